@@ -6,21 +6,64 @@ import socket
 CURRENT_REQUEST_VERSION = 1
 MAX_REQUEST_DATA_SIZE = 32
 MAX_PACKET_SIZE = 48
+MAX_TCP_REQUEST_DATA_SIZE = 1024 * 1024
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
-    WriteMemory = 2
+    WriteMemory = 2,
+    ServiceStats = 3,
+    PerfStats = 4,
+    ReadMemoryScatter = 5,
+    ReadMemoryAtFrameEnd = 6,
+    Subscribe = 7,
+    Unsubscribe = 8,
+    MemoryChanged = 9
 
 CITRA_PORT = 45987
 
 class Citra:
-    def __init__(self, address="127.0.0.1", port=CITRA_PORT):
-        self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    def __init__(self, address="127.0.0.1", port=CITRA_PORT, use_tcp=False):
+        """
+        TCP allows requests and replies of up to MAX_TCP_REQUEST_DATA_SIZE bytes, which makes large
+        reads and writes take far fewer round trips.
+        """
         self.address = address
+        self.use_tcp = use_tcp
+        if use_tcp:
+            self.socket = socket.create_connection((address, CITRA_PORT))
+            self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            self.max_data_size = MAX_TCP_REQUEST_DATA_SIZE
+        else:
+            self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+            self.max_data_size = MAX_REQUEST_DATA_SIZE
 
     def is_connected(self):
         return self.socket is not None
 
+    def _send(self, request):
+        if self.use_tcp:
+            self.socket.sendall(request)
+        else:
+            self.socket.sendto(request, (self.address, CITRA_PORT))
+
+    def _recv_exactly(self, size):
+        data = bytes()
+        while len(data) < size:
+            chunk = self.socket.recv(size - len(data))
+            if not chunk:
+                return None
+            data += chunk
+        return data
+
+    def _recv_reply(self):
+        if not self.use_tcp:
+            return self.socket.recv(MAX_PACKET_SIZE)
+        header = self._recv_exactly(4*4)
+        if header is None:
+            return bytes()
+        data = self._recv_exactly(struct.unpack("IIII", header)[3])
+        return header + (data or bytes())
+
     def _generate_header(self, request_type, data_size):
         request_id = random.getrandbits(32)
         return (struct.pack("IIII", CURRENT_REQUEST_VERSION, request_id, request_type, data_size), request_id)
@@ -41,13 +84,13 @@ class Citra:
         """
         result = bytes()
         while read_size > 0:
-            temp_read_size = min(read_size, MAX_REQUEST_DATA_SIZE)
+            temp_read_size = min(read_size, self.max_data_size)
             request_data = struct.pack("II", read_address, temp_read_size)
             request, request_id = self._generate_header(RequestType.ReadMemory, len(request_data))
             request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
+            self._send(request)
 
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            raw_reply = self._recv_reply()
             reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ReadMemory)
 
             if reply_data:
@@ -72,14 +115,14 @@ class Citra:
         """
         write_size = len(write_contents)
         while write_size > 0:
-            temp_write_size = min(write_size, MAX_REQUEST_DATA_SIZE - 8)
+            temp_write_size = min(write_size, self.max_data_size - 8)
             request_data = struct.pack("II", write_address, temp_write_size)
             request_data += write_contents[:temp_write_size]
             request, request_id = self._generate_header(RequestType.WriteMemory, len(request_data))
             request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
+            self._send(request)
 
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            raw_reply = self._recv_reply()
             reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.WriteMemory)
 
             if None != reply_data:
@@ -90,6 +133,140 @@ class Citra:
                 return False
         return True
 
+    def read_memory_scatter(self, ranges, at_frame_end=False):
+        """
+        Reads a list of (address, size) ranges in a single request, returning a list with the data
+        of every range. With at_frame_end, the reads happen at the end of the next emulated frame,
+        so that all the data comes from the same frame. The total size is bounded by the data size
+        of a request.
+        >>> len(c.read_memory_scatter([(0x100000, 4), (0x100004, 4)]))
+        2
+        """
+        if at_frame_end:
+            request_type = RequestType.ReadMemoryAtFrameEnd
+        else:
+            request_type = RequestType.ReadMemoryScatter
+        request_data = b"".join(struct.pack("II", address, size) for address, size in ranges)
+        request, request_id = self._generate_header(request_type, len(request_data))
+        request += request_data
+        self._send(request)
+
+        raw_reply = self._recv_reply()
+        reply_data = self._read_and_validate_header(raw_reply, request_id, request_type)
+
+        if not reply_data or len(reply_data) != sum(size for _, size in ranges):
+            return None
+        result = []
+        for _, size in ranges:
+            result.append(reply_data[:size])
+            reply_data = reply_data[size:]
+        return result
+
+    def subscribe(self, ranges):
+        """
+        Watches a list of (address, size) ranges of at most 64 KiB in total. Returns the id of the
+        subscription, whose changes are then read with wait_for_memory_changes.
+        >>> subscription_id = c.subscribe([(0x100000, 4)])
+        >>> c.wait_for_memory_changes()[0] == subscription_id
+        True
+        >>> c.unsubscribe(subscription_id)
+        True
+        """
+        request_data = b"".join(struct.pack("II", address, size) for address, size in ranges)
+        request, request_id = self._generate_header(RequestType.Subscribe, len(request_data))
+        request += request_data
+        self._send(request)
+
+        raw_reply = self._recv_reply()
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.Subscribe)
+
+        if not reply_data:
+            return None
+        return struct.unpack("I", reply_data)[0]
+
+    def unsubscribe(self, subscription_id):
+        request_data = struct.pack("II", subscription_id, 0)
+        request, request_id = self._generate_header(RequestType.Unsubscribe, len(request_data))
+        request += request_data
+        self._send(request)
+
+        # Changes pushed before the subscription ended may arrive first
+        while True:
+            raw_reply = self._recv_reply()
+            if len(raw_reply) < 4*4:
+                return False
+            reply_type = struct.unpack("IIII", raw_reply[:4*4])[2]
+            if reply_type != RequestType.MemoryChanged:
+                break
+        return self._read_and_validate_header(raw_reply, request_id,
+                                              RequestType.Unsubscribe) is not None
+
+    def wait_for_memory_changes(self):
+        """
+        Waits for the changes of a subscription, pushed at the end of every frame that changed the
+        watched memory. Returns the subscription id and a list of (address, data) of the changes,
+        the first changes of a subscription hold all its ranges.
+        """
+        while True:
+            raw_reply = self._recv_reply()
+            if len(raw_reply) < 4*4:
+                return None
+            _, subscription_id, reply_type, _ = struct.unpack("IIII", raw_reply[:4*4])
+            if reply_type == RequestType.MemoryChanged:
+                break
+
+        changes = []
+        reply_data = raw_reply[4*4:]
+        while len(reply_data) >= 8:
+            address, size = struct.unpack("II", reply_data[:8])
+            changes.append((address, reply_data[8:8 + size]))
+            reply_data = reply_data[8 + size:]
+        return (subscription_id, changes)
+
+    def get_service_stats(self):
+        """
+        Returns (service, command_id, count, total_ns, max_ns) of every HLE service command called
+        since the first query, which starts the collection.
+        >>> isinstance(c.get_service_stats(), list)
+        True
+        """
+        result = []
+        while True:
+            request_data = struct.pack("II", len(result), 0)
+            request, request_id = self._generate_header(RequestType.ServiceStats, len(request_data))
+            request += request_data
+            self._send(request)
+
+            raw_reply = self._recv_reply()
+            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ServiceStats)
+
+            if not reply_data:
+                return result
+            service, command_id, count, total_ns, max_ns = struct.unpack("8sIIQQ", reply_data)
+            result.append((service.rstrip(b"\0").decode(), command_id, count, total_ns, max_ns))
+
+    def get_perf_stats(self):
+        """
+        Returns a dict of the emulation speed, the p50, p95 and p99 frametimes and the time spent in
+        the CPU, HLE services, GPU submission and presentation per frame, in milliseconds.
+        Returns None when emulation isn't running.
+        >>> isinstance(c.get_perf_stats(), dict)
+        True
+        """
+        request_data = struct.pack("II", 0, 0)
+        request, request_id = self._generate_header(RequestType.PerfStats, len(request_data))
+        request += request_data
+        self._send(request)
+
+        raw_reply = self._recv_reply()
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.PerfStats)
+
+        if not reply_data:
+            return None
+        keys = ("emulation_speed", "frametime_p50", "frametime_p95", "frametime_p99", "cpu_time",
+                "service_time", "gpu_submit_time", "present_time")
+        return dict(zip(keys, struct.unpack("8f", reply_data)))
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
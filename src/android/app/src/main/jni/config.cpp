@@ -130,7 +130,14 @@ void Config::ReadValues() {
 
     // Core
     ReadSetting("Core", Settings::values.use_cpu_jit);
+    ReadSetting("Core", Settings::values.parallel_cpu_cores);
+    ReadSetting("Core", Settings::values.use_fastmem);
+    ReadSetting("Core", Settings::values.dyncom_block_profiling);
     ReadSetting("Core", Settings::values.cpu_clock_percentage);
+    ReadSetting("Core", Settings::values.enable_rewind);
+    ReadSetting("Core", Settings::values.rewind_frame_interval);
+    ReadSetting("Core", Settings::values.rewind_memory_budget);
+    ReadSetting("Core", Settings::values.movie_keyframe_interval);
 
     // Renderer
     Settings::values.use_gles = sdl2_config->GetBoolean("Renderer", "use_gles", true);
@@ -142,15 +149,28 @@ void Config::ReadValues() {
     ReadSetting("Renderer", Settings::values.spirv_shader_gen);
     ReadSetting("Renderer", Settings::values.use_hw_shader);
     ReadSetting("Renderer", Settings::values.use_shader_jit);
+    ReadSetting("Renderer", Settings::values.vertex_cache_size);
+    ReadSetting("Renderer", Settings::values.parallel_vertex_shading);
+    ReadSetting("Renderer", Settings::values.cache_command_lists);
+    ReadSetting("Renderer", Settings::values.async_gpu);
+    ReadSetting("Renderer", Settings::values.async_surface_downloads);
+    ReadSetting("Renderer", Settings::values.surface_pool_size);
+    ReadSetting("Renderer", Settings::values.async_texture_filtering);
+    ReadSetting("Renderer", Settings::values.async_texture_upload);
+    ReadSetting("Renderer", Settings::values.deduplicate_textures);
     ReadSetting("Renderer", Settings::values.resolution_factor);
+    ReadSetting("Renderer", Settings::values.dynamic_resolution);
+    ReadSetting("Renderer", Settings::values.dynamic_resolution_target);
     ReadSetting("Renderer", Settings::values.use_disk_shader_cache);
     ReadSetting("Renderer", Settings::values.use_vsync_new);
+    ReadSetting("Renderer", Settings::values.max_queued_presents);
     ReadSetting("Renderer", Settings::values.texture_filter);
     ReadSetting("Renderer", Settings::values.texture_sampling);
 
     // Work around to map Android setting for enabling the frame limiter to the format Citra expects
     if (sdl2_config->GetBoolean("Renderer", "use_frame_limit", true)) {
         ReadSetting("Renderer", Settings::values.frame_limit);
+    ReadSetting("Renderer", Settings::values.turbo_present_interval);
     } else {
         Settings::values.frame_limit = 0;
     }
@@ -164,6 +184,7 @@ void Config::ReadValues() {
         default_shader = "horizontal (builtin)";
     Settings::values.pp_shader_name =
         sdl2_config->GetString("Renderer", "pp_shader_name", default_shader);
+    ReadSetting("Renderer", Settings::values.pp_shader_chain);
     ReadSetting("Renderer", Settings::values.filter_mode);
 
     ReadSetting("Renderer", Settings::values.bg_red);
@@ -188,13 +209,17 @@ void Config::ReadValues() {
 
     // Utility
     ReadSetting("Utility", Settings::values.dump_textures);
+    ReadSetting("Utility", Settings::values.fast_texture_dumping);
     ReadSetting("Utility", Settings::values.custom_textures);
     ReadSetting("Utility", Settings::values.preload_textures);
     ReadSetting("Utility", Settings::values.async_custom_loading);
+    ReadSetting("Utility", Settings::values.custom_texture_memory);
 
     // Audio
     ReadSetting("Audio", Settings::values.audio_emulation);
     ReadSetting("Audio", Settings::values.enable_audio_stretching);
+    ReadSetting("Audio", Settings::values.async_hle_audio);
+    ReadSetting("Audio", Settings::values.audio_latency);
     ReadSetting("Audio", Settings::values.volume);
     ReadSetting("Audio", Settings::values.output_type);
     ReadSetting("Audio", Settings::values.output_device);
@@ -256,7 +281,10 @@ void Config::ReadValues() {
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
+    Settings::values.export_session_stats =
+        sdl2_config->GetBoolean("Debugging", "export_session_stats", false);
     ReadSetting("Debugging", Settings::values.renderer_debug);
+    ReadSetting("Debugging", Settings::values.gpu_timing);
     ReadSetting("Debugging", Settings::values.use_gdbstub);
     ReadSetting("Debugging", Settings::values.gdbstub_port);
 
@@ -6,9 +6,11 @@
 #include <array>
 #include <cstdlib>
 #include <string>
+#include <dlfcn.h>
 #include <android/native_window_jni.h>
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "core/core_timing.h"
 #include "input_common/main.h"
 #include "jni/emu_window/emu_window.h"
 #include "jni/id_cache.h"
@@ -27,8 +29,21 @@ static void UpdateLandscapeScreenLayout() {
             IDCache::GetNativeLibraryClass(), IDCache::GetLandscapeScreenLayout()));
 }
 
+/// Asks the compositor to run the display at the 3DS refresh rate where it supports several
+static void SetFrameRate(ANativeWindow* surface) {
+    // Added in Android 11, above the minimum SDK
+    using SetFrameRateFunc = int32_t (*)(ANativeWindow*, float, int8_t);
+    static const auto set_frame_rate =
+        reinterpret_cast<SetFrameRateFunc>(dlsym(RTLD_DEFAULT, "ANativeWindow_setFrameRate"));
+    if (surface && set_frame_rate) {
+        // ANATIVEWINDOW_FRAME_RATE_COMPATIBILITY_DEFAULT
+        set_frame_rate(surface, static_cast<float>(SCREEN_REFRESH_RATE), 0);
+    }
+}
+
 void EmuWindow_Android::OnSurfaceChanged(ANativeWindow* surface) {
     render_window = surface;
+    SetFrameRate(surface);
 
     window_info.type = Frontend::WindowSystemType::Android;
     window_info.render_surface = surface;
@@ -73,6 +88,7 @@ EmuWindow_Android::EmuWindow_Android(ANativeWindow* surface) : host_window{surfa
 
     window_width = ANativeWindow_getWidth(surface);
     window_height = ANativeWindow_getHeight(surface);
+    SetFrameRate(surface);
 
     Network::Init();
 }
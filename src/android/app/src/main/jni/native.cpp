@@ -37,6 +37,7 @@
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/nfc/nfc.h"
 #include "core/loader/loader.h"
+#include "core/savestate.h"
 #include "jni/android_common/android_common.h"
 #include "jni/applets/mii_selector.h"
 #include "jni/applets/swkbd.h"
@@ -53,6 +54,7 @@
 #include "jni/id_cache.h"
 #include "jni/input_manager.h"
 #include "jni/ndk_motion.h"
+#include "jni/performance_hint.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
@@ -217,11 +219,14 @@ static Core::System::ResultStatus RunCitra(const std::string& filepath) {
 
     SCOPE_EXIT({ TryShutdown(); });
 
+    PerformanceHint performance_hint;
+
     // Start running emulation
     while (!stop_run) {
         if (!pause_emulation) {
             const auto result = system.RunLoop();
             if (result == Core::System::ResultStatus::Success) {
+                performance_hint.OnFrame(system.perf_stats->GetGameFrameCount());
                 continue;
             }
             if (result == Core::System::ResultStatus::ShutdownRequested) {
@@ -698,7 +703,25 @@ jobjectArray Java_org_citra_citra_1emu_NativeLibrary_getSavestateInfo(
         return nullptr;
     }
 
-    const jobjectArray array = env->NewObjectArray(jsize(0), savestate_info_class, nullptr);
+    const auto savestates = Core::ListSaveStates(title_id, system.Movie().GetCurrentMovieID());
+    const jobjectArray array =
+        env->NewObjectArray(static_cast<jsize>(savestates.size()), savestate_info_class, nullptr);
+
+    const jclass date_class = env->FindClass("java/util/Date");
+    const auto date_constructor = env->GetMethodID(date_class, "<init>", "(J)V");
+    const auto slot_field = env->GetFieldID(savestate_info_class, "slot", "I");
+    const auto date_field = env->GetFieldID(savestate_info_class, "time", "Ljava/util/Date;");
+
+    for (std::size_t i = 0; i < savestates.size(); ++i) {
+        const jobject object = env->AllocObject(savestate_info_class);
+        env->SetIntField(object, slot_field, static_cast<jint>(savestates[i].slot));
+        env->SetObjectField(object, date_field,
+                            env->NewObject(date_class, date_constructor,
+                                           static_cast<jlong>(savestates[i].time * 1000)));
+
+        env->SetObjectArrayElement(array, static_cast<jsize>(i), object);
+    }
+
     return array;
 }
 
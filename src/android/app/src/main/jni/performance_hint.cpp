@@ -0,0 +1,75 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <ctime>
+#include <dlfcn.h>
+#include <unistd.h>
+#include "common/logging/log.h"
+#include "core/core_timing.h"
+#include "jni/performance_hint.h"
+
+struct APerformanceHintManager;
+
+namespace {
+
+/// Returns the CPU time used by the calling thread, which leaves out the frame limiter sleeps
+s64 GetThreadCpuTimeNs() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<s64>(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+}
+
+} // Anonymous namespace
+
+PerformanceHint::PerformanceHint() {
+    // The API was added in Android 13, above the minimum SDK, so it is looked up at runtime.
+    using GetManagerFunc = APerformanceHintManager* (*)();
+    using CreateSessionFunc = APerformanceHintSession* (*)(APerformanceHintManager*,
+                                                           const s32*, std::size_t, s64);
+    const auto get_manager =
+        reinterpret_cast<GetManagerFunc>(dlsym(RTLD_DEFAULT, "APerformanceHint_getManager"));
+    const auto create_session = reinterpret_cast<CreateSessionFunc>(
+        dlsym(RTLD_DEFAULT, "APerformanceHint_createSession"));
+    report_actual_work_duration = reinterpret_cast<ReportFunc>(
+        dlsym(RTLD_DEFAULT, "APerformanceHint_reportActualWorkDuration"));
+    close_session =
+        reinterpret_cast<CloseFunc>(dlsym(RTLD_DEFAULT, "APerformanceHint_closeSession"));
+    if (!get_manager || !create_session || !report_actual_work_duration || !close_session) {
+        return;
+    }
+
+    APerformanceHintManager* manager = get_manager();
+    if (!manager) {
+        return;
+    }
+
+    const s32 thread_id = gettid();
+    const s64 target_ns = static_cast<s64>(1'000'000'000.0 / SCREEN_REFRESH_RATE);
+    session = create_session(manager, &thread_id, 1, target_ns);
+    if (!session) {
+        LOG_WARNING(Frontend, "Unable to create a performance hint session");
+        return;
+    }
+    frame_start_ns = GetThreadCpuTimeNs();
+}
+
+PerformanceHint::~PerformanceHint() {
+    if (session) {
+        close_session(session);
+    }
+}
+
+void PerformanceHint::OnFrame(u64 frame_count) {
+    if (!session || frame_count == last_frame_count) {
+        return;
+    }
+    last_frame_count = frame_count;
+
+    const s64 now_ns = GetThreadCpuTimeNs();
+    const s64 work_ns = now_ns - frame_start_ns;
+    frame_start_ns = now_ns;
+    if (work_ns > 0) {
+        report_actual_work_duration(session, work_ns);
+    }
+}
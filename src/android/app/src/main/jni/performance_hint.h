@@ -0,0 +1,37 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+struct APerformanceHintSession;
+
+/**
+ * Reports the CPU time the emulation thread spends on every emulated frame to the Android Dynamic
+ * Performance Framework, so that the CPU is clocked for the frame target instead of being ramped
+ * up and throttled again. Does nothing before Android 13.
+ */
+class PerformanceHint {
+public:
+    /// Opens a hint session for the calling thread.
+    PerformanceHint();
+    ~PerformanceHint();
+
+    PerformanceHint(const PerformanceHint&) = delete;
+    PerformanceHint& operator=(const PerformanceHint&) = delete;
+
+    /// Reports the work of the last frame once frame_count has moved on since the previous call.
+    void OnFrame(u64 frame_count);
+
+private:
+    using ReportFunc = int (*)(APerformanceHintSession*, s64);
+    using CloseFunc = void (*)(APerformanceHintSession*);
+
+    APerformanceHintSession* session{};
+    ReportFunc report_actual_work_duration{};
+    CloseFunc close_session{};
+    u64 last_frame_count{};
+    s64 frame_start_ns{};
+};
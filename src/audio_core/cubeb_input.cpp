@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <utility>
 #include <vector>
 #include <cubeb/cubeb.h>
@@ -9,11 +12,12 @@
 #include "audio_core/input.h"
 #include "audio_core/sink.h"
 #include "common/logging/log.h"
-#include "common/threadsafe_queue.h"
+#include "common/ring_buffer.h"
 
 namespace AudioCore {
 
-using SampleQueue = Common::SPSCQueue<Samples>;
+/// Captured bytes waiting to be read by the emulation thread, about a second of 16-bit samples
+using SampleQueue = Common::RingBuffer<u8, 0x10000>;
 
 struct CubebInput::Impl {
     cubeb* ctx = nullptr;
@@ -139,11 +143,8 @@ Samples CubebInput::Read() {
         return {};
     }
 
-    Samples samples{};
-    Samples queue;
-    while (impl->sample_queue.Pop(queue)) {
-        samples.insert(samples.end(), queue.begin(), queue.end());
-    }
+    Samples samples(impl->sample_queue.Size());
+    samples.resize(impl->sample_queue.Pop(samples.data(), samples.size()));
     return samples;
 }
 
@@ -158,21 +159,24 @@ long CubebInput::Impl::DataCallback(cubeb_stream* stream, void* user_data, const
         return static_cast<u8>(static_cast<u16>(sample) >> 8);
     };
 
-    std::vector<u8> samples{};
-    samples.reserve(num_frames * impl->sample_size_in_bytes);
     if (impl->sample_size_in_bytes == 1) {
         // If the sample format is 8bit, then resample back to 8bit before passing back to core
-        for (std::size_t i = 0; i < static_cast<std::size_t>(num_frames); i++) {
-            s16 data;
-            std::memcpy(&data, static_cast<const u8*>(input_buffer) + i * 2, 2);
-            samples.push_back(resample_s16_s8(data));
+        std::array<u8, 512> samples;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(num_frames); i += samples.size()) {
+            const std::size_t count =
+                std::min(samples.size(), static_cast<std::size_t>(num_frames) - i);
+            for (std::size_t j = 0; j < count; j++) {
+                s16 data;
+                std::memcpy(&data, static_cast<const u8*>(input_buffer) + (i + j) * 2, 2);
+                samples[j] = resample_s16_s8(data);
+            }
+            impl->sample_queue.Push(samples.data(), count);
         }
     } else {
         // Otherwise copy all of the samples to the buffer (which will be treated as s16 by core)
-        const u8* data = reinterpret_cast<const u8*>(input_buffer);
-        samples.insert(samples.begin(), data, data + num_frames * impl->sample_size_in_bytes);
+        impl->sample_queue.Push(input_buffer,
+                                static_cast<std::size_t>(num_frames) * impl->sample_size_in_bytes);
     }
-    impl->sample_queue.Push(samples);
 
     // returning less than num_frames here signals cubeb to stop sampling
     return num_frames;
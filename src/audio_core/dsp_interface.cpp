@@ -72,6 +72,20 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
     }
     performing_time_stretching = should_stretch;
 
+    // Samples queued beyond the target latency are dropped, which bounds the latency when
+    // emulation produces audio faster than the sink consumes it.
+    const u32 target_latency = Settings::values.audio_latency.GetValue();
+    if (target_latency != 0 && !performing_time_stretching) {
+        const std::size_t target_frames =
+            num_frames + static_cast<std::size_t>(target_latency) * native_sample_rate / 1000;
+        std::size_t excess_frames = fifo.Size() > target_frames ? fifo.Size() - target_frames : 0;
+        std::array<s16, 512> discard;
+        while (excess_frames > 0) {
+            const std::size_t discard_frames = std::min(excess_frames, discard.size() / 2);
+            excess_frames -= fifo.Pop(discard.data(), discard_frames);
+        }
+    }
+
     std::size_t frames_written = 0;
     if (performing_time_stretching) {
         const std::vector<s16> in{fifo.Pop()};
@@ -94,6 +108,12 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
         std::memcpy(&last_frame[0], buffer + 2 * (frames_written - 1), 2 * sizeof(s16));
     }
 
+    if (system.perf_stats) {
+        const std::chrono::microseconds queued_latency{fifo.Size() * 1'000'000 /
+                                                       native_sample_rate};
+        system.perf_stats->SetAudioStats(queued_latency, frames_written < num_frames);
+    }
+
     // Hold last emitted frame; this prevents popping.
     for (std::size_t i = frames_written; i < num_frames; i++) {
         std::memcpy(buffer + 2 * i, &last_frame[0], 2 * sizeof(s16));
@@ -14,6 +14,8 @@
 #include "core/memory.h"
 
 namespace Core {
+class StateReader;
+class StateWriter;
 class System;
 } // namespace Core
 
@@ -99,6 +101,12 @@ public:
     /// Unloads the DSP program
     virtual void UnloadComponent() = 0;
 
+    /// Writes backend specific state, not covered by DSP memory, to a savestate stream
+    virtual void SaveState([[maybe_unused]] Core::StateWriter& writer) const {}
+
+    /// Restores backend specific state previously written by SaveState
+    virtual void LoadState([[maybe_unused]] Core::StateReader& reader) {}
+
     /// Select the sink to use based on sink type.
     void SetSink(SinkType sink_type, std::string_view audio_device);
     /// Get the current sink
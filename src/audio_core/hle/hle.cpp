@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <future>
 #include "audio_core/audio_types.h"
 #include "audio_core/hle/aac_decoder.h"
 #include "audio_core/hle/common.h"
@@ -15,8 +16,11 @@
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/savestate.h"
 
 using InterruptType = Service::DSP::InterruptType;
 
@@ -41,7 +45,7 @@ public:
     u16 RecvData(u32 register_number);
     bool RecvDataIsReady(u32 register_number) const;
     std::vector<u8> PipeRead(DspPipe pipe_number, std::size_t length);
-    std::size_t GetPipeReadableSize(DspPipe pipe_number) const;
+    std::size_t GetPipeReadableSize(DspPipe pipe_number);
     void PipeWrite(DspPipe pipe_number, std::span<const u8> buffer);
 
     void SetInterruptHandler(
@@ -51,11 +55,16 @@ public:
     void WriteU16(DspPipe pipe_number, u16 value);
     void AudioPipeWriteStructAddresses();
 
+    void QueueDecode(const HLE::BinaryMessage& request);
+    void FinishDecode(bool wait);
+
     std::size_t CurrentRegionIndex() const;
     HLE::SharedMemory& ReadRegion();
     HLE::SharedMemory& WriteRegion();
 
-    StereoFrame16 GenerateCurrentFrame();
+    StereoFrame16 GenerateFrame(HLE::SharedMemory& read, HLE::SharedMemory& write);
+    void QueueAsyncFrame();
+    void CommitAsyncFrame();
     bool Tick();
     void AudioTickCallback(s64 cycles_late);
 
@@ -77,8 +86,17 @@ public:
     Core::TimingEventType* tick_event{};
 
     std::unique_ptr<HLE::DecoderBase> aac_decoder{};
+    Common::ThreadWorker decode_worker{1, "DspHle decoder"};
+    std::future<HLE::BinaryMessage> pending_decode;
 
     std::function<void(Service::DSP::InterruptType type, DspPipe pipe)> interrupt_handler{};
+
+    /// Copies of the shared memory regions the frame worker reads from and writes to
+    std::unique_ptr<HLE::SharedMemory> async_read;
+    std::unique_ptr<HLE::SharedMemory> async_write;
+    StereoFrame16 async_frame{};
+    bool async_frame_pending{};
+    std::unique_ptr<Common::ThreadWorker> frame_worker;
 };
 
 DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory, Core::Timing& timing)
@@ -91,6 +109,11 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory, Core::Timing&
     }
 
     aac_decoder = std::make_unique<HLE::AACDecoder>(memory);
+    if (Settings::values.async_hle_audio) {
+        async_read = std::make_unique<HLE::SharedMemory>();
+        async_write = std::make_unique<HLE::SharedMemory>();
+        frame_worker = std::make_unique<Common::ThreadWorker>(1, "DspHle");
+    }
     tick_event =
         core_timing.RegisterEvent("AudioCore::DspHle::tick_event", [this](u64, s64 cycles_late) {
             this->AudioTickCallback(cycles_late);
@@ -100,6 +123,9 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory, Core::Timing&
 
 DspHle::Impl::~Impl() {
     core_timing.UnscheduleEvent(tick_event, 0);
+    if (frame_worker) {
+        frame_worker->WaitForRequests();
+    }
 }
 
 DspState DspHle::Impl::GetDspState() const {
@@ -142,6 +168,10 @@ std::vector<u8> DspHle::Impl::PipeRead(DspPipe pipe_number, std::size_t length)
         return {};
     }
 
+    if (pipe_number == DspPipe::Binary) {
+        FinishDecode(true);
+    }
+
     std::vector<u8>& data = pipe_data[pipe_index];
 
     if (length > data.size()) {
@@ -160,7 +190,7 @@ std::vector<u8> DspHle::Impl::PipeRead(DspPipe pipe_number, std::size_t length)
     return ret;
 }
 
-size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) const {
+size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) {
     const std::size_t pipe_index = static_cast<std::size_t>(pipe_number);
 
     if (pipe_index >= num_dsp_pipe) {
@@ -168,6 +198,10 @@ size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) const {
         return 0;
     }
 
+    if (pipe_number == DspPipe::Binary) {
+        FinishDecode(true);
+    }
+
     return pipe_data[pipe_index].size();
 }
 
@@ -227,7 +261,6 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, std::span<const u8> buffer) {
         return;
     }
     case DspPipe::Binary: {
-        // TODO(B3N30): Make this async, and signal the interrupt
         HLE::BinaryMessage request{};
         if (sizeof(request) != buffer.size()) {
             LOG_CRITICAL(Audio_DSP, "got binary pipe with wrong size {}", buffer.size());
@@ -240,11 +273,7 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, std::span<const u8> buffer) {
             UNIMPLEMENTED();
             return;
         }
-        const HLE::BinaryMessage response = aac_decoder->ProcessRequest(request);
-        pipe_data[static_cast<u32>(pipe_number)].resize(sizeof(response));
-        std::memcpy(pipe_data[static_cast<u32>(pipe_number)].data(), &response, sizeof(response));
-
-        interrupt_handler(InterruptType::Pipe, DspPipe::Binary);
+        QueueDecode(request);
         break;
     }
     default:
@@ -307,6 +336,32 @@ void DspHle::Impl::AudioPipeWriteStructAddresses() {
     interrupt_handler(InterruptType::Pipe, DspPipe::Audio);
 }
 
+void DspHle::Impl::QueueDecode(const HLE::BinaryMessage& request) {
+    // Requests are answered in order, so one that is still decoding is answered first.
+    FinishDecode(true);
+
+    std::packaged_task<HLE::BinaryMessage()> task{
+        [this, request] { return aac_decoder->ProcessRequest(request); }};
+    pending_decode = task.get_future();
+    decode_worker.QueueWork(std::move(task));
+}
+
+void DspHle::Impl::FinishDecode(bool wait) {
+    if (!pending_decode.valid()) {
+        return;
+    }
+    if (!wait && pending_decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    const HLE::BinaryMessage response = pending_decode.get();
+    auto& data = pipe_data[static_cast<u32>(DspPipe::Binary)];
+    data.resize(sizeof(response));
+    std::memcpy(data.data(), &response, sizeof(response));
+
+    interrupt_handler(InterruptType::Pipe, DspPipe::Binary);
+}
+
 size_t DspHle::Impl::CurrentRegionIndex() const {
     // The region with the higher frame counter is chosen unless there is wraparound.
     // This function only returns a 0 or 1.
@@ -334,10 +389,7 @@ HLE::SharedMemory& DspHle::Impl::WriteRegion() {
     return CurrentRegionIndex() != 0 ? dsp_memory->region_0 : dsp_memory->region_1;
 }
 
-StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
-    HLE::SharedMemory& read = ReadRegion();
-    HLE::SharedMemory& write = WriteRegion();
-
+StereoFrame16 DspHle::Impl::GenerateFrame(HLE::SharedMemory& read, HLE::SharedMemory& write) {
     std::array<QuadFrame32, 3> intermediate_mixes = {};
 
     // Generate intermediate mixes
@@ -365,14 +417,55 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
     return output_frame;
 }
 
+void DspHle::Impl::QueueAsyncFrame() {
+    HLE::SharedMemory& read = ReadRegion();
+    *async_read = read;
+    *async_write = WriteRegion();
+
+    // The worker clears the dirty flags of its copy, clear them here as well so the application
+    // sees the configuration as consumed just like it would after a synchronous frame.
+    for (auto& config : read.source_configurations.config) {
+        if (config.buffer_queue_dirty) {
+            config.buffers_dirty = 0;
+        }
+        config.dirty_raw = 0;
+    }
+    read.dsp_configuration.dirty_raw = 0;
+
+    frame_worker->QueueWork([this] { async_frame = GenerateFrame(*async_read, *async_write); });
+    async_frame_pending = true;
+}
+
+void DspHle::Impl::CommitAsyncFrame() {
+    frame_worker->WaitForRequests();
+    if (!async_frame_pending) {
+        return;
+    }
+    async_frame_pending = false;
+
+    HLE::SharedMemory& write = WriteRegion();
+    write.source_statuses = async_write->source_statuses;
+    write.dsp_status = async_write->dsp_status;
+    write.intermediate_mix_samples = async_write->intermediate_mix_samples;
+    write.final_samples = async_write->final_samples;
+    parent.OutputFrame(std::move(async_frame));
+}
+
 bool DspHle::Impl::Tick() {
-    StereoFrame16 current_frame = {};
+    // Decoded buffers are answered on the audio tick after the decoder finished them, like the
+    // DSP replies some time after the request instead of immediately.
+    FinishDecode(false);
 
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
     // shared memory region)
-    current_frame = GenerateCurrentFrame();
-
-    parent.OutputFrame(std::move(current_frame));
+    if (frame_worker) {
+        // The frame generated since the last tick is published, one frame later than the
+        // synchronous path, and the next one is generated while the emulated CPU runs.
+        CommitAsyncFrame();
+        QueueAsyncFrame();
+    } else {
+        parent.OutputFrame(GenerateFrame(ReadRegion(), WriteRegion()));
+    }
 
     return GetDspState() == DspState::On;
 }
@@ -439,4 +532,23 @@ void DspHle::UnloadComponent() {
     // Do nothing
 }
 
+void DspHle::SaveState(Core::StateWriter& writer) const {
+    impl->FinishDecode(true);
+    writer.Write<u32>(Core::MakeStateTag("DSPH"));
+    writer.Write<DspState>(impl->dsp_state);
+    for (const auto& pipe : impl->pipe_data) {
+        writer.Write<u32>(static_cast<u32>(pipe.size()));
+        writer.WriteBytes(pipe.data(), pipe.size());
+    }
+}
+
+void DspHle::LoadState(Core::StateReader& reader) {
+    reader.ExpectTag(Core::MakeStateTag("DSPH"));
+    reader.Read(impl->dsp_state);
+    for (auto& pipe : impl->pipe_data) {
+        pipe.resize(reader.Read<u32>());
+        reader.ReadBytes(pipe.data(), pipe.size());
+    }
+}
+
 } // namespace AudioCore
@@ -41,6 +41,9 @@ public:
     void LoadComponent(std::span<const u8> buffer) override;
     void UnloadComponent() override;
 
+    void SaveState(Core::StateWriter& writer) const override;
+    void LoadState(Core::StateReader& reader) override;
+
 private:
     struct Impl;
     friend struct Impl;
@@ -5,9 +5,16 @@
 #include <algorithm>
 #include <cstddef>
 #include "audio_core/hle/mixers.h"
+#include "common/arch.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace AudioCore::HLE {
 
 void Mixers::Reset() {
@@ -117,6 +124,35 @@ void Mixers::DownmixAndMixIntoCurrentFrame(float gain, const QuadFrame32& sample
         // fallthrough
 
     case OutputFormat::Stereo:
+        static_assert(samples_per_frame % 2 == 0);
+#if CITRA_ARCH(x86_64)
+        // Two quadraphonic samples are downmixed per step, the pack and the add saturate to s16
+        // like ClampToS16 and AddAndClampToS16 do.
+        const __m128 gain_vec = _mm_set1_ps(gain);
+        for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+            const auto* in = reinterpret_cast<const __m128i*>(&samples[samplei]);
+            const __m128 first = _mm_mul_ps(gain_vec, _mm_cvtepi32_ps(_mm_loadu_si128(in)));
+            const __m128 second = _mm_mul_ps(gain_vec, _mm_cvtepi32_ps(_mm_loadu_si128(in + 1)));
+            const __m128 front = _mm_shuffle_ps(first, second, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m128 back = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m128i mixed = _mm_cvttps_epi32(_mm_add_ps(front, back));
+            auto* out = reinterpret_cast<__m128i*>(&current_frame[samplei]);
+            const __m128i downmixed = _mm_packs_epi32(mixed, mixed);
+            _mm_storel_epi64(out, _mm_adds_epi16(_mm_loadl_epi64(out), downmixed));
+        }
+#elif CITRA_ARCH(arm64)
+        const float32x4_t gain_vec = vdupq_n_f32(gain);
+        for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+            const s32* in = samples[samplei].data();
+            const float32x4_t first = vmulq_f32(gain_vec, vcvtq_f32_s32(vld1q_s32(in)));
+            const float32x4_t second = vmulq_f32(gain_vec, vcvtq_f32_s32(vld1q_s32(in + 4)));
+            const float32x4_t front = vcombine_f32(vget_low_f32(first), vget_low_f32(second));
+            const float32x4_t back = vcombine_f32(vget_high_f32(first), vget_high_f32(second));
+            const int16x4_t mixed = vqmovn_s32(vcvtq_s32_f32(vaddq_f32(front, back)));
+            s16* out = current_frame[samplei].data();
+            vst1_s16(out, vqadd_s16(vld1_s16(out), mixed));
+        }
+#else
         std::transform(
             current_frame.begin(), current_frame.end(), samples.begin(), current_frame.begin(),
             [gain](const std::array<s16, 2>& accumulator,
@@ -127,6 +163,7 @@ void Mixers::DownmixAndMixIntoCurrentFrame(float gain, const QuadFrame32& sample
                 // Mix into current frame
                 return AddAndClampToS16(accumulator, {left, right});
             });
+#endif
         return;
     }
 
@@ -8,10 +8,17 @@
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/source.h"
 #include "audio_core/interpolate.h"
+#include "common/arch.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/memory.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace AudioCore::HLE {
 
 SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
@@ -30,6 +37,35 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
         return;
 
     const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
+    static_assert(samples_per_frame % 2 == 0);
+#if CITRA_ARCH(x86_64)
+    // Each stereo sample is broadcast to {left, right, left, right} to line up with the gains.
+    const __m128 gain = _mm_loadu_ps(gains.data());
+    const auto mix = [gain](std::array<s32, 4>& out, __m128i samples) {
+        const __m128i mixed = _mm_cvttps_epi32(_mm_mul_ps(gain, _mm_cvtepi32_ps(samples)));
+        __m128i* out_ptr = reinterpret_cast<__m128i*>(out.data());
+        _mm_storeu_si128(out_ptr, _mm_add_epi32(_mm_loadu_si128(out_ptr), mixed));
+    };
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+        const __m128i stereo =
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&current_frame[samplei]));
+        const __m128i widened = _mm_srai_epi32(_mm_unpacklo_epi16(stereo, stereo), 16);
+        mix(dest[samplei], _mm_shuffle_epi32(widened, _MM_SHUFFLE(1, 0, 1, 0)));
+        mix(dest[samplei + 1], _mm_shuffle_epi32(widened, _MM_SHUFFLE(3, 2, 3, 2)));
+    }
+#elif CITRA_ARCH(arm64)
+    const float32x4_t gain = vld1q_f32(gains.data());
+    const auto mix = [gain](std::array<s32, 4>& out, int32x2_t stereo) {
+        const int32x4_t samples = vcombine_s32(stereo, stereo);
+        const int32x4_t mixed = vcvtq_s32_f32(vmulq_f32(gain, vcvtq_f32_s32(samples)));
+        vst1q_s32(out.data(), vaddq_s32(vld1q_s32(out.data()), mixed));
+    };
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+        const int32x4_t widened = vmovl_s16(vld1_s16(current_frame[samplei].data()));
+        mix(dest[samplei], vget_low_s32(widened));
+        mix(dest[samplei + 1], vget_high_s32(widened));
+    }
+#else
     for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
         // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
         dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
@@ -37,6 +73,7 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
         dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
         dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
     }
+#endif
 }
 
 void Source::Reset() {
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <thread>
@@ -137,8 +138,9 @@ struct DspLle::Impl final {
     Teakra::Teakra teakra;
     u16 pipe_base_waddr = 0;
 
-    bool semaphore_signaled = false;
-    bool data_signaled = false;
+    // Set by the interrupt handlers, which run on the Teakra thread in multithreaded mode
+    std::atomic<bool> semaphore_signaled = false;
+    std::atomic<bool> data_signaled = false;
 
     Core::Timing& core_timing;
     Core::TimingEventType* teakra_slice_event;
@@ -152,10 +154,15 @@ struct DspLle::Impl final {
 
     static constexpr u32 DspDataOffset = 0x40000;
     static constexpr u32 TeakraSlice = 16384;
+    static constexpr u32 MinTeakraSlice = 1024;
+
+    /// Cycles the DSP runs per slice. Slices shrink while the CPU waits for the DSP so waiting
+    /// does not overshoot, and grow back to TeakraSlice once the DSP runs undisturbed.
+    std::atomic<u32> slice_size = TeakraSlice;
 
     void TeakraThread() {
         while (true) {
-            teakra.Run(TeakraSlice);
+            teakra.Run(slice_size.load(std::memory_order_relaxed));
             teakra_slice_barrier.Sync();
             if (stop_signal) {
                 if (stop_generation == teakra_slice_barrier.Generation())
@@ -178,13 +185,24 @@ struct DspLle::Impl final {
         if (multithread) {
             teakra_slice_barrier.Sync();
         } else {
-            teakra.Run(TeakraSlice);
+            teakra.Run(slice_size.load(std::memory_order_relaxed));
+        }
+    }
+
+    /// Runs the DSP in short slices until condition returns true
+    template <typename Func>
+    void RunTeakraUntil(Func&& condition) {
+        while (!condition()) {
+            slice_size.store(MinTeakraSlice, std::memory_order_relaxed);
+            RunTeakraSlice();
         }
     }
 
     void TeakraSliceEvent(u64 late) {
+        const u32 slice = std::min(slice_size.load(std::memory_order_relaxed) * 2, TeakraSlice);
+        slice_size.store(slice, std::memory_order_relaxed);
         RunTeakraSlice();
-        u64 next = TeakraSlice * 2; // DSP runs at clock rate half of the CPU rate
+        u64 next = slice * 2; // DSP runs at clock rate half of the CPU rate
         if (next < late)
             next = 0;
         else
@@ -253,8 +271,7 @@ struct DspLle::Impl final {
         }
         if (need_update) {
             UpdatePipeStatus(pipe_status);
-            while (!teakra.SendDataIsEmpty(2))
-                RunTeakraSlice();
+            RunTeakraUntil([this] { return teakra.SendDataIsEmpty(2); });
             teakra.SendData(2, pipe_status.slot_index);
         }
     }
@@ -290,8 +307,7 @@ struct DspLle::Impl final {
         }
         if (need_update) {
             UpdatePipeStatus(pipe_status);
-            while (!teakra.SendDataIsEmpty(2))
-                RunTeakraSlice();
+            RunTeakraUntil([this] { return teakra.SendDataIsEmpty(2); });
             teakra.SendData(2, pipe_status.slot_index);
         }
         return data;
@@ -337,15 +353,13 @@ struct DspLle::Impl final {
         if (dsp.recv_data_on_start) {
             for (u8 i = 0; i < 3; ++i) {
                 do {
-                    while (!teakra.RecvDataIsReady(i))
-                        RunTeakraSlice();
+                    RunTeakraUntil([this, i] { return teakra.RecvDataIsReady(i); });
                 } while (teakra.RecvData(i) != 1);
             }
         }
 
         // Get pipe base address
-        while (!teakra.RecvDataIsReady(2))
-            RunTeakraSlice();
+        RunTeakraUntil([this] { return teakra.RecvDataIsReady(2); });
         pipe_base_waddr = teakra.RecvData(2);
 
         loaded = true;
@@ -361,14 +375,12 @@ struct DspLle::Impl final {
 
         // Send finalization signal via command/reply register 2
         constexpr u16 FinalizeSignal = 0x8000;
-        while (!teakra.SendDataIsEmpty(2))
-            RunTeakraSlice();
+        RunTeakraUntil([this] { return teakra.SendDataIsEmpty(2); });
 
         teakra.SendData(2, FinalizeSignal);
 
         // Wait for completion
-        while (!teakra.RecvDataIsReady(2))
-            RunTeakraSlice();
+        RunTeakraUntil([this] { return teakra.RecvDataIsReady(2); });
 
         teakra.RecvData(2); // discard the value
 
@@ -378,9 +390,8 @@ struct DspLle::Impl final {
 };
 
 u16 DspLle::RecvData(u32 register_number) {
-    while (!impl->teakra.RecvDataIsReady(register_number)) {
-        impl->RunTeakraSlice();
-    }
+    impl->RunTeakraUntil(
+        [this, register_number] { return impl->teakra.RecvDataIsReady(register_number); });
     return impl->teakra.RecvData(static_cast<u8>(register_number));
 }
 
@@ -436,7 +447,8 @@ void DspLle::SetInterruptHandler(
             impl->semaphore_signaled = true;
         }
         if (impl->semaphore_signaled && impl->data_signaled) {
-            impl->semaphore_signaled = impl->data_signaled = false;
+            impl->semaphore_signaled = false;
+            impl->data_signaled = false;
             u16 slot = teakra.RecvData(2);
             u16 side = slot % 2;
             u16 pipe = slot / 2;
@@ -38,7 +38,8 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
 
     const double max_latency = 0.25; // seconds
     const double max_backlog = native_sample_rate * max_latency;
-    const double backlog_fullness = sound_touch->numSamples() / max_backlog;
+    const double backlog_fullness =
+        (sound_touch->numSamples() + linear_backlog.size() / 2) / max_backlog;
     if (backlog_fullness > 4.0) {
         // Too many samples in backlog: Don't push anymore on
         num_in = 0;
@@ -60,11 +61,69 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
     // Place a lower limit of 5% speed. When a game boots up, there will be
     // many silence samples. These do not need to be timestretched.
     stretch_ratio = std::max(stretch_ratio, 0.05);
-    sound_touch->setTempo(stretch_ratio);
 
     LOG_TRACE(Audio, "{:5}/{:5} ratio:{:0.6f} backlog:{:0.6f}", num_in, num_out, stretch_ratio,
               backlog_fullness);
 
+    // SoundTouch keeps the pitch but is expensive, so it is only used for large deviations from
+    // full speed. Moderate deviations are resampled linearly, shifting the pitch slightly, and
+    // small ones are passed through as is.
+    const double deviation = std::abs(stretch_ratio - 1.0);
+    if (deviation > linear_max_deviation) {
+        if (!linear_backlog.empty()) {
+            static_cast<void>(
+                ProcessSoundTouch(linear_backlog.data(), linear_backlog.size() / 2, nullptr, 0));
+            linear_backlog.clear();
+            linear_position = 0.0;
+        }
+        sound_touch_active = true;
+        sound_touch->setTempo(stretch_ratio);
+        return ProcessSoundTouch(in, num_in, out, num_out);
+    }
+
+    // Output what SoundTouch still holds before switching to the cheaper paths.
+    std::size_t frames_written = 0;
+    if (sound_touch_active) {
+        frames_written = ProcessSoundTouch(nullptr, 0, out, num_out);
+        if (sound_touch->numSamples() == 0) {
+            sound_touch->clear();
+            sound_touch_active = false;
+        }
+    }
+
+    linear_backlog.insert(linear_backlog.end(), in, in + 2 * num_in);
+    const double step = deviation <= bypass_max_deviation ? 1.0 : stretch_ratio;
+    frames_written +=
+        ProcessLinear(step, out + 2 * frames_written, num_out - frames_written);
+    return frames_written;
+}
+
+std::size_t TimeStretcher::ProcessLinear(double step, s16* out, std::size_t num_out) {
+    const std::size_t num_in = linear_backlog.size() / 2;
+    std::size_t frames_written = 0;
+    for (; frames_written < num_out; frames_written++) {
+        const std::size_t index = static_cast<std::size_t>(linear_position);
+        if (index + 1 >= num_in) {
+            break;
+        }
+        const double fraction = linear_position - static_cast<double>(index);
+        for (std::size_t channel = 0; channel < 2; channel++) {
+            const double x0 = linear_backlog[index * 2 + channel];
+            const double x1 = linear_backlog[(index + 1) * 2 + channel];
+            out[frames_written * 2 + channel] = static_cast<s16>(x0 + fraction * (x1 - x0));
+        }
+        linear_position += step;
+    }
+
+    const std::size_t consumed =
+        std::min(static_cast<std::size_t>(linear_position), num_in > 0 ? num_in - 1 : 0);
+    linear_backlog.erase(linear_backlog.begin(), linear_backlog.begin() + 2 * consumed);
+    linear_position -= static_cast<double>(consumed);
+    return frames_written;
+}
+
+std::size_t TimeStretcher::ProcessSoundTouch(const s16* in, std::size_t num_in, s16* out,
+                                             std::size_t num_out) {
     if constexpr (std::is_floating_point<soundtouch::SAMPLETYPE>()) {
         // The SoundTouch library on most systems expects float samples
         // use this vector to store input if soundtouch::SAMPLETYPE is a float
@@ -85,7 +144,7 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
             sound_touch->receiveSamples(float_out.data(), static_cast<u32>(num_out));
 
         // Converting output samples back to shorts so we can use them
-        for (std::size_t i = 0; i < (2 * num_out); i++) {
+        for (std::size_t i = 0; i < (2 * samples_received); i++) {
             const s16 temp = static_cast<s16>(float_out[i] * std::numeric_limits<s16>::max());
             out[i] = temp;
         }
@@ -107,6 +166,9 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
 
 void TimeStretcher::Clear() {
     sound_touch->clear();
+    sound_touch_active = false;
+    linear_backlog.clear();
+    linear_position = 0.0;
 }
 
 void TimeStretcher::Flush() {
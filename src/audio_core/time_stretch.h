@@ -7,6 +7,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <vector>
 #include "common/common_types.h"
 
 namespace soundtouch {
@@ -34,7 +35,20 @@ public:
     void Flush();
 
 private:
+    /// Resamples the linear backlog with linear interpolation, consuming step frames per output
+    std::size_t ProcessLinear(double step, s16* out, std::size_t num_out);
+
+    std::size_t ProcessSoundTouch(const s16* in, std::size_t num_in, s16* out,
+                                  std::size_t num_out);
+
+    /// Deviations of the stretch ratio from 1 up to which the cheaper paths are used
+    static constexpr double bypass_max_deviation = 0.02;
+    static constexpr double linear_max_deviation = 0.15;
+
     std::unique_ptr<soundtouch::SoundTouch> sound_touch;
+    bool sound_touch_active = false;
+    std::vector<s16> linear_backlog;
+    double linear_position = 0.0;
     double stretch_ratio = 1.0;
 };
 
@@ -2,11 +2,15 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <regex>
 #include <string>
 #include <thread>
+#include <vector>
 
 // This needs to be included before getopt.h because the latter #defines symbols used by it
 #include "common/microprofile.h"
@@ -27,11 +31,14 @@
 #include "common/file_util.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
+#include "common/microprofile_trace.h"
 #include "common/scm_rev.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "core/branch_explorer.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/dumping/backend.h"
 #include "core/dumping/ffmpeg_backend.h"
 #include "core/frontend/applets/default_applets.h"
@@ -39,6 +46,7 @@
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/cfg/cfg.h"
 #include "core/movie.h"
+#include "core/perf_stats.h"
 #include "input_common/main.h"
 #include "network/network.h"
 #include "video_core/gpu.h"
@@ -50,6 +58,7 @@
 
 #undef _UNICODE
 #include <getopt.h>
+#include <json.hpp>
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
@@ -77,6 +86,14 @@ static void PrintHelp(const char* argv0) {
                  "-a, --movie-record-author=AUTHOR Sets the author of the movie to be recorded\n"
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
                  "-d, --dump-video=[file]    Dumps audio and video to the given video file\n"
+                 "-b, --benchmark=FRAMES     Run unthrottled for FRAMES frames and print a report\n"
+                 "-F, --fork-frame=FRAME     Fork at game frame FRAME to run the branch movies\n"
+                 "-B, --branch-movie=[file]  Play the movie from the fork point, can be repeated.\n"
+                 "                           Branches end with their movie, or after the number\n"
+                 "                           of benchmark frames\n"
+                 "-o, --benchmark-report=[file] Write the benchmark report to the given file\n"
+                 "-t, --profile-trace=[file] Write microprofile scopes as a Chrome trace to the\n"
+                 "                           given file\n"
                  "-f, --fullscreen     Start in fullscreen mode\n"
                  "-h, --help           Display this help and exit\n"
                  "-v, --version        Output version information and exit\n";
@@ -181,6 +198,77 @@ static void OnStatusMessageReceived(const Network::StatusMessageEntry& msg) {
         std::cout << std::endl << "* " << message << std::endl << std::endl;
 }
 
+/// Returns the sample below which the given fraction of the sorted samples fall
+static double Percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+/**
+ * Writes the results of a benchmark run as JSON to the given file, or to stdout if it is empty.
+ * @param frames Number of game frames the benchmark ran for.
+ * @param wall_seconds Host time the benchmark took.
+ * @param emulated_seconds Emulated time the benchmark covered.
+ */
+static void WriteBenchmarkReport(const Core::System& system, const std::string& path, u64 frames,
+                                 double wall_seconds, double emulated_seconds) {
+    std::vector<double> frametimes = system.perf_stats->GetFrametimes();
+    std::sort(frametimes.begin(), frametimes.end());
+    const double mean_frametime =
+        frametimes.empty() ? 0.0
+                           : std::accumulate(frametimes.begin(), frametimes.end(), 0.0) /
+                                 static_cast<double>(frametimes.size());
+
+    nlohmann::ordered_json report;
+    report["frames"] = frames;
+    report["wall_time"] = wall_seconds;
+    report["emulated_time"] = emulated_seconds;
+    report["emulation_speed"] = wall_seconds > 0.0 ? emulated_seconds / wall_seconds : 0.0;
+    report["game_fps"] = wall_seconds > 0.0 ? static_cast<double>(frames) / wall_seconds : 0.0;
+    report["frametime_ms"] = {
+        {"mean", mean_frametime},
+        {"p50", Percentile(frametimes, 0.5)},
+        {"p90", Percentile(frametimes, 0.9)},
+        {"p99", Percentile(frametimes, 0.99)},
+        {"max", frametimes.empty() ? 0.0 : frametimes.back()},
+    };
+
+#if MICROPROFILE_ENABLED
+    // Timers are accumulated since the benchmark started, the aggregate holds their totals.
+    {
+        std::scoped_lock lock{MicroProfileGetMutex()};
+        const MicroProfile& profile = *MicroProfileGet();
+        const double ms_per_tick = 1000.0 / static_cast<double>(MicroProfileTicksPerSecondCpu());
+        auto& timers = report["microprofile"] = nlohmann::ordered_json::array();
+        for (u32 i = 0; i < profile.nTotalTimers; ++i) {
+            const MicroProfileTimer& timer = profile.Aggregate[i];
+            if (timer.nCount == 0) {
+                continue;
+            }
+            timers.push_back({
+                {"group", profile.GroupInfo[profile.TimerToGroup[i]].pName},
+                {"name", profile.TimerInfo[i].pName},
+                {"total_ms", static_cast<double>(timer.nTicks) * ms_per_tick},
+                {"calls", timer.nCount},
+            });
+        }
+    }
+#endif
+
+    const std::string output = report.dump(4);
+    if (path.empty()) {
+        std::cout << output << std::endl;
+        return;
+    }
+    FileUtil::IOFile file(path, "w");
+    if (!file.IsOpen() || file.WriteString(output) != output.size()) {
+        LOG_ERROR(Frontend, "Failed to write the benchmark report to {}", path);
+    }
+}
+
 /// Application entry point
 int main(int argc, char** argv) {
     Common::Log::Initialize();
@@ -195,6 +283,11 @@ int main(int argc, char** argv) {
     std::string movie_record_author;
     std::string movie_play;
     std::string dump_video;
+    u64 benchmark_frames = 0;
+    std::string benchmark_report;
+    std::string profile_trace;
+    u64 fork_frame = 0;
+    std::vector<std::string> branch_movies;
 
     char* endarg;
 #ifdef _WIN32
@@ -223,6 +316,11 @@ int main(int argc, char** argv) {
         {"movie-record-author", required_argument, 0, 'a'},
         {"movie-play", required_argument, 0, 'p'},
         {"dump-video", required_argument, 0, 'd'},
+        {"benchmark", required_argument, 0, 'b'},
+        {"benchmark-report", required_argument, 0, 'o'},
+        {"profile-trace", required_argument, 0, 't'},
+        {"fork-frame", required_argument, 0, 'F'},
+        {"branch-movie", required_argument, 0, 'B'},
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
@@ -230,7 +328,7 @@ int main(int argc, char** argv) {
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:i:m:r:p:fhv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:i:m:r:p:b:o:t:F:B:fhv", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -299,6 +397,35 @@ int main(int argc, char** argv) {
             case 'd':
                 dump_video = optarg;
                 break;
+            case 'b':
+                errno = 0;
+                benchmark_frames = strtoull(optarg, &endarg, 0);
+                if (endarg == optarg || benchmark_frames == 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--benchmark");
+                    exit(1);
+                }
+                break;
+            case 'o':
+                benchmark_report = optarg;
+                break;
+            case 't':
+                profile_trace = optarg;
+                break;
+            case 'F':
+                errno = 0;
+                fork_frame = strtoull(optarg, &endarg, 0);
+                if (endarg == optarg)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--fork-frame");
+                    exit(1);
+                }
+                break;
+            case 'B':
+                branch_movies.emplace_back(optarg);
+                break;
             case 'f':
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
@@ -337,6 +464,11 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    if (!branch_movies.empty() && (!movie_record.empty() || !movie_play.empty())) {
+        LOG_CRITICAL(Frontend, "Branch movies replace the movie being played or recorded");
+        return -1;
+    }
+
     auto& system = Core::System::GetInstance();
     auto& movie = system.Movie();
 
@@ -350,6 +482,11 @@ int main(int argc, char** argv) {
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (benchmark_frames != 0) {
+        // Benchmarks run as fast as possible, inputs come from the movie being played if any.
+        Settings::values.frame_limit = 0;
+        Settings::values.use_vsync_new = false;
+    }
     system.ApplySettings();
 
     // Register frontend applets
@@ -493,6 +630,56 @@ int main(int argc, char** argv) {
         // if the secondary window isn't created, it shouldn't affect the main loop
         return secondary_window ? secondary_window->IsOpen() : true;
     };
+
+    if (benchmark_frames != 0) {
+#if MICROPROFILE_ENABLED
+        MicroProfileSetForceEnable(true);
+        MicroProfileSetEnableAllGroups(true);
+        MicroProfileSetAggregateFrames(0);
+#endif
+        LOG_INFO(Frontend, "Running benchmark for {} frames", benchmark_frames);
+    }
+    std::unique_ptr<Common::MicroProfileTraceWriter> profile_trace_writer;
+    if (!profile_trace.empty()) {
+        profile_trace_writer = std::make_unique<Common::MicroProfileTraceWriter>(profile_trace);
+    }
+
+    const auto benchmark_start = std::chrono::steady_clock::now();
+    const auto benchmark_start_us = system.CoreTiming().GetGlobalTimeUs();
+    const u64 benchmark_start_frame = system.perf_stats->GetGameFrameCount();
+
+    Core::BranchExplorer branch_explorer{system};
+    std::size_t next_branch = 0;
+    u64 branch_start_frame = 0;
+
+    // Forks once the fork frame is reached, then starts the next branch whenever the current one
+    // is done. Returns false after the last branch.
+    const auto advance_branches = [&] {
+        const u64 frame = system.perf_stats->GetGameFrameCount();
+        if (!branch_explorer.HasForkPoint()) {
+            if (frame < fork_frame) {
+                return true;
+            }
+            branch_explorer.Fork();
+        } else {
+            const bool movie_done = movie.GetPlayMode() != Core::Movie::PlayMode::Playing;
+            const bool out_of_frames =
+                benchmark_frames != 0 && frame - branch_start_frame >= benchmark_frames;
+            if (!movie_done && !out_of_frames) {
+                return true;
+            }
+            LOG_INFO(Frontend, "Branch {} ended after {} frames", branch_explorer.GetBranchCount(),
+                     frame - branch_start_frame);
+        }
+
+        if (next_branch == branch_movies.size()) {
+            return false;
+        }
+        branch_explorer.StartBranch(branch_movies[next_branch++]);
+        branch_start_frame = system.perf_stats->GetGameFrameCount();
+        return true;
+    };
+
     while (emu_window->IsOpen() && secondary_is_open()) {
         const auto result = system.RunLoop();
 
@@ -506,6 +693,39 @@ int main(int argc, char** argv) {
             LOG_ERROR(Frontend, "Error in main run loop: {}", result, system.GetStatusDetails());
             break;
         }
+
+        if (profile_trace_writer) {
+            profile_trace_writer->Flush();
+        }
+
+        if (!branch_movies.empty()) {
+            try {
+                if (!advance_branches()) {
+                    break;
+                }
+            } catch (const std::exception& e) {
+                LOG_CRITICAL(Frontend, "Unable to start branch: {}", e.what());
+                break;
+            }
+            continue;
+        }
+
+        if (benchmark_frames != 0 &&
+            system.perf_stats->GetGameFrameCount() - benchmark_start_frame >= benchmark_frames) {
+            break;
+        }
+    }
+
+    profile_trace_writer.reset();
+
+    if (benchmark_frames != 0) {
+        const std::chrono::duration<double> wall_time =
+            std::chrono::steady_clock::now() - benchmark_start;
+        const std::chrono::duration<double> emulated_time =
+            system.CoreTiming().GetGlobalTimeUs() - benchmark_start_us;
+        WriteBenchmarkReport(system, benchmark_report,
+                             system.perf_stats->GetGameFrameCount() - benchmark_start_frame,
+                             wall_time.count(), emulated_time.count());
     }
     emu_window->RequestClose();
     if (secondary_window) {
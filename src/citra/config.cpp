@@ -129,7 +129,14 @@ void Config::ReadValues() {
 
     // Core
     ReadSetting("Core", Settings::values.use_cpu_jit);
+    ReadSetting("Core", Settings::values.parallel_cpu_cores);
+    ReadSetting("Core", Settings::values.use_fastmem);
+    ReadSetting("Core", Settings::values.dyncom_block_profiling);
     ReadSetting("Core", Settings::values.cpu_clock_percentage);
+    ReadSetting("Core", Settings::values.enable_rewind);
+    ReadSetting("Core", Settings::values.rewind_frame_interval);
+    ReadSetting("Core", Settings::values.rewind_memory_budget);
+    ReadSetting("Core", Settings::values.movie_keyframe_interval);
 
     // Renderer
     ReadSetting("Renderer", Settings::values.graphics_api);
@@ -141,10 +148,23 @@ void Config::ReadValues() {
     ReadSetting("Renderer", Settings::values.use_hw_shader);
     ReadSetting("Renderer", Settings::values.shaders_accurate_mul);
     ReadSetting("Renderer", Settings::values.use_shader_jit);
+    ReadSetting("Renderer", Settings::values.vertex_cache_size);
+    ReadSetting("Renderer", Settings::values.parallel_vertex_shading);
+    ReadSetting("Renderer", Settings::values.cache_command_lists);
+    ReadSetting("Renderer", Settings::values.async_gpu);
+    ReadSetting("Renderer", Settings::values.async_surface_downloads);
+    ReadSetting("Renderer", Settings::values.surface_pool_size);
+    ReadSetting("Renderer", Settings::values.async_texture_filtering);
+    ReadSetting("Renderer", Settings::values.async_texture_upload);
+    ReadSetting("Renderer", Settings::values.deduplicate_textures);
     ReadSetting("Renderer", Settings::values.resolution_factor);
+    ReadSetting("Renderer", Settings::values.dynamic_resolution);
+    ReadSetting("Renderer", Settings::values.dynamic_resolution_target);
     ReadSetting("Renderer", Settings::values.use_disk_shader_cache);
     ReadSetting("Renderer", Settings::values.frame_limit);
+    ReadSetting("Renderer", Settings::values.turbo_present_interval);
     ReadSetting("Renderer", Settings::values.use_vsync_new);
+    ReadSetting("Renderer", Settings::values.max_queued_presents);
     ReadSetting("Renderer", Settings::values.texture_filter);
     ReadSetting("Renderer", Settings::values.texture_sampling);
 
@@ -152,6 +172,7 @@ void Config::ReadValues() {
     ReadSetting("Renderer", Settings::values.render_3d);
     ReadSetting("Renderer", Settings::values.factor_3d);
     ReadSetting("Renderer", Settings::values.pp_shader_name);
+    ReadSetting("Renderer", Settings::values.pp_shader_chain);
     ReadSetting("Renderer", Settings::values.anaglyph_shader_name);
     ReadSetting("Renderer", Settings::values.filter_mode);
 
@@ -177,13 +198,17 @@ void Config::ReadValues() {
 
     // Utility
     ReadSetting("Utility", Settings::values.dump_textures);
+    ReadSetting("Utility", Settings::values.fast_texture_dumping);
     ReadSetting("Utility", Settings::values.custom_textures);
     ReadSetting("Utility", Settings::values.preload_textures);
     ReadSetting("Utility", Settings::values.async_custom_loading);
+    ReadSetting("Utility", Settings::values.custom_texture_memory);
 
     // Audio
     ReadSetting("Audio", Settings::values.audio_emulation);
     ReadSetting("Audio", Settings::values.enable_audio_stretching);
+    ReadSetting("Audio", Settings::values.async_hle_audio);
+    ReadSetting("Audio", Settings::values.audio_latency);
     ReadSetting("Audio", Settings::values.volume);
     ReadSetting("Audio", Settings::values.output_type);
     ReadSetting("Audio", Settings::values.output_device);
@@ -230,6 +255,7 @@ void Config::ReadValues() {
     ReadSetting("System", Settings::values.init_ticks_override);
     ReadSetting("System", Settings::values.plugin_loader_enabled);
     ReadSetting("System", Settings::values.allow_plugin_loader);
+    ReadSetting("System", Settings::values.uds_frame_batching);
 
     {
         constexpr const char* default_init_time_offset = "0 00:00:00";
@@ -307,6 +333,7 @@ void Config::ReadValues() {
     // Miscellaneous
     ReadSetting("Miscellaneous", Settings::values.log_filter);
     ReadSetting("Miscellaneous", Settings::values.log_regex_filter);
+    ReadSetting("Miscellaneous", Settings::values.log_binary);
 
     // Apply the log_filter setting as the logger has already been initialized
     // and doesn't pick up the filter on its own.
@@ -314,11 +341,15 @@ void Config::ReadValues() {
     filter.ParseFilterString(Settings::values.log_filter.GetValue());
     Common::Log::SetGlobalFilter(filter);
     Common::Log::SetRegexFilter(Settings::values.log_regex_filter.GetValue());
+    Common::Log::SetBinaryBackendEnabled(Settings::values.log_binary.GetValue());
 
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
+    Settings::values.export_session_stats =
+        sdl2_config->GetBoolean("Debugging", "export_session_stats", false);
     ReadSetting("Debugging", Settings::values.renderer_debug);
+    ReadSetting("Debugging", Settings::values.gpu_timing);
     ReadSetting("Debugging", Settings::values.use_gdbstub);
     ReadSetting("Debugging", Settings::values.gdbstub_port);
 
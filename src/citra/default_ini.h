@@ -91,12 +91,42 @@ udp_pad_index=
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_cpu_jit =
 
+# Whether to run each emulated ARM11 core on its own host thread. Requires the JIT.
+# This speeds up titles that use the extra New 3DS cores, but is experimental.
+# 0 (default): Off, 1: On
+parallel_cpu_cores =
+
+# Whether the JIT accesses guest memory directly through a host mapping of the address space.
+# Requires the JIT and a host with 4KiB pages. Not supported on Windows.
+# 0 (default): Off, 1: On
+use_fastmem =
+
+# Whether the interpreter counts how often each block is entered, and logs the hottest ones when
+# emulation stops. Only used when the JIT is disabled. Slows down emulation.
+# 0 (default): Off, 1: On
+dyncom_block_profiling =
+
 # Change the Clock Frequency of the emulated 3DS CPU.
 # Underclocking can increase the performance of the game at the risk of freezing.
 # Overclocking may fix lag that happens on console, but also comes with the risk of freezing.
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# Periodically keep snapshots of the emulated system in memory, so that emulation can be rewound
+# 0 (default): Off, 1: On
+enable_rewind =
+
+# Number of game frames between two rewind snapshots. Range is 1 - 600, default is 60
+rewind_frame_interval =
+
+# Memory in MiB the rewind snapshots may use before the oldest ones are dropped
+# Range is 32 - 8192, default is 512
+rewind_memory_budget =
+
+# Number of game frames between two savestate keyframes stored in recorded movies, which allow
+# seeking during playback. Range is 0 - 216000, 0 disables keyframes. Default is 3600
+movie_keyframe_interval =
+
 [Renderer]
 # Whether to render using OpenGL or Software
 # 0: Software, 1: OpenGL (default), 2: Vulkan
@@ -118,11 +148,63 @@ shaders_accurate_mul =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Number of entries of the post-transform vertex cache used when shading vertices on the CPU.
+# Larger caches avoid shading vertices of indexed meshes more than once.
+# 16 - 4096: Number of entries (default: 256)
+vertex_cache_size =
+
+# Whether large draws that are shaded on the CPU are split across multiple threads.
+# 0 (default): Off, 1: On
+parallel_vertex_shading =
+
+# Whether decoded PICA command lists are kept and replayed when a game resubmits an identical list.
+# 0 (default): Off, 1: On
+cache_command_lists =
+
+# Whether PICA command lists are processed on a dedicated GPU thread while the CPU carries on.
+# Not available with OpenGL. This is experimental.
+# 0 (default): Off, 1: On
+async_gpu =
+
+# Whether surfaces the game reads back every frame are copied to memory in the background, so the
+# CPU only waits for the GPU when the game accesses them.
+# 0 (default): Off, 1: On
+async_surface_downloads =
+
+# Maximum amount of memory in MiB held by released surface images that are kept for reuse.
+# 0: Off, 128 (default)
+surface_pool_size =
+
+# Whether upscaled textures are uploaded unfiltered and filtered during the next frame, so the
+# texture filter does not stall the draw that first uses them.
+# 0 (default): Off, 1: On
+async_texture_filtering =
+
+# Whether custom textures are uploaded by a thread with its own OpenGL context, the render thread
+# switches to them once the GPU received them. (OpenGL only)
+# 0 (default): Off, 1: On
+async_texture_upload =
+
+# Whether textures whose data matches a texture already in the cache are copied from it on the
+# GPU, instead of being decoded, uploaded and filtered again.
+# 0 (default): Off, 1: On
+deduplicate_textures =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
 use_vsync_new =
 
+# Limits how many presented frames may wait for the display before presenting blocks. Lower values
+# reduce input latency at the cost of throughput. Requires VK_KHR_present_wait on Vulkan.
+# 0 (default): Unlimited, 1 - 3: Maximum number of queued presents
+max_queued_presents =
+
+# Presents only every Nth frame while the speed limit is off or above 200%, which skips the
+# presentation and post-processing of the other frames. Screenshots and video dumps are unaffected.
+# 1 (default): Present every frame, 2 - 60: Present one frame out of this many
+turbo_present_interval =
+
 # Reduce stuttering by storing and loading generated shaders to disk
 # 0: Off, 1 (default. On)
 use_disk_shader_cache =
@@ -132,6 +214,15 @@ use_disk_shader_cache =
 # factor for the 3DS resolution
 resolution_factor =
 
+# Lowers the resolution of new render targets when the GPU takes longer than the target time to
+# render a frame, and raises it back up to resolution_factor once it has headroom. Vulkan only.
+# 0 (default): Off, 1: On
+dynamic_resolution =
+
+# GPU time per frame that dynamic resolution aims for, in milliseconds
+# 1 - 100: 12 (default)
+dynamic_resolution_target =
+
 # Texture filter
 # 0: None, 1: Anime4K, 2: Bicubic, 3: Nearest Neighbor, 4: ScaleForce, 5: xBRZ
 texture_filter =
@@ -171,6 +262,12 @@ mono_render_option =
 # Loaded from shaders if render_3d is off or side by side.
 pp_shader_name =
 
+# Post processing shaders that run over every screen before the one above, in order.
+# A comma separated list of shader names from shaders, each optionally followed by a colon and
+# the size of its output in multiples of the native 3DS resolution, like crt:1,sharpen
+# Passes without a size run at the internal resolution.
+pp_shader_chain =
+
 # The name of the shader to apply when render_3d is anaglyph.
 # Loaded from shaders/anaglyph
 anaglyph_shader_name =
@@ -225,6 +322,11 @@ large_screen_proportion =
 # 0 (default): Off, 1: On
 dump_textures =
 
+# Dumps textures as zstd compressed raw pixels, which are converted to PNG on the next boot.
+# Avoids encoding PNG files while playing.
+# 0 (default): Off, 1: On
+fast_texture_dumping =
+
 # Reads PNG files from load/textures/[Title ID]/ and replaces textures.
 # 0 (default): Off, 1: On
 custom_textures =
@@ -237,6 +339,11 @@ preload_textures =
 # 0: Off, 1 (default): On
 async_custom_loading =
 
+# Maximum amount of memory in MiB held by decoded custom textures. The least recently used
+# textures are released once it is exceeded and decoded again when needed.
+# 0 (default): Unlimited
+custom_texture_memory =
+
 [Audio]
 # Whether or not to enable DSP LLE
 # 0 (default): No, 1: Yes
@@ -252,6 +359,16 @@ enable_dsp_lle_thread =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not to generate HLE audio frames on a separate thread while the CPU runs.
+# Audio frames are published to the application one frame later.
+# 0 (default): No, 1: Yes
+async_hle_audio =
+
+# Maximum audio latency in milliseconds while audio stretching is inactive. Audio queued beyond it
+# is dropped, which keeps latency low when emulation runs faster than the audio output.
+# 0 (default): Unlimited
+audio_latency =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
@@ -319,6 +436,11 @@ init_ticks_type =
 # Defaults to 0.
 init_ticks_override =
 
+# Whether to coalesce the local wireless frames sent in a tick and relay fewer unchanged beacons.
+# Reduces the packet rate of multiplayer rooms. Every member of the room needs to support it.
+# 0 (default): No, 1: Yes
+uds_frame_batching =
+
 [Camera]
 # Which camera engine to use for the right outer camera
 # blank (default): a dummy camera that always returns black image
@@ -346,10 +468,18 @@ camera_inner_flip =
 # Examples: *:Debug Kernel.SVC:Trace Service.*:Critical
 log_filter = *:Info
 
+# Also write a compressed binary log, which is decoded with citra-log-decode
+# 0 (default): Off, 1: On
+log_binary =
+
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
 
+# Write the performance statistics of every session to the log directory on shutdown, in the
+# Prometheus text format and keyed by title ID. Boolean value
+export_session_stats =
+
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
@@ -358,6 +488,11 @@ gdbstub_port=24689
 # 0 (default): Off, 1: On
 renderer_debug =
 
+# Measures the time the host GPU spends on draws, texture uploads, blits, filters and presentation
+# with timestamp queries, shown in the performance statistics and microprofile
+# 0 (default): Off, 1: On
+gpu_timing =
+
 # To LLE a service module add "LLE\<module name>=true"
 
 [WebService]
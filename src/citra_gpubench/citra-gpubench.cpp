@@ -0,0 +1,421 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+
+// This needs to be included before getopt.h because the latter #defines symbols used by it
+#include "common/microprofile.h"
+
+#include "citra/config.h"
+#include "citra/emu_window/emu_window_sdl2.h"
+#ifdef ENABLE_OPENGL
+#include "citra/emu_window/emu_window_sdl2_gl.h"
+#endif
+#ifdef ENABLE_SOFTWARE_RENDERER
+#include "citra/emu_window/emu_window_sdl2_sw.h"
+#endif
+#ifdef ENABLE_VULKAN
+#include "citra/emu_window/emu_window_sdl2_vk.h"
+#endif
+#include "common/detached_tasks.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/log.h"
+#include "common/scope_exit.h"
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/memory.h"
+#include "core/tracer/citrace.h"
+#include "video_core/gpu.h"
+#include "video_core/pica/pica_core.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+extern "C" {
+// tells Nvidia drivers to use the dedicated GPU by default on laptops with switchable graphics
+__declspec(dllexport) unsigned long NvOptimusEnablement = 0x00000001;
+}
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Physical addresses of the register pages a trace may write to
+constexpr PAddr PADDR_LCD = 0x1ED02000 - Memory::IO_AREA_VADDR + Memory::IO_AREA_PADDR;
+constexpr PAddr PADDR_GPU = 0x1EF00000 - Memory::IO_AREA_VADDR + Memory::IO_AREA_PADDR;
+
+struct Trace {
+    CiTrace::CTHeader header;
+    std::vector<u8> data;
+
+    /// Returns the words of an initial state block, clamped to the end of the file
+    std::span<const u32> Words(u32 offset, u32 size) const {
+        if (offset >= data.size()) {
+            return {};
+        }
+        const std::size_t count = std::min<std::size_t>(size, (data.size() - offset) / 4);
+        return {reinterpret_cast<const u32*>(data.data() + offset), count};
+    }
+
+    std::span<const CiTrace::CTStreamElement> Stream() const {
+        const std::size_t count =
+            std::min<std::size_t>(header.stream_size, (data.size() - header.stream_offset) /
+                                                          sizeof(CiTrace::CTStreamElement));
+        return {reinterpret_cast<const CiTrace::CTStreamElement*>(data.data() +
+                                                                  header.stream_offset),
+                count};
+    }
+};
+
+/// Work done and time spent on a single frame of the trace
+struct FrameResult {
+    double cpu_ms;
+    double gpu_ms;
+    Pica::PicaCore::Stats stats;
+};
+
+bool LoadTrace(const std::string& filename, Trace& trace) {
+    FileUtil::IOFile file(filename, "rb");
+    if (!file.IsOpen()) {
+        LOG_CRITICAL(Frontend, "Failed to open trace {}", filename);
+        return false;
+    }
+
+    trace.data.resize(file.GetSize());
+    if (file.ReadBytes(trace.data.data(), trace.data.size()) != trace.data.size() ||
+        trace.data.size() < sizeof(CiTrace::CTHeader)) {
+        LOG_CRITICAL(Frontend, "Failed to read trace {}", filename);
+        return false;
+    }
+
+    std::memcpy(&trace.header, trace.data.data(), sizeof(CiTrace::CTHeader));
+    if (std::memcmp(trace.header.magic, CiTrace::CTHeader::ExpectedMagicWord(), 4) != 0 ||
+        trace.header.version != CiTrace::CTHeader::ExpectedVersion()) {
+        LOG_CRITICAL(Frontend, "{} is not a supported CiTrace file", filename);
+        return false;
+    }
+    if (trace.header.stream_offset > trace.data.size()) {
+        LOG_CRITICAL(Frontend, "Trace {} is truncated", filename);
+        return false;
+    }
+    return true;
+}
+
+/// Copies the register and shader state the trace was captured with to the PICA.
+void LoadInitialState(const Trace& trace, Pica::PicaCore& pica) {
+    const auto& initial = trace.header.initial_state_offsets;
+    const auto copy = [&](auto& dest, u32 offset, u32 size) {
+        const auto words = trace.Words(offset, size);
+        std::memcpy(std::addressof(dest), words.data(),
+                    std::min(words.size_bytes(), sizeof(dest)));
+    };
+
+    copy(pica.regs, initial.pica_registers, initial.pica_registers_size);
+    copy(pica.regs_lcd, initial.lcd_registers, initial.lcd_registers_size);
+    copy(pica.vs_setup.program_code, initial.vs_program_binary, initial.vs_program_binary_size);
+    copy(pica.vs_setup.swizzle_data, initial.vs_swizzle_data, initial.vs_swizzle_data_size);
+    pica.vs_setup.MarkProgramCodeDirty();
+    pica.vs_setup.MarkSwizzleDataDirty();
+
+    // Attributes and uniforms are stored as raw float24 values, four per vector.
+    const auto load_vectors = [&](auto& dest, u32 offset, u32 size) {
+        const auto words = trace.Words(offset, size);
+        for (std::size_t i = 0; i < dest.size() && 4 * i + 3 < words.size(); ++i) {
+            for (std::size_t comp = 0; comp < 4; ++comp) {
+                dest[i][comp] = Pica::f24::FromRaw(words[4 * i + comp]);
+            }
+        }
+    };
+    load_vectors(pica.input_default_attributes, initial.default_attributes,
+                 initial.default_attributes_size);
+    load_vectors(pica.vs_setup.uniforms.f, initial.vs_float_uniforms,
+                 initial.vs_float_uniforms_size);
+}
+
+/// Replays the trace once, returning the results of every frame marker reached.
+std::vector<FrameResult> ReplayTrace(const Trace& trace, Core::System& system) {
+    auto& gpu = system.GPU();
+    auto& pica = gpu.PicaCore();
+    auto& renderer = gpu.Renderer();
+    auto& memory = system.Memory();
+
+    std::vector<FrameResult> results;
+    Pica::PicaCore::Stats frame_start_stats = pica.stats;
+    auto frame_start = Clock::now();
+
+    for (const auto& element : trace.Stream()) {
+        switch (element.type) {
+        case CiTrace::MemoryLoad: {
+            const auto& load = element.memory_load;
+            u8* dest = memory.GetPhysicalPointer(load.physical_address);
+            if (!dest || static_cast<u64>(load.file_offset) + load.size > trace.data.size()) {
+                LOG_WARNING(Frontend, "Skipping memory load to {:#010X}", load.physical_address);
+                break;
+            }
+            std::memcpy(dest, trace.data.data() + load.file_offset, load.size);
+            renderer.Rasterizer()->InvalidateRegion(load.physical_address, load.size);
+            break;
+        }
+        case CiTrace::RegisterWrite: {
+            const PAddr addr = element.register_write.physical_address;
+            const bool is_lcd = addr >= PADDR_LCD && addr < PADDR_LCD + 0x1000;
+            const bool is_gpu = addr >= PADDR_GPU && addr < PADDR_GPU + 0x2000;
+            if (!is_lcd && !is_gpu) {
+                LOG_WARNING(Frontend, "Skipping write to unknown register {:#010X}", addr);
+                break;
+            }
+            gpu.WriteReg(addr - Memory::IO_AREA_PADDR + Memory::IO_AREA_VADDR,
+                         element.register_write.value);
+            break;
+        }
+        case CiTrace::FrameMarker: {
+            renderer.SwapBuffers();
+            const auto cpu_end = Clock::now();
+            renderer.WaitIdle();
+            const auto gpu_end = Clock::now();
+
+            const auto& stats = pica.stats;
+            results.push_back(FrameResult{
+                .cpu_ms = std::chrono::duration<double, std::milli>(cpu_end - frame_start).count(),
+                .gpu_ms = std::chrono::duration<double, std::milli>(gpu_end - cpu_end).count(),
+                .stats{
+                    .draws = stats.draws - frame_start_stats.draws,
+                    .accelerated_draws =
+                        stats.accelerated_draws - frame_start_stats.accelerated_draws,
+                    .indexed_vertices = stats.indexed_vertices - frame_start_stats.indexed_vertices,
+                    .vertex_cache_hits =
+                        stats.vertex_cache_hits - frame_start_stats.vertex_cache_hits,
+                    .cmd_list_lookups = stats.cmd_list_lookups - frame_start_stats.cmd_list_lookups,
+                    .cmd_list_cache_hits =
+                        stats.cmd_list_cache_hits - frame_start_stats.cmd_list_cache_hits,
+                },
+            });
+            frame_start_stats = stats;
+            frame_start = Clock::now();
+            break;
+        }
+        default:
+            LOG_ERROR(Frontend, "Unknown CiTrace stream element {:#X}",
+                      static_cast<u32>(element.type));
+            break;
+        }
+    }
+    return results;
+}
+
+double Percentage(u64 part, u64 total) {
+    return total != 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+}
+
+void PrintFrame(std::size_t index, const FrameResult& frame) {
+    const auto& stats = frame.stats;
+    fmt::print("frame {:5}: cpu {:8.3f} ms, gpu wait {:8.3f} ms, {:5} draws ({:5} accelerated), "
+               "vertex cache {:5.1f}%, cmdlist cache {:5.1f}%\n",
+               index, frame.cpu_ms, frame.gpu_ms, stats.draws, stats.accelerated_draws,
+               Percentage(stats.vertex_cache_hits, stats.indexed_vertices),
+               Percentage(stats.cmd_list_cache_hits, stats.cmd_list_lookups));
+}
+
+void PrintSummary(std::vector<FrameResult> frames) {
+    if (frames.empty()) {
+        fmt::print("The trace contains no frames\n");
+        return;
+    }
+
+    Pica::PicaCore::Stats total{};
+    double total_cpu_ms = 0.0;
+    double total_gpu_ms = 0.0;
+    for (const FrameResult& frame : frames) {
+        total_cpu_ms += frame.cpu_ms;
+        total_gpu_ms += frame.gpu_ms;
+        total.draws += frame.stats.draws;
+        total.accelerated_draws += frame.stats.accelerated_draws;
+        total.indexed_vertices += frame.stats.indexed_vertices;
+        total.vertex_cache_hits += frame.stats.vertex_cache_hits;
+        total.cmd_list_lookups += frame.stats.cmd_list_lookups;
+        total.cmd_list_cache_hits += frame.stats.cmd_list_cache_hits;
+    }
+
+    const auto frame_time = [](const FrameResult& frame) { return frame.cpu_ms + frame.gpu_ms; };
+    std::sort(frames.begin(), frames.end(), [&](const FrameResult& a, const FrameResult& b) {
+        return frame_time(a) < frame_time(b);
+    });
+    const auto percentile = [&](double p) {
+        const auto index = static_cast<std::size_t>(p * static_cast<double>(frames.size() - 1));
+        return frame_time(frames[index]);
+    };
+
+    const double count = static_cast<double>(frames.size());
+    fmt::print("{} frames, average cpu {:.3f} ms, average gpu wait {:.3f} ms\n", frames.size(),
+               total_cpu_ms / count, total_gpu_ms / count);
+    fmt::print("frame time: median {:.3f} ms, 99th percentile {:.3f} ms, max {:.3f} ms\n",
+               percentile(0.5), percentile(0.99), frame_time(frames.back()));
+    fmt::print("{} draws ({:.1f}% accelerated), vertex cache {:.1f}%, cmdlist cache {:.1f}%\n",
+               total.draws, Percentage(total.accelerated_draws, total.draws),
+               Percentage(total.vertex_cache_hits, total.indexed_vertices),
+               Percentage(total.cmd_list_cache_hits, total.cmd_list_lookups));
+}
+
+void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <trace.ctf>\n"
+                 "-r, --renderer=NAME  Renderer to replay with: software, opengl or vulkan\n"
+                 "-l, --loops=NUMBER   Replay the trace NUMBER times, the first is a warmup when\n"
+                 "                     looping more than once\n"
+                 "-q, --quiet          Only print the summary\n"
+                 "-h, --help           Display this help and exit\n";
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    Common::Log::Initialize();
+    Common::Log::SetColorConsoleBackendEnabled(true);
+    Common::Log::Start();
+    Common::DetachedTasks detached_tasks;
+    Config config;
+
+    std::string filepath;
+    u32 loops = 1;
+    bool quiet = false;
+
+    static struct option long_options[] = {
+        {"renderer", required_argument, 0, 'r'},
+        {"loops", required_argument, 0, 'l'},
+        {"quiet", no_argument, 0, 'q'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0},
+    };
+
+    int option_index = 0;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "r:l:qh", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'r': {
+                const std::string renderer{optarg};
+                if (renderer == "software") {
+                    Settings::values.graphics_api = Settings::GraphicsAPI::Software;
+                } else if (renderer == "opengl") {
+                    Settings::values.graphics_api = Settings::GraphicsAPI::OpenGL;
+                } else if (renderer == "vulkan") {
+                    Settings::values.graphics_api = Settings::GraphicsAPI::Vulkan;
+                } else {
+                    std::cout << "Unknown renderer " << renderer << "\n";
+                    PrintHelp(argv[0]);
+                    return -1;
+                }
+                break;
+            }
+            case 'l':
+                loops = std::max(static_cast<u32>(std::strtoul(optarg, nullptr, 0)), 1U);
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            }
+        } else {
+            filepath = argv[optind];
+            optind++;
+        }
+    }
+
+    MicroProfileOnThreadCreate("EmuThread");
+    SCOPE_EXIT({ MicroProfileShutdown(); });
+
+    if (filepath.empty()) {
+        LOG_CRITICAL(Frontend, "No trace specified");
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    Trace trace;
+    if (!LoadTrace(filepath, trace)) {
+        return -1;
+    }
+
+    // Frames are replayed back to back, with presentation left to the renderer.
+    Settings::values.frame_limit = 0;
+    Settings::values.use_vsync_new = false;
+
+    auto& system = Core::System::GetInstance();
+    EmuWindow_SDL2::InitializeSDL2();
+
+    const auto emu_window = [&]() -> std::unique_ptr<EmuWindow_SDL2> {
+        switch (Settings::values.graphics_api.GetValue()) {
+#ifdef ENABLE_OPENGL
+        case Settings::GraphicsAPI::OpenGL:
+            return std::make_unique<EmuWindow_SDL2_GL>(system, false, false);
+#endif
+#ifdef ENABLE_VULKAN
+        case Settings::GraphicsAPI::Vulkan:
+            return std::make_unique<EmuWindow_SDL2_VK>(system, false, false);
+#endif
+#ifdef ENABLE_SOFTWARE_RENDERER
+        case Settings::GraphicsAPI::Software:
+            return std::make_unique<EmuWindow_SDL2_SW>(system, false, false);
+#endif
+        default:
+            return nullptr;
+        }
+    }();
+    if (!emu_window) {
+        LOG_CRITICAL(Frontend, "The selected renderer is not available in this build");
+        return -1;
+    }
+
+    const auto scope = emu_window->Acquire();
+    if (system.InitHeadless(*emu_window) != Core::System::ResultStatus::Success) {
+        LOG_CRITICAL(Frontend, "Failed to initialize the emulated system");
+        return -1;
+    }
+    SCOPE_EXIT({ system.Shutdown(); });
+
+    // Nothing runs on the emulated CPU to receive GPU interrupts.
+    system.GPU().SetInterruptHandler([](Service::GSP::InterruptId) {});
+
+    std::thread render_thread([&emu_window] { emu_window->Present(); });
+
+    std::vector<FrameResult> frames;
+    for (u32 loop = 0; loop < loops && emu_window->IsOpen(); ++loop) {
+        LoadInitialState(trace, system.GPU().PicaCore());
+        system.GPU().Sync();
+
+        frames = ReplayTrace(trace, system);
+        if (loops > 1 && loop == 0) {
+            continue;
+        }
+        if (!quiet) {
+            for (std::size_t i = 0; i < frames.size(); ++i) {
+                PrintFrame(i, frames[i]);
+            }
+        }
+        PrintSummary(frames);
+    }
+
+    emu_window->RequestClose();
+    render_thread.join();
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/binary_log.h"
+#include "common/logging/log_entry.h"
+#include "common/logging/text_formatter.h"
+#include "common/zstd_compression.h"
+
+namespace {
+
+void PrintHelp(const char* argv0) {
+    fmt::print(stderr,
+               "Usage: {} <binary log> [output]\n"
+               "Converts a binary log written with log_binary enabled back into the text log.\n"
+               "The text is written to stdout if no output file is given.\n",
+               argv0);
+}
+
+} // Anonymous namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    FileUtil::IOFile input(argv[1], "rb");
+    if (!input.IsOpen()) {
+        fmt::print(stderr, "Could not open {}\n", argv[1]);
+        return -1;
+    }
+    std::vector<u8> compressed(input.GetSize());
+    if (input.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        fmt::print(stderr, "Could not read {}\n", argv[1]);
+        return -1;
+    }
+
+    // Every flush of the logger is an independent frame, so they are decompressed in parallel
+    const std::vector<u8> data = Common::Compression::DecompressDataZSTDFrames(
+        compressed, std::max(std::thread::hardware_concurrency(), 1U));
+    if (data.empty()) {
+        fmt::print(stderr, "{} is not a valid binary log\n", argv[1]);
+        return -1;
+    }
+
+    std::FILE* output = stdout;
+    if (argc == 3) {
+        output = std::fopen(argv[2], "w");
+        if (!output) {
+            fmt::print(stderr, "Could not create {}\n", argv[2]);
+            return -1;
+        }
+    }
+
+    const bool complete = Common::Log::DecodeBinaryLog(data, [output](const auto& entry) {
+        const std::string line = Common::Log::FormatLogMessage(entry).append(1, '\n');
+        std::fputs(line.c_str(), output);
+    });
+    if (output != stdout) {
+        std::fclose(output);
+    }
+    if (!complete) {
+        fmt::print(stderr, "The log is truncated or corrupted, stopped at the first bad entry\n");
+        return 1;
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <QMessageBox>
 #include <QPainter>
 #include <QWindow>
+#include <QtConcurrent/QtConcurrentRun>
 #include "citra_qt/bootmanager.h"
 #include "citra_qt/main.h"
 #include "common/color.h"
@@ -709,16 +710,22 @@ void GRenderWindow::CaptureScreenshot(u32 res_scale, const QString& screenshot_p
     }
 
     const auto layout{Layout::FrameLayoutFromResolutionScale(res_scale, is_secondary)};
-    screenshot_image = QImage(QSize(layout.width, layout.height), QImage::Format_RGB32);
+    // Each request owns its image, the renderer may still be reading back an earlier one
+    auto screenshot_image =
+        std::make_shared<QImage>(QSize(layout.width, layout.height), QImage::Format_RGB32);
     renderer.RequestScreenshot(
-        screenshot_image.bits(),
-        [this, screenshot_path](bool invert_y) {
-            const std::string std_screenshot_path = screenshot_path.toStdString();
-            if (screenshot_image.mirrored(false, invert_y).save(screenshot_path)) {
-                LOG_INFO(Frontend, "Screenshot saved to \"{}\"", std_screenshot_path);
-            } else {
-                LOG_ERROR(Frontend, "Failed to save screenshot to \"{}\"", std_screenshot_path);
-            }
+        screenshot_image->bits(),
+        [screenshot_image, screenshot_path](bool invert_y) {
+            // Encoding the PNG takes a while, keep it off the render thread
+            (void)QtConcurrent::run([screenshot_image, screenshot_path, invert_y] {
+                const std::string std_screenshot_path = screenshot_path.toStdString();
+                if (screenshot_image->mirrored(false, invert_y).save(screenshot_path)) {
+                    LOG_INFO(Frontend, "Screenshot saved to \"{}\"", std_screenshot_path);
+                } else {
+                    LOG_ERROR(Frontend, "Failed to save screenshot to \"{}\"",
+                              std_screenshot_path);
+                }
+            });
         },
         layout);
 }
@@ -207,8 +207,6 @@ private:
     /// should instead be shared from
     static std::unique_ptr<Frontend::GraphicsContext> main_context;
 
-    /// Temporary storage of the screenshot taken
-    QImage screenshot_image;
     QByteArray geometry;
     bool first_frame = false;
     bool has_focus = false;
@@ -175,9 +175,13 @@ std::vector<u16> Rgb2Yuv(const QImage& source, int width, int height) {
     auto dest = buffer.begin();
     bool write = false;
     int py, pu, pv;
+    // Read whole scanlines instead of going through QImage::pixel, which checks the bounds and
+    // converts the format of every pixel.
+    const QImage image = source.convertToFormat(QImage::Format_RGB32);
     for (int j = 0; j < height; ++j) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(j));
         for (int i = 0; i < width; ++i) {
-            QRgb rgb = source.pixel(i, j);
+            QRgb rgb = line[i];
             int r = qRed(rgb);
             int g = qGreen(rgb);
             int b = qBlue(rgb);
@@ -207,9 +211,8 @@ std::vector<u16> Rgb2Yuv(const QImage& source, int width, int height) {
 
 std::vector<u16> ProcessImage(const QImage& image, int width, int height, bool output_rgb = false,
                               bool flip_horizontal = false, bool flip_vertical = false) {
-    std::vector<u16> buffer(width * height);
     if (image.isNull()) {
-        return buffer;
+        return std::vector<u16>(width * height);
     }
     QImage scaled =
         image.scaled(width, height, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
@@ -218,11 +221,11 @@ std::vector<u16> ProcessImage(const QImage& image, int width, int height, bool o
             .mirrored(flip_horizontal, flip_vertical);
     if (output_rgb) {
         QImage converted = transformed.convertToFormat(QImage::Format_RGB16);
+        std::vector<u16> buffer(width * height);
         std::memcpy(buffer.data(), converted.bits(), width * height * sizeof(u16));
-    } else {
-        return CameraUtil::Rgb2Yuv(transformed, width, height);
+        return buffer;
     }
-    return buffer;
+    return CameraUtil::Rgb2Yuv(transformed, width, height);
 }
 
 } // namespace CameraUtil
@@ -54,7 +54,7 @@ const std::array<std::array<int, 5>, Settings::NativeAnalog::NumAnalogs> Config:
 // This must be in alphabetical order according to action name as it must have the same order as
 // UISetting::values.shortcuts, which is alphabetically ordered.
 // clang-format off
-const std::array<UISettings::Shortcut, 35> Config::default_hotkeys {{
+const std::array<UISettings::Shortcut, 36> Config::default_hotkeys {{
      {QStringLiteral("Advance Frame"),            QStringLiteral("Main Window"), {QStringLiteral(""),       Qt::ApplicationShortcut}},
      {QStringLiteral("Audio Mute/Unmute"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+M"), Qt::WindowShortcut}},
      {QStringLiteral("Audio Volume Down"),        QStringLiteral("Main Window"), {QStringLiteral(""),       Qt::WindowShortcut}},
@@ -78,6 +78,7 @@ const std::array<UISettings::Shortcut, 35> Config::default_hotkeys {{
      {QStringLiteral("Multiplayer Show Current Room"),        QStringLiteral("Main Window"), {QStringLiteral("Ctrl+R"), Qt::ApplicationShortcut}},
      {QStringLiteral("Remove Amiibo"),            QStringLiteral("Main Window"), {QStringLiteral("F3"),     Qt::ApplicationShortcut}},
      {QStringLiteral("Restart Emulation"),        QStringLiteral("Main Window"), {QStringLiteral("F6"),     Qt::WindowShortcut}},
+     {QStringLiteral("Rewind"),                   QStringLiteral("Main Window"), {QStringLiteral("Ctrl+Backspace"), Qt::WindowShortcut}},
      {QStringLiteral("Rotate Screens Upright"),   QStringLiteral("Main Window"), {QStringLiteral("F8"),     Qt::WindowShortcut}},
      {QStringLiteral("Save to Oldest Slot"),      QStringLiteral("Main Window"), {QStringLiteral("Ctrl+C"), Qt::WindowShortcut}},
      {QStringLiteral("Stop Emulation"),           QStringLiteral("Main Window"), {QStringLiteral("F5"),     Qt::WindowShortcut}},
@@ -281,6 +282,8 @@ void Config::ReadAudioValues() {
     ReadGlobalSetting(Settings::values.volume);
 
     if (global) {
+        ReadBasicSetting(Settings::values.async_hle_audio);
+        ReadBasicSetting(Settings::values.audio_latency);
         ReadBasicSetting(Settings::values.output_type);
         ReadBasicSetting(Settings::values.output_device);
         ReadBasicSetting(Settings::values.input_type);
@@ -447,6 +450,11 @@ void Config::ReadUtilityValues() {
     ReadGlobalSetting(Settings::values.preload_textures);
     ReadGlobalSetting(Settings::values.async_custom_loading);
 
+    if (global) {
+        ReadBasicSetting(Settings::values.fast_texture_dumping);
+        ReadBasicSetting(Settings::values.custom_texture_memory);
+    }
+
     qt_config->endGroup();
 }
 
@@ -457,6 +465,13 @@ void Config::ReadCoreValues() {
 
     if (global) {
         ReadBasicSetting(Settings::values.use_cpu_jit);
+        ReadBasicSetting(Settings::values.parallel_cpu_cores);
+        ReadBasicSetting(Settings::values.use_fastmem);
+        ReadBasicSetting(Settings::values.dyncom_block_profiling);
+        ReadBasicSetting(Settings::values.enable_rewind);
+        ReadBasicSetting(Settings::values.rewind_frame_interval);
+        ReadBasicSetting(Settings::values.rewind_memory_budget);
+        ReadBasicSetting(Settings::values.movie_keyframe_interval);
         ReadBasicSetting(Settings::values.delay_start_for_lle_modules);
     }
 
@@ -488,10 +503,13 @@ void Config::ReadDebuggingValues() {
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     Settings::values.record_frame_times =
         qt_config->value(QStringLiteral("record_frame_times"), false).toBool();
+    Settings::values.export_session_stats =
+        qt_config->value(QStringLiteral("export_session_stats"), false).toBool();
     ReadBasicSetting(Settings::values.use_gdbstub);
     ReadBasicSetting(Settings::values.gdbstub_port);
     ReadBasicSetting(Settings::values.renderer_debug);
     ReadBasicSetting(Settings::values.dump_command_buffers);
+    ReadBasicSetting(Settings::values.gpu_timing);
 
     qt_config->beginGroup(QStringLiteral("LLE"));
     for (const auto& service_module : Service::service_module_map) {
@@ -509,6 +527,7 @@ void Config::ReadLayoutValues() {
     ReadGlobalSetting(Settings::values.factor_3d);
     ReadGlobalSetting(Settings::values.filter_mode);
     ReadGlobalSetting(Settings::values.pp_shader_name);
+    ReadGlobalSetting(Settings::values.pp_shader_chain);
     ReadGlobalSetting(Settings::values.anaglyph_shader_name);
     ReadGlobalSetting(Settings::values.layout_option);
     ReadGlobalSetting(Settings::values.swap_screen);
@@ -537,6 +556,7 @@ void Config::ReadMiscellaneousValues() {
 
     ReadBasicSetting(Settings::values.log_filter);
     ReadBasicSetting(Settings::values.log_regex_filter);
+    ReadBasicSetting(Settings::values.log_binary);
     ReadBasicSetting(Settings::values.enable_gamemode);
 
     qt_config->endGroup();
@@ -655,7 +675,10 @@ void Config::ReadRendererValues() {
     ReadGlobalSetting(Settings::values.shaders_accurate_mul);
     ReadGlobalSetting(Settings::values.use_disk_shader_cache);
     ReadGlobalSetting(Settings::values.use_vsync_new);
+    ReadGlobalSetting(Settings::values.max_queued_presents);
     ReadGlobalSetting(Settings::values.resolution_factor);
+    ReadGlobalSetting(Settings::values.dynamic_resolution);
+    ReadGlobalSetting(Settings::values.dynamic_resolution_target);
     ReadGlobalSetting(Settings::values.frame_limit);
 
     ReadGlobalSetting(Settings::values.bg_red);
@@ -667,6 +690,16 @@ void Config::ReadRendererValues() {
 
     if (global) {
         ReadBasicSetting(Settings::values.use_shader_jit);
+        ReadBasicSetting(Settings::values.vertex_cache_size);
+        ReadBasicSetting(Settings::values.parallel_vertex_shading);
+        ReadBasicSetting(Settings::values.cache_command_lists);
+        ReadBasicSetting(Settings::values.async_gpu);
+        ReadBasicSetting(Settings::values.async_surface_downloads);
+        ReadBasicSetting(Settings::values.surface_pool_size);
+        ReadBasicSetting(Settings::values.async_texture_filtering);
+        ReadBasicSetting(Settings::values.async_texture_upload);
+        ReadBasicSetting(Settings::values.deduplicate_textures);
+        ReadBasicSetting(Settings::values.turbo_present_interval);
     }
 
     qt_config->endGroup();
@@ -708,6 +741,7 @@ void Config::ReadSystemValues() {
         ReadBasicSetting(Settings::values.init_ticks_override);
         ReadBasicSetting(Settings::values.plugin_loader_enabled);
         ReadBasicSetting(Settings::values.allow_plugin_loader);
+        ReadBasicSetting(Settings::values.uds_frame_batching);
     }
 
     qt_config->endGroup();
@@ -878,6 +912,8 @@ void Config::SaveAudioValues() {
     WriteGlobalSetting(Settings::values.volume);
 
     if (global) {
+        WriteBasicSetting(Settings::values.async_hle_audio);
+        WriteBasicSetting(Settings::values.audio_latency);
         WriteBasicSetting(Settings::values.output_type);
         WriteBasicSetting(Settings::values.output_device);
         WriteBasicSetting(Settings::values.input_type);
@@ -984,6 +1020,11 @@ void Config::SaveUtilityValues() {
     WriteGlobalSetting(Settings::values.preload_textures);
     WriteGlobalSetting(Settings::values.async_custom_loading);
 
+    if (global) {
+        WriteBasicSetting(Settings::values.fast_texture_dumping);
+        WriteBasicSetting(Settings::values.custom_texture_memory);
+    }
+
     qt_config->endGroup();
 }
 
@@ -994,6 +1035,13 @@ void Config::SaveCoreValues() {
 
     if (global) {
         WriteBasicSetting(Settings::values.use_cpu_jit);
+        WriteBasicSetting(Settings::values.parallel_cpu_cores);
+        WriteBasicSetting(Settings::values.use_fastmem);
+        WriteBasicSetting(Settings::values.dyncom_block_profiling);
+        WriteBasicSetting(Settings::values.enable_rewind);
+        WriteBasicSetting(Settings::values.rewind_frame_interval);
+        WriteBasicSetting(Settings::values.rewind_memory_budget);
+        WriteBasicSetting(Settings::values.movie_keyframe_interval);
         WriteBasicSetting(Settings::values.delay_start_for_lle_modules);
     }
 
@@ -1020,9 +1068,12 @@ void Config::SaveDebuggingValues() {
 
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     qt_config->setValue(QStringLiteral("record_frame_times"), Settings::values.record_frame_times);
+    qt_config->setValue(QStringLiteral("export_session_stats"),
+                        Settings::values.export_session_stats);
     WriteBasicSetting(Settings::values.use_gdbstub);
     WriteBasicSetting(Settings::values.gdbstub_port);
     WriteBasicSetting(Settings::values.renderer_debug);
+    WriteBasicSetting(Settings::values.gpu_timing);
 
     qt_config->beginGroup(QStringLiteral("LLE"));
     for (const auto& service_module : Settings::values.lle_modules) {
@@ -1040,6 +1091,7 @@ void Config::SaveLayoutValues() {
     WriteGlobalSetting(Settings::values.factor_3d);
     WriteGlobalSetting(Settings::values.filter_mode);
     WriteGlobalSetting(Settings::values.pp_shader_name);
+    WriteGlobalSetting(Settings::values.pp_shader_chain);
     WriteGlobalSetting(Settings::values.anaglyph_shader_name);
     WriteGlobalSetting(Settings::values.layout_option);
     WriteGlobalSetting(Settings::values.swap_screen);
@@ -1068,6 +1120,7 @@ void Config::SaveMiscellaneousValues() {
 
     WriteBasicSetting(Settings::values.log_filter);
     WriteBasicSetting(Settings::values.log_regex_filter);
+    WriteBasicSetting(Settings::values.log_binary);
     WriteBasicSetting(Settings::values.enable_gamemode);
 
     qt_config->endGroup();
@@ -1154,7 +1207,10 @@ void Config::SaveRendererValues() {
     WriteGlobalSetting(Settings::values.shaders_accurate_mul);
     WriteGlobalSetting(Settings::values.use_disk_shader_cache);
     WriteGlobalSetting(Settings::values.use_vsync_new);
+    WriteGlobalSetting(Settings::values.max_queued_presents);
     WriteGlobalSetting(Settings::values.resolution_factor);
+    WriteGlobalSetting(Settings::values.dynamic_resolution);
+    WriteGlobalSetting(Settings::values.dynamic_resolution_target);
     WriteGlobalSetting(Settings::values.frame_limit);
 
     WriteGlobalSetting(Settings::values.bg_red);
@@ -1167,6 +1223,16 @@ void Config::SaveRendererValues() {
     if (global) {
         WriteSetting(QStringLiteral("use_shader_jit"), Settings::values.use_shader_jit.GetValue(),
                      true);
+        WriteBasicSetting(Settings::values.vertex_cache_size);
+        WriteBasicSetting(Settings::values.parallel_vertex_shading);
+        WriteBasicSetting(Settings::values.cache_command_lists);
+        WriteBasicSetting(Settings::values.async_gpu);
+        WriteBasicSetting(Settings::values.async_surface_downloads);
+        WriteBasicSetting(Settings::values.surface_pool_size);
+        WriteBasicSetting(Settings::values.async_texture_filtering);
+        WriteBasicSetting(Settings::values.async_texture_upload);
+        WriteBasicSetting(Settings::values.deduplicate_textures);
+        WriteBasicSetting(Settings::values.turbo_present_interval);
     }
 
     qt_config->endGroup();
@@ -1207,6 +1273,7 @@ void Config::SaveSystemValues() {
         WriteBasicSetting(Settings::values.init_ticks_override);
         WriteBasicSetting(Settings::values.plugin_loader_enabled);
         WriteBasicSetting(Settings::values.allow_plugin_loader);
+        WriteBasicSetting(Settings::values.uds_frame_batching);
     }
 
     qt_config->endGroup();
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <QBrush>
 #include <QString>
 #include <QTreeWidgetItem>
@@ -28,6 +29,10 @@ IPCRecorderWidget::IPCRecorderWidget(Core::System& system_, QWidget* parent)
     connect(ui->filter, &QLineEdit::textChanged, this, &IPCRecorderWidget::ApplyFilterToAll);
     connect(ui->main, &QTreeWidget::itemDoubleClicked, this, &IPCRecorderWidget::OpenRecordDialog);
     connect(this, &IPCRecorderWidget::EntryUpdated, this, &IPCRecorderWidget::OnEntryUpdated);
+    connect(ui->statsEnabled, &QCheckBox::stateChanged, this,
+            [this](int new_state) { SetStatsEnabled(new_state == Qt::Checked); });
+    connect(ui->statsRefreshButton, &QPushButton::clicked, this, &IPCRecorderWidget::RefreshStats);
+    connect(ui->statsResetButton, &QPushButton::clicked, this, &IPCRecorderWidget::ResetStats);
 }
 
 IPCRecorderWidget::~IPCRecorderWidget() = default;
@@ -38,6 +43,8 @@ void IPCRecorderWidget::OnEmulationStarting() {
 
     // Update the enabled status when the system is powered on.
     SetEnabled(ui->enabled->isChecked());
+    SetStatsEnabled(ui->statsEnabled->isChecked());
+    ui->stats->clear();
 }
 
 QString IPCRecorderWidget::GetStatusStr(const IPCDebugger::RequestRecord& record) const {
@@ -115,6 +122,62 @@ void IPCRecorderWidget::SetEnabled(bool enabled) {
     }
 }
 
+void IPCRecorderWidget::SetStatsEnabled(bool enabled) {
+    if (!system.IsPoweredOn()) {
+        return;
+    }
+    system.Kernel().GetIPCRecorder().SetStatsEnabled(enabled);
+}
+
+void IPCRecorderWidget::RefreshStats() {
+    ui->stats->clear();
+    if (!system.IsPoweredOn()) {
+        return;
+    }
+
+    const auto stats = system.Kernel().GetIPCRecorder().GetServiceStats();
+    for (const auto& command : stats) {
+        const QString header_code =
+            QStringLiteral("0x%1").arg(command.command_id, 4, 16, QLatin1Char('0'));
+        const QString function =
+            command.function_name.empty()
+                ? header_code
+                : QStringLiteral("%1 (%2)")
+                      .arg(QString::fromStdString(command.function_name), header_code);
+
+        auto* item = new QTreeWidgetItem{{QString::fromStdString(command.service_name), function}};
+        // Store numbers instead of text so that the columns sort numerically
+        item->setData(2, Qt::DisplayRole, static_cast<qulonglong>(command.count));
+        item->setData(3, Qt::DisplayRole, static_cast<double>(command.total_ns) / 1000000.0);
+        item->setData(4, Qt::DisplayRole,
+                      static_cast<double>(command.total_ns) / 1000.0 /
+                          static_cast<double>(std::max<u64>(command.count, 1)));
+        item->setData(5, Qt::DisplayRole, static_cast<double>(command.max_ns) / 1000.0);
+
+        QStringList histogram;
+        for (std::size_t i = 0; i < command.histogram.size(); ++i) {
+            if (command.histogram[i] == 0) {
+                continue;
+            }
+            const QString bucket = i + 1 == command.histogram.size()
+                                       ? QStringLiteral(">= %1us").arg(1ULL << (i - 1))
+                                       : QStringLiteral("< %1us").arg(1ULL << i);
+            histogram.append(QStringLiteral("%1: %2").arg(bucket).arg(command.histogram[i]));
+        }
+        for (int column = 0; column < item->columnCount(); ++column) {
+            item->setToolTip(column, histogram.join(QLatin1Char('\n')));
+        }
+        ui->stats->addTopLevelItem(item);
+    }
+}
+
+void IPCRecorderWidget::ResetStats() {
+    if (system.IsPoweredOn()) {
+        system.Kernel().GetIPCRecorder().ClearServiceStats();
+    }
+    ui->stats->clear();
+}
+
 void IPCRecorderWidget::Clear() {
     id_offset += static_cast<int>(records.size());
 
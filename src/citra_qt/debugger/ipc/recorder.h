@@ -40,6 +40,9 @@ private:
     QString GetServiceName(const IPCDebugger::RequestRecord& record) const;
     QString GetFunctionName(const IPCDebugger::RequestRecord& record) const;
     void OpenRecordDialog(QTreeWidgetItem* item, int column);
+    void SetStatsEnabled(bool enabled);
+    void RefreshStats();
+    void ResetStats();
 
 private:
     std::unique_ptr<Ui::IPCRecorder> ui;
@@ -21,6 +21,7 @@
 #include <QStandardItem>
 #include <QStandardItemModel>
 #include <QThreadPool>
+#include <QTimer>
 #include <QToolButton>
 #include <QTreeView>
 #include <fmt/format.h>
@@ -292,9 +293,15 @@ void GameList::OnFilterCloseClicked() {
 }
 
 GameList::GameList(GMainWindow* parent) : QWidget{parent} {
+    // Copying a game triggers many notifications, only refresh once the directories are quiet
+    refresh_timer = new QTimer(this);
+    refresh_timer->setSingleShot(true);
+    refresh_timer->setInterval(500);
+    connect(refresh_timer, &QTimer::timeout, this, &GameList::RefreshGameDirectory);
+
     watcher = new QFileSystemWatcher(this);
-    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &GameList::RefreshGameDirectory,
-            Qt::UniqueConnection);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, refresh_timer,
+            qOverload<>(&QTimer::start), Qt::UniqueConnection);
 
     this->main_window = parent;
     layout = new QVBoxLayout;
@@ -355,11 +362,12 @@ void GameList::SetFilterVisible(bool visibility) {
 
 void GameList::SetDirectoryWatcherEnabled(bool enabled) {
     if (enabled) {
-        connect(watcher, &QFileSystemWatcher::directoryChanged, this,
-                &GameList::RefreshGameDirectory, Qt::UniqueConnection);
+        connect(watcher, &QFileSystemWatcher::directoryChanged, refresh_timer,
+                qOverload<>(&QTimer::start), Qt::UniqueConnection);
     } else {
-        disconnect(watcher, &QFileSystemWatcher::directoryChanged, this,
-                   &GameList::RefreshGameDirectory);
+        disconnect(watcher, &QFileSystemWatcher::directoryChanged, refresh_timer,
+                   qOverload<>(&QTimer::start));
+        refresh_timer->stop();
     }
 }
 
@@ -29,6 +29,7 @@ class QList;
 class QModelIndex;
 class QStandardItem;
 class QStandardItemModel;
+class QTimer;
 class QTreeView;
 class QToolButton;
 class QVBoxLayout;
@@ -127,6 +128,8 @@ private:
     QStandardItemModel* item_model = nullptr;
     GameListWorker* current_worker = nullptr;
     QFileSystemWatcher* watcher = nullptr;
+    /// Coalesces the bursts of change notifications of the watcher into a single refresh
+    QTimer* refresh_timer = nullptr;
     CompatibilityList compatibility_list;
 
     friend class GameListSearchField;
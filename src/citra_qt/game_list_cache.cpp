@@ -0,0 +1,151 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <span>
+#include "citra_qt/game_list_cache.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+
+namespace {
+
+constexpr u32 CacheMagic = 0x434C4747; // "GGLC"
+constexpr u32 CacheVersion = 1;
+
+std::string GetCachePath() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "game_list.bin";
+}
+
+template <typename T>
+void Write(std::vector<u8>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const u8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+/// Byte strings are stored with a u32 length prefix
+void WriteBytes(std::vector<u8>& out, std::span<const u8> bytes) {
+    Write(out, static_cast<u32>(bytes.size()));
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+class Reader {
+public:
+    explicit Reader(std::span<const u8> data_) : data{data_} {}
+
+    bool AtEnd() const {
+        return offset == data.size();
+    }
+
+    template <typename T>
+    bool Read(T& value) {
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename Container>
+    bool ReadBytes(Container& bytes) {
+        u32 size = 0;
+        if (!Read(size) || data.size() - offset < size) {
+            return false;
+        }
+        const auto* begin = data.data() + offset;
+        bytes.assign(begin, begin + size);
+        offset += size;
+        return true;
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t offset = 0;
+};
+
+} // Anonymous namespace
+
+GameListCache::GameListCache() {
+    FileUtil::IOFile file(GetCachePath(), "rb");
+    if (!file.IsOpen()) {
+        return;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadBytes(data.data(), data.size()) != data.size()) {
+        return;
+    }
+
+    Reader reader{data};
+    u32 magic = 0;
+    u32 version = 0;
+    if (!reader.Read(magic) || !reader.Read(version) || magic != CacheMagic ||
+        version != CacheVersion) {
+        LOG_INFO(Frontend, "Ignoring game list cache with a different version");
+        return;
+    }
+    while (!reader.AtEnd()) {
+        std::string path;
+        Entry entry{};
+        u8 listed = 0;
+        if (!reader.ReadBytes(path) || !reader.Read(entry.size) ||
+            !reader.Read(entry.modification_time) || !reader.Read(listed) ||
+            !reader.Read(entry.program_id) || !reader.Read(entry.extdata_id) ||
+            !reader.Read(entry.file_type) || !reader.ReadBytes(entry.smdh)) {
+            LOG_WARNING(Frontend, "Game list cache is truncated, ignoring its remaining entries");
+            break;
+        }
+        entry.listed = listed != 0;
+        loaded_entries.insert_or_assign(std::move(path), std::move(entry));
+    }
+}
+
+std::optional<GameListCache::Entry> GameListCache::Find(const std::string& path, u64 size,
+                                                        s64 modification_time) {
+    std::scoped_lock lock{mutex};
+    const auto it = loaded_entries.find(path);
+    if (it == loaded_entries.end() || it->second.size != size ||
+        it->second.modification_time != modification_time) {
+        return std::nullopt;
+    }
+    used_entries.insert_or_assign(path, it->second);
+    return it->second;
+}
+
+void GameListCache::Insert(const std::string& path, Entry entry) {
+    std::scoped_lock lock{mutex};
+    used_entries.insert_or_assign(path, std::move(entry));
+}
+
+void GameListCache::Save() {
+    std::vector<u8> data;
+    {
+        std::scoped_lock lock{mutex};
+        Write(data, CacheMagic);
+        Write(data, CacheVersion);
+        for (const auto& [path, entry] : used_entries) {
+            WriteBytes(data, std::span{reinterpret_cast<const u8*>(path.data()), path.size()});
+            Write(data, entry.size);
+            Write(data, entry.modification_time);
+            Write(data, static_cast<u8>(entry.listed));
+            Write(data, entry.program_id);
+            Write(data, entry.extdata_id);
+            Write(data, entry.file_type);
+            WriteBytes(data, entry.smdh);
+        }
+    }
+
+    // The cache is replaced at once, so that an interrupted save can't leave half of it
+    const std::string path = GetCachePath();
+    const std::string temp_path = path + ".tmp";
+    {
+        FileUtil::CreateFullPath(path);
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file.IsOpen() || file.WriteBytes(data.data(), data.size()) != data.size()) {
+            LOG_WARNING(Frontend, "Could not write the game list cache");
+            return;
+        }
+    }
+    FileUtil::Delete(path);
+    FileUtil::Rename(temp_path, path);
+}
@@ -0,0 +1,47 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * On-disk cache of the metadata the game list reads from every ROM, so that a refresh only opens
+ * the files that were added or modified since the last one. Entries are keyed by path and are
+ * only valid for the file size and modification time they were read with.
+ * Lookups and insertions are thread-safe.
+ */
+class GameListCache {
+public:
+    struct Entry {
+        u64 size;
+        s64 modification_time; ///< In milliseconds since the epoch
+        bool listed;           ///< Whether the file is an application shown in the game list
+        u64 program_id;
+        u64 extdata_id;
+        u32 file_type;         ///< Loader::FileType of the file
+        std::vector<u8> smdh;  ///< The SMDH of the file itself, without updates applied
+    };
+
+    /// Loads the cache file, starting with an empty cache if it is missing or invalid
+    GameListCache();
+
+    /// Returns the entry of path if it was read with the same size and modification time
+    std::optional<Entry> Find(const std::string& path, u64 size, s64 modification_time);
+
+    void Insert(const std::string& path, Entry entry);
+
+    /// Writes the entries found or inserted since the cache was loaded, dropping the others
+    void Save();
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> loaded_entries;
+    std::unordered_map<std::string, Entry> used_entries;
+};
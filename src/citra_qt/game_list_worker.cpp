@@ -6,10 +6,14 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
 #include "citra_qt/compatibility_list.h"
 #include "citra_qt/game_list.h"
+#include "citra_qt/game_list_cache.h"
 #include "citra_qt/game_list_p.h"
 #include "citra_qt/game_list_worker.h"
 #include "citra_qt/uisettings.h"
@@ -24,6 +28,36 @@ bool HasSupportedFileExtension(const std::string& file_name) {
     const QFileInfo file = QFileInfo(QString::fromStdString(file_name));
     return GameList::supported_file_extensions.contains(file.suffix(), Qt::CaseInsensitive);
 }
+
+/// Opens the file to read what the game list shows of it
+GameListCache::Entry ReadCacheEntry(const std::string& path, u64 size, s64 modification_time) {
+    GameListCache::Entry entry{
+        .size = size,
+        .modification_time = modification_time,
+        .listed = false,
+        .program_id = 0,
+        .extdata_id = 0,
+        .file_type = 0,
+        .smdh = {},
+    };
+    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(path);
+    if (!loader) {
+        return entry;
+    }
+
+    bool executable = false;
+    const auto res = loader->IsExecutable(executable);
+    if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
+        return entry;
+    }
+
+    entry.listed = true;
+    loader->ReadProgramId(entry.program_id);
+    loader->ReadExtdataId(entry.extdata_id);
+    loader->ReadIcon(entry.smdh);
+    entry.file_type = static_cast<u32>(loader->GetFileType());
+    return entry;
+}
 } // Anonymous namespace
 
 GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
@@ -46,75 +80,7 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader) {
-                return true;
-            }
-
-            bool executable = false;
-            const auto res = loader->IsExecutable(executable);
-            if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
-                return true;
-            }
-
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh;
-            // Look for an update icon if available
-            if (!(program_id & ~0x00040000FFFFFFFF)) {
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
-                if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
-                }
-            }
-
-            if (!Loader::IsValidSMDH(smdh)) {
-                // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
-            }
-
-            const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
-            if (Loader::IsValidSMDH(smdh)) {
-                if (system_title) {
-                    auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
-                    if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
-                        // Skip system titles without the visible flag.
-                        return true;
-                    }
-                }
-            } else if (UISettings::values.game_list_hide_no_icon || system_title) {
-                // Skip this invalid entry
-                return true;
-            }
-
-            auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
-
-            // The game list uses this as compatibility number for untested games
-            QString compatibility(QStringLiteral("99"));
-            if (it != compatibility_list.end())
-                compatibility = it->second.first;
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id, media_type),
-                    new GameListItemCompat(compatibility),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                },
-                parent_dir);
-
+            pending_files.push_back({physical_name, parent_dir, media_type});
         } else if (is_dir && recursion > 0) {
             watch_list.append(QString::fromStdString(physical_name));
             AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir, media_type);
@@ -126,8 +92,82 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
     FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
 }
 
+void GameListWorker::AddEntry(GameListCache& cache, const PendingFile& file) {
+    if (stop_processing) {
+        return;
+    }
+
+    const std::string& physical_name = file.path;
+    const QFileInfo file_info(QString::fromStdString(physical_name));
+    const u64 size = static_cast<u64>(file_info.size());
+    const s64 modification_time = file_info.lastModified().toMSecsSinceEpoch();
+    GameListCache::Entry entry;
+    if (auto cached = cache.Find(physical_name, size, modification_time)) {
+        entry = std::move(*cached);
+    } else {
+        entry = ReadCacheEntry(physical_name, size, modification_time);
+        cache.Insert(physical_name, entry);
+    }
+    if (!entry.listed) {
+        return;
+    }
+
+    const u64 program_id = entry.program_id;
+    std::vector<u8> smdh;
+    // Look for an update icon if available
+    if (!(program_id & ~0x00040000FFFFFFFF)) {
+        std::string update_path = Service::AM::GetTitleContentPath(
+            Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
+        if (FileUtil::Exists(update_path)) {
+            std::unique_ptr<Loader::AppLoader> update_loader = Loader::GetLoader(update_path);
+            if (update_loader) {
+                update_loader->ReadIcon(smdh);
+            }
+        }
+    }
+
+    if (!Loader::IsValidSMDH(smdh)) {
+        // Use the original smdh if there is no valid update smdh
+        smdh = std::move(entry.smdh);
+    }
+
+    const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
+    if (Loader::IsValidSMDH(smdh)) {
+        if (system_title) {
+            auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
+            if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
+                // Skip system titles without the visible flag.
+                return;
+            }
+        }
+    } else if (UISettings::values.game_list_hide_no_icon || system_title) {
+        // Skip this invalid entry
+        return;
+    }
+
+    auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
+
+    // The game list uses this as compatibility number for untested games
+    QString compatibility(QStringLiteral("99"));
+    if (it != compatibility_list.end())
+        compatibility = it->second.first;
+
+    const auto file_type = static_cast<Loader::FileType>(entry.file_type);
+    emit EntryReady(
+        {
+            new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
+                                 entry.extdata_id, file.media_type),
+            new GameListItemCompat(compatibility),
+            new GameListItemRegion(smdh),
+            new GameListItem(QString::fromStdString(Loader::GetFileTypeString(file_type))),
+            new GameListItemSize(size),
+        },
+        file.parent_dir);
+}
+
 void GameListWorker::run() {
     stop_processing = false;
+    pending_files.clear();
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == QStringLiteral("INSTALLED")) {
             QString games_path =
@@ -167,6 +207,18 @@ void GameListWorker::run() {
         }
     }
 
+    // Reading the files dominates on network storage, so more threads than cores are used
+    GameListCache cache;
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount() * 2);
+    for (const PendingFile& file : pending_files) {
+        pool.start([this, &cache, &file] { AddEntry(cache, file); });
+    }
+    pool.waitForDone();
+    if (!stop_processing) {
+        cache.Save();
+    }
+
     emit Finished(watch_list);
 }
 
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -19,6 +20,7 @@ namespace Service::FS {
 enum class MediaType : u32;
 }
 
+class GameListCache;
 class QStandardItem;
 
 /**
@@ -55,12 +57,24 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    /// A file with a supported extension found while traversing the game directories
+    struct PendingFile {
+        std::string path;
+        GameListDir* parent_dir;
+        Service::FS::MediaType media_type;
+    };
+
+    /// Adds the supported files of the directory tree to pending_files
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir, Service::FS::MediaType media_type);
 
+    /// Emits the entry of a file if it is an application, called from the threads of the pool
+    void AddEntry(GameListCache& cache, const PendingFile& file);
+
     QVector<UISettings::GameDir>& game_dirs;
     const CompatibilityList& compatibility_list;
 
+    std::vector<PendingFile> pending_files;
     QStringList watch_list;
     std::atomic_bool stop_processing;
 };
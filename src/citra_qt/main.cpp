@@ -87,6 +87,7 @@
 #include "core/hle/service/nfc/nfc.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
+#include "core/savestate.h"
 #include "core/system_titles.h"
 #include "input_common/main.h"
 #include "network/network_settings.h"
@@ -153,6 +154,7 @@ GMainWindow::GMainWindow(Core::System& system_)
     : ui{std::make_unique<Ui::MainWindow>()}, system{system_}, movie{system.Movie()},
       config{std::make_unique<Config>()}, emu_thread{nullptr} {
     Common::Log::Initialize();
+    Common::Log::SetBinaryBackendEnabled(Settings::values.log_binary.GetValue());
     Common::Log::Start();
 
     Debugger::ToggleConsole();
@@ -388,8 +390,17 @@ void GMainWindow::InitializeWidgets() {
     emu_frametime_label->setToolTip(
         tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
            "full-speed emulation this should be at most 16.67 ms."));
-
-    for (auto& label : {emu_speed_label, game_fps_label, emu_frametime_label}) {
+    texture_memory_label = new QLabel();
+    texture_memory_label->setToolTip(
+        tr("Memory occupied by cached textures out of the budget reported by the GPU driver. "
+           "The least recently used textures are recycled when the budget is exceeded."));
+    present_latency_label = new QLabel();
+    present_latency_label->setToolTip(
+        tr("Time from a frame being submitted by the emulator until it was shown on the display. "
+           "Only measured when the GPU driver supports present wait."));
+
+    for (auto& label : {emu_speed_label, game_fps_label, emu_frametime_label, texture_memory_label,
+                        present_latency_label}) {
         label->setVisible(false);
         label->setFrameStyle(QFrame::NoFrame);
         label->setContentsMargins(4, 0, 4, 0);
@@ -668,6 +679,11 @@ void GMainWindow::InitializeHotkeys() {
         Settings::values.frame_limit.SetGlobal(!Settings::values.frame_limit.UsingGlobal());
         UpdateStatusBar();
     });
+    connect_shortcut(QStringLiteral("Rewind"), [&] {
+        if (emulation_running) {
+            system.SendSignal(Core::System::Signal::Rewind);
+        }
+    });
     connect_shortcut(QStringLiteral("Toggle Texture Dumping"),
                      [&] { Settings::values.dump_textures = !Settings::values.dump_textures; });
     connect_shortcut(QStringLiteral("Toggle Custom Textures"),
@@ -1420,6 +1436,8 @@ void GMainWindow::ShutdownGame() {
     emu_speed_label->setVisible(false);
     game_fps_label->setVisible(false);
     emu_frametime_label->setVisible(false);
+    texture_memory_label->setVisible(false);
+    present_latency_label->setVisible(false);
 
     UpdateSaveStates();
 
@@ -1494,6 +1512,50 @@ void GMainWindow::UpdateSaveStates() {
     if (system.GetAppLoader().ReadProgramId(title_id) != Loader::ResultStatus::Success) {
         return;
     }
+    const auto savestates = Core::ListSaveStates(title_id, system.Movie().GetCurrentMovieID());
+    for (u32 i = 0; i < SaveStateSlotCount; ++i) {
+        actions_load_state[i]->setEnabled(false);
+        actions_load_state[i]->setText(tr("Slot %1").arg(i + 1));
+        actions_save_state[i]->setText(tr("Slot %1").arg(i + 1));
+    }
+    for (const auto& savestate : savestates) {
+        if (savestate.slot > SaveStateSlotCount) {
+            continue;
+        }
+        const bool display_name =
+            savestate.status == Core::SaveStateInfo::ValidationStatus::RevisionDismatch &&
+            !savestate.build_name.empty();
+        const auto text =
+            tr("Slot %1 - %2 %3")
+                .arg(savestate.slot)
+                .arg(QDateTime::fromSecsSinceEpoch(savestate.time)
+                         .toString(QStringLiteral("yyyy-MM-dd hh:mm:ss")))
+                .arg(display_name ? QString::fromStdString(savestate.build_name) : QLatin1String())
+                .trimmed();
+
+        actions_load_state[savestate.slot - 1]->setEnabled(true);
+        actions_load_state[savestate.slot - 1]->setText(text);
+        actions_save_state[savestate.slot - 1]->setText(text);
+
+        ui->action_Load_from_Newest_Slot->setEnabled(true);
+
+        if (savestate.time > newest_slot_time) {
+            newest_slot = savestate.slot;
+            newest_slot_time = savestate.time;
+        }
+        if (savestate.time < oldest_slot_time) {
+            oldest_slot = savestate.slot;
+            oldest_slot_time = savestate.time;
+        }
+    }
+    for (u32 i = 0; i < SaveStateSlotCount; ++i) {
+        if (!actions_load_state[i]->isEnabled()) {
+            // Prefer empty slot
+            oldest_slot = i + 1;
+            oldest_slot_time = 0;
+            break;
+        }
+    }
 }
 
 void GMainWindow::OnGameListLoadFile(QString game_path) {
@@ -1726,14 +1788,18 @@ void GMainWindow::InstallCIA(QStringList filepaths) {
     progress_bar->setMaximum(INT_MAX);
 
     (void)QtConcurrent::run([&, filepaths] {
-        Service::AM::InstallStatus status;
+        std::vector<std::string> paths;
+        paths.reserve(filepaths.size());
+        for (const auto& current_path : filepaths) {
+            paths.push_back(current_path.toStdString());
+        }
+        const auto cia_report = [&](std::size_t index, Service::AM::InstallStatus status) {
+            emit CIAInstallReport(status, filepaths[static_cast<qsizetype>(index)]);
+        };
         const auto cia_progress = [&](std::size_t written, std::size_t total) {
             emit UpdateProgress(written, total);
         };
-        for (const auto& current_path : filepaths) {
-            status = Service::AM::InstallCIA(current_path.toStdString(), cia_progress);
-            emit CIAInstallReport(status, current_path);
-        }
+        Service::AM::InstallCIAs(paths, cia_report, cia_progress);
         emit CIAInstallFinished();
     });
 }
@@ -2540,10 +2606,43 @@ void GMainWindow::UpdateStatusBar() {
     }
     game_fps_label->setText(tr("Game: %1 FPS").arg(results.game_fps, 0, 'f', 0));
     emu_frametime_label->setText(tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
+    const auto ms = [](double seconds) { return QString::number(seconds * 1000.0, 'f', 2); };
+    QString frametime_tooltip =
+        tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
+           "full-speed emulation this should be at most 16.67 ms.") +
+        QStringLiteral("\n\n") +
+        tr("Frame time p50 / p95 / p99: %1 / %2 / %3 ms\n"
+           "CPU: %4 ms, HLE services: %5 ms, GPU submission: %6 ms, Presentation: %7 ms")
+            .arg(ms(results.frametime_p50), ms(results.frametime_p95), ms(results.frametime_p99),
+                 ms(results.cpu_time), ms(results.service_time), ms(results.gpu_submit_time),
+                 ms(results.present_time));
+    if (Settings::values.gpu_timing.GetValue()) {
+        using GpuPass = Core::PerfStats::GpuPass;
+        const auto gpu_ms = [&](GpuPass pass) {
+            return ms(results.gpu_pass_time[static_cast<std::size_t>(pass)]);
+        };
+        frametime_tooltip +=
+            QStringLiteral("\n") +
+            tr("GPU draw: %1 ms, upload: %2 ms, blit: %3 ms, filter: %4 ms, present: %5 ms")
+                .arg(gpu_ms(GpuPass::Draw), gpu_ms(GpuPass::Upload), gpu_ms(GpuPass::Blit),
+                     gpu_ms(GpuPass::Filter), gpu_ms(GpuPass::Present));
+    }
+    emu_frametime_label->setToolTip(frametime_tooltip);
+    if (results.texture_memory_budget != 0) {
+        texture_memory_label->setText(tr("VRAM: %1 / %2 MiB")
+                                          .arg(results.texture_memory_usage >> 20)
+                                          .arg(results.texture_memory_budget >> 20));
+    }
+    if (results.present_latency != 0) {
+        present_latency_label->setText(
+            tr("Latency: %1 ms").arg(results.present_latency * 1000.0, 0, 'f', 2));
+    }
 
     emu_speed_label->setVisible(true);
     game_fps_label->setVisible(true);
     emu_frametime_label->setVisible(true);
+    texture_memory_label->setVisible(results.texture_memory_budget != 0);
+    present_latency_label->setVisible(results.present_latency != 0);
 }
 
 void GMainWindow::UpdateBootHomeMenuState() {
@@ -3042,6 +3141,12 @@ void GMainWindow::RetranslateStatusBar() {
     emu_frametime_label->setToolTip(
         tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
            "full-speed emulation this should be at most 16.67 ms."));
+    texture_memory_label->setToolTip(
+        tr("Memory occupied by cached textures out of the budget reported by the GPU driver. "
+           "The least recently used textures are recycled when the budget is exceeded."));
+    present_latency_label->setToolTip(
+        tr("Time from a frame being submitted by the emulator until it was shown on the display. "
+           "Only measured when the GPU driver supports present wait."));
 
     multiplayer_state->retranslateUi();
 }
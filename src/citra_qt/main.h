@@ -304,6 +304,8 @@ private:
     QLabel* emu_speed_label = nullptr;
     QLabel* game_fps_label = nullptr;
     QLabel* emu_frametime_label = nullptr;
+    QLabel* texture_memory_label = nullptr;
+    QLabel* present_latency_label = nullptr;
     QPushButton* graphics_api_button = nullptr;
     QPushButton* volume_button = nullptr;
     QWidget* volume_popup = nullptr;
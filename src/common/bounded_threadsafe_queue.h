@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
@@ -11,12 +12,65 @@
 #include <mutex>
 #include <new>
 
+#include "common/common_types.h"
 #include "common/polyfill_thread.h"
 
 namespace Common {
 
 namespace detail {
 constexpr std::size_t DefaultCapacity = 0x1000;
+
+/// Number of times a waiter rechecks the queue before parking its thread
+constexpr std::size_t SpinCount = 256;
+
+/**
+ * Lets one end of a queue park until the other end makes progress, using waitable atomics. Signal
+ * only wakes the futex when a thread is parked, so pushes and pops that don't have to wake anyone
+ * take neither a lock nor a syscall.
+ */
+class WaitPoint {
+public:
+    /// Spins, then parks until pred returns true or stop is requested on stop_token
+    template <typename Pred>
+    void Wait(Pred&& pred, std::stop_token stop_token = {}) {
+        for (std::size_t i = 0; i < SpinCount; i++) {
+            if (pred() || stop_token.stop_requested()) {
+                return;
+            }
+        }
+        std::stop_callback callback(stop_token, [this] { Wake(); });
+        while (!pred() && !stop_token.stop_requested()) {
+            const u32 old_epoch = epoch.load(std::memory_order::acquire);
+            waiting.store(true, std::memory_order::relaxed);
+            // Pairs with the fence in Signal, either the waiter sees the new state in pred or the
+            // signaller sees the flag and bumps the epoch.
+            std::atomic_thread_fence(std::memory_order::seq_cst);
+            if (!pred() && !stop_token.stop_requested()) {
+                epoch.wait(old_epoch, std::memory_order::acquire);
+            }
+        }
+    }
+
+    /// Wakes the threads parked in Wait, must be called after publishing the new state. Only the
+    /// first signal after a thread parked wakes the futex, the woken threads park again if needed.
+    void Signal() {
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (waiting.load(std::memory_order::relaxed) &&
+            waiting.exchange(false, std::memory_order::relaxed)) {
+            Wake();
+        }
+    }
+
+private:
+    void Wake() {
+        epoch.fetch_add(1, std::memory_order::release);
+        epoch.notify_all();
+    }
+
+    std::atomic<u32> epoch{0};
+    std::atomic_bool waiting{false};
+};
+
 } // namespace detail
 
 template <typename T, std::size_t Capacity = detail::DefaultCapacity>
@@ -248,4 +302,230 @@ private:
     std::mutex read_mutex;
 };
 
+/**
+ * Variant of SPSCQueue that waits on its indices with C++20 waitable atomics instead of condition
+ * variables. Neither end takes a lock, and an end only notifies when the other one is parked.
+ */
+template <typename T, std::size_t Capacity = detail::DefaultCapacity>
+class AtomicSPSCQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+    template <typename... Args>
+    bool TryEmplace(Args&&... args) {
+        const std::size_t write_index = m_write_index.load(std::memory_order::relaxed);
+        if (!HasFreeSlot(write_index)) {
+            return false;
+        }
+        Push(write_index, std::forward<Args>(args)...);
+        return true;
+    }
+
+    template <typename... Args>
+    void EmplaceWait(Args&&... args) {
+        const std::size_t write_index = m_write_index.load(std::memory_order::relaxed);
+        producer_wait.Wait([this, write_index] { return HasFreeSlot(write_index); });
+        Push(write_index, std::forward<Args>(args)...);
+    }
+
+    bool TryPop(T& t) {
+        const std::size_t read_index = m_read_index.load(std::memory_order::relaxed);
+        if (!HasData(read_index)) {
+            return false;
+        }
+        Pop(read_index, t);
+        return true;
+    }
+
+    void PopWait(T& t) {
+        const std::size_t read_index = m_read_index.load(std::memory_order::relaxed);
+        consumer_wait.Wait([this, read_index] { return HasData(read_index); });
+        Pop(read_index, t);
+    }
+
+    void PopWait(T& t, std::stop_token stop_token) {
+        const std::size_t read_index = m_read_index.load(std::memory_order::relaxed);
+        consumer_wait.Wait([this, read_index] { return HasData(read_index); }, stop_token);
+        if (stop_token.stop_requested()) {
+            return;
+        }
+        Pop(read_index, t);
+    }
+
+    T PopWait() {
+        T t;
+        PopWait(t);
+        return t;
+    }
+
+    T PopWait(std::stop_token stop_token) {
+        T t;
+        PopWait(t, stop_token);
+        return t;
+    }
+
+private:
+    bool HasFreeSlot(std::size_t write_index) const {
+        return write_index - m_read_index.load(std::memory_order::acquire) < Capacity;
+    }
+
+    bool HasData(std::size_t read_index) const {
+        return read_index != m_write_index.load(std::memory_order::acquire);
+    }
+
+    template <typename... Args>
+    void Push(std::size_t write_index, Args&&... args) {
+        m_data[write_index % Capacity] = T(std::forward<Args>(args)...);
+        m_write_index.store(write_index + 1, std::memory_order::release);
+        consumer_wait.Signal();
+    }
+
+    void Pop(std::size_t read_index, T& t) {
+        t = std::move(m_data[read_index % Capacity]);
+        m_read_index.store(read_index + 1, std::memory_order::release);
+        producer_wait.Signal();
+    }
+
+    alignas(128) std::atomic_size_t m_read_index{0};
+    detail::WaitPoint producer_wait;
+    alignas(128) std::atomic_size_t m_write_index{0};
+    detail::WaitPoint consumer_wait;
+
+    alignas(128) std::array<T, Capacity> m_data;
+};
+
+/**
+ * Variant of MPSCQueue on waitable atomics. Producers claim slots with a compare exchange on the
+ * write index instead of serializing on a mutex, and every slot carries a sequence number telling
+ * whether it is free, written or still being written.
+ */
+template <typename T, std::size_t Capacity = detail::DefaultCapacity>
+class AtomicMPSCQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+    AtomicMPSCQueue() {
+        for (std::size_t i = 0; i < Capacity; i++) {
+            m_slots[i].sequence.store(i, std::memory_order::relaxed);
+        }
+    }
+
+    template <typename... Args>
+    bool TryEmplace(Args&&... args) {
+        std::size_t write_index;
+        if (!ClaimSlot(write_index)) {
+            return false;
+        }
+        Push(write_index, std::forward<Args>(args)...);
+        return true;
+    }
+
+    template <typename... Args>
+    void EmplaceWait(Args&&... args) {
+        std::size_t write_index;
+        while (!ClaimSlot(write_index)) {
+            producer_wait.Wait([this] { return HasFreeSlot(); });
+        }
+        Push(write_index, std::forward<Args>(args)...);
+    }
+
+    bool TryPop(T& t) {
+        const std::size_t read_index = m_read_index.load(std::memory_order::relaxed);
+        if (!HasData(read_index)) {
+            return false;
+        }
+        Pop(read_index, t);
+        return true;
+    }
+
+    void PopWait(T& t) {
+        const std::size_t read_index = m_read_index.load(std::memory_order::relaxed);
+        consumer_wait.Wait([this, read_index] { return HasData(read_index); });
+        Pop(read_index, t);
+    }
+
+    void PopWait(T& t, std::stop_token stop_token) {
+        const std::size_t read_index = m_read_index.load(std::memory_order::relaxed);
+        consumer_wait.Wait([this, read_index] { return HasData(read_index); }, stop_token);
+        if (stop_token.stop_requested()) {
+            return;
+        }
+        Pop(read_index, t);
+    }
+
+    T PopWait() {
+        T t;
+        PopWait(t);
+        return t;
+    }
+
+    T PopWait(std::stop_token stop_token) {
+        T t;
+        PopWait(t, stop_token);
+        return t;
+    }
+
+private:
+    struct Slot {
+        /// Equals the write index that may claim the slot while it is free, and that plus one
+        /// once its value is written.
+        std::atomic_size_t sequence;
+        T value;
+    };
+
+    bool ClaimSlot(std::size_t& write_index) {
+        write_index = m_write_index.load(std::memory_order::relaxed);
+        while (true) {
+            const Slot& slot = m_slots[write_index % Capacity];
+            const std::size_t sequence = slot.sequence.load(std::memory_order::acquire);
+            if (sequence != write_index) {
+                if (sequence < write_index) {
+                    // The consumer did not pop the previous value of the slot yet, so it is full.
+                    return false;
+                }
+                write_index = m_write_index.load(std::memory_order::relaxed);
+                continue;
+            }
+            if (m_write_index.compare_exchange_weak(write_index, write_index + 1,
+                                                    std::memory_order::relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    bool HasFreeSlot() const {
+        const std::size_t write_index = m_write_index.load(std::memory_order::relaxed);
+        const Slot& slot = m_slots[write_index % Capacity];
+        return slot.sequence.load(std::memory_order::acquire) >= write_index;
+    }
+
+    bool HasData(std::size_t read_index) const {
+        const Slot& slot = m_slots[read_index % Capacity];
+        return slot.sequence.load(std::memory_order::acquire) == read_index + 1;
+    }
+
+    template <typename... Args>
+    void Push(std::size_t write_index, Args&&... args) {
+        Slot& slot = m_slots[write_index % Capacity];
+        slot.value = T(std::forward<Args>(args)...);
+        slot.sequence.store(write_index + 1, std::memory_order::release);
+        consumer_wait.Signal();
+    }
+
+    void Pop(std::size_t read_index, T& t) {
+        Slot& slot = m_slots[read_index % Capacity];
+        t = std::move(slot.value);
+        slot.sequence.store(read_index + Capacity, std::memory_order::release);
+        m_read_index.store(read_index + 1, std::memory_order::relaxed);
+        producer_wait.Signal();
+    }
+
+    alignas(128) std::atomic_size_t m_read_index{0};
+    detail::WaitPoint producer_wait;
+    alignas(128) std::atomic_size_t m_write_index{0};
+    detail::WaitPoint consumer_wait;
+
+    alignas(128) std::array<Slot, Capacity> m_slots;
+};
+
 } // namespace Common
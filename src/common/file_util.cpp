@@ -54,6 +54,8 @@
 #include <cstring>
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 
@@ -404,6 +406,24 @@ u64 GetSize(const std::string& filename) {
     return 0;
 }
 
+s64 GetModificationTime(const std::string& filename) {
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
+#elif ANDROID
+    // Storage access framework paths can't be stat'd
+    return 0;
+#else
+    if (stat(filename.c_str(), &buf) == 0)
+#endif
+    {
+        return static_cast<s64>(buf.st_mtime);
+    }
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+}
+
 u64 GetSize(const int fd) {
     struct stat buf;
     if (fstat(fd, &buf) != 0) {
@@ -1197,6 +1217,76 @@ std::size_t IOFile::ReadAtImpl(void* data, std::size_t length, std::size_t data_
     return pread(fileno(m_file), data, data_size * length, offset);
 }
 
+std::size_t IOFile::ReadAtRanges(std::span<const ReadRange> ranges) {
+    if (!IsOpen()) {
+        m_good = false;
+        return 0;
+    }
+
+    const int fd = fileno(m_file);
+    std::size_t total_read = 0;
+    for (std::size_t first = 0; first < ranges.size();) {
+        // Gather the ranges that continue each other in the file
+        constexpr std::size_t MaxRunRanges = 16;
+        std::size_t last = first + 1;
+        u64 run_end = ranges[first].offset + ranges[first].data.size();
+        while (last < ranges.size() && last - first < MaxRunRanges &&
+               ranges[last].offset == run_end) {
+            run_end += ranges[last].data.size();
+            last++;
+        }
+        const std::size_t run_size = static_cast<std::size_t>(run_end - ranges[first].offset);
+
+        std::size_t run_read = 0;
+#ifdef _WIN32
+        // ReadFileScatter needs unbuffered page aligned reads, so every range is read on its own
+        for (std::size_t i = first; i < last; i++) {
+            const std::size_t size = ranges[i].data.size();
+            const std::size_t read = pread(fd, ranges[i].data.data(), size, ranges[i].offset);
+            if (read == std::numeric_limits<std::size_t>::max()) {
+                break;
+            }
+            run_read += read;
+            if (read != size) {
+                break;
+            }
+        }
+#else
+        std::array<iovec, MaxRunRanges> iov;
+        for (std::size_t i = first; i < last; i++) {
+            iov[i - first] = {ranges[i].data.data(), ranges[i].data.size()};
+        }
+        std::size_t iov_index = 0;
+        while (run_read < run_size) {
+            const ssize_t read =
+                ::preadv(fd, iov.data() + iov_index, static_cast<int>(last - first - iov_index),
+                         static_cast<off_t>(ranges[first].offset + run_read));
+            if (read <= 0) {
+                break;
+            }
+            // Continue a short read where it stopped
+            run_read += static_cast<std::size_t>(read);
+            std::size_t remaining = static_cast<std::size_t>(read);
+            while (remaining != 0 && remaining >= iov[iov_index].iov_len) {
+                remaining -= iov[iov_index++].iov_len;
+            }
+            if (remaining != 0) {
+                iov[iov_index].iov_base = static_cast<u8*>(iov[iov_index].iov_base) + remaining;
+                iov[iov_index].iov_len -= remaining;
+            }
+        }
+#endif
+
+        total_read += run_read;
+        if (run_read != run_size) {
+            m_good = false;
+            break;
+        }
+        first = last;
+    }
+    return total_read;
+}
+
 std::size_t IOFile::WriteImpl(const void* data, std::size_t length, std::size_t data_size) {
     if (!IsOpen()) {
         m_good = false;
@@ -1228,6 +1318,51 @@ bool IOFile::Resize(u64 size) {
     return m_good;
 }
 
+FileMapping::FileMapping(const IOFile& file) {
+    const int fd = file.GetFd();
+    const u64 file_size = file.GetSize();
+    if (fd == -1 || file_size == 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_handle) {
+        LOG_ERROR(Common_Filesystem, "CreateFileMapping failed: {}", GetLastErrorMsg());
+        return;
+    }
+    void* const view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        LOG_ERROR(Common_Filesystem, "MapViewOfFile failed: {}", GetLastErrorMsg());
+        return;
+    }
+#else
+    void* const view = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "mmap failed: {}", GetLastErrorMsg());
+        return;
+    }
+#endif
+    data = static_cast<u8*>(view);
+    size = static_cast<std::size_t>(file_size);
+}
+
+FileMapping::~FileMapping() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping_handle) {
+        CloseHandle(mapping_handle);
+    }
+#else
+    if (data) {
+        munmap(data, size);
+    }
+#endif
+}
+
 template <typename T>
 using boost_iostreams = boost::iostreams::stream<T>;
 
@@ -10,6 +10,7 @@
 #include <ios>
 #include <limits>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -63,6 +64,9 @@ struct FSTEntry {
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(FILE* f);
 
+// Returns the last modification time of filename in seconds since the epoch, 0 if unknown
+[[nodiscard]] s64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -221,6 +225,12 @@ enum class DirectorySeparator {
 // and make forgetting an fclose() harder
 class IOFile : public NonCopyable {
 public:
+    /// Part of the file read by ReadAtRanges
+    struct ReadRange {
+        u64 offset;
+        std::span<u8> data;
+    };
+
     IOFile();
 
     // flags is used for windows specific file open mode flags, which
@@ -285,6 +295,14 @@ public:
         return ReadAtArray(reinterpret_cast<char*>(data), length, offset);
     }
 
+    /**
+     * Reads every range at its offset without moving the file position. Ranges that follow each
+     * other in the file are read with a single vectored read.
+     * @returns the number of bytes read, which stops at the first range that could not be read
+     *          completely
+     */
+    std::size_t ReadAtRanges(std::span<const ReadRange> ranges);
+
     template <typename T>
     std::size_t WriteBytes(const T* data, std::size_t length) {
         static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
@@ -351,6 +369,28 @@ private:
     u32 flags;
 };
 
+/**
+ * Read only view of the contents of an open file mapped into memory, which avoids copying them
+ * into a buffer before parsing. The view does not reflect later writes to the file.
+ */
+class FileMapping : public NonCopyable {
+public:
+    explicit FileMapping(const IOFile& file);
+    ~FileMapping();
+
+    /// Returns the mapped contents, empty when the file could not be mapped
+    [[nodiscard]] std::span<const u8> Data() const {
+        return {data, size};
+    }
+
+private:
+    u8* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
+};
+
 template <std::ios_base::openmode o, typename T>
 void OpenFStream(T& fstream, const std::string& filename);
 } // namespace FileUtil
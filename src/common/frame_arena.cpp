@@ -0,0 +1,59 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <bit>
+#include "common/frame_arena.h"
+
+namespace Common {
+
+FrameArena::FrameArena(std::size_t initial_size)
+    : block{new u8[initial_size]}, block_size{initial_size}, total_size{initial_size},
+      current{block.get()}, current_size{initial_size} {}
+
+FrameArena::~FrameArena() = default;
+
+void FrameArena::Reset() {
+    if (!overflow_blocks.empty()) {
+        // Grow the block to what the frame needed, so the next one fits in it
+        overflow_blocks.clear();
+        block_size = std::bit_ceil(total_size);
+        block.reset(new u8[block_size]);
+        total_size = block_size;
+    }
+    current = block.get();
+    current_size = block_size;
+    current_offset = 0;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* ptr = current + current_offset;
+    std::size_t space = current_size - current_offset;
+    if (!std::align(alignment, bytes, ptr, space)) {
+        const std::size_t size = std::max(bytes + alignment, current_size);
+        overflow_blocks.emplace_back(new u8[size]);
+        total_size += size;
+        current = overflow_blocks.back().get();
+        current_size = size;
+        ptr = current;
+        space = size;
+        std::align(alignment, bytes, ptr, space);
+    }
+    current_offset = static_cast<std::size_t>(static_cast<u8*>(ptr) - current) + bytes;
+    return ptr;
+}
+
+void FrameArena::do_deallocate(void* ptr, std::size_t bytes, std::size_t) {
+    // Temporaries freed before the next allocation, like a buffer in a loop, reuse the memory
+    u8* const begin = static_cast<u8*>(ptr);
+    if (begin >= current && begin + bytes == current + current_offset) {
+        current_offset = static_cast<std::size_t>(begin - current);
+    }
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace Common
@@ -0,0 +1,52 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Bump allocator for temporaries that don't outlive the frame they are created in, used through
+ * std::pmr containers. Allocating only moves a pointer. Deallocating gives the memory back only
+ * for the latest allocation, everything else is reclaimed at once by Reset. Allocations that don't
+ * fit in the block go to extra blocks, which Reset merges into a single larger block, so after a
+ * few frames the heap is not touched anymore. The arena is not thread safe.
+ */
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(std::size_t initial_size);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /// Releases every allocation of the frame, none of them may be in use anymore
+    void Reset();
+
+    /// Returns the size of the block allocations are made from after a reset
+    [[nodiscard]] std::size_t Capacity() const noexcept {
+        return block_size;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::unique_ptr<u8[]> block;
+    std::size_t block_size;
+    std::vector<std::unique_ptr<u8[]>> overflow_blocks;
+    std::size_t total_size; ///< Size of the block and the overflow blocks
+    u8* current;            ///< Block allocations are made from
+    std::size_t current_size;
+    std::size_t current_offset{};
+};
+
+} // namespace Common
@@ -0,0 +1,206 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include "common/arch.h"
+#include "common/hash.h"
+
+#if CITRA_ARCH(x86_64)
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+#if CITRA_ARCH(x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+namespace Common {
+
+namespace {
+
+constexpr u64 PRIME32_1 = 0x9E3779B1U;
+constexpr u64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr u64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr u64 PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr u64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+
+constexpr std::size_t NUM_LANES = 8;
+constexpr std::size_t STRIPE_SIZE = NUM_LANES * sizeof(u64);
+constexpr std::size_t STRIPES_PER_BLOCK = 16;
+
+/// Keys mixed into the input, offset by one lane per stripe so that reordering the stripes of a
+/// block changes the hash.
+constexpr auto SECRET = [] {
+    std::array<u64, STRIPES_PER_BLOCK + NUM_LANES> secret{};
+    u64 state = PRIME64_3;
+    for (u64& key : secret) {
+        // SplitMix64
+        u64 z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        key = z ^ (z >> 31);
+    }
+    return secret;
+}();
+
+using Accumulators = std::array<u64, NUM_LANES>;
+
+#if CITRA_ARCH(x86_64)
+TARGET_AVX2 __m256i AccumulateLanesAVX2(__m256i acc, const u8* data, const u64* keys) {
+    const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+    const __m256i keyed = _mm256_xor_si256(value, key);
+    const __m256i keyed_high = _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1));
+    const __m256i product = _mm256_mul_epu32(keyed, keyed_high);
+    const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm256_add_epi64(acc, _mm256_add_epi64(product, swapped));
+}
+
+/// AccumulateStripes with twice as many lanes per instruction
+TARGET_AVX2 void AccumulateStripesAVX2(Accumulators& acc, const u8* data,
+                                       std::size_t num_stripes, std::size_t first_key) {
+    const auto lanes = reinterpret_cast<__m256i*>(acc.data());
+    __m256i acc0 = _mm256_loadu_si256(lanes + 0);
+    __m256i acc1 = _mm256_loadu_si256(lanes + 1);
+    for (std::size_t stripe = 0; stripe < num_stripes; stripe++) {
+        const u8* stripe_data = data + stripe * STRIPE_SIZE;
+        const u64* keys = SECRET.data() + first_key + stripe;
+        acc0 = AccumulateLanesAVX2(acc0, stripe_data, keys);
+        acc1 = AccumulateLanesAVX2(acc1, stripe_data + 32, keys + 4);
+    }
+    _mm256_storeu_si256(lanes + 0, acc0);
+    _mm256_storeu_si256(lanes + 1, acc1);
+}
+#endif
+
+/**
+ * Accumulates num_stripes consecutive stripes, the key of each stripe starting one lane after the
+ * previous one from first_key. Every lane adds the product of the low and high halves of its keyed value and the
+ * value of its neighbour lane, which maps directly to 32-bit vector multiplies.
+ */
+void AccumulateStripes(Accumulators& acc, const u8* data, std::size_t num_stripes,
+                       std::size_t first_key = 0) {
+#if CITRA_ARCH(x86_64)
+    static const bool has_avx2 = Common::GetCPUCaps().avx2;
+    if (has_avx2) {
+        AccumulateStripesAVX2(acc, data, num_stripes, first_key);
+        return;
+    }
+    const auto accumulate = [](__m128i lane_acc, const u8* lane_data, const u64* keys) {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane_data));
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+        const __m128i keyed = _mm_xor_si128(value, key);
+        const __m128i keyed_high = _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product = _mm_mul_epu32(keyed, keyed_high);
+        const __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm_add_epi64(lane_acc, _mm_add_epi64(product, swapped));
+    };
+    const auto lanes = reinterpret_cast<__m128i*>(acc.data());
+    __m128i acc0 = _mm_loadu_si128(lanes + 0);
+    __m128i acc1 = _mm_loadu_si128(lanes + 1);
+    __m128i acc2 = _mm_loadu_si128(lanes + 2);
+    __m128i acc3 = _mm_loadu_si128(lanes + 3);
+    for (std::size_t stripe = 0; stripe < num_stripes; stripe++) {
+        const u8* stripe_data = data + stripe * STRIPE_SIZE;
+        const u64* keys = SECRET.data() + first_key + stripe;
+        acc0 = accumulate(acc0, stripe_data, keys);
+        acc1 = accumulate(acc1, stripe_data + 16, keys + 2);
+        acc2 = accumulate(acc2, stripe_data + 32, keys + 4);
+        acc3 = accumulate(acc3, stripe_data + 48, keys + 6);
+    }
+    _mm_storeu_si128(lanes + 0, acc0);
+    _mm_storeu_si128(lanes + 1, acc1);
+    _mm_storeu_si128(lanes + 2, acc2);
+    _mm_storeu_si128(lanes + 3, acc3);
+#elif CITRA_ARCH(arm64)
+    const auto accumulate = [](uint64x2_t lane_acc, const u8* lane_data, const u64* keys) {
+        const uint64x2_t value = vreinterpretq_u64_u8(vld1q_u8(lane_data));
+        const uint64x2_t keyed = veorq_u64(value, vld1q_u64(keys));
+        lane_acc = vaddq_u64(lane_acc, vextq_u64(value, value, 1));
+        return vmlal_u32(lane_acc, vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+    };
+    uint64x2_t acc0 = vld1q_u64(acc.data() + 0);
+    uint64x2_t acc1 = vld1q_u64(acc.data() + 2);
+    uint64x2_t acc2 = vld1q_u64(acc.data() + 4);
+    uint64x2_t acc3 = vld1q_u64(acc.data() + 6);
+    for (std::size_t stripe = 0; stripe < num_stripes; stripe++) {
+        const u8* stripe_data = data + stripe * STRIPE_SIZE;
+        const u64* keys = SECRET.data() + first_key + stripe;
+        acc0 = accumulate(acc0, stripe_data, keys);
+        acc1 = accumulate(acc1, stripe_data + 16, keys + 2);
+        acc2 = accumulate(acc2, stripe_data + 32, keys + 4);
+        acc3 = accumulate(acc3, stripe_data + 48, keys + 6);
+    }
+    vst1q_u64(acc.data() + 0, acc0);
+    vst1q_u64(acc.data() + 2, acc1);
+    vst1q_u64(acc.data() + 4, acc2);
+    vst1q_u64(acc.data() + 6, acc3);
+#else
+    for (std::size_t stripe = 0; stripe < num_stripes; stripe++) {
+        const u8* stripe_data = data + stripe * STRIPE_SIZE;
+        const u64* keys = SECRET.data() + first_key + stripe;
+        for (std::size_t i = 0; i < NUM_LANES; i++) {
+            u64 value;
+            std::memcpy(&value, stripe_data + i * sizeof(u64), sizeof(value));
+            const u64 keyed = value ^ keys[i];
+            acc[i ^ 1] += value;
+            acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+        }
+    }
+#endif
+}
+
+/// Mixes the accumulator bits between blocks, the multiplies above only spread them upwards.
+void Scramble(Accumulators& acc) {
+    for (std::size_t i = 0; i < NUM_LANES; i++) {
+        acc[i] = (acc[i] ^ (acc[i] >> 47) ^ SECRET[i + 1]) * PRIME32_1;
+    }
+}
+
+u64 Avalanche(u64 hash) {
+    hash ^= hash >> 37;
+    hash *= 0x165667919E3779F9ULL;
+    return hash ^ (hash >> 32);
+}
+
+} // Anonymous namespace
+
+u64 ComputeFastHash64(const void* data, std::size_t len) noexcept {
+    if (len <= STRIPE_SIZE) {
+        return ComputeHash64(data, len);
+    }
+
+    const u8* input = static_cast<const u8*>(data);
+    Accumulators acc = {PRIME32_1, PRIME64_1, PRIME64_2, PRIME64_3,
+                        PRIME64_4, PRIME64_2, PRIME64_1, PRIME32_1};
+
+    const std::size_t num_stripes = (len - 1) / STRIPE_SIZE;
+    const std::size_t num_blocks = num_stripes / STRIPES_PER_BLOCK;
+    for (std::size_t block = 0; block < num_blocks; block++) {
+        AccumulateStripes(acc, input + block * STRIPES_PER_BLOCK * STRIPE_SIZE,
+                          STRIPES_PER_BLOCK);
+        Scramble(acc);
+    }
+    AccumulateStripes(acc, input + num_blocks * STRIPES_PER_BLOCK * STRIPE_SIZE,
+                      num_stripes % STRIPES_PER_BLOCK);
+
+    // The last stripe overlaps the previous one when the length is not a multiple of its size.
+    // It is keyed like the stripe right after a block, which no other stripe uses.
+    AccumulateStripes(acc, input + len - STRIPE_SIZE, 1, STRIPES_PER_BLOCK);
+
+    u64 hash = len * PRIME64_1;
+    for (std::size_t i = 0; i < NUM_LANES; i++) {
+        hash ^= std::rotl(acc[i] * PRIME64_2, 31) * PRIME64_1;
+        hash = std::rotl(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    return Avalanche(hash);
+}
+
+} // namespace Common
@@ -0,0 +1,210 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/falloc.h>
+#include <sys/syscall.h>
+#else
+#include <fmt/format.h>
+#endif
+#endif
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+namespace Common {
+
+void HostMemory::ClearBacking(std::size_t offset, std::size_t length) {
+    ASSERT(offset + length <= backing_size);
+    const std::size_t page_size = HostPageSize();
+    const std::size_t begin = AlignUp(offset, page_size);
+    const std::size_t end = AlignDown(offset + length, page_size);
+    if (begin >= end) {
+        std::memset(backing_base + offset, 0, length);
+        return;
+    }
+
+    std::memset(backing_base + offset, 0, begin - offset);
+    std::memset(backing_base + end, 0, offset + length - end);
+    if (!ReleasePages(begin, end - begin)) {
+        std::memset(backing_base + begin, 0, end - begin);
+    }
+}
+
+#ifndef _WIN32
+
+/// Mirroring is done at the granularity of guest pages, which needs hosts with the same page size.
+constexpr long MirrorPageSize = 0x1000;
+
+static int CreateSharedMemory(std::size_t size) {
+    if (sysconf(_SC_PAGESIZE) != MirrorPageSize) {
+        LOG_INFO(Common_Memory, "Host page size doesn't allow memory mirroring");
+        return -1;
+    }
+
+#if defined(__linux__)
+    // Called through syscall() for older Android platform levels that lack the libc wrapper.
+    constexpr unsigned int MFD_CLOEXEC_FLAG = 0x0001U;
+    const int fd = static_cast<int>(syscall(SYS_memfd_create, "HostMemory", MFD_CLOEXEC_FLAG));
+#else
+    const std::string name = fmt::format("/citra-host-memory-{}", getpid());
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd != -1) {
+        shm_unlink(name.c_str());
+    }
+#endif
+    if (fd == -1) {
+        LOG_WARNING(Common_Memory, "Unable to create shared memory: {}", std::strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOG_WARNING(Common_Memory, "Unable to resize shared memory: {}", std::strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+HostMemory::HostMemory(std::size_t backing_size_) : backing_size{backing_size_} {
+    fd = CreateSharedMemory(backing_size);
+    if (fd != -1) {
+        void* const base = mmap(nullptr, backing_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED) {
+            backing_base = static_cast<u8*>(base);
+            return;
+        }
+        LOG_WARNING(Common_Memory, "Unable to map shared memory: {}", std::strerror(errno));
+        close(fd);
+        fd = -1;
+    }
+
+    // Private anonymous memory is committed on first touch as well, it just can't be mirrored.
+    void* const base = mmap(nullptr, backing_size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    ASSERT_MSG(base != MAP_FAILED, "Unable to allocate host memory: {}", std::strerror(errno));
+    backing_base = static_cast<u8*>(base);
+}
+
+HostMemory::~HostMemory() {
+    munmap(backing_base, backing_size);
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+std::size_t HostMemory::HostPageSize() {
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+bool HostMemory::ReleasePages(std::size_t offset, std::size_t length) {
+#if defined(__linux__)
+    // Punching a hole also drops the pages from every arena the backing is mirrored into.
+    if (fd != -1) {
+        return fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                         static_cast<off_t>(offset), static_cast<off_t>(length)) == 0;
+    }
+    return madvise(backing_base + offset, length, MADV_DONTNEED) == 0;
+#else
+    if (fd != -1) {
+        return false;
+    }
+    void* const ret = mmap(backing_base + offset, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+    return ret != MAP_FAILED;
+#endif
+}
+
+std::unique_ptr<VirtualArena> HostMemory::CreateArena(std::size_t virtual_size) const {
+    if (fd == -1) {
+        return nullptr;
+    }
+    void* const base = mmap(nullptr, virtual_size, PROT_NONE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        LOG_WARNING(Common_Memory, "Unable to reserve arena: {}", std::strerror(errno));
+        return nullptr;
+    }
+    return std::unique_ptr<VirtualArena>(
+        new VirtualArena(fd, static_cast<u8*>(base), virtual_size));
+}
+
+VirtualArena::VirtualArena(int fd_, u8* base_, std::size_t size_)
+    : fd{fd_}, base{base_}, size{size_} {}
+
+VirtualArena::~VirtualArena() {
+    munmap(base, size);
+}
+
+void VirtualArena::Map(std::size_t virtual_offset, std::size_t backing_offset, std::size_t length) {
+    ASSERT(virtual_offset + length <= size);
+    void* const ret = mmap(base + virtual_offset, length, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_FIXED, fd, static_cast<off_t>(backing_offset));
+    ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", std::strerror(errno));
+}
+
+void VirtualArena::Unmap(std::size_t virtual_offset, std::size_t length) {
+    ASSERT(virtual_offset + length <= size);
+    void* const ret = mmap(base + virtual_offset, length, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+    ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", std::strerror(errno));
+}
+
+#else
+
+HostMemory::HostMemory(std::size_t backing_size_) : backing_size{backing_size_} {
+    // Placeholder based views are only available on recent Windows versions, so mirroring is not
+    // supported there yet. Committed pages only become resident once they are touched.
+    void* const base =
+        VirtualAlloc(nullptr, backing_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    ASSERT_MSG(base != nullptr, "Unable to allocate host memory: {}", GetLastError());
+    backing_base = static_cast<u8*>(base);
+}
+
+HostMemory::~HostMemory() {
+    VirtualFree(backing_base, 0, MEM_RELEASE);
+}
+
+std::size_t HostMemory::HostPageSize() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+bool HostMemory::ReleasePages(std::size_t offset, std::size_t length) {
+    // Pages committed again after a decommit read as zero.
+    u8* const pointer = backing_base + offset;
+    return VirtualFree(pointer, length, MEM_DECOMMIT) &&
+           VirtualAlloc(pointer, length, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+std::unique_ptr<VirtualArena> HostMemory::CreateArena(std::size_t) const {
+    return nullptr;
+}
+
+VirtualArena::VirtualArena(int fd_, u8* base_, std::size_t size_)
+    : fd{fd_}, base{base_}, size{size_} {}
+
+VirtualArena::~VirtualArena() = default;
+
+void VirtualArena::Map(std::size_t, std::size_t, std::size_t) {
+    UNREACHABLE();
+}
+
+void VirtualArena::Unmap(std::size_t, std::size_t) {
+    UNREACHABLE();
+}
+
+#endif
+
+} // namespace Common
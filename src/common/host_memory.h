@@ -0,0 +1,91 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Inaccessible reservation of host address space that parts of a HostMemory backing can be
+ * mapped into. Accesses to any range that is not mapped fault.
+ */
+class VirtualArena {
+public:
+    ~VirtualArena();
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+
+    [[nodiscard]] u8* BasePointer() const noexcept {
+        return base;
+    }
+
+    /// Makes the backing range starting at backing_offset accessible at virtual_offset.
+    void Map(std::size_t virtual_offset, std::size_t backing_offset, std::size_t length);
+
+    /// Makes a range inaccessible again.
+    void Unmap(std::size_t virtual_offset, std::size_t length);
+
+private:
+    friend class HostMemory;
+
+    VirtualArena(int fd, u8* base, std::size_t size);
+
+    int fd;
+    u8* base;
+    std::size_t size;
+};
+
+/**
+ * Host memory backed by an anonymous shared memory object, so that any part of it can be mapped
+ * at several host addresses at once. Hosts that don't support this get a plain reservation, and no
+ * arenas can be created. Either way host pages are only committed once they are first touched.
+ */
+class HostMemory {
+public:
+    explicit HostMemory(std::size_t backing_size);
+    ~HostMemory();
+
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    /// Returns the zero-initialized backing memory.
+    [[nodiscard]] u8* BackingBasePointer() const noexcept {
+        return backing_base;
+    }
+
+    [[nodiscard]] std::size_t BackingSize() const noexcept {
+        return backing_size;
+    }
+
+    /// Returns whether backing pages can be mirrored into arenas at 4KiB granularity.
+    [[nodiscard]] bool SupportsMirroring() const noexcept {
+        return fd != -1;
+    }
+
+    /// Reserves an arena of virtual_size bytes, or returns nullptr if mirroring is unsupported.
+    [[nodiscard]] std::unique_ptr<VirtualArena> CreateArena(std::size_t virtual_size) const;
+
+    /**
+     * Zeroes a range of the backing. The whole host pages in it are handed back to the host
+     * instead of being written, so they are not resident until they are touched again.
+     */
+    void ClearBacking(std::size_t offset, std::size_t length);
+
+private:
+    static std::size_t HostPageSize();
+
+    /// Releases whole host pages of the backing. Returns false if they have to be zeroed instead.
+    bool ReleasePages(std::size_t offset, std::size_t length);
+
+    std::size_t backing_size;
+    int fd = -1;
+    u8* backing_base = nullptr;
+};
+
+} // namespace Common
@@ -2,7 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <boost/regex.hpp>
 
 #include <fmt/format.h>
@@ -21,11 +26,11 @@
 #include <signal.h>
 #endif
 
-#include "common/bounded_threadsafe_queue.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
 #include "common/literals.h"
 #include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
 #include "common/logging/log.h"
 #include "common/logging/log_entry.h"
 #include "common/logging/text_formatter.h"
@@ -33,6 +38,7 @@
 #include "common/settings.h"
 #include "common/string_util.h"
 #include "common/thread.h"
+#include "common/zstd_compression.h"
 
 namespace Common::Log {
 
@@ -140,6 +146,61 @@ private:
     std::size_t bytes_written = 0;
 };
 
+/**
+ * Backend that writes zstd compressed binary logs, which are decoded by citra-log-decode. The file
+ * is only created once the backend is enabled.
+ */
+class BinaryBackend final : public Backend {
+public:
+    explicit BinaryBackend(std::string filename_) : filename{std::move(filename_)} {}
+
+    ~BinaryBackend() override {
+        Flush();
+    }
+
+    void Write(const Entry& entry) override {
+        if (!enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (!file) {
+            static_cast<void>(FileUtil::Delete(filename + ".old"));
+            static_cast<void>(FileUtil::Rename(filename, filename + ".old"));
+            file = std::make_unique<FileUtil::IOFile>(filename, "wb", _SH_DENYWR);
+        }
+
+        encoder.Encode(entry, buffer);
+
+        using namespace Common::Literals;
+        // Every flush compresses the buffered entries into a separate zstd frame
+        if (buffer.size() >= 1_MiB || entry.log_level >= Level::Critical) {
+            Flush();
+        }
+    }
+
+    void Flush() override {
+        if (!file || buffer.empty()) {
+            return;
+        }
+        const auto compressed = Common::Compression::CompressDataZSTDDefault(buffer);
+        file->WriteBytes(compressed.data(), compressed.size());
+        file->Flush();
+        buffer.clear();
+    }
+
+    void EnableForStacktrace() override {}
+
+    void SetEnabled(bool enabled_) {
+        enabled = enabled_;
+    }
+
+private:
+    std::string filename;
+    std::unique_ptr<FileUtil::IOFile> file;
+    std::atomic_bool enabled{false};
+    BinaryLogEncoder encoder;
+    std::vector<u8> buffer;
+};
+
 /**
  * Backend that writes to Visual Studio's output window
  */
@@ -180,8 +241,103 @@ public:
 };
 #endif
 
+/**
+ * A log message that has not been written yet, either formatted already or holding the arguments
+ * to format on the logger thread.
+ */
+struct PendingEntry {
+    std::chrono::microseconds timestamp;
+    Class log_class{};
+    Level log_level{};
+    const char* filename = nullptr;
+    u32 line_num = 0;
+    const char* function = nullptr;
+    fmt::string_view format;
+    /// Formats the message from args, null if the message was formatted by the caller
+    DeferredFormatter formatter = nullptr;
+    const char* arg_types = nullptr;
+    std::array<u8, MAX_DEFERRED_ARGS_SIZE> args;
+    u8 args_size = 0;
+    std::string message;
+};
+
+/**
+ * Lock-free ring of the messages logged by a single thread, consumed by the logger thread.
+ * Messages are dropped instead of blocking the logging thread when the ring is full.
+ */
+class ThreadQueue {
+public:
+    static constexpr std::size_t Capacity = 512;
+
+    /// Called by the owning thread. Returns the entry to fill, or null if the ring is full.
+    PendingEntry* BeginPush() {
+        const std::size_t write = write_index.load(std::memory_order_relaxed);
+        if (write - read_index.load(std::memory_order_acquire) == Capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &entries[write % Capacity];
+    }
+
+    /// Called by the owning thread to publish the entry returned by BeginPush
+    void EndPush() {
+        write_index.store(write_index.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_release);
+    }
+
+    /// Called by the logger thread. Returns the oldest entry, or null if the ring is empty.
+    PendingEntry* Front() {
+        const std::size_t read = read_index.load(std::memory_order_relaxed);
+        if (read == write_index.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &entries[read % Capacity];
+    }
+
+    /// Called by the logger thread to release the entry returned by Front
+    void Pop() {
+        read_index.store(read_index.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_release);
+    }
+
+    /// Returns the number of messages dropped since the last call
+    u64 TakeDropped() {
+        return dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    /// Set when the owning thread exits, the ring is released once it is drained
+    std::atomic_bool thread_exited{false};
+
+private:
+    alignas(128) std::atomic_size_t read_index{0};
+    alignas(128) std::atomic_size_t write_index{0};
+    std::atomic<u64> dropped{0};
+    std::array<PendingEntry, Capacity> entries{};
+};
+
+/// Marks the queue of a thread as abandoned when the thread exits
+struct ThreadQueueOwner {
+    ~ThreadQueueOwner() {
+        if (queue) {
+            queue->thread_exited.store(true, std::memory_order_release);
+        }
+    }
+
+    std::shared_ptr<ThreadQueue> queue;
+};
+
+thread_local ThreadQueueOwner thread_queue_owner;
+
 bool initialization_in_progress_suppress_logging = true;
 
+/// Returns the name of the binary log written next to the text log
+std::string BinaryLogFilename(std::string_view text_filename) {
+    if (text_filename.ends_with(".txt")) {
+        text_filename.remove_suffix(4);
+    }
+    return fmt::format("{}.bin", text_filename);
+}
+
 #ifdef CITRA_LINUX_GCC_BACKTRACE
 [[noreturn]] void SleepForever() {
     while (true) {
@@ -252,23 +408,45 @@ public:
         color_console_backend.SetEnabled(enabled);
     }
 
+    void SetBinaryBackendEnabled(bool enabled) {
+        binary_backend.SetEnabled(enabled);
+    }
+
+    bool CheckMessage(Class log_class, Level log_level) const {
+        return filter.CheckMessage(log_class, log_level);
+    }
+
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, std::string message) {
-        if (!filter.CheckMessage(log_class, log_level)) {
+        PendingEntry* entry = BeginPush(log_class, log_level, filename, line_num, function);
+        if (!entry) {
             return;
         }
-        Entry new_entry =
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message));
-        if (!regex_filter.empty() &&
-            !boost::regex_search(FormatLogMessage(new_entry), regex_filter)) {
+        entry->formatter = nullptr;
+        entry->message = std::move(message);
+        EndPush(log_level);
+    }
+
+    void PushDeferredEntry(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, fmt::string_view format,
+                           DeferredFormatter formatter, const char* arg_types, const u8* args,
+                           std::size_t args_size) {
+        PendingEntry* entry = BeginPush(log_class, log_level, filename, line_num, function);
+        if (!entry) {
             return;
         }
-        message_queue.EmplaceWait(new_entry);
+        entry->format = format;
+        entry->formatter = formatter;
+        entry->arg_types = arg_types;
+        std::memcpy(entry->args.data(), args, args_size);
+        entry->args_size = static_cast<u8>(args_size);
+        EndPush(log_level);
     }
 
 private:
     Impl(const std::string& file_backend_filename, const Filter& filter_)
-        : filter{filter_}, file_backend{file_backend_filename} {
+        : filter{filter_}, file_backend{file_backend_filename},
+          binary_backend{BinaryLogFilename(file_backend_filename)} {
 #ifdef CITRA_LINUX_GCC_BACKTRACE
         int waker_pipefd[2];
         int done_printing_pipefd[2];
@@ -331,30 +509,111 @@ private:
 #endif
     }
 
+    PendingEntry* BeginPush(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_num, const char* function) {
+        auto& queue = thread_queue_owner.queue;
+        if (!queue) {
+            queue = std::make_shared<ThreadQueue>();
+            std::scoped_lock lock{queues_mutex};
+            queues.push_back(queue);
+        }
+        PendingEntry* entry = queue->BeginPush();
+        if (!entry) {
+            return nullptr;
+        }
+        entry->timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - time_origin);
+        entry->log_class = log_class;
+        entry->log_level = log_level;
+        entry->filename = filename;
+        entry->line_num = line_num;
+        entry->function = function;
+        return entry;
+    }
+
+    void EndPush(Level log_level) {
+        thread_queue_owner.queue->EndPush();
+        // The logger thread polls the queues, only wake it up early for messages which may
+        // precede a crash.
+        if (log_level >= Level::Error) {
+            wakeup_event.Set();
+        }
+    }
+
+    /// Moves the pending messages of every thread into batch, ordered by time
+    void CollectEntries(std::vector<Entry>& batch) {
+        std::vector<std::shared_ptr<ThreadQueue>> current_queues;
+        {
+            std::scoped_lock lock{queues_mutex};
+            // Release the queues of exited threads. Their last messages were published before the
+            // flag was set, so they are drained below.
+            std::erase_if(queues, [](const std::shared_ptr<ThreadQueue>& queue) {
+                return queue->thread_exited.load(std::memory_order_acquire) && !queue->Front();
+            });
+            current_queues = queues;
+        }
+
+        for (const auto& queue : current_queues) {
+            while (PendingEntry* pending = queue->Front()) {
+                std::string message =
+                    pending->formatter ? pending->formatter(pending->format, pending->args.data())
+                                       : std::move(pending->message);
+                Entry& entry = batch.emplace_back(CreateEntry(
+                    pending->log_class, pending->log_level, pending->filename, pending->line_num,
+                    pending->function, std::move(message)));
+                entry.timestamp = pending->timestamp;
+                if (pending->formatter) {
+                    entry.format = {pending->format.data(), pending->format.size()};
+                    entry.arg_types = pending->arg_types;
+                    entry.args = pending->args;
+                    entry.args_size = pending->args_size;
+                }
+                queue->Pop();
+            }
+            if (const u64 dropped = queue->TakeDropped(); dropped != 0) {
+                batch.push_back(CreateEntry(Class::Log, Level::Warning, "?", 0, "?",
+                                            fmt::format("Dropped {} log messages", dropped)));
+            }
+        }
+
+        std::stable_sort(batch.begin(), batch.end(), [](const Entry& a, const Entry& b) {
+            return a.timestamp < b.timestamp;
+        });
+    }
+
+    void WriteEntry(const Entry& entry) {
+        if (!regex_filter.empty() && !boost::regex_search(FormatLogMessage(entry), regex_filter)) {
+            return;
+        }
+        ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
+    }
+
     void StartBackendThread() {
         backend_thread = std::jthread([this](std::stop_token stop_token) {
             Common::SetCurrentThreadName("citra:Log");
-            Entry entry;
-            const auto write_logs = [this, &entry]() {
-                ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
-            };
+            using namespace std::chrono_literals;
+            std::vector<Entry> batch;
             while (!stop_token.stop_requested()) {
-                message_queue.PopWait(entry, stop_token);
-                if (entry.filename != nullptr) {
-                    write_logs();
+                wakeup_event.WaitUntil(std::chrono::steady_clock::now() + 10ms);
+                CollectEntries(batch);
+                for (const Entry& entry : batch) {
+                    WriteEntry(entry);
                 }
+                batch.clear();
             }
-            // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
-            // case where a system is repeatedly spamming logs even on close.
-            int max_logs_to_write = filter.IsDebug() ? INT_MAX : 100;
-            while (max_logs_to_write-- && message_queue.TryPop(entry)) {
-                write_logs();
+            // Drain the logging queues. Only writes out up to 100 messages to prevent a case
+            // where a system is repeatedly spamming logs even on close.
+            CollectEntries(batch);
+            const std::size_t max_logs_to_write = filter.IsDebug() ? batch.size() : 100;
+            for (std::size_t i = 0; i < std::min(batch.size(), max_logs_to_write); i++) {
+                WriteEntry(batch[i]);
             }
         });
     }
 
     void StopBackendThread() {
         backend_thread.request_stop();
+        wakeup_event.Set();
         if (backend_thread.joinable()) {
             backend_thread.join();
         }
@@ -383,6 +642,7 @@ private:
         lambda(static_cast<Backend&>(debugger_backend));
         lambda(static_cast<Backend&>(color_console_backend));
         lambda(static_cast<Backend&>(file_backend));
+        lambda(static_cast<Backend&>(binary_backend));
 #ifdef ANDROID
         lambda(static_cast<Backend&>(lc_backend));
 #endif
@@ -429,11 +689,16 @@ private:
     DebuggerBackend debugger_backend{};
     ColorConsoleBackend color_console_backend{};
     FileBackend file_backend;
+    BinaryBackend binary_backend;
 #ifdef ANDROID
     LogcatBackend lc_backend{};
 #endif
 
-    MPSCQueue<Entry> message_queue{};
+    /// Message queues of every thread that logged a message
+    std::vector<std::shared_ptr<ThreadQueue>> queues;
+    std::mutex queues_mutex;
+    /// Wakes up the logger thread before its next poll of the queues
+    Common::Event wakeup_event;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
     std::jthread backend_thread;
 
@@ -474,12 +739,34 @@ void SetColorConsoleBackendEnabled(bool enabled) {
     Impl::Instance().SetColorConsoleBackendEnabled(enabled);
 }
 
+void SetBinaryBackendEnabled(bool enabled) {
+    Impl::Instance().SetBinaryBackendEnabled(enabled);
+}
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, fmt::string_view format,
                        const fmt::format_args& args) {
-    if (!initialization_in_progress_suppress_logging) {
-        Impl::Instance().PushEntry(log_class, log_level, filename, line_num, function,
-                                   fmt::vformat(format, args));
+    if (initialization_in_progress_suppress_logging) {
+        return;
+    }
+    auto& instance = Impl::Instance();
+    if (instance.CheckMessage(log_class, log_level)) {
+        instance.PushEntry(log_class, log_level, filename, line_num, function,
+                           fmt::vformat(format, args));
+    }
+}
+
+void DeferredLogMessageImpl(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_num, const char* function, fmt::string_view format,
+                            DeferredFormatter formatter, const char* arg_types, const u8* args,
+                            std::size_t args_size) {
+    if (initialization_in_progress_suppress_logging) {
+        return;
+    }
+    auto& instance = Impl::Instance();
+    if (instance.CheckMessage(log_class, log_level)) {
+        instance.PushDeferredEntry(log_class, log_level, filename, line_num, function, format,
+                                   formatter, arg_types, args, args_size);
     }
 }
 } // namespace Common::Log
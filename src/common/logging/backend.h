@@ -33,4 +33,7 @@ void SetGlobalFilter(const Filter& filter);
 bool SetRegexFilter(const std::string& regex);
 
 void SetColorConsoleBackendEnabled(bool enabled);
+
+/// Enables writing a zstd compressed binary log next to the text log, decoded by citra-log-decode
+void SetBinaryBackendEnabled(bool enabled);
 } // namespace Common::Log
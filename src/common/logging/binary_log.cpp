@@ -0,0 +1,268 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <string>
+#include <fmt/args.h>
+#include <fmt/format.h>
+#include "common/logging/binary_log.h"
+#include "common/logging/log_entry.h"
+
+namespace Common::Log {
+
+namespace {
+
+constexpr u32 MAGIC = 0x474F4C43; // "CLOG"
+constexpr u32 VERSION = 1;
+
+enum class RecordType : u8 {
+    /// u32 id, u32 line, then the file name, function, format string and argument types
+    CallSite = 1,
+    /// u32 call site id, u64 timestamp in microseconds, u8 class, u8 level, u8 size, packed args
+    Message = 2,
+    /// u32 call site id, u64 timestamp in microseconds, u8 class, u8 level, string message
+    Text = 3,
+};
+
+template <typename T>
+void Write(std::vector<u8>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const u8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+/// Strings are stored with a u32 length prefix and without null terminator
+void WriteString(std::vector<u8>& out, std::string_view str) {
+    Write(out, static_cast<u32>(str.size()));
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+class Reader {
+public:
+    explicit Reader(std::span<const u8> data_) : data{data_} {}
+
+    bool AtEnd() const {
+        return offset == data.size();
+    }
+
+    template <typename T>
+    bool Read(T& value) {
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool ReadBytes(std::span<u8> out) {
+        if (data.size() - offset < out.size()) {
+            return false;
+        }
+        std::memcpy(out.data(), data.data() + offset, out.size());
+        offset += out.size();
+        return true;
+    }
+
+    bool ReadString(std::string& str) {
+        u32 size = 0;
+        if (!Read(size) || data.size() - offset < size) {
+            return false;
+        }
+        str.assign(reinterpret_cast<const char*>(data.data() + offset), size);
+        offset += size;
+        return true;
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t offset = 0;
+};
+
+struct DecodedCallSite {
+    u32 line_num;
+    std::string filename;
+    std::string function;
+    std::string format;
+    std::string arg_types;
+};
+
+template <typename T>
+void PushArg(fmt::dynamic_format_arg_store<fmt::format_context>& store, const u8* data,
+             std::size_t& offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    store.push_back(value);
+}
+
+/// Formats a message from its packed arguments, returns the format string if they are invalid
+std::string FormatMessage(const DecodedCallSite& site, std::span<const u8> args) {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    std::size_t offset = 0;
+    for (const char code : site.arg_types) {
+        const std::size_t remaining = args.size() - offset;
+        const auto push = [&]<typename T>(T*) {
+            if (remaining < sizeof(T)) {
+                return false;
+            }
+            PushArg<T>(store, args.data(), offset);
+            return true;
+        };
+        bool valid = false;
+        switch (code) {
+        case '?':
+            valid = push(static_cast<bool*>(nullptr));
+            break;
+        case 'c':
+            valid = push(static_cast<char*>(nullptr));
+            break;
+        case 'b':
+            valid = push(static_cast<s8*>(nullptr));
+            break;
+        case 'B':
+            valid = push(static_cast<u8*>(nullptr));
+            break;
+        case 'h':
+            valid = push(static_cast<s16*>(nullptr));
+            break;
+        case 'H':
+            valid = push(static_cast<u16*>(nullptr));
+            break;
+        case 'i':
+            valid = push(static_cast<s32*>(nullptr));
+            break;
+        case 'I':
+            valid = push(static_cast<u32*>(nullptr));
+            break;
+        case 'q':
+            valid = push(static_cast<s64*>(nullptr));
+            break;
+        case 'Q':
+            valid = push(static_cast<u64*>(nullptr));
+            break;
+        case 'f':
+            valid = push(static_cast<float*>(nullptr));
+            break;
+        case 'd':
+            valid = push(static_cast<double*>(nullptr));
+            break;
+        default:
+            break;
+        }
+        if (!valid) {
+            return site.format;
+        }
+    }
+
+    try {
+        return fmt::vformat(site.format, store);
+    } catch (const fmt::format_error&) {
+        return site.format;
+    }
+}
+
+} // Anonymous namespace
+
+std::size_t BinaryLogEncoder::CallSiteHash::operator()(const CallSite& site) const noexcept {
+    return std::hash<const void*>{}(site.filename) ^ std::hash<const void*>{}(site.format) ^
+           site.line_num;
+}
+
+void BinaryLogEncoder::Encode(const Entry& entry, std::vector<u8>& out) {
+    if (!header_written) {
+        Write(out, MAGIC);
+        Write(out, VERSION);
+        header_written = true;
+    }
+
+    // Messages formatted by the caller are identified by their source location only
+    const CallSite site{
+        .filename = entry.filename,
+        .line_num = entry.line_num,
+        .format = entry.format.data(),
+    };
+    auto [it, inserted] = call_site_ids.try_emplace(site, static_cast<u32>(call_site_ids.size()));
+    const u32 id = it->second;
+    if (inserted) {
+        Write(out, RecordType::CallSite);
+        Write(out, id);
+        Write(out, entry.line_num);
+        WriteString(out, entry.filename ? entry.filename : "");
+        WriteString(out, entry.function);
+        WriteString(out, entry.format);
+        WriteString(out, entry.arg_types ? entry.arg_types : "");
+    }
+
+    const bool packed = entry.format.data() != nullptr;
+    Write(out, packed ? RecordType::Message : RecordType::Text);
+    Write(out, id);
+    Write(out, static_cast<u64>(entry.timestamp.count()));
+    Write(out, entry.log_class);
+    Write(out, entry.log_level);
+    if (packed) {
+        Write(out, entry.args_size);
+        out.insert(out.end(), entry.args.begin(), entry.args.begin() + entry.args_size);
+    } else {
+        WriteString(out, entry.message);
+    }
+}
+
+bool DecodeBinaryLog(std::span<const u8> data, const std::function<void(const Entry&)>& callback) {
+    Reader reader{data};
+    u32 magic = 0;
+    u32 version = 0;
+    if (!reader.Read(magic) || !reader.Read(version) || magic != MAGIC || version != VERSION) {
+        return false;
+    }
+
+    std::vector<DecodedCallSite> call_sites;
+    while (!reader.AtEnd()) {
+        RecordType type{};
+        u32 id = 0;
+        if (!reader.Read(type) || !reader.Read(id)) {
+            return false;
+        }
+
+        if (type == RecordType::CallSite) {
+            DecodedCallSite site{};
+            if (id != call_sites.size() || !reader.Read(site.line_num) ||
+                !reader.ReadString(site.filename) || !reader.ReadString(site.function) ||
+                !reader.ReadString(site.format) || !reader.ReadString(site.arg_types)) {
+                return false;
+            }
+            call_sites.push_back(std::move(site));
+            continue;
+        }
+        if ((type != RecordType::Message && type != RecordType::Text) || id >= call_sites.size()) {
+            return false;
+        }
+
+        const DecodedCallSite& site = call_sites[id];
+        u64 timestamp = 0;
+        Entry entry{};
+        if (!reader.Read(timestamp) || !reader.Read(entry.log_class) ||
+            !reader.Read(entry.log_level)) {
+            return false;
+        }
+        if (type == RecordType::Message) {
+            if (!reader.Read(entry.args_size) || entry.args_size > entry.args.size() ||
+                !reader.ReadBytes(std::span{entry.args}.first(entry.args_size))) {
+                return false;
+            }
+            entry.message = FormatMessage(site, std::span{entry.args}.first(entry.args_size));
+        } else if (!reader.ReadString(entry.message)) {
+            return false;
+        }
+        entry.timestamp = std::chrono::microseconds{timestamp};
+        entry.filename = site.filename.c_str();
+        entry.line_num = site.line_num;
+        entry.function = site.function;
+        entry.format = site.format;
+        entry.arg_types = site.arg_types.c_str();
+        callback(entry);
+    }
+    return true;
+}
+
+} // namespace Common::Log
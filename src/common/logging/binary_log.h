@@ -0,0 +1,52 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common::Log {
+
+struct Entry;
+
+/**
+ * Encodes log entries into the compact binary log format. The source location, format string and
+ * argument types of every log call are stored once, after which its messages only store the
+ * timestamp, class, level and packed arguments. Messages formatted by the caller store their text.
+ * All values are stored in little endian.
+ */
+class BinaryLogEncoder {
+public:
+    /// Appends the encoded entry to out, preceded by the file header on the first call
+    void Encode(const Entry& entry, std::vector<u8>& out);
+
+private:
+    struct CallSite {
+        const char* filename;
+        u32 line_num;
+        const char* format;
+
+        bool operator==(const CallSite&) const = default;
+    };
+
+    struct CallSiteHash {
+        std::size_t operator()(const CallSite& site) const noexcept;
+    };
+
+    bool header_written = false;
+    std::unordered_map<CallSite, u32, CallSiteHash> call_site_ids;
+};
+
+/**
+ * Decodes a decompressed binary log, invoking callback with every entry in order.
+ * @returns false if the log is malformed or truncated, after decoding the entries preceding it.
+ */
+bool DecodeBinaryLog(std::span<const u8> data, const std::function<void(const Entry&)>& callback);
+
+} // namespace Common::Log
@@ -6,7 +6,12 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstring>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 
 #include "common/logging/formatter.h"
 #include "common/logging/types.h"
@@ -22,16 +27,99 @@ constexpr const char* TrimSourcePath(std::string_view source) {
     return source.data() + idx;
 }
 
+/// Formats a message from the arguments packed by DeferredLogMessageImpl
+using DeferredFormatter = std::string (*)(fmt::string_view format, const u8* args);
+
 /// Logs a message to the global logger, using fmt
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, fmt::string_view format,
                        const fmt::format_args& args);
 
+/**
+ * Logs a message to the global logger, formatting it on the logger thread. The format string and
+ * the argument types must outlive the logger and the arguments must be MAX_DEFERRED_ARGS_SIZE
+ * bytes or fewer.
+ */
+void DeferredLogMessageImpl(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_num, const char* function, fmt::string_view format,
+                            DeferredFormatter formatter, const char* arg_types, const u8* args,
+                            std::size_t args_size);
+
+namespace detail {
+
+/// Arguments that are copied by value and are formatted the same on any thread
+template <typename T>
+constexpr bool IsDeferrable =
+    (std::is_arithmetic_v<T> && !std::is_same_v<T, long double>) || std::is_enum_v<T>;
+
+/// Returns the code of the type of a packed argument, as stored in binary logs
+template <typename T>
+constexpr char ArgTypeCode() {
+    if constexpr (std::is_enum_v<T>) {
+        return ArgTypeCode<std::underlying_type_t<T>>();
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return '?';
+    } else if constexpr (std::is_same_v<T, char>) {
+        return 'c';
+    } else if constexpr (std::is_same_v<T, float>) {
+        return 'f';
+    } else if constexpr (std::is_same_v<T, double>) {
+        return 'd';
+    } else {
+        constexpr std::array<char, 4> signed_codes{'b', 'h', 'i', 'q'};
+        constexpr std::array<char, 4> unsigned_codes{'B', 'H', 'I', 'Q'};
+        constexpr std::size_t index = std::countr_zero(sizeof(T));
+        return std::is_signed_v<T> ? signed_codes[index] : unsigned_codes[index];
+    }
+}
+
+/// Codes of the types of the packed arguments, null terminated
+template <typename... Args>
+constexpr char ARG_TYPE_CODES[] = {ArgTypeCode<Args>()..., '\0'};
+
+template <typename... Args>
+constexpr bool CanDeferFormatting =
+    (IsDeferrable<Args> && ...) && (sizeof(Args) + ... + 0) <= MAX_DEFERRED_ARGS_SIZE;
+
+template <typename... Args>
+void PackArgs(u8* data, const Args&... args) {
+    std::size_t offset = 0;
+    ((std::memcpy(data + offset, &args, sizeof(Args)), offset += sizeof(Args)), ...);
+}
+
+template <typename... Args>
+std::string FormatPackedArgs(fmt::string_view format, const u8* data) {
+    std::tuple<Args...> args{};
+    std::size_t offset = 0;
+    std::apply(
+        [data, &offset](auto&... arg) {
+            ((std::memcpy(&arg, data + offset, sizeof(arg)), offset += sizeof(arg)), ...);
+        },
+        args);
+    return std::apply(
+        [format](const auto&... arg) {
+            return fmt::vformat(format, fmt::make_format_args(arg...));
+        },
+        args);
+}
+
+} // namespace detail
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, fmt::format_string<Args...> format, const Args&... args) {
-    FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
-                      fmt::make_format_args(args...));
+    // Messages with only numeric arguments are formatted by the logger thread, as the log macros
+    // always pass string literals as format strings.
+    if constexpr (detail::CanDeferFormatting<Args...>) {
+        std::array<u8, MAX_DEFERRED_ARGS_SIZE> packed;
+        detail::PackArgs(packed.data(), args...);
+        DeferredLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                               &detail::FormatPackedArgs<Args...>, detail::ARG_TYPE_CODES<Args...>,
+                               packed.data(), (sizeof(Args) + ... + 0));
+    } else {
+        FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                          fmt::make_format_args(args...));
+    }
 }
 
 } // namespace Common::Log
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <string>
+#include <string_view>
 
 #include "common/logging/types.h"
 
@@ -22,6 +25,12 @@ struct Entry {
     u32 line_num = 0;
     std::string function;
     std::string message;
+    /// Format string of a message formatted by the logger thread, empty otherwise
+    std::string_view format;
+    /// Type codes and packed values of the arguments of the format string
+    const char* arg_types = nullptr;
+    std::array<u8, MAX_DEFERRED_ARGS_SIZE> args;
+    u8 args_size = 0;
 };
 
 } // namespace Common::Log
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include "common/common_types.h"
 
 namespace Common::Log {
@@ -105,4 +106,7 @@ enum class Class : u8 {
     Count,           ///< Total number of logging classes
 };
 
+/// Maximum size of the arguments of a log message whose formatting is deferred
+constexpr std::size_t MAX_DEFERRED_ARGS_SIZE = 48;
+
 } // namespace Common::Log
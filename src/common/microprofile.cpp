@@ -5,3 +5,11 @@
 // Includes the MicroProfile implementation in this file for compilation
 #define MICROPROFILE_IMPL 1
 #include "common/microprofile.h"
+
+#include "common/thread.h"
+
+#if MICROPROFILE_ENABLED
+const char* MicroProfileGetThreadName() {
+    return Common::GetCurrentThreadName();
+}
+#endif
@@ -14,6 +14,7 @@
 #define MICROPROFILE_GPU_TIMERS 0 // TODO: Implement timer queries when we upgrade to OpenGL 3.3
 #define MICROPROFILE_CONTEXT_SWITCH_TRACE 0
 #define MICROPROFILE_PER_THREAD_BUFFER_SIZE (2048 << 13) // 16 MB
+#define MICROPROFILE_USE_THREAD_NAME_CALLBACK 1 // Implemented with Common::GetCurrentThreadName
 
 #ifdef _WIN32
 // This isn't defined by the standard library in MSVC2015
@@ -0,0 +1,140 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <mutex>
+#include <fmt/format.h>
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/microprofile_trace.h"
+
+namespace Common {
+
+#if MICROPROFILE_ENABLED
+
+namespace {
+
+/// Frames of the history that are never written to by the ongoing frame
+constexpr u32 MaxFlushFrames = MICROPROFILE_MAX_FRAME_HISTORY - MICROPROFILE_GPU_FRAME_DELAY - 3;
+
+/// Escapes a name for use in a JSON string
+std::string EscapeName(const char* name) {
+    std::string escaped;
+    for (const char* c = name; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            escaped.push_back('\\');
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20) {
+            escaped.push_back(*c);
+        }
+    }
+    return escaped;
+}
+
+} // Anonymous namespace
+
+MicroProfileTraceWriter::MicroProfileTraceWriter(const std::string& path)
+    : file{path, "w"}, named_threads(MICROPROFILE_MAX_THREADS) {
+    if (!file.IsOpen()) {
+        LOG_ERROR(Common, "Failed to open trace file {}", path);
+        return;
+    }
+    file.WriteString("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    MicroProfileSetForceEnable(true);
+    MicroProfileSetEnableAllGroups(true);
+
+    std::scoped_lock lock{MicroProfileGetMutex()};
+    const MicroProfile& profile = *MicroProfileGet();
+    next_frame = profile.nFrameCurrent;
+    base_tick = profile.Frames[next_frame].nFrameStartCpu;
+}
+
+MicroProfileTraceWriter::~MicroProfileTraceWriter() {
+    if (!file.IsOpen()) {
+        return;
+    }
+    Flush();
+    file.WriteString("\n]}\n");
+}
+
+void MicroProfileTraceWriter::Flush() {
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    std::scoped_lock lock{MicroProfileGetMutex()};
+    const MicroProfile& profile = *MicroProfileGet();
+    const u32 current_frame = profile.nFrameCurrent;
+    u32 num_frames = (current_frame + MICROPROFILE_MAX_FRAME_HISTORY - next_frame) %
+                     MICROPROFILE_MAX_FRAME_HISTORY;
+    if (num_frames > MaxFlushFrames) {
+        LOG_WARNING(Common, "Trace lost {} frames, flush more often", num_frames - MaxFlushFrames);
+        num_frames = MaxFlushFrames;
+    }
+    const u32 first_frame = (current_frame + MICROPROFILE_MAX_FRAME_HISTORY - num_frames) %
+                            MICROPROFILE_MAX_FRAME_HISTORY;
+    next_frame = current_frame;
+
+    const double us_per_tick = 1'000'000.0 / static_cast<double>(MicroProfileTicksPerSecondCpu());
+    for (u32 thread = 0; thread < profile.nNumLogs; ++thread) {
+        const MicroProfileThreadLog* log = profile.Pool[thread];
+        if (!log || log->nGpu) {
+            continue;
+        }
+
+        if (!named_threads[thread]) {
+            named_threads[thread] = true;
+            const std::string name = log->ThreadName[0] != '\0'
+                                         ? EscapeName(log->ThreadName)
+                                         : fmt::format("Thread {}", thread);
+            WriteEvent(fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},"
+                                   "\"args\":{{\"name\":\"{}\"}}}}",
+                                   thread, name));
+        }
+
+        const u32 log_start = profile.Frames[first_frame].nLogStart[thread];
+        const u32 log_end = profile.Frames[current_frame].nLogStart[thread];
+        for (u32 i = log_start; i != log_end; i = (i + 1) % MICROPROFILE_BUFFER_SIZE) {
+            const MicroProfileLogEntry entry = log->Log[i];
+            const int type = MicroProfileLogType(entry);
+            if (type != MP_LOG_ENTER && type != MP_LOG_LEAVE) {
+                continue;
+            }
+
+            const u64 timer = MicroProfileLogTimerIndex(entry);
+            const auto& timer_info = profile.TimerInfo[timer];
+            const auto& group_info = profile.GroupInfo[profile.TimerToGroup[timer]];
+            const double timestamp =
+                static_cast<double>(MicroProfileLogTickDifference(base_tick, entry)) * us_per_tick;
+            WriteEvent(fmt::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3f},"
+                                   "\"pid\":0,\"tid\":{}}}",
+                                   EscapeName(timer_info.pName), EscapeName(group_info.pName),
+                                   type == MP_LOG_ENTER ? 'B' : 'E', timestamp, thread));
+        }
+    }
+}
+
+void MicroProfileTraceWriter::WriteEvent(const std::string& event) {
+    if (!first_event) {
+        file.WriteString(",\n");
+    }
+    first_event = false;
+    file.WriteString(event);
+}
+
+#else
+
+MicroProfileTraceWriter::MicroProfileTraceWriter(const std::string& path) {
+    LOG_ERROR(Common, "MicroProfile is disabled in this build, not writing trace {}", path);
+}
+
+MicroProfileTraceWriter::~MicroProfileTraceWriter() = default;
+
+void MicroProfileTraceWriter::Flush() {}
+
+void MicroProfileTraceWriter::WriteEvent(const std::string&) {}
+
+#endif
+
+} // namespace Common
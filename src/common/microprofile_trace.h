@@ -0,0 +1,42 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Common {
+
+/**
+ * Streams the scopes recorded by MicroProfile to a file in the Chrome trace event format, which
+ * Perfetto and chrome://tracing can open. Only frames MicroProfile still keeps in its history are
+ * written, so the writer must be flushed at least every few hundred frames to not miss any.
+ */
+class MicroProfileTraceWriter {
+public:
+    /// Opens the trace file and enables recording of all MicroProfile groups
+    explicit MicroProfileTraceWriter(const std::string& path);
+    ~MicroProfileTraceWriter();
+
+    [[nodiscard]] bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    /// Writes the scopes of the frames completed since the previous flush
+    void Flush();
+
+private:
+    void WriteEvent(const std::string& event);
+
+    FileUtil::IOFile file;
+    u32 next_frame{};                ///< Index in the frame history of the first frame not written
+    u64 base_tick{};                 ///< Tick that trace timestamps are relative to
+    bool first_event{true};          ///< Whether no event was written yet
+    std::vector<bool> named_threads; ///< Thread logs whose name was written
+};
+
+} // namespace Common
@@ -82,20 +82,42 @@ void LogSettings() {
 
     LOG_INFO(Config, "Citra Configuration:");
     log_setting("Core_UseCpuJit", values.use_cpu_jit.GetValue());
+    log_setting("Core_ParallelCpuCores", values.parallel_cpu_cores.GetValue());
+    log_setting("Core_UseFastmem", values.use_fastmem.GetValue());
+    log_setting("Core_DyncomBlockProfiling", values.dyncom_block_profiling.GetValue());
     log_setting("Core_CPUClockPercentage", values.cpu_clock_percentage.GetValue());
+    log_setting("Core_EnableRewind", values.enable_rewind.GetValue());
+    log_setting("Core_RewindFrameInterval", values.rewind_frame_interval.GetValue());
+    log_setting("Core_RewindMemoryBudget", values.rewind_memory_budget.GetValue());
+    log_setting("Core_MovieKeyframeInterval", values.movie_keyframe_interval.GetValue());
     log_setting("Renderer_UseGLES", values.use_gles.GetValue());
     log_setting("Renderer_GraphicsAPI", GetGraphicsAPIName(values.graphics_api.GetValue()));
     log_setting("Renderer_AsyncShaders", values.async_shader_compilation.GetValue());
     log_setting("Renderer_AsyncPresentation", values.async_presentation.GetValue());
     log_setting("Renderer_SpirvShaderGen", values.spirv_shader_gen.GetValue());
     log_setting("Renderer_Debug", values.renderer_debug.GetValue());
+    log_setting("Renderer_GpuTiming", values.gpu_timing.GetValue());
     log_setting("Renderer_UseHwShader", values.use_hw_shader.GetValue());
     log_setting("Renderer_ShadersAccurateMul", values.shaders_accurate_mul.GetValue());
     log_setting("Renderer_UseShaderJit", values.use_shader_jit.GetValue());
+    log_setting("Renderer_VertexCacheSize", values.vertex_cache_size.GetValue());
+    log_setting("Renderer_ParallelVertexShading", values.parallel_vertex_shading.GetValue());
+    log_setting("Renderer_CacheCommandLists", values.cache_command_lists.GetValue());
+    log_setting("Renderer_AsyncGpu", values.async_gpu.GetValue());
+    log_setting("Renderer_AsyncSurfaceDownloads", values.async_surface_downloads.GetValue());
+    log_setting("Renderer_SurfacePoolSize", values.surface_pool_size.GetValue());
+    log_setting("Renderer_AsyncTextureFiltering", values.async_texture_filtering.GetValue());
+    log_setting("Renderer_AsyncTextureUpload", values.async_texture_upload.GetValue());
+    log_setting("Renderer_DeduplicateTextures", values.deduplicate_textures.GetValue());
     log_setting("Renderer_UseResolutionFactor", values.resolution_factor.GetValue());
+    log_setting("Renderer_DynamicResolution", values.dynamic_resolution.GetValue());
+    log_setting("Renderer_DynamicResolutionTarget", values.dynamic_resolution_target.GetValue());
     log_setting("Renderer_FrameLimit", values.frame_limit.GetValue());
+    log_setting("Renderer_TurboPresentInterval", values.turbo_present_interval.GetValue());
     log_setting("Renderer_VSyncNew", values.use_vsync_new.GetValue());
+    log_setting("Renderer_MaxQueuedPresents", values.max_queued_presents.GetValue());
     log_setting("Renderer_PostProcessingShader", values.pp_shader_name.GetValue());
+    log_setting("Renderer_PostProcessingChain", values.pp_shader_chain.GetValue());
     log_setting("Renderer_FilterMode", values.filter_mode.GetValue());
     log_setting("Renderer_TextureFilter", GetTextureFilterName(values.texture_filter.GetValue()));
     log_setting("Renderer_TextureSampling",
@@ -111,9 +133,11 @@ void LogSettings() {
     log_setting("Layout_UprightScreen", values.upright_screen.GetValue());
     log_setting("Layout_LargeScreenProportion", values.large_screen_proportion.GetValue());
     log_setting("Utility_DumpTextures", values.dump_textures.GetValue());
+    log_setting("Utility_FastTextureDumping", values.fast_texture_dumping.GetValue());
     log_setting("Utility_CustomTextures", values.custom_textures.GetValue());
     log_setting("Utility_PreloadTextures", values.preload_textures.GetValue());
     log_setting("Utility_AsyncCustomLoading", values.async_custom_loading.GetValue());
+    log_setting("Utility_CustomTextureMemory", values.custom_texture_memory.GetValue());
     log_setting("Utility_UseDiskShaderCache", values.use_disk_shader_cache.GetValue());
     log_setting("Audio_Emulation", GetAudioEmulationName(values.audio_emulation.GetValue()));
     log_setting("Audio_OutputType", values.output_type.GetValue());
@@ -121,6 +145,8 @@ void LogSettings() {
     log_setting("Audio_InputType", values.input_type.GetValue());
     log_setting("Audio_InputDevice", values.input_device.GetValue());
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
+    log_setting("Audio_AsyncHleAudio", values.async_hle_audio.GetValue());
+    log_setting("Audio_Latency", values.audio_latency.GetValue());
     using namespace Service::CAM;
     log_setting("Camera_OuterRightName", values.camera_name[OuterRightCamera]);
     log_setting("Camera_OuterRightConfig", values.camera_config[OuterRightCamera]);
@@ -142,6 +168,7 @@ void LogSettings() {
     log_setting("System_RegionValue", values.region_value.GetValue());
     log_setting("System_PluginLoader", values.plugin_loader_enabled.GetValue());
     log_setting("System_PluginLoaderAllowed", values.allow_plugin_loader.GetValue());
+    log_setting("System_UDSFrameBatching", values.uds_frame_batching.GetValue());
     log_setting("Debugging_DelayStartForLLEModules", values.delay_start_for_lle_modules.GetValue());
     log_setting("Debugging_UseGdbstub", values.use_gdbstub.GetValue());
     log_setting("Debugging_GdbstubPort", values.gdbstub_port.GetValue());
@@ -162,6 +189,14 @@ float Volume() {
     return values.volume.GetValue();
 }
 
+float SliderState3D() {
+    if (values.render_3d.GetValue() == StereoRenderOption::Off &&
+        values.mono_render_option.GetValue() == MonoRenderOption::LeftEye) {
+        return 0.0f;
+    }
+    return values.factor_3d.GetValue() / 100.0f;
+}
+
 void RestoreGlobalState(bool is_powered_on) {
     // If a game is running, DO NOT restore the global settings state
     if (is_powered_on) {
@@ -188,7 +223,10 @@ void RestoreGlobalState(bool is_powered_on) {
     values.use_disk_shader_cache.SetGlobal(true);
     values.shaders_accurate_mul.SetGlobal(true);
     values.use_vsync_new.SetGlobal(true);
+    values.max_queued_presents.SetGlobal(true);
     values.resolution_factor.SetGlobal(true);
+    values.dynamic_resolution.SetGlobal(true);
+    values.dynamic_resolution_target.SetGlobal(true);
     values.frame_limit.SetGlobal(true);
     values.texture_filter.SetGlobal(true);
     values.texture_sampling.SetGlobal(true);
@@ -203,6 +241,7 @@ void RestoreGlobalState(bool is_powered_on) {
     values.factor_3d.SetGlobal(true);
     values.filter_mode.SetGlobal(true);
     values.pp_shader_name.SetGlobal(true);
+    values.pp_shader_chain.SetGlobal(true);
     values.anaglyph_shader_name.SetGlobal(true);
     values.dump_textures.SetGlobal(true);
     values.custom_textures.SetGlobal(true);
@@ -430,9 +430,16 @@ struct Values {
 
     // Core
     Setting<bool> use_cpu_jit{true, "use_cpu_jit"};
+    Setting<bool> parallel_cpu_cores{false, "parallel_cpu_cores"};
+    Setting<bool> use_fastmem{false, "use_fastmem"};
+    Setting<bool> dyncom_block_profiling{false, "dyncom_block_profiling"};
     SwitchableSetting<s32, true> cpu_clock_percentage{100, 5, 400, "cpu_clock_percentage"};
     SwitchableSetting<bool> is_new_3ds{true, "is_new_3ds"};
     SwitchableSetting<bool> lle_applets{false, "lle_applets"};
+    Setting<bool> enable_rewind{false, "enable_rewind"};
+    Setting<u32, true> rewind_frame_interval{60, 1, 600, "rewind_frame_interval"};
+    Setting<u32, true> rewind_memory_budget{512, 32, 8192, "rewind_memory_budget"};
+    Setting<u32, true> movie_keyframe_interval{3600, 0, 216000, "movie_keyframe_interval"};
 
     // Data Storage
     Setting<bool> use_virtual_sd{true, "use_virtual_sd"};
@@ -447,6 +454,7 @@ struct Values {
     Setting<s64> init_ticks_override{0, "init_ticks_override"};
     Setting<bool> plugin_loader_enabled{false, "plugin_loader"};
     Setting<bool> allow_plugin_loader{true, "allow_plugin_loader"};
+    Setting<bool> uds_frame_batching{false, "uds_frame_batching"};
 
     // Renderer
     SwitchableSetting<GraphicsAPI, true> graphics_api {
@@ -466,6 +474,7 @@ struct Values {
     Setting<bool> use_gles{false, "use_gles"};
     Setting<bool> renderer_debug{false, "renderer_debug"};
     Setting<bool> dump_command_buffers{false, "dump_command_buffers"};
+    Setting<bool> gpu_timing{false, "gpu_timing"};
     SwitchableSetting<bool> spirv_shader_gen{true, "spirv_shader_gen"};
     SwitchableSetting<bool> async_shader_compilation{false, "async_shader_compilation"};
     SwitchableSetting<bool> async_presentation{true, "async_presentation"};
@@ -473,9 +482,22 @@ struct Values {
     SwitchableSetting<bool> use_disk_shader_cache{true, "use_disk_shader_cache"};
     SwitchableSetting<bool> shaders_accurate_mul{true, "shaders_accurate_mul"};
     SwitchableSetting<bool> use_vsync_new{true, "use_vsync_new"};
+    SwitchableSetting<u32, true> max_queued_presents{0, 0, 3, "max_queued_presents"};
     Setting<bool> use_shader_jit{true, "use_shader_jit"};
+    Setting<u32, true> vertex_cache_size{256, 16, 4096, "vertex_cache_size"};
+    Setting<bool> parallel_vertex_shading{false, "parallel_vertex_shading"};
+    Setting<bool> cache_command_lists{false, "cache_command_lists"};
+    Setting<bool> async_gpu{false, "async_gpu"};
+    Setting<bool> async_surface_downloads{false, "async_surface_downloads"};
+    Setting<u32, true> surface_pool_size{128, 0, 4096, "surface_pool_size"};
+    Setting<bool> async_texture_filtering{false, "async_texture_filtering"};
+    Setting<bool> async_texture_upload{false, "async_texture_upload"};
+    Setting<bool> deduplicate_textures{false, "deduplicate_textures"};
     SwitchableSetting<u32, true> resolution_factor{1, 0, 10, "resolution_factor"};
+    SwitchableSetting<bool> dynamic_resolution{false, "dynamic_resolution"};
+    SwitchableSetting<u32, true> dynamic_resolution_target{12, 1, 100, "dynamic_resolution_target"};
     SwitchableSetting<u16, true> frame_limit{100, 0, 1000, "frame_limit"};
+    Setting<u32, true> turbo_present_interval{1, 1, 60, "turbo_present_interval"};
     SwitchableSetting<TextureFilter> texture_filter{TextureFilter::None, "texture_filter"};
     SwitchableSetting<TextureSampling> texture_sampling{TextureSampling::GameControlled,
                                                         "texture_sampling"};
@@ -511,17 +533,22 @@ struct Values {
 
     SwitchableSetting<bool> filter_mode{true, "filter_mode"};
     SwitchableSetting<std::string> pp_shader_name{"none (builtin)", "pp_shader_name"};
+    SwitchableSetting<std::string> pp_shader_chain{"", "pp_shader_chain"};
     SwitchableSetting<std::string> anaglyph_shader_name{"dubois (builtin)", "anaglyph_shader_name"};
 
     SwitchableSetting<bool> dump_textures{false, "dump_textures"};
+    Setting<bool> fast_texture_dumping{false, "fast_texture_dumping"};
     SwitchableSetting<bool> custom_textures{false, "custom_textures"};
     SwitchableSetting<bool> preload_textures{false, "preload_textures"};
     SwitchableSetting<bool> async_custom_loading{true, "async_custom_loading"};
+    Setting<u32, true> custom_texture_memory{0, 0, 65536, "custom_texture_memory"};
 
     // Audio
     bool audio_muted;
     SwitchableSetting<AudioEmulation> audio_emulation{AudioEmulation::HLE, "audio_emulation"};
     SwitchableSetting<bool> enable_audio_stretching{true, "enable_audio_stretching"};
+    Setting<bool> async_hle_audio{false, "async_hle_audio"};
+    Setting<u32, true> audio_latency{0, 0, 250, "audio_latency"};
     SwitchableSetting<float, true> volume{1.f, 0.f, 1.f, "volume"};
     Setting<AudioCore::SinkType> output_type{AudioCore::SinkType::Auto, "output_type"};
     Setting<std::string> output_device{"auto", "output_device"};
@@ -535,6 +562,7 @@ struct Values {
 
     // Debugging
     bool record_frame_times;
+    bool export_session_stats;
     std::unordered_map<std::string, bool> lle_modules;
     Setting<bool> delay_start_for_lle_modules{true, "delay_start_for_lle_modules"};
     Setting<bool> use_gdbstub{false, "use_gdbstub"};
@@ -543,6 +571,7 @@ struct Values {
     // Miscellaneous
     Setting<std::string> log_filter{"*:Info", "log_filter"};
     Setting<std::string> log_regex_filter{"", "log_regex_filter"};
+    Setting<bool> log_binary{false, "log_binary"};
 
     // Video Dumping
     std::string output_format;
@@ -564,6 +593,10 @@ void SetConfiguringGlobal(bool is_global);
 
 float Volume();
 
+// Position of the 3D slider reported to the guest, in [0, 1]. Nothing shows the right eye when
+// stereo is off and the left eye is shown, so the slider is reported down and guests render once.
+float SliderState3D();
+
 void LogSettings();
 
 // Restore the global state of all applicable settings in the Values struct
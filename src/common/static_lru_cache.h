@@ -1,6 +1,8 @@
 // Modified version of: https://www.boost.org/doc/libs/1_79_0/boost/compute/detail/lru_cache.hpp
 // Most important change is the use of an array instead of a map, so that elements are
 // statically allocated. The insert and get methods have been merged into the request method.
+// The recency list is linked through indices into an array of nodes and the keys are found
+// through an open addressed hash table, so that requests neither allocate nor search the list.
 // Original license:
 //
 //---------------------------------------------------------------------------//
@@ -15,9 +17,10 @@
 #pragma once
 
 #include <array>
-#include <list>
-#include <tuple>
+#include <bit>
+#include <functional>
 #include <utility>
+#include "common/common_types.h"
 
 namespace Common {
 
@@ -25,18 +28,21 @@ namespace Common {
 // the cache elements are statically allocated.
 template <class Key, class Value, std::size_t Size>
 class StaticLRUCache {
+    static_assert(Size > 0 && Size < 0x10000, "Invalid cache size");
+
 public:
     using key_type = Key;
     using value_type = Value;
-    using list_type = std::list<std::pair<Key, std::size_t>>;
     using array_type = std::array<Value, Size>;
 
-    StaticLRUCache() = default;
+    StaticLRUCache() {
+        clear();
+    }
 
     ~StaticLRUCache() = default;
 
     std::size_t size() const {
-        return m_list.size();
+        return m_size;
     }
 
     constexpr std::size_t capacity() const {
@@ -44,11 +50,11 @@ public:
     }
 
     bool empty() const {
-        return m_list.empty();
+        return m_size == 0;
     }
 
     bool contains(const key_type& key) const {
-        return find(key) != m_list.end();
+        return m_table[find_slot(key)] != InvalidIndex;
     }
 
     // Requests an element from the cache. If it is not found,
@@ -56,58 +62,117 @@ public:
     // Returns whether the element was present in the cache
     // and a reference to the element itself.
     std::pair<bool, value_type&> request(const key_type& key) {
-        // lookup value in the cache
-        auto i = find(key);
-        if (i == m_list.cend()) {
-            std::size_t next_index = size();
-            // insert item into the cache, but first check if it is full
-            if (next_index >= capacity()) {
-                // cache is full, evict the least recently used item
-                next_index = evict();
+        std::size_t slot = find_slot(key);
+        if (m_table[slot] != InvalidIndex) {
+            // move the item to the front of the most recently used list
+            const u16 index = m_table[slot];
+            if (index != m_head) {
+                unlink(index);
+                push_front(index);
             }
-
-            // insert the new item
-            m_list.push_front(std::make_pair(key, next_index));
-            return std::pair<bool, value_type&>(false, m_array[next_index]);
+            return std::pair<bool, value_type&>(true, m_array[index]);
         }
-        // return the value, but first update its place in the most
-        // recently used list
-        if (i != m_list.cbegin()) {
-            // move item to the front of the most recently used list
-            auto backup = *i;
-            m_list.erase(i);
-            m_list.push_front(backup);
-
-            // return the value
-            return std::pair<bool, value_type&>(true, m_array[backup.second]);
+
+        u16 index;
+        if (m_size < capacity()) {
+            index = static_cast<u16>(m_size++);
         } else {
-            // the item is already at the front of the most recently
-            // used list so just return it
-            return std::pair<bool, value_type&>(true, m_array[i->second]);
+            // cache is full, evict the least recently used item
+            index = m_tail;
+            unlink(index);
+            erase_slot(find_slot(m_nodes[index].key));
+            // erasing may have moved other keys, so probe again
+            slot = find_slot(key);
         }
+
+        // insert the new item
+        m_nodes[index].key = key;
+        m_table[slot] = index;
+        push_front(index);
+        return std::pair<bool, value_type&>(false, m_array[index]);
     }
 
     void clear() {
-        m_list.clear();
+        m_table.fill(InvalidIndex);
+        m_head = InvalidIndex;
+        m_tail = InvalidIndex;
+        m_size = 0;
     }
 
 private:
-    typename list_type::const_iterator find(const key_type& key) const {
-        return std::find_if(m_list.cbegin(), m_list.cend(),
-                            [&key](const auto& el) { return el.first == key; });
+    static constexpr u16 InvalidIndex = 0xFFFF;
+    // the table is kept at most half full, so that probe sequences stay short
+    static constexpr std::size_t TableSize = std::bit_ceil(Size * 2);
+    static constexpr std::size_t TableMask = TableSize - 1;
+
+    struct Node {
+        Key key{};
+        u16 prev;
+        u16 next;
+    };
+
+    static std::size_t home_slot(const key_type& key) {
+        // keys like file offsets are often aligned, so the hash is mixed into the upper bits
+        constexpr u32 table_bits = std::countr_zero(TableSize);
+        const u64 hash = static_cast<u64>(std::hash<key_type>{}(key)) * 0x9E3779B97F4A7C15ULL;
+        return table_bits == 0 ? 0 : static_cast<std::size_t>(hash >> (64 - table_bits));
+    }
+
+    // returns the slot holding key, or the empty slot where it would be inserted
+    std::size_t find_slot(const key_type& key) const {
+        std::size_t slot = home_slot(key);
+        while (m_table[slot] != InvalidIndex && !(m_nodes[m_table[slot]].key == key)) {
+            slot = (slot + 1) & TableMask;
+        }
+        return slot;
+    }
+
+    // removes a key from the table, shifting back the keys probed past it
+    void erase_slot(std::size_t hole) {
+        for (std::size_t slot = (hole + 1) & TableMask; m_table[slot] != InvalidIndex;
+             slot = (slot + 1) & TableMask) {
+            const std::size_t home = home_slot(m_nodes[m_table[slot]].key);
+            if (((slot - home) & TableMask) >= ((slot - hole) & TableMask)) {
+                m_table[hole] = m_table[slot];
+                hole = slot;
+            }
+        }
+        m_table[hole] = InvalidIndex;
+    }
+
+    void unlink(u16 index) {
+        const Node& node = m_nodes[index];
+        if (node.prev != InvalidIndex) {
+            m_nodes[node.prev].next = node.next;
+        } else {
+            m_head = node.next;
+        }
+        if (node.next != InvalidIndex) {
+            m_nodes[node.next].prev = node.prev;
+        } else {
+            m_tail = node.prev;
+        }
     }
 
-    std::size_t evict() {
-        // evict item from the end of most recently used list
-        typename list_type::iterator i = --m_list.end();
-        std::size_t evicted_index = i->second;
-        m_list.erase(i);
-        return evicted_index;
+    void push_front(u16 index) {
+        Node& node = m_nodes[index];
+        node.prev = InvalidIndex;
+        node.next = m_head;
+        if (m_head != InvalidIndex) {
+            m_nodes[m_head].prev = index;
+        } else {
+            m_tail = index;
+        }
+        m_head = index;
     }
 
 private:
     array_type m_array;
-    list_type m_list;
+    std::array<Node, Size> m_nodes;
+    std::array<u16, TableSize> m_table;
+    u16 m_head;
+    u16 m_tail;
+    std::size_t m_size;
 };
 
-} // namespace Common
\ No newline at end of file
+} // namespace Common
@@ -30,6 +30,13 @@
 
 namespace Common {
 
+namespace {
+
+/// Name the current thread was given with SetCurrentThreadName
+thread_local std::string current_thread_name;
+
+} // Anonymous namespace
+
 #ifdef _WIN32
 
 void SetCurrentThreadPriority(ThreadPriority new_priority) {
@@ -84,6 +91,7 @@ void SetCurrentThreadPriority(ThreadPriority new_priority) {
 
 // Sets the debugger-visible name of the current thread.
 void SetCurrentThreadName(const char* name) {
+    current_thread_name = name;
     SetThreadDescription(GetCurrentThread(), UTF8ToUTF16W(name).data());
 }
 
@@ -92,6 +100,7 @@ void SetCurrentThreadName(const char* name) {
 // MinGW with the POSIX threading model does not support pthread_setname_np
 #if !defined(_WIN32) || defined(_MSC_VER)
 void SetCurrentThreadName(const char* name) {
+    current_thread_name = name;
 #ifdef __APPLE__
     pthread_setname_np(name);
 #elif defined(__Bitrig__) || defined(__DragonFly__) || defined(__FreeBSD__) || defined(__OpenBSD__)
@@ -113,11 +122,16 @@ void SetCurrentThreadName(const char* name) {
 #endif
 
 #if defined(_WIN32)
-void SetCurrentThreadName(const char*) {
-    // Do Nothing on MingW
+void SetCurrentThreadName(const char* name) {
+    // Only remember the name on MingW
+    current_thread_name = name;
 }
 #endif
 
 #endif
 
+const char* GetCurrentThreadName() {
+    return current_thread_name.c_str();
+}
+
 } // namespace Common
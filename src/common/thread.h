@@ -112,4 +112,7 @@ void SetCurrentThreadPriority(ThreadPriority new_priority);
 
 void SetCurrentThreadName(const char* name);
 
+/// Returns the name given to the current thread with SetCurrentThreadName, empty if none
+const char* GetCurrentThreadName();
+
 } // namespace Common
@@ -0,0 +1,121 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <thread>
+#include "common/assert.h"
+#include "common/thread.h"
+#include "common/thread_pool.h"
+
+namespace Common {
+
+ThreadPool::ThreadPool() {
+    const std::size_t num_threads = std::max(std::thread::hardware_concurrency(), 3U) - 2;
+    threads.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([this](std::stop_token stop_token) { WorkerThread(stop_token); });
+    }
+}
+
+ThreadPool::~ThreadPool() = default;
+
+ThreadPool& ThreadPool::Instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::WorkerThread(std::stop_token stop_token) {
+    SetCurrentThreadName("ThreadPool");
+
+    std::unique_lock lock{mutex};
+    while (true) {
+        TaskGroup* group = nullptr;
+        CondvarWait(work_available, lock, stop_token,
+                    [&] { return (group = NextRunnableGroup()) != nullptr; });
+        if (stop_token.stop_requested()) {
+            return;
+        }
+
+        TaskGroup::Task task = std::move(group->tasks.front());
+        group->tasks.pop();
+        ++group->running;
+        lock.unlock();
+        task();
+        lock.lock();
+
+        // The slot freed up is taken by this thread on the next iteration if the group has more
+        // tasks, so other threads only need waking for new tasks.
+        if (--group->running == 0 && group->tasks.empty()) {
+            group->idle.notify_all();
+        }
+    }
+}
+
+TaskGroup* ThreadPool::NextRunnableGroup() {
+    // Groups of the same priority take turns, so a group with many tasks can't starve the others
+    for (std::size_t priority = groups.size(); priority-- > 0;) {
+        auto& candidates = groups[priority];
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            const std::size_t index = (next_group[priority] + i) % candidates.size();
+            TaskGroup* group = candidates[index];
+            if (!group->tasks.empty() && group->running < group->max_concurrency) {
+                next_group[priority] = index + 1;
+                return group;
+            }
+        }
+    }
+    return nullptr;
+}
+
+TaskGroup::TaskGroup(TaskPriority priority_, std::size_t max_concurrency_)
+    : pool{ThreadPool::Instance()}, priority{priority_},
+      max_concurrency{max_concurrency_ == 0 ? pool.NumThreads()
+                                            : std::min(max_concurrency_, pool.NumThreads())} {
+    std::scoped_lock lock{pool.mutex};
+    pool.groups[static_cast<std::size_t>(priority)].push_back(this);
+}
+
+TaskGroup::~TaskGroup() {
+    std::unique_lock lock{pool.mutex};
+    tasks = {};
+    idle.wait(lock, [this] { return running == 0; });
+
+    auto& candidates = pool.groups[static_cast<std::size_t>(priority)];
+    const auto it = std::find(candidates.begin(), candidates.end(), this);
+    ASSERT(it != candidates.end());
+    candidates.erase(it);
+}
+
+void TaskGroup::QueueWork(Task work) {
+    {
+        std::scoped_lock lock{pool.mutex};
+        tasks.push(std::move(work));
+    }
+    pool.work_available.notify_one();
+}
+
+void TaskGroup::WaitForRequests() {
+    std::unique_lock lock{pool.mutex};
+    while (true) {
+        if (!tasks.empty()) {
+            // Help with the remaining tasks rather than leaving the calling thread idle
+            Task task = std::move(tasks.front());
+            tasks.pop();
+            ++running;
+            lock.unlock();
+            task();
+            lock.lock();
+            if (--running == 0 && tasks.empty()) {
+                idle.notify_all();
+            }
+            continue;
+        }
+        if (running == 0) {
+            return;
+        }
+        idle.wait(lock);
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,109 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "common/unique_function.h"
+
+namespace Common {
+
+class TaskGroup;
+
+enum class TaskPriority : u32 {
+    Low = 0,    ///< Work nothing waits on, like dumping
+    Normal = 1, ///< Background work, like compiling shaders
+    High = 2,   ///< Work the emulation is waiting on, like rasterizing a frame
+};
+
+/**
+ * Process-wide pool of worker threads that subsystems run their background work on through task
+ * groups, so that they don't each start as many threads as there are cores. The pool leaves two
+ * cores to the CPU and render threads, the threads the rest of the emulation waits on.
+ */
+class ThreadPool {
+public:
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Returns the shared pool, starting it on first use
+    static ThreadPool& Instance();
+
+    /// Returns the number of worker threads of the pool
+    [[nodiscard]] std::size_t NumThreads() const noexcept {
+        return threads.size();
+    }
+
+private:
+    friend class TaskGroup;
+
+    ThreadPool();
+
+    void WorkerThread(std::stop_token stop_token);
+
+    /// Returns the next group a task can be started from, nullptr if none. Requires the mutex.
+    TaskGroup* NextRunnableGroup();
+
+    std::mutex mutex;
+    std::condition_variable_any work_available;
+    std::array<std::vector<TaskGroup*>, 3> groups; ///< Registered groups by priority
+    std::array<std::size_t, 3> next_group{};       ///< Round robin position by priority
+    std::vector<std::jthread> threads;
+};
+
+/**
+ * Queue of tasks of one subsystem that run on the shared thread pool. Tasks start in the order
+ * they were queued, at most max_concurrency of them at once, and before the tasks of groups with
+ * a lower priority. Destroying the group drops the tasks that did not start yet and waits for the
+ * running ones.
+ */
+class TaskGroup {
+public:
+    using Task = UniqueFunction<void>;
+
+    /**
+     * @param priority Priority of the tasks of the group over those of other groups
+     * @param max_concurrency Number of tasks of the group that may run at once, 0 for as many as
+     *                        there are threads in the pool
+     */
+    explicit TaskGroup(TaskPriority priority = TaskPriority::Normal,
+                       std::size_t max_concurrency = 0);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void QueueWork(Task work);
+
+    /// Waits until every queued task finished, running queued tasks on the calling thread
+    void WaitForRequests();
+
+    /// Returns the number of tasks of the group that may run at once on the pool
+    [[nodiscard]] std::size_t NumWorkers() const noexcept {
+        return max_concurrency;
+    }
+
+private:
+    friend class ThreadPool;
+
+    ThreadPool& pool;
+    TaskPriority priority;
+    std::size_t max_concurrency;
+
+    // Guarded by the pool mutex.
+    std::queue<Task> tasks;
+    std::size_t running{};
+    std::condition_variable idle;
+};
+
+} // namespace Common
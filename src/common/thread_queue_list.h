@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <deque>
 #include "common/common_types.h"
 
@@ -21,16 +22,13 @@ struct ThreadQueueList {
 
     // Number of priority levels. (Valid levels are [0..NUM_QUEUES).)
     static constexpr Priority NUM_QUEUES = N;
-
-    ThreadQueueList() {
-        first = nullptr;
-    }
+    static_assert(NUM_QUEUES <= 64, "Non-empty priority levels are tracked in a 64-bit mask");
 
     // Only for debugging, returns priority level.
     [[nodiscard]] Priority contains(const T& uid) const {
         for (Priority i = 0; i < NUM_QUEUES; ++i) {
-            const Queue& cur = queues[i];
-            if (std::find(cur.data.cbegin(), cur.data.cend(), uid) != cur.data.cend()) {
+            const auto& cur = queues[i];
+            if (std::find(cur.cbegin(), cur.cend(), uid) != cur.cend()) {
                 return i;
             }
         }
@@ -39,145 +37,88 @@ struct ThreadQueueList {
     }
 
     [[nodiscard]] T get_first() const {
-        const Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                return cur->data.front();
-            }
-            cur = cur->next_nonempty;
+        if (nonempty == 0) {
+            return T();
         }
-
-        return T();
+        return queues[std::countr_zero(nonempty)].front();
     }
 
     T pop_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
+        if (nonempty == 0) {
+            return T();
         }
-
-        return T();
+        return pop(static_cast<Priority>(std::countr_zero(nonempty)));
     }
 
     T pop_first_better(Priority priority) {
-        Queue* cur = first;
-        Queue* stop = &queues[priority];
-        while (cur < stop) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
+        const u64 better = nonempty & (Bit(priority) - 1);
+        if (better == 0) {
+            return T();
         }
-
-        return T();
+        return pop(static_cast<Priority>(std::countr_zero(better)));
     }
 
     void push_front(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_front(thread_id);
+        queues[priority].push_front(thread_id);
+        nonempty |= Bit(priority);
     }
 
     void push_back(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_back(thread_id);
+        queues[priority].push_back(thread_id);
+        nonempty |= Bit(priority);
     }
 
     void move(const T& thread_id, Priority old_priority, Priority new_priority) {
         remove(old_priority, thread_id);
-        prepare(new_priority);
         push_back(new_priority, thread_id);
     }
 
     void remove(Priority priority, const T& thread_id) {
-        Queue* const cur = &queues[priority];
-        const auto iter = std::remove(cur->data.begin(), cur->data.end(), thread_id);
-        cur->data.erase(iter, cur->data.end());
+        auto& cur = queues[priority];
+        cur.erase(std::remove(cur.begin(), cur.end(), thread_id), cur.end());
+        if (cur.empty()) {
+            nonempty &= ~Bit(priority);
+        }
     }
 
     void rotate(Priority priority) {
-        Queue* cur = &queues[priority];
+        auto& cur = queues[priority];
 
-        if (cur->data.size() > 1) {
-            cur->data.push_back(std::move(cur->data.front()));
-            cur->data.pop_front();
+        if (cur.size() > 1) {
+            cur.push_back(std::move(cur.front()));
+            cur.pop_front();
         }
     }
 
     void clear() {
-        queues.fill(Queue());
-        first = nullptr;
+        queues.fill({});
+        nonempty = 0;
     }
 
     [[nodiscard]] bool empty(Priority priority) const {
-        const Queue* cur = &queues[priority];
-        return cur->data.empty();
-    }
-
-    void prepare(Priority priority) {
-        Queue* cur = &queues[priority];
-        if (cur->next_nonempty == UnlinkedTag())
-            link(priority);
+        return queues[priority].empty();
     }
 
 private:
-    struct Queue {
-        // Points to the next active priority, skipping over ones that have never been used.
-        Queue* next_nonempty = UnlinkedTag();
-        // Double-ended queue of threads in this priority level
-        std::deque<T> data;
-    };
-
-    /// Special tag used to mark priority levels that have never been used.
-    static Queue* UnlinkedTag() {
-        return reinterpret_cast<Queue*>(1);
+    static constexpr u64 Bit(Priority priority) {
+        return u64{1} << priority;
     }
 
-    void link(Priority priority) {
-        Queue* cur = &queues[priority];
-
-        for (int i = priority - 1; i >= 0; --i) {
-            if (queues[i].next_nonempty != UnlinkedTag()) {
-                cur->next_nonempty = queues[i].next_nonempty;
-                queues[i].next_nonempty = cur;
-                return;
-            }
+    T pop(Priority priority) {
+        auto& cur = queues[priority];
+        auto tmp = std::move(cur.front());
+        cur.pop_front();
+        if (cur.empty()) {
+            nonempty &= ~Bit(priority);
         }
-
-        cur->next_nonempty = first;
-        first = cur;
+        return tmp;
     }
 
-    // The first queue that's ever been used.
-    Queue* first;
+    // Bit i is set when the queue of priority level i holds threads, so finding the best ready
+    // thread is a single bit scan.
+    u64 nonempty{};
     // The priority level queues of thread ids.
-    std::array<Queue, NUM_QUEUES> queues;
-
-    s64 ToIndex(const Queue* q) const {
-        if (q == nullptr) {
-            return -2;
-        } else if (q == UnlinkedTag()) {
-            return -1;
-        } else {
-            return q - queues.data();
-        }
-    }
-
-    Queue* ToPointer(s64 idx) {
-        if (idx == -1) {
-            return UnlinkedTag();
-        } else if (idx < 0) {
-            return nullptr;
-        } else {
-            return &queues[idx];
-        }
-    }
+    std::array<std::deque<T>, NUM_QUEUES> queues;
 };
 
 } // namespace Common
@@ -3,6 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <zstd.h>
 
 #include "common/logging/log.h"
@@ -10,6 +13,28 @@
 
 namespace Common::Compression {
 
+namespace {
+
+/// Calls func with every index below count, spreading the calls over num_workers threads
+template <typename Func>
+void ParallelFor(std::size_t count, u32 num_workers, const Func& func) {
+    std::atomic_size_t next_index{};
+    const auto worker = [&] {
+        for (std::size_t index = next_index++; index < count; index = next_index++) {
+            func(index);
+        }
+    };
+
+    const std::size_t num_threads = std::min<std::size_t>(std::max(num_workers, 1U), count);
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 1; i < num_threads; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+}
+
+} // Anonymous namespace
+
 std::vector<u8> CompressDataZSTD(std::span<const u8> source, s32 compression_level) {
     compression_level = std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel());
     const std::size_t max_compressed_size = ZSTD_compressBound(source.size());
@@ -38,6 +63,71 @@ std::vector<u8> CompressDataZSTDDefault(std::span<const u8> source) {
     return CompressDataZSTD(source, ZSTD_CLEVEL_DEFAULT);
 }
 
+std::vector<u8> CompressDataZSTDMultithreaded(std::span<const u8> source, s32 compression_level,
+                                              u32 num_workers) {
+    compression_level = std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel());
+    const std::size_t max_compressed_size = ZSTD_compressBound(source.size());
+
+    if (ZSTD_isError(max_compressed_size)) {
+        LOG_ERROR(Common, "Error determining ZSTD maximum compressed size: {} ({})",
+                  ZSTD_getErrorName(max_compressed_size), max_compressed_size);
+        return {};
+    }
+
+    const std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx{ZSTD_createCCtx(),
+                                                                   ZSTD_freeCCtx};
+    if (!ctx) {
+        LOG_ERROR(Common, "Failed to create ZSTD compression context");
+        return {};
+    }
+
+    ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_compressionLevel, compression_level);
+    const std::size_t workers_result =
+        ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_nbWorkers, static_cast<int>(num_workers));
+    if (ZSTD_isError(workers_result)) {
+        LOG_DEBUG(Common, "ZSTD multithreading unavailable, compressing on a single thread: {}",
+                  ZSTD_getErrorName(workers_result));
+    }
+
+    std::vector<u8> compressed(max_compressed_size);
+    const std::size_t compressed_size = ZSTD_compress2(
+        ctx.get(), compressed.data(), compressed.size(), source.data(), source.size());
+
+    if (ZSTD_isError(compressed_size)) {
+        LOG_ERROR(Common, "Error compressing ZSTD data: {} ({})",
+                  ZSTD_getErrorName(compressed_size), compressed_size);
+        return {};
+    }
+
+    compressed.resize(compressed_size);
+    return compressed;
+}
+
+std::vector<u8> CompressDataZSTDFrames(std::span<const u8> source, s32 compression_level,
+                                       std::size_t frame_size, u32 num_workers) {
+    const std::size_t num_frames = std::max<std::size_t>(1, (source.size() + frame_size - 1) /
+                                                                frame_size);
+    std::vector<std::vector<u8>> frames(num_frames);
+    std::atomic_bool failed{};
+    ParallelFor(num_frames, num_workers, [&](std::size_t index) {
+        const std::size_t offset = index * frame_size;
+        const std::size_t size = std::min(frame_size, source.size() - offset);
+        frames[index] = CompressDataZSTD(source.subspan(offset, size), compression_level);
+        if (frames[index].empty()) {
+            failed = true;
+        }
+    });
+    if (failed) {
+        return {};
+    }
+
+    std::vector<u8> compressed;
+    for (const std::vector<u8>& frame : frames) {
+        compressed.insert(compressed.end(), frame.begin(), frame.end());
+    }
+    return compressed;
+}
+
 std::vector<u8> DecompressDataZSTD(std::span<const u8> compressed) {
     const std::size_t decompressed_size =
         ZSTD_getFrameContentSize(compressed.data(), compressed.size());
@@ -70,4 +160,56 @@ std::vector<u8> DecompressDataZSTD(std::span<const u8> compressed) {
     return decompressed;
 }
 
+std::vector<u8> DecompressDataZSTDFrames(std::span<const u8> compressed, u32 num_workers) {
+    struct Frame {
+        std::span<const u8> compressed;
+        std::size_t offset;
+    };
+
+    // Locate the frames and where their contents go in the decompressed data
+    std::vector<Frame> frames;
+    std::size_t decompressed_size = 0;
+    while (!compressed.empty()) {
+        const std::size_t frame_size =
+            ZSTD_findFrameCompressedSize(compressed.data(), compressed.size());
+        if (ZSTD_isError(frame_size)) {
+            LOG_ERROR(Common, "Error finding ZSTD frame: {} ({})", ZSTD_getErrorName(frame_size),
+                      frame_size);
+            return {};
+        }
+        const auto frame = compressed.first(frame_size);
+        const u64 content_size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+        if (content_size == ZSTD_CONTENTSIZE_UNKNOWN || content_size == ZSTD_CONTENTSIZE_ERROR) {
+            LOG_ERROR(Common, "ZSTD decompressed size could not be determined.");
+            return {};
+        }
+        frames.push_back(Frame{
+            .compressed = frame,
+            .offset = decompressed_size,
+        });
+        decompressed_size += content_size;
+        compressed = compressed.subspan(frame_size);
+    }
+
+    std::vector<u8> decompressed(decompressed_size);
+    std::atomic_bool failed{};
+    ParallelFor(frames.size(), num_workers, [&](std::size_t index) {
+        const Frame& frame = frames[index];
+        const std::size_t end =
+            index + 1 < frames.size() ? frames[index + 1].offset : decompressed_size;
+        const std::size_t result =
+            ZSTD_decompress(decompressed.data() + frame.offset, end - frame.offset,
+                            frame.compressed.data(), frame.compressed.size());
+        if (ZSTD_isError(result) || result != end - frame.offset) {
+            LOG_ERROR(Common, "Error decompressing ZSTD frame {}: {}", index,
+                      ZSTD_getErrorName(result));
+            failed = true;
+        }
+    });
+    if (failed) {
+        return {};
+    }
+    return decompressed;
+}
+
 } // namespace Common::Compression
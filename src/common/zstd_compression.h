@@ -31,6 +31,34 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> CompressDataZSTDDefault(std::span<const u8> source);
 
+/**
+ * Compresses a source memory region with Zstandard, splitting the work among multiple threads.
+ * Falls back to single-threaded compression if the library was built without threading support.
+ *
+ * @param source the uncompressed source memory region.
+ * @param compression_level the used compression level. Should be between 1 and 22.
+ * @param num_workers the number of worker threads to use.
+ *
+ * @return the compressed data.
+ */
+[[nodiscard]] std::vector<u8> CompressDataZSTDMultithreaded(std::span<const u8> source,
+                                                            s32 compression_level, u32 num_workers);
+
+/**
+ * Compresses a source memory region into independent Zstandard frames of up to frame_size
+ * uncompressed bytes each, so DecompressDataZSTDFrames can decompress them concurrently.
+ *
+ * @param source the uncompressed source memory region.
+ * @param compression_level the used compression level. Should be between 1 and 22.
+ * @param frame_size the number of uncompressed bytes stored in each frame.
+ * @param num_workers the number of threads compressing frames.
+ *
+ * @return the concatenated frames.
+ */
+[[nodiscard]] std::vector<u8> CompressDataZSTDFrames(std::span<const u8> source,
+                                                     s32 compression_level, std::size_t frame_size,
+                                                     u32 num_workers);
+
 /**
  * Decompresses a source memory region with Zstandard and returns the uncompressed data in a vector.
  *
@@ -40,4 +68,16 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> DecompressDataZSTD(std::span<const u8> compressed);
 
+/**
+ * Decompresses a source memory region made of one or more concatenated Zstandard frames, splitting
+ * the frames among multiple threads.
+ *
+ * @param compressed the compressed source memory region.
+ * @param num_workers the number of threads decompressing frames.
+ *
+ * @return the decompressed data, empty when any frame could not be decompressed.
+ */
+[[nodiscard]] std::vector<u8> DecompressDataZSTDFrames(std::span<const u8> compressed,
+                                                       u32 num_workers);
+
 } // namespace Common::Compression
@@ -7,6 +7,7 @@
 #include <dynarmic/interface/optimization_flags.h>
 #include "common/assert.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
 #include "core/arm/dynarmic/arm_exclusive_monitor.h"
@@ -25,41 +26,53 @@ public:
     ~DynarmicUserCallbacks() = default;
 
     std::uint8_t MemoryRead8(VAddr vaddr) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.Read8(vaddr);
     }
     std::uint16_t MemoryRead16(VAddr vaddr) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.Read16(vaddr);
     }
     std::uint32_t MemoryRead32(VAddr vaddr) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.Read32(vaddr);
     }
     std::uint64_t MemoryRead64(VAddr vaddr) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.Read64(vaddr);
     }
 
     void MemoryWrite8(VAddr vaddr, std::uint8_t value) override {
+        const auto guard = parent.system.EnterCore(parent);
         memory.Write8(vaddr, value);
     }
     void MemoryWrite16(VAddr vaddr, std::uint16_t value) override {
+        const auto guard = parent.system.EnterCore(parent);
         memory.Write16(vaddr, value);
     }
     void MemoryWrite32(VAddr vaddr, std::uint32_t value) override {
+        const auto guard = parent.system.EnterCore(parent);
         memory.Write32(vaddr, value);
     }
     void MemoryWrite64(VAddr vaddr, std::uint64_t value) override {
+        const auto guard = parent.system.EnterCore(parent);
         memory.Write64(vaddr, value);
     }
 
     bool MemoryWriteExclusive8(u32 vaddr, u8 value, u8 expected) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.WriteExclusive8(vaddr, value, expected);
     }
     bool MemoryWriteExclusive16(u32 vaddr, u16 value, u16 expected) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.WriteExclusive16(vaddr, value, expected);
     }
     bool MemoryWriteExclusive32(u32 vaddr, u32 value, u32 expected) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.WriteExclusive32(vaddr, value, expected);
     }
     bool MemoryWriteExclusive64(u32 vaddr, u64 value, u64 expected) override {
+        const auto guard = parent.system.EnterCore(parent);
         return memory.WriteExclusive64(vaddr, value, expected);
     }
 
@@ -70,6 +83,7 @@ public:
     }
 
     void CallSVC(std::uint32_t swi) override {
+        const auto guard = parent.system.EnterCore(parent);
         svc_context.CallSVC(swi);
     }
 
@@ -126,7 +140,9 @@ ARM_Dynarmic::~ARM_Dynarmic() = default;
 MICROPROFILE_DEFINE(ARM_Jit, "ARM JIT", "ARM JIT", MP_RGB(255, 64, 64));
 
 void ARM_Dynarmic::Run() {
-    ASSERT(memory.GetCurrentPageTable() == current_page_table);
+    // With parallel cores the current page table belongs to whichever core entered last.
+    ASSERT(Settings::values.parallel_cpu_cores ||
+           memory.GetCurrentPageTable() == current_page_table);
     MICROPROFILE_SCOPE(ARM_Jit);
 
     jit->Run();
@@ -276,11 +292,25 @@ void ARM_Dynarmic::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_t
     jits.emplace(current_page_table, std::move(new_jit));
 }
 
+// Translated blocks live only as long as their Jit. Dynarmic has no interface to export emitted
+// host code or to translate a block ahead of its first execution, so there is no persistent
+// code cache: every boot starts cold.
 std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     Dynarmic::A32::UserConfig config;
     config.callbacks = cb.get();
     if (current_page_table) {
         config.page_table = &current_page_table->pointers;
+        if (current_page_table->fastmem_arena) {
+            config.fastmem_pointer =
+                reinterpret_cast<uintptr_t>(current_page_table->fastmem_arena->BasePointer());
+            config.recompile_on_fastmem_failure = true;
+
+            // Do LDREX/STREX on the arena with an inline host compare and swap, so the global
+            // monitor lock is held for a single instruction rather than a callback into the
+            // memory system. Cores running on separate host threads contend on that lock.
+            config.fastmem_exclusive_access = true;
+            config.recompile_on_exclusive_fastmem_failure = true;
+        }
     }
     config.coprocessors[15] = std::make_shared<DynarmicCP15>(cp15_state);
     config.define_unpredictable_behaviour = true;
@@ -5,6 +5,9 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <vector>
+#include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/arm/dyncom/arm_dyncom.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/arm/dyncom/arm_dyncom_trans.h"
@@ -19,9 +22,29 @@ ARM_DynCom::ARM_DynCom(Core::System& system_, Memory::MemorySystem& memory,
                        std::shared_ptr<Core::Timing::Timer> timer)
     : ARM_Interface(id, timer), system(system_) {
     state = std::make_unique<ARMul_State>(system, memory, initial_mode);
+    state->profile_blocks = Settings::values.dyncom_block_profiling.GetValue();
 }
 
-ARM_DynCom::~ARM_DynCom() {}
+ARM_DynCom::~ARM_DynCom() {
+    DumpBlockProfile();
+}
+
+void ARM_DynCom::DumpBlockProfile() const {
+    if (!state->profile_blocks || state->block_hits.empty()) {
+        return;
+    }
+
+    constexpr std::size_t MaxBlocks = 32;
+    std::vector<std::pair<u32, u64>> blocks(state->block_hits.begin(), state->block_hits.end());
+    const auto count = std::min(MaxBlocks, blocks.size());
+    std::partial_sort(blocks.begin(), blocks.begin() + count, blocks.end(),
+                      [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    LOG_INFO(Core_ARM11, "Hottest blocks of core {}:", GetID());
+    for (std::size_t i = 0; i < count; ++i) {
+        LOG_INFO(Core_ARM11, "  {:08X}: {} entries", blocks[i].first, blocks[i].second);
+    }
+}
 
 void ARM_DynCom::Run() {
     ExecuteInstructions(std::max<s64>(timer->GetDowncount(), 0));
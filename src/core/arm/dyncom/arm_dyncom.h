@@ -51,6 +51,9 @@ public:
     void SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) override;
     void PrepareReschedule() override;
 
+    /// Logs the most frequently entered blocks, if block profiling is enabled.
+    void DumpBlockProfile() const;
+
 private:
     void ExecuteInstructions(u64 num_instructions);
 
@@ -1370,6 +1370,24 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     }
 #endif
 
+#define PROFILE_BLOCK                                                                              \
+    if (cpu->profile_blocks)                                                                       \
+        ++cpu->block_hits[cpu->Reg[15]]
+
+// Direct branches remember the block they lead to the first time they go through DISPATCH, and
+// from then on jump straight to it instead of looking it up again. Pending interrupts still take
+// the DISPATCH path.
+#define GOTO_LINKED_BLOCK(link)                                                                    \
+    if (link != NO_BLOCK_LINK && (cpu->NirqSig || (cpu->Cpsr & 0x80))) {                           \
+        PROFILE_BLOCK;                                                                             \
+        ptr = link;                                                                                \
+        inst_base = (arm_inst*)&trans_cache_buf[ptr];                                              \
+        GOTO_NEXT_INST;                                                                            \
+    }                                                                                              \
+    if (cpu->NumInstrsToExecute != 1)                                                              \
+        pending_link = &link;                                                                      \
+    goto DISPATCH
+
 #define UPDATE_NFLAG(dst) (cpu->NFlag = BIT(dst, 31) ? 1 : 0)
 #define UPDATE_ZFLAG(dst) (cpu->ZFlag = dst ? 0 : 1)
 #define UPDATE_CFLAG_WITH_SC (cpu->CFlag = cpu->shifter_carry_out)
@@ -1601,6 +1619,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     unsigned int num_instrs = 0;
 
     std::size_t ptr;
+    std::size_t* pending_link = nullptr;
 
     LOAD_NZCVT;
 DISPATCH : {
@@ -1627,6 +1646,12 @@ DISPATCH : {
             goto END;
     }
 
+    if (pending_link) {
+        *pending_link = ptr;
+        pending_link = nullptr;
+    }
+    PROFILE_BLOCK;
+
     inst_base = (arm_inst*)&trans_cache_buf[ptr];
     GOTO_NEXT_INST;
 }
@@ -1730,18 +1755,18 @@ AND_INST : {
     GOTO_NEXT_INST;
 }
 BBL_INST : {
+    bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
     if ((inst_base->cond == ConditionCode::AL) || CondPassed(cpu, inst_base->cond)) {
-        bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
         if (inst_cream->L) {
             LINK_RTN_ADDR;
         }
         SET_PC;
         INC_PC(sizeof(bbl_inst));
-        goto DISPATCH;
+        GOTO_LINKED_BLOCK(inst_cream->taken_link);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(bbl_inst));
-    goto DISPATCH;
+    GOTO_LINKED_BLOCK(inst_cream->next_link);
 }
 BIC_INST : {
     bic_inst* inst_cream = (bic_inst*)inst_base->component;
@@ -4291,18 +4316,20 @@ B_2_THUMB : {
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
     cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
     INC_PC(sizeof(b_2_thumb));
-    goto DISPATCH;
+    GOTO_LINKED_BLOCK(inst_cream->taken_link);
 }
 B_COND_THUMB : {
     b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
 
-    if (CondPassed(cpu, inst_cream->cond))
+    if (CondPassed(cpu, inst_cream->cond)) {
         cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-    else
-        cpu->Reg[15] += 2;
+        INC_PC(sizeof(b_cond_thumb));
+        GOTO_LINKED_BLOCK(inst_cream->taken_link);
+    }
 
+    cpu->Reg[15] += 2;
     INC_PC(sizeof(b_cond_thumb));
-    goto DISPATCH;
+    GOTO_LINKED_BLOCK(inst_cream->next_link);
 }
 BL_1_THUMB : {
     bl_1_thumb* inst_cream = (bl_1_thumb*)inst_base->component;
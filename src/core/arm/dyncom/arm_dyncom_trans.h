@@ -22,6 +22,9 @@ enum class TransExtData {
     SINGLE_STEP = (1 << 8)
 };
 
+/// Block link of a direct branch that has not been resolved to a translated block yet.
+constexpr std::size_t NO_BLOCK_LINK = ~std::size_t{0};
+
 struct arm_inst {
     unsigned int idx;
     unsigned int cond;
@@ -88,6 +91,8 @@ struct bbl_inst {
     int signed_immed_24;
     unsigned int next_addr;
     unsigned int jmp_addr;
+    std::size_t taken_link;
+    std::size_t next_link;
 };
 
 struct bx_inst {
@@ -451,10 +456,13 @@ struct setend_inst {
 
 struct b_2_thumb {
     unsigned int imm;
+    std::size_t taken_link;
 };
 struct b_cond_thumb {
     unsigned int imm;
     unsigned int cond;
+    std::size_t taken_link;
+    std::size_t next_link;
 };
 
 struct bl_1_thumb {
@@ -0,0 +1,55 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fmt/format.h>
+#include "common/thread.h"
+#include "core/arm/arm_interface.h"
+#include "core/arm/parallel_cores.h"
+
+namespace Core {
+
+ParallelCores::ParallelCores(std::span<const std::shared_ptr<ARM_Interface>> cores_)
+    : slice_begin{cores_.size()}, slice_end{cores_.size()} {
+    cores.reserve(cores_.size());
+    for (const auto& core : cores_) {
+        cores.push_back(core.get());
+    }
+
+    threads.reserve(cores.size() - 1);
+    for (std::size_t core_id = 1; core_id < cores.size(); ++core_id) {
+        threads.emplace_back(
+            [this, core_id](std::stop_token stop_token) { WorkerLoop(stop_token, core_id); });
+    }
+}
+
+ParallelCores::~ParallelCores() {
+    for (auto& thread : threads) {
+        thread.request_stop();
+    }
+}
+
+void ParallelCores::RunSlice(u32 core_mask) {
+    // The barriers order this write before the reads of the workers.
+    current_mask = core_mask;
+    slice_begin.Sync();
+    if (core_mask & 1) {
+        cores[0]->Run();
+    }
+    slice_end.Sync();
+}
+
+void ParallelCores::WorkerLoop(std::stop_token stop_token, std::size_t core_id) {
+    const std::string name = fmt::format("ARM11 Core {}", core_id);
+    Common::SetCurrentThreadName(name.c_str());
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+
+    while (slice_begin.Sync(stop_token)) {
+        if (current_mask & (1U << core_id)) {
+            cores[core_id]->Run();
+        }
+        slice_end.Sync();
+    }
+}
+
+} // namespace Core
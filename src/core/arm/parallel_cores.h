@@ -0,0 +1,45 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+
+namespace Core {
+
+class ARM_Interface;
+
+/**
+ * Runs the timing slices of the secondary ARM11 cores on dedicated host threads, in parallel with
+ * the emulation thread running core 0. The cores only synchronize at slice boundaries, any call
+ * from guest code into the emulator is serialized by System::EnterCore.
+ */
+class ParallelCores {
+public:
+    explicit ParallelCores(std::span<const std::shared_ptr<ARM_Interface>> cores);
+    ~ParallelCores();
+
+    /**
+     * Runs the current slice of every core whose bit is set in core_mask and returns once all of
+     * them finished. Core 0 runs on the calling thread.
+     */
+    void RunSlice(u32 core_mask);
+
+private:
+    void WorkerLoop(std::stop_token stop_token, std::size_t core_id);
+
+    std::vector<ARM_Interface*> cores;
+    u32 current_mask{};
+    Common::Barrier slice_begin;
+    Common::Barrier slice_end;
+    std::vector<std::jthread> threads;
+};
+
+} // namespace Core
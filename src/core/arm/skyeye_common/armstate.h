@@ -248,6 +248,11 @@ public:
     // process for our purposes), not per ARMul_State (which tracks CPU core state).
     std::unordered_map<u32, std::size_t> instruction_cache;
 
+    // Number of times each block was entered, keyed by its start address. Only counted when
+    // profile_blocks is set, as it costs a map lookup per block.
+    bool profile_blocks = false;
+    std::unordered_map<u32, u64> block_hits;
+
 private:
     void ResetMPCoreCP15Registers();
 
@@ -52,6 +52,8 @@
  */
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include "common/logging/log.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
@@ -961,6 +963,82 @@ static u32 vfp_double_fnmsc(ARMul_State* state, int dd, int dn, int dm, u32 fpsc
                                           "fnmsc");
 }
 
+/*
+ * Host FPU fast path for the common case. With round to nearest, operands that are zero or normal
+ * and a result that is normal, the emulation can only raise inexact, and the host computes the
+ * same correctly rounded result. The exponents of the operands are limited so that the exact
+ * rounding error of the host operation can neither overflow nor underflow, which makes it a
+ * reliable inexact test. Everything else is left to the emulation.
+ */
+static bool vfp_double_host_operand(u64 val) {
+    constexpr u32 max_distance = 400; // From the exponent bias
+    const u32 exponent = static_cast<u32>(val >> 52) & 0x7FF;
+    return (val << 1) == 0 ||
+           (exponent >= 1023 - max_distance && exponent <= 1023 + max_distance);
+}
+
+static bool vfp_double_host_operands(u32 fpscr, u64 n, u64 m) {
+    return (fpscr & FPSCR_RMODE_MASK) == FPSCR_ROUND_NEAREST && vfp_double_host_operand(n) &&
+           vfp_double_host_operand(m);
+}
+
+static bool vfp_double_host_result(ARMul_State* state, int dd, double result, bool inexact,
+                                   u32* exceptions) {
+    if (result != 0.0 && !std::isnormal(result)) {
+        return false;
+    }
+    vfp_put_double(state, std::bit_cast<u64>(result), dd);
+    *exceptions = inexact ? FPSCR_IXC : 0;
+    return true;
+}
+
+static bool vfp_double_host_add(ARMul_State* state, int dd, int dn, int dm, u32 fpscr,
+                                bool subtract, u32* exceptions) {
+    const u64 n = vfp_get_double(state, dn);
+    const u64 m = vfp_get_double(state, dm);
+    if (!vfp_double_host_operands(fpscr, n, m)) {
+        return false;
+    }
+    const double a = std::bit_cast<double>(n);
+    const double b = subtract ? -std::bit_cast<double>(m) : std::bit_cast<double>(m);
+    const double sum = a + b;
+    // Exact rounding error of the sum (TwoSum)
+    const double b_virtual = sum - a;
+    const double error = (a - (sum - b_virtual)) + (b - b_virtual);
+    return vfp_double_host_result(state, dd, sum, error != 0.0, exceptions);
+}
+
+static bool vfp_double_host_mul(ARMul_State* state, int dd, int dn, int dm, u32 fpscr,
+                                bool negate, u32* exceptions) {
+    const u64 n = vfp_get_double(state, dn);
+    const u64 m = vfp_get_double(state, dm);
+    if (!vfp_double_host_operands(fpscr, n, m)) {
+        return false;
+    }
+    const double a = std::bit_cast<double>(n);
+    const double b = std::bit_cast<double>(m);
+    const double product = a * b;
+    // The fused multiply-add yields the exact rounding error of the product
+    const bool inexact = std::fma(a, b, -product) != 0.0;
+    return vfp_double_host_result(state, dd, negate ? -product : product, inexact, exceptions);
+}
+
+static bool vfp_double_host_div(ARMul_State* state, int dd, int dn, int dm, u32 fpscr,
+                                u32* exceptions) {
+    const u64 n = vfp_get_double(state, dn);
+    const u64 m = vfp_get_double(state, dm);
+    // Division by zero raises DZC, leave it to the emulation
+    if (!vfp_double_host_operands(fpscr, n, m) || (m << 1) == 0) {
+        return false;
+    }
+    const double a = std::bit_cast<double>(n);
+    const double b = std::bit_cast<double>(m);
+    const double quotient = a / b;
+    // The quotient is exact if multiplying it back gives a without any rounding
+    const bool inexact = std::fma(quotient, b, -a) != 0.0;
+    return vfp_double_host_result(state, dd, quotient, inexact, exceptions);
+}
+
 /*
  * sd = sn * sm
  */
@@ -969,6 +1047,9 @@ static u32 vfp_double_fmul(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     u32 exceptions = 0;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    if (vfp_double_host_mul(state, dd, dn, dm, fpscr, false, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     if (vdn.exponent == 0 && vdn.significand)
         vfp_double_normalise_denormal(&vdn);
@@ -989,6 +1070,9 @@ static u32 vfp_double_fnmul(ARMul_State* state, int dd, int dn, int dm, u32 fpsc
     u32 exceptions = 0;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    if (vfp_double_host_mul(state, dd, dn, dm, fpscr, true, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     if (vdn.exponent == 0 && vdn.significand)
         vfp_double_normalise_denormal(&vdn);
@@ -1011,6 +1095,9 @@ static u32 vfp_double_fadd(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     u32 exceptions = 0;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    if (vfp_double_host_add(state, dd, dn, dm, fpscr, false, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     if (vdn.exponent == 0 && vdn.significand)
         vfp_double_normalise_denormal(&vdn);
@@ -1032,6 +1119,9 @@ static u32 vfp_double_fsub(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     u32 exceptions = 0;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    if (vfp_double_host_add(state, dd, dn, dm, fpscr, true, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     if (vdn.exponent == 0 && vdn.significand)
         vfp_double_normalise_denormal(&vdn);
@@ -1059,6 +1149,9 @@ static u32 vfp_double_fdiv(ARMul_State* state, int dd, int dn, int dm, u32 fpscr
     int tm, tn;
 
     LOG_TRACE(Core_ARM11, "In {}", __FUNCTION__);
+    if (vfp_double_host_div(state, dd, dn, dm, fpscr, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_double_unpack(&vdn, vfp_get_double(state, dn), fpscr);
     exceptions |= vfp_double_unpack(&vdm, vfp_get_double(state, dm), fpscr);
 
@@ -52,6 +52,9 @@
  */
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
@@ -986,6 +989,79 @@ static u32 vfp_single_fnmsc(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr
                                           "fnmsc");
 }
 
+/*
+ * Host FPU fast path for the common case. With round to nearest, operands that are zero or normal
+ * and a result that is zero or normal, the emulation can only raise inexact. Computing in double
+ * precision and rounding to single gives the correctly rounded result for add, mul and div, as
+ * double has more than twice the precision of single, so the host result matches bit for bit.
+ * Everything else is left to the emulation.
+ */
+static bool vfp_single_host_operand(s32 val) {
+    const u32 exponent = (static_cast<u32>(val) >> 23) & 0xFF;
+    return exponent != 0xFF && (exponent != 0 || (val & 0x7FFFFF) == 0);
+}
+
+static bool vfp_single_host_operands(u32 fpscr, s32 n, s32 m) {
+    return (fpscr & FPSCR_RMODE_MASK) == FPSCR_ROUND_NEAREST && vfp_single_host_operand(n) &&
+           vfp_single_host_operand(m);
+}
+
+/*
+ * Stores the host result if the emulation would store the same value. value is the result in
+ * double precision, inexact is set when computing it already rounded.
+ */
+static bool vfp_single_host_result(ARMul_State* state, int sd, double value, bool inexact,
+                                   u32* exceptions) {
+    const float result = static_cast<float>(value);
+    // Tininess is detected before rounding, so the unrounded value must not be below the
+    // smallest normal.
+    if (value != 0.0 && !(std::fabs(value) > std::numeric_limits<float>::min() &&
+                          std::fabs(result) <= std::numeric_limits<float>::max())) {
+        return false;
+    }
+    vfp_put_float(state, std::bit_cast<s32>(result), sd);
+    *exceptions = (inexact || static_cast<double>(result) != value) ? FPSCR_IXC : 0;
+    return true;
+}
+
+static bool vfp_single_host_add(ARMul_State* state, int sd, s32 n, s32 m, u32 fpscr,
+                                u32* exceptions) {
+    if (!vfp_single_host_operands(fpscr, n, m)) {
+        return false;
+    }
+    const double a = std::bit_cast<float>(n);
+    const double b = std::bit_cast<float>(m);
+    const double sum = a + b;
+    // Exact rounding error of the double sum (TwoSum)
+    const double b_virtual = sum - a;
+    const double error = (a - (sum - b_virtual)) + (b - b_virtual);
+    return vfp_single_host_result(state, sd, sum, error != 0.0, exceptions);
+}
+
+static bool vfp_single_host_mul(ARMul_State* state, int sd, s32 n, s32 m, u32 fpscr, bool negate,
+                                u32* exceptions) {
+    if (!vfp_single_host_operands(fpscr, n, m)) {
+        return false;
+    }
+    // The product of two singles is exact in double precision
+    const double product = static_cast<double>(std::bit_cast<float>(n)) * std::bit_cast<float>(m);
+    return vfp_single_host_result(state, sd, negate ? -product : product, false, exceptions);
+}
+
+static bool vfp_single_host_div(ARMul_State* state, int sd, s32 n, s32 m, u32 fpscr,
+                                u32* exceptions) {
+    // Division by zero raises DZC, leave it to the emulation
+    if (!vfp_single_host_operands(fpscr, n, m) || (m & 0x7FFFFFFF) == 0) {
+        return false;
+    }
+    const double a = std::bit_cast<float>(n);
+    const double b = std::bit_cast<float>(m);
+    const double quotient = a / b;
+    // The quotient is exact if the rounded single times b, which is exact in double, gives a
+    const double rounded = static_cast<float>(quotient);
+    return vfp_single_host_result(state, sd, quotient, rounded * b != a, exceptions);
+}
+
 /*
  * sd = sn * sm
  */
@@ -996,6 +1072,9 @@ static u32 vfp_single_fmul(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr)
 
     LOG_TRACE(Core_ARM11, "s{} = {:08x}", sn, n);
 
+    if (vfp_single_host_mul(state, sd, n, m, fpscr, false, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_single_unpack(&vsn, n, fpscr);
     if (vsn.exponent == 0 && vsn.significand)
         vfp_single_normalise_denormal(&vsn);
@@ -1018,6 +1097,9 @@ static u32 vfp_single_fnmul(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr
 
     LOG_TRACE(Core_ARM11, "s{} = {:08x}", sn, n);
 
+    if (vfp_single_host_mul(state, sd, n, m, fpscr, true, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_single_unpack(&vsn, n, fpscr);
     if (vsn.exponent == 0 && vsn.significand)
         vfp_single_normalise_denormal(&vsn);
@@ -1041,6 +1123,9 @@ static u32 vfp_single_fadd(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr)
 
     LOG_TRACE(Core_ARM11, "s{} = {:08x}", sn, n);
 
+    if (vfp_single_host_add(state, sd, n, m, fpscr, &exceptions))
+        return exceptions;
+
     /*
      * Unpack and normalise denormals.
      */
@@ -1092,6 +1177,9 @@ static u32 vfp_single_fdiv(ARMul_State* state, int sd, int sn, s32 m, u32 fpscr)
 
     LOG_TRACE(Core_ARM11, "s{} = {:08x}", sn, n);
 
+    if (vfp_single_host_div(state, sd, n, m, fpscr, &exceptions))
+        return exceptions;
+
     exceptions |= vfp_single_unpack(&vsn, n, fpscr);
     exceptions |= vfp_single_unpack(&vsm, m, fpscr);
 
@@ -0,0 +1,50 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <stdexcept>
+#include "common/logging/log.h"
+#include "core/branch_explorer.h"
+#include "core/core.h"
+#include "core/movie.h"
+
+namespace Core {
+
+BranchExplorer::BranchExplorer(System& system_) : system{system_} {}
+
+BranchExplorer::~BranchExplorer() = default;
+
+void BranchExplorer::Fork() {
+    // The fork point is restored once per branch, so it is kept uncompressed and never diffed
+    // against.
+    fork_point = system.CaptureSnapshot();
+    fork_point.page_hashes = {};
+    branch_count = 0;
+    LOG_INFO(Core, "Forked at snapshot {}, {} bytes", fork_point.id, fork_point.data.size());
+}
+
+void BranchExplorer::StartBranch(const std::string& movie_file) {
+    RestoreForkPoint();
+    system.Movie().StartPlayback(movie_file);
+    LOG_INFO(Core, "Started branch {} playing {}", branch_count, movie_file);
+}
+
+void BranchExplorer::StartBranchRecording(const std::string& movie_file,
+                                          const std::string& author) {
+    RestoreForkPoint();
+    system.Movie().StartRecording(movie_file, author);
+    LOG_INFO(Core, "Started branch {} recording {}", branch_count, movie_file);
+}
+
+void BranchExplorer::RestoreForkPoint() {
+    if (!HasForkPoint()) {
+        throw std::runtime_error("There is no fork point to branch from");
+    }
+
+    // Saves the movie of a recorded branch before its inputs are left behind.
+    system.Movie().Shutdown();
+    system.RestoreSnapshot(fork_point);
+    branch_count++;
+}
+
+} // namespace Core
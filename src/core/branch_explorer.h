@@ -0,0 +1,65 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include "common/common_types.h"
+#include "core/savestate.h"
+
+namespace Core {
+
+class System;
+
+/**
+ * Explores several branches of emulation from a common fork point. Forking keeps the current
+ * state as an in-memory snapshot, and every branch restores it before its own movie takes over
+ * the inputs, so branches only differ in what was played from the fork point on. Branches run
+ * one after the other on the same system.
+ */
+class BranchExplorer {
+public:
+    explicit BranchExplorer(System& system);
+    ~BranchExplorer();
+
+    /**
+     * Keeps the current state as the fork point of all following branches. Must be called from
+     * the emulation thread, between slices.
+     * @throws std::runtime_error if the state could not be captured.
+     */
+    void Fork();
+
+    [[nodiscard]] bool HasForkPoint() const {
+        return fork_point.id != 0;
+    }
+
+    /// Returns the number of branches started from the current fork point
+    [[nodiscard]] u32 GetBranchCount() const {
+        return branch_count;
+    }
+
+    /**
+     * Ends the current branch, restores the fork point and plays the given movie from there. The
+     * movie is expected to have been recorded from the fork point. Must be called from the
+     * emulation thread, between slices.
+     * @throws std::runtime_error if there is no fork point or it could not be restored.
+     */
+    void StartBranch(const std::string& movie_file);
+
+    /**
+     * Like StartBranch, but records the inputs of the new branch to the given movie, which can
+     * then be played back as a branch of the same fork point.
+     */
+    void StartBranchRecording(const std::string& movie_file, const std::string& author);
+
+private:
+    /// Ends the current branch and restores the fork point
+    void RestoreForkPoint();
+
+    System& system;
+    StateSnapshot fork_point;
+    u32 branch_count{};
+};
+
+} // namespace Core
@@ -6,6 +6,7 @@
 #include <cmath>
 #include <fstream>
 #include <functional>
+#include <optional>
 #include <span>
 #include <string>
 #include <vector>
@@ -131,24 +132,47 @@ static inline void AddOffsetOp(const GatewayCheat::CheatLine& line, State& state
     state.offset += line.value;
 }
 
-static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state,
-                           const Core::System& system) {
-    u32 pad_state = system.ServiceManager()
-                        .GetService<Service::HID::Module::Interface>("hid:USER")
-                        ->GetModule()
-                        ->GetState()
-                        .hex;
+static inline u32 GetPadState(const Core::System& system) {
+    return system.ServiceManager()
+        .GetService<Service::HID::Module::Interface>("hid:USER")
+        ->GetModule()
+        ->GetState()
+        .hex;
+}
+
+static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state, u32 pad_state) {
     bool pressed = (pad_state & line.value) == line.value;
     if (!pressed) {
         state.if_flag++;
     }
 }
 
+static constexpr bool IsConditional(GatewayCheat::CheatType type) {
+    switch (type) {
+    case GatewayCheat::CheatType::GreaterThan32:
+    case GatewayCheat::CheatType::LessThan32:
+    case GatewayCheat::CheatType::EqualTo32:
+    case GatewayCheat::CheatType::NotEqualTo32:
+    case GatewayCheat::CheatType::GreaterThan16WithMask:
+    case GatewayCheat::CheatType::LessThan16WithMask:
+    case GatewayCheat::CheatType::EqualTo16WithMask:
+    case GatewayCheat::CheatType::NotEqualTo16WithMask:
+    case GatewayCheat::CheatType::Joker:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static inline std::size_t GetPatchLineCount(const GatewayCheat::CheatLine& line) {
+    return static_cast<std::size_t>(std::ceil(line.value / 8.0));
+}
+
 static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Core::System& system,
                            std::span<const GatewayCheat::CheatLine> cheat_lines) {
     if (state.if_flag > 0) {
         // Skip over the additional patch lines
-        state.current_line_nr += static_cast<int>(std::ceil(line.value / 8.0));
+        state.current_line_nr += GetPatchLineCount(line);
         return;
     }
     u32 num_bytes = line.value;
@@ -212,6 +236,7 @@ GatewayCheat::CheatLine::CheatLine(const std::string& line) {
 GatewayCheat::GatewayCheat(std::string name_, std::vector<CheatLine> cheat_lines_,
                            std::string comments_)
     : name(std::move(name_)), cheat_lines(std::move(cheat_lines_)), comments(std::move(comments_)) {
+    ComputeSkipTargets();
 }
 
 GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comments_)
@@ -225,10 +250,41 @@ GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comm
             temp_cheat_lines.emplace_back(line);
     }
     cheat_lines = std::move(temp_cheat_lines);
+    ComputeSkipTargets();
 }
 
 GatewayCheat::~GatewayCheat() = default;
 
+void GatewayCheat::ComputeSkipTargets() {
+    skip_targets.assign(cheat_lines.size(), {});
+    for (std::size_t i = 0; i < cheat_lines.size(); i++) {
+        if (!IsConditional(cheat_lines[i].type)) {
+            continue;
+        }
+
+        // Mirrors the handling of lines in Execute while the if_flag is set: the scan only stops
+        // at the terminator closing the block or at a full terminator.
+        u32 if_flag = 1;
+        std::size_t line_nr = i + 1;
+        for (; line_nr < cheat_lines.size(); line_nr++) {
+            const auto& line = cheat_lines[line_nr];
+            if (IsConditional(line.type)) {
+                if_flag++;
+            } else if (line.type == CheatType::Patch) {
+                line_nr += GetPatchLineCount(line);
+            } else if (line.type == CheatType::Terminator) {
+                if (if_flag == 1) {
+                    break;
+                }
+                if_flag--;
+            } else if (line.type == CheatType::FullTerminator) {
+                break;
+            }
+        }
+        skip_targets[i] = {std::min(line_nr, cheat_lines.size()), if_flag};
+    }
+}
+
 void GatewayCheat::Execute(Core::System& system) const {
     State state;
 
@@ -239,10 +295,12 @@ void GatewayCheat::Execute(Core::System& system) const {
     auto Write8 = [&memory](VAddr addr, u8 value) { memory.Write8(addr, value); };
     auto Write16 = [&memory](VAddr addr, u16 value) { memory.Write16(addr, value); };
     auto Write32 = [&memory](VAddr addr, u32 value) { memory.Write32(addr, value); };
+    // The pad state does not change while the cheat runs, so look the service up once
+    std::optional<u32> pad_state;
 
     for (state.current_line_nr = 0; state.current_line_nr < cheat_lines.size();
          state.current_line_nr++) {
-        auto line = cheat_lines[state.current_line_nr];
+        const auto& line = cheat_lines[state.current_line_nr];
         if (state.if_flag > 0) {
             switch (line.type) {
             case CheatType::GreaterThan32:
@@ -411,7 +469,10 @@ void GatewayCheat::Execute(Core::System& system) const {
         }
         case CheatType::Joker: {
             // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
-            JokerOp(line, state, system);
+            if (!pad_state) {
+                pad_state = GetPadState(system);
+            }
+            JokerOp(line, state, *pad_state);
             break;
         }
         case CheatType::Patch: {
@@ -421,6 +482,14 @@ void GatewayCheat::Execute(Core::System& system) const {
             break;
         }
         }
+
+        if (state.if_flag > 0) {
+            // The condition of this line failed, continue at the end of its block as if every line
+            // in between had been scanned.
+            const SkipTarget& target = skip_targets[state.current_line_nr];
+            state.current_line_nr = target.line - 1;
+            state.if_flag = target.if_flag;
+        }
     }
 }
 
@@ -80,9 +80,22 @@ public:
     static std::vector<std::shared_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
 private:
+    /// Where execution resumes when the condition on a line fails.
+    struct SkipTarget {
+        std::size_t line;
+        u32 if_flag;
+    };
+
+    /**
+     * Precomputes, for every conditional line, the line at which scanning for the end of its block
+     * stops, so that a failed condition jumps there instead of walking the block line by line.
+     */
+    void ComputeSkipTargets();
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
+    std::vector<SkipTarget> skip_targets;
     const std::string comments;
 };
 } // namespace Cheats
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <utility>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/hle/hle.h"
@@ -11,6 +12,7 @@
 #include "common/settings.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/exclusive_monitor.h"
+#include "core/arm/parallel_cores.h"
 #include "core/hle/service/cam/cam.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/ir/ir_user.h"
@@ -41,6 +43,7 @@
 #include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
+#include "core/rewind_buffer.h"
 #ifdef ENABLE_SCRIPTING
 #include "core/rpc/server.h"
 #endif
@@ -107,10 +110,58 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         frame_limiter.WaitOnce();
         return ResultStatus::Success;
     }
+    case Signal::Rewind: {
+        if (!rewind_buffer) {
+            return ResultStatus::Success;
+        }
+        try {
+            if (!rewind_buffer->Rewind()) {
+                LOG_INFO(Core, "No rewind snapshot available");
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error rewinding: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+        frame_limiter.WaitOnce();
+        return ResultStatus::Success;
+    }
+    case Signal::SeekMovie: {
+        const u32 input_index = param;
+        try {
+            if (!movie.SeekToInput(input_index)) {
+                LOG_INFO(Core, "No movie keyframe available before input {}", input_index);
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error seeking movie: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+        frame_limiter.WaitOnce();
+        return ResultStatus::Success;
+    }
     default:
         break;
     }
 
+    if (rewind_buffer) {
+        rewind_buffer->OnFrame(perf_stats->GetGameFrameCount());
+    }
+    movie.OnFrame(perf_stats->GetGameFrameCount());
+
+    // Interrupts raised on the GPU thread are signalled at slice boundaries. When no core has a
+    // thread to run the guest is most likely waiting for one, so wait for the GPU instead of
+    // idling ahead to the next event.
+    if (gpu->HasGpuThread()) {
+        const bool all_idle = std::ranges::all_of(cpu_cores, [this](const auto& cpu_core) {
+            return kernel->GetThreadManager(cpu_core->GetID()).GetCurrentThread() == nullptr;
+        });
+        if (all_idle) {
+            gpu->WaitIdle();
+        }
+        gpu->SignalDeferredInterrupts();
+    }
+
     // All cores should have executed the same amount of ticks. If this is not the case an event was
     // scheduled with a cycles_into_future smaller then the current downcount.
     // So we have to get those cores to the same global time first
@@ -135,9 +186,8 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
 
     // jit sometimes overshoot by a few ticks which might lead to a minimal desync in the cores.
     // This small difference shouldn't make it necessary to sync the cores and would only cost
-    // performance. Thus we don't sync delays below min_delay
-    static constexpr s64 min_delay = 100;
-    if (max_delay > min_delay) {
+    // performance. Thus we don't sync small delays
+    if (max_delay > Timing::MIN_CORE_SYNC_DELAY) {
         LOG_TRACE(Core_ARM11, "Core {} running (delayed) for {} ticks",
                   current_core_to_execute->GetID(),
                   current_core_to_execute->GetTimer().GetDowncount());
@@ -150,6 +200,7 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             current_core_to_execute->GetTimer().Idle();
             PrepareReschedule();
         } else {
+            PerfStats::ScopedTimer timer{perf_stats.get(), PerfStats::Subsystem::Cpu};
             if (tight_loop) {
                 current_core_to_execute->Run();
             } else {
@@ -169,27 +220,32 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             kernel->GetThreadManager(cpu_core->GetID()).Reschedule();
             max_slice = std::min(max_slice, cpu_core->GetTimer().GetMaxSliceLength());
         }
-        for (auto& cpu_core : cpu_cores) {
-            cpu_core->GetTimer().SetNextSlice(max_slice);
-            auto start_ticks = cpu_core->GetTimer().GetTicks();
-            LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
-                      cpu_core->GetTimer().GetDowncount());
-            running_core = cpu_core.get();
-            kernel->SetRunningCPU(running_core);
-            // If we don't have a currently active thread then don't execute instructions,
-            // instead advance to the next event and try to yield to the next thread
-            if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
-                LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
-                cpu_core->GetTimer().Idle();
-                PrepareReschedule();
-            } else {
-                if (tight_loop) {
-                    cpu_core->Run();
+        if (parallel_cores && tight_loop) {
+            RunParallelSlice(max_slice);
+        } else {
+            for (auto& cpu_core : cpu_cores) {
+                cpu_core->GetTimer().SetNextSlice(max_slice);
+                auto start_ticks = cpu_core->GetTimer().GetTicks();
+                LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
+                          cpu_core->GetTimer().GetDowncount());
+                running_core = cpu_core.get();
+                kernel->SetRunningCPU(running_core);
+                // If we don't have a currently active thread then don't execute instructions,
+                // instead advance to the next event and try to yield to the next thread
+                if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+                    LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+                    cpu_core->GetTimer().Idle();
+                    PrepareReschedule();
                 } else {
-                    cpu_core->Step();
+                    PerfStats::ScopedTimer timer{perf_stats.get(), PerfStats::Subsystem::Cpu};
+                    if (tight_loop) {
+                        cpu_core->Run();
+                    } else {
+                        cpu_core->Step();
+                    }
                 }
+                max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
             }
-            max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
         }
     }
 
@@ -198,6 +254,38 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
     return status;
 }
 
+void System::RunParallelSlice(s64 max_slice) {
+    // Unlike the serial loop every core runs the full slice, as they can't shorten it for the
+    // cores that follow. Any resulting drift is evened out at the start of the next loop.
+    u32 core_mask = 0;
+    for (auto& cpu_core : cpu_cores) {
+        cpu_core->GetTimer().SetNextSlice(max_slice);
+        running_core = cpu_core.get();
+        kernel->SetRunningCPU(running_core);
+        if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+            LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+            cpu_core->GetTimer().Idle();
+            PrepareReschedule();
+        } else {
+            core_mask |= 1U << cpu_core->GetID();
+        }
+    }
+    PerfStats::ScopedTimer timer{perf_stats.get(), PerfStats::Subsystem::Cpu};
+    parallel_cores->RunSlice(core_mask);
+}
+
+std::unique_lock<std::recursive_mutex> System::EnterCore(ARM_Interface& core) {
+    if (!parallel_cores) {
+        return {};
+    }
+    std::unique_lock lock{core_mutex};
+    if (running_core != &core) {
+        running_core = &core;
+        kernel->SetRunningCPU(running_core);
+    }
+    return lock;
+}
+
 bool System::SendSignal(System::Signal signal, u32 param) {
     std::scoped_lock lock{signal_mutex};
     if (current_signal != signal && current_signal != Signal::None) {
@@ -216,7 +304,7 @@ System::ResultStatus System::SingleStep() {
 System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::string& filepath,
                                   Frontend::EmuWindow* secondary_window) {
     FileUtil::SetCurrentRomPath(filepath);
-    app_loader = Loader::GetLoader(filepath);
+    app_loader = Loader::GetLoader(*this, filepath);
     if (!app_loader) {
         LOG_CRITICAL(Core, "Failed to obtain loader for {}!", filepath);
         return ResultStatus::ErrorGetLoader;
@@ -309,6 +397,9 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     cheat_engine.Connect();
 
     perf_stats = std::make_unique<PerfStats>(title_id);
+    if (Settings::values.enable_rewind) {
+        rewind_buffer = std::make_unique<RewindBuffer>(*this);
+    }
 
     if (Settings::values.dump_textures) {
         custom_tex_manager->PrepareDumping(title_id);
@@ -343,6 +434,14 @@ PerfStats::Results System::GetLastPerfStats() {
     return perf_stats ? perf_stats->GetLastStats() : PerfStats::Results{};
 }
 
+void System::EndFrame() {
+#ifdef ENABLE_SCRIPTING
+    if (rpc_server) {
+        rpc_server->HandleFrameEndRequests();
+    }
+#endif
+}
+
 void System::Reschedule() {
     if (!reschedule_pending) {
         return;
@@ -396,6 +495,14 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     kernel->SetCPUs(cpu_cores);
     kernel->SetRunningCPU(cpu_cores[0].get());
 
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    // Only the JIT can run concurrently, the interpreter uses a global translation buffer.
+    if (Settings::values.parallel_cpu_cores && Settings::values.use_cpu_jit && num_cores > 1) {
+        LOG_INFO(Core, "Running {} CPU cores on separate host threads", num_cores);
+        parallel_cores = std::make_unique<ParallelCores>(cpu_cores);
+    }
+#endif
+
     const auto audio_emulation = Settings::values.audio_emulation.GetValue();
     if (audio_emulation == Settings::AudioEmulation::HLE) {
         dsp_core = std::make_unique<AudioCore::DspHle>(*this);
@@ -522,14 +629,37 @@ void System::RegisterSoftwareKeyboard(std::shared_ptr<Frontend::SoftwareKeyboard
     registered_swkbd = std::move(swkbd);
 }
 
+u64 System::GetProgramId() const {
+    u64 program_id{};
+    if (!app_loader || app_loader->ReadProgramId(program_id) != Loader::ResultStatus::Success) {
+        return 0;
+    }
+    return program_id;
+}
+
 void System::RegisterImageInterface(std::shared_ptr<Frontend::ImageInterface> image_interface) {
     registered_image_interface = std::move(image_interface);
 }
 
+System::ResultStatus System::InitHeadless(Frontend::EmuWindow& emu_window) {
+    const ResultStatus init_result{
+        Init(emu_window, nullptr, Kernel::MemoryMode::Prod, Kernel::New3dsHwCapabilities{}, 1)};
+    if (init_result != ResultStatus::Success) {
+        return init_result;
+    }
+
+    perf_stats = std::make_unique<PerfStats>(0);
+    status = ResultStatus::Success;
+    m_emu_window = &emu_window;
+    return ResultStatus::Success;
+}
+
 void System::Shutdown() {
     // Shutdown emulation session
     is_powered_on = false;
 
+    rewind_buffer.reset();
+    parallel_cores.reset();
     gpu.reset();
     perf_stats.reset();
     app_loader.reset();
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
@@ -35,6 +36,12 @@ namespace Core::RPC {
 class Server;
 }
 
+namespace Core {
+class ParallelCores;
+class RewindBuffer;
+struct StateSnapshot;
+} // namespace Core
+
 namespace Service {
 namespace SM {
 class ServiceManager;
@@ -128,7 +135,7 @@ public:
     /// Shutdown and then load again
     void Reset();
 
-    enum class Signal : u32 { None, Shutdown, Reset, Save, Load };
+    enum class Signal : u32 { None, Shutdown, Reset, Save, Load, Rewind, SeekMovie };
 
     bool SendSignal(Signal signal, u32 param = 0);
 
@@ -153,6 +160,14 @@ public:
     [[nodiscard]] ResultStatus Load(Frontend::EmuWindow& emu_window, const std::string& filepath,
                                     Frontend::EmuWindow* secondary_window = {});
 
+    /**
+     * Initializes the emulated system without loading an application, for tools that drive the
+     * GPU directly such as the GPU trace benchmark.
+     * @param emu_window Reference to the host-system window used for video output.
+     * @returns ResultStatus code, indicating if the operation succeeded.
+     */
+    [[nodiscard]] ResultStatus InitHeadless(Frontend::EmuWindow& emu_window);
+
     /**
      * Indicates if the emulated system is powered on (all subsystems initialized and able to run an
      * application).
@@ -169,6 +184,9 @@ public:
 
     [[nodiscard]] PerfStats::Results GetLastPerfStats();
 
+    /// Runs the work waiting for the end of the emulated frame, called by the renderer
+    void EndFrame();
+
     /**
      * Gets a reference to the emulated CPU.
      * @returns A reference to the emulated CPU.
@@ -178,6 +196,12 @@ public:
         return *running_core;
     };
 
+    /**
+     * Makes the given core the running one while guest code on it calls into the emulator. When
+     * the cores run on their own host threads, the returned lock also serializes those calls.
+     */
+    [[nodiscard]] std::unique_lock<std::recursive_mutex> EnterCore(ARM_Interface& core);
+
     /**
      * Gets a reference to the emulated CPU.
      * @param core_id The id of the core requested.
@@ -275,6 +299,7 @@ public:
     }
 
     std::unique_ptr<PerfStats> perf_stats;
+    std::unique_ptr<RewindBuffer> rewind_buffer;
     FrameLimiter frame_limiter;
 
     void SetStatus(ResultStatus new_status, const char* details = nullptr) {
@@ -292,6 +317,9 @@ public:
         return *app_loader;
     }
 
+    /// Returns the program id of the loaded application, 0 if there is none
+    [[nodiscard]] u64 GetProgramId() const;
+
     /// Frontend Applets
 
     void RegisterMiiSelector(std::shared_ptr<Frontend::MiiSelector> mii_selector);
@@ -325,9 +353,32 @@ public:
                (mic_permission_granted = mic_permission_func());
     }
 
-    void SaveState(u32 slot) const {}
+    /**
+     * Saves a compressed snapshot of the emulated system to the given slot.
+     * @throws std::runtime_error if the state could not be written.
+     */
+    void SaveState(u32 slot) const;
+
+    /**
+     * Restores the emulated system from the snapshot in the given slot.
+     * @throws std::runtime_error if the state is missing, corrupted or incompatible.
+     */
+    void LoadState(u32 slot);
+
+    /**
+     * Captures the emulated system into an in-memory snapshot.
+     * @param base If set, only the memory pages that changed since this snapshot are stored.
+     */
+    [[nodiscard]] StateSnapshot CaptureSnapshot(const StateSnapshot* base = nullptr) const;
 
-    void LoadState(u32 slot) {}
+    /**
+     * Restores the emulated system from an in-memory snapshot.
+     * @param bases The chain of snapshots an incremental snapshot is based on, starting with the
+     * nearest full snapshot and ending with its direct base.
+     * @throws std::runtime_error if the snapshot is corrupted or its chain is incomplete.
+     */
+    void RestoreSnapshot(const StateSnapshot& snapshot,
+                         std::span<const StateSnapshot* const> bases = {});
 
     /// Self delete ncch
     bool SetSelfDelete(const std::string& file) {
@@ -358,6 +409,9 @@ private:
     /// Reschedule the core emulation
     void Reschedule();
 
+    /// Runs a slice of max_slice ticks on all cores at once, on their own host threads.
+    void RunParallelSlice(s64 max_slice);
+
     /// AppLoader used to load the current executing application
     std::unique_ptr<Loader::AppLoader> app_loader;
 
@@ -365,6 +419,10 @@ private:
     std::vector<std::shared_ptr<ARM_Interface>> cpu_cores;
     ARM_Interface* running_core = nullptr;
 
+    /// Host threads of the secondary cores, if they run in parallel
+    std::unique_ptr<ParallelCores> parallel_cores;
+    std::recursive_mutex core_mutex;
+
     /// DSP core
     std::unique_ptr<AudioCore::DspInterface> dsp_core;
 
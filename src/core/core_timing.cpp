@@ -9,6 +9,7 @@
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "core/core_timing.h"
+#include "core/savestate.h"
 
 namespace Core {
 
@@ -21,6 +22,132 @@ bool Timing::Event::operator<(const Timing::Event& right) const {
     return std::tie(time, fifo_order) < std::tie(right.time, right.fifo_order);
 }
 
+void Timing::EventQueue::Push(const Event& event) {
+    u32 handle;
+    if (free_slots.empty()) {
+        handle = static_cast<u32>(slots.size());
+        slots.emplace_back();
+    } else {
+        handle = free_slots.back();
+        free_slots.pop_back();
+    }
+
+    auto& type_handles = by_type[event.type];
+    slots[handle].type_index = static_cast<u32>(type_handles.size());
+    type_handles.push_back(handle);
+
+    heap.push_back(Node{event, handle});
+    slots[handle].heap_index = static_cast<u32>(heap.size() - 1);
+    SiftUp(heap.size() - 1);
+}
+
+void Timing::EventQueue::Pop() {
+    RemoveAt(0);
+}
+
+void Timing::EventQueue::Remove(const TimingEventType* type) {
+    const auto it = by_type.find(type);
+    if (it == by_type.end()) {
+        return;
+    }
+    // RemoveAt() erases from the partition, so work on a copy.
+    const std::vector<u32> handles = it->second;
+    for (const u32 handle : handles) {
+        RemoveAt(slots[handle].heap_index);
+    }
+}
+
+void Timing::EventQueue::Remove(const TimingEventType* type, std::uintptr_t user_data) {
+    const auto it = by_type.find(type);
+    if (it == by_type.end()) {
+        return;
+    }
+    auto& handles = it->second;
+    for (std::size_t i = 0; i < handles.size();) {
+        const u32 heap_index = slots[handles[i]].heap_index;
+        if (heap[heap_index].event.user_data == user_data) {
+            // The last handle of the partition is moved into position i.
+            RemoveAt(heap_index);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void Timing::EventQueue::Clear() {
+    heap.clear();
+    slots.clear();
+    free_slots.clear();
+    by_type.clear();
+}
+
+void Timing::EventQueue::RemoveAt(std::size_t index) {
+    const u32 handle = heap[index].handle;
+
+    auto& type_handles = by_type[heap[index].event.type];
+    const u32 type_index = slots[handle].type_index;
+    type_handles[type_index] = type_handles.back();
+    slots[type_handles[type_index]].type_index = type_index;
+    type_handles.pop_back();
+    free_slots.push_back(handle);
+
+    Node last = std::move(heap.back());
+    heap.pop_back();
+    if (index == heap.size()) {
+        return;
+    }
+
+    // The moved node may belong either above or below its new position.
+    const bool move_up = index > 0 && last.event < heap[(index - 1) / Arity].event;
+    Place(index, std::move(last));
+    if (move_up) {
+        SiftUp(index);
+    } else {
+        SiftDown(index);
+    }
+}
+
+void Timing::EventQueue::SiftUp(std::size_t index) {
+    Node node = std::move(heap[index]);
+    while (index > 0) {
+        const std::size_t parent = (index - 1) / Arity;
+        if (!(node.event < heap[parent].event)) {
+            break;
+        }
+        Place(index, std::move(heap[parent]));
+        index = parent;
+    }
+    Place(index, std::move(node));
+}
+
+void Timing::EventQueue::SiftDown(std::size_t index) {
+    Node node = std::move(heap[index]);
+    while (true) {
+        const std::size_t first_child = index * Arity + 1;
+        if (first_child >= heap.size()) {
+            break;
+        }
+        const std::size_t last_child = std::min(first_child + Arity, heap.size());
+        std::size_t smallest = first_child;
+        for (std::size_t child = first_child + 1; child < last_child; ++child) {
+            if (heap[child].event < heap[smallest].event) {
+                smallest = child;
+            }
+        }
+        if (!(heap[smallest].event < node.event)) {
+            break;
+        }
+        Place(index, std::move(heap[smallest]));
+        index = smallest;
+    }
+    Place(index, std::move(node));
+}
+
+void Timing::EventQueue::Place(std::size_t index, Node&& node) {
+    slots[node.handle].heap_index = static_cast<u32>(index);
+    heap[index] = std::move(node);
+}
+
 Timing::Timing(std::size_t num_cores, u32 cpu_clock_percentage, s64 override_base_ticks) {
     // Generate non-zero base tick count to simulate time the system ran before launching the game.
     // This accounts for games that rely on the system tick to seed randomness.
@@ -88,9 +215,7 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
             if (!timer->is_timer_sane)
                 timer->ForceExceptionCheck(cycles_into_future);
 
-            timer->event_queue.emplace_back(
-                Event{timeout, timer->event_fifo_id++, user_data, event_type});
-            std::push_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+            timer->event_queue.Push(Event{timeout, timer->event_fifo_id++, user_data, event_type});
         } else {
             timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
                                        user_data, event_type});
@@ -100,29 +225,14 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
 
 void Timing::UnscheduleEvent(const TimingEventType* event_type, std::uintptr_t user_data) {
     for (auto timer : timers) {
-        auto itr = std::remove_if(
-            timer->event_queue.begin(), timer->event_queue.end(),
-            [&](const Event& e) { return e.type == event_type && e.user_data == user_data; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        timer->event_queue.Remove(event_type, user_data);
     }
     // TODO:remove events from ts_queue
 }
 
 void Timing::RemoveEvent(const TimingEventType* event_type) {
     for (auto timer : timers) {
-        auto itr = std::remove_if(timer->event_queue.begin(), timer->event_queue.end(),
-                                  [&](const Event& e) { return e.type == event_type; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        timer->event_queue.Remove(event_type);
     }
     // TODO:remove events from ts_queue
 }
@@ -151,6 +261,59 @@ std::shared_ptr<Timing::Timer> Timing::GetTimer(std::size_t cpu_id) {
     return timers[cpu_id];
 }
 
+void Timing::SaveState(StateWriter& writer) const {
+    writer.Write<u32>(MakeStateTag("TIMG"));
+    writer.Write<u32>(static_cast<u32>(timers.size()));
+    for (const auto& timer : timers) {
+        writer.Write<s64>(timer->slice_length);
+        writer.Write<s64>(timer->downcount);
+        writer.Write<s64>(timer->executed_ticks);
+        writer.Write<u64>(timer->idled_cycles);
+        writer.Write<u64>(timer->event_fifo_id);
+        writer.Write<bool>(timer->is_timer_sane);
+        writer.Write<u32>(static_cast<u32>(timer->event_queue.Size()));
+        timer->event_queue.ForEach([&writer](const Event& event) {
+            writer.Write<s64>(event.time);
+            writer.Write<u64>(event.fifo_order);
+            writer.Write<u64>(static_cast<u64>(event.user_data));
+            writer.WriteString(*event.type->name);
+        });
+    }
+}
+
+void Timing::LoadState(StateReader& reader) {
+    reader.ExpectTag(MakeStateTag("TIMG"));
+    if (reader.Read<u32>() != timers.size()) {
+        throw std::runtime_error("Savestate core count does not match the running system");
+    }
+
+    for (auto& timer : timers) {
+        reader.Read(timer->slice_length);
+        reader.Read(timer->downcount);
+        reader.Read(timer->executed_ticks);
+        reader.Read(timer->idled_cycles);
+        reader.Read(timer->event_fifo_id);
+        reader.Read(timer->is_timer_sane);
+
+        const u32 num_events = reader.Read<u32>();
+        timer->event_queue.Clear();
+        for (u32 i = 0; i < num_events; ++i) {
+            Event event{};
+            reader.Read(event.time);
+            reader.Read(event.fifo_order);
+            event.user_data = static_cast<std::uintptr_t>(reader.Read<u64>());
+
+            const std::string name = reader.ReadString();
+            const auto it = event_types.find(name);
+            if (it == event_types.end()) {
+                throw std::runtime_error(fmt::format("Unknown timing event '{}'", name));
+            }
+            event.type = &it->second;
+            timer->event_queue.Push(event);
+        }
+    }
+}
+
 Timing::Timer::Timer(s64 base_ticks) : executed_ticks(base_ticks) {}
 
 Timing::Timer::~Timer() {
@@ -184,16 +347,15 @@ void Timing::Timer::ForceExceptionCheck(s64 cycles) {
 void Timing::Timer::MoveEvents() {
     for (Event ev; ts_queue.Pop(ev);) {
         ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+        event_queue.Push(ev);
     }
 }
 
 s64 Timing::Timer::GetMaxSliceLength() const {
-    const auto& next_event = event_queue.begin();
-    if (next_event != event_queue.end()) {
-        ASSERT(next_event->time - executed_ticks > 0);
-        return next_event->time - executed_ticks;
+    if (!event_queue.Empty()) {
+        const Event& next_event = event_queue.Top();
+        ASSERT(next_event.time - executed_ticks > 0);
+        return next_event.time - executed_ticks;
     }
     return MAX_SLICE_LENGTH;
 }
@@ -209,10 +371,9 @@ void Timing::Timer::Advance() {
 
     is_timer_sane = true;
 
-    while (!event_queue.empty() && event_queue.front().time <= executed_ticks) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+    while (!event_queue.Empty() && event_queue.Top().time <= executed_ticks) {
+        const Event evt = event_queue.Top();
+        event_queue.Pop();
         if (evt.type->callback != nullptr) {
             evt.type->callback(evt.user_data, static_cast<int>(executed_ticks - evt.time));
         } else {
@@ -227,9 +388,9 @@ void Timing::Timer::SetNextSlice(s64 max_slice_length) {
     slice_length = max_slice_length;
 
     // Still events left (scheduled in the future)
-    if (!event_queue.empty()) {
+    if (!event_queue.Empty()) {
         slice_length = static_cast<int>(
-            std::min<s64>(event_queue.front().time - executed_ticks, max_slice_length));
+            std::min<s64>(event_queue.Top().time - executed_ticks, max_slice_length));
     }
 
     downcount = slice_length;
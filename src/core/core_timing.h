@@ -129,6 +129,9 @@ constexpr u64 cyclesToMs(s64 cycles) {
 
 namespace Core {
 
+class StateReader;
+class StateWriter;
+
 using TimedCallback = std::function<void(std::uintptr_t user_data, int cycles_late)>;
 
 struct TimingEventType {
@@ -157,15 +160,87 @@ public:
     // scheduled and repated.
     static constexpr int MAX_SLICE_LENGTH = BASE_CLOCK_RATE_ARM11 / 234;
 
+    // The JIT overshoots slices by a few ticks. Cores that fall behind the global time by at most
+    // this many ticks are left to catch up in the next slice rather than run a slice of their own.
+    static constexpr s64 MIN_CORE_SYNC_DELAY = 100;
+
+    /**
+     * Indexed 4-ary min-heap of pending events. Each event keeps a handle to its heap position and
+     * the handles are partitioned by event type, so events can be cancelled in O(log n) without
+     * scanning the whole queue.
+     */
+    class EventQueue {
+    public:
+        [[nodiscard]] bool Empty() const {
+            return heap.empty();
+        }
+
+        [[nodiscard]] std::size_t Size() const {
+            return heap.size();
+        }
+
+        /// Returns the earliest event. The queue must not be empty.
+        [[nodiscard]] const Event& Top() const {
+            return heap.front().event;
+        }
+
+        void Push(const Event& event);
+
+        /// Removes the earliest event. The queue must not be empty.
+        void Pop();
+
+        /// Removes all events of the given type.
+        void Remove(const TimingEventType* type);
+
+        /// Removes all events of the given type with matching user data.
+        void Remove(const TimingEventType* type, std::uintptr_t user_data);
+
+        void Clear();
+
+        /// Calls func for every event, in no particular order.
+        template <typename Func>
+        void ForEach(Func&& func) const {
+            for (const Node& node : heap) {
+                func(node.event);
+            }
+        }
+
+    private:
+        struct Node {
+            Event event;
+            u32 handle;
+        };
+
+        struct Slot {
+            u32 heap_index;
+            u32 type_index; ///< Position of the handle in its by_type partition
+        };
+
+        static constexpr std::size_t Arity = 4;
+
+        void RemoveAt(std::size_t index);
+        void SiftUp(std::size_t index);
+        void SiftDown(std::size_t index);
+        void Place(std::size_t index, Node&& node);
+
+        std::vector<Node> heap;
+        std::vector<Slot> slots;
+        std::vector<u32> free_slots;
+        std::unordered_map<const TimingEventType*, std::vector<u32>> by_type;
+    };
+
     class Timer {
     public:
         Timer(s64 base_ticks = 0);
         ~Timer();
 
+        /// Returns the ticks until the next pending event, MAX_SLICE_LENGTH if there is none
         s64 GetMaxSliceLength() const;
 
         void Advance();
 
+        /// Sizes the next slice to end at the next pending event, but after at most
+        /// max_slice_length ticks. The run loop passes the smallest length of all cores.
         void SetNextSlice(s64 max_slice_length = MAX_SLICE_LENGTH);
 
         void Idle();
@@ -183,11 +258,7 @@ public:
 
     private:
         friend class Timing;
-        // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-        // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-        // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-        // accommodated by the standard adaptor class.
-        std::vector<Event> event_queue;
+        EventQueue event_queue;
         u64 event_fifo_id = 0;
         // the queue for storing the events from other threads threadsafe until they will be added
         // to the event_queue by the emu thread
@@ -250,6 +321,12 @@ public:
     /// Generates a random tick count to seed the system tick timer with.
     static s64 GenerateBaseTicks();
 
+    /// Writes the timer state and pending events to a savestate stream. Events are stored by name.
+    void SaveState(StateWriter& writer) const;
+
+    /// Restores timer state and pending events. Throws if an event type is not registered.
+    void LoadState(StateReader& reader);
+
 private:
     // unordered_map stores each element separately as a linked list node so pointers to
     // elements remain stable regardless of rehashes/resizing.
@@ -12,6 +12,15 @@ VideoFrame::VideoFrame(std::size_t width_, std::size_t height_, u8* data_)
       data(data_, data_ + width * height * 4) {}
 
 Backend::~Backend() = default;
+
+VideoFrame Backend::AcquireVideoFrame(std::size_t width, std::size_t height) {
+    VideoFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.stride = static_cast<u32>(width * 4);
+    frame.data.resize(width * height * 4);
+    return frame;
+}
 NullBackend::~NullBackend() = default;
 
 } // namespace VideoDumper
\ No newline at end of file
@@ -29,6 +29,8 @@ class Backend {
 public:
     virtual ~Backend();
     virtual bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) = 0;
+    /// Returns a frame of the given size to be filled and passed to AddVideoFrame
+    virtual VideoFrame AcquireVideoFrame(std::size_t width, std::size_t height);
     virtual void AddVideoFrame(VideoFrame frame) = 0;
     virtual void AddAudioFrame(AudioCore::StereoFrame16 frame) = 0;
     virtual void AddAudioSample(const std::array<s16, 2>& sample) = 0;
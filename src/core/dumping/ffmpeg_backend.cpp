@@ -30,6 +30,14 @@ void InitializeFFmpegLibraries() {
     initialized = true;
 }
 
+/// Lets the encoder pick its thread count unless the user set one, most encoders default to one
+void ConfigureThreads(AVCodecContext* codec_context, AVDictionary* options) {
+    if (!FFmpeg::av_dict_get(options, "threads", nullptr, 0)) {
+        codec_context->thread_count = 0;
+        codec_context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+}
+
 AVDictionary* ToAVDictionary(const std::string& serialized) {
     Common::ParamPackage param_package{serialized};
     AVDictionary* result = nullptr;
@@ -104,9 +112,31 @@ FFmpegVideoStream::~FFmpegVideoStream() {
     Free();
 }
 
+/**
+ * Returns the format of the input frames if fmt contains it, so that hardware encoders convert
+ * the frames on the GPU instead of the filter graph converting them on the CPU.
+ */
+static AVPixelFormat GetRGBPixelFormat(const AVPixelFormat* fmt) {
+    for (const AVPixelFormat rgb_format : {AV_PIX_FMT_BGRA, AV_PIX_FMT_BGR0}) {
+        for (int i = 0; fmt[i] != AV_PIX_FMT_NONE; i++) {
+            if (fmt[i] == rgb_format) {
+                return rgb_format;
+            }
+        }
+    }
+    return AV_PIX_FMT_NONE;
+}
+
 // This is modified from libavcodec/decode.c
 // The original version was broken
 static AVPixelFormat GetPixelFormat(AVCodecContext* avctx, const AVPixelFormat* fmt) {
+    if (avctx->codec->capabilities & AV_CODEC_CAP_HARDWARE) {
+        if (const AVPixelFormat rgb_format = GetRGBPixelFormat(fmt);
+            rgb_format != AV_PIX_FMT_NONE) {
+            return rgb_format;
+        }
+    }
+
     // Choose a software pixel format if any, prefering those in the front of the list
     for (int i = 0; fmt[i] != AV_PIX_FMT_NONE; i++) {
         const AVPixFmtDescriptor* desc = FFmpeg::av_pix_fmt_desc_get(fmt[i]);
@@ -195,6 +225,7 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
         codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
     }
 
+    ConfigureThreads(codec_context.get(), options);
     if (FFmpeg::avcodec_open2(codec_context.get(), codec, &options) < 0) {
         LOG_ERROR(Render, "Could not open video codec");
         return false;
@@ -325,8 +356,14 @@ bool FFmpegVideoStream::InitHWContext(const AVCodec* codec) {
         SCOPE_EXIT({ FFmpeg::av_hwframe_constraints_free(&constraints); });
 
         if (constraints) {
-            sw_pixel_format = constraints->valid_sw_formats ? constraints->valid_sw_formats[0]
-                                                            : AV_PIX_FMT_YUV420P;
+            sw_pixel_format = AV_PIX_FMT_YUV420P;
+            if (constraints->valid_sw_formats) {
+                // Uploading the frames unconverted leaves the conversion to the GPU
+                sw_pixel_format = GetRGBPixelFormat(constraints->valid_sw_formats);
+                if (sw_pixel_format == AV_PIX_FMT_NONE) {
+                    sw_pixel_format = constraints->valid_sw_formats[0];
+                }
+            }
         } else {
             LOG_WARNING(Render, "Could not query HW device constraints");
             sw_pixel_format = AV_PIX_FMT_YUV420P;
@@ -501,6 +538,7 @@ bool FFmpegAudioStream::Init(FFmpegMuxer& muxer) {
     }
 
     AVDictionary* options = ToAVDictionary(Settings::values.audio_encoder_options);
+    ConfigureThreads(codec_context.get(), options);
     if (FFmpeg::avcodec_open2(codec_context.get(), codec, &options) < 0) {
         LOG_ERROR(Render, "Could not open audio codec");
         return false;
@@ -757,21 +795,29 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
     if (video_processing_thread.joinable()) {
         video_processing_thread.join();
     }
+    video_frame_queue.clear();
     video_processing_thread = std::thread([&] {
-        event1.Set();
         while (true) {
-            event2.Wait();
-            current_buffer = (current_buffer + 1) % 2;
-            next_buffer = (current_buffer + 1) % 2;
-            event1.Set();
-            // Process this frame
-            auto& frame = video_frame_buffers[current_buffer];
+            VideoFrame frame;
+            {
+                std::unique_lock lock{video_frame_mutex};
+                video_frame_pushed.wait(lock, [this] { return !video_frame_queue.empty(); });
+                frame = std::move(video_frame_queue.front());
+                video_frame_queue.pop_front();
+            }
+            video_frame_popped.notify_one();
+
             if (frame.width == 0 && frame.height == 0) {
                 // An empty frame marks the end of frame data
                 ffmpeg.FlushVideo();
                 break;
             }
             ffmpeg.ProcessVideoFrame(frame);
+
+            std::scoped_lock lock{video_frame_mutex};
+            if (free_frame_buffers.size() <= MaxQueuedVideoFrames) {
+                free_frame_buffers.push_back(std::move(frame.data));
+            }
         }
         // Finish audio execution first if not done yet
         if (audio_processing_thread.joinable())
@@ -782,15 +828,29 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
     if (audio_processing_thread.joinable()) {
         audio_processing_thread.join();
     }
+    audio_ended = false;
     audio_processing_thread = std::thread([&] {
+        std::vector<s16> samples(AudioRingSize * 2);
         VariableAudioFrame channel0, channel1;
         while (true) {
-            channel0 = audio_frame_queues[0].PopWait();
-            channel1 = audio_frame_queues[1].PopWait();
-            if (channel0.empty()) {
-                // An empty frame marks the end of frame data
-                ffmpeg.FlushAudio();
-                break;
+            const u32 pushes = audio_pushes.load();
+            const bool ended = audio_ended.load();
+            const std::size_t sample_count = audio_samples.Pop(samples.data(), AudioRingSize);
+            if (sample_count == 0) {
+                if (ended) {
+                    // Every sample pushed before the end was processed
+                    ffmpeg.FlushAudio();
+                    break;
+                }
+                audio_pushes.wait(pushes);
+                continue;
+            }
+
+            channel0.resize(sample_count);
+            channel1.resize(sample_count);
+            for (std::size_t i = 0; i < sample_count; i++) {
+                channel0[i] = samples[i * 2];
+                channel1[i] = samples[i * 2 + 1];
             }
             ffmpeg.ProcessAudioFrame(channel0, channel1);
         }
@@ -802,29 +862,53 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
     return true;
 }
 
-void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
-    event1.Wait();
-    video_frame_buffers[next_buffer] = std::move(frame);
-    event2.Set();
+VideoFrame FFmpegBackend::AcquireVideoFrame(std::size_t width, std::size_t height) {
+    VideoFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.stride = static_cast<u32>(width * 4);
+    {
+        std::scoped_lock lock{video_frame_mutex};
+        if (!free_frame_buffers.empty()) {
+            frame.data = std::move(free_frame_buffers.back());
+            free_frame_buffers.pop_back();
+        }
+    }
+    frame.data.resize(width * height * 4);
+    return frame;
 }
 
-void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
-    std::array<VariableAudioFrame, 2> refactored_frame;
-    for (auto& channel : refactored_frame) {
-        channel.resize(frame.size());
-    }
-    for (std::size_t i = 0; i < frame.size(); i++) {
-        refactored_frame[0][i] = frame[i][0];
-        refactored_frame[1][i] = frame[i][1];
+void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
+    {
+        std::unique_lock lock{video_frame_mutex};
+        video_frame_popped.wait(
+            lock, [this] { return video_frame_queue.size() < MaxQueuedVideoFrames; });
+        video_frame_queue.push_back(std::move(frame));
     }
+    video_frame_pushed.notify_one();
+}
 
-    audio_frame_queues[0].Push(std::move(refactored_frame[0]));
-    audio_frame_queues[1].Push(std::move(refactored_frame[1]));
+void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
+    PushAudioSamples(frame.data()->data(), frame.size());
 }
 
 void FFmpegBackend::AddAudioSample(const std::array<s16, 2>& sample) {
-    audio_frame_queues[0].Push(VariableAudioFrame{sample[0]});
-    audio_frame_queues[1].Push(VariableAudioFrame{sample[1]});
+    PushAudioSamples(sample.data(), 1);
+}
+
+void FFmpegBackend::PushAudioSamples(const s16* samples, std::size_t sample_count) {
+    while (true) {
+        const std::size_t pushed = audio_samples.Push(samples, sample_count);
+        audio_pushes.fetch_add(1);
+        audio_pushes.notify_one();
+        if (pushed == sample_count) {
+            return;
+        }
+        // The encoder is more than a second behind, wait for it instead of dropping audio
+        samples += pushed * 2;
+        sample_count -= pushed;
+        std::this_thread::yield();
+    }
 }
 
 void FFmpegBackend::StopDumping() {
@@ -833,10 +917,10 @@ void FFmpegBackend::StopDumping() {
 
     // Flush the video processing queue
     AddVideoFrame(VideoFrame());
-    for (auto i : {0, 1}) {
-        // Flush the audio processing queue
-        audio_frame_queues[i].Push(VariableAudioFrame());
-    }
+    // Flush the audio processing queue
+    audio_ended = true;
+    audio_pushes.fetch_add(1);
+    audio_pushes.notify_one();
     // Wait until processing ends
     processing_ended.Wait();
 }
@@ -854,6 +938,10 @@ void FFmpegBackend::EndDumping() {
 
     ffmpeg.WriteTrailer();
     ffmpeg.Free();
+    {
+        std::scoped_lock lock{video_frame_mutex};
+        free_frame_buffers.clear();
+    }
     processing_ended.Set();
 }
 
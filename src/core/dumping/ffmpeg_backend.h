@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -14,8 +15,8 @@
 #include <vector>
 #include "common/common_types.h"
 #include "common/dynamic_library/ffmpeg.h"
+#include "common/ring_buffer.h"
 #include "common/thread.h"
-#include "common/threadsafe_queue.h"
 #include "core/dumping/backend.h"
 
 namespace VideoCore {
@@ -181,13 +182,15 @@ private:
 
 /**
  * FFmpeg video dumping backend.
- * This class implements a double buffer.
+ * Video frames are encoded on their own thread from a bounded queue, so the renderer only waits
+ * for the encoder when it falls several frames behind.
  */
 class FFmpegBackend : public Backend {
 public:
     FFmpegBackend(VideoCore::RendererBase& renderer);
     ~FFmpegBackend() override;
     bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) override;
+    VideoFrame AcquireVideoFrame(std::size_t width, std::size_t height) override;
     void AddVideoFrame(VideoFrame frame) override;
     void AddAudioFrame(AudioCore::StereoFrame16 frame) override;
     void AddAudioSample(const std::array<s16, 2>& sample) override;
@@ -196,6 +199,7 @@ public:
     Layout::FramebufferLayout GetLayout() const override;
 
 private:
+    void PushAudioSamples(const s16* samples, std::size_t sample_count);
     void EndDumping();
 
     VideoCore::RendererBase& renderer;
@@ -204,12 +208,23 @@ private:
     FFmpegMuxer ffmpeg{};
 
     Layout::FramebufferLayout video_layout;
-    std::array<VideoFrame, 2> video_frame_buffers;
-    u32 current_buffer = 0, next_buffer = 1;
-    Common::Event event1, event2;
+
+    /// Number of frames that can wait for the encoder before AddVideoFrame blocks
+    static constexpr std::size_t MaxQueuedVideoFrames = 4;
+    std::deque<VideoFrame> video_frame_queue;
+    /// Storage of encoded frames, reused by AcquireVideoFrame to avoid reallocating every frame
+    std::vector<std::vector<u8>> free_frame_buffers;
+    std::mutex video_frame_mutex;
+    std::condition_variable video_frame_pushed;
+    std::condition_variable video_frame_popped;
     std::thread video_processing_thread;
 
-    std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
+    /// Interleaved stereo samples from the DSP. Pushing them neither locks nor allocates, so the
+    /// emulation thread does not wait for the audio encoder.
+    static constexpr std::size_t AudioRingSize = 1 << 16;
+    Common::RingBuffer<s16, AudioRingSize, 2> audio_samples;
+    std::atomic<u32> audio_pushes = 0; ///< Incremented and notified after every push
+    std::atomic_bool audio_ended = false;
     std::thread audio_processing_thread;
 
     Common::Event processing_ended;
@@ -11,6 +11,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "core/file_sys/archive_extsavedata.h"
+#include "core/file_sys/directory_cache.h"
 #include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/path_parser.h"
@@ -87,9 +88,12 @@ public:
 class ExtSaveDataArchive : public SaveDataArchive {
 public:
     explicit ExtSaveDataArchive(const std::string& mount_point,
-                                std::unique_ptr<DelayGenerator> delay_generator_)
+                                std::unique_ptr<DelayGenerator> delay_generator_,
+                                std::shared_ptr<DirectoryCache> directory_cache_)
         : SaveDataArchive(mount_point, false) {
         delay_generator = std::move(delay_generator_);
+        // Files of ExtSaveData can't be resized, so listings only change with the directories
+        directory_cache = std::move(directory_cache_);
     }
 
     std::string GetName() const override {
@@ -198,7 +202,8 @@ Path ConstructExtDataBinaryPath(u32 media_type, u32 high, u32 low) {
 ArchiveFactory_ExtSaveData::ArchiveFactory_ExtSaveData(const std::string& mount_location,
                                                        ExtSaveDataType type_)
     : type(type_),
-      mount_point(GetExtDataContainerPath(mount_location, type_ == ExtSaveDataType::Shared)) {
+      mount_point(GetExtDataContainerPath(mount_location, type_ == ExtSaveDataType::Shared)),
+      directory_cache(std::make_shared<DirectoryCache>()) {
     LOG_DEBUG(Service_FS, "Directory {} set as base for ExtSaveData.", mount_point);
 }
 
@@ -236,7 +241,8 @@ ResultVal<std::unique_ptr<ArchiveBackend>> ArchiveFactory_ExtSaveData::Open(cons
         }
     }
     std::unique_ptr<DelayGenerator> delay_generator = std::make_unique<ExtSaveDataDelayGenerator>();
-    return std::make_unique<ExtSaveDataArchive>(fullpath, std::move(delay_generator));
+    return std::make_unique<ExtSaveDataArchive>(fullpath, std::move(delay_generator),
+                                                directory_cache);
 }
 
 Result ArchiveFactory_ExtSaveData::Format(const Path& path,
@@ -13,6 +13,8 @@
 
 namespace FileSys {
 
+class DirectoryCache;
+
 enum class ExtSaveDataType {
     Normal, ///< Regular non-shared ext save data
     Shared, ///< Shared ext save data
@@ -56,6 +58,9 @@ private:
      */
     std::string mount_point;
 
+    /// Listings of the directories of the archives opened by this factory
+    std::shared_ptr<DirectoryCache> directory_cache;
+
     /// Returns a path with the correct SaveIdHigh value for Shared extdata paths.
     Path GetCorrectedPath(const Path& path);
 };
@@ -10,6 +10,7 @@
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "core/file_sys/archive_sdmc.h"
+#include "core/file_sys/directory_cache.h"
 #include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/path_parser.h"
@@ -104,7 +105,8 @@ ResultVal<std::unique_ptr<FileBackend>> SDMCArchive::OpenFileBase(const Path& pa
     }
 
     std::unique_ptr<DelayGenerator> delay_generator = std::make_unique<SDMCDelayGenerator>();
-    return std::make_unique<DiskFile>(std::move(file), mode, std::move(delay_generator));
+    return std::make_unique<DiskFile>(std::move(file), mode, std::move(delay_generator),
+                                      directory_cache, full_path);
 }
 
 Result SDMCArchive::DeleteFile(const Path& path) const {
@@ -352,6 +354,9 @@ ResultVal<std::unique_ptr<DirectoryBackend>> SDMCArchive::OpenDirectory(const Pa
         break; // Expected 'success' case
     }
 
+    if (directory_cache) {
+        return std::make_unique<DiskDirectory>(directory_cache->GetListing(full_path));
+    }
     return std::make_unique<DiskDirectory>(full_path);
 }
 
@@ -361,7 +366,7 @@ u64 SDMCArchive::GetFreeBytes() const {
 }
 
 ArchiveFactory_SDMC::ArchiveFactory_SDMC(const std::string& sdmc_directory)
-    : sdmc_directory(sdmc_directory) {
+    : sdmc_directory(sdmc_directory), directory_cache(std::make_shared<DirectoryCache>()) {
 
     LOG_DEBUG(Service_FS, "Directory {} set as SDMC.", sdmc_directory);
 }
@@ -383,7 +388,8 @@ bool ArchiveFactory_SDMC::Initialize() {
 ResultVal<std::unique_ptr<ArchiveBackend>> ArchiveFactory_SDMC::Open(const Path& path,
                                                                      u64 program_id) {
     std::unique_ptr<DelayGenerator> delay_generator = std::make_unique<SDMCDelayGenerator>();
-    return std::make_unique<SDMCArchive>(sdmc_directory, std::move(delay_generator));
+    return std::make_unique<SDMCArchive>(sdmc_directory, std::move(delay_generator),
+                                         directory_cache);
 }
 
 Result ArchiveFactory_SDMC::Format(const Path& path, const FileSys::ArchiveFormatInfo& format_info,
@@ -11,12 +11,15 @@
 
 namespace FileSys {
 
+class DirectoryCache;
+
 /// Archive backend for SDMC archive
 class SDMCArchive : public ArchiveBackend {
 public:
     explicit SDMCArchive(const std::string& mount_point_,
-                         std::unique_ptr<DelayGenerator> delay_generator_)
-        : mount_point(mount_point_) {
+                         std::unique_ptr<DelayGenerator> delay_generator_,
+                         std::shared_ptr<DirectoryCache> directory_cache_ = nullptr)
+        : mount_point(mount_point_), directory_cache(std::move(directory_cache_)) {
         delay_generator = std::move(delay_generator_);
     }
 
@@ -39,6 +42,7 @@ public:
 protected:
     ResultVal<std::unique_ptr<FileBackend>> OpenFileBase(const Path& path, const Mode& mode) const;
     std::string mount_point;
+    std::shared_ptr<DirectoryCache> directory_cache;
 };
 
 /// File system interface to the SDMC archive
@@ -63,6 +67,7 @@ public:
 
 private:
     std::string sdmc_directory;
+    std::shared_ptr<DirectoryCache> directory_cache;
 };
 
 class SDMCDelayGenerator;
@@ -0,0 +1,65 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <ctime>
+#include "core/file_sys/directory_cache.h"
+
+namespace FileSys {
+
+namespace {
+
+/// Listings older than this are enumerated again even if the directory wasn't modified
+constexpr auto ListingLifetime = std::chrono::seconds{1};
+
+/// Directories modified this recently can be modified again without their time changing
+constexpr s64 ModificationTimeGranularity = 2;
+
+std::string_view TrimSeparators(std::string_view path) {
+    while (!path.empty() && (path.back() == '/' || path.back() == '\\')) {
+        path.remove_suffix(1);
+    }
+    return path;
+}
+
+} // Anonymous namespace
+
+std::shared_ptr<const FileUtil::FSTEntry> DirectoryCache::GetListing(std::string_view path) {
+    const std::string key{TrimSeparators(path)};
+    const s64 modification_time = FileUtil::GetModificationTime(key);
+    const auto now = std::chrono::steady_clock::now();
+
+    std::scoped_lock lock{mutex};
+    if (const auto it = listings.find(key); it != listings.end()) {
+        const Listing& listing = it->second;
+        if (listing.modification_time == modification_time &&
+            now - listing.scan_time < ListingLifetime) {
+            return listing.entry;
+        }
+        listings.erase(it);
+    }
+
+    auto entry = std::make_shared<FileUtil::FSTEntry>();
+    entry->size = FileUtil::ScanDirectoryTree(key, *entry);
+    entry->isDirectory = true;
+
+    // A modification time of 0 means it is unknown and can't be used to validate the listing
+    if (modification_time != 0 &&
+        std::time(nullptr) - modification_time >= ModificationTimeGranularity) {
+        listings.insert_or_assign(key, Listing{entry, modification_time, now});
+    }
+    return entry;
+}
+
+void DirectoryCache::InvalidateParent(std::string_view path) {
+    path = TrimSeparators(path);
+    const auto separator = path.find_last_of("/\\");
+    if (separator == std::string_view::npos) {
+        return;
+    }
+
+    std::scoped_lock lock{mutex};
+    listings.erase(std::string{TrimSeparators(path.substr(0, separator))});
+}
+
+} // namespace FileSys
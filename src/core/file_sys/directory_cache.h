@@ -0,0 +1,47 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace FileSys {
+
+/**
+ * Cache of host directory listings shared by the archives of an archive factory, so that titles
+ * polling a directory don't enumerate it on the host every time.
+ *
+ * Creating, deleting or renaming entries changes the modification time of the directory, which
+ * is checked whenever a listing is used. Listings of directories modified too recently for their
+ * modification time to be trusted are not kept. Files written through the archives drop the
+ * listing of their directory, and listings expire after a short while to pick up file sizes
+ * changed on the host.
+ */
+class DirectoryCache {
+public:
+    /// Returns the entries of the directory at path, enumerating it when needed
+    std::shared_ptr<const FileUtil::FSTEntry> GetListing(std::string_view path);
+
+    /// Drops the listing of the directory containing the file at path
+    void InvalidateParent(std::string_view path);
+
+private:
+    struct Listing {
+        std::shared_ptr<const FileUtil::FSTEntry> entry;
+        s64 modification_time;
+        std::chrono::steady_clock::time_point scan_time;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Listing> listings;
+};
+
+} // namespace FileSys
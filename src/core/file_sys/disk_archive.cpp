@@ -3,21 +3,40 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include "common/common_types.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "core/file_sys/directory_cache.h"
 #include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
 
 namespace FileSys {
 
+/// Largest amount of guest writes coalesced before they are written to the host file
+constexpr std::size_t WriteBufferSize = 64 * 1024;
+
+/// Coalesced writes older than this are written out on the next write to the file
+constexpr auto WriteBufferTimeout = std::chrono::milliseconds{500};
+
+DiskFile::~DiskFile() {
+    if (file->IsOpen()) {
+        FlushWriteBuffer();
+    }
+}
+
 ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length,
                                       u8* buffer) const {
     if (!mode.read_flag)
         return ResultInvalidOpenFlags;
 
+    if (!write_buffer.empty() && offset < write_buffer_offset + write_buffer.size() &&
+        offset + length > write_buffer_offset) {
+        FlushWriteBuffer();
+    }
+
     file->Seek(offset, SEEK_SET);
     return file->ReadBytes(buffer, length);
 }
@@ -27,37 +46,97 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
     if (!mode.write_flag)
         return ResultInvalidOpenFlags;
 
-    file->Seek(offset, SEEK_SET);
-    std::size_t written = file->WriteBytes(buffer, length);
-    if (flush)
+    if (!write_buffer.empty()) {
+        // Only writes that continue or overlap the pending ones can be merged with them
+        const bool contiguous = offset >= write_buffer_offset &&
+                                offset <= write_buffer_offset + write_buffer.size() &&
+                                offset + length - write_buffer_offset <= WriteBufferSize;
+        const bool expired =
+            std::chrono::steady_clock::now() - write_buffer_time > WriteBufferTimeout;
+        if (!contiguous || expired) {
+            FlushWriteBuffer();
+        }
+    }
+
+    std::size_t written;
+    if (length > WriteBufferSize) {
+        file->Seek(offset, SEEK_SET);
+        written = file->WriteBytes(buffer, length);
+        InvalidateDirectory();
+    } else {
+        if (write_buffer.empty()) {
+            write_buffer.reserve(WriteBufferSize);
+            write_buffer_offset = offset;
+            write_buffer_time = std::chrono::steady_clock::now();
+        }
+        const std::size_t start = offset - write_buffer_offset;
+        write_buffer.resize(std::max(write_buffer.size(), start + length));
+        std::memcpy(write_buffer.data() + start, buffer, length);
+        written = length;
+    }
+
+    if (flush) {
+        FlushWriteBuffer();
         file->Flush();
+    }
     return written;
 }
 
 u64 DiskFile::GetSize() const {
-    return file->GetSize();
+    const u64 size = file->GetSize();
+    if (write_buffer.empty()) {
+        return size;
+    }
+    return std::max<u64>(size, write_buffer_offset + write_buffer.size());
 }
 
 bool DiskFile::SetSize(const u64 size) const {
+    FlushWriteBuffer();
     file->Resize(size);
     file->Flush();
+    InvalidateDirectory();
     return true;
 }
 
 bool DiskFile::Close() const {
+    FlushWriteBuffer();
     return file->Close();
 }
 
+void DiskFile::FlushWriteBuffer() const {
+    if (write_buffer.empty()) {
+        return;
+    }
+
+    file->Seek(write_buffer_offset, SEEK_SET);
+    if (file->WriteBytes(write_buffer.data(), write_buffer.size()) != write_buffer.size()) {
+        LOG_ERROR(Service_FS, "Could not write {} bytes to {}", write_buffer.size(), path);
+    }
+    write_buffer.clear();
+    InvalidateDirectory();
+}
+
+void DiskFile::InvalidateDirectory() const {
+    if (directory_cache) {
+        directory_cache->InvalidateParent(path);
+    }
+}
+
 DiskDirectory::DiskDirectory(const std::string& path) {
-    directory.size = FileUtil::ScanDirectoryTree(path, directory);
-    directory.isDirectory = true;
-    children_iterator = directory.children.begin();
+    auto entry = std::make_shared<FileUtil::FSTEntry>();
+    entry->size = FileUtil::ScanDirectoryTree(path, *entry);
+    entry->isDirectory = true;
+    directory = std::move(entry);
+    children_iterator = directory->children.begin();
 }
 
+DiskDirectory::DiskDirectory(std::shared_ptr<const FileUtil::FSTEntry> directory_)
+    : directory(std::move(directory_)), children_iterator(directory->children.begin()) {}
+
 u32 DiskDirectory::Read(const u32 count, Entry* entries) {
     u32 entries_read = 0;
 
-    while (entries_read < count && children_iterator != directory.children.cend()) {
+    while (entries_read < count && children_iterator != directory->children.cend()) {
         const FileUtil::FSTEntry& file = *children_iterator;
         const std::string& filename = file.virtualName;
         Entry& entry = entries[entries_read];
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <memory>
 #include <string>
@@ -17,14 +18,19 @@
 
 namespace FileSys {
 
+class DirectoryCache;
+
 class DiskFile : public FileBackend {
 public:
     DiskFile(FileUtil::IOFile&& file_, const Mode& mode_,
-             std::unique_ptr<DelayGenerator> delay_generator_)
-        : file(new FileUtil::IOFile(std::move(file_))) {
+             std::unique_ptr<DelayGenerator> delay_generator_,
+             std::shared_ptr<DirectoryCache> directory_cache_ = nullptr, std::string path_ = {})
+        : file(new FileUtil::IOFile(std::move(file_))),
+          directory_cache(std::move(directory_cache_)), path(std::move(path_)) {
         delay_generator = std::move(delay_generator_);
         mode.hex = mode_.hex;
     }
+    ~DiskFile() override;
 
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
@@ -34,17 +40,34 @@ public:
     bool Close() const override;
 
     void Flush() const override {
+        FlushWriteBuffer();
         file->Flush();
     }
 
 protected:
+    /// Writes the coalesced guest writes to the host file
+    void FlushWriteBuffer() const;
+
+    /// Drops the cached listing of the directory of the file after its size may have changed
+    void InvalidateDirectory() const;
+
     Mode mode;
     std::unique_ptr<FileUtil::IOFile> file;
+    std::shared_ptr<DirectoryCache> directory_cache;
+    std::string path;
+
+    // Titles often write their saves in small pieces, so writes are coalesced while they are
+    // contiguous. They reach the host file on guest flushes, on Close, once they get too large or
+    // old, or before the range is read back.
+    mutable std::vector<u8> write_buffer;
+    mutable u64 write_buffer_offset{};
+    mutable std::chrono::steady_clock::time_point write_buffer_time;
 };
 
 class DiskDirectory : public DirectoryBackend {
 public:
     explicit DiskDirectory(const std::string& path);
+    explicit DiskDirectory(std::shared_ptr<const FileUtil::FSTEntry> directory);
 
     ~DiskDirectory() override {
         Close();
@@ -57,11 +80,11 @@ public:
     }
 
 protected:
-    FileUtil::FSTEntry directory{};
+    std::shared_ptr<const FileUtil::FSTEntry> directory;
 
     // We need to remember the last entry we returned, so a subsequent call to Read will continue
     // from the next one.  This iterator will always point to the next unread entry.
-    std::vector<FileUtil::FSTEntry>::iterator children_iterator;
+    std::vector<FileUtil::FSTEntry>::const_iterator children_iterator;
 };
 
 } // namespace FileSys
@@ -4,11 +4,15 @@
 
 #include <algorithm>
 #include <cstring>
+#include <span>
+#include <type_traits>
+#include <fmt/format.h>
 #include "common/alignment.h"
 
 #include "common/assert.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
@@ -18,9 +22,12 @@ namespace FileSys {
 
 struct FileRelocationInfo {
     int type;                      // 0 - none, 1 - replaced / created, 2 - patched, 3 - removed
-    u64 original_offset;           // Type 0. Offset is absolute
+    u64 original_offset;           // Type 0 and 2. Offset is absolute
+    u64 original_size;             // Type 2
     std::string replace_file_path; // Type 1
-    std::vector<u8> patched_file;  // Type 2
+    std::string patch_file_path;   // Type 2
+    std::vector<u8> patched_file;  // Type 2, applied on the first read
+    bool patch_applied;            // Type 2
     u64 size;                      // Relocated file size
 };
 struct LayeredFS::File {
@@ -52,6 +59,68 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+constexpr u32 IndexMagic = 0x4953464C; // "LFSI"
+constexpr u32 IndexVersion = 1;
+
+template <typename T>
+static void WriteIndexValue(std::vector<u8>& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* bytes = reinterpret_cast<const u8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+static void WriteIndexString(std::vector<u8>& out, const std::string& str) {
+    WriteIndexValue(out, static_cast<u32>(str.size()));
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+namespace {
+
+// Bounds checked reader of cached indices, reads past the end mark the whole index as invalid
+class IndexReader {
+public:
+    explicit IndexReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        if (failed || offset + sizeof(T) > data.size()) {
+            failed = true;
+            return value;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    std::string ReadString() {
+        const u32 size = Read<u32>();
+        if (failed || offset + size > data.size()) {
+            failed = true;
+            return {};
+        }
+        std::string str(reinterpret_cast<const char*>(data.data() + offset), size);
+        offset += size;
+        return str;
+    }
+
+    void Fail() {
+        failed = true;
+    }
+
+    bool Failed() const {
+        return failed;
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t offset{};
+    bool failed{};
+};
+
+} // Anonymous namespace
+
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
                      std::string patch_ext_path_, bool load_relocations_)
     : romfs(std::move(romfs_)), patch_path(std::move(patch_path_)),
@@ -64,14 +133,24 @@ void LayeredFS::Load() {
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
+    // Read the whole metadata at once rather than doing a read for every entry
+    const std::size_t metadata_end = std::max<std::size_t>(
+        header.directory_metadata_table.offset + header.directory_metadata_table.length,
+        header.file_metadata_table.offset + header.file_metadata_table.length);
+    romfs_metadata.resize(std::min(metadata_end, romfs->GetSize()));
+    romfs->ReadFile(0, romfs_metadata.size(), romfs_metadata.data());
+
     // TODO: is root always the first directory in table?
     root.parent = &root;
-    LoadDirectory(root, 0);
-
-    if (load_relocations) {
+    if (!load_relocations) {
+        LoadDirectory(root, 0);
+    } else if (const u64 key = ComputeIndexKey(); !LoadIndex(key)) {
+        LoadDirectory(root, 0);
         LoadRelocations();
         LoadExtRelocations();
+        SaveIndex(key);
     }
+    romfs_metadata = {};
 
     RebuildMetadata();
 }
@@ -80,8 +159,7 @@ LayeredFS::~LayeredFS() = default;
 
 u32 LayeredFS::LoadDirectory(Directory& current, u32 offset) {
     DirectoryMetadata metadata;
-    romfs->ReadFile(header.directory_metadata_table.offset + offset, sizeof(metadata),
-                    reinterpret_cast<u8*>(&metadata));
+    ReadMetadata(header.directory_metadata_table.offset + offset, sizeof(metadata), &metadata);
 
     current.name = ReadName(header.directory_metadata_table.offset + offset + sizeof(metadata),
                             metadata.name_length);
@@ -107,8 +185,7 @@ u32 LayeredFS::LoadDirectory(Directory& current, u32 offset) {
 
 u32 LayeredFS::LoadFile(Directory& parent, u32 offset) {
     FileMetadata metadata;
-    romfs->ReadFile(header.file_metadata_table.offset + offset, sizeof(metadata),
-                    reinterpret_cast<u8*>(&metadata));
+    ReadMetadata(header.file_metadata_table.offset + offset, sizeof(metadata), &metadata);
 
     auto file = std::make_unique<File>();
     file->name = ReadName(header.file_metadata_table.offset + offset + sizeof(metadata),
@@ -124,9 +201,17 @@ u32 LayeredFS::LoadFile(Directory& parent, u32 offset) {
     return metadata.next_sibling_offset;
 }
 
+void LayeredFS::ReadMetadata(std::size_t offset, std::size_t length, void* buffer) {
+    if (offset + length <= romfs_metadata.size()) {
+        std::memcpy(buffer, romfs_metadata.data() + offset, length);
+    } else {
+        romfs->ReadFile(offset, length, static_cast<u8*>(buffer));
+    }
+}
+
 std::string LayeredFS::ReadName(u32 offset, u32 name_length) {
     std::vector<u16_le> buffer(name_length / sizeof(u16_le));
-    romfs->ReadFile(offset, name_length, reinterpret_cast<u8*>(buffer.data()));
+    ReadMetadata(offset, name_length, buffer.data());
 
     std::u16string name(buffer.size(), 0);
     std::transform(buffer.begin(), buffer.end(), name.begin(), [](u16_le character) {
@@ -232,36 +317,223 @@ void LayeredFS::LoadExtRelocations() {
                 continue;
             }
 
-            const auto size = patch_file.GetSize();
-            std::vector<u8> patch(size);
-            if (patch_file.ReadBytes(patch.data(), size) != size) {
+            // Patches are applied when the file is first read, only the size is needed here.
+            // IPS patches never resize the file, BPS ones store the new size in their header.
+            constexpr std::size_t PatchHeaderSize = 0x40;
+            std::vector<u8> patch_header(std::min<u64>(patch_file.GetSize(), PatchHeaderSize));
+            if (patch_file.ReadBytes(patch_header.data(), patch_header.size()) !=
+                patch_header.size()) {
                 LOG_ERROR(Service_FS, "LayeredFS Could not read file {}", entry.physicalName);
                 continue;
             }
 
             auto& file = *file_path_map[file_path];
-            std::vector<u8> buffer(file.relocation.size); // Original size
-            romfs->ReadFile(file.relocation.original_offset, buffer.size(), buffer.data());
-
-            bool ret = false;
-            if (extension == ".ips") {
-                ret = Patch::ApplyIpsPatch(patch, buffer);
-            } else {
-                ret = Patch::ApplyBpsPatch(patch, buffer);
+            file.relocation.type = 2;
+            file.relocation.original_size = file.relocation.size;
+            file.relocation.patch_file_path = entry.physicalName;
+            if (extension != ".ips") {
+                file.relocation.size =
+                    Patch::GetBpsPatchedSize(patch_header, file.relocation.original_size);
             }
+            LOG_INFO(Service_FS, "LayeredFS patch file in use for {}", file_path);
+        } else {
+            LOG_WARNING(Service_FS, "LayeredFS unknown ext file {}", path);
+        }
+    }
+}
 
-            if (ret) {
-                LOG_INFO(Service_FS, "LayeredFS patched file {}", file_path);
+void LayeredFS::MaterializePatch(File& file) {
+    std::scoped_lock lock{patch_mutex};
+    auto& relocation = file.relocation;
+    if (relocation.patch_applied) {
+        return;
+    }
+    relocation.patch_applied = true;
 
-                file.relocation.type = 2;
-                file.relocation.size = buffer.size();
-                file.relocation.patched_file = std::move(buffer);
-            } else {
-                LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file_path);
+    std::vector<u8> buffer(relocation.original_size);
+    romfs->ReadFile(relocation.original_offset, buffer.size(), buffer.data());
+
+    const auto apply_patch = [&relocation, &buffer] {
+        FileUtil::IOFile patch_file(relocation.patch_file_path, "rb");
+        if (!patch_file) {
+            LOG_ERROR(Service_FS, "LayeredFS Could not open file {}", relocation.patch_file_path);
+            return false;
+        }
+
+        const auto size = patch_file.GetSize();
+        std::vector<u8> patch(size);
+        if (patch_file.ReadBytes(patch.data(), size) != size) {
+            LOG_ERROR(Service_FS, "LayeredFS Could not read file {}", relocation.patch_file_path);
+            return false;
+        }
+
+        if (relocation.patch_file_path.ends_with(".ips")) {
+            return Patch::ApplyIpsPatch(patch, buffer);
+        }
+        return Patch::ApplyBpsPatch(patch, buffer);
+    };
+
+    if (apply_patch()) {
+        LOG_INFO(Service_FS, "LayeredFS patched file {}", file.path);
+    } else {
+        // The metadata already has the patched size, so serve the original data padded to it
+        LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file.path);
+        buffer.assign(relocation.original_size, 0);
+        romfs->ReadFile(relocation.original_offset, buffer.size(), buffer.data());
+    }
+
+    buffer.resize(relocation.size);
+    relocation.patched_file = std::move(buffer);
+}
+
+std::string LayeredFS::GetIndexPath() const {
+    // Base and update titles share their mod folder, tell their indices apart by their metadata
+    const u64 hash =
+        Common::HashCombine(Common::ComputeHash64(patch_path.data(), patch_path.size()),
+                            Common::ComputeHash64(romfs_metadata.data(), romfs_metadata.size()));
+    return fmt::format("{}layered_fs/{:016X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), hash);
+}
+
+u64 LayeredFS::ComputeIndexKey() const {
+    u64 key = romfs->GetSize();
+    const auto hash_entries = [&key](const auto& self, const FileUtil::FSTEntry& entry) -> void {
+        for (const auto& child : entry.children) {
+            const auto& name = child.physicalName;
+            key = Common::HashCombine(key, Common::ComputeHash64(name.data(), name.size()));
+            key = Common::HashCombine(key, child.size);
+            key = Common::HashCombine(key,
+                                      static_cast<u64>(FileUtil::GetModificationTime(name)));
+            self(self, child);
+        }
+    };
+
+    for (std::string path : {patch_path, patch_ext_path}) {
+        if (path.empty() || !FileUtil::Exists(path)) {
+            key = Common::HashCombine(key, 0);
+            continue;
+        }
+        if (path.back() == '/' || path.back() == '\\') {
+            path.pop_back();
+        }
+        FileUtil::FSTEntry tree;
+        key = Common::HashCombine(key, FileUtil::ScanDirectoryTree(path, tree, 256));
+        hash_entries(hash_entries, tree);
+    }
+    return key;
+}
+
+bool LayeredFS::LoadIndex(u64 key) {
+    const auto path = GetIndexPath();
+    FileUtil::IOFile index_file(path, "rb");
+    if (!index_file) {
+        return false;
+    }
+
+    std::vector<u8> data(index_file.GetSize());
+    if (index_file.ReadBytes(data.data(), data.size()) != data.size()) {
+        return false;
+    }
+
+    IndexReader reader{data};
+    if (reader.Read<u32>() != IndexMagic || reader.Read<u32>() != IndexVersion ||
+        reader.Read<u64>() != key) {
+        LOG_INFO(Service_FS, "LayeredFS index {} is stale, rebuilding", path);
+        return false;
+    }
+
+    const auto read_directory = [this, &reader](const auto& self, Directory& current) -> void {
+        current.name = reader.ReadString();
+        current.path = current.parent->path + current.name + DIR_SEP;
+        directory_path_map.emplace(current.path, &current);
+
+        const u32 num_files = reader.Read<u32>();
+        for (u32 i = 0; i < num_files && !reader.Failed(); i++) {
+            auto file = std::make_unique<File>();
+            file->name = reader.ReadString();
+            file->path = current.path + file->name;
+            file->parent = &current;
+
+            auto& relocation = file->relocation;
+            relocation.type = reader.Read<u8>();
+            relocation.original_offset = reader.Read<u64>();
+            relocation.original_size = reader.Read<u64>();
+            relocation.size = reader.Read<u64>();
+            relocation.replace_file_path = reader.ReadString();
+            relocation.patch_file_path = reader.ReadString();
+            if (relocation.type > 3) {
+                reader.Fail();
             }
-        } else {
-            LOG_WARNING(Service_FS, "LayeredFS unknown ext file {}", path);
+
+            if (relocation.type != 3) {
+                file_path_map.emplace(file->path, file.get());
+            }
+            current.files.emplace_back(std::move(file));
+        }
+
+        const u32 num_directories = reader.Read<u32>();
+        for (u32 i = 0; i < num_directories && !reader.Failed(); i++) {
+            auto child = std::make_unique<Directory>();
+            auto& directory = *child;
+            directory.parent = &current;
+            current.directories.emplace_back(std::move(child));
+            self(self, directory);
+        }
+    };
+    read_directory(read_directory, root);
+
+    if (reader.Failed()) {
+        LOG_ERROR(Service_FS, "LayeredFS index {} is corrupted, rebuilding", path);
+        root.name.clear();
+        root.path.clear();
+        root.files.clear();
+        root.directories.clear();
+        file_path_map.clear();
+        directory_path_map.clear();
+        return false;
+    }
+
+    LOG_INFO(Service_FS, "LayeredFS loaded cached index {}", path);
+    return true;
+}
+
+void LayeredFS::SaveIndex(u64 key) const {
+    std::vector<u8> data;
+    WriteIndexValue(data, IndexMagic);
+    WriteIndexValue(data, IndexVersion);
+    WriteIndexValue(data, key);
+
+    const auto write_directory = [&data](const auto& self, const Directory& current) -> void {
+        WriteIndexString(data, current.name);
+
+        WriteIndexValue(data, static_cast<u32>(current.files.size()));
+        for (const auto& file : current.files) {
+            const auto& relocation = file->relocation;
+            WriteIndexString(data, file->name);
+            WriteIndexValue(data, static_cast<u8>(relocation.type));
+            WriteIndexValue(data, relocation.original_offset);
+            WriteIndexValue(data, relocation.original_size);
+            WriteIndexValue(data, relocation.size);
+            WriteIndexString(data, relocation.replace_file_path);
+            WriteIndexString(data, relocation.patch_file_path);
         }
+
+        WriteIndexValue(data, static_cast<u32>(current.directories.size()));
+        for (const auto& directory : current.directories) {
+            self(self, *directory);
+        }
+    };
+    write_directory(write_directory, root);
+
+    const auto path = GetIndexPath();
+    if (!FileUtil::CreateFullPath(path)) {
+        LOG_WARNING(Service_FS, "LayeredFS could not create path {}", path);
+        return;
+    }
+
+    FileUtil::IOFile index_file(path, "wb");
+    if (!index_file || index_file.WriteBytes(data.data(), data.size()) != data.size()) {
+        LOG_WARNING(Service_FS, "LayeredFS could not write index {}", path);
     }
 }
 
@@ -527,6 +799,7 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
                           current->second->path);
             }
         } else if (relocation.type == 2) { // patch
+            MaterializePatch(*current->second);
             std::memcpy(buffer + read_size, relocation.patched_file.data() + relative_offset,
                         to_read);
         } else {
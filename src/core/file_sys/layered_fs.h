@@ -6,6 +6,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -67,6 +68,9 @@ private:
         Directory* parent;
     };
 
+    // Reads from the metadata of the original RomFS, which is read in a single pass on load
+    void ReadMetadata(std::size_t offset, std::size_t length, void* buffer);
+
     std::string ReadName(u32 offset, u32 name_length);
 
     // Loads the current directory, then its children.
@@ -102,6 +106,20 @@ private:
 
     void RebuildMetadata();
 
+    // Applies the patch of a patched file, done on the first read of the file
+    void MaterializePatch(File& file);
+
+    // Returns the path of the cached index of the merged layout
+    std::string GetIndexPath() const;
+
+    // Returns a hash of the names, sizes and modification times of every patch file
+    u64 ComputeIndexKey() const;
+
+    // Loads the merged layout from the cached index, returns false if it is missing or stale
+    bool LoadIndex(u64 key);
+
+    void SaveIndex(u64 key) const;
+
     void Load();
 
     std::shared_ptr<RomFSReader> romfs;
@@ -110,6 +128,7 @@ private:
     bool load_relocations;
 
     RomFSHeader header;
+    std::vector<u8> romfs_metadata; // Original metadata, only kept while loading
     Directory root;
     std::unordered_map<std::string, File*> file_path_map;
     std::unordered_map<std::string, Directory*> directory_path_map;
@@ -131,6 +150,8 @@ private:
     u64 current_file_offset{};           // current file metadata offset
     std::vector<u8> file_metadata_table; // rebuilt file metadata table
     u64 current_data_offset{};           // current assigned data offset
+
+    std::mutex patch_mutex; // Guards materializing patched files
 };
 
 } // namespace FileSys
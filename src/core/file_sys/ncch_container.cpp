@@ -2,19 +2,24 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <span>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
+#include <fmt/format.h>
 #include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/ncch_container.h"
 #include "core/file_sys/patch.h"
 #include "core/file_sys/seed_db.h"
+#include "core/hw/aes/ctr.h"
 #include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
 
@@ -110,6 +115,60 @@ static bool LZSS_Decompress(std::span<const u8> compressed, std::span<u8> decomp
     return true;
 }
 
+/**
+ * Get the path decompressed .code sections are cached at. The cache is keyed by the ExeFS hash of
+ * the compressed section, so a different version of the program gets a separate entry.
+ * @param program_id ID of the program the section belongs to
+ * @param section_hash ExeFS hash of the compressed section
+ * @return Path of the cache file
+ */
+static std::string GetCodeCachePath(u64 program_id, std::span<const u8> section_hash) {
+    return fmt::format("{}code/{:016X}_{:02X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), program_id,
+                       fmt::join(section_hash.first(8), ""));
+}
+
+/**
+ * Read a decompressed .code section from the cache. Cache files start with a hash of the code,
+ * so a corrupted one is not used.
+ * @param path Path of the cache file
+ * @param code Buffer receiving the decompressed section
+ * @return True if the cache entry exists and is intact
+ */
+static bool ReadCodeCache(const std::string& path, std::vector<u8>& code) {
+    FileUtil::IOFile file(path, "rb");
+    u64 hash{};
+    if (!file || file.GetSize() < sizeof(hash) ||
+        file.ReadBytes(&hash, sizeof(hash)) != sizeof(hash)) {
+        return false;
+    }
+    code.resize(file.GetSize() - sizeof(hash));
+    return file.ReadBytes(code.data(), code.size()) == code.size() &&
+           Common::ComputeHash64(code.data(), code.size()) == hash;
+}
+
+/**
+ * Write a decompressed .code section to the cache, replacing the entry at once so an interrupted
+ * write can't leave a truncated one behind
+ * @param path Path of the cache file
+ * @param code Decompressed section
+ */
+static void WriteCodeCache(const std::string& path, std::span<const u8> code) {
+    const std::string temp_path = path + ".tmp";
+    {
+        FileUtil::CreateFullPath(path);
+        FileUtil::IOFile file(temp_path, "wb");
+        const u64 hash = Common::ComputeHash64(code.data(), code.size());
+        if (!file || file.WriteBytes(&hash, sizeof(hash)) != sizeof(hash) ||
+            file.WriteBytes(code.data(), code.size()) != code.size()) {
+            LOG_WARNING(Service_FS, "Could not write decompressed code to the cache");
+            return;
+        }
+    }
+    FileUtil::Delete(path);
+    FileUtil::Rename(temp_path, path);
+}
+
 NCCHContainer::NCCHContainer(const std::string& filepath, u32 ncch_offset, u32 partition)
     : ncch_offset(ncch_offset), partition(partition), filepath(filepath) {
     file = FileUtil::IOFile(filepath, "rb");
@@ -532,11 +591,22 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 key = secondary_key;
             }
 
-            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key.data(), key.size(),
-                                                              exefs_ctr.data());
-            dec.Seek(section.offset + sizeof(ExeFs_Header));
+            const u64 crypto_offset = section.offset + sizeof(ExeFs_Header);
 
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
+                // Hashes are stored in reverse order of the sections. Sections without one can't
+                // be told apart from other versions of the program, so they are not cached.
+                const std::span<const u8> section_hash{
+                    exefs_header.hashes[kMaxSections - 1 - section_number]};
+                const bool cacheable = std::any_of(section_hash.begin(), section_hash.end(),
+                                                   [](u8 byte) { return byte != 0; });
+                const std::string cache_path =
+                    cacheable ? GetCodeCachePath(ncch_header.program_id, section_hash) : "";
+                if (cacheable && ReadCodeCache(cache_path, buffer)) {
+                    LOG_DEBUG(Service_FS, "Loaded decompressed .code from {}", cache_path);
+                    return Loader::ResultStatus::Success;
+                }
+
                 // Section is compressed, read compressed .code section...
                 std::vector<u8> temp_buffer(section.size);
                 if (exefs_file.ReadBytes(temp_buffer.data(), temp_buffer.size()) !=
@@ -544,7 +614,7 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                     return Loader::ResultStatus::Error;
 
                 if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                    HW::AES::TransformCTR(temp_buffer, key, exefs_ctr, crypto_offset);
                 }
 
                 // Decompress .code section...
@@ -552,13 +622,16 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 if (!LZSS_Decompress(temp_buffer, buffer)) {
                     return Loader::ResultStatus::ErrorInvalidFormat;
                 }
+                if (cacheable) {
+                    WriteCodeCache(cache_path, buffer);
+                }
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
                 if (exefs_file.ReadBytes(buffer.data(), section.size) != section.size)
                     return Loader::ResultStatus::Error;
                 if (is_encrypted) {
-                    dec.ProcessData(buffer.data(), buffer.data(), section.size);
+                    HW::AES::TransformCTR(buffer, key, exefs_ctr, crypto_offset);
                 }
             }
 
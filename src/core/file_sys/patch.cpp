@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <optional>
@@ -280,4 +281,15 @@ bool ApplyBpsPatch(const std::vector<u8>& patch, std::vector<u8>& buffer) {
     return applier.Apply();
 }
 
+std::size_t GetBpsPatchedSize(const std::vector<u8>& patch, std::size_t source_size) {
+    Bps::Stream patch_stream{patch.data(), patch.size()};
+    patch_stream.Seek(Bps::MagicSize);
+
+    [[maybe_unused]] const Bps::Number patch_source_size = patch_stream.ReadNumber();
+    const Bps::Number target_size = patch_stream.ReadNumber();
+
+    // ApplyBpsPatch only ever grows the buffer
+    return std::max<std::size_t>(source_size, target_size);
+}
+
 } // namespace FileSys::Patch
@@ -14,4 +14,8 @@ bool ApplyIpsPatch(const std::vector<u8>& patch, std::vector<u8>& buffer);
 
 bool ApplyBpsPatch(const std::vector<u8>& patch, std::vector<u8>& buffer);
 
+/// Returns the size of a file of source_size bytes after applying a BPS patch to it. Only the
+/// header of the patch is needed.
+std::size_t GetBpsPatchedSize(const std::vector<u8>& patch, std::size_t source_size);
+
 } // namespace FileSys::Patch
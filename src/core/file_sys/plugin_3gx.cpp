@@ -19,6 +19,8 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <mutex>
+#include <unordered_map>
 #include "core/file_sys/file_backend.h"
 #include "core/file_sys/plugin_3gx.h"
 #include "core/file_sys/plugin_3gx_bootloader.h"
@@ -63,21 +65,77 @@ static bool ReadSection(std::vector<u8>& data_out, FileUtil::IOFile& file, std::
     return true;
 }
 
+namespace {
+
+struct CachedPlugin {
+    u64 size;
+    s64 modification_time;
+    FileSys::Plugin3GXLoader loader;
+};
+
+// Plugins parsed by earlier boots, reused while their file keeps its size and modification time
+std::mutex plugin_cache_mutex;
+std::unordered_map<std::string, CachedPlugin> plugin_cache;
+
+} // Anonymous namespace
+
 Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
     Service::PLGLDR::PLG_LDR::PluginLoaderContext& plg_context, Kernel::Process& process,
     Kernel::KernelSystem& kernel, Service::PLGLDR::PLG_LDR& plg_ldr) {
-    FileUtil::IOFile file(plg_context.plugin_path, "rb");
-    if (!file.IsOpen()) {
-        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Not found: {}",
+    const Loader::ResultStatus result = LoadCached(plg_context.plugin_path);
+    if (result != Loader::ResultStatus::Success) {
+        return result;
+    }
+
+    LOG_INFO(Service_PLGLDR, "Trying to load plugin - Title: {} - Author: {}", title, author);
+
+    if (!compatible_TID.empty() &&
+        std::find(compatible_TID.begin(), compatible_TID.end(),
+                  static_cast<u32>(process.codeset->program_id)) == compatible_TID.end()) {
+        LOG_ERROR(Service_PLGLDR,
+                  "Failed to load 3GX plugin. Not compatible with loaded process: {}",
                   plg_context.plugin_path);
         return Loader::ResultStatus::Error;
     }
 
+    return Map(plg_context, process, kernel, plg_ldr);
+}
+
+Loader::ResultStatus FileSys::Plugin3GXLoader::LoadCached(const std::string& plugin_path) {
+    const u64 size = FileUtil::GetSize(plugin_path);
+    const s64 modification_time = FileUtil::GetModificationTime(plugin_path);
+    {
+        std::scoped_lock lock{plugin_cache_mutex};
+        const auto it = plugin_cache.find(plugin_path);
+        if (it != plugin_cache.end() && it->second.size == size &&
+            it->second.modification_time == modification_time) {
+            *this = it->second.loader;
+            return Loader::ResultStatus::Success;
+        }
+    }
+
+    const Loader::ResultStatus result = Parse(plugin_path);
+    if (result == Loader::ResultStatus::Success) {
+        std::scoped_lock lock{plugin_cache_mutex};
+        plugin_cache.insert_or_assign(plugin_path, CachedPlugin{size, modification_time, *this});
+    }
+    return result;
+}
+
+Loader::ResultStatus FileSys::Plugin3GXLoader::Parse(const std::string& plugin_path) {
+    // The loader may hold an earlier plugin that failed to load
+    *this = {};
+
+    FileUtil::IOFile file(plugin_path, "rb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Not found: {}", plugin_path);
+        return Loader::ResultStatus::Error;
+    }
+
     // Load CIA Header
     std::vector<u8> header_data(sizeof(_3gx_Header));
     if (file.ReadBytes(header_data.data(), sizeof(_3gx_Header)) != sizeof(_3gx_Header)) {
-        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}",
-                  plg_context.plugin_path);
+        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}", plugin_path);
         return Loader::ResultStatus::Error;
     }
 
@@ -86,13 +144,13 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
     // Check magic value
     if (std::memcmp(&header.magic, _3GX_magic, 8) != 0) {
         LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Outdated or invalid 3GX plugin: {}",
-                  plg_context.plugin_path);
+                  plugin_path);
         return Loader::ResultStatus::Error;
     }
 
     if (header.infos.flags.compatibility == static_cast<u32>(_3gx_Infos::Compatibility::CONSOLE)) {
         LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Not compatible with Citra: {}",
-                  plg_context.plugin_path);
+                  plugin_path);
         return Loader::ResultStatus::Error;
     }
 
@@ -103,8 +161,6 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
         ReadTextInfo(file, header.infos.description_msg_offset, header.infos.description_len);
     summary = ReadTextInfo(file, header.infos.summary_msg_offset, header.infos.summary_len);
 
-    LOG_INFO(Service_PLGLDR, "Trying to load plugin - Title: {} - Author: {}", title, author);
-
     // Load compatible TIDs
     {
         std::vector<u8> raw_TID_data;
@@ -112,22 +168,13 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
                          header.targets.count * sizeof(u32))) {
             return Loader::ResultStatus::Error;
         }
-        compatible_TID.reserve(header.targets.count); // compatible_TID should be empty right now
+        compatible_TID.reserve(header.targets.count);
         for (u32 i = 0; i < u32(header.targets.count); i++) {
             compatible_TID.push_back(
                 u32_le(*reinterpret_cast<u32*>(raw_TID_data.data() + i * sizeof(u32))));
         }
     }
 
-    if (!compatible_TID.empty() &&
-        std::find(compatible_TID.begin(), compatible_TID.end(),
-                  static_cast<u32>(process.codeset->program_id)) == compatible_TID.end()) {
-        LOG_ERROR(Service_PLGLDR,
-                  "Failed to load 3GX plugin. Not compatible with loaded process: {}",
-                  plg_context.plugin_path);
-        return Loader::ResultStatus::Error;
-    }
-
     // Load exe load func and args
     if (header.infos.flags.embedded_exe_func.Value() &&
         header.executable.exe_load_func_offset != 0) {
@@ -153,12 +200,11 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
                      header.executable.rodata_size) ||
         !ReadSection(data_section, file, header.executable.data_offset,
                      header.executable.data_size)) {
-        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}",
-                  plg_context.plugin_path);
+        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}", plugin_path);
         return Loader::ResultStatus::Error;
     }
 
-    return Map(plg_context, process, kernel, plg_ldr);
+    return Loader::ResultStatus::Success;
 }
 
 Loader::ResultStatus FileSys::Plugin3GXLoader::Map(
@@ -68,6 +68,13 @@ public:
     static constexpr u32 _3GX_fb_size = 0xA9000;
 
 private:
+    /// Fills the loader from the plugin file, reusing the result of an earlier boot when the file
+    /// is unchanged
+    Loader::ResultStatus LoadCached(const std::string& plugin_path);
+
+    /// Parses and validates the plugin file
+    Loader::ResultStatus Parse(const std::string& plugin_path);
+
     Loader::ResultStatus Map(Service::PLGLDR::PLG_LDR::PluginLoaderContext& plg_context,
                              Kernel::Process& process, Kernel::KernelSystem& kernel,
                              Service::PLGLDR::PLG_LDR& plg_ldr);
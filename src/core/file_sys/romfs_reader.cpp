@@ -1,18 +1,34 @@
 #include <algorithm>
+#include <cstring>
 #include <vector>
-#include <cryptopp/aes.h>
-#include <cryptopp/modes.h>
 
+#include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/file_sys/romfs_reader.h"
+#include "core/hw/aes/ctr.h"
 
 namespace FileSys {
 
+void DirectRomFSReader::MapFile() {
+    if (is_encrypted || !file.IsOpen()) {
+        return;
+    }
+    mapping = std::make_unique<FileUtil::FileMapping>(file);
+    if (mapping->Data().size() < file_offset + data_size) {
+        mapping.reset();
+    }
+}
+
 std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
     length = std::min(length, static_cast<std::size_t>(data_size) - offset);
     if (length == 0)
         return 0; // Crypto++ does not like zero size buffer
 
+    if (mapping) {
+        std::memcpy(buffer, mapping->Data().data() + file_offset + offset, length);
+        return length;
+    }
+
     const auto segments = BreakupRead(offset, length);
     std::size_t read_progress = 0;
 
@@ -20,9 +36,7 @@ std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length,
     if (segments.size() == 1 && segments[0].second > cache_line_size) {
         length = file.ReadAtBytes(buffer, length, file_offset + offset);
         if (is_encrypted) {
-            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-            d.Seek(crypto_offset + offset);
-            d.ProcessData(buffer, buffer, length);
+            HW::AES::TransformCTR({buffer, length}, key, ctr, crypto_offset + offset);
         }
         LOG_TRACE(Service_FS, "RomFS Cache SKIP: offset={}, length={}", offset, length);
         return length;
@@ -30,36 +44,92 @@ std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length,
 
     // TODO(PabloMK7): Make cache thread safe, read the comment in CacheReady function.
     // std::unique_lock<std::shared_mutex> read_guard(cache_mutex);
-    for (const auto& seg : segments) {
-        std::size_t read_size = cache_line_size;
-        std::size_t page = OffsetToPage(seg.first);
+    const bool sequential = offset == last_read_end;
+    last_read_end = offset + length;
+
+    // Reads no larger than a cache line span at most two lines
+    ASSERT(segments.size() <= 2);
+    std::array<u8*, 2> lines{};
+    std::array<std::size_t, 2> line_sizes{};
+    std::array<FileUtil::IOFile::ReadRange, 2> misses{};
+    std::array<std::size_t, 2> miss_segments{};
+    std::size_t num_misses = 0;
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        const auto& seg = segments[i];
+        const std::size_t page = OffsetToPage(seg.first);
         // Check if segment is in cache
         auto cache_entry = cache.request(page);
-        if (!cache_entry.first) {
-            // If not found, read from disk and cache the data
-            read_size = file.ReadAtBytes(cache_entry.second.data(), read_size, file_offset + page);
-            if (is_encrypted && read_size) {
-                CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-                d.Seek(crypto_offset + page);
-                d.ProcessData(cache_entry.second.data(), cache_entry.second.data(), read_size);
-            }
+        lines[i] = cache_entry.second.data();
+        line_sizes[i] = cache_line_size;
+        if (!cache_entry.first && sequential) {
+            line_sizes[i] = ReadAhead(page, lines[i]);
+            LOG_TRACE(Service_FS, "RomFS Cache READ AHEAD: page={}, length={}, into={}", page,
+                      seg.second, (seg.first - page));
+        } else if (!cache_entry.first) {
+            // If not found, read from disk and cache the data, both lines at once when needed
+            misses[num_misses] = {file_offset + page, cache_entry.second};
+            miss_segments[num_misses++] = i;
             LOG_TRACE(Service_FS, "RomFS Cache MISS: page={}, length={}, into={}", page, seg.second,
                       (seg.first - page));
         } else {
             LOG_TRACE(Service_FS, "RomFS Cache HIT: page={}, length={}, into={}", page, seg.second,
                       (seg.first - page));
         }
+    }
+
+    if (num_misses != 0) {
+        std::size_t remaining = file.ReadAtRanges(std::span{misses}.first(num_misses));
+        for (std::size_t i = 0; i < num_misses; i++) {
+            const std::size_t segment = miss_segments[i];
+            const std::size_t read_size = std::min(remaining, cache_line_size);
+            remaining -= read_size;
+            line_sizes[segment] = read_size;
+            if (is_encrypted && read_size) {
+                HW::AES::TransformCTR({lines[segment], read_size}, key, ctr,
+                                      crypto_offset + OffsetToPage(segments[segment].first));
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        const auto& seg = segments[i];
+        const std::size_t page = OffsetToPage(seg.first);
+        const std::size_t read_size = line_sizes[i];
         std::size_t copy_amount =
             (read_size > (seg.first - page))
                 ? std::min((seg.first - page) + seg.second, read_size) - (seg.first - page)
                 : 0;
-        std::memcpy(buffer + read_progress, cache_entry.second.data() + (seg.first - page),
-                    copy_amount);
+        std::memcpy(buffer + read_progress, lines[i] + (seg.first - page), copy_amount);
         read_progress += copy_amount;
     }
     return read_progress;
 }
 
+std::size_t DirectRomFSReader::ReadAhead(std::size_t page, u8* line) {
+    // Only read ahead whole lines, the last line of the data is read on its own.
+    const std::size_t lines =
+        std::clamp<std::size_t>((data_size - page) / cache_line_size, 1, read_ahead_lines);
+    read_ahead_buffer.resize(lines * cache_line_size);
+
+    const std::size_t read_size =
+        file.ReadAtBytes(read_ahead_buffer.data(), read_ahead_buffer.size(), file_offset + page);
+    if (is_encrypted && read_size) {
+        // Decrypting the whole window at once keeps the keystream generation in a single pass.
+        HW::AES::TransformCTR({read_ahead_buffer.data(), read_size}, key, ctr,
+                              crypto_offset + page);
+    }
+
+    std::memcpy(line, read_ahead_buffer.data(), std::min(read_size, cache_line_size));
+    for (std::size_t i = 1; i < lines && (i + 1) * cache_line_size <= read_size; i++) {
+        auto cache_entry = cache.request(page + i * cache_line_size);
+        if (!cache_entry.first) {
+            std::memcpy(cache_entry.second.data(), read_ahead_buffer.data() + i * cache_line_size,
+                        cache_line_size);
+        }
+    }
+    return std::min(read_size, cache_line_size);
+}
+
 bool DirectRomFSReader::AllowsCachedReads() const {
     return true;
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <shared_mutex>
+#include <vector>
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
@@ -29,7 +31,9 @@ class DirectRomFSReader : public RomFSReader {
 public:
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
         : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+          data_size(data_size) {
+        MapFile();
+    }
 
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
                       const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
@@ -50,19 +54,30 @@ public:
     bool CacheReady(std::size_t file_offset, std::size_t length) override;
 
 private:
+    /// Maps unencrypted files into memory, so that reads are a single copy out of the mapping
+    void MapFile();
+
+    /// Reads and decrypts the cache lines following page when reads are sequential
+    std::size_t ReadAhead(std::size_t page, u8* line);
+
     bool is_encrypted;
     FileUtil::IOFile file;
+    std::unique_ptr<FileUtil::FileMapping> mapping;
     std::array<u8, 16> key;
     std::array<u8, 16> ctr;
     u64 file_offset;
     u64 crypto_offset;
     u64 data_size;
 
-    // Total cache size: 128KB
+    // Total cache size: 512KB
     static constexpr std::size_t cache_line_size = (1 << 13); // About 8KB
-    static constexpr std::size_t cache_line_count = 16;
+    static constexpr std::size_t cache_line_count = 64;
+    // Number of cache lines read and decrypted at once when a miss continues the previous read
+    static constexpr std::size_t read_ahead_lines = 8;
 
     Common::StaticLRUCache<std::size_t, std::array<u8, cache_line_size>, cache_line_count> cache;
+    std::vector<u8> read_ahead_buffer;
+    std::size_t last_read_end = 0;
     // TODO(PabloMK7): Make cache thread safe, read the comment in CacheReady function.
     // std::shared_mutex cache_mutex;
 
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "common/file_util.h"
+#include "core/file_sys/directory_cache.h"
 #include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/path_parser.h"
@@ -87,7 +88,8 @@ ResultVal<std::unique_ptr<FileBackend>> SaveDataArchive::OpenFile(const Path& pa
     }
 
     std::unique_ptr<DelayGenerator> delay_generator = std::make_unique<SaveDataDelayGenerator>();
-    return std::make_unique<DiskFile>(std::move(file), mode, std::move(delay_generator));
+    return std::make_unique<DiskFile>(std::move(file), mode, std::move(delay_generator),
+                                      directory_cache, full_path);
 }
 
 Result SaveDataArchive::DeleteFile(const Path& path) const {
@@ -343,6 +345,9 @@ ResultVal<std::unique_ptr<DirectoryBackend>> SaveDataArchive::OpenDirectory(
         break; // Expected 'success' case
     }
 
+    if (directory_cache) {
+        return std::make_unique<DiskDirectory>(directory_cache->GetListing(full_path));
+    }
     return std::make_unique<DiskDirectory>(full_path);
 }
 
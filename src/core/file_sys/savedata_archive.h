@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include "core/file_sys/archive_backend.h"
 #include "core/file_sys/directory_backend.h"
@@ -12,6 +13,8 @@
 
 namespace FileSys {
 
+class DirectoryCache;
+
 /// Archive backend for general save data archive type (SaveData and SystemSaveData)
 class SaveDataArchive : public ArchiveBackend {
 public:
@@ -37,6 +40,7 @@ public:
 protected:
     std::string mount_point;
     bool allow_zero_size_create;
+    std::shared_ptr<DirectoryCache> directory_cache; // Optional, for archives polled often
 };
 
 class SaveDataDelayGenerator;
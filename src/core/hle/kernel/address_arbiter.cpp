@@ -18,51 +18,45 @@ namespace Kernel {
 void AddressArbiter::WaitThread(std::shared_ptr<Thread> thread, VAddr wait_address) {
     thread->wait_address = wait_address;
     thread->status = ThreadStatus::WaitArb;
-    waiting_threads.emplace_back(std::move(thread));
+    waiting_threads[wait_address].emplace_back(std::move(thread));
 }
 
 u64 AddressArbiter::ResumeAllThreads(VAddr address) {
-    // Determine which threads are waiting on this address, those should be woken up.
-    auto itr = std::stable_partition(waiting_threads.begin(), waiting_threads.end(),
-                                     [address](const auto& thread) {
-                                         ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                                                    "Inconsistent AddressArbiter state");
-                                         return thread->wait_address != address;
-                                     });
-
-    // Wake up all the found threads
-    const u64 num_threads = std::distance(itr, waiting_threads.end());
-    std::for_each(itr, waiting_threads.end(), [](auto& thread) { thread->ResumeFromWait(); });
-
-    // Remove the woken up threads from the wait list.
-    waiting_threads.erase(itr, waiting_threads.end());
-    return num_threads;
+    const auto node = waiting_threads.extract(address);
+    if (node.empty()) {
+        return 0;
+    }
+
+    // Wake up all the threads waiting on this address
+    for (const auto& thread : node.mapped()) {
+        ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+        thread->ResumeFromWait();
+    }
+    return node.mapped().size();
 }
 
 bool AddressArbiter::ResumeHighestPriorityThread(VAddr address) {
-    // Determine which threads are waiting on this address, those should be considered for wakeup.
-    auto matches_start = std::stable_partition(
-        waiting_threads.begin(), waiting_threads.end(), [address](const auto& thread) {
-            ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                       "Inconsistent AddressArbiter state");
-            return thread->wait_address != address;
-        });
+    const auto it = waiting_threads.find(address);
+    if (it == waiting_threads.end()) {
+        return false;
+    }
+    auto& threads = it->second;
 
     // Iterate through threads, find highest priority thread that is waiting to be arbitrated.
     // Note: The real kernel will pick the first thread in the list if more than one have the
     // same highest priority value. Lower priority values mean higher priority.
-    auto itr = std::min_element(matches_start, waiting_threads.end(),
-                                [](const auto& lhs, const auto& rhs) {
-                                    return lhs->current_priority < rhs->current_priority;
-                                });
-
-    if (itr == waiting_threads.end()) {
-        return false;
-    }
+    const auto itr =
+        std::min_element(threads.begin(), threads.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs->current_priority < rhs->current_priority;
+        });
 
     auto thread = *itr;
+    ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+    threads.erase(itr);
+    if (threads.empty()) {
+        waiting_threads.erase(it);
+    }
     thread->ResumeFromWait();
-    waiting_threads.erase(itr);
 
     return true;
 }
@@ -97,8 +91,15 @@ void AddressArbiter::WakeUp(ThreadWakeupReason reason, std::shared_ptr<Thread> t
                             std::shared_ptr<WaitObject> object) {
     ASSERT(reason == ThreadWakeupReason::Timeout);
     // Remove the newly-awakened thread from the Arbiter's waiting list.
-    waiting_threads.erase(std::remove(waiting_threads.begin(), waiting_threads.end(), thread),
-                          waiting_threads.end());
+    const auto it = waiting_threads.find(thread->wait_address);
+    if (it == waiting_threads.end()) {
+        return;
+    }
+    auto& threads = it->second;
+    threads.erase(std::remove(threads.begin(), threads.end(), thread), threads.end());
+    if (threads.empty()) {
+        waiting_threads.erase(it);
+    }
 };
 
 Result AddressArbiter::ArbitrateAddress(std::shared_ptr<Thread> thread, ArbitrationType type,
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include "common/common_types.h"
 #include "core/hle/kernel/object.h"
@@ -67,8 +68,9 @@ private:
     /// the resumed thread.
     bool ResumeHighestPriorityThread(VAddr address);
 
-    /// Threads waiting for the address arbiter to be signaled.
-    std::vector<std::shared_ptr<Thread>> waiting_threads;
+    /// Threads waiting for the address arbiter to be signaled, by the address they wait on and in
+    /// the order they started waiting.
+    std::unordered_map<VAddr, std::vector<std::shared_ptr<Thread>>> waiting_threads;
 
     std::shared_ptr<Callback> timeout_callback;
 
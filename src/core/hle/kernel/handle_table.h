@@ -87,6 +87,28 @@ public:
         return DynamicObjectCast<T>(GetGeneric(handle));
     }
 
+    /**
+     * Looks up a handle without taking a reference to the object.
+     * @return Pointer to the looked-up object, valid while the handle stays open, or `nullptr` if
+     *         the handle is not valid.
+     */
+    Object* GetGenericPointer(Handle handle) const;
+
+    /**
+     * Looks up a handle while verifying its type, without taking a reference to the object. Meant
+     * for the svcs that only use the object for the duration of the call.
+     * @return Pointer to the looked-up object, valid while the handle stays open, or `nullptr` if
+     *         the handle is not valid or its type differs from the requested one.
+     */
+    template <class T>
+    T* GetPointer(Handle handle) const {
+        Object* object = GetGenericPointer(handle);
+        if (object != nullptr && object->GetHandleType() == T::HANDLE_TYPE) {
+            return static_cast<T*>(object);
+        }
+        return nullptr;
+    }
+
     /// Closes all handles held in this table.
     void Clear();
 
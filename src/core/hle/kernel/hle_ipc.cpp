@@ -14,6 +14,7 @@
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
+#include "core/memory.h"
 
 namespace Kernel {
 
@@ -33,17 +34,11 @@ public:
         auto process = thread->owner_process.lock();
         ASSERT(process);
 
-        // We must copy the entire command buffer *plus* the entire static buffers area, since
-        // the translation might need to read from it in order to retrieve the StaticBuffer
-        // target addresses.
-        std::array<u32_le, IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS> cmd_buff;
-        Memory::MemorySystem& memory = context->kernel.memory;
-        memory.ReadBlock(*process, thread->GetCommandBufferAddress(), cmd_buff.data(),
-                         cmd_buff.size() * sizeof(u32));
-        context->WriteToOutgoingCommandBuffer(cmd_buff.data(), *process);
-        // Copy the translated command buffer back into the thread's command buffer area.
-        memory.WriteBlock(*process, thread->GetCommandBufferAddress(), cmd_buff.data(),
-                          cmd_buff.size() * sizeof(u32));
+        // The translation might need to read from the static buffers area in order to retrieve
+        // the StaticBuffer target addresses, so it is accessed along the command buffer.
+        CommandBufferAccess cmd_buff(context->kernel.memory, *process, *thread);
+        context->WriteToOutgoingCommandBuffer(cmd_buff.Data(), *process);
+        cmd_buff.Commit();
     }
 
 private:
@@ -273,6 +268,25 @@ Result HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf,
     return ResultSuccess;
 }
 
+CommandBufferAccess::CommandBufferAccess(Memory::MemorySystem& memory_, Process& process_,
+                                         const Thread& thread)
+    : memory{memory_}, process{process_}, address{thread.GetCommandBufferAddress()} {
+    // TLS slots are aligned to their size, so the area is only split across pages if corrupted
+    data = reinterpret_cast<u32_le*>(memory.GetPointer(process, address));
+    const bool crosses_page =
+        (address & Memory::CITRA_PAGE_MASK) + Size * sizeof(u32) > Memory::CITRA_PAGE_SIZE;
+    if (!data || crosses_page) {
+        memory.ReadBlock(process, address, copy.data(), Size * sizeof(u32));
+        data = copy.data();
+    }
+}
+
+void CommandBufferAccess::Commit() {
+    if (data == copy.data()) {
+        memory.WriteBlock(process, address, copy.data(), Size * sizeof(u32));
+    }
+}
+
 MappedBuffer& HLERequestContext::GetMappedBuffer(u32 id_from_cmdbuf) {
     ASSERT_MSG(id_from_cmdbuf < request_mapped_buffers.size(), "Mapped Buffer ID out of range!");
     return request_mapped_buffers[id_from_cmdbuf];
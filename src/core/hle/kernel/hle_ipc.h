@@ -272,6 +272,23 @@ public:
         }
     }
 
+    /**
+     * Same as RunAsync, but queues async_section on an executor instead of launching a thread for
+     * every request, which allows ordering requests and bounding the number of host threads.
+     * @param executor Callable taking the function to run and returning a std::future<void> that
+     * becomes ready once it has run.
+     */
+    template <typename Executor, typename AsyncFunctor, typename ResultFunctor>
+    void RunAsyncOn(Executor&& executor, AsyncFunctor async_section,
+                    ResultFunctor result_function) {
+        this->SleepClientThread("RunAsync", std::chrono::nanoseconds(-1),
+                                std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
+                                    result_function, executor([this, async_section] {
+                                        s64 sleep_for = async_section(*this);
+                                        this->thread->WakeAfterDelay(sleep_for, true);
+                                    })));
+    }
+
     /**
      * Resolves a object id from the request command buffer into a pointer to an object. See the
      * "HLE handle protocol" section in the class documentation for more details.
@@ -334,4 +351,30 @@ private:
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
 };
 
+/**
+ * Gives access to the command buffer of a thread, followed by its static buffer descriptors. The
+ * buffer is used in place when the TLS page is plain memory, which it nearly always is, and only
+ * copied in and written back otherwise.
+ */
+class CommandBufferAccess {
+public:
+    static constexpr std::size_t Size = IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS;
+
+    CommandBufferAccess(Memory::MemorySystem& memory, Process& process, const Thread& thread);
+
+    [[nodiscard]] u32_le* Data() noexcept {
+        return data;
+    }
+
+    /// Makes the changes made through Data() visible to the guest
+    void Commit();
+
+private:
+    Memory::MemorySystem& memory;
+    Process& process;
+    VAddr address;
+    u32_le* data;
+    std::array<u32_le, Size> copy;
+};
+
 } // namespace Kernel
@@ -2,9 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <bit>
+#include <tuple>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/hle/kernel/client_port.h"
+#include "core/hle/ipc.h"
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/process.h"
@@ -166,4 +170,56 @@ void Recorder::SetEnabled(bool enabled_) {
     enabled.store(enabled_, std::memory_order_relaxed);
 }
 
+bool Recorder::IsStatsEnabled() const {
+    return stats_enabled.load(std::memory_order_relaxed);
+}
+
+void Recorder::SetStatsEnabled(bool enabled_) {
+    stats_enabled.store(enabled_, std::memory_order_relaxed);
+}
+
+void Recorder::RecordServiceCall(const Kernel::SessionRequestHandler& handler, u32 header_code,
+                                 std::chrono::nanoseconds latency) {
+    const IPC::Header header{header_code};
+    const u32 command_id = header.command_id.Value();
+    const u64 latency_ns = static_cast<u64>(std::max<s64>(latency.count(), 0));
+    const std::size_t bucket =
+        std::min<std::size_t>(std::bit_width(latency_ns / 1000), NumLatencyBuckets - 1);
+
+    std::scoped_lock lock(stats_mutex);
+    auto [it, inserted] = service_stats.try_emplace({&handler, command_id});
+    auto& stats = it->second;
+    if (inserted) {
+        stats.command_id = command_id;
+        if (const auto service = dynamic_cast<const Service::ServiceFrameworkBase*>(&handler)) {
+            stats.service_name = service->GetServiceName();
+            stats.function_name = service->GetFunctionName(header);
+        }
+    }
+    stats.count++;
+    stats.total_ns += latency_ns;
+    stats.max_ns = std::max(stats.max_ns, latency_ns);
+    stats.histogram[bucket]++;
+}
+
+std::vector<ServiceCallStats> Recorder::GetServiceStats() const {
+    std::vector<ServiceCallStats> result;
+    {
+        std::scoped_lock lock(stats_mutex);
+        result.reserve(service_stats.size());
+        for (const auto& [key, stats] : service_stats) {
+            result.push_back(stats);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.service_name, a.command_id) < std::tie(b.service_name, b.command_id);
+    });
+    return result;
+}
+
+void Recorder::ClearServiceStats() {
+    std::scoped_lock lock(stats_mutex);
+    service_stats.clear();
+}
+
 } // namespace IPCDebugger
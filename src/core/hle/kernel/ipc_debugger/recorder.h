@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 #include <string>
@@ -16,6 +20,7 @@
 
 namespace Kernel {
 class ClientSession;
+class SessionRequestHandler;
 class Thread;
 } // namespace Kernel
 
@@ -64,6 +69,24 @@ struct RequestRecord {
     std::vector<u32> translated_reply_cmdbuf;
 };
 
+/// Number of buckets of the latency histogram of every service command
+constexpr std::size_t NumLatencyBuckets = 16;
+
+/**
+ * Call count and host latency of an HLE service command, for profiling purposes.
+ * Bucket 0 of the histogram counts the calls that took less than 1us, bucket i the calls that took
+ * between 2^(i-1)us and 2^i us, and the last bucket every slower call as well.
+ */
+struct ServiceCallStats {
+    std::string service_name;
+    std::string function_name; // Empty when the command has no registered handler
+    u32 command_id{};
+    u64 count{};
+    u64 total_ns{};
+    u64 max_ns{};
+    std::array<u64, NumLatencyBuckets> histogram{};
+};
+
 using CallbackType = std::function<void(const RequestRecord&)>;
 using CallbackHandle = std::shared_ptr<CallbackType>;
 
@@ -111,6 +134,30 @@ public:
     CallbackHandle BindCallback(CallbackType callback);
     void UnbindCallback(const CallbackHandle& handle);
 
+    /**
+     * Returns whether service call statistics are collected.
+     */
+    bool IsStatsEnabled() const;
+
+    /**
+     * Set whether service call statistics are collected. Statistics are kept when disabled.
+     */
+    void SetStatsEnabled(bool enabled);
+
+    /**
+     * Accounts a request handled by an HLE service. The latency only covers the synchronous part of
+     * the handler, work that is run asynchronously is not included.
+     */
+    void RecordServiceCall(const Kernel::SessionRequestHandler& handler, u32 header_code,
+                           std::chrono::nanoseconds latency);
+
+    /**
+     * Returns the statistics of every service command called so far, sorted by service.
+     */
+    std::vector<ServiceCallStats> GetServiceStats() const;
+
+    void ClearServiceStats();
+
 private:
     void InvokeCallbacks(const RequestRecord& request);
 
@@ -124,6 +171,11 @@ private:
 
     std::set<CallbackHandle> callbacks;
     mutable std::shared_mutex callback_mutex;
+
+    std::atomic_bool stats_enabled{false};
+    // Keyed by handler and command id, the handler is only used for identification
+    std::map<std::pair<const void*, u32>, ServiceCallStats> service_stats;
+    mutable std::mutex stats_mutex;
 };
 
 } // namespace IPCDebugger
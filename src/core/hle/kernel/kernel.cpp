@@ -13,6 +13,7 @@
 #include "core/hle/kernel/shared_page.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hle/kernel/timer.h"
+#include "core/savestate.h"
 
 namespace Kernel {
 
@@ -144,6 +145,24 @@ const IPCDebugger::Recorder& KernelSystem::GetIPCRecorder() const {
     return *ipc_recorder;
 }
 
+void KernelSystem::SaveState(Core::StateWriter& writer) const {
+    writer.Write<u32>(Core::MakeStateTag("KERN"));
+    writer.WriteBytes(config_mem_handler->GetPtr(), config_mem_handler->GetSize());
+    writer.WriteBytes(shared_page_handler->GetPtr(), shared_page_handler->GetSize());
+    for (const auto& thread_manager : thread_managers) {
+        thread_manager->SaveState(writer);
+    }
+}
+
+void KernelSystem::LoadState(Core::StateReader& reader) {
+    reader.ExpectTag(Core::MakeStateTag("KERN"));
+    reader.ReadBytes(config_mem_handler->GetPtr(), config_mem_handler->GetSize());
+    reader.ReadBytes(shared_page_handler->GetPtr(), shared_page_handler->GetSize());
+    for (auto& thread_manager : thread_managers) {
+        thread_manager->LoadState(reader);
+    }
+}
+
 void KernelSystem::AddNamedPort(std::string name, std::shared_ptr<ClientPort> port) {
     named_ports.emplace(std::move(name), std::move(port));
 }
@@ -32,6 +32,8 @@ class MemorySystem;
 
 namespace Core {
 class ARM_Interface;
+class StateReader;
+class StateWriter;
 class Timing;
 } // namespace Core
 
@@ -293,6 +295,12 @@ public:
     IPCDebugger::Recorder& GetIPCRecorder();
     const IPCDebugger::Recorder& GetIPCRecorder() const;
 
+    /// Writes thread scheduling state, the shared page and config memory to a savestate stream.
+    void SaveState(Core::StateWriter& writer) const;
+
+    /// Restores the kernel state written by SaveState.
+    void LoadState(Core::StateReader& reader);
+
     std::shared_ptr<MemoryRegionInfo> GetMemoryRegion(MemoryRegion region);
 
     void HandleSpecialMapping(VMManager& address_space, const AddressMapping& mapping);
@@ -168,87 +168,112 @@ void MemoryRegionInfo::Reset(u32 base, u32 size) {
     this->size = size;
     used = 0;
     free_blocks.clear();
+    free_sizes.clear();
 
     // mark the entire region as free
-    free_blocks.insert(Interval::right_open(base, base + size));
+    InsertFree(base, base + size);
 }
 
 MemoryRegionInfo::IntervalSet MemoryRegionInfo::HeapAllocate(u32 size) {
-    IntervalSet result;
-    u32 rest = size;
-
-    // Try allocating from the higher address
-    for (auto iter = free_blocks.rbegin(); iter != free_blocks.rend(); ++iter) {
-        ASSERT(iter->bounds() == boost::icl::interval_bounds::right_open());
-        if (iter->upper() - iter->lower() >= rest) {
-            // Requested size is fulfilled with this block
-            result += Interval(iter->upper() - rest, iter->upper());
-            rest = 0;
-            break;
-        }
-        result += *iter;
-        rest -= iter->upper() - iter->lower();
-    }
-
-    if (rest != 0) {
+    if (size > this->size - used) {
         // There is no enough free space
         return {};
     }
 
-    free_blocks -= result;
-    used += size;
+    // Allocate from the higher address, the blocks below the last one are taken whole
+    IntervalSet result;
+    for (u32 rest = size; rest != 0;) {
+        const auto block = std::prev(free_blocks.end());
+        const u32 taken = std::min(rest, block->second - block->first);
+        const u32 offset = block->second - taken;
+        result += Interval(offset, offset + taken);
+        TakeFree(block, offset, taken);
+        rest -= taken;
+    }
     return result;
 }
 
 bool MemoryRegionInfo::LinearAllocate(u32 offset, u32 size) {
-    Interval interval(offset, offset + size);
-    if (!boost::icl::contains(free_blocks, interval)) {
+    auto block = free_blocks.upper_bound(offset);
+    if (block == free_blocks.begin() || std::prev(block)->second < offset + size) {
         // The requested range is already allocated
         return false;
     }
-    free_blocks -= interval;
-    used += size;
+    TakeFree(std::prev(block), offset, size);
     return true;
 }
 
 std::optional<u32> MemoryRegionInfo::LinearAllocate(u32 size) {
-    // Find the first sufficient continuous block from the lower address
-    for (const auto& interval : free_blocks) {
-        ASSERT(interval.bounds() == boost::icl::interval_bounds::right_open());
-        if (interval.upper() - interval.lower() >= size) {
-            Interval allocated(interval.lower(), interval.lower() + size);
-            free_blocks -= allocated;
-            used += size;
-            return allocated.lower();
-        }
+    const auto best_fit = free_sizes.lower_bound({size, 0});
+    if (best_fit == free_sizes.end()) {
+        // No sufficient block found
+        return std::nullopt;
     }
-
-    // No sufficient block found
-    return std::nullopt;
+    const u32 offset = best_fit->second;
+    TakeFree(free_blocks.find(offset), offset, size);
+    return offset;
 }
 
 std::optional<u32> MemoryRegionInfo::RLinearAllocate(u32 size) {
+    if (free_sizes.empty() || free_sizes.rbegin()->first < size) {
+        // No sufficient block found
+        return std::nullopt;
+    }
+
     // Find the first sufficient continuous block from the upper address
-    for (auto iter = free_blocks.rbegin(); iter != free_blocks.rend(); ++iter) {
-        auto interval = *iter;
-        ASSERT(interval.bounds() == boost::icl::interval_bounds::right_open());
-        if (interval.upper() - interval.lower() >= size) {
-            Interval allocated(interval.upper() - size, interval.upper());
-            free_blocks -= allocated;
-            used += size;
-            return allocated.lower();
+    for (auto block = free_blocks.rbegin(); block != free_blocks.rend(); ++block) {
+        if (block->second - block->first >= size) {
+            const u32 offset = block->second - size;
+            TakeFree(std::prev(block.base()), offset, size);
+            return offset;
         }
     }
-
-    // No sufficient block found
-    return std::nullopt;
+    UNREACHABLE();
 }
 
 void MemoryRegionInfo::Free(u32 offset, u32 size) {
-    Interval interval(offset, offset + size);
-    ASSERT(!boost::icl::intersects(free_blocks, interval)); // must be allocated blocks
-    free_blocks += interval;
+    u32 start = offset;
+    u32 end = offset + size;
+
+    // Coalesce the range with the free blocks right before and after it
+    auto next = free_blocks.lower_bound(offset);
+    ASSERT_MSG(next == free_blocks.end() || next->first >= end, "Freeing a free block");
+    if (next != free_blocks.begin()) {
+        const auto prev = std::prev(next);
+        ASSERT_MSG(prev->second <= offset, "Freeing a free block");
+        if (prev->second == offset) {
+            start = prev->first;
+            EraseFree(prev);
+        }
+    }
+    if (next != free_blocks.end() && next->first == end) {
+        end = next->second;
+        EraseFree(next);
+    }
+    InsertFree(start, end);
     used -= size;
 }
 
+void MemoryRegionInfo::InsertFree(u32 offset, u32 end) {
+    if (offset == end) {
+        return;
+    }
+    free_blocks.emplace(offset, end);
+    free_sizes.emplace(end - offset, offset);
+}
+
+void MemoryRegionInfo::EraseFree(FreeBlocks::iterator block) {
+    free_sizes.erase({block->second - block->first, block->first});
+    free_blocks.erase(block);
+}
+
+void MemoryRegionInfo::TakeFree(FreeBlocks::iterator block, u32 offset, u32 size) {
+    const auto [start, end] = *block;
+    ASSERT(start <= offset && offset + size <= end);
+    EraseFree(block);
+    InsertFree(start, offset);
+    InsertFree(offset + size, end);
+    used += size;
+}
+
 } // namespace Kernel
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <map>
 #include <optional>
+#include <set>
+#include <utility>
 #include <boost/icl/interval_set.hpp>
 #include "common/common_types.h"
 
@@ -22,8 +25,6 @@ struct MemoryRegionInfo {
     using IntervalSet = boost::icl::interval_set<u32>;
     using Interval = IntervalSet::interval_type;
 
-    IntervalSet free_blocks;
-
     /**
      * Reset the allocator state
      * @param base The base offset the beginning of FCRAM.
@@ -48,7 +49,8 @@ struct MemoryRegionInfo {
     bool LinearAllocate(u32 offset, u32 size);
 
     /**
-     * Allocates memory from the linear heap with only size specified.
+     * Allocates memory from the linear heap with only size specified. The memory is taken from
+     * the start of the smallest free block that fits it, the lowest one among equally sized ones.
      * @param size size of the memory to allocate.
      * @returns the address offset to the beginning of FCRAM; null if there is no enough space
      */
@@ -68,6 +70,19 @@ struct MemoryRegionInfo {
      * @param size the size of the region to free.
      */
     void Free(u32 offset, u32 size);
+
+private:
+    /// Maps the start offsets of the free blocks to their ends, adjacent blocks are coalesced
+    using FreeBlocks = std::map<u32, u32>;
+
+    void InsertFree(u32 offset, u32 end);
+    void EraseFree(FreeBlocks::iterator block);
+
+    /// Allocates the range [offset, offset + size) from the free block containing it
+    void TakeFree(FreeBlocks::iterator block, u32 offset, u32 size);
+
+    FreeBlocks free_blocks;
+    std::set<std::pair<u32, u32>> free_sizes; ///< Size and start offset of every free block
 };
 
 } // namespace Kernel
@@ -240,20 +240,15 @@ Result Process::HeapAllocate(VAddr* out_addr, VAddr target, u32 size, VMAPermiss
     }
 
     // Maps heap block by block
-    VAddr interval_target = target;
+    VMManager::BackingBlocks backing_blocks;
     for (const auto& interval : allocated_fcram) {
         const u32 interval_size = interval.upper() - interval.lower();
         LOG_DEBUG(Kernel, "Allocated FCRAM region lower={:08X}, upper={:08X}", interval.lower(),
                   interval.upper());
-        std::fill(kernel.memory.GetFCRAMPointer(interval.lower()),
-                  kernel.memory.GetFCRAMPointer(interval.upper()), 0);
-        auto vma = vm_manager.MapBackingMemory(interval_target,
-                                               kernel.memory.GetFCRAMPointer(interval.lower()),
-                                               interval_size, memory_state);
-        ASSERT(vma.Succeeded());
-        vm_manager.Reprotect(vma.Unwrap(), perms);
-        interval_target += interval_size;
+        kernel.memory.ZeroFCRAM(interval.lower(), interval_size);
+        backing_blocks.emplace_back(kernel.memory.GetFCRAMPointer(interval.lower()), interval_size);
     }
+    R_ASSERT(vm_manager.MapBackingMemoryBlocks(target, backing_blocks, memory_state, perms));
 
     holding_memory += allocated_fcram;
     memory_used += size;
@@ -324,7 +319,7 @@ Result Process::LinearAllocate(VAddr* out_addr, VAddr target, u32 size, VMAPermi
 
     auto backing_memory = kernel.memory.GetFCRAMPointer(physical_offset);
 
-    std::fill(backing_memory, backing_memory + size, 0);
+    kernel.memory.ZeroFCRAM(physical_offset, size);
     auto vma = vm_manager.MapBackingMemory(target, backing_memory, size, MemoryState::Continuous);
     ASSERT(vma.Succeeded());
     vm_manager.Reprotect(vma.Unwrap(), perms);
@@ -472,14 +467,7 @@ Result Process::Map(VAddr target, VAddr source, u32 size, VMAPermission perms, b
                                        source_state, source_perm));
 
     CASCADE_RESULT(auto backing_blocks, vm_manager.GetBackingBlocksForRange(source, size));
-    VAddr interval_target = target;
-    for (const auto& [backing_memory, block_size] : backing_blocks) {
-        auto target_vma =
-            vm_manager.MapBackingMemory(interval_target, backing_memory, block_size, target_state);
-        ASSERT(target_vma.Succeeded());
-        vm_manager.Reprotect(target_vma.Unwrap(), perms);
-        interval_target += block_size;
-    }
+    R_ASSERT(vm_manager.MapBackingMemoryBlocks(target, backing_blocks, target_state, perms));
 
     return ResultSuccess;
 }
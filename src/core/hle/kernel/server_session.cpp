@@ -2,11 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <tuple>
 
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/kernel/session.h"
 #include "core/hle/kernel/thread.h"
@@ -67,17 +69,27 @@ Result ServerSession::HandleSyncRequest(std::shared_ptr<Thread> thread) {
 
     // If this ServerSession has an associated HLE handler, forward the request to it.
     if (hle_handler != nullptr) {
-        std::array<u32_le, IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS> cmd_buf;
         auto current_process = thread->owner_process.lock();
         ASSERT(current_process);
-        kernel.memory.ReadBlock(*current_process, thread->GetCommandBufferAddress(), cmd_buf.data(),
-                                cmd_buf.size() * sizeof(u32));
 
         auto context =
             std::make_shared<Kernel::HLERequestContext>(kernel, SharedFrom(this), thread);
-        context->PopulateFromIncomingCommandBuffer(cmd_buf.data(), current_process);
+        {
+            CommandBufferAccess cmd_buf(kernel.memory, *current_process, *thread);
+            context->PopulateFromIncomingCommandBuffer(cmd_buf.Data(), current_process);
+        }
 
-        hle_handler->HandleSyncRequest(*context);
+        auto& ipc_recorder = kernel.GetIPCRecorder();
+        if (ipc_recorder.IsStatsEnabled()) {
+            // The handler overwrites the command buffer with its reply, keep the request header.
+            const u32 header_code = context->CommandBuffer()[0];
+            const auto start = std::chrono::steady_clock::now();
+            hle_handler->HandleSyncRequest(*context);
+            ipc_recorder.RecordServiceCall(*hle_handler, header_code,
+                                           std::chrono::steady_clock::now() - start);
+        } else {
+            hle_handler->HandleSyncRequest(*context);
+        }
 
         ASSERT(thread->status == Kernel::ThreadStatus::Running ||
                thread->status == Kernel::ThreadStatus::WaitHleEvent);
@@ -85,9 +97,9 @@ Result ServerSession::HandleSyncRequest(std::shared_ptr<Thread> thread) {
         // put the thread to sleep then the writing of the command buffer will be deferred to the
         // wakeup callback.
         if (thread->status == Kernel::ThreadStatus::Running) {
-            context->WriteToOutgoingCommandBuffer(cmd_buf.data(), *current_process);
-            kernel.memory.WriteBlock(*current_process, thread->GetCommandBufferAddress(),
-                                     cmd_buf.data(), cmd_buf.size() * sizeof(u32));
+            CommandBufferAccess cmd_buf(kernel.memory, *current_process, *thread);
+            context->WriteToOutgoingCommandBuffer(cmd_buf.Data(), *current_process);
+            cmd_buf.Commit();
         }
     }
 
@@ -176,14 +176,8 @@ Result SharedMemory::Map(Process& target_process, VAddr address, MemoryPermissio
     }
 
     // Map the memory block into the target process
-    VAddr interval_target = target_address;
-    for (const auto& interval : backing_blocks) {
-        auto vma = target_process.vm_manager.MapBackingMemory(interval_target, interval.first,
-                                                              interval.second, MemoryState::Shared);
-        ASSERT(vma.Succeeded());
-        target_process.vm_manager.Reprotect(vma.Unwrap(), ConvertPermissions(permissions));
-        interval_target += interval.second;
-    }
+    R_ASSERT(target_process.vm_manager.MapBackingMemoryBlocks(
+        target_address, backing_blocks, MemoryState::Shared, ConvertPermissions(permissions)));
 
     return ResultSuccess;
 }
@@ -68,8 +68,7 @@ Handler::Handler(Core::Timing& timing, u64 override_init_time) : timing(timing)
                                              std::bind(&Handler::UpdateTimeCallback, this, _1, _2));
     timing.ScheduleEvent(0, update_time_event, 0, 0);
 
-    float slidestate = Settings::values.factor_3d.GetValue() / 100.0f;
-    shared_page.sliderstate_3d = static_cast<float_le>(slidestate);
+    shared_page.sliderstate_3d = static_cast<float_le>(Settings::SliderState3D());
 
     // TODO(PabloMK7)
     // Set wifi state to internet, to fake a connection from the NDM service.
@@ -611,8 +611,8 @@ Result SVC::ConnectToPort(Handle* out_handle, VAddr port_name_address) {
 
 /// Makes a blocking IPC call to an OS service.
 Result SVC::SendSyncRequest(Handle handle) {
-    std::shared_ptr<ClientSession> session =
-        kernel.GetCurrentProcess()->handle_table.Get<ClientSession>(handle);
+    ClientSession* session =
+        kernel.GetCurrentProcess()->handle_table.GetPointer<ClientSession>(handle);
     R_UNLESS(session, ResultInvalidHandle);
 
     LOG_TRACE(Kernel_SVC, "called handle=0x{:08X}({})", handle, session->GetName());
@@ -622,9 +622,11 @@ Result SVC::SendSyncRequest(Handle handle) {
     auto thread = SharedFrom(kernel.GetCurrentThreadManager().GetCurrentThread());
 
     if (kernel.GetIPCRecorder().IsEnabled()) {
-        kernel.GetIPCRecorder().RegisterRequest(session, thread);
+        kernel.GetIPCRecorder().RegisterRequest(SharedFrom(session), thread);
     }
 
+    Core::PerfStats::ScopedTimer timer{system.perf_stats.get(),
+                                       Core::PerfStats::Subsystem::Service};
     return session->SendSyncRequest(thread);
 }
 
@@ -1023,8 +1025,8 @@ Result SVC::ArbitrateAddress(Handle handle, u32 address, u32 type, u32 value, s6
     LOG_TRACE(Kernel_SVC, "called handle=0x{:08X}, address=0x{:08X}, type=0x{:08X}, value=0x{:08X}",
               handle, address, type, value);
 
-    std::shared_ptr<AddressArbiter> arbiter =
-        kernel.GetCurrentProcess()->handle_table.Get<AddressArbiter>(handle);
+    AddressArbiter* arbiter =
+        kernel.GetCurrentProcess()->handle_table.GetPointer<AddressArbiter>(handle);
     R_UNLESS(arbiter, ResultInvalidHandle);
 
     auto res =
@@ -1280,7 +1282,7 @@ Result SVC::CreateMutex(Handle* out_handle, u32 initial_locked) {
 Result SVC::ReleaseMutex(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called handle=0x{:08X}", handle);
 
-    std::shared_ptr<Mutex> mutex = kernel.GetCurrentProcess()->handle_table.Get<Mutex>(handle);
+    Mutex* mutex = kernel.GetCurrentProcess()->handle_table.GetPointer<Mutex>(handle);
     R_UNLESS(mutex, ResultInvalidHandle);
 
     return mutex->Release(kernel.GetCurrentThreadManager().GetCurrentThread());
@@ -1437,7 +1439,7 @@ Result SVC::DuplicateHandle(Handle* out, Handle handle) {
 Result SVC::SignalEvent(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called event=0x{:08X}", handle);
 
-    std::shared_ptr<Event> evt = kernel.GetCurrentProcess()->handle_table.Get<Event>(handle);
+    Event* evt = kernel.GetCurrentProcess()->handle_table.GetPointer<Event>(handle);
     R_UNLESS(evt, ResultInvalidHandle);
 
     evt->Signal();
@@ -1448,7 +1450,7 @@ Result SVC::SignalEvent(Handle handle) {
 Result SVC::ClearEvent(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called event=0x{:08X}", handle);
 
-    std::shared_ptr<Event> evt = kernel.GetCurrentProcess()->handle_table.Get<Event>(handle);
+    Event* evt = kernel.GetCurrentProcess()->handle_table.GetPointer<Event>(handle);
     R_UNLESS(evt, ResultInvalidHandle);
 
     evt->Clear();
@@ -1476,7 +1478,7 @@ Result SVC::CreateTimer(Handle* out_handle, u32 reset_type) {
 Result SVC::ClearTimer(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called timer=0x{:08X}", handle);
 
-    std::shared_ptr<Timer> timer = kernel.GetCurrentProcess()->handle_table.Get<Timer>(handle);
+    Timer* timer = kernel.GetCurrentProcess()->handle_table.GetPointer<Timer>(handle);
     R_UNLESS(timer, ResultInvalidHandle);
 
     timer->Clear();
@@ -1489,7 +1491,7 @@ Result SVC::SetTimer(Handle handle, s64 initial, s64 interval) {
 
     R_UNLESS(initial >= 0 && interval >= 0, ResultOutOfRangeKernel);
 
-    std::shared_ptr<Timer> timer = kernel.GetCurrentProcess()->handle_table.Get<Timer>(handle);
+    Timer* timer = kernel.GetCurrentProcess()->handle_table.GetPointer<Timer>(handle);
     R_UNLESS(timer, ResultInvalidHandle);
 
     timer->Set(initial, interval);
@@ -1501,7 +1503,7 @@ Result SVC::SetTimer(Handle handle, s64 initial, s64 interval) {
 Result SVC::CancelTimer(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called timer=0x{:08X}", handle);
 
-    std::shared_ptr<Timer> timer = kernel.GetCurrentProcess()->handle_table.Get<Timer>(handle);
+    Timer* timer = kernel.GetCurrentProcess()->handle_table.GetPointer<Timer>(handle);
     R_UNLESS(timer, ResultInvalidHandle);
 
     timer->Cancel();
@@ -1515,8 +1517,12 @@ void SVC::SleepThread(s64 nanoseconds) {
     ThreadManager& thread_manager = kernel.GetCurrentThreadManager();
 
     // Don't attempt to yield execution if there are no available threads to run,
-    // this way we avoid a useless reschedule to the idle thread.
+    // this way we avoid a useless reschedule to the idle thread. Titles yield in a loop while
+    // they poll for another core or an event, so skip to the end of the slice, the next event
+    // that could change what they poll for, instead of emulating the spin.
     if (nanoseconds == 0 && !thread_manager.HaveReadyThreads()) {
+        system.GetRunningCore().GetTimer().Idle();
+        system.PrepareReschedule();
         return;
     }
 
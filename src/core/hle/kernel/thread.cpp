@@ -20,6 +20,7 @@
 #include "core/hle/kernel/thread.h"
 #include "core/hle/result.h"
 #include "core/memory.h"
+#include "core/savestate.h"
 
 namespace Kernel {
 
@@ -321,7 +322,6 @@ ResultVal<std::shared_ptr<Thread>> KernelSystem::CreateThread(
     auto thread = std::make_shared<Thread>(*this, processor_id);
 
     thread_managers[processor_id]->thread_list.push_back(thread);
-    thread_managers[processor_id]->ready_queue.prepare(priority);
 
     thread->thread_id = NewThreadId();
     thread->status = ThreadStatus::Dormant;
@@ -356,8 +356,6 @@ void Thread::SetPriority(u32 priority) {
     // If thread was ready, adjust queues
     if (status == ThreadStatus::Ready)
         thread_manager.ready_queue.move(this, current_priority, priority);
-    else
-        thread_manager.ready_queue.prepare(priority);
 
     nominal_priority = current_priority = priority;
 }
@@ -375,8 +373,6 @@ void Thread::BoostPriority(u32 priority) {
     // If thread was ready, adjust queues
     if (status == ThreadStatus::Ready)
         thread_manager.ready_queue.move(this, current_priority, priority);
-    else
-        thread_manager.ready_queue.prepare(priority);
     current_priority = priority;
 }
 
@@ -475,4 +471,95 @@ std::span<const std::shared_ptr<Thread>> ThreadManager::GetThreadList() {
     return thread_list;
 }
 
+static bool IsSchedulable(ThreadStatus status) {
+    return status == ThreadStatus::Running || status == ThreadStatus::Ready;
+}
+
+void ThreadManager::SaveState(Core::StateWriter& writer) const {
+    writer.Write<u32>(Core::MakeStateTag("THRD"));
+    writer.Write<u32>(static_cast<u32>(thread_list.size()));
+    for (const auto& thread : thread_list) {
+        Core::ARM_Interface::ThreadContext context = thread->context;
+        if (thread == current_thread) {
+            // The context of the running thread only lives in the CPU.
+            cpu->SaveContext(context);
+        }
+        writer.Write<u32>(thread->thread_id);
+        writer.Write<ThreadStatus>(thread->status);
+        writer.Write<u32>(thread->current_priority);
+        writer.Write<u64>(thread->last_running_ticks);
+        writer.Write(context);
+    }
+    writer.Write<u32>(current_thread ? current_thread->thread_id : 0);
+}
+
+void ThreadManager::LoadState(Core::StateReader& reader) {
+    struct SavedThread {
+        u32 thread_id;
+        ThreadStatus status;
+        u32 current_priority;
+        u64 last_running_ticks;
+        Core::ARM_Interface::ThreadContext context;
+    };
+
+    reader.ExpectTag(Core::MakeStateTag("THRD"));
+    const u32 num_threads = reader.Read<u32>();
+    if (num_threads != thread_list.size()) {
+        throw std::runtime_error("Savestate thread list does not match the running system");
+    }
+
+    std::vector<std::pair<Thread*, SavedThread>> threads;
+    threads.reserve(num_threads);
+    for (u32 i = 0; i < num_threads; ++i) {
+        SavedThread saved{};
+        reader.Read(saved.thread_id);
+        reader.Read(saved.status);
+        reader.Read(saved.current_priority);
+        reader.Read(saved.last_running_ticks);
+        reader.Read(saved.context);
+
+        const auto it = std::find_if(thread_list.begin(), thread_list.end(), [&](const auto& t) {
+            return t->thread_id == saved.thread_id;
+        });
+        if (it == thread_list.end()) {
+            throw std::runtime_error("Savestate thread list does not match the running system");
+        }
+
+        Thread* thread = it->get();
+        const bool compatible = IsSchedulable(thread->status) && IsSchedulable(saved.status);
+        if (!compatible && thread->status != saved.status) {
+            throw std::runtime_error(
+                fmt::format("Savestate thread {} is waiting on an object that cannot be restored",
+                            saved.thread_id));
+        }
+        threads.emplace_back(thread, saved);
+    }
+    const u32 current_thread_id = reader.Read<u32>();
+
+    // Everything has been validated, the running state can now be replaced.
+    for (auto& [thread, saved] : threads) {
+        if (thread->status == ThreadStatus::Ready) {
+            ready_queue.remove(thread->current_priority, thread);
+        }
+        thread->current_priority = saved.current_priority;
+        thread->last_running_ticks = saved.last_running_ticks;
+        thread->context = saved.context;
+        thread->status = saved.status;
+        if (saved.status == ThreadStatus::Ready) {
+            ready_queue.push_back(thread->current_priority, thread);
+        }
+    }
+
+    current_thread = nullptr;
+    for (auto& [thread, saved] : threads) {
+        if (thread->thread_id != current_thread_id || saved.status != ThreadStatus::Running) {
+            continue;
+        }
+        current_thread = SharedFrom(thread);
+        kernel.SetCurrentProcessForCPU(thread->owner_process.lock(), cpu->GetID());
+        cpu->LoadContext(thread->context);
+        cpu->SetCP15Register(CP15_THREAD_URO, thread->GetTLSAddress());
+    }
+}
+
 } // namespace Kernel
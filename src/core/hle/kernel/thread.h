@@ -18,6 +18,11 @@
 #include "core/hle/kernel/wait_object.h"
 #include "core/hle/result.h"
 
+namespace Core {
+class StateReader;
+class StateWriter;
+} // namespace Core
+
 namespace Kernel {
 
 class Mutex;
@@ -116,6 +121,16 @@ public:
         cpu = &cpu_;
     }
 
+    /// Writes the contexts and scheduling state of all live threads to a savestate stream.
+    void SaveState(Core::StateWriter& writer) const;
+
+    /**
+     * Restores thread contexts and scheduling state. Wait relationships between threads and
+     * kernel objects are not part of the stream, so this throws if a thread that is waiting in
+     * either the stream or the running system is not waiting for the same reason in both.
+     */
+    void LoadState(Core::StateReader& reader);
+
 private:
     /**
      * Switches the CPU's active thread context to that of the specified thread
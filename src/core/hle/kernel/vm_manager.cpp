@@ -41,6 +41,7 @@ VMManager::VMManager(Kernel::KernelSystem& kernel, Kernel::Process& proc)
     VirtualMemoryArea initial_vma;
     initial_vma.size = MAX_ADDRESS;
     vma_map.emplace(initial_vma.base, initial_vma);
+    last_vma = vma_map.end();
 
     UpdatePageTableForVMA(initial_vma);
 }
@@ -50,9 +51,15 @@ VMManager::~VMManager() = default;
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
     if (target >= MAX_ADDRESS) {
         return vma_map.end();
-    } else {
-        return std::prev(vma_map.upper_bound(target));
     }
+
+    if (last_vma != vma_map.end() && target >= last_vma->second.base &&
+        target - last_vma->second.base < last_vma->second.size) {
+        return last_vma;
+    }
+
+    last_vma = std::prev(vma_map.upper_bound(target));
+    return last_vma;
 }
 
 ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, u8* memory,
@@ -300,14 +307,14 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     const VMAIter next_vma = std::next(iter);
     if (next_vma != vma_map.end() && iter->second.CanBeMergedWith(next_vma->second)) {
         iter->second.size += next_vma->second.size;
-        vma_map.erase(next_vma);
+        EraseVMA(next_vma);
     }
 
     if (iter != vma_map.begin()) {
         VMAIter prev_vma = std::prev(iter);
         if (prev_vma->second.CanBeMergedWith(iter->second)) {
             prev_vma->second.size += iter->second.size;
-            vma_map.erase(iter);
+            EraseVMA(iter);
             iter = prev_vma;
         }
     }
@@ -315,7 +322,14 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     return iter;
 }
 
-void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
+void VMManager::EraseVMA(VMAIter vma) {
+    if (last_vma == vma) {
+        last_vma = vma_map.end();
+    }
+    vma_map.erase(vma);
+}
+
+void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma, bool notify) {
     switch (vma.type) {
     case VMAType::Free:
         kernel.memory.UnmapRegion(*page_table, vma.base, vma.size);
@@ -325,6 +339,12 @@ void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
         break;
     }
 
+    if (notify) {
+        NotifyMemoryChanged();
+    }
+}
+
+void VMManager::NotifyMemoryChanged() {
     auto plgldr = Service::PLGLDR::GetService(kernel);
     if (plgldr)
         plgldr->OnMemoryChanged(process, kernel);
@@ -333,9 +353,9 @@ void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
 ResultVal<VMManager::BackingBlocks> VMManager::GetBackingBlocksForRange(VAddr address, u32 size) {
     BackingBlocks backing_blocks;
     VAddr interval_target = address;
-    while (interval_target != address + size) {
-        auto vma = FindVMA(interval_target);
-        if (vma->second.type != VMAType::BackingMemory) {
+    // The range is contiguous, so walk the map instead of looking up every interval.
+    for (auto vma = FindVMA(interval_target); interval_target != address + size; ++vma) {
+        if (vma == vma_map.end() || vma->second.type != VMAType::BackingMemory) {
             LOG_ERROR(Kernel, "Trying to use already freed memory");
             return ResultInvalidAddressState;
         }
@@ -350,4 +370,36 @@ ResultVal<VMManager::BackingBlocks> VMManager::GetBackingBlocksForRange(VAddr ad
     return backing_blocks;
 }
 
+Result VMManager::MapBackingMemoryBlocks(VAddr target, const BackingBlocks& blocks,
+                                         MemoryState state, VMAPermission perms) {
+    u32 total_size = 0;
+    for (const auto& [memory, size] : blocks) {
+        ASSERT(memory != nullptr);
+        total_size += size;
+    }
+    R_SUCCEED_IF(total_size == 0);
+
+    CASCADE_RESULT(VMAIter vma, CarveVMA(target, total_size));
+    for (const auto& [memory, size] : blocks) {
+        if (size == 0) {
+            continue;
+        }
+        if (size != vma->second.size) {
+            // Leave the rest of the carved range Free for the next blocks
+            SplitVMA(vma, size);
+        }
+
+        VirtualMemoryArea& block_vma = vma->second;
+        block_vma.type = VMAType::BackingMemory;
+        block_vma.permissions = perms;
+        block_vma.meminfo_state = state;
+        block_vma.backing_memory = memory;
+        UpdatePageTableForVMA(block_vma, false);
+        vma = std::next(MergeAdjacent(vma));
+    }
+
+    NotifyMemoryChanged();
+    return ResultSuccess;
+}
+
 } // namespace Kernel
@@ -109,7 +109,10 @@ public:
     explicit VMManager(Kernel::KernelSystem& kernel, Kernel::Process& proc);
     ~VMManager();
 
-    /// Finds the VMA in which the given address is included in, or `vma_map.end()`.
+    /**
+     * Finds the VMA in which the given address is included in, or `vma_map.end()`.
+     * The last VMA found is remembered, as consecutive lookups tend to hit the same region.
+     */
     VMAHandle FindVMA(VAddr target) const;
 
     /**
@@ -165,6 +168,18 @@ public:
     using BackingBlocks = std::vector<std::pair<u8*, u32>>;
     ResultVal<BackingBlocks> GetBackingBlocksForRange(VAddr address, u32 size);
 
+    /**
+     * Maps a list of host memory blocks back to back, starting at a given address. This is
+     * equivalent to mapping and reprotecting each block in turn, but only carves the range once.
+     *
+     * @param target The guest address to start the mapping at.
+     * @param blocks The memory blocks to be mapped.
+     * @param state MemoryState tag to attach to the VMAs.
+     * @param perms VMAPermission to give to the VMAs.
+     */
+    Result MapBackingMemoryBlocks(VAddr target, const BackingBlocks& blocks, MemoryState state,
+                                  VMAPermission perms);
+
     /// Each VMManager has its own page table, which is set as the main one when the owning process
     /// is scheduled.
     std::shared_ptr<Memory::PageTable> page_table;
@@ -207,10 +222,22 @@ private:
      */
     VMAIter MergeAdjacent(VMAIter vma);
 
-    /// Updates the pages corresponding to this VMA so they match the VMA's attributes.
-    void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
+    /// Removes the given VMA from the map, forgetting it if it was the last one found.
+    void EraseVMA(VMAIter vma);
+
+    /**
+     * Updates the pages corresponding to this VMA so they match the VMA's attributes.
+     * @param notify Whether to notify the plugin loader, batch operations only notify it once.
+     */
+    void UpdatePageTableForVMA(const VirtualMemoryArea& vma, bool notify = true);
+
+    /// Informs the plugin loader that the memory layout of the process changed.
+    void NotifyMemoryChanged();
 
     Kernel::KernelSystem& kernel;
     Kernel::Process& process;
+
+    /// The VMA returned by the last lookup, or `vma_map.end()`.
+    mutable VMAHandle last_vma;
 };
 } // namespace Kernel
@@ -68,7 +68,7 @@ private:
 template <>
 inline std::shared_ptr<WaitObject> DynamicObjectCast<WaitObject>(std::shared_ptr<Object> object) {
     if (object != nullptr && object->IsWaitable()) {
-        return std::static_pointer_cast<WaitObject>(object);
+        return std::static_pointer_cast<WaitObject>(std::move(object));
     }
     return nullptr;
 }
@@ -3,17 +3,27 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
+#include <cryptopp/sha.h>
 #include <fmt/format.h>
 #include "common/alignment.h"
 
 #include "common/common_paths.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/polyfill_thread.h"
+#include "common/scope_exit.h"
 #include "common/string_util.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/ncch_container.h"
@@ -109,6 +119,7 @@ u32 CTCert::GetDeviceID() const {
 class CIAFile::DecryptionState {
 public:
     std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> content;
+    std::vector<CryptoPP::SHA256> hash;
 };
 
 CIAFile::CIAFile(Core::System& system_, Service::FS::MediaType media_type)
@@ -211,6 +222,11 @@ Result CIAFile::WriteTitleMetadata() {
                  "Title has no encrypted content, skipping initializing decryption state.");
     }
 
+    if (verify_content_hashes) {
+        decryption_state->hash.clear();
+        decryption_state->hash.resize(content_count);
+    }
+
     install_state = CIAInstallState::TMDLoaded;
 
     return ResultSuccess;
@@ -256,6 +272,21 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
             content_written[i] += available_to_write;
             LOG_DEBUG(Service_AM, "Wrote {:x} to content {}, total {:x}", available_to_write, i,
                       content_written[i]);
+
+            if (verify_content_hashes) {
+                auto& hash = decryption_state->hash[i];
+                hash.Update(temp.data(), temp.size());
+                if (content_written[i] == size) {
+                    std::array<u8, CryptoPP::SHA256::DIGESTSIZE> digest;
+                    hash.Final(digest.data());
+                    if (digest != tmd.GetContentHashByIndex(i)) {
+                        LOG_ERROR(Service_AM, "Content {} does not match its hash in the TMD.", i);
+                        // TODO: Correct result code.
+                        return Result{ErrCodes::InvalidCIAHeader, ErrorModule::AM,
+                                      ErrorSummary::InvalidArgument, ErrorLevel::Permanent};
+                    }
+                }
+            }
         }
     }
 
@@ -443,6 +474,59 @@ bool TicketFile::Close() const {
 
 void TicketFile::Flush() const {}
 
+namespace {
+
+constexpr std::size_t CIAReadBlockSize = 1024 * 1024;
+constexpr std::size_t CIAReadAheadBlocks = 8;
+
+/// Reads a file in blocks on a separate thread, staying a bounded number of blocks ahead of the
+/// consumer so that reading overlaps decrypting, hashing and writing the previous blocks.
+class CIABlockReader {
+public:
+    explicit CIABlockReader(FileUtil::IOFile& file_) : file{file_} {
+        thread = std::jthread([this](std::stop_token stop_token) { ReadThread(stop_token); });
+    }
+
+    /// Returns the next block of the file, empty at the end of the file or on a read error
+    std::vector<u8> Next() {
+        std::unique_lock lock{mutex};
+        block_ready.wait(lock, [this] { return !blocks.empty(); });
+        std::vector<u8> block = std::move(blocks.front());
+        blocks.pop_front();
+        block_taken.notify_one();
+        return block;
+    }
+
+private:
+    void ReadThread(std::stop_token stop_token) {
+        Common::SetCurrentThreadName("CIABlockReader");
+        bool end = false;
+        while (!end) {
+            std::vector<u8> block(CIAReadBlockSize);
+            block.resize(file.ReadBytes(block.data(), block.size()));
+            end = block.empty();
+
+            std::unique_lock lock{mutex};
+            Common::CondvarWait(block_taken, lock, stop_token,
+                                [this] { return blocks.size() < CIAReadAheadBlocks; });
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            blocks.push_back(std::move(block));
+            block_ready.notify_one();
+        }
+    }
+
+    FileUtil::IOFile& file;
+    std::mutex mutex;
+    std::condition_variable block_ready;
+    std::condition_variable_any block_taken;
+    std::deque<std::vector<u8>> blocks;
+    std::jthread thread; ///< Declared last so it stops before the rest goes
+};
+
+} // Anonymous namespace
+
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback) {
     LOG_INFO(Service_AM, "Installing {}...", path);
@@ -471,13 +555,18 @@ InstallStatus InstallCIA(const std::string& path,
             return InstallStatus::ErrorFailedToOpenFile;
         }
 
-        std::array<u8, 0x10000> buffer;
         auto file_size = file.GetSize();
         std::size_t total_bytes_read = 0;
+        CIABlockReader reader{file};
         while (total_bytes_read != file_size) {
-            std::size_t bytes_read = file.ReadBytes(buffer.data(), buffer.size());
+            const std::vector<u8> block = reader.Next();
+            if (block.empty()) {
+                LOG_ERROR(Service_AM, "Could not read CIA file '{}'.", path);
+                return InstallStatus::ErrorAborted;
+            }
+            const std::size_t bytes_read = block.size();
             auto result = installFile.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                            static_cast<u8*>(buffer.data()));
+                                            block.data());
 
             if (update_callback) {
                 update_callback(total_bytes_read, file_size);
@@ -530,10 +619,68 @@ InstallStatus InstallCIA(const std::string& path,
     return InstallStatus::ErrorInvalid;
 }
 
+void InstallCIAs(std::span<const std::string> paths,
+                 std::function<ReportCallback>&& report_callback,
+                 std::function<ProgressCallback>&& update_callback) {
+    // CIAs of the same title would write the same files, so they are installed one after another
+    // by the same thread. Invalid CIAs get a group of their own and fail in InstallCIA.
+    std::map<u64, std::vector<std::size_t>> title_groups;
+    std::vector<std::vector<std::size_t>> groups;
+    std::size_t total_size = 0;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        total_size += FileUtil::GetSize(paths[i]);
+        FileSys::CIAContainer container;
+        if (container.Load(paths[i]) == Loader::ResultStatus::Success) {
+            title_groups[container.GetTitleMetadata().GetTitleID()].push_back(i);
+        } else {
+            groups.push_back({i});
+        }
+    }
+    for (auto& [title_id, group] : title_groups) {
+        groups.push_back(std::move(group));
+    }
+
+    std::mutex callback_mutex;
+    std::size_t total_written = 0;
+    std::atomic<std::size_t> next_group = 0;
+    const auto install_groups = [&] {
+        for (std::size_t group = next_group++; group < groups.size(); group = next_group++) {
+            for (const std::size_t index : groups[group]) {
+                std::size_t written = 0;
+                const auto status = InstallCIA(paths[index], [&](std::size_t current, std::size_t) {
+                    std::scoped_lock lock{callback_mutex};
+                    total_written += current - written;
+                    written = current;
+                    if (update_callback) {
+                        update_callback(total_written, total_size);
+                    }
+                });
+
+                std::scoped_lock lock{callback_mutex};
+                // Count the whole file, also when the install stopped early
+                total_written += FileUtil::GetSize(paths[index]) - written;
+                if (report_callback) {
+                    report_callback(index, status);
+                }
+            }
+        }
+    };
+
+    // Installing is mostly bound by the disk, so a few threads are enough to keep it busy
+    const std::size_t num_workers = std::min<std::size_t>(
+        groups.size(), std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U));
+    std::vector<std::jthread> workers;
+    for (std::size_t i = 1; i < num_workers; ++i) {
+        workers.emplace_back(install_groups);
+    }
+    install_groups();
+}
+
 InstallStatus InstallFromNus(Core::System& system, u64 title_id, int version) {
     LOG_DEBUG(Service_AM, "Downloading {:X}", title_id);
 
     CIAFile install_file{system, GetTitleMediaType(title_id)};
+    install_file.SetVerifyContentHashes(true);
 
     std::string path = fmt::format("/ccs/download/{:016X}/tmd", title_id);
     if (version != -1) {
@@ -554,19 +701,7 @@ InstallStatus InstallFromNus(Core::System& system, u64 title_id, int version) {
         return InstallStatus::ErrorFileNotFound;
     }
 
-    std::vector<u8> content;
     const auto content_count = tmd.GetContentCount();
-    for (std::size_t i = 0; i < content_count; ++i) {
-        const std::string filename = fmt::format("{:08x}", tmd.GetContentIDByIndex(i));
-        path = fmt::format("/ccs/download/{:016X}/{}", title_id, filename);
-        const auto temp_response = Core::NUS::Download(path);
-        if (!temp_response) {
-            LOG_ERROR(Service_AM, "Failed to download content for {:016X}", title_id);
-            return InstallStatus::ErrorFileNotFound;
-        }
-        content.insert(content.end(), temp_response->begin(), temp_response->end());
-    }
-
     FileSys::CIAContainer::Header fake_header{
         .header_size = sizeof(FileSys::CIAContainer::Header),
         .type = 0,
@@ -612,9 +747,45 @@ InstallStatus InstallFromNus(Core::System& system, u64 title_id, int version) {
         return result;
     }
 
-    result = write_to_cia_file_aligned(content);
-    if (result != InstallStatus::Success) {
-        return result;
+    // Contents are downloaded to disk and then streamed into the CIA file, which checks their
+    // hashes as they are written, so a whole title is never held in memory
+    const std::string download_dir = fmt::format(
+        "{}nus/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), title_id);
+    if (!FileUtil::CreateFullPath(download_dir)) {
+        LOG_ERROR(Service_AM, "Could not create {}", download_dir);
+        return InstallStatus::ErrorFailedToOpenFile;
+    }
+    SCOPE_EXIT({ FileUtil::DeleteDirRecursively(download_dir); });
+
+    std::vector<u8> chunk(1024 * 1024);
+    for (std::size_t i = 0; i < content_count; ++i) {
+        const std::string filename = fmt::format("{:08x}", tmd.GetContentIDByIndex(i));
+        path = fmt::format("/ccs/download/{:016X}/{}", title_id, filename);
+        const std::string file_path = download_dir + filename;
+        const u64 size = tmd.GetContentSizeByIndex(i);
+        if (!Core::NUS::DownloadToFile(path, file_path, size)) {
+            LOG_ERROR(Service_AM, "Failed to download content for {:016X}", title_id);
+            return InstallStatus::ErrorFileNotFound;
+        }
+
+        FileUtil::IOFile file(file_path, "rb");
+        for (u64 remaining = size; remaining > 0;) {
+            const std::size_t length =
+                static_cast<std::size_t>(std::min<u64>(remaining, chunk.size()));
+            if (file.ReadBytes(chunk.data(), length) != length) {
+                LOG_ERROR(Service_AM, "Could not read downloaded content {}", file_path);
+                return InstallStatus::ErrorFailedToOpenFile;
+            }
+            const auto write_result =
+                install_file.Write(current_offset, length, true, chunk.data());
+            if (write_result.Failed()) {
+                LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
+                          write_result.Code().raw);
+                return InstallStatus::ErrorAborted;
+            }
+            current_offset += length;
+            remaining -= length;
+        }
     }
     return InstallStatus::Success;
 }
@@ -793,6 +964,14 @@ void Module::ScanForAllTitles() {
     ScanForTitles(Service::FS::MediaType::SDMC);
 }
 
+const std::array<std::vector<u64_le>, 3>& Module::GetTitleLists() {
+    if (!title_lists_scanned) {
+        ScanForAllTitles();
+        title_lists_scanned = true;
+    }
+    return am_title_list;
+}
+
 Module::Interface::Interface(std::shared_ptr<Module> am, const char* name, u32 max_session)
     : ServiceFramework(name, max_session), am(std::move(am)) {}
 
@@ -804,7 +983,7 @@ void Module::Interface::GetNumPrograms(Kernel::HLERequestContext& ctx) {
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
     rb.Push(ResultSuccess);
-    rb.Push<u32>(static_cast<u32>(am->am_title_list[media_type].size()));
+    rb.Push<u32>(static_cast<u32>(am->GetTitleLists()[media_type].size()));
 }
 
 void Module::Interface::FindDLCContentInfos(Kernel::HLERequestContext& ctx) {
@@ -954,10 +1133,11 @@ void Module::Interface::GetProgramList(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    u32 media_count = static_cast<u32>(am->am_title_list[media_type].size());
+    const auto& title_list = am->GetTitleLists()[media_type];
+    u32 media_count = static_cast<u32>(title_list.size());
     u32 copied = std::min(media_count, count);
 
-    title_ids_output.Write(am->am_title_list[media_type].data(), 0, copied * sizeof(u64));
+    title_ids_output.Write(title_list.data(), 0, copied * sizeof(u64));
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
     rb.Push(ResultSuccess);
@@ -1037,7 +1217,7 @@ void Module::Interface::DeleteUserProgram(Kernel::HLERequestContext& ctx) {
         return;
     }
     bool success = FileUtil::DeleteDirRecursively(path);
-    am->ScanForAllTitles();
+    am->InvalidateTitleLists();
     rb.Push(ResultSuccess);
     if (!success)
         LOG_ERROR(Service_AM, "FileUtil::DeleteDirRecursively unexpectedly failed");
@@ -1206,7 +1386,7 @@ void Module::Interface::GetNumTickets(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
 
     u32 ticket_count = 0;
-    for (const auto& title_list : am->am_title_list) {
+    for (const auto& title_list : am->GetTitleLists()) {
         ticket_count += static_cast<u32>(title_list.size());
     }
 
@@ -1223,7 +1403,7 @@ void Module::Interface::GetTicketList(Kernel::HLERequestContext& ctx) {
     auto& ticket_tids_out = rp.PopMappedBuffer();
 
     u32 tickets_written = 0;
-    for (const auto& title_list : am->am_title_list) {
+    for (const auto& title_list : am->GetTitleLists()) {
         const auto tickets_to_write =
             std::min(static_cast<u32>(title_list.size()), ticket_list_count - tickets_written);
         ticket_tids_out.Write(title_list.data(), tickets_written * sizeof(u64),
@@ -1415,7 +1595,7 @@ void Module::Interface::EndImportProgram(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
     [[maybe_unused]] const auto cia = rp.PopObject<Kernel::ClientSession>();
 
-    am->ScanForAllTitles();
+    am->InvalidateTitleLists();
 
     am->cia_installing = false;
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1428,7 +1608,7 @@ void Module::Interface::EndImportProgramWithoutCommit(Kernel::HLERequestContext&
 
     // Note: This function is basically a no-op for us since we don't use title.db or ticket.db
     // files to keep track of installed titles.
-    am->ScanForAllTitles();
+    am->InvalidateTitleLists();
 
     am->cia_installing = false;
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1444,7 +1624,7 @@ void Module::Interface::CommitImportPrograms(Kernel::HLERequestContext& ctx) {
 
     // Note: This function is basically a no-op for us since we don't use title.db or ticket.db
     // files to keep track of installed titles.
-    am->ScanForAllTitles();
+    am->InvalidateTitleLists();
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(ResultSuccess);
@@ -1729,7 +1909,7 @@ void Module::Interface::DeleteProgram(Kernel::HLERequestContext& ctx) {
     LOG_INFO(Service_AM, "called, title={:016x}", title_id);
 
     const auto result = UninstallProgram(media_type, title_id);
-    am->ScanForAllTitles();
+    am->InvalidateTitleLists();
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(result);
@@ -1881,7 +2061,6 @@ CTCertLoadStatus Module::LoadCTCertFile(CTCert& output) {
 }
 
 Module::Module(Core::System& _system) : system(_system) {
-    ScanForAllTitles();
     LoadCTCertFile(ct_cert);
     system_updater_mutex = system.Kernel().CreateMutex(false, "AM::SystemUpdaterMutex");
 }
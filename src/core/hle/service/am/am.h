@@ -7,6 +7,7 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include "common/common_types.h"
@@ -99,6 +100,9 @@ constexpr u64 TWL_TITLE_ID_FLAG = 0x0000800000000000ULL;
 // Progress callback for InstallCIA, receives bytes written and total bytes
 using ProgressCallback = void(std::size_t, std::size_t);
 
+// Report callback for InstallCIAs, receives the index of the installed CIA and its install status
+using ReportCallback = void(std::size_t, InstallStatus);
+
 // A file handled returned for CIAs to be written into and subsequently installed.
 class CIAFile final : public FileSys::FileBackend {
 public:
@@ -116,6 +120,11 @@ public:
     bool Close() const override;
     void Flush() const override;
 
+    /// Makes the install fail if a content does not match its SHA-256 hash in the TMD
+    void SetVerifyContentHashes(bool verify) {
+        verify_content_hashes = verify;
+    }
+
 private:
     Core::System& system;
 
@@ -132,6 +141,7 @@ private:
     std::vector<u64> content_written;
     std::vector<FileUtil::IOFile> content_files;
     Service::FS::MediaType media_type;
+    bool verify_content_hashes = false;
 
     class DecryptionState;
     std::unique_ptr<DecryptionState> decryption_state;
@@ -165,6 +175,17 @@ private:
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback = nullptr);
 
+/**
+ * Installs multiple CIA files, several of them at once. CIAs of the same title are installed in
+ * the order they are given. The callbacks are called from the installing threads, one at a time.
+ * @param paths file paths of the CIA files to install
+ * @param report_callback callback function called once each CIA is installed or failed
+ * @param update_callback callback function called with the bytes written of all CIAs
+ */
+void InstallCIAs(std::span<const std::string> paths,
+                 std::function<ReportCallback>&& report_callback,
+                 std::function<ProgressCallback>&& update_callback = nullptr);
+
 /**
  * Downloads and installs title form the Nintendo Update Service.
  * @param title_id the title_id to download
@@ -777,8 +798,20 @@ private:
      */
     void ScanForAllTitles();
 
+    /**
+     * Gets the titles of every storage medium, scanning for them if they were not scanned since
+     * the last change. Scanning opens every installed title, so it is left until it is needed.
+     */
+    const std::array<std::vector<u64_le>, 3>& GetTitleLists();
+
+    /// Marks the title lists as outdated after titles were installed or removed.
+    void InvalidateTitleLists() {
+        title_lists_scanned = false;
+    }
+
     Core::System& system;
     bool cia_installing = false;
+    bool title_lists_scanned = false;
     std::array<std::vector<u64_le>, 3> am_title_list;
     std::shared_ptr<Kernel::Mutex> system_updater_mutex;
     CTCert ct_cert{};
@@ -1131,7 +1131,7 @@ void Module::APTInterface::GetProgramInfo(Kernel::HLERequestContext& ctx) {
     LOG_WARNING(Service_APT, "called title_id={:016X}, media_type={:02X}", title_id, media_type);
 
     std::string path = Service::AM::GetTitleContentPath(media_type, title_id);
-    auto loader = Loader::GetLoader(path);
+    auto loader = Loader::GetLoader(apt->system, path);
     if (!loader) {
         LOG_WARNING(Service_APT, "Could not find .app for title 0x{:016x}", title_id);
 
@@ -12,7 +12,7 @@ namespace Service::NS {
 std::shared_ptr<Kernel::Process> LaunchTitle(Core::System& system, FS::MediaType media_type,
                                              u64 title_id) {
     std::string path = AM::GetTitleContentPath(media_type, title_id);
-    auto loader = Loader::GetLoader(path);
+    auto loader = Loader::GetLoader(system, path);
 
     if (!loader) {
         LOG_WARNING(Service_NS, "Could not find .app for title 0x{:016x}", title_id);
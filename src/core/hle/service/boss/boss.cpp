@@ -9,9 +9,51 @@
 #include "core/hle/service/boss/boss.h"
 #include "core/hle/service/boss/boss_p.h"
 #include "core/hle/service/boss/boss_u.h"
+#include "core/hle/service/fs/archive.h"
 
 namespace Service::BOSS {
 
+/**
+ * Runs an operation on the SpotPass storage of online_service on the FS I/O threads, so that
+ * scanning the ext data does not stall the emulation thread. reply builds the response from the
+ * emulation thread once the operation has run.
+ */
+template <typename Operation, typename Reply>
+static void RunStorageOperation(Kernel::HLERequestContext& ctx, Core::System& system,
+                                const std::shared_ptr<OnlineService>& online_service,
+                                Operation operation, Reply reply) {
+    const u64 key = reinterpret_cast<std::uintptr_t>(online_service.get());
+    ctx.RunAsyncOn(
+        system.ArchiveManager().GetIoExecutor().Ordered(key),
+        [operation](Kernel::HLERequestContext& ctx) {
+            operation();
+            return static_cast<s64>(0);
+        },
+        reply);
+}
+
+void Module::Interface::ReplyNsDataIdList(Kernel::HLERequestContext& ctx,
+                                          std::shared_ptr<OnlineService> online_service,
+                                          u32 filter, u32 max_entries,
+                                          Kernel::MappedBuffer& buffer) {
+    const u16 command_id = static_cast<u16>(ctx.CommandBuffer()[0] >> 16);
+    auto entries = std::make_shared<std::vector<u32>>();
+    RunStorageOperation(
+        ctx, boss->system, online_service,
+        [online_service, entries, filter, max_entries] {
+            *entries = online_service->GetNsDataIdList(filter, max_entries);
+        },
+        [entries, command_id, &buffer](Kernel::HLERequestContext& ctx) {
+            buffer.Write(entries->data(), 0, sizeof(u32) * entries->size());
+
+            IPC::RequestBuilder rb(ctx, command_id, 3, 2);
+            rb.Push(ResultSuccess);
+            rb.Push<u16>(static_cast<u16>(entries->size())); /// Actual number of output entries
+            rb.Push<u16>(0); /// Last word-index copied to output in the internal NsDataId list.
+            rb.PushMappedBuffer(buffer);
+        });
+}
+
 std::shared_ptr<OnlineService> Module::Interface::GetSessionService(Kernel::HLERequestContext& ctx,
                                                                     IPC::RequestParser& rp) {
     const auto session_data = GetSessionData(ctx.Session());
@@ -243,13 +285,7 @@ void Module::Interface::GetNsDataIdList(Kernel::HLERequestContext& ctx) {
     if (online_service == nullptr) {
         return;
     }
-    const u16 entries_count = online_service->GetNsDataIdList(filter, max_entries, buffer);
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
-    rb.Push(ResultSuccess);
-    rb.Push<u16>(entries_count); /// Actual number of output entries
-    rb.Push<u16>(0);             /// Last word-index copied to output in the internal NsDataId list.
-    rb.PushMappedBuffer(buffer);
+    ReplyNsDataIdList(ctx, online_service, filter, max_entries, buffer);
 
     LOG_DEBUG(Service_BOSS,
               "filter={:#010x}, max_entries={:#010x}, "
@@ -269,13 +305,7 @@ void Module::Interface::GetNsDataIdList1(Kernel::HLERequestContext& ctx) {
     if (online_service == nullptr) {
         return;
     }
-    const u16 entries_count = online_service->GetNsDataIdList(filter, max_entries, buffer);
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
-    rb.Push(ResultSuccess);
-    rb.Push<u16>(entries_count); /// Actual number of output entries
-    rb.Push<u16>(0);             /// Last word-index copied to output in the internal NsDataId list.
-    rb.PushMappedBuffer(buffer);
+    ReplyNsDataIdList(ctx, online_service, filter, max_entries, buffer);
 
     LOG_DEBUG(Service_BOSS,
               "filter={:#010x}, max_entries={:#010x}, "
@@ -295,13 +325,7 @@ void Module::Interface::GetNsDataIdList2(Kernel::HLERequestContext& ctx) {
     if (online_service == nullptr) {
         return;
     }
-    const u16 entries_count = online_service->GetNsDataIdList(filter, max_entries, buffer);
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
-    rb.Push(ResultSuccess);
-    rb.Push<u16>(entries_count); /// Actual number of output entries
-    rb.Push<u16>(0);             /// Last word-index copied to output in the internal NsDataId list.
-    rb.PushMappedBuffer(buffer);
+    ReplyNsDataIdList(ctx, online_service, filter, max_entries, buffer);
 
     LOG_DEBUG(Service_BOSS,
               "filter={:#010x}, max_entries={:#010x}, "
@@ -321,13 +345,7 @@ void Module::Interface::GetNsDataIdList3(Kernel::HLERequestContext& ctx) {
     if (online_service == nullptr) {
         return;
     }
-    const u16 entries_count = online_service->GetNsDataIdList(filter, max_entries, buffer);
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
-    rb.Push(ResultSuccess);
-    rb.Push<u16>(entries_count); /// Actual number of output entries
-    rb.Push<u16>(0);             /// Last word-index copied to output in the internal NsDataId list.
-    rb.PushMappedBuffer(buffer);
+    ReplyNsDataIdList(ctx, online_service, filter, max_entries, buffer);
 
     LOG_DEBUG(Service_BOSS,
               "filter={:#010x}, max_entries={:#010x}, "
@@ -638,18 +656,28 @@ void Module::Interface::ReadNsData(Kernel::HLERequestContext& ctx) {
     if (online_service == nullptr) {
         return;
     }
-    const auto result = online_service->ReadNsData(ns_data_id, offset, size, buffer);
-
-    if (result.Succeeded()) {
-        IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
-        rb.Push(result.Code());
-        rb.Push<u32>(static_cast<u32>(result.Unwrap()));
-        rb.Push<u32>(0); /// unknown
-        rb.PushMappedBuffer(buffer);
-    } else {
-        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-        rb.Push(result.Code());
-    }
+    const u16 command_id = static_cast<u16>(ctx.CommandBuffer()[0] >> 16);
+    auto result = std::make_shared<ResultVal<std::vector<u8>>>(ResultUnknown);
+    RunStorageOperation(
+        ctx, boss->system, online_service,
+        [online_service, result, ns_data_id, offset, size] {
+            *result = online_service->ReadNsData(ns_data_id, offset, size);
+        },
+        [result, command_id, &buffer](Kernel::HLERequestContext& ctx) {
+            if (result->Succeeded()) {
+                const auto& data = result->Unwrap();
+                buffer.Write(data.data(), 0, data.size());
+
+                IPC::RequestBuilder rb(ctx, command_id, 3, 2);
+                rb.Push(result->Code());
+                rb.Push<u32>(static_cast<u32>(data.size()));
+                rb.Push<u32>(0); /// unknown
+                rb.PushMappedBuffer(buffer);
+            } else {
+                IPC::RequestBuilder rb(ctx, command_id, 1, 0);
+                rb.Push(result->Code());
+            }
+        });
 
     LOG_DEBUG(Service_BOSS, "called, ns_data_id={:#010x}, offset={:#018x}, size={:#010x}",
               ns_data_id, offset, size);
@@ -968,6 +968,12 @@ public:
 
         std::shared_ptr<OnlineService> GetSessionService(Kernel::HLERequestContext& ctx,
                                                          IPC::RequestParser& rp);
+
+        /// Lists the NsData of the session on the FS I/O threads and replies with the IDs, shared
+        /// by the GetNsDataIdList variants.
+        void ReplyNsDataIdList(Kernel::HLERequestContext& ctx,
+                               std::shared_ptr<OnlineService> online_service, u32 filter,
+                               u32 max_entries, Kernel::MappedBuffer& buffer);
     };
 
 private:
@@ -231,62 +231,78 @@ std::vector<NsDataEntry> OnlineService::GetNsDataEntries() {
         return {};
     }
 
+    std::scoped_lock lock{ns_data_mutex};
+    std::map<std::string, NsDataIndexEntry> index;
     std::vector<NsDataEntry> ns_data;
     const auto boss_files = GetBossExtDataFiles(boss_archive.get());
     for (const auto& current_file : boss_files) {
-        constexpr u32 boss_header_length = 0x34;
-        if (current_file.is_directory || current_file.file_size < boss_header_length) {
-            LOG_WARNING(Service_BOSS,
-                        "SpotPass extdata contains directory or file is too short: '{}'",
-                        Common::UTF16ToUTF8(current_file.filename));
-            continue;
+        std::string filename = Common::UTF16ToUTF8(current_file.filename);
+        const auto it = ns_data_index.find(filename);
+        auto& index_entry = index[filename];
+        if (it != ns_data_index.end() && it->second.file_size == current_file.file_size) {
+            index_entry = std::move(it->second);
+        } else {
+            index_entry.file_size = current_file.file_size;
+            index_entry.entry = ReadNsDataEntry(boss_archive.get(), current_file);
+        }
+        if (index_entry.entry) {
+            ns_data.push_back(*index_entry.entry);
         }
+    }
+    ns_data_index = std::move(index);
 
-        FileSys::Mode mode{};
-        mode.read_flag.Assign(1);
+    return ns_data;
+}
 
-        NsDataEntry entry{.filename = Common::UTF16ToUTF8(current_file.filename)};
-        auto file_result = boss_archive->OpenFile("/" + entry.filename, mode);
-        if (!file_result.Succeeded()) {
-            LOG_WARNING(Service_BOSS, "Opening SpotPass file failed.");
-            continue;
-        }
+std::optional<NsDataEntry> OnlineService::ReadNsDataEntry(FileSys::ArchiveBackend* boss_archive,
+                                                          const FileSys::Entry& current_file) {
+    constexpr u32 boss_header_length = 0x34;
+    if (current_file.is_directory || current_file.file_size < boss_header_length) {
+        LOG_WARNING(Service_BOSS, "SpotPass extdata contains directory or file is too short: '{}'",
+                    Common::UTF16ToUTF8(current_file.filename));
+        return std::nullopt;
+    }
 
-        auto file = std::move(file_result).Unwrap();
-        file->Read(0, boss_header_length, reinterpret_cast<u8*>(&entry.header));
-        if (entry.header.header_length != BOSS_EXTDATA_HEADER_LENGTH) {
-            LOG_WARNING(
-                Service_BOSS,
-                "Incorrect header length or non-SpotPass file; expected {:#010x}, found {:#010x}",
-                BOSS_EXTDATA_HEADER_LENGTH, entry.header.header_length);
-            continue;
-        }
+    FileSys::Mode mode{};
+    mode.read_flag.Assign(1);
 
-        if (entry.header.program_id != program_id) {
-            LOG_WARNING(Service_BOSS,
-                        "Mismatched program ID in SpotPass data. Was expecting "
-                        "{:#018x}, found {:#018x}",
-                        program_id, static_cast<u64>(entry.header.program_id));
-            continue;
-        }
+    NsDataEntry entry{.filename = Common::UTF16ToUTF8(current_file.filename)};
+    auto file_result = boss_archive->OpenFile("/" + entry.filename, mode);
+    if (!file_result.Succeeded()) {
+        LOG_WARNING(Service_BOSS, "Opening SpotPass file failed.");
+        return std::nullopt;
+    }
 
-        // Check the payload size is correct, excluding header
-        if (entry.header.payload_size != (current_file.file_size - boss_header_length)) {
-            LOG_WARNING(Service_BOSS,
-                        "Mismatched file size, was expecting {:#010x}, found {:#010x}",
-                        static_cast<u32>(entry.header.payload_size),
-                        current_file.file_size - boss_header_length);
-            continue;
-        }
+    auto file = std::move(file_result).Unwrap();
+    file->Read(0, boss_header_length, reinterpret_cast<u8*>(&entry.header));
+    if (entry.header.header_length != BOSS_EXTDATA_HEADER_LENGTH) {
+        LOG_WARNING(
+            Service_BOSS,
+            "Incorrect header length or non-SpotPass file; expected {:#010x}, found {:#010x}",
+            BOSS_EXTDATA_HEADER_LENGTH, entry.header.header_length);
+        return std::nullopt;
+    }
 
-        ns_data.push_back(entry);
+    if (entry.header.program_id != program_id) {
+        LOG_WARNING(Service_BOSS,
+                    "Mismatched program ID in SpotPass data. Was expecting "
+                    "{:#018x}, found {:#018x}",
+                    program_id, static_cast<u64>(entry.header.program_id));
+        return std::nullopt;
     }
 
-    return ns_data;
+    // Check the payload size is correct, excluding header
+    if (entry.header.payload_size != (current_file.file_size - boss_header_length)) {
+        LOG_WARNING(Service_BOSS, "Mismatched file size, was expecting {:#010x}, found {:#010x}",
+                    static_cast<u32>(entry.header.payload_size),
+                    current_file.file_size - boss_header_length);
+        return std::nullopt;
+    }
+
+    return entry;
 }
 
-u16 OnlineService::GetNsDataIdList(const u32 filter, const u32 max_entries,
-                                   Kernel::MappedBuffer& buffer) {
+std::vector<u32> OnlineService::GetNsDataIdList(const u32 filter, const u32 max_entries) {
     std::vector<NsDataEntry> ns_data = GetNsDataEntries();
     std::vector<u32> output_entries;
     for (const auto& current_entry : ns_data) {
@@ -308,8 +324,7 @@ u16 OnlineService::GetNsDataIdList(const u32 filter, const u32 max_entries,
         output_entries.push_back(current_entry.header.ns_data_id);
     }
 
-    buffer.Write(output_entries.data(), 0, sizeof(u32) * output_entries.size());
-    return static_cast<u16>(output_entries.size());
+    return output_entries;
 }
 
 std::optional<NsDataEntry> OnlineService::GetNsDataEntryFromId(const u32 ns_data_id) {
@@ -388,8 +403,8 @@ Result OnlineService::GetNsDataHeaderInfo(const u32 ns_data_id, const NsDataHead
     }
 }
 
-ResultVal<std::size_t> OnlineService::ReadNsData(const u32 ns_data_id, const u64 offset,
-                                                 const u32 size, Kernel::MappedBuffer& buffer) {
+ResultVal<std::vector<u8>> OnlineService::ReadNsData(const u32 ns_data_id, const u64 offset,
+                                                     const u32 size) {
     std::optional<NsDataEntry> entry = GetNsDataEntryFromId(ns_data_id);
     if (!entry.has_value()) {
         LOG_WARNING(Service_BOSS, "Failed to find NsData entry for ID {:#010X}", ns_data_id);
@@ -431,8 +446,8 @@ ResultVal<std::size_t> OnlineService::ReadNsData(const u32 ns_data_id, const u64
         return ResultUnknown;
     }
 
-    buffer.Write(ns_data_array.data(), 0, size);
-    return read_result;
+    ns_data_array.resize(read_result.Unwrap());
+    return ns_data_array;
 }
 
 template <class... Ts>
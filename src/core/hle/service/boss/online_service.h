@@ -5,6 +5,8 @@
 #pragma once
 
 #include <map>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -181,12 +183,13 @@ public:
     void RegisterTask(const u32 size, Kernel::MappedBuffer& buffer);
     Result UnregisterTask(const u32 size, Kernel::MappedBuffer& buffer);
     void GetTaskIdList();
-    u16 GetNsDataIdList(const u32 filter, const u32 max_entries, Kernel::MappedBuffer& buffer);
+    /// Returns the IDs of the NsData matching filter. Safe to call from the FS I/O threads.
+    std::vector<u32> GetNsDataIdList(const u32 filter, const u32 max_entries);
     std::optional<NsDataEntry> GetNsDataEntryFromId(const u32 ns_data_id);
     Result GetNsDataHeaderInfo(const u32 ns_data_id, const NsDataHeaderInfoType type,
                                const u32 size, Kernel::MappedBuffer& buffer);
-    ResultVal<std::size_t> ReadNsData(const u32 ns_data_id, const u64 offset, const u32 size,
-                                      Kernel::MappedBuffer& buffer);
+    /// Reads the payload of an NsData. Safe to call from the FS I/O threads.
+    ResultVal<std::vector<u8>> ReadNsData(const u32 ns_data_id, const u64 offset, const u32 size);
     Result SendProperty(const u16 id, const u32 size, Kernel::MappedBuffer& buffer);
     Result ReceiveProperty(const u16 id, const u32 size, Kernel::MappedBuffer& buffer);
 
@@ -195,6 +198,18 @@ private:
     std::vector<FileSys::Entry> GetBossExtDataFiles(FileSys::ArchiveBackend* boss_archive);
     FileSys::Path GetBossDataDir();
     std::vector<NsDataEntry> GetNsDataEntries();
+    std::optional<NsDataEntry> ReadNsDataEntry(FileSys::ArchiveBackend* boss_archive,
+                                               const FileSys::Entry& current_file);
+
+    /// Header of an ext data file as of the last scan, std::nullopt if it is not SpotPass data
+    struct NsDataIndexEntry {
+        u64 file_size;
+        std::optional<NsDataEntry> entry;
+    };
+
+    /// Headers of the ext data files by name. Files are only read again when their size changes.
+    std::map<std::string, NsDataIndexEntry> ns_data_index;
+    std::mutex ns_data_mutex;
 
     BossTaskProperties current_props;
     std::map<std::string, BossTaskProperties> task_id_list;
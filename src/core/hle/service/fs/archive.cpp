@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <system_error>
 #include <type_traits>
 #include <utility>
@@ -41,6 +42,7 @@ MediaType GetMediaTypeFromPath(std::string_view path) {
 }
 
 ArchiveBackend* ArchiveManager::GetArchive(ArchiveHandle handle) {
+    std::scoped_lock lock{handle_map_mutex};
     auto itr = handle_map.find(handle);
     return (itr == handle_map.end()) ? nullptr : itr->second.get();
 }
@@ -58,6 +60,7 @@ ResultVal<ArchiveHandle> ArchiveManager::OpenArchive(ArchiveIdCode id_code,
     CASCADE_RESULT(std::unique_ptr<ArchiveBackend> res,
                    itr->second->Open(archive_path, program_id));
 
+    std::scoped_lock lock{handle_map_mutex};
     // This should never even happen in the first place with 64-bit handles,
     while (handle_map.count(next_handle) != 0) {
         ++next_handle;
@@ -67,6 +70,10 @@ ResultVal<ArchiveHandle> ArchiveManager::OpenArchive(ArchiveIdCode id_code,
 }
 
 Result ArchiveManager::CloseArchive(ArchiveHandle handle) {
+    // Requests running on the I/O threads may still use the archive, renames even when it is not
+    // the archive they are keyed by.
+    io_executor.Wait();
+    std::scoped_lock lock{handle_map_mutex};
     if (handle_map.erase(handle) == 0)
         return FileSys::ResultInvalidArchiveHandle;
     else
@@ -197,7 +204,7 @@ ResultVal<std::shared_ptr<Directory>> ArchiveManager::OpenDirectoryFromArchive(
         return backend.Code();
     }
 
-    return std::make_shared<Directory>(std::move(backend).Unwrap(), path);
+    return std::make_shared<Directory>(std::move(backend).Unwrap(), path, io_executor);
 }
 
 ResultVal<u64> ArchiveManager::GetFreeBytesInArchive(ArchiveHandle archive_handle) {
@@ -5,12 +5,14 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <span>
 #include <string>
 #include <unordered_map>
 #include "common/common_types.h"
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/result.h"
+#include "core/hle/service/fs/async_io.h"
 #include "core/hle/service/fs/directory.h"
 #include "core/hle/service/fs/file.h"
 
@@ -255,6 +257,14 @@ public:
     /// Registers a new NCCH file with the SelfNCCH archive factory
     void RegisterSelfNCCH(Loader::AppLoader& app_loader);
 
+    /**
+     * Returns the executor that runs blocking archive operations off the emulation thread. The
+     * operations of an archive are keyed by its handle. Closing an archive waits for them.
+     */
+    AsyncIoExecutor& GetIoExecutor() {
+        return io_executor;
+    }
+
 private:
     Core::System& system;
 
@@ -281,7 +291,11 @@ private:
      * Map of active archive handles to archive objects
      */
     std::unordered_map<ArchiveHandle, std::unique_ptr<ArchiveBackend>> handle_map;
+    std::mutex handle_map_mutex; ///< Guards handle_map against lookups from the I/O threads
     ArchiveHandle next_handle = 1;
+
+    /// Declared last so that pending operations finish before the archives are destroyed
+    AsyncIoExecutor io_executor;
 };
 
 } // namespace Service::FS
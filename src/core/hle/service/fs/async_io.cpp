@@ -0,0 +1,38 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/hle/service/fs/async_io.h"
+
+namespace Service::FS {
+
+AsyncIoExecutor::AsyncIoExecutor(std::size_t num_threads) {
+    // Each key is bound to a single thread, which keeps the requests of a key in order.
+    workers.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; i++) {
+        workers.push_back(std::make_unique<Common::ThreadWorker>(1, "FS I/O"));
+    }
+}
+
+AsyncIoExecutor::~AsyncIoExecutor() {
+    Wait();
+}
+
+std::future<void> AsyncIoExecutor::Queue(u64 key, Common::UniqueFunction<void> work) {
+    std::packaged_task<void()> task{std::move(work)};
+    auto future = task.get_future();
+    WorkerFor(key).QueueWork(std::move(task));
+    return future;
+}
+
+void AsyncIoExecutor::Wait() {
+    for (auto& worker : workers) {
+        worker->WaitForRequests();
+    }
+}
+
+Common::ThreadWorker& AsyncIoExecutor::WorkerFor(u64 key) {
+    return *workers[key % workers.size()];
+}
+
+} // namespace Service::FS
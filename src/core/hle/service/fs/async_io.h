@@ -0,0 +1,45 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <future>
+#include <memory>
+#include <vector>
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "common/unique_function.h"
+
+namespace Service::FS {
+
+/**
+ * Runs the blocking host I/O of FS requests on a small pool of threads, so that the emulation
+ * thread does not stall on slow storage. Requests with the same key, usually the handle of the
+ * archive they operate on, run one at a time in the order they were queued.
+ */
+class AsyncIoExecutor {
+public:
+    explicit AsyncIoExecutor(std::size_t num_threads = 2);
+    ~AsyncIoExecutor();
+
+    /// Queues work behind the previous requests with the same key
+    std::future<void> Queue(u64 key, Common::UniqueFunction<void> work);
+
+    /// Returns an executor for Kernel::HLERequestContext::RunAsyncOn that queues with key
+    [[nodiscard]] auto Ordered(u64 key) {
+        return [this, key](Common::UniqueFunction<void> work) {
+            return Queue(key, std::move(work));
+        };
+    }
+
+    /// Blocks until all the requests queued so far have run
+    void Wait();
+
+private:
+    Common::ThreadWorker& WorkerFor(u64 key);
+
+    std::vector<std::unique_ptr<Common::ThreadWorker>> workers;
+};
+
+} // namespace Service::FS
@@ -2,16 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstdint>
+#include <memory>
+#include <vector>
 #include "common/logging/log.h"
 #include "core/file_sys/directory_backend.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/service/fs/async_io.h"
 #include "core/hle/service/fs/directory.h"
 
 namespace Service::FS {
 
 Directory::Directory(std::unique_ptr<FileSys::DirectoryBackend>&& backend,
-                     const FileSys::Path& path)
-    : ServiceFramework("", 1) {
+                     const FileSys::Path& path, AsyncIoExecutor& io_executor)
+    : ServiceFramework("", 1), io_executor{io_executor} {
     static const FunctionInfo functions[] = {
         // clang-format off
         {0x0801, &Directory::Read, "Read"},
@@ -23,22 +27,44 @@ Directory::Directory(std::unique_ptr<FileSys::DirectoryBackend>&& backend,
     this->path = path;
 }
 
-Directory::~Directory() {}
+Directory::~Directory() {
+    // A pending read may still be enumerating the backend.
+    io_executor.Wait();
+}
 
 void Directory::Read(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
     u32 count = rp.Pop<u32>();
     auto& buffer = rp.PopMappedBuffer();
-    std::vector<FileSys::Entry> entries(count);
     LOG_TRACE(Service_FS, "Read {}: count={}", GetName(), count);
-    // Number of entries actually read
-    u32 read = backend->Read(static_cast<u32>(entries.size()), entries.data());
-    buffer.Write(entries.data(), 0, read * sizeof(FileSys::Entry));
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-    rb.Push(ResultSuccess);
-    rb.Push(read);
-    rb.PushMappedBuffer(buffer);
+    struct AsyncData {
+        std::vector<FileSys::Entry> entries;
+        Kernel::MappedBuffer* buffer;
+        u32 read; ///< Number of entries actually read
+    };
+    auto async_data = std::make_shared<AsyncData>();
+    async_data->entries.resize(count);
+    async_data->buffer = &buffer;
+
+    // Enumerating a host directory can be slow, so it runs on the I/O threads and the reply is
+    // written back once it is done.
+    ctx.RunAsyncOn(
+        io_executor.Ordered(reinterpret_cast<std::uintptr_t>(this)),
+        [this, async_data](Kernel::HLERequestContext& ctx) {
+            async_data->read = backend->Read(static_cast<u32>(async_data->entries.size()),
+                                             async_data->entries.data());
+            return static_cast<s64>(0);
+        },
+        [async_data](Kernel::HLERequestContext& ctx) {
+            async_data->buffer->Write(async_data->entries.data(), 0,
+                                      async_data->read * sizeof(FileSys::Entry));
+
+            IPC::RequestBuilder rb(ctx, 0x0801, 2, 2);
+            rb.Push(ResultSuccess);
+            rb.Push(async_data->read);
+            rb.PushMappedBuffer(*async_data->buffer);
+        });
 }
 
 void Directory::Close(Kernel::HLERequestContext& ctx) {
@@ -10,9 +10,12 @@
 
 namespace Service::FS {
 
+class AsyncIoExecutor;
+
 class Directory final : public ServiceFramework<Directory> {
 public:
-    Directory(std::unique_ptr<FileSys::DirectoryBackend>&& backend, const FileSys::Path& path);
+    Directory(std::unique_ptr<FileSys::DirectoryBackend>&& backend, const FileSys::Path& path,
+              AsyncIoExecutor& io_executor);
     ~Directory();
 
     std::string GetName() const {
@@ -21,6 +24,7 @@ public:
 
     FileSys::Path path = "";                              ///< Path of the directory
     std::unique_ptr<FileSys::DirectoryBackend> backend{}; ///< File backend interface
+    AsyncIoExecutor& io_executor; ///< Executor enumerating the directory off the emulation thread
 
 protected:
     void Read(Kernel::HLERequestContext& ctx);
@@ -30,6 +30,27 @@ using Kernel::ServerSession;
 
 namespace Service::FS {
 
+/**
+ * Runs an archive operation on the I/O thread of archive_handle and replies to the request with
+ * the Result it returned, so that the emulation thread does not wait on host storage.
+ */
+template <typename Operation>
+static void RunArchiveOperation(Kernel::HLERequestContext& ctx, ArchiveManager& archives,
+                                u16 command_id, ArchiveHandle archive_handle,
+                                Operation operation) {
+    auto result = std::make_shared<Result>(ResultSuccess);
+    ctx.RunAsyncOn(
+        archives.GetIoExecutor().Ordered(archive_handle),
+        [result, operation](Kernel::HLERequestContext& ctx) {
+            *result = operation();
+            return static_cast<s64>(0);
+        },
+        [result, command_id](Kernel::HLERequestContext& ctx) {
+            IPC::RequestBuilder rb(ctx, command_id, 1, 0);
+            rb.Push(*result);
+        });
+}
+
 void FS_USER::Initialize(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
     u32 pid = rp.PopPID();
@@ -137,8 +158,9 @@ void FS_USER::DeleteFile(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_FS, "type={} size={} data={}", filename_type, filename_size,
               file_path.DebugStr());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(archives.DeleteFileFromArchive(archive_handle, file_path));
+    RunArchiveOperation(ctx, archives, 0x0804, archive_handle, [this, archive_handle, file_path] {
+        return archives.DeleteFileFromArchive(archive_handle, file_path);
+    });
 }
 
 void FS_USER::RenameFile(Kernel::HLERequestContext& ctx) {
@@ -164,9 +186,13 @@ void FS_USER::RenameFile(Kernel::HLERequestContext& ctx) {
               src_filename_type, src_filename_size, src_file_path.DebugStr(), dest_filename_type,
               dest_filename_size, dest_file_path.DebugStr());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(archives.RenameFileBetweenArchives(src_archive_handle, src_file_path,
-                                               dest_archive_handle, dest_file_path));
+    RunArchiveOperation(ctx, archives, 0x0805, src_archive_handle,
+                        [this, src_archive_handle, src_file_path, dest_archive_handle,
+                         dest_file_path] {
+                            return archives.RenameFileBetweenArchives(
+                                src_archive_handle, src_file_path, dest_archive_handle,
+                                dest_file_path);
+                        });
 }
 
 void FS_USER::DeleteDirectory(Kernel::HLERequestContext& ctx) {
@@ -184,8 +210,9 @@ void FS_USER::DeleteDirectory(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_FS, "type={} size={} data={}", dirname_type, dirname_size,
               dir_path.DebugStr());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(archives.DeleteDirectoryFromArchive(archive_handle, dir_path));
+    RunArchiveOperation(ctx, archives, 0x0806, archive_handle, [this, archive_handle, dir_path] {
+        return archives.DeleteDirectoryFromArchive(archive_handle, dir_path);
+    });
 }
 
 void FS_USER::DeleteDirectoryRecursively(Kernel::HLERequestContext& ctx) {
@@ -203,8 +230,9 @@ void FS_USER::DeleteDirectoryRecursively(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_FS, "type={} size={} data={}", dirname_type, dirname_size,
               dir_path.DebugStr());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(archives.DeleteDirectoryRecursivelyFromArchive(archive_handle, dir_path));
+    RunArchiveOperation(ctx, archives, 0x0807, archive_handle, [this, archive_handle, dir_path] {
+        return archives.DeleteDirectoryRecursivelyFromArchive(archive_handle, dir_path);
+    });
 }
 
 void FS_USER::CreateFile(Kernel::HLERequestContext& ctx) {
@@ -224,8 +252,11 @@ void FS_USER::CreateFile(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_FS, "type={} attributes={} size={:x} data={}", filename_type, attributes,
               file_size, file_path.DebugStr());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(archives.CreateFileInArchive(archive_handle, file_path, file_size));
+    RunArchiveOperation(ctx, archives, 0x0808, archive_handle,
+                        [this, archive_handle, file_path, file_size] {
+                            return archives.CreateFileInArchive(archive_handle, file_path,
+                                                                file_size);
+                        });
 }
 
 void FS_USER::CreateDirectory(Kernel::HLERequestContext& ctx) {
@@ -242,8 +273,9 @@ void FS_USER::CreateDirectory(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_FS, "type={} size={} data={}", dirname_type, dirname_size,
               dir_path.DebugStr());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(archives.CreateDirectoryFromArchive(archive_handle, dir_path));
+    RunArchiveOperation(ctx, archives, 0x0809, archive_handle, [this, archive_handle, dir_path] {
+        return archives.CreateDirectoryFromArchive(archive_handle, dir_path);
+    });
 }
 
 void FS_USER::RenameDirectory(Kernel::HLERequestContext& ctx) {
@@ -268,9 +300,13 @@ void FS_USER::RenameDirectory(Kernel::HLERequestContext& ctx) {
               src_dirname_type, src_dirname_size, src_dir_path.DebugStr(), dest_dirname_type,
               dest_dirname_size, dest_dir_path.DebugStr());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(archives.RenameDirectoryBetweenArchives(src_archive_handle, src_dir_path,
-                                                    dest_archive_handle, dest_dir_path));
+    RunArchiveOperation(ctx, archives, 0x080A, src_archive_handle,
+                        [this, src_archive_handle, src_dir_path, dest_archive_handle,
+                         dest_dir_path] {
+                            return archives.RenameDirectoryBetweenArchives(
+                                src_archive_handle, src_dir_path, dest_archive_handle,
+                                dest_dir_path);
+                        });
 }
 
 void FS_USER::OpenDirectory(Kernel::HLERequestContext& ctx) {
@@ -68,8 +68,7 @@ FrameBufferUpdate* GSP_GPU::GetFrameBufferInfo(u32 thread_id, u32 screen_index)
 }
 
 InterruptRelayQueue* GSP_GPU::GetInterruptRelayQueue(u32 thread_id) {
-    u8* ptr = shared_memory->GetPointer(sizeof(InterruptRelayQueue) * thread_id);
-    return reinterpret_cast<InterruptRelayQueue*>(ptr);
+    return interrupt_relay_queues[thread_id];
 }
 
 void GSP_GPU::ClientDisconnected(std::shared_ptr<Kernel::ServerSession> server_session) {
@@ -295,6 +294,7 @@ void GSP_GPU::RegisterInterruptRelayQueue(Kernel::HLERequestContext& ctx) {
     SessionData* session_data = GetSessionData(ctx.Session());
     session_data->interrupt_event = std::move(interrupt_event);
     session_data->registered = true;
+    registered_threads[session_data->thread_id] = session_data;
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
 
@@ -318,6 +318,7 @@ void GSP_GPU::UnregisterInterruptRelayQueue(Kernel::HLERequestContext& ctx) {
     SessionData* session_data = GetSessionData(ctx.Session());
     session_data->interrupt_event = nullptr;
     session_data->registered = false;
+    registered_threads[session_data->thread_id] = nullptr;
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(ResultSuccess);
@@ -383,6 +384,15 @@ void GSP_GPU::SignalInterrupt(InterruptId interrupt_id) {
         return;
     }
 
+    // Applications handle every interrupt id once per wakeup, so repeated completion interrupts of
+    // a command batch carry no extra information and are signalled once after it.
+    if (coalescing_interrupts && (interrupt_id == InterruptId::PSC0 ||
+                                  interrupt_id == InterruptId::PSC1 ||
+                                  interrupt_id == InterruptId::P3D)) {
+        coalesced_interrupts |= 1U << static_cast<u32>(interrupt_id);
+        return;
+    }
+
     SignalInterruptForThread(interrupt_id, active_thread_id);
 }
 
@@ -401,18 +411,31 @@ void GSP_GPU::SetLcdForceBlack(Kernel::HLERequestContext& ctx) {
 void GSP_GPU::TriggerCmdReqQueue(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx);
 
-    // Iterate through each command.
+    // Process every pending command, starting from the current index like the GSP module does.
     auto* command_buffer = GetCommandBuffer(active_thread_id);
     auto& gpu = system.GPU();
-    for (u32 i = 0; i < command_buffer->number_commands; i++) {
-        gpu.Debugger().GXCommandProcessed(command_buffer->commands[i]);
+    const u32 num_commands = command_buffer->number_commands;
+    coalescing_interrupts = true;
+    coalesced_interrupts = 0;
+    for (u32 i = 0; i < num_commands; i++) {
+        const u32 index = command_buffer->index;
+        auto& command = command_buffer->commands[index % std::size(command_buffer->commands)];
+        gpu.Debugger().GXCommandProcessed(command);
 
         // Decode and execute command
-        gpu.Execute(command_buffer->commands[i]);
+        gpu.Execute(command);
 
         // Indicates that command has completed
+        command_buffer->index.Assign((index + 1) % std::size(command_buffer->commands));
         command_buffer->number_commands.Assign(command_buffer->number_commands - 1);
     }
+    coalescing_interrupts = false;
+
+    for (const auto interrupt_id : {InterruptId::PSC0, InterruptId::PSC1, InterruptId::P3D}) {
+        if (coalesced_interrupts & (1U << static_cast<u32>(interrupt_id))) {
+            SignalInterrupt(interrupt_id);
+        }
+    }
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(ResultSuccess);
@@ -654,14 +677,7 @@ void GSP_GPU::SetInternalPriorities(Kernel::HLERequestContext& ctx) {
 }
 
 SessionData* GSP_GPU::FindRegisteredThreadData(u32 thread_id) {
-    for (auto& session_info : connected_sessions) {
-        SessionData* data = static_cast<SessionData*>(session_info.data.get());
-        if (!data->registered)
-            continue;
-        if (data->thread_id == thread_id)
-            return data;
-    }
-    return nullptr;
+    return thread_id < MaxGSPThreads ? registered_threads[thread_id] : nullptr;
 }
 
 GSP_GPU::GSP_GPU(Core::System& system) : ServiceFramework("gsp::Gpu", 4), system(system) {
@@ -708,6 +724,10 @@ GSP_GPU::GSP_GPU(Core::System& system) : ServiceFramework("gsp::Gpu", 4), system
                                             MemoryPermission::ReadWrite, 0,
                                             Kernel::MemoryRegion::BASE, "GSP:SharedMemory")
                         .Unwrap();
+    for (u32 thread_id = 0; thread_id < MaxGSPThreads; thread_id++) {
+        interrupt_relay_queues[thread_id] = reinterpret_cast<InterruptRelayQueue*>(
+            shared_memory->GetPointer(sizeof(InterruptRelayQueue) * thread_id));
+    }
 
     first_initialization = true;
 };
@@ -727,6 +747,9 @@ SessionData::SessionData(GSP_GPU* gsp) : gsp(gsp) {
 SessionData::~SessionData() {
     // Free the thread id slot so that other sessions can use it.
     gsp->used_thread_ids[thread_id] = false;
+    if (gsp->registered_threads[thread_id] == this) {
+        gsp->registered_threads[thread_id] = nullptr;
+    }
 }
 
 } // namespace Service::GSP
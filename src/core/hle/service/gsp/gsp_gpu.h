@@ -383,6 +383,18 @@ private:
     /// Thread ids currently in use by the sessions connected to the GSPGPU service.
     std::array<bool, MaxGSPThreads> used_thread_ids{};
 
+    /// Sessions that registered an interrupt relay queue, indexed by thread id.
+    std::array<SessionData*, MaxGSPThreads> registered_threads{};
+
+    /// Interrupt relay queues in GSP shared memory, indexed by thread id.
+    std::array<InterruptRelayQueue*, MaxGSPThreads> interrupt_relay_queues{};
+
+    /// Whether interrupts are being collected while TriggerCmdReqQueue processes a command batch.
+    bool coalescing_interrupts = false;
+
+    /// Bitmask of the interrupt ids raised while coalescing.
+    u32 coalesced_interrupts = 0;
+
     friend class SessionData;
 };
 
@@ -3,10 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <numeric>
+#include <thread>
 
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "core/3ds.h"
 #include "core/core.h"
 #include "core/hle/ipc_helpers.h"
@@ -62,8 +65,6 @@ void Module::LoadInputDevices() {
                    buttons.begin(), Input::CreateDevice<Input::ButtonDevice>);
     circle_pad = Input::CreateDevice<Input::AnalogDevice>(
         Settings::values.current_input_profile.analogs[Settings::NativeAnalog::CirclePad]);
-    motion_device = Input::CreateDevice<Input::MotionDevice>(
-        Settings::values.current_input_profile.motion_device);
     touch_device = Input::CreateDevice<Input::TouchDevice>(
         Settings::values.current_input_profile.touch_device);
     if (Settings::values.current_input_profile.use_touch_from_button) {
@@ -73,31 +74,103 @@ void Module::LoadInputDevices() {
     }
 }
 
+void Module::LoadMotionDevice() {
+    motion_device = Input::CreateDevice<Input::MotionDevice>(
+        Settings::values.current_input_profile.motion_device);
+}
+
+static s64 GetInputTimestampUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void Module::InputThread(std::stop_token token) {
+    Common::SetCurrentThreadName("HID:Input");
+    while (!token.stop_requested()) {
+        if (is_device_reload_pending.exchange(false)) {
+            LoadInputDevices();
+        }
+
+        // Samples are dropped while the queue is full, which happens when emulation is paused
+        const InputSample sample = SampleInputDevices();
+        input_samples.Push(&sample, 1);
+        std::this_thread::sleep_for(input_sample_period);
+    }
+}
+
+Module::InputSample Module::SampleInputDevices() const {
+    InputSample sample{};
+    sample.timestamp_us = GetInputTimestampUs();
+    for (std::size_t i = 0; i < buttons.size(); ++i) {
+        sample.buttons |= static_cast<u32>(buttons[i]->GetStatus()) << i;
+    }
+    std::tie(sample.circle_pad_x, sample.circle_pad_y) = circle_pad->GetStatus();
+    std::tie(sample.touch_x, sample.touch_y, sample.touch_pressed) = touch_device->GetStatus();
+    if (!sample.touch_pressed && touch_btn_device) {
+        std::tie(sample.touch_x, sample.touch_y, sample.touch_pressed) =
+            touch_btn_device->GetStatus();
+    }
+    return sample;
+}
+
+Module::InputSample Module::ConsumeInputSamples() {
+    std::array<InputSample, 64> samples;
+    const std::size_t count = input_samples.Pop(samples.data(), samples.size());
+    const s64 oldest_timestamp_us = GetInputTimestampUs() - max_input_sample_age_us;
+
+    const InputSample previous = last_input_sample;
+    u32 pressed_buttons = 0;
+    const InputSample* touch_tap = nullptr;
+    for (std::size_t i = 0; i < count; ++i) {
+        const InputSample& sample = samples[i];
+        if (sample.timestamp_us < oldest_timestamp_us) {
+            continue;
+        }
+        pressed_buttons |= sample.buttons;
+        if (sample.touch_pressed && !touch_tap) {
+            touch_tap = &sample;
+        }
+        last_input_sample = sample;
+    }
+
+    // Presses shorter than the pad update interval are reported for one update instead of lost
+    InputSample result = last_input_sample;
+    result.buttons |= pressed_buttons & ~previous.buttons;
+    if (touch_tap && !result.touch_pressed && !previous.touch_pressed) {
+        result.touch_x = touch_tap->touch_x;
+        result.touch_y = touch_tap->touch_y;
+        result.touch_pressed = true;
+    }
+    return result;
+}
+
 void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
     SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
 
-    if (is_device_reload_pending.exchange(false))
-        LoadInputDevices();
-
+    const InputSample input = ConsumeInputSamples();
     using namespace Settings::NativeButton;
-    state.a.Assign(buttons[A - BUTTON_HID_BEGIN]->GetStatus());
-    state.b.Assign(buttons[B - BUTTON_HID_BEGIN]->GetStatus());
-    state.x.Assign(buttons[X - BUTTON_HID_BEGIN]->GetStatus());
-    state.y.Assign(buttons[Y - BUTTON_HID_BEGIN]->GetStatus());
-    state.right.Assign(buttons[Right - BUTTON_HID_BEGIN]->GetStatus());
-    state.left.Assign(buttons[Left - BUTTON_HID_BEGIN]->GetStatus());
-    state.up.Assign(buttons[Up - BUTTON_HID_BEGIN]->GetStatus());
-    state.down.Assign(buttons[Down - BUTTON_HID_BEGIN]->GetStatus());
-    state.l.Assign(buttons[L - BUTTON_HID_BEGIN]->GetStatus());
-    state.r.Assign(buttons[R - BUTTON_HID_BEGIN]->GetStatus());
-    state.start.Assign(buttons[Start - BUTTON_HID_BEGIN]->GetStatus());
-    state.select.Assign(buttons[Select - BUTTON_HID_BEGIN]->GetStatus());
-    state.debug.Assign(buttons[Debug - BUTTON_HID_BEGIN]->GetStatus());
-    state.gpio14.Assign(buttons[Gpio14 - BUTTON_HID_BEGIN]->GetStatus());
+    const auto is_pressed = [&input](int button) {
+        return (input.buttons >> (button - BUTTON_HID_BEGIN)) & 1;
+    };
+    state.a.Assign(is_pressed(A));
+    state.b.Assign(is_pressed(B));
+    state.x.Assign(is_pressed(X));
+    state.y.Assign(is_pressed(Y));
+    state.right.Assign(is_pressed(Right));
+    state.left.Assign(is_pressed(Left));
+    state.up.Assign(is_pressed(Up));
+    state.down.Assign(is_pressed(Down));
+    state.l.Assign(is_pressed(L));
+    state.r.Assign(is_pressed(R));
+    state.start.Assign(is_pressed(Start));
+    state.select.Assign(is_pressed(Select));
+    state.debug.Assign(is_pressed(Debug));
+    state.gpio14.Assign(is_pressed(Gpio14));
 
     // Get current circle pad position and update circle pad direction
-    float circle_pad_x_f, circle_pad_y_f;
-    std::tie(circle_pad_x_f, circle_pad_y_f) = circle_pad->GetStatus();
+    const float circle_pad_x_f = input.circle_pad_x;
+    const float circle_pad_y_f = input.circle_pad_y;
 
     // xperia64: 0x9A seems to be the calibrated limit of the circle pad
     // Verified by using Input Redirector with very large-value digital inputs
@@ -158,12 +231,9 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
 
     // Get the current touch entry
     TouchDataEntry& touch_entry = mem->touch.entries[mem->touch.index];
-    bool pressed = false;
-    float x, y;
-    std::tie(x, y, pressed) = touch_device->GetStatus();
-    if (!pressed && touch_btn_device) {
-        std::tie(x, y, pressed) = touch_btn_device->GetStatus();
-    }
+    const float x = input.touch_x;
+    const float y = input.touch_y;
+    const bool pressed = input.touch_pressed;
     touch_entry.x = static_cast<u16>(x * Core::kScreenBottomWidth);
     touch_entry.y = static_cast<u16>(y * Core::kScreenBottomHeight);
     touch_entry.valid.Assign(pressed ? 1 : 0);
@@ -186,9 +256,8 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
 
     // TODO(xperia64): How the 3D Slider is updated by the HID module needs to be RE'd
     // and possibly moved to its own Core::Timing event.
-    mem->pad.sliderstate_3d = (Settings::values.factor_3d.GetValue() / 100.0f);
-    system.Kernel().GetSharedPageHandler().Set3DSlider(Settings::values.factor_3d.GetValue() /
-                                                       100.0f);
+    mem->pad.sliderstate_3d = Settings::SliderState3D();
+    system.Kernel().GetSharedPageHandler().Set3DSlider(Settings::SliderState3D());
 
     // Reschedule recurrent event
     system.CoreTiming().ScheduleEvent(pad_update_ticks - cycles_late, pad_update_event);
@@ -197,6 +266,10 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
 void Module::UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_late) {
     SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
 
+    if (is_motion_reload_pending.exchange(false)) {
+        LoadMotionDevice();
+    }
+
     mem->accelerometer.index = next_accelerometer_index;
     next_accelerometer_index = (next_accelerometer_index + 1) % mem->accelerometer.entries.size();
 
@@ -242,6 +315,10 @@ void Module::UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_la
 void Module::UpdateGyroscopeCallback(std::uintptr_t user_data, s64 cycles_late) {
     SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
 
+    if (is_motion_reload_pending.exchange(false)) {
+        LoadMotionDevice();
+    }
+
     mem->gyroscope.index = next_gyroscope_index;
     next_gyroscope_index = (next_gyroscope_index + 1) % mem->gyroscope.entries.size();
 
@@ -421,10 +498,13 @@ Module::Module(Core::System& system) : system(system) {
         });
 
     timing.ScheduleEvent(pad_update_ticks, pad_update_event);
+
+    input_thread = std::jthread([this](std::stop_token token) { InputThread(token); });
 }
 
 void Module::ReloadInputDevices() {
     is_device_reload_pending.store(true);
+    is_motion_reload_pending.store(true);
 }
 
 const PadState& Module::GetState() const {
@@ -6,12 +6,15 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <memory>
 #include <vector>
 #include "common/bit_field.h"
 #include "common/common_funcs.h"
 #include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "common/ring_buffer.h"
 #include "common/settings.h"
 #include "core/core_timing.h"
 #include "core/frontend/input.h"
@@ -305,7 +308,28 @@ public:
     static constexpr u64 gyroscope_update_ticks = BASE_CLOCK_RATE_ARM11 / 101;
 
 private:
+    /// Button, circle pad and touch state sampled by the input thread
+    struct InputSample {
+        s64 timestamp_us; ///< Steady clock time of the sample in microseconds
+        u32 buttons;      ///< Bit i is set when buttons[i] is pressed
+        float circle_pad_x;
+        float circle_pad_y;
+        float touch_x;
+        float touch_y;
+        bool touch_pressed;
+    };
+
+    /// Rate at which the input thread samples the devices, several times the pad update rate
+    static constexpr std::chrono::microseconds input_sample_period{1000};
+    /// Samples older than this when the pad is updated were queued while emulation was paused
+    static constexpr s64 max_input_sample_age_us = 50000;
+
     void LoadInputDevices();
+    void LoadMotionDevice();
+    void InputThread(std::stop_token token);
+    InputSample SampleInputDevices() const;
+    /// Combines the samples queued since the last pad update into the state reported to the game
+    InputSample ConsumeInputSamples();
     void UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateGyroscopeCallback(std::uintptr_t user_data, s64 cycles_late);
@@ -346,13 +370,21 @@ private:
     Core::TimingEventType* accelerometer_update_event;
     Core::TimingEventType* gyroscope_update_event;
 
+    // The buttons, circle pad and touch devices are only used by the input thread, the motion
+    // device by the emulation thread.
     std::atomic<bool> is_device_reload_pending{true};
+    std::atomic<bool> is_motion_reload_pending{true};
     std::array<std::unique_ptr<Input::ButtonDevice>, Settings::NativeButton::NUM_BUTTONS_HID>
         buttons;
     std::unique_ptr<Input::AnalogDevice> circle_pad;
     std::unique_ptr<Input::MotionDevice> motion_device;
     std::unique_ptr<Input::TouchDevice> touch_device;
     std::unique_ptr<Input::TouchDevice> touch_btn_device;
+
+    Common::RingBuffer<InputSample, 64> input_samples;
+    /// Latest sample consumed by the emulation thread
+    InputSample last_input_sample{};
+    std::jthread input_thread;
 };
 
 std::shared_ptr<Module> GetModule(Core::System& system);
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
+#include <cstdlib>
 #include <tuple>
 #include <unordered_map>
 #include <boost/algorithm/string/replace.hpp>
@@ -11,6 +13,7 @@
 #include <fmt/format.h>
 
 #include "common/assert.h"
+#include "common/hash.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
 #include "core/core.h"
@@ -198,6 +201,113 @@ static void SerializeChunkedMultipartPostData(httplib::DataSink& sink,
     sink.os << httplib::detail::serialize_multipart_formdata_finish(boundary);
 }
 
+constexpr std::size_t MaxIdleConnectionsPerServer = 4;
+constexpr std::size_t MaxIdleConnections = 16;
+constexpr auto MaxConnectionIdleTime = std::chrono::seconds{30};
+constexpr std::size_t MaxCachedResponseSize = 1024 * 1024;
+constexpr std::size_t MaxCachedBytes = 8 * 1024 * 1024;
+
+// Returns for how long a response may be cached according to its Cache-Control and Age headers
+static std::chrono::seconds GetResponseFreshness(const httplib::Response& response) {
+    if (response.status != 200 || response.has_header("Set-Cookie") ||
+        response.has_header("Vary")) {
+        return {};
+    }
+
+    long long max_age = 0;
+    const std::string cache_control = Common::ToLower(response.get_header_value("Cache-Control"));
+    for (std::string directive : Common::SplitString(cache_control, ',')) {
+        directive.erase(0, directive.find_first_not_of(' '));
+        if (directive.starts_with("no-store") || directive.starts_with("no-cache")) {
+            return {};
+        }
+        if (directive.starts_with("max-age=")) {
+            max_age = std::strtoll(directive.c_str() + 8, nullptr, 10);
+        }
+    }
+
+    const long long age = std::strtoll(response.get_header_value("Age").c_str(), nullptr, 10);
+    return std::chrono::seconds{std::max(max_age - std::max(age, 0LL), 0LL)};
+}
+
+std::unique_ptr<httplib::ClientImpl> ConnectionPool::Acquire(const Key& key) {
+    std::scoped_lock lock{mutex};
+    const auto now = Clock::now();
+    std::erase_if(idle_connections, [now](const IdleConnection& connection) {
+        return now - connection.released > MaxConnectionIdleTime;
+    });
+
+    // The most recently used connection is taken, as it is the least likely to be closed already
+    const auto it = std::find_if(idle_connections.rbegin(), idle_connections.rend(),
+                                 [&key](const IdleConnection& connection) {
+                                     return connection.key == key;
+                                 });
+    if (it == idle_connections.rend()) {
+        return nullptr;
+    }
+    std::unique_ptr<httplib::ClientImpl> client = std::move(it->client);
+    idle_connections.erase(std::next(it).base());
+    return client;
+}
+
+void ConnectionPool::Release(const Key& key, std::unique_ptr<httplib::ClientImpl> client) {
+    if (!client->is_socket_open()) {
+        return;
+    }
+
+    std::scoped_lock lock{mutex};
+    const auto count = std::count_if(
+        idle_connections.begin(), idle_connections.end(),
+        [&key](const IdleConnection& connection) { return connection.key == key; });
+    if (static_cast<std::size_t>(count) >= MaxIdleConnectionsPerServer) {
+        return;
+    }
+    if (idle_connections.size() >= MaxIdleConnections) {
+        idle_connections.pop_front();
+    }
+    idle_connections.push_back({key, std::move(client), Clock::now()});
+}
+
+std::optional<httplib::Response> ConnectionPool::FindCachedResponse(const std::string& cache_key) {
+    std::scoped_lock lock{mutex};
+    const auto it = std::find_if(
+        cached_responses.begin(), cached_responses.end(),
+        [&cache_key](const CachedResponse& cached) { return cached.cache_key == cache_key; });
+    if (it == cached_responses.end()) {
+        return std::nullopt;
+    }
+    if (Clock::now() >= it->expiry) {
+        cached_bytes -= it->response.body.size();
+        cached_responses.erase(it);
+        return std::nullopt;
+    }
+    cached_responses.splice(cached_responses.end(), cached_responses, it);
+    return it->response;
+}
+
+void ConnectionPool::CacheResponse(const std::string& cache_key,
+                                   const httplib::Response& response) {
+    const std::chrono::seconds freshness = GetResponseFreshness(response);
+    if (freshness.count() == 0 || response.body.size() > MaxCachedResponseSize) {
+        return;
+    }
+
+    std::scoped_lock lock{mutex};
+    std::erase_if(cached_responses, [this, &cache_key](const CachedResponse& cached) {
+        if (cached.cache_key != cache_key) {
+            return false;
+        }
+        cached_bytes -= cached.response.body.size();
+        return true;
+    });
+    while (cached_bytes + response.body.size() > MaxCachedBytes) {
+        cached_bytes -= cached_responses.front().response.body.size();
+        cached_responses.pop_front();
+    }
+    cached_responses.push_back({cache_key, response, Clock::now() + freshness});
+    cached_bytes += response.body.size();
+}
+
 std::size_t Context::HandleHeaderWrite(std::vector<Context::RequestHeader>& pending_headers,
                                        httplib::Stream& strm, httplib::Headers& httplib_headers) {
     std::vector<Context::RequestHeader> final_headers;
@@ -358,19 +468,54 @@ void Context::MakeRequest() {
         request.is_chunked_content_provider_ = true;
     }
 
+    // GET responses are cached per URL, request headers and client certificate
+    std::string cache_key;
+    if (method == RequestMethod::Get && connection_pool) {
+        cache_key = fmt::format("{}\n{:016x}\n", url, GetClientCertHash());
+        for (const auto& header : pending_headers) {
+            cache_key += fmt::format("{}: {}\n", header.name, header.value);
+        }
+        if (auto cached = connection_pool->FindCachedResponse(cache_key)) {
+            LOG_DEBUG(Service_HTTP, "Using cached response for {}", url);
+            response = std::move(*cached);
+            current_download_size_bytes = response.body.size();
+            total_download_size_bytes = response.body.size();
+            state = RequestState::ReadyToDownloadContent;
+            return;
+        }
+    }
+
     if (url_info.is_https) {
         MakeRequestSSL(request, url_info, pending_headers);
     } else {
         MakeRequestNonSSL(request, url_info, pending_headers);
     }
+
+    if (!cache_key.empty() && state == RequestState::ReadyToDownloadContent) {
+        connection_pool->CacheResponse(cache_key, response);
+    }
 }
 
-void Context::MakeRequestNonSSL(httplib::Request& request, const URLInfo& url_info,
-                                std::vector<Context::RequestHeader>& pending_headers) {
+u64 Context::GetClientCertHash() const {
+    if (uses_default_client_cert) {
+        return Common::ComputeHash64(clcert_data->certificate.data(),
+                                     clcert_data->certificate.size());
+    }
+    if (auto client_cert = ssl_config.client_cert_ctx.lock()) {
+        return Common::ComputeHash64(client_cert->certificate.data(),
+                                     client_cert->certificate.size());
+    }
+    return 0;
+}
+
+void Context::SendRequest(httplib::Request& request, const ConnectionPool::Key& key,
+                          std::unique_ptr<httplib::ClientImpl> client,
+                          std::vector<Context::RequestHeader>& pending_headers) {
     httplib::Error error{-1};
-    std::unique_ptr<httplib::Client> client =
-        std::make_unique<httplib::Client>(url_info.host, url_info.port);
+    const bool reuse_connection = keep_alive && connection_pool;
+    client->set_keep_alive(reuse_connection);
 
+    // The header writer is replaced on every request, as pooled clients outlive the context
     client->set_header_writer(
         [this, &pending_headers](httplib::Stream& strm, httplib::Headers& httplib_headers) {
             return HandleHeaderWrite(pending_headers, strm, httplib_headers);
@@ -379,15 +524,40 @@ void Context::MakeRequestNonSSL(httplib::Request& request, const URLInfo& url_in
     if (!client->send(request, response, error)) {
         LOG_ERROR(Service_HTTP, "Request failed: {}: {}", error, httplib::to_string(error));
         state = RequestState::TimedOut;
-    } else {
-        LOG_DEBUG(Service_HTTP, "Request successful");
-        state = RequestState::ReadyToDownloadContent;
+        return;
+    }
+
+    LOG_DEBUG(Service_HTTP, "Request successful");
+    if (reuse_connection) {
+        connection_pool->Release(key, std::move(client));
+    }
+    state = RequestState::ReadyToDownloadContent;
+}
+
+void Context::MakeRequestNonSSL(httplib::Request& request, const URLInfo& url_info,
+                                std::vector<Context::RequestHeader>& pending_headers) {
+    const ConnectionPool::Key key{false, url_info.host, url_info.port, 0};
+    std::unique_ptr<httplib::ClientImpl> client;
+    if (keep_alive && connection_pool) {
+        client = connection_pool->Acquire(key);
     }
+    if (!client) {
+        client = std::make_unique<httplib::ClientImpl>(url_info.host, url_info.port);
+    }
+
+    SendRequest(request, key, std::move(client), pending_headers);
 }
 
 void Context::MakeRequestSSL(httplib::Request& request, const URLInfo& url_info,
                              std::vector<Context::RequestHeader>& pending_headers) {
-    httplib::Error error{-1};
+    const ConnectionPool::Key pool_key{true, url_info.host, url_info.port, GetClientCertHash()};
+    if (keep_alive && connection_pool) {
+        if (auto client = connection_pool->Acquire(pool_key)) {
+            SendRequest(request, pool_key, std::move(client), pending_headers);
+            return;
+        }
+    }
+
     X509* cert = nullptr;
     EVP_PKEY* key = nullptr;
     const unsigned char* cert_data = nullptr;
@@ -429,18 +599,7 @@ void Context::MakeRequestSSL(httplib::Request& request, const URLInfo& url_info,
     // Hack: Since for now RootCerts are not implemented we set the VerifyMode to None.
     client->enable_server_certificate_verification(false);
 
-    client->set_header_writer(
-        [this, &pending_headers](httplib::Stream& strm, httplib::Headers& httplib_headers) {
-            return HandleHeaderWrite(pending_headers, strm, httplib_headers);
-        });
-
-    if (!client->send(request, response, error)) {
-        LOG_ERROR(Service_HTTP, "Request failed: {}: {}", error, httplib::to_string(error));
-        state = RequestState::TimedOut;
-    } else {
-        LOG_DEBUG(Service_HTTP, "Request successful");
-        state = RequestState::ReadyToDownloadContent;
-    }
+    SendRequest(request, pool_key, std::move(client), pending_headers);
 }
 
 bool Context::ContentProvider(size_t offset, size_t length, httplib::DataSink& sink) {
@@ -772,6 +931,7 @@ void HTTP_C::CreateContext(Kernel::HLERequestContext& ctx) {
     contexts[context_counter].socket_buffer_size = 0;
     contexts[context_counter].handle = context_counter;
     contexts[context_counter].session_id = session_data->session_id;
+    contexts[context_counter].connection_pool = &connection_pool;
 
     session_data->num_http_contexts++;
 
@@ -1811,7 +1971,14 @@ void HTTP_C::SetKeepAlive(Kernel::HLERequestContext& ctx) {
     const u32 context_handle = rp.Pop<u32>();
     const u32 option = rp.Pop<u32>();
 
-    LOG_WARNING(Service_HTTP, "(STUBBED) called, handle={}, option={}", context_handle, option);
+    LOG_DEBUG(Service_HTTP, "called, handle={}, option={}", context_handle, option);
+
+    if (!PerformStateChecks(ctx, rp, context_handle)) {
+        return;
+    }
+
+    // Option 0 disables keep-alive, 1 enables it
+    GetContext(context_handle).keep_alive = option != 0;
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(ResultSuccess);
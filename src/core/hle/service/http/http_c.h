@@ -4,8 +4,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <deque>
 #include <future>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -108,6 +112,56 @@ struct ClCertAData {
     bool init = false;
 };
 
+/**
+ * Keeps the host connections of finished requests open, so that later requests to the same server
+ * skip the TCP and TLS handshakes. Connections are only shared between requests using the same
+ * client certificate. It also caches the GET responses that the server allows caching for a while.
+ * It is accessed from the request threads of all contexts.
+ */
+class ConnectionPool {
+public:
+    struct Key {
+        bool is_https;
+        std::string host;
+        int port;
+        u64 client_cert_hash; ///< Zero when no client certificate is used
+
+        bool operator==(const Key&) const = default;
+    };
+
+    /// Takes an idle connection to the server of key, returns null if there is none
+    std::unique_ptr<httplib::ClientImpl> Acquire(const Key& key);
+
+    /// Gives back a connection after a successful request so that it can be reused
+    void Release(const Key& key, std::unique_ptr<httplib::ClientImpl> client);
+
+    /// Returns a copy of the cached response for cache_key, if there is one that has not expired
+    std::optional<httplib::Response> FindCachedResponse(const std::string& cache_key);
+
+    /// Caches the response of a GET request if its Cache-Control header allows it
+    void CacheResponse(const std::string& cache_key, const httplib::Response& response);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct IdleConnection {
+        Key key;
+        std::unique_ptr<httplib::ClientImpl> client;
+        Clock::time_point released;
+    };
+
+    struct CachedResponse {
+        std::string cache_key;
+        httplib::Response response;
+        Clock::time_point expiry;
+    };
+
+    std::mutex mutex;
+    std::deque<IdleConnection> idle_connections; ///< Oldest first
+    std::list<CachedResponse> cached_responses;  ///< Least recently used first
+    std::size_t cached_bytes = 0;
+};
+
 /// Represents an HTTP context.
 class Context final {
 public:
@@ -178,6 +232,8 @@ public:
     u32 socket_buffer_size;
     std::vector<RequestHeader> headers;
     const ClCertAData* clcert_data;
+    ConnectionPool* connection_pool = nullptr;
+    bool keep_alive = true;
     Params post_data;
     std::string post_data_raw;
     PostDataEncoding post_data_encoding = PostDataEncoding::Auto;
@@ -202,6 +258,10 @@ public:
                            std::vector<Context::RequestHeader>& pending_headers);
     void MakeRequestSSL(httplib::Request& request, const URLInfo& url_info,
                         std::vector<Context::RequestHeader>& pending_headers);
+    void SendRequest(httplib::Request& request, const ConnectionPool::Key& key,
+                     std::unique_ptr<httplib::ClientImpl> client,
+                     std::vector<Context::RequestHeader>& pending_headers);
+    u64 GetClientCertHash() const;
     bool ContentProvider(size_t offset, size_t length, httplib::DataSink& sink);
     bool ChunkedContentProvider(size_t offset, httplib::DataSink& sink);
     std::size_t HandleHeaderWrite(std::vector<Context::RequestHeader>& pending_headers,
@@ -766,6 +826,9 @@ private:
     /// The next handle number to use when a new ClientCert context is created.
     ClientCertContext::Handle client_certs_counter = 0;
 
+    /// Connections and responses shared by all contexts, it must outlive their requests.
+    ConnectionPool connection_pool;
+
     /// Global list of HTTP contexts currently opened.
     std::unordered_map<Context::Handle, Context> contexts;
 
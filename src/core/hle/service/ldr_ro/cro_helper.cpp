@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
@@ -63,6 +65,37 @@ VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
     return entry.offset + segment_tag.offset_into_segment;
 }
 
+std::vector<CROHelper::SegmentEntry> CROHelper::ReadSegmentTable() const {
+    std::vector<SegmentEntry> segments(GetField(SegmentNum));
+    system.Memory().ReadBlock(process, GetField(SegmentTableOffset), segments.data(),
+                              segments.size() * sizeof(SegmentEntry));
+    return segments;
+}
+
+VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag,
+                                     std::span<const SegmentEntry> segments) {
+    if (segment_tag.segment_index >= segments.size())
+        return 0;
+
+    const SegmentEntry& entry = segments[segment_tag.segment_index];
+    if (segment_tag.offset_into_segment >= entry.size)
+        return 0;
+
+    return entry.offset + segment_tag.offset_into_segment;
+}
+
+void CROHelper::WriteRelocation(VAddr target_address, u32 value) {
+    u8* target = (target_address & Memory::CITRA_PAGE_MASK) <= Memory::CITRA_PAGE_SIZE - 4
+                     ? system.Memory().GetPointer(process, target_address)
+                     : nullptr;
+    if (target) {
+        std::memcpy(target, &value, sizeof(u32));
+    } else {
+        system.Memory().Write32(target_address, value);
+    }
+    system.InvalidateCacheRange(target_address, sizeof(u32));
+}
+
 Result CROHelper::ApplyRelocation(VAddr target_address, RelocationType relocation_type, u32 addend,
                                   u32 symbol_address, u32 target_future_address) {
 
@@ -71,12 +104,10 @@ Result CROHelper::ApplyRelocation(VAddr target_address, RelocationType relocatio
         break;
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
-        system.Memory().Write32(target_address, symbol_address + addend);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        WriteRelocation(target_address, symbol_address + addend);
         break;
     case RelocationType::RelativeAddress:
-        system.Memory().Write32(target_address, symbol_address + addend - target_future_address);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        WriteRelocation(target_address, symbol_address + addend - target_future_address);
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -118,13 +149,21 @@ Result CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool res
     if (symbol_address == 0 && !reset)
         return CROFormatError(0x10);
 
+    // Batches of commonly used symbols are long, so the segment table is read once for all of
+    // their targets instead of once per relocation
+    const std::vector<SegmentEntry> segments = ReadSegmentTable();
+
+    RelocationEntry first_relocation{};
     VAddr relocation_address = batch;
     while (true) {
         RelocationEntry relocation;
         system.Memory().ReadBlock(process, relocation_address, &relocation,
                                   sizeof(RelocationEntry));
+        if (relocation_address == batch) {
+            first_relocation = relocation;
+        }
 
-        VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
+        VAddr relocation_target = SegmentTagToAddress(relocation.target_position, segments);
         if (relocation_target == 0) {
             return CROFormatError(0x12);
         }
@@ -142,10 +181,8 @@ Result CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool res
         relocation_address += sizeof(RelocationEntry);
     }
 
-    RelocationEntry relocation;
-    system.Memory().ReadBlock(process, batch, &relocation, sizeof(RelocationEntry));
-    relocation.is_batch_resolved = reset ? 0 : 1;
-    system.Memory().WriteBlock(process, batch, &relocation, sizeof(RelocationEntry));
+    first_relocation.is_batch_resolved = reset ? 0 : 1;
+    system.Memory().WriteBlock(process, batch, &first_relocation, sizeof(RelocationEntry));
     return ResultSuccess;
 }
 
@@ -195,6 +232,42 @@ VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
     return SegmentTagToAddress(symbol_entry.symbol_position);
 }
 
+VAddr CROHelper::FindExportNamedSymbol(const std::string& name,
+                                       ExportIndexCache& export_cache) const {
+    const auto [it, inserted] = export_cache.try_emplace(module_address);
+    ExportIndex& index = it->second;
+    if (inserted) {
+        // Builds the index from whole tables read at once, rather than walking the export tree
+        // with a memory read per node for every symbol looked up
+        const u32 symbol_num = GetField(ExportTreeNum) ? GetField(ExportNamedSymbolNum) : 0;
+        std::vector<ExportNamedSymbolEntry> symbols(symbol_num);
+        system.Memory().ReadBlock(process, GetField(ExportNamedSymbolTableOffset), symbols.data(),
+                                  symbols.size() * sizeof(ExportNamedSymbolEntry));
+
+        const VAddr strings_address = GetField(ExportStringsOffset);
+        std::vector<char> strings(symbol_num ? GetField(ExportStringsSize) : 0);
+        system.Memory().ReadBlock(process, strings_address, strings.data(), strings.size());
+
+        const std::vector<SegmentEntry> segments = ReadSegmentTable();
+        index.reserve(symbols.size());
+        for (const ExportNamedSymbolEntry& symbol : symbols) {
+            // Name offsets were verified to point into the export strings on rebase
+            if (symbol.name_offset < strings_address ||
+                symbol.name_offset >= strings_address + strings.size()) {
+                continue;
+            }
+            const std::size_t offset = symbol.name_offset - strings_address;
+            const char* symbol_name = strings.data() + offset;
+            const char* strings_end = strings.data() + strings.size();
+            index.try_emplace(std::string(symbol_name, std::find(symbol_name, strings_end, '\0')),
+                              SegmentTagToAddress(symbol.symbol_position, segments));
+        }
+    }
+
+    const auto symbol = index.find(name);
+    return symbol != index.end() ? symbol->second : 0;
+}
+
 Result CROHelper::RebaseHeader(u32 cro_size) {
     Result error = CROFormatError(0x11);
 
@@ -747,7 +820,7 @@ void CROHelper::UnrebaseHeader() {
     }
 }
 
-Result CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
+Result CROHelper::ApplyImportNamedSymbol(VAddr crs_address, ExportIndexCache& export_cache) {
     u32 import_strings_size = GetField(ImportStringsSize);
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
@@ -759,11 +832,11 @@ Result CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
                                   sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
+            const std::string symbol_name =
+                system.Memory().ReadCString(entry.name_offset, import_strings_size);
             Result result = ForEachAutoLinkCRO(
                 process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        system.Memory().ReadCString(entry.name_offset, import_strings_size);
-                    u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
+                    u32 symbol_address = source.FindExportNamedSymbol(symbol_name, export_cache);
 
                     if (symbol_address != 0) {
                         LOG_TRACE(Service_LDR, "CRO \"{}\" imports \"{}\" from \"{}\"",
@@ -908,7 +981,7 @@ Result CROHelper::ApplyModuleImport(VAddr crs_address) {
     return ResultSuccess;
 }
 
-Result CROHelper::ApplyExportNamedSymbol(CROHelper target) {
+Result CROHelper::ApplyExportNamedSymbol(CROHelper target, ExportIndexCache& export_cache) {
     LOG_DEBUG(Service_LDR, "CRO \"{}\" exports named symbols to \"{}\"", ModuleName(),
               target.ModuleName());
     u32 target_import_strings_size = target.GetField(ImportStringsSize);
@@ -924,7 +997,7 @@ Result CROHelper::ApplyExportNamedSymbol(CROHelper target) {
         if (!relocation_entry.is_batch_resolved) {
             std::string symbol_name =
                 system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
-            u32 symbol_address = FindExportNamedSymbol(symbol_name);
+            u32 symbol_address = FindExportNamedSymbol(symbol_name, export_cache);
             if (symbol_address != 0) {
                 LOG_TRACE(Service_LDR, "    exports symbol \"{}\"", symbol_name);
                 Result result = target.ApplyRelocationBatch(relocation_addr, symbol_address);
@@ -938,7 +1011,7 @@ Result CROHelper::ApplyExportNamedSymbol(CROHelper target) {
     return ResultSuccess;
 }
 
-Result CROHelper::ResetExportNamedSymbol(CROHelper target) {
+Result CROHelper::ResetExportNamedSymbol(CROHelper target, ExportIndexCache& export_cache) {
     LOG_DEBUG(Service_LDR, "CRO \"{}\" unexports named symbols to \"{}\"", ModuleName(),
               target.ModuleName());
     u32 unresolved_symbol = target.GetOnUnresolvedAddress();
@@ -955,7 +1028,7 @@ Result CROHelper::ResetExportNamedSymbol(CROHelper target) {
         if (relocation_entry.is_batch_resolved) {
             std::string symbol_name =
                 system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
-            u32 symbol_address = FindExportNamedSymbol(symbol_name);
+            u32 symbol_address = FindExportNamedSymbol(symbol_name, export_cache);
             if (symbol_address != 0) {
                 LOG_TRACE(Service_LDR, "    unexports symbol \"{}\"", symbol_name);
                 Result result =
@@ -1251,7 +1324,8 @@ Result CROHelper::VerifyHash(u32 cro_size, VAddr crr) const {
     return ResultSuccess;
 }
 
-Result CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
+Result CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix,
+                       ExportIndexCache& export_cache) {
     Result result = ResultSuccess;
 
     {
@@ -1290,7 +1364,7 @@ Result CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
         });
 
         // Imports named symbols from other modules
-        result = ApplyImportNamedSymbol(crs_address);
+        result = ApplyImportNamedSymbol(crs_address, export_cache);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying symbol import {:08X}", result.raw);
             return result;
@@ -1306,8 +1380,8 @@ Result CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
 
     // Exports symbols to other modules
     result = ForEachAutoLinkCRO(process, system, crs_address,
-                                [this](CROHelper target) -> ResultVal<bool> {
-                                    Result result = ApplyExportNamedSymbol(target);
+                                [&](CROHelper target) -> ResultVal<bool> {
+                                    Result result = ApplyExportNamedSymbol(target, export_cache);
                                     if (result.IsError())
                                         return result;
 
@@ -1325,7 +1399,7 @@ Result CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
     return ResultSuccess;
 }
 
-Result CROHelper::Unlink(VAddr crs_address) {
+Result CROHelper::Unlink(VAddr crs_address, ExportIndexCache& export_cache) {
 
     // Resets all imported named symbols
     Result result = ResetImportNamedSymbol();
@@ -1351,8 +1425,8 @@ Result CROHelper::Unlink(VAddr crs_address) {
     // Resets all symbols in other modules imported from this module
     // Note: the RO service seems only searching in auto-link modules
     result = ForEachAutoLinkCRO(process, system, crs_address,
-                                [this](CROHelper target) -> ResultVal<bool> {
-                                    Result result = ResetExportNamedSymbol(target);
+                                [&](CROHelper target) -> ResultVal<bool> {
+                                    Result result = ResetExportNamedSymbol(target, export_cache);
                                     if (result.IsError())
                                         return result;
 
@@ -5,7 +5,11 @@
 #pragma once
 
 #include <array>
+#include <span>
+#include <string>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -27,6 +31,12 @@ namespace Service::LDR {
 static constexpr u32 CRO_HEADER_SIZE = 0x138;
 static constexpr u32 CRO_HASH_SIZE = 0x80;
 
+/// Addresses of the named symbols exported by a module, by name
+using ExportIndex = std::unordered_map<std::string, VAddr>;
+
+/// Export indices of the registered modules of a process, by module address
+using ExportIndexCache = std::unordered_map<VAddr, ExportIndex>;
+
 /// Represents a loaded module (CRO) with interfaces manipulating it.
 class CROHelper final {
 public:
@@ -75,16 +85,18 @@ public:
      * Links this module with all registered auto-link module.
      * @param crs_address the virtual address of the static module
      * @param link_on_load_bug_fix true if links when loading and fixes the bug
+     * @param export_cache the export indices of the registered modules
      * @returns Result ResultSuccess on success, otherwise error code.
      */
-    Result Link(VAddr crs_address, bool link_on_load_bug_fix);
+    Result Link(VAddr crs_address, bool link_on_load_bug_fix, ExportIndexCache& export_cache);
 
     /**
      * Unlinks this module with other modules.
      * @param crs_address the virtual address of the static module
+     * @param export_cache the export indices of the registered modules
      * @returns Result ResultSuccess on success, otherwise error code.
      */
-    Result Unlink(VAddr crs_address);
+    Result Unlink(VAddr crs_address, ExportIndexCache& export_cache);
 
     /**
      * Clears all relocations to zero.
@@ -441,6 +453,18 @@ private:
      */
     VAddr SegmentTagToAddress(SegmentTag segment_tag) const;
 
+    /// Reads the whole segment table of this module.
+    std::vector<SegmentEntry> ReadSegmentTable() const;
+
+    /**
+     * Converts a segment tag to virtual address using a segment table read beforehand.
+     * @param segment_tag the segment tag to convert
+     * @param segments the segment table of this module
+     * @returns VAddr the virtual address the segment tag points to; 0 if invalid.
+     */
+    static VAddr SegmentTagToAddress(SegmentTag segment_tag,
+                                     std::span<const SegmentEntry> segments);
+
     VAddr NextModule() const {
         return GetField(NextCRO);
     }
@@ -496,6 +520,13 @@ private:
     Result ApplyRelocation(VAddr target_address, RelocationType relocation_type, u32 addend,
                            u32 symbol_address, u32 target_future_address);
 
+    /**
+     * Writes a relocated word, directly through the host pointer where the target is plain memory
+     * @param target_address where to write the word
+     * @param value the word to write
+     */
+    void WriteRelocation(VAddr target_address, u32 value);
+
     /**
      * Clears a relocation to zero
      * @param target_address where to apply the relocation
@@ -521,6 +552,15 @@ private:
      */
     VAddr FindExportNamedSymbol(const std::string& name) const;
 
+    /**
+     * Finds an exported named symbol in this module through its host side export index. The index
+     * is built from the export tables on first use.
+     * @param name the name of the symbol to find
+     * @param export_cache the export indices of the registered modules
+     * @return VAddr the virtual address of the symbol; 0 if not found.
+     */
+    VAddr FindExportNamedSymbol(const std::string& name, ExportIndexCache& export_cache) const;
+
     /**
      * Rebases offsets in module header according to module address.
      * @param cro_size the size of the CRO file
@@ -648,9 +688,10 @@ private:
      * Looks up all imported named symbols of this module in all registered auto-link modules, and
      * resolves them if found.
      * @param crs_address the virtual address of the static module
+     * @param export_cache the export indices of the registered modules
      * @returns Result ResultSuccess on success, otherwise error code.
      */
-    Result ApplyImportNamedSymbol(VAddr crs_address);
+    Result ApplyImportNamedSymbol(VAddr crs_address, ExportIndexCache& export_cache);
 
     /**
      * Resets all imported named symbols of this module to unresolved state.
@@ -681,16 +722,18 @@ private:
     /**
      * Resolves target module's imported named symbols that exported by this module.
      * @param target the module to resolve.
+     * @param export_cache the export indices of the registered modules
      * @returns Result ResultSuccess on success, otherwise error code.
      */
-    Result ApplyExportNamedSymbol(CROHelper target);
+    Result ApplyExportNamedSymbol(CROHelper target, ExportIndexCache& export_cache);
 
     /**
      * Resets target's named symbols imported from this module to unresolved state.
      * @param target the module to reset.
+     * @param export_cache the export indices of the registered modules
      * @returns Result ResultSuccess on success, otherwise error code.
      */
-    Result ResetExportNamedSymbol(CROHelper target);
+    Result ResetExportNamedSymbol(CROHelper target, ExportIndexCache& export_cache);
 
     /**
      * Resolves imported indexed and anonymous symbols in the target module which imports this
@@ -280,9 +280,10 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
         return;
     }
 
-    result = cro.Link(slot->loaded_crs, link_on_load_bug_fix);
+    result = cro.Link(slot->loaded_crs, link_on_load_bug_fix, slot->export_cache);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error linking CRO {:08X}", result.raw);
+        slot->export_cache.erase(cro_address);
         process->Unmap(cro_address, cro_buffer_ptr, cro_size, Kernel::VMAPermission::ReadWrite,
                        true);
         rb.Push(result);
@@ -294,6 +295,9 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
 
     u32 fix_size = cro.Fix(fix_level);
 
+    // Fixing may have cropped the export tables the index was built from during linking
+    slot->export_cache.erase(cro_address);
+
     if (fix_size != cro_size) {
         result = process->Unmap(cro_address + fix_size, cro_buffer_ptr + fix_size,
                                 cro_size - fix_size, Kernel::VMAPermission::ReadWrite, true);
@@ -368,7 +372,8 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
 
     cro.Unregister(slot->loaded_crs);
 
-    Result result = cro.Unlink(slot->loaded_crs);
+    Result result = cro.Unlink(slot->loaded_crs, slot->export_cache);
+    slot->export_cache.erase(cro_address);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error unlinking CRO {:08X}", result.raw);
         rb.Push(result);
@@ -431,7 +436,7 @@ void RO::LinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_INFO(Service_LDR, "Linking CRO \"{}\"", cro.ModuleName());
 
-    Result result = cro.Link(slot->loaded_crs, false);
+    Result result = cro.Link(slot->loaded_crs, false, slot->export_cache);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error linking CRO {:08X}", result.raw);
     }
@@ -471,7 +476,7 @@ void RO::UnlinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_INFO(Service_LDR, "Unlinking CRO \"{}\"", cro.ModuleName());
 
-    Result result = cro.Unlink(slot->loaded_crs);
+    Result result = cro.Unlink(slot->loaded_crs, slot->export_cache);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error unlinking CRO {:08X}", result.raw);
     }
@@ -507,6 +512,7 @@ void RO::Shutdown(Kernel::HLERequestContext& ctx) {
     }
 
     slot->loaded_crs = 0;
+    slot->export_cache.clear();
     rb.Push(result);
 }
 
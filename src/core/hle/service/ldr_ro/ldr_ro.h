@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "core/hle/service/ldr_ro/cro_helper.h"
 #include "core/hle/service/service.h"
 
 namespace Core {
@@ -13,7 +14,8 @@ class System;
 namespace Service::LDR {
 
 struct ClientSlot : public Kernel::SessionRequestHandler::SessionDataBase {
-    VAddr loaded_crs = 0; ///< the virtual address of the static module
+    VAddr loaded_crs = 0;          ///< the virtual address of the static module
+    ExportIndexCache export_cache; ///< host side index of the symbols the modules export
 };
 
 class RO final : public ServiceFramework<RO, ClientSlot> {
@@ -7,6 +7,10 @@
 
 namespace Service::MVD {
 
+// TODO: None of these commands is implemented. Decoding has to wait until the request and
+// status structures used by ProcessNALUnit, GetStatus and the output buffer commands are known
+// well enough to be written back to the guest, at which point the frames can be decoded with
+// FFmpeg like the video dumper does.
 MVD_STD::MVD_STD() : ServiceFramework("mvd:std", 1) {
     static const FunctionInfo functions[] = {
         // clang-format off
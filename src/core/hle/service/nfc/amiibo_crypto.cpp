@@ -7,6 +7,8 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <map>
+#include <mutex>
 #include <cryptopp/aes.h>
 #include <cryptopp/hmac.h>
 #include <cryptopp/modes.h>
@@ -222,11 +224,26 @@ void CryptoStep(CryptoCtx& ctx, CryptoPP::HMAC<CryptoPP::SHA256>& hmac_ctx, Drgb
 }
 
 DerivedKeys GenerateKey(const HW::AES::NfcSecret& secret, const NTAG215File& data) {
+    // The derived keys only depend on the HMAC key and the internal key, which changes with the
+    // write counter. Tags are usually decoded again with the keys of their last encode, so a few
+    // entries are enough.
+    static constexpr std::size_t MAX_CACHED_KEYS = 16;
+    static std::mutex cache_mutex;
+    static std::map<std::vector<u8>, DerivedKeys> key_cache;
+
     const auto seed = GetSeed(data);
 
     // Generate internal seed
     const std::vector<u8> internal_key = GenerateInternalKey(secret, seed);
 
+    std::vector<u8> cache_key = secret.hmac_key;
+    cache_key.insert(cache_key.end(), internal_key.begin(), internal_key.end());
+
+    std::scoped_lock lock{cache_mutex};
+    if (const auto it = key_cache.find(cache_key); it != key_cache.end()) {
+        return it->second;
+    }
+
     // Initialize context
     CryptoCtx ctx{};
     CryptoPP::HMAC<CryptoPP::SHA256> hmac_ctx;
@@ -239,6 +256,11 @@ DerivedKeys GenerateKey(const HW::AES::NfcSecret& secret, const NTAG215File& dat
     CryptoStep(ctx, hmac_ctx, temp[1]);
     memcpy(&derived_keys, temp.data(), sizeof(DerivedKeys));
 
+    if (key_cache.size() >= MAX_CACHED_KEYS) {
+        key_cache.clear();
+    }
+    key_cache.emplace(std::move(cache_key), derived_keys);
+
     return derived_keys;
 }
 
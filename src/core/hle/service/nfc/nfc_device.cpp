@@ -49,6 +49,7 @@ bool NfcDevice::LoadAmiibo(std::string filename) {
         return false;
     }
 
+    is_decoded_tag_valid = false;
     if (!amiibo_file.ReadBytes(&tag.file, sizeof(tag.file))) {
         LOG_ERROR(Service_NFC, "Could not read amiibo data from file \"{}\"", filename);
         tag.file = {};
@@ -113,6 +114,7 @@ void NfcDevice::CloseAmiibo() {
     device_state = DeviceState::TagRemoved;
     encrypted_tag.file = {};
     tag.file = {};
+    is_decoded_tag_valid = false;
     tag_in_range_event->Clear();
     tag_out_of_range_event->Signal();
 }
@@ -129,6 +131,7 @@ void NfcDevice::Initialize() {
     device_state = DeviceState::Initialized;
     encrypted_tag.file = {};
     tag.file = {};
+    is_decoded_tag_valid = false;
     is_initalized = true;
 }
 
@@ -267,8 +270,14 @@ Result NfcDevice::Flush() {
     if (!is_plain_amiibo) {
         if (!AmiiboCrypto::EncodeAmiibo(tag.file, encrypted_tag.file)) {
             LOG_ERROR(Service_NFC, "Failed to encode data");
+            is_decoded_tag_valid = false;
             return ResultOperationFailed;
         }
+        // Decoding the new image would regenerate the HMACs the encode just computed
+        decoded_tag.file = tag.file;
+        decoded_tag.file.hmac_tag = encrypted_tag.file.user_memory.hmac_tag;
+        decoded_tag.file.hmac_data = encrypted_tag.file.user_memory.hmac_data;
+        is_decoded_tag_valid = true;
 
         if (amiibo_filename.empty()) {
             LOG_ERROR(Service_NFC, "Tried to use UpdateStoredAmiiboData on a nonexistant file.");
@@ -327,7 +336,7 @@ Result NfcDevice::Mount() {
         return ResultSuccess;
     }
 
-    if (!AmiiboCrypto::DecodeAmiibo(encrypted_tag.file, tag.file)) {
+    if (!DecodeTag()) {
         LOG_ERROR(Service_NFC, "Can't decode amiibo {}", device_state);
         return ResultNeedFormat;
     }
@@ -372,7 +381,7 @@ Result NfcDevice::PartiallyMount() {
         return ResultSuccess;
     }
 
-    if (!AmiiboCrypto::DecodeAmiibo(encrypted_tag.file, tag.file)) {
+    if (!DecodeTag()) {
         LOG_ERROR(Service_NFC, "Can't decode amiibo {}", device_state);
         return ResultNeedFormat;
     }
@@ -395,6 +404,19 @@ Result NfcDevice::PartiallyMountAmiibo() {
 
     return PartiallyMount();
 }
+bool NfcDevice::DecodeTag() {
+    if (is_decoded_tag_valid) {
+        tag.file = decoded_tag.file;
+        return true;
+    }
+    if (!AmiiboCrypto::DecodeAmiibo(encrypted_tag.file, tag.file)) {
+        return false;
+    }
+    decoded_tag.file = tag.file;
+    is_decoded_tag_valid = true;
+    return true;
+}
+
 Result NfcDevice::ResetTagScanState() {
     if (device_state != DeviceState::TagMounted &&
         device_state != DeviceState::TagPartiallyMounted) {
@@ -84,6 +84,9 @@ private:
 
     void BuildAmiiboWithoutKeys();
 
+    /// Decrypts encrypted_tag into tag, reusing the last decoded image if it is still current.
+    bool DecodeTag();
+
     std::shared_ptr<Kernel::Event> tag_in_range_event = nullptr;
     std::shared_ptr<Kernel::Event> tag_out_of_range_event = nullptr;
     Core::TimingEventType* remove_amiibo_event = nullptr;
@@ -103,6 +106,11 @@ private:
 
     SerializableAmiiboFile tag{};
     SerializableEncryptedAmiiboFile encrypted_tag{};
+
+    // Decrypted image of encrypted_tag, so mounting the same tag again skips the decode.
+    // Changes that are not flushed are dropped on unmount, so tag can't be reused directly.
+    SerializableAmiiboFile decoded_tag{};
+    bool is_decoded_tag_valid{};
     Core::System& system;
 };
 
@@ -8,6 +8,7 @@
 
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/ipc_helpers.h"
@@ -40,6 +41,16 @@ constexpr u16 BroadcastNetworkNodeId = 0xFFFF;
 // The Host has always dest_node_id 1
 constexpr u16 HostDestNodeId = 1;
 
+// Time during which the data frames sent to a destination are coalesced into one relay packet.
+constexpr float DataFrameBatchWindowUs = 1000.0f;
+
+// Maximum size of a batch of data frames, chosen to fit in a single ENet datagram.
+constexpr std::size_t MaxDataFrameBatchSize = 1200;
+
+// With frame batching enabled, only one in this many beacons is relayed while the network is
+// unchanged. Scanning consoles keep the received beacons until the application fetches them.
+constexpr u32 UnchangedBeaconInterval = 4;
+
 std::list<Network::WifiPacket> NWM_UDS::GetReceivedBeacons(const MacAddress& sender) {
     std::scoped_lock lock(beacon_mutex);
     if (sender != Network::BroadcastMac) {
@@ -525,7 +536,92 @@ void NWM_UDS::OnWifiPacketReceived(const Network::WifiPacket& packet) {
     case Network::WifiPacket::PacketType::NodeMap:
         HandleNodeMapPacket(packet);
         break;
+    case Network::WifiPacket::PacketType::DataBatch:
+        HandleDataFrameBatch(packet);
+        break;
+    }
+}
+
+void NWM_UDS::HandleDataFrameBatch(const Network::WifiPacket& packet) {
+    Network::WifiPacket frame;
+    frame.type = Network::WifiPacket::PacketType::Data;
+    frame.transmitter_address = packet.transmitter_address;
+    frame.destination_address = packet.destination_address;
+    frame.channel = packet.channel;
+
+    std::size_t offset = 0;
+    while (offset < packet.data.size()) {
+        u16_le frame_size;
+        if (packet.data.size() - offset < sizeof(frame_size)) {
+            LOG_ERROR(Service_NWM, "Received a malformed data frame batch");
+            return;
+        }
+        std::memcpy(&frame_size, packet.data.data() + offset, sizeof(frame_size));
+        offset += sizeof(frame_size);
+        if (packet.data.size() - offset < frame_size) {
+            LOG_ERROR(Service_NWM, "Received a malformed data frame batch");
+            return;
+        }
+        frame.data.assign(packet.data.begin() + offset,
+                          packet.data.begin() + offset + frame_size);
+        offset += frame_size;
+        HandleDataFrame(frame);
+    }
+}
+
+void NWM_UDS::QueueDataFrame(Network::WifiPacket packet) {
+    const std::size_t entry_size = sizeof(u16_le) + packet.data.size();
+    const auto it = pending_data_frames.find(packet.destination_address);
+    if (it != pending_data_frames.end() &&
+        it->second.batch_size + entry_size > MaxDataFrameBatchSize) {
+        // Send what is queued first to keep the frames in order
+        FlushDataFrames();
+    }
+    if (entry_size > MaxDataFrameBatchSize) {
+        SendPacket(packet);
+        return;
+    }
+
+    auto& pending = pending_data_frames[packet.destination_address];
+    pending.frames.push_back(std::move(packet.data));
+    pending.batch_size += entry_size;
+    if (!data_frames_flush_scheduled) {
+        system.CoreTiming().ScheduleEvent(usToCycles(DataFrameBatchWindowUs),
+                                          flush_data_frames_event, 0);
+        data_frames_flush_scheduled = true;
+    }
+}
+
+void NWM_UDS::FlushDataFrames() {
+    if (data_frames_flush_scheduled) {
+        system.CoreTiming().UnscheduleEvent(flush_data_frames_event, 0);
+        data_frames_flush_scheduled = false;
+    }
+
+    for (auto& [destination, pending] : pending_data_frames) {
+        if (pending.frames.empty()) {
+            continue;
+        }
+        Network::WifiPacket packet;
+        packet.destination_address = destination;
+        packet.channel = network_channel;
+        if (pending.frames.size() == 1) {
+            // A lone frame is sent as is, without the overhead of a batch
+            packet.type = Network::WifiPacket::PacketType::Data;
+            packet.data = std::move(pending.frames.front());
+        } else {
+            packet.type = Network::WifiPacket::PacketType::DataBatch;
+            packet.data.reserve(pending.batch_size);
+            for (const auto& frame : pending.frames) {
+                const u16_le frame_size = static_cast<u16>(frame.size());
+                const auto* size_bytes = reinterpret_cast<const u8*>(&frame_size);
+                packet.data.insert(packet.data.end(), size_bytes, size_bytes + sizeof(frame_size));
+                packet.data.insert(packet.data.end(), frame.begin(), frame.end());
+            }
+        }
+        SendPacket(packet);
     }
+    pending_data_frames.clear();
 }
 
 boost::optional<Network::MacAddress> NWM_UDS::GetNodeMacAddress(u16 dest_node_id, u8 flags) {
@@ -884,6 +980,8 @@ Result NWM_UDS::BeginHostingNetwork(std::span<const u8> network_info_buffer,
     connection_status_event->Signal();
 
     // Start broadcasting the network, send a beacon frame every 102.4ms.
+    last_beacon_frame.clear();
+    skipped_beacons = 0;
     system.CoreTiming().ScheduleEvent(msToCycles(DefaultBeaconInterval * MillisecondsPerTU),
                                       beacon_broadcast_event, 0);
 
@@ -993,6 +1091,7 @@ void NWM_UDS::DestroyNetwork(Kernel::HLERequestContext& ctx) {
 
     // Only a host can destroy
     std::scoped_lock lock(connection_status_mutex);
+    FlushDataFrames();
     if (connection_status.status != NetworkStatus::ConnectedAsHost) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
         rb.Push(Result(ErrCodes::WrongStatus, ErrorModule::UDS, ErrorSummary::InvalidState,
@@ -1031,6 +1130,7 @@ void NWM_UDS::DisconnectNetwork(Kernel::HLERequestContext& ctx) {
     WifiPacket deauth;
     {
         std::scoped_lock lock(connection_status_mutex);
+        FlushDataFrames();
         if (connection_status.status == NetworkStatus::ConnectedAsHost) {
             // A real 3ds makes strange things here. We do the same
             u16_le tmp_node_id = connection_status.network_node_id;
@@ -1141,7 +1241,11 @@ void NWM_UDS::SendTo(Kernel::HLERequestContext& ctx) {
     packet.data = std::move(data_payload);
     packet.type = Network::WifiPacket::PacketType::Data;
 
-    SendPacket(packet);
+    if (Settings::values.uds_frame_batching) {
+        QueueDataFrame(std::move(packet));
+    } else {
+        SendPacket(packet);
+    }
 
     rb.Push(ResultSuccess);
 }
@@ -1413,6 +1517,16 @@ void NWM_UDS::BeaconBroadcastCallback(std::uintptr_t user_data, s64 cycles_late)
 
     std::vector<u8> frame = GenerateBeaconFrame(network_info, node_info);
 
+    if (Settings::values.uds_frame_batching && frame == last_beacon_frame &&
+        ++skipped_beacons < UnchangedBeaconInterval) {
+        system.CoreTiming().ScheduleEvent(msToCycles(DefaultBeaconInterval * MillisecondsPerTU) -
+                                              cycles_late,
+                                          beacon_broadcast_event, 0);
+        return;
+    }
+    skipped_beacons = 0;
+    last_beacon_frame = frame;
+
     using Network::WifiPacket;
     WifiPacket packet;
     packet.type = WifiPacket::PacketType::Beacon;
@@ -1471,6 +1585,12 @@ NWM_UDS::NWM_UDS(Core::System& system) : ServiceFramework("nwm::UDS"), system(sy
         "UDS::BeaconBroadcastCallback", [this](std::uintptr_t user_data, s64 cycles_late) {
             BeaconBroadcastCallback(user_data, cycles_late);
         });
+    flush_data_frames_event = system.CoreTiming().RegisterEvent(
+        "UDS::FlushDataFrames", [this](std::uintptr_t user_data, s64 cycles_late) {
+            std::scoped_lock lock(connection_status_mutex);
+            data_frames_flush_scheduled = false;
+            FlushDataFrames();
+        });
 
     CryptoPP::AutoSeededRandomPool rng;
     auto mac = SharedPage::DefaultMac;
@@ -1498,6 +1618,7 @@ NWM_UDS::~NWM_UDS() {
         room_member->Unbind(wifi_packet_received);
 
     system.CoreTiming().UnscheduleEvent(beacon_broadcast_event, 0);
+    system.CoreTiming().UnscheduleEvent(flush_data_frames_event, 0);
 }
 
 } // namespace Service::NWM
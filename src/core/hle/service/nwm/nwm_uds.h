@@ -498,6 +498,15 @@ private:
 
     void HandleDataFrame(const Network::WifiPacket& packet);
 
+    /// Handles every data frame of a batch sent by a console with frame batching enabled
+    void HandleDataFrameBatch(const Network::WifiPacket& packet);
+
+    /// Queues a data frame to be sent together with the other frames to its destination
+    void QueueDataFrame(Network::WifiPacket packet);
+
+    /// Sends the queued data frames, with one relay packet per destination
+    void FlushDataFrames();
+
     /// Callback to parse and handle a received wifi packet.
     void OnWifiPacketReceived(const Network::WifiPacket& packet);
 
@@ -555,6 +564,22 @@ private:
     // Event that will generate and send the 802.11 beacon frames.
     Core::TimingEventType* beacon_broadcast_event;
 
+    // The last beacon frame that was sent, and the number of identical beacons skipped since.
+    std::vector<u8> last_beacon_frame;
+    u32 skipped_beacons = 0;
+
+    // Data frames queued by SendTo when frame batching is enabled, by destination.
+    // Only accessed from the emulation thread.
+    struct PendingDataFrames {
+        std::vector<std::vector<u8>> frames;
+        std::size_t batch_size = 0; ///< Size of the frames with their size prefixes
+    };
+    std::map<MacAddress, PendingDataFrames> pending_data_frames;
+
+    // Event that sends the queued data frames at the end of the batching window.
+    Core::TimingEventType* flush_data_frames_event;
+    bool data_frames_flush_scheduled = false;
+
     // Callback identifier for the OnWifiPacketReceived event.
     Network::RoomMember::CallbackHandle<Network::WifiPacket> wifi_packet_received;
 
@@ -195,11 +195,11 @@ std::string ServiceFrameworkBase::GetFunctionName(IPC::Header header) const {
     return itr->second.name;
 }
 
-static bool AttemptLLE(const ServiceModuleInfo& service_module) {
+static bool AttemptLLE(Core::System& system, const ServiceModuleInfo& service_module) {
     if (!Settings::values.lle_modules.at(service_module.name))
         return false;
-    std::unique_ptr<Loader::AppLoader> loader =
-        Loader::GetLoader(AM::GetTitleContentPath(FS::MediaType::NAND, service_module.title_id));
+    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(
+        system, AM::GetTitleContentPath(FS::MediaType::NAND, service_module.title_id));
     if (!loader) {
         LOG_ERROR(Service,
                   "Service module \"{}\" could not be loaded; Defaulting to HLE implementation.",
@@ -219,7 +219,7 @@ void Init(Core::System& core) {
     bool lle_module_present = false;
 
     for (const auto& service_module : service_module_map) {
-        const bool has_lle = AttemptLLE(service_module);
+        const bool has_lle = AttemptLLE(core, service_module);
         if (!has_lle && service_module.init_function != nullptr) {
             service_module.init_function(core);
         }
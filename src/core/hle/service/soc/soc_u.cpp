@@ -19,6 +19,7 @@
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/result.h"
 #include "core/hle/service/soc/soc_u.h"
+#include "core/hle/service/soc/socket_reactor.h"
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -447,9 +448,12 @@ std::optional<std::reference_wrapper<SocketHolder>> SOC_U::GetSocketHolder(u32 c
 }
 
 void SOC_U::CloseAndDeleteAllSockets(s32 process_id) {
-    std::erase_if(created_sockets, [process_id](const auto& entry) {
+    std::erase_if(created_sockets, [this, process_id](const auto& entry) {
         if (process_id == -1 || entry.second.ownerProcess == static_cast<u32>(process_id)) {
             closesocket(entry.second.socket_fd);
+            if (reactor) {
+                reactor->Interrupt(entry.second.socket_fd);
+            }
             return true;
         }
         return false;
@@ -976,50 +980,57 @@ void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
     async_data->pid = pid;
     async_data->socket_handle = socket_handle;
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            socklen_t addr_len = sizeof(async_data->addr);
-            async_data->ret = static_cast<u32>(
-                ::accept(async_data->fd_info->socket_fd,
-                         reinterpret_cast<sockaddr*>(&async_data->addr), &addr_len));
-            async_data->accept_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-            return 0;
-        },
-        [this, async_data](Kernel::HLERequestContext& ctx) {
-            if (static_cast<s32>(async_data->ret) != SOCKET_ERROR_VALUE) {
-                u32 socketID = GetNextSocketID();
-                created_sockets[socketID] = {
-                    .socket_fd = static_cast<decltype(SocketHolder::socket_fd)>(async_data->ret),
-                    .blocking = true,
-                    .isGlobal = false,
-                    .shutdown_rd = false,
-                    .ownerProcess = async_data->pid,
-                };
-                async_data->ret = socketID;
-            }
+    auto accept_section = [async_data](Kernel::HLERequestContext& ctx) {
+        socklen_t addr_len = sizeof(async_data->addr);
+        async_data->ret = static_cast<u32>(
+            ::accept(async_data->fd_info->socket_fd,
+                     reinterpret_cast<sockaddr*>(&async_data->addr), &addr_len));
+        async_data->accept_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
+        return 0;
+    };
+    auto reply = [this, async_data](Kernel::HLERequestContext& ctx) {
+        if (static_cast<s32>(async_data->ret) != SOCKET_ERROR_VALUE) {
+            u32 socketID = GetNextSocketID();
+            created_sockets[socketID] = {
+                .socket_fd = static_cast<decltype(SocketHolder::socket_fd)>(async_data->ret),
+                .blocking = true,
+                .isGlobal = false,
+                .shutdown_rd = false,
+                .ownerProcess = async_data->pid,
+            };
+            async_data->ret = socketID;
+        }
 
-            CTRSockAddr ctr_addr;
-            std::vector<u8> ctr_addr_buf(sizeof(ctr_addr));
-            if (static_cast<s32>(async_data->ret) == SOCKET_ERROR_VALUE) {
-                async_data->ret = TranslateError(async_data->accept_error);
-            } else {
-                ctr_addr = CTRSockAddr::FromPlatform(async_data->addr);
-                std::memcpy(ctr_addr_buf.data(), &ctr_addr, sizeof(ctr_addr));
-            }
+        CTRSockAddr ctr_addr;
+        std::vector<u8> ctr_addr_buf(sizeof(ctr_addr));
+        if (static_cast<s32>(async_data->ret) == SOCKET_ERROR_VALUE) {
+            async_data->ret = TranslateError(async_data->accept_error);
+        } else {
+            ctr_addr = CTRSockAddr::FromPlatform(async_data->addr);
+            std::memcpy(ctr_addr_buf.data(), &ctr_addr, sizeof(ctr_addr));
+        }
 
-            if (ctr_addr_buf.size() > async_data->max_addr_len) {
-                LOG_DEBUG(Service_SOC, "CTRSockAddr is too long, truncating data.");
-                ctr_addr_buf.resize(async_data->max_addr_len);
-            }
+        if (ctr_addr_buf.size() > async_data->max_addr_len) {
+            LOG_DEBUG(Service_SOC, "CTRSockAddr is too long, truncating data.");
+            ctr_addr_buf.resize(async_data->max_addr_len);
+        }
 
-            LOG_DEBUG(Service_SOC, "called, pid={}, fd={}, ret={}", async_data->pid,
-                      async_data->socket_handle, static_cast<s32>(async_data->ret));
+        LOG_DEBUG(Service_SOC, "called, pid={}, fd={}, ret={}", async_data->pid,
+                  async_data->socket_handle, static_cast<s32>(async_data->ret));
 
-            IPC::RequestBuilder rb(ctx, 0x04, 2, 2);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-            rb.PushStaticBuffer(std::move(ctr_addr_buf), 0);
-        });
+        IPC::RequestBuilder rb(ctx, 0x04, 2, 2);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+        rb.PushStaticBuffer(std::move(ctr_addr_buf), 0);
+    };
+
+    if (GetSocketBlocking(holder)) {
+        // A listening socket becomes readable once a connection can be accepted
+        ctx.RunAsyncOn(GetReactor().WhenReady({{holder.socket_fd, POLLIN}}), accept_section,
+                       reply);
+    } else {
+        ctx.RunAsync(accept_section, reply, false);
+    }
 }
 
 void SOC_U::SockAtMark(Kernel::HLERequestContext& ctx) {
@@ -1091,6 +1102,10 @@ void SOC_U::Close(Kernel::HLERequestContext& ctx) {
 
     s32 ret = 0;
     ret = closesocket(holder.socket_fd);
+    if (reactor) {
+        // A pending poll on the socket may not notice it being closed
+        reactor->Interrupt(holder.socket_fd);
+    }
 
     if (ret != 0) {
         ret = TranslateError(GET_ERRNO);
@@ -1239,22 +1254,11 @@ void SOC_U::SendToSingle(Kernel::HLERequestContext& ctx) {
     rb.Push(ret);
 }
 
-// A poll busy loop has to be used when recieving from a blocking socket
-// because calling shutdown on a socket that's currently in a blocking
-// recv call does not make it return, which causes some games to hang.
-void SOC_U::RecvBusyWaitForEvent(SocketHolder& holder) {
-    constexpr int timeout_ms = 100;
-
-    while (true) {
-        pollfd poll_fd{};
-        poll_fd.fd = holder.socket_fd;
-        poll_fd.events = POLLIN; // Check for available data.
-        int res = ::poll(&poll_fd, 1, timeout_ms);
-        // Break if there is any event, error or socket RD shutdown.
-        if (res != 0 || holder.shutdown_rd) {
-            break;
-        }
+SocketReactor& SOC_U::GetReactor() {
+    if (!reactor) {
+        reactor = std::make_unique<SocketReactor>();
     }
+    return *reactor;
 }
 
 void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
@@ -1297,7 +1301,6 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
         bool dont_wait;
         bool was_blocking;
 #endif
-        bool is_blocking;
 
         // Output
         s32 ret{};
@@ -1321,60 +1324,62 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
     async_data->dont_wait = dont_wait;
     async_data->was_blocking = was_blocking;
 #endif
-    async_data->is_blocking = needs_async;
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            sockaddr_storage src_addr;
-            socklen_t src_addr_len = sizeof(src_addr);
-            CTRSockAddr ctr_src_addr;
-            // Windows, why do you have to be so special...
-            if (async_data->is_blocking) {
-                RecvBusyWaitForEvent(*async_data->fd_info);
-            }
-            if (async_data->addr_len > 0) {
-                async_data->ret = static_cast<s32>(::recvfrom(
-                    async_data->fd_info->socket_fd,
-                    reinterpret_cast<char*>(async_data->output_buff.data()), async_data->len,
-                    async_data->flags, reinterpret_cast<sockaddr*>(&src_addr), &src_addr_len));
-                if (async_data->ret >= 0 && src_addr_len > 0) {
-                    ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-                    std::memcpy(async_data->addr_buff.data(), &ctr_src_addr,
-                                std::min<size_t>(async_data->addr_len, sizeof(ctr_src_addr)));
-                }
-            } else {
-                async_data->ret = static_cast<s32>(
-                    ::recvfrom(async_data->fd_info->socket_fd,
-                               reinterpret_cast<char*>(async_data->output_buff.data()),
-                               async_data->len, async_data->flags, NULL, 0));
-                async_data->addr_buff.resize(0);
-            }
-            async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-            return 0;
-        },
-        [this, async_data](Kernel::HLERequestContext& ctx) {
-            if (async_data->ret == SOCKET_ERROR_VALUE) {
-                async_data->ret = TranslateError(async_data->recv_error);
-            } else {
-                async_data->buffer->Write(async_data->output_buff.data(), 0, async_data->ret);
+    auto recv_section = [async_data](Kernel::HLERequestContext& ctx) {
+        sockaddr_storage src_addr;
+        socklen_t src_addr_len = sizeof(src_addr);
+        CTRSockAddr ctr_src_addr;
+        if (async_data->addr_len > 0) {
+            async_data->ret = static_cast<s32>(::recvfrom(
+                async_data->fd_info->socket_fd,
+                reinterpret_cast<char*>(async_data->output_buff.data()), async_data->len,
+                async_data->flags, reinterpret_cast<sockaddr*>(&src_addr), &src_addr_len));
+            if (async_data->ret >= 0 && src_addr_len > 0) {
+                ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
+                std::memcpy(async_data->addr_buff.data(), &ctr_src_addr,
+                            std::min<size_t>(async_data->addr_len, sizeof(ctr_src_addr)));
             }
+        } else {
+            async_data->ret = static_cast<s32>(
+                ::recvfrom(async_data->fd_info->socket_fd,
+                           reinterpret_cast<char*>(async_data->output_buff.data()),
+                           async_data->len, async_data->flags, NULL, 0));
+            async_data->addr_buff.resize(0);
+        }
+        async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
+        return 0;
+    };
+    auto reply = [this, async_data](Kernel::HLERequestContext& ctx) {
+        if (async_data->ret == SOCKET_ERROR_VALUE) {
+            async_data->ret = TranslateError(async_data->recv_error);
+        } else {
+            async_data->buffer->Write(async_data->output_buff.data(), 0, async_data->ret);
+        }
 #ifdef _WIN32
-            if (async_data->dont_wait && async_data->was_blocking) {
-                SetSocketBlocking(*async_data->fd_info, true);
-            }
+        if (async_data->dont_wait && async_data->was_blocking) {
+            SetSocketBlocking(*async_data->fd_info, true);
+        }
 #else
-            (void)this;
+        (void)this;
 #endif
-            LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
-                          static_cast<s32>(async_data->ret));
+        LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
+                      static_cast<s32>(async_data->ret));
 
-            IPC::RequestBuilder rb(ctx, 0x07, 2, 4);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-            rb.PushStaticBuffer(std::move(async_data->addr_buff), 0);
-            rb.PushMappedBuffer(*async_data->buffer);
-        },
-        needs_async);
+        IPC::RequestBuilder rb(ctx, 0x07, 2, 4);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+        rb.PushStaticBuffer(std::move(async_data->addr_buff), 0);
+        rb.PushMappedBuffer(*async_data->buffer);
+    };
+
+    if (needs_async) {
+        // Wait for data on the reactor, as shutting down a socket that is blocked in recv does not
+        // make it return on every platform, which causes some games to hang
+        ctx.RunAsyncOn(GetReactor().WhenReady({{holder.socket_fd, POLLIN}}), recv_section,
+                       reply);
+    } else {
+        ctx.RunAsync(recv_section, reply, false);
+    }
 }
 
 void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
@@ -1416,7 +1421,6 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
         bool dont_wait;
         bool was_blocking;
 #endif
-        bool is_blocking;
 
         // Output
         s32 ret{};
@@ -1438,66 +1442,69 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
     async_data->dont_wait = dont_wait;
     async_data->was_blocking = was_blocking;
 #endif
-    async_data->is_blocking = needs_async;
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            sockaddr_storage src_addr;
-            socklen_t src_addr_len = sizeof(src_addr);
-            CTRSockAddr ctr_src_addr;
-            if (async_data->is_blocking) {
-                RecvBusyWaitForEvent(*async_data->fd_info);
-            }
-            if (async_data->addr_len > 0) {
-                // Only get src adr if input adr available
-                async_data->ret = static_cast<s32>(::recvfrom(
-                    async_data->fd_info->socket_fd,
-                    reinterpret_cast<char*>(async_data->output_buff.data()), async_data->len,
-                    async_data->flags, reinterpret_cast<sockaddr*>(&src_addr), &src_addr_len));
-                if (async_data->ret >= 0 && src_addr_len > 0) {
-                    ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-                    std::memcpy(async_data->addr_buff.data(), &ctr_src_addr,
-                                std::min<size_t>(async_data->addr_len, sizeof(ctr_src_addr)));
-                }
-            } else {
-                async_data->ret = static_cast<s32>(
-                    ::recvfrom(async_data->fd_info->socket_fd,
-                               reinterpret_cast<char*>(async_data->output_buff.data()),
-                               async_data->len, async_data->flags, NULL, 0));
-                async_data->addr_buff.resize(0);
+    auto recv_section = [async_data](Kernel::HLERequestContext& ctx) {
+        sockaddr_storage src_addr;
+        socklen_t src_addr_len = sizeof(src_addr);
+        CTRSockAddr ctr_src_addr;
+        if (async_data->addr_len > 0) {
+            // Only get src adr if input adr available
+            async_data->ret = static_cast<s32>(::recvfrom(
+                async_data->fd_info->socket_fd,
+                reinterpret_cast<char*>(async_data->output_buff.data()), async_data->len,
+                async_data->flags, reinterpret_cast<sockaddr*>(&src_addr), &src_addr_len));
+            if (async_data->ret >= 0 && src_addr_len > 0) {
+                ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
+                std::memcpy(async_data->addr_buff.data(), &ctr_src_addr,
+                            std::min<size_t>(async_data->addr_len, sizeof(ctr_src_addr)));
             }
-            async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
-            return 0;
-        },
-        [this, async_data](Kernel::HLERequestContext& ctx) {
+        } else {
+            async_data->ret = static_cast<s32>(
+                ::recvfrom(async_data->fd_info->socket_fd,
+                           reinterpret_cast<char*>(async_data->output_buff.data()),
+                           async_data->len, async_data->flags, NULL, 0));
+            async_data->addr_buff.resize(0);
+        }
+        async_data->recv_error = (async_data->ret == SOCKET_ERROR_VALUE) ? GET_ERRNO : 0;
+        return 0;
+    };
+    auto reply = [this, async_data](Kernel::HLERequestContext& ctx) {
 
 #ifdef _WIN32
-            if (async_data->dont_wait && async_data->was_blocking) {
-                SetSocketBlocking(*async_data->fd_info, true);
-            }
+        if (async_data->dont_wait && async_data->was_blocking) {
+            SetSocketBlocking(*async_data->fd_info, true);
+        }
 #else
-            (void)this;
+        (void)this;
 #endif
-            s32 total_received = async_data->ret;
-            if (async_data->ret == SOCKET_ERROR_VALUE) {
-                async_data->ret = TranslateError(async_data->recv_error);
-                total_received = 0;
-            }
+        s32 total_received = async_data->ret;
+        if (async_data->ret == SOCKET_ERROR_VALUE) {
+            async_data->ret = TranslateError(async_data->recv_error);
+            total_received = 0;
+        }
 
-            // Write only the data we received to avoid overwriting parts of the buffer with zeros
-            async_data->output_buff.resize(total_received);
+        // Write only the data we received to avoid overwriting parts of the buffer with zeros
+        async_data->output_buff.resize(total_received);
 
-            LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
-                          static_cast<s32>(async_data->ret));
+        LOG_SEND_RECV(Service_SOC, "called, fd={}, ret={}", async_data->socket_handle,
+                      static_cast<s32>(async_data->ret));
 
-            IPC::RequestBuilder rb(ctx, 0x08, 3, 4);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-            rb.Push(total_received);
-            rb.PushStaticBuffer(std::move(async_data->output_buff), 0);
-            rb.PushStaticBuffer(std::move(async_data->addr_buff), 1);
-        },
-        needs_async);
+        IPC::RequestBuilder rb(ctx, 0x08, 3, 4);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+        rb.Push(total_received);
+        rb.PushStaticBuffer(std::move(async_data->output_buff), 0);
+        rb.PushStaticBuffer(std::move(async_data->addr_buff), 1);
+    };
+
+    if (needs_async) {
+        // Wait for data on the reactor, as shutting down a socket that is blocked in recv does not
+        // make it return on every platform, which causes some games to hang
+        ctx.RunAsyncOn(GetReactor().WhenReady({{holder.socket_fd, POLLIN}}), recv_section,
+                       reply);
+    } else {
+        ctx.RunAsync(recv_section, reply, false);
+    }
 }
 
 void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
@@ -1541,40 +1548,52 @@ void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
             CTRPollFD::ToPlatform(*this, async_data->ctr_fds[i], async_data->has_libctru_bug[i]);
     }
 
-    ctx.RunAsync(
-        [async_data](Kernel::HLERequestContext& ctx) {
-            async_data->ret =
-                ::poll(async_data->platform_pollfd.data(), async_data->nfds, async_data->timeout);
-            if (async_data->ret == SOCKET_ERROR_VALUE) {
-                async_data->poll_error = GET_ERRNO;
-            }
-            return 0;
-        },
-        [this, async_data](Kernel::HLERequestContext& ctx) {
-            // Now update the output 3ds_pollfd structure
-            for (u32 i = 0; i < async_data->nfds; i++) {
-                async_data->ctr_fds[i] = CTRPollFD::FromPlatform(
-                    *this, async_data->platform_pollfd[i], async_data->has_libctru_bug[i]);
-            }
+    // When waiting, the reactor waits for the descriptors and this only collects their events
+    const bool needs_async = timeout != 0;
+    auto poll_section = [async_data, needs_async](Kernel::HLERequestContext& ctx) {
+        async_data->ret = ::poll(async_data->platform_pollfd.data(), async_data->nfds,
+                                 needs_async ? 0 : async_data->timeout);
+        if (async_data->ret == SOCKET_ERROR_VALUE) {
+            async_data->poll_error = GET_ERRNO;
+        }
+        return 0;
+    };
+    auto reply = [this, async_data](Kernel::HLERequestContext& ctx) {
+        // Now update the output 3ds_pollfd structure
+        for (u32 i = 0; i < async_data->nfds; i++) {
+            async_data->ctr_fds[i] = CTRPollFD::FromPlatform(
+                *this, async_data->platform_pollfd[i], async_data->has_libctru_bug[i]);
+        }
 
-            std::vector<u8> output_fds(async_data->nfds * sizeof(CTRPollFD));
-            std::memcpy(output_fds.data(), async_data->ctr_fds.data(),
-                        async_data->nfds * sizeof(CTRPollFD));
+        std::vector<u8> output_fds(async_data->nfds * sizeof(CTRPollFD));
+        std::memcpy(output_fds.data(), async_data->ctr_fds.data(),
+                    async_data->nfds * sizeof(CTRPollFD));
 
-            if (async_data->ret == SOCKET_ERROR_VALUE) {
-                async_data->ret = TranslateError(async_data->poll_error);
-            }
+        if (async_data->ret == SOCKET_ERROR_VALUE) {
+            async_data->ret = TranslateError(async_data->poll_error);
+        }
 
-            IPC::RequestBuilder rb(ctx, static_cast<u16>(ctx.CommandHeader().command_id.Value()), 2,
-                                   2);
-            rb.Push(ResultSuccess);
-            rb.Push(async_data->ret);
-            rb.PushStaticBuffer(std::move(output_fds), 0);
+        IPC::RequestBuilder rb(ctx, static_cast<u16>(ctx.CommandHeader().command_id.Value()), 2,
+                               2);
+        rb.Push(ResultSuccess);
+        rb.Push(async_data->ret);
+        rb.PushStaticBuffer(std::move(output_fds), 0);
 
-            LOG_POLL(Service_SOC, "called, fd_count={}, ret={}", async_data->nfds,
-                     static_cast<s32>(async_data->ret));
-        },
-        timeout != 0);
+        LOG_POLL(Service_SOC, "called, fd_count={}, ret={}", async_data->nfds,
+                 static_cast<s32>(async_data->ret));
+    };
+
+    if (needs_async) {
+        std::vector<SocketReactor::WaitFd> wait_fds;
+        wait_fds.reserve(nfds);
+        for (const pollfd& fd : async_data->platform_pollfd) {
+            wait_fds.push_back({fd.fd, fd.events});
+        }
+        ctx.RunAsyncOn(GetReactor().WhenReady(std::move(wait_fds), timeout), poll_section,
+                       reply);
+    } else {
+        ctx.RunAsync(poll_section, reply, false);
+    }
 }
 
 void SOC_U::GetSockName(Kernel::HLERequestContext& ctx) {
@@ -1633,6 +1652,10 @@ void SOC_U::Shutdown(Kernel::HLERequestContext& ctx) {
     } else {
         if (how == SHUT_RD || how == SHUT_RDWR) {
             holder.shutdown_rd = true;
+            // Shutting down a socket does not wake up a pending recv or poll on every platform
+            if (reactor) {
+                reactor->Interrupt(holder.socket_fd);
+            }
         }
     }
 
@@ -2227,6 +2250,7 @@ SOC_U::SOC_U() : ServiceFramework("soc:U", 18) {
 
 SOC_U::~SOC_U() {
     CloseAndDeleteAllSockets();
+    reactor.reset();
 #ifdef _WIN32
     WSACleanup();
 #endif
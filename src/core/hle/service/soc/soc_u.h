@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include "core/hle/result.h"
@@ -19,6 +20,8 @@ class RequestParser;
 
 namespace Service::SOC {
 
+class SocketReactor;
+
 /// Holds information about a particular socket
 struct SocketHolder {
 #ifdef _WIN32
@@ -86,7 +89,8 @@ private:
     s32 SendToImpl(SocketHolder& holder, u32 len, u32 flags, u32 addr_len,
                    const std::vector<u8>& input_buff, const u8* dest_addr_buff);
 
-    static void RecvBusyWaitForEvent(SocketHolder& holder);
+    /// Gets the reactor waiting for the sockets of blocking requests, creating it on first use
+    SocketReactor& GetReactor();
 
     // From
     // https://github.com/devkitPro/libctru/blob/1de86ea38aec419744149daf692556e187d4678a/libctru/include/3ds/services/soc.h#L15
@@ -154,6 +158,8 @@ private:
     /// obtain them again between play sessions.
     bool interface_info_cached = false;
     InterfaceInfo interface_info;
+
+    std::unique_ptr<SocketReactor> reactor;
 };
 
 std::shared_ptr<SOC_U> GetService(Core::System& system);
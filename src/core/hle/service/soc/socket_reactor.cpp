@@ -0,0 +1,217 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/hle/service/soc/socket_reactor.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define closesocket(x) close(x)
+#endif
+
+namespace Service::SOC {
+
+namespace {
+
+/// Poll timeout used when the wake socket could not be created, bounds the wake up latency
+constexpr int FallbackPollTimeoutMs = 20;
+
+int PlatformPoll(pollfd* fds, std::size_t count, int timeout_ms) {
+#ifdef _WIN32
+    return WSAPoll(fds, static_cast<ULONG>(count), timeout_ms);
+#else
+    return ::poll(fds, static_cast<nfds_t>(count), timeout_ms);
+#endif
+}
+
+std::optional<SocketReactor::NativeSocket> CreateWakeSocket() {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+#ifdef _WIN32
+    if (fd == INVALID_SOCKET) {
+        return std::nullopt;
+    }
+#else
+    if (fd < 0) {
+        return std::nullopt;
+    }
+#endif
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0 ||
+        ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        closesocket(fd);
+        return std::nullopt;
+    }
+
+#ifdef _WIN32
+    unsigned long nonblocking = 1;
+    ioctlsocket(fd, FIONBIO, &nonblocking);
+#else
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    return static_cast<SocketReactor::NativeSocket>(fd);
+}
+
+} // Anonymous namespace
+
+SocketReactor::SocketReactor() : wake_socket{CreateWakeSocket()} {
+    if (!wake_socket) {
+        LOG_WARNING(Service_SOC, "Could not create the reactor wake socket, falling back to "
+                                 "polling every {} ms",
+                    FallbackPollTimeoutMs);
+    }
+    thread = std::jthread([this](std::stop_token stop_token) { Loop(stop_token); });
+}
+
+SocketReactor::~SocketReactor() {
+    thread.request_stop();
+    Wake();
+    thread.join();
+
+    // The guest is going away, release the requests without running their work
+    for (auto& wait : waits) {
+        wait->done.set_value();
+    }
+    if (wake_socket) {
+        closesocket(*wake_socket);
+    }
+}
+
+std::future<void> SocketReactor::Queue(std::vector<WaitFd> fds, s32 timeout_ms,
+                                       Common::UniqueFunction<void> work) {
+    auto wait = std::make_unique<Wait>();
+    wait->fds = std::move(fds);
+    if (timeout_ms >= 0) {
+        wait->deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+    wait->work = std::move(work);
+    std::future<void> future = wait->done.get_future();
+    {
+        std::scoped_lock lock{mutex};
+        waits.push_back(std::move(wait));
+    }
+    Wake();
+    return future;
+}
+
+void SocketReactor::Interrupt(NativeSocket fd) {
+    bool found = false;
+    {
+        std::scoped_lock lock{mutex};
+        for (auto& wait : waits) {
+            if (std::any_of(wait->fds.begin(), wait->fds.end(),
+                            [fd](const WaitFd& wait_fd) { return wait_fd.fd == fd; })) {
+                wait->interrupted = true;
+                found = true;
+            }
+        }
+    }
+    if (found) {
+        Wake();
+    }
+}
+
+void SocketReactor::Wake() {
+    if (wake_socket) {
+        const char byte = 0;
+        ::send(*wake_socket, &byte, sizeof(byte), 0);
+    }
+}
+
+void SocketReactor::DrainWakeSocket() {
+    char buffer[64];
+    while (::recv(*wake_socket, buffer, sizeof(buffer), 0) > 0) {
+    }
+}
+
+void SocketReactor::Loop(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("SocketReactor");
+
+    std::vector<pollfd> poll_fds;
+    std::vector<Wait*> polled_waits;
+    std::vector<std::unique_ptr<Wait>> ready;
+    while (!stop_token.stop_requested()) {
+        poll_fds.clear();
+        polled_waits.clear();
+        int timeout_ms = wake_socket ? -1 : FallbackPollTimeoutMs;
+        {
+            std::scoped_lock lock{mutex};
+            if (wake_socket) {
+                poll_fds.push_back({.fd = *wake_socket, .events = POLLIN, .revents = 0});
+            }
+            const auto now = Clock::now();
+            for (auto& wait : waits) {
+                polled_waits.push_back(wait.get());
+                for (const WaitFd& wait_fd : wait->fds) {
+                    poll_fds.push_back({.fd = wait_fd.fd, .events = wait_fd.events, .revents = 0});
+                }
+                int wait_timeout_ms = -1;
+                if (wait->interrupted) {
+                    wait_timeout_ms = 0;
+                } else if (wait->deadline) {
+                    // Round up, so that the deadline has passed once poll returns
+                    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+                        std::max(*wait->deadline - now, Clock::duration::zero()));
+                    wait_timeout_ms = static_cast<int>(remaining.count());
+                }
+                if (wait_timeout_ms >= 0 && (timeout_ms < 0 || wait_timeout_ms < timeout_ms)) {
+                    timeout_ms = wait_timeout_ms;
+                }
+            }
+        }
+
+        if (poll_fds.empty()) {
+            // Polling no socket is an error with WSAPoll, only possible without wake socket
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        } else if (PlatformPoll(poll_fds.data(), poll_fds.size(), timeout_ms) < 0) {
+            LOG_ERROR(Service_SOC, "Reactor poll failed");
+        }
+        if (wake_socket) {
+            DrainWakeSocket();
+        }
+
+        {
+            std::scoped_lock lock{mutex};
+            const auto now = Clock::now();
+            std::size_t offset = wake_socket ? 1 : 0;
+            for (Wait* wait : polled_waits) {
+                bool is_ready = wait->interrupted || (wait->deadline && now >= *wait->deadline);
+                for (std::size_t i = 0; i < wait->fds.size(); ++i) {
+                    is_ready |= poll_fds[offset + i].revents != 0;
+                }
+                offset += wait->fds.size();
+                if (!is_ready) {
+                    continue;
+                }
+                const auto it = std::find_if(waits.begin(), waits.end(), [wait](const auto& entry) {
+                    return entry.get() == wait;
+                });
+                ready.push_back(std::move(*it));
+                waits.erase(it);
+            }
+        }
+
+        for (auto& wait : ready) {
+            wait->work();
+            wait->done.set_value();
+        }
+        ready.clear();
+    }
+}
+
+} // namespace Service::SOC
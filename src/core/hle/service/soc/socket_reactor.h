@@ -0,0 +1,91 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/unique_function.h"
+
+namespace Service::SOC {
+
+/**
+ * Waits for the host sockets of blocking guest requests on a single thread, instead of a thread
+ * per request. The work of a request runs on the reactor thread as soon as one of its sockets is
+ * ready, its timeout expires or it is interrupted, at which point it should no longer block.
+ */
+class SocketReactor {
+public:
+#ifdef _WIN32
+    using NativeSocket = unsigned long long;
+#else
+    using NativeSocket = int;
+#endif
+
+    struct WaitFd {
+        NativeSocket fd;
+        short events; ///< Host poll events to wait for
+    };
+
+    SocketReactor();
+    ~SocketReactor();
+
+    SocketReactor(const SocketReactor&) = delete;
+    SocketReactor& operator=(const SocketReactor&) = delete;
+
+    /**
+     * Queues work to run once any of fds is ready.
+     * @param timeout_ms Time after which the work runs regardless, negative to wait indefinitely.
+     */
+    std::future<void> Queue(std::vector<WaitFd> fds, s32 timeout_ms,
+                            Common::UniqueFunction<void> work);
+
+    /// Returns an executor for Kernel::HLERequestContext::RunAsyncOn that waits for fds
+    [[nodiscard]] auto WhenReady(std::vector<WaitFd> fds, s32 timeout_ms = -1) {
+        return [this, fds = std::move(fds), timeout_ms](Common::UniqueFunction<void> work) mutable {
+            return Queue(std::move(fds), timeout_ms, std::move(work));
+        };
+    }
+
+    /**
+     * Runs the work waiting on fd without waiting for it to be ready. Used when the socket is
+     * shut down or closed, which does not wake up a pending poll on every platform.
+     */
+    void Interrupt(NativeSocket fd);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Wait {
+        std::vector<WaitFd> fds;
+        std::optional<Clock::time_point> deadline;
+        Common::UniqueFunction<void> work;
+        std::promise<void> done;
+        bool interrupted = false;
+    };
+
+    void Loop(std::stop_token stop_token);
+
+    /// Makes the reactor thread return from poll and pick up the new state of the waits
+    void Wake();
+
+    void DrainWakeSocket();
+
+    std::mutex mutex; ///< Protects waits
+    std::vector<std::unique_ptr<Wait>> waits;
+
+    /// UDP socket connected to itself, a datagram sent to it wakes up the reactor thread
+    std::optional<NativeSocket> wake_socket;
+
+    std::jthread thread;
+};
+
+} // namespace Service::SOC
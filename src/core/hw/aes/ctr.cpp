@@ -0,0 +1,61 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "core/hw/aes/ctr.h"
+
+namespace HW::AES {
+
+namespace {
+
+/// Ranges smaller than this are not worth the cost of waking other threads
+constexpr std::size_t MinParallelSize = 1024 * 1024;
+/// Smallest amount of data a thread is given, a multiple of the AES block size
+constexpr std::size_t MinChunkSize = 256 * 1024;
+
+void TransformChunk(std::span<u8> data, const AESKey& key, const AESKey& ctr, u64 offset) {
+    // Crypto++ uses AES-NI or the ARMv8 crypto extensions on its own when the host has them.
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
+    d.Seek(offset);
+    d.ProcessData(data.data(), data.data(), data.size());
+}
+
+} // Anonymous namespace
+
+void TransformCTR(std::span<u8> data, const AESKey& key, const AESKey& ctr, u64 offset) {
+    if (data.empty()) {
+        return;
+    }
+
+    const std::size_t num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    if (data.size() < MinParallelSize || num_threads == 1) {
+        TransformChunk(data, key, ctr, offset);
+        return;
+    }
+
+    const std::size_t num_chunks =
+        std::min<std::size_t>(num_threads, (data.size() + MinChunkSize - 1) / MinChunkSize);
+    const std::size_t chunk_size =
+        (data.size() / num_chunks + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+
+    // The calling thread transforms the first chunk while others handle the rest.
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_chunks - 1);
+    for (std::size_t start = chunk_size; start < data.size(); start += chunk_size) {
+        const auto chunk = data.subspan(start, std::min(chunk_size, data.size() - start));
+        futures.push_back(std::async(std::launch::async, TransformChunk, chunk, std::cref(key),
+                                     std::cref(ctr), offset + start));
+    }
+    TransformChunk(data.first(std::min(chunk_size, data.size())), key, ctr, offset);
+    for (auto& future : futures) {
+        future.wait();
+    }
+}
+
+} // namespace HW::AES
@@ -0,0 +1,24 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include "common/common_types.h"
+#include "core/hw/aes/key.h"
+
+namespace HW::AES {
+
+/**
+ * Encrypts or decrypts data in place with AES-CTR, which are the same operation. Large ranges are
+ * split into chunks that are processed in parallel, since every block of the key stream only
+ * depends on its own counter value.
+ * @param data The data to transform
+ * @param key The key to use
+ * @param ctr The initial counter of the key stream
+ * @param offset Byte offset of data in the key stream
+ */
+void TransformCTR(std::span<u8> data, const AESKey& key, const AESKey& ctr, u64 offset = 0);
+
+} // namespace HW::AES
@@ -5,7 +5,9 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include "common/arch.h"
 #include "common/assert.h"
 #include "common/color.h"
 #include "common/common_types.h"
@@ -16,6 +18,12 @@
 #include "core/hw/y2r.h"
 #include "core/memory.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace HW::Y2R {
 
 using namespace Service::Y2R;
@@ -24,56 +32,159 @@ static const std::size_t MAX_TILES = 1024 / 8;
 static const std::size_t TILE_SIZE = 8 * 8;
 using ImageTile = std::array<u32, TILE_SIZE>;
 
+/// Converts one YUV pixel to RGB32. This conversion process is bit-exact with hardware, as far as
+/// could be tested.
+static u32 ConvertPixel(s32 Y, s32 U, s32 V, const CoefficientSet& c) {
+    s32 cY = c[0] * Y;
+
+    s32 r = cY + c[1] * V;
+    s32 g = cY - c[2] * V - c[3] * U;
+    s32 b = cY + c[4] * U;
+
+    const s32 rounding_offset = 0x18;
+    r = (r >> 3) + c[5] + rounding_offset;
+    g = (g >> 3) + c[6] + rounding_offset;
+    b = (b >> 3) + c[7] + rounding_offset;
+
+    return ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) | ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
+           ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+}
+
+#if CITRA_ARCH(x86_64)
+/// 32-bit products of the low and high four lanes of two 16-bit vectors
+struct WideProduct {
+    __m128i lo;
+    __m128i hi;
+};
+
+static WideProduct MultiplyWide(__m128i a, __m128i b) {
+    const __m128i lo = _mm_mullo_epi16(a, b);
+    const __m128i hi = _mm_mulhi_epi16(a, b);
+    return {_mm_unpacklo_epi16(lo, hi), _mm_unpackhi_epi16(lo, hi)};
+}
+
+/// Finishes a color channel of eight pixels from its two vectors of 32-bit sums
+static __m128i PackChannel(__m128i lo, __m128i hi, s16 offset) {
+    const __m128i bias = _mm_set1_epi32(offset + 0x18);
+    lo = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(lo, 3), bias), 5);
+    hi = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(hi, 3), bias), 5);
+    // Saturating to 16 and then to unsigned 8 bits clamps the channel to [0, 255].
+    const __m128i channel = _mm_packs_epi32(lo, hi);
+    return _mm_packus_epi16(channel, channel);
+}
+#endif
+
+/**
+ * Converts a line of YUV pixels to RGB32, writing each group of 8 pixels to the following tile.
+ * Width must be a multiple of 8.
+ */
+static void ConvertLine(const s16* Y, const s16* U, const s16* V, u32* out, unsigned int width,
+                        const CoefficientSet& c) {
+    unsigned int x = 0;
+#if CITRA_ARCH(x86_64)
+    const __m128i c0 = _mm_set1_epi16(c[0]);
+    const __m128i c1 = _mm_set1_epi16(c[1]);
+    const __m128i c2 = _mm_set1_epi16(c[2]);
+    const __m128i c3 = _mm_set1_epi16(c[3]);
+    const __m128i c4 = _mm_set1_epi16(c[4]);
+    const __m128i zero = _mm_setzero_si128();
+    for (; x < width; x += 8, out += TILE_SIZE) {
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + x));
+        const __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(U + x));
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(V + x));
+
+        const auto [cy_lo, cy_hi] = MultiplyWide(c0, y);
+        const auto [r_lo, r_hi] = MultiplyWide(c1, v);
+        const auto [gv_lo, gv_hi] = MultiplyWide(c2, v);
+        const auto [gu_lo, gu_hi] = MultiplyWide(c3, u);
+        const auto [b_lo, b_hi] = MultiplyWide(c4, u);
+
+        const __m128i r = PackChannel(_mm_add_epi32(cy_lo, r_lo), _mm_add_epi32(cy_hi, r_hi), c[5]);
+        const __m128i g = PackChannel(_mm_sub_epi32(_mm_sub_epi32(cy_lo, gv_lo), gu_lo),
+                                      _mm_sub_epi32(_mm_sub_epi32(cy_hi, gv_hi), gu_hi), c[6]);
+        const __m128i b = PackChannel(_mm_add_epi32(cy_lo, b_lo), _mm_add_epi32(cy_hi, b_hi), c[7]);
+
+        // Interleave the channels into 0xRRGGBB00 pixels.
+        const __m128i zb = _mm_unpacklo_epi8(zero, b);
+        const __m128i gr = _mm_unpacklo_epi8(g, r);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(zb, gr));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(zb, gr));
+    }
+#elif CITRA_ARCH(arm64)
+    const int16x4_t coeffs = vld1_s16(c.data());
+    const int16x4_t c4 = vdup_n_s16(c[4]);
+    const auto pack_channel = [](int32x4_t lo, int32x4_t hi, s16 offset) {
+        const int32x4_t bias = vdupq_n_s32(offset + 0x18);
+        lo = vshrq_n_s32(vaddq_s32(vshrq_n_s32(lo, 3), bias), 5);
+        hi = vshrq_n_s32(vaddq_s32(vshrq_n_s32(hi, 3), bias), 5);
+        return vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    };
+    for (; x < width; x += 8, out += TILE_SIZE) {
+        const int16x8_t y = vld1q_s16(Y + x);
+        const int16x8_t u = vld1q_s16(U + x);
+        const int16x8_t v = vld1q_s16(V + x);
+
+        const int32x4_t cy_lo = vmull_lane_s16(vget_low_s16(y), coeffs, 0);
+        const int32x4_t cy_hi = vmull_lane_s16(vget_high_s16(y), coeffs, 0);
+
+        const int32x4_t r_lo = vmlal_lane_s16(cy_lo, vget_low_s16(v), coeffs, 1);
+        const int32x4_t r_hi = vmlal_lane_s16(cy_hi, vget_high_s16(v), coeffs, 1);
+        int32x4_t g_lo = vmlsl_lane_s16(cy_lo, vget_low_s16(v), coeffs, 2);
+        int32x4_t g_hi = vmlsl_lane_s16(cy_hi, vget_high_s16(v), coeffs, 2);
+        g_lo = vmlsl_lane_s16(g_lo, vget_low_s16(u), coeffs, 3);
+        g_hi = vmlsl_lane_s16(g_hi, vget_high_s16(u), coeffs, 3);
+        const int32x4_t b_lo = vmlal_s16(cy_lo, vget_low_s16(u), c4);
+        const int32x4_t b_hi = vmlal_s16(cy_hi, vget_high_s16(u), c4);
+
+        // Interleave the channels into 0xRRGGBB00 pixels.
+        const uint8x8x4_t pixels = {{
+            vdup_n_u8(0),
+            pack_channel(b_lo, b_hi, c[7]),
+            pack_channel(g_lo, g_hi, c[6]),
+            pack_channel(r_lo, r_hi, c[5]),
+        }};
+        vst4_u8(reinterpret_cast<u8*>(out), pixels);
+    }
+#endif
+    for (; x < width; ++x) {
+        out[(x / 8) * TILE_SIZE + x % 8] = ConvertPixel(Y[x], U[x], V[x], c);
+    }
+}
+
 /// Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles.
 template <InputFormat input_format>
 static void ConvertYUVToRGB(const u8* input_Y, const u8* input_U, const u8* input_V,
                             ImageTile output[], unsigned int width, unsigned int height,
                             const CoefficientSet& coefficients) {
+    // Components of the current line, with chroma replicated for every pixel.
+    std::array<s16, MAX_TILES * 8> line_Y;
+    std::array<s16, MAX_TILES * 8> line_U;
+    std::array<s16, MAX_TILES * 8> line_V;
 
     for (unsigned int y = 0; y < height; ++y) {
         for (unsigned int x = 0; x < width; ++x) {
-            s32 Y;
-            s32 U;
-            s32 V;
             if constexpr (input_format == InputFormat::YUV422_Indiv8 ||
                           input_format == InputFormat::YUV422_Indiv16) {
-                Y = input_Y[y * width + x];
-                U = input_U[(y * width + x) / 2];
-                V = input_V[(y * width + x) / 2];
+                line_Y[x] = input_Y[y * width + x];
+                line_U[x] = input_U[(y * width + x) / 2];
+                line_V[x] = input_V[(y * width + x) / 2];
             } else if constexpr (input_format == InputFormat::YUV420_Indiv8 ||
                                  input_format == InputFormat::YUV420_Indiv16) {
-                Y = input_Y[y * width + x];
-                U = input_U[((y / 2) * width + x) / 2];
-                V = input_V[((y / 2) * width + x) / 2];
+                line_Y[x] = input_Y[y * width + x];
+                line_U[x] = input_U[((y / 2) * width + x) / 2];
+                line_V[x] = input_V[((y / 2) * width + x) / 2];
             } else if constexpr (input_format == InputFormat::YUYV422_Interleaved) {
-                Y = input_Y[(y * width + x) * 2];
-                U = input_Y[(y * width + (x / 2) * 2) * 2 + 1];
-                V = input_Y[(y * width + (x / 2) * 2) * 2 + 3];
+                line_Y[x] = input_Y[(y * width + x) * 2];
+                line_U[x] = input_Y[(y * width + (x / 2) * 2) * 2 + 1];
+                line_V[x] = input_Y[(y * width + (x / 2) * 2) * 2 + 3];
             } else {
                 UNREACHABLE_MSG("Unknown Y2R input format {}", input_format);
                 return;
             }
-
-            // This conversion process is bit-exact with hardware, as far as could be tested.
-            auto& c = coefficients;
-            s32 cY = c[0] * Y;
-
-            s32 r = cY + c[1] * V;
-            s32 g = cY - c[2] * V - c[3] * U;
-            s32 b = cY + c[4] * U;
-
-            const s32 rounding_offset = 0x18;
-            r = (r >> 3) + c[5] + rounding_offset;
-            g = (g >> 3) + c[6] + rounding_offset;
-            b = (b >> 3) + c[7] + rounding_offset;
-
-            unsigned int tile = x / 8;
-            unsigned int tile_x = x % 8;
-            u32* out = &output[tile][y * 8 + tile_x];
-            *out = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
-                   ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
-                   ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
         }
+
+        ConvertLine(line_Y.data(), line_U.data(), line_V.data(), &output[0][y * 8], width,
+                    coefficients);
     }
 }
 
@@ -168,6 +279,10 @@ static const u8 morton_lut[TILE_SIZE] = {
 
 static void RotateTile0(const ImageTile& input, ImageTile& output, int height,
                         const u8 out_map[64]) {
+    if (out_map == linear_lut) {
+        std::memcpy(output.data(), input.data(), height * 8 * sizeof(u32));
+        return;
+    }
     for (int i = 0; i < height * 8; ++i) {
         output[out_map[i]] = input[i];
     }
@@ -203,9 +318,7 @@ static void RotateTile270(const ImageTile& input, ImageTile& output, int height,
 
 static void WriteTileToOutput(u32* output, const ImageTile& tile, int height, int line_stride) {
     for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < 8; ++x) {
-            output[y * line_stride + x] = tile[y * 8 + x];
-        }
+        std::memcpy(output + y * line_stride, tile.data() + y * 8, 8 * sizeof(u32));
     }
 }
 
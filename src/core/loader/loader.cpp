@@ -113,7 +113,7 @@ static std::unique_ptr<AppLoader> GetFileLoader(Core::System& system, FileUtil::
     }
 }
 
-std::unique_ptr<AppLoader> GetLoader(const std::string& filename) {
+std::unique_ptr<AppLoader> GetLoader(Core::System& system, const std::string& filename) {
     FileUtil::IOFile file(filename, "rb");
     if (!file.IsOpen()) {
         LOG_ERROR(Loader, "Failed to load file {}", filename);
@@ -134,8 +134,11 @@ std::unique_ptr<AppLoader> GetLoader(const std::string& filename) {
 
     LOG_DEBUG(Loader, "Loading file {} as {}...", filename, GetFileTypeString(type));
 
-    auto& system = Core::System::GetInstance();
     return GetFileLoader(system, std::move(file), type, filename_filename, filename);
 }
 
+std::unique_ptr<AppLoader> GetLoader(const std::string& filename) {
+    return GetLoader(Core::System::GetInstance(), filename);
+}
+
 } // namespace Loader
@@ -273,6 +273,15 @@ protected:
 
 /**
  * Identifies a bootable file and return a suitable loader
+ * @param system System instance the loader loads the file into
+ * @param filename String filename of bootable file
+ * @return best loader for this file
+ */
+std::unique_ptr<AppLoader> GetLoader(Core::System& system, const std::string& filename);
+
+/**
+ * Identifies a bootable file and return a suitable loader for the global system instance. Meant
+ * for frontends that only read metadata, code running inside a system passes it explicitly.
  * @param filename String filename of bootable file
  * @return best loader for this file
  */
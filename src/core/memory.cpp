@@ -2,13 +2,17 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <optional>
 
 #include "common/assert.h"
 #include "common/atomic_ops.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "common/swap.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
@@ -16,6 +20,7 @@
 #include "core/hle/kernel/process.h"
 #include "core/hle/service/plgldr/plgldr.h"
 #include "core/memory.h"
+#include "core/savestate.h"
 #include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
 
@@ -62,10 +67,13 @@ private:
 class MemorySystem::Impl {
 public:
     Core::System& system;
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
-    std::unique_ptr<u8[]> dsp_mem = std::make_unique<u8[]>(Memory::DSP_RAM_SIZE);
+    // All physical memory shares one backing so that fastmem arenas can mirror any of it.
+    Common::HostMemory backing{Memory::FCRAM_N3DS_SIZE + Memory::VRAM_SIZE +
+                               Memory::N3DS_EXTRA_RAM_SIZE + Memory::DSP_RAM_SIZE};
+    u8* const fcram = backing.BackingBasePointer();
+    u8* const vram = fcram + Memory::FCRAM_N3DS_SIZE;
+    u8* const n3ds_extra_ram = vram + Memory::VRAM_SIZE;
+    u8* const dsp_mem = n3ds_extra_ram + Memory::N3DS_EXTRA_RAM_SIZE;
 
     std::shared_ptr<PageTable> current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
@@ -88,122 +96,235 @@ public:
         }
     }
 
-    u32 GetPC() const noexcept {
-        return system.GetRunningCore().GetPC();
-    }
-
-    template <bool UNSAFE>
-    void ReadBlockImpl(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
-                       const std::size_t size) {
-        auto& page_table = *process.vm_manager.page_table;
-
-        std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
-        std::size_t page_offset = src_addr & CITRA_PAGE_MASK;
+    /**
+     * Mirrors the pages of the given range that are of type Memory into the fastmem arena of the
+     * page table, and makes all other pages of the range fault.
+     */
+    void UpdateFastmem(PageTable& page_table, u32 first_page, u32 num_pages) {
+        if (!page_table.fastmem_arena) {
+            return;
+        }
 
-        while (remaining_size > 0) {
-            const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-            const VAddr current_vaddr =
-                static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
+        const u8* const backing_base = backing.BackingBasePointer();
+        const auto backing_offset = [&](u32 page) -> std::optional<std::size_t> {
+            const u8* const pointer = page_table.pointers[page];
+            if (page_table.attributes[page] != PageType::Memory || pointer < backing_base ||
+                pointer >= backing_base + backing.BackingSize()) {
+                return std::nullopt;
+            }
+            return static_cast<std::size_t>(pointer - backing_base);
+        };
 
-            switch (page_table.attributes[page_index]) {
-            case PageType::Unmapped: {
-                LOG_ERROR(
-                    HW_Memory,
-                    "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                    "0x{:08X}",
-                    current_vaddr, src_addr, size, GetPC());
-                std::memset(dest_buffer, 0, copy_amount);
-                break;
+        // Coalesce runs of contiguous pages to keep the number of host mappings low.
+        const u32 end_page = first_page + num_pages;
+        for (u32 page = first_page; page < end_page;) {
+            const auto run_offset = backing_offset(page);
+            u32 run_end = page + 1;
+            while (run_end < end_page) {
+                const auto offset = backing_offset(run_end);
+                if (run_offset.has_value() != offset.has_value() ||
+                    (run_offset && *offset != *run_offset + (run_end - page) * CITRA_PAGE_SIZE)) {
+                    break;
+                }
+                ++run_end;
             }
-            case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
 
-                const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_buffer, src_ptr, copy_amount);
-                break;
+            const std::size_t virtual_offset = static_cast<std::size_t>(page) * CITRA_PAGE_SIZE;
+            const std::size_t length = static_cast<std::size_t>(run_end - page) * CITRA_PAGE_SIZE;
+            if (run_offset) {
+                page_table.fastmem_arena->Map(virtual_offset, *run_offset, length);
+            } else {
+                page_table.fastmem_arena->Unmap(virtual_offset, length);
             }
-            case PageType::RasterizerCachedMemory: {
-                if constexpr (!UNSAFE) {
-                    RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                                 FlushMode::Flush);
+            page = run_end;
+        }
+    }
+
+    /// Switches the pages of a virtual range backed by one memory region to cached or uncached in
+    /// every page table.
+    void MarkPagesCached(VAddr start, u32 num_pages, bool cached) {
+        const u32 first_page = start >> CITRA_PAGE_BITS;
+        const u32 end_page = first_page + num_pages;
+        for (u32 page = first_page; page < end_page; page++) {
+            cache_marker.Mark(page << CITRA_PAGE_BITS, cached);
+        }
+
+        // The range is contiguous in host memory, only its start needs translating
+        u8* backing = nullptr;
+        for (auto& page_table : page_table_list) {
+            u32 changed_begin = end_page;
+            u32 changed_end = first_page;
+            for (u32 page = first_page; page < end_page; page++) {
+                PageType& page_type = page_table->attributes[page];
+                if (page_type == PageType::Unmapped) {
+                    // It is not necessary for a process to have this region mapped into its
+                    // address space, for example, a system module need not have a VRAM mapping.
+                    continue;
                 }
-                std::memcpy(dest_buffer, GetPointerForRasterizerCache(current_vaddr), copy_amount);
-                break;
+                if (cached) {
+                    // Switch page type to cached if now cached
+                    ASSERT(page_type == PageType::Memory);
+                    page_type = PageType::RasterizerCachedMemory;
+                    page_table->pointers[page] = nullptr;
+                } else {
+                    // Switch page type to uncached if now uncached
+                    ASSERT(page_type == PageType::RasterizerCachedMemory);
+                    if (!backing) {
+                        backing = GetPointerForRasterizerCache(start);
+                    }
+                    page_type = PageType::Memory;
+                    page_table->pointers[page] =
+                        backing + static_cast<std::size_t>(page - first_page) * CITRA_PAGE_SIZE;
+                }
+                changed_begin = std::min(changed_begin, page);
+                changed_end = page + 1;
             }
-            default:
-                UNREACHABLE();
+            if (changed_begin < changed_end) {
+                UpdateFastmem(*page_table, changed_begin, changed_end - changed_begin);
             }
+        }
+    }
 
-            page_index++;
-            page_offset = 0;
-            dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-            remaining_size -= copy_amount;
+    u32 GetPC() const noexcept {
+        return system.GetRunningCore().GetPC();
+    }
+
+    /// Returns the host pointer backing the given page, or nullptr when it is unmapped.
+    u8* GetPagePointer(const PageTable& page_table, std::size_t page_index) const {
+        switch (page_table.attributes[page_index]) {
+        case PageType::Memory:
+            return page_table.pointers[page_index];
+        case PageType::RasterizerCachedMemory:
+            return GetPointerForRasterizerCache(static_cast<VAddr>(page_index << CITRA_PAGE_BITS));
+        default:
+            return nullptr;
         }
     }
 
-    template <bool UNSAFE>
-    void WriteBlockImpl(const Kernel::Process& process, const VAddr dest_addr,
-                        const void* src_buffer, const std::size_t size) {
-        auto& page_table = *process.vm_manager.page_table;
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> CITRA_PAGE_BITS;
-        std::size_t page_offset = dest_addr & CITRA_PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-            const VAddr current_vaddr =
+    /**
+     * Splits a range of virtual memory into runs of pages of the same type whose host memory is
+     * contiguous, so that each run can be handled with a single copy and rasterizer flush. The
+     * callback receives the page type, virtual address, host pointer (nullptr when unmapped),
+     * offset in the range and size of every run.
+     */
+    template <typename Func>
+    void WalkBlock(const PageTable& page_table, const VAddr addr, const std::size_t size,
+                   Func&& func) const {
+        std::size_t offset = 0;
+        std::size_t page_index = addr >> CITRA_PAGE_BITS;
+        std::size_t page_offset = addr & CITRA_PAGE_MASK;
+
+        while (offset < size) {
+            const PageType type = page_table.attributes[page_index];
+            const VAddr run_vaddr =
                 static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case PageType::Unmapped: {
-                LOG_ERROR(
-                    HW_Memory,
-                    "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                    "0x{:08X}",
-                    current_vaddr, dest_addr, size, GetPC());
-                break;
+            u8* run_pointer = GetPagePointer(page_table, page_index);
+            if (run_pointer) {
+                run_pointer += page_offset;
             }
-            case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
+            std::size_t run_size = std::min(CITRA_PAGE_SIZE - page_offset, size - offset);
+            page_index++;
 
-                u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_ptr, src_buffer, copy_amount);
-                break;
-            }
-            case PageType::RasterizerCachedMemory: {
-                if constexpr (!UNSAFE) {
-                    RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                                 FlushMode::Invalidate);
-                }
-                std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
+            while (offset + run_size < size && page_table.attributes[page_index] == type &&
+                   GetPagePointer(page_table, page_index) ==
+                       (run_pointer ? run_pointer + run_size : nullptr)) {
+                run_size += std::min<std::size_t>(CITRA_PAGE_SIZE, size - offset - run_size);
+                page_index++;
             }
 
-            page_index++;
+            func(type, run_vaddr, run_pointer, offset, run_size);
+            offset += run_size;
             page_offset = 0;
-            src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-            remaining_size -= copy_amount;
         }
     }
 
+    template <bool UNSAFE>
+    void ReadBlockImpl(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
+                       const std::size_t size) {
+        const auto& page_table = *process.vm_manager.page_table;
+        u8* const dest = static_cast<u8*>(dest_buffer);
+
+        WalkBlock(page_table, src_addr, size,
+                  [&](PageType type, VAddr vaddr, const u8* src_ptr, std::size_t offset,
+                      std::size_t amount) {
+                      switch (type) {
+                      case PageType::Unmapped: {
+                          LOG_ERROR(HW_Memory,
+                                    "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                    "size = {}) at PC 0x{:08X}",
+                                    vaddr, src_addr, size, GetPC());
+                          std::memset(dest + offset, 0, amount);
+                          break;
+                      }
+                      case PageType::Memory: {
+                          DEBUG_ASSERT(src_ptr);
+                          std::memcpy(dest + offset, src_ptr, amount);
+                          break;
+                      }
+                      case PageType::RasterizerCachedMemory: {
+                          if constexpr (!UNSAFE) {
+                              RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(amount),
+                                                           FlushMode::Flush);
+                          }
+                          std::memcpy(dest + offset, src_ptr, amount);
+                          break;
+                      }
+                      default:
+                          UNREACHABLE();
+                      }
+                  });
+    }
+
+    template <bool UNSAFE>
+    void WriteBlockImpl(const Kernel::Process& process, const VAddr dest_addr,
+                        const void* src_buffer, const std::size_t size) {
+        const auto& page_table = *process.vm_manager.page_table;
+        const u8* const src = static_cast<const u8*>(src_buffer);
+
+        WalkBlock(page_table, dest_addr, size,
+                  [&](PageType type, VAddr vaddr, u8* dest_ptr, std::size_t offset,
+                      std::size_t amount) {
+                      switch (type) {
+                      case PageType::Unmapped: {
+                          LOG_ERROR(HW_Memory,
+                                    "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                    "size = {}) at PC 0x{:08X}",
+                                    vaddr, dest_addr, size, GetPC());
+                          break;
+                      }
+                      case PageType::Memory: {
+                          DEBUG_ASSERT(dest_ptr);
+                          std::memcpy(dest_ptr, src + offset, amount);
+                          break;
+                      }
+                      case PageType::RasterizerCachedMemory: {
+                          if constexpr (!UNSAFE) {
+                              RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(amount),
+                                                           FlushMode::Invalidate);
+                          }
+                          std::memcpy(dest_ptr, src + offset, amount);
+                          break;
+                      }
+                      default:
+                          UNREACHABLE();
+                      }
+                  });
+    }
+
     u8* GetPointerForRasterizerCache(VAddr addr) const {
         if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END) {
-            return fcram.get() + addr - LINEAR_HEAP_VADDR;
+            return fcram + addr - LINEAR_HEAP_VADDR;
         }
         if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR_END) {
-            return fcram.get() + addr - NEW_LINEAR_HEAP_VADDR;
+            return fcram + addr - NEW_LINEAR_HEAP_VADDR;
         }
         if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END) {
-            return vram.get() + addr - VRAM_VADDR;
+            return vram + addr - VRAM_VADDR;
         }
         if (addr >= PLUGIN_3GX_FB_VADDR && addr < PLUGIN_3GX_FB_VADDR_END) {
             auto plg_ldr = Service::PLGLDR::GetService(system.Kernel());
             if (plg_ldr) {
-                return fcram.get() + addr - PLUGIN_3GX_FB_VADDR + plg_ldr->GetPluginFBAddr() -
+                return fcram + addr - PLUGIN_3GX_FB_VADDR + plg_ldr->GetPluginFBAddr() -
                        FCRAM_PADDR;
             }
         }
@@ -221,7 +342,11 @@ public:
                 return;
             }
 
-            auto& renderer = system.GPU().Renderer();
+            // The guest reads or writes memory the GPU thread may still be rendering to
+            auto& gpu = system.GPU();
+            gpu.WaitIdle();
+
+            auto& renderer = gpu.Renderer();
             VAddr overlap_start = std::max(start, region_start);
             VAddr overlap_end = std::min(end, region_end);
             PAddr physical_start = paddr_region_start + (overlap_start - region_start);
@@ -276,6 +401,7 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, u8* memor
                                      FlushMode::FlushAndInvalidate);
     }
 
+    const u32 first_page = base;
     u32 end = base + size;
     while (base != end) {
         ASSERT_MSG(base < PageTable::NUM_ENTRIES, "out of range mapping at {:08X}", base);
@@ -294,6 +420,8 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, u8* memor
             memory += CITRA_PAGE_SIZE;
         }
     }
+
+    impl->UpdateFastmem(page_table, first_page, size);
 }
 
 void MemorySystem::MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, u8* target) {
@@ -314,6 +442,11 @@ u8* MemorySystem::GetPointerForRasterizerCache(VAddr addr) const {
 }
 
 void MemorySystem::RegisterPageTable(std::shared_ptr<PageTable> page_table) {
+    if (Settings::values.use_fastmem && Settings::values.use_cpu_jit &&
+        impl->backing.SupportsMirroring()) {
+        page_table->fastmem_arena = impl->backing.CreateArena(FastmemArenaSize);
+        impl->UpdateFastmem(*page_table, 0, PageTable::NUM_ENTRIES);
+    }
     impl->page_table_list.push_back(page_table);
 }
 
@@ -482,6 +615,14 @@ u8* MemorySystem::GetPointer(const VAddr vaddr) {
     return nullptr;
 }
 
+u8* MemorySystem::GetPointer(const Kernel::Process& process, const VAddr vaddr) {
+    auto& page_table = *process.vm_manager.page_table;
+    if (page_table.attributes[vaddr >> CITRA_PAGE_BITS] != PageType::Memory) {
+        return nullptr;
+    }
+    return page_table.pointers[vaddr >> CITRA_PAGE_BITS] + (vaddr & CITRA_PAGE_MASK);
+}
+
 const u8* MemorySystem::GetPointer(const VAddr vaddr) const {
     const u8* page_pointer = impl->current_page_table->pointers[vaddr >> CITRA_PAGE_BITS];
     if (page_pointer) {
@@ -546,16 +687,16 @@ std::span<u8> MemorySystem::GetPhysicalSpan(PAddr address) const {
     u8* target_mem = nullptr;
     switch (area->first) {
     case VRAM_PADDR:
-        target_mem = impl->vram.get();
+        target_mem = impl->vram;
         break;
     case DSP_RAM_PADDR:
-        target_mem = impl->dsp_mem.get();
+        target_mem = impl->dsp_mem;
         break;
     case FCRAM_PADDR:
-        target_mem = impl->fcram.get();
+        target_mem = impl->fcram;
         break;
     case N3DS_EXTRA_RAM_PADDR:
-        target_mem = impl->n3ds_extra_ram.get();
+        target_mem = impl->n3ds_extra_ram;
         break;
     default:
         UNREACHABLE();
@@ -564,23 +705,31 @@ std::span<u8> MemorySystem::GetPhysicalSpan(PAddr address) const {
     return std::span{target_mem + offset_into_region, area->second - offset_into_region};
 }
 
-std::vector<VAddr> MemorySystem::PhysicalToVirtualAddressForRasterizer(PAddr addr) {
+MemorySystem::RasterizerMapping MemorySystem::PhysicalToVirtualAddressForRasterizer(PAddr addr) {
     if (addr >= VRAM_PADDR && addr < VRAM_PADDR_END) {
-        return {addr - VRAM_PADDR + VRAM_VADDR};
+        return {{addr - VRAM_PADDR + VRAM_VADDR}, 1, VRAM_PADDR_END};
     }
     // NOTE: Order matters here.
+    PAddr fb_addr = 0;
     auto plg_ldr = Service::PLGLDR::GetService(impl->system.Kernel());
     if (plg_ldr) {
-        auto fb_addr = plg_ldr->GetPluginFBAddr();
+        fb_addr = plg_ldr->GetPluginFBAddr();
         if (addr >= fb_addr && addr < fb_addr + PLUGIN_3GX_FB_SIZE) {
-            return {addr - fb_addr + PLUGIN_3GX_FB_VADDR};
+            return {{addr - fb_addr + PLUGIN_3GX_FB_VADDR}, 1, fb_addr + PLUGIN_3GX_FB_SIZE};
         }
     }
+    // The plugin framebuffer is carved out of FCRAM, so FCRAM runs end where it starts
+    const auto fcram_end = [&](PAddr region_end) {
+        return fb_addr > addr ? std::min(region_end, fb_addr) : region_end;
+    };
     if (addr >= FCRAM_PADDR && addr < FCRAM_PADDR_END) {
-        return {addr - FCRAM_PADDR + LINEAR_HEAP_VADDR, addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR};
+        const u32 offset = addr - FCRAM_PADDR;
+        return {{offset + LINEAR_HEAP_VADDR, offset + NEW_LINEAR_HEAP_VADDR},
+                2,
+                fcram_end(FCRAM_PADDR_END)};
     }
     if (addr >= FCRAM_PADDR_END && addr < FCRAM_N3DS_PADDR_END) {
-        return {addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR};
+        return {{addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR}, 1, fcram_end(FCRAM_N3DS_PADDR_END)};
     }
     // While the physical <-> virtual mapping is 1:1 for the regions supported by the cache,
     // some games (like Pokemon Super Mystery Dungeon) will try to use textures that go beyond
@@ -589,7 +738,7 @@ std::vector<VAddr> MemorySystem::PhysicalToVirtualAddressForRasterizer(PAddr add
     LOG_ERROR(HW_Memory,
               "Trying to use invalid physical address for rasterizer: {:08X} at PC 0x{:08X}", addr,
               impl->GetPC());
-    return {};
+    return {{}, 0, (addr & ~CITRA_PAGE_MASK) + CITRA_PAGE_SIZE};
 }
 
 void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached) {
@@ -597,48 +746,18 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
         return;
     }
 
-    u32 num_pages = ((start + size - 1) >> CITRA_PAGE_BITS) - (start >> CITRA_PAGE_BITS) + 1;
-    PAddr paddr = start;
-
-    for (unsigned i = 0; i < num_pages; ++i, paddr += CITRA_PAGE_SIZE) {
-        for (VAddr vaddr : PhysicalToVirtualAddressForRasterizer(paddr)) {
-            impl->cache_marker.Mark(vaddr, cached);
-            for (auto& page_table : impl->page_table_list) {
-                PageType& page_type = page_table->attributes[vaddr >> CITRA_PAGE_BITS];
+    PAddr paddr = start & ~CITRA_PAGE_MASK;
+    const PAddr end = ((start + size - 1) & ~CITRA_PAGE_MASK) + CITRA_PAGE_SIZE;
 
-                if (cached) {
-                    // Switch page type to cached if now cached
-                    switch (page_type) {
-                    case PageType::Unmapped:
-                        // It is not necessary for a process to have this region mapped into its
-                        // address space, for example, a system module need not have a VRAM mapping.
-                        break;
-                    case PageType::Memory:
-                        page_type = PageType::RasterizerCachedMemory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] = nullptr;
-                        break;
-                    default:
-                        UNREACHABLE();
-                    }
-                } else {
-                    // Switch page type to uncached if now uncached
-                    switch (page_type) {
-                    case PageType::Unmapped:
-                        // It is not necessary for a process to have this region mapped into its
-                        // address space, for example, a system module need not have a VRAM mapping.
-                        break;
-                    case PageType::RasterizerCachedMemory: {
-                        page_type = PageType::Memory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] =
-                            GetPointerForRasterizerCache(vaddr & ~CITRA_PAGE_MASK);
-                        break;
-                    }
-                    default:
-                        UNREACHABLE();
-                    }
-                }
-            }
+    // Pages up to the end of a memory region share their translation, update them as one run
+    while (paddr < end) {
+        const RasterizerMapping mapping = PhysicalToVirtualAddressForRasterizer(paddr);
+        const PAddr run_end = std::min(end, mapping.end);
+        const u32 num_pages = (run_end - paddr) >> CITRA_PAGE_BITS;
+        for (VAddr vaddr : mapping.VAddrs()) {
+            impl->MarkPagesCached(vaddr, num_pages, cached);
         }
+        paddr = run_end;
     }
 }
 
@@ -713,45 +832,32 @@ void MemorySystem::WriteBlock(const VAddr dest_addr, const void* src_buffer,
 
 void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_addr,
                              const std::size_t size) {
-    auto& page_table = *process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> CITRA_PAGE_BITS;
-    std::size_t page_offset = dest_addr & CITRA_PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr =
-            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                      "0x{:08X}",
-                      current_vaddr, dest_addr, size, impl->GetPC());
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memset(dest_ptr, 0, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Invalidate);
-            std::memset(GetPointerForRasterizerCache(current_vaddr), 0, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        remaining_size -= copy_amount;
-    }
+    const auto& page_table = *process.vm_manager.page_table;
+    impl->WalkBlock(page_table, dest_addr, size,
+                    [&](PageType type, VAddr vaddr, u8* dest_ptr, std::size_t, std::size_t amount) {
+                        switch (type) {
+                        case PageType::Unmapped: {
+                            LOG_ERROR(HW_Memory,
+                                      "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, "
+                                      "size = {}) at PC 0x{:08X}",
+                                      vaddr, dest_addr, size, impl->GetPC());
+                            break;
+                        }
+                        case PageType::Memory: {
+                            DEBUG_ASSERT(dest_ptr);
+                            std::memset(dest_ptr, 0, amount);
+                            break;
+                        }
+                        case PageType::RasterizerCachedMemory: {
+                            RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(amount),
+                                                         FlushMode::Invalidate);
+                            std::memset(dest_ptr, 0, amount);
+                            break;
+                        }
+                        default:
+                            UNREACHABLE();
+                        }
+                    });
 }
 
 void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
@@ -762,67 +868,215 @@ void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VA
 void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
                              const Kernel::Process& src_process, VAddr dest_addr, VAddr src_addr,
                              std::size_t size) {
-    auto& page_table = *src_process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
-    std::size_t page_offset = src_addr & CITRA_PAGE_MASK;
+    const auto& page_table = *src_process.vm_manager.page_table;
+    impl->WalkBlock(
+        page_table, src_addr, size,
+        [&](PageType type, VAddr vaddr, const u8* src_ptr, std::size_t offset, std::size_t amount) {
+            const VAddr run_dest_addr = dest_addr + static_cast<VAddr>(offset);
+            switch (type) {
+            case PageType::Unmapped: {
+                LOG_ERROR(HW_Memory,
+                          "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at "
+                          "PC 0x{:08X}",
+                          vaddr, src_addr, size, impl->GetPC());
+                ZeroBlock(dest_process, run_dest_addr, amount);
+                break;
+            }
+            case PageType::Memory: {
+                DEBUG_ASSERT(src_ptr);
+                WriteBlock(dest_process, run_dest_addr, src_ptr, amount);
+                break;
+            }
+            case PageType::RasterizerCachedMemory: {
+                RasterizerFlushVirtualRegion(vaddr, static_cast<u32>(amount), FlushMode::Flush);
+                WriteBlock(dest_process, run_dest_addr, src_ptr, amount);
+                break;
+            }
+            default:
+                UNREACHABLE();
+            }
+        });
+}
 
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr =
-            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
+u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
+    ASSERT(pointer >= impl->fcram && pointer <= impl->fcram + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram);
+}
 
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                      "0x{:08X}",
-                      current_vaddr, src_addr, size, impl->GetPC());
-            ZeroBlock(dest_process, dest_addr, copy_amount);
-            break;
+u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
+    ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
+    return impl->fcram + offset;
+}
+
+const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
+    ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
+    return impl->fcram + offset;
+}
+
+void MemorySystem::ZeroFCRAM(std::size_t offset, std::size_t size) {
+    ASSERT(offset + size <= Memory::FCRAM_N3DS_SIZE);
+    impl->backing.ClearBacking(offset, size);
+}
+
+std::span<u8, DSP_RAM_SIZE> MemorySystem::GetDspMemory() const {
+    return std::span<u8, DSP_RAM_SIZE>{impl->dsp_mem, DSP_RAM_SIZE};
+}
+
+void MemorySystem::SaveState(Core::StateWriter& writer, const PageHashes* base,
+                             PageHashes* page_hashes) const {
+    // Old 3DS titles never touch the extended FCRAM region, so avoid storing it in their states.
+    const u32 fcram_size = Settings::values.is_new_3ds.GetValue() ? FCRAM_N3DS_SIZE : FCRAM_SIZE;
+    const std::array<std::span<const u8>, 4> regions{{
+        {impl->fcram, fcram_size},
+        {impl->vram, VRAM_SIZE},
+        {impl->n3ds_extra_ram, N3DS_EXTRA_RAM_SIZE},
+        {impl->dsp_mem, DSP_RAM_SIZE},
+    }};
+
+    std::size_t num_pages = 0;
+    for (const auto& region : regions) {
+        num_pages += region.size() / CITRA_PAGE_SIZE;
+    }
+
+    if (page_hashes || base) {
+        PageHashes hashes;
+        hashes.reserve(num_pages);
+        for (const auto& region : regions) {
+            for (std::size_t offset = 0; offset < region.size(); offset += CITRA_PAGE_SIZE) {
+                hashes.push_back(Common::ComputeHash64(region.data() + offset, CITRA_PAGE_SIZE));
+            }
         }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
-            break;
+
+        // A base taken with a different FCRAM size can't be diffed against, store everything.
+        if (base && base->size() != num_pages) {
+            LOG_WARNING(HW_Memory, "Incremental savestate base doesn't match, storing full image");
+            base = nullptr;
         }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            WriteBlock(dest_process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
-            break;
+
+        if (base) {
+            writer.Write<u32>(Core::MakeStateTag("MEMD"));
+            writer.Write<u32>(fcram_size);
+
+            std::size_t page = 0;
+            for (const auto& region : regions) {
+                std::vector<u32> dirty_pages;
+                const u32 region_pages = static_cast<u32>(region.size() / CITRA_PAGE_SIZE);
+                for (u32 i = 0; i < region_pages; ++i, ++page) {
+                    if (hashes[page] != (*base)[page]) {
+                        dirty_pages.push_back(i);
+                    }
+                }
+
+                // Store all indices ahead of the page data to keep the latter contiguous, which
+                // compresses better.
+                writer.Write<u32>(static_cast<u32>(dirty_pages.size()));
+                writer.WriteBytes(dirty_pages.data(), dirty_pages.size() * sizeof(u32));
+                for (const u32 index : dirty_pages) {
+                    writer.WriteBytes(region.data() + index * CITRA_PAGE_SIZE, CITRA_PAGE_SIZE);
+                }
+            }
         }
-        default:
-            UNREACHABLE();
+
+        if (page_hashes) {
+            *page_hashes = std::move(hashes);
         }
+        if (base) {
+            return;
+        }
+    }
 
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
+    writer.Write<u32>(Core::MakeStateTag("MEMS"));
+    writer.Write<u32>(fcram_size);
+    for (const auto& region : regions) {
+        writer.WriteBytes(region.data(), region.size());
     }
 }
 
-u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+/// Reads the header of a memory section and returns whether it is incremental and its FCRAM size.
+static std::pair<bool, u32> ReadStateHeader(Core::StateReader& reader) {
+    const u32 tag = reader.Read<u32>();
+    if (tag != Core::MakeStateTag("MEMS") && tag != Core::MakeStateTag("MEMD")) {
+        throw std::runtime_error("Savestate section is corrupted");
+    }
+    const u32 fcram_size = reader.Read<u32>();
+    if (fcram_size > FCRAM_N3DS_SIZE) {
+        throw std::runtime_error("Savestate FCRAM size is invalid");
+    }
+    return {tag == Core::MakeStateTag("MEMD"), fcram_size};
 }
 
-u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
-    ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+/// Reads the body of a memory section. Incremental sections only overwrite the changed pages.
+static void ReadStateRegions(Core::StateReader& reader, bool incremental,
+                             std::span<const std::span<u8>> regions) {
+    if (!incremental) {
+        for (const auto& region : regions) {
+            reader.ReadBytes(region.data(), region.size());
+        }
+        return;
+    }
+
+    for (const auto& region : regions) {
+        std::vector<u32> dirty_pages(reader.Read<u32>());
+        reader.ReadBytes(dirty_pages.data(), dirty_pages.size() * sizeof(u32));
+        for (const u32 index : dirty_pages) {
+            if (index >= region.size() / CITRA_PAGE_SIZE) {
+                throw std::runtime_error("Savestate page index is out of range");
+            }
+            reader.ReadBytes(region.data() + index * CITRA_PAGE_SIZE, CITRA_PAGE_SIZE);
+        }
+    }
 }
 
-const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
-    ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+void MemorySystem::LoadState(Core::StateReader& reader) {
+    const auto [incremental, fcram_size] = ReadStateHeader(reader);
+    const std::array<std::span<u8>, 4> regions{{
+        {impl->fcram, fcram_size},
+        {impl->vram, VRAM_SIZE},
+        {impl->n3ds_extra_ram, N3DS_EXTRA_RAM_SIZE},
+        {impl->dsp_mem, DSP_RAM_SIZE},
+    }};
+
+    if (incremental) {
+        ReadStateRegions(reader, true, regions);
+        return;
+    }
+
+    // Start from released memory and only write the pages that aren't zero, so that memory the
+    // guest never used does not become resident on the host.
+    impl->backing.ClearBacking(0, impl->backing.BackingSize());
+    std::array<u8, CITRA_PAGE_SIZE> page;
+    for (const auto& region : regions) {
+        for (std::size_t offset = 0; offset < region.size(); offset += CITRA_PAGE_SIZE) {
+            reader.ReadBytes(page.data(), page.size());
+            if (std::any_of(page.begin(), page.end(), [](u8 value) { return value != 0; })) {
+                std::memcpy(region.data() + offset, page.data(), page.size());
+            }
+        }
+    }
 }
 
-std::span<u8, DSP_RAM_SIZE> MemorySystem::GetDspMemory() const {
-    return std::span<u8, DSP_RAM_SIZE>{impl->dsp_mem.get(), DSP_RAM_SIZE};
+void MemorySystem::MergeState(Core::StateReader& base, Core::StateReader& delta,
+                              Core::StateWriter& writer) {
+    const auto [base_incremental, fcram_size] = ReadStateHeader(base);
+    const auto [delta_incremental, delta_fcram_size] = ReadStateHeader(delta);
+    if (base_incremental || fcram_size != delta_fcram_size) {
+        throw std::runtime_error("Savestate memory sections can't be merged");
+    }
+
+    std::vector<u8> image(fcram_size + VRAM_SIZE + N3DS_EXTRA_RAM_SIZE + DSP_RAM_SIZE);
+    const std::array<std::span<u8>, 4> regions{{
+        {image.data(), fcram_size},
+        {image.data() + fcram_size, VRAM_SIZE},
+        {image.data() + fcram_size + VRAM_SIZE, N3DS_EXTRA_RAM_SIZE},
+        {image.data() + fcram_size + VRAM_SIZE + N3DS_EXTRA_RAM_SIZE, DSP_RAM_SIZE},
+    }};
+
+    ReadStateRegions(base, false, regions);
+    ReadStateRegions(delta, delta_incremental, regions);
+
+    writer.Write<u32>(Core::MakeStateTag("MEMS"));
+    writer.Write<u32>(fcram_size);
+    writer.WriteBytes(image.data(), image.size());
 }
 
 } // namespace Memory
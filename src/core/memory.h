@@ -5,8 +5,12 @@
 #pragma once
 #include <array>
 #include <cstddef>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 #include "common/common_types.h"
+#include "common/host_memory.h"
 
 namespace Kernel {
 class Process;
@@ -14,7 +18,9 @@ class Process;
 
 namespace Core {
 class System;
-}
+class StateReader;
+class StateWriter;
+} // namespace Core
 
 namespace AudioCore {
 class DspInterface;
@@ -65,9 +71,19 @@ struct PageTable {
     std::array<u8*, NUM_ENTRIES> pointers{};
     std::array<PageType, NUM_ENTRIES> attributes{};
 
+    /**
+     * Host view of the whole guest address space, used by the JIT to access memory without going
+     * through the page table. Only pages of type `Memory` are accessible in it, any other access
+     * faults so that the JIT falls back to the memory callbacks. Null when fastmem is disabled.
+     */
+    std::unique_ptr<Common::VirtualArena> fastmem_arena;
+
     void Clear();
 };
 
+/// Size of the fastmem arena of a page table, covering the whole 32-bit guest address space.
+constexpr std::size_t FastmemArenaSize = 1ULL << 32;
+
 /// Physical memory regions as seen from the ARM11
 enum : PAddr {
     /// IO register area
@@ -180,6 +196,13 @@ enum : VAddr {
     PLUGIN_3GX_FB_VADDR_END = PLUGIN_3GX_FB_VADDR + PLUGIN_3GX_FB_SIZE
 };
 
+/**
+ * Content hashes of every physical memory page at the time a snapshot was taken. Guest writes
+ * through the JIT page table bypass MemorySystem entirely, so comparing page contents is what
+ * allows later snapshots to store only the pages that changed since then.
+ */
+using PageHashes = std::vector<u64>;
+
 enum class FlushMode {
     /// Write back modified surfaces to RAM
     Flush,
@@ -230,6 +253,15 @@ public:
      */
     const u8* GetPointer(VAddr vaddr) const;
 
+    /**
+     * Gets a pointer to the given address in the address space of a process.
+     *
+     * @returns The pointer to the given address, if the page is backed by plain memory.
+     *          Otherwise nullptr is returned, and the address has to be accessed with ReadBlock
+     *          and WriteBlock.
+     */
+    u8* GetPointer(const Kernel::Process& process, VAddr vaddr);
+
     /**
      * Reads an 8-bit unsigned value from the current process' address space
      * at the given virtual address.
@@ -470,8 +502,20 @@ public:
      */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
-    /// For a rasterizer-accessible PAddr, gets a list of all possible VAddr
-    std::vector<VAddr> PhysicalToVirtualAddressForRasterizer(PAddr addr);
+    /// Virtual addresses a rasterizer-accessible physical address is mapped at
+    struct RasterizerMapping {
+        std::array<VAddr, 2> vaddrs{};
+        u32 num_vaddrs = 0;
+        /// The following physical addresses map to the following virtual ones up to this address
+        PAddr end = 0;
+
+        std::span<const VAddr> VAddrs() const {
+            return {vaddrs.data(), num_vaddrs};
+        }
+    };
+
+    /// For a rasterizer-accessible PAddr, gets all possible VAddr
+    RasterizerMapping PhysicalToVirtualAddressForRasterizer(PAddr addr);
 
     /// Gets a pointer to the memory region beginning at the specified physical address.
     u8* GetPhysicalPointer(PAddr address) const;
@@ -494,6 +538,9 @@ public:
     /// Gets pointer in FCRAM with given offset
     const u8* GetFCRAMPointer(std::size_t offset) const;
 
+    /// Zeroes a range of FCRAM, releasing the host pages behind it until the guest touches them
+    void ZeroFCRAM(std::size_t offset, std::size_t size);
+
     /// Registers page table for rasterizer cache marking
     void RegisterPageTable(std::shared_ptr<PageTable> page_table);
 
@@ -504,6 +551,28 @@ public:
 
     void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode);
 
+    /**
+     * Writes the contents of FCRAM, VRAM, N3DS extra RAM and DSP RAM to a savestate stream.
+     * @param base If set, only the pages whose contents differ from this base are written.
+     * @param page_hashes If set, receives the hashes of all pages so the state can become a base.
+     */
+    void SaveState(Core::StateWriter& writer, const PageHashes* base = nullptr,
+                   PageHashes* page_hashes = nullptr) const;
+
+    /**
+     * Restores the physical memory contents from a savestate stream. Incremental states only
+     * contain the changed pages, so memory must already hold the contents of their base.
+     * @note The rasterizer cache must be cleared beforehand, as no flushes/invalidations are done.
+     */
+    void LoadState(Core::StateReader& reader);
+
+    /**
+     * Combines a full memory section with a following one into a single full section, so older
+     * incremental states can be folded into their base.
+     */
+    static void MergeState(Core::StateReader& base, Core::StateReader& delta,
+                           Core::StateWriter& writer);
+
 private:
     template <typename T>
     T Read(const VAddr vaddr);
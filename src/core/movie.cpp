@@ -3,9 +3,12 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 #include <boost/optional.hpp>
 #include <cryptopp/hex.h>
@@ -16,13 +19,16 @@
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "common/swap.h"
+#include "common/thread_worker.h"
 #include "common/timer.h"
+#include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/ir/extra_hid.h"
 #include "core/hle/service/ir/ir_rst.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
+#include "core/savestate.h"
 
 namespace Core {
 
@@ -121,12 +127,263 @@ struct CTMHeader {
     u32_le rerecord_count;       /// Number of rerecords when making the movie
     u64_le input_count;          /// Number of inputs (button and pad states) when making the movie
     s64_le timing_base_ticks;    /// The base system tick count to initialize core timing with.
+    u32_le format;               /// Layout of the data following the header, see MovieFormat
+    u64_le index_offset;         /// Offset of the chunk and keyframe index (chunked format)
+    u32_le chunk_count;          /// Number of chunks of input states (chunked format)
+    u32_le keyframe_count;       /// Number of savestate keyframes (chunked format)
 
-    std::array<u8, 156> reserved; /// Make heading 256 bytes so it has consistent size
+    std::array<u8, 136> reserved; /// Make heading 256 bytes so it has consistent size
 };
 static_assert(sizeof(CTMHeader) == 256, "CTMHeader should be 256 bytes");
+
+/// Index entry of a chunk of input states
+struct CTMChunk {
+    u64_le offset;          /// Offset of the compressed chunk in the file
+    u32_le compressed_size; /// Size of the compressed chunk
+    u32_le size;            /// Size of the input states stored in the chunk
+    u64_le first_byte;      /// Offset of the first input state of the chunk in the input stream
+};
+static_assert(sizeof(CTMChunk) == 24, "CTMChunk should be 24 bytes");
+
+/// Index entry of a savestate keyframe
+struct CTMKeyframe {
+    u64_le offset;      /// Offset of the compressed savestate in the file
+    u64_le size;        /// Size of the compressed savestate
+    u64_le input_byte;  /// Offset in the input stream at which the savestate was captured
+    u64_le input_index; /// Number of pad inputs played before the savestate was captured
+};
+static_assert(sizeof(CTMKeyframe) == 32, "CTMKeyframe should be 32 bytes");
 #pragma pack(pop)
 
+enum class MovieFormat : u32 {
+    /// The input states follow the header uncompressed, as written by older versions
+    Raw = 0,
+    /// Zstandard compressed chunks of input states and savestate keyframes follow the header in
+    /// any order, the index locating them follows the last of them
+    Chunked = 1,
+};
+
+/// Uncompressed size of a full chunk, a whole number of input states so none spans two chunks
+constexpr std::size_t ChunkSize = sizeof(ControllerState) * 8192;
+constexpr s32 ChunkCompressionLevel = 19;
+
+/// Reads the input stream of a movie file, keeping only the chunk being played in memory
+class MovieReader {
+public:
+    /// Opens the movie file and reads its index. Returns false if the file is malformed.
+    bool Open(const std::string& movie_file, const CTMHeader& header) {
+        file = FileUtil::IOFile(movie_file, "rb");
+        const u64 file_size = file.GetSize();
+        if (!file || file_size < sizeof(CTMHeader)) {
+            return false;
+        }
+
+        if (header.format == static_cast<u32>(MovieFormat::Raw)) {
+            // Older movies are loaded as a single chunk
+            chunk.resize(file_size - sizeof(CTMHeader));
+            size = chunk.size();
+            return file.ReadAtBytes(chunk.data(), chunk.size(), sizeof(CTMHeader)) == chunk.size();
+        }
+        if (header.format != static_cast<u32>(MovieFormat::Chunked)) {
+            return false;
+        }
+
+        const u64 index_size = header.chunk_count * sizeof(CTMChunk) +
+                               header.keyframe_count * sizeof(CTMKeyframe);
+        if (header.index_offset < sizeof(CTMHeader) || header.index_offset > file_size ||
+            index_size > file_size - header.index_offset) {
+            return false;
+        }
+        chunks.resize(header.chunk_count);
+        keyframes.resize(header.keyframe_count);
+        const std::size_t chunks_size = chunks.size() * sizeof(CTMChunk);
+        const std::size_t keyframes_size = keyframes.size() * sizeof(CTMKeyframe);
+        const std::array<FileUtil::IOFile::ReadRange, 2> index_ranges{{
+            {header.index_offset, {reinterpret_cast<u8*>(chunks.data()), chunks_size}},
+            {header.index_offset + chunks_size,
+             {reinterpret_cast<u8*>(keyframes.data()), keyframes_size}},
+        }};
+        if (file.ReadAtRanges(index_ranges) != index_size) {
+            return false;
+        }
+
+        // Chunks have to cover the input stream in order, so they can be looked up by offset
+        for (const CTMChunk& entry : chunks) {
+            if (entry.first_byte != size || entry.size == 0 ||
+                entry.size % sizeof(ControllerState) != 0 || entry.offset > file_size ||
+                entry.compressed_size > file_size - entry.offset) {
+                return false;
+            }
+            size += entry.size;
+        }
+        u64 last_input = 0;
+        for (const CTMKeyframe& entry : keyframes) {
+            if (entry.input_byte > size || entry.input_index < last_input ||
+                entry.offset > file_size || entry.size > file_size - entry.offset) {
+                return false;
+            }
+            last_input = entry.input_index;
+        }
+        return true;
+    }
+
+    /// Returns the size of the input stream
+    u64 GetSize() const {
+        return size;
+    }
+
+    /**
+     * Returns the input states from the given offset of the input stream up to the end of the
+     * chunk holding it, loading the chunk if needed. Empty if the chunk could not be read.
+     */
+    std::span<const u8> GetInput(u64 offset) {
+        if ((offset < chunk_start || offset - chunk_start >= chunk.size()) && !LoadChunk(offset)) {
+            return {};
+        }
+        return std::span<const u8>{chunk}.subspan(offset - chunk_start);
+    }
+
+    /// Returns the keyframes ordered by input index
+    const std::vector<CTMKeyframe>& GetKeyframes() const {
+        return keyframes;
+    }
+
+    /// Returns the compressed savestate of a keyframe, empty if it could not be read
+    std::vector<u8> ReadKeyframe(const CTMKeyframe& keyframe) {
+        std::vector<u8> data(keyframe.size);
+        if (file.ReadAtBytes(data.data(), data.size(), keyframe.offset) != data.size()) {
+            return {};
+        }
+        return data;
+    }
+
+private:
+    bool LoadChunk(u64 offset) {
+        const auto it = std::upper_bound(
+            chunks.begin(), chunks.end(), offset,
+            [](u64 value, const CTMChunk& entry) { return value < entry.first_byte; });
+        if (it == chunks.begin()) {
+            return false;
+        }
+        const CTMChunk& entry = *std::prev(it);
+        if (offset - entry.first_byte >= entry.size) {
+            return false;
+        }
+
+        std::vector<u8> compressed(entry.compressed_size);
+        if (file.ReadAtBytes(compressed.data(), compressed.size(), entry.offset) !=
+            compressed.size()) {
+            return false;
+        }
+        auto data = Common::Compression::DecompressDataZSTD(compressed);
+        if (data.size() != entry.size) {
+            return false;
+        }
+        chunk = std::move(data);
+        chunk_start = entry.first_byte;
+        return true;
+    }
+
+    FileUtil::IOFile file;
+    std::vector<CTMChunk> chunks;
+    std::vector<CTMKeyframe> keyframes;
+    std::vector<u8> chunk; ///< Input states of the loaded chunk
+    u64 chunk_start{};     ///< Offset of the loaded chunk in the input stream
+    u64 size{};
+};
+
+/**
+ * Writes the chunks and keyframes of a recording to the movie file as they are produced, from a
+ * worker thread so the emulation thread never waits on compression or the disk.
+ */
+class MovieWriter {
+public:
+    explicit MovieWriter(const std::string& movie_file)
+        : file{movie_file, "wb"}, worker{1, "MovieWriter"} {}
+
+    bool IsGood() const {
+        return file.IsGood();
+    }
+
+    void WriteChunk(std::vector<u8> input, u64 first_byte) {
+        worker.QueueWork([this, input = std::move(input), first_byte] {
+            const auto compressed =
+                Common::Compression::CompressDataZSTD(input, ChunkCompressionLevel);
+            CTMChunk entry{};
+            entry.offset = end_offset;
+            entry.compressed_size = static_cast<u32>(compressed.size());
+            entry.size = static_cast<u32>(input.size());
+            entry.first_byte = first_byte;
+            if (compressed.empty() || !Write(compressed)) {
+                // Later chunks would not line up in the input stream anymore
+                LOG_ERROR(Movie, "Unable to write movie chunk");
+                failed = true;
+                return;
+            }
+            chunks.push_back(entry);
+        });
+    }
+
+    void WriteKeyframe(StateSnapshot snapshot, u64 input_byte, u64 input_index) {
+        worker.QueueWork([this, snapshot = std::move(snapshot), input_byte, input_index]() mutable {
+            try {
+                CompressSnapshot(snapshot);
+            } catch (const std::exception& e) {
+                LOG_ERROR(Movie, "Unable to compress movie keyframe: {}", e.what());
+                return;
+            }
+            CTMKeyframe entry{};
+            entry.offset = end_offset;
+            entry.size = snapshot.data.size();
+            entry.input_byte = input_byte;
+            entry.input_index = input_index;
+            if (!Write(snapshot.data)) {
+                LOG_ERROR(Movie, "Unable to write movie keyframe");
+                return;
+            }
+            keyframes.push_back(entry);
+        });
+    }
+
+    /**
+     * Writes the index and the given header once everything queued is written. Data written
+     * afterwards replaces the index, so this can be called again to save a longer recording.
+     */
+    bool Finish(CTMHeader header) {
+        worker.WaitForRequests();
+
+        header.format = static_cast<u32>(MovieFormat::Chunked);
+        header.index_offset = end_offset;
+        header.chunk_count = static_cast<u32>(chunks.size());
+        header.keyframe_count = static_cast<u32>(keyframes.size());
+        file.Seek(end_offset, SEEK_SET);
+        file.WriteArray(chunks.data(), chunks.size());
+        file.WriteArray(keyframes.data(), keyframes.size());
+        file.Seek(0, SEEK_SET);
+        file.WriteObject(header);
+        file.Flush();
+        return !failed && file.IsGood();
+    }
+
+private:
+    bool Write(std::span<const u8> data) {
+        if (!file.Seek(end_offset, SEEK_SET) ||
+            file.WriteBytes(data.data(), data.size()) != data.size()) {
+            return false;
+        }
+        end_offset += data.size();
+        return true;
+    }
+
+    FileUtil::IOFile file;
+    u64 end_offset{sizeof(CTMHeader)}; ///< The header is written last, once the index is known
+    std::vector<CTMChunk> chunks;
+    std::vector<CTMKeyframe> keyframes;
+    bool failed{};
+
+    Common::ThreadWorker worker; ///< Declared last so pending writes finish before the rest goes
+};
+
 static u64 GetInputCount(std::span<const u8> input) {
     u64 input_count = 0;
     for (std::size_t pos = 0; pos < input.size(); pos += sizeof(ControllerState)) {
@@ -143,7 +400,7 @@ static u64 GetInputCount(std::span<const u8> input) {
     return input_count;
 }
 
-Movie::Movie(const Core::System& system_) : system{system_} {}
+Movie::Movie(Core::System& system_) : system{system_} {}
 
 Movie::~Movie() = default;
 
@@ -159,17 +416,41 @@ u64 Movie::GetTotalInputCount() const {
 }
 
 void Movie::CheckInputEnd() {
-    if (current_byte + sizeof(ControllerState) > recorded_input.size()) {
+    if (play_mode == PlayMode::Playing &&
+        current_byte + sizeof(ControllerState) > reader->GetSize()) {
         LOG_INFO(Movie, "Playback finished");
         play_mode = PlayMode::MovieFinished;
         playback_completion_callback();
     }
 }
 
+bool Movie::ReadState(ControllerState& state) {
+    const auto input = reader->GetInput(current_byte);
+    if (input.size() < sizeof(ControllerState)) {
+        LOG_ERROR(Movie, "Unable to read movie input at offset {}, playback stopped", current_byte);
+        play_mode = PlayMode::MovieFinished;
+        playback_completion_callback();
+        return false;
+    }
+    std::memcpy(&state, input.data(), sizeof(ControllerState));
+    current_byte += sizeof(ControllerState);
+    return true;
+}
+
+void Movie::FlushChunk() {
+    if (recorded_input.empty()) {
+        return;
+    }
+    const std::size_t first_byte = current_byte - recorded_input.size();
+    writer->WriteChunk(std::exchange(recorded_input, {}), first_byte);
+    recorded_input.reserve(ChunkSize);
+}
+
 void Movie::Play(Service::HID::PadState& pad_state, s16& circle_pad_x, s16& circle_pad_y) {
     ControllerState s{};
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
-    current_byte += sizeof(ControllerState);
+    if (!ReadState(s)) {
+        return;
+    }
     current_input++;
 
     if (s.type != ControllerStateType::PadAndCircle) {
@@ -200,8 +481,9 @@ void Movie::Play(Service::HID::PadState& pad_state, s16& circle_pad_x, s16& circ
 
 void Movie::Play(Service::HID::TouchDataEntry& touch_data) {
     ControllerState s{};
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
-    current_byte += sizeof(ControllerState);
+    if (!ReadState(s)) {
+        return;
+    }
 
     if (s.type != ControllerStateType::Touch) {
         LOG_ERROR(Movie,
@@ -217,8 +499,9 @@ void Movie::Play(Service::HID::TouchDataEntry& touch_data) {
 
 void Movie::Play(Service::HID::AccelerometerDataEntry& accelerometer_data) {
     ControllerState s{};
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
-    current_byte += sizeof(ControllerState);
+    if (!ReadState(s)) {
+        return;
+    }
 
     if (s.type != ControllerStateType::Accelerometer) {
         LOG_ERROR(Movie,
@@ -234,8 +517,9 @@ void Movie::Play(Service::HID::AccelerometerDataEntry& accelerometer_data) {
 
 void Movie::Play(Service::HID::GyroscopeDataEntry& gyroscope_data) {
     ControllerState s{};
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
-    current_byte += sizeof(ControllerState);
+    if (!ReadState(s)) {
+        return;
+    }
 
     if (s.type != ControllerStateType::Gyroscope) {
         LOG_ERROR(Movie,
@@ -251,8 +535,9 @@ void Movie::Play(Service::HID::GyroscopeDataEntry& gyroscope_data) {
 
 void Movie::Play(Service::IR::PadState& pad_state, s16& c_stick_x, s16& c_stick_y) {
     ControllerState s{};
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
-    current_byte += sizeof(ControllerState);
+    if (!ReadState(s)) {
+        return;
+    }
 
     if (s.type != ControllerStateType::IrRst) {
         LOG_ERROR(Movie,
@@ -269,8 +554,9 @@ void Movie::Play(Service::IR::PadState& pad_state, s16& c_stick_x, s16& c_stick_
 
 void Movie::Play(Service::IR::ExtraHIDResponse& extra_hid_response) {
     ControllerState s{};
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
-    current_byte += sizeof(ControllerState);
+    if (!ReadState(s)) {
+        return;
+    }
 
     if (s.type != ControllerStateType::ExtraHidResponse) {
         LOG_ERROR(Movie,
@@ -291,9 +577,12 @@ void Movie::Play(Service::IR::ExtraHIDResponse& extra_hid_response) {
 }
 
 void Movie::Record(const ControllerState& controller_state) {
-    recorded_input.resize(current_byte + sizeof(ControllerState));
-    std::memcpy(&recorded_input[current_byte], &controller_state, sizeof(ControllerState));
+    const auto* bytes = reinterpret_cast<const u8*>(&controller_state);
+    recorded_input.insert(recorded_input.end(), bytes, bytes + sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
+    if (recorded_input.size() >= ChunkSize) {
+        FlushChunk();
+    }
 }
 
 void Movie::Record(const Service::HID::PadState& pad_state, const s16& circle_pad_x,
@@ -408,16 +697,24 @@ Movie::ValidationResult Movie::ValidateHeader(const CTMHeader& header) const {
     return ValidationResult::OK;
 }
 
-Movie::ValidationResult Movie::ValidateInput(std::span<const u8> input, u64 expected_count) const {
-    return GetInputCount(input) == expected_count ? ValidationResult::OK
-                                                  : ValidationResult::InputCountDismatch;
+Movie::ValidationResult Movie::ValidateInput(MovieReader& movie_reader,
+                                             u64 expected_count) const {
+    u64 input_count = 0;
+    for (u64 offset = 0; offset < movie_reader.GetSize();) {
+        const auto input = movie_reader.GetInput(offset);
+        if (input.empty()) {
+            return ValidationResult::Invalid;
+        }
+        input_count += GetInputCount(input);
+        offset += input.size();
+    }
+    return input_count == expected_count ? ValidationResult::OK
+                                         : ValidationResult::InputCountDismatch;
 }
 
 void Movie::SaveMovie() {
     LOG_INFO(Movie, "Saving recorded movie to '{}'", record_movie_file);
-    FileUtil::IOFile save_record(record_movie_file, "wb");
-
-    if (!save_record.IsGood()) {
+    if (!writer || !writer->IsGood()) {
         LOG_ERROR(Movie, "Unable to open file to save movie");
         return;
     }
@@ -433,17 +730,16 @@ void Movie::SaveMovie() {
                 std::min(header.author.size(), record_movie_author.size()));
 
     header.rerecord_count = rerecord_count;
-    header.input_count = GetInputCount(recorded_input);
+    header.input_count = current_input;
 
     std::string rev_bytes;
     CryptoPP::StringSource(Common::g_scm_rev, true,
                            new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
     std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(CTMHeader::revision));
 
-    save_record.WriteBytes(&header, sizeof(CTMHeader));
-    save_record.WriteBytes(recorded_input.data(), recorded_input.size());
-
-    if (!save_record.IsGood()) {
+    // Recording continues in a new chunk, so the saved file holds everything recorded so far
+    FlushChunk();
+    if (!writer->Finish(header)) {
         LOG_ERROR(Movie, "Error saving movie");
     }
 }
@@ -461,6 +757,13 @@ void Movie::StartPlayback(const std::string& movie_file) {
         CTMHeader header;
         save_record.ReadArray(&header, 1);
         if (ValidateHeader(header) != ValidationResult::Invalid) {
+            reader = std::make_unique<MovieReader>();
+            if (!reader->Open(movie_file, header)) {
+                LOG_ERROR(Movie, "Failed to playback movie: '{}' is corrupted", movie_file);
+                reader.reset();
+                return;
+            }
+
             play_mode = PlayMode::Playing;
             record_movie_file = movie_file;
 
@@ -471,9 +774,6 @@ void Movie::StartPlayback(const std::string& movie_file) {
             rerecord_count = header.rerecord_count;
             total_input = header.input_count;
 
-            recorded_input.resize(size - sizeof(CTMHeader));
-            save_record.ReadArray(recorded_input.data(), recorded_input.size());
-
             current_byte = 0;
             current_input = 0;
             id = header.id;
@@ -492,6 +792,13 @@ void Movie::StartRecording(const std::string& movie_file, const std::string& aut
     record_movie_author = author;
     rerecord_count = 1;
 
+    writer = std::make_unique<MovieWriter>(movie_file);
+    if (!writer->IsGood()) {
+        LOG_ERROR(Movie, "Unable to open file '{}' to save movie", movie_file);
+    }
+    recorded_input.reserve(ChunkSize);
+    last_keyframe_frame.reset();
+
     // Generate a random ID
     CryptoPP::AutoSeededRandomPool rng;
     rng.GenerateBlock(reinterpret_cast<CryptoPP::byte*>(&id), sizeof(id));
@@ -576,9 +883,11 @@ Movie::ValidationResult Movie::ValidateMovie(const std::string& movie_file) cons
         return ValidationResult::OK;
     }
 
-    std::vector<u8> input(size - sizeof(header));
-    save_record.ReadArray(input.data(), input.size());
-    return ValidateInput(input, header.input_count);
+    MovieReader movie_reader;
+    if (!movie_reader.Open(movie_file, header)) {
+        return ValidationResult::Invalid;
+    }
+    return ValidateInput(movie_reader, header.input_count);
 }
 
 Movie::MovieMetadata Movie::GetMovieMetadata(const std::string& movie_file) const {
@@ -599,7 +908,10 @@ void Movie::Shutdown() {
     }
 
     play_mode = PlayMode::None;
-    recorded_input.resize(0);
+    reader.reset();
+    writer.reset();
+    recorded_input = {};
+    last_keyframe_frame.reset();
     record_movie_file.clear();
     current_byte = 0;
     current_input = 0;
@@ -608,10 +920,63 @@ void Movie::Shutdown() {
     id = 0;
 }
 
+void Movie::OnFrame(u64 game_frame) {
+    const u32 interval = Settings::values.movie_keyframe_interval.GetValue();
+    if (play_mode != PlayMode::Recording || interval == 0) {
+        return;
+    }
+    if (!last_keyframe_frame) {
+        last_keyframe_frame = game_frame;
+        return;
+    }
+    if (game_frame - *last_keyframe_frame < interval) {
+        return;
+    }
+    last_keyframe_frame = game_frame;
+
+    try {
+        writer->WriteKeyframe(system.CaptureSnapshot(), current_byte, current_input);
+    } catch (const std::exception& e) {
+        LOG_ERROR(Movie, "Unable to capture movie keyframe: {}", e.what());
+    }
+}
+
+bool Movie::SeekToInput(u64 input_index) {
+    if (!reader || (play_mode != PlayMode::Playing && play_mode != PlayMode::MovieFinished)) {
+        return false;
+    }
+
+    // Keyframes count every pad input, the input index only counts those of full frames
+    const auto target = static_cast<u64>(std::nearbyint(input_index * 234.0 / SCREEN_REFRESH_RATE));
+    const auto& keyframes = reader->GetKeyframes();
+    const auto it = std::upper_bound(
+        keyframes.begin(), keyframes.end(), target,
+        [](u64 value, const CTMKeyframe& entry) { return value < entry.input_index; });
+    if (it == keyframes.begin()) {
+        return false;
+    }
+    const CTMKeyframe& keyframe = *std::prev(it);
+
+    StateSnapshot snapshot{};
+    snapshot.compressed = true;
+    snapshot.data = reader->ReadKeyframe(keyframe);
+    if (snapshot.data.empty()) {
+        throw std::runtime_error("Could not read movie keyframe");
+    }
+    system.RestoreSnapshot(snapshot);
+
+    current_byte = keyframe.input_byte;
+    current_input = keyframe.input_index;
+    play_mode = PlayMode::Playing;
+    LOG_INFO(Movie, "Movie playback continues from keyframe at input {}", GetCurrentInputIndex());
+    CheckInputEnd();
+    return true;
+}
+
 template <typename... Targs>
 void Movie::Handle(Targs&... Fargs) {
     if (play_mode == PlayMode::Playing) {
-        ASSERT(current_byte + sizeof(ControllerState) <= recorded_input.size());
+        ASSERT(current_byte + sizeof(ControllerState) <= reader->GetSize());
         Play(Fargs...);
         CheckInputEnd();
     } else if (play_mode == PlayMode::Recording) {
@@ -5,7 +5,10 @@
 #pragma once
 
 #include <functional>
-#include <span>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Service {
@@ -24,6 +27,8 @@ union PadState;
 namespace Core {
 
 class System;
+class MovieReader;
+class MovieWriter;
 struct CTMHeader;
 struct ControllerState;
 
@@ -43,7 +48,7 @@ public:
         Invalid,
     };
 
-    explicit Movie(const Core::System& system);
+    explicit Movie(Core::System& system);
     ~Movie();
 
     void SetPlaybackCompletionCallback(std::function<void()> completion_callback);
@@ -91,6 +96,20 @@ public:
 
     void Shutdown();
 
+    /**
+     * Stores a savestate keyframe in the movie being recorded if enough game frames have passed
+     * since the last one. Must be called from the emulation thread, between slices.
+     */
+    void OnFrame(u64 game_frame);
+
+    /**
+     * Restores the last keyframe of the movie being played that is not past the given input, so
+     * playback continues from there. Must be called from the emulation thread, between slices.
+     * @returns false if the movie has no keyframe before the input.
+     * @throws std::runtime_error if the keyframe could not be restored.
+     */
+    bool SeekToInput(u64 input_index);
+
     /**
      * When recording: Takes a copy of the given input states so they can be used for playback
      * When playing: Replaces the given input states with the ones stored in the playback file
@@ -141,6 +160,12 @@ public:
 private:
     void CheckInputEnd();
 
+    /// Reads the next input state of the movie being played, ending playback if it is unreadable
+    bool ReadState(ControllerState& state);
+
+    /// Hands the input states recorded since the last chunk over to the writer
+    void FlushChunk();
+
     template <typename... Targs>
     void Handle(Targs&... Fargs);
 
@@ -161,10 +186,10 @@ private:
     void Record(const Service::IR::ExtraHIDResponse& extra_hid_response);
 
     ValidationResult ValidateHeader(const CTMHeader& header) const;
-    ValidationResult ValidateInput(std::span<const u8> input, u64 expected_count) const;
+    ValidationResult ValidateInput(MovieReader& reader, u64 expected_count) const;
 
 private:
-    const Core::System& system;
+    Core::System& system;
     PlayMode play_mode;
 
     std::string record_movie_file;
@@ -173,8 +198,11 @@ private:
     u64 init_time;       // Clock init time override for RNG consistency
     s64 base_ticks = -1; // Core timing base system ticks override for RNG consistency
 
-    std::vector<u8> recorded_input;
-    std::size_t current_byte = 0;
+    std::unique_ptr<MovieReader> reader; // Input of the movie being played
+    std::unique_ptr<MovieWriter> writer; // File of the movie being recorded
+
+    std::vector<u8> recorded_input; // Input states recorded since the last chunk was written
+    std::size_t current_byte = 0;   // Offset of the next input state in the input stream
     u64 current_input = 0;
     // Total input count of the current movie being played. Not used for recording.
     u64 total_input = 0;
@@ -183,6 +211,7 @@ private:
     u64 program_id = 0;
     u32 rerecord_count = 1;
     bool read_only = true;
+    std::optional<u64> last_keyframe_frame; // Game frame of the last keyframe while recording
 
     std::function<void()> playback_completion_callback = [] {};
 };
@@ -2,16 +2,105 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <fmt/format.h>
 #include <httplib.h>
+#include "common/file_util.h"
 #include "common/logging/log.h"
 #include "core/nus_download.h"
 
 namespace Core::NUS {
 
-std::optional<std::vector<u8>> Download(const std::string& path) {
-    constexpr auto HOST = "http://nus.cdn.c.shop.nintendowifi.net";
+namespace {
+
+constexpr auto HOST = "http://nus.cdn.c.shop.nintendowifi.net";
+
+// Files are split in ranges of at least this size, so small contents take a single request
+constexpr u64 MinRangeSize = 4 * 1024 * 1024;
+constexpr u64 MaxParallelRanges = 4;
+constexpr int MaxRangeAttempts = 4;
+
+/**
+ * Downloads the bytes [begin, end) of path into file at the same offset. When use_range is false
+ * the whole file is requested, which needs begin to be 0 and end the size of the file.
+ * @returns false if the range could not be downloaded, ranges_unsupported is set if the server
+ * answered a range request with the whole file
+ */
+bool DownloadRange(const std::string& path, const std::string& file_path, u64 begin, u64 end,
+                   bool use_range, std::atomic<bool>& ranges_unsupported) {
+    FileUtil::IOFile file(file_path, "r+b");
+    if (!file.IsOpen()) {
+        LOG_ERROR(WebService, "Could not open {}", file_path);
+        return false;
+    }
+
+    httplib::Client client(HOST);
+    client.set_follow_location(true);
+
+    u64 position = begin;
+    for (int attempt = 0; attempt < MaxRangeAttempts && position < end; ++attempt) {
+        if (attempt > 0) {
+            LOG_WARNING(WebService, "Resuming GET to {}{} at byte {}", HOST, path, position);
+        }
+        if (!use_range) {
+            // Without ranges a failed download can only be restarted
+            position = begin;
+        }
+        if (!file.Seek(static_cast<s64>(position), SEEK_SET)) {
+            return false;
+        }
+
+        httplib::Headers headers;
+        if (use_range) {
+            headers.emplace("Range", fmt::format("bytes={}-{}", position, end - 1));
+        }
+
+        int error_status = 0;
+        client.Get(
+            path, headers,
+            [&](const httplib::Response& response) {
+                if (use_range && response.status == 200) {
+                    ranges_unsupported = true;
+                    return false;
+                }
+                if (response.status >= 400) {
+                    error_status = response.status;
+                    return false;
+                }
+                return true;
+            },
+            [&](const char* data, std::size_t length) {
+                length = static_cast<std::size_t>(std::min<u64>(length, end - position));
+                if (file.WriteBytes(data, length) != length) {
+                    return false;
+                }
+                position += length;
+                return true;
+            });
+        if (ranges_unsupported) {
+            return false;
+        }
+        if (error_status != 0) {
+            LOG_ERROR(WebService, "GET to {}{} returned error status code: {}", HOST, path,
+                      error_status);
+            return false;
+        }
+    }
+
+    if (position < end) {
+        LOG_ERROR(WebService, "GET to {}{} failed after {} attempts", HOST, path,
+                  MaxRangeAttempts);
+        return false;
+    }
+    return true;
+}
+
+} // Anonymous namespace
 
+std::optional<std::vector<u8>> Download(const std::string& path) {
     std::unique_ptr<httplib::Client> client = std::make_unique<httplib::Client>(HOST);
     if (client == nullptr) {
         LOG_ERROR(WebService, "Invalid URL {}{}", HOST, path);
@@ -46,4 +135,38 @@ std::optional<std::vector<u8>> Download(const std::string& path) {
     return std::vector<u8>(response.body.begin(), response.body.end());
 }
 
+bool DownloadToFile(const std::string& path, const std::string& file_path, u64 size) {
+    {
+        FileUtil::IOFile file(file_path, "wb");
+        if (!file.IsOpen() || !file.Resize(size)) {
+            LOG_ERROR(WebService, "Could not create {}", file_path);
+            return false;
+        }
+    }
+
+    const u64 range_count = std::clamp<u64>(size / MinRangeSize, 1, MaxParallelRanges);
+    const u64 range_size = size / range_count;
+    std::atomic<bool> ranges_unsupported = false;
+    std::atomic<bool> failed = false;
+    {
+        std::vector<std::jthread> workers;
+        for (u64 i = 0; i < range_count; ++i) {
+            const u64 begin = i * range_size;
+            const u64 end = i == range_count - 1 ? size : begin + range_size;
+            workers.emplace_back([&, begin, end] {
+                if (!DownloadRange(path, file_path, begin, end, range_count > 1,
+                                   ranges_unsupported)) {
+                    failed = true;
+                }
+            });
+        }
+    }
+
+    if (ranges_unsupported) {
+        LOG_WARNING(WebService, "{}{} does not support ranges, downloading it whole", HOST, path);
+        return DownloadRange(path, file_path, 0, size, false, ranges_unsupported);
+    }
+    return !failed;
+}
+
 } // namespace Core::NUS
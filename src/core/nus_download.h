@@ -5,6 +5,7 @@
 #pragma once
 
 #include <optional>
+#include <string>
 #include <vector>
 #include "common/common_types.h"
 
@@ -12,4 +13,14 @@ namespace Core::NUS {
 
 std::optional<std::vector<u8>> Download(const std::string& path);
 
+/**
+ * Downloads a file of a known size straight to disk. Large files are split into ranges that are
+ * downloaded in parallel, and a range that fails is resumed from the last byte received.
+ * @param path path of the file on the server
+ * @param file_path path of the file to write
+ * @param size size of the file, as stated by its TMD
+ * @returns whether the whole file was downloaded
+ */
+bool DownloadToFile(const std::string& path, const std::string& file_path, u64 size);
+
 } // namespace Core::NUS
@@ -12,6 +12,7 @@
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
+#include "common/scm_rev.h"
 #include "common/settings.h"
 #include "core/core_timing.h"
 #include "core/perf_stats.h"
@@ -21,17 +22,40 @@ using namespace std::chrono_literals;
 using DoubleSecs = std::chrono::duration<double, std::chrono::seconds::period>;
 using std::chrono::duration_cast;
 using std::chrono::microseconds;
+using std::chrono::nanoseconds;
 
 // Purposefully ignore the first five frames, as there's a significant amount of overhead in
 // booting that we shouldn't account for
 constexpr std::size_t IgnoreFrames = 5;
 
+// Upper bound of the frametimes kept for the percentiles, a bit more than a minute of frames
+constexpr std::size_t MaxIntervalFrames = 4096;
+
+namespace {
+
+/// Returns the value below which the given fraction of the sorted values lie
+double Percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+} // Anonymous namespace
+
 namespace Core {
 
 PerfStats::PerfStats(u64 title_id) : title_id(title_id) {}
 
 PerfStats::~PerfStats() {
-    if (!Settings::values.record_frame_times || title_id == 0) {
+    if (title_id == 0) {
+        return;
+    }
+    if (Settings::values.export_session_stats) {
+        WriteSessionStats();
+    }
+    if (!Settings::values.record_frame_times) {
         return;
     }
 
@@ -47,10 +71,83 @@ PerfStats::~PerfStats() {
     file.WriteString(stream.str());
 }
 
+void PerfStats::WriteSessionStats() const {
+    std::scoped_lock lock{object_mutex};
+
+    std::vector<double> frametimes;
+    if (current_index > IgnoreFrames) {
+        frametimes.reserve(current_index - IgnoreFrames);
+        std::transform(perf_history.begin() + IgnoreFrames, perf_history.begin() + current_index,
+                       std::back_inserter(frametimes), [](double ms) { return ms / 1000.0; });
+    }
+    std::sort(frametimes.begin(), frametimes.end());
+    const double frametime_sum = std::accumulate(frametimes.begin(), frametimes.end(), 0.0);
+    const double duration = duration_cast<DoubleSecs>(Clock::now() - session_begin).count();
+    const double hit_ratio =
+        pipeline_lookups == 0 ? 0.0 : static_cast<double>(pipeline_hits) / pipeline_lookups;
+
+    // Every sample carries the title, so the files of many titles can be collected together
+    const std::string labels = fmt::format("title_id=\"{:016X}\"", title_id);
+    std::string out;
+    const auto metric = [&](std::string_view name, std::string_view type, std::string_view help) {
+        out += fmt::format("# HELP citra_{} {}\n# TYPE citra_{} {}\n", name, help, name, type);
+    };
+    const auto sample = [&](std::string_view name, auto value, std::string_view extra = {}) {
+        out += fmt::format("citra_{}{{{}{}}} {}\n", name, labels, extra, value);
+    };
+
+    metric("build_info", "gauge", "Build of the emulator that ran the session");
+    sample("build_info", 1, fmt::format(",version=\"{}\"", Common::g_build_fullname));
+    metric("session_duration_seconds", "gauge", "Walltime the title ran for");
+    sample("session_duration_seconds", duration);
+    metric("game_frames_total", "counter", "Game frames submitted by the title");
+    sample("game_frames_total", total_game_frames.load(std::memory_order_relaxed));
+    metric("frametime_seconds", "summary",
+           "Walltime per system frame excluding waits, up to the first hour");
+    for (const double quantile : {0.5, 0.9, 0.95, 0.99}) {
+        sample("frametime_seconds", Percentile(frametimes, quantile),
+               fmt::format(",quantile=\"{}\"", quantile));
+    }
+    sample("frametime_seconds_sum", frametime_sum);
+    sample("frametime_seconds_count", frametimes.size());
+    metric("frametime_max_seconds", "gauge", "Longest system frame excluding waits");
+    sample("frametime_max_seconds", frametimes.empty() ? 0.0 : frametimes.back());
+    metric("pipeline_cache_lookups_total", "counter", "Pipelines requested by draws");
+    sample("pipeline_cache_lookups_total", pipeline_lookups);
+    metric("pipeline_cache_hits_total", "counter", "Requests that found the pipeline created");
+    sample("pipeline_cache_hits_total", pipeline_hits);
+    metric("pipeline_cache_hit_ratio", "gauge", "Share of requests that found the pipeline");
+    sample("pipeline_cache_hit_ratio", hit_ratio);
+    metric("shader_compile_stalls_total", "counter",
+           "Draws that waited for or skipped a pipeline still compiling");
+    sample("shader_compile_stalls_total", pipeline_compile_stalls);
+    metric("texture_memory_peak_bytes", "gauge", "Highest memory occupied by cached textures");
+    sample("texture_memory_peak_bytes", peak_texture_memory_usage);
+    metric("texture_memory_budget_bytes", "gauge", "Memory budget of cached textures");
+    sample("texture_memory_budget_bytes", texture_memory_budget);
+    metric("audio_underruns_total", "counter", "Audio callbacks that ran out of samples");
+    sample("audio_underruns_total", total_audio_underruns);
+
+    // The file of a title is replaced by every session, it reports the latest one
+    const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    const std::string filename = fmt::format("{}/session_stats_{:016X}.prom", path, title_id);
+    FileUtil::IOFile file(filename, "w");
+    if (file.WriteString(out) != out.size()) {
+        LOG_ERROR(Core, "Failed to write the session statistics to {}", filename);
+    }
+}
+
 void PerfStats::BeginSystemFrame() {
     std::scoped_lock lock{object_mutex};
 
     frame_begin = Clock::now();
+    present_begin = frame_begin;
+}
+
+void PerfStats::BeginPresent() {
+    std::scoped_lock lock{object_mutex};
+
+    present_begin = Clock::now();
 }
 
 void PerfStats::EndSystemFrame() {
@@ -62,6 +159,10 @@ void PerfStats::EndSystemFrame() {
         perf_history[current_index++] =
             std::chrono::duration<double, std::milli>(frame_time).count();
     }
+    if (interval_frametimes.size() < MaxIntervalFrames) {
+        interval_frametimes.push_back(duration_cast<DoubleSecs>(frame_time).count());
+    }
+    AddSubsystemTime(Subsystem::Present, frame_end - present_begin);
     accumulated_frametime += frame_time;
     system_frames += 1;
 
@@ -73,6 +174,39 @@ void PerfStats::EndGameFrame() {
     std::scoped_lock lock{object_mutex};
 
     game_frames += 1;
+    total_game_frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfStats::SetTextureMemory(u64 usage, u64 budget) {
+    std::scoped_lock lock{object_mutex};
+
+    texture_memory_usage = usage;
+    texture_memory_budget = budget;
+    peak_texture_memory_usage = std::max(peak_texture_memory_usage, usage);
+}
+
+void PerfStats::SetPipelineCacheStats(u64 lookups, u64 hits, u64 compile_stalls) {
+    std::scoped_lock lock{object_mutex};
+
+    pipeline_lookups = lookups;
+    pipeline_hits = hits;
+    pipeline_compile_stalls = compile_stalls;
+}
+
+void PerfStats::SetPresentLatency(microseconds latency) {
+    std::scoped_lock lock{object_mutex};
+
+    present_latency = latency;
+}
+
+void PerfStats::SetAudioStats(microseconds latency, bool underrun) {
+    std::scoped_lock lock{object_mutex};
+
+    audio_latency = latency;
+    if (underrun) {
+        audio_underruns++;
+        total_audio_underruns++;
+    }
 }
 
 double PerfStats::GetMeanFrametime() const {
@@ -87,6 +221,15 @@ double PerfStats::GetMeanFrametime() const {
     return sum / static_cast<double>(current_index - IgnoreFrames);
 }
 
+std::vector<double> PerfStats::GetFrametimes() const {
+    std::scoped_lock lock{object_mutex};
+
+    if (current_index <= IgnoreFrames) {
+        return {};
+    }
+    return {perf_history.begin() + IgnoreFrames, perf_history.begin() + current_index};
+}
+
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
     std::scoped_lock lock{object_mutex};
 
@@ -102,12 +245,47 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
                            static_cast<double>(system_frames);
     last_stats.emulation_speed = system_us_per_second.count() / 1'000'000.0;
 
+    std::sort(interval_frametimes.begin(), interval_frametimes.end());
+    last_stats.frametime_p50 = Percentile(interval_frametimes, 0.50);
+    last_stats.frametime_p95 = Percentile(interval_frametimes, 0.95);
+    last_stats.frametime_p99 = Percentile(interval_frametimes, 0.99);
+
+    // Report the time exclusive to every subsystem, the counters include their nested subsystems
+    std::array<Clock::rep, static_cast<std::size_t>(Subsystem::Count)> times;
+    for (std::size_t i = 0; i < times.size(); i++) {
+        times[i] = subsystem_time[i].exchange(0, std::memory_order_relaxed);
+    }
+    const auto per_frame = [this](Clock::rep time) {
+        return duration_cast<DoubleSecs>(Clock::duration{std::max<Clock::rep>(time, 0)}).count() /
+               static_cast<double>(system_frames);
+    };
+    const auto time_of = [&times](Subsystem subsystem) {
+        return times[static_cast<std::size_t>(subsystem)];
+    };
+    last_stats.cpu_time = per_frame(time_of(Subsystem::Cpu) - time_of(Subsystem::Service));
+    last_stats.service_time =
+        per_frame(time_of(Subsystem::Service) - time_of(Subsystem::GpuSubmit));
+    last_stats.gpu_submit_time = per_frame(time_of(Subsystem::GpuSubmit));
+    last_stats.present_time = per_frame(time_of(Subsystem::Present));
+    for (std::size_t i = 0; i < gpu_pass_time.size(); i++) {
+        const s64 time = gpu_pass_time[i].exchange(0, std::memory_order_relaxed);
+        last_stats.gpu_pass_time[i] = duration_cast<DoubleSecs>(nanoseconds{time}).count() /
+                                      static_cast<double>(system_frames);
+    }
+    last_stats.texture_memory_usage = texture_memory_usage;
+    last_stats.texture_memory_budget = texture_memory_budget;
+    last_stats.present_latency = duration_cast<DoubleSecs>(present_latency).count();
+    last_stats.audio_latency = duration_cast<DoubleSecs>(audio_latency).count();
+    last_stats.audio_underruns = audio_underruns;
+
     // Reset counters
     reset_point = now;
     reset_point_system_us = current_system_time_us;
     accumulated_frametime = Clock::duration::zero();
+    interval_frametimes.clear();
     system_frames = 0;
     game_frames = 0;
+    audio_underruns = 0;
 
     return last_stats;
 }
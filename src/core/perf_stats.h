@@ -9,6 +9,7 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <vector>
 #include "common/common_types.h"
 #include "common/thread.h"
 
@@ -25,6 +26,55 @@ public:
 
     using Clock = std::chrono::high_resolution_clock;
 
+    /// Parts of the emulation whose walltime is tracked separately within every system frame
+    enum class Subsystem : u32 {
+        /// Guest code executed by the CPU cores, excluding HLE service calls
+        Cpu,
+        /// HLE service requests, excluding the GPU commands they submit
+        Service,
+        /// GPU commands submitted through GSP
+        GpuSubmit,
+        /// Presentation of the frame by the renderer, excluding frame-limiting
+        Present,
+        Count,
+    };
+
+    /// Kinds of host GPU work whose execution time the renderer measures with timestamp queries
+    enum class GpuPass : u32 {
+        Draw,
+        Upload,
+        Blit,
+        Filter,
+        Present,
+        Count,
+    };
+
+    /// Adds the walltime spent between its construction and destruction to a subsystem
+    class ScopedTimer {
+    public:
+        /// A null perf_stats makes the timer a no-op
+        ScopedTimer(PerfStats* perf_stats_, Subsystem subsystem_)
+            : perf_stats{perf_stats_}, subsystem{subsystem_} {
+            if (perf_stats) {
+                begin = Clock::now();
+            }
+        }
+
+        ~ScopedTimer() {
+            if (perf_stats) {
+                perf_stats->AddSubsystemTime(subsystem, Clock::now() - begin);
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        PerfStats* perf_stats;
+        Subsystem subsystem;
+        Clock::time_point begin{};
+    };
+
     struct Results {
         /// System FPS (LCD VBlanks) in Hz
         double system_fps;
@@ -32,14 +82,67 @@ public:
         double game_fps;
         /// Walltime per system frame, in seconds, excluding any waits
         double frametime;
+        /// Median, 95th and 99th percentile of the walltime per system frame, in seconds
+        double frametime_p50;
+        double frametime_p95;
+        double frametime_p99;
+        /// Walltime per system frame spent in each subsystem, in seconds
+        double cpu_time;
+        double service_time;
+        double gpu_submit_time;
+        double present_time;
+        /// Host GPU time per system frame spent in each GpuPass, in seconds, 0 if not measured
+        std::array<double, static_cast<std::size_t>(GpuPass::Count)> gpu_pass_time;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Memory occupied by cached textures, in bytes
+        u64 texture_memory_usage;
+        /// Memory budget of cached textures in bytes, 0 if unknown
+        u64 texture_memory_budget;
+        /// Time from frame submission until it was shown on the display, in seconds, 0 if unknown
+        double present_latency;
+        /// Duration of the audio queued for the sink, in seconds
+        double audio_latency;
+        /// Audio callbacks since the last reset that ran out of samples
+        u32 audio_underruns;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /// Marks the beginning of the presentation of the current system frame
+    void BeginPresent();
+
+    /// Adds walltime spent in a subsystem to the current interval. Lock-free.
+    void AddSubsystemTime(Subsystem subsystem, Clock::duration duration) {
+        subsystem_time[static_cast<std::size_t>(subsystem)].fetch_add(
+            duration.count(), std::memory_order_relaxed);
+    }
+
+    /// Adds host GPU time spent in a pass to the current interval. Lock-free.
+    void AddGpuTime(GpuPass pass, std::chrono::nanoseconds duration) {
+        gpu_pass_time[static_cast<std::size_t>(pass)].fetch_add(duration.count(),
+                                                                std::memory_order_relaxed);
+    }
+
+    /// Records the memory usage and budget of the renderer texture cache, in bytes
+    void SetTextureMemory(u64 usage, u64 budget);
+
+    /// Records the pipeline cache counters of the renderer, they are cumulative for the session
+    void SetPipelineCacheStats(u64 lookups, u64 hits, u64 compile_stalls);
+
+    /// Records the latest presentation latency measured by the renderer, zero if not measured
+    void SetPresentLatency(std::chrono::microseconds latency);
+
+    /// Records the audio queued for the sink by an audio callback and whether it ran out of audio
+    void SetAudioStats(std::chrono::microseconds latency, bool underrun);
+
+    /// Returns the number of game frames submitted since emulation started. Lock-free.
+    [[nodiscard]] u64 GetGameFrameCount() const {
+        return total_game_frames.load(std::memory_order_relaxed);
+    }
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     Results GetLastStats();
@@ -49,6 +152,9 @@ public:
      */
     double GetMeanFrametime() const;
 
+    /// Returns the frametimes of the performance history in milliseconds, excluding boot frames.
+    std::vector<double> GetFrametimes() const;
+
     /**
      * Gets the ratio between walltime and the emulated time of the previous system frame. This is
      * useful for scaling inputs or outputs moving between the two time domains.
@@ -56,6 +162,10 @@ public:
     double GetLastFrameTimeScale() const;
 
 private:
+    /// Writes the statistics of the whole session to the log directory in the Prometheus text
+    /// format, so a textfile collector can export them
+    void WriteSessionStats() const;
+
     mutable std::mutex object_mutex;
 
     /// Title ID for the game that is running. 0 if there is no game running yet
@@ -73,18 +183,53 @@ private:
 
     /// Cumulative duration (excluding v-sync/frame-limiting) of frames since last reset
     Clock::duration accumulated_frametime = Clock::duration::zero();
+    /// Durations of the system frames since last reset, in seconds, used for the percentiles
+    std::vector<double> interval_frametimes;
+    /// Cumulative walltime of every subsystem since last reset, in clock ticks. Nested subsystems
+    /// are also counted by their parent: GPU submissions are part of service calls, which are part
+    /// of the CPU time.
+    std::array<std::atomic<Clock::rep>, static_cast<std::size_t>(Subsystem::Count)>
+        subsystem_time{};
+    /// Cumulative host GPU time of every pass since last reset, in nanoseconds
+    std::array<std::atomic<s64>, static_cast<std::size_t>(GpuPass::Count)> gpu_pass_time{};
     /// Cumulative number of system frames (LCD VBlanks) presented since last reset
     u32 system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Number of game frames since emulation started, never reset
+    std::atomic<u64> total_game_frames = 0;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
     /// Point when the current system frame began
     Clock::time_point frame_begin = reset_point;
+    /// Point when the presentation of the current system frame began
+    Clock::time_point present_begin = reset_point;
     /// Total visible duration (including frame-limiting, etc.) of the previous system frame
     Clock::duration previous_frame_length = Clock::duration::zero();
 
+    /// Memory occupied by cached textures reported by the renderer
+    u64 texture_memory_usage = 0;
+    /// Memory budget of cached textures reported by the renderer
+    u64 texture_memory_budget = 0;
+    /// Highest memory occupied by cached textures during the session
+    u64 peak_texture_memory_usage = 0;
+    /// Pipeline cache counters reported by the renderer
+    u64 pipeline_lookups = 0;
+    u64 pipeline_hits = 0;
+    u64 pipeline_compile_stalls = 0;
+    /// Presentation latency reported by the renderer
+    std::chrono::microseconds present_latency{0};
+    /// Duration of the audio queued for the sink after the last audio callback
+    std::chrono::microseconds audio_latency{0};
+    /// Audio callbacks that ran out of samples since last reset
+    u32 audio_underruns = 0;
+    /// Audio callbacks that ran out of samples since emulation started, never reset
+    u64 total_audio_underruns = 0;
+
+    /// Point when emulation started
+    Clock::time_point session_begin = Clock::now();
+
     /// Last recorded performance statistics.
     Results last_stats;
 };
@@ -0,0 +1,114 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <vector>
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/rewind_buffer.h"
+
+namespace Core {
+
+/// Number of incremental snapshots between two full ones. This bounds the length of the chain
+/// that has to be applied on rewind, and the number of merges needed to drop a full snapshot.
+constexpr u32 KeyframeInterval = 30;
+
+RewindBuffer::RewindBuffer(System& system_) : system{system_}, worker{1, "RewindBuffer"} {}
+
+RewindBuffer::~RewindBuffer() = default;
+
+void RewindBuffer::OnFrame(u64 game_frame) {
+    if (game_frame - last_frame < Settings::values.rewind_frame_interval.GetValue()) {
+        return;
+    }
+    last_frame = game_frame;
+
+    const bool keyframe = last_capture.id == 0 || captures_since_keyframe >= KeyframeInterval;
+    StateSnapshot snapshot;
+    try {
+        snapshot = system.CaptureSnapshot(keyframe ? nullptr : &last_capture);
+    } catch (const std::exception& e) {
+        LOG_ERROR(Core, "Unable to capture rewind snapshot: {}", e.what());
+        return;
+    }
+    captures_since_keyframe = keyframe ? 0 : captures_since_keyframe + 1;
+
+    // Only the most recent capture is ever diffed against, so the hashes stay on this thread.
+    last_capture.id = snapshot.id;
+    last_capture.page_hashes = std::move(snapshot.page_hashes);
+    snapshot.page_hashes.clear();
+
+    worker.QueueWork([this, snapshot = std::move(snapshot)]() mutable {
+        try {
+            CompressSnapshot(snapshot);
+        } catch (const std::exception& e) {
+            // Keep the snapshot uncompressed, dropping it would break the chain of its successors.
+            LOG_ERROR(Core, "Unable to compress rewind snapshot: {}", e.what());
+        }
+
+        std::scoped_lock lock{mutex};
+        if (snapshot.IsIncremental() &&
+            (snapshots.empty() || snapshots.back().id != snapshot.base_id)) {
+            // The base was dropped after a failed merge, wait for the next full snapshot.
+            return;
+        }
+        used_memory += snapshot.data.size();
+        snapshots.push_back(std::move(snapshot));
+        EnforceBudget();
+    });
+}
+
+bool RewindBuffer::Rewind() {
+    // Snapshots that are still being compressed are newer than the ones in the history.
+    worker.WaitForRequests();
+
+    std::scoped_lock lock{mutex};
+    if (snapshots.empty()) {
+        return false;
+    }
+
+    std::vector<const StateSnapshot*> bases;
+    for (auto it = snapshots.rbegin(); it->IsIncremental();) {
+        bases.push_back(&*++it);
+    }
+    std::reverse(bases.begin(), bases.end());
+
+    system.RestoreSnapshot(snapshots.back(), bases);
+
+    used_memory -= snapshots.back().data.size();
+    snapshots.pop_back();
+
+    // The page hashes of the new most recent snapshot are gone, so start over with a full one.
+    last_capture = {};
+    return true;
+}
+
+void RewindBuffer::EnforceBudget() {
+    const std::size_t budget =
+        static_cast<std::size_t>(Settings::values.rewind_memory_budget.GetValue()) * 1024 * 1024;
+
+    while (used_memory > budget && snapshots.size() > 1) {
+        StateSnapshot& oldest = snapshots.front();
+        StateSnapshot& next = snapshots[1];
+        if (next.IsIncremental()) {
+            try {
+                StateSnapshot merged = MergeSnapshots(oldest, next);
+                CompressSnapshot(merged);
+                used_memory -= next.data.size();
+                used_memory += merged.data.size();
+                next = std::move(merged);
+            } catch (const std::exception& e) {
+                LOG_ERROR(Core, "Unable to merge rewind snapshots: {}", e.what());
+                used_memory = 0;
+                snapshots.clear();
+                return;
+            }
+        }
+        used_memory -= oldest.data.size();
+        snapshots.pop_front();
+    }
+}
+
+} // namespace Core
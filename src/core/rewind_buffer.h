@@ -0,0 +1,60 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "core/savestate.h"
+
+namespace Core {
+
+class System;
+
+/**
+ * Bounded history of in-memory snapshots that emulation can be rewound through. Snapshots are
+ * captured every few game frames, mostly as incremental ones relative to the previous capture,
+ * and compressed on a background thread so the emulation thread never waits on compression.
+ * Once the memory budget is exceeded the oldest snapshots are folded into their successors.
+ */
+class RewindBuffer {
+public:
+    explicit RewindBuffer(System& system);
+    ~RewindBuffer();
+
+    /**
+     * Captures a snapshot if enough game frames have passed since the last one. Must be called
+     * from the emulation thread, between slices.
+     */
+    void OnFrame(u64 game_frame);
+
+    /**
+     * Restores the most recent snapshot and drops it from the history. Must be called from the
+     * emulation thread, between slices.
+     * @returns false if there is no snapshot to rewind to.
+     * @throws std::runtime_error if the snapshot could not be restored.
+     */
+    bool Rewind();
+
+private:
+    /// Drops or merges the oldest snapshots until the memory budget is met. Requires the mutex.
+    void EnforceBudget();
+
+    System& system;
+
+    std::mutex mutex;
+    std::deque<StateSnapshot> snapshots; ///< Oldest first, the oldest one is always full
+    std::size_t used_memory{};
+
+    // Only accessed from the emulation thread.
+    u64 last_frame{};
+    u32 captures_since_keyframe{};
+    StateSnapshot last_capture; ///< Id and page hashes of the most recent capture, without data
+
+    Common::ThreadWorker worker; ///< Declared last so pending tasks finish before the rest goes
+};
+
+} // namespace Core
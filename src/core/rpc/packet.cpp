@@ -8,10 +8,12 @@
 
 namespace Core::RPC {
 
-Packet::Packet(const PacketHeader& header_, u8* data,
+Packet::Packet(const PacketHeader& header_, const u8* data, u32 max_data_size_,
                std::function<void(Packet&)> send_reply_callback_)
-    : header{header_}, send_reply_callback{std::move(send_reply_callback_)} {
-    std::memcpy(packet_data.data(), data, std::min(header.packet_size, MAX_PACKET_DATA_SIZE));
+    : header{header_}, max_data_size{max_data_size_},
+      packet_data(std::max(std::min(header.packet_size, max_data_size), MAX_PACKET_DATA_SIZE)),
+      send_reply_callback{std::move(send_reply_callback_)} {
+    std::memcpy(packet_data.data(), data, std::min(header.packet_size, max_data_size));
 }
 
 Packet::~Packet() = default;
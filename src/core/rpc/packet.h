@@ -7,6 +7,7 @@
 #include <array>
 #include <functional>
 #include <span>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Core::RPC {
@@ -15,6 +16,22 @@ enum class PacketType : u32 {
     Undefined = 0,
     ReadMemory = 1,
     WriteMemory = 2,
+    ServiceStats = 3,
+    PerfStats = 4,
+    /// Reads a list of u32 address, u32 size pairs, replying with the concatenated data
+    ReadMemoryScatter = 5,
+    /// ReadMemoryScatter performed at the end of the next emulated frame, so that all the data
+    /// comes from the same frame
+    ReadMemoryAtFrameEnd = 6,
+    /// Watches a list of u32 address, u32 size pairs. The reply holds the u32 subscription id,
+    /// which is the id of the request, and MemoryChanged packets follow at the end of every frame
+    /// that changed the watched memory
+    Subscribe = 7,
+    /// Stops the subscription whose id is in the address field
+    Unsubscribe = 8,
+    /// Pushed to subscribers with the id of their subscription. Holds u32 address, u32 size
+    /// records of the changed memory, each followed by its data. The first one has all the ranges.
+    MemoryChanged = 9,
 };
 
 struct PacketHeader {
@@ -29,10 +46,46 @@ constexpr u32 MIN_PACKET_SIZE = sizeof(PacketHeader);
 constexpr u32 MAX_PACKET_DATA_SIZE = 32;
 constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
 constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
+/// Packets sent over TCP may carry much more data than datagrams
+constexpr u32 MAX_TCP_PACKET_DATA_SIZE = 1024 * 1024;
+
+/// Memory range of the ReadMemoryScatter, ReadMemoryAtFrameEnd and Subscribe requests
+struct MemoryRange {
+    u32 address;
+    u32 size;
+};
+static_assert(sizeof(MemoryRange) == 8);
+
+/// Reply data of a ServiceStats request, describing the service command at the requested index
+struct ServiceStatsEntry {
+    std::array<char, 8> service_name; // Not null terminated when 8 characters long
+    u32 command_id;
+    u32 count; // Saturates at the maximum u32 value
+    u64 total_ns;
+    u64 max_ns;
+};
+static_assert(sizeof(ServiceStatsEntry) == MAX_PACKET_DATA_SIZE);
+
+/// Reply data of a PerfStats request, times are per system frame in milliseconds
+struct PerfStatsEntry {
+    f32 emulation_speed; // Ratio of emulated time / walltime elapsed
+    f32 frametime_p50;
+    f32 frametime_p95;
+    f32 frametime_p99;
+    f32 cpu_time;
+    f32 service_time;
+    f32 gpu_submit_time;
+    f32 present_time;
+};
+static_assert(sizeof(PerfStatsEntry) == MAX_PACKET_DATA_SIZE);
 
 class Packet {
 public:
-    explicit Packet(const PacketHeader& header, u8* data,
+    /**
+     * @param data the header.packet_size bytes of request data
+     * @param max_data_size the largest data size of the transport, which bounds the replies
+     */
+    explicit Packet(const PacketHeader& header, const u8* data, u32 max_data_size,
                     std::function<void(Packet&)> send_reply_callback);
     ~Packet();
 
@@ -48,6 +101,10 @@ public:
         return header.packet_type;
     }
 
+    void SetPacketType(PacketType type) {
+        header.packet_type = type;
+    }
+
     u32 GetPacketDataSize() const {
         return header.packet_size;
     }
@@ -56,12 +113,20 @@ public:
         return header;
     }
 
-    std::span<u8, MAX_PACKET_DATA_SIZE> GetPacketData() {
+    u32 GetMaxPacketDataSize() const {
+        return max_data_size;
+    }
+
+    /// The data holds at least MAX_PACKET_DATA_SIZE bytes, and grows with SetPacketDataSize
+    std::span<u8> GetPacketData() {
         return packet_data;
     }
 
     void SetPacketDataSize(u32 size) {
         header.packet_size = size;
+        if (packet_data.size() < size) {
+            packet_data.resize(size);
+        }
     }
 
     void SendReply() {
@@ -73,7 +138,8 @@ private:
     void HandleWriteMemory(u32 address, std::span<const u8> data);
 
     struct PacketHeader header;
-    std::array<u8, MAX_PACKET_DATA_SIZE> packet_data;
+    u32 max_data_size;
+    std::vector<u8> packet_data;
 
     std::function<void(Packet&)> send_reply_callback;
 };
@@ -2,8 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include "common/logging/log.h"
 #include "core/core.h"
+#include "core/hle/kernel/ipc_debugger/recorder.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/memory.h"
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
@@ -19,13 +24,46 @@ RPCServer::RPCServer(Core::System& system_) : system{system_} {
 RPCServer::~RPCServer() = default;
 
 void RPCServer::HandleReadMemory(Packet& packet, u32 address, u32 data_size) {
-    if (data_size > MAX_READ_SIZE) {
+    if (data_size > packet.GetMaxPacketDataSize()) {
         return;
     }
 
     // Note: Memory read occurs asynchronously from the state of the emulator
-    system.Memory().ReadBlock(address, packet.GetPacketData().data(), data_size);
     packet.SetPacketDataSize(data_size);
+    system.Memory().ReadBlock(address, packet.GetPacketData().data(), data_size);
+    packet.SendReply();
+}
+
+namespace {
+
+constexpr std::size_t MaxSubscriptions = 16;
+constexpr u32 MaxSubscriptionSize = 64 * 1024;
+// Changed memory is searched in blocks of this size, nearby changes are reported together
+constexpr u32 DiffBlockSize = 32;
+
+std::vector<MemoryRange> GetMemoryRanges(Packet& packet) {
+    std::vector<MemoryRange> ranges(packet.GetPacketDataSize() / sizeof(MemoryRange));
+    std::memcpy(ranges.data(), packet.GetPacketData().data(), ranges.size() * sizeof(MemoryRange));
+    return ranges;
+}
+
+} // Anonymous namespace
+
+void RPCServer::HandleReadMemoryScatter(Packet& packet) {
+    // The reply overwrites the request, which is why the ranges are copied first
+    const std::vector<MemoryRange> ranges = GetMemoryRanges(packet);
+    u32 offset = 0;
+    packet.SetPacketDataSize(0);
+    for (const MemoryRange& range : ranges) {
+        if (range.size > packet.GetMaxPacketDataSize() - offset) {
+            packet.SetPacketDataSize(0);
+            break;
+        }
+        packet.SetPacketDataSize(offset + range.size);
+        system.Memory().ReadBlock(range.address, packet.GetPacketData().data() + offset,
+                                  range.size);
+        offset += range.size;
+    }
     packet.SendReply();
 }
 
@@ -45,15 +83,183 @@ void RPCServer::HandleWriteMemory(Packet& packet, u32 address, std::span<const u
     packet.SendReply();
 }
 
+bool RPCServer::HandleSubscribe(std::unique_ptr<Packet>& packet) {
+    Subscription subscription{.ranges = GetMemoryRanges(*packet)};
+    u64 total_size = 0;
+    for (const MemoryRange& range : subscription.ranges) {
+        total_size += range.size;
+    }
+    if (total_size == 0 || total_size > MaxSubscriptionSize) {
+        return false;
+    }
+    subscription.snapshot.resize(total_size);
+    subscription.current.resize(total_size);
+
+    const u32 id = packet->GetId();
+    {
+        std::scoped_lock lock{frame_end_mutex};
+        if (subscriptions.size() >= MaxSubscriptions) {
+            return false;
+        }
+        std::memcpy(packet->GetPacketData().data(), &id, sizeof(id));
+        packet->SetPacketDataSize(sizeof(id));
+        packet->SendReply();
+        subscription.packet = std::move(packet);
+        subscriptions.push_back(std::move(subscription));
+    }
+    return true;
+}
+
+void RPCServer::HandleUnsubscribe(Packet& packet, u32 id) {
+    {
+        std::scoped_lock lock{frame_end_mutex};
+        std::erase_if(subscriptions, [id](const Subscription& subscription) {
+            return subscription.packet->GetId() == id;
+        });
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
+void RPCServer::UpdateSubscriptions() {
+    for (Subscription& subscription : subscriptions) {
+        Packet& packet = *subscription.packet;
+        const u32 max_size = packet.GetMaxPacketDataSize();
+        std::vector<u8> message;
+        const auto flush = [&packet, &message] {
+            if (message.empty()) {
+                return;
+            }
+            packet.SetPacketType(PacketType::MemoryChanged);
+            packet.SetPacketDataSize(static_cast<u32>(message.size()));
+            std::memcpy(packet.GetPacketData().data(), message.data(), message.size());
+            packet.SendReply();
+            message.clear();
+        };
+        // Splits the change into as many records as needed to fit into the packets
+        const auto report = [&](u32 address, const u8* data, u32 size) {
+            while (size > 0) {
+                if (max_size - message.size() <= sizeof(MemoryRange)) {
+                    flush();
+                }
+                const u32 length =
+                    std::min<u32>(size, max_size - static_cast<u32>(message.size()) -
+                                            static_cast<u32>(sizeof(MemoryRange)));
+                const MemoryRange record{address, length};
+                const auto* record_bytes = reinterpret_cast<const u8*>(&record);
+                message.insert(message.end(), record_bytes, record_bytes + sizeof(record));
+                message.insert(message.end(), data, data + length);
+                address += length;
+                data += length;
+                size -= length;
+            }
+        };
+
+        u32 offset = 0;
+        for (const MemoryRange& range : subscription.ranges) {
+            u8* current = subscription.current.data() + offset;
+            const u8* snapshot = subscription.snapshot.data() + offset;
+            offset += range.size;
+            system.Memory().ReadBlock(range.address, current, range.size);
+
+            // Most watched memory does not change every frame, which the whole range compare
+            // finds quickly, only changed ranges are searched block by block
+            if (!subscription.has_snapshot) {
+                report(range.address, current, range.size);
+                continue;
+            }
+            if (std::memcmp(current, snapshot, range.size) == 0) {
+                continue;
+            }
+            u32 run_begin = 0;
+            u32 run_end = 0;
+            for (u32 block = 0; block < range.size; block += DiffBlockSize) {
+                const u32 block_size = std::min(DiffBlockSize, range.size - block);
+                if (std::memcmp(current + block, snapshot + block, block_size) == 0) {
+                    continue;
+                }
+                if (run_end != block) {
+                    report(range.address + run_begin, current + run_begin, run_end - run_begin);
+                    run_begin = block;
+                }
+                run_end = block + block_size;
+            }
+            report(range.address + run_begin, current + run_begin, run_end - run_begin);
+        }
+        flush();
+
+        subscription.snapshot.swap(subscription.current);
+        subscription.has_snapshot = true;
+    }
+}
+
+void RPCServer::HandleServiceStats(Packet& packet, u32 index) {
+    auto& ipc_recorder = system.Kernel().GetIPCRecorder();
+    // Collection starts with the first query, in which case there is nothing to report yet
+    ipc_recorder.SetStatsEnabled(true);
+
+    const auto stats = ipc_recorder.GetServiceStats();
+    if (index >= stats.size()) {
+        packet.SetPacketDataSize(0);
+        packet.SendReply();
+        return;
+    }
+
+    const auto& command = stats[index];
+    ServiceStatsEntry entry{};
+    std::copy_n(command.service_name.begin(),
+                std::min(command.service_name.size(), entry.service_name.size()),
+                entry.service_name.begin());
+    entry.command_id = command.command_id;
+    entry.count = static_cast<u32>(std::min<u64>(command.count, std::numeric_limits<u32>::max()));
+    entry.total_ns = command.total_ns;
+    entry.max_ns = command.max_ns;
+
+    std::memcpy(packet.GetPacketData().data(), &entry, sizeof(entry));
+    packet.SetPacketDataSize(sizeof(entry));
+    packet.SendReply();
+}
+
+void RPCServer::HandlePerfStats(Packet& packet) {
+    const auto stats = system.GetLastPerfStats();
+    const auto to_ms = [](double seconds) { return static_cast<f32>(seconds * 1000.0); };
+
+    const PerfStatsEntry entry{
+        .emulation_speed = static_cast<f32>(stats.emulation_speed),
+        .frametime_p50 = to_ms(stats.frametime_p50),
+        .frametime_p95 = to_ms(stats.frametime_p95),
+        .frametime_p99 = to_ms(stats.frametime_p99),
+        .cpu_time = to_ms(stats.cpu_time),
+        .service_time = to_ms(stats.service_time),
+        .gpu_submit_time = to_ms(stats.gpu_submit_time),
+        .present_time = to_ms(stats.present_time),
+    };
+
+    std::memcpy(packet.GetPacketData().data(), &entry, sizeof(entry));
+    packet.SetPacketDataSize(sizeof(entry));
+    packet.SendReply();
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
         case PacketType::ReadMemory:
         case PacketType::WriteMemory:
+        case PacketType::ServiceStats:
+        case PacketType::PerfStats:
+        case PacketType::Unsubscribe:
             if (packet_header.packet_size >= (sizeof(u32) * 2)) {
                 return true;
             }
             break;
+        case PacketType::ReadMemoryScatter:
+        case PacketType::ReadMemoryAtFrameEnd:
+        case PacketType::Subscribe:
+            if (packet_header.packet_size >= (sizeof(u32) * 2) &&
+                packet_header.packet_size % (sizeof(u32) * 2) == 0) {
+                return true;
+            }
+            break;
         default:
             break;
         }
@@ -74,18 +280,53 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
 
         switch (request_packet->GetPacketType()) {
         case PacketType::ReadMemory:
-            if (data_size > 0 && data_size <= MAX_READ_SIZE) {
+            if (data_size > 0 && data_size <= request_packet->GetMaxPacketDataSize()) {
                 HandleReadMemory(*request_packet, address, data_size);
                 success = true;
             }
             break;
+        case PacketType::ReadMemoryScatter:
+            HandleReadMemoryScatter(*request_packet);
+            success = true;
+            break;
+        case PacketType::ReadMemoryAtFrameEnd:
+            if (system.IsPoweredOn()) {
+                std::scoped_lock lock{frame_end_mutex};
+                frame_end_requests.push_back(std::move(request_packet));
+                return;
+            }
+            break;
+        case PacketType::Subscribe:
+            if (HandleSubscribe(request_packet)) {
+                return;
+            }
+            break;
+        case PacketType::Unsubscribe:
+            HandleUnsubscribe(*request_packet, address);
+            success = true;
+            break;
         case PacketType::WriteMemory:
-            if (data_size > 0 && data_size <= MAX_PACKET_DATA_SIZE - (sizeof(u32) * 2)) {
+            if (data_size > 0 &&
+                data_size <= request_packet->GetPacketDataSize() - (sizeof(u32) * 2)) {
                 const auto data = packet_data.subspan(sizeof(u32) * 2, data_size);
                 HandleWriteMemory(*request_packet, address, data);
                 success = true;
             }
             break;
+        case PacketType::ServiceStats:
+            // The address holds the index of the entry, the size is unused
+            if (system.IsPoweredOn()) {
+                HandleServiceStats(*request_packet, address);
+                success = true;
+            }
+            break;
+        case PacketType::PerfStats:
+            // The address and size are unused
+            if (system.IsPoweredOn()) {
+                HandlePerfStats(*request_packet);
+                success = true;
+            }
+            break;
         default:
             break;
         }
@@ -112,4 +353,16 @@ void RPCServer::QueueRequest(std::unique_ptr<RPC::Packet> request) {
     request_queue.Push(std::move(request));
 }
 
+void RPCServer::HandleFrameEndRequests() {
+    std::vector<std::unique_ptr<Packet>> requests;
+    {
+        std::scoped_lock lock{frame_end_mutex};
+        requests.swap(frame_end_requests);
+        UpdateSubscriptions();
+    }
+    for (const auto& request : requests) {
+        HandleReadMemoryScatter(*request);
+    }
+}
+
 }; // namespace Core::RPC
@@ -6,9 +6,12 @@
 
 #include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <span>
+#include <vector>
 #include "common/polyfill_thread.h"
 #include "common/threadsafe_queue.h"
+#include "core/rpc/packet.h"
 
 namespace Core {
 class System;
@@ -16,8 +19,6 @@ class System;
 
 namespace Core::RPC {
 
-class Packet;
-struct PacketHeader;
 
 class RPCServer {
 public:
@@ -26,16 +27,36 @@ public:
 
     void QueueRequest(std::unique_ptr<RPC::Packet> request);
 
+    /// Handles the requests waiting for the end of the frame, called by the emulation thread
+    void HandleFrameEndRequests();
+
 private:
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
+    void HandleReadMemoryScatter(Packet& packet);
+    bool HandleSubscribe(std::unique_ptr<Packet>& packet);
+    void HandleUnsubscribe(Packet& packet, u32 id);
+    void UpdateSubscriptions();
     void HandleWriteMemory(Packet& packet, u32 address, std::span<const u8> data);
+    void HandleServiceStats(Packet& packet, u32 index);
+    void HandlePerfStats(Packet& packet);
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop(std::stop_token stop_token);
 
 private:
+    struct Subscription {
+        std::unique_ptr<Packet> packet; ///< Used to push the changes to the subscriber
+        std::vector<MemoryRange> ranges;
+        std::vector<u8> snapshot; ///< Data of all the ranges at the last frame end
+        std::vector<u8> current;
+        bool has_snapshot = false;
+    };
+
     Core::System& system;
     Common::SPSCQueue<std::unique_ptr<Packet>, true> request_queue;
+    std::mutex frame_end_mutex;
+    std::vector<std::unique_ptr<Packet>> frame_end_requests;
+    std::vector<Subscription> subscriptions;
     std::jthread request_handler_thread;
 };
 
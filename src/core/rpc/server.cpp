@@ -6,6 +6,7 @@
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
 #include "core/rpc/server.h"
+#include "core/rpc/tcp_server.h"
 #include "core/rpc/udp_server.h"
 
 namespace Core::RPC {
@@ -20,9 +21,16 @@ Server::Server(Core::System& system_) : rpc_server{system_} {
     } catch (...) {
         LOG_ERROR(RPC_Server, "Error starting UDP server");
     }
+
+    try {
+        tcp_server = std::make_unique<TCPServer>(callback);
+    } catch (...) {
+        LOG_ERROR(RPC_Server, "Error starting TCP server");
+    }
 }
 
 Server::~Server() {
+    tcp_server.reset();
     udp_server.reset();
     NewRequestCallback(nullptr); // Notify the RPC server to end
 }
@@ -14,6 +14,7 @@ class System;
 namespace Core::RPC {
 
 class UDPServer;
+class TCPServer;
 class Packet;
 
 class Server {
@@ -23,9 +24,14 @@ public:
 
     void NewRequestCallback(std::unique_ptr<Packet> new_request);
 
+    void HandleFrameEndRequests() {
+        rpc_server.HandleFrameEndRequests();
+    }
+
 private:
     RPCServer rpc_server;
     std::unique_ptr<UDPServer> udp_server;
+    std::unique_ptr<TCPServer> tcp_server;
 };
 
 } // namespace Core::RPC
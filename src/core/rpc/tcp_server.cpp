@@ -0,0 +1,156 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "core/rpc/packet.h"
+#include "core/rpc/tcp_server.h"
+
+namespace Core::RPC {
+
+namespace {
+
+using boost::asio::ip::tcp;
+
+/// A client connection, which stays alive while a read or write is pending on its socket
+class Connection : public std::enable_shared_from_this<Connection> {
+public:
+    explicit Connection(tcp::socket socket_,
+                        std::function<void(std::unique_ptr<Packet>)> new_request_callback_)
+        : socket(std::move(socket_)), new_request_callback(std::move(new_request_callback_)) {}
+
+    void Start() {
+        ReadHeader();
+    }
+
+private:
+    void ReadHeader() {
+        boost::asio::async_read(
+            socket, boost::asio::buffer(&header, sizeof(header)),
+            [this, self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                if (error) {
+                    return;
+                }
+                if (header.packet_size > MAX_TCP_PACKET_DATA_SIZE) {
+                    LOG_WARNING(RPC_Server, "Received message with wrong size: {}",
+                                header.packet_size);
+                    return;
+                }
+                request_data.resize(header.packet_size);
+                ReadData();
+            });
+    }
+
+    void ReadData() {
+        boost::asio::async_read(
+            socket, boost::asio::buffer(request_data),
+            [this, self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                if (error) {
+                    return;
+                }
+                // Replies to a closed connection are dropped
+                std::function<void(Packet&)> send_reply_callback =
+                    [weak = weak_from_this()](Packet& reply_packet) {
+                        if (auto connection = weak.lock()) {
+                            connection->SendReply(reply_packet);
+                        }
+                    };
+                new_request_callback(std::make_unique<Packet>(header, request_data.data(),
+                                                              MAX_TCP_PACKET_DATA_SIZE,
+                                                              std::move(send_reply_callback)));
+                ReadHeader();
+            });
+    }
+
+    /// Called from the thread handling the request, the write happens on the network thread
+    void SendReply(Packet& reply_packet) {
+        std::vector<u8> reply_buffer(MIN_PACKET_SIZE + reply_packet.GetPacketDataSize());
+        const auto reply_header = reply_packet.GetHeader();
+        std::memcpy(reply_buffer.data(), &reply_header, sizeof(reply_header));
+        std::memcpy(reply_buffer.data() + MIN_PACKET_SIZE, reply_packet.GetPacketData().data(),
+                    reply_packet.GetPacketDataSize());
+
+        auto write = [self = shared_from_this(), buffer = std::move(reply_buffer)]() mutable {
+            self->pending_replies.push_back(std::move(buffer));
+            if (self->pending_replies.size() == 1) {
+                self->WriteReply();
+            }
+        };
+        boost::asio::post(socket.get_executor(), std::move(write));
+    }
+
+    void WriteReply() {
+        boost::asio::async_write(
+            socket, boost::asio::buffer(pending_replies.front()),
+            [this, self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                if (error) {
+                    LOG_WARNING(RPC_Server, "Failed to send reply: {}", error.message());
+                    return;
+                }
+                pending_replies.pop_front();
+                if (!pending_replies.empty()) {
+                    WriteReply();
+                }
+            });
+    }
+
+    tcp::socket socket;
+    PacketHeader header{};
+    std::vector<u8> request_data;
+    std::deque<std::vector<u8>> pending_replies;
+
+    std::function<void(std::unique_ptr<Packet>)> new_request_callback;
+};
+
+} // Anonymous namespace
+
+class TCPServer::Impl {
+public:
+    explicit Impl(std::function<void(std::unique_ptr<Packet>)> new_request_callback)
+        // Uses the same port as the UDP server
+        : acceptor(io_context, tcp::endpoint(tcp::v4(), 45987)),
+          new_request_callback(std::move(new_request_callback)) {
+
+        StartAccept();
+        worker_thread = std::thread([this] { io_context.run(); });
+    }
+
+    ~Impl() {
+        io_context.stop();
+        worker_thread.join();
+    }
+
+private:
+    void StartAccept() {
+        acceptor.async_accept([this](const boost::system::error_code& error, tcp::socket socket) {
+            if (error) {
+                LOG_WARNING(RPC_Server, "Failed to accept TCP connection: {}", error.message());
+            } else {
+                // Requests are small and latency sensitive
+                socket.set_option(tcp::no_delay(true));
+                std::make_shared<Connection>(std::move(socket), new_request_callback)->Start();
+            }
+            StartAccept();
+        });
+    }
+
+    std::thread worker_thread;
+
+    boost::asio::io_context io_context;
+    tcp::acceptor acceptor;
+
+    std::function<void(std::unique_ptr<Packet>)> new_request_callback;
+};
+
+TCPServer::TCPServer(std::function<void(std::unique_ptr<Packet>)> new_request_callback)
+    : impl(std::make_unique<Impl>(new_request_callback)) {}
+
+TCPServer::~TCPServer() = default;
+
+} // namespace Core::RPC
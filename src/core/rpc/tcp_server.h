@@ -0,0 +1,26 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace Core::RPC {
+
+class Packet;
+
+/// Receives requests over TCP on the same port as UDPServer, for data sizes up to
+/// MAX_TCP_PACKET_DATA_SIZE. Replies are sent in the order they become ready.
+class TCPServer {
+public:
+    explicit TCPServer(std::function<void(std::unique_ptr<Packet>)> new_request_callback);
+    ~TCPServer();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Core::RPC
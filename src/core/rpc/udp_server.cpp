@@ -46,8 +46,8 @@ private:
                 u8* data = request_buffer.data() + MIN_PACKET_SIZE;
                 std::function<void(Packet&)> send_reply_callback =
                     std::bind(&Impl::SendReply, this, remote_endpoint, std::placeholders::_1);
-                std::unique_ptr<Packet> new_packet =
-                    std::make_unique<Packet>(header, data, send_reply_callback);
+                std::unique_ptr<Packet> new_packet = std::make_unique<Packet>(
+                    header, data, MAX_PACKET_DATA_SIZE, send_reply_callback);
 
                 // Send the request to the upper layer for handling
                 new_request_callback(std::move(new_packet));
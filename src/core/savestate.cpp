@@ -0,0 +1,337 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <cryptopp/hex.h>
+#include <fmt/format.h>
+#include "audio_core/dsp_interface.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/swap.h"
+#include "common/zstd_compression.h"
+#include "core/arm/arm_interface.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/memory.h"
+#include "core/movie.h"
+#include "core/savestate.h"
+#include "video_core/gpu.h"
+#include "video_core/renderer_base.h"
+
+namespace Core {
+
+#pragma pack(push, 1)
+struct CSTHeader {
+    std::array<u8, 4> filetype;      /// Unique Identifier to check the file type (always "CST"0x1B)
+    u64_le program_id;               /// ID of the ROM being executed. Also called title_id
+    std::array<u8, 20> revision;     /// Git hash of the revision this savestate was created with
+    u64_le time;                     /// The time when this save state was created
+    std::array<char, 32> build_name; /// The build name (Canary/Nightly) with the version number
+    u32_le format_version;           /// Layout version of the state payload
+
+    std::array<u8, 180> reserved{}; /// Make heading 256 bytes so it has consistent size
+};
+static_assert(sizeof(CSTHeader) == 256, "CSTHeader should be 256 bytes");
+#pragma pack(pop)
+
+constexpr std::array<u8, 4> header_magic_bytes{{'C', 'S', 'T', 0x1B}};
+
+/// Bump this whenever the layout of any subsystem section changes.
+constexpr u32 SaveStateFormatVersion = 2;
+
+/// Upper bound of the uncompressed state size, dominated by the New 3DS FCRAM image.
+constexpr std::size_t SaveStateReserveSize = Memory::FCRAM_N3DS_SIZE + Memory::VRAM_SIZE +
+                                             Memory::N3DS_EXTRA_RAM_SIZE + Memory::DSP_RAM_SIZE +
+                                             0x100000;
+
+/// Level 1 is several times faster than the default level while still shrinking the mostly empty
+/// FCRAM image very well, which keeps saving well below a frame's worth of time.
+constexpr s32 SaveStateCompressionLevel = 1;
+
+static std::string GetSaveStatePath(u64 program_id, u64 movie_id, u32 slot) {
+    const auto states_dir = FileUtil::GetUserPath(FileUtil::UserPath::StatesDir);
+    if (movie_id) {
+        return fmt::format("{}{:016X}.movie{:016X}.{:02d}.cst", states_dir, program_id, movie_id,
+                           slot);
+    }
+    return fmt::format("{}{:016X}.{:02d}.cst", states_dir, program_id, slot);
+}
+
+static bool ValidateSaveState(const CSTHeader& header, SaveStateInfo& info, u64 program_id) {
+    if (header.filetype != header_magic_bytes) {
+        LOG_WARNING(Core, "Invalid save state file type");
+        return false;
+    }
+
+    if (header.program_id != program_id) {
+        LOG_WARNING(Core, "Save state file isn't for the current game");
+        return false;
+    }
+
+    const std::string revision = fmt::format("{:02x}", fmt::join(header.revision, ""));
+    const std::string build_name{header.build_name.data(),
+                                 strnlen(header.build_name.data(), header.build_name.size())};
+
+    if (revision == Common::g_scm_rev) {
+        info.status = SaveStateInfo::ValidationStatus::OK;
+    } else {
+        if (!build_name.empty()) {
+            info.build_name = build_name;
+        } else {
+            info.build_name = revision;
+        }
+        LOG_WARNING(Core, "Save state file {} created from a different revision {}", info.slot,
+                    info.build_name);
+        info.status = SaveStateInfo::ValidationStatus::RevisionDismatch;
+    }
+    return true;
+}
+
+std::vector<SaveStateInfo> ListSaveStates(u64 program_id, u64 movie_id) {
+    std::vector<SaveStateInfo> result;
+    result.reserve(SaveStateSlotCount);
+    for (u32 slot = 1; slot <= SaveStateSlotCount; ++slot) {
+        const auto path = GetSaveStatePath(program_id, movie_id, slot);
+        if (!FileUtil::Exists(path)) {
+            continue;
+        }
+
+        SaveStateInfo info;
+        info.slot = slot;
+
+        FileUtil::IOFile file(path, "rb");
+        if (!file) {
+            LOG_ERROR(Core, "Could not open file {}", path);
+            continue;
+        }
+
+        CSTHeader header;
+        if (file.GetSize() < sizeof(header)) {
+            LOG_ERROR(Core, "File too small {}", path);
+            continue;
+        }
+        if (file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+            LOG_ERROR(Core, "Could not read from file {}", path);
+            continue;
+        }
+        if (!ValidateSaveState(header, info, program_id)) {
+            continue;
+        }
+
+        info.time = header.time;
+        result.emplace_back(std::move(info));
+    }
+    return result;
+}
+
+/// Returns the uncompressed state stream of a snapshot, decompressing it if needed.
+static std::vector<u8> GetSnapshotData(const StateSnapshot& snapshot) {
+    if (!snapshot.compressed) {
+        return snapshot.data;
+    }
+    auto decompressed = Common::Compression::DecompressDataZSTD(snapshot.data);
+    if (decompressed.empty()) {
+        throw std::runtime_error("Unable to decompress savestate");
+    }
+    return decompressed;
+}
+
+void CompressSnapshot(StateSnapshot& snapshot) {
+    if (snapshot.compressed) {
+        return;
+    }
+    const auto num_workers = std::max(std::thread::hardware_concurrency(), 1U);
+    auto compressed = Common::Compression::CompressDataZSTDMultithreaded(
+        snapshot.data, SaveStateCompressionLevel, num_workers);
+    if (compressed.empty()) {
+        throw std::runtime_error("Unable to compress savestate");
+    }
+    snapshot.data = std::move(compressed);
+    snapshot.compressed = true;
+}
+
+StateSnapshot MergeSnapshots(const StateSnapshot& base, const StateSnapshot& delta) {
+    if (base.IsIncremental() || delta.base_id != base.id) {
+        throw std::runtime_error("Snapshots can't be merged");
+    }
+
+    const auto base_data = GetSnapshotData(base);
+    const auto delta_data = GetSnapshotData(delta);
+    StateReader base_reader{base_data};
+    StateReader delta_reader{delta_data};
+
+    // Only the memory section is incremental, every other section is taken from the delta as is.
+    StateWriter writer{base_data.size()};
+    Memory::MemorySystem::MergeState(base_reader, delta_reader, writer);
+    const auto remaining = delta_reader.Remaining();
+    writer.WriteBytes(remaining.data(), remaining.size());
+
+    StateSnapshot merged{};
+    merged.id = delta.id;
+    merged.page_hashes = delta.page_hashes;
+    const auto data = writer.Data();
+    merged.data.assign(data.begin(), data.end());
+    return merged;
+}
+
+StateSnapshot System::CaptureSnapshot(const StateSnapshot* base) const {
+    static std::atomic<u64> next_snapshot_id{1};
+
+    // Write back any surfaces modified by the GPU so the memory image is up to date.
+    gpu->WaitIdle();
+    gpu->Renderer().Rasterizer()->FlushAll();
+
+    StateSnapshot snapshot{};
+    snapshot.id = next_snapshot_id++;
+    if (base) {
+        snapshot.base_id = base->id;
+    }
+
+    // Memory goes first, so restoring an incremental snapshot can apply the memory sections of its
+    // bases without parsing the remaining sections of them.
+    StateWriter writer{base ? 0 : SaveStateReserveSize};
+    memory->SaveState(writer, base ? &base->page_hashes : nullptr, &snapshot.page_hashes);
+    kernel->SaveState(writer);
+    timing->SaveState(writer);
+    gpu->SaveState(writer);
+    dsp_core->SaveState(writer);
+
+    const auto data = writer.Data();
+    snapshot.data.assign(data.begin(), data.end());
+    return snapshot;
+}
+
+void System::RestoreSnapshot(const StateSnapshot& snapshot,
+                             std::span<const StateSnapshot* const> bases) {
+    // Validate the whole chain before touching any state.
+    if (snapshot.IsIncremental()) {
+        if (bases.empty() || bases.front()->IsIncremental() ||
+            bases.back()->id != snapshot.base_id) {
+            throw std::runtime_error("Base of the incremental snapshot is missing");
+        }
+        for (std::size_t i = 1; i < bases.size(); ++i) {
+            if (bases[i]->base_id != bases[i - 1]->id) {
+                throw std::runtime_error("Snapshot chain is broken");
+            }
+        }
+    }
+
+    const auto data = GetSnapshotData(snapshot);
+
+    // The memory image is about to be replaced, so drop all cached surfaces without writing
+    // them back.
+    gpu->ClearAll(false);
+
+    if (snapshot.IsIncremental()) {
+        for (const StateSnapshot* base : bases) {
+            const auto base_data = GetSnapshotData(*base);
+            StateReader base_reader{base_data};
+            memory->LoadState(base_reader);
+        }
+    }
+
+    StateReader reader{data};
+    memory->LoadState(reader);
+    kernel->LoadState(reader);
+    timing->LoadState(reader);
+    gpu->LoadState(reader);
+    dsp_core->LoadState(reader);
+
+    // Any translated code may now refer to stale guest memory.
+    for (auto& cpu_core : cpu_cores) {
+        cpu_core->ClearInstructionCache();
+        cpu_core->ClearExclusiveState();
+    }
+}
+
+void System::SaveState(u32 slot) const {
+    const auto start = std::chrono::steady_clock::now();
+
+    auto snapshot = CaptureSnapshot();
+    const std::size_t uncompressed_size = snapshot.data.size();
+    CompressSnapshot(snapshot);
+
+    CSTHeader header{};
+    header.filetype = header_magic_bytes;
+    header.program_id = title_id;
+    std::string rev_bytes;
+    CryptoPP::StringSource(Common::g_scm_rev, true,
+                           new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
+    std::memcpy(header.revision.data(), rev_bytes.data(),
+                std::min(rev_bytes.size(), sizeof(header.revision)));
+    header.time = std::chrono::duration_cast<std::chrono::seconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    const std::string_view build_name = Common::g_build_name;
+    std::memcpy(header.build_name.data(), build_name.data(),
+                std::min(build_name.size(), header.build_name.size() - 1));
+    header.format_version = SaveStateFormatVersion;
+
+    const auto path = GetSaveStatePath(title_id, movie.GetCurrentMovieID(), slot);
+    if (!FileUtil::CreateFullPath(path)) {
+        throw std::runtime_error("Could not create path " + path);
+    }
+
+    FileUtil::IOFile file(path, "wb");
+    if (!file) {
+        throw std::runtime_error("Could not open file " + path);
+    }
+    if (file.WriteBytes(&header, sizeof(header)) != sizeof(header)) {
+        throw std::runtime_error("Could not write to file " + path);
+    }
+    if (file.WriteBytes(snapshot.data.data(), snapshot.data.size()) != snapshot.data.size()) {
+        throw std::runtime_error("Could not write to file " + path);
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    LOG_INFO(Core, "Saved state to slot {} ({} bytes -> {} bytes) in {} ms", slot,
+             uncompressed_size, snapshot.data.size(), elapsed.count());
+}
+
+void System::LoadState(u32 slot) {
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto path = GetSaveStatePath(title_id, movie.GetCurrentMovieID(), slot);
+    FileUtil::IOFile file(path, "rb");
+    if (!file) {
+        throw std::runtime_error("Could not open file " + path);
+    }
+
+    CSTHeader header;
+    if (file.GetSize() < sizeof(header) ||
+        file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+        throw std::runtime_error("Could not read from file " + path);
+    }
+
+    SaveStateInfo info{};
+    info.slot = slot;
+    if (!ValidateSaveState(header, info, title_id)) {
+        throw std::runtime_error("Invalid savestate");
+    }
+    if (header.format_version != SaveStateFormatVersion) {
+        throw std::runtime_error("Savestate was created with an incompatible format version");
+    }
+
+    StateSnapshot snapshot{};
+    snapshot.compressed = true;
+    snapshot.data.resize(file.GetSize() - sizeof(header));
+    if (file.ReadBytes(snapshot.data.data(), snapshot.data.size()) != snapshot.data.size()) {
+        throw std::runtime_error("Could not read from file " + path);
+    }
+
+    RestoreSnapshot(snapshot);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    LOG_INFO(Core, "Loaded state from slot {} in {} ms", slot, elapsed.count());
+}
+
+} // namespace Core
@@ -0,0 +1,155 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "common/common_types.h"
+#include "core/memory.h"
+
+namespace Core {
+
+struct CSTHeader;
+
+struct SaveStateInfo {
+    u32 slot;
+    u64 time;
+    enum class ValidationStatus {
+        OK,
+        RevisionDismatch,
+    } status;
+    std::string build_name;
+};
+
+constexpr u32 SaveStateSlotCount = 10; // Maximum count of savestate slots
+
+/// Returns the savestates that exist for the given program and movie.
+std::vector<SaveStateInfo> ListSaveStates(u64 program_id, u64 movie_id);
+
+/**
+ * Savestate kept in memory rather than in a slot file. Incremental snapshots only hold the memory
+ * pages that changed since the snapshot they are based on, so they are a fraction of the size of
+ * a full one and can be taken frequently. Restoring one needs the whole chain of snapshots back to
+ * the nearest full snapshot.
+ */
+struct StateSnapshot {
+    u64 id{};      ///< Unique, increasing identifier of the snapshot
+    u64 base_id{}; ///< Identifier of the snapshot this one is relative to, 0 if full
+    bool compressed{};
+    std::vector<u8> data;
+    Memory::PageHashes page_hashes; ///< Page hashes at capture time, to diff later snapshots against
+
+    [[nodiscard]] bool IsIncremental() const {
+        return base_id != 0;
+    }
+};
+
+/// Compresses the data of a captured snapshot. Safe to call from any thread.
+void CompressSnapshot(StateSnapshot& snapshot);
+
+/**
+ * Folds an incremental snapshot into its full base, producing a full snapshot equivalent to the
+ * incremental one. Safe to call from any thread.
+ * @throws std::runtime_error if the snapshots are corrupted or not directly related.
+ */
+[[nodiscard]] StateSnapshot MergeSnapshots(const StateSnapshot& base, const StateSnapshot& delta);
+
+/**
+ * Append-only binary stream that subsystems write their state into. Values are stored in host
+ * byte order, as savestates are not meant to be portable between hosts of different endianness.
+ */
+class StateWriter {
+public:
+    explicit StateWriter(std::size_t reserve_size = 0) {
+        buffer.reserve(reserve_size);
+    }
+
+    void WriteBytes(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const u8*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Type must be trivially copyable");
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteString(const std::string& value) {
+        Write<u32>(static_cast<u32>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+    [[nodiscard]] std::span<const u8> Data() const {
+        return buffer;
+    }
+
+private:
+    std::vector<u8> buffer;
+};
+
+/**
+ * Reader counterpart of StateWriter. Throws std::runtime_error when the stream is truncated, so
+ * callers do not have to check every read individually.
+ */
+class StateReader {
+public:
+    explicit StateReader(std::span<const u8> data_) : data{data_} {}
+
+    void ReadBytes(void* dest, std::size_t size) {
+        if (size > data.size() - offset) {
+            throw std::runtime_error("Savestate data is truncated");
+        }
+        std::memcpy(dest, data.data() + offset, size);
+        offset += size;
+    }
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>, "Type must be trivially copyable");
+        T value;
+        ReadBytes(&value, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void Read(T& value) {
+        value = Read<T>();
+    }
+
+    /// Returns the part of the stream that has not been read yet.
+    [[nodiscard]] std::span<const u8> Remaining() const {
+        return data.subspan(offset);
+    }
+
+    std::string ReadString() {
+        std::string value(Read<u32>(), '\0');
+        ReadBytes(value.data(), value.size());
+        return value;
+    }
+
+    /// Reads a section tag and throws if it does not match the expected one.
+    void ExpectTag(u32 tag) {
+        if (Read<u32>() != tag) {
+            throw std::runtime_error("Savestate section is corrupted");
+        }
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t offset{};
+};
+
+/// Builds a four character section tag, used to detect stream misalignment while loading.
+constexpr u32 MakeStateTag(const char (&tag)[5]) {
+    return static_cast<u32>(tag[0]) | (static_cast<u32>(tag[1]) << 8) |
+           (static_cast<u32>(tag[2]) << 16) | (static_cast<u32>(tag[3]) << 24);
+}
+
+} // namespace Core
@@ -2,17 +2,114 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <cstring>
+#include <fmt/format.h>
 #include "common/assert.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/zstd_compression.h"
 #include "core/tracer/recorder.h"
 
 namespace CiTrace {
 
-Recorder::Recorder(const InitialState& initial_state) : initial_state(initial_state) {}
+namespace {
+/// Amount of memory contents compressed together in a chunk of the spool file
+constexpr std::size_t ChunkSize = 4 * 1024 * 1024;
+
+/// Header of every chunk stored in the spool file
+struct ChunkHeader {
+    u32 size;
+    u32 compressed_size;
+};
+} // Anonymous namespace
+
+Recorder::Recorder(const InitialState& initial_state) : initial_state(initial_state) {
+    const std::string cache_dir = FileUtil::GetUserPath(FileUtil::UserPath::CacheDir);
+    FileUtil::CreateFullPath(cache_dir);
+    spool_path = fmt::format("{}citrace_{:016X}.tmp", cache_dir,
+                             std::chrono::steady_clock::now().time_since_epoch().count());
+    spool = FileUtil::IOFile(spool_path, "w+b");
+    if (!spool.IsOpen()) {
+        LOG_ERROR(HW_GPU, "Could not create CiTrace spool file {}", spool_path);
+        spool_failed = true;
+    }
+
+    spool_thread = std::jthread([this] { SpoolLoop(); });
+}
+
+Recorder::~Recorder() {
+    if (spool_thread.joinable()) {
+        chunk_queue.Push(std::vector<u8>{});
+        spool_thread.join();
+    }
+    spool.Close();
+    FileUtil::Delete(spool_path);
+}
+
+void Recorder::SubmitChunk() {
+    if (pending_chunk.empty()) {
+        return;
+    }
+    chunk_queue.Push(std::move(pending_chunk));
+    pending_chunk = {};
+    pending_chunk.reserve(ChunkSize);
+}
+
+void Recorder::SpoolLoop() {
+    while (true) {
+        std::vector<u8> chunk = chunk_queue.PopWait();
+        if (chunk.empty()) {
+            return;
+        }
+        if (spool_failed) {
+            continue;
+        }
+
+        const std::vector<u8> compressed = Common::Compression::CompressDataZSTDDefault(chunk);
+        const ChunkHeader header{static_cast<u32>(chunk.size()),
+                                 static_cast<u32>(compressed.size())};
+        if (spool.WriteObject(header) != 1 ||
+            spool.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            LOG_ERROR(HW_GPU, "Failed to write to CiTrace spool file {}", spool_path);
+            spool_failed = true;
+        }
+    }
+}
+
+bool Recorder::CopySpooledData(FileUtil::IOFile& file) {
+    if (spool_failed || !spool.Seek(0, SEEK_SET)) {
+        return false;
+    }
+
+    u32 copied = 0;
+    std::vector<u8> compressed;
+    while (copied < memory_data_size) {
+        ChunkHeader header;
+        if (spool.ReadArray(&header, 1) != 1) {
+            return false;
+        }
+        compressed.resize(header.compressed_size);
+        if (spool.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            return false;
+        }
+        const std::vector<u8> chunk = Common::Compression::DecompressDataZSTD(compressed);
+        if (chunk.size() != header.size ||
+            file.WriteBytes(chunk.data(), chunk.size()) != chunk.size()) {
+            return false;
+        }
+        copied += header.size;
+    }
+    return copied == memory_data_size;
+}
 
 void Recorder::Finish(const std::string& filename) {
+    // Spool the remaining memory contents and wait for the spool thread to write everything
+    SubmitChunk();
+    chunk_queue.Push(std::vector<u8>{});
+    spool_thread.join();
+
     // Setup CiTrace header
     CTHeader header;
     std::memcpy(header.magic, CTHeader::ExpectedMagicWord(), 4);
@@ -50,26 +147,15 @@ void Recorder::Finish(const std::string& filename) {
         initial.gs_program_binary + initial.gs_program_binary_size * sizeof(u32);
     initial.gs_float_uniforms =
         initial.gs_swizzle_data + initial.gs_swizzle_data_size * sizeof(u32);
-    header.stream_offset = initial.gs_float_uniforms + initial.gs_float_uniforms_size * sizeof(u32);
+    const u32 memory_data_offset =
+        initial.gs_float_uniforms + initial.gs_float_uniforms_size * sizeof(u32);
+    header.stream_offset = memory_data_offset + memory_data_size;
 
-    // Iterate through stream elements, update relevant stream element data
+    // Memory contents are stored right after the initial state
     for (auto& stream_element : stream) {
-        switch (stream_element.data.type) {
-        case MemoryLoad: {
-            auto& file_offset = memory_regions[stream_element.hash];
-            if (!stream_element.uses_existing_data) {
-                file_offset = header.stream_offset;
-            }
-            stream_element.data.memory_load.file_offset = file_offset;
-            break;
-        }
-
-        default:
-            // Other commands don't use any extra data
-            DEBUG_ASSERT(stream_element.extra_data.size() == 0);
-            break;
+        if (stream_element.type == MemoryLoad) {
+            stream_element.memory_load.file_offset += memory_data_offset;
         }
-        header.stream_offset += static_cast<u32>(stream_element.extra_data.size());
     }
 
     try {
@@ -133,58 +219,49 @@ void Recorder::Finish(const std::string& filename) {
             file.Tell() != initial.gs_float_uniforms + sizeof(u32) * initial.gs_float_uniforms_size)
             throw "Failed to write geometry shader float uniforms";
 
-        // Iterate through stream elements, write "extra data"
-        for (const auto& stream_element : stream) {
-            if (stream_element.extra_data.size() == 0)
-                continue;
-
-            written =
-                file.WriteBytes(stream_element.extra_data.data(), stream_element.extra_data.size());
-            if (written != stream_element.extra_data.size())
-                throw "Failed to write extra data";
-        }
+        // Write the memory contents referenced by memory loads
+        if (!CopySpooledData(file))
+            throw "Failed to write memory contents";
 
         if (file.Tell() != header.stream_offset)
-            throw "Unexpected end of extra data";
+            throw "Unexpected end of memory contents";
 
         // Write actual stream elements
-        for (const auto& stream_element : stream) {
-            if (1 != file.WriteObject(stream_element.data))
-                throw "Failed to write stream element";
-        }
+        if (file.WriteArray(stream.data(), stream.size()) != stream.size())
+            throw "Failed to write stream elements";
     } catch (const char* str) {
         LOG_ERROR(HW_GPU, "Writing CiTrace file failed: {}", str);
     }
 }
 
 void Recorder::FrameFinished() {
-    stream.push_back({{FrameMarker}});
+    stream.push_back({FrameMarker});
 }
 
 void Recorder::MemoryAccessed(const u8* data, u32 size, u32 physical_address) {
-    StreamElement element = {{MemoryLoad}};
-    element.data.memory_load.size = size;
-    element.data.memory_load.physical_address = physical_address;
+    CTStreamElement element{MemoryLoad};
+    element.memory_load.size = size;
+    element.memory_load.physical_address = physical_address;
 
     // Compute hash over given memory region to check if the contents are already stored internally
-    boost::crc_32_type result;
-    result.process_bytes(data, size);
-    element.hash = result.checksum();
-
-    element.uses_existing_data = (memory_regions.find(element.hash) != memory_regions.end());
-    if (!element.uses_existing_data) {
-        element.extra_data.resize(size);
-        std::memcpy(element.extra_data.data(), data, size);
-        memory_regions.insert({element.hash, 0}); // file offset will be initialized in Finish()
+    const u64 hash = Common::HashCombine(Common::ComputeHash64(data, size), size);
+    const auto [it, inserted] = memory_regions.try_emplace(hash, memory_data_size);
+    if (inserted) {
+        pending_chunk.insert(pending_chunk.end(), data, data + size);
+        memory_data_size += size;
+        if (pending_chunk.size() >= ChunkSize) {
+            SubmitChunk();
+        }
     }
+    element.memory_load.file_offset = it->second;
 
     stream.push_back(element);
 }
 
 void Recorder::RegisterWritten(u32 physical_address, u32 value) {
-    StreamElement element = {{RegisterWrite}};
-    element.data.register_write.physical_address = physical_address;
-    element.data.register_write.value = value;
+    CTStreamElement element{RegisterWrite};
+    element.register_write.physical_address = physical_address;
+    element.register_write.value = value;
 
     stream.push_back(element);
 }
@@ -7,12 +7,19 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
-#include <boost/crc.hpp>
 #include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/polyfill_thread.h"
+#include "common/threadsafe_queue.h"
 #include "core/tracer/citrace.h"
 
 namespace CiTrace {
 
+/**
+ * Records the PICA command stream to a CiTrace file. The contents of memory loads are deduplicated
+ * by hash, and new contents are compressed and spooled to a temporary file by a background thread
+ * as the recording goes, so that long captures are not limited by the available memory.
+ */
 class Recorder {
 public:
     struct InitialState {
@@ -33,6 +40,9 @@ public:
      */
     explicit Recorder(const InitialState& initial_state);
 
+    /// Discards the recording if it has not been finished.
+    ~Recorder();
+
     /// Finish recording of this Citrace and save it using the given filename.
     void Finish(const std::string& filename);
 
@@ -53,33 +63,39 @@ public:
     void RegisterWritten(u32 physical_address, u32 value);
 
 private:
-    // Initial state of recording start
-    InitialState initial_state;
+    /// Hands the pending memory contents to the spool thread.
+    void SubmitChunk();
 
-    // Command stream
-    struct StreamElement {
-        CTStreamElement data;
+    /// Compresses the chunks handed to it and appends them to the spool file.
+    void SpoolLoop();
 
-        /**
-         * Extra data to store along "core" data.
-         * This is e.g. used for data used in MemoryUpdates.
-         */
-        std::vector<u8> extra_data;
+    /// Copies the decompressed spooled memory contents to the given file.
+    bool CopySpooledData(FileUtil::IOFile& file);
 
-        /// Optional CRC hash (e.g. for hashing memory regions)
-        boost::crc_32_type::value_type hash;
-
-        /// If true, refer to data already written to the output file instead of extra_data
-        bool uses_existing_data;
-    };
+    // Initial state of recording start
+    InitialState initial_state;
 
-    std::vector<StreamElement> stream;
+    // Command stream. The file offsets of memory loads are relative to the start of the contents.
+    std::vector<CTStreamElement> stream;
 
     /**
-     * Internal cache which maps hashes of memory contents to file offsets at which those memory
+     * Internal cache which maps hashes of memory contents to the offsets at which those memory
      * contents are stored.
      */
-    std::unordered_map<boost::crc_32_type::value_type /*hash*/, u32 /*file_offset*/> memory_regions;
+    std::unordered_map<u64 /*hash*/, u32 /*offset*/> memory_regions;
+
+    /// Total size of the unique memory contents recorded so far.
+    u32 memory_data_size{};
+
+    /// Memory contents not handed to the spool thread yet.
+    std::vector<u8> pending_chunk;
+
+    std::string spool_path;
+    FileUtil::IOFile spool;
+    /// Uncompressed chunks to be spooled, an empty chunk stops the spool thread.
+    Common::SPSCQueue<std::vector<u8>> chunk_queue;
+    std::jthread spool_thread;
+    bool spool_failed{};
 };
 
 } // namespace CiTrace
@@ -2,12 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 #include <cryptopp/base64.h>
 
 #ifdef _WIN32
@@ -57,6 +59,8 @@ static void PrintHelp(const char* argv0) {
                  "--ban-list-file     The file for storing the room ban list\n"
                  "--log-file          The file for storing the room log\n"
                  "--enable-citra-mods Allow Citra Community Moderators to moderate on your room\n"
+                 "--room-count        The number of rooms to host, on consecutive ports\n"
+                 "--worker-threads    The number of threads servicing the rooms\n"
                  "-h, --help          Display this help and exit\n"
                  "-v, --version       Output version information and exit\n";
 }
@@ -149,6 +153,39 @@ static void SaveBanList(const Network::Room::BanList& ban_list, const std::strin
     file.flush();
 }
 
+/// Merges the ban lists of all rooms, as they share a single ban list file.
+static Network::Room::BanList MergeBanLists(
+    const std::vector<std::shared_ptr<Network::Room>>& rooms) {
+    Network::Room::BanList merged;
+    const auto append_unique = [](std::vector<std::string>& out, const auto& in) {
+        for (const auto& entry : in) {
+            if (std::find(out.begin(), out.end(), entry) == out.end()) {
+                out.push_back(entry);
+            }
+        }
+    };
+    for (const auto& room : rooms) {
+        const Network::Room::BanList ban_list = room->GetBanList();
+        append_unique(merged.first, ban_list.first);
+        append_unique(merged.second, ban_list.second);
+    }
+    return merged;
+}
+
+static void PrintStatistics(const std::vector<std::shared_ptr<Network::Room>>& rooms) {
+    for (const auto& room : rooms) {
+        const Network::Room::Statistics stats = room->GetStatistics();
+        const auto busy_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(stats.busy_time).count();
+        std::cout << room->GetRoomInformation().name << " (port "
+                  << room->GetRoomInformation().port << "): " << stats.member_count
+                  << " members, " << stats.packets_received << " packets / "
+                  << stats.bytes_received << " bytes received, " << stats.packets_relayed
+                  << " packets relayed, " << busy_ms << " ms busy\n";
+    }
+    std::cout << std::endl;
+}
+
 static void InitializeLogging(const std::string& log_file) {
     Common::Log::Initialize(log_file);
     Common::Log::SetColorConsoleBackendEnabled(true);
@@ -173,6 +210,8 @@ int main(int argc, char** argv) {
     u64 preferred_game_id = 0;
     u16 port = Network::DefaultRoomPort;
     u32 max_members = 16;
+    u32 room_count = 1;
+    u32 worker_threads = 0;
     bool enable_citra_mods = false;
 
     static struct option long_options[] = {
@@ -189,13 +228,16 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-citra-mods", no_argument, 0, 'e'},
+        {"room-count", required_argument, 0, 'c'},
+        {"worker-threads", required_argument, 0, 'r'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "n:d:p:m:w:g:u:t:a:i:l:hv", long_options, &option_index);
+        int arg =
+            getopt_long(argc, argv, "n:d:p:m:w:g:u:t:a:i:l:c:r:hv", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'n':
@@ -237,6 +279,12 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_citra_mods = true;
                 break;
+            case 'c':
+                room_count = strtoul(optarg, &endarg, 0);
+                break;
+            case 'r':
+                worker_threads = strtoul(optarg, &endarg, 0);
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -272,6 +320,16 @@ int main(int argc, char** argv) {
         PrintHelp(argv[0]);
         return -1;
     }
+    if (room_count == 0 || port + room_count - 1 > 65535) {
+        std::cout << "room-count needs to be at least 1 and the rooms need to fit below port "
+                     "65535!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    // A single room keeps its own thread unless a pool is requested explicitly
+    if (worker_threads == 0 && room_count > 1) {
+        worker_threads = std::clamp(std::thread::hardware_concurrency(), 1U, room_count);
+    }
     if (ban_list_file.empty()) {
         std::cout << "Ban list file not set!\nThis should get set to load and save room ban "
                      "list.\nSet with --ban-list-file <file>\n\n";
@@ -312,50 +370,85 @@ int main(int argc, char** argv) {
         ban_list = LoadBanList(ban_list_file);
     }
 
-    std::unique_ptr<Network::VerifyUser::Backend> verify_backend;
-    if (announce) {
+    const auto make_verify_backend = [announce]() -> std::unique_ptr<Network::VerifyUser::Backend> {
+        if (announce) {
 #ifdef ENABLE_WEB_SERVICE
-        verify_backend =
-            std::make_unique<WebService::VerifyUserJWT>(NetSettings::values.web_api_url);
-#else
+            return std::make_unique<WebService::VerifyUserJWT>(NetSettings::values.web_api_url);
+#endif
+        }
+        return std::make_unique<Network::VerifyUser::NullBackend>();
+    };
+#ifndef ENABLE_WEB_SERVICE
+    if (announce) {
         std::cout
             << "Citra Web Services is not available with this build: validation is disabled.\n\n";
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
-#endif
-    } else {
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
     }
+#endif
 
     Network::Init();
-    if (std::shared_ptr<Network::Room> room = Network::GetRoom().lock()) {
-        if (!room->Create(room_name, room_description, "", port, password, max_members, username,
-                          preferred_game, preferred_game_id, std::move(verify_backend), ban_list,
-                          enable_citra_mods)) {
-            std::cout << "Failed to create room: \n\n";
-            return -1;
+    if (std::shared_ptr<Network::Room> global_room = Network::GetRoom().lock()) {
+        std::unique_ptr<Network::RoomWorkerPool> worker_pool;
+        if (worker_threads > 0) {
+            worker_pool = std::make_unique<Network::RoomWorkerPool>(worker_threads);
         }
-        std::cout << "Room is open. Close with Q+Enter...\n\n";
-        auto announce_session = std::make_unique<Network::AnnounceMultiplayerSession>();
-        if (announce) {
-            announce_session->Start();
+
+        // The first room is the global room of the network module, the others are only owned here
+        std::vector<std::shared_ptr<Network::Room>> rooms;
+        for (u32 i = 0; i < room_count; ++i) {
+            auto room = i == 0 ? global_room : std::make_shared<Network::Room>();
+            const std::string name =
+                room_count > 1 ? room_name + " #" + std::to_string(i + 1) : room_name;
+            const u16 room_port = static_cast<u16>(port + i);
+            if (!room->Create(name, room_description, "", room_port, password, max_members,
+                              username, preferred_game, preferred_game_id, make_verify_backend(),
+                              ban_list, enable_citra_mods, worker_pool.get())) {
+                std::cout << "Failed to create room on port " << room_port << "\n\n";
+                for (const auto& created_room : rooms) {
+                    created_room->Destroy();
+                }
+                return -1;
+            }
+            rooms.push_back(std::move(room));
+        }
+        if (worker_pool) {
+            std::cout << rooms.size() << " rooms are serviced by " << worker_pool->GetThreadCount()
+                      << " threads\n";
+        }
+        std::cout << "Room is open. Close with Q+Enter, show statistics with S+Enter...\n\n";
+
+        std::vector<std::unique_ptr<Network::AnnounceMultiplayerSession>> announce_sessions;
+        for (const auto& room : rooms) {
+            announce_sessions.push_back(std::make_unique<Network::AnnounceMultiplayerSession>(
+                std::weak_ptr<Network::Room>(room)));
+            if (announce) {
+                announce_sessions.back()->Start();
+            }
         }
-        while (room->GetState() == Network::Room::State::Open) {
+        while (global_room->GetState() == Network::Room::State::Open) {
             std::string in;
             std::cin >> in;
+            if (in == "s" || in == "S") {
+                PrintStatistics(rooms);
+                continue;
+            }
             if (in.size() > 0) {
                 break;
             }
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
         if (announce) {
-            announce_session->Stop();
+            for (const auto& announce_session : announce_sessions) {
+                announce_session->Stop();
+            }
         }
-        announce_session.reset();
+        announce_sessions.clear();
         // Save the ban list
         if (!ban_list_file.empty()) {
-            SaveBanList(room->GetBanList(), ban_list_file);
+            SaveBanList(MergeBanLists(rooms), ban_list_file);
+        }
+        for (const auto& room : rooms) {
+            room->Destroy();
         }
-        room->Destroy();
     }
     Network::Shutdown();
     detached_tasks.WaitForAllTasks();
@@ -8,6 +8,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <thread>
 #include "common/announce_multiplayer_room.h"
@@ -26,7 +27,10 @@ class Room;
 class AnnounceMultiplayerSession : NonCopyable {
 public:
     using CallbackHandle = std::shared_ptr<std::function<void(const Common::WebResult&)>>;
+    /// Announces the global room of the network module
     AnnounceMultiplayerSession();
+    /// Announces the given room, used when a process hosts several rooms
+    explicit AnnounceMultiplayerSession(std::weak_ptr<Room> room);
     ~AnnounceMultiplayerSession();
 
     /**
@@ -87,6 +91,11 @@ private:
 
     std::atomic_bool registered = false; ///< Whether the room has been registered
 
+    /// Room to announce, the global room is announced if this is not set
+    std::optional<std::weak_ptr<Room>> announced_room;
+
+    std::shared_ptr<Network::Room> LockRoom() const;
+
     void UpdateBackendData(std::shared_ptr<Network::Room> room);
     void AnnounceMultiplayerLoop();
 };
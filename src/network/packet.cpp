@@ -8,11 +8,51 @@
 #include <arpa/inet.h>
 #endif
 #include <cstring>
+#include <mutex>
 #include <string>
+#include "enet/enet.h"
 #include "network/packet.h"
 
 namespace Network {
 
+namespace {
+
+/// Initial capacity of pooled buffers, enough for any UDS frame with its headers
+constexpr std::size_t PooledBufferCapacity = 2048;
+/// Maximum number of idle buffers kept for reuse
+constexpr std::size_t MaxPooledBuffers = 64;
+
+std::mutex buffer_pool_mutex;
+std::vector<std::vector<char>> buffer_pool;
+
+std::vector<char> AcquireBuffer() {
+    {
+        std::scoped_lock lock{buffer_pool_mutex};
+        if (!buffer_pool.empty()) {
+            std::vector<char> buffer = std::move(buffer_pool.back());
+            buffer_pool.pop_back();
+            return buffer;
+        }
+    }
+    std::vector<char> buffer;
+    buffer.reserve(PooledBufferCapacity);
+    return buffer;
+}
+
+void ReleaseBuffer(std::vector<char>&& buffer) {
+    // Buffers that grew for an unusually large packet are not kept around
+    if (buffer.capacity() < PooledBufferCapacity || buffer.capacity() > 4 * PooledBufferCapacity) {
+        return;
+    }
+    buffer.clear();
+    std::scoped_lock lock{buffer_pool_mutex};
+    if (buffer_pool.size() < MaxPooledBuffers) {
+        buffer_pool.push_back(std::move(buffer));
+    }
+}
+
+} // Anonymous namespace
+
 #ifndef htonll
 u64 htonll(u64 x) {
     return ((1 == htonl(1)) ? (x) : ((uint64_t)htonl((x)&0xFFFFFFFF) << 32) | htonl((x) >> 32));
@@ -25,8 +65,20 @@ u64 ntohll(u64 x) {
 }
 #endif
 
+Packet::Packet(std::span<const u8> view)
+    : view_data{reinterpret_cast<const char*>(view.data())}, view_size{view.size()} {}
+
+Packet::~Packet() {
+    ReleaseBuffer(std::move(data));
+}
+
 void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
     if (in_data && (size_in_bytes > 0)) {
+        if (view_data) {
+            DetachView();
+        } else if (data.capacity() == 0) {
+            data = AcquireBuffer();
+        }
         std::size_t start = data.size();
         data.resize(start + size_in_bytes);
         std::memcpy(&data[start], in_data, size_in_bytes);
@@ -35,18 +87,23 @@ void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
 
 void Packet::Read(void* out_data, std::size_t size_in_bytes) {
     if (out_data && CheckSize(size_in_bytes)) {
-        std::memcpy(out_data, &data[read_pos], size_in_bytes);
+        std::memcpy(out_data, ReadData() + read_pos, size_in_bytes);
         read_pos += size_in_bytes;
     }
 }
 
 void Packet::Clear() {
     data.clear();
+    view_data = nullptr;
+    view_size = 0;
     read_pos = 0;
     is_valid = true;
 }
 
 const void* Packet::GetData() const {
+    if (view_data) {
+        return view_data;
+    }
     return !data.empty() ? &data[0] : nullptr;
 }
 
@@ -55,11 +112,38 @@ void Packet::IgnoreBytes(u32 length) {
 }
 
 std::size_t Packet::GetDataSize() const {
-    return data.size();
+    return view_data ? view_size : data.size();
 }
 
 bool Packet::EndOfPacket() const {
-    return read_pos >= data.size();
+    return read_pos >= GetDataSize();
+}
+
+ENetPacket* Packet::ToENetPacket(u32 flags) && {
+    if (view_data) {
+        ENetPacket* packet = enet_packet_create(view_data, view_size, flags);
+        Clear();
+        return packet;
+    }
+
+    // ENet keeps pointing at the buffer and hands it back to the pool once the packet is sent
+    auto* buffer = new std::vector<char>(std::move(data));
+    ENetPacket* packet =
+        enet_packet_create(buffer->data(), buffer->size(), flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+    if (!packet) {
+        ReleaseBuffer(std::move(*buffer));
+        delete buffer;
+        Clear();
+        return nullptr;
+    }
+    packet->userData = buffer;
+    packet->freeCallback = [](ENetPacket* enet_packet) {
+        auto* owned_buffer = static_cast<std::vector<char>*>(enet_packet->userData);
+        ReleaseBuffer(std::move(*owned_buffer));
+        delete owned_buffer;
+    };
+    Clear();
+    return packet;
 }
 
 Packet::operator bool() const {
@@ -143,7 +227,7 @@ Packet& Packet::operator>>(char* out_data) {
 
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        std::memcpy(out_data, &data[read_pos], length);
+        std::memcpy(out_data, ReadData() + read_pos, length);
         out_data[length] = '\0';
 
         // Update reading position
@@ -161,7 +245,7 @@ Packet& Packet::operator>>(std::string& out_data) {
     out_data.clear();
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        out_data.assign(&data[read_pos], length);
+        out_data.assign(ReadData() + read_pos, length);
 
         // Update reading position
         read_pos += length;
@@ -255,9 +339,18 @@ Packet& Packet::operator<<(const std::string& in_data) {
 }
 
 bool Packet::CheckSize(std::size_t size) {
-    is_valid = is_valid && (read_pos + size <= data.size());
+    is_valid = is_valid && (read_pos + size <= GetDataSize());
 
     return is_valid;
 }
 
+void Packet::DetachView() {
+    const char* viewed = view_data;
+    const std::size_t size = view_size;
+    view_data = nullptr;
+    view_size = 0;
+    data = AcquireBuffer();
+    data.assign(viewed, viewed + size);
+}
+
 } // namespace Network
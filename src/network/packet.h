@@ -5,16 +5,37 @@
 #pragma once
 
 #include <array>
+#include <span>
+#include <string>
+#include <type_traits>
 #include <vector>
 #include "common/common_types.h"
 
+typedef struct _ENetPacket ENetPacket;
+
 namespace Network {
 
-/// A class that serializes data for network transfer. It also handles endianess
+/**
+ * A class that serializes data for network transfer. It also handles endianess.
+ * Written packets draw their storage from a pool of reusable buffers. Received data can be read
+ * in place by constructing the packet as a view over it.
+ */
 class Packet {
 public:
     Packet() = default;
-    ~Packet() = default;
+
+    /**
+     * Creates a read-only packet over existing data, e.g. the payload of a received ENet packet.
+     * The data is not copied and must outlive the packet. Appending copies it first.
+     */
+    explicit Packet(std::span<const u8> view);
+
+    ~Packet();
+
+    Packet(const Packet&) = default;
+    Packet& operator=(const Packet&) = default;
+    Packet(Packet&&) noexcept = default;
+    Packet& operator=(Packet&&) noexcept = default;
 
     /**
      * Append data to the end of the packet
@@ -62,6 +83,13 @@ public:
      */
     bool EndOfPacket() const;
 
+    /**
+     * Moves the contents of the packet into an ENet packet that owns the buffer, so that it is
+     * sent without another copy. The packet is empty afterwards.
+     * @param flags The ENet packet flags
+     */
+    ENetPacket* ToENetPacket(u32 flags) &&;
+
     explicit operator bool() const;
 
     /// Overloads of operator >> to read data from the packet
@@ -111,10 +139,24 @@ private:
      */
     bool CheckSize(std::size_t size);
 
+    /// Copies the viewed data into the owned buffer, so that the packet can be appended to.
+    void DetachView();
+
+    /// Pointer to the data being read, either the viewed data or the owned buffer
+    const char* ReadData() const {
+        return view_data ? view_data : data.data();
+    }
+
+    /// Elements that need no byte swapping are copied in one go instead of one at a time
+    template <typename T>
+    static constexpr bool IsBulkType = std::is_same_v<T, u8> || std::is_same_v<T, s8>;
+
     // Member data
-    std::vector<char> data;   ///< Data stored in the packet
-    std::size_t read_pos = 0; ///< Current reading position in the packet
-    bool is_valid = true;     ///< Reading state of the packet
+    std::vector<char> data;          ///< Data stored in the packet
+    const char* view_data = nullptr; ///< External data viewed by the packet, if any
+    std::size_t view_size = 0;       ///< Size of the viewed data
+    std::size_t read_pos = 0;        ///< Current reading position in the packet
+    bool is_valid = true;            ///< Reading state of the packet
 };
 
 template <typename T>
@@ -122,6 +164,14 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
     // First extract the size
     u32 size = 0;
     *this >> size;
+    if constexpr (IsBulkType<T>) {
+        out_data.clear();
+        if (CheckSize(size)) {
+            out_data.resize(size);
+            Read(out_data.data(), size);
+        }
+        return *this;
+    }
     out_data.resize(size);
 
     // Then extract the data
@@ -135,6 +185,10 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator>>(std::array<T, S>& out_data) {
+    if constexpr (IsBulkType<T>) {
+        Read(out_data.data(), S);
+        return *this;
+    }
     for (std::size_t i = 0; i < out_data.size(); ++i) {
         T character;
         *this >> character;
@@ -149,6 +203,10 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
     *this << static_cast<u32>(in_data.size());
 
     // Then insert the data
+    if constexpr (IsBulkType<T>) {
+        Append(in_data.data(), in_data.size());
+        return *this;
+    }
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
     }
@@ -157,6 +215,10 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator<<(const std::array<T, S>& in_data) {
+    if constexpr (IsBulkType<T>) {
+        Append(in_data.data(), S);
+        return *this;
+    }
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
     }
@@ -4,12 +4,16 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <mutex>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <thread>
 #include "common/logging/log.h"
+#include "common/thread.h"
+#include "common/thread_worker.h"
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room.h"
@@ -54,22 +58,61 @@ public:
     RoomImpl()
         : NintendoOUI{0x00, 0x1F, 0x32, 0x00, 0x00, 0x00}, random_gen(std::random_device()()) {}
 
-    /// Thread that receives and dispatches network packets
+    /// Thread that receives and dispatches network packets, unless the room uses a worker pool
     std::unique_ptr<std::thread> room_thread;
 
+    /// Worker pool servicing this room instead of room_thread, if any
+    RoomWorkerPool* worker_pool = nullptr;
+
+    std::atomic<u64> packets_received{0}; ///< Number of packets received from the members
+    std::atomic<u64> bytes_received{0};   ///< Number of bytes received from the members
+    std::atomic<u64> packets_relayed{0};  ///< Number of wifi packets forwarded to members
+    std::atomic<s64> busy_time_ns{0};     ///< Time spent handling events, in nanoseconds
+
     /// Verification backend of the room
     std::unique_ptr<VerifyUser::Backend> verify_backend;
 
+    /// A join request that passed the checks which don't depend on the other members
+    struct PendingJoin {
+        Member member;
+        MacAddress preferred_mac;
+        u32 connect_id; ///< Tells whether member.peer is still the connection that asked to join
+    };
+
+    /// Joins whose token has been verified, waiting to be completed by the room thread
+    std::vector<PendingJoin> verified_joins;
+    std::mutex verified_joins_mutex;
+
+    /// Verifies the tokens of joining members, as the backend may have to wait on the network.
+    /// Created with the first token, declared last so that it stops before the above is freed.
+    std::unique_ptr<Common::ThreadWorker> verify_worker;
+
     /// Thread function that will receive and dispatch messages until the room is destroyed.
     void ServerLoop();
     void StartLoop();
 
+    /// Dispatches a single event received by the host.
+    void HandleEvent(ENetEvent& event);
+
+    /// Handles the events that are already pending without waiting for new ones. Used by the
+    /// worker pool, which waits on the sockets of all of its rooms at once instead.
+    void ServiceEvents();
+
     /**
-     * Parses and answers a room join request from a client.
+     * Parses a room join request from a client and validates the password and version. The token
+     * of the client is verified on verify_worker, after which CompleteJoinRequest answers it.
+     */
+    void HandleJoinRequest(const ENetEvent* event);
+
+    /**
+     * Answers a join request once its token has been verified.
      * Validates the uniqueness of the username and assigns the MAC address
      * that the client will use for the remainder of the connection.
      */
-    void HandleJoinRequest(const ENetEvent* event);
+    void CompleteJoinRequest(PendingJoin join);
+
+    /// Completes the joins that verify_worker has finished verifying
+    void CompleteVerifiedJoins();
 
     /**
      * Parses and answers a kick request from a client.
@@ -222,7 +265,8 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Relays this packet to the member with its destination MAC address, or to all members except
+     * the sender if it is a broadcast. The received ENet packet is forwarded as is.
      * @param event The ENet event containing the data
      */
     void HandleWifiPacket(const ENetEvent* event);
@@ -249,46 +293,10 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
+        CompleteVerifiedJoins();
         ENetEvent event;
         if (enet_host_service(server, &event, 16) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
+            HandleEvent(event);
         }
     }
     // Close the connection to all members:
@@ -299,6 +307,69 @@ void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
 
+void Room::RoomImpl::HandleEvent(ENetEvent& event) {
+    const auto start = std::chrono::steady_clock::now();
+    switch (event.type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        packets_received.fetch_add(1, std::memory_order_relaxed);
+        bytes_received.fetch_add(event.packet->dataLength, std::memory_order_relaxed);
+        switch (event.packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(&event);
+            break;
+        case IdSetGameInfo:
+            HandleGameNamePacket(&event);
+            break;
+        case IdWifiPacket:
+            HandleWifiPacket(&event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(&event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(&event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(&event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(&event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(&event);
+            break;
+        }
+        // Packets forwarded to members are freed by ENet once they have been sent
+        if (event.packet->referenceCount == 0) {
+            enet_packet_destroy(event.packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    busy_time_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                           std::memory_order_relaxed);
+}
+
+void Room::RoomImpl::ServiceEvents() {
+    // Bound the work done per call so that a flooded room can't starve the others of its worker
+    constexpr int MaxEventsPerService = 64;
+    CompleteVerifiedJoins();
+    ENetEvent event;
+    for (int i = 0; i < MaxEventsPerService; ++i) {
+        if (enet_host_service(server, &event, 0) <= 0) {
+            break;
+        }
+        HandleEvent(event);
+    }
+}
+
 void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     {
         std::lock_guard lock(member_mutex);
@@ -307,8 +378,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
             return;
         }
     }
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string nickname;
     packet >> nickname;
@@ -333,15 +403,80 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         return;
     }
 
-    if (!IsValidNickname(nickname)) {
-        SendNameCollision(event->peer);
+    if (client_version != network_version) {
+        SendVersionMismatch(event->peer);
+        return;
+    }
+
+    PendingJoin join{};
+    join.member.console_id_hash = console_id_hash;
+    join.member.nickname = nickname;
+    join.member.peer = event->peer;
+    join.preferred_mac = preferred_mac;
+    join.connect_id = event->peer->connectID;
+
+    std::string uid;
+    {
+        std::lock_guard lock(verify_UID_mutex);
+        uid = verify_UID;
+    }
+
+    // Without a token there is nothing for the backend to wait on
+    if (token.empty()) {
+        join.member.user_data = verify_backend->LoadUserData(uid, token);
+        CompleteJoinRequest(std::move(join));
         return;
     }
 
+    if (!verify_worker) {
+        verify_worker = std::make_unique<Common::ThreadWorker>(1, "RoomVerify");
+    }
+    verify_worker->QueueWork([this, join = std::move(join), uid = std::move(uid),
+                              token = std::move(token)]() mutable {
+        join.member.user_data = verify_backend->LoadUserData(uid, token);
+        std::scoped_lock lock{verified_joins_mutex};
+        verified_joins.push_back(std::move(join));
+    });
+}
+
+void Room::RoomImpl::CompleteVerifiedJoins() {
+    std::vector<PendingJoin> joins;
+    {
+        std::scoped_lock lock{verified_joins_mutex};
+        joins.swap(verified_joins);
+    }
+    for (PendingJoin& join : joins) {
+        // The client may have disconnected, and its peer been reused, during the verification
+        ENetPeer* peer = join.member.peer;
+        if (peer->state == ENET_PEER_STATE_CONNECTED && peer->connectID == join.connect_id) {
+            CompleteJoinRequest(std::move(join));
+        }
+    }
+}
+
+void Room::RoomImpl::CompleteJoinRequest(PendingJoin join) {
+    Member& member = join.member;
+    ENetPeer* peer = member.peer;
+
+    // Other clients may have joined while the token was verified
+    {
+        std::lock_guard lock(member_mutex);
+        if (members.size() >= room_information.member_slots) {
+            SendRoomIsFull(peer);
+            return;
+        }
+    }
+
+    if (!IsValidNickname(member.nickname)) {
+        SendNameCollision(peer);
+        return;
+    }
+
+    MacAddress preferred_mac = join.preferred_mac;
     if (preferred_mac != NoPreferredMac) {
         // Verify if the preferred mac is available
         if (!IsValidMacAddress(preferred_mac)) {
-            SendMacCollision(event->peer);
+            SendMacCollision(peer);
             return;
         }
     } else {
@@ -349,29 +484,13 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         preferred_mac = GenerateMacAddress();
     }
 
-    if (!IsValidConsoleId(console_id_hash)) {
-        SendConsoleIdCollision(event->peer);
-        return;
-    }
-
-    if (client_version != network_version) {
-        SendVersionMismatch(event->peer);
+    if (!IsValidConsoleId(member.console_id_hash)) {
+        SendConsoleIdCollision(peer);
         return;
     }
 
     // At this point the client is ready to be added to the room.
-    Member member{};
     member.mac_address = preferred_mac;
-    member.console_id_hash = console_id_hash;
-    member.nickname = nickname;
-    member.peer = event->peer;
-
-    std::string uid;
-    {
-        std::lock_guard lock(verify_UID_mutex);
-        uid = verify_UID;
-    }
-    member.user_data = verify_backend->LoadUserData(uid, token);
 
     std::string ip;
     {
@@ -382,17 +501,17 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
             std::find(username_ban_list.begin(), username_ban_list.end(),
                       member.user_data.username) != username_ban_list.end()) {
 
-            SendUserBanned(event->peer);
+            SendUserBanned(peer);
             return;
         }
 
         // Check IP ban
         char ip_raw[256];
-        enet_address_get_host_ip(&event->peer->address, ip_raw, sizeof(ip_raw) - 1);
+        enet_address_get_host_ip(&peer->address, ip_raw, sizeof(ip_raw) - 1);
         ip = ip_raw;
 
         if (std::find(ip_ban_list.begin(), ip_ban_list.end(), ip) != ip_ban_list.end()) {
-            SendUserBanned(event->peer);
+            SendUserBanned(peer);
             return;
         }
     }
@@ -407,10 +526,10 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     // Notify everyone that the room information has changed.
     BroadcastRoomInformation();
-    if (HasModPermission(event->peer)) {
-        SendJoinSuccessAsMod(event->peer, preferred_mac);
+    if (HasModPermission(peer)) {
+        SendJoinSuccessAsMod(peer, preferred_mac);
     } else {
-        SendJoinSuccess(event->peer, preferred_mac);
+        SendJoinSuccess(peer, preferred_mac);
     }
 }
 
@@ -420,8 +539,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -462,8 +580,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -523,8 +640,7 @@ void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string address;
@@ -615,8 +731,7 @@ void Room::RoomImpl::SendNameCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdNameCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -625,8 +740,7 @@ void Room::RoomImpl::SendMacCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdMacCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -635,8 +749,7 @@ void Room::RoomImpl::SendConsoleIdCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdConsoleIdCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -645,8 +758,7 @@ void Room::RoomImpl::SendWrongPassword(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdWrongPassword);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -655,8 +767,7 @@ void Room::RoomImpl::SendRoomIsFull(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdRoomIsFull);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -666,8 +777,7 @@ void Room::RoomImpl::SendVersionMismatch(ENetPeer* client) {
     packet << static_cast<u8>(IdVersionMismatch);
     packet << network_version;
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -676,8 +786,7 @@ void Room::RoomImpl::SendJoinSuccess(ENetPeer* client, MacAddress mac_address) {
     Packet packet;
     packet << static_cast<u8>(IdJoinSuccess);
     packet << mac_address;
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -686,8 +795,7 @@ void Room::RoomImpl::SendJoinSuccessAsMod(ENetPeer* client, MacAddress mac_addre
     Packet packet;
     packet << static_cast<u8>(IdJoinSuccessAsMod);
     packet << mac_address;
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -696,8 +804,7 @@ void Room::RoomImpl::SendUserKicked(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdHostKicked);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -706,8 +813,7 @@ void Room::RoomImpl::SendUserBanned(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdHostBanned);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -716,8 +822,7 @@ void Room::RoomImpl::SendModPermissionDenied(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdModPermissionDenied);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -726,8 +831,7 @@ void Room::RoomImpl::SendModNoSuchUser(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdModNoSuchUser);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -741,8 +845,7 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
         packet << ip_ban_list;
     }
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -752,8 +855,7 @@ void Room::RoomImpl::SendCloseMessage() {
     packet << static_cast<u8>(IdCloseRoom);
     std::lock_guard lock(member_mutex);
     if (!members.empty()) {
-        ENetPacket* enet_packet =
-            enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+        ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
         for (auto& member : members) {
             enet_peer_send(member.peer, 0, enet_packet);
         }
@@ -773,8 +875,7 @@ void Room::RoomImpl::SendStatusMessage(StatusMessageTypes type, const std::strin
     packet << username;
     std::lock_guard lock(member_mutex);
     if (!members.empty()) {
-        ENetPacket* enet_packet =
-            enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+        ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
         for (auto& member : members) {
             enet_peer_send(member.peer, 0, enet_packet);
         }
@@ -827,8 +928,7 @@ void Room::RoomImpl::BroadcastRoomInformation() {
         }
     }
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     enet_host_broadcast(server, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -846,33 +946,28 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+    // Message type, WifiPacket type, channel and transmitter address precede the destination
+    constexpr std::size_t DestinationOffset = 3 * sizeof(u8) + sizeof(MacAddress);
+    ENetPacket* enet_packet = event->packet;
+    if (enet_packet->dataLength < DestinationOffset + sizeof(MacAddress)) {
+        LOG_ERROR(Network, "Received a truncated wifi packet");
+        return;
+    }
     MacAddress destination_address;
-    in_packet >> destination_address;
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    std::memcpy(destination_address.data(), enet_packet->data + DestinationOffset,
+                sizeof(MacAddress));
 
+    // Relay the received packet itself instead of a copy, ENet reference counts it per peer. Only
+    // the reliable flag is kept, as the client sends the frames reliably.
+    enet_packet->flags &= ENET_PACKET_FLAG_RELIABLE;
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
         std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
         for (const auto& member : members) {
             if (member.peer != event->peer) {
-                sent_packet = true;
+                packets_relayed.fetch_add(1, std::memory_order_relaxed);
                 enet_peer_send(member.peer, 0, enet_packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
         std::lock_guard lock(member_mutex);
         auto member = std::find_if(members.begin(), members.end(),
@@ -880,6 +975,7 @@ void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
                                        return member.mac_address == destination_address;
                                    });
         if (member != members.end()) {
+            packets_relayed.fetch_add(1, std::memory_order_relaxed);
             enet_peer_send(member->peer, 0, enet_packet);
         } else {
             LOG_ERROR(Network,
@@ -887,15 +983,13 @@ void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
     enet_host_flush(server);
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet{std::span{event->packet->data, event->packet->dataLength}};
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string message;
@@ -919,8 +1013,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     out_packet << sending_member->user_data.username;
     out_packet << message;
 
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = std::move(out_packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
     bool sent_packet = false;
     for (const auto& member : members) {
         if (member.peer != event->peer) {
@@ -944,8 +1037,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
 }
 
 void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet{std::span{event->packet->data, event->packet->dataLength}};
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     GameInfo game_info;
@@ -1013,7 +1105,8 @@ bool Room::Create(const std::string& name, const std::string& description,
                   const u32 max_connections, const std::string& host_username,
                   const std::string& preferred_game, u64 preferred_game_id,
                   std::unique_ptr<VerifyUser::Backend> verify_backend,
-                  const Room::BanList& ban_list, bool enable_citra_mods) {
+                  const Room::BanList& ban_list, bool enable_citra_mods,
+                  RoomWorkerPool* worker_pool) {
     ENetAddress address;
     address.host = ENET_HOST_ANY;
     if (!server_address.empty()) {
@@ -1041,8 +1134,17 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->verify_backend = std::move(verify_backend);
     room_impl->username_ban_list = ban_list.first;
     room_impl->ip_ban_list = ban_list.second;
-
-    room_impl->StartLoop();
+    room_impl->worker_pool = worker_pool;
+    room_impl->packets_received = 0;
+    room_impl->bytes_received = 0;
+    room_impl->packets_relayed = 0;
+    room_impl->busy_time_ns = 0;
+
+    if (worker_pool) {
+        worker_pool->Add(room_impl.get());
+    } else {
+        room_impl->StartLoop();
+    }
     return true;
 }
 
@@ -1080,6 +1182,18 @@ std::vector<Room::Member> Room::GetRoomMemberList() const {
     return member_list;
 }
 
+Room::Statistics Room::GetStatistics() const {
+    Statistics statistics{};
+    statistics.packets_received = room_impl->packets_received.load(std::memory_order_relaxed);
+    statistics.bytes_received = room_impl->bytes_received.load(std::memory_order_relaxed);
+    statistics.packets_relayed = room_impl->packets_relayed.load(std::memory_order_relaxed);
+    statistics.busy_time =
+        std::chrono::nanoseconds{room_impl->busy_time_ns.load(std::memory_order_relaxed)};
+    std::lock_guard lock(room_impl->member_mutex);
+    statistics.member_count = static_cast<u32>(room_impl->members.size());
+    return statistics;
+}
+
 bool Room::HasPassword() const {
     return !room_impl->password.empty();
 }
@@ -1091,8 +1205,15 @@ void Room::SetVerifyUID(const std::string& uid) {
 
 void Room::Destroy() {
     room_impl->state = State::Closed;
-    room_impl->room_thread->join();
-    room_impl->room_thread.reset();
+    if (room_impl->worker_pool) {
+        // Once removed, the worker no longer touches the host and it can be closed from here
+        room_impl->worker_pool->Remove(room_impl.get());
+        room_impl->worker_pool = nullptr;
+        room_impl->SendCloseMessage();
+    } else {
+        room_impl->room_thread->join();
+        room_impl->room_thread.reset();
+    }
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1107,4 +1228,72 @@ void Room::Destroy() {
     room_impl->room_information.name.clear();
 }
 
+struct RoomWorkerPool::Worker {
+    std::mutex mutex;                  ///< Protects rooms
+    std::vector<Room::RoomImpl*> rooms; ///< Rooms serviced by this worker
+    std::jthread thread;
+};
+
+RoomWorkerPool::RoomWorkerPool(u32 num_threads) {
+    workers.resize(std::max(num_threads, 1U));
+    for (auto& worker : workers) {
+        worker = std::make_unique<Worker>();
+        worker->thread = std::jthread([this, &worker = *worker](std::stop_token stop_token) {
+            WorkerLoop(worker, stop_token);
+        });
+    }
+}
+
+RoomWorkerPool::~RoomWorkerPool() = default;
+
+std::size_t RoomWorkerPool::GetThreadCount() const {
+    return workers.size();
+}
+
+void RoomWorkerPool::Add(Room::RoomImpl* room) {
+    const auto load = [](const std::unique_ptr<Worker>& worker) {
+        std::scoped_lock lock{worker->mutex};
+        return worker->rooms.size();
+    };
+    const auto it = std::min_element(
+        workers.begin(), workers.end(),
+        [&](const auto& lhs, const auto& rhs) { return load(lhs) < load(rhs); });
+    std::scoped_lock lock{(*it)->mutex};
+    (*it)->rooms.push_back(room);
+}
+
+void RoomWorkerPool::Remove(Room::RoomImpl* room) {
+    for (auto& worker : workers) {
+        std::scoped_lock lock{worker->mutex};
+        std::erase(worker->rooms, room);
+    }
+}
+
+void RoomWorkerPool::WorkerLoop(Worker& worker, std::stop_token stop_token) {
+    Common::SetCurrentThreadName("RoomWorker");
+    while (!stop_token.stop_requested()) {
+        ENetSocketSet read_set;
+        ENET_SOCKETSET_EMPTY(read_set);
+        ENetSocket max_socket = 0;
+        bool has_rooms = false;
+        {
+            std::scoped_lock lock{worker.mutex};
+            for (auto* room : worker.rooms) {
+                room->ServiceEvents();
+                ENET_SOCKETSET_ADD(read_set, room->server->socket);
+                max_socket = std::max(max_socket, room->server->socket);
+                has_rooms = true;
+            }
+        }
+
+        // Wait until any of the rooms receives a packet. The timeout matches the one of the
+        // dedicated room threads and lets ENet handle resends and peer timeouts.
+        if (has_rooms) {
+            enet_socketset_select(max_socket, &read_set, nullptr, 16);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        }
+    }
+}
+
 } // namespace Network
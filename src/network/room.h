@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <memory>
+#include <stop_token>
 #include <string>
 #include <vector>
 #include "common/common_types.h"
@@ -87,6 +89,8 @@ enum StatusMessageTypes : u8 {
     IdAddressUnbanned, ///< A username / ip address is unbanned from the room
 };
 
+class RoomWorkerPool;
+
 /// This is what a server [person creating a server] would use.
 class Room final {
 public:
@@ -104,6 +108,14 @@ public:
         MacAddress mac_address;   ///< The assigned mac address of the member.
     };
 
+    struct Statistics {
+        u64 packets_received;               ///< Packets received from the members
+        u64 bytes_received;                 ///< Bytes received from the members
+        u64 packets_relayed;                ///< Wifi packets forwarded to other members
+        std::chrono::nanoseconds busy_time; ///< Time spent handling the received events
+        u32 member_count;                   ///< Number of members currently in the room
+    };
+
     Room();
     ~Room();
 
@@ -132,6 +144,11 @@ public:
      */
     bool HasPassword() const;
 
+    /**
+     * Gets the traffic statistics of the room since it was created.
+     */
+    Statistics GetStatistics() const;
+
     using UsernameBanList = std::vector<std::string>;
     using IPBanList = std::vector<std::string>;
 
@@ -139,7 +156,8 @@ public:
 
     /**
      * Creates the socket for this room. Will bind to default address if
-     * server is empty string.
+     * server is empty string. If worker_pool is set, the room is serviced by the threads of the
+     * pool instead of a thread of its own. The pool must outlive the room.
      */
     bool Create(const std::string& name, const std::string& description = "",
                 const std::string& server = "", u16 server_port = DefaultRoomPort,
@@ -148,7 +166,8 @@ public:
                 const std::string& host_username = "", const std::string& preferred_game = "",
                 u64 preferred_game_id = 0,
                 std::unique_ptr<VerifyUser::Backend> verify_backend = nullptr,
-                const BanList& ban_list = {}, bool enable_citra_mods = false);
+                const BanList& ban_list = {}, bool enable_citra_mods = false,
+                RoomWorkerPool* worker_pool = nullptr);
 
     /**
      * Sets the verification GUID of the room.
@@ -166,8 +185,41 @@ public:
     void Destroy();
 
 private:
+    friend class RoomWorkerPool;
+
     class RoomImpl;
     std::unique_ptr<RoomImpl> room_impl;
 };
 
+/**
+ * Services the network events of several rooms on a fixed number of threads, so that a single
+ * process can host many rooms without a thread per room.
+ */
+class RoomWorkerPool final {
+public:
+    explicit RoomWorkerPool(u32 num_threads);
+    ~RoomWorkerPool();
+
+    RoomWorkerPool(const RoomWorkerPool&) = delete;
+    RoomWorkerPool& operator=(const RoomWorkerPool&) = delete;
+
+    /// Gets the number of worker threads of the pool.
+    std::size_t GetThreadCount() const;
+
+private:
+    friend class Room;
+
+    struct Worker;
+
+    /// Assigns the room to the worker with the least rooms.
+    void Add(Room::RoomImpl* room);
+
+    /// Stops servicing the room. Once this returns no worker accesses the room anymore.
+    void Remove(Room::RoomImpl* room);
+
+    void WorkerLoop(Worker& worker, std::stop_token stop_token);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
 } // namespace Network
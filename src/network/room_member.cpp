@@ -258,9 +258,8 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
             std::lock_guard send_list_lock(send_list_mutex);
             packets.swap(send_list);
         }
-        for (const auto& packet : packets) {
-            ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
-                                                        ENET_PACKET_FLAG_RELIABLE);
+        for (auto& packet : packets) {
+            ENetPacket* enetPacket = std::move(packet).ToENetPacket(ENET_PACKET_FLAG_RELIABLE);
             enet_peer_send(server, 0, enetPacket);
         }
         enet_host_flush(client);
@@ -294,8 +293,7 @@ void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
 }
 
 void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -338,8 +336,7 @@ void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* ev
 }
 
 void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -350,8 +347,7 @@ void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
 
 void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
     WifiPacket wifi_packet{};
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -371,8 +367,7 @@ void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
 }
 
 void RoomMember::RoomMemberImpl::HandleChatPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -386,8 +381,7 @@ void RoomMember::RoomMemberImpl::HandleChatPacket(const ENetEvent* event) {
 }
 
 void RoomMember::RoomMemberImpl::HandleStatusMessagePacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -402,8 +396,7 @@ void RoomMember::RoomMemberImpl::HandleStatusMessagePacket(const ENetEvent* even
 }
 
 void RoomMember::RoomMemberImpl::HandleModBanListResponsePacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{std::span{event->packet->data, event->packet->dataLength}};
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
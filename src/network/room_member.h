@@ -22,7 +22,9 @@ struct WifiPacket {
         Authentication,
         AssociationResponse,
         Deauthentication,
-        NodeMap
+        NodeMap,
+        /// Several data frames for the same destination, each preceded by its u16 size
+        DataBatch,
     };
     PacketType type;      ///< The type of 802.11 frame.
     std::vector<u8> data; ///< Raw 802.11 frame data, starting at the management frame header
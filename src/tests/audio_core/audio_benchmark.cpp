@@ -0,0 +1,159 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include "audio_core/codec.h"
+#include "audio_core/hle/common.h"
+#include "audio_core/hle/shared_memory.h"
+#include "audio_core/interpolate.h"
+#include "common/settings.h"
+#include "tests/audio_core/merryhime_3ds_audio/merry_audio/merry_audio.h"
+
+namespace {
+
+/// Number of samples of every buffer, a few seconds at the native sample rate
+constexpr std::size_t NUM_SAMPLES = 160 * 1024;
+
+/// Numbers of playing sources the frame benchmark is run with
+constexpr std::array<std::size_t, 3> SOURCE_COUNTS{1, 8, AudioCore::HLE::num_sources};
+
+/// Samples consumed by a single frame when resampling at the given rate
+std::size_t FrameInputSize(float rate) {
+    return static_cast<std::size_t>(AudioCore::samples_per_frame * rate) + 2;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Audio decode and interpolate benchmark", "[.][benchmark][audio_core]") {
+    std::vector<u8> adpcm(NUM_SAMPLES / 2);
+    std::vector<s16> pcm16(NUM_SAMPLES * 2);
+    for (std::size_t i = 0; i < adpcm.size(); i++) {
+        adpcm[i] = static_cast<u8>(i * 37);
+    }
+    for (std::size_t i = 0; i < pcm16.size(); i++) {
+        pcm16[i] = static_cast<s16>(i * 251);
+    }
+    std::array<s16, 16> adpcm_coeff{};
+    for (std::size_t i = 0; i < adpcm_coeff.size(); i++) {
+        adpcm_coeff[i] = static_cast<s16>(0x800 - i * 0x80);
+    }
+
+    BENCHMARK("DecodeADPCM") {
+        AudioCore::Codec::ADPCMState state{};
+        return AudioCore::Codec::DecodeADPCM(adpcm.data(), NUM_SAMPLES, adpcm_coeff, state);
+    };
+
+    BENCHMARK("DecodePCM16 stereo") {
+        return AudioCore::Codec::DecodePCM16(2, reinterpret_cast<const u8*>(pcm16.data()),
+                                             NUM_SAMPLES);
+    };
+
+    // Interpolation consumes its input, so every run resamples a fresh frame worth of samples.
+    const AudioCore::StereoBuffer16 decoded =
+        AudioCore::Codec::DecodePCM16(2, reinterpret_cast<const u8*>(pcm16.data()), 1024);
+    for (const float rate : {0.5f, 1.0f, 1.5f}) {
+        BENCHMARK_ADVANCED(fmt::format("Linear interpolation, rate {}", rate))
+        (Catch::Benchmark::Chronometer meter) {
+            const std::size_t input_size = FrameInputSize(rate);
+            std::vector<AudioCore::AudioInterp::StereoBuffer16> inputs(
+                meter.runs(), {decoded.begin(), decoded.begin() + input_size});
+            meter.measure([&](int i) {
+                AudioCore::AudioInterp::State state{};
+                AudioCore::StereoFrame16 output{};
+                std::size_t outputi = 0;
+                AudioCore::AudioInterp::Linear(state, inputs[i], rate, output, outputi);
+                return outputi;
+            });
+        };
+    }
+}
+
+TEST_CASE_METHOD(MerryAudio::MerryAudioFixture, "Audio frame benchmark",
+                 "[.][benchmark][audio_core][merryhime_3ds_audio]") {
+    u32* audio_buffer = static_cast<u32*>(linearAlloc(NUM_SAMPLES * sizeof(u32)));
+    for (std::size_t i = 0; i < NUM_SAMPLES; i++) {
+        const u32 data = (i % 160) * 256;
+        audio_buffer[i] = (data << 16) | (data & 0xFFFF);
+    }
+    DSP_FlushDataCache(audio_buffer, NUM_SAMPLES);
+
+    MerryAudio::AudioState state;
+    {
+        std::vector<u8> dspfirm;
+        SECTION("HLE") {
+            // The test case assumes HLE AudioCore doesn't require a valid firmware
+            InitDspCore(Settings::AudioEmulation::HLE);
+            dspfirm = {0};
+        }
+        SECTION("LLE") {
+            InitDspCore(Settings::AudioEmulation::LLE);
+            dspfirm = loadDspFirmFromFile();
+        }
+        if (!dspfirm.size()) {
+            SKIP("Couldn't load firmware\n");
+            return;
+        }
+        auto ret = audioInit(dspfirm);
+        if (!ret) {
+            INFO("Couldn't init audio\n");
+            goto end;
+        }
+        state = *ret;
+    }
+
+    state.waitForSync();
+    initSharedMem(state);
+    state.notifyDsp();
+
+    // Every frame measured processes this many sources, each playing a looping stereo buffer at a
+    // different rate so that the interpolators have to resample.
+    for (const std::size_t num_sources : SOURCE_COUNTS) {
+        state.waitForSync();
+        for (std::size_t i = 0; i < AudioCore::HLE::num_sources; i++) {
+            auto& config = state.write().source_configurations->config[i];
+            const bool enable = i < num_sources;
+            config.enable = enable;
+            config.enable_dirty.Assign(true);
+            if (!enable) {
+                continue;
+            }
+
+            config.play_position = 0;
+            config.physical_address = osConvertVirtToPhys(audio_buffer);
+            config.length = NUM_SAMPLES;
+            config.mono_or_stereo.Assign(
+                AudioCore::HLE::SourceConfiguration::Configuration::MonoOrStereo::Stereo);
+            config.format.Assign(
+                AudioCore::HLE::SourceConfiguration::Configuration::Format::PCM16);
+            config.is_looping.Assign(true);
+            config.buffer_id = 1;
+            config.rate_multiplier = 0.75f + 0.05f * static_cast<float>(i);
+            config.interpolation_mode =
+                AudioCore::HLE::SourceConfiguration::Configuration::InterpolationMode::Linear;
+            config.gain[0][0] = 1.0f;
+            config.gain[0][1] = 1.0f;
+            config.gain_0_dirty.Assign(true);
+            config.rate_multiplier_dirty.Assign(true);
+            config.interpolation_dirty.Assign(true);
+            config.format_dirty.Assign(true);
+            config.mono_or_stereo_dirty.Assign(true);
+            config.partial_reset_flag.Assign(true);
+            config.play_position_dirty.Assign(true);
+            config.embedded_buffer_dirty.Assign(true);
+        }
+        state.notifyDsp();
+
+        BENCHMARK(fmt::format("{} sources, one frame", num_sources)) {
+            state.waitForSync();
+            state.notifyDsp();
+        };
+    }
+
+end:
+    audioExit(state);
+}
@@ -0,0 +1,106 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/logging/binary_log.h"
+#include "common/logging/log.h"
+#include "common/logging/log_entry.h"
+
+using namespace Common::Log;
+
+namespace {
+
+enum class TestEnum : u16 { Value = 42 };
+
+const char* const FORMAT = "value={:08X} enum={} ratio={:.2f} flag={}";
+
+/// Builds the entry the logger thread produces for a message formatted by it
+template <typename... Args>
+Entry MakeDeferredEntry(u32 line, const Args&... args) {
+    Entry entry{
+        .timestamp = std::chrono::microseconds{1234567},
+        .log_class = Class::Service,
+        .log_level = Level::Debug,
+        .filename = "core/hle/service/test.cpp",
+        .line_num = line,
+        .function = "Test",
+        .message = fmt::format(fmt::runtime(FORMAT), args...),
+        .format = FORMAT,
+        .arg_types = detail::ARG_TYPE_CODES<Args...>,
+        .args_size = static_cast<u8>((sizeof(Args) + ...)),
+    };
+    detail::PackArgs(entry.args.data(), args...);
+    return entry;
+}
+
+/// Decoded entry, owning the strings that the decoder only passes by pointer
+struct DecodedEntry {
+    Entry entry;
+    std::string filename;
+};
+
+std::vector<DecodedEntry> RoundTrip(const std::vector<Entry>& entries) {
+    BinaryLogEncoder encoder;
+    std::vector<u8> data;
+    for (const Entry& entry : entries) {
+        encoder.Encode(entry, data);
+    }
+    std::vector<DecodedEntry> decoded;
+    REQUIRE(DecodeBinaryLog(data, [&decoded](const Entry& entry) {
+        auto& copy = decoded.emplace_back(entry, entry.filename);
+        copy.entry.filename = nullptr;
+        copy.entry.format = {};
+        copy.entry.arg_types = nullptr;
+    }));
+    return decoded;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("BinaryLog", "[common]") {
+    SECTION("decodes messages formatted by the logger thread") {
+        const Entry entry = MakeDeferredEntry(10, 0xBEEFu, TestEnum::Value, 1.5, true);
+        const auto decoded = RoundTrip({entry, entry});
+        REQUIRE(decoded.size() == 2);
+        for (const auto& [result, filename] : decoded) {
+            REQUIRE(result.message == "value=0000BEEF enum=42 ratio=1.50 flag=true");
+            REQUIRE(result.timestamp == entry.timestamp);
+            REQUIRE(result.log_class == Class::Service);
+            REQUIRE(result.log_level == Level::Debug);
+            REQUIRE(filename == entry.filename);
+            REQUIRE(result.line_num == 10);
+            REQUIRE(result.function == "Test");
+        }
+    }
+
+    SECTION("decodes messages formatted by the caller") {
+        const Entry entry{
+            .timestamp = std::chrono::microseconds{5},
+            .log_class = Class::Loader,
+            .log_level = Level::Error,
+            .filename = "core/loader/test.cpp",
+            .line_num = 20,
+            .function = "Load",
+            .message = "Failed to open file.3ds",
+        };
+        const auto decoded = RoundTrip({entry});
+        REQUIRE(decoded.size() == 1);
+        REQUIRE(decoded[0].entry.message == entry.message);
+        REQUIRE(decoded[0].entry.log_level == Level::Error);
+        REQUIRE(decoded[0].entry.line_num == 20);
+        REQUIRE(decoded[0].filename == entry.filename);
+    }
+
+    SECTION("rejects truncated logs") {
+        BinaryLogEncoder encoder;
+        std::vector<u8> data;
+        encoder.Encode(MakeDeferredEntry(10, 1u, TestEnum::Value, 0.0, false), data);
+        data.pop_back();
+        std::size_t count = 0;
+        REQUIRE_FALSE(DecodeBinaryLog(data, [&count](const Entry&) { count++; }));
+        REQUIRE(count == 0);
+    }
+}
@@ -0,0 +1,142 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/bounded_threadsafe_queue.h"
+
+namespace Common {
+
+namespace {
+
+constexpr std::size_t NumProducers = 4;
+constexpr std::size_t NumItems = 1 << 16;
+
+/// Pushes NumItems values from one thread and pops them on the calling one
+template <typename Queue>
+u64 TransferSingle(Queue& queue) {
+    std::jthread producer([&queue] {
+        for (std::size_t i = 0; i < NumItems; i++) {
+            queue.EmplaceWait(i);
+        }
+    });
+    u64 sum = 0;
+    for (std::size_t i = 0; i < NumItems; i++) {
+        sum += queue.PopWait();
+    }
+    return sum;
+}
+
+/// Pushes NumItems values from every one of NumProducers threads, with the producer index in the
+/// top bits, and pops them on the calling one
+template <typename Queue, typename Callback>
+void TransferMultiple(Queue& queue, Callback&& callback) {
+    std::vector<std::jthread> producers;
+    for (std::size_t p = 0; p < NumProducers; p++) {
+        producers.emplace_back([&queue, p] {
+            for (std::size_t i = 0; i < NumItems; i++) {
+                queue.EmplaceWait((p << 32) | i);
+            }
+        });
+    }
+    for (std::size_t i = 0; i < NumItems * NumProducers; i++) {
+        callback(queue.PopWait());
+    }
+}
+
+} // Anonymous namespace
+
+TEMPLATE_TEST_CASE("Bounded SPSC queues", "[common]", (SPSCQueue<u64, 64>),
+                   (AtomicSPSCQueue<u64, 64>)) {
+    auto queue = std::make_unique<TestType>();
+
+    SECTION("try operations respect the capacity") {
+        u64 value = 0;
+        REQUIRE(!queue->TryPop(value));
+        for (u64 i = 0; i < 64; i++) {
+            REQUIRE(queue->TryEmplace(i));
+        }
+        REQUIRE(!queue->TryEmplace(u64{64}));
+        for (u64 i = 0; i < 64; i++) {
+            REQUIRE(queue->TryPop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE(!queue->TryPop(value));
+    }
+
+    SECTION("transfers in order between threads") {
+        std::jthread producer([&queue] {
+            for (u64 i = 0; i < NumItems; i++) {
+                queue->EmplaceWait(i);
+            }
+        });
+        bool in_order = true;
+        for (u64 i = 0; i < NumItems; i++) {
+            in_order &= queue->PopWait() == i;
+        }
+        REQUIRE(in_order);
+    }
+
+    SECTION("stop token wakes a waiting consumer") {
+        std::stop_source stop_source;
+        std::jthread stopper([&stop_source] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            stop_source.request_stop();
+        });
+        u64 value = 42;
+        queue->PopWait(value, stop_source.get_token());
+        REQUIRE(value == 42);
+    }
+}
+
+TEMPLATE_TEST_CASE("Bounded MPSC queues", "[common]", (MPSCQueue<u64, 64>),
+                   (AtomicMPSCQueue<u64, 64>)) {
+    auto queue = std::make_unique<TestType>();
+
+    SECTION("keeps the order of every producer") {
+        std::vector<u64> next(NumProducers);
+        bool in_order = true;
+        TransferMultiple(*queue, [&](u64 value) {
+            const u64 producer = value >> 32;
+            in_order &= producer < NumProducers && (value & 0xFFFFFFFF) == next[producer]++;
+        });
+        REQUIRE(in_order);
+        for (const u64 count : next) {
+            REQUIRE(count == NumItems);
+        }
+    }
+}
+
+TEST_CASE("Bounded queues benchmark", "[.][benchmark][common]") {
+    BENCHMARK("SPSCQueue") {
+        auto queue = std::make_unique<SPSCQueue<u64>>();
+        return TransferSingle(*queue);
+    };
+
+    BENCHMARK("AtomicSPSCQueue") {
+        auto queue = std::make_unique<AtomicSPSCQueue<u64>>();
+        return TransferSingle(*queue);
+    };
+
+    BENCHMARK("MPSCQueue") {
+        auto queue = std::make_unique<MPSCQueue<u64>>();
+        u64 sum = 0;
+        TransferMultiple(*queue, [&sum](u64 value) { sum += value; });
+        return sum;
+    };
+
+    BENCHMARK("AtomicMPSCQueue") {
+        auto queue = std::make_unique<AtomicMPSCQueue<u64>>();
+        u64 sum = 0;
+        TransferMultiple(*queue, [&sum](u64 value) { sum += value; });
+        return sum;
+    };
+}
+
+} // namespace Common
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <filesystem>
 #include <string>
 
 #include <catch2/catch_test_macros.hpp>
@@ -24,3 +26,68 @@ TEST_CASE("SplitFilename83 Sanity", "[common]") {
     REQUIRE(std::memcmp(short_name.data(), expected_short_name.data(), short_name.size()) == 0);
     REQUIRE(std::memcmp(extension.data(), expected_extension.data(), extension.size()) == 0);
 }
+
+TEST_CASE("FileMapping maps the contents of a file", "[common]") {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_file_mapping_test.bin").string();
+    const std::array<u8, 5> contents{1, 2, 3, 4, 5};
+    {
+        FileUtil::IOFile file(path, "wb");
+        REQUIRE(file.WriteArray(contents.data(), contents.size()) == contents.size());
+    }
+
+    {
+        FileUtil::IOFile file(path, "rb");
+        const FileUtil::FileMapping mapping{file};
+        const auto data = mapping.Data();
+        REQUIRE(std::equal(data.begin(), data.end(), contents.begin(), contents.end()));
+    }
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("IOFile::ReadAtRanges reads every range", "[common]") {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "citra_read_ranges_test.bin").string();
+    std::array<u8, 4096> contents;
+    for (std::size_t i = 0; i < contents.size(); i++) {
+        contents[i] = static_cast<u8>(i * 7 + i / 256);
+    }
+    {
+        FileUtil::IOFile file(path, "wb");
+        REQUIRE(file.WriteArray(contents.data(), contents.size()) == contents.size());
+    }
+
+    FileUtil::IOFile file(path, "rb");
+    std::array<u8, 100> first;
+    std::array<u8, 900> second;
+    std::array<u8, 16> third;
+    std::array<u8, 64> past_end;
+
+    {
+        // The first two ranges are adjacent and read together
+        const std::array<FileUtil::IOFile::ReadRange, 3> ranges{{
+            {10, first},
+            {110, second},
+            {3000, third},
+        }};
+        REQUIRE(file.ReadAtRanges(ranges) == first.size() + second.size() + third.size());
+        REQUIRE(std::equal(first.begin(), first.end(), contents.begin() + 10));
+        REQUIRE(std::equal(second.begin(), second.end(), contents.begin() + 110));
+        REQUIRE(std::equal(third.begin(), third.end(), contents.begin() + 3000));
+        REQUIRE(file.Tell() == 0);
+        REQUIRE(file.IsGood());
+    }
+
+    {
+        const std::array<FileUtil::IOFile::ReadRange, 2> ranges{{
+            {4064, past_end},
+            {0, first},
+        }};
+        REQUIRE(file.ReadAtRanges(ranges) == 32);
+        REQUIRE(std::equal(past_end.begin(), past_end.begin() + 32, contents.begin() + 4064));
+        REQUIRE(!file.IsGood());
+    }
+
+    file.Close();
+    FileUtil::Delete(path);
+}
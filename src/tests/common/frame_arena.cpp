@@ -0,0 +1,47 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdint>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/frame_arena.h"
+
+namespace Common {
+
+TEST_CASE("FrameArena", "[common]") {
+    FrameArena arena{1024};
+
+    SECTION("respects the alignment") {
+        for (const std::size_t alignment : {1, 8, 64, 4096}) {
+            static_cast<void>(arena.allocate(3, 1));
+            const void* ptr = arena.allocate(16, alignment);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0);
+        }
+    }
+
+    SECTION("reuses the latest allocation") {
+        void* first = arena.allocate(256);
+        arena.deallocate(first, 256);
+        REQUIRE(arena.allocate(256) == first);
+    }
+
+    SECTION("grows to fit a frame after a reset") {
+        for (u32 frame = 0; frame < 3; frame++) {
+            arena.Reset();
+            std::pmr::vector<u32> values{&arena};
+            for (u32 i = 0; i < 4096; i++) {
+                values.push_back(i);
+            }
+            REQUIRE(values[4095] == 4095);
+        }
+        REQUIRE(arena.Capacity() > 4096 * sizeof(u32));
+        const std::size_t capacity = arena.Capacity();
+        arena.Reset();
+        std::pmr::vector<u32> values(4096, &arena);
+        arena.Reset();
+        REQUIRE(arena.Capacity() == capacity);
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,76 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <set>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/hash.h"
+
+namespace Common {
+
+namespace {
+
+std::vector<u8> RandomBytes(std::size_t size) {
+    std::mt19937 rng(0x9E37);
+    std::vector<u8> bytes(size);
+    for (u8& byte : bytes) {
+        byte = static_cast<u8>(rng());
+    }
+    return bytes;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ComputeFastHash64", "[common]") {
+    auto data = RandomBytes(4096 + 37);
+
+    SECTION("is deterministic") {
+        for (const std::size_t len : {0, 1, 64, 65, 1024, 4133}) {
+            REQUIRE(ComputeFastHash64(data.data(), len) == ComputeFastHash64(data.data(), len));
+        }
+    }
+
+    SECTION("changes with every byte") {
+        std::set<u64> hashes{ComputeFastHash64(data.data(), data.size())};
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] ^= 1;
+            hashes.insert(ComputeFastHash64(data.data(), data.size()));
+            data[i] ^= 1;
+        }
+        REQUIRE(hashes.size() == data.size() + 1);
+    }
+
+    SECTION("changes with the order of the data") {
+        const u64 hash = ComputeFastHash64(data.data(), 1024);
+        std::swap_ranges(data.begin(), data.begin() + 64, data.begin() + 64);
+        REQUIRE(ComputeFastHash64(data.data(), 1024) != hash);
+        std::swap_ranges(data.begin(), data.begin() + 64, data.begin() + 1024);
+        REQUIRE(ComputeFastHash64(data.data(), 2048) != ComputeFastHash64(data.data(), 2048 - 1));
+    }
+
+    SECTION("changes with the length") {
+        std::vector<u8> zeros(512);
+        std::set<u64> hashes;
+        for (std::size_t len = 1; len <= zeros.size(); len++) {
+            hashes.insert(ComputeFastHash64(zeros.data(), len));
+        }
+        REQUIRE(hashes.size() == zeros.size());
+    }
+}
+
+TEST_CASE("ComputeFastHash64 benchmark", "[.][benchmark][common]") {
+    const auto data = RandomBytes(4 * 1024 * 1024);
+
+    BENCHMARK("ComputeHash64") {
+        return ComputeHash64(data.data(), data.size());
+    };
+
+    BENCHMARK("ComputeFastHash64") {
+        return ComputeFastHash64(data.data(), data.size());
+    };
+}
+
+} // namespace Common
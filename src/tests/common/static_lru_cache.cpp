@@ -0,0 +1,67 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+#include "common/static_lru_cache.h"
+
+namespace Common {
+
+TEST_CASE("StaticLRUCache", "[common]") {
+    StaticLRUCache<std::size_t, std::size_t, 16> cache;
+
+    SECTION("evicts the least recently used item") {
+        for (std::size_t i = 0; i < 16; i++) {
+            const auto [found, value] = cache.request(i);
+            REQUIRE(!found);
+            value = i;
+        }
+        REQUIRE(cache.size() == 16);
+        REQUIRE(cache.request(0).first);
+        REQUIRE(!cache.request(16).first);
+        REQUIRE(cache.contains(0));
+        REQUIRE(!cache.contains(1));
+        REQUIRE(cache.request(2).second == 2);
+        REQUIRE(cache.size() == 16);
+    }
+
+    SECTION("matches a list based cache") {
+        // Page aligned keys collide in the low bits, like the offsets of the RomFS cache lines
+        std::list<std::size_t> reference;
+        std::mt19937 rng(0x4C52);
+        std::uniform_int_distribution<std::size_t> dist(0, 40);
+        bool matches = true;
+        for (std::size_t i = 0; i < 100000; i++) {
+            const std::size_t key = dist(rng) << 13;
+            const auto it = std::find(reference.begin(), reference.end(), key);
+            const bool expected = it != reference.end();
+            if (expected) {
+                reference.erase(it);
+            } else if (reference.size() == 16) {
+                reference.pop_back();
+            }
+            reference.push_front(key);
+
+            const auto [found, value] = cache.request(key);
+            matches &= found == expected && (!found || value == key);
+            value = key;
+        }
+        REQUIRE(matches);
+        for (const std::size_t key : reference) {
+            REQUIRE(cache.contains(key));
+        }
+    }
+
+    SECTION("clear empties the cache") {
+        cache.request(1);
+        cache.clear();
+        REQUIRE(cache.empty());
+        REQUIRE(!cache.contains(1));
+        REQUIRE(!cache.request(1).first);
+    }
+}
+
+} // namespace Common
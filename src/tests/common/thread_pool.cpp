@@ -0,0 +1,73 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/thread_pool.h"
+
+using namespace Common;
+
+TEST_CASE("TaskGroup", "[common]") {
+    SECTION("runs every queued task") {
+        TaskGroup group;
+        std::atomic<int> count = 0;
+        for (int i = 0; i < 1000; ++i) {
+            group.QueueWork([&count] { ++count; });
+        }
+        group.WaitForRequests();
+        REQUIRE(count == 1000);
+    }
+
+    SECTION("starts tasks in order") {
+        TaskGroup group{TaskPriority::Normal, 1};
+        std::mutex mutex;
+        std::vector<int> order;
+        for (int i = 0; i < 100; ++i) {
+            group.QueueWork([&, i] {
+                std::scoped_lock lock{mutex};
+                order.push_back(i);
+            });
+        }
+        group.WaitForRequests();
+        REQUIRE(std::is_sorted(order.begin(), order.end()));
+        REQUIRE(order.size() == 100);
+    }
+
+    SECTION("respects the concurrency limit") {
+        TaskGroup group{TaskPriority::High, 2};
+        std::atomic<int> running = 0;
+        std::atomic<int> max_running = 0;
+        for (int i = 0; i < 64; ++i) {
+            group.QueueWork([&] {
+                const int now = ++running;
+                int expected = max_running;
+                while (now > expected && !max_running.compare_exchange_weak(expected, now)) {
+                }
+                std::this_thread::yield();
+                --running;
+            });
+        }
+        group.WaitForRequests();
+
+        // The waiting thread helps with the tasks on top of the ones running on the pool
+        REQUIRE(max_running <= 3);
+    }
+
+    SECTION("groups share the pool") {
+        TaskGroup first{TaskPriority::Low};
+        TaskGroup second{TaskPriority::High};
+        std::atomic<int> count = 0;
+        for (int i = 0; i < 100; ++i) {
+            first.QueueWork([&count] { ++count; });
+            second.QueueWork([&count] { ++count; });
+        }
+        first.WaitForRequests();
+        second.WaitForRequests();
+        REQUIRE(count == 200);
+    }
+}
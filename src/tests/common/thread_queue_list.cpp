@@ -0,0 +1,41 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "common/thread_queue_list.h"
+
+TEST_CASE("ThreadQueueList", "[common]") {
+    Common::ThreadQueueList<int, 64> queue;
+    REQUIRE(queue.get_first() == 0);
+    REQUIRE(queue.pop_first() == 0);
+
+    queue.push_back(40, 1);
+    queue.push_back(63, 2);
+    queue.push_back(40, 3);
+    queue.push_front(40, 4);
+    queue.push_back(0, 5);
+
+    REQUIRE(queue.contains(3) == 40);
+    REQUIRE(queue.get_first() == 5);
+    REQUIRE(queue.pop_first() == 5);
+    REQUIRE(queue.empty(0));
+
+    // Only threads strictly better than the given priority are returned
+    REQUIRE(queue.pop_first_better(40) == 0);
+    REQUIRE(queue.pop_first_better(41) == 4);
+
+    queue.rotate(40);
+    REQUIRE(queue.get_first() == 3);
+
+    queue.move(3, 40, 10);
+    REQUIRE(queue.pop_first() == 3);
+    queue.remove(40, 1);
+    REQUIRE(queue.empty(40));
+    REQUIRE(queue.pop_first() == 2);
+    REQUIRE(queue.pop_first() == 0);
+
+    queue.push_back(5, 6);
+    queue.clear();
+    REQUIRE(queue.get_first() == 0);
+}
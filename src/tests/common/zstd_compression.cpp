@@ -0,0 +1,33 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <numeric>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/zstd_compression.h"
+
+using namespace Common::Compression;
+
+TEST_CASE("DecompressDataZSTDFrames", "[common]") {
+    std::vector<u8> source(10000);
+    std::iota(source.begin(), source.end(), u8{0});
+
+    SECTION("round trips data split into frames") {
+        const auto compressed = CompressDataZSTDFrames(source, 3, 1024, 4);
+        REQUIRE_FALSE(compressed.empty());
+        REQUIRE(DecompressDataZSTDFrames(compressed, 4) == source);
+        REQUIRE(DecompressDataZSTDFrames(compressed, 1) == source);
+    }
+
+    SECTION("decompresses a single frame") {
+        const auto compressed = CompressDataZSTDDefault(source);
+        REQUIRE(DecompressDataZSTDFrames(compressed, 4) == source);
+    }
+
+    SECTION("rejects truncated data") {
+        auto compressed = CompressDataZSTDFrames(source, 3, 1024, 4);
+        compressed.resize(compressed.size() - 1);
+        REQUIRE(DecompressDataZSTDFrames(compressed, 4).empty());
+    }
+}
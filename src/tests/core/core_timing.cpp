@@ -77,6 +77,36 @@ TEST_CASE("CoreTiming[BasicOrder]", "[core]") {
     AdvanceAndCheck(timing, 4, MAX_SLICE_LENGTH);
 }
 
+TEST_CASE("CoreTiming[Unschedule]", "[core]") {
+    Core::Timing timing(1, 100);
+
+    Core::TimingEventType* cb_a = timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+    Core::TimingEventType* cb_b = timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+    Core::TimingEventType* cb_c = timing.RegisterEvent("callbackC", CallbackTemplate<2>);
+    Core::TimingEventType* cb_d = timing.RegisterEvent("callbackD", CallbackTemplate<3>);
+    Core::TimingEventType* cb_e = timing.RegisterEvent("callbackE", CallbackTemplate<4>);
+
+    // Enter slice 0
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+
+    timing.ScheduleEvent(100, cb_a, CB_IDS[0], 0);
+    timing.ScheduleEvent(200, cb_b, CB_IDS[1], 0);
+    timing.ScheduleEvent(300, cb_c, CB_IDS[2], 0);
+    timing.ScheduleEvent(400, cb_d, CB_IDS[3], 0);
+    timing.ScheduleEvent(450, cb_d, CB_IDS[3], 0);
+    timing.ScheduleEvent(500, cb_e, CB_IDS[4], 0);
+
+    // Only the events matching both type and user data are removed.
+    timing.UnscheduleEvent(cb_b, CB_IDS[0]);
+    timing.UnscheduleEvent(cb_c, CB_IDS[2]);
+    timing.RemoveEvent(cb_d);
+
+    AdvanceAndCheck(timing, 0, 100);
+    AdvanceAndCheck(timing, 1, 300);
+    AdvanceAndCheck(timing, 4, MAX_SLICE_LENGTH);
+}
+
 namespace SharedSlotTest {
 static unsigned int counter = 0;
 
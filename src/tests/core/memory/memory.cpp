@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <memory>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -55,3 +58,59 @@ TEST_CASE("memory.IsValidVirtualAddress", "[core][memory]") {
         CHECK(memory.IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("memory.ReadBlock and WriteBlock across pages", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    // Three guest pages, the first one backed apart from the other two
+    auto backing = std::make_unique<u8[]>(Memory::CITRA_PAGE_SIZE * 4);
+    u8* const block0 = backing.get() + Memory::CITRA_PAGE_SIZE * 3;
+    u8* const block1 = backing.get();
+    REQUIRE(process->vm_manager.MapBackingMemoryBlocks(
+                Memory::HEAP_VADDR,
+                {{block0, Memory::CITRA_PAGE_SIZE}, {block1, Memory::CITRA_PAGE_SIZE * 2}},
+                Kernel::MemoryState::Private,
+                Kernel::VMAPermission::ReadWrite) == ResultSuccess);
+
+    std::vector<u8> data(Memory::CITRA_PAGE_SIZE * 2);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>(i * 7 + 1);
+    }
+    const VAddr start = Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE / 2;
+    memory.WriteBlock(*process, start, data.data(), data.size());
+
+    const std::size_t first_size = Memory::CITRA_PAGE_SIZE / 2;
+    CHECK(std::equal(data.begin(), data.begin() + first_size, block0 + first_size));
+    CHECK(std::equal(data.begin() + first_size, data.end(), block1));
+
+    std::vector<u8> read(data.size());
+    memory.ReadBlock(*process, start, read.data(), read.size());
+    CHECK(read == data);
+}
+
+TEST_CASE("memory.ZeroFCRAM", "[core][memory]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+
+    // Unaligned ends are zeroed in place, the pages in between are released
+    constexpr std::size_t offset = Memory::CITRA_PAGE_SIZE - 16;
+    constexpr std::size_t size = Memory::CITRA_PAGE_SIZE * 3;
+    u8* const fcram = memory.GetFCRAMPointer(0);
+    std::fill(fcram, fcram + Memory::CITRA_PAGE_SIZE * 5, u8{0xAA});
+
+    memory.ZeroFCRAM(offset, size);
+    CHECK(std::all_of(fcram, fcram + offset, [](u8 value) { return value == 0xAA; }));
+    CHECK(std::all_of(fcram + offset, fcram + offset + size, [](u8 value) { return value == 0; }));
+    CHECK(std::all_of(fcram + offset + size, fcram + Memory::CITRA_PAGE_SIZE * 5,
+                      [](u8 value) { return value == 0xAA; }));
+
+    // Released pages can be written again
+    fcram[Memory::CITRA_PAGE_SIZE * 2] = 1;
+    CHECK(fcram[Memory::CITRA_PAGE_SIZE * 2] == 1);
+}
@@ -0,0 +1,101 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "core/hle/kernel/memory.h"
+#include "core/memory.h"
+
+namespace {
+
+constexpr u32 PAGE_SIZE = Memory::CITRA_PAGE_SIZE;
+constexpr u32 REGION_BASE = 0x100000;
+constexpr u32 REGION_SIZE = 64 * 1024 * 1024;
+
+} // Anonymous namespace
+
+TEST_CASE("MemoryRegionInfo", "[kernel][memory]") {
+    Kernel::MemoryRegionInfo region;
+    region.Reset(REGION_BASE, REGION_SIZE);
+
+    SECTION("heap allocations come from the top") {
+        const auto blocks = region.HeapAllocate(4 * PAGE_SIZE);
+        REQUIRE(blocks.iterative_size() == 1);
+        CHECK(blocks.begin()->lower() == REGION_BASE + REGION_SIZE - 4 * PAGE_SIZE);
+        CHECK(blocks.begin()->upper() == REGION_BASE + REGION_SIZE);
+        CHECK(region.used == 4 * PAGE_SIZE);
+    }
+
+    SECTION("heap allocations gather fragmented blocks") {
+        REQUIRE(region.LinearAllocate(REGION_BASE + PAGE_SIZE, PAGE_SIZE));
+        REQUIRE(region.LinearAllocate(REGION_BASE + 4 * PAGE_SIZE, REGION_SIZE - 4 * PAGE_SIZE));
+        CHECK(region.HeapAllocate(4 * PAGE_SIZE).empty());
+
+        Kernel::MemoryRegionInfo::IntervalSet expected;
+        expected += Kernel::MemoryRegionInfo::Interval(REGION_BASE, REGION_BASE + PAGE_SIZE);
+        expected += Kernel::MemoryRegionInfo::Interval(REGION_BASE + 2 * PAGE_SIZE,
+                                                       REGION_BASE + 4 * PAGE_SIZE);
+        CHECK(region.HeapAllocate(3 * PAGE_SIZE) == expected);
+        CHECK(region.HeapAllocate(PAGE_SIZE).empty());
+        CHECK(region.used == REGION_SIZE);
+    }
+
+    SECTION("linear allocations use the smallest fitting block") {
+        REQUIRE(region.LinearAllocate(REGION_BASE + 3 * PAGE_SIZE, PAGE_SIZE));
+        REQUIRE(region.LinearAllocate(REGION_BASE + 6 * PAGE_SIZE, PAGE_SIZE));
+
+        // Free blocks are now 3, 2 and the rest of the region pages long
+        CHECK(region.LinearAllocate(2 * PAGE_SIZE) == REGION_BASE + 4 * PAGE_SIZE);
+        CHECK(region.LinearAllocate(4 * PAGE_SIZE) == REGION_BASE + 7 * PAGE_SIZE);
+        CHECK(region.LinearAllocate(PAGE_SIZE) == REGION_BASE);
+        CHECK(region.RLinearAllocate(PAGE_SIZE) == REGION_BASE + REGION_SIZE - PAGE_SIZE);
+        CHECK(!region.LinearAllocate(REGION_BASE + 3 * PAGE_SIZE, PAGE_SIZE));
+        CHECK(!region.LinearAllocate(REGION_SIZE));
+    }
+
+    SECTION("freed blocks are coalesced") {
+        std::vector<u32> offsets;
+        for (u32 i = 0; i < REGION_SIZE / PAGE_SIZE; i++) {
+            const auto offset = region.LinearAllocate(PAGE_SIZE);
+            REQUIRE(offset);
+            offsets.push_back(*offset);
+        }
+        CHECK(!region.LinearAllocate(PAGE_SIZE));
+
+        std::shuffle(offsets.begin(), offsets.end(), std::mt19937{});
+        for (const u32 offset : offsets) {
+            region.Free(offset, PAGE_SIZE);
+        }
+        CHECK(region.used == 0);
+        CHECK(region.LinearAllocate(REGION_SIZE) == REGION_BASE);
+    }
+}
+
+TEST_CASE("MemoryRegionInfo benchmark", "[.][benchmark][kernel][memory]") {
+    // The lower part of the region is left with a page sized hole every four pages, as after
+    // titles kept growing and shrinking their heap around other allocations.
+    Kernel::MemoryRegionInfo region;
+    region.Reset(REGION_BASE, REGION_SIZE);
+    for (u32 offset = REGION_BASE; offset < REGION_BASE + REGION_SIZE / 4 * 3;
+         offset += 4 * PAGE_SIZE) {
+        region.LinearAllocate(offset, 3 * PAGE_SIZE);
+    }
+
+    BENCHMARK("Heap allocate and free 20 MiB") {
+        const auto blocks = region.HeapAllocate(20 * 1024 * 1024);
+        for (const auto& interval : blocks) {
+            region.Free(interval.lower(), interval.upper() - interval.lower());
+        }
+        return blocks.iterative_size();
+    };
+
+    BENCHMARK("Linear allocate and free 4 pages") {
+        const auto offset = region.LinearAllocate(4 * PAGE_SIZE);
+        region.Free(*offset, 4 * PAGE_SIZE);
+        return *offset;
+    };
+}
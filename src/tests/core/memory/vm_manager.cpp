@@ -50,6 +50,45 @@ TEST_CASE("Memory Basics", "[kernel][memory]") {
         CHECK(vma->second.backing_memory == nullptr);
     }
 
+    SECTION("mapping memory blocks") {
+        auto blocks_mem = std::make_unique<u8[]>(Memory::CITRA_PAGE_SIZE * 4);
+        u8* const block0 = blocks_mem.get();
+        u8* const block1 = block0 + Memory::CITRA_PAGE_SIZE * 2;
+        // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
+        auto manager = std::make_unique<Kernel::VMManager>(kernel, process);
+        Result code = manager->MapBackingMemoryBlocks(
+            Memory::HEAP_VADDR,
+            {{block0, Memory::CITRA_PAGE_SIZE}, {block1, Memory::CITRA_PAGE_SIZE * 2}},
+            Kernel::MemoryState::Shared, Kernel::VMAPermission::Read);
+        REQUIRE(code == ResultSuccess);
+
+        auto vma = manager->FindVMA(Memory::HEAP_VADDR);
+        CHECK(vma->second.size == Memory::CITRA_PAGE_SIZE);
+        CHECK(vma->second.backing_memory == block0);
+        CHECK(vma->second.permissions == Kernel::VMAPermission::Read);
+        CHECK(vma->second.meminfo_state == Kernel::MemoryState::Shared);
+
+        vma = manager->FindVMA(Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE * 2);
+        CHECK(vma->second.base == Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE);
+        CHECK(vma->second.size == Memory::CITRA_PAGE_SIZE * 2);
+        CHECK(vma->second.backing_memory == block1);
+
+        vma = manager->FindVMA(Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE * 3);
+        CHECK(vma->second.type == Kernel::VMAType::Free);
+
+        auto blocks = manager->GetBackingBlocksForRange(Memory::HEAP_VADDR + 0x800,
+                                                        Memory::CITRA_PAGE_SIZE * 2);
+        REQUIRE(blocks.Succeeded());
+        CHECK(blocks.Unwrap() == Kernel::VMManager::BackingBlocks{
+                                     {block0 + 0x800, Memory::CITRA_PAGE_SIZE - 0x800},
+                                     {block1, Memory::CITRA_PAGE_SIZE + 0x800}});
+
+        code = manager->UnmapRange(Memory::HEAP_VADDR, Memory::CITRA_PAGE_SIZE * 3);
+        REQUIRE(code == ResultSuccess);
+        vma = manager->FindVMA(Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE * 2);
+        CHECK(vma->second.type == Kernel::VMAType::Free);
+    }
+
     SECTION("changing memory permissions") {
         // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
         auto manager = std::make_unique<Kernel::VMManager>(kernel, process);
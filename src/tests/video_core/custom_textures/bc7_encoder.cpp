@@ -0,0 +1,120 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstdlib>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/custom_textures/bc7_encoder.h"
+
+using namespace VideoCore;
+
+namespace {
+
+/// Decodes a mode 6 BC7 block to 16 RGBA8 pixels
+std::array<u8, 64> DecodeMode6(std::span<const u8, 16> block) {
+    u32 position = 0;
+    const auto read = [&](u32 bits) {
+        u32 value = 0;
+        for (u32 i = 0; i < bits; i++, position++) {
+            value |= ((block[position / 8] >> (position % 8)) & 1) << i;
+        }
+        return value;
+    };
+    REQUIRE(read(7) == 1 << 6);
+
+    std::array<std::array<u32, 4>, 2> endpoints{};
+    for (u32 c = 0; c < 4; c++) {
+        endpoints[0][c] = read(7) << 1;
+        endpoints[1][c] = read(7) << 1;
+    }
+    const u32 pbit0 = read(1);
+    const u32 pbit1 = read(1);
+    for (u32 c = 0; c < 4; c++) {
+        endpoints[0][c] |= pbit0;
+        endpoints[1][c] |= pbit1;
+    }
+
+    constexpr std::array<u32, 16> weights = {0,  4,  9,  13, 17, 21, 26, 30,
+                                             34, 38, 43, 47, 51, 55, 60, 64};
+    std::array<u8, 64> pixels{};
+    for (u32 p = 0; p < 16; p++) {
+        const u32 index = read(p == 0 ? 3 : 4);
+        for (u32 c = 0; c < 4; c++) {
+            const u32 w = weights[index];
+            pixels[p * 4 + c] =
+                static_cast<u8>(((64 - w) * endpoints[0][c] + w * endpoints[1][c] + 32) >> 6);
+        }
+    }
+    return pixels;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("EncodeBC7", "[video_core][custom_textures]") {
+    SECTION("gradients are reproduced closely") {
+        constexpr u32 width = 8;
+        constexpr u32 height = 4;
+        std::vector<u8> src(width * height * 4);
+        for (u32 y = 0; y < height; y++) {
+            for (u32 x = 0; x < width; x++) {
+                u8* pixel = &src[(y * width + x) * 4];
+                const u32 t = (x % 4) + y * 4;
+                pixel[0] = static_cast<u8>(t * 16);
+                pixel[1] = static_cast<u8>(255 - t * 8);
+                pixel[2] = static_cast<u8>(x < 4 ? 32 : 224);
+                pixel[3] = static_cast<u8>(255 - t * 4);
+            }
+        }
+
+        std::vector<u8> dst(BC7CompressedSize(width, height));
+        REQUIRE(dst.size() == 32);
+        EncodeBC7(src, width, height, dst);
+
+        for (u32 block_x = 0; block_x < 2; block_x++) {
+            const auto pixels = DecodeMode6(std::span{dst}.subspan(block_x * 16).first<16>());
+            for (u32 p = 0; p < 16; p++) {
+                const u32 x = block_x * 4 + p % 4;
+                const u32 y = p / 4;
+                for (u32 c = 0; c < 4; c++) {
+                    const s32 expected = src[(y * width + x) * 4 + c];
+                    REQUIRE(std::abs(pixels[p * 4 + c] - expected) <= 4);
+                }
+            }
+        }
+    }
+
+    SECTION("solid blocks are exact when representable") {
+        constexpr u32 width = 4;
+        constexpr u32 height = 4;
+        std::vector<u8> src(width * height * 4);
+        for (u32 p = 0; p < width * height; p++) {
+            src[p * 4 + 0] = 200;
+            src[p * 4 + 1] = 100;
+            src[p * 4 + 2] = 50;
+            src[p * 4 + 3] = 128;
+        }
+        std::vector<u8> dst(BC7CompressedSize(width, height));
+        EncodeBC7(src, width, height, dst);
+
+        const auto pixels = DecodeMode6(std::span{dst}.first<16>());
+        REQUIRE(std::equal(pixels.begin(), pixels.end(), src.begin()));
+    }
+
+    SECTION("partial blocks repeat the edge pixels") {
+        constexpr u32 width = 2;
+        constexpr u32 height = 2;
+        const std::vector<u8> src = {0, 0, 0, 255, 254, 254, 254, 255,
+                                     0, 0, 0, 255, 254, 254, 254, 255};
+        std::vector<u8> dst(BC7CompressedSize(width, height));
+        REQUIRE(dst.size() == 16);
+        EncodeBC7(src, width, height, dst);
+
+        const auto pixels = DecodeMode6(std::span{dst}.first<16>());
+        for (u32 p = 0; p < 16; p++) {
+            const u8 expected = p % 4 == 0 ? 0 : 254;
+            REQUIRE(std::abs(pixels[p * 4] - expected) <= 2);
+        }
+    }
+}
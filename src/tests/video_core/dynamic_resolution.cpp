@@ -0,0 +1,61 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/dynamic_resolution.h"
+
+using namespace VideoCore;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::chrono::nanoseconds Target = 12ms;
+
+/// Feeds frames of the given GPU time until just after the next scale change, or gives up
+u32 RunUntilChange(DynamicResolution& dynamic, std::chrono::nanoseconds gpu_time, u32 max_scale) {
+    const u32 scale = dynamic.Scale(max_scale);
+    for (u32 i = 0; i < 10 * DynamicResolution::WindowFrames; i++) {
+        const u32 new_scale = dynamic.Update(gpu_time, Target, max_scale);
+        if (new_scale != scale) {
+            return new_scale;
+        }
+    }
+    return scale;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DynamicResolution", "[video_core]") {
+    DynamicResolution dynamic;
+    REQUIRE(dynamic.Scale(4) == 4);
+
+    SECTION("steps down one scale per window while over the target") {
+        for (u32 i = 0; i < DynamicResolution::WindowFrames - 1; i++) {
+            REQUIRE(dynamic.Update(20ms, Target, 4) == 4);
+        }
+        REQUIRE(dynamic.Update(20ms, Target, 4) == 3);
+        REQUIRE(RunUntilChange(dynamic, 20ms, 4) == 2);
+        REQUIRE(RunUntilChange(dynamic, 20ms, 4) == 1);
+        REQUIRE(RunUntilChange(dynamic, 20ms, 4) == 1);
+    }
+
+    SECTION("steps up only when the next scale fits the target") {
+        REQUIRE(RunUntilChange(dynamic, 20ms, 4) == 3);
+        REQUIRE(RunUntilChange(dynamic, 20ms, 4) == 2);
+        // 6ms at 2x is predicted to take 13.5ms at 3x
+        REQUIRE(RunUntilChange(dynamic, 6ms, 4) == 2);
+        // 4ms at 2x is predicted to take 9ms at 3x
+        REQUIRE(RunUntilChange(dynamic, 4ms, 4) == 3);
+        REQUIRE(RunUntilChange(dynamic, 1ms, 4) == 4);
+        REQUIRE(RunUntilChange(dynamic, 1ms, 4) == 4);
+    }
+
+    SECTION("never exceeds the maximum scale") {
+        REQUIRE(RunUntilChange(dynamic, 20ms, 4) == 3);
+        REQUIRE(dynamic.Scale(2) == 2);
+        REQUIRE(dynamic.Update(1ms, Target, 2) == 2);
+        dynamic.Reset();
+        REQUIRE(dynamic.Scale(4) == 4);
+    }
+}
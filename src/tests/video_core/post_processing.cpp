@@ -0,0 +1,32 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/post_processing.h"
+
+using namespace VideoCore;
+
+TEST_CASE("ParsePostProcessingChain", "[video_core]") {
+    SECTION("empty chain") {
+        REQUIRE(ParsePostProcessingChain("").empty());
+        REQUIRE(ParsePostProcessingChain(" , ,").empty());
+    }
+
+    SECTION("passes with and without scale") {
+        const std::vector<PostProcessingPass> expected{
+            {"crt", 1},
+            {"sharpen", 0},
+            {"lcd grid", 4},
+        };
+        REQUIRE(ParsePostProcessingChain("crt:1,sharpen, lcd grid : 4 ") == expected);
+    }
+
+    SECTION("invalid and large scales") {
+        const std::vector<PostProcessingPass> expected{
+            {"crt", 0},
+            {"sharpen", MaxPostProcessingScale},
+        };
+        REQUIRE(ParsePostProcessingChain("crt:x,sharpen:100,:2") == expected);
+    }
+}
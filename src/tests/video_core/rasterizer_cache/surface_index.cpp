@@ -0,0 +1,147 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+#include <boost/icl/interval_map.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/surface_index.h"
+
+using namespace VideoCore;
+
+namespace {
+
+struct Range {
+    PAddr addr;
+    u32 size;
+};
+
+/// Generates surface sized ranges spread over VRAM and the start of FCRAM
+std::vector<Range> RandomRanges(std::mt19937& rng, std::size_t count) {
+    static constexpr std::array<PAddr, 2> bases = {0x18000000, 0x20000000};
+    std::uniform_int_distribution<u32> offset_dist(0, 0x600000 / 0x100 - 1);
+    std::uniform_int_distribution<u32> size_dist(1, 0x100000 / 0x100);
+    std::vector<Range> ranges(count);
+    for (Range& range : ranges) {
+        range.addr = bases[rng() % bases.size()] + offset_dist(rng) * 0x100;
+        range.size = size_dist(rng) * 0x100;
+    }
+    return ranges;
+}
+
+/// Interval map keyed surface lookup, the layout the cache used before SurfacePageIndex
+class IclSurfaceIndex {
+public:
+    void Insert(SurfaceId surface_id, PAddr addr, u32 size) {
+        map.add({Interval(addr, addr + size), std::set<SurfaceId>{surface_id}});
+    }
+
+    template <typename Func>
+    void ForEach(PAddr addr, std::size_t size, Func&& func) const {
+        std::set<SurfaceId> visited;
+        const auto range = map.equal_range(Interval(addr, static_cast<PAddr>(addr + size)));
+        for (auto it = range.first; it != range.second; ++it) {
+            for (const SurfaceId surface_id : it->second) {
+                if (visited.insert(surface_id).second) {
+                    func(surface_id);
+                }
+            }
+        }
+    }
+
+private:
+    using Interval = boost::icl::right_open_interval<PAddr>;
+    boost::icl::interval_map<PAddr, std::set<SurfaceId>, boost::icl::partial_absorber, std::less,
+                             boost::icl::inplace_plus, boost::icl::inter_section, Interval>
+        map;
+};
+
+std::set<SurfaceId> Overlapping(const std::vector<Range>& surfaces, Range query) {
+    std::set<SurfaceId> result;
+    for (u32 i = 0; i < surfaces.size(); i++) {
+        const Range& surface = surfaces[i];
+        if (surface.addr < query.addr + query.size && query.addr < surface.addr + surface.size) {
+            result.insert(SurfaceId{i});
+        }
+    }
+    return result;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SurfacePageIndex", "[video_core][rasterizer_cache]") {
+    std::mt19937 rng(0x3D5);
+    const auto surfaces = RandomRanges(rng, 256);
+    const auto queries = RandomRanges(rng, 256);
+
+    SurfacePageIndex index;
+    for (u32 i = 0; i < surfaces.size(); i++) {
+        index.Insert(SurfaceId{i}, surfaces[i].addr, surfaces[i].size);
+    }
+
+    SECTION("visits every overlapping surface once") {
+        for (const Range& query : queries) {
+            std::vector<SurfaceId> visited;
+            index.ForEach(query.addr, query.size,
+                          [&](SurfaceId surface_id) { visited.push_back(surface_id); });
+            const std::set<SurfaceId> unique(visited.begin(), visited.end());
+            REQUIRE(unique.size() == visited.size());
+            REQUIRE(unique == Overlapping(surfaces, query));
+        }
+    }
+
+    SECTION("stops when the callback returns true") {
+        u32 calls = 0;
+        index.ForEach(0, 0xFFFFFFFF, [&](SurfaceId) {
+            calls++;
+            return true;
+        });
+        REQUIRE(calls == 1);
+    }
+
+    SECTION("erases surfaces") {
+        for (u32 i = 0; i < surfaces.size(); i += 2) {
+            REQUIRE(index.Erase(SurfaceId{i}, surfaces[i].addr, surfaces[i].size));
+        }
+        REQUIRE_FALSE(index.Erase(SurfaceId{0}, surfaces[0].addr, surfaces[0].size));
+        index.ForEach(0, 0xFFFFFFFF, [](SurfaceId surface_id) { REQUIRE(surface_id.index % 2); });
+
+        index.Clear();
+        u32 calls = 0;
+        index.ForEach(0, 0xFFFFFFFF, [&](SurfaceId) { calls++; });
+        REQUIRE(calls == 0);
+    }
+}
+
+TEST_CASE("SurfacePageIndex benchmark", "[.][benchmark][video_core][rasterizer_cache]") {
+    std::mt19937 rng(0x3D5);
+    const auto surfaces = RandomRanges(rng, 512);
+    const auto queries = RandomRanges(rng, 1024);
+
+    SurfacePageIndex page_index;
+    IclSurfaceIndex icl_index;
+    for (u32 i = 0; i < surfaces.size(); i++) {
+        page_index.Insert(SurfaceId{i}, surfaces[i].addr, surfaces[i].size);
+        icl_index.Insert(SurfaceId{i}, surfaces[i].addr, surfaces[i].size);
+    }
+
+    BENCHMARK("SurfacePageIndex lookup") {
+        u32 found = 0;
+        for (const Range& query : queries) {
+            page_index.ForEach(query.addr, query.size, [&](SurfaceId) { found++; });
+        }
+        return found;
+    };
+
+    BENCHMARK("boost::icl lookup") {
+        u32 found = 0;
+        for (const Range& query : queries) {
+            icl_index.ForEach(query.addr, query.size, [&](SurfaceId) { found++; });
+        }
+        return found;
+    };
+}
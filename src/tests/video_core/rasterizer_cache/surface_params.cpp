@@ -0,0 +1,60 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/surface_params.h"
+
+using namespace VideoCore;
+
+namespace {
+
+constexpr PAddr BASE = 0x18000000;
+
+SurfaceParams MakeAtlas() {
+    SurfaceParams params{
+        .addr = BASE,
+        .width = 256,
+        .height = 256,
+        .is_tiled = true,
+        .pixel_format = PixelFormat::RGBA8,
+    };
+    params.UpdateParams();
+    return params;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SurfaceParams::SplitAtRows", "[video_core][rasterizer_cache]") {
+    const SurfaceParams atlas = MakeAtlas();
+    constexpr u32 TILE = 8 * 8 * 4;
+    constexpr u32 ROW = 256 * 8 * 4;
+
+    SECTION("keeps intervals within one row") {
+        const SurfaceInterval interval(BASE + ROW + TILE, BASE + ROW + 3 * TILE);
+        REQUIRE(atlas.SplitAtRows(interval) == interval);
+
+        const SurfaceParams tiles = atlas.FromInterval(interval);
+        REQUIRE(tiles.width == 16);
+        REQUIRE(tiles.height == 8);
+    }
+
+    SECTION("keeps intervals of whole rows") {
+        const SurfaceInterval interval(BASE + ROW, BASE + 4 * ROW);
+        REQUIRE(atlas.SplitAtRows(interval) == interval);
+    }
+
+    SECTION("splits partial rows from whole ones") {
+        const SurfaceInterval interval(BASE + 2 * TILE, BASE + 3 * ROW + TILE);
+        const SurfaceInterval leading = atlas.SplitAtRows(interval);
+        REQUIRE(leading == SurfaceInterval(BASE + 2 * TILE, BASE + ROW));
+        REQUIRE(atlas.FromInterval(leading).width == 256 - 16);
+
+        const SurfaceInterval remaining(BASE + ROW, interval.upper());
+        REQUIRE(atlas.SplitAtRows(remaining) == SurfaceInterval(BASE + ROW, BASE + 3 * ROW));
+
+        const SurfaceInterval trailing(BASE + 3 * ROW, interval.upper());
+        REQUIRE(atlas.SplitAtRows(trailing) == trailing);
+        REQUIRE(atlas.FromInterval(trailing).width == 8);
+    }
+}
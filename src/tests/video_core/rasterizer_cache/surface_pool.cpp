@@ -0,0 +1,64 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/surface_pool.h"
+
+using namespace VideoCore;
+
+namespace {
+
+struct Key {
+    u32 width;
+    u32 height;
+
+    bool operator==(const Key& other) const noexcept = default;
+
+    u64 Hash() const noexcept {
+        return (static_cast<u64>(width) << 32) | height;
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("SurfacePool", "[video_core][rasterizer_cache]") {
+    std::vector<int> destroyed;
+    SurfacePool<Key, std::unique_ptr<int>> pool{
+        100, [&](std::unique_ptr<int>&& value) { destroyed.push_back(*value); }};
+
+    SECTION("reuses allocations with the same key") {
+        pool.Release({8, 8}, std::make_unique<int>(1), 10);
+        pool.Release({8, 8}, std::make_unique<int>(2), 10);
+        pool.Release({16, 8}, std::make_unique<int>(3), 10);
+        REQUIRE(pool.Size() == 30);
+
+        REQUIRE_FALSE(pool.Acquire({8, 16}));
+        const auto newest = pool.Acquire({8, 8});
+        REQUIRE(newest);
+        REQUIRE(**newest == 2);
+        REQUIRE(**pool.Acquire({8, 8}) == 1);
+        REQUIRE_FALSE(pool.Acquire({8, 8}));
+        REQUIRE(pool.Count() == 1);
+        REQUIRE(pool.Size() == 10);
+        REQUIRE(destroyed.empty());
+    }
+
+    SECTION("destroys the oldest allocations over capacity") {
+        for (int i = 0; i < 5; i++) {
+            pool.Release({8, 8}, std::make_unique<int>(i), 30);
+        }
+        REQUIRE(destroyed == std::vector<int>{0, 1});
+        REQUIRE(pool.Size() == 90);
+
+        pool.Release({8, 8}, std::make_unique<int>(5), 200);
+        REQUIRE(destroyed == std::vector<int>{0, 1, 5});
+
+        pool.Clear();
+        REQUIRE(destroyed == std::vector<int>{0, 1, 5, 2, 3, 4});
+        REQUIRE(pool.Count() == 0);
+        REQUIRE(pool.Size() == 0);
+    }
+}
@@ -0,0 +1,80 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/texture_codec.h"
+
+using namespace VideoCore;
+
+namespace {
+
+constexpr u32 WIDTH = 32;
+constexpr u32 HEIGHT = 16;
+
+std::vector<u8> RandomBytes(std::mt19937& rng, std::size_t size) {
+    std::vector<u8> bytes(size);
+    for (u8& byte : bytes) {
+        byte = static_cast<u8>(rng());
+    }
+    return bytes;
+}
+
+void CompareUnswizzle(PixelFormat format, bool converted) {
+    const MortonFunc vector_func = GetVectorMortonFunc(true, format, converted);
+    if (!vector_func) {
+        return;
+    }
+    const MortonFunc reference_func = (converted ? UNSWIZZLE_TABLE_CONVERTED
+                                                 : UNSWIZZLE_TABLE)[static_cast<u32>(format)];
+    const u32 tiled_size = WIDTH * HEIGHT * GetFormatBpp(format) / 8;
+    const u32 linear_size = WIDTH * HEIGHT * (converted ? 4 : GetFormatBytesPerPixel(format));
+
+    std::mt19937 rng(static_cast<u32>(format));
+    auto tiled = RandomBytes(rng, tiled_size);
+    std::vector<u8> expected(linear_size);
+    std::vector<u8> result(linear_size);
+    reference_func(WIDTH, HEIGHT, 0, tiled_size, expected, tiled);
+    vector_func(WIDTH, HEIGHT, 0, tiled_size, result, tiled);
+    REQUIRE(result == expected);
+}
+
+void CompareSwizzle(PixelFormat format, bool converted, u32 start_offset, u32 end_offset) {
+    const MortonFunc vector_func = GetVectorMortonFunc(false, format, converted);
+    if (!vector_func) {
+        return;
+    }
+    const MortonFunc reference_func =
+        (converted ? SWIZZLE_TABLE_CONVERTED : SWIZZLE_TABLE)[static_cast<u32>(format)];
+    const u32 linear_size = WIDTH * HEIGHT * (converted ? 4 : GetFormatBytesPerPixel(format));
+
+    std::mt19937 rng(static_cast<u32>(format));
+    auto linear = RandomBytes(rng, linear_size);
+    std::vector<u8> expected(end_offset - start_offset);
+    std::vector<u8> result(end_offset - start_offset);
+    reference_func(WIDTH, HEIGHT, start_offset, end_offset, linear, expected);
+    vector_func(WIDTH, HEIGHT, start_offset, end_offset, linear, result);
+    REQUIRE(result == expected);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Vector morton copy matches reference", "[video_core][rasterizer_cache]") {
+    constexpr std::array formats = {PixelFormat::RGBA8, PixelFormat::RGB8, PixelFormat::RGB5A1,
+                                     PixelFormat::RGB565, PixelFormat::RGBA4, PixelFormat::D16,
+                                     PixelFormat::D24S8};
+    for (const PixelFormat format : formats) {
+        const u32 bytes_per_pixel = GetFormatBpp(format) / 8;
+        const u32 tiled_size = WIDTH * HEIGHT * bytes_per_pixel;
+        for (const bool converted : {false, true}) {
+            CompareUnswizzle(format, converted);
+            CompareSwizzle(format, converted, 0, tiled_size);
+            // Downloads are not required to start or end on a tile boundary
+            CompareSwizzle(format, converted, 5 * bytes_per_pixel,
+                           tiled_size - 3 * bytes_per_pixel);
+        }
+    }
+}
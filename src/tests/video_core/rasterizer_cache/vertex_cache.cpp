@@ -0,0 +1,151 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/rasterizer_cache/vertex_cache.h"
+
+using namespace VideoCore;
+
+namespace {
+
+using Removed = std::vector<std::pair<PAddr, u32>>;
+
+Removed Invalidate(VertexCache& cache, PAddr addr, u32 size) {
+    Removed removed;
+    cache.Invalidate(addr, size, [&](PAddr entry_addr, u32 entry_size) {
+        removed.emplace_back(entry_addr, entry_size);
+    });
+    return removed;
+}
+
+void AdvanceFrames(VertexCache& cache, u64 frames) {
+    for (u64 i = 0; i < frames; i++) {
+        cache.TickFrame();
+    }
+}
+
+template <typename T>
+IndexRange ReferenceRange(const std::vector<T>& indices) {
+    IndexRange range{0xFFFF, 0};
+    for (const T index : indices) {
+        range.min = std::min<u32>(range.min, index);
+        range.max = std::max<u32>(range.max, index);
+    }
+    return range;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("VertexCache finds registered copies", "[video_core][rasterizer_cache]") {
+    VertexCache cache;
+    REQUIRE(cache.Insert(0x20000000, 0x300, 12, 0x40));
+    REQUIRE(cache.Insert(0x20000000, 0x300, 16, 0x400));
+
+    REQUIRE(cache.Find(0x20000000, 0x300, 12) == 0x40);
+    REQUIRE(cache.Find(0x20000000, 0x300, 16) == 0x400);
+    REQUIRE(!cache.Find(0x20000000, 0x200, 12));
+    REQUIRE(!cache.Find(0x20000004, 0x300, 12));
+
+    REQUIRE(!cache.Insert(0x20000000, 0x300, 12, 0x800));
+    REQUIRE(cache.Find(0x20000000, 0x300, 12) == 0x800);
+    REQUIRE(cache.Size() == 2);
+}
+
+TEST_CASE("VertexCache drops the copies of written regions", "[video_core][rasterizer_cache]") {
+    VertexCache cache;
+    cache.Insert(0x20000000, 0x100, 8, 0);
+    cache.Insert(0x20003F00, 0x8200, 8, 0x100);
+    cache.Insert(0x20010000, 0x100, 8, 0x8300);
+
+    SECTION("writes outside of the copies keep them") {
+        REQUIRE(Invalidate(cache, 0x20000100, 0x3E00).empty());
+        REQUIRE(Invalidate(cache, 0x2000C100, 0x3F00).empty());
+        REQUIRE(cache.Size() == 3);
+    }
+
+    SECTION("entries spanning several pages are removed once") {
+        const Removed removed = Invalidate(cache, 0x20004000, 0x8000);
+        REQUIRE(removed == Removed{{0x20003F00, 0x8200}});
+        REQUIRE(!cache.Find(0x20003F00, 0x8200, 8));
+        REQUIRE(cache.Find(0x20000000, 0x100, 8) == 0);
+        REQUIRE(cache.Find(0x20010000, 0x100, 8) == 0x8300);
+    }
+
+    SECTION("a single byte write hits the last byte of a copy") {
+        REQUIRE(Invalidate(cache, 0x200000FF, 1) == Removed{{0x20000000, 0x100}});
+        REQUIRE(cache.Size() == 2);
+    }
+
+    SECTION("clearing reports every copy") {
+        Removed removed;
+        cache.Clear([&](PAddr addr, u32 size) { removed.emplace_back(addr, size); });
+        REQUIRE(removed.size() == 3);
+        REQUIRE(cache.Size() == 0);
+        REQUIRE(Invalidate(cache, 0x20000000, 0x20000).empty());
+    }
+}
+
+TEST_CASE("VertexCache keeps index ranges apart from vertex copies",
+          "[video_core][rasterizer_cache]") {
+    VertexCache cache;
+    REQUIRE(cache.InsertIndexRange(0x20000000, 0x100, false, {3, 200}));
+    REQUIRE(cache.InsertIndexRange(0x20000000, 0x100, true, {0x8000, 0xFFFE}));
+    REQUIRE(cache.Insert(0x20000000, 0x100, 1, 0x40));
+
+    REQUIRE(cache.FindIndexRange(0x20000000, 0x100, false) == IndexRange{3, 200});
+    REQUIRE(cache.FindIndexRange(0x20000000, 0x100, true) == IndexRange{0x8000, 0xFFFE});
+    REQUIRE(cache.Find(0x20000000, 0x100, 1) == 0x40);
+
+    Removed removed;
+    cache.Clear([&](PAddr addr, u32 size) { removed.emplace_back(addr, size); });
+    REQUIRE(removed == Removed{{0x20000000, 0x100}});
+    REQUIRE(cache.FindIndexRange(0x20000000, 0x100, false));
+
+    REQUIRE(Invalidate(cache, 0x20000080, 2).size() == 2);
+    REQUIRE(cache.Size() == 0);
+}
+
+TEST_CASE("ScanIndexRange matches a scalar scan", "[video_core][rasterizer_cache]") {
+    std::mt19937 rng{1234};
+    for (const u32 count : {0U, 1U, 7U, 8U, 15U, 16U, 17U, 100U, 4096U, 4099U}) {
+        std::vector<u8> indices_8(count);
+        std::vector<u16> indices_16(count);
+        for (u32 i = 0; i < count; i++) {
+            indices_8[i] = static_cast<u8>(rng());
+            indices_16[i] = static_cast<u16>(rng());
+        }
+        REQUIRE(ScanIndexRange(indices_8.data(), count, false) == ReferenceRange(indices_8));
+        REQUIRE(ScanIndexRange(reinterpret_cast<const u8*>(indices_16.data()), count, true) ==
+                ReferenceRange(indices_16));
+    }
+
+    // Values on both sides of the sign bit of a word
+    const std::vector<u16> words = {0x7FFF, 0x8000, 0x8001, 0x7FFE, 0xFFFF, 0x0000, 0x1234, 0x9000};
+    REQUIRE(ScanIndexRange(reinterpret_cast<const u8*>(words.data()), 8, true) ==
+            IndexRange{0, 0xFFFF});
+    const std::vector<u16> high = {0x8005, 0x9000, 0x8001, 0xA000, 0x8100, 0x8002, 0x8003, 0xF000};
+    REQUIRE(ScanIndexRange(reinterpret_cast<const u8*>(high.data()), 8, true) ==
+            IndexRange{0x8001, 0xF000});
+}
+
+TEST_CASE("VertexCache detects rewritten ranges", "[video_core][rasterizer_cache]") {
+    VertexCache cache;
+    cache.Insert(0x20000000, 0x100, 8, 0);
+    cache.Insert(0x20001000, 0x100, 8, 0x100);
+
+    AdvanceFrames(cache, VertexCache::DYNAMIC_FRAMES - 1);
+    Invalidate(cache, 0x20000000, 4);
+    REQUIRE(cache.IsDynamic(0x20000000));
+
+    AdvanceFrames(cache, 1);
+    Invalidate(cache, 0x20001000, 4);
+    REQUIRE(!cache.IsDynamic(0x20001000));
+
+    cache.Reset();
+    REQUIRE(!cache.IsDynamic(0x20000000));
+}
@@ -0,0 +1,86 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/shader/generator/pica_fs_config.h"
+
+using namespace Pica::Shader;
+using TevStageConfig = Pica::TexturingRegs::TevStageConfig;
+
+namespace {
+
+/// Sets every stage to pass the previous combiner output through
+void SetPassThrough(Pica::RegsInternal& regs) {
+    auto& texturing = regs.texturing;
+    for (auto* stage : {&texturing.tev_stage0, &texturing.tev_stage1, &texturing.tev_stage2,
+                        &texturing.tev_stage3, &texturing.tev_stage4, &texturing.tev_stage5}) {
+        *stage = {};
+        stage->color_source1.Assign(TevStageConfig::Source::Previous);
+        stage->alpha_source1.Assign(TevStageConfig::Source::Previous);
+    }
+    regs.lighting.disable.Assign(1);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("FSConfig canonicalization", "[video_core][shader]") {
+    const Profile profile{};
+    Pica::RegsInternal regs{};
+    SetPassThrough(regs);
+    Pica::RegsInternal other = regs;
+    auto& stage = regs.texturing.tev_stage1;
+    auto& other_stage = other.texturing.tev_stage1;
+
+    SECTION("operands the combiner does not read are cleared") {
+        stage.color_op.Assign(TevStageConfig::Operation::Modulate);
+        stage.color_source1.Assign(TevStageConfig::Source::Texture0);
+        stage.color_source2.Assign(TevStageConfig::Source::PrimaryColor);
+        other_stage = stage;
+        other_stage.color_source3.Assign(TevStageConfig::Source::Texture1);
+        other_stage.color_modifier3.Assign(TevStageConfig::ColorModifier::OneMinusSourceAlpha);
+
+        u64 raw_hash{};
+        u64 other_raw_hash{};
+        const FSConfig config{regs, {}, profile, &raw_hash};
+        const FSConfig other_config{other, {}, profile, &other_raw_hash};
+        REQUIRE(config == other_config);
+        REQUIRE(raw_hash != other_raw_hash);
+
+        FSConfigStats stats;
+        stats.Record(config, raw_hash);
+        stats.Record(config, raw_hash);
+        stats.Record(other_config, other_raw_hash);
+        REQUIRE(stats.NumConfigs() == 1);
+        REQUIRE(stats.NumCollapsed() == 1);
+    }
+
+    SECTION("operands the combiner reads are kept") {
+        stage.color_op.Assign(TevStageConfig::Operation::Lerp);
+        other_stage = stage;
+        other_stage.color_source3.Assign(TevStageConfig::Source::Texture1);
+        REQUIRE_FALSE(FSConfig(regs, {}, profile) == FSConfig(other, {}, profile));
+    }
+
+    SECTION("the first stage keeps the third source when reading the previous output") {
+        auto& first_stage = regs.texturing.tev_stage0;
+        first_stage.color_op.Assign(TevStageConfig::Operation::Modulate);
+        other.texturing.tev_stage0 = first_stage;
+        other.texturing.tev_stage0.color_source3.Assign(TevStageConfig::Source::Texture1);
+        REQUIRE_FALSE(FSConfig(regs, {}, profile) == FSConfig(other, {}, profile));
+    }
+
+    SECTION("pass-through stages share an encoding") {
+        other_stage.color_source2.Assign(TevStageConfig::Source::Texture2);
+        other_stage.alpha_modifier3.Assign(TevStageConfig::AlphaModifier::OneMinusSourceAlpha);
+        REQUIRE(FSConfig(regs, {}, profile) == FSConfig(other, {}, profile));
+    }
+
+    SECTION("fog flip is only kept with fog enabled") {
+        other.texturing.fog_flip.Assign(1);
+        REQUIRE(FSConfig(regs, {}, profile) == FSConfig(other, {}, profile));
+        regs.texturing.fog_mode.Assign(Pica::TexturingRegs::FogMode::Fog);
+        other.texturing.fog_mode.Assign(Pica::TexturingRegs::FogMode::Fog);
+        REQUIRE_FALSE(FSConfig(regs, {}, profile) == FSConfig(other, {}, profile));
+    }
+}
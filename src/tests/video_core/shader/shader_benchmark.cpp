@@ -0,0 +1,172 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/arch.h"
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <nihstro/inline_assembly.h>
+#include "video_core/pica/shader_setup.h"
+#include "video_core/pica/shader_unit.h"
+#include "video_core/shader/shader_interpreter.h"
+#if CITRA_ARCH(x86_64)
+#include "video_core/shader/shader_jit_x64_compiler.h"
+#elif CITRA_ARCH(arm64)
+#include "video_core/shader/shader_jit_a64_compiler.h"
+#endif
+
+using JitShader = Pica::Shader::JitShader;
+using ShaderInterpreter = Pica::Shader::InterpreterEngine;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+using Type = nihstro::InlineAsm::Type;
+
+namespace {
+
+/// Vertices run through a program by every benchmark iteration
+constexpr u32 NUM_VERTICES = 1024;
+
+struct BenchmarkProgram {
+    const char* name;
+    std::unique_ptr<Pica::ShaderSetup> setup;
+};
+
+std::unique_ptr<Pica::ShaderSetup> CompileShaderSetup(
+    std::initializer_list<nihstro::InlineAsm> code) {
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
+
+    auto shader = std::make_unique<Pica::ShaderSetup>();
+
+    std::transform(shbin.program.begin(), shbin.program.end(), shader->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   shader->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+
+    // Uniforms of plausible magnitudes, so that the programs do not run on infinities
+    for (u32 i = 0; i < shader->uniforms.f.size(); i++) {
+        const auto value = Pica::f24::FromFloat32(1.0f / static_cast<float>(i + 2));
+        shader->uniforms.f[i] = Common::Vec4<Pica::f24>::AssignToAll(value);
+    }
+    return shader;
+}
+
+/// Programs shaped after what games run: a plain transform, per vertex lighting and a loop
+std::array<BenchmarkProgram, 3> MakePrograms() {
+    const auto v0 = SourceRegister::MakeInput(0);
+    const auto v1 = SourceRegister::MakeInput(1);
+    const auto v2 = SourceRegister::MakeInput(2);
+    const auto c0 = SourceRegister::MakeFloat(0);
+    const auto c1 = SourceRegister::MakeFloat(1);
+    const auto c2 = SourceRegister::MakeFloat(2);
+    const auto c3 = SourceRegister::MakeFloat(3);
+    const auto c4 = SourceRegister::MakeFloat(4);
+    const auto c5 = SourceRegister::MakeFloat(5);
+    const auto r0 = SourceRegister::MakeTemporary(0);
+    const auto r1 = SourceRegister::MakeTemporary(1);
+    const auto o0 = DestRegister::MakeOutput(0);
+    const auto o1 = DestRegister::MakeOutput(1);
+    const auto o2 = DestRegister::MakeOutput(2);
+    const auto dest_r0 = DestRegister::MakeTemporary(0);
+    const auto dest_r1 = DestRegister::MakeTemporary(1);
+
+    auto transform = CompileShaderSetup({
+        {OpCode::Id::DP4, o0, "x", v0, "xyzw", c0, "xyzw"},
+        {OpCode::Id::DP4, o0, "y", v0, "xyzw", c1, "xyzw"},
+        {OpCode::Id::DP4, o0, "z", v0, "xyzw", c2, "xyzw"},
+        {OpCode::Id::DP4, o0, "w", v0, "xyzw", c3, "xyzw"},
+        {OpCode::Id::MUL, o1, "xyzw", v1, "xyzw", c4, "xyzw"},
+        {OpCode::Id::MOV, o2, "xy", v2, "xy", SourceRegister{}, ""},
+        {OpCode::Id::END},
+    });
+
+    auto lighting = CompileShaderSetup({
+        {OpCode::Id::DP4, o0, "x", v0, "xyzw", c0, "xyzw"},
+        {OpCode::Id::DP4, o0, "y", v0, "xyzw", c1, "xyzw"},
+        {OpCode::Id::DP4, o0, "z", v0, "xyzw", c2, "xyzw"},
+        {OpCode::Id::DP4, o0, "w", v0, "xyzw", c3, "xyzw"},
+        {OpCode::Id::DP3, dest_r0, "x", v1, "xyz", v1, "xyz"},
+        {OpCode::Id::RSQ, dest_r0, "x", r0, "x", SourceRegister{}, ""},
+        {OpCode::Id::MUL, dest_r1, "xyz", v1, "xyz", r0, "xxx"},
+        {OpCode::Id::DP3, dest_r0, "x", r1, "xyz", c4, "xyz"},
+        {OpCode::Id::MAX, dest_r0, "x", r0, "x", SourceRegister::MakeFloat(95), "x"},
+        {OpCode::Id::MUL, o1, "xyzw", c5, "xyzw", r0, "xxxx"},
+        {OpCode::Id::MOV, o2, "xy", v2, "xy", SourceRegister{}, ""},
+        {OpCode::Id::END},
+    });
+
+    auto loop = CompileShaderSetup({
+        // clang-format off
+        {OpCode::Id::MOV, dest_r0, "xyzw", v0, "xyzw", SourceRegister{}, ""},
+        {OpCode::Id::LOOP, 0},
+            {OpCode::Id::MUL, dest_r0, "xyzw", r0, "xyzw", c0, "xyzw"},
+            {OpCode::Id::ADD, dest_r0, "xyzw", r0, "xyzw", v1, "xyzw"},
+        {Type::EndLoop},
+        {OpCode::Id::MOV, o0, "xyzw", r0, "xyzw", SourceRegister{}, ""},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+    loop->uniforms.i[0] = {15, 0, 1, 0};
+
+    return {{
+        {"Transform", std::move(transform)},
+        {"Lighting", std::move(lighting)},
+        {"Loop", std::move(loop)},
+    }};
+}
+
+/// Runs NUM_VERTICES vertices through run, returns a sum of the outputs to keep them alive
+template <typename Run>
+float RunVertices(Pica::ShaderUnit& unit, Run&& run) {
+    float sum = 0.0f;
+    for (u32 vertex = 0; vertex < NUM_VERTICES; vertex++) {
+        for (u32 i = 0; i < 3; i++) {
+            const float value = static_cast<float>(vertex % 64) * 0.25f + static_cast<float>(i);
+            unit.input[i] = Common::Vec4<Pica::f24>::AssignToAll(Pica::f24::FromFloat32(value));
+        }
+        run(unit);
+        sum += unit.output[0].x.ToFloat32();
+    }
+    return sum;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Shader engines benchmark", "[.][benchmark][video_core][shader]") {
+    const auto programs = MakePrograms();
+
+    for (const BenchmarkProgram& program : programs) {
+        const Pica::ShaderSetup& setup = *program.setup;
+
+        BENCHMARK(fmt::format("{} JIT compile", program.name)) {
+            auto jit = std::make_unique<JitShader>();
+            jit->Compile(&setup.program_code, &setup.swizzle_data);
+            return jit;
+        };
+
+        // Every iteration runs NUM_VERTICES vertices, the vertex rate is their number divided by
+        // the reported time.
+        ShaderInterpreter interpreter;
+        Pica::ShaderUnit unit;
+        BENCHMARK(fmt::format("{} interpreter, {} vertices", program.name, NUM_VERTICES)) {
+            return RunVertices(unit, [&](Pica::ShaderUnit& state) {
+                interpreter.Run(setup, state);
+            });
+        };
+
+        JitShader jit;
+        jit.Compile(&setup.program_code, &setup.swizzle_data);
+        BENCHMARK(fmt::format("{} JIT, {} vertices", program.name, NUM_VERTICES)) {
+            return RunVertices(unit, [&](Pica::ShaderUnit& state) { jit.Run(setup, state, 0); });
+        };
+    }
+}
+
+#endif // CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
@@ -0,0 +1,98 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <catch2/catch_test_macros.hpp>
+#include <nihstro/inline_assembly.h>
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/shader_dead_code.h"
+
+using namespace Pica::Shader;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+using Type = nihstro::InlineAsm::Type;
+
+namespace {
+
+std::unique_ptr<Pica::ShaderSetup> CompileShaderSetup(
+    std::initializer_list<nihstro::InlineAsm> code) {
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
+
+    auto shader = std::make_unique<Pica::ShaderSetup>();
+
+    std::transform(shbin.program.begin(), shbin.program.end(), shader->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   shader->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+    return shader;
+}
+
+InstructionMask FindDead(const Pica::ShaderSetup& setup, OutputMask live_outputs) {
+    return FindDeadInstructions(setup.program_code, setup.swizzle_data, live_outputs);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Dead shader instructions", "[video_core][shader]") {
+    const auto v0 = SourceRegister::MakeInput(0);
+    const auto v1 = SourceRegister::MakeInput(1);
+    const auto c0 = SourceRegister::MakeFloat(0);
+    const auto r0 = SourceRegister::MakeTemporary(0);
+    const auto r1 = SourceRegister::MakeTemporary(1);
+    const auto o0 = DestRegister::MakeOutput(0);
+    const auto o1 = DestRegister::MakeOutput(1);
+    const auto dest_r0 = DestRegister::MakeTemporary(0);
+    const auto dest_r1 = DestRegister::MakeTemporary(1);
+
+    SECTION("unread temporaries and unused outputs") {
+        const auto shader = CompileShaderSetup({
+            {OpCode::Id::MOV, dest_r0, "xyzw", v0, "xyzw", SourceRegister{}, ""},
+            {OpCode::Id::MOV, o0, "xyzw", v1, "xyzw", SourceRegister{}, ""},
+            {OpCode::Id::MUL, o1, "xyzw", v0, "xyzw", c0, "xyzw"},
+            {OpCode::Id::END},
+        });
+        const InstructionMask dead = FindDead(*shader, OutputMask{0b01});
+        REQUIRE(dead[0]);
+        REQUIRE(!dead[1]);
+        REQUIRE(dead[2]);
+        REQUIRE(!dead[3]);
+
+        REQUIRE(!FindDead(*shader, OutputMask{0b11})[2]);
+    }
+
+    SECTION("components are tracked through chains") {
+        const auto shader = CompileShaderSetup({
+            {OpCode::Id::MOV, dest_r0, "xyzw", v0, "xyzw", SourceRegister{}, ""},
+            {OpCode::Id::MOV, dest_r1, "x", r0, "x", SourceRegister{}, ""},
+            {OpCode::Id::MOV, dest_r1, "y", v1, "y", SourceRegister{}, ""},
+            {OpCode::Id::MOV, o0, "xyzw", r1, "yyyy", SourceRegister{}, ""},
+            {OpCode::Id::END},
+        });
+        const InstructionMask dead = FindDead(*shader, OutputMask{}.set());
+        REQUIRE(dead[0]);
+        REQUIRE(dead[1]);
+        REQUIRE(!dead[2]);
+        REQUIRE(!dead[3]);
+    }
+
+    SECTION("values carried by loops stay alive") {
+        const auto shader = CompileShaderSetup({
+            // clang-format off
+            {OpCode::Id::MOV, dest_r0, "xyzw", v0, "xyzw", SourceRegister{}, ""},
+            {OpCode::Id::LOOP, 0},
+                {OpCode::Id::MOV, o0, "xyzw", r1, "xyzw", SourceRegister{}, ""},
+                {OpCode::Id::ADD, dest_r1, "xyzw", r0, "xyzw", v1, "xyzw"},
+            {Type::EndLoop},
+            {OpCode::Id::END},
+            // clang-format on
+        });
+        const InstructionMask dead = FindDead(*shader, OutputMask{}.set());
+        for (u32 offset = 0; offset < 5; offset++) {
+            REQUIRE(!dead[offset]);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/stream_ring.h"
+
+using namespace VideoCore;
+
+namespace {
+
+/// Fences that signal in order once the test moves the completed fence forward
+struct Fences {
+    u64 completed{};
+    std::vector<u64> waits;
+
+    auto IsSignaled() {
+        return [this](u64 fence) { return fence <= completed; };
+    }
+
+    auto Wait() {
+        return [this](u64 fence) {
+            waits.push_back(fence);
+            completed = fence;
+        };
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("StreamRing", "[video_core]") {
+    Fences fences;
+
+    SECTION("reserves aligned ranges until the ring wraps") {
+        StreamRing ring{256};
+        auto reservation = ring.Reserve(100, 0, fences.IsSignaled(), fences.Wait());
+        REQUIRE(reservation.offset == 0);
+        REQUIRE_FALSE(reservation.invalidate);
+        ring.Commit(100, 1);
+
+        reservation = ring.Reserve(100, 64, fences.IsSignaled(), fences.Wait());
+        REQUIRE(reservation.offset == 128);
+        ring.Commit(100, 2);
+
+        fences.completed = 2;
+        reservation = ring.Reserve(100, 0, fences.IsSignaled(), fences.Wait());
+        REQUIRE(reservation.offset == 0);
+        REQUIRE(reservation.invalidate);
+        REQUIRE(fences.waits.empty());
+        REQUIRE(ring.GetStats().wraps == 1);
+        REQUIRE(ring.GetStats().stalls == 0);
+    }
+
+    SECTION("waits only for the fences of reused ranges") {
+        StreamRing ring{256};
+        for (u64 fence = 1; fence <= 4; fence++) {
+            static_cast<void>(ring.Reserve(64, 0, fences.IsSignaled(), fences.Wait()));
+            ring.Commit(64, fence);
+        }
+
+        const auto reservation = ring.Reserve(100, 0, fences.IsSignaled(), fences.Wait());
+        REQUIRE(reservation.offset == 0);
+        REQUIRE(fences.waits == std::vector<u64>{1, 2});
+        REQUIRE(ring.GetStats().stalls == 2);
+    }
+
+    SECTION("grows instead of stalling") {
+        StreamRing ring{256, 1024};
+        static_cast<void>(ring.Reserve(200, 0, fences.IsSignaled(), fences.Wait()));
+        ring.Commit(200, 1);
+
+        auto reservation = ring.Reserve(200, 0, fences.IsSignaled(), fences.Wait());
+        REQUIRE(reservation.grow);
+        REQUIRE(ring.GrowSize() == 512);
+        REQUIRE(fences.waits.empty());
+
+        ring.Reset(ring.GrowSize());
+        reservation = ring.Reserve(200, 0, fences.IsSignaled(), fences.Wait());
+        REQUIRE_FALSE(reservation.grow);
+        REQUIRE(reservation.offset == 0);
+
+        reservation = ring.Reserve(2000, 0, fences.IsSignaled(), fences.Wait());
+        REQUIRE(reservation.grow);
+        REQUIRE(ring.GrowSize() == 1024);
+        REQUIRE(ring.GetStats().grows == 2);
+    }
+
+    SECTION("merges consecutive commits of the same fence") {
+        StreamRing ring{256};
+        for (u64 i = 0; i < 4; i++) {
+            static_cast<void>(ring.Reserve(64, 0, fences.IsSignaled(), fences.Wait()));
+            ring.Commit(64, 1);
+        }
+        static_cast<void>(ring.Reserve(64, 0, fences.IsSignaled(), fences.Wait()));
+        REQUIRE(fences.waits == std::vector<u64>{1});
+    }
+}
@@ -0,0 +1,232 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include "common/assert.h"
+#include "common/vector_math.h"
+#include "video_core/custom_textures/bc7_encoder.h"
+
+namespace VideoCore {
+
+namespace {
+
+/// Interpolation weights of the 4 bit indices, out of 64
+constexpr std::array<s32, 16> Weights = {0,  4,  9,  13, 17, 21, 26, 30,
+                                         34, 38, 43, 47, 51, 55, 60, 64};
+
+using Block = std::array<Common::Vec4f, 16>;
+
+/// Endpoint of mode 6, with 7 bits per channel and the shared low bit stored separately
+struct Endpoint {
+    Common::Vec4<s32> value;
+    u32 pbit;
+
+    [[nodiscard]] Common::Vec4<s32> Expand() const {
+        const s32 low = static_cast<s32>(pbit);
+        return value * 2 + Common::MakeVec(low, low, low, low);
+    }
+};
+
+struct Encoding {
+    std::array<Endpoint, 2> endpoints;
+    std::array<u32, 16> indices;
+    s32 error;
+};
+
+/// Quantizes an endpoint, picking the low bit that keeps it closest to the requested color
+Endpoint QuantizeEndpoint(const Common::Vec4f& color) {
+    Endpoint best{};
+    float best_error = INFINITY;
+    for (u32 pbit = 0; pbit < 2; pbit++) {
+        Endpoint endpoint{.pbit = pbit};
+        float error = 0.f;
+        for (u32 c = 0; c < 4; c++) {
+            const float value = std::round((color[c] - static_cast<float>(pbit)) / 2.f);
+            endpoint.value[c] = std::clamp(static_cast<s32>(value), 0, 127);
+            const float diff = static_cast<float>(endpoint.value[c] * 2 + pbit) - color[c];
+            error += diff * diff;
+        }
+        if (error < best_error) {
+            best_error = error;
+            best = endpoint;
+        }
+    }
+    return best;
+}
+
+/// Picks the index of the palette entry closest to each pixel
+Encoding Evaluate(const Block& block, const std::array<Endpoint, 2>& endpoints) {
+    const auto e0 = endpoints[0].Expand();
+    const auto e1 = endpoints[1].Expand();
+    std::array<Common::Vec4<s32>, 16> palette;
+    for (u32 i = 0; i < palette.size(); i++) {
+        for (u32 c = 0; c < 4; c++) {
+            palette[i][c] = ((64 - Weights[i]) * e0[c] + Weights[i] * e1[c] + 32) >> 6;
+        }
+    }
+
+    Encoding encoding{.endpoints = endpoints, .indices = {}, .error = 0};
+    for (u32 p = 0; p < block.size(); p++) {
+        const Common::Vec4<s32> pixel = block[p].Cast<s32>();
+        s32 best_error = std::numeric_limits<s32>::max();
+        for (u32 i = 0; i < palette.size(); i++) {
+            const auto diff = palette[i] - pixel;
+            const s32 error = Common::Dot(diff, diff);
+            if (error < best_error) {
+                best_error = error;
+                encoding.indices[p] = i;
+            }
+        }
+        encoding.error += best_error;
+    }
+    return encoding;
+}
+
+/// Fits the endpoints to the pixels with the weights of their indices by least squares
+std::array<Common::Vec4f, 2> RefineEndpoints(const Block& block, const Encoding& encoding) {
+    float a = 0.f;
+    float b = 0.f;
+    float c = 0.f;
+    Common::Vec4f rhs0{};
+    Common::Vec4f rhs1{};
+    for (u32 p = 0; p < block.size(); p++) {
+        const float w = static_cast<float>(Weights[encoding.indices[p]]) / 64.f;
+        a += (1.f - w) * (1.f - w);
+        b += w * (1.f - w);
+        c += w * w;
+        rhs0 += block[p] * (1.f - w);
+        rhs1 += block[p] * w;
+    }
+    const float det = a * c - b * b;
+    if (std::abs(det) < 1e-6f) {
+        return {encoding.endpoints[0].Expand().Cast<float>(),
+                encoding.endpoints[1].Expand().Cast<float>()};
+    }
+    return {(rhs0 * c - rhs1 * b) / det, (rhs1 * a - rhs0 * b) / det};
+}
+
+/// Returns the endpoints at the extremes of the principal axis of the block colors
+std::array<Common::Vec4f, 2> FitEndpoints(const Block& block) {
+    Common::Vec4f mean{};
+    Common::Vec4f min{255.f, 255.f, 255.f, 255.f};
+    Common::Vec4f max{};
+    for (const auto& pixel : block) {
+        mean += pixel;
+        for (u32 c = 0; c < 4; c++) {
+            min[c] = std::min(min[c], pixel[c]);
+            max[c] = std::max(max[c], pixel[c]);
+        }
+    }
+    mean /= 16.f;
+
+    std::array<std::array<float, 4>, 4> covariance{};
+    for (const auto& pixel : block) {
+        const auto diff = pixel - mean;
+        for (u32 i = 0; i < 4; i++) {
+            for (u32 j = 0; j < 4; j++) {
+                covariance[i][j] += diff[i] * diff[j];
+            }
+        }
+    }
+
+    // Power iteration starting from the diagonal of the bounding box.
+    Common::Vec4f axis = max - min;
+    for (u32 iteration = 0; iteration < 8; iteration++) {
+        Common::Vec4f next{};
+        for (u32 i = 0; i < 4; i++) {
+            for (u32 j = 0; j < 4; j++) {
+                next[i] += covariance[i][j] * axis[j];
+            }
+        }
+        const float length = std::sqrt(Common::Dot(next, next));
+        if (length < 1e-6f) {
+            break;
+        }
+        axis = next / length;
+    }
+    const float length2 = Common::Dot(axis, axis);
+    if (length2 < 1e-6f) {
+        return {mean, mean};
+    }
+    axis /= std::sqrt(length2);
+
+    float t_min = INFINITY;
+    float t_max = -INFINITY;
+    for (const auto& pixel : block) {
+        const float t = Common::Dot(pixel - mean, axis);
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+    }
+    return {mean + axis * t_min, mean + axis * t_max};
+}
+
+void WriteBits(std::span<u8, 16> out, u32& position, u32 value, u32 bits) {
+    for (u32 i = 0; i < bits; i++, position++) {
+        out[position / 8] |= static_cast<u8>(((value >> i) & 1) << (position % 8));
+    }
+}
+
+void EncodeBlock(const Block& block, std::span<u8, 16> out) {
+    const auto quantize = [](const std::array<Common::Vec4f, 2>& colors) {
+        return std::array{QuantizeEndpoint(colors[0]), QuantizeEndpoint(colors[1])};
+    };
+    Encoding encoding = Evaluate(block, quantize(FitEndpoints(block)));
+    if (encoding.error > 0) {
+        const Encoding refined = Evaluate(block, quantize(RefineEndpoints(block, encoding)));
+        if (refined.error < encoding.error) {
+            encoding = refined;
+        }
+    }
+
+    // The most significant bit of the first index is implicitly zero.
+    if (encoding.indices[0] >= 8) {
+        std::swap(encoding.endpoints[0], encoding.endpoints[1]);
+        for (u32& index : encoding.indices) {
+            index = 15 - index;
+        }
+    }
+
+    std::fill(out.begin(), out.end(), u8{0});
+    u32 position = 0;
+    WriteBits(out, position, 1 << 6, 7);
+    for (u32 c = 0; c < 4; c++) {
+        WriteBits(out, position, encoding.endpoints[0].value[c], 7);
+        WriteBits(out, position, encoding.endpoints[1].value[c], 7);
+    }
+    WriteBits(out, position, encoding.endpoints[0].pbit, 1);
+    WriteBits(out, position, encoding.endpoints[1].pbit, 1);
+    WriteBits(out, position, encoding.indices[0], 3);
+    for (u32 p = 1; p < encoding.indices.size(); p++) {
+        WriteBits(out, position, encoding.indices[p], 4);
+    }
+    ASSERT(position == 128);
+}
+
+} // Anonymous namespace
+
+void EncodeBC7(std::span<const u8> src, u32 width, u32 height, std::span<u8> dst) {
+    ASSERT(src.size() >= static_cast<std::size_t>(width) * height * 4);
+    ASSERT(dst.size() >= BC7CompressedSize(width, height));
+
+    const u32 blocks_x = (width + 3) / 4;
+    const u32 blocks_y = (height + 3) / 4;
+    Block block;
+    for (u32 block_y = 0; block_y < blocks_y; block_y++) {
+        for (u32 block_x = 0; block_x < blocks_x; block_x++) {
+            for (u32 p = 0; p < block.size(); p++) {
+                const u32 x = std::min(block_x * 4 + p % 4, width - 1);
+                const u32 y = std::min(block_y * 4 + p / 4, height - 1);
+                const u8* pixel = &src[(y * width + x) * 4];
+                block[p] = Common::MakeVec(pixel[0], pixel[1], pixel[2], pixel[3]).Cast<float>();
+            }
+            const std::size_t offset = (block_y * blocks_x + block_x) * 16;
+            EncodeBlock(block, dst.subspan(offset).first<16>());
+        }
+    }
+}
+
+} // namespace VideoCore
@@ -0,0 +1,26 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/// Returns the size in bytes of a width x height image compressed with BC7
+[[nodiscard]] constexpr std::size_t BC7CompressedSize(u32 width, u32 height) {
+    return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * 16;
+}
+
+/**
+ * Compresses an RGBA8 image to BC7. Every block is encoded with mode 6, a single RGBA subset with
+ * 4 bit indices, which trades some quality on blocks with several distinct colors for speed.
+ * Blocks crossing the border of images whose size is not a multiple of 4 repeat the edge pixels.
+ * @param src Pixels of the image, with rows stored from top to bottom
+ * @param dst Destination of the BC7CompressedSize(width, height) bytes of blocks
+ */
+void EncodeBC7(std::span<const u8> src, u32 width, u32 height, std::span<u8> dst);
+
+} // namespace VideoCore
@@ -10,6 +10,7 @@
 #include "common/settings.h"
 #include "common/string_util.h"
 #include "common/texture.h"
+#include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/frontend/image_interface.h"
 #include "core/hle/kernel/kernel.h"
@@ -22,12 +23,49 @@ namespace VideoCore {
 
 namespace {
 
+using namespace Common::Literals;
+
 MICROPROFILE_DEFINE(CustomTexManager_TickFrame, "CustomTexManager", "TickFrame",
                     MP_RGB(54, 16, 32));
 
 constexpr std::size_t MAX_UPLOADS_PER_TICK = 8;
 
-using namespace Common::Literals;
+/// Directories holding more materials than this are not treated as scenes
+constexpr std::size_t MAX_SCENE_MATERIALS = 64;
+
+/// Materials requested by a draw are decoded before any speculatively queued material
+constexpr u64 REQUESTED_PRIORITY = 1ULL << 63;
+
+/// Eviction releases materials until this fraction of the memory budget is used
+constexpr u64 EVICTION_TARGET_PERCENT = 75;
+
+/// Textures uploaded while this many bytes are queued for dumping are dumped on a later upload
+constexpr u64 MAX_PENDING_DUMP_SIZE = 256_MiB;
+constexpr std::size_t NUM_DUMP_WORKERS = 2;
+
+/// Raw dumps store flipped RGBA8 pixels after this header, compressed with zstd
+struct RawDumpHeader {
+    u32 magic;
+    u32 width;
+    u32 height;
+};
+constexpr u32 RAW_DUMP_MAGIC = 0x57415243; // CRAW
+constexpr s32 RAW_DUMP_COMPRESSION_LEVEL = 1;
+constexpr std::string_view RAW_DUMP_EXTENSION = ".zst";
+
+bool WriteRawDump(const std::string& path, u32 width, u32 height, std::span<const u8> pixels) {
+    const RawDumpHeader header = {
+        .magic = RAW_DUMP_MAGIC,
+        .width = width,
+        .height = height,
+    };
+    std::vector<u8> raw(sizeof(header) + pixels.size());
+    std::memcpy(raw.data(), &header, sizeof(header));
+    std::memcpy(raw.data() + sizeof(header), pixels.data(), pixels.size());
+    const auto compressed = Common::Compression::CompressDataZSTD(raw, RAW_DUMP_COMPRESSION_LEVEL);
+    FileUtil::IOFile file{path, "wb"};
+    return file.WriteBytes(compressed.data(), compressed.size()) == compressed.size();
+}
 
 bool IsPow2(u32 value) {
     return value != 0 && (value & (value - 1)) == 0;
@@ -56,23 +94,35 @@ MapType MakeMapType(std::string_view ext) {
 
 CustomTexManager::CustomTexManager(Core::System& system_)
     : system{system_}, image_interface{*system.GetImageInterface()},
-      async_custom_loading{Settings::values.async_custom_loading.GetValue()} {}
-
-CustomTexManager::~CustomTexManager() = default;
+      async_custom_loading{Settings::values.async_custom_loading.GetValue()},
+      fast_texture_dumping{Settings::values.fast_texture_dumping.GetValue()},
+      memory_budget{static_cast<u64>(Settings::values.custom_texture_memory.GetValue()) * 1_MiB} {}
+
+CustomTexManager::~CustomTexManager() {
+    // The dump queue is bounded, finish it instead of losing the textures.
+    if (dump_workers) {
+        dump_workers->WaitForRequests();
+    }
+}
 
 void CustomTexManager::TickFrame() {
     MICROPROFILE_SCOPE(CustomTexManager_TickFrame);
+    frame_count++;
     if (!textures_loaded) {
         return;
     }
     std::size_t num_uploads = 0;
     for (auto it = async_uploads.begin(); it != async_uploads.end();) {
         if (num_uploads >= MAX_UPLOADS_PER_TICK) {
-            return;
+            break;
         }
         switch (it->material->state) {
         case DecodeState::Decoded:
-            it->func();
+            if (!it->func()) {
+                // The renderer is still preparing the upload, it is retried on the next tick
+                it++;
+                continue;
+            }
             num_uploads++;
             [[fallthrough]];
         case DecodeState::Failed:
@@ -83,6 +133,7 @@ void CustomTexManager::TickFrame() {
             break;
         }
     }
+    EvictMaterials();
 }
 
 void CustomTexManager::FindCustomTextures() {
@@ -100,6 +151,26 @@ void CustomTexManager::FindCustomTextures() {
         skip_mipmap = true;
     }
 
+    if (compress_png_files) {
+        if (supports_bc7) {
+            compressed_dir = fmt::format("{}custom_textures/{:016X}/",
+                                         FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                                         title_id);
+            if (!FileUtil::CreateFullPath(compressed_dir)) {
+                LOG_ERROR(Render, "Unable to create {}", compressed_dir);
+                compressed_dir.clear();
+            }
+        } else {
+            LOG_WARNING(Render, "BC7 is not supported by the GPU, PNG files are not compressed");
+        }
+    }
+
+    // Games usually draw the textures of a pack directory together, packs are often organized by
+    // scene. Files in the root of the pack are not grouped.
+    const std::string load_path =
+        fmt::format("{}textures/{:016X}/", GetUserPath(FileUtil::UserPath::LoadDir), title_id);
+    std::unordered_map<std::string_view, std::size_t> directory_scenes;
+
     custom_textures.reserve(textures.size());
     for (const FileUtil::FSTEntry& file : textures) {
         if (file.isDirectory) {
@@ -110,15 +181,26 @@ void CustomTexManager::FindCustomTextures() {
         if (!ParseFilename(file, texture)) {
             continue;
         }
+        const std::string_view directory = FileUtil::GetParentPath(texture->path);
         for (const u64 hash : texture->hashes) {
             auto& material = material_map[hash];
             if (!material) {
                 material = std::make_unique<Material>();
+                if (directory != load_path) {
+                    const auto [it, new_scene] =
+                        directory_scenes.try_emplace(directory, scenes.size());
+                    if (new_scene) {
+                        scenes.emplace_back();
+                    }
+                    scenes[it->second].push_back(material.get());
+                    material_scenes.emplace(material.get(), it->second);
+                }
             }
             material->hash = hash;
             material->AddMapTexture(texture);
         }
     }
+    queued_scenes.resize(scenes.size());
     textures_loaded = true;
 }
 
@@ -184,6 +266,8 @@ void CustomTexManager::PrepareDumping(u64 title_id) {
     // Write template config file
     const std::string dump_path =
         fmt::format("{}textures/{:016X}/", GetUserPath(FileUtil::UserPath::DumpDir), title_id);
+    ConvertRawDumps(dump_path);
+
     const std::string pack_config = dump_path + "pack.json";
     if (FileUtil::Exists(pack_config)) {
         return;
@@ -198,6 +282,7 @@ void CustomTexManager::PrepareDumping(u64 title_id) {
     options["skip_mipmap"] = false;
     options["flip_png_files"] = true;
     options["use_new_hash"] = true;
+    options["compress_png_files"] = false;
 
     FileUtil::IOFile file{pack_config, "w"};
     const std::string output = json.dump(4);
@@ -225,7 +310,7 @@ void CustomTexManager::PreloadTextures(const std::atomic_bool& stop_run,
             if (stop_run) {
                 return;
             }
-            material->LoadFromDisk(flip_png_files);
+            LoadMaterial(material.get());
             size_sum += material->size;
             if (callback) {
                 callback(VideoCore::LoadCallbackStage::Preload, preloaded, custom_textures.size());
@@ -234,7 +319,10 @@ void CustomTexManager::PreloadTextures(const std::atomic_bool& stop_run,
         }
     });
     workers->WaitForRequests();
-    async_custom_loading = false;
+    // Evicted materials are decoded again on demand, keep that from stalling the frame.
+    if (!memory_budget) {
+        async_custom_loading = false;
+    }
 }
 
 void CustomTexManager::DumpTexture(const SurfaceParams& params, u32 level, std::span<u8> data,
@@ -253,8 +341,11 @@ void CustomTexManager::DumpTexture(const SurfaceParams& params, u32 level, std::
     }
 
     dump_path +=
-        fmt::format("tex1_{}x{}_{:016X}_{}_mip{}.png", width, height, data_hash, format, level);
-    if (dumped_textures.contains(data_hash) || FileUtil::Exists(dump_path)) {
+        fmt::format("tex1_{}x{}_{:016X}_{}_mip{}", width, height, data_hash, format, level);
+    const std::string raw_dump_path = fmt::format("{}{}", dump_path, RAW_DUMP_EXTENSION);
+    dump_path += ".png";
+    if (dumped_textures.contains(data_hash) || FileUtil::Exists(dump_path) ||
+        FileUtil::Exists(raw_dump_path)) {
         return;
     }
 
@@ -267,22 +358,37 @@ void CustomTexManager::DumpTexture(const SurfaceParams& params, u32 level, std::
     }
 
     const u32 decoded_size = width * height * 4;
-    std::vector<u8> pixels(data_size + decoded_size);
+    const u64 dump_size = data_size + decoded_size;
+    if (pending_dump_size + dump_size > MAX_PENDING_DUMP_SIZE) {
+        // The texture is not marked as dumped, so it gets dumped when it is uploaded again.
+        return;
+    }
+    pending_dump_size += dump_size;
+    std::vector<u8> pixels(dump_size);
     std::memcpy(pixels.data(), data.data(), data_size);
 
-    auto dump = [this, width, height, params, data_size, decoded_size, pixels = std::move(pixels),
-                 dump_path = std::move(dump_path)]() mutable {
+    auto dump = [this, width, height, params, data_size, decoded_size, dump_size,
+                 pixels = std::move(pixels),
+                 dump_path = fast_texture_dumping ? raw_dump_path : dump_path]() mutable {
         const std::span encoded = std::span{pixels}.first(data_size);
         const std::span decoded = std::span{pixels}.last(decoded_size);
         DecodeTexture(params, params.addr, params.end, encoded, decoded,
                       params.type == SurfaceType::Color);
         Common::FlipRGBA8Texture(decoded, width, height);
-        image_interface.EncodePNG(dump_path, width, height, decoded);
+        if (fast_texture_dumping) {
+            if (!WriteRawDump(dump_path, width, height, decoded)) {
+                LOG_ERROR(Render, "Failed to save raw dump {}", dump_path);
+            }
+        } else {
+            image_interface.EncodePNG(dump_path, width, height, decoded);
+        }
+        pending_dump_size -= dump_size;
     };
-    if (!workers) {
-        CreateWorkers();
+    if (!dump_workers) {
+        dump_workers =
+            std::make_unique<Common::TaskGroup>(Common::TaskPriority::Low, NUM_DUMP_WORKERS);
     }
-    workers->QueueWork(std::move(dump));
+    dump_workers->QueueWork(std::move(dump));
     dumped_textures.insert(data_hash);
 }
 
@@ -296,13 +402,13 @@ Material* CustomTexManager::GetMaterial(u64 data_hash) {
 }
 
 bool CustomTexManager::Decode(Material* material, std::function<bool()>&& upload) {
+    material->last_use = frame_count;
     if (!async_custom_loading) {
-        material->LoadFromDisk(flip_png_files);
+        LoadMaterial(material);
         return upload();
     }
-    if (material->IsUnloaded()) {
-        material->state = DecodeState::Pending;
-        workers->QueueWork([material, this] { material->LoadFromDisk(flip_png_files); });
+    if (QueueDecode(material, REQUESTED_PRIORITY | frame_count)) {
+        QueueSceneDecodes(material);
     }
     async_uploads.push_back({
         .material = material,
@@ -311,6 +417,122 @@ bool CustomTexManager::Decode(Material* material, std::function<bool()>&& upload
     return false;
 }
 
+bool CustomTexManager::QueueDecode(Material* material, u64 priority) {
+    {
+        std::scoped_lock lock{decode_queue_mutex};
+        const auto [it, is_new] = decode_priorities.try_emplace(material, priority);
+        if (is_new && !material->IsUnloaded()) {
+            // The material is decoded or a worker is already decoding it.
+            decode_priorities.erase(it);
+            return false;
+        }
+        if (!is_new) {
+            if (it->second >= priority) {
+                return false;
+            }
+            it->second = priority;
+        }
+        material->state = DecodeState::Pending;
+        decode_queue.push({
+            .priority = priority,
+            .material = material,
+        });
+    }
+    // Requests are not bound to the job, each job decodes the most important material left.
+    workers->QueueWork([this] { DecodeNext(); });
+    return true;
+}
+
+void CustomTexManager::QueueSceneDecodes(const Material* material) {
+    const auto it = material_scenes.find(material);
+    if (it == material_scenes.end() || queued_scenes[it->second]) {
+        return;
+    }
+    queued_scenes[it->second] = true;
+    const auto& scene = scenes[it->second];
+    if (scene.size() > MAX_SCENE_MATERIALS) {
+        return;
+    }
+    for (Material* const scene_material : scene) {
+        QueueDecode(scene_material, frame_count);
+    }
+}
+
+void CustomTexManager::DecodeNext() {
+    Material* material = nullptr;
+    {
+        std::scoped_lock lock{decode_queue_mutex};
+        while (!material && !decode_queue.empty()) {
+            const DecodeRequest request = decode_queue.top();
+            decode_queue.pop();
+            // Skip requests whose material got requested again with a higher priority.
+            const auto it = decode_priorities.find(request.material);
+            if (it != decode_priorities.end() && it->second == request.priority) {
+                decode_priorities.erase(it);
+                material = request.material;
+            }
+        }
+    }
+    if (material) {
+        LoadMaterial(material);
+    }
+}
+
+void CustomTexManager::LoadMaterial(Material* material) {
+    const u64 old_size = material->size;
+    material->LoadFromDisk(flip_png_files, compressed_dir);
+    resident_size += material->size - old_size;
+}
+
+void CustomTexManager::EvictMaterials() {
+    if (!memory_budget || resident_size <= memory_budget) {
+        return;
+    }
+
+    // Materials waiting for their upload and materials sharing a texture with another material
+    // are kept, releasing them would leave the upload or the other material without data.
+    std::unordered_set<const Material*> pending_uploads;
+    for (const AsyncUpload& upload : async_uploads) {
+        pending_uploads.insert(upload.material);
+    }
+    const auto is_evictable = [&](const Material* material) {
+        if (!material->IsDecoded() || material->last_use == frame_count ||
+            pending_uploads.contains(material)) {
+            return false;
+        }
+        return std::ranges::all_of(material->textures, [](const CustomTexture* texture) {
+            return !texture || texture->hashes.size() == 1;
+        });
+    };
+    std::vector<Material*> candidates;
+    for (const auto& [hash, material] : material_map) {
+        if (is_evictable(material.get())) {
+            candidates.push_back(material.get());
+        }
+    }
+    std::ranges::sort(candidates, {}, &Material::last_use);
+
+    const u64 target_size = memory_budget * EVICTION_TARGET_PERCENT / 100;
+    std::size_t num_evicted = 0;
+    for (Material* const material : candidates) {
+        if (resident_size <= target_size) {
+            break;
+        }
+        for (CustomTexture* const texture : material->textures) {
+            if (texture) {
+                std::scoped_lock lock{texture->decode_mutex};
+                texture->data = {};
+            }
+        }
+        resident_size -= material->size;
+        material->size = 0;
+        material->state = DecodeState::None;
+        num_evicted++;
+    }
+    LOG_DEBUG(Render, "Evicted {} custom materials, {} MiB resident", num_evicted,
+              resident_size / 1_MiB);
+}
+
 bool CustomTexManager::ReadConfig(u64 title_id, bool options_only) {
     const std::string load_path =
         fmt::format("{}textures/{:016X}/", GetUserPath(FileUtil::UserPath::LoadDir), title_id);
@@ -336,6 +558,7 @@ bool CustomTexManager::ReadConfig(u64 title_id, bool options_only) {
     skip_mipmap = options["skip_mipmap"].get<bool>();
     flip_png_files = options["flip_png_files"].get<bool>();
     use_new_hash = options["use_new_hash"].get<bool>();
+    compress_png_files = options.value("compress_png_files", false);
 
     if (options_only) {
         return true;
@@ -384,9 +607,55 @@ std::vector<FileUtil::FSTEntry> CustomTexManager::GetTextures(u64 title_id) {
     return textures;
 }
 
+void CustomTexManager::ConvertRawDumps(const std::string& dump_path) {
+    FileUtil::FSTEntry dump_dir;
+    std::vector<FileUtil::FSTEntry> dumps;
+    FileUtil::ScanDirectoryTree(dump_path, dump_dir);
+    FileUtil::GetAllFilesFromNestedEntries(dump_dir, dumps);
+    std::erase_if(dumps, [](const FileUtil::FSTEntry& entry) {
+        return entry.isDirectory || !entry.virtualName.ends_with(RAW_DUMP_EXTENSION);
+    });
+    if (dumps.empty()) {
+        return;
+    }
+
+    LOG_INFO(Render, "Converting {} raw texture dumps to PNG", dumps.size());
+    if (!workers) {
+        CreateWorkers();
+    }
+    for (const FileUtil::FSTEntry& entry : dumps) {
+        workers->QueueWork([this, path = entry.physicalName] {
+            FileUtil::IOFile file{path, "rb"};
+            std::vector<u8> compressed(file.GetSize());
+            if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+                LOG_ERROR(Render, "Failed to read raw dump {}", path);
+                return;
+            }
+            file.Close();
+
+            const auto raw = Common::Compression::DecompressDataZSTD(compressed);
+            RawDumpHeader header{};
+            if (raw.size() >= sizeof(header)) {
+                std::memcpy(&header, raw.data(), sizeof(header));
+            }
+            const std::span pixels = std::span{raw}.subspan(std::min(raw.size(), sizeof(header)));
+            if (header.magic != RAW_DUMP_MAGIC ||
+                pixels.size() != static_cast<std::size_t>(header.width) * header.height * 4) {
+                LOG_ERROR(Render, "Raw dump {} is invalid", path);
+                return;
+            }
+            const std::string png_path =
+                path.substr(0, path.size() - RAW_DUMP_EXTENSION.size()) + ".png";
+            if (image_interface.EncodePNG(png_path, header.width, header.height, pixels)) {
+                FileUtil::Delete(path);
+            }
+        });
+    }
+    workers->WaitForRequests();
+}
+
 void CustomTexManager::CreateWorkers() {
-    const std::size_t num_workers = std::max(std::thread::hardware_concurrency(), 2U) - 1;
-    workers = std::make_unique<Common::ThreadWorker>(num_workers, "Custom textures");
+    workers = std::make_unique<Common::TaskGroup>(Common::TaskPriority::Normal);
 }
 
 } // namespace VideoCore
@@ -5,10 +5,12 @@
 #pragma once
 
 #include <list>
+#include <mutex>
+#include <queue>
 #include <span>
 #include <unordered_map>
 #include <unordered_set>
-#include "common/thread_worker.h"
+#include "common/thread_pool.h"
 #include "video_core/custom_textures/material.h"
 #include "video_core/rasterizer_interface.h"
 
@@ -56,7 +58,8 @@ public:
     /// Returns the material assigned to the provided data hash
     Material* GetMaterial(u64 data_hash);
 
-    /// Decodes the textures in material to a consumable format and uploads it.
+    /// Decodes the textures in material to a consumable format and uploads it. Asynchronous uploads
+    /// returning false are retried on the next frame.
     bool Decode(Material* material, std::function<bool()>&& upload);
 
     /// True when mipmap uploads should be skipped (legacy packs only)
@@ -69,6 +72,11 @@ public:
         return use_new_hash;
     }
 
+    /// Allows transcoding PNG textures of packs that request it, when the GPU can sample BC7
+    void SetSupportsBC7(bool supported) noexcept {
+        supports_bc7 = supported;
+    }
+
 private:
     /// Parses the custom texture filename (hash, material type, etc).
     bool ParseFilename(const FileUtil::FSTEntry& file, CustomTexture* texture);
@@ -79,6 +87,37 @@ private:
     /// Creates the thread workers.
     void CreateWorkers();
 
+    /// Encodes the raw dumps left in dump_path by fast texture dumping to PNG.
+    void ConvertRawDumps(const std::string& dump_path);
+
+    /**
+     * Queues the material for decoding with the provided priority, or raises the priority of a
+     * material that is still queued. Returns true when the material was not queued before.
+     */
+    bool QueueDecode(Material* material, u64 priority);
+
+    /// Speculatively queues the materials in the directory of a newly requested material.
+    void QueueSceneDecodes(const Material* material);
+
+    /// Decodes the queued material with the highest priority.
+    void DecodeNext();
+
+    /// Decodes the material and accounts for the memory it holds.
+    void LoadMaterial(Material* material);
+
+    /// Releases the least recently used materials while the memory budget is exceeded.
+    void EvictMaterials();
+
+private:
+    struct DecodeRequest {
+        u64 priority;
+        Material* material;
+
+        bool operator<(const DecodeRequest& other) const noexcept {
+            return priority < other.priority;
+        }
+    };
+
 private:
     Core::System& system;
     Frontend::ImageInterface& image_interface;
@@ -87,12 +126,27 @@ private:
     std::unordered_map<std::string, std::vector<u64>> path_to_hash_map;
     std::vector<std::unique_ptr<CustomTexture>> custom_textures;
     std::list<AsyncUpload> async_uploads;
-    std::unique_ptr<Common::ThreadWorker> workers;
+    std::atomic<u64> pending_dump_size{}; ///< Bytes held by queued texture dumps
+    std::unique_ptr<Common::TaskGroup> workers;
+    std::unique_ptr<Common::TaskGroup> dump_workers;
+    std::mutex decode_queue_mutex;
+    std::priority_queue<DecodeRequest> decode_queue;
+    std::unordered_map<const Material*, u64> decode_priorities; ///< Latest priority of a request
+    std::unordered_map<const Material*, std::size_t> material_scenes;
+    std::vector<std::vector<Material*>> scenes; ///< Materials of the pack grouped by directory
+    std::vector<bool> queued_scenes;
+    u64 frame_count{};
+    u64 memory_budget{};              ///< Bytes of decoded textures to hold, unlimited when zero
+    std::atomic<u64> resident_size{}; ///< Bytes of decoded textures currently held
+    std::string compressed_dir;
     bool textures_loaded{false};
     bool async_custom_loading{true};
+    bool fast_texture_dumping{false};
     bool skip_mipmap{false};
     bool flip_png_files{true};
     bool use_new_hash{true};
+    bool compress_png_files{false};
+    bool supports_bc7{false};
 };
 
 } // namespace VideoCore
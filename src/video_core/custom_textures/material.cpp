@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/texture.h"
 #include "core/frontend/image_interface.h"
+#include "video_core/custom_textures/bc7_encoder.h"
 #include "video_core/custom_textures/material.h"
 
 namespace VideoCore {
@@ -36,6 +38,74 @@ CustomPixelFormat ToCustomPixelFormat(ddsktx_format format) {
     }
 }
 
+/// Header of a DDS file followed by the DX10 extension that describes the DXGI format
+struct DDSHeader {
+    u32 magic;
+    u32 size;
+    u32 flags;
+    u32 height;
+    u32 width;
+    u32 pitch_or_linear_size;
+    u32 depth;
+    u32 mip_map_count;
+    std::array<u32, 11> reserved1;
+    u32 pf_size;
+    u32 pf_flags;
+    u32 pf_fourcc;
+    std::array<u32, 5> pf_masks;
+    u32 caps;
+    u32 caps2;
+    u32 caps3;
+    u32 caps4;
+    u32 reserved2;
+    u32 dxgi_format;
+    u32 resource_dimension;
+    u32 misc_flag;
+    u32 array_size;
+    u32 misc_flags2;
+};
+static_assert(sizeof(DDSHeader) == 148);
+
+bool WriteBC7DDS(const std::string& path, u32 width, u32 height, std::span<const u8> data) {
+    constexpr u32 DDS_MAGIC = 0x20534444;        // "DDS "
+    constexpr u32 DX10_FOURCC = 0x30315844;      // "DX10"
+    constexpr u32 DDSD_REQUIRED_FLAGS = 0x81007; // Caps, height, width, pixel format, linear size
+    constexpr u32 DDPF_FOURCC = 0x4;
+    constexpr u32 DDSCAPS_TEXTURE = 0x1000;
+    constexpr u32 DXGI_FORMAT_BC7_UNORM = 98;
+    constexpr u32 D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+    const DDSHeader header = {
+        .magic = DDS_MAGIC,
+        .size = 124,
+        .flags = DDSD_REQUIRED_FLAGS,
+        .height = height,
+        .width = width,
+        .pitch_or_linear_size = static_cast<u32>(data.size()),
+        .depth = 0,
+        .mip_map_count = 1,
+        .reserved1 = {},
+        .pf_size = 32,
+        .pf_flags = DDPF_FOURCC,
+        .pf_fourcc = DX10_FOURCC,
+        .pf_masks = {},
+        .caps = DDSCAPS_TEXTURE,
+        .caps2 = 0,
+        .caps3 = 0,
+        .caps4 = 0,
+        .reserved2 = 0,
+        .dxgi_format = DXGI_FORMAT_BC7_UNORM,
+        .resource_dimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D,
+        .misc_flag = 0,
+        .array_size = 1,
+        .misc_flags2 = 0,
+    };
+
+    FileUtil::IOFile file{path, "wb"};
+    return file.WriteObject(header) == 1 &&
+           file.WriteBytes(data.data(), data.size()) == data.size();
+}
+
 std::string_view MapTypeName(MapType type) {
     switch (type) {
     case MapType::Color:
@@ -54,7 +124,7 @@ CustomTexture::CustomTexture(Frontend::ImageInterface& image_interface_)
 
 CustomTexture::~CustomTexture() = default;
 
-void CustomTexture::LoadFromDisk(bool flip_png) {
+void CustomTexture::LoadFromDisk(bool flip_png, const std::string& compressed_dir) {
     std::scoped_lock lock{decode_mutex};
     if (IsLoaded()) {
         return;
@@ -68,7 +138,11 @@ void CustomTexture::LoadFromDisk(bool flip_png) {
     }
     switch (file_format) {
     case CustomFileFormat::PNG:
-        LoadPNG(input, flip_png);
+        if (compressed_dir.empty()) {
+            LoadPNG(input, flip_png);
+        } else {
+            LoadCompressedPNG(input, flip_png, compressed_dir);
+        }
         break;
     case CustomFileFormat::DDS:
     case CustomFileFormat::KTX:
@@ -90,13 +164,43 @@ void CustomTexture::LoadPNG(std::span<const u8> input, bool flip_png) {
     format = CustomPixelFormat::RGBA8;
 }
 
+void CustomTexture::LoadCompressedPNG(std::span<const u8> input, bool flip_png,
+                                      const std::string& compressed_dir) {
+    // Transcodes are named after the contents of the PNG, edited files get transcoded again.
+    const u64 hash = Common::HashCombine(Common::ComputeHash64(input.data(), input.size()),
+                                         static_cast<u64>(flip_png));
+    const std::string compressed_path = fmt::format("{}{:016X}.dds", compressed_dir, hash);
+    if (FileUtil::IOFile file{compressed_path, "rb"}; file.IsOpen()) {
+        const FileUtil::FileMapping mapping{file};
+        LoadDDS(mapping.Data());
+        if (format == CustomPixelFormat::BC7 && !data.empty()) {
+            return;
+        }
+        LOG_WARNING(Render, "Compressed texture {} of {} is invalid, transcoding again",
+                    compressed_path, path);
+        data.clear();
+    }
+
+    LoadPNG(input, flip_png);
+    if (data.empty()) {
+        return;
+    }
+    std::vector<u8> compressed(BC7CompressedSize(width, height));
+    EncodeBC7(data, width, height, compressed);
+    data = std::move(compressed);
+    format = CustomPixelFormat::BC7;
+    if (!WriteBC7DDS(compressed_path, width, height, data)) {
+        LOG_ERROR(Render, "Failed to save compressed texture {}", compressed_path);
+    }
+}
+
 void CustomTexture::LoadDDS(std::span<const u8> input) {
     ddsktx_format dds_format{};
     image_interface.DecodeDDS(data, width, height, dds_format, input);
     format = ToCustomPixelFormat(dds_format);
 }
 
-void Material::LoadFromDisk(bool flip_png) noexcept {
+void Material::LoadFromDisk(bool flip_png, const std::string& compressed_dir) noexcept {
     if (IsDecoded()) {
         return;
     }
@@ -104,7 +208,7 @@ void Material::LoadFromDisk(bool flip_png) noexcept {
         if (!texture || texture->IsLoaded()) {
             continue;
         }
-        texture->LoadFromDisk(flip_png);
+        texture->LoadFromDisk(flip_png, compressed_dir);
         size += texture->data.size();
         LOG_DEBUG(Render, "Loading {} map {}", MapTypeName(texture->type), texture->path);
     }
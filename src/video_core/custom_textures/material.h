@@ -37,7 +37,12 @@ public:
     explicit CustomTexture(Frontend::ImageInterface& image_interface);
     ~CustomTexture();
 
-    void LoadFromDisk(bool flip_png);
+    /**
+     * Reads and decodes the texture file.
+     * @param compressed_dir When not empty, PNG files are transcoded to BC7 once and the result
+     *                       is cached in this directory for the following loads
+     */
+    void LoadFromDisk(bool flip_png, const std::string& compressed_dir = {});
 
     [[nodiscard]] bool IsParsed() const noexcept {
         return file_format != CustomFileFormat::None && !hashes.empty();
@@ -50,6 +55,9 @@ public:
 private:
     void LoadPNG(std::span<const u8> input, bool flip_png);
 
+    void LoadCompressedPNG(std::span<const u8> input, bool flip_png,
+                           const std::string& compressed_dir);
+
     void LoadDDS(std::span<const u8> input);
 
 public:
@@ -73,8 +81,9 @@ struct Material {
     CustomPixelFormat format;
     std::array<CustomTexture*, MAX_MAPS> textures;
     std::atomic<DecodeState> state{};
+    u64 last_use{}; ///< Frame the material was last requested in
 
-    void LoadFromDisk(bool flip_png) noexcept;
+    void LoadFromDisk(bool flip_png, const std::string& compressed_dir = {}) noexcept;
 
     void AddMapTexture(CustomTexture* texture) noexcept;
 
@@ -0,0 +1,53 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/dynamic_resolution.h"
+
+namespace VideoCore {
+
+u32 DynamicResolution::Update(std::chrono::nanoseconds gpu_time, std::chrono::nanoseconds target,
+                              u32 max_scale) {
+    if (scale == 0 || scale > max_scale) {
+        Reset();
+        scale = max_scale;
+    }
+    if (settle_frames > 0) {
+        settle_frames--;
+        return scale;
+    }
+
+    total += gpu_time;
+    if (++frames < WindowFrames) {
+        return scale;
+    }
+    const std::chrono::nanoseconds average = total / frames;
+    frames = 0;
+    total = {};
+
+    u32 new_scale = scale;
+    if (average > target) {
+        new_scale = scale > 1 ? scale - 1 : 1;
+    } else if (scale < max_scale) {
+        // Require the next step to fit in 90% of the target
+        const u64 next = scale + 1;
+        const auto predicted = average * (next * next) / (scale * scale);
+        if (predicted * 10 < target * 9) {
+            new_scale = scale + 1;
+        }
+    }
+    if (new_scale != scale) {
+        scale = new_scale;
+        settle_frames = SettleFrames;
+    }
+    return scale;
+}
+
+void DynamicResolution::Reset() noexcept {
+    scale = 0;
+    frames = 0;
+    settle_frames = 0;
+    total = {};
+}
+
+} // namespace VideoCore
@@ -0,0 +1,50 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Picks the scale of new render targets from the GPU time of the frames, to keep it under a
+ * target time. The GPU time is averaged over a window of frames, and the scale moves by one step
+ * at most per window. As the time of a frame grows with the number of pixels rendered, the scale
+ * is only raised when the average scaled by the pixels of the next step still fits the target
+ * with some headroom, which keeps it from going back and forth between two steps.
+ */
+class DynamicResolution {
+public:
+    /// Number of frames the GPU time is averaged over before the scale may change
+    static constexpr u32 WindowFrames = 30;
+
+    /// Number of frames ignored after a change, they include the copies of the surfaces into
+    /// render targets of the new scale
+    static constexpr u32 SettleFrames = 10;
+
+    /**
+     * Records the GPU time of a frame and returns the scale to render the next frames at.
+     * @param target GPU time per frame to stay under
+     * @param max_scale Scale that is never exceeded, the configured resolution scale factor
+     */
+    u32 Update(std::chrono::nanoseconds gpu_time, std::chrono::nanoseconds target, u32 max_scale);
+
+    /// Returns the current scale, max_scale until the first frame is recorded
+    [[nodiscard]] u32 Scale(u32 max_scale) const noexcept {
+        return scale != 0 && scale < max_scale ? scale : max_scale;
+    }
+
+    /// Forgets the measured frames and goes back to the maximum scale
+    void Reset() noexcept;
+
+private:
+    u32 scale{};
+    u32 frames{};
+    u32 settle_frames{};
+    std::chrono::nanoseconds total{};
+};
+
+} // namespace VideoCore
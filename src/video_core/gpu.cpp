@@ -2,7 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bit>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
 #include "common/microprofile.h"
+#include "common/polyfill_thread.h"
+#include "common/settings.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp_gpu.h"
@@ -37,14 +44,71 @@ struct GPU::Impl {
     Core::TimingEventType* vblank_event;
     Service::GSP::InterruptHandler signal_interrupt;
 
+    /// A command list submitted through the GSP, processed on the GPU thread
+    struct CmdList {
+        PAddr addr;
+        u32 size;
+    };
+
+    // GPU thread state, the queue and the interrupt mask are guarded by gpu_thread_mutex
+    std::mutex gpu_thread_mutex;
+    std::condition_variable_any list_cv;
+    std::condition_variable idle_cv;
+    std::queue<CmdList> cmd_lists;
+    u32 num_pending_lists{};
+    u32 pending_interrupts{};
+    Service::GSP::InterruptHandler defer_interrupt;
+    std::jthread gpu_thread;
+
     explicit Impl(Core::System& system, Frontend::EmuWindow& emu_window,
                   Frontend::EmuWindow* secondary_window)
         : timing{system.CoreTiming()}, system{system}, memory{system.Memory()},
           debug_context{Pica::g_debug_context}, pica{memory, debug_context},
           renderer{VideoCore::CreateRenderer(emu_window, secondary_window, pica, system)},
           rasterizer{renderer->Rasterizer()}, sw_blitter{std::make_unique<SwRenderer::SwBlitter>(
-                                                  memory, rasterizer)} {}
+                                                  memory, rasterizer)} {
+        // The OpenGL renderer owns a context that is current on the emulation thread only
+        if (Settings::values.async_gpu &&
+            Settings::values.graphics_api.GetValue() != Settings::GraphicsAPI::OpenGL) {
+            defer_interrupt = [this](Service::GSP::InterruptId interrupt_id) {
+                std::scoped_lock lock{gpu_thread_mutex};
+                pending_interrupts |= 1U << static_cast<u32>(interrupt_id);
+            };
+            gpu_thread = std::jthread([this](std::stop_token token) { GpuThread(token); });
+        }
+    }
     ~Impl() = default;
+
+    void GpuThread(std::stop_token token) {
+        Common::SetCurrentThreadName("GPU");
+        while (true) {
+            CmdList list;
+            {
+                std::unique_lock lock{gpu_thread_mutex};
+                Common::CondvarWait(list_cv, lock, token, [this] { return !cmd_lists.empty(); });
+                if (token.stop_requested()) {
+                    return;
+                }
+                list = cmd_lists.front();
+                cmd_lists.pop();
+            }
+
+            MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
+
+            // The command buffer registers are written here rather than on submission, as command
+            // lists may change them while they are processed.
+            auto& cmdbuffer = pica.regs.internal.pipeline.command_buffer;
+            cmdbuffer.addr[0].Assign(list.addr >> 3);
+            cmdbuffer.size[0].Assign(list.size >> 3);
+            pica.ProcessCmdList(cmdbuffer.GetPhysicalAddress(0), cmdbuffer.GetSize(0));
+            cmdbuffer.trigger[0] = 0;
+
+            std::scoped_lock lock{gpu_thread_mutex};
+            if (--num_pending_lists == 0) {
+                idle_cv.notify_all();
+            }
+        }
+    }
 };
 
 GPU::GPU(Core::System& system, Frontend::EmuWindow& emu_window,
@@ -88,25 +152,63 @@ PAddr GPU::VirtualToPhysicalAddress(VAddr addr) {
 
 void GPU::SetInterruptHandler(Service::GSP::InterruptHandler handler) {
     impl->signal_interrupt = handler;
-    impl->pica.SetInterruptHandler(handler);
+    impl->pica.SetInterruptHandler(HasGpuThread() ? impl->defer_interrupt : handler);
+}
+
+bool GPU::HasGpuThread() const {
+    return impl->gpu_thread.joinable();
+}
+
+void GPU::WaitIdle() const {
+    if (!HasGpuThread()) {
+        return;
+    }
+    std::unique_lock lock{impl->gpu_thread_mutex};
+    impl->idle_cv.wait(lock, [this] { return impl->num_pending_lists == 0; });
+}
+
+void GPU::SignalDeferredInterrupts() {
+    if (!HasGpuThread()) {
+        return;
+    }
+    u32 interrupts;
+    {
+        std::scoped_lock lock{impl->gpu_thread_mutex};
+        interrupts = std::exchange(impl->pending_interrupts, 0);
+    }
+    while (interrupts != 0) {
+        const u32 interrupt_id = std::countr_zero(interrupts);
+        impl->signal_interrupt(static_cast<Service::GSP::InterruptId>(interrupt_id));
+        interrupts &= interrupts - 1;
+    }
 }
 
 void GPU::FlushRegion(PAddr addr, u32 size) {
+    WaitIdle();
     impl->rasterizer->FlushRegion(addr, size);
 }
 
 void GPU::InvalidateRegion(PAddr addr, u32 size) {
+    WaitIdle();
     impl->rasterizer->InvalidateRegion(addr, size);
 }
 
 void GPU::ClearAll(bool flush) {
+    WaitIdle();
     impl->rasterizer->ClearAll(flush);
 }
 
 void GPU::Execute(const Service::GSP::Command& command) {
     using Service::GSP::CommandId;
+    Core::PerfStats::ScopedTimer timer{impl->system.perf_stats.get(),
+                                       Core::PerfStats::Subsystem::GpuSubmit};
     auto& regs = impl->pica.regs;
 
+    // Command lists queue behind each other on the GPU thread, anything else acts on its results
+    if (command.id != CommandId::SubmitCmdList) {
+        WaitIdle();
+    }
+
     switch (command.id) {
     case CommandId::RequestDma: {
         impl->system.Memory().RasterizerFlushVirtualRegion(
@@ -125,6 +227,16 @@ void GPU::Execute(const Service::GSP::Command& command) {
     }
     case CommandId::SubmitCmdList: {
         auto& params = command.submit_gpu_cmdlist;
+        if (HasGpuThread()) {
+            // Let the guest carry on while the list is processed, the interrupts it raises are
+            // signalled by the emulation thread through SignalDeferredInterrupts.
+            std::scoped_lock lock{impl->gpu_thread_mutex};
+            impl->cmd_lists.push({VirtualToPhysicalAddress(params.address), params.size});
+            impl->num_pending_lists++;
+            impl->list_cv.notify_one();
+            break;
+        }
+
         auto& cmdbuffer = regs.internal.pipeline.command_buffer;
 
         // Write to the command buffer GPU registers
@@ -240,6 +352,7 @@ void GPU::SetColorFill(const Pica::ColorFill& fill) {
 }
 
 u32 GPU::ReadReg(VAddr addr) {
+    WaitIdle();
     switch (addr & 0xFFFFF000) {
     case VADDR_LCD: {
         const u32 offset = addr - VADDR_LCD;
@@ -262,6 +375,7 @@ u32 GPU::ReadReg(VAddr addr) {
 }
 
 void GPU::WriteReg(VAddr addr, u32 data) {
+    WaitIdle();
     switch (addr & 0xFFFFF000) {
     case VADDR_LCD: {
         const u32 offset = addr - VADDR_LCD;
@@ -308,9 +422,21 @@ void GPU::WriteReg(VAddr addr, u32 data) {
 }
 
 void GPU::Sync() {
+    WaitIdle();
     impl->renderer->Sync();
 }
 
+void GPU::SaveState(Core::StateWriter& writer) const {
+    WaitIdle();
+    impl->pica.SaveState(writer);
+}
+
+void GPU::LoadState(Core::StateReader& reader) {
+    WaitIdle();
+    impl->pica.LoadState(reader);
+    Sync();
+}
+
 VideoCore::RendererBase& GPU::Renderer() {
     return *impl->renderer;
 }
@@ -406,7 +532,11 @@ void GPU::MemoryTransfer() {
 }
 
 void GPU::VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
+    // The CPU runs at most a frame ahead of the GPU thread.
+    WaitIdle();
+
     // Present renderered frame.
+    impl->system.perf_stats->BeginPresent();
     impl->renderer->SwapBuffers();
 
     // Signal to GSP that GPU interrupt has occurred
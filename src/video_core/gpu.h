@@ -15,8 +15,10 @@ struct FrameBufferInfo;
 } // namespace Service::GSP
 
 namespace Core {
+class StateReader;
+class StateWriter;
 class System;
-}
+} // namespace Core
 
 namespace Pica {
 class DebugContext;
@@ -49,6 +51,15 @@ public:
     /// Sets the function to call for signalling GSP interrupts.
     void SetInterruptHandler(Service::GSP::InterruptHandler handler);
 
+    /// Returns true if command lists are processed on a GPU thread (the async_gpu setting).
+    [[nodiscard]] bool HasGpuThread() const;
+
+    /// Waits for the GPU thread to finish processing the submitted command lists.
+    void WaitIdle() const;
+
+    /// Signals the interrupts raised by the command lists the GPU thread has processed so far.
+    void SignalDeferredInterrupts();
+
     /// Notify rasterizer that any caches of the specified region should be flushed to Switch memory
     void FlushRegion(PAddr addr, u32 size);
 
@@ -76,6 +87,12 @@ public:
     /// Synchronizes fixed function renderer state with PICA registers.
     void Sync();
 
+    /// Writes the PICA GPU state to a savestate stream.
+    void SaveState(Core::StateWriter& writer) const;
+
+    /// Restores the PICA GPU state and resynchronizes the renderer with it.
+    void LoadState(Core::StateReader& reader);
+
     /// Returns a mutable reference to the renderer.
     [[nodiscard]] VideoCore::RendererBase& Renderer();
 
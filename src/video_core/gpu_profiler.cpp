@@ -0,0 +1,113 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include "common/microprofile.h"
+#include "common/settings.h"
+#include "video_core/gpu_profiler.h"
+
+MICROPROFILE_DEFINE(GPU_ReadTimestamps, "GPU", "Read Timestamps", MP_RGB(128, 192, 255));
+
+namespace VideoCore {
+
+GpuProfiler::GpuProfiler(bool supported_) : supported{supported_} {}
+
+GpuProfiler::~GpuProfiler() = default;
+
+void GpuProfiler::EndFrame(Core::PerfStats& perf_stats) {
+    if (enabled) {
+        if (current_pass != NoPass) {
+            Mark(NoPass);
+        }
+        Frame& frame = frames[current_frame];
+        frame.pending = frame.num_timestamps > 1;
+        current_pass = NoPass;
+    }
+    ReadFrames(perf_stats);
+
+    // Frames the GPU did not finish by the time their slot comes around again are dropped
+    enabled = supported && Settings::values.gpu_timing.GetValue();
+    current_frame = (current_frame + 1) % NumFrames;
+    Frame& frame = frames[current_frame];
+    frame.num_timestamps = 0;
+    frame.pending = false;
+    if (enabled) {
+        ResetTimestamps(current_frame);
+    }
+}
+
+void GpuProfiler::Push(GpuPass pass) {
+    if (!enabled) {
+        return;
+    }
+    scopes.push_back(pass);
+    if (pass != current_pass) {
+        Mark(pass);
+    }
+}
+
+void GpuProfiler::Pop() {
+    if (!enabled || scopes.empty()) {
+        return;
+    }
+    scopes.pop_back();
+    const GpuPass pass = scopes.empty() ? NoPass : scopes.back();
+    if (pass != current_pass) {
+        Mark(pass);
+    }
+}
+
+void GpuProfiler::Mark(GpuPass pass) {
+    Frame& frame = frames[current_frame];
+    // The last timestamp is kept for the end of the frame
+    if (frame.num_timestamps >= MaxTimestamps - 1 && pass != NoPass) {
+        return;
+    }
+    frame.passes[frame.num_timestamps] = pass;
+    WriteTimestamp(current_frame, frame.num_timestamps);
+    frame.num_timestamps++;
+    current_pass = pass;
+}
+
+void GpuProfiler::ReadFrames(Core::PerfStats& perf_stats) {
+    MICROPROFILE_SCOPE(GPU_ReadTimestamps);
+    std::array<u64, static_cast<std::size_t>(GpuPass::Count)> pass_time{};
+    bool frames_read = false;
+    for (u32 i = 1; i <= NumFrames; i++) {
+        const u32 slot = (current_frame + i) % NumFrames;
+        Frame& frame = frames[slot];
+        if (!frame.pending) {
+            continue;
+        }
+        const auto frame_timestamps = std::span{timestamps}.first(frame.num_timestamps);
+        if (!ReadTimestamps(slot, frame_timestamps)) {
+            break;
+        }
+        frame.pending = false;
+        frames_read = true;
+        for (u32 j = 0; j + 1 < frame.num_timestamps; j++) {
+            if (frame.passes[j] != NoPass && frame_timestamps[j + 1] > frame_timestamps[j]) {
+                pass_time[static_cast<std::size_t>(frame.passes[j])] +=
+                    frame_timestamps[j + 1] - frame_timestamps[j];
+            }
+        }
+    }
+    if (!frames_read) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < pass_time.size(); i++) {
+        perf_stats.AddGpuTime(static_cast<GpuPass>(i), std::chrono::nanoseconds{pass_time[i]});
+    }
+    const auto us = [&pass_time](GpuPass pass) {
+        return static_cast<int>(pass_time[static_cast<std::size_t>(pass)] / 1000);
+    };
+    MICROPROFILE_META_CPU("GPU draw us", us(GpuPass::Draw));
+    MICROPROFILE_META_CPU("GPU upload us", us(GpuPass::Upload));
+    MICROPROFILE_META_CPU("GPU blit us", us(GpuPass::Blit));
+    MICROPROFILE_META_CPU("GPU filter us", us(GpuPass::Filter));
+    MICROPROFILE_META_CPU("GPU present us", us(GpuPass::Present));
+}
+
+} // namespace VideoCore
@@ -0,0 +1,105 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+#include "common/common_types.h"
+#include "core/perf_stats.h"
+
+namespace VideoCore {
+
+using GpuPass = Core::PerfStats::GpuPass;
+
+/**
+ * Measures the host GPU time of the render passes with timestamp queries, enabled by the
+ * gpu_timing setting. A timestamp is written whenever the innermost active pass changes, and the
+ * time until the next one is attributed to it. Time outside of any scope, which includes the GPU
+ * waiting for work, is not counted. The timestamps of a frame are read once the GPU is done with
+ * it, a few frames later.
+ *
+ * The backends write and read the timestamps, this class decides their placement.
+ */
+class GpuProfiler {
+public:
+    /// Timestamps written per frame at most, the ones past it extend the last interval
+    static constexpr u32 MaxTimestamps = 4096;
+
+    /// Number of frames whose timestamps may be waiting for the GPU at once
+    static constexpr u32 NumFrames = 4;
+
+    /// Attributes the GPU work recorded during its lifetime to a pass
+    class Scope {
+    public:
+        explicit Scope(GpuProfiler& profiler_, GpuPass pass) : profiler{profiler_} {
+            profiler.Push(pass);
+        }
+
+        ~Scope() {
+            profiler.Pop();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& profiler;
+    };
+
+    virtual ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    /**
+     * Ends the current frame and reports the GPU time of the frames the GPU finished to
+     * perf_stats and microprofile. Must be called outside of any scope.
+     */
+    void EndFrame(Core::PerfStats& perf_stats);
+
+protected:
+    /// supported is false if the backend cannot write timestamps, which disables the profiler
+    explicit GpuProfiler(bool supported);
+
+    /// Writes the timestamp index of the frame slot once the preceding GPU work completed
+    virtual void WriteTimestamp(u32 frame, u32 index) = 0;
+
+    /// Prepares the timestamps of the frame slot for a new frame, before any of them is written
+    virtual void ResetTimestamps(u32 frame) = 0;
+
+    /**
+     * Reads the first timestamps.size() timestamps of the frame slot, in nanoseconds.
+     * @returns false if the GPU did not write them yet
+     */
+    virtual bool ReadTimestamps(u32 frame, std::span<u64> timestamps) = 0;
+
+private:
+    /// Pass of the timestamps that are not followed by any work, like the last of a frame
+    static constexpr GpuPass NoPass = GpuPass::Count;
+
+    struct Frame {
+        std::array<GpuPass, MaxTimestamps> passes;
+        u32 num_timestamps;
+        bool pending; ///< The frame ended and its timestamps were not read yet
+    };
+
+    void Push(GpuPass pass);
+    void Pop();
+    void Mark(GpuPass pass);
+
+    /// Reads the timestamps of the pending frames the GPU finished, oldest first
+    void ReadFrames(Core::PerfStats& perf_stats);
+
+    bool supported;
+    bool enabled{};
+    u32 current_frame{};
+    GpuPass current_pass{NoPass}; ///< Pass of the last timestamp written
+    std::vector<GpuPass> scopes;
+    std::array<Frame, NumFrames> frames{};
+    std::array<u64, MaxTimestamps> timestamps{};
+};
+
+} // namespace VideoCore
@@ -10,11 +10,8 @@ layout(location = 0) out vec4 frag_color;
 
 layout(binding = 0) uniform sampler2D tex;
 
-#ifdef VULKAN
-layout(push_constant, std140) uniform XbrzInfo {
-    float scale;
-};
-#else
+// On Vulkan the scale is part of the push constants of the compute filter wrapper
+#ifndef VULKAN
 layout(location = 2) uniform float scale;
 #endif
 
@@ -263,6 +263,7 @@ void GeometryPipeline::SubmitVertex(const AttributeBuffer& input) {
     } else {
         if (backend->SubmitVertex(input)) {
             shader_engine->Run(gs, gs_unit);
+            gs_unit.emitter.Flush();
 
             // The uniform b15 is set to true after every geometry shader invocation. This is useful
             // for the shader to know if this is the first invocation in a batch, if the program set
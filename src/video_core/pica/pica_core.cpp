@@ -2,13 +2,17 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <limits>
+#include <thread>
 #include "common/arch.h"
-
+#include "common/hash.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/memory.h"
+#include "core/savestate.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/pica/vertex_loader.h"
@@ -17,6 +21,11 @@
 
 namespace Pica {
 
+/// Smallest draw shaded by the parallel vertex path, below it thread synchronization dominates.
+constexpr u32 PARALLEL_SHADING_MIN_VERTICES = 1024;
+/// Number of vertices shaded by one parallel vertex task.
+constexpr std::size_t PARALLEL_SHADING_CHUNK_SIZE = 256;
+
 MICROPROFILE_DEFINE(GPU_Drawing, "GPU", "Drawing", MP_RGB(50, 50, 240));
 
 using namespace DebugUtils;
@@ -30,6 +39,83 @@ union CommandHeader {
 };
 static_assert(sizeof(CommandHeader) == sizeof(u32), "CommandHeader has incorrect size!");
 
+// Expand a 4-bit mask to 4-byte mask, e.g. 0b0101 -> 0x00FF00FF
+constexpr std::array<u32, 16> ExpandBitsToBytes = {
+    0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff, 0x00ffff00, 0x00ffffff,
+    0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ffff, 0xffff0000, 0xffff00ff, 0xffffff00, 0xffffffff,
+};
+
+/// Number of decoded command lists kept before the cache is flushed.
+constexpr std::size_t MAX_CACHED_CMD_LISTS = 1024;
+
+/**
+ * Returns true when the register affects how batched triangles are drawn. The registers from the
+ * vertex pipeline onwards only feed vertex loading and shading, which batched triangles are past.
+ */
+static constexpr bool AffectsBatchedTriangles(u32 id) {
+    return id < PICA_REG_INDEX(pipeline);
+}
+
+/// Returns the first register of the uniform or LUT data port a run of words is written to.
+static std::optional<u32> FindDataPort(u32 id, bool group_commands, std::size_t num_words) {
+    constexpr std::array<u32, 5> DataPorts = {
+        PICA_REG_INDEX(vs.uniform_setup.set_value[0]),
+        PICA_REG_INDEX(gs.uniform_setup.set_value[0]),
+        PICA_REG_INDEX(lighting.lut_data[0]),
+        PICA_REG_INDEX(texturing.fog_lut_data[0]),
+        PICA_REG_INDEX(texturing.proctex_lut_data[0]),
+    };
+    const auto port = std::find_if(DataPorts.begin(), DataPorts.end(),
+                                   [id](u32 first) { return id >= first && id < first + 8; });
+    // Grouped commands must stay within the eight registers of the port.
+    const u32 last_id = id + (group_commands ? static_cast<u32>(num_words) : 0);
+    if (port == DataPorts.end() || last_id >= *port + 8) {
+        return std::nullopt;
+    }
+    return *port;
+}
+
+/// Returns true if writing the register does more than store its value and notify the rasterizer.
+static bool HasWriteSideEffects(u32 id) {
+    static constexpr auto table = [] {
+        std::array<bool, RegsInternal::NUM_REGS> table{};
+        const auto mark = [&table](std::size_t first, std::size_t count = 1) {
+            for (std::size_t i = 0; i < count; i++) {
+                table[first + i] = true;
+            }
+        };
+        mark(PICA_REG_INDEX(trigger_irq));
+        mark(PICA_REG_INDEX(pipeline.triangle_topology));
+        mark(PICA_REG_INDEX(pipeline.restart_primitive));
+        mark(PICA_REG_INDEX(pipeline.vs_default_attributes_setup.index));
+        mark(PICA_REG_INDEX(pipeline.vs_default_attributes_setup.set_value[0]), 3);
+        mark(PICA_REG_INDEX(pipeline.command_buffer.trigger[0]), 2);
+        mark(PICA_REG_INDEX(pipeline.trigger_draw));
+        mark(PICA_REG_INDEX(pipeline.trigger_draw_indexed));
+        mark(PICA_REG_INDEX(gs.bool_uniforms));
+        mark(PICA_REG_INDEX(gs.int_uniforms[0]), 4);
+        mark(PICA_REG_INDEX(gs.uniform_setup.set_value[0]), 8);
+        mark(PICA_REG_INDEX(gs.program.set_word[0]), 8);
+        mark(PICA_REG_INDEX(gs.swizzle_patterns.set_word[0]), 8);
+        mark(PICA_REG_INDEX(vs.output_mask));
+        mark(PICA_REG_INDEX(vs.bool_uniforms));
+        mark(PICA_REG_INDEX(vs.int_uniforms[0]), 4);
+        mark(PICA_REG_INDEX(vs.uniform_setup.set_value[0]), 8);
+        mark(PICA_REG_INDEX(vs.program.set_word[0]), 8);
+        mark(PICA_REG_INDEX(vs.swizzle_patterns.set_word[0]), 8);
+        mark(PICA_REG_INDEX(lighting.lut_data[0]), 8);
+        mark(PICA_REG_INDEX(texturing.fog_lut_data[0]), 8);
+        mark(PICA_REG_INDEX(texturing.proctex_lut_data[0]), 8);
+        return table;
+    }();
+    return id >= table.size() || table[id];
+}
+
+static bool IsCmdListJump(u32 id) {
+    return id == PICA_REG_INDEX(pipeline.command_buffer.trigger[0]) ||
+           id == PICA_REG_INDEX(pipeline.command_buffer.trigger[1]);
+}
+
 PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext> debug_context_)
     : memory{memory_}, debug_context{std::move(debug_context_)}, geometry_pipeline{regs.internal,
                                                                                    gs_unit,
@@ -84,6 +170,52 @@ void PicaCore::InitializeRegs() {
     gs.shader_mode.Assign(ShaderRegs::ShaderMode::VS);
 }
 
+void PicaCore::SaveState(Core::StateWriter& writer) const {
+    const auto save_setup = [&writer](const ShaderSetup& setup) {
+        writer.WriteBytes(&setup.uniforms, sizeof(setup.uniforms));
+        writer.WriteBytes(setup.program_code.data(), sizeof(setup.program_code));
+        writer.WriteBytes(setup.swizzle_data.data(), sizeof(setup.swizzle_data));
+        writer.Write<u32>(setup.entry_point);
+    };
+
+    writer.Write<u32>(Core::MakeStateTag("PICA"));
+    writer.WriteBytes(&regs_lcd, sizeof(regs_lcd));
+    writer.WriteBytes(regs.reg_array.data(), sizeof(regs.reg_array));
+    save_setup(vs_setup);
+    save_setup(gs_setup);
+    writer.WriteBytes(&proctex, sizeof(proctex));
+    writer.WriteBytes(&lighting, sizeof(lighting));
+    writer.WriteBytes(&fog, sizeof(fog));
+    writer.WriteBytes(&input_default_attributes, sizeof(input_default_attributes));
+}
+
+void PicaCore::LoadState(Core::StateReader& reader) {
+    const auto load_setup = [&reader](ShaderSetup& setup) {
+        reader.ReadBytes(&setup.uniforms, sizeof(setup.uniforms));
+        reader.ReadBytes(setup.program_code.data(), sizeof(setup.program_code));
+        reader.ReadBytes(setup.swizzle_data.data(), sizeof(setup.swizzle_data));
+        reader.Read(setup.entry_point);
+        setup.uniform_queue.Reset();
+        setup.MarkProgramCodeDirty();
+        setup.MarkSwizzleDataDirty();
+    };
+
+    reader.ExpectTag(Core::MakeStateTag("PICA"));
+    reader.ReadBytes(&regs_lcd, sizeof(regs_lcd));
+    reader.ReadBytes(regs.reg_array.data(), sizeof(regs.reg_array));
+    load_setup(vs_setup);
+    load_setup(gs_setup);
+    reader.ReadBytes(&proctex, sizeof(proctex));
+    reader.ReadBytes(&lighting, sizeof(lighting));
+    reader.ReadBytes(&fog, sizeof(fog));
+    reader.ReadBytes(&input_default_attributes, sizeof(input_default_attributes));
+
+    // Command list processing always completes within a single GSP command, so any in-flight
+    // immediate mode or primitive assembly state can be safely discarded.
+    immediate.Reset();
+    primitive_assembler.Reconfigure(regs.internal.pipeline.triangle_topology);
+}
+
 void PicaCore::BindRasterizer(VideoCore::RasterizerInterface* rasterizer) {
     this->rasterizer = rasterizer;
 }
@@ -97,6 +229,12 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size) {
     const u8* head = memory.GetPhysicalPointer(list);
     cmd_list.Reset(list, head, size);
 
+    // Replay lists that were decoded before, following any jumps to other lists.
+    if (Settings::values.cache_command_lists && !debug_context && !DebugUtils::IsPicaTracing()) {
+        while (cmd_list.current_index < cmd_list.length && ReplayCmdList()) {
+        }
+    }
+
     while (cmd_list.current_index < cmd_list.length) {
         // Align read pointer to 8 bytes
         if (cmd_list.current_index % 2 != 0) {
@@ -110,6 +248,15 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size) {
         // Write to the requested PICA register.
         WriteInternalReg(header.cmd_id, value, header.parameter_mask);
 
+        // Uniform and LUT uploads stream many words into the same data port, copy those in bulk.
+        const std::span extra_data{cmd_list.head + cmd_list.current_index,
+                                   header.extra_data_length.Value()};
+        if (header.parameter_mask == 0xF && !extra_data.empty() &&
+            WriteDataPort(header.cmd_id, header.group_commands, extra_data)) {
+            cmd_list.current_index += header.extra_data_length;
+            continue;
+        }
+
         // Write any extra paramters as well.
         for (u32 i = 0; i < header.extra_data_length; ++i) {
             const u32 cmd = header.cmd_id + (header.group_commands ? i + 1 : 0);
@@ -117,6 +264,9 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size) {
             WriteInternalReg(cmd, extra_value, header.parameter_mask);
         }
     }
+
+    // The guest may read the render targets once the list is processed.
+    rasterizer->FlushTriangles();
 }
 
 void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
@@ -128,12 +278,9 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         return;
     }
 
-    // Expand a 4-bit mask to 4-byte mask, e.g. 0b0101 -> 0x00FF00FF
-    constexpr std::array<u32, 16> ExpandBitsToBytes = {
-        0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff,
-        0x00ffff00, 0x00ffffff, 0xff000000, 0xff0000ff, 0xff00ff00, 0xff00ffff,
-        0xffff0000, 0xffff00ff, 0xffffff00, 0xffffffff,
-    };
+    if (AffectsBatchedTriangles(id)) {
+        rasterizer->FlushTriangles();
+    }
 
     // TODO: Figure out how register masking acts on e.g. vs.uniform_setup.set_value
     const u32 old_value = regs.internal.reg_array[id];
@@ -361,6 +508,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         ASSERT_MSG(lut_config.index < 256, "lut_config.index exceeded maximum value of 255!");
 
         lighting.luts[lut_config.type][lut_config.index].raw = value;
+        lighting.dirty[lut_config.type].Add(lut_config.index, 1, 256);
         lut_config.index.Assign(lut_config.index + 1);
         break;
     }
@@ -374,6 +522,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
     case PICA_REG_INDEX(texturing.fog_lut_data[6]):
     case PICA_REG_INDEX(texturing.fog_lut_data[7]): {
         fog.lut[regs.internal.texturing.fog_lut_offset % 128].raw = value;
+        fog.dirty.Add(regs.internal.texturing.fog_lut_offset, 1, 128);
         regs.internal.texturing.fog_lut_offset.Assign(regs.internal.texturing.fog_lut_offset + 1);
         break;
     }
@@ -391,18 +540,23 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         switch (regs.internal.texturing.proctex_lut_config.ref_table.Value()) {
         case TexturingRegs::ProcTexLutTable::Noise:
             proctex.noise_table[index % proctex.noise_table.size()].raw = value;
+            proctex.noise_dirty.Add(index, 1, 128);
             break;
         case TexturingRegs::ProcTexLutTable::ColorMap:
             proctex.color_map_table[index % proctex.color_map_table.size()].raw = value;
+            proctex.color_map_dirty.Add(index, 1, 128);
             break;
         case TexturingRegs::ProcTexLutTable::AlphaMap:
             proctex.alpha_map_table[index % proctex.alpha_map_table.size()].raw = value;
+            proctex.alpha_map_dirty.Add(index, 1, 128);
             break;
         case TexturingRegs::ProcTexLutTable::Color:
             proctex.color_table[index % proctex.color_table.size()].raw = value;
+            proctex.color_dirty.Add(index, 1, 256);
             break;
         case TexturingRegs::ProcTexLutTable::ColorDiff:
             proctex.color_diff_table[index % proctex.color_diff_table.size()].raw = value;
+            proctex.color_diff_dirty.Add(index, 1, 256);
             break;
         }
         index.Assign(index + 1);
@@ -416,6 +570,228 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
     rasterizer->NotifyPicaRegisterChanged(id);
 }
 
+bool PicaCore::WriteDataPort(u32 id, bool group_commands, std::span<const u32> words) {
+    // The debugger and the PICA tracer want to observe every individual write.
+    if (debug_context || DebugUtils::IsPicaTracing()) {
+        return false;
+    }
+
+    const auto port = FindDataPort(id, group_commands, words.size());
+    if (!port) {
+        return false;
+    }
+    const u32 last_id = id + (group_commands ? static_cast<u32>(words.size()) : 0);
+    if (AffectsBatchedTriangles(id)) {
+        rasterizer->FlushTriangles();
+    }
+
+    // Mirror the register file as if every word had been written individually.
+    if (group_commands) {
+        std::copy(words.begin(), words.end(), regs.internal.reg_array.begin() + id + 1);
+    } else {
+        regs.internal.reg_array[id] = words.back();
+    }
+
+    switch (*port) {
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[0]): {
+        const bool mirror_to_gs = !regs.internal.pipeline.gs_unit_exclusive_configuration &&
+                                  regs.internal.pipeline.use_gs == PipelineRegs::UseGS::No;
+        for (const u32 word : words) {
+            const auto index = vs_setup.WriteUniformFloatReg(regs.internal.vs, word);
+            if (mirror_to_gs && index) {
+                gs_setup.uniforms.f[index.value()] = vs_setup.uniforms.f[index.value()];
+            }
+        }
+        break;
+    }
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[0]):
+        for (const u32 word : words) {
+            gs_setup.WriteUniformFloatReg(regs.internal.gs, word);
+        }
+        break;
+    case PICA_REG_INDEX(lighting.lut_data[0]): {
+        auto& lut_config = regs.internal.lighting.lut_config;
+        auto& lut = lighting.luts[lut_config.type];
+        u32 index = lut_config.index;
+        lighting.dirty[lut_config.type].Add(index, static_cast<u32>(words.size()), 256);
+        for (const u32 word : words) {
+            lut[index++ % lut.size()].raw = word;
+        }
+        lut_config.index.Assign(index);
+        break;
+    }
+    case PICA_REG_INDEX(texturing.fog_lut_data[0]): {
+        u32 offset = regs.internal.texturing.fog_lut_offset;
+        fog.dirty.Add(offset, static_cast<u32>(words.size()), 128);
+        for (const u32 word : words) {
+            fog.lut[offset++ % fog.lut.size()].raw = word;
+        }
+        regs.internal.texturing.fog_lut_offset.Assign(offset);
+        break;
+    }
+    case PICA_REG_INDEX(texturing.proctex_lut_data[0]): {
+        auto& index = regs.internal.texturing.proctex_lut_config.index;
+        const auto upload = [&](auto& table, LutDirtyRange& dirty) {
+            u32 offset = index;
+            dirty.Add(offset, static_cast<u32>(words.size()), static_cast<u32>(table.size()));
+            for (const u32 word : words) {
+                table[offset++ % table.size()].raw = word;
+            }
+            index.Assign(offset);
+        };
+        switch (regs.internal.texturing.proctex_lut_config.ref_table.Value()) {
+        case TexturingRegs::ProcTexLutTable::Noise:
+            upload(proctex.noise_table, proctex.noise_dirty);
+            break;
+        case TexturingRegs::ProcTexLutTable::ColorMap:
+            upload(proctex.color_map_table, proctex.color_map_dirty);
+            break;
+        case TexturingRegs::ProcTexLutTable::AlphaMap:
+            upload(proctex.alpha_map_table, proctex.alpha_map_dirty);
+            break;
+        case TexturingRegs::ProcTexLutTable::Color:
+            upload(proctex.color_table, proctex.color_dirty);
+            break;
+        case TexturingRegs::ProcTexLutTable::ColorDiff:
+            upload(proctex.color_diff_table, proctex.color_diff_dirty);
+            break;
+        }
+        break;
+    }
+    }
+
+    // The rasterizer only marks the uploaded data dirty, once is enough for the whole command.
+    rasterizer->NotifyPicaRegisterChanged(last_id);
+    return true;
+}
+
+bool PicaCore::ReplayCmdList() {
+    const u64 key = (static_cast<u64>(cmd_list.length) << 32) | cmd_list.addr;
+    const u64 hash = Common::ComputeHash64(cmd_list.head, cmd_list.length * sizeof(u32));
+
+    auto it = cmd_list_cache.find(key);
+    stats.cmd_list_lookups++;
+    if (it != cmd_list_cache.end() && it->second.hash == hash) {
+        stats.cmd_list_cache_hits++;
+    } else {
+        if (cmd_list_cache.size() >= MAX_CACHED_CMD_LISTS) {
+            cmd_list_cache.clear();
+        }
+        auto cached = DecodeCmdList();
+        cached.hash = hash;
+        it = cmd_list_cache.insert_or_assign(key, std::move(cached)).first;
+    }
+
+    const CachedCmdList& cached = it->second;
+    if (!cached.replayable) {
+        return false;
+    }
+
+    // Data port words are read from the list itself, which a jump replaces.
+    const u32* head = cmd_list.head;
+    for (const CachedCommand& command : cached.commands) {
+        switch (command.type) {
+        case CachedCommand::Type::Write:
+            WriteInternalReg(command.id, command.value, command.mask);
+            break;
+        case CachedCommand::Type::DataPort:
+            WriteDataPort(command.id, command.group_commands, {head + command.value, command.mask});
+            break;
+        case CachedCommand::Type::State: {
+            if (AffectsBatchedTriangles(command.id)) {
+                rasterizer->FlushTriangles();
+            }
+            u32& reg = regs.internal.reg_array[command.id];
+            reg = (reg & ~command.mask) | command.value;
+            rasterizer->NotifyPicaRegisterChanged(command.id);
+            break;
+        }
+        }
+    }
+
+    if (!cached.ends_with_jump) {
+        cmd_list.current_index = cmd_list.length;
+    }
+    return true;
+}
+
+PicaCore::CachedCmdList PicaCore::DecodeCmdList() const {
+    CachedCmdList cached{};
+    cached.replayable = true;
+
+    // Writes to registers without side effects are merged until the next command that could
+    // observe them, keeping the order in which registers were first written.
+    std::array<s32, RegsInternal::NUM_REGS> pending_slot;
+    pending_slot.fill(-1);
+    std::vector<CachedCommand> pending;
+    const auto flush_pending = [&] {
+        for (const CachedCommand& command : pending) {
+            pending_slot[command.id] = -1;
+        }
+        cached.commands.insert(cached.commands.end(), pending.begin(), pending.end());
+        pending.clear();
+    };
+
+    const auto decode_write = [&](u32 id, u32 value, u32 mask) {
+        if (!HasWriteSideEffects(id)) {
+            if (pending_slot[id] < 0) {
+                pending_slot[id] = static_cast<s32>(pending.size());
+                pending.push_back({CachedCommand::Type::State, false, id, 0, 0});
+            }
+            CachedCommand& command = pending[pending_slot[id]];
+            const u32 write_mask = ExpandBitsToBytes[mask];
+            command.value = (command.value & ~write_mask) | (value & write_mask);
+            command.mask |= write_mask;
+            return;
+        }
+        flush_pending();
+        cached.commands.push_back({CachedCommand::Type::Write, false, id, value, mask});
+    };
+
+    u32 index = 0;
+    while (index < cmd_list.length) {
+        // Align read pointer to 8 bytes
+        if (index % 2 != 0) {
+            index++;
+        }
+
+        const u32 value = cmd_list.head[index++];
+        const CommandHeader header{cmd_list.head[index++]};
+        const u32 num_extra = header.extra_data_length;
+
+        if (header.parameter_mask == 0xF && num_extra > 0 &&
+            FindDataPort(header.cmd_id, header.group_commands, num_extra)) {
+            decode_write(header.cmd_id, value, header.parameter_mask);
+            cached.commands.push_back({CachedCommand::Type::DataPort,
+                                       static_cast<bool>(header.group_commands), header.cmd_id,
+                                       index, num_extra});
+            index += num_extra;
+            continue;
+        }
+
+        decode_write(header.cmd_id, value, header.parameter_mask);
+        if (IsCmdListJump(header.cmd_id)) {
+            // The interpreter keeps reading extra words from the list that was jumped to.
+            cached.replayable = num_extra == 0;
+            cached.ends_with_jump = true;
+            return cached;
+        }
+
+        for (u32 i = 0; i < num_extra; ++i) {
+            const u32 cmd = header.cmd_id + (header.group_commands ? i + 1 : 0);
+            decode_write(cmd, cmd_list.head[index++], header.parameter_mask);
+            if (IsCmdListJump(cmd)) {
+                cached.replayable = i + 1 == num_extra;
+                cached.ends_with_jump = true;
+                return cached;
+            }
+        }
+    }
+
+    flush_pending();
+    return cached;
+}
+
 void PicaCore::SubmitImmediate(u32 value) {
     // Push to word to the queue. This returns true when a full attribute is formed.
     if (!immediate.queue.Push(value)) {
@@ -482,6 +858,9 @@ void PicaCore::DrawImmediate() {
 
     // Flush the immediate triangle.
     rasterizer->DrawTriangles();
+    if (debug_context) {
+        rasterizer->FlushTriangles();
+    }
     immediate.current_attribute = 0;
 }
 
@@ -517,9 +896,15 @@ void PicaCore::DrawArrays(bool is_indexed) {
         return accelerate_draw;
     }();
 
+    stats.draws++;
+
     // Attempt to use hardware vertex shaders if possible.
-    if (accelerate_draw && rasterizer->AccelerateDrawBatch(is_indexed)) {
-        return;
+    if (accelerate_draw) {
+        rasterizer->FlushTriangles();
+        if (rasterizer->AccelerateDrawBatch(is_indexed)) {
+            stats.accelerated_draws++;
+            return;
+        }
     }
 
     // We cannot accelerate the draw, so load and execute the vertex shader for each vertex.
@@ -527,6 +912,36 @@ void PicaCore::DrawArrays(bool is_indexed) {
 
     // Draw emitted triangles.
     rasterizer->DrawTriangles();
+    if (debug_context) {
+        rasterizer->FlushTriangles();
+    }
+}
+
+void PicaCore::ShadeVerticesParallel(const VertexLoader& loader, PAddr base_address) {
+    if (!vertex_workers) {
+        const std::size_t num_workers = std::max(std::thread::hardware_concurrency(), 2U);
+        vertex_workers = std::make_unique<Common::StatefulThreadWorker<ShaderUnit>>(
+            num_workers, "PicaVertexWorker", [](std::size_t) { return ShaderUnit{}; });
+    }
+
+    parallel_outputs.resize(parallel_vertices.size());
+    for (std::size_t start = 0; start < parallel_vertices.size();
+         start += PARALLEL_SHADING_CHUNK_SIZE) {
+        const std::size_t end =
+            std::min(start + PARALLEL_SHADING_CHUNK_SIZE, parallel_vertices.size());
+        vertex_workers->QueueWork([this, &loader, base_address, start, end](ShaderUnit* unit) {
+            for (std::size_t i = start; i < end; ++i) {
+                const ParallelVertex& vertex = parallel_vertices[i];
+                AttributeBuffer input;
+                loader.LoadVertex(base_address, vertex.index, vertex.vertex, input,
+                                  input_default_attributes);
+                unit->LoadInput(regs.internal.vs, input);
+                shader_engine->Run(vs_setup, *unit);
+                unit->WriteOutput(regs.internal.vs, parallel_outputs[i]);
+            }
+        });
+    }
+    vertex_workers->WaitForRequests();
 }
 
 void PicaCore::LoadVertices(bool is_indexed) {
@@ -542,16 +957,7 @@ void PicaCore::LoadVertices(bool is_indexed) {
     const u16* index_address_16 = reinterpret_cast<const u16*>(index_address_8);
     const bool index_u16 = index_info.format != 0;
 
-    // Simple circular-replacement vertex cache
-    const std::size_t VERTEX_CACHE_SIZE = 64;
-    std::array<bool, VERTEX_CACHE_SIZE> vertex_cache_valid{};
-    std::array<u16, VERTEX_CACHE_SIZE> vertex_cache_ids;
-    std::array<AttributeBuffer, VERTEX_CACHE_SIZE> vertex_cache;
-    u32 vertex_cache_pos = 0;
-
     // Compile the vertex shader for this batch.
-    ShaderUnit shader_unit;
-    AttributeBuffer vs_output;
     shader_engine->SetupBatch(vs_setup, regs.internal.vs.main_offset);
 
     // Setup geometry pipeline in case we are using a geometry shader.
@@ -559,29 +965,100 @@ void PicaCore::LoadVertices(bool is_indexed) {
     geometry_pipeline.Setup(shader_engine.get());
     ASSERT(!geometry_pipeline.NeedIndexInput() || is_indexed);
 
-    for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+    const auto get_vertex = [&](u32 index) -> u32 {
         // Indexed rendering doesn't use the start offset
-        const u32 vertex = is_indexed
-                               ? (index_u16 ? index_address_16[index] : index_address_8[index])
-                               : (index + pipeline.vertex_offset);
+        return is_indexed ? (index_u16 ? index_address_16[index] : index_address_8[index])
+                          : (index + pipeline.vertex_offset);
+    };
+
+    if (geometry_pipeline.NeedIndexInput()) {
+        for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+            geometry_pipeline.SubmitIndex(get_vertex(index));
+        }
+        return;
+    }
 
-        bool vertex_cache_hit = false;
+    // Large draws are shaded on worker threads, one pass over the distinct vertices, and then
+    // submitted in order. The debugger expects shader invocations in order, so it forces the
+    // serial path.
+    if (Settings::values.parallel_vertex_shading && !debug_context &&
+        pipeline.num_vertices >= PARALLEL_SHADING_MIN_VERTICES) {
+        parallel_vertices.clear();
+        parallel_slots.resize(pipeline.num_vertices);
         if (is_indexed) {
-            if (geometry_pipeline.NeedIndexInput()) {
-                geometry_pipeline.SubmitIndex(vertex);
+            parallel_vertex_slots.resize(std::numeric_limits<u16>::max() + 1, -1);
+        }
+
+        for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+            const u32 vertex = get_vertex(index);
+            if (is_indexed && parallel_vertex_slots[vertex] >= 0) {
+                parallel_slots[index] = static_cast<u32>(parallel_vertex_slots[vertex]);
                 continue;
             }
+            parallel_slots[index] = static_cast<u32>(parallel_vertices.size());
+            if (is_indexed) {
+                parallel_vertex_slots[vertex] = static_cast<s32>(parallel_vertices.size());
+            }
+            parallel_vertices.push_back({index, vertex});
+        }
 
-            for (u32 i = 0; i < VERTEX_CACHE_SIZE; ++i) {
-                if (vertex_cache_valid[i] && vertex == vertex_cache_ids[i]) {
-                    vs_output = vertex_cache[i];
-                    vertex_cache_hit = true;
-                    break;
-                }
+        ShadeVerticesParallel(loader, base_address);
+
+        for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+            geometry_pipeline.SubmitVertex(parallel_outputs[parallel_slots[index]]);
+        }
+        if (is_indexed) {
+            for (const ParallelVertex& vertex : parallel_vertices) {
+                parallel_vertex_slots[vertex.vertex] = -1;
             }
+            stats.indexed_vertices += pipeline.num_vertices;
+            stats.vertex_cache_hits += pipeline.num_vertices - parallel_vertices.size();
+        }
+        return;
+    }
+
+    // Direct-mapped post-transform vertex cache, only used by indexed rendering
+    if (is_indexed) {
+        vertex_cache.resize(Settings::values.vertex_cache_size.GetValue());
+        for (VertexCacheEntry& entry : vertex_cache) {
+            entry.valid = false;
+            entry.pending_unit = -1;
         }
+    }
+    u32 vertex_cache_hits = 0;
+
+    // Vertices are shaded in batches. While a batch is being gathered its outputs are not known
+    // yet, so cache entries and vertices that hit them refer to the shader unit that will produce
+    // them instead.
+    constexpr std::size_t BATCH_SIZE = ShaderEngine::MaxBatchSize;
+    std::array<ShaderUnit, BATCH_SIZE> batch_units;
+    std::array<AttributeBuffer, BATCH_SIZE> batch_outputs;
+    std::array<s32, BATCH_SIZE> batch_output_unit;
+    std::array<VertexCacheEntry*, BATCH_SIZE> batch_cache_entries;
+
+    for (u32 batch_start = 0; batch_start < pipeline.num_vertices; batch_start += BATCH_SIZE) {
+        const u32 batch_size = std::min<u32>(BATCH_SIZE, pipeline.num_vertices - batch_start);
+        std::size_t num_units = 0;
+
+        for (u32 i = 0; i < batch_size; ++i) {
+            const u32 index = batch_start + i;
+            const u32 vertex = get_vertex(index);
+            batch_output_unit[i] = -1;
+
+            VertexCacheEntry* cache_entry = nullptr;
+            if (is_indexed) {
+                cache_entry = &vertex_cache[vertex % vertex_cache.size()];
+                if (cache_entry->valid && cache_entry->vertex == vertex) {
+                    if (cache_entry->pending_unit >= 0) {
+                        batch_output_unit[i] = cache_entry->pending_unit;
+                    } else {
+                        batch_outputs[i] = cache_entry->output;
+                    }
+                    vertex_cache_hits++;
+                    continue;
+                }
+            }
 
-        if (!vertex_cache_hit) {
             // Initialize data for the current vertex
             AttributeBuffer input;
             loader.LoadVertex(base_address, index, vertex, input, input_default_attributes);
@@ -592,22 +1069,47 @@ void PicaCore::LoadVertices(bool is_indexed) {
                                        std::addressof(input));
             }
 
-            // Invoke the vertex shader for this vertex.
-            shader_unit.LoadInput(regs.internal.vs, input);
-            shader_engine->Run(vs_setup, shader_unit);
-            shader_unit.WriteOutput(regs.internal.vs, vs_output);
+            batch_units[num_units].LoadInput(regs.internal.vs, input);
+            batch_output_unit[i] = static_cast<s32>(num_units);
 
             // Cache the vertex when doing indexed rendering.
-            if (is_indexed) {
-                vertex_cache[vertex_cache_pos] = vs_output;
-                vertex_cache_valid[vertex_cache_pos] = true;
-                vertex_cache_ids[vertex_cache_pos] = vertex;
-                vertex_cache_pos = (vertex_cache_pos + 1) % VERTEX_CACHE_SIZE;
+            if (cache_entry) {
+                cache_entry->valid = true;
+                cache_entry->vertex = vertex;
+                cache_entry->pending_unit = static_cast<s32>(num_units);
+            }
+            batch_cache_entries[num_units] = cache_entry;
+            num_units++;
+        }
+
+        // Invoke the vertex shader for the vertices of the batch.
+        shader_engine->RunBatch(vs_setup, std::span{batch_units.data(), num_units});
+
+        for (u32 i = 0; i < batch_size; ++i) {
+            if (batch_output_unit[i] >= 0) {
+                batch_units[batch_output_unit[i]].WriteOutput(regs.internal.vs, batch_outputs[i]);
+            }
+        }
+        for (std::size_t unit = 0; unit < num_units; ++unit) {
+            VertexCacheEntry* const entry = batch_cache_entries[unit];
+            // The entry may have been claimed by a later vertex of the batch.
+            if (entry && entry->pending_unit == static_cast<s32>(unit)) {
+                batch_units[unit].WriteOutput(regs.internal.vs, entry->output);
+                entry->pending_unit = -1;
             }
         }
 
         // Send to geometry pipeline
-        geometry_pipeline.SubmitVertex(vs_output);
+        for (u32 i = 0; i < batch_size; ++i) {
+            geometry_pipeline.SubmitVertex(batch_outputs[i]);
+        }
+    }
+
+    if (is_indexed) {
+        stats.indexed_vertices += pipeline.num_vertices;
+        stats.vertex_cache_hits += vertex_cache_hits;
+        MICROPROFILE_META_CPU("Vertex cache hits", vertex_cache_hits);
+        MICROPROFILE_META_CPU("Vertex cache misses", pipeline.num_vertices - vertex_cache_hits);
     }
 }
 
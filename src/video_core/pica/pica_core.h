@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "common/thread_worker.h"
 #include "core/hle/service/gsp/gsp_interrupt.h"
 #include "video_core/pica/geometry_pipeline.h"
 #include "video_core/pica/packed_attribute.h"
@@ -14,6 +19,11 @@
 #include "video_core/pica/shader_setup.h"
 #include "video_core/pica/shader_unit.h"
 
+namespace Core {
+class StateReader;
+class StateWriter;
+} // namespace Core
+
 namespace Memory {
 class MemorySystem;
 }
@@ -26,6 +36,7 @@ namespace Pica {
 
 class DebugContext;
 class ShaderEngine;
+class VertexLoader;
 
 class PicaCore {
 public:
@@ -38,11 +49,55 @@ public:
 
     void ProcessCmdList(PAddr list, u32 size);
 
+    /// Writes the register file, shader setups and LUTs to a savestate stream.
+    void SaveState(Core::StateWriter& writer) const;
+
+    /// Restores state written by SaveState. The caller must resync the renderer afterwards.
+    void LoadState(Core::StateReader& reader);
+
 private:
+    /// Command of a decoded command list.
+    struct CachedCommand {
+        enum class Type : u8 {
+            Write,    ///< Register write with side effects, replayed with WriteInternalReg
+            DataPort, ///< Run of words uploaded with WriteDataPort
+            State,    ///< Coalesced writes to a register without side effects
+        };
+        Type type;
+        bool group_commands;
+        u32 id;
+        u32 value; ///< Value written, or offset of the first word in the list for data ports
+        u32 mask;  ///< Parameter mask for writes, byte mask for state, word count for data ports
+    };
+
+    /// Decoded command list, identified by its address, size and content hash.
+    struct CachedCmdList {
+        u64 hash;
+        bool replayable;     ///< False if the list can only be interpreted
+        bool ends_with_jump; ///< Whether the last command jumps to another command list
+        std::vector<CachedCommand> commands;
+    };
+
     void InitializeRegs();
 
     void WriteInternalReg(u32 id, u32 value, u32 mask);
 
+    /**
+     * Uploads the extra words of a command that targets a uniform or LUT data port in one go.
+     * @returns false if the command must be processed one register write at a time.
+     */
+    bool WriteDataPort(u32 id, bool group_commands, std::span<const u32> words);
+
+    /**
+     * Replays the decoded form of the current command list, decoding it first if it was not seen
+     * before. Replaying stops at a jump to another command list.
+     * @returns false if the list cannot be replayed and must be interpreted instead.
+     */
+    bool ReplayCmdList();
+
+    /// Decodes the current command list, coalescing writes to registers without side effects.
+    CachedCmdList DecodeCmdList() const;
+
     void SubmitImmediate(u32 data);
 
     void DrawImmediate();
@@ -51,6 +106,9 @@ private:
 
     void LoadVertices(bool is_indexed);
 
+    /// Shades parallel_vertices into parallel_outputs on the vertex worker threads.
+    void ShadeVerticesParallel(const VertexLoader& loader, PAddr base_address);
+
 public:
     union Regs {
         static constexpr std::size_t NUM_REGS = 0x732;
@@ -101,6 +159,38 @@ public:
         }
     };
 
+    /// Range of the entries of a lookup table written since the rasterizer last synced it
+    struct LutDirtyRange {
+        u32 begin{};
+        u32 end{};
+
+        /// Adds the count entries written from first on, wrapping around at lut_size
+        void Add(u32 first, u32 count, u32 lut_size) {
+            first %= lut_size;
+            if (first + count > lut_size) {
+                begin = 0;
+                end = lut_size;
+                return;
+            }
+            begin = Empty() ? first : std::min(begin, first);
+            end = std::max(end, first + count);
+        }
+
+        void MarkAll(u32 lut_size) {
+            begin = 0;
+            end = lut_size;
+        }
+
+        bool Empty() const {
+            return begin == end;
+        }
+
+        void Clear() {
+            begin = 0;
+            end = 0;
+        }
+    };
+
     struct ProcTex {
         union ValueEntry {
             u32 raw;
@@ -152,6 +242,12 @@ public:
         std::array<ValueEntry, 128> alpha_map_table;
         std::array<ColorEntry, 256> color_table;
         std::array<ColorDifferenceEntry, 256> color_diff_table;
+
+        LutDirtyRange noise_dirty;
+        LutDirtyRange color_map_dirty;
+        LutDirtyRange alpha_map_dirty;
+        LutDirtyRange color_dirty;
+        LutDirtyRange color_diff_dirty;
     };
 
     struct Lighting {
@@ -177,6 +273,7 @@ public:
         };
 
         std::array<std::array<LutEntry, 256>, 24> luts;
+        std::array<LutDirtyRange, 24> dirty;
     };
 
     struct Fog {
@@ -197,6 +294,7 @@ public:
         };
 
         std::array<LutEntry, 128> lut;
+        LutDirtyRange dirty;
     };
 
     RegsLcd regs_lcd{};
@@ -211,6 +309,17 @@ public:
     AttributeBuffer input_default_attributes{};
     ImmediateModeState immediate{};
 
+    /// Counters of the work processed by the PICA, read by benchmarking tools.
+    struct Stats {
+        u64 draws;
+        u64 accelerated_draws;
+        u64 indexed_vertices;
+        u64 vertex_cache_hits;
+        u64 cmd_list_lookups;
+        u64 cmd_list_cache_hits;
+    };
+    Stats stats{};
+
 private:
     Memory::MemorySystem& memory;
     VideoCore::RasterizerInterface* rasterizer;
@@ -220,6 +329,28 @@ private:
     PrimitiveAssembler primitive_assembler;
     CommandList cmd_list;
     std::unique_ptr<ShaderEngine> shader_engine;
+
+    std::unordered_map<u64, CachedCmdList> cmd_list_cache;
+
+    /// Entry of the post-transform vertex cache, which is direct-mapped by vertex index.
+    struct VertexCacheEntry {
+        bool valid;
+        u32 vertex;
+        s32 pending_unit; ///< Shader unit of the current batch producing the output, or -1
+        AttributeBuffer output;
+    };
+    std::vector<VertexCacheEntry> vertex_cache;
+
+    /// Distinct vertex of a draw shaded by the parallel vertex path.
+    struct ParallelVertex {
+        u32 index;  ///< Index of the first use of the vertex in the draw
+        u32 vertex; ///< Vertex index the attributes are loaded from
+    };
+    std::unique_ptr<Common::StatefulThreadWorker<ShaderUnit>> vertex_workers;
+    std::vector<ParallelVertex> parallel_vertices;
+    std::vector<u32> parallel_slots;        ///< Slot in parallel_outputs of each index of the draw
+    std::vector<s32> parallel_vertex_slots; ///< Slot in parallel_outputs of each vertex, or -1
+    std::vector<AttributeBuffer> parallel_outputs;
 };
 
 #define GPU_REG_INDEX(field_name) (offsetof(Pica::PicaCore::Regs, field_name) / sizeof(u32))
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/assert.h"
 #include "common/bit_set.h"
 #include "video_core/pica/regs_shader.h"
@@ -34,19 +35,34 @@ void ShaderUnit::WriteOutput(const ShaderRegs& config, AttributeBuffer& buffer)
 void GeometryEmitter::Emit(std::span<Common::Vec4<f24>, 16> output_regs) {
     ASSERT(vertex_id < 3);
 
-    u32 output_index{};
-    for (u32 reg : Common::BitSet<u32>(output_mask)) {
-        buffer[vertex_id][output_index++] = output_regs[reg];
+    auto& vertex = buffer[vertex_id];
+    for (u32 i = 0; i < num_outputs; ++i) {
+        vertex[i] = output_regs[output_regs_map[i]];
     }
 
     if (prim_emit) {
+        if (num_vertices == vertices.size()) {
+            Flush();
+        }
         if (winding) {
-            handlers->winding_setter();
+            winding_mask |= 1U << (num_vertices / 3);
         }
-        for (std::size_t i = 0; i < buffer.size(); ++i) {
-            handlers->vertex_handler(buffer[i]);
+        std::copy(buffer.begin(), buffer.end(), vertices.begin() + num_vertices);
+        num_vertices += static_cast<u32>(buffer.size());
+    }
+}
+
+void GeometryEmitter::Flush() {
+    for (u32 i = 0; i < num_vertices; i += 3) {
+        if (winding_mask & (1U << (i / 3))) {
+            handlers->winding_setter();
         }
+        handlers->vertex_handler(vertices[i]);
+        handlers->vertex_handler(vertices[i + 1]);
+        handlers->vertex_handler(vertices[i + 2]);
     }
+    num_vertices = 0;
+    winding_mask = 0;
 }
 
 GeometryShaderUnit::GeometryShaderUnit() : ShaderUnit{&emitter} {}
@@ -62,6 +78,10 @@ void GeometryShaderUnit::SetVertexHandlers(VertexHandler vertex_handler,
 
 void GeometryShaderUnit::ConfigOutput(const ShaderRegs& config) {
     emitter.output_mask = config.output_mask;
+    emitter.num_outputs = 0;
+    for (u32 reg : Common::BitSet<u32>(config.output_mask)) {
+        emitter.output_regs_map[emitter.num_outputs++] = static_cast<u8>(reg);
+    }
 }
 
 } // namespace Pica
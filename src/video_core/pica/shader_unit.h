@@ -58,10 +58,20 @@ struct Handlers {
     WindingSetter winding_setter;
 };
 
-/// This structure contains state information for primitive emitting in geometry shader.
+/**
+ * This structure contains state information for primitive emitting in geometry shader. Emitted
+ * primitives are collected in a contiguous vertex buffer and handed to the vertex handler when the
+ * shader invocation finishes, so the shader does not call into the primitive assembler.
+ */
 struct GeometryEmitter {
+    /// Maximum number of emitted vertices collected before they are flushed.
+    static constexpr std::size_t MaxVertices = 96;
+
     void Emit(std::span<Common::Vec4<f24>, 16> output_regs);
 
+    /// Hands the collected primitives to the vertex handler, in emission order.
+    void Flush();
+
 public:
     std::array<AttributeBuffer, 3> buffer;
     u8 vertex_id;
@@ -69,7 +79,14 @@ public:
     bool winding;
     u32 output_mask;
     Handlers* handlers;
+    u32 num_outputs{};                  ///< Number of enabled output registers
+    std::array<u8, 16> output_regs_map; ///< Output register written to each attribute
+    u32 num_vertices{};
+    u32 winding_mask{}; ///< Bit set for each collected primitive with inverted winding
+    std::array<AttributeBuffer, MaxVertices> vertices;
 };
+static_assert(GeometryEmitter::MaxVertices % 3 == 0 && GeometryEmitter::MaxVertices / 3 <= 32,
+              "Collected primitives must fit the winding mask");
 
 /**
  * This is an extended shader unit state that represents the special unit that can run both vertex
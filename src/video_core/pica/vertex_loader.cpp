@@ -2,12 +2,107 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include "common/alignment.h"
+#include "common/arch.h"
 #include "common/logging/log.h"
 #include "video_core/pica/vertex_loader.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace Pica {
 
+namespace {
+
+/// Widens four integer elements to floats in one go.
+template <typename T>
+std::array<f32, 4> WidenElements(const u8* data) {
+    std::array<f32, 4> result;
+#if CITRA_ARCH(x86_64)
+    __m128i elements;
+    if constexpr (sizeof(T) == 1) {
+        s32 packed;
+        std::memcpy(&packed, data, sizeof(packed));
+        elements = _mm_cvtsi32_si128(packed);
+        if constexpr (std::is_signed_v<T>) {
+            elements = _mm_unpacklo_epi8(elements, elements);
+            elements = _mm_srai_epi32(_mm_unpacklo_epi16(elements, elements), 24);
+        } else {
+            const __m128i zero = _mm_setzero_si128();
+            elements = _mm_unpacklo_epi16(_mm_unpacklo_epi8(elements, zero), zero);
+        }
+    } else {
+        elements = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+        elements = _mm_srai_epi32(_mm_unpacklo_epi16(elements, elements), 16);
+    }
+    _mm_storeu_ps(result.data(), _mm_cvtepi32_ps(elements));
+#elif CITRA_ARCH(arm64)
+    int32x4_t elements;
+    if constexpr (sizeof(T) == 1) {
+        s32 packed;
+        std::memcpy(&packed, data, sizeof(packed));
+        const uint8x8_t bytes = vreinterpret_u8_s32(vdup_n_s32(packed));
+        if constexpr (std::is_signed_v<T>) {
+            elements = vmovl_s16(vget_low_s16(vmovl_s8(vreinterpret_s8_u8(bytes))));
+        } else {
+            elements = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(bytes))));
+        }
+    } else {
+        elements = vmovl_s16(vld1_s16(reinterpret_cast<const s16*>(data)));
+    }
+    vst1q_f32(result.data(), vcvtq_f32_s32(elements));
+#else
+    for (std::size_t i = 0; i < result.size(); i++) {
+        T element;
+        std::memcpy(&element, data + i * sizeof(T), sizeof(T));
+        result[i] = static_cast<f32>(element);
+    }
+#endif
+    return result;
+}
+
+template <typename T, u32 NumElements>
+void LoadElements(const u8* data, Common::Vec4<f24>& out) {
+    std::array<f32, 4> elements;
+    if constexpr (NumElements == 4 && !std::is_same_v<T, f32>) {
+        elements = WidenElements<T>(data);
+    } else {
+        for (u32 comp = 0; comp < NumElements; ++comp) {
+            T element;
+            std::memcpy(&element, data + comp * sizeof(T), sizeof(T));
+            elements[comp] = static_cast<f32>(element);
+        }
+    }
+
+    // Default attribute values set if array elements have < 4 components. This
+    // is *not* carried over from the default attribute settings even if they're
+    // enabled for this attribute.
+    for (u32 comp = 0; comp < 4; ++comp) {
+        out[comp] = comp < NumElements ? f24::FromFloat32(elements[comp])
+                                       : (comp == 3 ? f24::One() : f24::Zero());
+    }
+}
+
+template <typename T>
+constexpr std::array<VertexLoader::AttributeLoader, 5> MakeLoaders() {
+    return {nullptr, &LoadElements<T, 1>, &LoadElements<T, 2>, &LoadElements<T, 3>,
+            &LoadElements<T, 4>};
+}
+
+/// Attribute loaders indexed by VertexAttributeFormat and element count.
+constexpr std::array<std::array<VertexLoader::AttributeLoader, 5>, 4> ATTRIBUTE_LOADERS = {
+    MakeLoaders<s8>(),
+    MakeLoaders<u8>(),
+    MakeLoaders<s16>(),
+    MakeLoaders<f32>(),
+};
+
+} // Anonymous namespace
+
 VertexLoader::VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& regs)
     : memory{memory_} {
     const auto& attribute_config = regs.vertex_attributes;
@@ -41,10 +136,11 @@ VertexLoader::VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& re
                 vertex_attribute_sources[attribute_index] = loader_config.data_offset + offset;
                 vertex_attribute_strides[attribute_index] =
                     static_cast<u32>(loader_config.byte_count);
-                vertex_attribute_formats[attribute_index] =
-                    attribute_config.GetFormat(attribute_index);
                 vertex_attribute_elements[attribute_index] =
                     attribute_config.GetNumElements(attribute_index);
+                vertex_attribute_loaders[attribute_index] =
+                    ATTRIBUTE_LOADERS[static_cast<u32>(attribute_config.GetFormat(attribute_index))]
+                                     [vertex_attribute_elements[attribute_index]];
                 offset += attribute_config.GetStride(attribute_index);
             } else if (attribute_index < 16) {
                 // Attribute ids 12, 13, 14 and 15 signify 4, 8, 12 and 16-byte paddings,
@@ -82,27 +178,7 @@ void VertexLoader::LoadVertex(PAddr base_address, u32 index, u32 vertex, Attribu
         const PAddr source_addr =
             base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
 
-        switch (vertex_attribute_formats[i]) {
-        case PipelineRegs::VertexAttributeFormat::BYTE:
-            LoadAttribute<s8>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::UBYTE:
-            LoadAttribute<u8>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::SHORT:
-            LoadAttribute<s16>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::FLOAT:
-            LoadAttribute<f32>(source_addr, i, input);
-            break;
-        }
-
-        // Default attribute values set if array elements have < 4 components. This
-        // is *not* carried over from the default attribute settings even if they're
-        // enabled for this attribute.
-        for (u32 comp = vertex_attribute_elements[i]; comp < 4; comp++) {
-            input[i][comp] = comp == 3 ? f24::One() : f24::Zero();
-        }
+        vertex_attribute_loaders[i](memory.GetPhysicalPointer(source_addr), input[i]);
     }
 }
 
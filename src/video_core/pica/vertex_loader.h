@@ -22,13 +22,11 @@ public:
     void LoadVertex(PAddr base_address, u32 index, u32 vertex, AttributeBuffer& input,
                     AttributeBuffer& input_default_attributes) const;
 
-    template <typename T>
-    void LoadAttribute(PAddr source_addr, u32 attrib, AttributeBuffer& out) const {
-        const T* data = reinterpret_cast<const T*>(memory.GetPhysicalPointer(source_addr));
-        for (u32 comp = 0; comp < vertex_attribute_elements[attrib]; ++comp) {
-            out[attrib][comp] = f24::FromFloat32(data[comp]);
-        }
-    }
+    /**
+     * Converts the elements of one attribute to f24, filling the missing ones with the defaults.
+     * One is instantiated for every format and element count, and picked when the loader is setup.
+     */
+    using AttributeLoader = void (*)(const u8* data, Common::Vec4<f24>& out);
 
     int GetNumTotalAttributes() const {
         return num_total_attributes;
@@ -38,7 +36,7 @@ private:
     Memory::MemorySystem& memory;
     std::array<u32, 16> vertex_attribute_sources;
     std::array<u32, 16> vertex_attribute_strides{};
-    std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
+    std::array<AttributeLoader, 16> vertex_attribute_loaders{};
     std::array<u32, 16> vertex_attribute_elements{};
     std::array<bool, 16> vertex_attribute_is_default;
     int num_total_attributes = 0;
@@ -0,0 +1,208 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <charconv>
+#include <sstream>
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "video_core/post_processing.h"
+
+#include <boost/iostreams/device/file_descriptor.hpp>
+#include <boost/iostreams/stream.hpp>
+
+namespace VideoCore {
+
+namespace {
+
+// The Dolphin shader interface is provided for drop-in compatibility with most of Dolphin's "glsl"
+// shaders, which use hlsl types, hence the #define's below. It's fairly complete, but the features
+// it's missing are:
+// The font texture for the ascii shader (Citra doesn't have an overlay font)
+// GetTime (not used in any shader provided by Dolphin)
+// GetOption* (used in only one shader provided by Dolphin; would require more
+// configuration/frontend work)
+constexpr char dolphin_shader_types[] = R"(
+
+// hlsl to glsl types
+#define float2 vec2
+#define float3 vec3
+#define float4 vec4
+#define uint2 uvec2
+#define uint3 uvec3
+#define uint4 uvec4
+#define int2 ivec2
+#define int3 ivec3
+#define int4 ivec4
+
+// hlsl to glsl function translation
+#define frac fract
+#define lerp mix
+
+)";
+
+constexpr char dolphin_shader_functions[] = R"(
+
+// Interfacing functions
+float4 Sample()
+{
+    return texture(color_texture, frag_tex_coord);
+}
+
+float4 SampleLocation(float2 location)
+{
+    return texture(color_texture, location);
+}
+
+float4 SampleLayer(int layer)
+{
+    if(layer == 0)
+        return texture(color_texture, frag_tex_coord);
+    else
+        return texture(color_texture_r, frag_tex_coord);
+}
+
+#define SampleOffset(offset) textureOffset(color_texture, frag_tex_coord, offset)
+
+float2 GetResolution()
+{
+    return i_resolution.xy;
+}
+
+float2 GetInvResolution()
+{
+    return i_resolution.zw;
+}
+
+float2 GetIResolution()
+{
+    return i_resolution.xy;
+}
+
+float2 GetIInvResolution()
+{
+    return i_resolution.zw;
+}
+
+float2 GetWindowResolution()
+{
+  return o_resolution.xy;
+}
+
+float2 GetInvWindowResolution()
+{
+  return o_resolution.zw;
+}
+
+float2 GetOResolution()
+{
+    return o_resolution.xy;
+}
+
+float2 GetOInvResolution()
+{
+    return o_resolution.zw;
+}
+
+float2 GetCoordinates()
+{
+    return frag_tex_coord;
+}
+
+void SetOutput(float4 color_in)
+{
+    color = color_in;
+}
+
+)";
+
+} // Anonymous namespace
+
+std::vector<PostProcessingPass> ParsePostProcessingChain(std::string_view chain) {
+    std::vector<PostProcessingPass> passes;
+    for (const std::string& entry : Common::SplitString(std::string{chain}, ',')) {
+        const std::string trimmed = Common::StripSpaces(entry);
+        if (trimmed.empty()) {
+            continue;
+        }
+
+        PostProcessingPass pass{trimmed, 0};
+        const std::size_t colon = trimmed.rfind(':');
+        if (colon != std::string::npos) {
+            const std::string scale = Common::StripSpaces(trimmed.substr(colon + 1));
+            const auto result = std::from_chars(scale.data(), scale.data() + scale.size(),
+                                                pass.scale);
+            if (result.ec != std::errc{} || result.ptr != scale.data() + scale.size()) {
+                LOG_ERROR(Render, "Invalid scale in post-processing pass {}", trimmed);
+                pass.scale = 0;
+            }
+            pass.shader = Common::StripSpaces(trimmed.substr(0, colon));
+            pass.scale = std::min(pass.scale, MaxPostProcessingScale);
+        }
+        if (!pass.shader.empty()) {
+            passes.push_back(std::move(pass));
+        }
+    }
+    return passes;
+}
+
+std::string LoadPostProcessingShader(bool anaglyph, std::string_view shader) {
+    std::string shader_dir = FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir);
+    std::string shader_path;
+
+    if (anaglyph) {
+        shader_dir = shader_dir + "anaglyph";
+    }
+
+    // Examining the directory is done because the shader extension might have an odd case
+    // This can be eliminated if it is specified that the shader extension must be lowercase
+    const auto callback = [&shader, &shader_path](u64* num_entries_out,
+                                                  const std::string& directory,
+                                                  const std::string& virtual_name) -> bool {
+        const std::string physical_name = directory + DIR_SEP + virtual_name;
+        if (!FileUtil::IsDirectory(physical_name)) {
+            // The following is done to avoid coupling this to Qt
+            std::size_t dot_pos = virtual_name.rfind(".");
+            if (dot_pos != std::string::npos) {
+                if (Common::ToLower(virtual_name.substr(dot_pos + 1)) == "glsl" &&
+                    virtual_name.substr(0, dot_pos) == shader) {
+                    shader_path = physical_name;
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    FileUtil::ForeachDirectoryEntry(nullptr, shader_dir, callback);
+    if (shader_path.empty()) {
+        return "";
+    }
+
+    boost::iostreams::stream<boost::iostreams::file_descriptor_source> file;
+    FileUtil::OpenFStream<std::ios_base::in>(file, shader_path);
+    if (!file.is_open()) {
+        return "";
+    }
+
+    std::stringstream shader_text;
+    shader_text << file.rdbuf();
+    return shader_text.str();
+}
+
+std::string MakePostProcessingShader(std::string_view declarations, std::string_view source) {
+    if (source.empty()) {
+        return "";
+    }
+
+    std::string shader{dolphin_shader_types};
+    shader.append(declarations);
+    shader.append(dolphin_shader_functions);
+    shader.append(source);
+    return shader;
+}
+
+} // namespace VideoCore
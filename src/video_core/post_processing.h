@@ -0,0 +1,44 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/// Largest output scale of a post-processing pass
+constexpr u32 MaxPostProcessingScale = 10;
+
+/// Pass of the post-processing chain that runs over every emulated screen before presentation
+struct PostProcessingPass {
+    std::string shader; ///< Name of the shader in the shaders directory, without extension
+    u32 scale;          ///< Output size in multiples of the native size, 0 for the internal one
+
+    bool operator==(const PostProcessingPass&) const = default;
+};
+
+/**
+ * Parses a post-processing chain, a comma separated list of shader names, each optionally followed
+ * by a colon and the scale of its output, like "crt:1,sharpen". Passes without a scale output at
+ * the internal resolution. Empty entries are ignored.
+ */
+std::vector<PostProcessingPass> ParsePostProcessingChain(std::string_view chain);
+
+/**
+ * Returns the source of the shader named shader in the shaders directory, or in its anaglyph
+ * subdirectory if anaglyph is true. Returns an empty string if the shader cannot be loaded.
+ */
+std::string LoadPostProcessingShader(bool anaglyph, std::string_view shader);
+
+/**
+ * Returns the source with the Dolphin compatible shader interface prepended to it, empty if the
+ * source is empty. The backends declare the inputs, output and uniforms the interface uses.
+ */
+std::string MakePostProcessingShader(std::string_view declarations, std::string_view source);
+
+} // namespace VideoCore
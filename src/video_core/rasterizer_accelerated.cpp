@@ -2,7 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include "common/alignment.h"
+#include "common/hash.h"
 #include "core/memory.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/rasterizer_accelerated.h"
@@ -11,6 +14,12 @@ namespace VideoCore {
 
 using Pica::f24;
 
+/// Vertices batched before they are drawn even when no state changes
+constexpr std::size_t MAX_BATCHED_VERTICES = 3 * 4096;
+
+/// Index arrays smaller than this are cheaper to scan than to look up and track
+constexpr u32 MIN_CACHED_INDICES = 64;
+
 static Common::Vec4f ColorRGBA8(const u32 color) {
     const auto rgba =
         Common::Vec4u{color >> 0 & 0xFF, color >> 8 & 0xFF, color >> 16 & 0xFF, color >> 24 & 0xFF};
@@ -21,6 +30,48 @@ static Common::Vec3f LightColor(const Pica::LightingRegs::LightColor& color) {
     return Common::Vec3u{color.r, color.g, color.b} / 255.0f;
 }
 
+static Common::Vec2f ValueLutEntry(const auto& entry) {
+    return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
+}
+
+static Common::Vec4f ColorLutEntry(const auto& entry) {
+    const auto rgba = entry.ToVector() / 255.0f;
+    return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+}
+
+/// Converts the dirty entries of lut into lut_data and clears them, returns true if any changed
+template <typename Entry, typename Data, std::size_t N, typename Convert>
+static bool SyncLutData(const std::array<Entry, N>& lut, std::array<Data, N>& lut_data,
+                        Pica::PicaCore::LutDirtyRange& dirty, Convert&& convert) {
+    bool changed = false;
+    for (u32 i = dirty.begin; i < dirty.end; i++) {
+        const Data value = convert(lut[i]);
+        changed |= value != lut_data[i];
+        lut_data[i] = value;
+    }
+    dirty.Clear();
+    return changed;
+}
+
+void RasterizerAccelerated::LutUploader::Begin(u8* buffer_, u64 offset_, bool invalidate) {
+    if (invalidate) {
+        copies.clear();
+    }
+    buffer = buffer_;
+    offset = offset_;
+    bytes_used = 0;
+}
+
+u64 RasterizerAccelerated::LutUploader::UploadBytes(const void* data, std::size_t size) {
+    const u64 hash = Common::HashCombine(Common::ComputeFastHash64(data, size), size);
+    const auto [it, inserted] = copies.try_emplace(hash, offset + bytes_used);
+    if (inserted) {
+        std::memcpy(buffer + bytes_used, data, size);
+        bytes_used += size;
+    }
+    return it->second;
+}
+
 RasterizerAccelerated::HardwareVertex::HardwareVertex(const Pica::OutputVertex& v,
                                                       bool flip_quaternion) {
     position[0] = v.pos.x.ToFloat32();
@@ -54,6 +105,11 @@ RasterizerAccelerated::HardwareVertex::HardwareVertex(const Pica::OutputVertex&
 RasterizerAccelerated::RasterizerAccelerated(Memory::MemorySystem& memory_, Pica::PicaCore& pica_)
     : memory{memory_}, pica{pica_}, regs{pica.regs.internal} {
     fs_uniform_block_data.lighting_lut_dirty.fill(true);
+    MarkLutsDirty();
+
+    // The uniforms are compared bytewise, so the padding of the copies must stay zero
+    std::memset(&pica_uniform_block_data.data, 0, sizeof(pica_uniform_block_data.data));
+    std::memset(&pica_uniform_block_data.next, 0, sizeof(pica_uniform_block_data.next));
 }
 
 /**
@@ -88,6 +144,31 @@ void RasterizerAccelerated::AddTriangle(const Pica::OutputVertex& v0, const Pica
     vertex_batch.emplace_back(v2, AreQuaternionsOpposite(v0.quat, v2.quat));
 }
 
+void RasterizerAccelerated::DrawTriangles() {
+    // Consecutive draws only differing in their vertices are merged into a single host draw.
+    // The PICA notifies FlushTriangles before it changes any state the batch is drawn with.
+    // Each draw that samples the color buffer must observe the previous ones, so draw those now.
+    if (vertex_batch.size() >= MAX_BATCHED_VERTICES || SamplesColorBuffer()) {
+        FlushTriangles();
+    }
+}
+
+void RasterizerAccelerated::FlushTriangles() {
+    if (vertex_batch.empty()) {
+        return;
+    }
+    DrawVertexBatch();
+    vertex_batch.clear();
+}
+
+bool RasterizerAccelerated::SamplesColorBuffer() const {
+    const PAddr color_address = regs.framebuffer.framebuffer.GetColorBufferPhysicalAddress();
+    const auto textures = regs.texturing.GetTextures();
+    return std::any_of(textures.begin(), textures.end(), [color_address](const auto& texture) {
+        return texture.enabled && texture.config.GetPhysicalAddress() == color_address;
+    });
+}
+
 RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray(
     bool is_indexed, u32 stride_alignment) {
     const auto& vertex_attributes = regs.pipeline.vertex_attributes;
@@ -97,19 +178,24 @@ RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray
     if (is_indexed) {
         const auto& index_info = regs.pipeline.index_array;
         const PAddr address = vertex_attributes.GetPhysicalBaseAddress() + index_info.offset;
-        const u8* index_address_8 = memory.GetPhysicalPointer(address);
-        const u16* index_address_16 = reinterpret_cast<const u16*>(index_address_8);
         const bool index_u16 = index_info.format != 0;
+        const u32 num_indices = regs.pipeline.num_vertices;
+        const u32 size = num_indices * (index_u16 ? 2 : 1);
+        const bool cacheable = num_indices >= MIN_CACHED_INDICES;
 
-        vertex_min = 0xFFFF;
-        vertex_max = 0;
-        const u32 size = regs.pipeline.num_vertices * (index_u16 ? 2 : 1);
-        FlushRegion(address, size);
-        for (u32 index = 0; index < regs.pipeline.num_vertices; ++index) {
-            const u32 vertex = index_u16 ? index_address_16[index] : index_address_8[index];
-            vertex_min = std::min(vertex_min, vertex);
-            vertex_max = std::max(vertex_max, vertex);
+        std::optional<IndexRange> range;
+        if (cacheable) {
+            range = FindIndexRange(address, size, index_u16);
         }
+        if (!range) {
+            FlushRegion(address, size);
+            range = ScanIndexRange(memory.GetPhysicalPointer(address), num_indices, index_u16);
+            if (cacheable) {
+                CacheIndexRange(address, size, index_u16, *range);
+            }
+        }
+        vertex_min = range->min;
+        vertex_max = range->max;
     } else {
         vertex_min = regs.pipeline.vertex_offset;
         vertex_max = regs.pipeline.vertex_offset + regs.pipeline.num_vertices - 1;
@@ -128,6 +214,71 @@ RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray
     return {vertex_min, vertex_max, vs_input_size};
 }
 
+bool RasterizerAccelerated::SyncPicaUniforms() {
+    auto& block = pica_uniform_block_data;
+    const bool use_gs = regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No;
+    block.next.vs_uniforms.SetFromRegs(regs.vs, pica.vs_setup);
+    if (use_gs) {
+        block.next.uniforms.SetFromRegs(regs.gs, pica.gs_setup);
+    }
+
+    const std::size_t size = use_gs ? sizeof(block.next) : sizeof(block.next.vs_uniforms);
+    if (use_gs != block.use_gs || std::memcmp(&block.data, &block.next, size) != 0) {
+        std::memcpy(&block.data, &block.next, size);
+        block.use_gs = use_gs;
+        block.dirty = true;
+    }
+    return block.dirty;
+}
+
+bool RasterizerAccelerated::SyncLightingLutData(u32 index) {
+    return SyncLutData(pica.lighting.luts[index], lighting_lut_data[index],
+                       pica.lighting.dirty[index],
+                       [](const auto& entry) { return ValueLutEntry(entry); });
+}
+
+bool RasterizerAccelerated::SyncFogLutData() {
+    return SyncLutData(pica.fog.lut, fog_lut_data, pica.fog.dirty,
+                       [](const auto& entry) { return ValueLutEntry(entry); });
+}
+
+bool RasterizerAccelerated::SyncProcTexLutData(Pica::TexturingRegs::ProcTexLutTable table) {
+    using Pica::TexturingRegs;
+    const auto value_entry = [](const auto& entry) { return ValueLutEntry(entry); };
+    const auto color_entry = [](const auto& entry) { return ColorLutEntry(entry); };
+    auto& proctex = pica.proctex;
+    switch (table) {
+    case TexturingRegs::ProcTexLutTable::Noise:
+        return SyncLutData(proctex.noise_table, proctex_noise_lut_data, proctex.noise_dirty,
+                           value_entry);
+    case TexturingRegs::ProcTexLutTable::ColorMap:
+        return SyncLutData(proctex.color_map_table, proctex_color_map_data,
+                           proctex.color_map_dirty, value_entry);
+    case TexturingRegs::ProcTexLutTable::AlphaMap:
+        return SyncLutData(proctex.alpha_map_table, proctex_alpha_map_data,
+                           proctex.alpha_map_dirty, value_entry);
+    case TexturingRegs::ProcTexLutTable::Color:
+        return SyncLutData(proctex.color_table, proctex_lut_data, proctex.color_dirty,
+                           color_entry);
+    case TexturingRegs::ProcTexLutTable::ColorDiff:
+        return SyncLutData(proctex.color_diff_table, proctex_diff_lut_data,
+                           proctex.color_diff_dirty, color_entry);
+    }
+    return false;
+}
+
+void RasterizerAccelerated::MarkLutsDirty() {
+    for (auto& dirty : pica.lighting.dirty) {
+        dirty.MarkAll(256);
+    }
+    pica.fog.dirty.MarkAll(128);
+    pica.proctex.noise_dirty.MarkAll(128);
+    pica.proctex.color_map_dirty.MarkAll(128);
+    pica.proctex.alpha_map_dirty.MarkAll(128);
+    pica.proctex.color_dirty.MarkAll(256);
+    pica.proctex.color_diff_dirty.MarkAll(256);
+}
+
 void RasterizerAccelerated::SyncEntireState() {
     // Sync renderer-specific fixed-function state
     SyncFixedState();
@@ -163,6 +314,21 @@ void RasterizerAccelerated::SyncEntireState() {
     for (u32 tex_index = 0; tex_index < 3; tex_index++) {
         SyncTextureLodBias(tex_index);
     }
+
+    // The whole register file may have been replaced (e.g. by loading a savestate),
+    // so the LUTs and uniform blocks must be reuploaded as well.
+    fs_uniform_block_data.lighting_lut_dirty.fill(true);
+    fs_uniform_block_data.lighting_lut_dirty_any = true;
+    fs_uniform_block_data.fog_lut_dirty = true;
+    fs_uniform_block_data.proctex_noise_lut_dirty = true;
+    fs_uniform_block_data.proctex_color_map_dirty = true;
+    fs_uniform_block_data.proctex_alpha_map_dirty = true;
+    fs_uniform_block_data.proctex_lut_dirty = true;
+    fs_uniform_block_data.proctex_diff_lut_dirty = true;
+    fs_uniform_block_data.dirty = true;
+    vs_uniform_block_data.dirty = true;
+    shader_dirty = true;
+    MarkLutsDirty();
 }
 
 void RasterizerAccelerated::NotifyPicaRegisterChanged(u32 id) {
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <optional>
+#include <unordered_map>
 #include "common/vector_math.h"
+#include "video_core/rasterizer_cache/vertex_cache.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/shader/generator/pica_fs_config.h"
 #include "video_core/shader/generator/shader_uniforms.h"
@@ -27,17 +30,33 @@ public:
     void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                      const Pica::OutputVertex& v2) override;
 
+    void DrawTriangles() override;
+
+    void FlushTriangles() override;
+
     void NotifyPicaRegisterChanged(u32 id) override;
 
     void SyncEntireState() override;
 
 protected:
+    /// Draws the software shaded triangles of the vertex batch
+    virtual void DrawVertexBatch() = 0;
+
+    /// Returns true when a texture unit samples the color buffer that is drawn to
+    bool SamplesColorBuffer() const;
+
     /// Sync fixed-function pipeline state
     virtual void SyncFixedState() = 0;
 
     /// Notifies that a fixed function PICA register changed to the video backend
     virtual void NotifyFixedFunctionPicaRegisterChanged(u32 id) = 0;
 
+    /// Returns the index range of an index array analyzed by an earlier draw, if it is unchanged
+    virtual std::optional<IndexRange> FindIndexRange(PAddr addr, u32 size, bool index_u16) = 0;
+
+    /// Remembers the index range of an index array until it is written to
+    virtual void CacheIndexRange(PAddr addr, u32 size, bool index_u16, IndexRange range) = 0;
+
     /// Syncs the depth scale to match the PICA register
     void SyncDepthScale();
 
@@ -126,6 +145,15 @@ protected:
         bool dirty = true;
     };
 
+    /// Structure that keeps track of the PICA shader uniforms, which are uploaded by accelerated
+    /// draws when they differ from the uploaded copy
+    struct PicaUniformBlockData {
+        Pica::Shader::Generator::GSPicaUniformData data;
+        Pica::Shader::Generator::GSPicaUniformData next;
+        bool use_gs = false;
+        bool dirty = true;
+    };
+
     /// Structure that the hardware rendered vertices are composed of
     struct HardwareVertex {
         HardwareVertex() = default;
@@ -141,6 +169,36 @@ protected:
         Common::Vec3f view;
     };
 
+    /**
+     * Writes lookup tables to a mapped texel buffer, remembering the offsets of the tables written
+     * since the buffer last wrapped around by their contents. Tables switching back and forth
+     * between a few contents then point at the copy written earlier instead of being written again.
+     */
+    class LutUploader {
+    public:
+        /// Starts writing to a newly mapped buffer, forgetting the copies if it wrapped around
+        void Begin(u8* buffer, u64 offset, bool invalidate);
+
+        /// Returns the offset of a copy of data in elements of T, writing one if there is none
+        template <typename T, std::size_t N>
+        int Upload(const std::array<T, N>& data) {
+            return static_cast<int>(UploadBytes(data.data(), sizeof(data)) / sizeof(T));
+        }
+
+        /// Returns the number of bytes written since Begin
+        [[nodiscard]] std::size_t BytesUsed() const noexcept {
+            return bytes_used;
+        }
+
+    private:
+        u64 UploadBytes(const void* data, std::size_t size);
+
+        std::unordered_map<u64, u64> copies; ///< Buffer offset by hash of the contents
+        u8* buffer{};
+        u64 offset{};
+        std::size_t bytes_used{};
+    };
+
     struct VertexArrayInfo {
         u32 vs_input_index_min;
         u32 vs_input_index_max;
@@ -150,6 +208,30 @@ protected:
     /// Retrieve the range and the size of the input vertex
     VertexArrayInfo AnalyzeVertexArray(bool is_indexed, u32 stride_alignment = 1);
 
+    /// Collects the PICA shader uniforms of an accelerated draw, returns true if they must be
+    /// uploaded
+    bool SyncPicaUniforms();
+
+    /// Returns the size of the PICA shader uniforms of the current geometry pipeline configuration
+    [[nodiscard]] std::size_t PicaUniformsSize() const noexcept {
+        return pica_uniform_block_data.use_gs ? sizeof(Pica::Shader::Generator::GSPicaUniformData)
+                                              : sizeof(Pica::Shader::Generator::VSPicaUniformData);
+    }
+
+    /// Converts the entries of a lighting LUT written since the last sync, returns true on change
+    bool SyncLightingLutData(u32 index);
+
+    /// Converts the entries of the fog LUT written since the last sync, returns true on change
+    bool SyncFogLutData();
+
+    /// Converts the entries of a procedural texture LUT written since the last sync, returns true
+    /// on change
+    bool SyncProcTexLutData(Pica::TexturingRegs::ProcTexLutTable table);
+
+private:
+    /// Marks every entry of the PICA lookup tables for conversion
+    void MarkLutsDirty();
+
 protected:
     Memory::MemorySystem& memory;
     Pica::PicaCore& pica;
@@ -161,6 +243,7 @@ protected:
 
     VSUniformBlockData vs_uniform_block_data{};
     FSUniformBlockData fs_uniform_block_data{};
+    PicaUniformBlockData pica_uniform_block_data;
     using LightLUT = std::array<Common::Vec2f, 256>;
     std::array<LightLUT, Pica::LightingRegs::NumLightingSampler> lighting_lut_data{};
     std::array<Common::Vec2f, 128> fog_lut_data{};
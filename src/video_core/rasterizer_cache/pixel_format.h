@@ -102,6 +102,28 @@ constexpr SurfaceType GetFormatType(PixelFormat format) {
     return FORMAT_MAP[index].type;
 }
 
+/// Returns true if tiled data of the format can be decoded to RGBA8 by the texture decode shader
+constexpr bool IsGpuDecodable(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::RGB5A1:
+    case PixelFormat::RGBA4:
+    case PixelFormat::IA4:
+    case PixelFormat::I4:
+    case PixelFormat::A4:
+    case PixelFormat::ETC1:
+    case PixelFormat::ETC1A4:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Returns true if every pixel of the format occupies whole bytes of guest memory
+constexpr bool IsByteAddressable(PixelFormat format) {
+    return format != PixelFormat::ETC1 && format != PixelFormat::ETC1A4 &&
+           GetFormatBpp(format) >= 8;
+}
+
 bool CheckFormatsBlittable(PixelFormat source_format, PixelFormat dest_format);
 
 std::string_view PixelFormatAsString(PixelFormat format);
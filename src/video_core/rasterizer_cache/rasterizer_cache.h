@@ -38,11 +38,18 @@ RasterizerCache<T>::RasterizerCache(Memory::MemorySystem& memory_,
                                     Pica::RegsInternal& regs_, RendererBase& renderer_)
     : memory{memory_}, custom_tex_manager{custom_tex_manager_}, runtime{runtime_}, regs{regs_},
       renderer{renderer_}, resolution_scale_factor{renderer.GetResolutionScaleFactor()},
+      render_scale_factor{renderer.GetRenderScaleFactor()},
       filter{Settings::values.texture_filter.GetValue()},
       dump_textures{Settings::values.dump_textures.GetValue()},
-      use_custom_textures{Settings::values.custom_textures.GetValue()} {
+      use_custom_textures{Settings::values.custom_textures.GetValue()},
+      async_downloads{Settings::values.async_surface_downloads.GetValue() &&
+                      runtime.SupportsAsyncDownload()},
+      async_filtering{Settings::values.async_texture_filtering.GetValue()},
+      deduplicate_textures{Settings::values.deduplicate_textures.GetValue()} {
     using TextureConfig = Pica::TexturingRegs::TextureConfig;
 
+    custom_tex_manager.SetSupportsBC7(runtime.SupportsCustomFormat(CustomPixelFormat::BC7));
+
     // Create null handles for all cached resources
     void(slot_surfaces.insert(runtime, SurfaceParams{
                                            .width = 1,
@@ -86,8 +93,11 @@ RasterizerCache<T>::~RasterizerCache() {
 
 template <class T>
 void RasterizerCache<T>::TickFrame() {
+    frame_arena.Reset();
+    vertex_cache.TickFrame();
     custom_tex_manager.TickFrame();
     RunGarbageCollector();
+    EvictSurfaces();
 
     const auto new_filter = Settings::values.texture_filter.GetValue();
     if (filter != new_filter) [[unlikely]] {
@@ -108,6 +118,13 @@ void RasterizerCache<T>::TickFrame() {
         }
         UnregisterAll();
     }
+
+    // Render targets of the previous scale are invalidated as the guest draws over them with the
+    // new one and fall out of the cache on their own, so a change doesn't unregister anything.
+    render_scale_factor = renderer.GetRenderScaleFactor();
+
+    FilterPendingSurfaces();
+    ScheduleDownloads();
 }
 
 template <class T>
@@ -125,6 +142,47 @@ void RasterizerCache<T>::RunGarbageCollector() {
     }
 }
 
+template <class T>
+void RasterizerCache<T>::EvictSurfaces() {
+    memory_budget = runtime.GetMemoryBudget() / 100 * SURFACE_MEMORY_BUDGET_PERCENT;
+    memory_usage = 0;
+
+    std::pmr::vector<std::pair<u64, SurfaceId>> candidates{&frame_arena};
+    ForEachSurfaceInRegion(0, 0xFFFFFFFF, [&](SurfaceId surface_id, Surface& surface) {
+        if (surface.type == SurfaceType::Fill) {
+            return;
+        }
+        memory_usage += surface.MemoryUsage();
+        // Surfaces used in the last frame are likely to be used again in the next one
+        if (surface.last_used_tick + 1 < frame_tick) {
+            candidates.emplace_back(surface.last_used_tick, surface_id);
+        }
+    });
+    for (const auto& [config, cube] : texture_cube_cache) {
+        memory_usage += slot_surfaces[cube.surface_id].MemoryUsage();
+    }
+
+    if (memory_budget == 0 || memory_usage <= memory_budget) {
+        return;
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    u32 num_evicted = 0;
+    for (const auto& [tick, surface_id] : candidates) {
+        if (memory_usage <= memory_budget) {
+            break;
+        }
+        Surface& surface = slot_surfaces[surface_id];
+        FlushRegion(surface.addr, surface.size, surface_id);
+        memory_usage -= surface.MemoryUsage();
+        UnregisterSurface(surface_id);
+        num_evicted++;
+    }
+
+    LOG_DEBUG(HW_GPU, "Evicted {} surfaces, memory usage is {} MiB out of {} MiB", num_evicted,
+              memory_usage >> 20, memory_budget >> 20);
+}
+
 template <class T>
 void RasterizerCache<T>::RemoveFramebuffers(SurfaceId surface_id) {
     for (auto it = framebuffers.begin(); it != framebuffers.end();) {
@@ -239,8 +297,14 @@ bool RasterizerCache<T>::AccelerateTextureCopy(const Pica::DisplayTransferConfig
     Surface& src_surface = slot_surfaces[src_surface_id];
     Surface& dst_surface = slot_surfaces[dst_surface_id];
 
-    if (dst_surface.type == SurfaceType::Texture ||
-        !CheckFormatsBlittable(src_surface.pixel_format, dst_surface.pixel_format)) {
+    // Copies between texture surfaces stay on the GPU as long as the copied bytes map to whole
+    // pixels and neither surface was replaced by a custom texture.
+    if (dst_surface.type == SurfaceType::Texture &&
+        (!IsByteAddressable(dst_surface.pixel_format) || src_surface.IsCustom() ||
+         dst_surface.IsCustom())) {
+        return false;
+    }
+    if (!CheckFormatsBlittable(src_surface.pixel_format, dst_surface.pixel_format)) {
         return false;
     }
 
@@ -645,9 +709,10 @@ typename T::Surface& RasterizerCache<T>::GetTextureCube(const TextureCubeConfig&
         }
         cube.ticks[i] = surface.modification_tick;
         Surface& cube_surface = slot_surfaces[cube.surface_id];
+        std::array<TextureCopy, MAX_PICA_LEVELS> texture_copies;
         for (u32 level = 0; level < config.levels; level++) {
             const u32 width_lod = scaled_size >> level;
-            const TextureCopy texture_copy = {
+            texture_copies[level] = {
                 .src_level = level,
                 .dst_level = level,
                 .src_layer = 0,
@@ -656,8 +721,9 @@ typename T::Surface& RasterizerCache<T>::GetTextureCube(const TextureCubeConfig&
                 .dst_offset = {0, 0},
                 .extent = {width_lod, width_lod},
             };
-            runtime.CopyTextures(surface, cube_surface, texture_copy);
         }
+        runtime.CopyTextures(surface, cube_surface,
+                             std::span{texture_copies.data(), config.levels});
     }
 
     return slot_surfaces[cube.surface_id];
@@ -680,7 +746,7 @@ FramebufferHelper<T> RasterizerCache<T>::GetFramebufferSurfaces(bool using_color
 
     SurfaceParams color_params;
     color_params.is_tiled = true;
-    color_params.res_scale = resolution_scale_factor;
+    color_params.res_scale = render_scale_factor;
     color_params.width = config.GetWidth();
     color_params.height = config.GetHeight();
     SurfaceParams depth_params = color_params;
@@ -789,43 +855,9 @@ template <class T>
 template <typename Func>
 void RasterizerCache<T>::ForEachSurfaceInRegion(PAddr addr, std::size_t size, Func&& func) {
     using FuncReturn = typename std::invoke_result<Func, SurfaceId, Surface&>::type;
-    static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
-    boost::container::small_vector<SurfaceId, 8> surfaces;
-    ForEachPage(addr, size, [this, &surfaces, addr, size, func](u64 page) {
-        const auto it = page_table.find(page);
-        if (it == page_table.end()) {
-            if constexpr (BOOL_BREAK) {
-                return false;
-            } else {
-                return;
-            }
-        }
-        for (const SurfaceId surface_id : it->second) {
-            Surface& surface = slot_surfaces[surface_id];
-            if (True(surface.flags & SurfaceFlagBits::Picked)) {
-                continue;
-            }
-            if (!surface.Overlaps(addr, size)) {
-                continue;
-            }
-
-            surface.flags |= SurfaceFlagBits::Picked;
-            surfaces.push_back(surface_id);
-            if constexpr (BOOL_BREAK) {
-                if (func(surface_id, surface)) {
-                    return true;
-                }
-            } else {
-                func(surface_id, surface);
-            }
-        }
-        if constexpr (BOOL_BREAK) {
-            return false;
-        }
+    surface_index.ForEach(addr, size, [this, &func](SurfaceId surface_id) -> FuncReturn {
+        return func(surface_id, slot_surfaces[surface_id]);
     });
-    for (const SurfaceId surface_id : surfaces) {
-        slot_surfaces[surface_id].flags &= ~SurfaceFlagBits::Picked;
-    }
 }
 
 template <class T>
@@ -922,6 +954,7 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
     }
 
     Surface& surface = slot_surfaces[surface_id];
+    surface.last_used_tick = frame_tick;
     const SurfaceInterval validate_interval(addr, addr + size);
 
     if (surface.type == SurfaceType::Fill) {
@@ -951,12 +984,16 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
         // Take an invalid interval from the validation regions and clamp it
         // to the current level interval. If the interval is empty
         // then we have validated the entire level so move to the next.
-        const auto interval = *validate_regions.begin() & level_interval;
-        if (boost::icl::is_empty(interval)) {
+        const auto level_invalid = *validate_regions.begin() & level_interval;
+        if (boost::icl::is_empty(level_invalid)) {
             level_interval = surface.LevelInterval(++level);
             continue;
         }
 
+        // Validate partially written rows of tiles apart from the whole rows, so a small write
+        // into a large texture only uploads the tiles it touched.
+        const auto interval = surface.SplitAtRows(level_invalid);
+
         // Look for a valid surface to copy from.
         const SurfaceParams params = surface.FromInterval(interval);
         const SurfaceId copy_surface_id =
@@ -976,9 +1013,14 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
             continue;
         }
 
+        if (ValidateByFill(surface_id, params, interval)) {
+            notify_validated(params.GetInterval());
+            continue;
+        }
+
         FlushRegion(params.addr, params.size);
         if (!use_custom_textures || !UploadCustomSurface(surface_id, interval)) {
-            UploadSurface(surface, interval);
+            UploadSurface(surface_id, interval);
         }
         notify_validated(params.GetInterval());
     }
@@ -991,28 +1033,71 @@ void RasterizerCache<T>::ValidateSurface(SurfaceId surface_id, PAddr addr, u32 s
 }
 
 template <class T>
-void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interval) {
+void RasterizerCache<T>::UploadSurface(SurfaceId surface_id, SurfaceInterval interval,
+                                       std::span<u8> source) {
     MICROPROFILE_SCOPE(RasterizerCache_UploadSurface);
 
+    Surface& surface = slot_surfaces[surface_id];
     const SurfaceParams load_info = surface.FromInterval(interval);
     ASSERT(load_info.addr >= surface.addr && load_info.end <= surface.end);
 
-    const auto staging = runtime.FindStaging(
-        load_info.width * load_info.height * surface.GetInternalBytesPerPixel(), true);
-
-    auto source_span = memory.GetPhysicalSpan(load_info.addr);
+    auto source_span = source.empty() ? memory.GetPhysicalSpan(load_info.addr) : source;
     if (source_span.empty()) [[unlikely]] {
         return;
     }
 
     const auto upload_data = source_span.subspan(0, load_info.end - load_info.addr);
-    DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging.mapped,
-                  runtime.NeedsConversion(surface.pixel_format));
+
+    // Textures with the same data as a level of another texture copy it on the GPU. Upscaled
+    // ones still upload their unscaled image, which scaling and filters read, but copy the
+    // filtered one.
+    const u32 level = surface.LevelOf(load_info.addr);
+    const u64 content_key =
+        deduplicate_textures ? ComputeContentKey(surface, load_info, upload_data) : 0;
+    const auto duplicate = content_key ? FindDuplicate(surface, content_key) : std::nullopt;
+    const auto copy_duplicate = [&] {
+        const auto rect = surface.GetScaledRect(level);
+        const TextureCopy copy = {
+            .src_level = duplicate->level,
+            .dst_level = level,
+            .src_offset = {0, 0},
+            .dst_offset = {0, 0},
+            .extent = {rect.GetWidth(), rect.GetHeight()},
+        };
+        runtime.CopyTextures(slot_surfaces[duplicate->surface_id], surface, copy);
+    };
+    if (content_key) {
+        surface.level_contents.resize(surface.levels);
+        surface.level_contents[level] = content_key;
+        if (!duplicate) {
+            content_index.insert_or_assign(content_key, ContentEntry{surface_id, level});
+            surface.flags |= SurfaceFlagBits::ContentIndexed;
+        }
+    }
+    if (duplicate && surface.res_scale == 1) {
+        copy_duplicate();
+        return;
+    }
+
+    // When the runtime can decode the format on the GPU the tiled data is uploaded as-is,
+    // which spares the emulation thread the deswizzle and per pixel conversion.
+    const bool decode_on_gpu =
+        load_info.is_tiled && runtime.SupportsTiledDecode(surface.pixel_format);
+    const auto staging = runtime.FindStaging(
+        decode_on_gpu ? static_cast<u32>(upload_data.size())
+                      : load_info.width * load_info.height * surface.GetInternalBytesPerPixel(),
+        true);
+    if (decode_on_gpu) {
+        std::memcpy(staging.mapped.data(), upload_data.data(), upload_data.size());
+    } else {
+        DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging.mapped,
+                      runtime.NeedsConversion(surface.pixel_format));
+    }
 
     const bool should_dump = False(surface.flags & SurfaceFlagBits::Custom) &&
                              False(surface.flags & SurfaceFlagBits::RenderTarget);
     if (dump_textures && should_dump) {
-        const u64 hash = ComputeHash(load_info, upload_data);
+        const u64 hash = ComputeHash(surface, load_info, upload_data);
         const u32 level = surface.LevelOf(load_info.addr);
         custom_tex_manager.DumpTexture(load_info, level, upload_data, hash);
     }
@@ -1023,21 +1108,133 @@ void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interva
         .texture_rect = surface.GetSubRect(load_info),
         .texture_level = surface.LevelOf(load_info.addr),
     };
-    surface.Upload(upload, staging);
+
+    // Upper levels are regenerated from the base level of upscaled surfaces, so only the base
+    // level is worth filtering. Defer it to the next frame when asked to, the linearly scaled
+    // image is used until then.
+    const bool defer_filter = async_filtering && filter != Settings::TextureFilter::None &&
+                              surface.res_scale != 1 && upload.texture_level == 0 && !duplicate;
+    const bool apply_filter = !defer_filter && !duplicate;
+    if (decode_on_gpu) {
+        surface.UploadTiled(upload, staging, apply_filter);
+    } else {
+        surface.Upload(upload, staging, apply_filter);
+    }
+    if (duplicate) {
+        copy_duplicate();
+    }
+    if (defer_filter) {
+        pending_filters.push_back({
+            .surface_id = surface_id,
+            .interval = interval,
+        });
+    }
 }
 
 template <class T>
-u64 RasterizerCache<T>::ComputeHash(const SurfaceParams& load_info, std::span<u8> upload_data) {
-    if (!custom_tex_manager.UseNewHash()) {
-        const u32 width = load_info.width;
-        const u32 height = load_info.height;
-        const u32 bpp = GetFormatBytesPerPixel(load_info.pixel_format);
-        auto decoded = std::vector<u8>(width * height * bpp);
-        DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, decoded, false);
-        return Common::ComputeHash64(decoded.data(), decoded.size());
-    } else {
+void RasterizerCache<T>::FilterPendingSurfaces() {
+    u32 filtered_pixels = 0;
+    auto it = pending_filters.begin();
+    for (; it != pending_filters.end(); it++) {
+        Surface& surface = slot_surfaces[it->surface_id];
+        const SurfaceParams filter_info = surface.FromInterval(it->interval);
+        const u32 num_pixels = filter_info.width * filter_info.height;
+        if (filtered_pixels != 0 && filtered_pixels + num_pixels > ASYNC_FILTER_BUDGET) {
+            break;
+        }
+        filtered_pixels += num_pixels;
+
+        const auto rect = surface.GetSubRect(filter_info);
+        surface.Filter({
+            .src_rect = rect,
+            .dst_rect = rect * surface.res_scale,
+        });
+        if (surface.levels > 1) {
+            runtime.GenerateMipmaps(surface);
+        }
+    }
+    pending_filters.erase(pending_filters.begin(), it);
+}
+
+template <class T>
+u64 RasterizerCache<T>::ComputeContentKey(const Surface& surface, const SurfaceParams& load_info,
+                                          std::span<const u8> upload_data) const {
+    // Only textures are never written by the GPU, so their contents stay what was uploaded
+    // until the guest invalidates them.
+    const u32 level = surface.LevelOf(load_info.addr);
+    if (surface.type != SurfaceType::Texture || surface.texture_type != TextureType::Texture2D ||
+        True(surface.flags & SurfaceFlagBits::Custom) ||
+        load_info.GetInterval() != surface.LevelInterval(level)) {
+        return 0;
+    }
+    u64 key = Common::ComputeFastHash64(upload_data.data(), upload_data.size());
+    key = Common::HashCombine(key, (u64{load_info.width} << 32) | load_info.height);
+    key = Common::HashCombine(key, (static_cast<u64>(load_info.pixel_format) << 1) |
+                                       static_cast<u64>(load_info.is_tiled));
+    return key;
+}
+
+template <class T>
+auto RasterizerCache<T>::FindDuplicate(const Surface& surface, u64 content_key)
+    -> std::optional<ContentEntry> {
+    const auto it = content_index.find(content_key);
+    if (it == content_index.end()) {
+        return std::nullopt;
+    }
+    const auto [surface_id, level] = it->second;
+    const Surface& duplicate = slot_surfaces[surface_id];
+    // Keys of levels that were invalidated since are cleared, and the upscaled image of one
+    // waiting for its filter is still unfiltered.
+    if (&duplicate == &surface || duplicate.level_contents.size() <= level ||
+        duplicate.level_contents[level] != content_key ||
+        duplicate.pixel_format != surface.pixel_format ||
+        duplicate.res_scale != surface.res_scale ||
+        std::ranges::any_of(pending_filters, [surface_id](const PendingFilter& pending) {
+            return pending.surface_id == surface_id;
+        })) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+template <class T>
+u64 RasterizerCache<T>::ComputeHash(Surface& surface, const SurfaceParams& load_info,
+                                    std::span<u8> upload_data) {
+    // Large textures take milliseconds to hash and are often uploaded again with the same data,
+    // so check a faster hash of the data against the last upload of the interval first.
+    const u64 content_hash = Common::ComputeFastHash64(upload_data.data(), upload_data.size());
+    const bool new_hash = custom_tex_manager.UseNewHash();
+    const SurfaceInterval interval = load_info.GetInterval();
+    auto& upload_hashes = surface.upload_hashes;
+    const auto it =
+        std::find_if(upload_hashes.begin(), upload_hashes.end(),
+                     [&](const UploadHash& entry) { return entry.interval == interval; });
+    if (it != upload_hashes.end() && it->content_hash == content_hash &&
+        it->new_hash == new_hash) {
+        return it->hash;
+    }
+
+    const u64 hash = [&] {
+        if (!new_hash) {
+            const u32 width = load_info.width;
+            const u32 height = load_info.height;
+            const u32 bpp = GetFormatBytesPerPixel(load_info.pixel_format);
+            std::pmr::vector<u8> decoded(width * height * bpp, &frame_arena);
+            DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, decoded, false);
+            return Common::ComputeHash64(decoded.data(), decoded.size());
+        }
         return Common::ComputeHash64(upload_data.data(), upload_data.size());
+    }();
+
+    if (it != upload_hashes.end()) {
+        *it = {interval, content_hash, hash, new_hash};
+        return hash;
+    }
+    if (upload_hashes.size() >= MAX_UPLOAD_HASHES) {
+        upload_hashes.erase(upload_hashes.begin());
     }
+    upload_hashes.push_back({interval, content_hash, hash, new_hash});
+    return hash;
 }
 
 template <class T>
@@ -1054,7 +1251,7 @@ bool RasterizerCache<T>::UploadCustomSurface(SurfaceId surface_id, SurfaceInterv
     }
 
     const auto upload_data = source_span.subspan(0, load_info.end - load_info.addr);
-    const u64 hash = ComputeHash(load_info, upload_data);
+    const u64 hash = ComputeHash(surface, load_info, upload_data);
 
     const u32 level = surface.LevelOf(load_info.addr);
     Material* material = custom_tex_manager.GetMaterial(hash);
@@ -1071,6 +1268,9 @@ bool RasterizerCache<T>::UploadCustomSurface(SurfaceId surface_id, SurfaceInterv
     const auto upload = [this, level, surface_id, material]() -> bool {
         ASSERT_MSG(True(slot_surfaces[surface_id].flags & SurfaceFlagBits::Custom),
                    "Surface is not suitable for custom upload, aborting!");
+        if (!runtime.PrepareCustomUpload(material)) {
+            return false;
+        }
         if (!slot_surfaces[surface_id].IsCustom()) {
             const SurfaceBase old_surface{slot_surfaces[surface_id]};
             const SurfaceId old_id =
@@ -1108,16 +1308,114 @@ void RasterizerCache<T>::DownloadSurface(Surface& surface, SurfaceInterval inter
     };
     surface.Download(download, staging);
 
+    EncodeDownload(surface, interval, staging.mapped);
+}
+
+template <class T>
+void RasterizerCache<T>::DownloadSurfaceAsync(SurfaceId surface_id, SurfaceInterval interval) {
+    Surface& surface = slot_surfaces[surface_id];
+    const SurfaceParams flush_info = surface.FromInterval(interval);
+    const u32 flush_start = boost::icl::first(interval);
+
+    const auto staging = runtime.FindReadbackStaging(flush_info.width * flush_info.height *
+                                                     surface.GetInternalBytesPerPixel());
+
+    const BufferTextureCopy download = {
+        .buffer_offset = staging.offset,
+        .buffer_size = staging.size,
+        .texture_rect = surface.GetSubRect(flush_info),
+        .texture_level = surface.LevelOf(flush_start),
+    };
+    const u64 tick = surface.DownloadAsync(download, staging);
+
+    pending_downloads.push_back({
+        .surface_id = surface_id,
+        .interval = interval,
+        .staging = staging,
+        .tick = tick,
+    });
+}
+
+template <class T>
+bool RasterizerCache<T>::FlushPendingDownload(SurfaceId surface_id, SurfaceInterval interval) {
+    const auto it = std::find_if(pending_downloads.begin(), pending_downloads.end(),
+                                 [&](const PendingDownload& pending) {
+                                     return pending.surface_id == surface_id &&
+                                            pending.interval == interval;
+                                 });
+    if (it == pending_downloads.end()) {
+        return false;
+    }
+
+    MICROPROFILE_SCOPE(RasterizerCache_DownloadSurface);
+    runtime.WaitDownload(it->tick);
+    EncodeDownload(slot_surfaces[surface_id], interval, it->staging.mapped);
+    pending_downloads.erase(it);
+    return true;
+}
+
+template <class T>
+void RasterizerCache<T>::EncodeDownload(const Surface& surface, SurfaceInterval interval,
+                                        std::span<u8> data) {
+    const SurfaceParams flush_info = surface.FromInterval(interval);
+    const u32 flush_start = boost::icl::first(interval);
+    const u32 flush_end = boost::icl::last_next(interval);
+
     auto dest_span = memory.GetPhysicalSpan(flush_start);
     if (dest_span.empty()) [[unlikely]] {
         return;
     }
 
     const auto download_dest = dest_span.subspan(0, flush_end - flush_start);
-    EncodeTexture(flush_info, flush_start, flush_end, staging.mapped, download_dest,
+    EncodeTexture(flush_info, flush_start, flush_end, data, download_dest,
                   runtime.NeedsConversion(surface.pixel_format));
 }
 
+template <class T>
+void RasterizerCache<T>::ScheduleDownloads() {
+    // Readbacks the CPU did not consume during the last frame are stale by now
+    pending_downloads.clear();
+    if (!async_downloads) {
+        return;
+    }
+
+    // Surfaces the CPU read back during the last frame will likely be read back again after
+    // this one. Copy their dirty regions now, so FlushRegion only has to wait for the GPU.
+    u32 scheduled_size = 0;
+    for (const auto& [region, surface_id] : dirty_regions) {
+        Surface& surface = slot_surfaces[surface_id];
+        if (False(surface.flags & SurfaceFlagBits::ReadBack) ||
+            surface.type == SurfaceType::Fill) {
+            continue;
+        }
+
+        // Schedule the same intervals FlushRegion downloads when the CPU accesses the region
+        const u32 start_level = surface.LevelOf(region.lower());
+        const u32 end_level = surface.LevelOf(region.upper());
+        for (u32 level = start_level; level <= end_level; level++) {
+            const auto download_interval = region & surface.LevelInterval(level);
+            if (boost::icl::is_empty(download_interval)) {
+                continue;
+            }
+            const SurfaceParams flush_info = surface.FromInterval(download_interval);
+            const u32 download_size =
+                flush_info.width * flush_info.height * surface.GetInternalBytesPerPixel();
+            if (scheduled_size + download_size > ASYNC_DOWNLOAD_BUDGET) {
+                continue;
+            }
+            scheduled_size += download_size;
+            DownloadSurfaceAsync(surface_id, download_interval);
+        }
+    }
+
+    for (const PendingDownload& pending : pending_downloads) {
+        slot_surfaces[pending.surface_id].flags &= ~SurfaceFlagBits::ReadBack;
+    }
+    if (!pending_downloads.empty()) {
+        runtime.Flush();
+    }
+}
+
 template <class T>
 void RasterizerCache<T>::DownloadFillSurface(Surface& surface, SurfaceInterval interval) {
     const u32 flush_start = boost::icl::first(interval);
@@ -1150,6 +1448,36 @@ void RasterizerCache<T>::DownloadFillSurface(Surface& surface, SurfaceInterval i
     }
 }
 
+template <class T>
+bool RasterizerCache<T>::ValidateByFill(SurfaceId surface_id, const SurfaceParams& params,
+                                        const SurfaceInterval& interval) {
+    SurfaceId fill_id{};
+    ForEachSurfaceInRegion(params.addr, params.size, [&](SurfaceId id, Surface& surface) {
+        if (surface.type == SurfaceType::Fill && params.addr >= surface.addr &&
+            params.end <= surface.end && surface.IsRegionValid(params.GetInterval())) {
+            fill_id = id;
+            return true;
+        }
+        return false;
+    });
+    if (!fill_id) {
+        return false;
+    }
+
+    // Repeat the fill pattern in the guest layout of the interval, the regular decode path takes
+    // care of tiling and conversion just like it would after flushing the fill to guest VRAM.
+    const Surface& fill_surface = slot_surfaces[fill_id];
+    const u32 fill_size = fill_surface.fill_size;
+    const u32 phase = (params.addr - fill_surface.addr) % fill_size;
+    fill_upload_buffer.resize(params.size);
+    for (u32 offset = 0; offset < params.size; offset++) {
+        fill_upload_buffer[offset] = fill_surface.fill_data[(phase + offset) % fill_size];
+    }
+
+    UploadSurface(surface_id, interval, fill_upload_buffer);
+    return true;
+}
+
 template <class T>
 bool RasterizerCache<T>::ValidateByReinterpretation(Surface& surface, SurfaceParams params,
                                                     const SurfaceInterval& interval) {
@@ -1223,8 +1551,38 @@ void RasterizerCache<T>::ClearAll(bool flush) {
 
     // Remove the whole cache without really looking at it.
     cached_pages -= flush_interval;
+    vertex_cache.Reset();
     dirty_regions.clear();
-    page_table.clear();
+    surface_index.Clear();
+    pending_downloads.clear();
+    pending_filters.clear();
+}
+
+template <class T>
+void RasterizerCache<T>::CacheVertexData(PAddr addr, u32 size, u32 stride, u64 offset) {
+    if (size == 0) [[unlikely]] {
+        return;
+    }
+    if (vertex_cache.Insert(addr, size, stride, offset)) {
+        UpdatePagesCachedCount(addr, size, 1);
+    }
+}
+
+template <class T>
+void RasterizerCache<T>::CacheIndexRange(PAddr addr, u32 size, bool index_u16, IndexRange range) {
+    if (size == 0 || vertex_cache.IsDynamic(addr)) {
+        return;
+    }
+    if (vertex_cache.InsertIndexRange(addr, size, index_u16, range)) {
+        UpdatePagesCachedCount(addr, size, 1);
+    }
+}
+
+template <class T>
+void RasterizerCache<T>::ClearVertexData() {
+    vertex_cache.Clear([this](PAddr entry_addr, u32 entry_size) {
+        UpdatePagesCachedCount(entry_addr, entry_size, -1);
+    });
 }
 
 template <class T>
@@ -1266,6 +1624,12 @@ void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, SurfaceId flush_surfa
             if (boost::icl::is_empty(download_interval)) {
                 continue;
             }
+            if (async_downloads) {
+                surface.flags |= SurfaceFlagBits::ReadBack;
+                if (FlushPendingDownload(surface_id, download_interval)) {
+                    continue;
+                }
+            }
             DownloadSurface(surface, download_interval);
         }
     }
@@ -1287,6 +1651,11 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region
 
     const SurfaceInterval invalid_interval(addr, addr + size);
 
+    // Copies of vertex data are stale whether the CPU or the GPU writes to the region
+    vertex_cache.Invalidate(addr, size, [this](PAddr entry_addr, u32 entry_size) {
+        UpdatePagesCachedCount(entry_addr, entry_size, -1);
+    });
+
     if (region_owner_id) {
         Surface& region_owner = slot_surfaces[region_owner_id];
         ASSERT(region_owner.type != SurfaceType::Texture);
@@ -1312,6 +1681,16 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region
         if (!surface.IsFullyInvalid()) {
             return;
         }
+        // Views of the region owner in another format stay registered while they are in use, so
+        // that titles switching between the two only pay for the reinterpretation, and not for
+        // a new surface and its framebuffers every time.
+        if (region_owner_id && surface.last_used_tick + 1 >= frame_tick) {
+            Surface& region_owner = slot_surfaces[region_owner_id];
+            if (region_owner.addr == surface.addr && region_owner.end == surface.end &&
+                region_owner.CanReinterpret(surface)) {
+                return;
+            }
+        }
         remove_surfaces.push_back(surface_id);
     });
 
@@ -1321,6 +1700,15 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, SurfaceId region
         dirty_regions.erase(invalid_interval);
     }
 
+    // Pending downloads of the region no longer reflect the latest surface contents
+    std::erase_if(pending_downloads, [&](const PendingDownload& pending) {
+        return boost::icl::intersects(pending.interval, invalid_interval);
+    });
+    // Neither do the unscaled images pending filters would read from
+    std::erase_if(pending_filters, [&](const PendingFilter& pending) {
+        return boost::icl::intersects(pending.interval, invalid_interval);
+    });
+
     for (const SurfaceId surface_id : remove_surfaces) {
         UnregisterSurface(surface_id);
     }
@@ -1340,6 +1728,7 @@ SurfaceId RasterizerCache<T>::CreateSurface(const SurfaceParams& params) {
         return surface_id;
     }();
     Surface& surface = slot_surfaces[surface_id];
+    surface.last_used_tick = frame_tick;
     if (params.res_scale > surface.res_scale) {
         surface.ScaleUp(params.res_scale);
     }
@@ -1355,8 +1744,7 @@ void RasterizerCache<T>::RegisterSurface(SurfaceId surface_id) {
 
     surface.flags |= SurfaceFlagBits::Registered;
     UpdatePagesCachedCount(surface.addr, surface.size, 1);
-    ForEachPage(surface.addr, surface.size,
-                [this, surface_id](u64 page) { page_table[page].push_back(surface_id); });
+    surface_index.Insert(surface_id, surface.addr, surface.size);
 }
 
 template <class T>
@@ -1367,21 +1755,19 @@ void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
 
     surface.flags &= ~SurfaceFlagBits::Registered;
     UpdatePagesCachedCount(surface.addr, surface.size, -1);
-    ForEachPage(surface.addr, surface.size, [this, surface_id](u64 page) {
-        const auto page_it = page_table.find(page);
-        if (page_it == page_table.end()) {
-            ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}", page << CITRA_PAGEBITS);
-            return;
-        }
-        std::vector<SurfaceId>& surfaces = page_it.value();
-        const auto vector_it = std::find(surfaces.begin(), surfaces.end(), surface_id);
-        if (vector_it == surfaces.end()) {
-            ASSERT_MSG(false, "Unregistering unregistered surface in page=0x{:x}",
-                       page << CITRA_PAGEBITS);
-            return;
-        }
-        surfaces.erase(vector_it);
+    std::erase_if(pending_downloads, [surface_id](const PendingDownload& pending) {
+        return pending.surface_id == surface_id;
     });
+    std::erase_if(pending_filters, [surface_id](const PendingFilter& pending) {
+        return pending.surface_id == surface_id;
+    });
+    if (True(surface.flags & SurfaceFlagBits::ContentIndexed)) {
+        std::erase_if(content_index, [surface_id](const auto& entry) {
+            return entry.second.surface_id == surface_id;
+        });
+    }
+    const bool indexed = surface_index.Erase(surface_id, surface.addr, surface.size);
+    ASSERT_MSG(indexed, "Unregistering unindexed surface at addr=0x{:x}", surface.addr);
 
     if (surface.type != SurfaceType::Fill) {
         RemoveTextureCubeFace(surface_id);
@@ -1395,10 +1781,11 @@ void RasterizerCache<T>::UnregisterSurface(SurfaceId surface_id) {
 template <class T>
 void RasterizerCache<T>::UnregisterAll() {
     FlushAll();
-    for (auto& [page, surfaces] : page_table) {
-        while (!surfaces.empty()) {
-            UnregisterSurface(surfaces.back());
-        }
+    std::pmr::vector<SurfaceId> surfaces{&frame_arena};
+    ForEachSurfaceInRegion(0, 0xFFFFFFFF,
+                           [&](SurfaceId surface_id, Surface&) { surfaces.push_back(surface_id); });
+    for (const SurfaceId surface_id : surfaces) {
+        UnregisterSurface(surface_id);
     }
     runtime.Finish();
     frame_tick += runtime.RemoveThreshold();
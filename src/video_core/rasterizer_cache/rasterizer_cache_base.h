@@ -11,12 +11,15 @@
 #include <unordered_map>
 #include <vector>
 #include <boost/icl/interval_map.hpp>
-#include <tsl/robin_map.h>
 
+#include "common/frame_arena.h"
 #include "video_core/rasterizer_cache/framebuffer_base.h"
 #include "video_core/rasterizer_cache/sampler_params.h"
+#include "video_core/rasterizer_cache/surface_index.h"
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/texture_cube.h"
+#include "video_core/rasterizer_cache/utils.h"
+#include "video_core/rasterizer_cache/vertex_cache.h"
 
 namespace Memory {
 class MemorySystem;
@@ -59,8 +62,22 @@ class RendererBase;
 
 template <class T>
 class RasterizerCache {
-    /// Address shift for caching surfaces into a hash table
-    static constexpr u64 CITRA_PAGEBITS = 18;
+    /// Maximum number of bytes read back asynchronously per frame.
+    /// @note Runtimes must provide at least twice this amount of readback staging memory.
+    static constexpr u32 ASYNC_DOWNLOAD_BUDGET = 8 * 1024 * 1024;
+
+    /// Percentage of the runtime memory budget that cached surfaces are allowed to occupy.
+    /// The rest is left for swapchain images, stream buffers and other driver allocations.
+    static constexpr u64 SURFACE_MEMORY_BUDGET_PERCENT = 75;
+
+    /// Maximum number of unscaled pixels filtered per frame when texture filtering is deferred.
+    static constexpr u32 ASYNC_FILTER_BUDGET = 2 * 1024 * 1024;
+
+    /// Maximum number of upload hashes remembered per surface.
+    static constexpr std::size_t MAX_UPLOAD_HASHES = 8;
+
+    /// Initial size of the arena for temporaries of a frame, it grows to what frames need.
+    static constexpr std::size_t FRAME_ARENA_SIZE = 256 * 1024;
 
     using Runtime = typename T::Runtime;
     using Sampler = typename T::Sampler;
@@ -75,6 +92,23 @@ class RasterizerCache {
     using SurfaceRect_Tuple = std::pair<SurfaceId, Common::Rectangle<u32>>;
     using PageMap = boost::icl::interval_map<u32, int>;
 
+    struct PendingDownload {
+        SurfaceId surface_id;
+        SurfaceInterval interval;
+        StagingData staging;
+        u64 tick;
+    };
+
+    struct PendingFilter {
+        SurfaceId surface_id;
+        SurfaceInterval interval;
+    };
+
+    struct ContentEntry {
+        SurfaceId surface_id;
+        u32 level;
+    };
+
 public:
     explicit RasterizerCache(Memory::MemorySystem& memory, CustomTexManager& custom_tex_manager,
                              Runtime& runtime, Pica::RegsInternal& regs, RendererBase& renderer);
@@ -136,23 +170,41 @@ public:
     /// Clear all cached resources tracked by this cache manager
     void ClearAll(bool flush);
 
-private:
-    /// Iterate over all page indices in a range
-    template <typename Func>
-    void ForEachPage(PAddr addr, std::size_t size, Func&& func) {
-        static constexpr bool RETURNS_BOOL = std::is_same_v<std::invoke_result<Func, u64>, bool>;
-        const u64 page_end = (addr + size - 1) >> CITRA_PAGEBITS;
-        for (u64 page = addr >> CITRA_PAGEBITS; page <= page_end; ++page) {
-            if constexpr (RETURNS_BOOL) {
-                if (func(page)) {
-                    break;
-                }
-            } else {
-                func(page);
-            }
-        }
+    /// Returns the backend buffer offset of the copy of the vertex data, if it is still valid
+    std::optional<u64> FindVertexData(PAddr addr, u32 size, u32 stride) const {
+        return vertex_cache.Find(addr, size, stride);
+    }
+
+    /// Returns true when the vertex data starting at addr is not rewritten too often to be cached
+    bool CanCacheVertexData(PAddr addr) const {
+        return !vertex_cache.IsDynamic(addr);
+    }
+
+    /// Registers the copy of the vertex data at offset of the backend buffer, tracking writes to it
+    void CacheVertexData(PAddr addr, u32 size, u32 stride, u64 offset);
+
+    /// Forgets all copies of vertex data, for when the backend reuses the buffer holding them
+    void ClearVertexData();
+
+    /// Returns the index range of the index array in the region, if it is still valid
+    std::optional<IndexRange> FindIndexRange(PAddr addr, u32 size, bool index_u16) const {
+        return vertex_cache.FindIndexRange(addr, size, index_u16);
     }
 
+    /// Registers the index range of the index array in the region, unless it is rewritten often
+    void CacheIndexRange(PAddr addr, u32 size, bool index_u16, IndexRange range);
+
+    /// Returns the estimated memory in bytes occupied by cached surfaces
+    u64 GetMemoryUsage() const noexcept {
+        return memory_usage;
+    }
+
+    /// Returns the memory budget in bytes for cached surfaces, 0 when unknown
+    u64 GetMemoryBudget() const noexcept {
+        return memory_budget;
+    }
+
+private:
     /// Iterates over all the surfaces in a region calling func
     template <typename Func>
     void ForEachSurfaceInRegion(PAddr addr, std::size_t size, Func&& func);
@@ -165,20 +217,37 @@ private:
     /// Unregisters sentenced surfaces that have surpassed the destruction threshold.
     void RunGarbageCollector();
 
+    /// Unregisters the least recently used surfaces until cached surfaces fit the memory budget.
+    void EvictSurfaces();
+
     /// Removes any framebuffers that reference the provided surface_id.
     void RemoveFramebuffers(SurfaceId surface_id);
 
     /// Removes any references of the provided surface id from cached texture cubes.
     void RemoveTextureCubeFace(SurfaceId surface_id);
 
-    /// Computes the hash of the provided texture data.
-    u64 ComputeHash(const SurfaceParams& load_info, std::span<u8> upload_data);
+    /// Computes the hash of the texture data uploaded to the surface, reusing the last one
+    /// computed for the same interval when the data did not change.
+    u64 ComputeHash(Surface& surface, const SurfaceParams& load_info, std::span<u8> upload_data);
+
+    /// Returns the content index key of an upload covering a whole texture level, or zero when
+    /// the upload cannot be shared with other textures.
+    u64 ComputeContentKey(const Surface& surface, const SurfaceParams& load_info,
+                          std::span<const u8> upload_data) const;
+
+    /// Returns a texture level holding the contents identified by content_key, if there is one
+    /// the surface can copy from.
+    std::optional<ContentEntry> FindDuplicate(const Surface& surface, u64 content_key);
 
     /// Update surface's texture for given region when necessary
     void ValidateSurface(SurfaceId surface, PAddr addr, u32 size);
 
-    /// Copies pixel data in interval from the guest VRAM to the host GPU surface
-    void UploadSurface(Surface& surface, SurfaceInterval interval);
+    /// Copies pixel data in interval from the guest VRAM, or from source when provided,
+    /// to the host GPU surface
+    void UploadSurface(SurfaceId surface_id, SurfaceInterval interval, std::span<u8> source = {});
+
+    /// Filters the upscaled images of surfaces uploaded with deferred filtering
+    void FilterPendingSurfaces();
 
     /// Uploads a custom texture identified with hash to the target surface
     bool UploadCustomSurface(SurfaceId surface_id, SurfaceInterval interval);
@@ -186,9 +255,26 @@ private:
     /// Copies pixel data in interval from the host GPU surface to the guest VRAM
     void DownloadSurface(Surface& surface, SurfaceInterval interval);
 
+    /// Schedules a copy of the surface interval to readback memory without waiting for it
+    void DownloadSurfaceAsync(SurfaceId surface_id, SurfaceInterval interval);
+
+    /// Writes a pending asynchronous download of the surface interval to guest VRAM if one exists
+    bool FlushPendingDownload(SurfaceId surface_id, SurfaceInterval interval);
+
+    /// Encodes downloaded pixel data of the surface interval to guest VRAM
+    void EncodeDownload(const Surface& surface, SurfaceInterval interval, std::span<u8> data);
+
+    /// Schedules asynchronous downloads of dirty surfaces the CPU read back since the last frame
+    void ScheduleDownloads();
+
     /// Downloads a fill surface to guest VRAM
     void DownloadFillSurface(Surface& surface, SurfaceInterval interval);
 
+    /// Validates an interval covered by a fill surface that cannot be cleared as a rectangle by
+    /// uploading the fill pattern, leaving the fill pending in guest VRAM
+    bool ValidateByFill(SurfaceId surface_id, const SurfaceParams& params,
+                        const SurfaceInterval& interval);
+
     /// Attempt to find a reinterpretable surface in the cache and use it to copy for validation
     bool ValidateByReinterpretation(Surface& surface, SurfaceParams params,
                                     const SurfaceInterval& interval);
@@ -218,7 +304,7 @@ private:
     Pica::RegsInternal& regs;
     RendererBase& renderer;
     std::unordered_map<TextureCubeConfig, TextureCube> texture_cube_cache;
-    tsl::robin_pg_map<u64, std::vector<SurfaceId>, Common::IdentityHash<u64>> page_table;
+    SurfacePageIndex surface_index;
     std::unordered_map<FramebufferParams, FramebufferId> framebuffers;
     std::unordered_map<SamplerParams, SamplerId> samplers;
     std::list<std::pair<SurfaceId, u64>> sentenced;
@@ -227,12 +313,24 @@ private:
     Common::SlotVector<Framebuffer> slot_framebuffers;
     SurfaceMap dirty_regions;
     PageMap cached_pages;
+    VertexCache vertex_cache;
+    std::vector<PendingDownload> pending_downloads;
+    std::vector<PendingFilter> pending_filters;
+    std::unordered_map<u64, ContentEntry> content_index;
+    std::vector<u8> fill_upload_buffer;
+    Common::FrameArena frame_arena{FRAME_ARENA_SIZE};
     u32 resolution_scale_factor;
+    u32 render_scale_factor; ///< Scale of new render targets, lowered by dynamic resolution
     u64 frame_tick{};
+    u64 memory_usage{};
+    u64 memory_budget{};
     FramebufferParams fb_params;
     Settings::TextureFilter filter;
     bool dump_textures;
     bool use_custom_textures;
+    bool async_downloads;
+    bool async_filtering;
+    bool deduplicate_textures;
 };
 
 } // namespace VideoCore
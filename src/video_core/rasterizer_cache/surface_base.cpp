@@ -22,7 +22,7 @@ bool SurfaceBase::CanFill(const SurfaceParams& dest_surface, SurfaceInterval fil
         if (fill_size * 8 != dest_surface.GetFormatBpp()) {
             // Check if bits repeat for our fill_size
             const u32 dest_bytes_per_pixel = std::max(dest_surface.GetFormatBpp() / 8, 1u);
-            std::vector<u8> fill_test(fill_size * dest_bytes_per_pixel);
+            std::array<u8, 16> fill_test;
 
             for (u32 i = 0; i < dest_bytes_per_pixel; ++i) {
                 std::memcpy(&fill_test[i * fill_size], &fill_data[0], fill_size);
@@ -122,6 +122,21 @@ Extent SurfaceBase::RealExtent(bool scaled) const {
     };
 }
 
+u64 SurfaceBase::MemoryUsage() const {
+    const Extent extent = RealExtent();
+    // Custom textures may be compressed, assume the worst case of RGBA8
+    const u32 bytes_per_pixel = IsCustom() ? 4 : GetFormatBytesPerPixel(pixel_format);
+    u64 usage = static_cast<u64>(extent.width) * extent.height * bytes_per_pixel;
+    if (levels > 1) {
+        // The mipmap chain adds up to a third of the base level
+        usage += usage / 3;
+    }
+    if (texture_type == TextureType::CubeMap) {
+        usage *= 6;
+    }
+    return usage;
+}
+
 bool SurfaceBase::HasNormalMap() const noexcept {
     return material && material->Map(MapType::Normal) != nullptr;
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <vector>
 #include <boost/icl/interval_set.hpp>
 #include "video_core/rasterizer_cache/surface_params.h"
 #include "video_core/rasterizer_cache/utils.h"
@@ -15,15 +16,24 @@ using SurfaceRegions = boost::icl::interval_set<PAddr, std::less, SurfaceInterva
 struct Material;
 
 enum class SurfaceFlagBits : u32 {
-    Registered = 1 << 0,   ///< Surface is registed in the rasterizer cache.
-    Picked = 1 << 1,       ///< Surface has been picked when searching for a match.
-    Tracked = 1 << 2,      ///< Surface is part of a texture cube and should be tracked.
-    Custom = 1 << 3,       ///< Surface texture has been replaced with a custom texture.
-    ShadowMap = 1 << 4,    ///< Surface is used during shadow rendering.
-    RenderTarget = 1 << 5, ///< Surface was a render target.
+    Registered = 1 << 0,     ///< Surface is registed in the rasterizer cache.
+    Tracked = 1 << 2,        ///< Surface is part of a texture cube and should be tracked.
+    Custom = 1 << 3,         ///< Surface texture has been replaced with a custom texture.
+    ShadowMap = 1 << 4,      ///< Surface is used during shadow rendering.
+    RenderTarget = 1 << 5,   ///< Surface was a render target.
+    ReadBack = 1 << 6,       ///< Surface was read back by the CPU since the last frame.
+    ContentIndexed = 1 << 7, ///< Surface was added to the content index of the cache.
 };
 DECLARE_ENUM_FLAG_OPERATORS(SurfaceFlagBits);
 
+/// Hash of the guest data uploaded to a surface interval
+struct UploadHash {
+    SurfaceInterval interval;
+    u64 content_hash; ///< Fast hash of the data, tells whether hash must be computed again.
+    u64 hash;         ///< Hash used to look up custom textures and name dumped ones.
+    bool new_hash;    ///< Whether hash was computed with the new hashing method.
+};
+
 class SurfaceBase : public SurfaceParams {
 public:
     SurfaceBase(const SurfaceParams& params);
@@ -47,6 +57,9 @@ public:
     /// Returns true if the surface contains a custom material with a normal map.
     bool HasNormalMap() const noexcept;
 
+    /// Returns an estimate of the host memory in bytes occupied by the surface texture.
+    u64 MemoryUsage() const;
+
     bool Overlaps(PAddr overlap_addr, std::size_t overlap_size) const noexcept {
         const PAddr overlap_end = overlap_addr + static_cast<PAddr>(overlap_size);
         return addr < overlap_end && overlap_addr < end;
@@ -71,6 +84,7 @@ public:
 
     void MarkInvalid(SurfaceInterval interval) {
         invalid_regions.insert(interval);
+        level_contents.clear();
         modification_tick++;
     }
 
@@ -90,6 +104,9 @@ public:
     u32 fill_size = 0;
     std::array<u8, 4> fill_data;
     u64 modification_tick = 1;
+    u64 last_used_tick = 0;
+    std::vector<UploadHash> upload_hashes;
+    std::vector<u64> level_contents; ///< Content keys of the levels uploaded as a whole, or zero
 };
 
 } // namespace VideoCore
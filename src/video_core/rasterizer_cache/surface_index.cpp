@@ -0,0 +1,39 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/rasterizer_cache/surface_index.h"
+
+namespace VideoCore {
+
+SurfacePageIndex::SurfacePageIndex() : pages(NUM_PAGES) {}
+
+SurfacePageIndex::~SurfacePageIndex() = default;
+
+void SurfacePageIndex::Insert(SurfaceId surface_id, PAddr addr, u32 size) {
+    ForEachPage(addr, size, [&](u64 page) { pages[page].push_back({surface_id, addr, size}); });
+}
+
+bool SurfacePageIndex::Erase(SurfaceId surface_id, PAddr addr, u32 size) {
+    bool found = true;
+    ForEachPage(addr, size, [&](u64 page) {
+        auto& bucket = pages[page];
+        const auto it = std::find_if(bucket.begin(), bucket.end(), [surface_id](const Entry& entry) {
+            return entry.surface_id == surface_id;
+        });
+        if (it == bucket.end()) {
+            found = false;
+            return;
+        }
+        bucket.erase(it);
+    });
+    return found;
+}
+
+void SurfacePageIndex::Clear() {
+    for (auto& bucket : pages) {
+        bucket.clear();
+    }
+}
+
+} // namespace VideoCore
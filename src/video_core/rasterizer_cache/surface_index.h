@@ -0,0 +1,93 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "common/common_types.h"
+#include "video_core/rasterizer_cache/slot_id.h"
+
+namespace VideoCore {
+
+/**
+ * Flat page bucketed index of the address ranges covered by registered surfaces.
+ * A surface is stored in the bucket of every page it touches, so lookups index straight into the
+ * page array and iterate the buckets without hashing or allocating.
+ */
+class SurfacePageIndex {
+public:
+    /// Address shift for bucketing surfaces into pages
+    static constexpr u32 PAGE_BITS = 18;
+    static constexpr std::size_t NUM_PAGES = 1ULL << (32 - PAGE_BITS);
+
+    SurfacePageIndex();
+    ~SurfacePageIndex();
+
+    /// Adds the surface covering [addr, addr + size) to the index
+    void Insert(SurfaceId surface_id, PAddr addr, u32 size);
+
+    /// Removes the surface covering [addr, addr + size), returns false if it was not indexed
+    bool Erase(SurfaceId surface_id, PAddr addr, u32 size);
+
+    /// Removes all surfaces from the index
+    void Clear();
+
+    /**
+     * Calls func once for every surface overlapping [addr, addr + size), in the order they
+     * are found while walking the pages. Iteration stops when func returns true.
+     * @note func must not insert or erase surfaces
+     */
+    template <typename Func>
+    void ForEach(PAddr addr, std::size_t size, Func&& func) const {
+        using FuncReturn = std::invoke_result_t<Func, SurfaceId>;
+        static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
+        if (size == 0) {
+            return;
+        }
+        const u64 end = static_cast<u64>(addr) + size;
+        const u64 first_page = addr >> PAGE_BITS;
+        const u64 last_page = std::min<u64>((end - 1) >> PAGE_BITS, NUM_PAGES - 1);
+        for (u64 page = first_page; page <= last_page; page++) {
+            for (const Entry& entry : pages[page]) {
+                // Surfaces spanning multiple pages are only visited from the first one in range
+                if (page != std::max<u64>(first_page, entry.addr >> PAGE_BITS)) {
+                    continue;
+                }
+                if (entry.addr >= end || addr >= static_cast<u64>(entry.addr) + entry.size) {
+                    continue;
+                }
+                if constexpr (BOOL_BREAK) {
+                    if (func(entry.surface_id)) {
+                        return;
+                    }
+                } else {
+                    func(entry.surface_id);
+                }
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        SurfaceId surface_id;
+        PAddr addr;
+        u32 size;
+    };
+
+    /// Calls func with the index of every page touched by [addr, addr + size)
+    template <typename Func>
+    static void ForEachPage(PAddr addr, u32 size, Func&& func) {
+        const u64 end = static_cast<u64>(addr) + std::max(size, 1U);
+        const u64 last_page = std::min<u64>((end - 1) >> PAGE_BITS, NUM_PAGES - 1);
+        for (u64 page = addr >> PAGE_BITS; page <= last_page; page++) {
+            func(page);
+        }
+    }
+
+    std::vector<std::vector<Entry>> pages;
+};
+
+} // namespace VideoCore
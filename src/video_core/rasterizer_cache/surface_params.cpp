@@ -146,6 +146,26 @@ SurfaceParams SurfaceParams::FromInterval(SurfaceInterval interval) const {
     return params;
 }
 
+SurfaceInterval SurfaceParams::SplitAtRows(SurfaceInterval interval) const {
+    const u32 level = LevelOf(interval.lower());
+    const u32 tiled_size = is_tiled ? 8 : 1;
+    const u32 row_bytes = BytesInPixels((stride >> level) * tiled_size);
+    const PAddr start = mipmap_offsets[level];
+    const u32 first = boost::icl::first(interval) - start;
+    const u32 last_next = boost::icl::last_next(interval) - start;
+
+    if (first / row_bytes == (last_next - 1) / row_bytes) {
+        return interval;
+    }
+    if (first % row_bytes != 0) {
+        return SurfaceInterval(interval.lower(), start + Common::AlignUp(first, row_bytes));
+    }
+    if (last_next % row_bytes != 0) {
+        return SurfaceInterval(interval.lower(), start + Common::AlignDown(last_next, row_bytes));
+    }
+    return interval;
+}
+
 SurfaceInterval SurfaceParams::GetSubRectInterval(Common::Rectangle<u32> unscaled_rect,
                                                   u32 level) const {
     if (unscaled_rect.GetHeight() == 0 || unscaled_rect.GetWidth() == 0) [[unlikely]] {
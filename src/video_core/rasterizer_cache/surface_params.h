@@ -41,6 +41,10 @@ public:
     /// Returns the outer rectangle containing interval
     SurfaceParams FromInterval(SurfaceInterval interval) const;
 
+    /// Returns the leading part of interval that either lies within one row of tiles or only
+    /// spans whole rows, so that its outer rectangle excludes the untouched tiles of partial rows.
+    SurfaceInterval SplitAtRows(SurfaceInterval interval) const;
+
     /// Returns the address interval referenced by unscaled_rect
     SurfaceInterval GetSubRectInterval(Common::Rectangle<u32> unscaled_rect, u32 level = 0) const;
 
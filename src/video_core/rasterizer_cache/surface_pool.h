@@ -0,0 +1,131 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Keeps the host allocations of destroyed surfaces around so new surfaces with the same
+ * properties can reuse them instead of going through the driver allocator.
+ * Allocations are released in FIFO order once the pool holds more than its capacity.
+ * @note Key must be equality comparable and provide a Hash() method
+ */
+template <typename Key, typename Allocation>
+class SurfacePool {
+public:
+    using Deleter = std::function<void(Allocation&&)>;
+
+    explicit SurfacePool(u64 capacity_, Deleter deleter_ = {})
+        : capacity{capacity_}, deleter{std::move(deleter_)} {}
+
+    ~SurfacePool() {
+        Clear();
+    }
+
+    SurfacePool(const SurfacePool&) = delete;
+    SurfacePool& operator=(const SurfacePool&) = delete;
+
+    /// Returns the most recently released allocation matching key, if any
+    [[nodiscard]] std::optional<Allocation> Acquire(const Key& key) {
+        const auto [begin, end] = lookup.equal_range(key);
+        if (begin == end) {
+            return std::nullopt;
+        }
+        auto newest = begin;
+        for (auto it = begin; it != end; ++it) {
+            if (it->second->sequence > newest->second->sequence) {
+                newest = it;
+            }
+        }
+        const auto entry = newest->second;
+        lookup.erase(newest);
+        std::optional<Allocation> allocation{std::move(entry->allocation)};
+        size -= entry->size;
+        entries.erase(entry);
+        return allocation;
+    }
+
+    /// Stores an allocation of size bytes for reuse, releasing the oldest ones over capacity
+    void Release(const Key& key, Allocation&& allocation, u64 allocation_size) {
+        if (allocation_size > capacity) {
+            Destroy(std::move(allocation));
+            return;
+        }
+        entries.push_back(Entry{key, std::move(allocation), allocation_size, sequence++});
+        lookup.emplace(key, std::prev(entries.end()));
+        size += allocation_size;
+        while (size > capacity) {
+            EraseOldest();
+        }
+    }
+
+    /// Releases all stored allocations
+    void Clear() {
+        while (!entries.empty()) {
+            EraseOldest();
+        }
+    }
+
+    /// Returns the number of bytes held by stored allocations
+    [[nodiscard]] u64 Size() const noexcept {
+        return size;
+    }
+
+    /// Returns the number of stored allocations
+    [[nodiscard]] std::size_t Count() const noexcept {
+        return entries.size();
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Allocation allocation;
+        u64 size;
+        u64 sequence;
+    };
+    using EntryIterator = typename std::list<Entry>::iterator;
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            return key.Hash();
+        }
+    };
+
+    void EraseOldest() {
+        const auto entry = entries.begin();
+        const auto [begin, end] = lookup.equal_range(entry->key);
+        for (auto it = begin; it != end; ++it) {
+            if (it->second == entry) {
+                lookup.erase(it);
+                break;
+            }
+        }
+        size -= entry->size;
+        Destroy(std::move(entry->allocation));
+        entries.erase(entry);
+    }
+
+    void Destroy(Allocation&& allocation) {
+        if (deleter) {
+            deleter(std::move(allocation));
+        }
+    }
+
+private:
+    std::list<Entry> entries;
+    std::unordered_multimap<Key, EntryIterator, KeyHash> lookup;
+    u64 capacity;
+    u64 size{};
+    u64 sequence{};
+    Deleter deleter;
+};
+
+} // namespace VideoCore
@@ -0,0 +1,388 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "common/arch.h"
+#include "video_core/rasterizer_cache/texture_codec.h"
+
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include "common/x64/cpu_detect.h"
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+#if CITRA_ARCH(x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define TARGET_SSSE3
+#endif
+
+namespace VideoCore {
+
+namespace {
+
+/**
+ * An 8x8 morton tile is made of 16 2x2 quads, which are themselves laid out in morton order.
+ * Each quad holds the pixels (0, 0), (1, 0), (0, 1), (1, 1) in that order, so a pair of pixels
+ * always belongs to the same linear row. The kernels below copy whole pairs instead of going
+ * through MortonInterleave for every pixel.
+ */
+constexpr u32 QuadIndex(u32 qx, u32 qy) {
+    return VideoCore::MortonInterleave(qx * 2, qy * 2) / 4;
+}
+
+/// Conversion applied to each 32-bit pixel while copying
+enum class PixelOp {
+    Copy,
+    ByteSwap,    ///< ABGR <-> RGBA
+    RotateLeft,  ///< S8D24 -> D24S8
+    RotateRight, ///< D24S8 -> S8D24
+};
+
+/// Copies a tile of formats that are not converted, one pixel pair at a time.
+template <bool morton_to_linear, u32 bytes_per_pixel>
+void CopyTilePairs(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
+    constexpr u32 pair_size = 2 * bytes_per_pixel;
+    const std::size_t row_pitch = stride * bytes_per_pixel;
+
+    for (u32 qy = 0; qy < 4; qy++) {
+        // The linear buffer is written from the bottom up, see MortonCopy
+        u8* row0 = linear_buffer.data() + (7 - 2 * qy) * row_pitch;
+        u8* row1 = row0 - row_pitch;
+        for (u32 qx = 0; qx < 4; qx++) {
+            u8* quad = tile_buffer.data() + QuadIndex(qx, qy) * 2 * pair_size;
+            if constexpr (morton_to_linear) {
+                std::memcpy(row0 + qx * pair_size, quad, pair_size);
+                std::memcpy(row1 + qx * pair_size, quad + pair_size, pair_size);
+            } else {
+                std::memcpy(quad, row0 + qx * pair_size, pair_size);
+                std::memcpy(quad + pair_size, row1 + qx * pair_size, pair_size);
+            }
+        }
+    }
+}
+
+#if CITRA_ARCH(x86_64)
+
+template <PixelOp op>
+__m128i ApplyOp(__m128i value) {
+    if constexpr (op == PixelOp::ByteSwap) {
+        value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, 0xB1), 0xB1);
+        return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+    } else if constexpr (op == PixelOp::RotateLeft) {
+        return _mm_or_si128(_mm_slli_epi32(value, 8), _mm_srli_epi32(value, 24));
+    } else if constexpr (op == PixelOp::RotateRight) {
+        return _mm_or_si128(_mm_srli_epi32(value, 8), _mm_slli_epi32(value, 24));
+    } else {
+        return value;
+    }
+}
+
+__m128i Load(const u8* source) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+}
+
+void Store(u8* dest, __m128i value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), value);
+}
+
+/// Loads the 12 bytes of a 24-bit quad without reading past the end of the tile
+__m128i Load12(const u8* source) {
+    const __m128i lo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+    return _mm_unpacklo_epi64(lo, _mm_cvtsi32_si128(MakeInt<s32>(source + 8)));
+}
+
+void Store12(u8* dest, __m128i value) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), value);
+    const s32 hi = _mm_cvtsi128_si32(_mm_srli_si128(value, 8));
+    std::memcpy(dest + 8, &hi, sizeof(hi));
+}
+
+/**
+ * Copies a tile of 32-bit pixels. Two quads hold the first two pixels of four linear
+ * pixels in each of their halves.
+ */
+template <bool morton_to_linear, PixelOp op>
+void CopyTile32(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
+    const std::size_t row_pitch = stride * 4;
+
+    for (u32 qy = 0; qy < 4; qy++) {
+        u8* row0 = linear_buffer.data() + (7 - 2 * qy) * row_pitch;
+        u8* row1 = row0 - row_pitch;
+        for (u32 qx = 0; qx < 4; qx += 2) {
+            u8* quads = tile_buffer.data() + QuadIndex(qx, qy) * 16;
+            if constexpr (morton_to_linear) {
+                const __m128i quad0 = Load(quads);
+                const __m128i quad1 = Load(quads + 16);
+                Store(row0 + qx * 8, ApplyOp<op>(_mm_unpacklo_epi64(quad0, quad1)));
+                Store(row1 + qx * 8, ApplyOp<op>(_mm_unpackhi_epi64(quad0, quad1)));
+            } else {
+                const __m128i line0 = Load(row0 + qx * 8);
+                const __m128i line1 = Load(row1 + qx * 8);
+                Store(quads, ApplyOp<op>(_mm_unpacklo_epi64(line0, line1)));
+                Store(quads + 16, ApplyOp<op>(_mm_unpackhi_epi64(line0, line1)));
+            }
+        }
+    }
+}
+
+/**
+ * Copies a tile of 16-bit pixels. A 16 byte load covers two quads, which interleave the pixel
+ * pairs of two rows, so a full row of 8 pixels is gathered from two loads.
+ */
+template <bool morton_to_linear>
+void CopyTile16(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
+    const std::size_t row_pitch = stride * 2;
+
+    for (u32 qy = 0; qy < 4; qy++) {
+        u8* row0 = linear_buffer.data() + (7 - 2 * qy) * row_pitch;
+        u8* row1 = row0 - row_pitch;
+        u8* quads_left = tile_buffer.data() + QuadIndex(0, qy) * 8;
+        u8* quads_right = tile_buffer.data() + QuadIndex(2, qy) * 8;
+        if constexpr (morton_to_linear) {
+            const __m128i left = _mm_shuffle_epi32(Load(quads_left), _MM_SHUFFLE(3, 1, 2, 0));
+            const __m128i right = _mm_shuffle_epi32(Load(quads_right), _MM_SHUFFLE(3, 1, 2, 0));
+            Store(row0, _mm_unpacklo_epi64(left, right));
+            Store(row1, _mm_unpackhi_epi64(left, right));
+        } else {
+            const __m128i line0 = Load(row0);
+            const __m128i line1 = Load(row1);
+            Store(quads_left, _mm_unpacklo_epi32(line0, line1));
+            Store(quads_right, _mm_unpackhi_epi32(line0, line1));
+        }
+    }
+}
+
+/// Copies a tile of RGB8 pixels while converting them to/from RGBA8.
+template <bool morton_to_linear>
+TARGET_SSSE3 void CopyTileRGB8Converted(u32 stride, std::span<u8> tile_buffer,
+                                        std::span<u8> linear_buffer) {
+    const std::size_t row_pitch = stride * 4;
+    const __m128i decode_mask =
+        _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i encode_mask =
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+    for (u32 qy = 0; qy < 4; qy++) {
+        u8* row0 = linear_buffer.data() + (7 - 2 * qy) * row_pitch;
+        u8* row1 = row0 - row_pitch;
+        for (u32 qx = 0; qx < 4; qx += 2) {
+            u8* quads = tile_buffer.data() + QuadIndex(qx, qy) * 12;
+            if constexpr (morton_to_linear) {
+                const __m128i quad0 =
+                    _mm_or_si128(_mm_shuffle_epi8(Load12(quads), decode_mask), alpha);
+                const __m128i quad1 =
+                    _mm_or_si128(_mm_shuffle_epi8(Load12(quads + 12), decode_mask), alpha);
+                Store(row0 + qx * 8, _mm_unpacklo_epi64(quad0, quad1));
+                Store(row1 + qx * 8, _mm_unpackhi_epi64(quad0, quad1));
+            } else {
+                const __m128i line0 = Load(row0 + qx * 8);
+                const __m128i line1 = Load(row1 + qx * 8);
+                Store12(quads, _mm_shuffle_epi8(_mm_unpacklo_epi64(line0, line1), encode_mask));
+                Store12(quads + 12,
+                        _mm_shuffle_epi8(_mm_unpackhi_epi64(line0, line1), encode_mask));
+            }
+        }
+    }
+}
+
+#elif CITRA_ARCH(arm64)
+
+template <PixelOp op>
+uint8x16_t ApplyOp(uint8x16_t value) {
+    if constexpr (op == PixelOp::ByteSwap) {
+        return vrev32q_u8(value);
+    } else if constexpr (op == PixelOp::RotateLeft) {
+        const uint32x4_t words = vreinterpretq_u32_u8(value);
+        return vreinterpretq_u8_u32(vsriq_n_u32(vshlq_n_u32(words, 8), words, 24));
+    } else if constexpr (op == PixelOp::RotateRight) {
+        const uint32x4_t words = vreinterpretq_u32_u8(value);
+        return vreinterpretq_u8_u32(vsliq_n_u32(vshrq_n_u32(words, 8), words, 24));
+    } else {
+        return value;
+    }
+}
+
+uint8x16_t ZipLo64(uint8x16_t a, uint8x16_t b) {
+    return vreinterpretq_u8_u64(vzip1q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+}
+
+uint8x16_t ZipHi64(uint8x16_t a, uint8x16_t b) {
+    return vreinterpretq_u8_u64(vzip2q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+}
+
+/**
+ * Copies a tile of 32-bit pixels. Two quads hold the first two pixels of four linear
+ * pixels in each of their halves.
+ */
+template <bool morton_to_linear, PixelOp op>
+void CopyTile32(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
+    const std::size_t row_pitch = stride * 4;
+
+    for (u32 qy = 0; qy < 4; qy++) {
+        u8* row0 = linear_buffer.data() + (7 - 2 * qy) * row_pitch;
+        u8* row1 = row0 - row_pitch;
+        for (u32 qx = 0; qx < 4; qx += 2) {
+            u8* quads = tile_buffer.data() + QuadIndex(qx, qy) * 16;
+            if constexpr (morton_to_linear) {
+                const uint8x16_t quad0 = vld1q_u8(quads);
+                const uint8x16_t quad1 = vld1q_u8(quads + 16);
+                vst1q_u8(row0 + qx * 8, ApplyOp<op>(ZipLo64(quad0, quad1)));
+                vst1q_u8(row1 + qx * 8, ApplyOp<op>(ZipHi64(quad0, quad1)));
+            } else {
+                const uint8x16_t line0 = vld1q_u8(row0 + qx * 8);
+                const uint8x16_t line1 = vld1q_u8(row1 + qx * 8);
+                vst1q_u8(quads, ApplyOp<op>(ZipLo64(line0, line1)));
+                vst1q_u8(quads + 16, ApplyOp<op>(ZipHi64(line0, line1)));
+            }
+        }
+    }
+}
+
+/**
+ * Copies a tile of 16-bit pixels. A 16 byte load covers two quads, which interleave the pixel
+ * pairs of two rows, so a full row of 8 pixels is gathered from two loads.
+ */
+template <bool morton_to_linear>
+void CopyTile16(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
+    const std::size_t row_pitch = stride * 2;
+
+    for (u32 qy = 0; qy < 4; qy++) {
+        u8* row0 = linear_buffer.data() + (7 - 2 * qy) * row_pitch;
+        u8* row1 = row0 - row_pitch;
+        u8* quads_left = tile_buffer.data() + QuadIndex(0, qy) * 8;
+        u8* quads_right = tile_buffer.data() + QuadIndex(2, qy) * 8;
+        if constexpr (morton_to_linear) {
+            const uint32x4_t left = vreinterpretq_u32_u8(vld1q_u8(quads_left));
+            const uint32x4_t right = vreinterpretq_u32_u8(vld1q_u8(quads_right));
+            vst1q_u8(row0, vreinterpretq_u8_u32(vuzp1q_u32(left, right)));
+            vst1q_u8(row1, vreinterpretq_u8_u32(vuzp2q_u32(left, right)));
+        } else {
+            const uint32x4_t line0 = vreinterpretq_u32_u8(vld1q_u8(row0));
+            const uint32x4_t line1 = vreinterpretq_u32_u8(vld1q_u8(row1));
+            vst1q_u8(quads_left, vreinterpretq_u8_u32(vzip1q_u32(line0, line1)));
+            vst1q_u8(quads_right, vreinterpretq_u8_u32(vzip2q_u32(line0, line1)));
+        }
+    }
+}
+
+/// Copies a tile of RGB8 pixels while converting them to/from RGBA8.
+template <bool morton_to_linear>
+void CopyTileRGB8Converted(u32 stride, std::span<u8> tile_buffer, std::span<u8> linear_buffer) {
+    const std::size_t row_pitch = stride * 4;
+    alignas(16) std::array<u8, 32> quads_rgba;
+
+    for (u32 qy = 0; qy < 4; qy++) {
+        u8* row0 = linear_buffer.data() + (7 - 2 * qy) * row_pitch;
+        u8* row1 = row0 - row_pitch;
+        for (u32 qx = 0; qx < 4; qx += 2) {
+            u8* quads = tile_buffer.data() + QuadIndex(qx, qy) * 12;
+            if constexpr (morton_to_linear) {
+                const uint8x8x3_t bgr = vld3_u8(quads);
+                const uint8x8x4_t rgba = {bgr.val[2], bgr.val[1], bgr.val[0], vdup_n_u8(0xFF)};
+                vst4_u8(quads_rgba.data(), rgba);
+                const uint8x16_t quad0 = vld1q_u8(quads_rgba.data());
+                const uint8x16_t quad1 = vld1q_u8(quads_rgba.data() + 16);
+                vst1q_u8(row0 + qx * 8, ZipLo64(quad0, quad1));
+                vst1q_u8(row1 + qx * 8, ZipHi64(quad0, quad1));
+            } else {
+                const uint8x16_t line0 = vld1q_u8(row0 + qx * 8);
+                const uint8x16_t line1 = vld1q_u8(row1 + qx * 8);
+                vst1q_u8(quads_rgba.data(), ZipLo64(line0, line1));
+                vst1q_u8(quads_rgba.data() + 16, ZipHi64(line0, line1));
+                const uint8x8x4_t rgba = vld4_u8(quads_rgba.data());
+                const uint8x8x3_t bgr = {rgba.val[2], rgba.val[1], rgba.val[0]};
+                vst3_u8(quads, bgr);
+            }
+        }
+    }
+}
+
+#endif
+
+template <bool morton_to_linear, PixelFormat format, bool converted, auto CopyTile>
+constexpr MortonFunc MakeMortonFunc() {
+    return MortonCopy<morton_to_linear, format, converted, CopyTile>;
+}
+
+template <bool morton_to_linear>
+MortonFunc SelectMortonFunc(PixelFormat format, bool converted) {
+    constexpr bool decode = morton_to_linear;
+    switch (format) {
+    case PixelFormat::RGB8:
+        if (!converted) {
+            return MakeMortonFunc<decode, PixelFormat::RGB8, false, CopyTilePairs<decode, 3>>();
+        }
+#if CITRA_ARCH(x86_64)
+        if (!Common::GetCPUCaps().ssse3) {
+            return nullptr;
+        }
+#endif
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+        return MakeMortonFunc<decode, PixelFormat::RGB8, true, CopyTileRGB8Converted<decode>>();
+#else
+        return nullptr;
+#endif
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    case PixelFormat::RGBA8:
+        if (converted) {
+            return MakeMortonFunc<decode, PixelFormat::RGBA8, true,
+                                  CopyTile32<decode, PixelOp::ByteSwap>>();
+        }
+        return MakeMortonFunc<decode, PixelFormat::RGBA8, false, CopyTile32<decode, PixelOp::Copy>>();
+    case PixelFormat::D24S8: {
+        if (converted) {
+            return nullptr;
+        }
+        constexpr PixelOp op = decode ? PixelOp::RotateLeft : PixelOp::RotateRight;
+        return MakeMortonFunc<decode, PixelFormat::D24S8, false, CopyTile32<decode, op>>();
+    }
+    case PixelFormat::RGB5A1:
+        return converted ? nullptr
+                         : MakeMortonFunc<decode, PixelFormat::RGB5A1, false, CopyTile16<decode>>();
+    case PixelFormat::RGB565:
+        return converted ? nullptr
+                         : MakeMortonFunc<decode, PixelFormat::RGB565, false, CopyTile16<decode>>();
+    case PixelFormat::RGBA4:
+        return converted ? nullptr
+                         : MakeMortonFunc<decode, PixelFormat::RGBA4, false, CopyTile16<decode>>();
+    case PixelFormat::D16:
+        return converted ? nullptr
+                         : MakeMortonFunc<decode, PixelFormat::D16, false, CopyTile16<decode>>();
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+template <bool morton_to_linear>
+std::array<MortonFunc, PIXEL_FORMAT_COUNT> BuildTable(bool converted) {
+    std::array<MortonFunc, PIXEL_FORMAT_COUNT> table{};
+    for (std::size_t i = 0; i < table.size(); i++) {
+        table[i] = SelectMortonFunc<morton_to_linear>(static_cast<PixelFormat>(i), converted);
+    }
+    return table;
+}
+
+} // Anonymous namespace
+
+MortonFunc GetVectorMortonFunc(bool morton_to_linear, PixelFormat format, bool converted) {
+    // The CPU features are queried once, the first time a tiled surface is copied
+    static const std::array<std::array<MortonFunc, PIXEL_FORMAT_COUNT>, 4> tables = {
+        BuildTable<false>(false),
+        BuildTable<false>(true),
+        BuildTable<true>(false),
+        BuildTable<true>(true),
+    };
+    const std::size_t index = static_cast<std::size_t>(format);
+    if (index >= PIXEL_FORMAT_COUNT) {
+        return nullptr;
+    }
+    return tables[morton_to_linear * 2 + converted][index];
+}
+
+} // namespace VideoCore
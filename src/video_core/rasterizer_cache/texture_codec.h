@@ -252,8 +252,11 @@ constexpr void MortonCopyTile(u32 stride, std::span<u8> tile_buffer, std::span<u
  * not required to be aligned to any specific boundary which requires special care.
  * start_offset/end_offset are useful here as they tell us exactly where the data should be placed
  * in the linear_buffer.
+ *
+ * CopyTile converts a single 8x8 tile and defaults to the reference MortonCopyTile implementation.
  */
-template <bool morton_to_linear, PixelFormat format, bool converted = false>
+template <bool morton_to_linear, PixelFormat format, bool converted = false,
+          auto CopyTile = MortonCopyTile<morton_to_linear, format, converted>>
 static constexpr void MortonCopy(u32 width, u32 height, u32 start_offset, u32 end_offset,
                                  std::span<u8> linear_buffer, std::span<u8> tiled_buffer) {
     constexpr u32 bytes_per_pixel = GetFormatBpp(format) / 8;
@@ -296,7 +299,7 @@ static constexpr void MortonCopy(u32 width, u32 height, u32 start_offset, u32 en
     if (start_offset < aligned_start_offset && !morton_to_linear) {
         std::array<u8, tile_size> tmp_buf;
         auto linear_data = linear_buffer.subspan(linear_offset, linear_tile_stride);
-        MortonCopyTile<morton_to_linear, format, converted>(width, tmp_buf, linear_data);
+        CopyTile(width, tmp_buf, linear_data);
 
         std::memcpy(tiled_buffer.data(), tmp_buf.data() + start_offset - aligned_down_start_offset,
                     std::min(aligned_start_offset, end_offset) - start_offset);
@@ -313,7 +316,7 @@ static constexpr void MortonCopy(u32 width, u32 height, u32 start_offset, u32 en
         while (tiled_offset < buffer_end) {
             auto linear_data = linear_buffer.subspan(linear_offset, linear_tile_stride);
             auto tiled_data = tiled_buffer.subspan(tiled_offset, tile_size);
-            MortonCopyTile<morton_to_linear, format, converted>(width, tiled_data, linear_data);
+            CopyTile(width, tiled_data, linear_data);
             tiled_offset += tile_size;
             linear_next_tile();
         }
@@ -324,7 +327,7 @@ static constexpr void MortonCopy(u32 width, u32 height, u32 start_offset, u32 en
     if (end_offset > std::max(aligned_start_offset, aligned_end_offset) && !morton_to_linear) {
         std::array<u8, tile_size> tmp_buf;
         auto linear_data = linear_buffer.subspan(linear_offset, linear_tile_stride);
-        MortonCopyTile<morton_to_linear, format, converted>(width, tmp_buf, linear_data);
+        CopyTile(width, tmp_buf, linear_data);
         std::memcpy(tiled_buffer.data() + tiled_offset, tmp_buf.data(),
                     end_offset - aligned_end_offset);
     }
@@ -372,6 +375,13 @@ static constexpr void LinearCopy(std::span<u8> src_buffer, std::span<u8> dst_buf
 
 using MortonFunc = void (*)(u32, u32, u32, u32, std::span<u8>, std::span<u8>);
 
+/**
+ * Returns a vectorized MortonCopy for the format that is supported by the host CPU, or nullptr
+ * when only the reference implementation in the tables below handles it. The output of both is
+ * identical.
+ */
+MortonFunc GetVectorMortonFunc(bool morton_to_linear, PixelFormat format, bool converted);
+
 static constexpr std::array<MortonFunc, 18> UNSWIZZLE_TABLE = {
     MortonCopy<true, PixelFormat::RGBA8>,  // 0
     MortonCopy<true, PixelFormat::RGB8>,   // 1
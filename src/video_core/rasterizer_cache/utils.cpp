@@ -25,8 +25,10 @@ void EncodeTexture(const SurfaceParams& surface_info, PAddr start_addr, PAddr en
     const u32 func_index = static_cast<u32>(format);
 
     if (surface_info.is_tiled) {
-        const MortonFunc SwizzleImpl =
-            (convert ? SWIZZLE_TABLE_CONVERTED : SWIZZLE_TABLE)[func_index];
+        MortonFunc SwizzleImpl = GetVectorMortonFunc(false, format, convert);
+        if (!SwizzleImpl) {
+            SwizzleImpl = (convert ? SWIZZLE_TABLE_CONVERTED : SWIZZLE_TABLE)[func_index];
+        }
         if (SwizzleImpl) {
             SwizzleImpl(surface_info.width, surface_info.height, start_addr - surface_info.addr,
                         end_addr - surface_info.addr, source, dest);
@@ -52,8 +54,10 @@ void DecodeTexture(const SurfaceParams& surface_info, PAddr start_addr, PAddr en
     const u32 func_index = static_cast<u32>(format);
 
     if (surface_info.is_tiled) {
-        const MortonFunc UnswizzleImpl =
-            (convert ? UNSWIZZLE_TABLE_CONVERTED : UNSWIZZLE_TABLE)[func_index];
+        MortonFunc UnswizzleImpl = GetVectorMortonFunc(true, format, convert);
+        if (!UnswizzleImpl) {
+            UnswizzleImpl = (convert ? UNSWIZZLE_TABLE_CONVERTED : UNSWIZZLE_TABLE)[func_index];
+        }
         if (UnswizzleImpl) {
             UnswizzleImpl(surface_info.width, surface_info.height, start_addr - surface_info.addr,
                           end_addr - surface_info.addr, dest, source);
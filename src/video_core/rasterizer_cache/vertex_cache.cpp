@@ -0,0 +1,224 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include "common/arch.h"
+#include "common/hash.h"
+#include "video_core/rasterizer_cache/vertex_cache.h"
+
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+namespace VideoCore {
+
+namespace {
+
+/// Scans the indices the vector loop left over
+template <typename T>
+void ScanIndicesScalar(const T* indices, u32 begin, u32 count, IndexRange& range) {
+    for (u32 i = begin; i < count; i++) {
+        const u32 index = indices[i];
+        range.min = std::min(range.min, index);
+        range.max = std::max(range.max, index);
+    }
+}
+
+#if CITRA_ARCH(x86_64)
+/// Reduces the lanes of the vector minimum and maximum into range
+template <typename T, std::size_t N>
+void ReduceLanes(__m128i vmin, __m128i vmax, T bias, IndexRange& range) {
+    std::array<T, N> mins;
+    std::array<T, N> maxs;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mins.data()), vmin);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(maxs.data()), vmax);
+    for (std::size_t lane = 0; lane < N; lane++) {
+        range.min = std::min<u32>(range.min, static_cast<T>(mins[lane] ^ bias));
+        range.max = std::max<u32>(range.max, static_cast<T>(maxs[lane] ^ bias));
+    }
+}
+#endif
+
+/// Calls func with the index of every page touched by [addr, addr + size)
+template <typename Func>
+void ForEachPage(PAddr addr, u32 size, Func&& func) {
+    const u64 end = static_cast<u64>(addr) + std::max(size, 1U);
+    for (u64 page = addr >> VertexCache::PAGE_BITS; page <= (end - 1) >> VertexCache::PAGE_BITS;
+         page++) {
+        func(static_cast<u32>(page));
+    }
+}
+
+} // Anonymous namespace
+
+IndexRange ScanIndexRange(const u8* indices, u32 count, bool index_u16) {
+    IndexRange range{0xFFFF, 0};
+    u32 i = 0;
+    if (index_u16) {
+        const u16* indices_16 = reinterpret_cast<const u16*>(indices);
+#if CITRA_ARCH(x86_64)
+        // SSE2 only compares signed words, so flip the sign bit to keep the unsigned order
+        if (count >= 8) {
+            const __m128i bias = _mm_set1_epi16(static_cast<s16>(0x8000));
+            __m128i vmin = _mm_set1_epi16(0x7FFF);
+            __m128i vmax = _mm_set1_epi16(static_cast<s16>(0x8000));
+            for (; i + 8 <= count; i += 8) {
+                const __m128i values = _mm_xor_si128(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices_16 + i)), bias);
+                vmin = _mm_min_epi16(vmin, values);
+                vmax = _mm_max_epi16(vmax, values);
+            }
+            ReduceLanes<u16, 8>(vmin, vmax, 0x8000, range);
+        }
+#elif CITRA_ARCH(arm64)
+        if (count >= 8) {
+            uint16x8_t vmin = vdupq_n_u16(0xFFFF);
+            uint16x8_t vmax = vdupq_n_u16(0);
+            for (; i + 8 <= count; i += 8) {
+                const uint16x8_t values = vld1q_u16(indices_16 + i);
+                vmin = vminq_u16(vmin, values);
+                vmax = vmaxq_u16(vmax, values);
+            }
+            range.min = vminvq_u16(vmin);
+            range.max = vmaxvq_u16(vmax);
+        }
+#endif
+        ScanIndicesScalar(indices_16, i, count, range);
+        return range;
+    }
+
+#if CITRA_ARCH(x86_64)
+    if (count >= 16) {
+        __m128i vmin = _mm_set1_epi8(static_cast<s8>(0xFF));
+        __m128i vmax = _mm_setzero_si128();
+        for (; i + 16 <= count; i += 16) {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+            vmin = _mm_min_epu8(vmin, values);
+            vmax = _mm_max_epu8(vmax, values);
+        }
+        ReduceLanes<u8, 16>(vmin, vmax, 0, range);
+    }
+#elif CITRA_ARCH(arm64)
+    if (count >= 16) {
+        uint8x16_t vmin = vdupq_n_u8(0xFF);
+        uint8x16_t vmax = vdupq_n_u8(0);
+        for (; i + 16 <= count; i += 16) {
+            const uint8x16_t values = vld1q_u8(indices + i);
+            vmin = vminq_u8(vmin, values);
+            vmax = vmaxq_u8(vmax, values);
+        }
+        range.min = vminvq_u8(vmin);
+        range.max = vmaxvq_u8(vmax);
+    }
+#endif
+    ScanIndicesScalar(indices, i, count, range);
+    return range;
+}
+
+std::size_t VertexCache::KeyHash::operator()(const Key& key) const noexcept {
+    const u64 stride = (static_cast<u64>(key.index) << 32) | key.stride;
+    return Common::HashCombine(Common::HashCombine(key.addr, key.size), stride);
+}
+
+VertexCache::VertexCache() = default;
+
+VertexCache::~VertexCache() = default;
+
+std::optional<u64> VertexCache::Find(PAddr addr, u32 size, u32 stride) const {
+    return FindValue(Key{addr, size, stride, false});
+}
+
+std::optional<IndexRange> VertexCache::FindIndexRange(PAddr addr, u32 size, bool index_u16) const {
+    const auto value = FindValue(Key{addr, size, index_u16 ? 2U : 1U, true});
+    if (!value) {
+        return std::nullopt;
+    }
+    return IndexRange{static_cast<u32>(*value), static_cast<u32>(*value >> 32)};
+}
+
+bool VertexCache::Insert(PAddr addr, u32 size, u32 stride, u64 offset) {
+    return InsertValue(Key{addr, size, stride, false}, offset);
+}
+
+bool VertexCache::InsertIndexRange(PAddr addr, u32 size, bool index_u16, IndexRange range) {
+    const u64 value = (static_cast<u64>(range.max) << 32) | range.min;
+    return InsertValue(Key{addr, size, index_u16 ? 2U : 1U, true}, value);
+}
+
+void VertexCache::Reset() {
+    ClearEntries();
+    dynamic_ranges.clear();
+}
+
+std::optional<u64> VertexCache::FindValue(const Key& key) const {
+    const auto it = lookup.find(key);
+    if (it == lookup.end()) {
+        return std::nullopt;
+    }
+    return entries[it->second].value;
+}
+
+bool VertexCache::InsertValue(const Key& key, u64 value) {
+    const auto [it, inserted] = lookup.try_emplace(key, 0);
+    if (!inserted) {
+        entries[it->second].value = value;
+        return false;
+    }
+
+    u32 entry_id;
+    if (free_slots.empty()) {
+        entry_id = static_cast<u32>(entries.size());
+        entries.emplace_back();
+    } else {
+        entry_id = free_slots.back();
+        free_slots.pop_back();
+    }
+    entries[entry_id] = Entry{
+        .addr = key.addr,
+        .size = key.size,
+        .stride = key.stride,
+        .index = key.index,
+        .value = value,
+        .frame = frame,
+    };
+    it->second = entry_id;
+    num_entries++;
+    ForEachPage(key.addr, key.size, [&](u32 page) { pages[page].push_back(entry_id); });
+    return true;
+}
+
+void VertexCache::Erase(u32 entry_id) {
+    Entry& entry = entries[entry_id];
+    ForEachPage(entry.addr, entry.size, [&](u32 page) {
+        const auto it = pages.find(page);
+        std::erase(it->second, entry_id);
+        if (it->second.empty()) {
+            pages.erase(it);
+        }
+    });
+    lookup.erase(Key{entry.addr, entry.size, entry.stride, entry.index});
+    entry.size = 0;
+    free_slots.push_back(entry_id);
+    num_entries--;
+}
+
+void VertexCache::ClearEntries() {
+    entries.clear();
+    free_slots.clear();
+    num_entries = 0;
+    lookup.clear();
+    pages.clear();
+}
+
+void VertexCache::MarkDynamic(PAddr addr) {
+    if (dynamic_ranges.size() >= MAX_DYNAMIC_RANGES) {
+        dynamic_ranges.clear();
+    }
+    dynamic_ranges.insert(addr);
+}
+
+} // namespace VideoCore
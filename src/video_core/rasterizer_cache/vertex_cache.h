@@ -0,0 +1,181 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/// Smallest and largest vertex index referenced by an index array
+struct IndexRange {
+    u32 min;
+    u32 max;
+
+    bool operator==(const IndexRange&) const = default;
+};
+
+/**
+ * Scans count indices of one or two bytes for their smallest and largest values, with SIMD where
+ * available. Returns {0xFFFF, 0} when count is zero.
+ */
+[[nodiscard]] IndexRange ScanIndexRange(const u8* indices, u32 count, bool index_u16);
+
+/**
+ * Bookkeeping of the vertex arrays whose guest data has a copy in a backend buffer, keyed by the
+ * guest range and the stride of the copy. The cache does not own any buffer: the backend uploads
+ * the data on a miss and registers the offset of its copy, the owner drops the entries overlapping
+ * the regions the CPU or the GPU write to. Ranges that are rewritten within a few frames of being
+ * cached are considered dynamic and are streamed from then on, so that they do not pay for write
+ * tracking. The index ranges of index arrays are remembered the same way, so that draws do not
+ * scan unchanged indices again.
+ */
+class VertexCache {
+public:
+    /// Address shift for bucketing entries into pages
+    static constexpr u32 PAGE_BITS = 14;
+
+    /// Entries rewritten before being this many frames old mark their range as dynamic
+    static constexpr u64 DYNAMIC_FRAMES = 8;
+
+    /// Maximum number of dynamic ranges remembered before forgetting all of them
+    static constexpr std::size_t MAX_DYNAMIC_RANGES = 4096;
+
+    VertexCache();
+    ~VertexCache();
+
+    /// Returns the buffer offset of the copy of [addr, addr + size) at stride, if there is one
+    [[nodiscard]] std::optional<u64> Find(PAddr addr, u32 size, u32 stride) const;
+
+    /// Returns the index range of the index array at [addr, addr + size), if it was registered
+    [[nodiscard]] std::optional<IndexRange> FindIndexRange(PAddr addr, u32 size,
+                                                           bool index_u16) const;
+
+    /// Returns true when the data starting at addr was found to be rewritten often
+    [[nodiscard]] bool IsDynamic(PAddr addr) const {
+        return dynamic_ranges.contains(addr);
+    }
+
+    /**
+     * Registers the copy of [addr, addr + size) at stride living at offset of the backend buffer.
+     * @returns false if the range was already registered, in which case only its offset changes
+     */
+    bool Insert(PAddr addr, u32 size, u32 stride, u64 offset);
+
+    /**
+     * Registers the index range of the index array at [addr, addr + size).
+     * @returns false if the array was already registered, in which case only its range changes
+     */
+    bool InsertIndexRange(PAddr addr, u32 size, bool index_u16, IndexRange range);
+
+    /**
+     * Removes the entries overlapping [addr, addr + size), calling func with the address and
+     * size of every removed entry.
+     */
+    template <typename Func>
+    void Invalidate(PAddr addr, u32 size, Func&& func) {
+        if (size == 0 || num_entries == 0) {
+            return;
+        }
+        const u64 end = static_cast<u64>(addr) + size;
+        for (u64 page = addr >> PAGE_BITS; page <= (end - 1) >> PAGE_BITS; page++) {
+            const auto it = pages.find(static_cast<u32>(page));
+            if (it == pages.end()) {
+                continue;
+            }
+            // Erasing entries modifies the bucket, so work on a copy of it
+            removed.assign(it->second.begin(), it->second.end());
+            for (const u32 entry_id : removed) {
+                const Entry& entry = entries[entry_id];
+                if (entry.size == 0 || entry.addr >= end ||
+                    addr >= static_cast<u64>(entry.addr) + entry.size) {
+                    continue;
+                }
+                func(entry.addr, entry.size);
+                if (frame - entry.frame < DYNAMIC_FRAMES) {
+                    MarkDynamic(entry.addr);
+                }
+                Erase(entry_id);
+            }
+        }
+    }
+
+    /**
+     * Removes the copies of vertex data, calling func with the address and size of every one of
+     * them. Index ranges do not depend on the backend buffer and are kept.
+     */
+    template <typename Func>
+    void Clear(Func&& func) {
+        for (u32 entry_id = 0; entry_id < entries.size(); entry_id++) {
+            const Entry& entry = entries[entry_id];
+            if (entry.size != 0 && !entry.index) {
+                func(entry.addr, entry.size);
+                Erase(entry_id);
+            }
+        }
+    }
+
+    /// Forgets the dynamic ranges as well, for when the guest memory is replaced
+    void Reset();
+
+    /// Advances the frame counter used to detect dynamic ranges
+    void TickFrame() noexcept {
+        frame++;
+    }
+
+    /// Returns the number of cached vertex arrays and index ranges
+    [[nodiscard]] std::size_t Size() const noexcept {
+        return num_entries;
+    }
+
+private:
+    struct Key {
+        PAddr addr;
+        u32 size;
+        u32 stride; ///< Size of an index for index arrays
+        bool index;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept;
+    };
+
+    struct Entry {
+        PAddr addr;
+        u32 size; ///< Zero for free slots
+        u32 stride;
+        bool index;
+        u64 value; ///< Buffer offset of vertex copies, packed range of index arrays
+        u64 frame;
+    };
+
+    [[nodiscard]] std::optional<u64> FindValue(const Key& key) const;
+
+    bool InsertValue(const Key& key, u64 value);
+
+    /// Removes the entry from the lookup table and its pages
+    void Erase(u32 entry_id);
+
+    /// Removes every entry without looking at them
+    void ClearEntries();
+
+    void MarkDynamic(PAddr addr);
+
+    std::vector<Entry> entries;
+    std::vector<u32> free_slots;
+    std::size_t num_entries{};
+    std::unordered_map<Key, u32, KeyHash> lookup;
+    std::unordered_map<u32, std::vector<u32>> pages; ///< Entries touching every page
+    std::unordered_set<PAddr> dynamic_ranges;
+    std::vector<u32> removed;
+    u64 frame{};
+};
+
+} // namespace VideoCore
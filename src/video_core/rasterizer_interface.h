@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <functional>
+#include <utility>
 #include "common/common_types.h"
 
 namespace Pica {
@@ -28,6 +29,14 @@ enum class LoadCallbackStage {
 };
 using DiskResourceLoadCallback = std::function<void(LoadCallbackStage, std::size_t, std::size_t)>;
 
+/// Counters of the pipeline cache since the rasterizer was created. OpenGL tracks its fragment
+/// shaders, the part of the pipeline generated from PICA state.
+struct PipelineCacheStats {
+    u64 lookups;        ///< Pipelines requested by draws
+    u64 hits;           ///< Requests that found the pipeline already created
+    u64 compile_stalls; ///< Draws that waited for or skipped a pipeline still compiling
+};
+
 class RasterizerInterface {
 public:
     virtual ~RasterizerInterface() = default;
@@ -39,6 +48,9 @@ public:
     /// Draw the current batch of triangles
     virtual void DrawTriangles() = 0;
 
+    /// Draws the triangles still batched by DrawTriangles, before the state they use changes
+    virtual void FlushTriangles() {}
+
     /// Notify rasterizer that the specified PICA register has been changed
     virtual void NotifyPicaRegisterChanged(u32 id) = 0;
 
@@ -82,5 +94,14 @@ public:
                                    [[maybe_unused]] const DiskResourceLoadCallback& callback) {}
 
     virtual void SyncEntireState() {}
+
+    /// Returns the memory in bytes occupied by cached textures and their budget (0 if unknown)
+    virtual std::pair<u64, u64> GetTextureMemory() const {
+        return {};
+    }
+
+    virtual PipelineCacheStats GetPipelineCacheStats() const {
+        return {};
+    }
 };
 } // namespace VideoCore
@@ -4,6 +4,7 @@
 
 #include "common/settings.h"
 #include "core/core.h"
+#include "core/dumping/backend.h"
 #include "core/frontend/emu_window.h"
 #include "core/tracer/recorder.h"
 #include "video_core/debug_utils/debug_utils.h"
@@ -29,6 +30,28 @@ u32 RendererBase::GetResolutionScaleFactor() {
                              : render_window.GetFramebufferLayout().GetScalingRatio();
 }
 
+u32 RendererBase::GetRenderScaleFactor() {
+    const u32 scale_factor = GetResolutionScaleFactor();
+    if (!Settings::values.dynamic_resolution.GetValue()) {
+        return scale_factor;
+    }
+    return dynamic_resolution.Scale(scale_factor);
+}
+
+void RendererBase::UpdateDynamicResolution(std::chrono::nanoseconds gpu_time) {
+    if (!Settings::values.dynamic_resolution.GetValue()) {
+        dynamic_resolution.Reset();
+        return;
+    }
+    const u32 scale_factor = GetResolutionScaleFactor();
+    const u32 previous_scale = dynamic_resolution.Scale(scale_factor);
+    const std::chrono::milliseconds target{Settings::values.dynamic_resolution_target.GetValue()};
+    const u32 scale = dynamic_resolution.Update(gpu_time, target, scale_factor);
+    if (scale != previous_scale) {
+        LOG_DEBUG(Render, "Dynamic resolution changed the render scale to {}x", scale);
+    }
+}
+
 void RendererBase::UpdateCurrentFramebufferLayout(bool is_portrait_mode) {
     const auto update_layout = [is_portrait_mode](Frontend::EmuWindow& window) {
         const Layout::FramebufferLayout& layout = window.GetFramebufferLayout();
@@ -44,6 +67,13 @@ void RendererBase::EndFrame() {
     current_frame++;
 
     system.perf_stats->EndSystemFrame();
+    system.EndFrame();
+
+    const auto [texture_usage, texture_budget] = Rasterizer()->GetTextureMemory();
+    system.perf_stats->SetTextureMemory(texture_usage, texture_budget);
+    const auto pipeline_stats = Rasterizer()->GetPipelineCacheStats();
+    system.perf_stats->SetPipelineCacheStats(pipeline_stats.lookups, pipeline_stats.hits,
+                                             pipeline_stats.compile_stalls);
 
     render_window.PollEvents();
 
@@ -55,6 +85,21 @@ bool RendererBase::IsScreenshotPending() const {
     return settings.screenshot_requested;
 }
 
+bool RendererBase::IsTurboSkippedFrame() const {
+    const u32 interval = Settings::values.turbo_present_interval.GetValue();
+    const u16 frame_limit = Settings::values.frame_limit.GetValue();
+    if (interval <= 1 || (frame_limit != 0 && frame_limit <= 200)) {
+        return false;
+    }
+
+    // Screenshots and video dumps need the frame to be drawn
+    const auto video_dumper = system.GetVideoDumper();
+    if (IsScreenshotPending() || (video_dumper && video_dumper->IsDumping())) {
+        return false;
+    }
+    return current_frame % interval != 0;
+}
+
 void RendererBase::RequestScreenshot(void* data, std::function<void(bool)> callback,
                                      const Layout::FramebufferLayout& layout) {
     if (settings.screenshot_requested) {
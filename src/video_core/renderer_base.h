@@ -6,6 +6,7 @@
 
 #include "common/common_types.h"
 #include "core/frontend/framebuffer_layout.h"
+#include "video_core/dynamic_resolution.h"
 #include "video_core/rasterizer_interface.h"
 
 namespace Frontend {
@@ -63,12 +64,19 @@ public:
     /// Synchronizes fixed function renderer state
     virtual void Sync() {}
 
+    /// Blocks until the host GPU has finished all work submitted so far
+    virtual void WaitIdle() {}
+
     /// This is called to notify the rendering backend of a surface change
     virtual void NotifySurfaceChanged() {}
 
     /// Returns the resolution scale factor relative to the native 3DS screen resolution
     u32 GetResolutionScaleFactor();
 
+    /// Returns the scale new render targets are created at, which dynamic resolution may lower
+    /// below the resolution scale factor
+    u32 GetRenderScaleFactor();
+
     /// Updates the framebuffer layout of the contained render window handle.
     void UpdateCurrentFramebufferLayout(bool is_portrait_mode = {});
 
@@ -102,17 +110,24 @@ public:
     /// Returns true if a screenshot is being processed
     [[nodiscard]] bool IsScreenshotPending() const;
 
+    /// Returns true if turbo mode skips the presentation of the current frame
+    [[nodiscard]] bool IsTurboSkippedFrame() const;
+
     /// Request a screenshot of the next frame
     void RequestScreenshot(void* data, std::function<void(bool)> callback,
                            const Layout::FramebufferLayout& layout);
 
 protected:
+    /// Feeds the GPU time of a frame to dynamic resolution, called before ticking the rasterizer
+    void UpdateDynamicResolution(std::chrono::nanoseconds gpu_time);
+
     Core::System& system;
     RendererSettings settings;
     Frontend::EmuWindow& render_window;    ///< Reference to the render window handle.
     Frontend::EmuWindow* secondary_window; ///< Reference to the secondary render window handle.
     f32 current_fps = 0.0f;                ///< Current framerate, should be set by the renderer
     s32 current_frame = 0;                 ///< Current frame, should be set by the renderer
+    DynamicResolution dynamic_resolution;
 };
 
 } // namespace VideoCore
@@ -4,6 +4,7 @@
 
 #include <glad/glad.h>
 
+#include <cstring>
 #include <utility>
 
 #include "core/core.h"
@@ -72,7 +73,8 @@ void FrameDumperOpenGL::PresentLoop(std::stop_token stop_token) {
             glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[next_pbo].handle);
             GLubyte* pixels =
                 static_cast<GLubyte*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
-            VideoDumper::VideoFrame frame_data{layout.width, layout.height, pixels};
+            auto frame_data = video_dumper->AcquireVideoFrame(layout.width, layout.height);
+            std::memcpy(frame_data.data.data(), pixels, frame_data.data.size());
             video_dumper->AddVideoFrame(std::move(frame_data));
             glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
             glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
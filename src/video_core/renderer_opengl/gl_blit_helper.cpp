@@ -4,6 +4,7 @@
 
 #include "common/scope_exit.h"
 #include "common/settings.h"
+#include "video_core/gpu_profiler.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/renderer_opengl/gl_blit_helper.h"
 #include "video_core/renderer_opengl/gl_driver.h"
@@ -13,6 +14,7 @@
 #include "video_core/host_shaders/format_reinterpreter/d24s8_to_rgba8_frag.h"
 #include "video_core/host_shaders/format_reinterpreter/rgba4_to_rgb5a1_frag.h"
 #include "video_core/host_shaders/full_screen_triangle_vert.h"
+#include "video_core/host_shaders/texture_decode_comp.h"
 #include "video_core/host_shaders/texture_filtering/bicubic_frag.h"
 #include "video_core/host_shaders/texture_filtering/mmpx_frag.h"
 #include "video_core/host_shaders/texture_filtering/refine_frag.h"
@@ -51,10 +53,20 @@ OGLProgram CreateProgram(std::string_view frag) {
     return program;
 }
 
+OGLProgram CreateComputeProgram(std::string_view comp) {
+    OGLShader shader;
+    shader.Create(comp, GL_COMPUTE_SHADER);
+
+    OGLProgram program;
+    const std::array shaders{shader.handle};
+    program.Create(false, shaders);
+    return program;
+}
+
 } // Anonymous namespace
 
-BlitHelper::BlitHelper(const Driver& driver_)
-    : driver{driver_}, linear_sampler{CreateSampler(GL_LINEAR)},
+BlitHelper::BlitHelper(const Driver& driver_, VideoCore::GpuProfiler& gpu_profiler_)
+    : driver{driver_}, gpu_profiler{gpu_profiler_}, linear_sampler{CreateSampler(GL_LINEAR)},
       nearest_sampler{CreateSampler(GL_NEAREST)}, bicubic_program{CreateProgram(
                                                       HostShaders::BICUBIC_FRAG)},
       scale_force_program{CreateProgram(HostShaders::SCALE_FORCE_FRAG)},
@@ -64,9 +76,11 @@ BlitHelper::BlitHelper(const Driver& driver_)
       gradient_y_program{CreateProgram(HostShaders::Y_GRADIENT_FRAG)},
       refine_program{CreateProgram(HostShaders::REFINE_FRAG)},
       d24s8_to_rgba8{CreateProgram(HostShaders::D24S8_TO_RGBA8_FRAG)},
-      rgba4_to_rgb5a1{CreateProgram(HostShaders::RGBA4_TO_RGB5A1_FRAG)} {
+      rgba4_to_rgb5a1{CreateProgram(HostShaders::RGBA4_TO_RGB5A1_FRAG)},
+      texture_decode{CreateComputeProgram(HostShaders::TEXTURE_DECODE_COMP)} {
     vao.Create();
     draw_fbo.Create();
+    decode_buffer.Create();
     state.draw.vertex_array = vao.handle;
     for (u32 i = 0; i < 3; i++) {
         state.texture_units[i].sampler = i == 2 ? nearest_sampler.handle : linear_sampler.handle;
@@ -155,6 +169,37 @@ bool BlitHelper::ConvertRGBA4ToRGB5A1(Surface& source, Surface& dest,
     return true;
 }
 
+void BlitHelper::DecodeTiled(Surface& surface, const VideoCore::BufferTextureCopy& upload,
+                             std::span<const u8> data) {
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    SCOPE_EXIT({ prev_state.Apply(); });
+
+    state.draw.shader_program = texture_decode.handle;
+    state.Apply();
+
+    // Orphan the previous contents, the driver takes care of keeping them alive until used.
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, decode_buffer.handle);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(data.size()), data.data(),
+                 GL_STREAM_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, decode_buffer.handle);
+    glBindImageTexture(ImageUnits::TextureDecode, surface.Handle(0), upload.texture_level,
+                       GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+    const auto rect = upload.texture_rect;
+    glProgramUniform2i(texture_decode.handle, 0, static_cast<GLint>(rect.left),
+                       static_cast<GLint>(rect.bottom));
+    glProgramUniform2i(texture_decode.handle, 1, static_cast<GLint>(rect.GetWidth()),
+                       static_cast<GLint>(rect.GetHeight()));
+    glProgramUniform1ui(texture_decode.handle, 2, 0);
+    glProgramUniform1ui(texture_decode.handle, 3, static_cast<GLuint>(surface.pixel_format));
+    glDispatchCompute(rect.GetWidth() / 8, rect.GetHeight() / 8, 1);
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                    GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+    glBindImageTexture(ImageUnits::TextureDecode, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+}
+
 bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
     const auto filter = Settings::values.texture_filter.GetValue();
     const bool is_depth =
@@ -166,6 +211,7 @@ bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
         return true;
     }
 
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Filter};
     switch (filter) {
     case TextureFilter::Anime4K:
         FilterAnime4K(surface, blit);
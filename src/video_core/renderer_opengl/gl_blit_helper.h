@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <span>
 #include "common/math_util.h"
 #include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
@@ -11,6 +12,7 @@
 
 namespace VideoCore {
 struct Extent;
+class GpuProfiler;
 struct TextureBlit;
 struct TextureCopy;
 } // namespace VideoCore
@@ -22,7 +24,7 @@ class Surface;
 
 class BlitHelper {
 public:
-    explicit BlitHelper(const Driver& driver);
+    explicit BlitHelper(const Driver& driver, VideoCore::GpuProfiler& gpu_profiler);
     ~BlitHelper();
 
     bool Filter(Surface& surface, const VideoCore::TextureBlit& blit);
@@ -31,6 +33,10 @@ public:
 
     bool ConvertRGBA4ToRGB5A1(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
+    /// Decodes the raw tiled PICA data to the upload rectangle of the RGBA8 surface
+    void DecodeTiled(Surface& surface, const VideoCore::BufferTextureCopy& upload,
+                     std::span<const u8> data);
+
 private:
     void FilterAnime4K(Surface& surface, const VideoCore::TextureBlit& blit);
     void FilterBicubic(Surface& surface, const VideoCore::TextureBlit& blit);
@@ -45,6 +51,7 @@ private:
 
 private:
     const Driver& driver;
+    VideoCore::GpuProfiler& gpu_profiler;
     OGLVertexArray vao;
     OpenGLState state;
     OGLFramebuffer draw_fbo;
@@ -60,6 +67,8 @@ private:
     OGLProgram refine_program;
     OGLProgram d24s8_to_rgba8;
     OGLProgram rgba4_to_rgb5a1;
+    OGLProgram texture_decode;
+    OGLBuffer decode_buffer;
 
     OGLTexture temp_tex;
     VideoCore::Extent temp_extent{};
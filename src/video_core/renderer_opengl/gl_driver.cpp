@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <cstring>
 #include <glad/glad.h>
 #include "common/assert.h"
 #include "common/settings.h"
@@ -84,6 +86,7 @@ Driver::Driver() {
     DeduceGLES();
     DeduceVendor();
     CheckExtensionSupport();
+    QueryVideoMemory();
     FindBugs();
 }
 
@@ -178,6 +181,48 @@ void Driver::CheckExtensionSupport() {
     intel_fragment_shader_ordering = GLAD_GL_INTEL_fragment_shader_ordering;
     blend_minmax_factor = GLAD_GL_AMD_blend_minmax_factor || GLAD_GL_NV_blend_minmax_factor;
     is_suitable = GLAD_GL_VERSION_4_3 || GLAD_GL_ES_VERSION_3_1;
+
+    // glad is not generated with the parallel shader compile extensions, look them up directly
+    GLint num_extensions;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+    for (GLuint index = 0; index < static_cast<GLuint>(num_extensions); ++index) {
+        const auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, index));
+        if (!std::strcmp(name, "GL_KHR_parallel_shader_compile") ||
+            !std::strcmp(name, "GL_ARB_parallel_shader_compile")) {
+            parallel_shader_compile = true;
+            break;
+        }
+    }
+}
+
+void Driver::QueryVideoMemory() {
+    // Neither memory info extension is exposed by glad, so their tokens are defined here
+    constexpr GLenum GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX = 0x9047;
+    constexpr GLenum TEXTURE_FREE_MEMORY_ATI = 0x87FC;
+
+    GLint num_extensions;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+    for (GLuint index = 0; index < static_cast<GLuint>(num_extensions); ++index) {
+        const auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, index));
+        // Both extensions report their values in kilobytes
+        if (!std::strcmp(name, "GL_NVX_gpu_memory_info")) {
+            GLint dedicated_kb{};
+            glGetIntegerv(GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &dedicated_kb);
+            video_memory_size = static_cast<u64>(dedicated_kb) * 1024;
+            break;
+        }
+        if (!std::strcmp(name, "GL_ATI_meminfo")) {
+            // The first value is the total free memory of the texture pool
+            std::array<GLint, 4> free_kb{};
+            glGetIntegerv(TEXTURE_FREE_MEMORY_ATI, free_kb.data());
+            video_memory_size = static_cast<u64>(free_kb[0]) * 1024;
+            break;
+        }
+    }
+
+    if (video_memory_size != 0) {
+        LOG_INFO(Render_OpenGL, "Video memory: {} MiB", video_memory_size >> 20);
+    }
 }
 
 void Driver::FindBugs() {
@@ -66,6 +66,11 @@ public:
         return gpu_vendor;
     }
 
+    /// Returns the amount of video memory in bytes reported by the driver, 0 when unknown
+    u64 GetVideoMemorySize() const {
+        return video_memory_size;
+    }
+
     /// Returns true if the an OpenGLES context is used
     bool IsOpenGLES() const noexcept {
         return is_gles;
@@ -131,11 +136,17 @@ public:
         return blend_minmax_factor;
     }
 
+    /// Returns true if the implementation supports (KHR/ARB)_parallel_shader_compile
+    bool HasParallelShaderCompile() const {
+        return parallel_shader_compile;
+    }
+
 private:
     void ReportDriverInfo();
     void DeduceGLES();
     void DeduceVendor();
     void CheckExtensionSupport();
+    void QueryVideoMemory();
     void FindBugs();
 
 private:
@@ -143,6 +154,7 @@ private:
     DriverBug bugs{};
     bool is_suitable{};
     bool is_gles{};
+    u64 video_memory_size{};
 
     bool ext_buffer_storage{};
     bool arb_buffer_storage{};
@@ -157,6 +169,7 @@ private:
     bool nv_fragment_shader_interlock{};
     bool intel_fragment_shader_ordering{};
     bool blend_minmax_factor{};
+    bool parallel_shader_compile{};
 
     std::string_view gl_version{};
     std::string_view gpu_vendor{};
@@ -0,0 +1,47 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/renderer_opengl/gl_driver.h"
+#include "video_core/renderer_opengl/gl_gpu_profiler.h"
+
+namespace OpenGL {
+
+GpuProfiler::GpuProfiler(const Driver& driver) : VideoCore::GpuProfiler{!driver.IsOpenGLES()} {}
+
+GpuProfiler::~GpuProfiler() {
+    for (auto& frame_queries : queries) {
+        if (frame_queries[0] != 0) {
+            glDeleteQueries(MaxTimestamps, frame_queries.data());
+        }
+    }
+}
+
+void GpuProfiler::WriteTimestamp(u32 frame, u32 index) {
+    glQueryCounter(queries[frame][index], GL_TIMESTAMP);
+}
+
+void GpuProfiler::ResetTimestamps(u32 frame) {
+    // Issuing a query again makes its previous result unavailable, nothing to reset
+    if (queries[frame][0] == 0) {
+        glGenQueries(MaxTimestamps, queries[frame].data());
+    }
+}
+
+bool GpuProfiler::ReadTimestamps(u32 frame, std::span<u64> timestamps) {
+    // The queries complete in order, once the last one is available all of them are
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(queries[frame][timestamps.size() - 1], GL_QUERY_RESULT_AVAILABLE,
+                       &available);
+    if (available == GL_FALSE) {
+        return false;
+    }
+    for (std::size_t i = 0; i < timestamps.size(); i++) {
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(queries[frame][i], GL_QUERY_RESULT, &timestamp);
+        timestamps[i] = timestamp;
+    }
+    return true;
+}
+
+} // namespace OpenGL
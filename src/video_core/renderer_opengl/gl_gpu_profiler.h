@@ -0,0 +1,30 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <glad/glad.h>
+#include "video_core/gpu_profiler.h"
+
+namespace OpenGL {
+
+class Driver;
+
+/// Writes the timestamps of the GPU profiler with GL_TIMESTAMP queries, desktop OpenGL only
+class GpuProfiler final : public VideoCore::GpuProfiler {
+public:
+    explicit GpuProfiler(const Driver& driver);
+    ~GpuProfiler() override;
+
+private:
+    void WriteTimestamp(u32 frame, u32 index) override;
+    void ResetTimestamps(u32 frame) override;
+    bool ReadTimestamps(u32 frame, std::span<u64> timestamps) override;
+
+    /// Query objects of every frame slot, created the first time the slot is used
+    std::array<std::array<GLuint, MaxTimestamps>, NumFrames> queries{};
+};
+
+} // namespace OpenGL
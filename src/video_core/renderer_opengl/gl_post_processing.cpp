@@ -0,0 +1,147 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/logging/log.h"
+#include "common/scope_exit.h"
+#include "common/settings.h"
+#include "common/vector_math.h"
+#include "video_core/renderer_opengl/gl_post_processing.h"
+#include "video_core/renderer_opengl/post_processing_opengl.h"
+#include "video_core/renderer_opengl/renderer_opengl.h"
+#include "video_core/shader/generator/glsl_shader_gen.h"
+
+#include "video_core/host_shaders/full_screen_triangle_vert.h"
+
+namespace OpenGL {
+
+PostProcessingChain::PostProcessingChain() {
+    vao.Create();
+    sampler.Create();
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    state.draw.vertex_array = vao.handle;
+    state.texture_units[0].sampler = sampler.handle;
+}
+
+PostProcessingChain::~PostProcessingChain() = default;
+
+void PostProcessingChain::Apply(ScreenInfo& screen_info, std::size_t screen_id,
+                                u32 resolution_scale) {
+    UpdateChain();
+    if (passes.empty()) {
+        return;
+    }
+
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    SCOPE_EXIT({ prev_state.Apply(); });
+
+    // The screens are stored rotated, u goes from the top to the bottom of the texcoords and v
+    // from the left to the right. The passes keep that orientation.
+    const auto& texcoords = screen_info.display_texcoords;
+    GLuint source = screen_info.display_texture;
+    Common::Vec2f tex_scale{texcoords.bottom - texcoords.top, texcoords.right - texcoords.left};
+    Common::Vec2f tex_offset{texcoords.top, texcoords.left};
+    u32 source_width = screen_info.texture.width * resolution_scale;
+    u32 source_height = screen_info.texture.height * resolution_scale;
+
+    auto& screen_targets = targets[screen_id];
+    screen_targets.resize(passes.size());
+    for (std::size_t i = 0; i < passes.size(); i++) {
+        const Program* program = GetProgram(passes[i].shader);
+        if (!program) {
+            continue;
+        }
+
+        const u32 scale = passes[i].scale != 0 ? passes[i].scale : resolution_scale;
+        const u32 width = screen_info.texture.width * scale;
+        const u32 height = screen_info.texture.height * scale;
+        Target& target = screen_targets[i];
+        if (target.width != width || target.height != height) {
+            ResizeTarget(target, width, height);
+        }
+
+        const GLuint handle = program->program.handle;
+        glProgramUniform2f(handle, 0, tex_scale.x, tex_scale.y);
+        glProgramUniform2f(handle, 1, tex_offset.x, tex_offset.y);
+        glProgramUniform4f(handle, program->i_resolution, static_cast<float>(source_width),
+                           static_cast<float>(source_height), 1.0f / source_width,
+                           1.0f / source_height);
+        glProgramUniform4f(handle, program->o_resolution, static_cast<float>(width),
+                           static_cast<float>(height), 1.0f / width, 1.0f / height);
+        glProgramUniform1i(handle, program->layer, screen_id == 1 ? 1 : 0);
+
+        state.draw.shader_program = handle;
+        state.draw.draw_framebuffer = target.framebuffer.handle;
+        state.texture_units[0].texture_2d = source;
+        state.viewport.x = 0;
+        state.viewport.y = 0;
+        state.viewport.width = static_cast<GLsizei>(width);
+        state.viewport.height = static_cast<GLsizei>(height);
+        state.Apply();
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        source = target.texture.handle;
+        tex_scale = {1.0f, 1.0f};
+        tex_offset = {0.0f, 0.0f};
+        source_width = width;
+        source_height = height;
+    }
+    state.texture_units[0].texture_2d = 0;
+
+    if (source != screen_info.display_texture) {
+        screen_info.display_texture = source;
+        screen_info.display_texcoords = Common::Rectangle<f32>(0.f, 0.f, 1.f, 1.f);
+    }
+}
+
+void PostProcessingChain::UpdateChain() {
+    const std::string& setting = Settings::values.pp_shader_chain.GetValue();
+    if (setting == chain_setting) {
+        return;
+    }
+    chain_setting = setting;
+    passes = VideoCore::ParsePostProcessingChain(chain_setting);
+}
+
+PostProcessingChain::Program* PostProcessingChain::GetProgram(const std::string& shader) {
+    auto [it, inserted] = programs.try_emplace(shader);
+    Program& program = it->second;
+    if (!inserted) {
+        return program.program.handle != 0 ? &program : nullptr;
+    }
+
+    const std::string shader_text = GetPostProcessingShaderCode(false, shader);
+    if (shader_text.empty()) {
+        // The failure is remembered so the shader directory isn't searched every frame
+        LOG_ERROR(Render_OpenGL, "Post-processing shader {} could not be loaded", shader);
+        return nullptr;
+    }
+
+    program.program.Create(HostShaders::FULL_SCREEN_TRIANGLE_VERT,
+                           fragment_shader_precision_OES + shader_text);
+    program.i_resolution = glGetUniformLocation(program.program.handle, "i_resolution");
+    program.o_resolution = glGetUniformLocation(program.program.handle, "o_resolution");
+    program.layer = glGetUniformLocation(program.program.handle, "layer");
+    return &program;
+}
+
+void PostProcessingChain::ResizeTarget(Target& target, u32 width, u32 height) {
+    target.texture.Release();
+    target.texture.Create();
+    target.texture.Allocate(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    if (target.framebuffer.handle == 0) {
+        target.framebuffer.Create();
+    }
+
+    state.draw.draw_framebuffer = target.framebuffer.handle;
+    state.Apply();
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           target.texture.handle, 0);
+    target.width = width;
+    target.height = height;
+}
+
+} // namespace OpenGL
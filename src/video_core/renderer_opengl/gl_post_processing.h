@@ -0,0 +1,70 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "video_core/post_processing.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/renderer_opengl/gl_state.h"
+
+namespace OpenGL {
+
+struct ScreenInfo;
+
+/**
+ * Runs the post-processing chain of pp_shader_chain over the emulated screens. Every pass renders
+ * into a target of its output size that is kept across frames, and the program of every shader is
+ * compiled once, so changing the chain back and forth does not compile the shaders again.
+ */
+class PostProcessingChain {
+public:
+    PostProcessingChain();
+    ~PostProcessingChain();
+
+    /**
+     * Runs the passes over the display texture of the screen and replaces it with the output of
+     * the last pass.
+     * @param screen_id Index of the screen, 1 being the right eye of the top screen
+     * @param resolution_scale Internal resolution in multiples of the native one
+     */
+    void Apply(ScreenInfo& screen_info, std::size_t screen_id, u32 resolution_scale);
+
+private:
+    struct Program {
+        OGLProgram program;
+        GLint i_resolution;
+        GLint o_resolution;
+        GLint layer;
+    };
+
+    struct Target {
+        OGLTexture texture;
+        OGLFramebuffer framebuffer;
+        u32 width{};
+        u32 height{};
+    };
+
+    /// Parses the chain again if the setting changed
+    void UpdateChain();
+
+    /// Returns the program of the shader, compiling it on first use, nullptr if it does not exist
+    Program* GetProgram(const std::string& shader);
+
+    void ResizeTarget(Target& target, u32 width, u32 height);
+
+private:
+    OpenGLState state;
+    OGLVertexArray vao;
+    OGLSampler sampler;
+    std::string chain_setting;
+    std::vector<VideoCore::PostProcessingPass> passes;
+    std::unordered_map<std::string, Program> programs;
+    std::array<std::vector<Target>, 3> targets;
+};
+
+} // namespace OpenGL
@@ -8,6 +8,7 @@
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/microprofile.h"
+#include "video_core/gpu_profiler.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/pica_to_gl.h"
@@ -30,6 +31,8 @@ using namespace Common::Literals;
 using namespace Pica::Shader::Generator;
 
 constexpr std::size_t VERTEX_BUFFER_SIZE = 16_MiB;
+constexpr std::size_t VERTEX_CACHE_SIZE = 32_MiB;
+constexpr std::size_t MAX_CACHED_VERTEX_SIZE = VERTEX_CACHE_SIZE / 16;
 constexpr std::size_t INDEX_BUFFER_SIZE = 2_MiB;
 constexpr std::size_t UNIFORM_BUFFER_SIZE = 2_MiB;
 constexpr std::size_t TEXTURE_BUFFER_SIZE = 2_MiB;
@@ -49,6 +52,18 @@ GLenum MakePrimitiveMode(Pica::PipelineRegs::TriangleTopology topology) {
     return GL_TRIANGLES;
 }
 
+/// Returns the input primitive of a geometry shader consuming the given number of vertices.
+GLenum MakeGeometryShaderInputMode(u32 vertices_per_primitive) {
+    switch (vertices_per_primitive) {
+    case 1:
+        return GL_POINTS;
+    case 2:
+        return GL_LINES;
+    default:
+        return GL_TRIANGLES;
+    }
+}
+
 GLenum MakeAttributeType(Pica::PipelineRegs::VertexAttributeFormat format) {
     switch (format) {
     case Pica::PipelineRegs::VertexAttributeFormat::BYTE:
@@ -75,12 +90,15 @@ GLenum MakeAttributeType(Pica::PipelineRegs::VertexAttributeFormat format) {
 
 RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory, Pica::PicaCore& pica,
                                    VideoCore::CustomTexManager& custom_tex_manager,
-                                   VideoCore::RendererBase& renderer, Driver& driver_)
-    : VideoCore::RasterizerAccelerated{memory, pica}, driver{driver_},
-      shader_manager{renderer.GetRenderWindow(), driver, !driver.IsOpenGLES()},
-      runtime{driver, renderer}, res_cache{memory, custom_tex_manager, runtime, regs, renderer},
+                                   VideoCore::RendererBase& renderer, Driver& driver_,
+                                   VideoCore::GpuProfiler& gpu_profiler_, u64 program_id)
+    : VideoCore::RasterizerAccelerated{memory, pica}, driver{driver_}, gpu_profiler{gpu_profiler_},
+      shader_manager{renderer.GetRenderWindow(), driver, !driver.IsOpenGLES(), program_id},
+      runtime{driver, renderer, gpu_profiler},
+      res_cache{memory, custom_tex_manager, runtime, regs, renderer},
       texture_buffer_size{TextureBufferSize()}, vertex_buffer{driver, GL_ARRAY_BUFFER,
                                                               VERTEX_BUFFER_SIZE},
+      vertex_cache_buffer{driver, GL_ARRAY_BUFFER, VERTEX_CACHE_SIZE},
       uniform_buffer{driver, GL_UNIFORM_BUFFER, UNIFORM_BUFFER_SIZE},
       index_buffer{driver, GL_ELEMENT_ARRAY_BUFFER, INDEX_BUFFER_SIZE},
       texture_buffer{driver, GL_TEXTURE_BUFFER, texture_buffer_size}, texture_lf_buffer{
@@ -96,7 +114,7 @@ RasterizerOpenGL::RasterizerOpenGL(Memory::MemorySystem& memory, Pica::PicaCore&
 
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_buffer_alignment);
     uniform_size_aligned_vs_pica =
-        Common::AlignUp<std::size_t>(sizeof(VSPicaUniformData), uniform_buffer_alignment);
+        Common::AlignUp<std::size_t>(sizeof(GSPicaUniformData), uniform_buffer_alignment);
     uniform_size_aligned_vs =
         Common::AlignUp<std::size_t>(sizeof(VSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs =
@@ -199,11 +217,59 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
 
     std::array<bool, 16> enable_attributes{};
 
+    const auto bind_buffer = [this](GLuint handle) {
+        if (state.draw.vertex_buffer != handle) {
+            state.draw.vertex_buffer = handle;
+            state.Apply();
+        }
+    };
+
     for (const auto& loader : vertex_attributes.attribute_loaders) {
         if (loader.component_count == 0 || loader.byte_count == 0) {
             continue;
         }
 
+        const PAddr data_addr =
+            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
+
+        const u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
+        const u32 data_size = loader.byte_count * vertex_num;
+
+        // Source the loader from a copy of unchanged vertex data when possible
+        GLintptr loader_offset = buffer_offset;
+        if (const auto cached_offset =
+                res_cache.FindVertexData(data_addr, data_size, loader.byte_count)) {
+            bind_buffer(vertex_cache_buffer.GetHandle());
+            loader_offset = static_cast<GLintptr>(*cached_offset);
+        } else {
+            res_cache.FlushRegion(data_addr, data_size);
+            const u8* src_ptr = memory.GetPhysicalPointer(data_addr);
+            if (data_size <= MAX_CACHED_VERTEX_SIZE && res_cache.CanCacheVertexData(data_addr)) {
+                bind_buffer(vertex_cache_buffer.GetHandle());
+                auto [cache_ptr, cache_offset, cache_invalidate] =
+                    vertex_cache_buffer.Map(data_size, 4);
+                if (cache_invalidate) {
+                    // The buffer wrapped around over copies that issued draws, including the
+                    // ones of the previous loaders, may still read. Wait for them and start over.
+                    vertex_cache_buffer.Unmap(0);
+                    glFinish();
+                    res_cache.ClearVertexData();
+                    SetupVertexArray(array_ptr, buffer_offset, vs_input_index_min,
+                                     vs_input_index_max);
+                    return;
+                }
+                std::memcpy(cache_ptr, src_ptr, data_size);
+                vertex_cache_buffer.Unmap(data_size);
+                res_cache.CacheVertexData(data_addr, data_size, loader.byte_count, cache_offset);
+                loader_offset = cache_offset;
+            } else {
+                bind_buffer(vertex_buffer.GetHandle());
+                std::memcpy(array_ptr, src_ptr, data_size);
+                array_ptr += data_size;
+                buffer_offset += data_size;
+            }
+        }
+
         u32 offset = 0;
         for (u32 comp = 0; comp < loader.component_count && comp < 12; ++comp) {
             u32 attribute_index = loader.GetComponent(comp);
@@ -217,7 +283,7 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
                     GLenum type = MakeAttributeType(vertex_attributes.GetFormat(attribute_index));
                     GLsizei stride = loader.byte_count;
                     glVertexAttribPointer(input_reg, size, type, GL_FALSE, stride,
-                                          reinterpret_cast<GLvoid*>(buffer_offset + offset));
+                                          reinterpret_cast<GLvoid*>(loader_offset + offset));
                     enable_attributes[input_reg] = true;
 
                     offset += vertex_attributes.GetStride(attribute_index);
@@ -229,20 +295,11 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
                 offset += (attribute_index - 11) * 4;
             }
         }
-
-        const PAddr data_addr =
-            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
-
-        const u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
-        const u32 data_size = loader.byte_count * vertex_num;
-
-        res_cache.FlushRegion(data_addr, data_size);
-        std::memcpy(array_ptr, memory.GetPhysicalPointer(data_addr), data_size);
-
-        array_ptr += data_size;
-        buffer_offset += data_size;
     }
 
+    // The stream buffer is unmapped through its binding
+    bind_buffer(vertex_buffer.GetHandle());
+
     for (std::size_t i = 0; i < enable_attributes.size(); ++i) {
         if (enable_attributes[i] != hw_vao_enabled_attributes[i]) {
             if (enable_attributes[i]) {
@@ -273,8 +330,7 @@ bool RasterizerOpenGL::SetupGeometryShader() {
     MICROPROFILE_SCOPE(OpenGL_GS);
 
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        LOG_ERROR(Render_OpenGL, "Accelerate draw doesn't support geometry shader");
-        return false;
+        return shader_manager.UseProgrammableGeometryShader(regs, pica.gs_setup);
     }
 
     // Enable the quaternion fix-up geometry-shader only if we are actually doing per-fragment
@@ -311,7 +367,13 @@ bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
 }
 
 bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
-    const GLenum primitive_mode = MakePrimitiveMode(regs.pipeline.triangle_topology);
+    GLenum primitive_mode = MakePrimitiveMode(regs.pipeline.triangle_topology);
+    if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
+        // In the Point mode every geometry shader invocation consumes a fixed number of vertices
+        const u32 vertices_per_primitive = (regs.gs.max_input_attribute_index + 1) /
+                                           (regs.pipeline.vs_outmap_total_minus_1_a + 1);
+        primitive_mode = MakeGeometryShaderInputMode(vertices_per_primitive);
+    }
     auto [vs_input_index_min, vs_input_index_max, vs_input_size] = AnalyzeVertexArray(is_indexed);
 
     if (vs_input_size > VERTEX_BUFFER_SIZE) {
@@ -319,6 +381,12 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
         return false;
     }
 
+    // Skip large draws while their shaders compile asynchronously
+    const bool wait_built = regs.pipeline.num_vertices <= 6;
+    if (!shader_manager.ApplyTo(state, wait_built)) {
+        return true;
+    }
+
     state.draw.vertex_buffer = vertex_buffer.GetHandle();
     state.Apply();
 
@@ -328,7 +396,6 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
     SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max);
     vertex_buffer.Unmap(vs_input_size);
 
-    shader_manager.ApplyTo(state);
     state.Apply();
 
     if (is_indexed) {
@@ -357,14 +424,13 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
     return true;
 }
 
-void RasterizerOpenGL::DrawTriangles() {
-    if (vertex_batch.empty())
-        return;
+void RasterizerOpenGL::DrawVertexBatch() {
     Draw(false, false);
 }
 
 bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     MICROPROFILE_SCOPE(OpenGL_Drawing);
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Draw};
 
     const bool shadow_rendering = regs.framebuffer.IsShadowRendering();
     const bool has_stencil = regs.framebuffer.HasStencil();
@@ -707,6 +773,16 @@ void RasterizerOpenGL::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
 
+std::optional<VideoCore::IndexRange> RasterizerOpenGL::FindIndexRange(PAddr addr, u32 size,
+                                                                      bool index_u16) {
+    return res_cache.FindIndexRange(addr, size, index_u16);
+}
+
+void RasterizerOpenGL::CacheIndexRange(PAddr addr, u32 size, bool index_u16,
+                                       VideoCore::IndexRange range) {
+    res_cache.CacheIndexRange(addr, size, index_u16, range);
+}
+
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) {
     return res_cache.AccelerateDisplayTransfer(config);
 }
@@ -719,6 +795,14 @@ bool RasterizerOpenGL::AccelerateFill(const Pica::MemoryFillConfig& config) {
     return res_cache.AccelerateFill(config);
 }
 
+std::pair<u64, u64> RasterizerOpenGL::GetTextureMemory() const {
+    return {res_cache.GetMemoryUsage(), res_cache.GetMemoryBudget()};
+}
+
+VideoCore::PipelineCacheStats RasterizerOpenGL::GetPipelineCacheStats() const {
+    return shader_manager.GetStats();
+}
+
 bool RasterizerOpenGL::AccelerateDisplay(const Pica::FramebufferConfig& config,
                                          PAddr framebuffer_addr, u32 pixel_stride,
                                          ScreenInfo& screen_info) {
@@ -930,62 +1014,40 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
         return;
     }
 
-    std::size_t bytes_used = 0;
     glBindBuffer(GL_TEXTURE_BUFFER, texture_lf_buffer.GetHandle());
     const auto [buffer, offset, invalidate] =
         texture_lf_buffer.Map(max_size, sizeof(Common::Vec4f));
+    lut_lf_uploader.Begin(buffer, offset, invalidate);
 
-    // Sync the lighting luts
+    // Sync the lighting luts, converting only the entries written since the last sync. A buffer
+    // that wrapped around gets the tables converted earlier again.
     if (fs_uniform_block_data.lighting_lut_dirty_any || invalidate) {
-        for (unsigned index = 0; index < fs_uniform_block_data.lighting_lut_dirty.size(); index++) {
-            if (fs_uniform_block_data.lighting_lut_dirty[index] || invalidate) {
-                std::array<Common::Vec2f, 256> new_data;
-                const auto& source_lut = pica.lighting.luts[index];
-                std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
-                               [](const auto& entry) {
-                                   return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                               });
-
-                if (new_data != lighting_lut_data[index] || invalidate) {
-                    lighting_lut_data[index] = new_data;
-                    std::memcpy(buffer + bytes_used, new_data.data(),
-                                new_data.size() * sizeof(Common::Vec2f));
-                    fs_uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
-                        static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec2f));
-                    fs_uniform_block_data.dirty = true;
-                    bytes_used += new_data.size() * sizeof(Common::Vec2f);
-                }
-                fs_uniform_block_data.lighting_lut_dirty[index] = false;
+        for (u32 index = 0; index < fs_uniform_block_data.lighting_lut_dirty.size(); index++) {
+            const bool dirty = fs_uniform_block_data.lighting_lut_dirty[index];
+            if ((dirty && SyncLightingLutData(index)) || invalidate) {
+                fs_uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
+                    lut_lf_uploader.Upload(lighting_lut_data[index]);
+                fs_uniform_block_data.dirty = true;
             }
+            fs_uniform_block_data.lighting_lut_dirty[index] = false;
         }
         fs_uniform_block_data.lighting_lut_dirty_any = false;
     }
 
     // Sync the fog lut
     if (fs_uniform_block_data.fog_lut_dirty || invalidate) {
-        std::array<Common::Vec2f, 128> new_data;
-
-        std::transform(pica.fog.lut.begin(), pica.fog.lut.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != fog_lut_data || invalidate) {
-            fog_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec2f));
-            fs_uniform_block_data.data.fog_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        if ((fs_uniform_block_data.fog_lut_dirty && SyncFogLutData()) || invalidate) {
+            fs_uniform_block_data.data.fog_lut_offset = lut_lf_uploader.Upload(fog_lut_data);
             fs_uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec2f);
         }
         fs_uniform_block_data.fog_lut_dirty = false;
     }
 
-    texture_lf_buffer.Unmap(bytes_used);
+    texture_lf_buffer.Unmap(lut_lf_uploader.BytesUsed());
 }
 
 void RasterizerOpenGL::SyncAndUploadLUTs() {
+    using Pica::TexturingRegs;
     constexpr std::size_t max_size =
         sizeof(Common::Vec2f) * 128 * 3 + // proctex: noise + color + alpha
         sizeof(Common::Vec4f) * 256 +     // proctex
@@ -998,95 +1060,36 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
         return;
     }
 
-    std::size_t bytes_used = 0;
     glBindBuffer(GL_TEXTURE_BUFFER, texture_buffer.GetHandle());
     const auto [buffer, offset, invalidate] = texture_buffer.Map(max_size, sizeof(Common::Vec4f));
+    lut_uploader.Begin(buffer, offset, invalidate);
 
-    // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
-    const auto sync_proc_tex_value_lut =
-        [this, buffer = buffer, offset = offset, invalidate = invalidate, &bytes_used](
-            const auto& lut, std::array<Common::Vec2f, 128>& lut_data, GLint& lut_offset) {
-            std::array<Common::Vec2f, 128> new_data;
-            std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
-                return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-            });
-
-            if (new_data != lut_data || invalidate) {
-                lut_data = new_data;
-                std::memcpy(buffer + bytes_used, new_data.data(),
-                            new_data.size() * sizeof(Common::Vec2f));
-                lut_offset = static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec2f));
-                fs_uniform_block_data.dirty = true;
-                bytes_used += new_data.size() * sizeof(Common::Vec2f);
-            }
-        };
-
-    // Sync the proctex noise lut
-    if (fs_uniform_block_data.proctex_noise_lut_dirty || invalidate) {
-        sync_proc_tex_value_lut(pica.proctex.noise_table, proctex_noise_lut_data,
-                                fs_uniform_block_data.data.proctex_noise_lut_offset);
-        fs_uniform_block_data.proctex_noise_lut_dirty = false;
-    }
-
-    // Sync the proctex color map
-    if (fs_uniform_block_data.proctex_color_map_dirty || invalidate) {
-        sync_proc_tex_value_lut(pica.proctex.color_map_table, proctex_color_map_data,
-                                fs_uniform_block_data.data.proctex_color_map_offset);
-        fs_uniform_block_data.proctex_color_map_dirty = false;
-    }
-
-    // Sync the proctex alpha map
-    if (fs_uniform_block_data.proctex_alpha_map_dirty || invalidate) {
-        sync_proc_tex_value_lut(pica.proctex.alpha_map_table, proctex_alpha_map_data,
-                                fs_uniform_block_data.data.proctex_alpha_map_offset);
-        fs_uniform_block_data.proctex_alpha_map_dirty = false;
-    }
-
-    // Sync the proctex lut
-    if (fs_uniform_block_data.proctex_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(pica.proctex.color_table.begin(), pica.proctex.color_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_lut_data || invalidate) {
-            proctex_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            fs_uniform_block_data.data.proctex_lut_offset =
-                static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec4f));
+    const auto sync_lut = [&, invalidate = invalidate](TexturingRegs::ProcTexLutTable table,
+                                                        bool& lut_dirty, const auto& lut_data,
+                                                        int& lut_offset) {
+        if ((lut_dirty && SyncProcTexLutData(table)) || invalidate) {
+            lut_offset = lut_uploader.Upload(lut_data);
             fs_uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
         }
-        fs_uniform_block_data.proctex_lut_dirty = false;
-    }
-
-    // Sync the proctex difference lut
-    if (fs_uniform_block_data.proctex_diff_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(pica.proctex.color_diff_table.begin(), pica.proctex.color_diff_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_diff_lut_data || invalidate) {
-            proctex_diff_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            fs_uniform_block_data.data.proctex_diff_lut_offset =
-                static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec4f));
-            fs_uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
-        }
-        fs_uniform_block_data.proctex_diff_lut_dirty = false;
-    }
+        lut_dirty = false;
+    };
 
-    texture_buffer.Unmap(bytes_used);
+    auto& data = fs_uniform_block_data.data;
+    sync_lut(TexturingRegs::ProcTexLutTable::Noise, fs_uniform_block_data.proctex_noise_lut_dirty,
+             proctex_noise_lut_data, data.proctex_noise_lut_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::ColorMap,
+             fs_uniform_block_data.proctex_color_map_dirty, proctex_color_map_data,
+             data.proctex_color_map_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::AlphaMap,
+             fs_uniform_block_data.proctex_alpha_map_dirty, proctex_alpha_map_data,
+             data.proctex_alpha_map_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::Color, fs_uniform_block_data.proctex_lut_dirty,
+             proctex_lut_data, data.proctex_lut_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::ColorDiff,
+             fs_uniform_block_data.proctex_diff_lut_dirty, proctex_diff_lut_data,
+             data.proctex_diff_lut_offset);
+
+    texture_buffer.Unmap(lut_uploader.BytesUsed());
 }
 
 void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
@@ -1094,7 +1097,7 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
     state.draw.uniform_buffer = uniform_buffer.GetHandle();
     state.Apply();
 
-    const bool sync_vs_pica = accelerate_draw;
+    const bool sync_vs_pica = accelerate_draw && SyncPicaUniforms();
     const bool sync_vs = vs_uniform_block_data.dirty;
     const bool sync_fs = fs_uniform_block_data.dirty;
     if (!sync_vs_pica && !sync_vs && !sync_fs) {
@@ -1126,12 +1129,17 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
         used_bytes += uniform_size_aligned_fs;
     }
 
-    if (sync_vs_pica) {
-        VSPicaUniformData vs_uniforms;
-        vs_uniforms.uniforms.SetFromRegs(regs.vs, pica.vs_setup);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+    // The PICA uniforms only change between some draws, the copy uploaded last is reused until
+    // then. It is lost when the buffer wraps around, even if this draw does not need it.
+    if (invalidate) {
+        pica_uniform_block_data.dirty = true;
+    }
+    if (accelerate_draw && pica_uniform_block_data.dirty) {
+        const std::size_t size = PicaUniformsSize();
+        std::memcpy(uniforms + used_bytes, &pica_uniform_block_data.data, size);
         glBindBufferRange(GL_UNIFORM_BUFFER, UniformBindings::VSPicaData,
-                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(vs_uniforms));
+                          uniform_buffer.GetHandle(), offset + used_bytes, size);
+        pica_uniform_block_data.dirty = false;
         used_bytes += uniform_size_aligned_vs_pica;
     }
 
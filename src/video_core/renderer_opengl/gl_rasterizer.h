@@ -17,7 +17,8 @@ class RendererBase;
 
 namespace VideoCore {
 class CustomTexManager;
-}
+class GpuProfiler;
+} // namespace VideoCore
 
 namespace Pica {
 struct DisplayTransferConfig;
@@ -36,14 +37,14 @@ class RasterizerOpenGL : public VideoCore::RasterizerAccelerated {
 public:
     explicit RasterizerOpenGL(Memory::MemorySystem& memory, Pica::PicaCore& pica,
                               VideoCore::CustomTexManager& custom_tex_manager,
-                              VideoCore::RendererBase& renderer, Driver& driver);
+                              VideoCore::RendererBase& renderer, Driver& driver,
+                              VideoCore::GpuProfiler& gpu_profiler, u64 program_id);
     ~RasterizerOpenGL() override;
 
     void TickFrame();
     void LoadDiskResources(const std::atomic_bool& stop_loading,
                            const VideoCore::DiskResourceLoadCallback& callback) override;
 
-    void DrawTriangles() override;
     void FlushAll() override;
     void FlushRegion(PAddr addr, u32 size) override;
     void InvalidateRegion(PAddr addr, u32 size) override;
@@ -55,10 +56,16 @@ public:
     bool AccelerateDisplay(const Pica::FramebufferConfig& config, PAddr framebuffer_addr,
                            u32 pixel_stride, ScreenInfo& screen_info);
     bool AccelerateDrawBatch(bool is_indexed) override;
+    std::pair<u64, u64> GetTextureMemory() const override;
+    VideoCore::PipelineCacheStats GetPipelineCacheStats() const override;
 
 private:
     void SyncFixedState() override;
     void NotifyFixedFunctionPicaRegisterChanged(u32 id) override;
+    std::optional<VideoCore::IndexRange> FindIndexRange(PAddr addr, u32 size,
+                                                        bool index_u16) override;
+    void CacheIndexRange(PAddr addr, u32 size, bool index_u16,
+                         VideoCore::IndexRange range) override;
 
     /// Syncs the clip enabled status to match the PICA register
     void SyncClipEnabled();
@@ -118,7 +125,10 @@ private:
     /// Upload the uniform blocks to the uniform buffer object
     void UploadUniforms(bool accelerate_draw);
 
-    /// Generic draw function for DrawTriangles and AccelerateDrawBatch
+    /// Draws the software shaded vertex batch
+    void DrawVertexBatch() override;
+
+    /// Generic draw function for DrawVertexBatch and AccelerateDrawBatch
     bool Draw(bool accelerate, bool is_indexed);
 
     /// Internal implementation for AccelerateDrawBatch
@@ -136,6 +146,7 @@ private:
 
 private:
     Driver& driver;
+    VideoCore::GpuProfiler& gpu_profiler;
     OpenGLState state;
     ShaderProgramManager shader_manager;
     TextureRuntime runtime;
@@ -147,10 +158,13 @@ private:
 
     GLsizeiptr texture_buffer_size;
     OGLStreamBuffer vertex_buffer;
+    OGLStreamBuffer vertex_cache_buffer; ///< Copies of unchanged vertex data
     OGLStreamBuffer uniform_buffer;
     OGLStreamBuffer index_buffer;
     OGLStreamBuffer texture_buffer;
     OGLStreamBuffer texture_lf_buffer;
+    LutUploader lut_uploader;
+    LutUploader lut_lf_uploader;
     GLint uniform_buffer_alignment;
     std::size_t uniform_size_aligned_vs_pica;
     std::size_t uniform_size_aligned_vs;
@@ -3,21 +3,23 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
+#include <thread>
 #include <fmt/format.h>
 
 #include "common/common_paths.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
+#include "common/literals.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
 #include "common/zstd_compression.h"
-#include "core/core.h"
-#include "core/loader/loader.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 
 namespace OpenGL {
 
+using namespace Common::Literals;
+
 constexpr std::size_t HASH_LENGTH = 64;
 using ShaderCacheVersionHash = std::array<u8, HASH_LENGTH>;
 
@@ -32,6 +34,14 @@ enum class PrecompiledEntryKind : u32 {
 
 constexpr u32 NativeVersion = 1;
 
+// The precompiled file is compressed as independent frames so they can be decompressed in parallel
+constexpr std::size_t PrecompiledFrameSize = 1_MiB;
+constexpr s32 PrecompiledCompressionLevel = 3;
+
+static u32 GetNumCompressionWorkers() {
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
 // The hash is based on relevant files. The list of files can be found at src/common/CMakeLists.txt
 // and CMakeModules/GenerateSCMRev.cmake
 ShaderCacheVersionHash GetShaderCacheVersionHash() {
@@ -103,8 +113,8 @@ bool ShaderDiskCacheRaw::Save(FileUtil::IOFile& file) const {
     return true;
 }
 
-ShaderDiskCache::ShaderDiskCache(bool separable)
-    : separable{separable}, transferable_file(AppendTransferableFile()),
+ShaderDiskCache::ShaderDiskCache(bool separable, u64 program_id)
+    : separable{separable}, program_id{program_id}, transferable_file(AppendTransferableFile()),
       // seperable shaders use the virtual precompile file, that already has a header.
       precompiled_file(AppendPrecompiledFile(!separable)) {}
 
@@ -200,19 +210,24 @@ ShaderDiskCache::LoadPrecompiled(bool compressed) {
 
 std::optional<std::pair<std::unordered_map<u64, ShaderDiskCacheDecompiled>, ShaderDumpsMap>>
 ShaderDiskCache::LoadPrecompiledFile(FileUtil::IOFile& file, bool compressed) {
-    // Read compressed file from disk and decompress to virtual precompiled cache file
-    std::vector<u8> precompiled_file(file.GetSize());
-    file.ReadBytes(precompiled_file.data(), precompiled_file.size());
+    // Map the file from disk and decompress it to the virtual precompiled cache file
+    file.Flush();
+    const FileUtil::FileMapping mapping{file};
+    const std::span<const u8> precompiled_data = mapping.Data();
+    if (precompiled_data.empty()) {
+        LOG_ERROR(Render_OpenGL, "Could not map precompiled shader cache.");
+        return std::nullopt;
+    }
     if (compressed) {
-        const std::vector<u8> decompressed =
-            Common::Compression::DecompressDataZSTD(precompiled_file);
+        const std::vector<u8> decompressed = Common::Compression::DecompressDataZSTDFrames(
+            precompiled_data, GetNumCompressionWorkers());
         if (decompressed.empty()) {
             LOG_ERROR(Render_OpenGL, "Could not decompress precompiled shader cache.");
             return std::nullopt;
         }
         SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
     } else {
-        SaveArrayToPrecompiled(precompiled_file.data(), precompiled_file.size());
+        SaveArrayToPrecompiled(precompiled_data.data(), precompiled_data.size());
     }
 
     decompressed_precompiled_cache_offset = 0;
@@ -507,8 +522,9 @@ void ShaderDiskCache::SavePrecompiledHeaderToVirtualPrecompiledCache() {
 
 void ShaderDiskCache::SaveVirtualPrecompiledFile() {
     decompressed_precompiled_cache_offset = 0;
-    const auto compressed =
-        Common::Compression::CompressDataZSTDDefault(decompressed_precompiled_cache);
+    const auto compressed = Common::Compression::CompressDataZSTDFrames(
+        decompressed_precompiled_cache, PrecompiledCompressionLevel, PrecompiledFrameSize,
+        GetNumCompressionWorkers());
 
     const auto precompiled_path{GetPrecompiledPath()};
 
@@ -568,15 +584,7 @@ std::string ShaderDiskCache::GetBaseDir() const {
     return FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir) + DIR_SEP "opengl";
 }
 
-u64 ShaderDiskCache::GetProgramID() {
-    // Skip games without title id
-    if (program_id != 0) {
-        return program_id;
-    }
-    if (Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id) !=
-        Loader::ResultStatus::Success) {
-        return 0;
-    }
+u64 ShaderDiskCache::GetProgramID() const {
     return program_id;
 }
 
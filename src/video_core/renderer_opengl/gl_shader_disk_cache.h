@@ -83,7 +83,7 @@ struct ShaderDiskCacheDump {
 
 class ShaderDiskCache {
 public:
-    explicit ShaderDiskCache(bool separable);
+    explicit ShaderDiskCache(bool separable, u64 program_id);
     ~ShaderDiskCache() = default;
 
     /// Loads transferable cache. If file has a old version or on failure, it deletes the file.
@@ -162,7 +162,7 @@ private:
     std::string GetBaseDir() const;
 
     /// Get current game's title id as u64
-    u64 GetProgramID();
+    u64 GetProgramID() const;
 
     /// Get current game's title id
     std::string GetTitleID();
@@ -214,6 +214,7 @@ private:
 
     bool separable{};
 
+    /// Program id of the running title, 0 when it has none
     u64 program_id{};
     std::string title_id;
 
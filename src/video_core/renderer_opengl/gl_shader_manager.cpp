@@ -8,14 +8,18 @@
 #include <span>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
+#include "common/async_handle.h"
 #include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/frontend/emu_window.h"
 #include "video_core/pica/shader_setup.h"
 #include "video_core/renderer_opengl/gl_driver.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
+#include "video_core/renderer_opengl/gl_shader_util.h"
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/shader/generator/glsl_fs_shader_gen.h"
 #include "video_core/shader/generator/glsl_shader_gen.h"
@@ -26,6 +30,9 @@ using Pica::Shader::FSConfig;
 
 namespace OpenGL {
 
+// The parallel shader compile extensions are not exposed by glad, so their token is defined here
+constexpr GLenum COMPLETION_STATUS_KHR = 0x91B1;
+
 static u64 GetUniqueIdentifier(const Pica::RegsInternal& regs, const ProgramCode& code) {
     std::size_t hash = 0;
     u64 regs_uid =
@@ -93,8 +100,11 @@ static std::tuple<PicaVSConfig, Pica::ShaderSetup> BuildVSConfigFromRaw(
     setup.swizzle_data = swizzle_data;
 
     // Enable the geometry-shader only if we are actually doing per-fragment lighting
-    // and care about proper quaternions. Otherwise just use standard vertex+fragment shaders
-    const bool use_geometry_shader = !raw.GetRawShaderConfig().lighting.disable;
+    // and care about proper quaternions, or if the PICA geometry shader is in use.
+    // Otherwise just use standard vertex+fragment shaders
+    const auto& config = raw.GetRawShaderConfig();
+    const bool use_geometry_shader =
+        !config.lighting.disable || config.pipeline.use_gs == Pica::PipelineRegs::UseGS::Yes;
     return {PicaVSConfig{raw.GetRawShaderConfig(), setup, driver.HasClipCullDistance(),
                          use_geometry_shader},
             setup};
@@ -125,6 +135,58 @@ public:
         }
     }
 
+    /**
+     * Submits the stage without querying its status, so drivers supporting parallel shader
+     * compile build it on their own threads. The stage is pending until the driver completes it.
+     */
+    void CreateDeferred(const char* source, GLenum type) {
+        OGLShader shader;
+        shader.handle = LoadShader(source, type, false);
+        if (shader_or_program.index() == 0) {
+            std::get<OGLShader>(shader_or_program) = std::move(shader);
+        } else {
+            std::get<OGLProgram>(shader_or_program).handle =
+                LoadProgram(true, std::array{shader.handle}, false);
+        }
+        deferred = true;
+    }
+
+    /// Marks the stage as pending until a worker thread calls MarkDone after creating it
+    void MarkQueued() {
+        async_handle = std::make_unique<Common::AsyncHandle>();
+    }
+
+    void MarkDone() {
+        async_handle->MarkDone();
+    }
+
+    /// Returns true when the stage can be used without waiting for it to be compiled
+    bool IsDone() {
+        if (deferred) {
+            GLint completed = GL_FALSE;
+            if (shader_or_program.index() == 0) {
+                glGetShaderiv(GetHandle(), COMPLETION_STATUS_KHR, &completed);
+            } else {
+                glGetProgramiv(GetHandle(), COMPLETION_STATUS_KHR, &completed);
+            }
+            if (completed == GL_FALSE) {
+                return false;
+            }
+            FinishDeferred();
+            return true;
+        }
+        return !async_handle || async_handle->IsDone();
+    }
+
+    void WaitDone() {
+        if (deferred) {
+            // Querying the link status blocks until the driver is done
+            FinishDeferred();
+        } else if (async_handle) {
+            async_handle->WaitDone();
+        }
+    }
+
     GLuint GetHandle() const {
         if (shader_or_program.index() == 0) {
             return std::get<OGLShader>(shader_or_program).handle;
@@ -137,8 +199,20 @@ public:
         shader_or_program = std::move(program);
     }
 
+private:
+    void FinishDeferred() {
+        deferred = false;
+        // Errors of shader objects are reported when the program using them is linked
+        if (shader_or_program.index() == 1) {
+            const bool linked = CheckProgramLinked(GetHandle());
+            ASSERT_MSG(linked, "Shader not linked");
+        }
+    }
+
 private:
     std::variant<OGLShader, OGLProgram> shader_or_program;
+    std::unique_ptr<Common::AsyncHandle> async_handle;
+    bool deferred{};
 };
 
 class TrivialVertexShader {
@@ -162,6 +236,24 @@ public:
     explicit ShaderCache(bool separable_) : separable{separable_} {}
     ~ShaderCache() = default;
 
+    /**
+     * Returns the stage of config, new stages are handed to compile together with their code,
+     * which may compile them without waiting. Pending stages are not done until it finishes.
+     */
+    template <typename Compile, typename... Args>
+    std::tuple<OGLShaderStage*, std::optional<std::string>> GetStage(const KeyConfigType& config,
+                                                                     Compile&& compile,
+                                                                     Args&&... args) {
+        auto [iter, new_shader] = shaders.emplace(config, OGLShaderStage{separable});
+        OGLShaderStage& cached_shader = iter->second;
+        std::optional<std::string> result{};
+        if (new_shader) {
+            result = CodeGenerator(config, args...);
+            compile(cached_shader, *result);
+        }
+        return {&cached_shader, std::move(result)};
+    }
+
     template <typename... Args>
     std::tuple<GLuint, std::optional<std::string>> Get(const KeyConfigType& config,
                                                        Args&&... args) {
@@ -255,14 +347,22 @@ using ProgrammableVertexShaders =
 using FixedGeometryShaders =
     ShaderCache<PicaFixedGSConfig, &GLSL::GenerateFixedGeometryShader, GL_GEOMETRY_SHADER>;
 
+using ProgrammableGeometryShaders =
+    ShaderDoubleCache<PicaGSConfig, &GLSL::GenerateGeometryShader, GL_GEOMETRY_SHADER>;
+
 using FragmentShaders = ShaderCache<FSConfig, &GLSL::GenerateFragmentShader, GL_FRAGMENT_SHADER>;
 
+/// Keeps a context shared with the render context current on each shader worker
+using ShaderWorkerState = std::unique_ptr<Frontend::GraphicsContext::Scoped>;
+using ShaderWorkers = Common::StatefulThreadWorker<ShaderWorkerState>;
+
 class ShaderProgramManager::Impl {
 public:
-    explicit Impl(const Driver& driver, bool separable)
+    explicit Impl(const Driver& driver, bool separable, u64 program_id)
         : separable(separable), programmable_vertex_shaders(separable),
           trivial_vertex_shader(driver, separable), fixed_geometry_shaders(separable),
-          fragment_shaders(separable), disk_cache(separable) {
+          programmable_geometry_shaders(separable), fragment_shaders(separable),
+          disk_cache(separable, program_id) {
         if (separable) {
             pipeline.Create();
         }
@@ -313,6 +413,22 @@ public:
     static_assert(offsetof(ShaderTuple, fs_hash) == sizeof(std::size_t) * 2,
                   "ShaderTuple layout changed!");
 
+    void CompileFragmentShader(OGLShaderStage& stage, const std::string& code) {
+        if (fragment_workers) {
+            stage.MarkQueued();
+            fragment_workers->QueueWork([&stage, code](ShaderWorkerState*) {
+                stage.Create(code.c_str(), GL_FRAGMENT_SHADER);
+                // The program must be complete once the render context uses it
+                glFinish();
+                stage.MarkDone();
+            });
+        } else if (parallel_compile) {
+            stage.CreateDeferred(code.c_str(), GL_FRAGMENT_SHADER);
+        } else {
+            stage.Create(code.c_str(), GL_FRAGMENT_SHADER);
+        }
+    }
+
     bool separable;
     Pica::Shader::Profile profile{};
     ShaderTuple current;
@@ -321,26 +437,65 @@ public:
     TrivialVertexShader trivial_vertex_shader;
 
     FixedGeometryShaders fixed_geometry_shaders;
+    ProgrammableGeometryShaders programmable_geometry_shaders;
 
     FragmentShaders fragment_shaders;
+    OGLShaderStage* fs_stage{};
+    Pica::Shader::FSConfigStats fs_config_stats;
     std::unordered_map<u64, OGLProgram> program_cache;
+    std::unordered_set<u64> pending_programs; ///< Programs the driver is still linking
+    VideoCore::PipelineCacheStats stats{};
     OGLPipeline pipeline;
     ShaderDiskCache disk_cache;
+
+    bool parallel_compile{}; ///< Stages are deferred to the parallel compile threads of the driver
+    std::vector<std::unique_ptr<Frontend::GraphicsContext>> worker_contexts;
+    std::unique_ptr<ShaderWorkers> fragment_workers;
 };
 
 ShaderProgramManager::ShaderProgramManager(Frontend::EmuWindow& emu_window_, const Driver& driver_,
-                                           bool separable)
+                                           bool separable, u64 program_id)
     : emu_window{emu_window_}, driver{driver_},
-      strict_context_required{emu_window.StrictContextRequired()}, impl{std::make_unique<Impl>(
-                                                                       driver_, separable)} {}
+      strict_context_required{emu_window.StrictContextRequired()},
+      impl{std::make_unique<Impl>(driver_, separable, program_id)} {
+    if (!Settings::values.async_shader_compilation.GetValue()) {
+        return;
+    }
 
-ShaderProgramManager::~ShaderProgramManager() = default;
+    // Separable fragment programs are compiled by workers with shared contexts. Without them, let
+    // drivers supporting parallel shader compile build the stages asynchronously instead.
+    if (separable && !strict_context_required) {
+        const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency() / 2)};
+        emu_window.SaveContext();
+        for (std::size_t i = 0; i < num_workers; ++i) {
+            auto& context = impl->worker_contexts.emplace_back(emu_window.CreateSharedContext());
+            // Release the context, so it can be made current by its worker
+            context->DoneCurrent();
+        }
+        emu_window.RestoreContext();
+        impl->fragment_workers = std::make_unique<ShaderWorkers>(
+            num_workers, "GLShaderWorker", [this](std::size_t index) {
+                return std::make_unique<Frontend::GraphicsContext::Scoped>(
+                    *impl->worker_contexts[index]);
+            });
+    } else if (driver.HasParallelShaderCompile()) {
+        impl->parallel_compile = true;
+    }
+}
+
+ShaderProgramManager::~ShaderProgramManager() {
+    const auto& stats = impl->fs_config_stats;
+    LOG_INFO(Render_OpenGL, "Merged {} fragment shader configurations into {} shaders",
+             stats.NumCollapsed() + stats.NumConfigs(), stats.NumConfigs());
+}
 
 bool ShaderProgramManager::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
                                                        Pica::ShaderSetup& setup) {
     // Enable the geometry-shader only if we are actually doing per-fragment lighting
-    // and care about proper quaternions. Otherwise just use standard vertex+fragment shaders
-    const bool use_geometry_shader = !regs.lighting.disable;
+    // and care about proper quaternions, or if the PICA geometry shader is in use.
+    // Otherwise just use standard vertex+fragment shaders
+    const bool use_geometry_shader =
+        !regs.lighting.disable || regs.pipeline.use_gs == Pica::PipelineRegs::UseGS::Yes;
 
     PicaVSConfig config{regs, setup, driver.HasClipCullDistance(), use_geometry_shader};
     auto [handle, result] = impl->programmable_vertex_shaders.Get(config, setup);
@@ -377,6 +532,18 @@ void ShaderProgramManager::UseFixedGeometryShader(const Pica::RegsInternal& regs
     impl->current.gs_hash = gs_config.Hash();
 }
 
+bool ShaderProgramManager::UseProgrammableGeometryShader(const Pica::RegsInternal& regs,
+                                                         Pica::ShaderSetup& setup) {
+    PicaGSConfig gs_config{regs, setup, driver.HasClipCullDistance()};
+    auto [handle, _] = impl->programmable_geometry_shaders.Get(gs_config, setup);
+    if (handle == 0) {
+        return false;
+    }
+    impl->current.gs = handle;
+    impl->current.gs_hash = gs_config.Hash();
+    return true;
+}
+
 void ShaderProgramManager::UseTrivialGeometryShader() {
     impl->current.gs = 0;
     impl->current.gs_hash = 0;
@@ -384,10 +551,17 @@ void ShaderProgramManager::UseTrivialGeometryShader() {
 
 void ShaderProgramManager::UseFragmentShader(const Pica::RegsInternal& regs,
                                              const Pica::Shader::UserConfig& user) {
-    const FSConfig fs_config{regs, user, impl->profile};
-    auto [handle, result] = impl->fragment_shaders.Get(fs_config, impl->profile);
-    impl->current.fs = handle;
+    u64 raw_hash{};
+    const FSConfig fs_config{regs, user, impl->profile, &raw_hash};
+    impl->fs_config_stats.Record(fs_config, raw_hash);
+    const auto compile = [this](OGLShaderStage& stage, const std::string& code) {
+        impl->CompileFragmentShader(stage, code);
+    };
+    auto [stage, result] = impl->fragment_shaders.GetStage(fs_config, compile, impl->profile);
+    impl->fs_stage = stage;
     impl->current.fs_hash = fs_config.Hash();
+    impl->stats.lookups++;
+    impl->stats.hits += result ? 0 : 1;
     // Save FS to the disk cache if its a new shader
     if (result) {
         auto& disk_cache = impl->disk_cache;
@@ -398,7 +572,18 @@ void ShaderProgramManager::UseFragmentShader(const Pica::RegsInternal& regs,
     }
 }
 
-void ShaderProgramManager::ApplyTo(OpenGLState& state) {
+bool ShaderProgramManager::ApplyTo(OpenGLState& state, bool wait_built) {
+    if (OGLShaderStage* fs_stage = impl->fs_stage) {
+        if (!fs_stage->IsDone()) {
+            impl->stats.compile_stalls++;
+            if (!wait_built) {
+                return false;
+            }
+            fs_stage->WaitDone();
+        }
+        impl->current.fs = fs_stage->GetHandle();
+    }
+
     if (impl->separable) {
         if (driver.HasBug(DriverBug::ShaderStageChangeFreeze)) {
             glUseProgramStages(
@@ -414,15 +599,43 @@ void ShaderProgramManager::ApplyTo(OpenGLState& state) {
     } else {
         const u64 unique_identifier = impl->current.GetConfigHash();
         OGLProgram& cached_program = impl->program_cache[unique_identifier];
+        const std::array shaders{impl->current.vs, impl->current.gs, impl->current.fs};
+        bool new_program = false;
         if (cached_program.handle == 0) {
-            cached_program.Create(false,
-                                  std::array{impl->current.vs, impl->current.gs, impl->current.fs});
+            if (impl->parallel_compile) {
+                cached_program.handle = LoadProgram(false, shaders, false);
+                impl->pending_programs.insert(unique_identifier);
+            } else {
+                cached_program.Create(false, shaders);
+                new_program = true;
+            }
+        }
+        if (impl->pending_programs.contains(unique_identifier)) {
+            GLint completed = GL_FALSE;
+            glGetProgramiv(cached_program.handle, COMPLETION_STATUS_KHR, &completed);
+            if (completed == GL_FALSE) {
+                impl->stats.compile_stalls++;
+                if (!wait_built) {
+                    return false;
+                }
+            }
+            const bool linked = CheckProgramLinked(cached_program.handle);
+            ASSERT_MSG(linked, "Shader not linked");
+            impl->pending_programs.erase(unique_identifier);
+            new_program = true;
+        }
+        if (new_program) {
             auto& disk_cache = impl->disk_cache;
             const bool sanitize_mul = Settings::values.shaders_accurate_mul.GetValue();
             disk_cache.SaveDumpToFile(unique_identifier, cached_program.handle, sanitize_mul);
         }
         state.draw.shader_program = cached_program.handle;
     }
+    return true;
+}
+
+VideoCore::PipelineCacheStats ShaderProgramManager::GetStats() const {
+    return impl->stats;
 }
 
 void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
@@ -450,9 +663,49 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
 
     std::mutex mutex;
     std::atomic_bool compilation_failed = false;
+
+    // Programs are loaded and built by workers with contexts shared with the render context.
+    // Frontends requiring a strict context load them on the current thread instead.
+    std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts;
+    if (!strict_context_required) {
+        const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
+        emu_window.SaveContext();
+        for (std::size_t i = 0; i < num_workers; ++i) {
+            // On some platforms the shared context has to be created from the GUI thread
+            auto& context = contexts.emplace_back(emu_window.CreateSharedContext());
+            // Release the context, so it can be immediately used by the spawned thread
+            context->DoneCurrent();
+        }
+        emu_window.RestoreContext();
+    }
+    const auto LoadInParallel = [&](std::size_t count, const auto& load) {
+        if (contexts.empty()) {
+            load(0, count);
+            return;
+        }
+        const std::size_t num_workers{contexts.size()};
+        const std::size_t bucket_size{count / num_workers};
+        std::vector<std::thread> threads(num_workers);
+        for (std::size_t i = 0; i < num_workers; ++i) {
+            const bool is_last_worker = i + 1 == num_workers;
+            const std::size_t start{bucket_size * i};
+            const std::size_t end{is_last_worker ? count : start + bucket_size};
+            threads[i] = std::thread([&load, start, end, context = contexts[i].get()] {
+                const auto scope = context->Acquire();
+                load(start, end);
+                // The render context uses the programs once the workers are joined
+                glFinish();
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
     if (callback) {
         callback(VideoCore::LoadCallbackStage::Decompile, 0, raws.size());
     }
+    std::size_t loaded_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
     std::vector<std::size_t> load_raws_index;
     // Loads both decompiled and precompiled shaders from the cache. If either one is missing for
     const auto LoadPrecompiledShader = [&](std::size_t begin, std::size_t end,
@@ -473,6 +726,7 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                           "Invalid hash in entry={:016x} (obtained hash={:016x}) - removing "
                           "shader cache",
                           raw.GetUniqueIdentifier(), calculated_hash);
+                std::scoped_lock lock(mutex);
                 disk_cache.InvalidateAll();
                 return;
             }
@@ -525,47 +779,60 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                 load_raws_index.push_back(i);
             }
             if (callback) {
-                callback(VideoCore::LoadCallbackStage::Decompile, i, raw_cache.size());
+                std::scoped_lock lock(mutex);
+                callback(VideoCore::LoadCallbackStage::Decompile, ++loaded_shaders,
+                         raw_cache.size());
             }
         }
     };
 
-    const auto LoadPrecompiledProgram = [&](const ShaderDecompiledMap& decompiled_map,
-                                            const ShaderDumpsMap& dump_map) {
-        std::size_t i{0};
-        for (const auto& dump : dump_map) {
-            if (stop_loading) {
-                break;
-            }
-            const u64 unique_identifier{dump.first};
-            const auto decomp{decompiled_map.find(unique_identifier)};
+    const auto LoadPrecompiledProgram =
+        [&](std::size_t begin, std::size_t end, const ShaderDecompiledMap& decompiled_map,
+            std::span<const ShaderDumpsMap::value_type* const> dump_entries) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (stop_loading || compilation_failed) {
+                    return;
+                }
+                const auto& [unique_identifier, dump] = *dump_entries[i];
+                const auto decomp{decompiled_map.find(unique_identifier)};
 
-            // Only load the program if its sanitize_mul setting matches
-            const bool sanitize_mul = Settings::values.shaders_accurate_mul.GetValue();
-            if (decomp->second.sanitize_mul != sanitize_mul) {
-                continue;
-            }
+                // Only load the program if its sanitize_mul setting matches
+                const bool sanitize_mul = Settings::values.shaders_accurate_mul.GetValue();
+                if (decomp == decompiled_map.end() || decomp->second.sanitize_mul != sanitize_mul) {
+                    continue;
+                }
 
-            // If the shader program is dumped, attempt to load it
-            OGLProgram shader =
-                GeneratePrecompiledProgram(dump.second, supported_formats, impl->separable);
-            if (shader.handle != 0) {
+                // If the shader program is dumped, attempt to load it
+                OGLProgram shader =
+                    GeneratePrecompiledProgram(dump, supported_formats, impl->separable);
+                if (shader.handle == 0) {
+                    LOG_ERROR(Frontend, "Failed to link Precompiled program!");
+                    compilation_failed = true;
+                    return;
+                }
+
+                std::scoped_lock lock(mutex);
                 impl->program_cache.emplace(unique_identifier, std::move(shader));
-            } else {
-                LOG_ERROR(Frontend, "Failed to link Precompiled program!");
-                compilation_failed = true;
-                break;
-            }
-            if (callback) {
-                callback(VideoCore::LoadCallbackStage::Decompile, ++i, dump_map.size());
+                if (callback) {
+                    callback(VideoCore::LoadCallbackStage::Decompile, ++loaded_shaders,
+                             dump_entries.size());
+                }
             }
-        }
-    };
+        };
 
     if (impl->separable) {
-        LoadPrecompiledShader(0, raws.size(), raws, decompiled, dumps);
+        LoadInParallel(raws.size(), [&](std::size_t begin, std::size_t end) {
+            LoadPrecompiledShader(begin, end, raws, decompiled, dumps);
+        });
     } else {
-        LoadPrecompiledProgram(decompiled, dumps);
+        std::vector<const ShaderDumpsMap::value_type*> dump_entries;
+        dump_entries.reserve(dumps.size());
+        for (const auto& dump : dumps) {
+            dump_entries.push_back(&dump);
+        }
+        LoadInParallel(dump_entries.size(), [&](std::size_t begin, std::size_t end) {
+            LoadPrecompiledProgram(begin, end, decompiled, dump_entries);
+        });
     }
 
     bool load_all_raws = false;
@@ -592,9 +859,7 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
     compilation_failed = false;
 
     std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
-    const auto LoadRawSepareble = [&](std::size_t begin, std::size_t end,
-                                      Frontend::GraphicsContext* context = nullptr) {
-        const auto scope = context->Acquire();
+    const auto LoadRawSepareble = [&](std::size_t begin, std::size_t end) {
         for (std::size_t i = begin; i < end; ++i) {
             if (stop_loading || compilation_failed) {
                 return;
@@ -654,32 +919,7 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
-    if (!strict_context_required) {
-        const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
-        const std::size_t bucket_size{load_raws_size / num_workers};
-        std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts(num_workers);
-        std::vector<std::thread> threads(num_workers);
-
-        emu_window.SaveContext();
-        for (std::size_t i = 0; i < num_workers; ++i) {
-            const bool is_last_worker = i + 1 == num_workers;
-            const std::size_t start{bucket_size * i};
-            const std::size_t end{is_last_worker ? load_raws_size : start + bucket_size};
-
-            // On some platforms the shared context has to be created from the GUI thread
-            contexts[i] = emu_window.CreateSharedContext();
-            // Release the context, so it can be immediately used by the spawned thread
-            contexts[i]->DoneCurrent();
-            threads[i] = std::thread(LoadRawSepareble, start, end, contexts[i].get());
-        }
-        for (auto& thread : threads) {
-            thread.join();
-        }
-        emu_window.RestoreContext();
-    } else {
-        const auto dummy_context{std::make_unique<Frontend::GraphicsContext>()};
-        LoadRawSepareble(0, load_raws_size, dummy_context.get());
-    }
+    LoadInParallel(load_raws_size, LoadRawSepareble);
 
     if (compilation_failed) {
         disk_cache.InvalidateAll();
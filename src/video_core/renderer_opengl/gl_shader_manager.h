@@ -34,7 +34,8 @@ enum UniformBindings {
 /// A class that manage different shader stages and configures them with given config data.
 class ShaderProgramManager {
 public:
-    ShaderProgramManager(Frontend::EmuWindow& emu_window, const Driver& driver, bool separable);
+    ShaderProgramManager(Frontend::EmuWindow& emu_window, const Driver& driver, bool separable,
+                         u64 program_id);
     ~ShaderProgramManager();
 
     void LoadDiskCache(const std::atomic_bool& stop_loading,
@@ -46,11 +47,21 @@ public:
 
     void UseFixedGeometryShader(const Pica::RegsInternal& regs);
 
+    bool UseProgrammableGeometryShader(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup);
+
     void UseTrivialGeometryShader();
 
     void UseFragmentShader(const Pica::RegsInternal& config, const Pica::Shader::UserConfig& user);
 
-    void ApplyTo(OpenGLState& state);
+    /**
+     * Binds the current shaders to state.
+     * @param wait_built Whether to wait for shaders that are still compiling asynchronously
+     * @returns false when a shader is still compiling and wait_built is not set
+     */
+    bool ApplyTo(OpenGLState& state, bool wait_built = true);
+
+    /// Returns the fragment shader lookups of draws and how many found a compiled shader
+    VideoCore::PipelineCacheStats GetStats() const;
 
 private:
     Frontend::EmuWindow& emu_window;
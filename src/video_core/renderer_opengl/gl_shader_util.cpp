@@ -13,7 +13,7 @@
 
 namespace OpenGL {
 
-GLuint LoadShader(std::string_view source, GLenum type) {
+GLuint LoadShader(std::string_view source, GLenum type, bool check_status) {
     std::string preamble;
     if (GLES) {
         preamble = R"(#version 320 es
@@ -41,6 +41,9 @@ GLuint LoadShader(std::string_view source, GLenum type) {
     case GL_FRAGMENT_SHADER:
         debug_type = "fragment";
         break;
+    case GL_COMPUTE_SHADER:
+        debug_type = "compute";
+        break;
     default:
         UNREACHABLE();
     }
@@ -52,6 +55,9 @@ GLuint LoadShader(std::string_view source, GLenum type) {
     glShaderSource(shader_id, static_cast<GLsizei>(src_arr.size()), src_arr.data(), lengths.data());
     LOG_DEBUG(Render_OpenGL, "Compiling {} shader...", debug_type);
     glCompileShader(shader_id);
+    if (!check_status) {
+        return shader_id;
+    }
 
     GLint result = GL_FALSE;
     GLint info_log_length;
@@ -72,7 +78,7 @@ GLuint LoadShader(std::string_view source, GLenum type) {
     return shader_id;
 }
 
-GLuint LoadProgram(bool separable_program, std::span<const GLuint> shaders) {
+GLuint LoadProgram(bool separable_program, std::span<const GLuint> shaders, bool check_status) {
     // Link the program
     LOG_DEBUG(Render_OpenGL, "Linking program...");
 
@@ -91,7 +97,21 @@ GLuint LoadProgram(bool separable_program, std::span<const GLuint> shaders) {
     glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program_id);
 
-    // Check the program
+    if (check_status) {
+        const bool linked = CheckProgramLinked(program_id);
+        ASSERT_MSG(linked, "Shader not linked");
+    }
+
+    for (GLuint shader : shaders) {
+        if (shader != 0) {
+            glDetachShader(program_id, shader);
+        }
+    }
+
+    return program_id;
+}
+
+bool CheckProgramLinked(GLuint program_id) {
     GLint result = GL_FALSE;
     GLint info_log_length;
     glGetProgramiv(program_id, GL_LINK_STATUS, &result);
@@ -106,16 +126,7 @@ GLuint LoadProgram(bool separable_program, std::span<const GLuint> shaders) {
             LOG_ERROR(Render_OpenGL, "Error linking shader:\n{}", &program_error[0]);
         }
     }
-
-    ASSERT_MSG(result == GL_TRUE, "Shader not linked");
-
-    for (GLuint shader : shaders) {
-        if (shader != 0) {
-            glDetachShader(program_id, shader);
-        }
-    }
-
-    return program_id;
+    return result == GL_TRUE;
 }
 
 } // namespace OpenGL
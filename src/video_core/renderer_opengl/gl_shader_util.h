@@ -13,15 +13,26 @@ namespace OpenGL {
  * Utility function to create and compile an OpenGL GLSL shader
  * @param source String of the GLSL shader program
  * @param type Type of the shader (GL_VERTEX_SHADER, GL_GEOMETRY_SHADER or GL_FRAGMENT_SHADER)
+ * @param check_status When false the compile status is not queried, so drivers supporting
+ *                     GL_KHR_parallel_shader_compile can compile without blocking the caller
  */
-GLuint LoadShader(std::string_view source, GLenum type);
+GLuint LoadShader(std::string_view source, GLenum type, bool check_status = true);
 
 /**
  * Utility function to create and link an OpenGL GLSL shader program
  * @param separable_program whether to create a separable program
  * @param shaders ID of shaders to attach to the program
+ * @param check_status When false the link status is not queried, CheckProgramLinked must be
+ *                     called once the driver reports the program as complete
  * @returns Handle of the newly created OpenGL program object
  */
-GLuint LoadProgram(bool separable_program, std::span<const GLuint> shaders);
+GLuint LoadProgram(bool separable_program, std::span<const GLuint> shaders,
+                   bool check_status = true);
+
+/**
+ * Queries the link status of a program, logging the errors of the driver
+ * @returns true when the program linked successfully
+ */
+bool CheckProgramLinked(GLuint program_id);
 
 } // namespace OpenGL
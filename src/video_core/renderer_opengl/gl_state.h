@@ -38,6 +38,7 @@ constexpr GLuint ShadowTextureNY = 3;
 constexpr GLuint ShadowTexturePZ = 4;
 constexpr GLuint ShadowTextureNZ = 5;
 constexpr GLuint ShadowBuffer = 6;
+constexpr GLuint TextureDecode = 7;
 } // namespace ImageUnits
 
 class OpenGLState {
@@ -4,6 +4,7 @@
 
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "video_core/renderer_opengl/gl_driver.h"
 #include "video_core/renderer_opengl/gl_stream_buffer.h"
@@ -13,9 +14,16 @@ MICROPROFILE_DEFINE(OpenGL_StreamBuffer, "OpenGL", "Stream Buffer Orphaning",
 
 namespace OpenGL {
 
+namespace {
+
+/// Number of sync objects inserted while filling the buffer once
+constexpr GLsizeiptr SYNC_POINTS = 16;
+
+} // Anonymous namespace
+
 OGLStreamBuffer::OGLStreamBuffer(Driver& driver, GLenum target, GLsizeiptr size,
                                  bool prefer_coherent)
-    : gl_target(target), buffer_size(size) {
+    : gl_target(target), buffer_size(size), ring(size) {
     gl_buffer.Create();
     glBindBuffer(gl_target, gl_buffer.handle);
 
@@ -38,7 +46,15 @@ OGLStreamBuffer::OGLStreamBuffer(Driver& driver, GLenum target, GLsizeiptr size,
 }
 
 OGLStreamBuffer::~OGLStreamBuffer() {
+    for (const GLsync fence : fences) {
+        glDeleteSync(fence);
+    }
     if (persistent) {
+        const auto& stats = ring.GetStats();
+        LOG_INFO(Render_OpenGL,
+                 "Stream buffer {:#x} of {} KiB wrapped {} times, stalled {} times for {} ms",
+                 gl_target, buffer_size / 1024, stats.wraps, stats.stalls,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(stats.stall_time).count());
         glBindBuffer(gl_target, gl_buffer.handle);
         glUnmapBuffer(gl_target);
     }
@@ -58,6 +74,18 @@ std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr a
     ASSERT(alignment <= buffer_size);
     mapped_size = size;
 
+    if (persistent) {
+        // The commands reading the chunks committed so far have been issued by now
+        if (unfenced_size >= buffer_size / SYNC_POINTS) {
+            InsertFence();
+        }
+        const auto reservation =
+            ring.Reserve(size, alignment, [this](u64 fence) { return IsFenceSignaled(fence); },
+                         [this](u64 fence) { WaitFence(fence); });
+        buffer_pos = reservation.offset;
+        return std::make_tuple(mapped_ptr + buffer_pos, buffer_pos, reservation.invalidate);
+    }
+
     if (alignment > 0) {
         buffer_pos = Common::AlignUp<std::size_t>(buffer_pos, alignment);
     }
@@ -66,23 +94,17 @@ std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr a
     if (buffer_pos + size > buffer_size) {
         buffer_pos = 0;
         invalidate = true;
-
-        if (persistent) {
-            glUnmapBuffer(gl_target);
-        }
     }
 
-    if (invalidate || !persistent) {
-        MICROPROFILE_SCOPE(OpenGL_StreamBuffer);
-        GLbitfield flags = GL_MAP_WRITE_BIT | (persistent ? GL_MAP_PERSISTENT_BIT : 0) |
-                           (coherent ? GL_MAP_COHERENT_BIT : GL_MAP_FLUSH_EXPLICIT_BIT) |
-                           (invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
-        mapped_ptr = static_cast<u8*>(
-            glMapBufferRange(gl_target, buffer_pos, buffer_size - buffer_pos, flags));
-        mapped_offset = buffer_pos;
-    }
+    MICROPROFILE_SCOPE(OpenGL_StreamBuffer);
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT |
+        (invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
+    mapped_ptr = static_cast<u8*>(
+        glMapBufferRange(gl_target, buffer_pos, buffer_size - buffer_pos, flags));
+    mapped_offset = buffer_pos;
 
-    return std::make_tuple(mapped_ptr + buffer_pos - mapped_offset, buffer_pos, invalidate);
+    return std::make_tuple(mapped_ptr, buffer_pos, invalidate);
 }
 
 void OGLStreamBuffer::Unmap(GLsizeiptr size) {
@@ -92,11 +114,47 @@ void OGLStreamBuffer::Unmap(GLsizeiptr size) {
         glFlushMappedBufferRange(gl_target, buffer_pos - mapped_offset, size);
     }
 
-    if (!persistent) {
+    if (persistent) {
+        ring.Commit(size, current_fence);
+        unfenced_size += size;
+    } else {
         glUnmapBuffer(gl_target);
     }
 
     buffer_pos += size;
 }
 
+void OGLStreamBuffer::InsertFence() {
+    fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    current_fence++;
+    unfenced_size = 0;
+}
+
+bool OGLStreamBuffer::IsFenceSignaled(u64 fence) {
+    if (fence >= current_fence) {
+        return false;
+    }
+    while (!fences.empty() && OldestFence() <= fence) {
+        GLint status{};
+        glGetSynciv(fences.front(), GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED) {
+            return false;
+        }
+        glDeleteSync(fences.front());
+        fences.pop_front();
+    }
+    return true;
+}
+
+void OGLStreamBuffer::WaitFence(u64 fence) {
+    if (fence >= current_fence) {
+        InsertFence();
+    }
+    while (!fences.empty() && OldestFence() <= fence) {
+        glClientWaitSync(fences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fences.front());
+        fences.pop_front();
+    }
+}
+
 } // namespace OpenGL
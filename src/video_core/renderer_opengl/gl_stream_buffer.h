@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <deque>
 #include <tuple>
 #include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/stream_ring.h"
 
 namespace OpenGL {
 
@@ -23,7 +25,8 @@ public:
     /*
      * Allocates a linear chunk of memory in the GPU buffer with at least "size" bytes
      * and the optional alignment requirement.
-     * If the buffer is full, the whole buffer is reallocated which invalidates old chunks.
+     * If the buffer is full, persistent buffers wait for the GPU to finish reading the chunks
+     * that get reused, other buffers are reallocated. Either way old chunks are invalidated.
      * The return values are the pointer to the new chunk, the offset within the buffer,
      * and the invalidation flag for previous chunks.
      * The actual used size must be specified on unmapping the chunk.
@@ -32,6 +35,26 @@ public:
 
     void Unmap(GLsizeiptr size);
 
+    /// Returns the wait statistics of persistent buffers
+    const VideoCore::StreamRing::Stats& GetStats() const noexcept {
+        return ring.GetStats();
+    }
+
+private:
+    /// Inserts a fence after the commands issued so far, signaling fence current_fence
+    void InsertFence();
+
+    /// Returns true when the GPU has passed the provided fence
+    bool IsFenceSignaled(u64 fence);
+
+    /// Blocks until the GPU has passed the provided fence
+    void WaitFence(u64 fence);
+
+    /// Returns the fence signaled by the oldest pending sync object
+    u64 OldestFence() const noexcept {
+        return current_fence - fences.size();
+    }
+
 private:
     OGLBuffer gl_buffer;
     GLenum gl_target;
@@ -44,6 +67,11 @@ private:
     GLintptr mapped_offset = 0;
     GLsizeiptr mapped_size = 0;
     u8* mapped_ptr = nullptr;
+
+    VideoCore::StreamRing ring;
+    std::deque<GLsync> fences; ///< Pending sync objects, the last one signals current_fence - 1
+    u64 current_fence = 1;     ///< Fence the chunks committed since the last sync object wait on
+    GLsizeiptr unfenced_size = 0;
 };
 
 } // namespace OpenGL
@@ -4,12 +4,15 @@
 
 #include "common/scope_exit.h"
 #include "common/settings.h"
+#include "core/frontend/emu_window.h"
 #include "video_core/custom_textures/material.h"
+#include "video_core/gpu_profiler.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_opengl/gl_driver.h"
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/gl_texture_mailbox.h"
 #include "video_core/renderer_opengl/gl_texture_runtime.h"
+#include "video_core/renderer_opengl/gl_texture_uploader.h"
 #include "video_core/renderer_opengl/pica_to_gl.h"
 
 namespace OpenGL {
@@ -92,33 +95,57 @@ static constexpr std::array<FormatTuple, 8> CUSTOM_TUPLES = {{
     return 0;
 }
 
-[[nodiscard]] OGLTexture MakeHandle(GLenum target, u32 width, u32 height, u32 levels,
-                                    const FormatTuple& tuple, std::string_view debug_name = "") {
+[[nodiscard]] HandleInfo MakeHandleInfo(GLenum target, u32 width, u32 height, u32 levels,
+                                        const FormatTuple& tuple) {
+    return HandleInfo{
+        .target = target,
+        .internal_format = tuple.internal_format,
+        .width = width,
+        .height = height,
+        .levels = levels,
+    };
+}
+
+[[nodiscard]] OGLTexture MakeHandle(const HandleInfo& info) {
     OGLTexture texture{};
     texture.Create();
 
-    glBindTexture(target, texture.handle);
-    glTexStorage2D(target, levels, tuple.internal_format, width, height);
-
-    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(info.target, texture.handle);
+    glTexStorage2D(info.target, info.levels, info.internal_format, info.width, info.height);
 
-    if (!debug_name.empty()) {
-        glObjectLabel(GL_TEXTURE, texture.handle, -1, debug_name.data());
-    }
+    glTexParameteri(info.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(info.target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(info.target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     return texture;
 }
 
+/// Estimates the memory of a texture, the format size is unknown so assume RGBA8
+[[nodiscard]] u64 EstimateHandleSize(const HandleInfo& info) {
+    u64 size = static_cast<u64>(info.width) * info.height * 4;
+    if (info.levels > 1) {
+        size += size / 3;
+    }
+    return info.target == GL_TEXTURE_CUBE_MAP ? size * 6 : size;
+}
+
 } // Anonymous namespace
 
-TextureRuntime::TextureRuntime(const Driver& driver_, VideoCore::RendererBase& renderer)
-    : driver{driver_}, blit_helper{driver} {
+TextureRuntime::TextureRuntime(const Driver& driver_, VideoCore::RendererBase& renderer,
+                               VideoCore::GpuProfiler& gpu_profiler_)
+    : driver{driver_}, gpu_profiler{gpu_profiler_}, blit_helper{driver, gpu_profiler},
+      texture_pool{static_cast<u64>(Settings::values.surface_pool_size.GetValue()) << 20} {
     for (std::size_t i = 0; i < draw_fbos.size(); ++i) {
         draw_fbos[i].Create();
         read_fbos[i].Create();
     }
+
+    // The upload thread only receives the materials decoded in the background
+    Frontend::EmuWindow& emu_window = renderer.GetRenderWindow();
+    if (Settings::values.async_texture_upload.GetValue() &&
+        Settings::values.async_custom_loading.GetValue() && !emu_window.StrictContextRequired()) {
+        uploader = std::make_unique<TextureUploader>(emu_window);
+    }
 }
 
 TextureRuntime::~TextureRuntime() = default;
@@ -127,12 +154,48 @@ u32 TextureRuntime::RemoveThreshold() {
     return SWAP_CHAIN_SIZE;
 }
 
+u64 TextureRuntime::GetMemoryBudget() const {
+    return driver.GetVideoMemorySize();
+}
+
+OGLTexture TextureRuntime::AllocateHandle(const HandleInfo& info, std::string_view debug_name) {
+    auto texture = texture_pool.Acquire(info);
+    if (!texture) {
+        texture = MakeHandle(info);
+    }
+    if (!debug_name.empty()) {
+        glObjectLabel(GL_TEXTURE, texture->handle, -1, debug_name.data());
+    }
+    return std::move(*texture);
+}
+
+void TextureRuntime::RecycleHandle(const HandleInfo& info, OGLTexture&& texture) {
+    if (!texture.handle) {
+        return;
+    }
+    texture_pool.Release(info, std::move(texture), EstimateHandleSize(info));
+}
+
 bool TextureRuntime::NeedsConversion(VideoCore::PixelFormat pixel_format) const {
     const bool should_convert = pixel_format == PixelFormat::RGBA8 || // Needs byteswap
                                 pixel_format == PixelFormat::RGB8;    // Is converted to RGBA8
     return driver.IsOpenGLES() && should_convert;
 }
 
+bool TextureRuntime::SupportsTiledDecode(VideoCore::PixelFormat pixel_format) const {
+    // The decode shader writes RGBA8, formats with a native tuple are uploaded directly.
+    return VideoCore::IsGpuDecodable(pixel_format) &&
+           GetFormatTuple(pixel_format).internal_format == GL_RGBA8;
+}
+
+bool TextureRuntime::SupportsCustomFormat(VideoCore::CustomPixelFormat format) const {
+    return driver.IsCustomFormatSupported(format);
+}
+
+bool TextureRuntime::PrepareCustomUpload(const VideoCore::Material* material) {
+    return !uploader || uploader->IsReady(material, GetFormatTuple(material->format));
+}
+
 VideoCore::StagingData TextureRuntime::FindStaging(u32 size, bool upload) {
     if (size > staging_buffer.size()) {
         staging_buffer.resize(size);
@@ -261,6 +324,7 @@ void TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClea
 
 bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureCopy& copy) {
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Blit};
     const GLenum src_textarget = source.texture_type == VideoCore::TextureType::CubeMap
                                      ? GL_TEXTURE_CUBE_MAP
                                      : GL_TEXTURE_2D;
@@ -273,8 +337,17 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
     return true;
 }
 
+bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
+                                  std::span<const VideoCore::TextureCopy> copies) {
+    for (const VideoCore::TextureCopy& copy : copies) {
+        CopyTextures(source, dest, copy);
+    }
+    return true;
+}
+
 bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureBlit& blit) {
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Blit};
     OpenGLState state = OpenGLState::GetCurState();
     state.scissor.enabled = false;
     state.draw.read_framebuffer = read_fbos[FboIndex(source.type)].handle;
@@ -324,16 +397,19 @@ Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceParams& param
     const GLenum target =
         texture_type == VideoCore::TextureType::CubeMap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
 
-    textures[0] = MakeHandle(target, width, height, levels, tuple, DebugName(false));
+    texture_infos[0] = MakeHandleInfo(target, width, height, levels, tuple);
+    textures[0] = runtime->AllocateHandle(texture_infos[0], DebugName(false));
     if (res_scale != 1) {
-        textures[1] = MakeHandle(target, GetScaledWidth(), GetScaledHeight(), levels, tuple,
-                                 DebugName(true, false));
+        texture_infos[1] =
+            MakeHandleInfo(target, GetScaledWidth(), GetScaledHeight(), levels, tuple);
+        textures[1] = runtime->AllocateHandle(texture_infos[1], DebugName(true, false));
     }
 }
 
-Surface::Surface(TextureRuntime& runtime, const VideoCore::SurfaceBase& surface,
+Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceBase& surface,
                  const VideoCore::Material* mat)
-    : SurfaceBase{surface}, tuple{runtime.GetFormatTuple(mat->format)} {
+    : SurfaceBase{surface}, driver{&runtime_.GetDriver()}, runtime{&runtime_},
+      tuple{runtime->GetFormatTuple(mat->format)} {
     if (mat && !driver->IsCustomFormatSupported(mat->format)) {
         return;
     }
@@ -345,19 +421,27 @@ Surface::Surface(TextureRuntime& runtime, const VideoCore::SurfaceBase& surface,
     custom_format = mat->format;
     material = mat;
 
-    textures[0] = MakeHandle(target, mat->width, mat->height, levels, tuple, DebugName(false));
+    texture_infos[0] = MakeHandleInfo(target, mat->width, mat->height, levels, tuple);
+    textures[0] = runtime->AllocateHandle(texture_infos[0], DebugName(false));
     if (res_scale != 1) {
-        textures[1] = MakeHandle(target, mat->width, mat->height, levels, DEFAULT_TUPLE,
-                                 DebugName(true, true));
+        texture_infos[1] = MakeHandleInfo(target, mat->width, mat->height, levels, DEFAULT_TUPLE);
+        textures[1] = runtime->AllocateHandle(texture_infos[1], DebugName(true, true));
     }
     const bool has_normal = mat->Map(MapType::Normal);
     if (has_normal) {
-        textures[2] =
-            MakeHandle(target, mat->width, mat->height, levels, tuple, DebugName(true, true));
+        texture_infos[2] = texture_infos[0];
+        textures[2] = runtime->AllocateHandle(texture_infos[2], DebugName(true, true));
     }
 }
 
-Surface::~Surface() = default;
+Surface::~Surface() {
+    if (!runtime) {
+        return;
+    }
+    for (u32 i = 0; i < textures.size(); i++) {
+        runtime->RecycleHandle(texture_infos[i], std::move(textures[i]));
+    }
+}
 
 GLuint Surface::Handle(u32 index) const noexcept {
     if (!textures[index].handle) {
@@ -368,8 +452,9 @@ GLuint Surface::Handle(u32 index) const noexcept {
 
 GLuint Surface::CopyHandle() noexcept {
     if (!copy_texture.handle) {
-        copy_texture = MakeHandle(GL_TEXTURE_2D, GetScaledWidth(), GetScaledHeight(), levels, tuple,
-                                  DebugName(true));
+        copy_texture = runtime->AllocateHandle(
+            MakeHandleInfo(GL_TEXTURE_2D, GetScaledWidth(), GetScaledHeight(), levels, tuple),
+            DebugName(true));
     }
 
     for (u32 level = 0; level < levels; level++) {
@@ -383,7 +468,8 @@ GLuint Surface::CopyHandle() noexcept {
 }
 
 void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
-                     const VideoCore::StagingData& staging) {
+                     const VideoCore::StagingData& staging, bool filter) {
+    VideoCore::GpuProfiler::Scope gpu_scope{runtime->gpu_profiler, VideoCore::GpuPass::Upload};
     ASSERT(stride * GetFormatBytesPerPixel(pixel_format) % 4 == 0);
 
     const u32 unscaled_width = upload.texture_rect.GetWidth();
@@ -405,12 +491,33 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
         .src_rect = upload.texture_rect,
         .dst_rect = upload.texture_rect * res_scale,
     };
-    if (res_scale != 1 && !runtime->blit_helper.Filter(*this, blit)) {
+    if (res_scale != 1 && !(filter && runtime->blit_helper.Filter(*this, blit))) {
+        BlitScale(blit, true);
+    }
+}
+
+void Surface::UploadTiled(const VideoCore::BufferTextureCopy& upload,
+                          const VideoCore::StagingData& staging, bool filter) {
+    VideoCore::GpuProfiler::Scope gpu_scope{runtime->gpu_profiler, VideoCore::GpuPass::Upload};
+    runtime->blit_helper.DecodeTiled(*this, upload, staging.mapped);
+
+    const VideoCore::TextureBlit blit = {
+        .src_level = upload.texture_level,
+        .dst_level = upload.texture_level,
+        .src_rect = upload.texture_rect,
+        .dst_rect = upload.texture_rect * res_scale,
+    };
+    if (res_scale != 1 && !(filter && runtime->blit_helper.Filter(*this, blit))) {
         BlitScale(blit, true);
     }
 }
 
+void Surface::Filter(const VideoCore::TextureBlit& blit) {
+    runtime->blit_helper.Filter(*this, blit);
+}
+
 void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
+    VideoCore::GpuProfiler::Scope gpu_scope{runtime->gpu_profiler, VideoCore::GpuPass::Upload};
     const u32 width = material->width;
     const u32 height = material->height;
     const auto color = material->textures[0];
@@ -431,7 +538,17 @@ void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
         }
     };
 
-    upload(0, color);
+    // Materials from the upload thread are already on the GPU and only copied
+    std::array<GLuint, VideoCore::MAX_MAPS> map_handles{};
+    for (u32 i = 0; i < VideoCore::MAX_MAPS; i++) {
+        map_handles[i] = Handle(i == 0 ? 0 : i + 1);
+    }
+    const bool uploaded =
+        runtime->uploader && runtime->uploader->CopyTo(material, level, map_handles);
+
+    if (!uploaded) {
+        upload(0, color);
+    }
 
     const VideoCore::TextureBlit blit = {
         .src_rect = filter_rect,
@@ -440,7 +557,7 @@ void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
     if (res_scale != 1 && !runtime->blit_helper.Filter(*this, blit)) {
         BlitScale(blit, true);
     }
-    for (u32 i = 1; i < VideoCore::MAX_MAPS; i++) {
+    for (u32 i = 1; i < VideoCore::MAX_MAPS && !uploaded; i++) {
         const auto texture = material->textures[i];
         if (!texture) {
             continue;
@@ -490,6 +607,12 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download,
     glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 }
 
+u64 Surface::DownloadAsync(const VideoCore::BufferTextureCopy& download,
+                           const VideoCore::StagingData& staging) {
+    Download(download, staging);
+    return 0;
+}
+
 bool Surface::DownloadWithoutFbo(const VideoCore::BufferTextureCopy& download,
                                  const VideoCore::StagingData& staging) {
     if (driver->IsOpenGLES()) {
@@ -556,8 +679,9 @@ void Surface::ScaleUp(u32 new_scale) {
     }
 
     res_scale = new_scale;
-    textures[1] = MakeHandle(GL_TEXTURE_2D, GetScaledWidth(), GetScaledHeight(), levels, tuple,
-                             DebugName(true));
+    texture_infos[1] =
+        MakeHandleInfo(GL_TEXTURE_2D, GetScaledWidth(), GetScaledHeight(), levels, tuple);
+    textures[1] = runtime->AllocateHandle(texture_infos[1], DebugName(true));
 
     for (u32 level = 0; level < levels; level++) {
         const VideoCore::TextureBlit blit = {
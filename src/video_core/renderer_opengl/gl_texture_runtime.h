@@ -4,12 +4,17 @@
 
 #pragma once
 
+#include <memory>
+#include <span>
+#include "common/hash.h"
 #include "video_core/rasterizer_cache/framebuffer_base.h"
 #include "video_core/rasterizer_cache/rasterizer_cache_base.h"
 #include "video_core/rasterizer_cache/surface_base.h"
+#include "video_core/rasterizer_cache/surface_pool.h"
 #include "video_core/renderer_opengl/gl_blit_helper.h"
 
 namespace VideoCore {
+class GpuProfiler;
 struct Material;
 class RendererBase;
 } // namespace VideoCore
@@ -27,8 +32,25 @@ struct FormatTuple {
     }
 };
 
+struct HandleInfo {
+    GLenum target;
+    GLint internal_format;
+    u32 width;
+    u32 height;
+    u32 levels;
+
+    bool operator==(const HandleInfo& other) const noexcept = default;
+
+    u64 Hash() const noexcept {
+        return Common::ComputeHash64(this, sizeof(HandleInfo));
+    }
+};
+static_assert(std::has_unique_object_representations_v<HandleInfo>,
+              "HandleInfo is not suitable for hashing");
+
 class Surface;
 class Driver;
+class TextureUploader;
 
 /**
  * Provides texture manipulation functions to the rasterizer cache
@@ -39,18 +61,49 @@ class TextureRuntime {
     friend class Framebuffer;
 
 public:
-    explicit TextureRuntime(const Driver& driver, VideoCore::RendererBase& renderer);
+    explicit TextureRuntime(const Driver& driver, VideoCore::RendererBase& renderer,
+                            VideoCore::GpuProfiler& gpu_profiler);
     ~TextureRuntime();
 
     /// Returns the removal threshold ticks for the garbage collector
     u32 RemoveThreshold();
 
+    /// Returns the amount of video memory in bytes reported by the driver, 0 when unknown
+    u64 GetMemoryBudget() const;
+
     /// Submits and waits for current GPU work.
     void Finish() {}
 
+    /// Submits current GPU work without waiting for it.
+    void Flush() {}
+
+    /// Returns true if surfaces can be read back without waiting for the GPU.
+    /// Downloads read pixels to client memory, which always waits.
+    bool SupportsAsyncDownload() const {
+        return false;
+    }
+
+    /// Maps readback memory of the provided size for asynchronous downloads
+    VideoCore::StagingData FindReadbackStaging(u32 size) {
+        return FindStaging(size, false);
+    }
+
+    /// Waits for the asynchronous download that returned tick to complete
+    void WaitDownload(u64) {}
+
     /// Returns true if the provided pixel format cannot be used natively by the runtime.
     bool NeedsConversion(VideoCore::PixelFormat pixel_format) const;
 
+    /// Returns true if tiled data of the provided pixel format can be decoded on the GPU.
+    bool SupportsTiledDecode(VideoCore::PixelFormat pixel_format) const;
+
+    /// Returns true if custom textures of the provided format can be sampled.
+    bool SupportsCustomFormat(VideoCore::CustomPixelFormat format) const;
+
+    /// Returns true if the custom material can be uploaded now. With the upload thread this is
+    /// false until the thread uploaded the material, which is queued on the first call.
+    bool PrepareCustomUpload(const VideoCore::Material* material);
+
     /// Maps an internal staging buffer of the provided size of pixel uploads/downloads
     VideoCore::StagingData FindStaging(u32 size, bool upload);
 
@@ -67,6 +120,10 @@ public:
     /// Copies a rectangle of source to another rectange of dest
     bool CopyTextures(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
+    /// Copies multiple rectangles of source to dest
+    bool CopyTextures(Surface& source, Surface& dest,
+                      std::span<const VideoCore::TextureCopy> copies);
+
     /// Blits a rectangle of source to another rectange of dest
     bool BlitTextures(Surface& source, Surface& dest, const VideoCore::TextureBlit& blit);
 
@@ -74,6 +131,12 @@ public:
     void GenerateMipmaps(Surface& surface);
 
 private:
+    /// Returns a released texture matching info from the surface pool or creates a new one
+    OGLTexture AllocateHandle(const HandleInfo& info, std::string_view debug_name = {});
+
+    /// Returns the texture to the surface pool for reuse by later surfaces
+    void RecycleHandle(const HandleInfo& info, OGLTexture&& texture);
+
     /// Returns the OpenGL driver class
     const Driver& GetDriver() const {
         return driver;
@@ -84,10 +147,13 @@ private:
 
 private:
     const Driver& driver;
+    VideoCore::GpuProfiler& gpu_profiler;
     BlitHelper blit_helper;
+    std::unique_ptr<TextureUploader> uploader;
     std::vector<u8> staging_buffer;
     std::array<OGLFramebuffer, 3> draw_fbos;
     std::array<OGLFramebuffer, 3> read_fbos;
+    VideoCore::SurfacePool<HandleInfo, OGLTexture> texture_pool;
 };
 
 class Surface : public VideoCore::SurfaceBase {
@@ -113,8 +179,17 @@ public:
     /// Returns a copy of the upscaled texture handle, used for feedback loops.
     GLuint CopyHandle() noexcept;
 
-    /// Uploads pixel data in staging to a rectangle region of the surface texture
-    void Upload(const VideoCore::BufferTextureCopy& upload, const VideoCore::StagingData& staging);
+    /// Uploads pixel data in staging to a rectangle region of the surface texture.
+    /// When filter is false the upscaled texture is only scaled linearly, see Filter.
+    void Upload(const VideoCore::BufferTextureCopy& upload, const VideoCore::StagingData& staging,
+                bool filter = true);
+
+    /// Uploads raw tiled pixel data in staging and decodes it to a rectangle region of the texture
+    void UploadTiled(const VideoCore::BufferTextureCopy& upload,
+                     const VideoCore::StagingData& staging, bool filter = true);
+
+    /// Applies the texture filter to a rectangle region of the upscaled texture
+    void Filter(const VideoCore::TextureBlit& blit);
 
     /// Uploads the custom material to the surface allocation.
     void UploadCustom(const VideoCore::Material* material, u32 level);
@@ -123,6 +198,10 @@ public:
     void Download(const VideoCore::BufferTextureCopy& download,
                   const VideoCore::StagingData& staging);
 
+    /// Downloads pixel data to staging like Download, returning the tick of the download
+    u64 DownloadAsync(const VideoCore::BufferTextureCopy& download,
+                      const VideoCore::StagingData& staging);
+
     /// Attaches a handle of surface to the specified framebuffer target
     void Attach(GLenum target, u32 level, u32 layer, bool scaled = true);
 
@@ -144,6 +223,7 @@ private:
     const Driver* driver;
     TextureRuntime* runtime;
     std::array<OGLTexture, 3> textures;
+    std::array<HandleInfo, 3> texture_infos{};
     OGLTexture copy_texture;
     FormatTuple tuple;
 };
@@ -0,0 +1,145 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "common/microprofile.h"
+#include "core/frontend/emu_window.h"
+#include "video_core/custom_textures/custom_format.h"
+#include "video_core/renderer_opengl/gl_texture_uploader.h"
+
+MICROPROFILE_DEFINE(OpenGL_AsyncUpload, "OpenGL", "Async Texture Upload", MP_RGB(128, 64, 192));
+
+namespace OpenGL {
+
+struct TextureUploader::WorkerState {
+    explicit WorkerState(Frontend::GraphicsContext& context) : scope{context} {
+        glGenBuffers(1, &pbo);
+    }
+
+    ~WorkerState() {
+        glDeleteBuffers(1, &pbo);
+    }
+
+    Frontend::GraphicsContext::Scoped scope;
+    GLuint pbo{};
+};
+
+TextureUploader::TextureUploader(Frontend::EmuWindow& emu_window) {
+    // On some platforms the shared context has to be created from the GUI thread
+    emu_window.SaveContext();
+    context = emu_window.CreateSharedContext();
+    // Release the context, so it can be made current by the worker
+    context->DoneCurrent();
+    emu_window.RestoreContext();
+
+    worker = std::make_unique<Common::StatefulThreadWorker<std::unique_ptr<WorkerState>>>(
+        1, "GLTextureUploader",
+        [this](std::size_t) { return std::make_unique<WorkerState>(*context); });
+}
+
+TextureUploader::~TextureUploader() {
+    // Joining the worker leaves every upload either done or never started
+    worker.reset();
+    for (auto& [material, upload] : uploads) {
+        if (upload->done) {
+            Release(*upload);
+        }
+    }
+}
+
+bool TextureUploader::IsReady(const VideoCore::Material* material, const FormatTuple& tuple) {
+    const auto [it, is_new] = uploads.try_emplace(material);
+    if (is_new) {
+        it->second = std::make_unique<Upload>();
+        worker->QueueWork([this, material, tuple, upload = it->second.get()](
+                              std::unique_ptr<WorkerState>* state) {
+            UploadMaterial(**state, material, tuple, *upload);
+        });
+        return false;
+    }
+
+    Upload& upload = *it->second;
+    if (!upload.done.load(std::memory_order_acquire)) {
+        return false;
+    }
+    const GLenum result = glClientWaitSync(upload.fence, 0, 0);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+bool TextureUploader::CopyTo(const VideoCore::Material* material, u32 level,
+                             const std::array<GLuint, VideoCore::MAX_MAPS>& dst_textures) {
+    const auto it = uploads.find(material);
+    if (it == uploads.end() || !it->second->done.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    Upload& upload = *it->second;
+    for (std::size_t i = 0; i < VideoCore::MAX_MAPS; i++) {
+        if (upload.textures[i] != 0 && dst_textures[i] != 0) {
+            glCopyImageSubData(upload.textures[i], GL_TEXTURE_2D, 0, 0, 0, 0, dst_textures[i],
+                               GL_TEXTURE_2D, level, 0, 0, 0, material->width, material->height,
+                               1);
+        }
+    }
+    Release(upload);
+    uploads.erase(it);
+    return true;
+}
+
+void TextureUploader::UploadMaterial(WorkerState& state, const VideoCore::Material* material,
+                                     const FormatTuple& tuple, Upload& upload) {
+    MICROPROFILE_SCOPE(OpenGL_AsyncUpload);
+
+    // The material stays decoded while its upload is pending, see CustomTexManager::TickFrame
+    const bool compressed = VideoCore::IsCustomFormatCompressed(material->format);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, state.pbo);
+    for (std::size_t i = 0; i < VideoCore::MAX_MAPS; i++) {
+        const VideoCore::CustomTexture* texture = material->textures[i];
+        if (!texture) {
+            continue;
+        }
+        const auto size = static_cast<GLsizeiptr>(texture->data.size());
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (!mapped) {
+            continue;
+        }
+        std::memcpy(mapped, texture->data.data(), texture->data.size());
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        GLuint& handle = upload.textures[i];
+        glGenTextures(1, &handle);
+        glBindTexture(GL_TEXTURE_2D, handle);
+        glTexStorage2D(GL_TEXTURE_2D, 1, tuple.internal_format, material->width,
+                       material->height);
+        if (compressed) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, material->width, material->height,
+                                      tuple.format, static_cast<GLsizei>(size), nullptr);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, material->width, material->height,
+                            tuple.format, tuple.type, nullptr);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // Flushed so the render context can wait on the fence
+    upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    upload.done.store(true, std::memory_order_release);
+}
+
+void TextureUploader::Release(Upload& upload) {
+    for (GLuint& texture : upload.textures) {
+        if (texture != 0) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
+    glDeleteSync(upload.fence);
+    upload.fence = {};
+}
+
+} // namespace OpenGL
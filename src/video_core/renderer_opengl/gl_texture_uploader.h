@@ -0,0 +1,72 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <glad/glad.h>
+#include "common/thread_worker.h"
+#include "video_core/custom_textures/material.h"
+#include "video_core/renderer_opengl/gl_texture_runtime.h"
+
+namespace Frontend {
+class EmuWindow;
+class GraphicsContext;
+} // namespace Frontend
+
+namespace OpenGL {
+
+/**
+ * Uploads the textures of custom materials on a thread with an OpenGL context shared with the
+ * render context. The pixels are written to a pixel buffer object, so the driver copies them to
+ * the textures while the render thread keeps drawing, and a fence signals when the GPU received
+ * them. The render thread only switches surfaces to a material once its fence signaled, copying
+ * the uploaded textures on the GPU.
+ */
+class TextureUploader {
+public:
+    explicit TextureUploader(Frontend::EmuWindow& emu_window);
+    ~TextureUploader();
+
+    TextureUploader(const TextureUploader&) = delete;
+    TextureUploader& operator=(const TextureUploader&) = delete;
+
+    /**
+     * Returns true once the textures of the material are on the GPU, queueing their upload the
+     * first time the material is requested.
+     */
+    bool IsReady(const VideoCore::Material* material, const FormatTuple& tuple);
+
+    /**
+     * Copies the uploaded maps of the material to level of the textures in dst_textures, indexed
+     * like the material maps, and releases them.
+     * @returns false if the material was not uploaded
+     */
+    bool CopyTo(const VideoCore::Material* material, u32 level,
+                const std::array<GLuint, VideoCore::MAX_MAPS>& dst_textures);
+
+private:
+    struct Upload {
+        std::array<GLuint, VideoCore::MAX_MAPS> textures{}; ///< Indexed like the material maps
+        GLsync fence{};
+        std::atomic_bool done{}; ///< The fence was created and flushed by the worker
+    };
+
+    /// Keeps the shared context current on the worker and owns its pixel buffer object
+    struct WorkerState;
+
+    void UploadMaterial(WorkerState& state, const VideoCore::Material* material,
+                        const FormatTuple& tuple, Upload& upload);
+
+    void Release(Upload& upload);
+
+    std::unique_ptr<Frontend::GraphicsContext> context;
+    std::unordered_map<const VideoCore::Material*, std::unique_ptr<Upload>> uploads;
+    std::unique_ptr<Common::StatefulThreadWorker<std::unique_ptr<WorkerState>>> worker;
+};
+
+} // namespace OpenGL
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
@@ -75,9 +76,9 @@ static std::array<GLfloat, 3 * 2> MakeOrthographicMatrix(const float width, cons
 RendererOpenGL::RendererOpenGL(Core::System& system, Pica::PicaCore& pica_,
                                Frontend::EmuWindow& window, Frontend::EmuWindow* secondary_window)
     : VideoCore::RendererBase{system, window, secondary_window}, pica{pica_},
-      rasterizer{system.Memory(), pica, system.CustomTexManager(), *this, driver}, frame_dumper{
-                                                                                       system,
-                                                                                       window} {
+      gpu_profiler{driver}, rasterizer{system.Memory(), pica, system.CustomTexManager(), *this,
+                                       driver, gpu_profiler, system.GetProgramId()},
+      frame_dumper{system, window} {
     const bool has_debug_tool = driver.HasDebugTool();
     window.mailbox = std::make_unique<OGLTextureMailbox>(has_debug_tool);
     if (secondary_window) {
@@ -87,35 +88,50 @@ RendererOpenGL::RendererOpenGL(Core::System& system, Pica::PicaCore& pica_,
     InitOpenGLObjects();
 }
 
-RendererOpenGL::~RendererOpenGL() = default;
+RendererOpenGL::~RendererOpenGL() {
+    CompleteScreenshots(true);
+}
 
 void RendererOpenGL::SwapBuffers() {
+    CompleteScreenshots(false);
+    if (IsTurboSkippedFrame()) {
+        // Nothing is drawn, the window keeps showing the last presented frame
+        gpu_profiler.EndFrame(*system.perf_stats);
+        EndFrame();
+        rasterizer.TickFrame();
+        return;
+    }
+
     // Maintain the rasterizer's state as a priority
     OpenGLState prev_state = OpenGLState::GetCurState();
     state.Apply();
 
-    PrepareRendertarget();
-    RenderScreenshot();
+    {
+        VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Present};
+        PrepareRendertarget();
+        RenderScreenshot();
 
-    const auto& main_layout = render_window.GetFramebufferLayout();
-    RenderToMailbox(main_layout, render_window.mailbox, false);
+        const auto& main_layout = render_window.GetFramebufferLayout();
+        RenderToMailbox(main_layout, render_window.mailbox, false);
 
 #ifndef ANDROID
-    if (Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
-        ASSERT(secondary_window);
-        const auto& secondary_layout = secondary_window->GetFramebufferLayout();
-        RenderToMailbox(secondary_layout, secondary_window->mailbox, false);
-        secondary_window->PollEvents();
-    }
+        if (Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
+            ASSERT(secondary_window);
+            const auto& secondary_layout = secondary_window->GetFramebufferLayout();
+            RenderToMailbox(secondary_layout, secondary_window->mailbox, false);
+            secondary_window->PollEvents();
+        }
 #endif
-    if (frame_dumper.IsDumping()) {
-        try {
-            RenderToMailbox(frame_dumper.GetLayout(), frame_dumper.mailbox, true);
-        } catch (const OGLTextureMailboxException& exception) {
-            LOG_DEBUG(Render_OpenGL, "Frame dumper exception caught: {}", exception.what());
+        if (frame_dumper.IsDumping()) {
+            try {
+                RenderToMailbox(frame_dumper.GetLayout(), frame_dumper.mailbox, true);
+            } catch (const OGLTextureMailboxException& exception) {
+                LOG_DEBUG(Render_OpenGL, "Frame dumper exception caught: {}", exception.what());
+            }
         }
     }
 
+    gpu_profiler.EndFrame(*system.perf_stats);
     EndFrame();
     prev_state.Apply();
     rasterizer.TickFrame();
@@ -141,16 +157,50 @@ void RendererOpenGL::RenderScreenshot() {
 
         DrawScreens(layout, false);
 
+        // Read back to a pixel buffer, it is copied to the screenshot once the fence signals
+        PendingScreenshot& screenshot = pending_screenshots.emplace_back();
+        screenshot.bits = settings.screenshot_bits;
+        screenshot.size = static_cast<GLsizeiptr>(layout.width) * layout.height * 4;
+        screenshot.callback = std::move(settings.screenshot_complete_callback);
+        screenshot.buffer.Create();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, screenshot.buffer.handle);
+        glBufferData(GL_PIXEL_PACK_BUFFER, screenshot.size, nullptr, GL_STREAM_READ);
         glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
-                     settings.screenshot_bits);
+                     nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        screenshot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
         screenshot_framebuffer.Release();
         state.draw.read_framebuffer = old_read_fb;
         state.draw.draw_framebuffer = old_draw_fb;
         state.Apply();
         glDeleteRenderbuffers(1, &renderbuffer);
+    }
+}
+
+void RendererOpenGL::CompleteScreenshots(bool wait) {
+    while (!pending_screenshots.empty()) {
+        PendingScreenshot& screenshot = pending_screenshots.front();
+        const GLenum result = glClientWaitSync(screenshot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                               wait ? GL_TIMEOUT_IGNORED : 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+            return;
+        }
+        glDeleteSync(screenshot.fence);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, screenshot.buffer.handle);
+        const void* mapped =
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, screenshot.size, GL_MAP_READ_BIT);
+        if (mapped) {
+            std::memcpy(screenshot.bits, mapped, screenshot.size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            LOG_ERROR(Render_OpenGL, "Failed to map the screenshot readback buffer");
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-        settings.screenshot_complete_callback(true);
+        screenshot.callback(true);
+        pending_screenshots.pop_front();
     }
 }
 
@@ -173,6 +223,13 @@ void RendererOpenGL::PrepareRendertarget() {
             ConfigureFramebufferTexture(texture, framebuffer);
         }
         LoadFBToScreenInfo(framebuffer, screen_infos[i], i == 1);
+
+        // Without stereo only the eye selected for mono rendering is drawn on the top screen
+        const auto mono_eye = static_cast<u32>(Settings::values.mono_render_option.GetValue());
+        if (i == 2 || Settings::values.render_3d.GetValue() != Settings::StereoRenderOption::Off ||
+            i == mono_eye) {
+            post_processing.Apply(screen_infos[i], i, GetResolutionScaleFactor());
+        }
     }
 }
 
@@ -881,4 +938,8 @@ void RendererOpenGL::Sync() {
     rasterizer.SyncEntireState();
 }
 
+void RendererOpenGL::WaitIdle() {
+    glFinish();
+}
+
 } // namespace OpenGL
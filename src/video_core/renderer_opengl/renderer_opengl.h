@@ -5,9 +5,12 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_opengl/frame_dumper_opengl.h"
 #include "video_core/renderer_opengl/gl_driver.h"
+#include "video_core/renderer_opengl/gl_gpu_profiler.h"
+#include "video_core/renderer_opengl/gl_post_processing.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
@@ -54,12 +57,16 @@ public:
     void PrepareVideoDumping() override;
     void CleanupVideoDumping() override;
     void Sync() override;
+    void WaitIdle() override;
 
 private:
     void InitOpenGLObjects();
     void ReloadShader();
     void PrepareRendertarget();
     void RenderScreenshot();
+    /// Copies the screenshots whose readback finished to their destination, or all of them
+    /// after waiting for the GPU when wait is set
+    void CompleteScreenshots(bool wait);
     void RenderToMailbox(const Layout::FramebufferLayout& layout,
                          std::unique_ptr<Frontend::TextureMailbox>& mailbox, bool flipped);
     void ConfigureFramebufferTexture(TextureInfo& texture,
@@ -83,8 +90,17 @@ private:
     void FillScreen(Common::Vec3<u8> color, TextureInfo& texture);
 
 private:
+    struct PendingScreenshot {
+        OGLBuffer buffer;
+        GLsync fence{};
+        void* bits{};
+        GLsizeiptr size{};
+        std::function<void(bool)> callback;
+    };
+
     Pica::PicaCore& pica;
     Driver driver;
+    GpuProfiler gpu_profiler;
     RasterizerOpenGL rasterizer;
     OpenGLState state;
 
@@ -93,10 +109,12 @@ private:
     OGLBuffer vertex_buffer;
     OGLProgram shader;
     OGLFramebuffer screenshot_framebuffer;
+    std::deque<PendingScreenshot> pending_screenshots;
     std::array<OGLSampler, 2> samplers;
 
     // Display information for top and bottom screens respectively
     std::array<ScreenInfo, 3> screen_infos;
+    PostProcessingChain post_processing;
 
     // Shader uniform location indices
     GLuint uniform_modelview_matrix;
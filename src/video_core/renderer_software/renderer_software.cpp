@@ -18,7 +18,9 @@ RendererSoftware::RendererSoftware(Core::System& system, Pica::PicaCore& pica_,
 RendererSoftware::~RendererSoftware() = default;
 
 void RendererSoftware::SwapBuffers() {
-    PrepareRenderTarget();
+    if (!IsTurboSkippedFrame()) {
+        PrepareRenderTarget();
+    }
     EndFrame();
 }
 
@@ -35,7 +35,9 @@ public:
 
     void SwapBuffers() override;
     void TryPresent(int timeout_ms, bool is_secondary) override {}
-    void Sync() override {}
+    void Sync() override {
+        rasterizer.SyncEntireState();
+    }
 
 private:
     void PrepareRenderTarget();
@@ -2,6 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+#include <vector>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/vector_math.h"
@@ -13,24 +18,161 @@
 
 namespace SwRenderer {
 
-static Common::Vec4<u8> DecodePixel(Pica::PixelFormat input_format, const u8* src_pixel) {
-    switch (input_format) {
-    case Pica::PixelFormat::RGBA8:
-        return Common::Color::DecodeRGBA8(src_pixel);
-    case Pica::PixelFormat::RGB8:
-        return Common::Color::DecodeRGB8(src_pixel);
-    case Pica::PixelFormat::RGB565:
-        return Common::Color::DecodeRGB565(src_pixel);
-    case Pica::PixelFormat::RGB5A1:
-        return Common::Color::DecodeRGB5A1(src_pixel);
-    case Pica::PixelFormat::RGBA4:
-        return Common::Color::DecodeRGBA4(src_pixel);
+namespace {
+
+using Pica::PixelFormat;
+
+/// Row of pixels decoded to RGBA8, each packed with the channels in the Vec4 order
+using DecodedRow = std::span<u32>;
+
+template <PixelFormat format>
+void DecodeRow(const u8* source, DecodedRow row) {
+    constexpr u32 bytes_per_pixel = Pica::BytesPerPixel(format);
+    for (std::size_t x = 0; x < row.size(); ++x) {
+        const u8* pixel = source + x * bytes_per_pixel;
+        Common::Vec4<u8> color;
+        if constexpr (format == PixelFormat::RGBA8) {
+            color = Common::Color::DecodeRGBA8(pixel);
+        } else if constexpr (format == PixelFormat::RGB8) {
+            color = Common::Color::DecodeRGB8(pixel);
+        } else if constexpr (format == PixelFormat::RGB565) {
+            color = Common::Color::DecodeRGB565(pixel);
+        } else if constexpr (format == PixelFormat::RGB5A1) {
+            color = Common::Color::DecodeRGB5A1(pixel);
+        } else {
+            color = Common::Color::DecodeRGBA4(pixel);
+        }
+        std::memcpy(&row[x], color.AsArray(), sizeof(u32));
+    }
+}
+
+template <PixelFormat format>
+void EncodeRow(std::span<const u32> row, u8* dest) {
+    constexpr u32 bytes_per_pixel = Pica::BytesPerPixel(format);
+    for (std::size_t x = 0; x < row.size(); ++x) {
+        u8* pixel = dest + x * bytes_per_pixel;
+        Common::Vec4<u8> color;
+        std::memcpy(color.AsArray(), &row[x], sizeof(u32));
+        if constexpr (format == PixelFormat::RGBA8) {
+            Common::Color::EncodeRGBA8(color, pixel);
+        } else if constexpr (format == PixelFormat::RGB8) {
+            Common::Color::EncodeRGB8(color, pixel);
+        } else if constexpr (format == PixelFormat::RGB565) {
+            Common::Color::EncodeRGB565(color, pixel);
+        } else if constexpr (format == PixelFormat::RGB5A1) {
+            Common::Color::EncodeRGB5A1(color, pixel);
+        } else {
+            Common::Color::EncodeRGBA4(color, pixel);
+        }
+    }
+}
+
+using DecodeRowFunc = void (*)(const u8*, DecodedRow);
+using EncodeRowFunc = void (*)(std::span<const u32>, u8*);
+
+constexpr std::array<DecodeRowFunc, 5> DECODE_ROW = {
+    DecodeRow<PixelFormat::RGBA8>,  DecodeRow<PixelFormat::RGB8>,
+    DecodeRow<PixelFormat::RGB565>, DecodeRow<PixelFormat::RGB5A1>,
+    DecodeRow<PixelFormat::RGBA4>,
+};
+
+constexpr std::array<EncodeRowFunc, 5> ENCODE_ROW = {
+    EncodeRow<PixelFormat::RGBA8>,  EncodeRow<PixelFormat::RGB8>,
+    EncodeRow<PixelFormat::RGB565>, EncodeRow<PixelFormat::RGB5A1>,
+    EncodeRow<PixelFormat::RGBA4>,
+};
+
+/// Spreads the channels of a packed pixel to 16 bits each, so that up to 256 pixels can be summed
+/// without the channels overflowing into each other.
+constexpr u64 Widen(u32 pixel) {
+    return (pixel & 0x00FF00FFULL) | (static_cast<u64>(pixel & 0xFF00FF00U) << 24);
+}
+
+/// Packs the channels of a widened pixel divided by 2^shift, rounding down
+template <u32 shift>
+constexpr u32 Narrow(u64 sum) {
+    const u64 value = (sum >> shift) & 0x00FF00FF00FF00FFULL;
+    return static_cast<u32>(value | (value >> 24));
+}
+
+/// Averages horizontal pairs of pixels
+void DownscaleRowX(std::span<const u32> row, DecodedRow out) {
+    for (std::size_t x = 0; x < out.size(); ++x) {
+        out[x] = Narrow<1>(Widen(row[2 * x]) + Widen(row[2 * x + 1]));
+    }
+}
+
+/// Averages 2x2 blocks of pixels of two rows
+void DownscaleRowXY(std::span<const u32> row0, std::span<const u32> row1, DecodedRow out) {
+    for (std::size_t x = 0; x < out.size(); ++x) {
+        const u64 sum = Widen(row0[2 * x]) + Widen(row0[2 * x + 1]) + Widen(row1[2 * x]) +
+                        Widen(row1[2 * x + 1]);
+        out[x] = Narrow<2>(sum);
+    }
+}
+
+/**
+ * Gathers a row of pixels of a tiled image into linear order. The tiles are walked one at a time,
+ * with the Morton offsets of the row computed once.
+ */
+template <u32 bytes_per_pixel>
+void ReadTiledRow(const u8* image, u32 width, u32 y, u32 count, u8* row) {
+    std::array<u32, 8> offsets;
+    for (u32 x = 0; x < 8; ++x) {
+        offsets[x] = VideoCore::MortonInterleave(x, y) * bytes_per_pixel;
+    }
+    const u8* tile = image + (y & ~7U) * width * bytes_per_pixel;
+    for (u32 x = 0; x < count; x += 8, tile += 64 * bytes_per_pixel) {
+        const u32 tile_pixels = std::min(8U, count - x);
+        for (u32 i = 0; i < tile_pixels; ++i) {
+            std::memcpy(row + (x + i) * bytes_per_pixel, tile + offsets[i], bytes_per_pixel);
+        }
+    }
+}
+
+/// Scatters a linear row of pixels into a tiled image, the counterpart of ReadTiledRow.
+template <u32 bytes_per_pixel>
+void WriteTiledRow(u8* image, u32 width, u32 y, u32 count, const u8* row) {
+    std::array<u32, 8> offsets;
+    for (u32 x = 0; x < 8; ++x) {
+        offsets[x] = VideoCore::MortonInterleave(x, y) * bytes_per_pixel;
+    }
+    u8* tile = image + (y & ~7U) * width * bytes_per_pixel;
+    for (u32 x = 0; x < count; x += 8, tile += 64 * bytes_per_pixel) {
+        const u32 tile_pixels = std::min(8U, count - x);
+        for (u32 i = 0; i < tile_pixels; ++i) {
+            std::memcpy(tile + offsets[i], row + (x + i) * bytes_per_pixel, bytes_per_pixel);
+        }
+    }
+}
+
+using ReadRowFunc = void (*)(const u8*, u32, u32, u32, u8*);
+using WriteRowFunc = void (*)(u8*, u32, u32, u32, const u8*);
+
+ReadRowFunc GetReadTiledRow(u32 bytes_per_pixel) {
+    switch (bytes_per_pixel) {
+    case 2:
+        return ReadTiledRow<2>;
+    case 3:
+        return ReadTiledRow<3>;
+    default:
+        return ReadTiledRow<4>;
+    }
+}
+
+WriteRowFunc GetWriteTiledRow(u32 bytes_per_pixel) {
+    switch (bytes_per_pixel) {
+    case 2:
+        return WriteTiledRow<2>;
+    case 3:
+        return WriteTiledRow<3>;
     default:
-        LOG_ERROR(HW_GPU, "Unknown source framebuffer format {:x}", input_format);
-        return {0, 0, 0, 0};
+        return WriteTiledRow<4>;
     }
 }
 
+} // Anonymous namespace
+
 SwBlitter::SwBlitter(Memory::MemorySystem& memory_, VideoCore::RasterizerInterface* rasterizer_)
     : memory{memory_}, rasterizer{rasterizer_} {}
 
@@ -152,6 +294,14 @@ void SwBlitter::DisplayTransfer(const Pica::DisplayTransferConfig& config) {
         return;
     }
 
+    if (config.input_format.Value() > PixelFormat::RGBA4 ||
+        config.output_format.Value() > PixelFormat::RGBA4) {
+        LOG_ERROR(HW_GPU, "Unknown framebuffer format, input {:x}, output {:x}",
+                  static_cast<u32>(config.input_format.Value()),
+                  static_cast<u32>(config.output_format.Value()));
+        return;
+    }
+
     // Using flip_vertically alongside crop_input_lines produces skewed output on hardware.
     // We have to emulate this because some games rely on this behaviour to render correctly.
     if (config.flip_vertically && config.crop_input_lines) {
@@ -188,106 +338,73 @@ void SwBlitter::DisplayTransfer(const Pica::DisplayTransferConfig& config) {
     rasterizer->FlushRegion(config.GetPhysicalInputAddress(), input_size);
     rasterizer->InvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
+    const u32 src_bytes_per_pixel = BytesPerPixel(config.input_format);
+    const u32 dst_bytes_per_pixel = BytesPerPixel(config.output_format);
+    const u32 input_count = output_width << horizontal_scale;
+    const bool same_format = config.input_format == config.output_format;
+    const bool convert = !same_format || config.scaling != config.NoScale;
+
+    // Tiled rows are gathered to and scattered from linear scratch rows, in which the pixels are
+    // then converted. Round-tripping a format through RGBA8 is lossless, so pixels of the same
+    // format are moved as is.
+    const bool input_tiled = !config.input_linear;
+    const bool output_tiled = config.input_linear.Value() != config.dont_swizzle.Value();
+    const ReadRowFunc read_tiled_row = GetReadTiledRow(src_bytes_per_pixel);
+    const WriteRowFunc write_tiled_row = GetWriteTiledRow(dst_bytes_per_pixel);
+    const DecodeRowFunc decode_row = DECODE_ROW[static_cast<u32>(config.input_format.Value())];
+    const EncodeRowFunc encode_row = ENCODE_ROW[static_cast<u32>(config.output_format.Value())];
+
+    std::vector<u8> src_rows(input_tiled ? input_count * src_bytes_per_pixel * 2 : 0);
+    std::vector<u8> dst_row(output_tiled && convert ? output_width * dst_bytes_per_pixel : 0);
+    std::vector<u32> decoded(convert ? input_count * 2 + output_width : 0);
+    const DecodedRow decoded_rows[2] = {
+        {decoded.data(), convert ? input_count : 0},
+        {decoded.data() + input_count, convert ? input_count : 0},
+    };
+    const DecodedRow scaled_row{decoded.data() + input_count * 2, convert ? output_width : 0};
+
+    const u32 input_rows = config.scaling == config.ScaleXY ? 2 : 1;
     for (u32 y = 0; y < output_height; ++y) {
-        for (u32 x = 0; x < output_width; ++x) {
-            Common::Vec4<u8> src_color;
-
-            // Calculate the [x,y] position of the input image
-            // based on the current output position and the scale
-            const u32 input_x = x << horizontal_scale;
-            const u32 input_y = y << vertical_scale;
-
-            u32 output_y;
-            if (config.flip_vertically) {
-                // Flip the y value of the output data,
-                // we do this after calculating the [x,y] position of the input image
-                // to account for the scaling options.
-                output_y = output_height - y - 1;
+        // Flip the y value of the output data after calculating the input position, to account
+        // for the scaling options.
+        const u32 input_y = y << vertical_scale;
+        const u32 output_y = config.flip_vertically ? output_height - y - 1 : y;
+
+        std::array<const u8*, 2> src_row{};
+        for (u32 i = 0; i < input_rows; ++i) {
+            if (input_tiled) {
+                u8* row = src_rows.data() + i * input_count * src_bytes_per_pixel;
+                read_tiled_row(src_pointer, config.input_width, input_y + i, input_count, row);
+                src_row[i] = row;
             } else {
-                output_y = y;
+                src_row[i] =
+                    src_pointer + (input_y + i) * config.input_width * src_bytes_per_pixel;
             }
+        }
 
-            const u32 dst_bytes_per_pixel = BytesPerPixel(config.output_format);
-            const u32 src_bytes_per_pixel = BytesPerPixel(config.input_format);
-            u32 src_offset;
-            u32 dst_offset;
-
-            if (config.input_linear) {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as linear and the output as tiled
-                    u32 coarse_y = output_y & ~7;
-                    u32 stride = output_width * dst_bytes_per_pixel;
-
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 coarse_y * stride;
-                } else {
-                    // Both input and output are linear
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                }
-            } else {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as tiled and the output as linear
-                    const u32 coarse_y = input_y & ~7;
-                    const u32 stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 coarse_y * stride;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                } else {
-                    // Both input and output are tiled
-                    const u32 out_coarse_y = output_y & ~7;
-                    const u32 out_stride = output_width * dst_bytes_per_pixel;
-
-                    const u32 in_coarse_y = input_y & ~7;
-                    const u32 in_stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 in_coarse_y * in_stride;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 out_coarse_y * out_stride;
-                }
+        u8* const dst_linear_row = dst_pointer + output_y * output_width * dst_bytes_per_pixel;
+        const u8* result = src_row[0];
+        if (convert) {
+            u8* const encoded = output_tiled ? dst_row.data() : dst_linear_row;
+            for (u32 i = 0; i < input_rows; ++i) {
+                decode_row(src_row[i], decoded_rows[i]);
             }
-
-            const u8* src_pixel = src_pointer + src_offset;
-            src_color = DecodePixel(config.input_format, src_pixel);
             if (config.scaling == config.ScaleX) {
-                const auto pixel =
-                    DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
-                src_color = ((src_color + pixel) / 2).Cast<u8>();
+                DownscaleRowX(decoded_rows[0], scaled_row);
+                encode_row(scaled_row, encoded);
             } else if (config.scaling == config.ScaleXY) {
-                const auto pixel1 =
-                    DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
-                const auto pixel2 =
-                    DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
-                const auto pixel3 =
-                    DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
-                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
+                DownscaleRowXY(decoded_rows[0], decoded_rows[1], scaled_row);
+                encode_row(scaled_row, encoded);
+            } else {
+                encode_row(decoded_rows[0], encoded);
             }
+            result = encoded;
+        }
 
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Pica::PixelFormat::RGBA8:
-                Common::Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB8:
-                Common::Color::EncodeRGB8(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB565:
-                Common::Color::EncodeRGB565(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB5A1:
-                Common::Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGBA4:
-                Common::Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
-                          static_cast<u32>(config.output_format.Value()));
-                break;
-            }
+        if (output_tiled) {
+            write_tiled_row(dst_pointer, output_width, output_y, output_width, result);
+        } else if (result != dst_linear_row) {
+            std::memmove(dst_linear_row, result, output_width * dst_bytes_per_pixel);
         }
     }
 }
@@ -10,21 +10,19 @@ namespace SwRenderer {
 using Pica::f16;
 using Pica::LightingRegs;
 
-static float LookupLightingLut(const Pica::PicaCore::Lighting& lighting, std::size_t lut_index,
-                               u8 index, float delta) {
-    ASSERT_MSG(lut_index < lighting.luts.size(), "Out of range lut");
-    ASSERT_MSG(index < lighting.luts[lut_index].size(), "Out of range index");
-
-    const auto& lut = lighting.luts[lut_index][index];
-
-    const float lut_value = lut.ToFloat();
-    const float lut_diff = lut.DiffToFloat();
-
-    return lut_value + lut_diff * delta;
+void LightingLuts::Sync(Pica::PicaCore::Lighting& lighting_state) {
+    for (std::size_t lut_index = 0; lut_index < luts.size(); lut_index++) {
+        auto& dirty = lighting_state.dirty[lut_index];
+        for (u32 i = dirty.begin; i < dirty.end; i++) {
+            const auto& entry = lighting_state.luts[lut_index][i];
+            luts[lut_index][i] = {entry.ToFloat(), entry.DiffToFloat()};
+        }
+        dirty.Clear();
+    }
 }
 
 std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::PicaCore::Lighting& lighting_state,
+    const Pica::LightingRegs& lighting, const LightingLuts& luts,
     const Common::Quaternion<f32>& normquat, const Common::Vec3f& view,
     std::span<const Common::Vec4<u8>, 4> texture_color) {
 
@@ -71,6 +69,8 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
     Common::Vec4f diffuse_sum = {0.0f, 0.0f, 0.0f, 1.0f};
     Common::Vec4f specular_sum = {0.0f, 0.0f, 0.0f, 1.0f};
 
+    const Common::Vec3f norm_view = view.Normalized();
+
     for (u32 light_index = 0; light_index <= lighting.max_light_index; ++light_index) {
         u32 num = lighting.light_enable.GetNum(light_index);
         const auto& light_config = lighting.light[num];
@@ -89,8 +89,8 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
 
         [[maybe_unused]] const f32 length = light_vector.Normalize();
 
-        Common::Vec3f norm_view = view.Normalized();
-        Common::Vec3f half_vector = norm_view + light_vector;
+        const Common::Vec3f half_vector = norm_view + light_vector;
+        const Common::Vec3f norm_half_vector = half_vector.Normalized();
 
         f32 dist_atten = 1.0f;
         if (!lighting.IsDistAttenDisabled(num)) {
@@ -105,7 +105,7 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
                 static_cast<u8>(std::clamp(std::floor(sample_loc * 256.0f), 0.0f, 255.0f));
             const f32 delta = sample_loc * 256 - lutindex;
 
-            dist_atten = LookupLightingLut(lighting_state, lut, lutindex, delta);
+            dist_atten = luts.Lookup(lut, lutindex, delta);
         }
 
         auto get_lut_value = [&](LightingRegs::LightingLutInput input, bool abs,
@@ -115,10 +115,10 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
 
             switch (input) {
             case LightingRegs::LightingLutInput::NH:
-                result = Common::Dot(normal, half_vector.Normalized());
+                result = Common::Dot(normal, norm_half_vector);
                 break;
             case LightingRegs::LightingLutInput::VH:
-                result = Common::Dot(norm_view, half_vector.Normalized());
+                result = Common::Dot(norm_view, norm_half_vector);
                 break;
             case LightingRegs::LightingLutInput::NV:
                 result = Common::Dot(normal, norm_view);
@@ -134,7 +134,6 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
             }
             case LightingRegs::LightingLutInput::CP:
                 if (lighting.config0.config == LightingRegs::LightingConfig::Config7) {
-                    const Common::Vec3f norm_half_vector = half_vector.Normalized();
                     const Common::Vec3f half_vector_proj =
                         norm_half_vector - normal * Common::Dot(normal, norm_half_vector);
                     result = Common::Dot(half_vector_proj, tangent);
@@ -169,8 +168,7 @@ std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
             }
 
             const f32 scale = lighting.lut_scale.GetScale(scale_enum);
-            return scale * LookupLightingLut(lighting_state, static_cast<std::size_t>(sampler),
-                                             index, delta);
+            return scale * luts.Lookup(static_cast<std::size_t>(sampler), index, delta);
         };
 
         // If enabled, compute spot light attenuation value
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <span>
 #include <utility>
 
@@ -13,8 +14,27 @@
 
 namespace SwRenderer {
 
+/**
+ * Float copy of the lighting LUTs, so that fragments do not convert the fixed point entries of
+ * every sample again. Each entry holds the value and the difference to the next entry.
+ */
+class LightingLuts {
+public:
+    /// Converts the entries written since the last call and clears their dirty ranges
+    void Sync(Pica::PicaCore::Lighting& lighting_state);
+
+    /// Returns the entry at index of the LUT, interpolated towards the next one by delta
+    [[nodiscard]] f32 Lookup(std::size_t lut_index, u8 index, f32 delta) const {
+        const Common::Vec2f& entry = luts[lut_index][index];
+        return entry.x + entry.y * delta;
+    }
+
+private:
+    std::array<std::array<Common::Vec2f, 256>, 24> luts{};
+};
+
 std::pair<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::PicaCore::Lighting& lighting_state,
+    const Pica::LightingRegs& lighting, const LightingLuts& luts,
     const Common::Quaternion<f32>& normquat, const Common::Vec3f& view,
     std::span<const Common::Vec4<u8>, 4> texture_color);
 
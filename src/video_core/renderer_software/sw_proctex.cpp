@@ -15,14 +15,23 @@ using ProcTexCombiner = Pica::TexturingRegs::ProcTexCombiner;
 using ProcTexFilter = Pica::TexturingRegs::ProcTexFilter;
 using Pica::f16;
 
-float LookupLUT(const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& lut, float coord) {
+float LookupLUT(const std::array<Common::Vec2f, 128>& lut, float coord) {
     // For NoiseLUT/ColorMap/AlphaMap, coord=0.0 is lut[0], coord=127.0/128.0 is lut[127] and
     // coord=1.0 is lut[127]+lut_diff[127]. For other indices, the result is interpolated using
     // value entries and difference entries.
     coord *= 128;
     const int index_int = std::min(static_cast<int>(coord), 127);
     const float frac = coord - index_int;
-    return lut[index_int].ToFloat() + frac * lut[index_int].DiffToFloat();
+    return lut[index_int].x + frac * lut[index_int].y;
+}
+
+template <typename Entry, typename T, std::size_t N, typename Convert>
+void SyncLUT(std::array<T, N>& table, const std::array<Entry, N>& lut,
+             Pica::PicaCore::LutDirtyRange& dirty, Convert&& convert) {
+    for (u32 i = dirty.begin; i < dirty.end; i++) {
+        table[i] = convert(lut[i]);
+    }
+    dirty.Clear();
 }
 
 // These function are used to generate random noise for procedural texture. Their results are
@@ -46,14 +55,9 @@ float NoiseRand2D(unsigned int x, unsigned int y) {
     return -1.0f + v2 * 2.0f / 15.0f;
 }
 
-float NoiseCoef(float u, float v, const Pica::TexturingRegs& regs,
-                const Pica::PicaCore::ProcTex& state) {
-    const float freq_u = f16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32();
-    const float freq_v = f16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32();
-    const float phase_u = f16::FromRaw(regs.proctex_noise_u.phase).ToFloat32();
-    const float phase_v = f16::FromRaw(regs.proctex_noise_v.phase).ToFloat32();
-    const float x = 9 * freq_u * std::abs(u + phase_u);
-    const float y = 9 * freq_v * std::abs(v + phase_v);
+float NoiseCoef(float u, float v, const ProcTexTables& tables) {
+    const float x = 9 * tables.noise_frequency.x * std::abs(u + tables.noise_phase.x);
+    const float y = 9 * tables.noise_frequency.y * std::abs(v + tables.noise_phase.y);
     const int x_int = static_cast<int>(x);
     const int y_int = static_cast<int>(y);
     const float x_frac = x - x_int;
@@ -63,8 +67,8 @@ float NoiseCoef(float u, float v, const Pica::TexturingRegs& regs,
     const float g1 = NoiseRand2D(x_int + 1, y_int) * (x_frac + y_frac - 1);
     const float g2 = NoiseRand2D(x_int, y_int + 1) * (x_frac + y_frac - 1);
     const float g3 = NoiseRand2D(x_int + 1, y_int + 1) * (x_frac + y_frac - 2);
-    const float x_noise = LookupLUT(state.noise_table, x_frac);
-    const float y_noise = LookupLUT(state.noise_table, y_frac);
+    const float x_noise = LookupLUT(tables.noise_table, x_frac);
+    const float y_noise = LookupLUT(tables.noise_table, y_frac);
     return Common::BilinearInterp(g0, g1, g2, g3, x_noise, y_noise);
 }
 
@@ -115,7 +119,7 @@ void ClampCoord(float& coord, ProcTexClamp mode) {
 }
 
 float CombineAndMap(float u, float v, ProcTexCombiner combiner,
-                    const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& map_table) {
+                    const std::array<Common::Vec2f, 128>& map_table) {
     float f;
     switch (combiner) {
     case ProcTexCombiner::U:
@@ -157,8 +161,30 @@ float CombineAndMap(float u, float v, ProcTexCombiner combiner,
 }
 } // Anonymous namespace
 
+void ProcTexTables::Sync(const Pica::TexturingRegs& regs, Pica::PicaCore::ProcTex& state) {
+    const auto value_entry = [](const Pica::PicaCore::ProcTex::ValueEntry& entry) {
+        return Common::MakeVec(entry.ToFloat(), entry.DiffToFloat());
+    };
+    SyncLUT(noise_table, state.noise_table, state.noise_dirty, value_entry);
+    SyncLUT(color_map_table, state.color_map_table, state.color_map_dirty, value_entry);
+    SyncLUT(alpha_map_table, state.alpha_map_table, state.alpha_map_dirty, value_entry);
+    SyncLUT(color_table, state.color_table, state.color_dirty,
+            [](const Pica::PicaCore::ProcTex::ColorEntry& entry) {
+                return entry.ToVector().Cast<float>();
+            });
+    SyncLUT(color_diff_table, state.color_diff_table, state.color_diff_dirty,
+            [](const Pica::PicaCore::ProcTex::ColorDifferenceEntry& entry) {
+                return entry.ToVector().Cast<float>();
+            });
+
+    noise_frequency = {f16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32(),
+                       f16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32()};
+    noise_phase = {f16::FromRaw(regs.proctex_noise_u.phase).ToFloat32(),
+                   f16::FromRaw(regs.proctex_noise_v.phase).ToFloat32()};
+}
+
 Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
-                         const Pica::PicaCore::ProcTex& state) {
+                         const ProcTexTables& tables) {
     u = std::abs(u);
     v = std::abs(v);
 
@@ -168,7 +194,7 @@ Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
 
     // Generate noise
     if (regs.proctex.noise_enable) {
-        float noise = NoiseCoef(u, v, regs, state);
+        float noise = NoiseCoef(u, v, tables);
         u += noise * regs.proctex_noise_u.amplitude / 4095.0f;
         v += noise * regs.proctex_noise_v.amplitude / 4095.0f;
         u = std::abs(u);
@@ -184,7 +210,8 @@ Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
     ClampCoord(v, regs.proctex.v_clamp);
 
     // Combine and map
-    const float lut_coord = CombineAndMap(u, v, regs.proctex.color_combiner, state.color_map_table);
+    const float lut_coord =
+        CombineAndMap(u, v, regs.proctex.color_combiner, tables.color_map_table);
 
     // Look up the color
     // For the color lut, coord=0.0 is lut[offset] and coord=1.0 is lut[offset+width-1]
@@ -199,15 +226,15 @@ Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
     case ProcTexFilter::LinearMipmapNearest: {
         const int index_int = static_cast<int>(index);
         const float frac = index - index_int;
-        const auto color_value = state.color_table[index_int].ToVector().Cast<float>();
-        const auto color_diff = state.color_diff_table[index_int].ToVector().Cast<float>();
+        const auto& color_value = tables.color_table[index_int];
+        const auto& color_diff = tables.color_diff_table[index_int];
         final_color = (color_value + frac * color_diff).Cast<u8>();
         break;
     }
     case ProcTexFilter::Nearest:
     case ProcTexFilter::NearestMipmapLinear:
     case ProcTexFilter::NearestMipmapNearest:
-        final_color = state.color_table[static_cast<int>(std::round(index))].ToVector();
+        final_color = tables.color_table[static_cast<int>(std::round(index))].Cast<u8>();
         break;
     }
 
@@ -215,7 +242,7 @@ Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
         // Note: in separate alpha mode, the alpha channel skips the color LUT look up stage. It
         // uses the output of CombineAndMap directly instead.
         const float final_alpha =
-            CombineAndMap(u, v, regs.proctex.alpha_combiner, state.alpha_map_table);
+            CombineAndMap(u, v, regs.proctex.alpha_combiner, tables.alpha_map_table);
         return Common::MakeVec<u8>(final_color.rgb(), static_cast<u8>(final_alpha * 255));
     } else {
         return final_color;
@@ -4,14 +4,34 @@
 
 #pragma once
 
+#include <array>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica/pica_core.h"
 
 namespace SwRenderer {
 
+/**
+ * Float copy of the procedural texture LUTs and noise parameters, so that samples do not convert
+ * the fixed point entries and registers again. Value LUT entries hold the value and the
+ * difference to the next entry.
+ */
+struct ProcTexTables {
+    /// Converts the LUT entries written since the last call and the noise registers
+    void Sync(const Pica::TexturingRegs& regs, Pica::PicaCore::ProcTex& state);
+
+    std::array<Common::Vec2f, 128> noise_table{};
+    std::array<Common::Vec2f, 128> color_map_table{};
+    std::array<Common::Vec2f, 128> alpha_map_table{};
+    std::array<Common::Vec4f, 256> color_table{};
+    std::array<Common::Vec4f, 256> color_diff_table{};
+
+    Common::Vec2f noise_frequency{};
+    Common::Vec2f noise_phase{};
+};
+
 /// Generates procedural texture color for the given coordinates
 Common::Vec4<u8> ProcTex(float u, float v, const Pica::TexturingRegs& regs,
-                         const Pica::PicaCore::ProcTex& state);
+                         const ProcTexTables& tables);
 
 } // namespace SwRenderer
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <boost/container/static_vector.hpp>
+#include "common/arch.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/quaternion.h"
@@ -17,13 +18,18 @@
 #include "video_core/renderer_software/sw_texturing.h"
 #include "video_core/texture/texture_decode.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace SwRenderer {
 
 using Pica::f24;
 using Pica::FramebufferRegs;
 using Pica::RasterizerRegs;
 using Pica::TexturingRegs;
-using Pica::Texture::LookupTexture;
 using Pica::Texture::TextureInfo;
 
 // Certain games render 2D elements very close to clip plane 0 resulting in very tiny
@@ -32,6 +38,11 @@ using Pica::Texture::TextureInfo;
 // we can use a very small epsilon value for clip plane comparison.
 constexpr f32 EPSILON_Z = 0.00000001f;
 
+// Triangles are binned into square screen tiles of this many pixels per side, which are then
+// shaded in parallel.
+constexpr u32 TILE_SIZE_BITS = 5;
+constexpr u32 TILE_SIZE = 1U << TILE_SIZE_BITS;
+
 struct Vertex : Pica::OutputVertex {
     Vertex(const OutputVertex& v) : OutputVertex(v) {}
 
@@ -66,6 +77,17 @@ struct Vertex : Pica::OutputVertex {
     }
 };
 
+struct RasterizerSoftware::Triangle {
+    std::array<Vertex, 3> vertices;
+    std::array<Common::Vec3<Fix12P4>, 3> vtxpos;
+    std::array<int, 3> bias;
+    /// Bounding box in 12.4 fixed point, already clipped to the scissor box if it is inclusive.
+    u16 min_x;
+    u16 min_y;
+    u16 max_x;
+    u16 max_y;
+};
+
 namespace {
 
 MICROPROFILE_DEFINE(GPU_Rasterization, "GPU", "Rasterization", MP_RGB(50, 50, 240));
@@ -98,12 +120,79 @@ private:
     Common::Vec4<f24> bias;
 };
 
+/// Edge functions of a run of horizontally adjacent pixels, evaluated all at once.
+struct EdgeSpan {
+    static constexpr std::size_t NumPixels = 4;
+
+    std::array<std::array<s32, NumPixels>, 3> w;
+    u32 coverage; ///< Bit i is set if pixel i is covered by the triangle
+
+    bool IsCovered(u32 pixel) const {
+        return (coverage >> pixel) & 1;
+    }
+};
+
+/**
+ * Evaluates the three edge functions for EdgeSpan::NumPixels pixels, given their values at the
+ * first pixel and the increment from one pixel to the next. A pixel is covered when none of its
+ * edge functions is negative.
+ */
+EdgeSpan EvaluateEdgeSpan(const std::array<s32, 3>& start, const std::array<s32, 3>& step) {
+    EdgeSpan span;
+#if CITRA_ARCH(x86_64)
+    __m128i any_negative = _mm_setzero_si128();
+    for (std::size_t i = 0; i < 3; i++) {
+        const __m128i lanes = _mm_add_epi32(_mm_set1_epi32(start[i]),
+                                            _mm_setr_epi32(0, step[i], step[i] * 2, step[i] * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(span.w[i].data()), lanes);
+        any_negative = _mm_or_si128(any_negative, lanes);
+    }
+    span.coverage = ~_mm_movemask_ps(_mm_castsi128_ps(any_negative)) & 0xF;
+#elif CITRA_ARCH(arm64)
+    static constexpr std::array<s32, 4> lane_index = {0, 1, 2, 3};
+    const int32x4_t offsets = vld1q_s32(lane_index.data());
+    uint32x4_t any_negative = vdupq_n_u32(0);
+    for (std::size_t i = 0; i < 3; i++) {
+        const int32x4_t lanes = vmlaq_n_s32(vdupq_n_s32(start[i]), offsets, step[i]);
+        vst1q_s32(span.w[i].data(), lanes);
+        any_negative = vorrq_u32(any_negative, vreinterpretq_u32_s32(lanes));
+    }
+    const uint32x4_t sign_bits = vshlq_u32(vshrq_n_u32(any_negative, 31), offsets);
+    span.coverage = ~vaddvq_u32(sign_bits) & 0xF;
+#else
+    span.coverage = 0;
+    for (u32 pixel = 0; pixel < EdgeSpan::NumPixels; pixel++) {
+        bool covered = true;
+        for (std::size_t i = 0; i < 3; i++) {
+            span.w[i][pixel] = start[i] + step[i] * static_cast<s32>(pixel);
+            covered &= span.w[i][pixel] >= 0;
+        }
+        span.coverage |= static_cast<u32>(covered) << pixel;
+    }
+#endif
+    return span;
+}
+
 } // Anonymous namespace
 
 RasterizerSoftware::RasterizerSoftware(Memory::MemorySystem& memory_, Pica::PicaCore& pica_)
     : memory{memory_}, pica{pica_}, regs{pica.regs.internal},
-      num_sw_threads{std::max(std::thread::hardware_concurrency(), 2U)},
-      sw_workers{num_sw_threads, "SwRenderer workers"}, fb{memory, regs.framebuffer} {}
+      sw_workers{Common::TaskPriority::High}, fb{memory, regs.framebuffer} {
+    SyncEntireState();
+}
+
+void RasterizerSoftware::SyncEntireState() {
+    for (auto& dirty : pica.lighting.dirty) {
+        dirty.MarkAll(256);
+    }
+    pica.proctex.noise_dirty.MarkAll(128);
+    pica.proctex.color_map_dirty.MarkAll(128);
+    pica.proctex.alpha_map_dirty.MarkAll(128);
+    pica.proctex.color_dirty.MarkAll(256);
+    pica.proctex.color_diff_dirty.MarkAll(256);
+}
+
+RasterizerSoftware::~RasterizerSoftware() = default;
 
 void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                                      const Pica::OutputVertex& v2) {
@@ -229,8 +318,6 @@ void RasterizerSoftware::MakeScreenCoords(Vertex& vtx) {
 
 void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2,
                                          bool reversed) {
-    MICROPROFILE_SCOPE(GPU_Rasterization);
-
     // Vertex positions in rasterizer coordinates
     static auto screen_to_rasterizer_coords = [](const Common::Vec3<f24>& vec) {
         return Common::Vec3{Fix12P4::FromFloat24(vec.x), Fix12P4::FromFloat24(vec.y),
@@ -285,6 +372,9 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
     min_y &= Fix12P4::IntMask();
     max_x = ((max_x + Fix12P4::FracMask()) & Fix12P4::IntMask());
     max_y = ((max_y + Fix12P4::FracMask()) & Fix12P4::IntMask());
+    if (min_x >= max_x || min_y >= max_y) {
+        return;
+    }
 
     const int bias0 =
         IsRightSideOrFlatBottomEdge(vtxpos[0].xy(), vtxpos[1].xy(), vtxpos[2].xy()) ? -1 : 0;
@@ -293,187 +383,310 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
     const int bias2 =
         IsRightSideOrFlatBottomEdge(vtxpos[2].xy(), vtxpos[0].xy(), vtxpos[1].xy()) ? -1 : 0;
 
-    const auto w_inverse = Common::MakeVec(v0.pos.w, v1.pos.w, v2.pos.w);
+    triangles.push_back(Triangle{
+        .vertices = {v0, v1, v2},
+        .vtxpos = vtxpos,
+        .bias = {bias0, bias1, bias2},
+        .min_x = min_x,
+        .min_y = min_y,
+        .max_x = max_x,
+        .max_y = max_y,
+    });
+}
+
+void RasterizerSoftware::DrawTriangles() {
+    if (triangles.empty()) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_Rasterization);
+
+    // Bin the triangles into the screen tiles their bounding boxes overlap. Tiles do not share
+    // pixels, so they can be shaded concurrently as long as each one keeps the submission order.
+    // Bounds are in 12.4 fixed point, hence the extra 4 bits of shift.
+    constexpr u32 TileShift = 4 + TILE_SIZE_BITS;
+    u16 min_x = triangles[0].min_x;
+    u16 min_y = triangles[0].min_y;
+    u16 max_x = triangles[0].max_x;
+    u16 max_y = triangles[0].max_y;
+    for (const Triangle& triangle : triangles) {
+        min_x = std::min(min_x, triangle.min_x);
+        min_y = std::min(min_y, triangle.min_y);
+        max_x = std::max(max_x, triangle.max_x);
+        max_y = std::max(max_y, triangle.max_y);
+    }
+
+    const u32 first_tile_x = min_x >> TileShift;
+    const u32 first_tile_y = min_y >> TileShift;
+    const u32 num_tiles_x = ((max_x - 1) >> TileShift) - first_tile_x + 1;
+    const u32 num_tiles_y = ((max_y - 1) >> TileShift) - first_tile_y + 1;
+
+    tile_bins.resize(std::max<std::size_t>(tile_bins.size(), num_tiles_x * num_tiles_y));
+    for (u32 i = 0; i < static_cast<u32>(triangles.size()); i++) {
+        const Triangle& triangle = triangles[i];
+        for (u32 ty = (triangle.min_y >> TileShift); ty <= ((triangle.max_y - 1) >> TileShift);
+             ty++) {
+            for (u32 tx = (triangle.min_x >> TileShift);
+                 tx <= ((triangle.max_x - 1) >> TileShift); tx++) {
+                tile_bins[(ty - first_tile_y) * num_tiles_x + (tx - first_tile_x)].push_back(i);
+            }
+        }
+    }
 
     const auto textures = regs.texturing.GetTextures();
     const auto tev_stages = regs.texturing.GetTevStages();
+    if (!regs.lighting.disable) {
+        lighting_luts.Sync(pica.lighting);
+    }
+    if (regs.texturing.main_config.texture3_enable) {
+        proctex_tables.Sync(regs.texturing, pica.proctex);
+    }
 
     fb.Bind();
 
+    for (u32 ty = 0; ty < num_tiles_y; ty++) {
+        for (u32 tx = 0; tx < num_tiles_x; tx++) {
+            auto& bin = tile_bins[ty * num_tiles_x + tx];
+            if (bin.empty()) {
+                continue;
+            }
+            const u16 tile_x = static_cast<u16>((first_tile_x + tx) << TileShift);
+            const u16 tile_y = static_cast<u16>((first_tile_y + ty) << TileShift);
+            sw_workers.QueueWork([this, &bin, tile_x, tile_y, textures, tev_stages] {
+                TextureTileCache tile_cache;
+                for (const u32 index : bin) {
+                    RasterizeTriangle(triangles[index], tile_x, tile_y, textures, tev_stages,
+                                      tile_cache);
+                }
+                bin.clear();
+            });
+        }
+    }
+    sw_workers.WaitForRequests();
+    triangles.clear();
+}
+
+void RasterizerSoftware::RasterizeTriangle(
+    const Triangle& triangle, u16 tile_x, u16 tile_y,
+    std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures,
+    std::span<const Pica::TexturingRegs::TevStageConfig, 6> tev_stages,
+    TextureTileCache& tile_cache) {
+    const Vertex& v0 = triangle.vertices[0];
+    const Vertex& v1 = triangle.vertices[1];
+    const Vertex& v2 = triangle.vertices[2];
+    const auto& vtxpos = triangle.vtxpos;
+    const auto [bias0, bias1, bias2] = triangle.bias;
+
+    // Convert the scissor box coordinates to 12.4 fixed point
+    const u16 scissor_x1 = static_cast<u16>(regs.rasterizer.scissor_test.x1 << 4);
+    const u16 scissor_y1 = static_cast<u16>(regs.rasterizer.scissor_test.y1 << 4);
+    // x2,y2 have +1 added to cover the entire sub-pixel area
+    const u16 scissor_x2 = static_cast<u16>((regs.rasterizer.scissor_test.x2 + 1) << 4);
+    const u16 scissor_y2 = static_cast<u16>((regs.rasterizer.scissor_test.y2 + 1) << 4);
+
+    // Only the part of the bounding box that lies inside the tile.
+    constexpr u32 TileExtent = TILE_SIZE << 4;
+    const u16 min_x = std::max(triangle.min_x, tile_x);
+    const u16 min_y = std::max(triangle.min_y, tile_y);
+    const u16 max_x = static_cast<u16>(std::min<u32>(triangle.max_x, tile_x + TileExtent));
+    const u16 max_y = static_cast<u16>(std::min<u32>(triangle.max_y, tile_y + TileExtent));
+
+    const auto w_inverse = Common::MakeVec(v0.pos.w, v1.pos.w, v2.pos.w);
+
+    // The edge functions are linear, so they only change by a constant from one pixel to the next.
+    const std::array<s32, 3> edge_step = {
+        (static_cast<s32>(vtxpos[1].y) - static_cast<s32>(vtxpos[2].y)) * 0x10,
+        (static_cast<s32>(vtxpos[2].y) - static_cast<s32>(vtxpos[0].y)) * 0x10,
+        (static_cast<s32>(vtxpos[0].y) - static_cast<s32>(vtxpos[1].y)) * 0x10,
+    };
+
     // Enter rasterization loop, starting at the center of the topleft bounding box corner.
     // TODO: Not sure if looping through x first might be faster
     for (u16 y = min_y + 8; y < max_y; y += 0x10) {
-        const auto process_scanline = [&, y] {
-            for (u16 x = min_x + 8; x < max_x; x += 0x10) {
-                // Do not process the pixel if it's inside the scissor box and the scissor mode is
-                // set to Exclude.
-                if (regs.rasterizer.scissor_test.mode == RasterizerRegs::ScissorMode::Exclude) {
-                    if (x >= scissor_x1 && x < scissor_x2 && y >= scissor_y1 && y < scissor_y2) {
-                        continue;
-                    }
+        // Calculate the barycentric coordinates w0, w1 and w2 of the first pixel of the row
+        const u16 row_x = min_x + 8;
+        std::array<s32, 3> span_start = {
+            bias0 + SignedArea(vtxpos[1].xy(), vtxpos[2].xy(), {row_x, y}),
+            bias1 + SignedArea(vtxpos[2].xy(), vtxpos[0].xy(), {row_x, y}),
+            bias2 + SignedArea(vtxpos[0].xy(), vtxpos[1].xy(), {row_x, y}),
+        };
+        EdgeSpan span;
+
+        for (u16 x = row_x; x < max_x; x += 0x10) {
+            const u32 lane = ((x - row_x) >> 4) % EdgeSpan::NumPixels;
+            if (lane == 0) {
+                span = EvaluateEdgeSpan(span_start, edge_step);
+                for (std::size_t i = 0; i < span_start.size(); i++) {
+                    span_start[i] += edge_step[i] * static_cast<s32>(EdgeSpan::NumPixels);
                 }
+            }
 
-                // Calculate the barycentric coordinates w0, w1 and w2
-                const s32 w0 = bias0 + SignedArea(vtxpos[1].xy(), vtxpos[2].xy(), {x, y});
-                const s32 w1 = bias1 + SignedArea(vtxpos[2].xy(), vtxpos[0].xy(), {x, y});
-                const s32 w2 = bias2 + SignedArea(vtxpos[0].xy(), vtxpos[1].xy(), {x, y});
-                const s32 wsum = w0 + w1 + w2;
+            // If current pixel is not covered by the current primitive
+            if (!span.IsCovered(lane)) {
+                continue;
+            }
 
-                // If current pixel is not covered by the current primitive
-                if (w0 < 0 || w1 < 0 || w2 < 0) {
+            // Do not process the pixel if it's inside the scissor box and the scissor mode is
+            // set to Exclude.
+            if (regs.rasterizer.scissor_test.mode == RasterizerRegs::ScissorMode::Exclude) {
+                if (x >= scissor_x1 && x < scissor_x2 && y >= scissor_y1 && y < scissor_y2) {
                     continue;
                 }
+            }
 
-                const auto baricentric_coordinates = Common::MakeVec(
-                    f24::FromFloat32(static_cast<f32>(w0)), f24::FromFloat32(static_cast<f32>(w1)),
-                    f24::FromFloat32(static_cast<f32>(w2)));
-                const f24 interpolated_w_inverse =
-                    f24::One() / Common::Dot(w_inverse, baricentric_coordinates);
-
-                // interpolated_z = z / w
-                const float interpolated_z_over_w =
-                    (v0.screenpos[2].ToFloat32() * w0 + v1.screenpos[2].ToFloat32() * w1 +
-                     v2.screenpos[2].ToFloat32() * w2) /
-                    wsum;
-
-                // Not fully accurate. About 3 bits in precision are missing.
-                // Z-Buffer (z / w * scale + offset)
-                const float depth_scale =
-                    f24::FromRaw(regs.rasterizer.viewport_depth_range).ToFloat32();
-                const float depth_offset =
-                    f24::FromRaw(regs.rasterizer.viewport_depth_near_plane).ToFloat32();
-                float depth = interpolated_z_over_w * depth_scale + depth_offset;
-
-                // Potentially switch to W-Buffer
-                if (regs.rasterizer.depthmap_enable ==
-                    Pica::RasterizerRegs::DepthBuffering::WBuffering) {
-                    // W-Buffer (z * scale + w * offset = (z / w * scale + offset) * w)
-                    depth *= interpolated_w_inverse.ToFloat32() * wsum;
-                }
+            const s32 w0 = span.w[0][lane];
+            const s32 w1 = span.w[1][lane];
+            const s32 w2 = span.w[2][lane];
+            const s32 wsum = w0 + w1 + w2;
+
+            const auto baricentric_coordinates = Common::MakeVec(
+                f24::FromFloat32(static_cast<f32>(w0)), f24::FromFloat32(static_cast<f32>(w1)),
+                f24::FromFloat32(static_cast<f32>(w2)));
+            const f24 interpolated_w_inverse =
+                f24::One() / Common::Dot(w_inverse, baricentric_coordinates);
+
+            // interpolated_z = z / w
+            const float interpolated_z_over_w =
+                (v0.screenpos[2].ToFloat32() * w0 + v1.screenpos[2].ToFloat32() * w1 +
+                 v2.screenpos[2].ToFloat32() * w2) /
+                wsum;
+
+            // Not fully accurate. About 3 bits in precision are missing.
+            // Z-Buffer (z / w * scale + offset)
+            const float depth_scale =
+                f24::FromRaw(regs.rasterizer.viewport_depth_range).ToFloat32();
+            const float depth_offset =
+                f24::FromRaw(regs.rasterizer.viewport_depth_near_plane).ToFloat32();
+            float depth = interpolated_z_over_w * depth_scale + depth_offset;
+
+            // Potentially switch to W-Buffer
+            if (regs.rasterizer.depthmap_enable ==
+                Pica::RasterizerRegs::DepthBuffering::WBuffering) {
+                // W-Buffer (z * scale + w * offset = (z / w * scale + offset) * w)
+                depth *= interpolated_w_inverse.ToFloat32() * wsum;
+            }
 
-                // Clamp the result
-                depth = std::clamp(depth, 0.0f, 1.0f);
-
-                /**
-                 * Perspective correct attribute interpolation:
-                 * Attribute values cannot be calculated by simple linear interpolation since
-                 * they are not linear in screen space. For example, when interpolating a
-                 * texture coordinate across two vertices, something simple like
-                 *     u = (u0*w0 + u1*w1)/(w0+w1)
-                 * will not work. However, the attribute value divided by the
-                 * clipspace w-coordinate (u/w) and and the inverse w-coordinate (1/w) are linear
-                 * in screenspace. Hence, we can linearly interpolate these two independently and
-                 * calculate the interpolated attribute by dividing the results.
-                 * I.e.
-                 *     u_over_w   = ((u0/v0.pos.w)*w0 + (u1/v1.pos.w)*w1)/(w0+w1)
-                 *     one_over_w = (( 1/v0.pos.w)*w0 + ( 1/v1.pos.w)*w1)/(w0+w1)
-                 *     u = u_over_w / one_over_w
-                 *
-                 * The generalization to three vertices is straightforward in baricentric
-                 *coordinates.
-                 **/
-                const auto get_interpolated_attribute = [&](f24 attr0, f24 attr1, f24 attr2) {
-                    auto attr_over_w = Common::MakeVec(attr0, attr1, attr2);
-                    f24 interpolated_attr_over_w =
-                        Common::Dot(attr_over_w, baricentric_coordinates);
-                    return interpolated_attr_over_w * interpolated_w_inverse;
-                };
+            // Clamp the result
+            depth = std::clamp(depth, 0.0f, 1.0f);
+
+            /**
+             * Perspective correct attribute interpolation:
+             * Attribute values cannot be calculated by simple linear interpolation since
+             * they are not linear in screen space. For example, when interpolating a
+             * texture coordinate across two vertices, something simple like
+             *     u = (u0*w0 + u1*w1)/(w0+w1)
+             * will not work. However, the attribute value divided by the
+             * clipspace w-coordinate (u/w) and and the inverse w-coordinate (1/w) are linear
+             * in screenspace. Hence, we can linearly interpolate these two independently and
+             * calculate the interpolated attribute by dividing the results.
+             * I.e.
+             *     u_over_w   = ((u0/v0.pos.w)*w0 + (u1/v1.pos.w)*w1)/(w0+w1)
+             *     one_over_w = (( 1/v0.pos.w)*w0 + ( 1/v1.pos.w)*w1)/(w0+w1)
+             *     u = u_over_w / one_over_w
+             *
+             * The generalization to three vertices is straightforward in baricentric
+             *coordinates.
+             **/
+            const auto get_interpolated_attribute = [&](f24 attr0, f24 attr1, f24 attr2) {
+                auto attr_over_w = Common::MakeVec(attr0, attr1, attr2);
+                f24 interpolated_attr_over_w =
+                    Common::Dot(attr_over_w, baricentric_coordinates);
+                return interpolated_attr_over_w * interpolated_w_inverse;
+            };
+
+            const Common::Vec4<u8> primary_color{
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.r(), v1.color.r(), v2.color.r())
+                              .ToFloat32() *
+                          255)),
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.g(), v1.color.g(), v2.color.g())
+                              .ToFloat32() *
+                          255)),
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.b(), v1.color.b(), v2.color.b())
+                              .ToFloat32() *
+                          255)),
+                static_cast<u8>(
+                    round(get_interpolated_attribute(v0.color.a(), v1.color.a(), v2.color.a())
+                              .ToFloat32() *
+                          255)),
+            };
+
+            std::array<Common::Vec2<f24>, 3> uv;
+            uv[0].u() = get_interpolated_attribute(v0.tc0.u(), v1.tc0.u(), v2.tc0.u());
+            uv[0].v() = get_interpolated_attribute(v0.tc0.v(), v1.tc0.v(), v2.tc0.v());
+            uv[1].u() = get_interpolated_attribute(v0.tc1.u(), v1.tc1.u(), v2.tc1.u());
+            uv[1].v() = get_interpolated_attribute(v0.tc1.v(), v1.tc1.v(), v2.tc1.v());
+            uv[2].u() = get_interpolated_attribute(v0.tc2.u(), v1.tc2.u(), v2.tc2.u());
+            uv[2].v() = get_interpolated_attribute(v0.tc2.v(), v1.tc2.v(), v2.tc2.v());
+
+            // Sample bound texture units.
+            const f24 tc0_w = get_interpolated_attribute(v0.tc0_w, v1.tc0_w, v2.tc0_w);
+            const auto texture_color = TextureColor(uv, textures, tc0_w, tile_cache);
+
+            Common::Vec4<u8> primary_fragment_color = {0, 0, 0, 0};
+            Common::Vec4<u8> secondary_fragment_color = {0, 0, 0, 0};
+
+            if (!regs.lighting.disable) {
+                const auto normquat =
+                    Common::Quaternion<f32>{
+                        {get_interpolated_attribute(v0.quat.x, v1.quat.x, v2.quat.x)
+                             .ToFloat32(),
+                         get_interpolated_attribute(v0.quat.y, v1.quat.y, v2.quat.y)
+                             .ToFloat32(),
+                         get_interpolated_attribute(v0.quat.z, v1.quat.z, v2.quat.z)
+                             .ToFloat32()},
+                        get_interpolated_attribute(v0.quat.w, v1.quat.w, v2.quat.w).ToFloat32(),
+                    }
+                        .Normalized();
 
-                const Common::Vec4<u8> primary_color{
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.r(), v1.color.r(), v2.color.r())
-                                  .ToFloat32() *
-                              255)),
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.g(), v1.color.g(), v2.color.g())
-                                  .ToFloat32() *
-                              255)),
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.b(), v1.color.b(), v2.color.b())
-                                  .ToFloat32() *
-                              255)),
-                    static_cast<u8>(
-                        round(get_interpolated_attribute(v0.color.a(), v1.color.a(), v2.color.a())
-                                  .ToFloat32() *
-                              255)),
+                const Common::Vec3f view{
+                    get_interpolated_attribute(v0.view.x, v1.view.x, v2.view.x).ToFloat32(),
+                    get_interpolated_attribute(v0.view.y, v1.view.y, v2.view.y).ToFloat32(),
+                    get_interpolated_attribute(v0.view.z, v1.view.z, v2.view.z).ToFloat32(),
                 };
+                std::tie(primary_fragment_color, secondary_fragment_color) =
+                    ComputeFragmentsColors(regs.lighting, lighting_luts, normquat, view,
+                                           texture_color);
+            }
 
-                std::array<Common::Vec2<f24>, 3> uv;
-                uv[0].u() = get_interpolated_attribute(v0.tc0.u(), v1.tc0.u(), v2.tc0.u());
-                uv[0].v() = get_interpolated_attribute(v0.tc0.v(), v1.tc0.v(), v2.tc0.v());
-                uv[1].u() = get_interpolated_attribute(v0.tc1.u(), v1.tc1.u(), v2.tc1.u());
-                uv[1].v() = get_interpolated_attribute(v0.tc1.v(), v1.tc1.v(), v2.tc1.v());
-                uv[2].u() = get_interpolated_attribute(v0.tc2.u(), v1.tc2.u(), v2.tc2.u());
-                uv[2].v() = get_interpolated_attribute(v0.tc2.v(), v1.tc2.v(), v2.tc2.v());
-
-                // Sample bound texture units.
-                const f24 tc0_w = get_interpolated_attribute(v0.tc0_w, v1.tc0_w, v2.tc0_w);
-                const auto texture_color = TextureColor(uv, textures, tc0_w);
-
-                Common::Vec4<u8> primary_fragment_color = {0, 0, 0, 0};
-                Common::Vec4<u8> secondary_fragment_color = {0, 0, 0, 0};
-
-                if (!regs.lighting.disable) {
-                    const auto normquat =
-                        Common::Quaternion<f32>{
-                            {get_interpolated_attribute(v0.quat.x, v1.quat.x, v2.quat.x)
-                                 .ToFloat32(),
-                             get_interpolated_attribute(v0.quat.y, v1.quat.y, v2.quat.y)
-                                 .ToFloat32(),
-                             get_interpolated_attribute(v0.quat.z, v1.quat.z, v2.quat.z)
-                                 .ToFloat32()},
-                            get_interpolated_attribute(v0.quat.w, v1.quat.w, v2.quat.w).ToFloat32(),
-                        }
-                            .Normalized();
-
-                    const Common::Vec3f view{
-                        get_interpolated_attribute(v0.view.x, v1.view.x, v2.view.x).ToFloat32(),
-                        get_interpolated_attribute(v0.view.y, v1.view.y, v2.view.y).ToFloat32(),
-                        get_interpolated_attribute(v0.view.z, v1.view.z, v2.view.z).ToFloat32(),
-                    };
-                    std::tie(primary_fragment_color, secondary_fragment_color) =
-                        ComputeFragmentsColors(regs.lighting, pica.lighting, normquat, view,
-                                               texture_color);
-                }
-
-                // Write the TEV stages.
-                auto combiner_output =
-                    WriteTevConfig(texture_color, tev_stages, primary_color, primary_fragment_color,
-                                   secondary_fragment_color);
-
-                const auto& output_merger = regs.framebuffer.output_merger;
-                if (output_merger.fragment_operation_mode ==
-                    FramebufferRegs::FragmentOperationMode::Shadow) {
-                    const u32 depth_int = static_cast<u32>(depth * 0xFFFFFF);
-                    // Use green color as the shadow intensity
-                    const u8 stencil = combiner_output.y;
-                    fb.DrawShadowMapPixel(x >> 4, y >> 4, depth_int, stencil);
-                    // Skip the normal output merger pipeline if it is in shadow mode
-                    continue;
-                }
+            // Write the TEV stages.
+            auto combiner_output =
+                WriteTevConfig(texture_color, tev_stages, primary_color, primary_fragment_color,
+                               secondary_fragment_color);
+
+            const auto& output_merger = regs.framebuffer.output_merger;
+            if (output_merger.fragment_operation_mode ==
+                FramebufferRegs::FragmentOperationMode::Shadow) {
+                const u32 depth_int = static_cast<u32>(depth * 0xFFFFFF);
+                // Use green color as the shadow intensity
+                const u8 stencil = combiner_output.y;
+                fb.DrawShadowMapPixel(x >> 4, y >> 4, depth_int, stencil);
+                // Skip the normal output merger pipeline if it is in shadow mode
+                continue;
+            }
 
-                // Does alpha testing happen before or after stencil?
-                if (!DoAlphaTest(combiner_output.a())) {
-                    continue;
-                }
-                WriteFog(depth, combiner_output);
-                if (!DoDepthStencilTest(x, y, depth)) {
-                    continue;
-                }
-                const auto result = PixelColor(x, y, combiner_output);
-                if (regs.framebuffer.framebuffer.allow_color_write != 0) {
-                    fb.DrawPixel(x >> 4, y >> 4, result);
-                }
+            // Does alpha testing happen before or after stencil?
+            if (!DoAlphaTest(combiner_output.a())) {
+                continue;
             }
-        };
-        sw_workers.QueueWork(std::move(process_scanline));
+            WriteFog(depth, combiner_output);
+            if (!DoDepthStencilTest(x, y, depth)) {
+                continue;
+            }
+            const auto result = PixelColor(x, y, combiner_output);
+            if (regs.framebuffer.framebuffer.allow_color_write != 0) {
+                fb.DrawPixel(x >> 4, y >> 4, result);
+            }
+        }
     }
-    sw_workers.WaitForRequests();
 }
 
 std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
     std::span<const Common::Vec2<f24>, 3> uv,
-    std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w) const {
+    std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w,
+    TextureTileCache& tile_cache) const {
     std::array<Common::Vec4<u8>, 4> texture_color{};
     for (u32 i = 0; i < 3; ++i) {
         const auto& texture = textures[i];
@@ -561,7 +774,7 @@ std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
             const auto info = TextureInfo::FromPicaRegister(texture.config, texture.format);
 
             // TODO: Apply the min and mag filters to the texture
-            texture_color[i] = LookupTexture(texture_data, s, t, info);
+            texture_color[i] = tile_cache.Lookup(texture_data, s, t, info);
         }
 
         if (i == 0 && (texture.config.type == TexturingRegs::TextureConfig::Shadow2D ||
@@ -585,7 +798,7 @@ std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
     if (regs.texturing.main_config.texture3_enable) {
         const auto& proctex_uv = uv[regs.texturing.main_config.texture3_coordinates];
         texture_color[3] = ProcTex(proctex_uv.u().ToFloat32(), proctex_uv.v().ToFloat32(),
-                                   regs.texturing, pica.proctex);
+                                   regs.texturing, proctex_tables);
     }
 
     return texture_color;
@@ -5,11 +5,14 @@
 #pragma once
 
 #include <span>
-#include "common/thread_worker.h"
+#include <vector>
+#include "common/thread_pool.h"
 #include "video_core/pica/regs_texturing.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_software/sw_clipper.h"
 #include "video_core/renderer_software/sw_framebuffer.h"
+#include "video_core/renderer_software/sw_lighting.h"
+#include "video_core/renderer_software/sw_proctex.h"
 
 namespace Pica {
 struct RegsInternal;
@@ -19,33 +22,45 @@ class PicaCore;
 namespace SwRenderer {
 
 struct Vertex;
+class TextureTileCache;
 
 class RasterizerSoftware : public VideoCore::RasterizerInterface {
 public:
     explicit RasterizerSoftware(Memory::MemorySystem& memory, Pica::PicaCore& pica);
+    ~RasterizerSoftware() override;
 
     void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                      const Pica::OutputVertex& v2) override;
-    void DrawTriangles() override {}
+    void DrawTriangles() override;
     void NotifyPicaRegisterChanged(u32 id) override {}
     void FlushAll() override {}
     void FlushRegion(PAddr addr, u32 size) override {}
     void InvalidateRegion(PAddr addr, u32 size) override {}
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
     void ClearAll(bool flush) override {}
+    void SyncEntireState() override;
 
 private:
+    struct Triangle;
+
     /// Computes the screen coordinates of the provided vertex.
     void MakeScreenCoords(Vertex& vtx);
 
-    /// Processes the triangle defined by the provided vertices.
+    /// Culls the triangle defined by the provided vertices and queues it for rasterization.
     void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2,
                          bool reversed = false);
 
+    /// Rasterizes the part of the triangle that lies in the tile starting at the given position.
+    void RasterizeTriangle(const Triangle& triangle, u16 tile_x, u16 tile_y,
+                           std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures,
+                           std::span<const Pica::TexturingRegs::TevStageConfig, 6> tev_stages,
+                           TextureTileCache& tile_cache);
+
     /// Returns the texture color of the currently processed pixel.
     std::array<Common::Vec4<u8>, 4> TextureColor(
         std::span<const Common::Vec2<f24>, 3> uv,
-        std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w) const;
+        std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w,
+        TextureTileCache& tile_cache) const;
 
     /// Returns the final pixel color with blending or logic ops applied.
     Common::Vec4<u8> PixelColor(u16 x, u16 y, Common::Vec4<u8> combiner_output) const;
@@ -70,9 +85,12 @@ private:
     Memory::MemorySystem& memory;
     Pica::PicaCore& pica;
     Pica::RegsInternal& regs;
-    std::size_t num_sw_threads;
-    Common::ThreadWorker sw_workers;
+    Common::TaskGroup sw_workers;
     Framebuffer fb;
+    LightingLuts lighting_luts;
+    ProcTexTables proctex_tables;
+    std::vector<Triangle> triangles;         ///< Triangles of the current draw
+    std::vector<std::vector<u32>> tile_bins; ///< Indices of the triangles overlapping each tile
 };
 
 } // namespace SwRenderer
@@ -13,6 +13,27 @@ namespace SwRenderer {
 
 using TevStageConfig = Pica::TexturingRegs::TevStageConfig;
 
+Common::Vec4<u8> TextureTileCache::Lookup(const u8* source, u32 x, u32 y,
+                                          const Pica::Texture::TextureInfo& info) {
+    const std::size_t tile_size = Pica::Texture::CalculateTileSize(info.format);
+    const u8* tile_source = source + (y / 8) * info.stride + (x / 8) * tile_size;
+    const u32 texel = (y % 8) * 8 + (x % 8);
+
+    // Neighbouring tiles of a row land in different slots
+    const std::size_t slot = (reinterpret_cast<uintptr_t>(tile_source) / tile_size) % NUM_TILES;
+    if (sources[slot] != tile_source || formats[slot] != info.format) {
+        sources[slot] = tile_source;
+        formats[slot] = info.format;
+        decoded[slot] = 0;
+    }
+    if (!(decoded[slot] & (1ULL << texel))) {
+        texels[slot][texel] =
+            Pica::Texture::LookupTexelInTile(tile_source, x % 8, y % 8, info, false);
+        decoded[slot] |= 1ULL << texel;
+    }
+    return texels[slot][texel];
+}
+
 int GetWrappedTexCoord(Pica::TexturingRegs::TextureConfig::WrapMode mode, s32 val, u32 size) {
     using TextureConfig = Pica::TexturingRegs::TextureConfig;
 
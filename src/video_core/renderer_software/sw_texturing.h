@@ -4,14 +4,38 @@
 
 #pragma once
 
+#include <array>
 #include <span>
 
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica/regs_texturing.h"
+#include "video_core/texture/texture_decode.h"
 
 namespace SwRenderer {
 
+/**
+ * Decoded texels of the 8x8 tiles sampled last, so that sampling a texel again does not decode it
+ * from guest memory, which is costly for ETC1 and the packed formats. Texels are decoded on their
+ * first sample rather than a whole tile at once, so the cache never decodes more than the plain
+ * lookup. The cache is not invalidated on guest writes and must not outlive the draw it was
+ * created for.
+ */
+class TextureTileCache {
+public:
+    /// Returns the texel at x, y of the texture at source, as Pica::Texture::LookupTexture does
+    Common::Vec4<u8> Lookup(const u8* source, u32 x, u32 y,
+                            const Pica::Texture::TextureInfo& info);
+
+private:
+    static constexpr std::size_t NUM_TILES = 16;
+
+    std::array<const u8*, NUM_TILES> sources{}; ///< Guest data of the cached tiles
+    std::array<Pica::TexturingRegs::TextureFormat, NUM_TILES> formats{};
+    std::array<u64, NUM_TILES> decoded{}; ///< Bit per texel of every tile, set once decoded
+    std::array<std::array<Common::Vec4<u8>, 64>, NUM_TILES> texels;
+};
+
 int GetWrappedTexCoord(Pica::TexturingRegs::TextureConfig::WrapMode mode, s32 val, u32 size);
 
 Common::Vec3<u8> GetColorModifier(Pica::TexturingRegs::TevStageConfig::ColorModifier factor,
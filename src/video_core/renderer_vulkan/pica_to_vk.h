@@ -162,7 +162,18 @@ inline vk::StencilOp StencilOp(Pica::FramebufferRegs::StencilAction action) {
     return stencil_op_table[index];
 }
 
-inline vk::PrimitiveTopology PrimitiveTopology(Pica::PipelineRegs::TriangleTopology topology) {
+inline vk::PrimitiveTopology PrimitiveTopology(Pica::PipelineRegs::TriangleTopology topology,
+                                               u32 gs_input_vertices = 0) {
+    // Geometry shaders in the Point mode consume independent groups of vertices.
+    switch (gs_input_vertices) {
+    case 1:
+        return vk::PrimitiveTopology::ePointList;
+    case 2:
+        return vk::PrimitiveTopology::eLineList;
+    case 3:
+        return vk::PrimitiveTopology::eTriangleList;
+    }
+
     switch (topology) {
     case Pica::PipelineRegs::TriangleTopology::Fan:
         return vk::PrimitiveTopology::eTriangleFan;
@@ -9,6 +9,7 @@
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/frontend/emu_window.h"
+#include "core/perf_stats.h"
 #include "video_core/gpu.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/renderer_vulkan/renderer_vulkan.h"
@@ -54,8 +55,8 @@ RendererVulkan::RendererVulkan(Core::System& system, Pica::PicaCore& pica_,
                                Frontend::EmuWindow& window, Frontend::EmuWindow* secondary_window)
     : RendererBase{system, window, secondary_window}, memory{system.Memory()}, pica{pica_},
       instance{window, Settings::values.physical_device.GetValue()}, scheduler{instance},
-      renderpass_cache{instance, scheduler}, pool{instance}, main_window{window, instance,
-                                                                         scheduler},
+      renderpass_cache{instance, scheduler}, gpu_profiler{instance, scheduler, renderpass_cache},
+      pool{instance}, main_window{window, instance, scheduler},
       vertex_buffer{instance, scheduler, vk::BufferUsageFlagBits::eVertexBuffer,
                     VERTEX_BUFFER_SIZE},
       rasterizer{memory,
@@ -67,8 +68,12 @@ RendererVulkan::RendererVulkan(Core::System& system, Pica::PicaCore& pica_,
                  scheduler,
                  pool,
                  renderpass_cache,
-                 main_window.ImageCount()},
-      present_set_provider{instance, pool, PRESENT_BINDINGS} {
+                 main_window.ImageCount(),
+                 gpu_profiler,
+                 system.GetProgramId()},
+      frame_dumper{system, instance, scheduler, main_window},
+      present_set_provider{instance, pool, PRESENT_BINDINGS},
+      post_processing{instance, scheduler, renderpass_cache, pool, present_set_provider} {
     CompileShaders();
     BuildLayouts();
     BuildPipelines();
@@ -79,6 +84,7 @@ RendererVulkan::RendererVulkan(Core::System& system, Pica::PicaCore& pica_,
 
 RendererVulkan::~RendererVulkan() {
     vk::Device device = instance.GetDevice();
+    CompleteScreenshots(true);
     scheduler.Finish();
     device.waitIdle();
 
@@ -102,6 +108,18 @@ void RendererVulkan::Sync() {
     rasterizer.SyncEntireState();
 }
 
+void RendererVulkan::WaitIdle() {
+    scheduler.Finish();
+}
+
+void RendererVulkan::PrepareVideoDumping() {
+    frame_dumper.StartDumping();
+}
+
+void RendererVulkan::CleanupVideoDumping() {
+    frame_dumper.StopDumping();
+}
+
 void RendererVulkan::PrepareRendertarget() {
     const auto& framebuffer_config = pica.regs.framebuffer_config;
     const auto& regs_lcd = pica.regs_lcd;
@@ -122,6 +140,13 @@ void RendererVulkan::PrepareRendertarget() {
         }
 
         LoadFBToScreenInfo(framebuffer, screen_infos[i], i == 1);
+
+        // Without stereo only the eye selected for mono rendering is drawn on the top screen
+        const auto mono_eye = static_cast<u32>(Settings::values.mono_render_option.GetValue());
+        if (i == 2 || Settings::values.render_3d.GetValue() != Settings::StereoRenderOption::Off ||
+            i == mono_eye) {
+            post_processing.Apply(screen_infos[i], i, GetRenderScaleFactor());
+        }
     }
 }
 
@@ -135,8 +160,12 @@ void RendererVulkan::PrepareDraw(Frame* frame, const Layout::FramebufferLayout&
 
     const auto descriptor_set = present_set_provider.Acquire(present_textures);
 
+    // Frames drawn into a swapchain image use a renderpass compatible with the present one
+    const vk::RenderPass renderpass =
+        frame->renderpass ? frame->renderpass : main_window.Renderpass();
+
     renderpass_cache.EndRendering();
-    scheduler.Record([this, layout, frame, descriptor_set, renderpass = main_window.Renderpass(),
+    scheduler.Record([this, layout, frame, descriptor_set, renderpass,
                       index = current_pipeline](vk::CommandBuffer cmdbuf) {
         const vk::Viewport viewport = {
             .x = 0.0f,
@@ -177,11 +206,19 @@ void RendererVulkan::PrepareDraw(Frame* frame, const Layout::FramebufferLayout&
 
 void RendererVulkan::RenderToWindow(PresentWindow& window, const Layout::FramebufferLayout& layout,
                                     bool flipped) {
+    if (window.CanPresentDirect()) {
+        // The emulated frame is submitted first so it doesn't wait for the swapchain image
+        scheduler.Flush();
+        Frame* frame = window.AcquireDirectFrame(layout.width, layout.height);
+        DrawScreens(frame, layout, flipped);
+        window.PresentDirect(frame);
+        return;
+    }
+
     Frame* frame = window.GetRenderFrame();
 
+    // The frame finished presenting once it is handed out, so the GPU is done with its image
     if (layout.width != frame->width || layout.height != frame->height) {
-        window.WaitPresent();
-        scheduler.Finish();
         window.RecreateFrame(frame, layout.width, layout.height);
     }
 
@@ -191,6 +228,12 @@ void RendererVulkan::RenderToWindow(PresentWindow& window, const Layout::Framebu
     window.Present(frame);
 }
 
+void RendererVulkan::RenderToDumper() {
+    Frame* frame = frame_dumper.GetRenderFrame();
+    DrawScreens(frame, frame_dumper.GetLayout(), false);
+    frame_dumper.ReadbackFrame(frame);
+}
+
 void RendererVulkan::LoadFBToScreenInfo(const Pica::FramebufferConfig& framebuffer,
                                         ScreenInfo& screen_info, bool right_eye) {
 
@@ -584,7 +627,7 @@ void RendererVulkan::DrawSingleScreen(u32 screen_id, float x, float y, float w,
     std::memcpy(data, vertices.data(), size);
     vertex_buffer.Commit(size);
 
-    const u32 scale_factor = GetResolutionScaleFactor();
+    const u32 scale_factor = GetRenderScaleFactor();
     draw_info.i_resolution =
         Common::MakeVec(static_cast<f32>(screen_info.texture.width * scale_factor),
                         static_cast<f32>(screen_info.texture.height * scale_factor),
@@ -656,7 +699,7 @@ void RendererVulkan::DrawSingleScreenStereo(u32 screen_id_l, u32 screen_id_r, fl
     std::memcpy(data, vertices.data(), size);
     vertex_buffer.Commit(size);
 
-    const u32 scale_factor = GetResolutionScaleFactor();
+    const u32 scale_factor = GetRenderScaleFactor();
     draw_info.i_resolution =
         Common::MakeVec(static_cast<f32>(screen_info_l.texture.width * scale_factor),
                         static_cast<f32>(screen_info_l.texture.height * scale_factor),
@@ -783,6 +826,8 @@ void RendererVulkan::DrawScreens(Frame* frame, const Layout::FramebufferLayout&
         ReloadPipeline();
     }
 
+    // Ends before the submission, so the GPU waiting for the next frame is not counted
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Present};
     PrepareDraw(frame, layout);
 
     const auto& top_screen = layout.top_screen;
@@ -809,6 +854,12 @@ void RendererVulkan::DrawScreens(Frame* frame, const Layout::FramebufferLayout&
         }
     }
 
+    if (frame->renderpass) {
+        // The renderpass leaves swapchain images ready to be presented
+        scheduler.Record([](vk::CommandBuffer cmdbuf) { cmdbuf.endRenderPass(); });
+        return;
+    }
+
     scheduler.Record([image = frame->image](vk::CommandBuffer cmdbuf) {
         const vk::ImageMemoryBarrier render_barrier = {
             .srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
@@ -835,9 +886,26 @@ void RendererVulkan::DrawScreens(Frame* frame, const Layout::FramebufferLayout&
 }
 
 void RendererVulkan::SwapBuffers() {
+    CompleteScreenshots(false);
+    if (IsTurboSkippedFrame()) {
+        // Nothing is drawn, the window keeps showing the last presented frame
+        UpdateGpuTime();
+        rasterizer.TickFrame();
+        gpu_profiler.EndFrame(*system.perf_stats);
+        EndFrame();
+        return;
+    }
+
     const Layout::FramebufferLayout& layout = render_window.GetFramebufferLayout();
-    PrepareRendertarget();
+    {
+        VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Present};
+        PrepareRendertarget();
+    }
     RenderScreenshot();
+    if (frame_dumper.IsDumping()) {
+        // Recorded first so the readback is submitted together with the presented frame
+        RenderToDumper();
+    }
     RenderToWindow(main_window, layout, false);
 #ifndef ANDROID
     if (Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
@@ -850,31 +918,139 @@ void RendererVulkan::SwapBuffers() {
         secondary_window->PollEvents();
     }
 #endif
+    UpdateGpuTime();
     rasterizer.TickFrame();
+    system.perf_stats->SetPresentLatency(main_window.PresentLatency());
+    gpu_profiler.EndFrame(*system.perf_stats);
     EndFrame();
 }
 
+void RendererVulkan::UpdateGpuTime() {
+    if (const auto gpu_time = scheduler.CollectGpuTime()) {
+        UpdateDynamicResolution(*gpu_time);
+    }
+}
+
 void RendererVulkan::RenderScreenshot() {
     if (!settings.screenshot_requested.exchange(false)) {
         return;
     }
 
-    if (!TryRenderScreenshotWithHostMemory()) {
-        RenderScreenshotWithStagingCopy();
+    const Layout::FramebufferLayout layout{settings.screenshot_framebuffer_layout};
+    PendingScreenshot& screenshot = pending_screenshots.emplace_back();
+    screenshot.bits = settings.screenshot_bits;
+    screenshot.size = layout.width * layout.height * 4ull;
+    screenshot.callback = std::move(settings.screenshot_complete_callback);
+    if (!TryImportScreenshotMemory(screenshot)) {
+        CreateScreenshotStagingBuffer(screenshot);
     }
 
-    settings.screenshot_complete_callback(false);
+    main_window.RecreateFrame(&screenshot.frame, layout.width, layout.height);
+    DrawScreens(&screenshot.frame, layout, false);
+
+    const vk::BufferImageCopy image_copy = {
+        .bufferOffset = screenshot.buffer_offset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource =
+            {
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .imageOffset = {0, 0, 0},
+        .imageExtent = {layout.width, layout.height, 1},
+    };
+    scheduler.Record([image_copy, source_image = screenshot.frame.image,
+                      buffer = screenshot.buffer](vk::CommandBuffer cmdbuf) {
+        const vk::ImageMemoryBarrier read_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = source_image,
+            .subresourceRange{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel = 0,
+                .levelCount = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            },
+        };
+        const vk::ImageMemoryBarrier write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferRead,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = source_image,
+            .subresourceRange{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel = 0,
+                .levelCount = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            },
+        };
+        static constexpr vk::MemoryBarrier memory_write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+        };
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
+        cmdbuf.copyImageToBuffer(source_image, vk::ImageLayout::eTransferSrcOptimal, buffer,
+                                 image_copy);
+        cmdbuf.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands,
+            vk::DependencyFlagBits::eByRegion, memory_write_barrier, {}, write_barrier);
+    });
+
+    // The copy completes with the submission of the current tick, the screenshot is handed out
+    // on a later frame instead of waiting for it here
+    screenshot.tick = scheduler.CurrentTick();
 }
 
-void RendererVulkan::RenderScreenshotWithStagingCopy() {
+void RendererVulkan::CompleteScreenshots(bool wait) {
+    if (pending_screenshots.empty()) {
+        return;
+    }
+
     const vk::Device device = instance.GetDevice();
+    scheduler.GetMasterSemaphore()->Refresh();
+    while (!pending_screenshots.empty()) {
+        PendingScreenshot& screenshot = pending_screenshots.front();
+        if (wait) {
+            scheduler.Wait(screenshot.tick);
+        } else if (!scheduler.IsFree(screenshot.tick)) {
+            return;
+        }
 
-    const Layout::FramebufferLayout layout{settings.screenshot_framebuffer_layout};
-    const u32 width = layout.width;
-    const u32 height = layout.height;
+        if (screenshot.allocation) {
+            // Copy backing image data to the screenshot buffer
+            vmaInvalidateAllocation(instance.GetAllocator(), screenshot.allocation, 0,
+                                    VK_WHOLE_SIZE);
+            std::memcpy(screenshot.bits, screenshot.mapped, screenshot.size);
+            vmaDestroyBuffer(instance.GetAllocator(), screenshot.buffer, screenshot.allocation);
+        }
+        const Frame& frame = screenshot.frame;
+        vmaDestroyImage(instance.GetAllocator(), frame.image, frame.allocation);
+        device.destroyFramebuffer(frame.framebuffer);
+        device.destroyImageView(frame.image_view);
 
+        screenshot.callback(false);
+        pending_screenshots.pop_front();
+    }
+}
+
+void RendererVulkan::CreateScreenshotStagingBuffer(PendingScreenshot& screenshot) {
     const vk::BufferCreateInfo staging_buffer_info = {
-        .size = width * height * 4,
+        .size = screenshot.size,
         .usage = vk::BufferUsageFlagBits::eTransferDst,
     };
 
@@ -889,102 +1065,22 @@ void RendererVulkan::RenderScreenshotWithStagingCopy() {
     };
 
     VkBuffer unsafe_buffer{};
-    VmaAllocation allocation{};
     VmaAllocationInfo alloc_info;
     VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(staging_buffer_info);
 
-    VkResult result = vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info,
-                                      &alloc_create_info, &unsafe_buffer, &allocation, &alloc_info);
+    VkResult result =
+        vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info, &alloc_create_info,
+                        &unsafe_buffer, &screenshot.allocation, &alloc_info);
     if (result != VK_SUCCESS) [[unlikely]] {
         LOG_CRITICAL(Render_Vulkan, "Failed allocating texture with error {}", result);
         UNREACHABLE();
     }
 
-    vk::Buffer staging_buffer{unsafe_buffer};
-
-    Frame frame{};
-    main_window.RecreateFrame(&frame, width, height);
-
-    DrawScreens(&frame, layout, false);
-
-    scheduler.Record(
-        [width, height, source_image = frame.image, staging_buffer](vk::CommandBuffer cmdbuf) {
-            const vk::ImageMemoryBarrier read_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .dstAccessMask = vk::AccessFlagBits::eTransferRead,
-                .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .newLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = source_image,
-                .subresourceRange{
-                    .aspectMask = vk::ImageAspectFlagBits::eColor,
-                    .baseMipLevel = 0,
-                    .levelCount = VK_REMAINING_MIP_LEVELS,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
-            };
-            const vk::ImageMemoryBarrier write_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eTransferRead,
-                .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .newLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = source_image,
-                .subresourceRange{
-                    .aspectMask = vk::ImageAspectFlagBits::eColor,
-                    .baseMipLevel = 0,
-                    .levelCount = VK_REMAINING_MIP_LEVELS,
-                    .baseArrayLayer = 0,
-                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
-                },
-            };
-            static constexpr vk::MemoryBarrier memory_write_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
-            };
-
-            const vk::BufferImageCopy image_copy = {
-                .bufferOffset = 0,
-                .bufferRowLength = 0,
-                .bufferImageHeight = 0,
-                .imageSubresource =
-                    {
-                        .aspectMask = vk::ImageAspectFlagBits::eColor,
-                        .mipLevel = 0,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1,
-                    },
-                .imageOffset = {0, 0, 0},
-                .imageExtent = {width, height, 1},
-            };
-
-            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
-                                   vk::PipelineStageFlagBits::eTransfer,
-                                   vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
-            cmdbuf.copyImageToBuffer(source_image, vk::ImageLayout::eTransferSrcOptimal,
-                                     staging_buffer, image_copy);
-            cmdbuf.pipelineBarrier(
-                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands,
-                vk::DependencyFlagBits::eByRegion, memory_write_barrier, {}, write_barrier);
-        });
-
-    // Ensure the copy is fully completed before saving the screenshot
-    scheduler.Finish();
-
-    // Copy backing image data to the QImage screenshot buffer
-    std::memcpy(settings.screenshot_bits, alloc_info.pMappedData, staging_buffer_info.size);
-
-    // Destroy allocated resources
-    vmaDestroyBuffer(instance.GetAllocator(), staging_buffer, allocation);
-    vmaDestroyImage(instance.GetAllocator(), frame.image, frame.allocation);
-    device.destroyFramebuffer(frame.framebuffer);
-    device.destroyImageView(frame.image_view);
+    screenshot.buffer = vk::Buffer{unsafe_buffer};
+    screenshot.mapped = alloc_info.pMappedData;
 }
 
-bool RendererVulkan::TryRenderScreenshotWithHostMemory() {
+bool RendererVulkan::TryImportScreenshotMemory(PendingScreenshot& screenshot) {
     // If the host-memory import alignment matches the allocation granularity of the platform, then
     // the entire span of memory can be trivially imported
     const bool trivial_import =
@@ -996,33 +1092,13 @@ bool RendererVulkan::TryRenderScreenshotWithHostMemory() {
 
     const vk::Device device = instance.GetDevice();
 
-    const Layout::FramebufferLayout layout{settings.screenshot_framebuffer_layout};
-    const u32 width = layout.width;
-    const u32 height = layout.height;
-
     // For a span of memory [x, x + s], import [AlignDown(x, alignment), AlignUp(x + s, alignment)]
     // and maintain an offset to the start of the data
     const u64 import_alignment = instance.GetMinImportedHostPointerAlignment();
-    const uintptr_t address = reinterpret_cast<uintptr_t>(settings.screenshot_bits);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(screenshot.bits);
     void* aligned_pointer = reinterpret_cast<void*>(Common::AlignDown(address, import_alignment));
     const u64 offset = address % import_alignment;
-    const u64 aligned_size = Common::AlignUp(offset + width * height * 4ull, import_alignment);
-
-    // Buffer<->Image mapping for the imported imported buffer
-    const vk::BufferImageCopy buffer_image_copy = {
-        .bufferOffset = offset,
-        .bufferRowLength = 0,
-        .bufferImageHeight = 0,
-        .imageSubresource =
-            {
-                .aspectMask = vk::ImageAspectFlagBits::eColor,
-                .mipLevel = 0,
-                .baseArrayLayer = 0,
-                .layerCount = 1,
-            },
-        .imageOffset = {0, 0, 0},
-        .imageExtent = {width, height, 1},
-    };
+    const u64 aligned_size = Common::AlignUp(offset + screenshot.size, import_alignment);
 
     const vk::MemoryHostPointerPropertiesEXT import_properties =
         device.getMemoryHostPointerPropertiesEXT(
@@ -1056,8 +1132,7 @@ bool RendererVulkan::TryRenderScreenshotWithHostMemory() {
         };
 
     // Import host memory
-    const vk::UniqueDeviceMemory imported_memory =
-        device.allocateMemoryUnique(allocation_chain.get());
+    screenshot.imported_memory = device.allocateMemoryUnique(allocation_chain.get());
 
     const vk::StructureChain<vk::BufferCreateInfo, vk::ExternalMemoryBufferCreateInfo> buffer_info =
         {
@@ -1072,70 +1147,12 @@ bool RendererVulkan::TryRenderScreenshotWithHostMemory() {
         };
 
     // Bind imported memory to buffer
-    const vk::UniqueBuffer imported_buffer = device.createBufferUnique(buffer_info.get());
-    device.bindBufferMemory(imported_buffer.get(), imported_memory.get(), 0);
-
-    Frame frame{};
-    main_window.RecreateFrame(&frame, width, height);
-
-    DrawScreens(&frame, layout, false);
-
-    scheduler.Record([buffer_image_copy, source_image = frame.image,
-                      imported_buffer = imported_buffer.get()](vk::CommandBuffer cmdbuf) {
-        const vk::ImageMemoryBarrier read_barrier = {
-            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
-            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
-            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image = source_image,
-            .subresourceRange{
-                .aspectMask = vk::ImageAspectFlagBits::eColor,
-                .baseMipLevel = 0,
-                .levelCount = VK_REMAINING_MIP_LEVELS,
-                .baseArrayLayer = 0,
-                .layerCount = VK_REMAINING_ARRAY_LAYERS,
-            },
-        };
-        const vk::ImageMemoryBarrier write_barrier = {
-            .srcAccessMask = vk::AccessFlagBits::eTransferRead,
-            .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
-            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
-            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image = source_image,
-            .subresourceRange{
-                .aspectMask = vk::ImageAspectFlagBits::eColor,
-                .baseMipLevel = 0,
-                .levelCount = VK_REMAINING_MIP_LEVELS,
-                .baseArrayLayer = 0,
-                .layerCount = VK_REMAINING_ARRAY_LAYERS,
-            },
-        };
-        static constexpr vk::MemoryBarrier memory_write_barrier = {
-            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-            .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
-        };
-
-        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
-                               vk::PipelineStageFlagBits::eTransfer,
-                               vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
-        cmdbuf.copyImageToBuffer(source_image, vk::ImageLayout::eTransferSrcOptimal,
-                                 imported_buffer, buffer_image_copy);
-        cmdbuf.pipelineBarrier(
-            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands,
-            vk::DependencyFlagBits::eByRegion, memory_write_barrier, {}, write_barrier);
-    });
-
-    // Ensure the copy is fully completed before saving the screenshot
-    scheduler.Finish();
-
-    // Image data has been copied directly to host memory
-    device.destroyFramebuffer(frame.framebuffer);
-    device.destroyImageView(frame.image_view);
+    screenshot.imported_buffer = device.createBufferUnique(buffer_info.get());
+    device.bindBufferMemory(screenshot.imported_buffer.get(), screenshot.imported_memory.get(), 0);
 
+    // Image data is copied directly to host memory
+    screenshot.buffer = screenshot.imported_buffer.get();
+    screenshot.buffer_offset = offset;
     return true;
 }
 
@@ -4,11 +4,16 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
 #include "common/common_types.h"
 #include "common/math_util.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
+#include "video_core/renderer_vulkan/vk_frame_dumper.h"
+#include "video_core/renderer_vulkan/vk_gpu_profiler.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_post_processing.h"
 #include "video_core/renderer_vulkan/vk_present_window.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
@@ -82,8 +87,25 @@ public:
     void SwapBuffers() override;
     void TryPresent(int timeout_ms, bool is_secondary) override {}
     void Sync() override;
+    void WaitIdle() override;
+    void PrepareVideoDumping() override;
+    void CleanupVideoDumping() override;
 
 private:
+    struct PendingScreenshot {
+        Frame frame{};
+        vk::Buffer buffer{};
+        u64 buffer_offset{};
+        VmaAllocation allocation{}; ///< Staging allocation, null when the GPU writes bits directly
+        const void* mapped{};
+        vk::UniqueDeviceMemory imported_memory{};
+        vk::UniqueBuffer imported_buffer{};
+        void* bits{};
+        u64 size{};
+        std::function<void(bool)> callback;
+        u64 tick{};
+    };
+
     void ReloadPipeline();
     void CompileShaders();
     void BuildLayouts();
@@ -92,12 +114,18 @@ private:
                                      const Pica::FramebufferConfig& framebuffer);
     void ConfigureRenderPipeline();
     void PrepareRendertarget();
+    /// Feeds the GPU time of the completed submissions to dynamic resolution
+    void UpdateGpuTime();
     void RenderScreenshot();
-    void RenderScreenshotWithStagingCopy();
-    bool TryRenderScreenshotWithHostMemory();
+    void CreateScreenshotStagingBuffer(PendingScreenshot& screenshot);
+    bool TryImportScreenshotMemory(PendingScreenshot& screenshot);
+    /// Hands out the screenshots whose readback finished, or all of them after waiting for the
+    /// GPU when wait is set
+    void CompleteScreenshots(bool wait);
     void PrepareDraw(Frame* frame, const Layout::FramebufferLayout& layout);
     void RenderToWindow(PresentWindow& window, const Layout::FramebufferLayout& layout,
                         bool flipped);
+    void RenderToDumper();
 
     void DrawScreens(Frame* frame, const Layout::FramebufferLayout& layout, bool flipped);
     void DrawBottomScreen(const Layout::FramebufferLayout& layout,
@@ -119,14 +147,18 @@ private:
     Instance instance;
     Scheduler scheduler;
     RenderpassCache renderpass_cache;
+    GpuProfiler gpu_profiler;
     DescriptorPool pool;
     PresentWindow main_window;
     StreamBuffer vertex_buffer;
     RasterizerVulkan rasterizer;
     std::unique_ptr<PresentWindow> second_window;
+    FrameDumper frame_dumper;
+    std::deque<PendingScreenshot> pending_screenshots;
 
     vk::UniquePipelineLayout present_pipeline_layout;
     DescriptorSetProvider present_set_provider;
+    PostProcessingChain post_processing;
     std::array<vk::Pipeline, PRESENT_PIPELINES> present_pipelines;
     std::array<vk::ShaderModule, PRESENT_PIPELINES> present_shaders;
     std::array<vk::Sampler, 2> present_samplers;
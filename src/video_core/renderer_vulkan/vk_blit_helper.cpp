@@ -2,7 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <string_view>
+#include <fmt/format.h>
+#include "common/alignment.h"
+#include "common/settings.h"
 #include "common/vector_math.h"
+#include "video_core/gpu_profiler.h"
 #include "video_core/renderer_vulkan/vk_blit_helper.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
@@ -12,12 +18,24 @@
 
 #include "video_core/host_shaders/format_reinterpreter/vulkan_d24s8_to_rgba8_comp.h"
 #include "video_core/host_shaders/full_screen_triangle_vert.h"
+#include "video_core/host_shaders/texture_filtering/bicubic_frag.h"
+#include "video_core/host_shaders/texture_filtering/mmpx_frag.h"
+#include "video_core/host_shaders/texture_filtering/refine_frag.h"
+#include "video_core/host_shaders/texture_filtering/scale_force_frag.h"
+#include "video_core/host_shaders/texture_filtering/x_gradient_frag.h"
+#include "video_core/host_shaders/texture_filtering/xbrz_freescale_frag.h"
+#include "video_core/host_shaders/texture_filtering/y_gradient_frag.h"
 #include "video_core/host_shaders/vulkan_blit_depth_stencil_frag.h"
 #include "video_core/host_shaders/vulkan_depth_to_buffer_comp.h"
+#include "video_core/host_shaders/vulkan_texture_decode_comp.h"
+
+#include <vk_mem_alloc.h>
 
 namespace Vulkan {
 
+using Settings::TextureFilter;
 using VideoCore::PixelFormat;
+using VideoCore::SurfaceType;
 
 namespace {
 struct PushConstants {
@@ -31,6 +49,33 @@ struct ComputeInfo {
     Common::Vec2i src_extent;
 };
 
+struct DecodeInfo {
+    Common::Vec2i dst_offset;
+    Common::Vec2i extent;
+    u32 src_offset;
+    u32 format;
+};
+
+struct FilterInfo {
+    Common::Vec2f tex_scale;
+    Common::Vec2f tex_offset;
+    Common::Vec2i dst_offset;
+    Common::Vec2i dst_extent;
+    float scale;
+};
+
+inline constexpr vk::PushConstantRange FILTER_PUSH_CONSTANT_RANGE{
+    .stageFlags = vk::ShaderStageFlagBits::eCompute,
+    .offset = 0,
+    .size = sizeof(FilterInfo),
+};
+
+inline constexpr vk::PushConstantRange DECODE_PUSH_CONSTANT_RANGE{
+    .stageFlags = vk::ShaderStageFlagBits::eCompute,
+    .offset = 0,
+    .size = sizeof(DecodeInfo),
+};
+
 inline constexpr vk::PushConstantRange COMPUTE_PUSH_CONSTANT_RANGE{
     .stageFlags = vk::ShaderStageFlagBits::eCompute,
     .offset = 0,
@@ -49,6 +94,18 @@ constexpr std::array<vk::DescriptorSetLayoutBinding, 3> COMPUTE_BUFFER_BINDINGS
     {2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
 }};
 
+constexpr std::array<vk::DescriptorSetLayoutBinding, 2> DECODE_BINDINGS = {{
+    {0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
+    {1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute},
+}};
+
+constexpr std::array<vk::DescriptorSetLayoutBinding, 4> FILTER_BINDINGS = {{
+    {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute},
+    {1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute},
+    {2, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute},
+    {3, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute},
+}};
+
 constexpr std::array<vk::DescriptorSetLayoutBinding, 2> TWO_TEXTURES_BINDINGS = {{
     {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
     {1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
@@ -122,14 +179,15 @@ constexpr vk::PipelineDepthStencilStateCreateInfo PIPELINE_DEPTH_STENCIL_STATE_C
     .maxDepthBounds = 0.0f,
 };
 
-template <vk::Filter filter>
+template <vk::Filter filter,
+          vk::SamplerAddressMode address_mode = vk::SamplerAddressMode::eClampToBorder>
 inline constexpr vk::SamplerCreateInfo SAMPLER_CREATE_INFO{
     .magFilter = filter,
     .minFilter = filter,
     .mipmapMode = vk::SamplerMipmapMode::eNearest,
-    .addressModeU = vk::SamplerAddressMode::eClampToBorder,
-    .addressModeV = vk::SamplerAddressMode::eClampToBorder,
-    .addressModeW = vk::SamplerAddressMode::eClampToBorder,
+    .addressModeU = address_mode,
+    .addressModeV = address_mode,
+    .addressModeW = address_mode,
     .mipLodBias = 0.0f,
     .anisotropyEnable = VK_FALSE,
     .maxAnisotropy = 0.0f,
@@ -175,20 +233,217 @@ constexpr vk::PipelineShaderStageCreateInfo MakeStages(vk::ShaderModule compute_
     };
 }
 
+/// Declarations shared by all texture filter compute shaders, inserted before the filter source
+constexpr std::string_view FILTER_COMPUTE_HEADER = R"(
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(push_constant, std140) uniform FilterInfo {
+    vec2 tex_scale;
+    vec2 tex_offset;
+    ivec2 dst_offset;
+    ivec2 dst_extent;
+    float scale;
+};
+
+#define main FilterMain
+)";
+
+/// Compute entry point that runs the filter fragment shader once for every destination texel
+constexpr std::string_view FILTER_COMPUTE_MAIN = R"(
+#undef main
+
+layout(binding = 3, FILTER_OUTPUT_FORMAT) uniform writeonly image2D dst_image;
+
+void main() {
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(coord, dst_extent))) {
+        return;
+    }
+    tex_coord = tex_offset + (vec2(coord) + 0.5) / vec2(dst_extent) * tex_scale;
+    FilterMain();
+    imageStore(dst_image, dst_offset + coord, FILTER_OUTPUT(frag_color));
+}
+)";
+
+struct FilterPassInfo {
+    std::string_view source;
+    std::string_view output_format;
+    std::string_view output;
+};
+
+constexpr std::array<FilterPassInfo, 7> FILTER_PASSES = {{
+    {HostShaders::BICUBIC_FRAG, "rgba8", "color"},
+    {HostShaders::SCALE_FORCE_FRAG, "rgba8", "color"},
+    {HostShaders::XBRZ_FREESCALE_FRAG, "rgba8", "color"},
+    {HostShaders::MMPX_FRAG, "rgba8", "color"},
+    {HostShaders::X_GRADIENT_FRAG, "rgba16f", "vec4(color, 0.0, 0.0)"},
+    {HostShaders::Y_GRADIENT_FRAG, "rgba16f", "vec4(color)"},
+    {HostShaders::REFINE_FRAG, "rgba8", "color"},
+}};
+
+/// Format of the Anime4K gradient images, it has guaranteed storage support unlike RG16F/R16F
+constexpr vk::Format FILTER_SCRATCH_FORMAT = vk::Format::eR16G16B16A16Sfloat;
+
+/// Number of ticks an idle set of Anime4K images is kept around for reuse
+constexpr u64 FILTER_SCRATCH_LIFETIME = 256;
+
+/// Turns a texture_filtering fragment shader into the body of a filter compute shader
+std::string MakeFilterComputeShader(const FilterPassInfo& pass) {
+    static constexpr std::array<std::string_view, 2> FRAGMENT_INTERFACE = {
+        "layout(location = 0) in ",
+        "layout(location = 0) out ",
+    };
+    std::string source{pass.source};
+    // The fragment stage inputs and outputs become globals written by the compute entry point
+    for (const std::string_view qualifier : FRAGMENT_INTERFACE) {
+        const std::size_t pos = source.find(qualifier);
+        ASSERT_MSG(pos != std::string::npos, "Filter shader is missing its fragment interface");
+        source.erase(pos, qualifier.size());
+    }
+    source += FILTER_COMPUTE_MAIN;
+    return source;
+}
+
+/// Image used by the Anime4K passes for intermediate results
+class ScratchImage {
+public:
+    explicit ScratchImage(const Instance& instance, vk::Format format, vk::ImageUsageFlags usage,
+                          u32 width, u32 height)
+        : allocator{instance.GetAllocator()} {
+        const vk::ImageCreateInfo image_info = {
+            .imageType = vk::ImageType::e2D,
+            .format = format,
+            .extent = {width, height, 1},
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = vk::SampleCountFlagBits::e1,
+            .usage = usage,
+        };
+        const VmaAllocationCreateInfo alloc_info = {
+            .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        };
+
+        VkImage unsafe_image{};
+        VkImageCreateInfo unsafe_image_info = static_cast<VkImageCreateInfo>(image_info);
+        const VkResult result = vmaCreateImage(allocator, &unsafe_image_info, &alloc_info,
+                                               &unsafe_image, &allocation, nullptr);
+        if (result != VK_SUCCESS) [[unlikely]] {
+            LOG_CRITICAL(Render_Vulkan, "Failed allocating filter image with error {}", result);
+            UNREACHABLE();
+        }
+        image = vk::Image{unsafe_image};
+
+        const vk::ImageViewCreateInfo view_info = {
+            .image = image,
+            .viewType = vk::ImageViewType::e2D,
+            .format = format,
+            .subresourceRange{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        };
+        image_view = instance.GetDevice().createImageViewUnique(view_info);
+    }
+
+    ~ScratchImage() {
+        image_view.reset();
+        vmaDestroyImage(allocator, static_cast<VkImage>(image), allocation);
+    }
+
+    ScratchImage(const ScratchImage&) = delete;
+    ScratchImage& operator=(const ScratchImage&) = delete;
+
+    vk::Image Image() const noexcept {
+        return image;
+    }
+
+    vk::ImageView View() const noexcept {
+        return image_view.get();
+    }
+
+private:
+    VmaAllocator allocator;
+    VmaAllocation allocation{};
+    vk::Image image;
+    vk::UniqueImageView image_view;
+};
+
+vk::ImageMemoryBarrier MakeColorBarrier(vk::Image image, vk::AccessFlags src_access,
+                                        vk::AccessFlags dst_access,
+                                        vk::ImageLayout old_layout = vk::ImageLayout::eGeneral) {
+    return vk::ImageMemoryBarrier{
+        .srcAccessMask = src_access,
+        .dstAccessMask = dst_access,
+        .oldLayout = old_layout,
+        .newLayout = vk::ImageLayout::eGeneral,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = 0,
+            .levelCount = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+}
+
 } // Anonymous namespace
 
+/// Source copy and gradient images of a single Anime4K filter
+struct BlitHelper::FilterScratch {
+    explicit FilterScratch(const Instance& instance, u32 width_, u32 height_)
+        : src{instance, vk::Format::eR8G8B8A8Unorm,
+              vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst, width_,
+              height_},
+          xy{instance, FILTER_SCRATCH_FORMAT,
+             vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage, width_ * 2,
+             height_ * 2},
+          lumad{instance, FILTER_SCRATCH_FORMAT,
+                vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage, width_ * 2,
+                height_ * 2},
+          width{width_}, height{height_} {}
+
+    ScratchImage src;
+    ScratchImage xy;
+    ScratchImage lumad;
+    u32 width;
+    u32 height;
+    u64 tick{};
+    bool in_use{};
+};
+
 BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_, DescriptorPool& pool,
-                       RenderpassCache& renderpass_cache_)
+                       RenderpassCache& renderpass_cache_, VideoCore::GpuProfiler& gpu_profiler_)
     : instance{instance_}, scheduler{scheduler_}, renderpass_cache{renderpass_cache_},
-      device{instance.GetDevice()}, compute_provider{instance, pool, COMPUTE_BINDINGS},
+      gpu_profiler{gpu_profiler_}, device{instance.GetDevice()},
+      compute_provider{instance, pool, COMPUTE_BINDINGS},
       compute_buffer_provider{instance, pool, COMPUTE_BUFFER_BINDINGS},
       two_textures_provider{instance, pool, TWO_TEXTURES_BINDINGS},
+      decode_provider{instance, pool, DECODE_BINDINGS},
+      filter_provider{instance, pool, FILTER_BINDINGS},
       compute_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&compute_provider.Layout(), true))},
       compute_buffer_pipeline_layout{device.createPipelineLayout(
           PipelineLayoutCreateInfo(&compute_buffer_provider.Layout(), true))},
       two_textures_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&two_textures_provider.Layout()))},
+      decode_pipeline_layout{device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+          .setLayoutCount = 1,
+          .pSetLayouts = &decode_provider.Layout(),
+          .pushConstantRangeCount = 1,
+          .pPushConstantRanges = &DECODE_PUSH_CONSTANT_RANGE,
+      })},
+      filter_pipeline_layout{device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+          .setLayoutCount = 1,
+          .pSetLayouts = &filter_provider.Layout(),
+          .pushConstantRangeCount = 1,
+          .pPushConstantRanges = &FILTER_PUSH_CONSTANT_RANGE,
+      })},
       full_screen_vert{Compile(HostShaders::FULL_SCREEN_TRIANGLE_VERT,
                                vk::ShaderStageFlagBits::eVertex, device)},
       d24s8_to_rgba8_comp{Compile(HostShaders::VULKAN_D24S8_TO_RGBA8_COMP,
@@ -197,12 +452,17 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_, Descrip
                                    vk::ShaderStageFlagBits::eCompute, device)},
       blit_depth_stencil_frag{Compile(HostShaders::VULKAN_BLIT_DEPTH_STENCIL_FRAG,
                                       vk::ShaderStageFlagBits::eFragment, device)},
+      texture_decode_comp{Compile(HostShaders::VULKAN_TEXTURE_DECODE_COMP,
+                                  vk::ShaderStageFlagBits::eCompute, device)},
       d24s8_to_rgba8_pipeline{MakeComputePipeline(d24s8_to_rgba8_comp, compute_pipeline_layout)},
       depth_to_buffer_pipeline{
           MakeComputePipeline(depth_to_buffer_comp, compute_buffer_pipeline_layout)},
       depth_blit_pipeline{MakeDepthStencilBlitPipeline()},
+      texture_decode_pipeline{MakeComputePipeline(texture_decode_comp, decode_pipeline_layout)},
       linear_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eLinear>)},
-      nearest_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eNearest>)} {
+      nearest_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eNearest>)},
+      filter_sampler{device.createSampler(
+          SAMPLER_CREATE_INFO<vk::Filter::eLinear, vk::SamplerAddressMode::eClampToEdge>)} {
 
     if (instance.HasDebuggingToolAttached()) {
         SetObjectName(device, compute_pipeline_layout, "BlitHelper: compute_pipeline_layout");
@@ -210,17 +470,22 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_, Descrip
                       "BlitHelper: compute_buffer_pipeline_layout");
         SetObjectName(device, two_textures_pipeline_layout,
                       "BlitHelper: two_textures_pipeline_layout");
+        SetObjectName(device, decode_pipeline_layout, "BlitHelper: decode_pipeline_layout");
+        SetObjectName(device, filter_pipeline_layout, "BlitHelper: filter_pipeline_layout");
         SetObjectName(device, full_screen_vert, "BlitHelper: full_screen_vert");
         SetObjectName(device, d24s8_to_rgba8_comp, "BlitHelper: d24s8_to_rgba8_comp");
         SetObjectName(device, depth_to_buffer_comp, "BlitHelper: depth_to_buffer_comp");
         SetObjectName(device, blit_depth_stencil_frag, "BlitHelper: blit_depth_stencil_frag");
+        SetObjectName(device, texture_decode_comp, "BlitHelper: texture_decode_comp");
         SetObjectName(device, d24s8_to_rgba8_pipeline, "BlitHelper: d24s8_to_rgba8_pipeline");
         SetObjectName(device, depth_to_buffer_pipeline, "BlitHelper: depth_to_buffer_pipeline");
+        SetObjectName(device, texture_decode_pipeline, "BlitHelper: texture_decode_pipeline");
         if (depth_blit_pipeline) {
             SetObjectName(device, depth_blit_pipeline, "BlitHelper: depth_blit_pipeline");
         }
         SetObjectName(device, linear_sampler, "BlitHelper: linear_sampler");
         SetObjectName(device, nearest_sampler, "BlitHelper: nearest_sampler");
+        SetObjectName(device, filter_sampler, "BlitHelper: filter_sampler");
     }
 }
 
@@ -228,15 +493,24 @@ BlitHelper::~BlitHelper() {
     device.destroyPipelineLayout(compute_pipeline_layout);
     device.destroyPipelineLayout(compute_buffer_pipeline_layout);
     device.destroyPipelineLayout(two_textures_pipeline_layout);
+    device.destroyPipelineLayout(decode_pipeline_layout);
+    device.destroyPipelineLayout(filter_pipeline_layout);
     device.destroyShaderModule(full_screen_vert);
     device.destroyShaderModule(d24s8_to_rgba8_comp);
     device.destroyShaderModule(depth_to_buffer_comp);
     device.destroyShaderModule(blit_depth_stencil_frag);
+    device.destroyShaderModule(texture_decode_comp);
     device.destroyPipeline(depth_to_buffer_pipeline);
     device.destroyPipeline(d24s8_to_rgba8_pipeline);
     device.destroyPipeline(depth_blit_pipeline);
+    device.destroyPipeline(texture_decode_pipeline);
     device.destroySampler(linear_sampler);
     device.destroySampler(nearest_sampler);
+    device.destroySampler(filter_sampler);
+    for (u32 i = 0; i < filter_pipelines.size(); i++) {
+        device.destroyPipeline(filter_pipelines[i]);
+        device.destroyShaderModule(filter_shaders[i]);
+    }
 }
 
 void BindBlitState(vk::CommandBuffer cmdbuf, vk::PipelineLayout layout,
@@ -526,6 +800,391 @@ bool BlitHelper::DepthToBuffer(Surface& source, vk::Buffer buffer,
     return true;
 }
 
+void BlitHelper::DecodeTiled(Surface& dest, vk::Buffer buffer,
+                             const VideoCore::BufferTextureCopy& copy) {
+    // The staging offset is only guaranteed to be 16 byte aligned, bind the buffer at the closest
+    // valid offset and let the shader skip the remainder.
+    const u32 bind_offset = static_cast<u32>(
+        Common::AlignDown(copy.buffer_offset, instance.StorageMinAlignment()));
+
+    std::array<DescriptorData, 2> textures{};
+    textures[0].buffer_info = vk::DescriptorBufferInfo{
+        .buffer = buffer,
+        .offset = bind_offset,
+        .range = copy.buffer_offset - bind_offset + copy.buffer_size,
+    };
+    textures[1].image_info = vk::DescriptorImageInfo{
+        .imageView = dest.LevelView(copy.texture_level),
+        .imageLayout = vk::ImageLayout::eGeneral,
+    };
+
+    const auto descriptor_set = decode_provider.Acquire(textures);
+
+    const DecodeInfo info = {
+        .dst_offset = Common::Vec2i{static_cast<int>(copy.texture_rect.left),
+                                    static_cast<int>(copy.texture_rect.bottom)},
+        .extent = Common::Vec2i{static_cast<int>(copy.texture_rect.GetWidth()),
+                                static_cast<int>(copy.texture_rect.GetHeight())},
+        .src_offset = copy.buffer_offset - bind_offset,
+        .format = static_cast<u32>(dest.pixel_format),
+    };
+
+    renderpass_cache.EndRendering();
+    scheduler.Record([this, descriptor_set, info, level = copy.texture_level,
+                      image = dest.Image(0), access = dest.AccessFlags(),
+                      stages = dest.PipelineStageFlags()](vk::CommandBuffer cmdbuf) {
+        const vk::ImageSubresourceRange range = {
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = level,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS,
+        };
+        const vk::ImageMemoryBarrier pre_barrier = {
+            .srcAccessMask = access,
+            .dstAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = range,
+        };
+        const vk::ImageMemoryBarrier post_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = access,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = range,
+        };
+        cmdbuf.pipelineBarrier(stages, vk::PipelineStageFlagBits::eComputeShader,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, pre_barrier);
+
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, decode_pipeline_layout, 0,
+                                  descriptor_set, {});
+        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, texture_decode_pipeline);
+        cmdbuf.pushConstants(decode_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+                             sizeof(info), &info);
+
+        cmdbuf.dispatch(info.extent.x / 8, info.extent.y / 8, 1);
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, stages,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, post_barrier);
+    });
+}
+
+bool BlitHelper::Filter(Surface& surface, const VideoCore::TextureBlit& blit) {
+    const auto filter = Settings::values.texture_filter.GetValue();
+    const bool is_depth =
+        surface.type == SurfaceType::Depth || surface.type == SurfaceType::DepthStencil;
+    if (filter == TextureFilter::None || is_depth) {
+        return false;
+    }
+    // The filters write through storage images, which are only available for RGBA8 surfaces.
+    const FormatTraits& traits = surface.traits;
+    if (traits.native != vk::Format::eR8G8B8A8Unorm ||
+        !(traits.usage & vk::ImageUsageFlagBits::eStorage) ||
+        surface.texture_type == VideoCore::TextureType::CubeMap) {
+        return false;
+    }
+    if (blit.src_level != 0) {
+        return true;
+    }
+
+    FilterPass pass;
+    switch (filter) {
+    case TextureFilter::Anime4K:
+        pass = FilterPass::Refine;
+        break;
+    case TextureFilter::Bicubic:
+        pass = FilterPass::Bicubic;
+        break;
+    case TextureFilter::ScaleForce:
+        pass = FilterPass::ScaleForce;
+        break;
+    case TextureFilter::xBRZ:
+        pass = FilterPass::Xbrz;
+        break;
+    case TextureFilter::MMPX:
+        pass = FilterPass::MMPX;
+        break;
+    default:
+        LOG_ERROR(Render_Vulkan, "Unknown texture filter {}", filter);
+        return false;
+    }
+
+    pending_filters.push_back(FilterJob{
+        .pass = pass,
+        .src_image = surface.Image(0),
+        .dst_image = surface.Image(1),
+        .src_view = surface.ImageView(0),
+        .dst_view = surface.LevelView(blit.dst_level, 1),
+        .access = surface.AccessFlags() | vk::AccessFlagBits::eShaderWrite,
+        .stages = surface.PipelineStageFlags() | vk::PipelineStageFlagBits::eComputeShader,
+        .src_extent = surface.RealExtent(false),
+        .src_rect = blit.src_rect,
+        .dst_rect = blit.dst_rect,
+        .scale = static_cast<float>(surface.res_scale),
+    });
+    return true;
+}
+
+void BlitHelper::FlushFilters() {
+    if (pending_filters.empty()) {
+        return;
+    }
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Filter};
+
+    struct FilterDispatch {
+        vk::Pipeline pipeline;
+        vk::DescriptorSet descriptor_set;
+        FilterInfo info;
+    };
+    struct ScratchCopy {
+        vk::Image src_image;
+        vk::Image dst_image;
+        vk::ImageCopy region;
+    };
+
+    // Retire Anime4K images that have not been used in a while
+    const u64 current_tick = scheduler.CurrentTick();
+    std::erase_if(filter_scratch, [&](const std::unique_ptr<FilterScratch>& scratch) {
+        if (!scheduler.IsFree(scratch->tick) ||
+            scratch->tick + FILTER_SCRATCH_LIFETIME > current_tick) {
+            return false;
+        }
+        filter_provider.FreeWithImage(scratch->src.View());
+        filter_provider.FreeWithImage(scratch->xy.View());
+        filter_provider.FreeWithImage(scratch->lumad.View());
+        return true;
+    });
+
+    const auto make_dispatch = [&](FilterPass pass, std::array<vk::ImageView, 3> inputs,
+                                   vk::ImageView output, const FilterInfo& info) {
+        std::array<DescriptorData, 4> data{};
+        for (u32 i = 0; i < inputs.size(); i++) {
+            data[i].image_info = vk::DescriptorImageInfo{
+                .sampler = filter_sampler,
+                .imageView = inputs[i],
+                .imageLayout = vk::ImageLayout::eGeneral,
+            };
+        }
+        data[3].image_info = vk::DescriptorImageInfo{
+            .imageView = output,
+            .imageLayout = vk::ImageLayout::eGeneral,
+        };
+        return FilterDispatch{
+            .pipeline = FilterPipeline(pass),
+            .descriptor_set = filter_provider.Acquire(data),
+            .info = info,
+        };
+    };
+    const auto to_vec2f = [](float x, float y) { return Common::Vec2f{x, y}; };
+    const auto to_vec2i = [](u32 x, u32 y) {
+        return Common::Vec2i{static_cast<int>(x), static_cast<int>(y)};
+    };
+
+    // Every pass reads the results of the previous one, the dispatches within a pass are
+    // independent so they can run without barriers in between.
+    std::vector<vk::ImageMemoryBarrier> pre_barriers;
+    std::vector<vk::ImageMemoryBarrier> post_barriers;
+    std::vector<ScratchCopy> copies;
+    std::array<std::vector<FilterDispatch>, 3> passes;
+    vk::PipelineStageFlags src_stages{};
+    vk::PipelineStageFlags dst_stages{};
+
+    for (const FilterJob& job : pending_filters) {
+        const u32 src_width = job.src_rect.GetWidth();
+        const u32 src_height = job.src_rect.GetHeight();
+        const FilterInfo dst_info = {
+            .tex_scale = to_vec2f(static_cast<float>(src_width) / job.src_extent.width,
+                                  static_cast<float>(src_height) / job.src_extent.height),
+            .tex_offset = to_vec2f(static_cast<float>(job.src_rect.left) / job.src_extent.width,
+                                   static_cast<float>(job.src_rect.bottom) / job.src_extent.height),
+            .dst_offset = to_vec2i(job.dst_rect.left, job.dst_rect.bottom),
+            .dst_extent = to_vec2i(job.dst_rect.GetWidth(), job.dst_rect.GetHeight()),
+            .scale = job.scale,
+        };
+
+        pre_barriers.push_back(MakeColorBarrier(job.src_image, job.access,
+                                                vk::AccessFlagBits::eShaderRead |
+                                                    vk::AccessFlagBits::eTransferRead));
+        pre_barriers.push_back(
+            MakeColorBarrier(job.dst_image, job.access, vk::AccessFlagBits::eShaderWrite));
+        post_barriers.push_back(MakeColorBarrier(job.src_image,
+                                                 vk::AccessFlagBits::eShaderRead |
+                                                     vk::AccessFlagBits::eTransferRead,
+                                                 job.access));
+        post_barriers.push_back(
+            MakeColorBarrier(job.dst_image, vk::AccessFlagBits::eShaderWrite, job.access));
+        src_stages |= job.stages;
+        dst_stages |= job.stages;
+
+        if (job.pass != FilterPass::Refine) {
+            passes[0].push_back(make_dispatch(
+                job.pass, {job.src_view, job.src_view, job.src_view}, job.dst_view, dst_info));
+            continue;
+        }
+
+        // Anime4K works on a copy of the source rectangle and two gradient images of twice its
+        // size, so the refine pass can sample all of them with the same coordinates.
+        FilterScratch& scratch = AcquireScratch(src_width, src_height);
+        const FilterInfo scratch_info = {
+            .tex_scale = to_vec2f(1.f, 1.f),
+            .tex_offset = to_vec2f(0.f, 0.f),
+            .dst_offset = to_vec2i(0, 0),
+            .dst_extent = to_vec2i(src_width * 2, src_height * 2),
+            .scale = job.scale,
+        };
+        FilterInfo refine_info = dst_info;
+        refine_info.tex_scale = to_vec2f(1.f, 1.f);
+        refine_info.tex_offset = to_vec2f(0.f, 0.f);
+
+        pre_barriers.push_back(MakeColorBarrier(scratch.src.Image(), vk::AccessFlagBits::eNone,
+                                                vk::AccessFlagBits::eTransferWrite,
+                                                vk::ImageLayout::eUndefined));
+        pre_barriers.push_back(MakeColorBarrier(scratch.xy.Image(), vk::AccessFlagBits::eNone,
+                                                vk::AccessFlagBits::eShaderWrite,
+                                                vk::ImageLayout::eUndefined));
+        pre_barriers.push_back(MakeColorBarrier(scratch.lumad.Image(), vk::AccessFlagBits::eNone,
+                                                vk::AccessFlagBits::eShaderWrite,
+                                                vk::ImageLayout::eUndefined));
+        src_stages |= vk::PipelineStageFlagBits::eTransfer |
+                      vk::PipelineStageFlagBits::eComputeShader;
+
+        copies.push_back(ScratchCopy{
+            .src_image = job.src_image,
+            .dst_image = scratch.src.Image(),
+            .region{
+                .srcSubresource{
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+                .srcOffset = {static_cast<s32>(job.src_rect.left),
+                              static_cast<s32>(job.src_rect.bottom), 0},
+                .dstSubresource{
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+                .dstOffset = {0, 0, 0},
+                .extent = {src_width, src_height, 1},
+            },
+        });
+
+        const vk::ImageView src = scratch.src.View();
+        const vk::ImageView xy = scratch.xy.View();
+        const vk::ImageView lumad = scratch.lumad.View();
+        passes[0].push_back(
+            make_dispatch(FilterPass::GradientX, {src, src, src}, xy, scratch_info));
+        passes[1].push_back(
+            make_dispatch(FilterPass::GradientY, {xy, xy, xy}, lumad, scratch_info));
+        passes[2].push_back(
+            make_dispatch(FilterPass::Refine, {src, lumad, lumad}, job.dst_view, refine_info));
+    }
+    pending_filters.clear();
+    for (const auto& scratch : filter_scratch) {
+        scratch->in_use = false;
+    }
+
+    renderpass_cache.EndRendering();
+    scheduler.Record([this, pre_barriers = std::move(pre_barriers),
+                      post_barriers = std::move(post_barriers), copies = std::move(copies),
+                      passes = std::move(passes), src_stages,
+                      dst_stages](vk::CommandBuffer cmdbuf) {
+        static constexpr vk::MemoryBarrier COPY_BARRIER = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+        };
+        static constexpr vk::MemoryBarrier PASS_BARRIER = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+        };
+
+        cmdbuf.pipelineBarrier(src_stages,
+                               vk::PipelineStageFlagBits::eTransfer |
+                                   vk::PipelineStageFlagBits::eComputeShader,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, pre_barriers);
+
+        for (const ScratchCopy& copy : copies) {
+            cmdbuf.copyImage(copy.src_image, vk::ImageLayout::eGeneral, copy.dst_image,
+                             vk::ImageLayout::eGeneral, copy.region);
+        }
+        if (!copies.empty()) {
+            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   vk::PipelineStageFlagBits::eComputeShader,
+                                   vk::DependencyFlagBits::eByRegion, COPY_BARRIER, {}, {});
+        }
+
+        for (u32 i = 0; i < passes.size(); i++) {
+            if (passes[i].empty()) {
+                continue;
+            }
+            if (i != 0) {
+                cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                       vk::PipelineStageFlagBits::eComputeShader,
+                                       vk::DependencyFlagBits::eByRegion, PASS_BARRIER, {}, {});
+            }
+            vk::Pipeline bound_pipeline{};
+            for (const FilterDispatch& dispatch : passes[i]) {
+                if (dispatch.pipeline != bound_pipeline) {
+                    cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, dispatch.pipeline);
+                    bound_pipeline = dispatch.pipeline;
+                }
+                cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, filter_pipeline_layout,
+                                          0, dispatch.descriptor_set, {});
+                cmdbuf.pushConstants(filter_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+                                     sizeof(FilterInfo), &dispatch.info);
+                cmdbuf.dispatch((dispatch.info.dst_extent.x + 7) / 8,
+                                (dispatch.info.dst_extent.y + 7) / 8, 1);
+            }
+        }
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, dst_stages,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, post_barriers);
+    });
+}
+
+vk::Pipeline BlitHelper::FilterPipeline(FilterPass pass) {
+    const u32 index = static_cast<u32>(pass);
+    if (filter_pipelines[index]) {
+        return filter_pipelines[index];
+    }
+
+    const FilterPassInfo& info = FILTER_PASSES[index];
+    const std::string preamble =
+        fmt::format("{}#define FILTER_OUTPUT_FORMAT {}\n#define FILTER_OUTPUT(color) {}\n",
+                    FILTER_COMPUTE_HEADER, info.output_format, info.output);
+    filter_shaders[index] = Compile(MakeFilterComputeShader(info),
+                                    vk::ShaderStageFlagBits::eCompute, device, preamble);
+    filter_pipelines[index] = MakeComputePipeline(filter_shaders[index], filter_pipeline_layout);
+    if (instance.HasDebuggingToolAttached()) {
+        SetObjectName(device, filter_pipelines[index], "BlitHelper: filter_pipeline {}", index);
+    }
+    return filter_pipelines[index];
+}
+
+BlitHelper::FilterScratch& BlitHelper::AcquireScratch(u32 width, u32 height) {
+    // Earlier batches are ordered by the pipeline barriers, so the images only have to be
+    // unique within the batch being built.
+    const auto it = std::ranges::find_if(filter_scratch, [&](const auto& scratch) {
+        return scratch->width == width && scratch->height == height && !scratch->in_use;
+    });
+    FilterScratch& scratch = it != filter_scratch.end()
+                                 ? **it
+                                 : *filter_scratch.emplace_back(
+                                       std::make_unique<FilterScratch>(instance, width, height));
+    scratch.tick = scheduler.CurrentTick();
+    scratch.in_use = true;
+    return scratch;
+}
+
 vk::Pipeline BlitHelper::MakeComputePipeline(vk::ShaderModule shader, vk::PipelineLayout layout) {
     const vk::ComputePipelineCreateInfo compute_info = {
         .stage = MakeStages(shader),
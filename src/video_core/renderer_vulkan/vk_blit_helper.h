@@ -4,13 +4,14 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+#include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 
 namespace VideoCore {
-struct TextureBlit;
-struct TextureCopy;
-struct BufferTextureCopy;
-} // namespace VideoCore
+class GpuProfiler;
+}
 
 namespace Vulkan {
 
@@ -24,7 +25,7 @@ class BlitHelper {
 
 public:
     BlitHelper(const Instance& instance, Scheduler& scheduler, DescriptorPool& pool,
-               RenderpassCache& renderpass_cache);
+               RenderpassCache& renderpass_cache, VideoCore::GpuProfiler& gpu_profiler);
     ~BlitHelper();
 
     bool BlitDepthStencil(Surface& source, Surface& dest, const VideoCore::TextureBlit& blit);
@@ -34,14 +35,58 @@ public:
     bool DepthToBuffer(Surface& source, vk::Buffer buffer,
                        const VideoCore::BufferTextureCopy& copy);
 
+    /// Decodes the raw tiled PICA data in buffer to the copy rectangle of the RGBA8 surface
+    void DecodeTiled(Surface& dest, vk::Buffer buffer, const VideoCore::BufferTextureCopy& copy);
+
+    /// Queues the configured texture filter for the upscale blit, returns false when the
+    /// surface should be scaled with a regular blit instead
+    bool Filter(Surface& surface, const VideoCore::TextureBlit& blit);
+
+    /// Records all queued filters, dispatching each filter pass for every surface back to back
+    void FlushFilters();
+
 private:
+    enum class FilterPass : u32 {
+        Bicubic,
+        ScaleForce,
+        Xbrz,
+        MMPX,
+        GradientX,
+        GradientY,
+        Refine,
+        Count,
+    };
+
+    struct FilterJob {
+        FilterPass pass;
+        vk::Image src_image;
+        vk::Image dst_image;
+        vk::ImageView src_view;
+        vk::ImageView dst_view;
+        vk::AccessFlags access;
+        vk::PipelineStageFlags stages;
+        VideoCore::Extent src_extent;
+        Common::Rectangle<u32> src_rect;
+        Common::Rectangle<u32> dst_rect;
+        float scale;
+    };
+
+    struct FilterScratch;
+
     vk::Pipeline MakeComputePipeline(vk::ShaderModule shader, vk::PipelineLayout layout);
     vk::Pipeline MakeDepthStencilBlitPipeline();
 
+    /// Returns the compute pipeline of the filter pass, compiling it on first use
+    vk::Pipeline FilterPipeline(FilterPass pass);
+
+    /// Returns idle Anime4K intermediate images for a source rectangle of the provided size
+    FilterScratch& AcquireScratch(u32 width, u32 height);
+
 private:
     const Instance& instance;
     Scheduler& scheduler;
     RenderpassCache& renderpass_cache;
+    VideoCore::GpuProfiler& gpu_profiler;
 
     vk::Device device;
     vk::RenderPass r32_renderpass;
@@ -49,20 +94,32 @@ private:
     DescriptorSetProvider compute_provider;
     DescriptorSetProvider compute_buffer_provider;
     DescriptorSetProvider two_textures_provider;
+    DescriptorSetProvider decode_provider;
+    DescriptorSetProvider filter_provider;
     vk::PipelineLayout compute_pipeline_layout;
     vk::PipelineLayout compute_buffer_pipeline_layout;
     vk::PipelineLayout two_textures_pipeline_layout;
+    vk::PipelineLayout decode_pipeline_layout;
+    vk::PipelineLayout filter_pipeline_layout;
 
     vk::ShaderModule full_screen_vert;
     vk::ShaderModule d24s8_to_rgba8_comp;
     vk::ShaderModule depth_to_buffer_comp;
     vk::ShaderModule blit_depth_stencil_frag;
+    vk::ShaderModule texture_decode_comp;
 
     vk::Pipeline d24s8_to_rgba8_pipeline;
     vk::Pipeline depth_to_buffer_pipeline;
     vk::Pipeline depth_blit_pipeline;
+    vk::Pipeline texture_decode_pipeline;
     vk::Sampler linear_sampler;
     vk::Sampler nearest_sampler;
+    vk::Sampler filter_sampler;
+
+    std::array<vk::ShaderModule, static_cast<u32>(FilterPass::Count)> filter_shaders{};
+    std::array<vk::Pipeline, static_cast<u32>(FilterPass::Count)> filter_pipelines{};
+    std::vector<FilterJob> pending_filters;
+    std::vector<std::unique_ptr<FilterScratch>> filter_scratch;
 };
 
 } // namespace Vulkan
@@ -0,0 +1,240 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "core/core.h"
+#include "core/dumping/backend.h"
+#include "video_core/renderer_vulkan/vk_frame_dumper.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+#include <vk_mem_alloc.h>
+
+MICROPROFILE_DEFINE(Vulkan_WaitDump, "Vulkan", "Wait For Frame Dump", MP_RGB(128, 160, 128));
+
+namespace Vulkan {
+
+FrameDumper::FrameDumper(Core::System& system_, const Instance& instance_, Scheduler& scheduler_,
+                         PresentWindow& window_)
+    : system{system_}, instance{instance_}, scheduler{scheduler_}, window{window_},
+      swap_red_blue{window.Format() != vk::Format::eB8G8R8A8Unorm} {
+    for (auto& slot : slots) {
+        free_slots.push(&slot);
+    }
+}
+
+FrameDumper::~FrameDumper() {
+    StopDumping();
+    for (auto& slot : slots) {
+        DestroySlot(slot);
+    }
+}
+
+bool FrameDumper::IsDumping() const {
+    auto video_dumper = system.GetVideoDumper();
+    return video_dumper && video_dumper->IsDumping();
+}
+
+Layout::FramebufferLayout FrameDumper::GetLayout() const {
+    auto video_dumper = system.GetVideoDumper();
+    return video_dumper ? video_dumper->GetLayout() : Layout::FramebufferLayout{};
+}
+
+void FrameDumper::StartDumping() {
+    StopDumping();
+
+    {
+        std::scoped_lock lock{slot_mutex};
+        running = true;
+    }
+    readback_thread = std::jthread([this](std::stop_token token) { ReadbackThread(token); });
+}
+
+void FrameDumper::StopDumping() {
+    if (!readback_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::scoped_lock lock{slot_mutex};
+        running = false;
+    }
+
+    // The readback thread sends the frames that are still pending before exiting
+    readback_thread.request_stop();
+    readback_thread.join();
+}
+
+Frame* FrameDumper::GetRenderFrame() {
+    ReadbackSlot* slot;
+    {
+        MICROPROFILE_SCOPE(Vulkan_WaitDump);
+        std::unique_lock lock{slot_mutex};
+        free_cv.wait(lock, [this] { return !free_slots.empty(); });
+        slot = free_slots.front();
+        free_slots.pop();
+    }
+
+    // The GPU is done with free slots, so their resources can be recreated right away
+    const auto layout = GetLayout();
+    if (slot->frame.width != layout.width || slot->frame.height != layout.height) {
+        window.RecreateFrame(&slot->frame, layout.width, layout.height);
+    }
+    const u64 size = static_cast<u64>(layout.width) * layout.height * 4;
+    if (slot->buffer_size != size) {
+        RecreateBuffer(*slot, size);
+    }
+    return &slot->frame;
+}
+
+void FrameDumper::ReadbackFrame(Frame* frame) {
+    ReadbackSlot* slot = nullptr;
+    for (auto& candidate : slots) {
+        if (&candidate.frame == frame) {
+            slot = &candidate;
+        }
+    }
+    ASSERT_MSG(slot, "Frame was not returned by GetRenderFrame");
+
+    scheduler.Record([image = frame->image, buffer = slot->buffer, width = frame->width,
+                      height = frame->height](vk::CommandBuffer cmdbuf) {
+        const vk::BufferImageCopy image_copy = {
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource =
+                {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {width, height, 1},
+        };
+        static constexpr vk::MemoryBarrier host_read_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eHostRead,
+        };
+
+        cmdbuf.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, buffer, image_copy);
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                               vk::PipelineStageFlagBits::eHost, vk::DependencyFlagBits::eByRegion,
+                               host_read_barrier, {}, {});
+    });
+
+    // The copy completes with the submission of the current tick
+    slot->tick = scheduler.CurrentTick();
+
+    std::scoped_lock lock{slot_mutex};
+    if (!running) {
+        // Dumping was stopped while this frame was rendered, nobody reads it back
+        free_slots.push(slot);
+        free_cv.notify_one();
+        return;
+    }
+    pending_slots.push(slot);
+    pending_cv.notify_one();
+}
+
+void FrameDumper::ReadbackThread(std::stop_token token) {
+    Common::SetCurrentThreadName("VulkanFrameDump");
+    MasterSemaphore* master_semaphore = scheduler.GetMasterSemaphore();
+    while (true) {
+        ReadbackSlot* slot;
+        {
+            std::unique_lock lock{slot_mutex};
+            Common::CondvarWait(pending_cv, lock, token,
+                                [this] { return !pending_slots.empty(); });
+            if (pending_slots.empty()) {
+                // Stop was requested and every rendered frame was sent
+                return;
+            }
+            slot = pending_slots.front();
+            pending_slots.pop();
+        }
+
+        master_semaphore->Wait(slot->tick);
+        vmaInvalidateAllocation(instance.GetAllocator(), slot->allocation, 0, VK_WHOLE_SIZE);
+
+        auto video_dumper = system.GetVideoDumper();
+        if (video_dumper) {
+            auto frame_data =
+                video_dumper->AcquireVideoFrame(slot->frame.width, slot->frame.height);
+            if (swap_red_blue) {
+                // The backend takes BGRA frames
+                const u8* src = slot->mapped;
+                u8* dst = frame_data.data.data();
+                for (std::size_t i = 0; i < frame_data.data.size(); i += 4) {
+                    dst[i] = src[i + 2];
+                    dst[i + 1] = src[i + 1];
+                    dst[i + 2] = src[i];
+                    dst[i + 3] = src[i + 3];
+                }
+            } else {
+                std::memcpy(frame_data.data.data(), slot->mapped, frame_data.data.size());
+            }
+            video_dumper->AddVideoFrame(std::move(frame_data));
+        }
+
+        std::scoped_lock lock{slot_mutex};
+        free_slots.push(slot);
+        free_cv.notify_one();
+    }
+}
+
+void FrameDumper::RecreateBuffer(ReadbackSlot& slot, u64 size) {
+    if (slot.buffer) {
+        vmaDestroyBuffer(instance.GetAllocator(), slot.buffer, slot.allocation);
+    }
+
+    const vk::BufferCreateInfo buffer_info = {
+        .size = size,
+        .usage = vk::BufferUsageFlagBits::eTransferDst,
+    };
+
+    const VmaAllocationCreateInfo alloc_create_info = {
+        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT |
+                 VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+        .requiredFlags = 0,
+        .preferredFlags = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+    };
+
+    VkBuffer unsafe_buffer{};
+    VmaAllocationInfo alloc_info;
+    VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(buffer_info);
+
+    VkResult result = vmaCreateBuffer(instance.GetAllocator(), &unsafe_buffer_info,
+                                      &alloc_create_info, &unsafe_buffer, &slot.allocation,
+                                      &alloc_info);
+    if (result != VK_SUCCESS) [[unlikely]] {
+        LOG_CRITICAL(Render_Vulkan, "Failed allocating frame dump buffer with error {}", result);
+        UNREACHABLE();
+    }
+
+    slot.buffer = vk::Buffer{unsafe_buffer};
+    slot.mapped = static_cast<u8*>(alloc_info.pMappedData);
+    slot.buffer_size = size;
+}
+
+void FrameDumper::DestroySlot(ReadbackSlot& slot) {
+    const vk::Device device = instance.GetDevice();
+    if (slot.buffer) {
+        vmaDestroyBuffer(instance.GetAllocator(), slot.buffer, slot.allocation);
+    }
+    device.destroyFramebuffer(slot.frame.framebuffer);
+    device.destroyImageView(slot.frame.image_view);
+    if (slot.frame.image) {
+        vmaDestroyImage(instance.GetAllocator(), slot.frame.image, slot.frame.allocation);
+    }
+}
+
+} // namespace Vulkan
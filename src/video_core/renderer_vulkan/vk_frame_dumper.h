@@ -0,0 +1,82 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include "common/polyfill_thread.h"
+#include "core/frontend/framebuffer_layout.h"
+#include "video_core/renderer_vulkan/vk_present_window.h"
+
+namespace Core {
+class System;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Reads back frames rendered with the present renderpass and sends them to the video encoding
+ * backend. Every frame is copied to a host visible buffer of a small ring as part of the regular
+ * present submission, and a readback thread hands it to the backend once the GPU is done with it,
+ * so the scheduler never waits for the copy.
+ */
+class FrameDumper {
+public:
+    explicit FrameDumper(Core::System& system, const Instance& instance, Scheduler& scheduler,
+                         PresentWindow& window);
+    ~FrameDumper();
+
+    bool IsDumping() const;
+    Layout::FramebufferLayout GetLayout() const;
+    void StartDumping();
+    void StopDumping();
+
+    /// Returns a frame of the dump layout to render to, waits while every slot is being read back
+    Frame* GetRenderFrame();
+
+    /// Records the copy of the rendered frame to its readback buffer. The copy is submitted with
+    /// the next flush of the scheduler.
+    void ReadbackFrame(Frame* frame);
+
+private:
+    struct ReadbackSlot {
+        Frame frame{};
+        vk::Buffer buffer{};
+        VmaAllocation allocation{};
+        u8* mapped{};
+        u64 buffer_size{};
+        u64 tick{};
+    };
+
+    void ReadbackThread(std::stop_token token);
+    void RecreateBuffer(ReadbackSlot& slot, u64 size);
+    void DestroySlot(ReadbackSlot& slot);
+
+private:
+    /// Number of frames that can be rendered before the renderer waits for their readback
+    static constexpr std::size_t NumSlots = 3;
+
+    Core::System& system;
+    const Instance& instance;
+    Scheduler& scheduler;
+    PresentWindow& window;
+    bool swap_red_blue{};
+
+    std::array<ReadbackSlot, NumSlots> slots{};
+    std::queue<ReadbackSlot*> free_slots;
+    std::queue<ReadbackSlot*> pending_slots;
+    std::mutex slot_mutex;
+    std::condition_variable free_cv;
+    std::condition_variable_any pending_cv;
+    bool running{};
+    std::jthread readback_thread;
+};
+
+} // namespace Vulkan
@@ -0,0 +1,62 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/renderer_vulkan/vk_gpu_profiler.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_master_semaphore.h"
+#include "video_core/renderer_vulkan/vk_renderpass_cache.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+namespace Vulkan {
+
+GpuProfiler::GpuProfiler(const Instance& instance_, Scheduler& scheduler_,
+                         RenderpassCache& renderpass_cache_)
+    : VideoCore::GpuProfiler{instance_.IsTimestampSupported()}, instance{instance_},
+      scheduler{scheduler_}, renderpass_cache{renderpass_cache_} {}
+
+GpuProfiler::~GpuProfiler() = default;
+
+void GpuProfiler::WriteTimestamp(u32 frame, u32 index) {
+    scheduler.Record([pool = *pools[frame], index](vk::CommandBuffer cmdbuf) {
+        cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, pool, index);
+    });
+    frame_ticks[frame] = scheduler.CurrentTick();
+}
+
+void GpuProfiler::ResetTimestamps(u32 frame) {
+    if (!pools[frame]) {
+        pools[frame] = instance.GetDevice().createQueryPoolUnique({
+            .queryType = vk::QueryType::eTimestamp,
+            .queryCount = MaxTimestamps,
+        });
+    }
+    // Queries cannot be reset inside a render pass
+    renderpass_cache.EndRendering();
+    scheduler.Record([pool = *pools[frame]](vk::CommandBuffer cmdbuf) {
+        cmdbuf.resetQueryPool(pool, 0, MaxTimestamps);
+    });
+}
+
+bool GpuProfiler::ReadTimestamps(u32 frame, std::span<u64> timestamps) {
+    scheduler.GetMasterSemaphore()->Refresh();
+    if (!scheduler.IsFree(frame_ticks[frame])) {
+        return false;
+    }
+    const vk::Result result = instance.GetDevice().getQueryPoolResults(
+        *pools[frame], 0, static_cast<u32>(timestamps.size()), timestamps.size_bytes(),
+        timestamps.data(), sizeof(u64), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) {
+        return false;
+    }
+
+    const u32 valid_bits = instance.GetTimestampValidBits();
+    const u64 mask = valid_bits >= 64 ? ~u64{0} : (u64{1} << valid_bits) - 1;
+    const double period = instance.GetTimestampPeriod();
+    for (u64& timestamp : timestamps) {
+        timestamp = static_cast<u64>(static_cast<double>(timestamp & mask) * period);
+    }
+    return true;
+}
+
+} // namespace Vulkan
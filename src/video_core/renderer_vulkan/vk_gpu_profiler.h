@@ -0,0 +1,36 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include "video_core/gpu_profiler.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Vulkan {
+
+class Instance;
+class RenderpassCache;
+class Scheduler;
+
+/// Writes the timestamps of the GPU profiler into a timestamp query pool per frame slot
+class GpuProfiler final : public VideoCore::GpuProfiler {
+public:
+    explicit GpuProfiler(const Instance& instance, Scheduler& scheduler,
+                         RenderpassCache& renderpass_cache);
+    ~GpuProfiler() override;
+
+private:
+    void WriteTimestamp(u32 frame, u32 index) override;
+    void ResetTimestamps(u32 frame) override;
+    bool ReadTimestamps(u32 frame, std::span<u64> timestamps) override;
+
+    const Instance& instance;
+    Scheduler& scheduler;
+    RenderpassCache& renderpass_cache;
+    std::array<vk::UniqueQueryPool, NumFrames> pools;
+    std::array<u64, NumFrames> frame_ticks{}; ///< Tick of the last timestamp of every slot
+};
+
+} // namespace Vulkan
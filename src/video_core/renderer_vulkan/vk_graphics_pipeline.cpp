@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <span>
 #include <boost/container/static_vector.hpp>
 
 #include "common/hash.h"
@@ -15,6 +16,9 @@
 namespace Vulkan {
 
 MICROPROFILE_DEFINE(Vulkan_Pipeline, "Vulkan", "Pipeline Building", MP_RGB(0, 192, 32));
+MICROPROFILE_DEFINE(Vulkan_PipelineLibrary, "Vulkan", "Pipeline Library Building",
+                    MP_RGB(0, 160, 64));
+MICROPROFILE_DEFINE(Vulkan_PipelineLink, "Vulkan", "Pipeline Linking", MP_RGB(0, 224, 32));
 
 vk::ShaderStageFlagBits MakeShaderStage(std::size_t index) {
     switch (index) {
@@ -64,45 +68,36 @@ Shader::~Shader() {
     }
 }
 
-GraphicsPipeline::GraphicsPipeline(const Instance& instance_, RenderpassCache& renderpass_cache_,
-                                   const PipelineInfo& info_, vk::PipelineCache pipeline_cache_,
-                                   vk::PipelineLayout layout_, std::array<Shader*, 3> stages_,
-                                   Common::ThreadWorker* worker_)
-    : instance{instance_}, renderpass_cache{renderpass_cache_}, worker{worker_},
-      pipeline_layout{layout_}, pipeline_cache{pipeline_cache_}, info{info_}, stages{stages_} {}
+namespace {
 
-GraphicsPipeline::~GraphicsPipeline() = default;
+/// Fixed function and shader stage state of a pipeline, the create infos point into the object
+struct PipelineState {
+    explicit PipelineState(const Instance& instance, const PipelineInfo& info,
+                           const std::array<Shader*, 3>& stages);
 
-bool GraphicsPipeline::TryBuild(bool wait_built) {
-    // The pipeline is currently being compiled. We can either wait for it
-    // or skip the draw.
-    if (is_pending) {
-        return wait_built;
-    }
-
-    // If the shaders haven't been compiled yet, we cannot proceed.
-    const bool shaders_pending = std::any_of(
-        stages.begin(), stages.end(), [](Shader* shader) { return shader && !shader->IsDone(); });
-    if (!wait_built && shaders_pending) {
-        return false;
-    }
-
-    // Ask the driver if it can give us the pipeline quickly.
-    if (!shaders_pending && instance.IsPipelineCreationCacheControlSupported() && Build(true)) {
-        return true;
-    }
-
-    // Fallback to (a)synchronous compilation
-    worker->QueueWork([this] { Build(); });
-    is_pending = true;
-    return wait_built;
-}
-
-bool GraphicsPipeline::Build(bool fail_on_compile_required) {
-    MICROPROFILE_SCOPE(Vulkan_Pipeline);
-    const vk::Device device = instance.GetDevice();
+    PipelineState(const PipelineState&) = delete;
+    PipelineState& operator=(const PipelineState&) = delete;
 
     std::array<vk::VertexInputBindingDescription, MAX_VERTEX_BINDINGS> bindings;
+    std::array<vk::VertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> attributes;
+    vk::PipelineVertexInputStateCreateInfo vertex_input_info;
+    vk::PipelineInputAssemblyStateCreateInfo input_assembly;
+    vk::PipelineRasterizationStateCreateInfo raster_state;
+    vk::PipelineMultisampleStateCreateInfo multisampling;
+    vk::PipelineColorBlendAttachmentState colorblend_attachment;
+    vk::PipelineColorBlendStateCreateInfo color_blending;
+    vk::Viewport viewport;
+    vk::Rect2D scissor;
+    vk::PipelineViewportStateCreateInfo viewport_info;
+    boost::container::static_vector<vk::DynamicState, 14> dynamic_states;
+    vk::PipelineDynamicStateCreateInfo dynamic_info;
+    vk::PipelineDepthStencilStateCreateInfo depth_info;
+    u32 shader_count = 0;
+    std::array<vk::PipelineShaderStageCreateInfo, MAX_SHADER_STAGES> shader_stages;
+};
+
+PipelineState::PipelineState(const Instance& instance, const PipelineInfo& info,
+                             const std::array<Shader*, 3>& stages) {
     for (u32 i = 0; i < info.vertex_layout.binding_count; i++) {
         const auto& binding = info.vertex_layout.bindings[i];
         bindings[i] = vk::VertexInputBindingDescription{
@@ -113,7 +108,6 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         };
     }
 
-    std::array<vk::VertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> attributes;
     for (u32 i = 0; i < info.vertex_layout.attribute_count; i++) {
         const auto& attr = info.vertex_layout.attributes[i];
         const FormatTraits& traits = instance.GetTraits(attr.type, attr.size);
@@ -132,19 +126,20 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         }
     }
 
-    const vk::PipelineVertexInputStateCreateInfo vertex_input_info = {
+    vertex_input_info = vk::PipelineVertexInputStateCreateInfo{
         .vertexBindingDescriptionCount = info.vertex_layout.binding_count,
         .pVertexBindingDescriptions = bindings.data(),
         .vertexAttributeDescriptionCount = info.vertex_layout.attribute_count,
         .pVertexAttributeDescriptions = attributes.data(),
     };
 
-    const vk::PipelineInputAssemblyStateCreateInfo input_assembly = {
-        .topology = PicaToVK::PrimitiveTopology(info.rasterization.topology),
+    input_assembly = vk::PipelineInputAssemblyStateCreateInfo{
+        .topology = PicaToVK::PrimitiveTopology(info.rasterization.topology,
+                                                info.rasterization.gs_input_vertices),
         .primitiveRestartEnable = false,
     };
 
-    const vk::PipelineRasterizationStateCreateInfo raster_state = {
+    raster_state = vk::PipelineRasterizationStateCreateInfo{
         .depthClampEnable = false,
         .rasterizerDiscardEnable = false,
         .cullMode = PicaToVK::CullMode(info.rasterization.cull_mode),
@@ -153,12 +148,12 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .lineWidth = 1.0f,
     };
 
-    const vk::PipelineMultisampleStateCreateInfo multisampling = {
+    multisampling = vk::PipelineMultisampleStateCreateInfo{
         .rasterizationSamples = vk::SampleCountFlagBits::e1,
         .sampleShadingEnable = false,
     };
 
-    const vk::PipelineColorBlendAttachmentState colorblend_attachment = {
+    colorblend_attachment = vk::PipelineColorBlendAttachmentState{
         .blendEnable = info.blending.blend_enable,
         .srcColorBlendFactor = PicaToVK::BlendFunc(info.blending.src_color_blend_factor),
         .dstColorBlendFactor = PicaToVK::BlendFunc(info.blending.dst_color_blend_factor),
@@ -169,7 +164,7 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .colorWriteMask = static_cast<vk::ColorComponentFlags>(info.blending.color_write_mask),
     };
 
-    const vk::PipelineColorBlendStateCreateInfo color_blending = {
+    color_blending = vk::PipelineColorBlendStateCreateInfo{
         .logicOpEnable = !info.blending.blend_enable && !instance.NeedsLogicOpEmulation(),
         .logicOp = PicaToVK::LogicOp(info.blending.logic_op),
         .attachmentCount = 1,
@@ -177,7 +172,7 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .blendConstants = std::array{1.0f, 1.0f, 1.0f, 1.0f},
     };
 
-    const vk::Viewport viewport = {
+    viewport = vk::Viewport{
         .x = 0.0f,
         .y = 0.0f,
         .width = 1.0f,
@@ -186,19 +181,19 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .maxDepth = 1.0f,
     };
 
-    const vk::Rect2D scissor = {
+    scissor = vk::Rect2D{
         .offset = {0, 0},
         .extent = {1, 1},
     };
 
-    const vk::PipelineViewportStateCreateInfo viewport_info = {
+    viewport_info = vk::PipelineViewportStateCreateInfo{
         .viewportCount = 1,
         .pViewports = &viewport,
         .scissorCount = 1,
         .pScissors = &scissor,
     };
 
-    boost::container::static_vector<vk::DynamicState, 14> dynamic_states = {
+    dynamic_states = {
         vk::DynamicState::eViewport,           vk::DynamicState::eScissor,
         vk::DynamicState::eStencilCompareMask, vk::DynamicState::eStencilWriteMask,
         vk::DynamicState::eStencilReference,   vk::DynamicState::eBlendConstants,
@@ -214,7 +209,7 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         dynamic_states.insert(dynamic_states.end(), extended.begin(), extended.end());
     }
 
-    const vk::PipelineDynamicStateCreateInfo dynamic_info = {
+    dynamic_info = vk::PipelineDynamicStateCreateInfo{
         .dynamicStateCount = static_cast<u32>(dynamic_states.size()),
         .pDynamicStates = dynamic_states.data(),
     };
@@ -226,7 +221,7 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .compareOp = PicaToVK::CompareFunc(info.depth_stencil.stencil_compare_op),
     };
 
-    const vk::PipelineDepthStencilStateCreateInfo depth_info = {
+    depth_info = vk::PipelineDepthStencilStateCreateInfo{
         .depthTestEnable = static_cast<u32>(info.depth_stencil.depth_test_enable.Value()),
         .depthWriteEnable = static_cast<u32>(info.depth_stencil.depth_write_enable.Value()),
         .depthCompareOp = PicaToVK::CompareFunc(info.depth_stencil.depth_compare_op),
@@ -236,8 +231,6 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
         .back = stencil_op_state,
     };
 
-    u32 shader_count = 0;
-    std::array<vk::PipelineShaderStageCreateInfo, MAX_SHADER_STAGES> shader_stages;
     for (std::size_t i = 0; i < stages.size(); i++) {
         Shader* shader = stages[i];
         if (!shader) {
@@ -251,18 +244,195 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
             .pName = "main",
         };
     }
+}
+
+/// Shaders are never destroyed while the pipeline cache is alive, so they are hashed by address
+u64 HashShaders(std::span<Shader* const> shaders) {
+    u64 hash = 0;
+    for (Shader* shader : shaders) {
+        hash = Common::HashCombine(hash, reinterpret_cast<std::uintptr_t>(shader));
+    }
+    return hash;
+}
+
+} // Anonymous namespace
+
+PipelineLibraryCache::PipelineLibraryCache(const Instance& instance_,
+                                           RenderpassCache& renderpass_cache_,
+                                           vk::PipelineCache pipeline_cache_,
+                                           vk::PipelineLayout layout_)
+    : instance{instance_}, renderpass_cache{renderpass_cache_}, pipeline_cache{pipeline_cache_},
+      pipeline_layout{layout_} {}
+
+PipelineLibraryCache::~PipelineLibraryCache() = default;
+
+std::array<vk::Pipeline, PipelineLibraryCache::NUM_PARTS> PipelineLibraryCache::GetLibraries(
+    const PipelineInfo& info, const std::array<Shader*, 3>& stages) {
+    using Part = vk::GraphicsPipelineLibraryFlagBitsEXT;
+    static constexpr std::array<Part, NUM_PARTS> parts = {
+        Part::eVertexInputInterface,
+        Part::ePreRasterizationShaders,
+        Part::eFragmentShader,
+        Part::eFragmentOutputInterface,
+    };
+
+    const auto append_hash = [](u64& hash, const auto& data) {
+        hash = Common::HashCombine(hash, Common::ComputeStructHash64(data));
+    };
+
+    // Each part is keyed by the state it contains, mirroring PipelineInfo::Hash
+    std::array<u64, NUM_PARTS> hashes{};
+    append_hash(hashes[0], info.vertex_layout);
+    hashes[1] = HashShaders(std::array{stages[0], stages[2]});
+    append_hash(hashes[1], info.attachments);
+    hashes[2] = HashShaders(std::array{stages[1]});
+    append_hash(hashes[2], info.attachments);
+    append_hash(hashes[3], info.blending);
+    append_hash(hashes[3], info.attachments);
+    if (!instance.IsExtendedDynamicStateSupported()) {
+        append_hash(hashes[0], info.rasterization);
+        append_hash(hashes[1], info.rasterization);
+        append_hash(hashes[2], info.depth_stencil);
+    }
+
+    std::array<vk::Pipeline, NUM_PARTS> handles;
+    for (std::size_t i = 0; i < NUM_PARTS; i++) {
+        auto [it, new_library] = libraries[i].try_emplace(hashes[i]);
+        if (new_library) {
+            it->second = CreateLibrary(info, stages, parts[i]);
+        }
+        handles[i] = *it->second;
+    }
+    return handles;
+}
+
+vk::UniquePipeline PipelineLibraryCache::CreateLibrary(
+    const PipelineInfo& info, const std::array<Shader*, 3>& stages,
+    vk::GraphicsPipelineLibraryFlagBitsEXT part) {
+    MICROPROFILE_SCOPE(Vulkan_PipelineLibrary);
+    using Part = vk::GraphicsPipelineLibraryFlagBitsEXT;
+    const PipelineState state{instance, info, stages};
+
+    // The shader stages are split between the pre-rasterization and fragment shader parts
+    u32 shader_count = 0;
+    std::array<vk::PipelineShaderStageCreateInfo, MAX_SHADER_STAGES> shader_stages;
+    for (u32 i = 0; i < state.shader_count; i++) {
+        const bool is_fragment = state.shader_stages[i].stage == vk::ShaderStageFlagBits::eFragment;
+        if (is_fragment == (part == Part::eFragmentShader)) {
+            shader_stages[shader_count++] = state.shader_stages[i];
+        }
+    }
+
+    const vk::GraphicsPipelineLibraryCreateInfoEXT library_info = {
+        .flags = part,
+    };
+
+    vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .pNext = &library_info,
+        .flags = vk::PipelineCreateFlagBits::eLibraryKHR,
+        .pDynamicState = &state.dynamic_info,
+    };
+
+    switch (part) {
+    case Part::eVertexInputInterface:
+        pipeline_info.pVertexInputState = &state.vertex_input_info;
+        pipeline_info.pInputAssemblyState = &state.input_assembly;
+        break;
+    case Part::ePreRasterizationShaders:
+        pipeline_info.stageCount = shader_count;
+        pipeline_info.pStages = shader_stages.data();
+        pipeline_info.pViewportState = &state.viewport_info;
+        pipeline_info.pRasterizationState = &state.raster_state;
+        pipeline_info.layout = pipeline_layout;
+        break;
+    case Part::eFragmentShader:
+        pipeline_info.stageCount = shader_count;
+        pipeline_info.pStages = shader_stages.data();
+        pipeline_info.pMultisampleState = &state.multisampling;
+        pipeline_info.pDepthStencilState = &state.depth_info;
+        pipeline_info.layout = pipeline_layout;
+        break;
+    case Part::eFragmentOutputInterface:
+        pipeline_info.pMultisampleState = &state.multisampling;
+        pipeline_info.pColorBlendState = &state.color_blending;
+        break;
+    }
+
+    if (part != Part::eVertexInputInterface) {
+        pipeline_info.renderPass =
+            renderpass_cache.GetRenderpass(info.attachments.color, info.attachments.depth, false);
+    }
+
+    auto result = instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+    if (result.result != vk::Result::eSuccess) {
+        UNREACHABLE_MSG("Graphics pipeline library creation failed!");
+    }
+    return std::move(result.value);
+}
+
+GraphicsPipeline::GraphicsPipeline(const Instance& instance_, RenderpassCache& renderpass_cache_,
+                                   const PipelineInfo& info_, vk::PipelineCache pipeline_cache_,
+                                   vk::PipelineLayout layout_, std::array<Shader*, 3> stages_,
+                                   Common::TaskGroup* worker_,
+                                   PipelineLibraryCache* library_cache_)
+    : instance{instance_}, renderpass_cache{renderpass_cache_}, worker{worker_},
+      library_cache{library_cache_}, pipeline_layout{layout_}, pipeline_cache{pipeline_cache_},
+      info{info_}, stages{stages_} {}
+
+GraphicsPipeline::~GraphicsPipeline() = default;
+
+bool GraphicsPipeline::TryBuild(bool wait_built) {
+    // The pipeline is currently being compiled. We can either wait for it
+    // or skip the draw.
+    if (is_pending) {
+        return wait_built;
+    }
+
+    // If the shaders haven't been compiled yet, we cannot proceed.
+    const bool shaders_pending = std::any_of(
+        stages.begin(), stages.end(), [](Shader* shader) { return shader && !shader->IsDone(); });
+    if (!wait_built && shaders_pending) {
+        return false;
+    }
+
+    // Ask the driver if it can give us the pipeline quickly.
+    if (!shaders_pending && instance.IsPipelineCreationCacheControlSupported() && Build(true)) {
+        return true;
+    }
+
+    // Link the pipeline from its libraries for immediate use and replace it
+    // with the optimized one once that has been built.
+    if (library_cache && Link()) {
+        worker->QueueWork([this] { Build(); });
+        return true;
+    }
+
+    // Fallback to (a)synchronous compilation
+    QueueBuild();
+    return wait_built;
+}
+
+void GraphicsPipeline::QueueBuild() {
+    worker->QueueWork([this] { Build(); });
+    is_pending = true;
+}
+
+bool GraphicsPipeline::Build(bool fail_on_compile_required) {
+    MICROPROFILE_SCOPE(Vulkan_Pipeline);
+    const vk::Device device = instance.GetDevice();
+    const PipelineState state{instance, info, stages};
 
     vk::GraphicsPipelineCreateInfo pipeline_info = {
-        .stageCount = shader_count,
-        .pStages = shader_stages.data(),
-        .pVertexInputState = &vertex_input_info,
-        .pInputAssemblyState = &input_assembly,
-        .pViewportState = &viewport_info,
-        .pRasterizationState = &raster_state,
-        .pMultisampleState = &multisampling,
-        .pDepthStencilState = &depth_info,
-        .pColorBlendState = &color_blending,
-        .pDynamicState = &dynamic_info,
+        .stageCount = state.shader_count,
+        .pStages = state.shader_stages.data(),
+        .pVertexInputState = &state.vertex_input_info,
+        .pInputAssemblyState = &state.input_assembly,
+        .pViewportState = &state.viewport_info,
+        .pRasterizationState = &state.raster_state,
+        .pMultisampleState = &state.multisampling,
+        .pDepthStencilState = &state.depth_info,
+        .pColorBlendState = &state.color_blending,
+        .pDynamicState = &state.dynamic_info,
         .layout = pipeline_layout,
         .renderPass =
             renderpass_cache.GetRenderpass(info.attachments.color, info.attachments.depth, false),
@@ -273,14 +443,46 @@ bool GraphicsPipeline::Build(bool fail_on_compile_required) {
     }
 
     auto result = device.createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
-    if (result.result == vk::Result::eSuccess) {
-        pipeline = std::move(result.value);
-    } else if (result.result == vk::Result::eErrorPipelineCompileRequiredEXT) {
+    if (result.result == vk::Result::eErrorPipelineCompileRequiredEXT) {
         return false;
-    } else {
+    } else if (result.result != vk::Result::eSuccess) {
         UNREACHABLE_MSG("Graphics pipeline creation failed!");
     }
 
+    // The linked pipeline is kept alive, it may still be referenced by command buffers.
+    if (pipeline) {
+        optimized_pipeline = std::move(result.value);
+        is_optimized.store(true, std::memory_order::release);
+        return true;
+    }
+
+    pipeline = std::move(result.value);
+    MarkDone();
+    return true;
+}
+
+bool GraphicsPipeline::Link() {
+    MICROPROFILE_SCOPE(Vulkan_PipelineLink);
+    const auto libraries = library_cache->GetLibraries(info, stages);
+
+    const vk::PipelineLibraryCreateInfoKHR library_info = {
+        .libraryCount = static_cast<u32>(libraries.size()),
+        .pLibraries = libraries.data(),
+    };
+
+    const vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .pNext = &library_info,
+        .layout = pipeline_layout,
+    };
+
+    auto result = instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+    if (result.result != vk::Result::eSuccess) {
+        LOG_ERROR(Render_Vulkan, "Failed to link graphics pipeline with error {}",
+                  vk::to_string(result.result));
+        return false;
+    }
+
+    pipeline = std::move(result.value);
     MarkDone();
     return true;
 }
@@ -2,41 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "common/thread_worker.h"
+#include <unordered_map>
+#include "common/async_handle.h"
+#include "common/thread_pool.h"
 #include "video_core/pica/regs_pipeline.h"
 #include "video_core/pica/regs_rasterizer.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/renderer_vulkan/vk_common.h"
 
-namespace Common {
-
-struct AsyncHandle {
-public:
-    AsyncHandle(bool is_done_ = false) : is_done{is_done_} {}
-
-    [[nodiscard]] bool IsDone() noexcept {
-        return is_done.load(std::memory_order::relaxed);
-    }
-
-    void WaitDone() noexcept {
-        std::unique_lock lock{mutex};
-        condvar.wait(lock, [this] { return is_done.load(std::memory_order::relaxed); });
-    }
-
-    void MarkDone(bool done = true) noexcept {
-        std::scoped_lock lock{mutex};
-        is_done = done;
-        condvar.notify_all();
-    }
-
-private:
-    std::condition_variable condvar;
-    std::mutex mutex;
-    std::atomic_bool is_done{false};
-};
-
-} // namespace Common
-
 namespace Vulkan {
 
 class Instance;
@@ -53,6 +26,7 @@ constexpr u32 MAX_VERTEX_BINDINGS = 13;
 union RasterizationState {
     u8 value = 0;
     BitField<0, 2, Pica::PipelineRegs::TriangleTopology> topology;
+    BitField<2, 2, u32> gs_input_vertices; ///< Vertices per PICA geometry shader invocation, or 0
     BitField<4, 2, Pica::RasterizerRegs::CullMode> cull_mode;
 };
 
@@ -163,28 +137,66 @@ struct Shader : public Common::AsyncHandle {
     std::string program;
 };
 
+/**
+ * Caches the parts of VK_EXT_graphics_pipeline_library pipelines. Each part only depends on the
+ * state it contains, so a new pipeline is usually linked from existing parts without compiling
+ * any shader code.
+ */
+class PipelineLibraryCache {
+public:
+    static constexpr std::size_t NUM_PARTS = 4;
+
+    explicit PipelineLibraryCache(const Instance& instance, RenderpassCache& renderpass_cache,
+                                  vk::PipelineCache pipeline_cache, vk::PipelineLayout layout);
+    ~PipelineLibraryCache();
+
+    /// Returns the vertex input, pre-rasterization, fragment shader and fragment output libraries
+    [[nodiscard]] std::array<vk::Pipeline, NUM_PARTS> GetLibraries(
+        const PipelineInfo& info, const std::array<Shader*, 3>& stages);
+
+private:
+    vk::UniquePipeline CreateLibrary(const PipelineInfo& info, const std::array<Shader*, 3>& stages,
+                                     vk::GraphicsPipelineLibraryFlagBitsEXT part);
+
+private:
+    const Instance& instance;
+    RenderpassCache& renderpass_cache;
+    vk::PipelineCache pipeline_cache;
+    vk::PipelineLayout pipeline_layout;
+    std::array<std::unordered_map<u64, vk::UniquePipeline>, NUM_PARTS> libraries;
+};
+
 class GraphicsPipeline : public Common::AsyncHandle {
 public:
     explicit GraphicsPipeline(const Instance& instance, RenderpassCache& renderpass_cache,
                               const PipelineInfo& info, vk::PipelineCache pipeline_cache,
                               vk::PipelineLayout layout, std::array<Shader*, 3> stages,
-                              Common::ThreadWorker* worker);
+                              Common::TaskGroup* worker, PipelineLibraryCache* library_cache);
     ~GraphicsPipeline();
 
     bool TryBuild(bool wait_built);
 
     bool Build(bool fail_on_compile_required = false);
 
+    /// Queues the pipeline to be built on the worker threads
+    void QueueBuild();
+
+    /// Links the pipeline from its libraries, without link time optimization
+    bool Link();
+
     [[nodiscard]] vk::Pipeline Handle() const noexcept {
-        return *pipeline;
+        return is_optimized.load(std::memory_order::acquire) ? *optimized_pipeline : *pipeline;
     }
 
 private:
     const Instance& instance;
     RenderpassCache& renderpass_cache;
-    Common::ThreadWorker* worker;
+    Common::TaskGroup* worker;
+    PipelineLibraryCache* library_cache;
 
     vk::UniquePipeline pipeline;
+    vk::UniquePipeline optimized_pipeline;
+    std::atomic_bool is_optimized{};
     vk::PipelineLayout pipeline_layout;
     vk::PipelineCache pipeline_cache;
 
@@ -250,9 +250,11 @@ FormatTraits Instance::DetermineTraits(VideoCore::PixelFormat pixel_format, vk::
                           ? vk::ImageUsageFlagBits::eDepthStencilAttachment
                           : vk::ImageUsageFlagBits::eColorAttachment;
     }
-    // Storage flag is only needed for shadow rendering with RGBA8 texture.
-    // Keeping it disables can boost performance on mobile drivers.
-    if (supports_storage && pixel_format == VideoCore::PixelFormat::RGBA8) {
+    // Storage flag is only needed for shadow rendering with RGBA8 texture and for formats
+    // decoded to RGBA8 with compute. Keeping it disables can boost performance on mobile drivers.
+    const bool is_gpu_decoded =
+        format == vk::Format::eR8G8B8A8Unorm && VideoCore::IsGpuDecodable(pixel_format);
+    if (supports_storage && (pixel_format == VideoCore::PixelFormat::RGBA8 || is_gpu_decoded)) {
         best_usage |= vk::ImageUsageFlagBits::eStorage;
     }
 
@@ -404,11 +406,16 @@ bool Instance::CreateDevice() {
         vk::PhysicalDeviceCustomBorderColorFeaturesEXT, vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT,
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT,
-        vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR>();
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT,
+        vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR,
+        vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR,
+        vk::PhysicalDeviceDescriptorIndexingFeaturesEXT>();
     const vk::StructureChain properties_chain =
         physical_device.getProperties2<vk::PhysicalDeviceProperties2,
                                        vk::PhysicalDevicePortabilitySubsetPropertiesKHR,
-                                       vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>();
+                                       vk::PhysicalDeviceExternalMemoryHostPropertiesEXT,
+                                       vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+                                       vk::PhysicalDeviceDescriptorIndexingPropertiesEXT>();
 
     features = feature_chain.get().features;
     if (available_extensions.empty()) {
@@ -416,7 +423,7 @@ bool Instance::CreateDevice() {
         return false;
     }
 
-    boost::container::static_vector<const char*, 13> enabled_extensions;
+    boost::container::static_vector<const char*, 20> enabled_extensions;
     const auto add_extension = [&](std::string_view extension, bool blacklist = false,
                                    std::string_view reason = "") -> bool {
         const auto result =
@@ -448,6 +455,7 @@ bool Instance::CreateDevice() {
     shader_stencil_export = add_extension(VK_EXT_SHADER_STENCIL_EXPORT_EXTENSION_NAME);
     external_memory_host = add_extension(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
     tooling_info = add_extension(VK_EXT_TOOLING_INFO_EXTENSION_NAME);
+    memory_budget = add_extension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
     const bool has_timeline_semaphores =
         add_extension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, is_qualcomm || is_turnip,
                       "it is broken on Qualcomm drivers");
@@ -465,9 +473,15 @@ bool Instance::CreateDevice() {
     const bool has_pipeline_creation_cache_control =
         add_extension(VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME, is_nvidia,
                       "it is broken on Nvidia drivers");
+    const bool has_graphics_pipeline_library =
+        add_extension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        add_extension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
     const bool has_fragment_shader_barycentric =
         add_extension(VK_KHR_FRAGMENT_SHADER_BARYCENTRIC_EXTENSION_NAME, is_moltenvk,
                       "the PerVertexKHR attribute is not supported by MoltenVK");
+    const bool has_present_wait = add_extension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+                                  add_extension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    const bool has_descriptor_indexing = add_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
 
     const auto family_properties = physical_device.getQueueFamilyProperties();
     if (family_properties.empty()) {
@@ -476,12 +490,26 @@ bool Instance::CreateDevice() {
     }
 
     bool graphics_queue_found = false;
+    bool transfer_queue_found = false;
     for (std::size_t i = 0; i < family_properties.size(); i++) {
         const u32 index = static_cast<u32>(i);
-        if (family_properties[i].queueFlags & vk::QueueFlagBits::eGraphics) {
+        const vk::QueueFlags flags = family_properties[i].queueFlags;
+        if (flags & vk::QueueFlagBits::eGraphics) {
             queue_family_index = index;
+            timestamp_valid_bits = family_properties[i].timestampValidBits;
             graphics_queue_found = true;
         }
+        // Transfer only families are backed by dedicated copy engines. Surface uploads copy
+        // arbitrary rectangles, so only accept families without a transfer granularity.
+        const vk::Extent3D granularity = family_properties[i].minImageTransferGranularity;
+        const bool is_transfer_only = (flags & vk::QueueFlagBits::eTransfer) &&
+                                      !(flags & vk::QueueFlagBits::eGraphics) &&
+                                      !(flags & vk::QueueFlagBits::eCompute);
+        if (!transfer_queue_found && is_transfer_only && granularity.width == 1 &&
+            granularity.height == 1 && granularity.depth == 1) {
+            transfer_queue_family_index = index;
+            transfer_queue_found = true;
+        }
     }
 
     if (!graphics_queue_found) {
@@ -491,16 +519,23 @@ bool Instance::CreateDevice() {
 
     static constexpr std::array<f32, 1> queue_priorities = {1.0f};
 
-    const vk::DeviceQueueCreateInfo queue_info = {
-        .queueFamilyIndex = queue_family_index,
-        .queueCount = static_cast<u32>(queue_priorities.size()),
-        .pQueuePriorities = queue_priorities.data(),
+    const std::array queue_infos = {
+        vk::DeviceQueueCreateInfo{
+            .queueFamilyIndex = queue_family_index,
+            .queueCount = static_cast<u32>(queue_priorities.size()),
+            .pQueuePriorities = queue_priorities.data(),
+        },
+        vk::DeviceQueueCreateInfo{
+            .queueFamilyIndex = transfer_queue_family_index,
+            .queueCount = static_cast<u32>(queue_priorities.size()),
+            .pQueuePriorities = queue_priorities.data(),
+        },
     };
 
     vk::StructureChain device_chain = {
         vk::DeviceCreateInfo{
-            .queueCreateInfoCount = 1u,
-            .pQueueCreateInfos = &queue_info,
+            .queueCreateInfoCount = transfer_queue_found ? 2u : 1u,
+            .pQueueCreateInfos = queue_infos.data(),
             .enabledExtensionCount = static_cast<u32>(enabled_extensions.size()),
             .ppEnabledExtensionNames = enabled_extensions.data(),
         },
@@ -511,6 +546,8 @@ bool Instance::CreateDevice() {
                 .logicOp = features.logicOp,
                 .samplerAnisotropy = features.samplerAnisotropy,
                 .fragmentStoresAndAtomics = features.fragmentStoresAndAtomics,
+                .shaderSampledImageArrayDynamicIndexing =
+                    features.shaderSampledImageArrayDynamicIndexing && has_descriptor_indexing,
                 .shaderClipDistance = features.shaderClipDistance,
             },
         },
@@ -523,7 +560,11 @@ bool Instance::CreateDevice() {
         vk::PhysicalDeviceIndexTypeUint8FeaturesEXT{},
         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT{},
         vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT{},
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT{},
         vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR{},
+        vk::PhysicalDevicePresentIdFeaturesKHR{},
+        vk::PhysicalDevicePresentWaitFeaturesKHR{},
+        vk::PhysicalDeviceDescriptorIndexingFeaturesEXT{},
     };
 
 #define PROP_GET(structName, prop, property) property = properties_chain.get<structName>().prop;
@@ -591,6 +632,19 @@ bool Instance::CreateDevice() {
         device_chain.unlink<vk::PhysicalDevicePipelineCreationCacheControlFeaturesEXT>();
     }
 
+    if (has_graphics_pipeline_library) {
+        FEAT_SET(vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, graphicsPipelineLibrary,
+                 graphics_pipeline_library)
+
+        // Linking is only worth it over building the pipeline when the driver does it quickly
+        bool fast_linking{};
+        PROP_GET(vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+                 graphicsPipelineLibraryFastLinking, fast_linking)
+        graphics_pipeline_library &= fast_linking;
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+    }
+
     if (external_memory_host) {
         PROP_GET(vk::PhysicalDeviceExternalMemoryHostPropertiesEXT, minImportedHostPointerAlignment,
                  min_imported_host_pointer_alignment);
@@ -603,6 +657,40 @@ bool Instance::CreateDevice() {
         device_chain.unlink<vk::PhysicalDeviceFragmentShaderBarycentricFeaturesKHR>();
     }
 
+    if (has_present_wait) {
+        bool present_id{};
+        FEAT_SET(vk::PhysicalDevicePresentIdFeaturesKHR, presentId, present_id)
+        FEAT_SET(vk::PhysicalDevicePresentWaitFeaturesKHR, presentWait, present_wait)
+        present_wait &= present_id;
+    } else {
+        device_chain.unlink<vk::PhysicalDevicePresentIdFeaturesKHR>();
+        device_chain.unlink<vk::PhysicalDevicePresentWaitFeaturesKHR>();
+    }
+
+    if (has_descriptor_indexing) {
+        // The texture heap is a partially bound array of samplers that is written while in use
+        bool partially_bound{};
+        bool update_after_bind{};
+        bool update_unused_while_pending{};
+        FEAT_SET(vk::PhysicalDeviceDescriptorIndexingFeaturesEXT, descriptorBindingPartiallyBound,
+                 partially_bound)
+        FEAT_SET(vk::PhysicalDeviceDescriptorIndexingFeaturesEXT,
+                 descriptorBindingSampledImageUpdateAfterBind, update_after_bind)
+        FEAT_SET(vk::PhysicalDeviceDescriptorIndexingFeaturesEXT,
+                 descriptorBindingUpdateUnusedWhilePending, update_unused_while_pending)
+        u32 max_sampled_images{};
+        u32 max_samplers{};
+        PROP_GET(vk::PhysicalDeviceDescriptorIndexingPropertiesEXT,
+                 maxPerStageDescriptorUpdateAfterBindSampledImages, max_sampled_images)
+        PROP_GET(vk::PhysicalDeviceDescriptorIndexingPropertiesEXT,
+                 maxPerStageDescriptorUpdateAfterBindSamplers, max_samplers)
+        max_texture_heap_size = std::min(max_sampled_images, max_samplers);
+        descriptor_indexing = partially_bound && update_after_bind && update_unused_while_pending &&
+                              features.shaderSampledImageArrayDynamicIndexing;
+    } else {
+        device_chain.unlink<vk::PhysicalDeviceDescriptorIndexingFeaturesEXT>();
+    }
+
 #undef PROP_GET
 #undef FEAT_SET
 
@@ -618,6 +706,13 @@ bool Instance::CreateDevice() {
     graphics_queue = device->getQueue(queue_family_index, 0);
     present_queue = device->getQueue(queue_family_index, 0);
 
+    // Uploads signal graphics with a timeline semaphore, so the transfer queue requires them.
+    if (transfer_queue_found && timeline_semaphores) {
+        transfer_queue = device->getQueue(transfer_queue_family_index, 0);
+        LOG_INFO(Render_Vulkan, "Using queue family {} for asynchronous transfers",
+                 transfer_queue_family_index);
+    }
+
     CreateAllocator();
     return true;
 }
@@ -629,6 +724,7 @@ void Instance::CreateAllocator() {
     };
 
     const VmaAllocatorCreateInfo allocator_info = {
+        .flags = memory_budget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
         .physicalDevice = physical_device,
         .device = *device,
         .pVulkanFunctions = &functions,
@@ -93,6 +93,19 @@ public:
         return present_queue;
     }
 
+    /// Returns true when surface uploads can be recorded on a dedicated transfer queue
+    bool HasTransferQueue() const {
+        return static_cast<bool>(transfer_queue);
+    }
+
+    u32 GetTransferQueueFamilyIndex() const {
+        return transfer_queue_family_index;
+    }
+
+    vk::Queue GetTransferQueue() const {
+        return transfer_queue;
+    }
+
     /// Returns true when a known debugging tool is attached.
     bool HasDebuggingToolAttached() const {
         return has_renderdoc || has_nsight_graphics;
@@ -158,6 +171,11 @@ public:
         return pipeline_creation_cache_control;
     }
 
+    /// Returns true when VK_EXT_graphics_pipeline_library is supported with fast linking
+    bool IsGraphicsPipelineLibrarySupported() const {
+        return graphics_pipeline_library;
+    }
+
     /// Returns true when VK_EXT_shader_stencil_export is supported
     bool IsShaderStencilExportSupported() const {
         return shader_stencil_export;
@@ -173,6 +191,21 @@ public:
         return fragment_shader_barycentric;
     }
 
+    /// Returns true when VK_KHR_present_id and VK_KHR_present_wait are supported
+    bool IsPresentWaitSupported() const {
+        return present_wait;
+    }
+
+    /// Returns true when VK_EXT_descriptor_indexing supports an update after bind texture array
+    bool IsDescriptorIndexingSupported() const {
+        return descriptor_indexing;
+    }
+
+    /// Returns the maximum number of textures in the update after bind texture array
+    u32 MaxTextureHeapSize() const {
+        return max_texture_heap_size;
+    }
+
     /// Returns the vendor ID of the physical device
     u32 GetVendorID() const {
         return properties.vendorID;
@@ -223,6 +256,11 @@ public:
         return properties.limits.minUniformBufferOffsetAlignment;
     }
 
+    /// Returns the minimum required alignment for storage buffers
+    vk::DeviceSize StorageMinAlignment() const {
+        return properties.limits.minStorageBufferOffsetAlignment;
+    }
+
     /// Returns the minimum alignemt required for accessing host-mapped device memory
     vk::DeviceSize NonCoherentAtomSize() const {
         return properties.limits.nonCoherentAtomSize;
@@ -233,6 +271,21 @@ public:
         return properties.limits.maxTexelBufferElements;
     }
 
+    /// Returns true if the graphics queue can write timestamps
+    bool IsTimestampSupported() const {
+        return timestamp_valid_bits != 0 && properties.limits.timestampPeriod > 0.0f;
+    }
+
+    /// Returns the number of valid bits of the timestamps written by the graphics queue
+    u32 GetTimestampValidBits() const {
+        return timestamp_valid_bits;
+    }
+
+    /// Returns the number of nanoseconds it takes for a timestamp to be incremented by one
+    f32 GetTimestampPeriod() const {
+        return properties.limits.timestampPeriod;
+    }
+
     /// Returns true if shaders can declare the ClipDistance attribute
     bool IsShaderClipDistanceSupported() const {
         return features.shaderClipDistance;
@@ -301,6 +354,7 @@ private:
     VmaAllocator allocator{};
     vk::Queue present_queue;
     vk::Queue graphics_queue;
+    vk::Queue transfer_queue;
     std::vector<vk::PhysicalDevice> physical_devices;
     FormatTraits null_traits;
     std::array<FormatTraits, VideoCore::PIXEL_FORMAT_COUNT> format_table;
@@ -308,6 +362,8 @@ private:
     std::array<FormatTraits, 16> attrib_table;
     std::vector<std::string> available_extensions;
     u32 queue_family_index{0};
+    u32 transfer_queue_family_index{0};
+    u32 timestamp_valid_bits{0};
     bool triangle_fan_supported{true};
     bool image_view_reinterpretation{true};
     u32 min_vertex_stride_alignment{1};
@@ -318,11 +374,16 @@ private:
     bool fragment_shader_interlock{};
     bool image_format_list{};
     bool pipeline_creation_cache_control{};
+    bool graphics_pipeline_library{};
     bool fragment_shader_barycentric{};
+    bool present_wait{};
+    bool descriptor_indexing{};
+    u32 max_texture_heap_size{};
     bool shader_stencil_export{};
     bool external_memory_host{};
     u64 min_imported_host_pointer_alignment{};
     bool tooling_info{};
+    bool memory_budget{};
     bool debug_utils_supported{};
     bool has_nsight_graphics{};
     bool has_renderdoc{};
@@ -62,21 +62,31 @@ void MasterSemaphoreTimeline::Wait(u64 tick) {
 }
 
 void MasterSemaphoreTimeline::SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait,
-                                         vk::Semaphore signal, u64 signal_value) {
+                                         vk::Semaphore signal, u64 signal_value,
+                                         vk::Semaphore transfer, u64 transfer_value) {
     cmdbuf.end();
 
     const u32 num_signal_semaphores = signal ? 2U : 1U;
     const std::array signal_values{signal_value, u64(0)};
     const std::array signal_semaphores{Handle(), signal};
 
-    const u32 num_wait_semaphores = wait ? 2U : 1U;
-    const std::array wait_values{signal_value - 1, u64(1)};
-    const std::array wait_semaphores{Handle(), wait};
-
-    static constexpr std::array<vk::PipelineStageFlags, 2> wait_stage_masks = {
+    u32 num_wait_semaphores = 1;
+    std::array wait_values{signal_value - 1, u64(1), u64(1)};
+    std::array wait_semaphores{Handle(), wait, transfer};
+    std::array<vk::PipelineStageFlags, 3> wait_stage_masks = {
         vk::PipelineStageFlagBits::eAllCommands,
         vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eAllCommands,
     };
+    if (wait) {
+        num_wait_semaphores++;
+    }
+    if (transfer) {
+        wait_values[num_wait_semaphores] = transfer_value;
+        wait_semaphores[num_wait_semaphores] = transfer;
+        wait_stage_masks[num_wait_semaphores] = vk::PipelineStageFlagBits::eAllCommands;
+        num_wait_semaphores++;
+    }
 
     const vk::TimelineSemaphoreSubmitInfoKHR timeline_si = {
         .waitSemaphoreValueCount = num_wait_semaphores,
@@ -129,7 +139,9 @@ void MasterSemaphoreFence::Wait(u64 tick) {
 }
 
 void MasterSemaphoreFence::SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait,
-                                      vk::Semaphore signal, u64 signal_value) {
+                                      vk::Semaphore signal, u64 signal_value,
+                                      vk::Semaphore transfer, u64 transfer_value) {
+    ASSERT_MSG(!transfer, "Transfer queue submissions require timeline semaphores");
     cmdbuf.end();
 
     const u32 num_signal_semaphores = signal ? 1U : 0U;
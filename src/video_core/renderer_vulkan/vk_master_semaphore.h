@@ -41,9 +41,10 @@ public:
     /// Waits for a tick to be hit on the GPU
     virtual void Wait(u64 tick) = 0;
 
-    /// Submits the provided command buffer for execution
+    /// Submits the provided command buffer for execution. When transfer is provided the
+    /// submission also waits for the timeline semaphore to reach transfer_value.
     virtual void SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait, vk::Semaphore signal,
-                            u64 signal_value) = 0;
+                            u64 signal_value, vk::Semaphore transfer, u64 transfer_value) = 0;
 
 protected:
     std::atomic<u64> gpu_tick{0};     ///< Current known GPU tick.
@@ -64,7 +65,7 @@ public:
     void Wait(u64 tick) override;
 
     void SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait, vk::Semaphore signal,
-                    u64 signal_value) override;
+                    u64 signal_value, vk::Semaphore transfer, u64 transfer_value) override;
 
 private:
     const Instance& instance;
@@ -81,7 +82,7 @@ public:
     void Wait(u64 tick) override;
 
     void SubmitWork(vk::CommandBuffer cmdbuf, vk::Semaphore wait, vk::Semaphore signal,
-                    u64 signal_value) override;
+                    u64 signal_value, vk::Semaphore transfer, u64 transfer_value) override;
 
 private:
     void WaitThread(std::stop_token token);
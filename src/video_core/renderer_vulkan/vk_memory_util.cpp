@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include "video_core/renderer_vulkan/vk_memory_util.h"
 
+#include <vk_mem_alloc.h>
+
 namespace Vulkan {
 
 std::optional<u32> FindMemoryType(const vk::PhysicalDeviceMemoryProperties& properties,
@@ -20,4 +23,59 @@ std::optional<u32> FindMemoryType(const vk::PhysicalDeviceMemoryProperties& prop
     }
     return std::nullopt;
 }
+
+u64 GetDeviceLocalBudget(VmaAllocator allocator) {
+    const VkPhysicalDeviceMemoryProperties* properties{};
+    vmaGetMemoryProperties(allocator, &properties);
+
+    // Without VK_EXT_memory_budget VMA estimates the budget from the heap sizes
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    u64 budget = 0;
+    for (u32 i = 0; i < properties->memoryHeapCount; ++i) {
+        if (properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            budget += budgets[i].budget;
+        }
+    }
+    return budget;
+}
+
+ImagePools::ImagePools(VmaAllocator allocator_) : allocator{allocator_} {}
+
+ImagePools::~ImagePools() {
+    for (const auto& class_pools : pools) {
+        for (VmaPool pool : class_pools) {
+            if (pool) {
+                vmaDestroyPool(allocator, pool);
+            }
+        }
+    }
+}
+
+VmaPool ImagePools::Get(const VkImageCreateInfo& image_info) {
+    const VmaAllocationCreateInfo alloc_info = {
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+    };
+    u32 memory_type{};
+    if (vmaFindMemoryTypeIndexForImageInfo(allocator, &image_info, &alloc_info, &memory_type) !=
+        VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+
+    constexpr VkImageUsageFlags attachment_usage =
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    const UsageClass usage_class = (image_info.usage & attachment_usage) ? Attachment : Sampled;
+    VmaPool& pool = pools[usage_class][memory_type];
+    if (!pool) {
+        const VmaPoolCreateInfo pool_info = {
+            .memoryTypeIndex = memory_type,
+        };
+        if (vmaCreatePool(allocator, &pool_info, &pool) != VK_SUCCESS) {
+            pool = VK_NULL_HANDLE;
+        }
+    }
+    return pool;
+}
+
 } // namespace Vulkan
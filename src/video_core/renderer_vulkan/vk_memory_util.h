@@ -4,12 +4,16 @@
 
 #pragma once
 
+#include <array>
 #include <bitset>
 #include <optional>
 
 #include "common/common_types.h"
 #include "video_core/renderer_vulkan/vk_common.h"
 
+VK_DEFINE_HANDLE(VmaAllocator)
+VK_DEFINE_HANDLE(VmaPool)
+
 namespace Vulkan {
 
 /// Find a memory type with the passed requirements
@@ -18,4 +22,34 @@ std::optional<u32> FindMemoryType(
     std::bitset<32> memory_type_mask = 0xFFFFFFFF,
     vk::MemoryPropertyFlags excluded = vk::MemoryPropertyFlagBits::eProtected);
 
+/// Returns the sum of the memory budgets of all device local heaps
+u64 GetDeviceLocalBudget(VmaAllocator allocator);
+
+/**
+ * Custom VMA pools that keep the images of each usage class in their own memory blocks. Attachments
+ * are reallocated whenever render targets churn, sharing blocks with long lived sampled images
+ * leaves those blocks fragmented until neither kind fits.
+ */
+class ImagePools {
+public:
+    explicit ImagePools(VmaAllocator allocator);
+    ~ImagePools();
+
+    ImagePools(const ImagePools&) = delete;
+    ImagePools& operator=(const ImagePools&) = delete;
+
+    /// Returns the pool to allocate the image from, VK_NULL_HANDLE to use the default pools
+    VmaPool Get(const VkImageCreateInfo& image_info);
+
+private:
+    enum UsageClass : u32 {
+        Attachment,
+        Sampled,
+        NumUsageClasses,
+    };
+
+    VmaAllocator allocator;
+    std::array<std::array<VmaPool, VK_MAX_MEMORY_TYPES>, NumUsageClasses> pools{};
+};
+
 } // namespace Vulkan
@@ -2,10 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bit>
+#include <limits>
 #include <boost/container/static_vector.hpp>
 
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -19,6 +22,7 @@
 #include "video_core/shader/generator/glsl_fs_shader_gen.h"
 #include "video_core/shader/generator/glsl_shader_gen.h"
 #include "video_core/shader/generator/spv_fs_shader_gen.h"
+#include "video_core/shader/generator/spv_vs_shader_gen.h"
 
 using namespace Pica::Shader::Generator;
 using Pica::Shader::FSConfig;
@@ -27,6 +31,66 @@ MICROPROFILE_DEFINE(Vulkan_Bind, "Vulkan", "Pipeline Bind", MP_RGB(192, 32, 32))
 
 namespace Vulkan {
 
+namespace {
+
+constexpr u32 MANIFEST_MAGIC = 0x4D495056; // VPIM
+constexpr u32 MANIFEST_VERSION = 2;
+
+constexpr u32 SPIRV_CACHE_MAGIC = 0x43505356; // VSPC
+constexpr u32 SPIRV_CACHE_VERSION = 1;
+
+/// Bounds the module size read from the SPIR-V cache, generated shaders are far smaller
+constexpr u32 MAX_SPIRV_CACHE_MODULE_WORDS = 1u << 20;
+
+/// Shader indices of pipeline records that do not refer to a recorded shader
+constexpr u32 NO_SHADER = std::numeric_limits<u32>::max();
+constexpr u32 TRIVIAL_SHADER = NO_SHADER - 1;
+
+/// Replaces the fragment shader hash of pipelines drawing with the uber fragment shader
+constexpr u64 UBER_FRAGMENT_SHADER_HASH = std::numeric_limits<u64>::max();
+
+/// The record sizes change along with the layout of the raw structures they contain
+struct ManifestHeader {
+    u32 magic;
+    u32 version;
+    u32 pipeline_record_size;
+    u32 fs_config_size;
+    u32 gs_config_size;
+    u32 num_shaders;
+    u32 num_pipelines;
+};
+
+/// Followed by the modules, each a u64 key, a u32 word count and the words
+struct SpirvCacheHeader {
+    u32 magic;
+    u32 version;
+    u32 num_modules;
+};
+
+/// Keys a GLSL shader in the SPIR-V cache. The source changes along with the generators.
+u64 SpirvCacheKey(std::string_view code, vk::ShaderStageFlagBits stage) {
+    return Common::HashCombine(Common::ComputeHash64(code.data(), code.size()),
+                               static_cast<u64>(stage));
+}
+
+template <typename T>
+std::span<const u8> ObjectBytes(const T& object) {
+    return {reinterpret_cast<const u8*>(&object), sizeof(T)};
+}
+
+std::span<const u8> StringBytes(std::string_view str) {
+    return {reinterpret_cast<const u8*>(str.data()), str.size()};
+}
+
+template <typename T>
+T FromBytes(std::span<const u8> data) {
+    std::array<u8, sizeof(T)> raw;
+    std::memcpy(raw.data(), data.data(), raw.size());
+    return std::bit_cast<T>(raw);
+}
+
+} // Anonymous namespace
+
 u32 AttribBytes(Pica::PipelineRegs::VertexAttributeFormat format, u32 size) {
     switch (format) {
     case Pica::PipelineRegs::VertexAttributeFormat::FLOAT:
@@ -53,7 +117,8 @@ AttribLoadFlags MakeAttribLoadFlag(Pica::PipelineRegs::VertexAttributeFormat for
 }
 
 constexpr std::array<vk::DescriptorSetLayoutBinding, 6> BUFFER_BINDINGS = {{
-    {0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex},
+    {0, vk::DescriptorType::eUniformBufferDynamic, 1,
+     vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eGeometry},
     {1, vk::DescriptorType::eUniformBufferDynamic, 1,
      vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eGeometry},
     {2, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eFragment},
@@ -62,12 +127,31 @@ constexpr std::array<vk::DescriptorSetLayoutBinding, 6> BUFFER_BINDINGS = {{
     {5, vk::DescriptorType::eUniformTexelBuffer, 1, vk::ShaderStageFlagBits::eFragment},
 }};
 
-constexpr std::array<vk::DescriptorSetLayoutBinding, 3> TEXTURE_BINDINGS = {{
+constexpr std::array<vk::DescriptorSetLayoutBinding, NUM_TEXTURE_UNITS> TEXTURE_BINDINGS = {{
     {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
     {1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
     {2, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
 }};
 
+/// With the texture heap 2D textures are sampled from the heap, only cube maps use a binding
+constexpr std::array<vk::DescriptorSetLayoutBinding, 1> TEXTURE_CUBE_BINDINGS = {{
+    {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
+}};
+
+/// Upper bound of the texture heap size, which is well above the textures of a frame
+constexpr u32 MAX_TEXTURE_HEAP_SIZE = 4096;
+
+namespace {
+
+std::span<const vk::DescriptorSetLayoutBinding> TextureBindings(const Instance& instance) {
+    if (instance.IsDescriptorIndexingSupported()) {
+        return TEXTURE_CUBE_BINDINGS;
+    }
+    return TEXTURE_BINDINGS;
+}
+
+} // Anonymous namespace
+
 // TODO: Use descriptor array for shadow cube
 constexpr std::array<vk::DescriptorSetLayoutBinding, 7> SHADOW_BINDINGS = {{
     {0, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eFragment},
@@ -80,16 +164,26 @@ constexpr std::array<vk::DescriptorSetLayoutBinding, 7> SHADOW_BINDINGS = {{
 }};
 
 PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
-                             RenderpassCache& renderpass_cache_, DescriptorPool& pool_)
+                             RenderpassCache& renderpass_cache_, DescriptorPool& pool_,
+                             u64 program_id_)
     : instance{instance_}, scheduler{scheduler_}, renderpass_cache{renderpass_cache_}, pool{pool_},
-      num_worker_threads{std::max(std::thread::hardware_concurrency(), 2U)},
-      workers{num_worker_threads, "Pipeline workers"},
+      program_id{program_id_},
+      workers{Common::TaskPriority::Normal},
       descriptor_set_providers{DescriptorSetProvider{instance, pool, BUFFER_BINDINGS},
-                               DescriptorSetProvider{instance, pool, TEXTURE_BINDINGS},
+                               DescriptorSetProvider{instance, pool, TextureBindings(instance)},
                                DescriptorSetProvider{instance, pool, SHADOW_BINDINGS}},
       trivial_vertex_shader{
           instance, vk::ShaderStageFlagBits::eVertex,
-          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)} {
+          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)},
+      uber_fragment_shader{instance} {
+    if (instance.IsDescriptorIndexingSupported()) {
+        // The other texture sets count towards the per stage sampler limit of the heap
+        const u32 heap_size = std::min(
+            MAX_TEXTURE_HEAP_SIZE,
+            instance.MaxTextureHeapSize() - static_cast<u32>(TEXTURE_BINDINGS.size()));
+        texture_heap.emplace(instance, scheduler, heap_size);
+        LOG_INFO(Render_Vulkan, "Using a texture heap of {} textures", heap_size);
+    }
     profile = Pica::Shader::Profile{
         .has_separable_shaders = true,
         .has_clip_planes = instance.IsShaderClipDistanceSupported(),
@@ -100,28 +194,54 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
         .has_blend_minmax_factor = false,
         .has_minus_one_to_one_range = false,
         .has_logic_op = !instance.NeedsLogicOpEmulation(),
+        .has_texture_heap = texture_heap.has_value(),
         .is_vulkan = true,
+        .texture_heap_size = texture_heap ? texture_heap->Size() : 0,
     };
     BuildLayout();
+
+    // Skipped draws are drawn with the uber fragment shader while their shaders are compiling
+    if (Settings::values.async_shader_compilation.GetValue()) {
+        workers.QueueWork([this] {
+            const std::string code = GLSL::GenerateUberFragmentShader(profile);
+            uber_fragment_shader.module =
+                Compile(code, vk::ShaderStageFlagBits::eFragment, instance.GetDevice());
+            uber_fragment_shader.MarkDone();
+        });
+    }
 }
 
 void PipelineCache::BuildLayout() {
-    std::array<vk::DescriptorSetLayout, NUM_RASTERIZER_SETS> descriptor_set_layouts;
-    std::transform(descriptor_set_providers.begin(), descriptor_set_providers.end(),
-                   descriptor_set_layouts.begin(),
-                   [](const auto& provider) { return provider.Layout(); });
+    boost::container::static_vector<vk::DescriptorSetLayout, NUM_RASTERIZER_SETS + 1>
+        descriptor_set_layouts;
+    for (const auto& provider : descriptor_set_providers) {
+        descriptor_set_layouts.push_back(provider.Layout());
+    }
+
+    // The heap indices of the texture units are provided through push constants.
+    const vk::PushConstantRange texture_indices_range = {
+        .stageFlags = vk::ShaderStageFlagBits::eFragment,
+        .offset = 0,
+        .size = sizeof(texture_indices),
+    };
+    if (texture_heap) {
+        descriptor_set_layouts.push_back(texture_heap->Layout());
+    }
 
     const vk::PipelineLayoutCreateInfo layout_info = {
-        .setLayoutCount = NUM_RASTERIZER_SETS,
+        .setLayoutCount = static_cast<u32>(descriptor_set_layouts.size()),
         .pSetLayouts = descriptor_set_layouts.data(),
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges = nullptr,
+        .pushConstantRangeCount = texture_heap ? 1u : 0u,
+        .pPushConstantRanges = texture_heap ? &texture_indices_range : nullptr,
     };
     pipeline_layout = instance.GetDevice().createPipelineLayoutUnique(layout_info);
 }
 
 PipelineCache::~PipelineCache() {
     SaveDiskCache();
+    LOG_INFO(Render_Vulkan, "Merged {} fragment shader configurations into {} shaders",
+             fs_config_stats.NumCollapsed() + fs_config_stats.NumConfigs(),
+             fs_config_stats.NumConfigs());
 }
 
 void PipelineCache::LoadDiskCache() {
@@ -172,6 +292,9 @@ void PipelineCache::SaveDiskCache() {
         return;
     }
 
+    SaveManifest();
+    SaveSpirvCache();
+
     const auto cache_dir = GetPipelineCacheDir();
     const u32 vendor_id = instance.GetVendorID();
     const u32 device_id = instance.GetDeviceID();
@@ -191,27 +314,291 @@ void PipelineCache::SaveDiskCache() {
     }
 }
 
-bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
-    MICROPROFILE_SCOPE(Vulkan_Bind);
+void PipelineCache::LoadManifest(const std::atomic_bool& stop_loading,
+                                 const VideoCore::DiskResourceLoadCallback& callback) {
+    if (!Settings::values.use_disk_shader_cache || !EnsureDirectories()) {
+        return;
+    }
 
-    u64 shader_hash = 0;
-    for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
-        shader_hash = Common::HashCombine(shader_hash, shader_hashes[i]);
+    manifest_path = GetTitleCachePath("manifest");
+    if (manifest_path.empty()) {
+        return;
     }
+    spirv_cache_path = GetTitleCachePath("spirv");
+    LoadSpirvCache();
 
-    const u64 info_hash = info.Hash(instance);
-    const u64 pipeline_hash = Common::HashCombine(shader_hash, info_hash);
+    FileUtil::IOFile file{manifest_path, "rb"};
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No pipeline manifest found for title");
+        return;
+    }
 
-    auto [it, new_pipeline] = graphics_pipelines.try_emplace(pipeline_hash);
-    if (new_pipeline) {
-        it.value() =
-            std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info, *pipeline_cache,
-                                               *pipeline_layout, current_shaders, &workers);
+    const auto discard = [&] {
+        LOG_WARNING(Render_Vulkan, "Pipeline manifest is invalid, removing");
+        file.Close();
+        FileUtil::Delete(manifest_path);
+    };
+
+    ManifestHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != MANIFEST_MAGIC || header.version != MANIFEST_VERSION ||
+        header.pipeline_record_size != sizeof(PipelineRecord) ||
+        header.fs_config_size != sizeof(FSConfig) ||
+        header.gs_config_size != sizeof(PicaFixedGSConfig)) {
+        discard();
+        return;
     }
 
-    GraphicsPipeline* const pipeline{it->second.get()};
-    if (!pipeline->IsDone() && !pipeline->TryBuild(wait_built)) {
-        return false;
+    const auto load_shader = [&](ShaderKind kind, std::span<const u8> data) -> Shader* {
+        const auto emplace = [&](auto& shaders, auto key) {
+            auto [it, new_shader] = shaders.try_emplace(std::move(key), instance);
+            if (new_shader) {
+                CompileShader(it->second, kind, data);
+            }
+            return &it->second;
+        };
+        switch (kind) {
+        case ShaderKind::VertexSpirv:
+        case ShaderKind::VertexGlsl:
+            return emplace(programmable_vertex_cache, std::string{data.begin(), data.end()});
+        case ShaderKind::GeometryGlsl:
+            return emplace(programmable_geometry_cache, std::string{data.begin(), data.end()});
+        case ShaderKind::FixedGeometry:
+            return emplace(fixed_geometry_shaders, FromBytes<PicaFixedGSConfig>(data));
+        case ShaderKind::Fragment:
+            return emplace(fragment_shaders, FromBytes<FSConfig>(data));
+        }
+        return nullptr;
+    };
+
+    // Shaders are queued for compilation before the pipelines using them, so that the
+    // workers building pipelines only wait on shaders which are already being compiled.
+    std::vector<Shader*> shaders(header.num_shaders);
+    for (Shader*& shader : shaders) {
+        u32 kind{};
+        u32 size{};
+        if (file.ReadBytes(&kind, sizeof(kind)) != sizeof(kind) ||
+            file.ReadBytes(&size, sizeof(size)) != sizeof(size) ||
+            kind > static_cast<u32>(ShaderKind::Fragment)) {
+            discard();
+            return;
+        }
+        std::vector<u8> data(size);
+        if (file.ReadBytes(data.data(), size) != size) {
+            discard();
+            return;
+        }
+
+        const auto shader_kind = static_cast<ShaderKind>(kind);
+        const bool is_config =
+            shader_kind == ShaderKind::FixedGeometry || shader_kind == ShaderKind::Fragment;
+        const std::size_t config_size = shader_kind == ShaderKind::Fragment
+                                            ? sizeof(FSConfig)
+                                            : sizeof(PicaFixedGSConfig);
+        if (is_config && size != config_size) {
+            discard();
+            return;
+        }
+        shader = load_shader(shader_kind, data);
+    }
+
+    std::vector<PipelineRecord> records(header.num_pipelines);
+    const std::size_t records_size = records.size() * sizeof(PipelineRecord);
+    if (file.ReadBytes(records.data(), records_size) != records_size) {
+        discard();
+        return;
+    }
+
+    std::vector<GraphicsPipeline*> pipelines;
+    for (const PipelineRecord& record : records) {
+        bool valid = true;
+        for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
+            const u32 index = record.shader_indices[i];
+            if (index == NO_SHADER) {
+                current_shaders[i] = nullptr;
+            } else if (index == TRIVIAL_SHADER) {
+                current_shaders[i] = &trivial_vertex_shader;
+            } else if (index < shaders.size() && shaders[index]) {
+                current_shaders[i] = shaders[index];
+            } else {
+                valid = false;
+            }
+        }
+        if (!valid) {
+            continue;
+        }
+
+        shader_hashes = record.shader_hashes;
+        const auto [pipeline, new_pipeline] = GetPipeline(record.info);
+        if (new_pipeline) {
+            pipeline->QueueBuild();
+            pipelines.push_back(pipeline);
+        }
+    }
+
+    LOG_INFO(Render_Vulkan, "Building {} pipelines from the pipeline manifest", pipelines.size());
+    for (std::size_t i = 0; i < pipelines.size(); i++) {
+        if (stop_loading) {
+            return;
+        }
+        pipelines[i]->WaitDone();
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Build, i + 1, pipelines.size());
+        }
+    }
+}
+
+void PipelineCache::SaveManifest() {
+    if (manifest_path.empty() || pipeline_records.empty()) {
+        return;
+    }
+
+    FileUtil::IOFile file{manifest_path, "wb"};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Unable to open pipeline manifest for writing");
+        return;
+    }
+
+    const ManifestHeader header = {
+        .magic = MANIFEST_MAGIC,
+        .version = MANIFEST_VERSION,
+        .pipeline_record_size = sizeof(PipelineRecord),
+        .fs_config_size = sizeof(FSConfig),
+        .gs_config_size = sizeof(PicaFixedGSConfig),
+        .num_shaders = static_cast<u32>(shader_records.size()),
+        .num_pipelines = static_cast<u32>(pipeline_records.size()),
+    };
+
+    bool success = file.WriteObject(header) == 1;
+    for (const ShaderRecord& record : shader_records) {
+        success = success && file.WriteObject(static_cast<u32>(record.kind)) == 1 &&
+                  file.WriteObject(static_cast<u32>(record.data.size())) == 1 &&
+                  file.WriteBytes(record.data.data(), record.data.size()) == record.data.size();
+    }
+    success = success && file.WriteArray(pipeline_records.data(), pipeline_records.size()) ==
+                             pipeline_records.size();
+    if (!success) {
+        LOG_ERROR(Render_Vulkan, "Error during pipeline manifest write");
+    }
+}
+
+vk::ShaderModule PipelineCache::CompileGLSL(std::string_view code, vk::ShaderStageFlagBits stage) {
+    const vk::Device device = instance.GetDevice();
+    const u64 key = SpirvCacheKey(code, stage);
+    const std::vector<u32>* cached_spv = nullptr;
+    {
+        std::scoped_lock lock{spirv_cache_mutex};
+        if (const auto it = spirv_cache.find(key); it != spirv_cache.end()) {
+            cached_spv = &it->second;
+        }
+    }
+    // Modules are never removed once loaded, so the code stays valid outside the lock
+    if (cached_spv) {
+        return CompileSPV(*cached_spv, device);
+    }
+
+    std::vector<u32> spv = CompileToSPV(code, stage);
+    if (spv.empty()) {
+        return {};
+    }
+    const vk::ShaderModule module = CompileSPV(spv, device);
+    if (!spirv_cache_path.empty()) {
+        std::scoped_lock lock{spirv_cache_mutex};
+        spirv_cache.try_emplace(key, std::move(spv));
+        spirv_cache_dirty = true;
+    }
+    return module;
+}
+
+void PipelineCache::LoadSpirvCache() {
+    FileUtil::IOFile file{spirv_cache_path, "rb"};
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    const auto discard = [&] {
+        LOG_WARNING(Render_Vulkan, "SPIR-V cache is invalid, removing");
+        file.Close();
+        FileUtil::Delete(spirv_cache_path);
+    };
+
+    SpirvCacheHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != SPIRV_CACHE_MAGIC || header.version != SPIRV_CACHE_VERSION) {
+        discard();
+        return;
+    }
+
+    std::scoped_lock lock{spirv_cache_mutex};
+    for (u32 i = 0; i < header.num_modules; i++) {
+        u64 key{};
+        u32 num_words{};
+        if (file.ReadBytes(&key, sizeof(key)) != sizeof(key) ||
+            file.ReadBytes(&num_words, sizeof(num_words)) != sizeof(num_words) ||
+            num_words == 0 || num_words > MAX_SPIRV_CACHE_MODULE_WORDS) {
+            spirv_cache.clear();
+            discard();
+            return;
+        }
+        std::vector<u32> spv(num_words);
+        const std::size_t size = num_words * sizeof(u32);
+        if (file.ReadBytes(spv.data(), size) != size) {
+            spirv_cache.clear();
+            discard();
+            return;
+        }
+        spirv_cache.insert_or_assign(key, std::move(spv));
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} SPIR-V modules from the disk cache", spirv_cache.size());
+}
+
+void PipelineCache::SaveSpirvCache() {
+    std::scoped_lock lock{spirv_cache_mutex};
+    if (spirv_cache_path.empty() || !spirv_cache_dirty) {
+        return;
+    }
+
+    FileUtil::IOFile file{spirv_cache_path, "wb"};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Unable to open SPIR-V cache for writing");
+        return;
+    }
+
+    const SpirvCacheHeader header = {
+        .magic = SPIRV_CACHE_MAGIC,
+        .version = SPIRV_CACHE_VERSION,
+        .num_modules = static_cast<u32>(spirv_cache.size()),
+    };
+
+    bool success = file.WriteObject(header) == 1;
+    for (const auto& [key, spv] : spirv_cache) {
+        success = success && file.WriteObject(key) == 1 &&
+                  file.WriteObject(static_cast<u32>(spv.size())) == 1 &&
+                  file.WriteArray(spv.data(), spv.size()) == spv.size();
+    }
+    if (!success) {
+        LOG_ERROR(Render_Vulkan, "Error during SPIR-V cache write");
+        return;
+    }
+    spirv_cache_dirty = false;
+}
+
+bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
+    MICROPROFILE_SCOPE(Vulkan_Bind);
+
+    const auto lookup = GetPipeline(info);
+    GraphicsPipeline* pipeline{lookup.first};
+    const bool new_pipeline = lookup.second;
+    stats.lookups++;
+    stats.hits += new_pipeline ? 0 : 1;
+    if (!pipeline->IsDone()) {
+        stats.compile_stalls++;
+        if (!pipeline->TryBuild(wait_built)) {
+            pipeline = GetUberPipeline(info);
+            if (!pipeline) {
+                return false;
+            }
+        }
     }
 
     u32 new_descriptors_start = 0;
@@ -219,37 +606,53 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     std::span<u32> new_offsets_span{};
 
     // Ensure all the descriptor sets are set at least once at the beginning.
-    if (scheduler.IsStateDirty(StateFlags::DescriptorSets)) {
+    const bool rebind_sets = scheduler.IsStateDirty(StateFlags::DescriptorSets);
+    if (rebind_sets) {
         set_dirty.set();
     }
 
+    // Sets are cached by their contents, so switching back to a previous combination of
+    // bindings finds the set that is already bound and does not need to bind it again.
+    std::bitset<NUM_RASTERIZER_SETS> bind_mask{};
     if (set_dirty.any()) {
         for (u32 i = 0; i < NUM_RASTERIZER_SETS; i++) {
             if (!set_dirty.test(i)) {
                 continue;
             }
-            bound_descriptor_sets[i] = descriptor_set_providers[i].Acquire(update_data[i]);
+            const vk::DescriptorSet set = descriptor_set_providers[i].Acquire(update_data[i]);
+            if (set != bound_descriptor_sets[i] || rebind_sets) {
+                bound_descriptor_sets[i] = set;
+                bind_mask.set(i);
+            }
         }
+        set_dirty.reset();
+    }
+
+    // Dynamic offsets are provided when binding the buffer set, which does not change.
+    if (offsets_dirty) {
+        bind_mask.set(0);
+        offsets_dirty = false;
+    }
+
+    if (bind_mask.any()) {
         new_descriptors_span = bound_descriptor_sets;
 
-        // Only send new offsets if the buffer descriptor-set changed.
-        if (set_dirty.test(0)) {
+        // Only send new offsets if the buffer descriptor-set is bound.
+        if (bind_mask.test(0)) {
             new_offsets_span = offsets;
         }
 
         // Try to compact the number of updated descriptor-set slots to the ones that have actually
         // changed
-        if (!set_dirty.all()) {
-            const u64 dirty_mask = set_dirty.to_ulong();
-            new_descriptors_start = static_cast<u32>(std::countr_zero(dirty_mask));
-            const u32 new_descriptors_end = 64u - static_cast<u32>(std::countl_zero(dirty_mask));
+        if (!bind_mask.all()) {
+            const u64 bind_bits = bind_mask.to_ulong();
+            new_descriptors_start = static_cast<u32>(std::countr_zero(bind_bits));
+            const u32 new_descriptors_end = 64u - static_cast<u32>(std::countl_zero(bind_bits));
             const u32 new_descriptors_size = new_descriptors_end - new_descriptors_start;
 
             new_descriptors_span =
                 new_descriptors_span.subspan(new_descriptors_start, new_descriptors_size);
         }
-
-        set_dirty.reset();
     }
 
     boost::container::static_vector<vk::DescriptorSet, NUM_RASTERIZER_SETS> new_descriptors(
@@ -257,12 +660,21 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     boost::container::static_vector<u32, NUM_DYNAMIC_OFFSETS> new_offsets(new_offsets_span.begin(),
                                                                           new_offsets_span.end());
 
+    // The heap set never changes, push constants only need to be sent when an index changed.
+    const vk::DescriptorSet heap_set =
+        texture_heap && rebind_sets ? texture_heap->Set() : vk::DescriptorSet{};
+    std::optional<std::array<u32, NUM_TEXTURE_UNITS>> new_texture_indices;
+    if (texture_heap && (texture_indices_dirty || rebind_sets)) {
+        new_texture_indices = texture_indices;
+        texture_indices_dirty = false;
+    }
+
     const bool is_dirty = scheduler.IsStateDirty(StateFlags::Pipeline);
     const bool pipeline_dirty = (current_pipeline != pipeline) || is_dirty;
     scheduler.Record([this, is_dirty, pipeline_dirty, pipeline,
                       current_dynamic = current_info.dynamic, dynamic = info.dynamic,
                       new_descriptors_start, descriptor_sets = std::move(new_descriptors),
-                      offsets = std::move(new_offsets),
+                      offsets = std::move(new_offsets), heap_set, new_texture_indices,
                       current_rasterization = current_info.rasterization,
                       current_depth_stencil = current_info.depth_stencil,
                       rasterization = info.rasterization,
@@ -334,8 +746,11 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
                 cmdbuf.setDepthWriteEnableEXT(depth_stencil.depth_write_enable);
             }
 
-            if (rasterization.topology != current_rasterization.topology || is_dirty) {
-                cmdbuf.setPrimitiveTopologyEXT(PicaToVK::PrimitiveTopology(rasterization.topology));
+            if (rasterization.topology != current_rasterization.topology ||
+                rasterization.gs_input_vertices != current_rasterization.gs_input_vertices ||
+                is_dirty) {
+                cmdbuf.setPrimitiveTopologyEXT(PicaToVK::PrimitiveTopology(
+                    rasterization.topology, rasterization.gs_input_vertices));
             }
 
             if (depth_stencil.stencil_test_enable != current_depth_stencil.stencil_test_enable ||
@@ -368,6 +783,16 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
             cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout,
                                       new_descriptors_start, descriptor_sets, offsets);
         }
+
+        if (heap_set) {
+            cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout,
+                                      NUM_RASTERIZER_SETS, heap_set, {});
+        }
+
+        if (new_texture_indices) {
+            cmdbuf.pushConstants(*pipeline_layout, vk::ShaderStageFlagBits::eFragment, 0,
+                                 sizeof(*new_texture_indices), new_texture_indices->data());
+        }
     });
 
     current_info = info;
@@ -377,14 +802,83 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     return true;
 }
 
+std::pair<GraphicsPipeline*, bool> PipelineCache::GetPipeline(const PipelineInfo& info) {
+    u64 shader_hash = 0;
+    for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
+        shader_hash = Common::HashCombine(shader_hash, shader_hashes[i]);
+    }
+
+    const u64 info_hash = info.Hash(instance);
+    const u64 pipeline_hash = Common::HashCombine(shader_hash, info_hash);
+
+    auto [it, new_pipeline] = graphics_pipelines.try_emplace(pipeline_hash);
+    if (!new_pipeline) {
+        return {it->second.get(), false};
+    }
+
+    // Created on first use as the pipeline cache is only created when loading the disk cache
+    if (!library_cache && instance.IsGraphicsPipelineLibrarySupported()) {
+        library_cache = std::make_unique<PipelineLibraryCache>(instance, renderpass_cache,
+                                                               *pipeline_cache, *pipeline_layout);
+    }
+    it.value() = std::make_unique<GraphicsPipeline>(instance, renderpass_cache, info,
+                                                    *pipeline_cache, *pipeline_layout,
+                                                    current_shaders, &workers, library_cache.get());
+
+    // Pipelines are only recorded when all of their shaders can be rebuilt from the manifest
+    PipelineRecord record{
+        .info = info,
+        .shader_hashes = shader_hashes,
+    };
+    for (u32 i = 0; i < MAX_SHADER_STAGES; i++) {
+        const Shader* shader = current_shaders[i];
+        if (!shader) {
+            record.shader_indices[i] = NO_SHADER;
+        } else if (shader == &trivial_vertex_shader) {
+            record.shader_indices[i] = TRIVIAL_SHADER;
+        } else if (const auto index = shader_indices.find(shader); index != shader_indices.end()) {
+            record.shader_indices[i] = index->second;
+        } else {
+            return {it->second.get(), true};
+        }
+    }
+    pipeline_records.push_back(record);
+
+    return {it->second.get(), true};
+}
+
+GraphicsPipeline* PipelineCache::GetUberPipeline(const PipelineInfo& info) {
+    if (!use_uber_shader || !uber_fragment_shader.IsDone()) {
+        return nullptr;
+    }
+
+    Shader* const fragment_shader = current_shaders[ProgramType::FS];
+    const u64 fragment_hash = shader_hashes[ProgramType::FS];
+    current_shaders[ProgramType::FS] = &uber_fragment_shader;
+    shader_hashes[ProgramType::FS] = UBER_FRAGMENT_SHADER_HASH;
+    GraphicsPipeline* const pipeline{GetPipeline(info).first};
+    current_shaders[ProgramType::FS] = fragment_shader;
+    shader_hashes[ProgramType::FS] = fragment_hash;
+
+    // The uber pipeline is shared by all fragment configurations, so it is usually built already.
+    // Never wait for it, as that would stall the draw the uber shader is meant to keep going.
+    if (!pipeline->IsDone() && !pipeline->TryBuild(false)) {
+        return nullptr;
+    }
+    return pipeline;
+}
+
 bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
                                                 Pica::ShaderSetup& setup,
                                                 const VertexLayout& layout) {
     // Enable the geometry-shader only if we are actually doing per-fragment lighting
     // and care about proper quaternions. Otherwise just use standard vertex+fragment shaders.
     // We also don't need the geometry shader if we have the barycentric extension.
-    const bool use_geometry_shader = instance.UseGeometryShaders() && !regs.lighting.disable &&
-                                     !instance.IsFragmentShaderBarycentricSupported();
+    // A PICA geometry shader always needs the vertex outputs as they are.
+    const bool use_geometry_shader =
+        instance.UseGeometryShaders() &&
+        ((!regs.lighting.disable && !instance.IsFragmentShaderBarycentricSupported()) ||
+         regs.pipeline.use_gs == Pica::PipelineRegs::UseGS::Yes);
 
     PicaVSConfig config{regs, setup, instance.IsShaderClipDistanceSupported(), use_geometry_shader};
 
@@ -404,7 +898,20 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
 
     auto [it, new_config] = programmable_vertex_map.try_emplace(config);
     if (new_config) {
-        auto program = GLSL::GenerateVertexShader(setup, config, true);
+        // Emitting SPIR-V directly skips parsing GLSL with glslang, the costliest part of
+        // compiling a new shader. GLSL remains the fallback for programs it cannot handle.
+        std::vector<u32> code;
+        if (Settings::values.spirv_shader_gen.GetValue()) {
+            code = SPIRV::GenerateVertexShader(setup, config);
+        }
+
+        std::string program;
+        if (!code.empty()) {
+            // The cache is keyed by the bytecode, to share modules between equivalent configs
+            program.assign(reinterpret_cast<const char*>(code.data()), code.size() * sizeof(u32));
+        } else {
+            program = GLSL::GenerateVertexShader(setup, config, true);
+        }
         if (program.empty()) {
             LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable vertex shader");
             programmable_vertex_map[config] = nullptr;
@@ -415,12 +922,8 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
         auto& shader = iter->second;
 
         if (new_program) {
-            shader.program = std::move(program);
-            const vk::Device device = instance.GetDevice();
-            workers.QueueWork([device, &shader] {
-                shader.module = Compile(shader.program, vk::ShaderStageFlagBits::eVertex, device);
-                shader.MarkDone();
-            });
+            const auto kind = code.empty() ? ShaderKind::VertexGlsl : ShaderKind::VertexSpirv;
+            CompileShader(shader, kind, StringBytes(iter->first));
         }
 
         it->second = &shader;
@@ -454,11 +957,7 @@ bool PipelineCache::UseFixedGeometryShader(const Pica::RegsInternal& regs) {
     auto& shader = it->second;
 
     if (new_shader) {
-        workers.QueueWork([gs_config, device = instance.GetDevice(), &shader]() {
-            const auto code = GLSL::GenerateFixedGeometryShader(gs_config, true);
-            shader.module = Compile(code, vk::ShaderStageFlagBits::eGeometry, device);
-            shader.MarkDone();
-        });
+        CompileShader(shader, ShaderKind::FixedGeometry, ObjectBytes(gs_config));
     }
 
     current_shaders[ProgramType::GS] = &shader;
@@ -467,37 +966,126 @@ bool PipelineCache::UseFixedGeometryShader(const Pica::RegsInternal& regs) {
     return true;
 }
 
+bool PipelineCache::UseProgrammableGeometryShader(const Pica::RegsInternal& regs,
+                                                  Pica::ShaderSetup& setup) {
+    if (!instance.UseGeometryShaders()) {
+        return false;
+    }
+
+    const PicaGSConfig gs_config{regs, setup, instance.IsShaderClipDistanceSupported()};
+    auto [it, new_config] = programmable_geometry_map.try_emplace(gs_config);
+    if (new_config) {
+        auto program = GLSL::GenerateGeometryShader(setup, gs_config, true);
+        if (program.empty()) {
+            LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable geometry shader");
+            programmable_geometry_map[gs_config] = nullptr;
+            return false;
+        }
+
+        auto [iter, new_program] = programmable_geometry_cache.try_emplace(program, instance);
+        auto& shader = iter->second;
+
+        if (new_program) {
+            CompileShader(shader, ShaderKind::GeometryGlsl, StringBytes(iter->first));
+        }
+
+        it->second = &shader;
+    }
+
+    Shader* const shader{it->second};
+    if (!shader) {
+        return false;
+    }
+
+    current_shaders[ProgramType::GS] = shader;
+    shader_hashes[ProgramType::GS] = gs_config.Hash();
+
+    return true;
+}
+
 void PipelineCache::UseTrivialGeometryShader() {
     current_shaders[ProgramType::GS] = nullptr;
     shader_hashes[ProgramType::GS] = 0;
 }
 
-void PipelineCache::UseFragmentShader(const Pica::RegsInternal& regs,
-                                      const Pica::Shader::UserConfig& user) {
-    const FSConfig fs_config{regs, user, profile};
+const FSConfig& PipelineCache::UseFragmentShader(const Pica::RegsInternal& regs,
+                                                 const Pica::Shader::UserConfig& user) {
+    u64 raw_hash{};
+    const FSConfig fs_config{regs, user, profile, &raw_hash};
+    fs_config_stats.Record(fs_config, raw_hash);
     const auto [it, new_shader] = fragment_shaders.try_emplace(fs_config, instance);
     auto& shader = it->second;
 
     if (new_shader) {
-        workers.QueueWork([fs_config, this, &shader]() {
+        CompileShader(shader, ShaderKind::Fragment, ObjectBytes(fs_config));
+    }
+
+    current_shaders[ProgramType::FS] = &shader;
+    shader_hashes[ProgramType::FS] = fs_config.Hash();
+    use_uber_shader = GLSL::CanUseUberFragmentShader(fs_config, profile);
+    return it->first;
+}
+
+void PipelineCache::CompileShader(Shader& shader, ShaderKind kind, std::span<const u8> data) {
+    shader_indices.emplace(&shader, static_cast<u32>(shader_records.size()));
+    shader_records.push_back(ShaderRecord{kind, {data.begin(), data.end()}});
+
+    const vk::Device device = instance.GetDevice();
+    switch (kind) {
+    case ShaderKind::VertexSpirv: {
+        std::vector<u32> code(data.size() / sizeof(u32));
+        std::memcpy(code.data(), data.data(), code.size() * sizeof(u32));
+        workers.QueueWork([device, &shader, code = std::move(code)] {
+            shader.module = CompileSPV(code, device);
+            shader.MarkDone();
+        });
+        break;
+    }
+    case ShaderKind::VertexGlsl:
+    case ShaderKind::GeometryGlsl: {
+        const auto stage = kind == ShaderKind::VertexGlsl ? vk::ShaderStageFlagBits::eVertex
+                                                          : vk::ShaderStageFlagBits::eGeometry;
+        shader.program.assign(reinterpret_cast<const char*>(data.data()), data.size());
+        workers.QueueWork([this, &shader, stage] {
+            shader.module = CompileGLSL(shader.program, stage);
+            shader.MarkDone();
+        });
+        break;
+    }
+    case ShaderKind::FixedGeometry:
+        workers.QueueWork([gs_config = FromBytes<PicaFixedGSConfig>(data), this, &shader] {
+            const auto code = GLSL::GenerateFixedGeometryShader(gs_config, true);
+            shader.module = CompileGLSL(code, vk::ShaderStageFlagBits::eGeometry);
+            shader.MarkDone();
+        });
+        break;
+    case ShaderKind::Fragment:
+        workers.QueueWork([fs_config = FromBytes<FSConfig>(data), this, &shader] {
             const bool use_spirv = Settings::values.spirv_shader_gen.GetValue();
             if (use_spirv && !fs_config.UsesShadowPipeline()) {
                 const std::vector code = SPIRV::GenerateFragmentShader(fs_config, profile);
                 shader.module = CompileSPV(code, instance.GetDevice());
             } else {
                 const std::string code = GLSL::GenerateFragmentShader(fs_config, profile);
-                shader.module =
-                    Compile(code, vk::ShaderStageFlagBits::eFragment, instance.GetDevice());
+                shader.module = CompileGLSL(code, vk::ShaderStageFlagBits::eFragment);
             }
             shader.MarkDone();
         });
+        break;
     }
-
-    current_shaders[ProgramType::FS] = &shader;
-    shader_hashes[ProgramType::FS] = fs_config.Hash();
 }
 
 void PipelineCache::BindTexture(u32 binding, vk::ImageView image_view, vk::Sampler sampler) {
+    if (texture_heap) {
+        // Acquiring every draw keeps the texture resident while it is in use
+        const u32 index = texture_heap->Acquire(image_view, sampler);
+        if (texture_indices[binding] != index) {
+            texture_indices[binding] = index;
+            texture_indices_dirty = true;
+        }
+        return;
+    }
+
     auto& info = update_data[1][binding].image_info;
     if (info.imageView == image_view && info.sampler == sampler) {
         return;
@@ -510,6 +1098,19 @@ void PipelineCache::BindTexture(u32 binding, vk::ImageView image_view, vk::Sampl
     };
 }
 
+void PipelineCache::BindTextureCube(vk::ImageView image_view, vk::Sampler sampler) {
+    auto& info = update_data[1][0].image_info;
+    if (info.imageView == image_view && info.sampler == sampler) {
+        return;
+    }
+    set_dirty[1] = true;
+    info = vk::DescriptorImageInfo{
+        .sampler = sampler,
+        .imageView = image_view,
+        .imageLayout = vk::ImageLayout::eGeneral,
+    };
+}
+
 void PipelineCache::BindStorageImage(u32 binding, vk::ImageView image_view) {
     auto& info = update_data[2][binding].image_info;
     if (info.imageView == image_view) {
@@ -546,7 +1147,7 @@ void PipelineCache::BindTexelBuffer(u32 binding, vk::BufferView buffer_view) {
 void PipelineCache::SetBufferOffset(u32 binding, std::size_t offset) {
     if (offsets[binding] != static_cast<u32>(offset)) {
         offsets[binding] = static_cast<u32>(offset);
-        set_dirty[0] = true;
+        offsets_dirty = true;
     }
 }
 
@@ -606,6 +1207,13 @@ bool PipelineCache::EnsureDirectories() const {
            create_dir(GetPipelineCacheDir());
 }
 
+std::string PipelineCache::GetTitleCachePath(std::string_view extension) const {
+    if (program_id == 0) {
+        return {};
+    }
+    return fmt::format("{}{:016X}.{}", GetPipelineCacheDir(), program_id, extension);
+}
+
 std::string PipelineCache::GetPipelineCacheDir() const {
     return FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir) + "vulkan" + DIR_SEP;
 }
@@ -5,10 +5,14 @@
 #pragma once
 
 #include <bitset>
+#include <mutex>
+#include <optional>
 #include <tsl/robin_map.h>
 
+#include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_texture_heap.h"
 #include "video_core/shader/generator/pica_fs_config.h"
 #include "video_core/shader/generator/profile.h"
 #include "video_core/shader/generator/shader_gen.h"
@@ -27,6 +31,7 @@ class DescriptorPool;
 
 constexpr u32 NUM_RASTERIZER_SETS = 3;
 constexpr u32 NUM_DYNAMIC_OFFSETS = 3;
+constexpr u32 NUM_TEXTURE_UNITS = 3;
 
 /**
  * Stores a collection of rasterizer pipelines used during rendering.
@@ -34,19 +39,29 @@ constexpr u32 NUM_DYNAMIC_OFFSETS = 3;
 class PipelineCache {
 public:
     explicit PipelineCache(const Instance& instance, Scheduler& scheduler,
-                           RenderpassCache& renderpass_cache, DescriptorPool& pool);
+                           RenderpassCache& renderpass_cache, DescriptorPool& pool,
+                           u64 program_id);
     ~PipelineCache();
 
     [[nodiscard]] DescriptorSetProvider& TextureProvider() noexcept {
         return descriptor_set_providers[1];
     }
 
+    /// Returns the texture heap, or nullptr when descriptor indexing is not supported
+    [[nodiscard]] TextureHeap* GetTextureHeap() noexcept {
+        return texture_heap ? &*texture_heap : nullptr;
+    }
+
     /// Loads the pipeline cache stored to disk
     void LoadDiskCache();
 
-    /// Stores the generated pipeline cache to disk
+    /// Stores the generated pipeline cache and pipeline manifest to disk
     void SaveDiskCache();
 
+    /// Builds the pipelines recorded in the manifest of the running title
+    void LoadManifest(const std::atomic_bool& stop_loading,
+                      const VideoCore::DiskResourceLoadCallback& callback);
+
     /// Binds a pipeline using the provided information
     bool BindPipeline(const PipelineInfo& info, bool wait_built = false);
 
@@ -60,15 +75,22 @@ public:
     /// Binds a PICA decompiled geometry shader
     bool UseFixedGeometryShader(const Pica::RegsInternal& regs);
 
+    /// Binds a geometry shader decompiled from the PICA geometry shader
+    bool UseProgrammableGeometryShader(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup);
+
     /// Binds a passthrough geometry shader
     void UseTrivialGeometryShader();
 
-    /// Binds a fragment shader generated from PICA state
-    void UseFragmentShader(const Pica::RegsInternal& regs, const Pica::Shader::UserConfig& user);
+    /// Binds a fragment shader generated from PICA state and returns its configuration
+    const Pica::Shader::FSConfig& UseFragmentShader(const Pica::RegsInternal& regs,
+                                                    const Pica::Shader::UserConfig& user);
 
     /// Binds a texture to the specified binding
     void BindTexture(u32 binding, vk::ImageView image_view, vk::Sampler sampler);
 
+    /// Binds a cube texture to texture unit 0
+    void BindTextureCube(vk::ImageView image_view, vk::Sampler sampler);
+
     /// Binds a storage image to the specified binding
     void BindStorageImage(u32 binding, vk::ImageView image_view);
 
@@ -81,10 +103,60 @@ public:
     /// Sets the dynamic offset for the uniform buffer at binding
     void SetBufferOffset(u32 binding, std::size_t offset);
 
+    [[nodiscard]] const VideoCore::PipelineCacheStats& GetStats() const noexcept {
+        return stats;
+    }
+
 private:
+    /// Kinds of shader sources recorded in the pipeline manifest
+    enum class ShaderKind : u32 {
+        VertexSpirv,
+        VertexGlsl,
+        FixedGeometry,
+        GeometryGlsl,
+        Fragment,
+    };
+
+    struct ShaderRecord {
+        ShaderKind kind;
+        std::vector<u8> data;
+    };
+
+    struct PipelineRecord {
+        PipelineInfo info;
+        std::array<u64, MAX_SHADER_STAGES> shader_hashes;
+        std::array<u32, MAX_SHADER_STAGES> shader_indices;
+    };
+
     /// Builds the rasterizer pipeline layout
     void BuildLayout();
 
+    /// Returns the pipeline of the current shaders and info and whether it was created
+    std::pair<GraphicsPipeline*, bool> GetPipeline(const PipelineInfo& info);
+
+    /// Returns the pipeline of the current shaders with the uber fragment shader if it is ready
+    GraphicsPipeline* GetUberPipeline(const PipelineInfo& info);
+
+    /// Queues compilation of the shader from its source and records it in the manifest
+    void CompileShader(Shader& shader, ShaderKind kind, std::span<const u8> data);
+
+    /// Stores the recorded shaders and pipelines of the running title
+    void SaveManifest();
+
+    /// Creates the module of a GLSL shader. glslang only runs for shaders missing from the SPIR-V
+    /// cache. Called from the workers.
+    vk::ShaderModule CompileGLSL(std::string_view code, vk::ShaderStageFlagBits stage);
+
+    /// Loads the SPIR-V that GLSL shaders of the running title were converted to in earlier runs
+    void LoadSpirvCache();
+
+    /// Stores the SPIR-V cache of the running title if shaders were converted since loading it
+    void SaveSpirvCache();
+
+    /// Returns the path of a cache file of the running title, or an empty string if it has no
+    /// title id
+    std::string GetTitleCachePath(std::string_view extension) const;
+
     /// Returns true when the disk data can be used by the current driver
     bool IsCacheValid(std::span<const u8> cache_data) const;
 
@@ -99,30 +171,52 @@ private:
     Scheduler& scheduler;
     RenderpassCache& renderpass_cache;
     DescriptorPool& pool;
+    u64 program_id; ///< Program id of the running title, 0 when it has none
 
     Pica::Shader::Profile profile{};
     vk::UniquePipelineCache pipeline_cache;
     vk::UniquePipelineLayout pipeline_layout;
-    std::size_t num_worker_threads;
-    Common::ThreadWorker workers;
+    std::unique_ptr<PipelineLibraryCache> library_cache;
+    Common::TaskGroup workers;
     PipelineInfo current_info{};
     GraphicsPipeline* current_pipeline{};
     tsl::robin_map<u64, std::unique_ptr<GraphicsPipeline>, Common::IdentityHash<u64>>
         graphics_pipelines;
+    VideoCore::PipelineCacheStats stats{};
 
     std::array<DescriptorSetProvider, NUM_RASTERIZER_SETS> descriptor_set_providers;
     std::array<DescriptorSetData, NUM_RASTERIZER_SETS> update_data{};
     std::array<vk::DescriptorSet, NUM_RASTERIZER_SETS> bound_descriptor_sets{};
     std::array<u32, NUM_DYNAMIC_OFFSETS> offsets{};
     std::bitset<NUM_RASTERIZER_SETS> set_dirty{};
+    bool offsets_dirty{};
+
+    std::optional<TextureHeap> texture_heap;
+    std::array<u32, NUM_TEXTURE_UNITS> texture_indices{};
+    bool texture_indices_dirty{};
 
     std::array<u64, MAX_SHADER_STAGES> shader_hashes;
     std::array<Shader*, MAX_SHADER_STAGES> current_shaders;
     std::unordered_map<Pica::Shader::Generator::PicaVSConfig, Shader*> programmable_vertex_map;
     std::unordered_map<std::string, Shader> programmable_vertex_cache;
     std::unordered_map<Pica::Shader::Generator::PicaFixedGSConfig, Shader> fixed_geometry_shaders;
+    std::unordered_map<Pica::Shader::Generator::PicaGSConfig, Shader*> programmable_geometry_map;
+    std::unordered_map<std::string, Shader> programmable_geometry_cache;
     std::unordered_map<Pica::Shader::FSConfig, Shader> fragment_shaders;
+    Pica::Shader::FSConfigStats fs_config_stats;
     Shader trivial_vertex_shader;
+    Shader uber_fragment_shader;
+    bool use_uber_shader{};
+
+    std::string spirv_cache_path;
+    std::mutex spirv_cache_mutex;
+    std::unordered_map<u64, std::vector<u32>> spirv_cache;
+    bool spirv_cache_dirty{};
+
+    std::string manifest_path;
+    std::vector<ShaderRecord> shader_records;
+    std::unordered_map<const Shader*, u32> shader_indices;
+    std::vector<PipelineRecord> pipeline_records;
 };
 
 } // namespace Vulkan
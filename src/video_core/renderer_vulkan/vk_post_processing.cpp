@@ -0,0 +1,447 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "common/vector_math.h"
+#include "video_core/renderer_vulkan/renderer_vulkan.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_post_processing.h"
+#include "video_core/renderer_vulkan/vk_renderpass_cache.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+
+#include "video_core/host_shaders/full_screen_triangle_vert.h"
+
+#include <vk_mem_alloc.h>
+
+namespace Vulkan {
+
+namespace {
+
+constexpr vk::Format TARGET_FORMAT = vk::Format::eR8G8B8A8Unorm;
+
+// Declarations of the Dolphin compatible shader interface, see VideoCore::MakePostProcessingShader.
+// The first members of the push constants are the ones of the full screen triangle shader.
+constexpr char dolphin_shader_declarations[] = R"(
+layout (location = 0) out float4 color;
+layout (location = 0) in float2 frag_tex_coord;
+
+layout (push_constant) uniform PassInfo {
+    float2 tex_scale;
+    float2 tex_offset;
+    float4 i_resolution;
+    float4 o_resolution;
+    int layer;
+};
+
+layout (set = 0, binding = 0) uniform sampler2D color_texture;
+
+// Every eye is processed on its own
+#define color_texture_r color_texture
+)";
+
+struct PassInfo {
+    Common::Vec2f tex_scale;
+    Common::Vec2f tex_offset;
+    Common::Vec4f i_resolution;
+    Common::Vec4f o_resolution;
+    s32 layer;
+};
+
+constexpr vk::PushConstantRange PUSH_CONSTANT_RANGE = {
+    .stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+    .offset = 0,
+    .size = sizeof(PassInfo),
+};
+
+constexpr std::array<vk::DescriptorSetLayoutBinding, 1> BINDINGS = {{
+    {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
+}};
+
+[[nodiscard]] Common::Vec4f MakeResolution(u32 width, u32 height) {
+    return Common::Vec4f{static_cast<f32>(width), static_cast<f32>(height), 1.0f / width,
+                         1.0f / height};
+}
+
+} // Anonymous namespace
+
+PostProcessingChain::PostProcessingChain(const Instance& instance_, Scheduler& scheduler_,
+                                         RenderpassCache& renderpass_cache_, DescriptorPool& pool,
+                                         DescriptorSetProvider& present_provider_)
+    : instance{instance_}, scheduler{scheduler_}, renderpass_cache{renderpass_cache_},
+      present_provider{present_provider_}, set_provider{instance, pool, BINDINGS},
+      device{instance.GetDevice()}, renderpass{CreateRenderpass()},
+      pipeline_layout{device.createPipelineLayout(vk::PipelineLayoutCreateInfo{
+          .setLayoutCount = 1,
+          .pSetLayouts = &set_provider.Layout(),
+          .pushConstantRangeCount = 1,
+          .pPushConstantRanges = &PUSH_CONSTANT_RANGE,
+      })},
+      vertex_shader{Compile(HostShaders::FULL_SCREEN_TRIANGLE_VERT,
+                            vk::ShaderStageFlagBits::eVertex, device)},
+      sampler{device.createSampler(vk::SamplerCreateInfo{
+          .magFilter = vk::Filter::eLinear,
+          .minFilter = vk::Filter::eLinear,
+          .mipmapMode = vk::SamplerMipmapMode::eNearest,
+          .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+          .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+          .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+          .maxLod = 0.0f,
+      })} {}
+
+PostProcessingChain::~PostProcessingChain() {
+    for (auto& screen_targets : targets) {
+        for (Target& target : screen_targets) {
+            DestroyTarget(target);
+        }
+    }
+    for (const auto& [shader, pipeline] : pipelines) {
+        device.destroyPipeline(pipeline);
+    }
+    device.destroySampler(sampler);
+    device.destroyShaderModule(vertex_shader);
+    device.destroyPipelineLayout(pipeline_layout);
+    device.destroyRenderPass(renderpass);
+}
+
+void PostProcessingChain::Apply(ScreenInfo& screen_info, std::size_t screen_id,
+                                u32 resolution_scale) {
+    UpdateChain();
+    if (passes.empty()) {
+        return;
+    }
+
+    // The screens are stored rotated, u goes from the top to the bottom of the texcoords and v
+    // from the left to the right. The passes keep that orientation.
+    const auto& texcoords = screen_info.texcoords;
+    vk::ImageView source = screen_info.image_view;
+    PassInfo info{
+        .tex_scale{texcoords.bottom - texcoords.top, texcoords.right - texcoords.left},
+        .tex_offset{texcoords.top, texcoords.left},
+        .i_resolution = MakeResolution(screen_info.texture.width * resolution_scale,
+                                       screen_info.texture.height * resolution_scale),
+        .layer = screen_id == 1 ? 1 : 0,
+    };
+
+    auto& screen_targets = targets[screen_id];
+    screen_targets.resize(passes.size());
+    renderpass_cache.EndRendering();
+    for (std::size_t i = 0; i < passes.size(); i++) {
+        const vk::Pipeline pipeline = GetPipeline(passes[i].shader);
+        if (!pipeline) {
+            continue;
+        }
+
+        const u32 scale = passes[i].scale != 0 ? passes[i].scale : resolution_scale;
+        const u32 width = screen_info.texture.width * scale;
+        const u32 height = screen_info.texture.height * scale;
+        Target& target = screen_targets[i];
+        if (target.width != width || target.height != height) {
+            ResizeTarget(target, width, height);
+        }
+
+        const DescriptorData data{vk::DescriptorImageInfo{
+            .sampler = sampler,
+            .imageView = source,
+            .imageLayout = vk::ImageLayout::eGeneral,
+        }};
+        const vk::DescriptorSet descriptor_set = set_provider.Acquire(std::span{&data, 1});
+        info.o_resolution = MakeResolution(width, height);
+
+        scheduler.Record([this, pipeline, descriptor_set, info, framebuffer = target.framebuffer,
+                          width, height](vk::CommandBuffer cmdbuf) {
+            const vk::Viewport viewport = {
+                .x = 0.0f,
+                .y = 0.0f,
+                .width = static_cast<float>(width),
+                .height = static_cast<float>(height),
+                .minDepth = 0.0f,
+                .maxDepth = 1.0f,
+            };
+            const vk::Rect2D render_area = {
+                .offset = {0, 0},
+                .extent = {width, height},
+            };
+            const vk::RenderPassBeginInfo renderpass_begin_info = {
+                .renderPass = renderpass,
+                .framebuffer = framebuffer,
+                .renderArea = render_area,
+                .clearValueCount = 0,
+                .pClearValues = nullptr,
+            };
+
+            cmdbuf.beginRenderPass(renderpass_begin_info, vk::SubpassContents::eInline);
+            cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+            cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0,
+                                      descriptor_set, {});
+            cmdbuf.pushConstants(pipeline_layout, PUSH_CONSTANT_RANGE.stageFlags, 0,
+                                 sizeof(info), &info);
+            cmdbuf.setViewport(0, viewport);
+            cmdbuf.setScissor(0, render_area);
+            cmdbuf.draw(3, 1, 0, 0);
+            cmdbuf.endRenderPass();
+        });
+
+        source = target.image_view;
+        info.tex_scale = {1.0f, 1.0f};
+        info.tex_offset = {0.0f, 0.0f};
+        info.i_resolution = info.o_resolution;
+    }
+    scheduler.MakeDirty(StateFlags::Pipeline);
+
+    if (source != screen_info.image_view) {
+        screen_info.image_view = source;
+        screen_info.texcoords = Common::Rectangle<f32>(0.f, 0.f, 1.f, 1.f);
+    }
+}
+
+void PostProcessingChain::UpdateChain() {
+    const std::string& setting = Settings::values.pp_shader_chain.GetValue();
+    if (setting == chain_setting) {
+        return;
+    }
+    chain_setting = setting;
+    passes = VideoCore::ParsePostProcessingChain(chain_setting);
+}
+
+vk::Pipeline PostProcessingChain::GetPipeline(const std::string& shader) {
+    auto [it, inserted] = pipelines.try_emplace(shader);
+    if (!inserted) {
+        return it->second;
+    }
+
+    // Failures are remembered so the shader directory isn't searched every frame
+    const std::string shader_text = VideoCore::MakePostProcessingShader(
+        dolphin_shader_declarations, VideoCore::LoadPostProcessingShader(false, shader));
+    if (shader_text.empty()) {
+        LOG_ERROR(Render_Vulkan, "Post-processing shader {} could not be loaded", shader);
+        return {};
+    }
+    const vk::ShaderModule fragment_shader =
+        Compile(shader_text, vk::ShaderStageFlagBits::eFragment, device);
+    if (!fragment_shader) {
+        LOG_ERROR(Render_Vulkan, "Post-processing shader {} failed to compile", shader);
+        return {};
+    }
+
+    const std::array stages = {
+        vk::PipelineShaderStageCreateInfo{
+            .stage = vk::ShaderStageFlagBits::eVertex,
+            .module = vertex_shader,
+            .pName = "main",
+        },
+        vk::PipelineShaderStageCreateInfo{
+            .stage = vk::ShaderStageFlagBits::eFragment,
+            .module = fragment_shader,
+            .pName = "main",
+        },
+    };
+    const vk::PipelineVertexInputStateCreateInfo vertex_input_info{};
+    const vk::PipelineInputAssemblyStateCreateInfo input_assembly = {
+        .topology = vk::PrimitiveTopology::eTriangleList,
+        .primitiveRestartEnable = false,
+    };
+    const vk::PipelineViewportStateCreateInfo viewport_info = {
+        .viewportCount = 1,
+        .scissorCount = 1,
+    };
+    const vk::PipelineRasterizationStateCreateInfo raster_state = {
+        .depthClampEnable = false,
+        .rasterizerDiscardEnable = false,
+        .cullMode = vk::CullModeFlagBits::eNone,
+        .frontFace = vk::FrontFace::eClockwise,
+        .depthBiasEnable = false,
+        .lineWidth = 1.0f,
+    };
+    const vk::PipelineMultisampleStateCreateInfo multisampling = {
+        .rasterizationSamples = vk::SampleCountFlagBits::e1,
+        .sampleShadingEnable = false,
+    };
+    const vk::PipelineColorBlendAttachmentState colorblend_attachment = {
+        .blendEnable = false,
+        .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                          vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA,
+    };
+    const vk::PipelineColorBlendStateCreateInfo color_blending = {
+        .logicOpEnable = false,
+        .attachmentCount = 1,
+        .pAttachments = &colorblend_attachment,
+    };
+    const vk::PipelineDepthStencilStateCreateInfo depth_info = {
+        .depthTestEnable = false,
+        .depthWriteEnable = false,
+        .depthCompareOp = vk::CompareOp::eAlways,
+        .depthBoundsTestEnable = false,
+        .stencilTestEnable = false,
+    };
+    const std::array dynamic_states = {
+        vk::DynamicState::eViewport,
+        vk::DynamicState::eScissor,
+    };
+    const vk::PipelineDynamicStateCreateInfo dynamic_info = {
+        .dynamicStateCount = static_cast<u32>(dynamic_states.size()),
+        .pDynamicStates = dynamic_states.data(),
+    };
+
+    const vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .stageCount = static_cast<u32>(stages.size()),
+        .pStages = stages.data(),
+        .pVertexInputState = &vertex_input_info,
+        .pInputAssemblyState = &input_assembly,
+        .pViewportState = &viewport_info,
+        .pRasterizationState = &raster_state,
+        .pMultisampleState = &multisampling,
+        .pDepthStencilState = &depth_info,
+        .pColorBlendState = &color_blending,
+        .pDynamicState = &dynamic_info,
+        .layout = pipeline_layout,
+        .renderPass = renderpass,
+    };
+
+    const auto [result, pipeline] = device.createGraphicsPipeline({}, pipeline_info);
+    device.destroyShaderModule(fragment_shader);
+    if (result != vk::Result::eSuccess) {
+        LOG_ERROR(Render_Vulkan, "Unable to build the pipeline of post-processing shader {}",
+                  shader);
+        return {};
+    }
+    it->second = pipeline;
+    return pipeline;
+}
+
+void PostProcessingChain::ResizeTarget(Target& target, u32 width, u32 height) {
+    if (target.image) {
+        // Frames in flight may still sample the previous image
+        scheduler.Finish();
+        DestroyTarget(target);
+    }
+
+    const vk::ImageCreateInfo image_info = {
+        .imageType = vk::ImageType::e2D,
+        .format = TARGET_FORMAT,
+        .extent = {width, height, 1},
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+    };
+
+    const VmaAllocationCreateInfo alloc_info = {
+        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        .requiredFlags = 0,
+        .preferredFlags = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+    };
+
+    VkImage unsafe_image{};
+    VkImageCreateInfo unsafe_image_info = static_cast<VkImageCreateInfo>(image_info);
+
+    VkResult result = vmaCreateImage(instance.GetAllocator(), &unsafe_image_info, &alloc_info,
+                                     &unsafe_image, &target.allocation, nullptr);
+    if (result != VK_SUCCESS) [[unlikely]] {
+        LOG_CRITICAL(Render_Vulkan, "Failed allocating texture with error {}", result);
+        UNREACHABLE();
+    }
+    target.image = vk::Image{unsafe_image};
+
+    const vk::ImageViewCreateInfo view_info = {
+        .image = target.image,
+        .viewType = vk::ImageViewType::e2D,
+        .format = TARGET_FORMAT,
+        .subresourceRange{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+    };
+    target.image_view = device.createImageView(view_info);
+
+    const vk::FramebufferCreateInfo framebuffer_info = {
+        .renderPass = renderpass,
+        .attachmentCount = 1,
+        .pAttachments = &target.image_view,
+        .width = width,
+        .height = height,
+        .layers = 1,
+    };
+    target.framebuffer = device.createFramebuffer(framebuffer_info);
+    target.width = width;
+    target.height = height;
+}
+
+void PostProcessingChain::DestroyTarget(Target& target) {
+    if (!target.image) {
+        return;
+    }
+    set_provider.FreeWithImage(target.image_view);
+    present_provider.FreeWithImage(target.image_view);
+    device.destroyFramebuffer(target.framebuffer);
+    device.destroyImageView(target.image_view);
+    vmaDestroyImage(instance.GetAllocator(), target.image, target.allocation);
+    target = {};
+}
+
+vk::RenderPass PostProcessingChain::CreateRenderpass() {
+    const vk::AttachmentReference color_ref = {
+        .attachment = 0,
+        .layout = vk::ImageLayout::eColorAttachmentOptimal,
+    };
+
+    const vk::SubpassDescription subpass = {
+        .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+        .colorAttachmentCount = 1u,
+        .pColorAttachments = &color_ref,
+    };
+
+    // The targets are left in the general layout the present descriptors sample them with
+    const vk::AttachmentDescription color_attachment = {
+        .format = TARGET_FORMAT,
+        .loadOp = vk::AttachmentLoadOp::eDontCare,
+        .storeOp = vk::AttachmentStoreOp::eStore,
+        .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
+        .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
+        .initialLayout = vk::ImageLayout::eUndefined,
+        .finalLayout = vk::ImageLayout::eGeneral,
+    };
+
+    // The previous frame sampled the target before it is overwritten, and the next pass or the
+    // present samples it after
+    const std::array dependencies = {
+        vk::SubpassDependency{
+            .srcSubpass = VK_SUBPASS_EXTERNAL,
+            .dstSubpass = 0,
+            .srcStageMask = vk::PipelineStageFlagBits::eFragmentShader,
+            .dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            .srcAccessMask = vk::AccessFlagBits::eNone,
+            .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
+        },
+        vk::SubpassDependency{
+            .srcSubpass = 0,
+            .dstSubpass = VK_SUBPASS_EXTERNAL,
+            .srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            .dstStageMask = vk::PipelineStageFlagBits::eFragmentShader,
+            .srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
+            .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+        },
+    };
+
+    const vk::RenderPassCreateInfo renderpass_info = {
+        .attachmentCount = 1,
+        .pAttachments = &color_attachment,
+        .subpassCount = 1,
+        .pSubpasses = &subpass,
+        .dependencyCount = static_cast<u32>(dependencies.size()),
+        .pDependencies = dependencies.data(),
+    };
+
+    return device.createRenderPass(renderpass_info);
+}
+
+} // namespace Vulkan
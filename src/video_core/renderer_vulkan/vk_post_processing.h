@@ -0,0 +1,83 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "video_core/post_processing.h"
+#include "video_core/renderer_vulkan/vk_descriptor_pool.h"
+
+VK_DEFINE_HANDLE(VmaAllocation)
+
+namespace Vulkan {
+
+class Instance;
+class RenderpassCache;
+class Scheduler;
+struct ScreenInfo;
+
+/**
+ * Runs the post-processing chain of pp_shader_chain over the emulated screens. Every pass renders
+ * into a target of its output size that is kept across frames, and the pipeline of every shader is
+ * built once, so changing the chain back and forth does not compile the shaders again.
+ */
+class PostProcessingChain {
+public:
+    /// present_provider is the descriptor set provider that samples the output of the chain
+    explicit PostProcessingChain(const Instance& instance, Scheduler& scheduler,
+                                 RenderpassCache& renderpass_cache, DescriptorPool& pool,
+                                 DescriptorSetProvider& present_provider);
+    ~PostProcessingChain();
+
+    /**
+     * Records the passes over the image view of the screen and replaces it with the output of the
+     * last pass.
+     * @param screen_id Index of the screen, 1 being the right eye of the top screen
+     * @param resolution_scale Internal resolution in multiples of the native one
+     */
+    void Apply(ScreenInfo& screen_info, std::size_t screen_id, u32 resolution_scale);
+
+private:
+    struct Target {
+        vk::Image image;
+        vk::ImageView image_view;
+        vk::Framebuffer framebuffer;
+        VmaAllocation allocation{};
+        u32 width{};
+        u32 height{};
+    };
+
+    /// Parses the chain again if the setting changed
+    void UpdateChain();
+
+    /// Returns the pipeline of the shader, building it on first use, null if it does not exist
+    vk::Pipeline GetPipeline(const std::string& shader);
+
+    void ResizeTarget(Target& target, u32 width, u32 height);
+
+    void DestroyTarget(Target& target);
+
+    vk::RenderPass CreateRenderpass();
+
+private:
+    const Instance& instance;
+    Scheduler& scheduler;
+    RenderpassCache& renderpass_cache;
+    DescriptorSetProvider& present_provider;
+    DescriptorSetProvider set_provider;
+    vk::Device device;
+    vk::RenderPass renderpass;
+    vk::PipelineLayout pipeline_layout;
+    vk::ShaderModule vertex_shader;
+    vk::Sampler sampler;
+    std::string chain_setting;
+    std::vector<VideoCore::PostProcessingPass> passes;
+    std::unordered_map<std::string, vk::Pipeline> pipelines;
+    std::array<std::vector<Target>, 3> targets;
+};
+
+} // namespace Vulkan
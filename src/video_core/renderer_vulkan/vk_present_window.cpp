@@ -16,6 +16,7 @@
 #include <vk_mem_alloc.h>
 
 MICROPROFILE_DEFINE(Vulkan_WaitPresent, "Vulkan", "Wait For Present", MP_RGB(128, 128, 128));
+MICROPROFILE_DEFINE(Vulkan_PacePresent, "Vulkan", "Pace Present", MP_RGB(160, 128, 128));
 
 namespace Vulkan {
 
@@ -101,9 +102,11 @@ PresentWindow::PresentWindow(Frontend::EmuWindow& emu_window_, const Instance& i
                              Scheduler& scheduler_)
     : emu_window{emu_window_}, instance{instance_}, scheduler{scheduler_},
       surface{CreateSurface(instance.GetInstance(), emu_window)},
-      next_surface{surface}, swapchain{instance, emu_window.GetFramebufferLayout().width,
+      next_surface{surface}, swapchain{instance, scheduler, emu_window.GetFramebufferLayout().width,
                                        emu_window.GetFramebufferLayout().height, surface},
-      graphics_queue{instance.GetGraphicsQueue()}, present_renderpass{CreateRenderpass()},
+      graphics_queue{instance.GetGraphicsQueue()},
+      present_renderpass{CreateRenderpass(vk::ImageLayout::eTransferSrcOptimal)},
+      direct_renderpass{CreateRenderpass(vk::ImageLayout::ePresentSrcKHR)},
       vsync_enabled{Settings::values.use_vsync_new.GetValue()},
       blit_supported{
           CanBlitToSwapchain(instance.GetPhysicalDevice(), swapchain.GetSurfaceFormat().format)},
@@ -156,6 +159,16 @@ PresentWindow::~PresentWindow() {
     const vk::Device device = instance.GetDevice();
     device.destroyCommandPool(command_pool);
     device.destroyRenderPass(present_renderpass);
+    device.destroyRenderPass(direct_renderpass);
+    DestroyDirectFramebuffers();
+    for (const RetiredFramebuffers& old : retired_framebuffers) {
+        for (const vk::Framebuffer framebuffer : old.framebuffers) {
+            device.destroyFramebuffer(framebuffer);
+        }
+        for (const vk::ImageView view : old.views) {
+            device.destroyImageView(view);
+        }
+    }
     for (auto& frame : swap_chain) {
         device.destroyImageView(frame.image_view);
         device.destroyFramebuffer(frame.framebuffer);
@@ -275,6 +288,7 @@ Frame* PresentWindow::GetRenderFrame() {
 }
 
 void PresentWindow::Present(Frame* frame) {
+    frame->queue_time = std::chrono::steady_clock::now();
     if (!use_present_thread) {
         scheduler.WaitWorker();
         CopyToSwapchain(frame);
@@ -289,6 +303,44 @@ void PresentWindow::Present(Frame* frame) {
     });
 }
 
+Frame* PresentWindow::AcquireDirectFrame(u32 width, u32 height) {
+    MICROPROFILE_SCOPE(Vulkan_WaitPresent);
+    UpdateSwapchain(width, height);
+    while (!swapchain.AcquireNextImage()) {
+        RecreateSwapchain(width, height);
+    }
+    if (direct_framebuffers.empty()) {
+        CreateDirectFramebuffers();
+    }
+
+    // The surface may not allow the requested size, the frame then matches the swapchain
+    direct_frame.width = swapchain.GetWidth();
+    direct_frame.height = swapchain.GetHeight();
+    direct_frame.image = swapchain.Image();
+    direct_frame.framebuffer = direct_framebuffers[swapchain.ImageIndex()];
+    direct_frame.renderpass = direct_renderpass;
+    return &direct_frame;
+}
+
+void PresentWindow::PresentDirect(Frame* frame) {
+    frame->queue_time = std::chrono::steady_clock::now();
+
+    // The submission waits for the image to be acquired before writing to it
+    scheduler.Flush(swapchain.GetPresentReadySemaphore(), swapchain.GetImageAcquiredSemaphore());
+    scheduler.WaitWorker();
+
+    u64 present_id{};
+    {
+        std::scoped_lock submit_lock{scheduler.submit_mutex};
+        present_id = swapchain.Present();
+    }
+
+    if (present_id != 0) {
+        pending_presents.push_back({present_id, frame->queue_time});
+        PaceFrames();
+    }
+}
+
 void PresentWindow::WaitPresent() {
     if (!use_present_thread) {
         return;
@@ -344,33 +396,110 @@ void PresentWindow::NotifySurfaceChanged() {
 #endif
 }
 
-void PresentWindow::CopyToSwapchain(Frame* frame) {
-    const auto recreate_swapchain = [&] {
-#ifdef ANDROID
-        {
-            std::unique_lock lock{recreate_surface_mutex};
-            recreate_surface_cv.wait(lock, [this]() { return surface != next_surface; });
-            surface = next_surface;
-        }
-#endif
-        std::scoped_lock submit_lock{scheduler.submit_mutex};
-        graphics_queue.waitIdle();
-        swapchain.Create(frame->width, frame->height, surface);
-    };
-
+void PresentWindow::UpdateSwapchain(u32 width, u32 height) {
 #ifndef ANDROID
     const bool use_vsync = Settings::values.use_vsync_new.GetValue();
-    const bool size_changed =
-        swapchain.GetWidth() != frame->width || swapchain.GetHeight() != frame->height;
+    const bool size_changed = swapchain.GetWidth() != width || swapchain.GetHeight() != height;
     const bool vsync_changed = vsync_enabled != use_vsync;
     if (vsync_changed || size_changed) [[unlikely]] {
         vsync_enabled = use_vsync;
-        recreate_swapchain();
+        RecreateSwapchain(width, height);
     }
 #endif
+}
 
+void PresentWindow::RecreateSwapchain(u32 width, u32 height) {
+#ifdef ANDROID
+    {
+        std::unique_lock lock{recreate_surface_mutex};
+        recreate_surface_cv.wait(lock, [this]() { return surface != next_surface; });
+        surface = next_surface;
+    }
+#endif
+    // Nothing waits for the GPU here, the replaced resources are destroyed once the submissions
+    // still using them completed
+    std::scoped_lock submit_lock{scheduler.submit_mutex};
+    RetireDirectFramebuffers();
+    swapchain.Create(width, height, surface);
+    pending_presents.clear();
+}
+
+void PresentWindow::CreateDirectFramebuffers() {
+    const vk::Device device = instance.GetDevice();
+    const vk::Extent2D extent = swapchain.GetExtent();
+    const u32 num_images = swapchain.GetImageCount();
+    direct_views.resize(num_images);
+    direct_framebuffers.resize(num_images);
+
+    // The images are returned in the order of the indices they are acquired with
+    const std::vector images = device.getSwapchainImagesKHR(swapchain.GetHandle());
+    for (u32 i = 0; i < num_images; i++) {
+        const vk::ImageViewCreateInfo view_info = {
+            .image = images[i],
+            .viewType = vk::ImageViewType::e2D,
+            .format = swapchain.GetSurfaceFormat().format,
+            .subresourceRange{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        };
+        direct_views[i] = device.createImageView(view_info);
+
+        const vk::FramebufferCreateInfo framebuffer_info = {
+            .renderPass = direct_renderpass,
+            .attachmentCount = 1,
+            .pAttachments = &direct_views[i],
+            .width = extent.width,
+            .height = extent.height,
+            .layers = 1,
+        };
+        direct_framebuffers[i] = device.createFramebuffer(framebuffer_info);
+    }
+}
+
+void PresentWindow::RetireDirectFramebuffers() {
+    const vk::Device device = instance.GetDevice();
+    std::erase_if(retired_framebuffers, [&](const RetiredFramebuffers& old) {
+        if (!scheduler.IsFree(old.tick)) {
+            return false;
+        }
+        for (const vk::Framebuffer framebuffer : old.framebuffers) {
+            device.destroyFramebuffer(framebuffer);
+        }
+        for (const vk::ImageView view : old.views) {
+            device.destroyImageView(view);
+        }
+        return true;
+    });
+    if (direct_framebuffers.empty()) {
+        return;
+    }
+    retired_framebuffers.push_back({
+        .views = std::exchange(direct_views, {}),
+        .framebuffers = std::exchange(direct_framebuffers, {}),
+        .tick = scheduler.CurrentTick(),
+    });
+}
+
+void PresentWindow::DestroyDirectFramebuffers() {
+    const vk::Device device = instance.GetDevice();
+    for (const vk::Framebuffer framebuffer : direct_framebuffers) {
+        device.destroyFramebuffer(framebuffer);
+    }
+    for (const vk::ImageView view : direct_views) {
+        device.destroyImageView(view);
+    }
+    direct_framebuffers.clear();
+    direct_views.clear();
+}
+
+void PresentWindow::CopyToSwapchain(Frame* frame) {
+    UpdateSwapchain(frame->width, frame->height);
     while (!swapchain.AcquireNextImage()) {
-        recreate_swapchain();
+        RecreateSwapchain(frame->width, frame->height);
     }
 
     const vk::Image swapchain_image = swapchain.Image();
@@ -473,19 +602,57 @@ void PresentWindow::CopyToSwapchain(Frame* frame) {
         .pSignalSemaphores = &present_ready,
     };
 
-    std::scoped_lock submit_lock{scheduler.submit_mutex};
+    u64 present_id{};
+    {
+        std::scoped_lock submit_lock{scheduler.submit_mutex};
 
-    try {
-        graphics_queue.submit(submit_info, frame->present_done);
-    } catch (vk::DeviceLostError& err) {
-        LOG_CRITICAL(Render_Vulkan, "Device lost during present submit: {}", err.what());
-        UNREACHABLE();
+        try {
+            graphics_queue.submit(submit_info, frame->present_done);
+        } catch (vk::DeviceLostError& err) {
+            LOG_CRITICAL(Render_Vulkan, "Device lost during present submit: {}", err.what());
+            UNREACHABLE();
+        }
+
+        present_id = swapchain.Present();
     }
 
-    swapchain.Present();
+    if (present_id != 0) {
+        pending_presents.push_back({present_id, frame->queue_time});
+        PaceFrames();
+    }
 }
 
-vk::RenderPass PresentWindow::CreateRenderpass() {
+void PresentWindow::PaceFrames() {
+    MICROPROFILE_SCOPE(Vulkan_PacePresent);
+    static constexpr u64 PaceTimeout = 100'000'000;
+
+    const u32 max_queued_presents = Settings::values.max_queued_presents.GetValue();
+    while (!pending_presents.empty()) {
+        // Completed presents are polled for latency, presenting only blocks when too many frames
+        // are waiting for the display. This keeps the display queue short so new frames reflect
+        // recent input.
+        const bool must_wait =
+            max_queued_presents != 0 && pending_presents.size() > max_queued_presents;
+        const PendingPresent pending = pending_presents.front();
+        if (!swapchain.WaitForPresent(pending.present_id, must_wait ? PaceTimeout : 0)) {
+            // The display is not consuming frames, for example when the window is minimized
+            if (must_wait) {
+                pending_presents.pop_front();
+            }
+            break;
+        }
+        pending_presents.pop_front();
+
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - pending.queue_time);
+        const u64 sample = static_cast<u64>(latency.count());
+        const u64 average = present_latency_us.load(std::memory_order_relaxed);
+        present_latency_us.store(average == 0 ? sample : (average * 7 + sample) / 8,
+                                 std::memory_order_relaxed);
+    }
+}
+
+vk::RenderPass PresentWindow::CreateRenderpass(vk::ImageLayout final_layout) {
     const vk::AttachmentReference color_ref = {
         .attachment = 0,
         .layout = vk::ImageLayout::eGeneral,
@@ -508,16 +675,28 @@ vk::RenderPass PresentWindow::CreateRenderpass() {
         .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
         .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
         .initialLayout = vk::ImageLayout::eUndefined,
-        .finalLayout = vk::ImageLayout::eTransferSrcOptimal,
+        .finalLayout = final_layout,
+    };
+
+    // Swapchain images are transitioned once the image acquired semaphore, waited on at the color
+    // output stage, is signaled
+    const vk::SubpassDependency acquire_dependency = {
+        .srcSubpass = VK_SUBPASS_EXTERNAL,
+        .dstSubpass = 0,
+        .srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        .dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        .srcAccessMask = vk::AccessFlagBits::eNone,
+        .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
     };
+    const bool is_present = final_layout == vk::ImageLayout::ePresentSrcKHR;
 
     const vk::RenderPassCreateInfo renderpass_info = {
         .attachmentCount = 1,
         .pAttachments = &color_attachment,
         .subpassCount = 1,
         .pSubpasses = &subpass,
-        .dependencyCount = 0,
-        .pDependencies = nullptr,
+        .dependencyCount = is_present ? 1U : 0U,
+        .pDependencies = is_present ? &acquire_dependency : nullptr,
     };
 
     return instance.GetDevice().createRenderPass(renderpass_info);
@@ -2,8 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#pragma once
+
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <queue>
 #include "common/polyfill_thread.h"
@@ -32,6 +36,8 @@ struct Frame {
     vk::Semaphore render_ready;
     vk::Fence present_done;
     vk::CommandBuffer cmdbuf;
+    std::chrono::steady_clock::time_point queue_time;
+    vk::RenderPass renderpass{}; ///< Set when the frame draws directly into a swapchain image
 };
 
 class PresentWindow final {
@@ -52,6 +58,18 @@ public:
     /// Queues the provided frame for presentation.
     void Present(Frame* frame);
 
+    /// Returns true when frames can be drawn directly into the swapchain images, which is the
+    /// case when presentation is synchronous and the images are acquired on the render thread.
+    [[nodiscard]] bool CanPresentDirect() const noexcept {
+        return !use_present_thread;
+    }
+
+    /// Acquires the next swapchain image and returns a frame that draws into it.
+    Frame* AcquireDirectFrame(u32 width, u32 height);
+
+    /// Submits the current execution context and presents the frame from AcquireDirectFrame.
+    void PresentDirect(Frame* frame);
+
     /// This is called to notify the rendering backend of a surface change
     void NotifySurfaceChanged();
 
@@ -59,16 +77,44 @@ public:
         return present_renderpass;
     }
 
+    /// Returns the format of the frames, which matches the one of the swapchain.
+    [[nodiscard]] vk::Format Format() const noexcept {
+        return swapchain.GetSurfaceFormat().format;
+    }
+
     u32 ImageCount() const noexcept {
         return swapchain.GetImageCount();
     }
 
+    /// Returns the average time from queueing a frame until it reached the display,
+    /// zero when present wait is not supported.
+    [[nodiscard]] std::chrono::microseconds PresentLatency() const noexcept {
+        return std::chrono::microseconds{present_latency_us.load(std::memory_order_relaxed)};
+    }
+
 private:
     void PresentThread(std::stop_token token);
 
     void CopyToSwapchain(Frame* frame);
 
-    vk::RenderPass CreateRenderpass();
+    /// Recreates the swapchain if the size or the vsync setting changed.
+    void UpdateSwapchain(u32 width, u32 height);
+
+    /// Recreates the swapchain, waiting for a new surface on Android.
+    void RecreateSwapchain(u32 width, u32 height);
+
+    /// Creates the framebuffers drawing directly into the swapchain images.
+    void CreateDirectFramebuffers();
+
+    /// Queues the direct framebuffers for destruction once the GPU is done with them.
+    void RetireDirectFramebuffers();
+
+    void DestroyDirectFramebuffers();
+
+    /// Measures the latency of presented frames and blocks while too many are queued.
+    void PaceFrames();
+
+    vk::RenderPass CreateRenderpass(vk::ImageLayout final_layout);
 
 private:
     Frontend::EmuWindow& emu_window;
@@ -80,6 +126,16 @@ private:
     vk::CommandPool command_pool;
     vk::Queue graphics_queue;
     vk::RenderPass present_renderpass;
+    vk::RenderPass direct_renderpass;
+    std::vector<vk::ImageView> direct_views;
+    std::vector<vk::Framebuffer> direct_framebuffers;
+    struct RetiredFramebuffers {
+        std::vector<vk::ImageView> views;
+        std::vector<vk::Framebuffer> framebuffers;
+        u64 tick;
+    };
+    std::vector<RetiredFramebuffers> retired_framebuffers;
+    Frame direct_frame{};
     std::vector<Frame> swap_chain;
     std::queue<Frame*> free_queue;
     std::queue<Frame*> present_queue;
@@ -91,6 +147,12 @@ private:
     std::mutex queue_mutex;
     std::mutex free_mutex;
     std::jthread present_thread;
+    struct PendingPresent {
+        u64 present_id;
+        std::chrono::steady_clock::time_point queue_time;
+    };
+    std::deque<PendingPresent> pending_presents;
+    std::atomic<u64> present_latency_us{};
     bool vsync_enabled{};
     bool blit_supported;
     bool use_present_thread{true};
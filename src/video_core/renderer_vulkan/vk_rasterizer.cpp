@@ -31,6 +31,8 @@ using namespace Common::Literals;
 using namespace Pica::Shader::Generator;
 
 constexpr u64 STREAM_BUFFER_SIZE = 64_MiB;
+constexpr u64 VERTEX_CACHE_SIZE = 32_MiB;
+constexpr u64 MAX_CACHED_VERTEX_SIZE = VERTEX_CACHE_SIZE / 16;
 constexpr u64 UNIFORM_BUFFER_SIZE = 4_MiB;
 constexpr u64 TEXTURE_BUFFER_SIZE = 2_MiB;
 
@@ -42,6 +44,7 @@ struct DrawParams {
     s32 vertex_offset;
     u32 binding_count;
     std::array<u32, 16> bindings;
+    std::array<vk::Buffer, 16> buffers;
     bool is_indexed;
 };
 
@@ -59,14 +62,17 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
                                    VideoCore::RendererBase& renderer,
                                    Frontend::EmuWindow& emu_window, const Instance& instance,
                                    Scheduler& scheduler, DescriptorPool& pool,
-                                   RenderpassCache& renderpass_cache, u32 image_count)
+                                   RenderpassCache& renderpass_cache, u32 image_count,
+                                   VideoCore::GpuProfiler& gpu_profiler_, u64 program_id)
     : RasterizerAccelerated{memory, pica}, instance{instance}, scheduler{scheduler},
-      renderpass_cache{renderpass_cache}, pipeline_cache{instance, scheduler, renderpass_cache,
-                                                         pool},
-      runtime{instance,   scheduler, renderpass_cache, pool, pipeline_cache.TextureProvider(),
-              image_count},
+      renderpass_cache{renderpass_cache}, gpu_profiler{gpu_profiler_},
+      pipeline_cache{instance, scheduler, renderpass_cache, pool, program_id},
+      runtime{instance, scheduler, renderpass_cache, pool, pipeline_cache.TextureProvider(),
+              pipeline_cache.GetTextureHeap(), image_count, gpu_profiler},
       res_cache{memory, custom_tex_manager, runtime, regs, renderer},
       stream_buffer{instance, scheduler, BUFFER_USAGE, STREAM_BUFFER_SIZE},
+      vertex_cache_buffer{instance, scheduler, vk::BufferUsageFlagBits::eVertexBuffer,
+                          VERTEX_CACHE_SIZE},
       uniform_buffer{instance, scheduler, vk::BufferUsageFlagBits::eUniformBuffer,
                      UNIFORM_BUFFER_SIZE},
       texture_buffer{instance, scheduler, vk::BufferUsageFlagBits::eUniformTexelBuffer,
@@ -79,7 +85,7 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
 
     uniform_buffer_alignment = instance.UniformMinAlignment();
     uniform_size_aligned_vs_pica =
-        Common::AlignUp(sizeof(VSPicaUniformData), uniform_buffer_alignment);
+        Common::AlignUp(sizeof(GSPicaUniformData), uniform_buffer_alignment);
     uniform_size_aligned_vs = Common::AlignUp(sizeof(VSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs = Common::AlignUp(sizeof(FSUniformData), uniform_buffer_alignment);
 
@@ -109,7 +115,7 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
 
     // Since we don't have access to VK_EXT_descriptor_indexing we need to intiallize
     // all descriptor sets even the ones we don't use.
-    pipeline_cache.BindBuffer(0, uniform_buffer.Handle(), 0, sizeof(VSPicaUniformData));
+    pipeline_cache.BindBuffer(0, uniform_buffer.Handle(), 0, sizeof(GSPicaUniformData));
     pipeline_cache.BindBuffer(1, uniform_buffer.Handle(), 0, sizeof(VSUniformData));
     pipeline_cache.BindBuffer(2, uniform_buffer.Handle(), 0, sizeof(FSUniformData));
     pipeline_cache.BindTexelBuffer(3, *texture_lf_view);
@@ -121,6 +127,7 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
     for (u32 i = 0; i < 3; i++) {
         pipeline_cache.BindTexture(i, null_surface.ImageView(), null_sampler.Handle());
     }
+    pipeline_cache.BindTextureCube(null_surface.ImageView(), null_sampler.Handle());
 
     for (u32 i = 0; i < 7; i++) {
         pipeline_cache.BindStorageImage(i, null_surface.StorageView());
@@ -138,6 +145,7 @@ void RasterizerVulkan::TickFrame() {
 void RasterizerVulkan::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     pipeline_cache.LoadDiskCache();
+    pipeline_cache.LoadManifest(stop_loading, callback);
 }
 
 void RasterizerVulkan::SyncFixedState() {
@@ -217,6 +225,27 @@ void RasterizerVulkan::SetupVertexArray() {
             base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
         const u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
         u32 data_size = loader.byte_count * vertex_num;
+
+        // Align stride up if required by Vulkan implementation.
+        const u32 aligned_stride =
+            Common::AlignUp(static_cast<u32>(loader.byte_count), stride_alignment);
+        const u32 copy_size = aligned_stride * vertex_num;
+
+        // Create the binding associated with this loader
+        const u32 binding_index = layout.binding_count++;
+        VertexBinding& binding = layout.bindings[binding_index];
+        binding.binding.Assign(binding_index);
+        binding.fixed.Assign(0);
+        binding.stride.Assign(aligned_stride);
+
+        // Bind the copy of unchanged vertex data uploaded by an earlier draw
+        if (const auto cached_offset =
+                res_cache.FindVertexData(data_addr, data_size, aligned_stride)) {
+            vertex_buffers[binding_index] = vertex_cache_buffer.Handle();
+            binding_offsets[binding_index] = static_cast<u32>(*cached_offset);
+            continue;
+        }
+
         res_cache.FlushRegion(data_addr, data_size);
 
         const auto src_span = memory.GetPhysicalSpan(data_addr);
@@ -227,29 +256,43 @@ void RasterizerVulkan::SetupVertexArray() {
         }
 
         const u8* src_ptr = src_span.data();
-        u8* dst_ptr = array_ptr + buffer_offset;
-
-        // Align stride up if required by Vulkan implementation.
-        const u32 aligned_stride =
-            Common::AlignUp(static_cast<u32>(loader.byte_count), stride_alignment);
-        if (aligned_stride == loader.byte_count) {
-            std::memcpy(dst_ptr, src_ptr, data_size);
-        } else {
+        const auto copy_vertices = [&](u8* dst_ptr) {
+            if (aligned_stride == loader.byte_count) {
+                std::memcpy(dst_ptr, src_ptr, data_size);
+                return;
+            }
             for (std::size_t vertex = 0; vertex < vertex_num; vertex++) {
                 std::memcpy(dst_ptr + vertex * aligned_stride, src_ptr + vertex * loader.byte_count,
                             loader.byte_count);
             }
+        };
+
+        if (copy_size <= MAX_CACHED_VERTEX_SIZE && src_span.size() >= data_size &&
+            res_cache.CanCacheVertexData(data_addr)) {
+            auto [cache_ptr, cache_offset, cache_invalidate] =
+                vertex_cache_buffer.Map(copy_size, 16);
+            if (cache_invalidate) {
+                // The buffer wrapped around over copies that recorded draws, including the ones
+                // of the previous loaders, may still read. Wait for them and start over.
+                scheduler.Finish();
+                res_cache.ClearVertexData();
+                return SetupVertexArray();
+            }
+            copy_vertices(cache_ptr);
+            vertex_cache_buffer.Commit(copy_size);
+            res_cache.CacheVertexData(data_addr, data_size, aligned_stride, cache_offset);
+
+            vertex_buffers[binding_index] = vertex_cache_buffer.Handle();
+            binding_offsets[binding_index] = static_cast<u32>(cache_offset);
+            continue;
         }
 
-        // Create the binding associated with this loader
-        VertexBinding& binding = layout.bindings[layout.binding_count];
-        binding.binding.Assign(layout.binding_count);
-        binding.fixed.Assign(0);
-        binding.stride.Assign(aligned_stride);
+        copy_vertices(array_ptr + buffer_offset);
 
         // Keep track of the binding offsets so we can bind the vertex buffer later
-        binding_offsets[layout.binding_count++] = static_cast<u32>(array_offset + buffer_offset);
-        buffer_offset += Common::AlignUp(aligned_stride * vertex_num, 4);
+        vertex_buffers[binding_index] = stream_buffer.Handle();
+        binding_offsets[binding_index] = static_cast<u32>(array_offset + buffer_offset);
+        buffer_offset += Common::AlignUp(copy_size, 4);
     }
 
     stream_buffer.Commit(buffer_offset);
@@ -263,6 +306,7 @@ void RasterizerVulkan::SetupFixedAttribs() {
     VertexLayout& layout = pipeline_info.vertex_layout;
 
     auto [fixed_ptr, fixed_offset, _] = stream_buffer.Map(16 * sizeof(Common::Vec4f), 0);
+    vertex_buffers[layout.binding_count] = stream_buffer.Handle();
     binding_offsets[layout.binding_count] = static_cast<u32>(fixed_offset);
 
     // Reserve the last binding for fixed and default attributes
@@ -329,8 +373,7 @@ bool RasterizerVulkan::SetupGeometryShader() {
     MICROPROFILE_SCOPE(Vulkan_GS);
 
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        LOG_ERROR(Render_Vulkan, "Accelerate draw doesn't support geometry shader");
-        return false;
+        return pipeline_cache.UseProgrammableGeometryShader(regs, pica.gs_setup);
     }
 
     // Enable the quaternion fix-up geometry-shader only if we are actually doing per-fragment
@@ -355,6 +398,16 @@ bool RasterizerVulkan::AccelerateDrawBatch(bool is_indexed) {
     }
 
     pipeline_info.rasterization.topology.Assign(regs.pipeline.triangle_topology);
+    pipeline_info.rasterization.gs_input_vertices.Assign(0);
+    if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
+        // In the Point mode every geometry shader invocation consumes a fixed number of vertices
+        const u32 vertices_per_primitive = (regs.gs.max_input_attribute_index + 1) /
+                                           (regs.pipeline.vs_outmap_total_minus_1_a + 1);
+        if (vertices_per_primitive > 3) {
+            return false;
+        }
+        pipeline_info.rasterization.gs_input_vertices.Assign(vertices_per_primitive);
+    }
     if (regs.pipeline.triangle_topology == TriangleTopology::Fan &&
         !instance.IsTriangleFanSupported()) {
         LOG_DEBUG(Render_Vulkan,
@@ -392,14 +445,15 @@ bool RasterizerVulkan::AccelerateDrawBatchInternal(bool is_indexed) {
         .vertex_offset = -static_cast<s32>(vertex_info.vs_input_index_min),
         .binding_count = pipeline_info.vertex_layout.binding_count,
         .bindings = binding_offsets,
+        .buffers = vertex_buffers,
         .is_indexed = is_indexed,
     };
 
-    scheduler.Record([this, params](vk::CommandBuffer cmdbuf) {
+    scheduler.Record([params](vk::CommandBuffer cmdbuf) {
         std::array<vk::DeviceSize, 16> offsets;
         std::transform(params.bindings.begin(), params.bindings.end(), offsets.begin(),
                        [](u32 offset) { return static_cast<vk::DeviceSize>(offset); });
-        cmdbuf.bindVertexBuffers(0, params.binding_count, vertex_buffers.data(), offsets.data());
+        cmdbuf.bindVertexBuffers(0, params.binding_count, params.buffers.data(), offsets.data());
         if (params.is_indexed) {
             cmdbuf.drawIndexed(params.vertex_count, 1, 0, params.vertex_offset, 0);
         } else {
@@ -439,12 +493,9 @@ void RasterizerVulkan::SetupIndexArray() {
         });
 }
 
-void RasterizerVulkan::DrawTriangles() {
-    if (vertex_batch.empty()) {
-        return;
-    }
-
+void RasterizerVulkan::DrawVertexBatch() {
     pipeline_info.rasterization.topology.Assign(Pica::PipelineRegs::TriangleTopology::List);
+    pipeline_info.rasterization.gs_input_vertices.Assign(0);
     pipeline_info.vertex_layout = software_layout;
 
     pipeline_cache.UseTrivialVertexShader();
@@ -455,6 +506,7 @@ void RasterizerVulkan::DrawTriangles() {
 
 bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
     MICROPROFILE_SCOPE(Vulkan_Drawing);
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Draw};
 
     const bool shadow_rendering = regs.framebuffer.IsShadowRendering();
     const bool has_stencil = regs.framebuffer.HasStencil();
@@ -503,7 +555,17 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
 
     // Sync and bind the shader
     if (shader_dirty) {
-        pipeline_cache.UseFragmentShader(regs, user_config);
+        const auto& fs_config = pipeline_cache.UseFragmentShader(regs, user_config);
+        if (async_shaders) {
+            // The uber fragment shader reads the configuration a pending shader specializes on
+            FSUberData uber_data;
+            uber_data.SetFromConfig(fs_config);
+            auto& current_uber_data = fs_uniform_block_data.data.uber;
+            if (std::memcmp(&uber_data, &current_uber_data, sizeof(uber_data)) != 0) {
+                current_uber_data = uber_data;
+                fs_uniform_block_data.dirty = true;
+            }
+        }
         shader_dirty = false;
     }
 
@@ -512,6 +574,9 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
     SyncAndUploadLUTsLF();
     UploadUniforms(accelerate);
 
+    // Record the texture filters of the surfaces uploaded for this draw
+    runtime.FlushFilters();
+
     // Begin rendering
     const auto draw_rect = fb_helper.DrawRect();
     renderpass_cache.BeginRendering(framebuffer, draw_rect);
@@ -633,7 +698,7 @@ void RasterizerVulkan::BindTextureCube(const Pica::TexturingRegs::FullTextureCon
 
     Surface& surface = res_cache.GetTextureCube(config);
     Sampler& sampler = res_cache.GetSampler(texture.config);
-    pipeline_cache.BindTexture(0, surface.ImageView(), sampler.Handle());
+    pipeline_cache.BindTextureCube(surface.ImageView(), sampler.Handle());
 }
 
 bool RasterizerVulkan::IsFeedbackLoop(u32 texture_index, const Framebuffer* framebuffer,
@@ -739,6 +804,16 @@ void RasterizerVulkan::ClearAll(bool flush) {
     res_cache.ClearAll(flush);
 }
 
+std::optional<VideoCore::IndexRange> RasterizerVulkan::FindIndexRange(PAddr addr, u32 size,
+                                                                      bool index_u16) {
+    return res_cache.FindIndexRange(addr, size, index_u16);
+}
+
+void RasterizerVulkan::CacheIndexRange(PAddr addr, u32 size, bool index_u16,
+                                       VideoCore::IndexRange range) {
+    res_cache.CacheIndexRange(addr, size, index_u16, range);
+}
+
 bool RasterizerVulkan::AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) {
     return res_cache.AccelerateDisplayTransfer(config);
 }
@@ -751,6 +826,14 @@ bool RasterizerVulkan::AccelerateFill(const Pica::MemoryFillConfig& config) {
     return res_cache.AccelerateFill(config);
 }
 
+std::pair<u64, u64> RasterizerVulkan::GetTextureMemory() const {
+    return {res_cache.GetMemoryUsage(), res_cache.GetMemoryBudget()};
+}
+
+VideoCore::PipelineCacheStats RasterizerVulkan::GetPipelineCacheStats() const {
+    return pipeline_cache.GetStats();
+}
+
 bool RasterizerVulkan::AccelerateDisplay(const Pica::FramebufferConfig& config,
                                          PAddr framebuffer_addr, u32 pixel_stride,
                                          ScreenInfo& screen_info) {
@@ -773,6 +856,7 @@ bool RasterizerVulkan::AccelerateDisplay(const Pica::FramebufferConfig& config,
     if (!src_surface_id) {
         return false;
     }
+    runtime.FlushFilters();
 
     const Surface& src_surface = res_cache.GetSurface(src_surface_id);
     const u32 scaled_width = src_surface.GetScaledWidth();
@@ -925,61 +1009,38 @@ void RasterizerVulkan::SyncAndUploadLUTsLF() {
         return;
     }
 
-    std::size_t bytes_used = 0;
     auto [buffer, offset, invalidate] = texture_lf_buffer.Map(max_size, sizeof(Common::Vec4f));
+    lut_lf_uploader.Begin(buffer, offset, invalidate);
 
-    // Sync the lighting luts
+    // Sync the lighting luts, converting only the entries written since the last sync. A buffer
+    // that wrapped around gets the tables converted earlier again.
     if (fs_uniform_block_data.lighting_lut_dirty_any || invalidate) {
-        for (unsigned index = 0; index < fs_uniform_block_data.lighting_lut_dirty.size(); index++) {
-            if (fs_uniform_block_data.lighting_lut_dirty[index] || invalidate) {
-                std::array<Common::Vec2f, 256> new_data;
-                const auto& source_lut = pica.lighting.luts[index];
-                std::transform(source_lut.begin(), source_lut.end(), new_data.begin(),
-                               [](const auto& entry) {
-                                   return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                               });
-
-                if (new_data != lighting_lut_data[index] || invalidate) {
-                    lighting_lut_data[index] = new_data;
-                    std::memcpy(buffer + bytes_used, new_data.data(),
-                                new_data.size() * sizeof(Common::Vec2f));
-                    fs_uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
-                        static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-                    fs_uniform_block_data.dirty = true;
-                    bytes_used += new_data.size() * sizeof(Common::Vec2f);
-                }
-                fs_uniform_block_data.lighting_lut_dirty[index] = false;
+        for (u32 index = 0; index < fs_uniform_block_data.lighting_lut_dirty.size(); index++) {
+            const bool dirty = fs_uniform_block_data.lighting_lut_dirty[index];
+            if ((dirty && SyncLightingLutData(index)) || invalidate) {
+                fs_uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
+                    lut_lf_uploader.Upload(lighting_lut_data[index]);
+                fs_uniform_block_data.dirty = true;
             }
+            fs_uniform_block_data.lighting_lut_dirty[index] = false;
         }
         fs_uniform_block_data.lighting_lut_dirty_any = false;
     }
 
     // Sync the fog lut
     if (fs_uniform_block_data.fog_lut_dirty || invalidate) {
-        std::array<Common::Vec2f, 128> new_data;
-
-        std::transform(pica.fog.lut.begin(), pica.fog.lut.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-                       });
-
-        if (new_data != fog_lut_data || invalidate) {
-            fog_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec2f));
-            fs_uniform_block_data.data.fog_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+        if ((fs_uniform_block_data.fog_lut_dirty && SyncFogLutData()) || invalidate) {
+            fs_uniform_block_data.data.fog_lut_offset = lut_lf_uploader.Upload(fog_lut_data);
             fs_uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec2f);
         }
         fs_uniform_block_data.fog_lut_dirty = false;
     }
 
-    texture_lf_buffer.Commit(static_cast<u32>(bytes_used));
+    texture_lf_buffer.Commit(static_cast<u32>(lut_lf_uploader.BytesUsed()));
 }
 
 void RasterizerVulkan::SyncAndUploadLUTs() {
-    const auto& proctex = pica.proctex;
+    using Pica::TexturingRegs;
     constexpr std::size_t max_size =
         sizeof(Common::Vec2f) * 128 * 3 + // proctex: noise + color + alpha
         sizeof(Common::Vec4f) * 256 +     // proctex
@@ -992,99 +1053,39 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
         return;
     }
 
-    std::size_t bytes_used = 0;
     auto [buffer, offset, invalidate] = texture_buffer.Map(max_size, sizeof(Common::Vec4f));
+    lut_uploader.Begin(buffer, offset, invalidate);
 
-    // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
-    auto sync_proctex_value_lut =
-        [this, buffer = buffer, offset = offset, invalidate = invalidate,
-         &bytes_used](const std::array<Pica::PicaCore::ProcTex::ValueEntry, 128>& lut,
-                      std::array<Common::Vec2f, 128>& lut_data, int& lut_offset) {
-            std::array<Common::Vec2f, 128> new_data;
-            std::transform(lut.begin(), lut.end(), new_data.begin(), [](const auto& entry) {
-                return Common::Vec2f{entry.ToFloat(), entry.DiffToFloat()};
-            });
-
-            if (new_data != lut_data || invalidate) {
-                lut_data = new_data;
-                std::memcpy(buffer + bytes_used, new_data.data(),
-                            new_data.size() * sizeof(Common::Vec2f));
-                lut_offset = static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
-                fs_uniform_block_data.dirty = true;
-                bytes_used += new_data.size() * sizeof(Common::Vec2f);
-            }
-        };
-
-    // Sync the proctex noise lut
-    if (fs_uniform_block_data.proctex_noise_lut_dirty || invalidate) {
-        sync_proctex_value_lut(proctex.noise_table, proctex_noise_lut_data,
-                               fs_uniform_block_data.data.proctex_noise_lut_offset);
-        fs_uniform_block_data.proctex_noise_lut_dirty = false;
-    }
-
-    // Sync the proctex color map
-    if (fs_uniform_block_data.proctex_color_map_dirty || invalidate) {
-        sync_proctex_value_lut(proctex.color_map_table, proctex_color_map_data,
-                               fs_uniform_block_data.data.proctex_color_map_offset);
-        fs_uniform_block_data.proctex_color_map_dirty = false;
-    }
-
-    // Sync the proctex alpha map
-    if (fs_uniform_block_data.proctex_alpha_map_dirty || invalidate) {
-        sync_proctex_value_lut(proctex.alpha_map_table, proctex_alpha_map_data,
-                               fs_uniform_block_data.data.proctex_alpha_map_offset);
-        fs_uniform_block_data.proctex_alpha_map_dirty = false;
-    }
-
-    // Sync the proctex lut
-    if (fs_uniform_block_data.proctex_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_table.begin(), proctex.color_table.end(), new_data.begin(),
-                       [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_lut_data || invalidate) {
-            proctex_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            fs_uniform_block_data.data.proctex_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
-            fs_uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
-        }
-        fs_uniform_block_data.proctex_lut_dirty = false;
-    }
-
-    // Sync the proctex difference lut
-    if (fs_uniform_block_data.proctex_diff_lut_dirty || invalidate) {
-        std::array<Common::Vec4f, 256> new_data;
-
-        std::transform(proctex.color_diff_table.begin(), proctex.color_diff_table.end(),
-                       new_data.begin(), [](const auto& entry) {
-                           auto rgba = entry.ToVector() / 255.0f;
-                           return Common::Vec4f{rgba.r(), rgba.g(), rgba.b(), rgba.a()};
-                       });
-
-        if (new_data != proctex_diff_lut_data || invalidate) {
-            proctex_diff_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
-            fs_uniform_block_data.data.proctex_diff_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec4f));
+    const auto sync_lut = [&, invalidate = invalidate](TexturingRegs::ProcTexLutTable table,
+                                                        bool& lut_dirty, const auto& lut_data,
+                                                        int& lut_offset) {
+        if ((lut_dirty && SyncProcTexLutData(table)) || invalidate) {
+            lut_offset = lut_uploader.Upload(lut_data);
             fs_uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
         }
-        fs_uniform_block_data.proctex_diff_lut_dirty = false;
-    }
+        lut_dirty = false;
+    };
 
-    texture_buffer.Commit(static_cast<u32>(bytes_used));
+    auto& data = fs_uniform_block_data.data;
+    sync_lut(TexturingRegs::ProcTexLutTable::Noise, fs_uniform_block_data.proctex_noise_lut_dirty,
+             proctex_noise_lut_data, data.proctex_noise_lut_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::ColorMap,
+             fs_uniform_block_data.proctex_color_map_dirty, proctex_color_map_data,
+             data.proctex_color_map_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::AlphaMap,
+             fs_uniform_block_data.proctex_alpha_map_dirty, proctex_alpha_map_data,
+             data.proctex_alpha_map_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::Color, fs_uniform_block_data.proctex_lut_dirty,
+             proctex_lut_data, data.proctex_lut_offset);
+    sync_lut(TexturingRegs::ProcTexLutTable::ColorDiff,
+             fs_uniform_block_data.proctex_diff_lut_dirty, proctex_diff_lut_data,
+             data.proctex_diff_lut_offset);
+
+    texture_buffer.Commit(static_cast<u32>(lut_uploader.BytesUsed()));
 }
 
 void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
-    const bool sync_vs_pica = accelerate_draw;
+    const bool sync_vs_pica = accelerate_draw && SyncPicaUniforms();
     const bool sync_vs = vs_uniform_block_data.dirty;
     const bool sync_fs = fs_uniform_block_data.dirty;
     if (!sync_vs_pica && !sync_vs && !sync_fs) {
@@ -1116,12 +1117,16 @@ void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
         used_bytes += static_cast<u32>(uniform_size_aligned_fs);
     }
 
-    if (sync_vs_pica) {
-        VSPicaUniformData vs_uniforms;
-        vs_uniforms.uniforms.SetFromRegs(regs.vs, pica.vs_setup);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+    // The PICA uniforms only change between some draws, the copy uploaded last is reused until
+    // then. It is lost when the buffer wraps around, even if this draw does not need it.
+    if (invalidate) {
+        pica_uniform_block_data.dirty = true;
+    }
+    if (accelerate_draw && pica_uniform_block_data.dirty) {
+        std::memcpy(uniforms + used_bytes, &pica_uniform_block_data.data, PicaUniformsSize());
 
         pipeline_cache.SetBufferOffset(0, offset + used_bytes);
+        pica_uniform_block_data.dirty = false;
         used_bytes += static_cast<u32>(uniform_size_aligned_vs_pica);
     }
 
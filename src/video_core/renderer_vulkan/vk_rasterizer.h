@@ -16,6 +16,7 @@ class EmuWindow;
 
 namespace VideoCore {
 class CustomTexManager;
+class GpuProfiler;
 class RendererBase;
 } // namespace VideoCore
 
@@ -40,14 +41,14 @@ public:
                               VideoCore::CustomTexManager& custom_tex_manager,
                               VideoCore::RendererBase& renderer, Frontend::EmuWindow& emu_window,
                               const Instance& instance, Scheduler& scheduler, DescriptorPool& pool,
-                              RenderpassCache& renderpass_cache, u32 image_count);
+                              RenderpassCache& renderpass_cache, u32 image_count,
+                              VideoCore::GpuProfiler& gpu_profiler, u64 program_id);
     ~RasterizerVulkan() override;
 
     void TickFrame();
     void LoadDiskResources(const std::atomic_bool& stop_loading,
                            const VideoCore::DiskResourceLoadCallback& callback) override;
 
-    void DrawTriangles() override;
     void FlushAll() override;
     void FlushRegion(PAddr addr, u32 size) override;
     void InvalidateRegion(PAddr addr, u32 size) override;
@@ -59,11 +60,17 @@ public:
     bool AccelerateDisplay(const Pica::FramebufferConfig& config, PAddr framebuffer_addr,
                            u32 pixel_stride, ScreenInfo& screen_info);
     bool AccelerateDrawBatch(bool is_indexed) override;
+    std::pair<u64, u64> GetTextureMemory() const override;
+    VideoCore::PipelineCacheStats GetPipelineCacheStats() const override;
 
     void SyncFixedState() override;
 
 private:
     void NotifyFixedFunctionPicaRegisterChanged(u32 id) override;
+    std::optional<VideoCore::IndexRange> FindIndexRange(PAddr addr, u32 size,
+                                                        bool index_u16) override;
+    void CacheIndexRange(PAddr addr, u32 size, bool index_u16,
+                         VideoCore::IndexRange range) override;
 
     /// Syncs the cull mode to match the PICA register
     void SyncCullMode();
@@ -118,7 +125,10 @@ private:
     /// Upload the uniform blocks to the uniform buffer object
     void UploadUniforms(bool accelerate_draw);
 
-    /// Generic draw function for DrawTriangles and AccelerateDrawBatch
+    /// Draws the software shaded vertex batch
+    void DrawVertexBatch() override;
+
+    /// Generic draw function for DrawVertexBatch and AccelerateDrawBatch
     bool Draw(bool accelerate, bool is_indexed);
 
     /// Internal implementation for AccelerateDrawBatch
@@ -146,6 +156,7 @@ private:
     const Instance& instance;
     Scheduler& scheduler;
     RenderpassCache& renderpass_cache;
+    VideoCore::GpuProfiler& gpu_profiler;
     PipelineCache pipeline_cache;
     TextureRuntime runtime;
     RasterizerCache res_cache;
@@ -157,10 +168,13 @@ private:
     VertexArrayInfo vertex_info;
     PipelineInfo pipeline_info{};
 
-    StreamBuffer stream_buffer;     ///< Vertex+Index buffer
-    StreamBuffer uniform_buffer;    ///< Uniform buffer
-    StreamBuffer texture_buffer;    ///< Texture buffer
-    StreamBuffer texture_lf_buffer; ///< Texture Light-Fog buffer
+    StreamBuffer stream_buffer;       ///< Vertex+Index buffer
+    StreamBuffer vertex_cache_buffer; ///< Copies of unchanged vertex data
+    StreamBuffer uniform_buffer;      ///< Uniform buffer
+    StreamBuffer texture_buffer;      ///< Texture buffer
+    StreamBuffer texture_lf_buffer;   ///< Texture Light-Fog buffer
+    LutUploader lut_uploader;
+    LutUploader lut_lf_uploader;
     vk::UniqueBufferView texture_lf_view;
     vk::UniqueBufferView texture_rg_view;
     vk::UniqueBufferView texture_rgba_view;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <limits>
 #include "common/assert.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
@@ -17,6 +18,16 @@ constexpr u32 MIN_DRAWS_TO_FLUSH = 20;
 using VideoCore::PixelFormat;
 using VideoCore::SurfaceType;
 
+namespace {
+
+bool Contains(const vk::Rect2D& area, const vk::Rect2D& rect) {
+    return rect.offset.x >= area.offset.x && rect.offset.y >= area.offset.y &&
+           rect.offset.x + rect.extent.width <= area.offset.x + area.extent.width &&
+           rect.offset.y + rect.extent.height <= area.offset.y + area.extent.height;
+}
+
+} // Anonymous namespace
+
 RenderpassCache::RenderpassCache(const Instance& instance, Scheduler& scheduler)
     : instance{instance}, scheduler{scheduler} {}
 
@@ -34,19 +45,74 @@ void RenderpassCache::BeginRendering(const Framebuffer* framebuffer,
             .height = draw_rect.GetHeight(),
         },
     };
-    const RenderPass new_pass = {
+    RenderPass new_pass = {
         .framebuffer = framebuffer->Handle(),
         .render_pass = framebuffer->RenderPass(),
         .render_area = render_area,
         .clear = {},
         .do_clear = false,
     };
-    images = framebuffer->Images();
+
+    // Deferred clears of attachments the size of the framebuffer are turned into load
+    // operations, which avoids loading their previous contents on tiled GPUs.
+    const std::array formats = {framebuffer->Format(SurfaceType::Color),
+                                framebuffer->Format(SurfaceType::DepthStencil)};
+    const std::array fb_images = framebuffer->Images();
+    const vk::Extent2D fb_extent = {framebuffer->Width(), framebuffer->Height()};
+    std::array<bool, 2> clear_attachments{};
+    u32 attachment = 0;
+    for (u32 i = 0; i < fb_images.size(); i++) {
+        if (formats[i] == PixelFormat::Invalid) {
+            continue;
+        }
+        const auto it = std::find_if(
+            pending_clears.begin(), pending_clears.end(),
+            [image = fb_images[i]](const ImageClear& clear) { return clear.image == image; });
+        if (it != pending_clears.end() && it->extent == fb_extent) {
+            clear_attachments[i] = true;
+            new_pass.clear[attachment] = it->value;
+            pending_clears.erase(it);
+        }
+        attachment++;
+    }
+    FlushClears();
+
+    if (clear_attachments[0] || clear_attachments[1]) {
+        new_pass.render_pass =
+            GetRenderpass(formats[0], formats[1], clear_attachments[0], clear_attachments[1]);
+        new_pass.render_area = vk::Rect2D{
+            .offset = {0, 0},
+            .extent = fb_extent,
+        };
+        new_pass.do_clear = true;
+    }
+
+    // Draws within the area of the active renderpass continue it instead of restarting it
+    if (!new_pass.do_clear && pass.render_pass == new_pass.render_pass &&
+        pass.framebuffer == new_pass.framebuffer && Contains(pass.render_area, render_area))
+        [[likely]] {
+        num_draws++;
+        return;
+    }
+
+    EndRendering();
+    images = fb_images;
     aspects = framebuffer->Aspects();
-    BeginRendering(new_pass);
+    for (u32 i = 0; i < fb_images.size(); i++) {
+        attachment_images[i] = formats[i] != PixelFormat::Invalid ? fb_images[i] : vk::Image{};
+    }
+    BeginPass(new_pass);
 }
 
 void RenderpassCache::BeginRendering(const RenderPass& new_pass) {
+    FlushClears();
+    if (!(pass == new_pass)) {
+        attachment_images = {};
+    }
+    BeginPass(new_pass);
+}
+
+void RenderpassCache::BeginPass(const RenderPass& new_pass) {
     if (pass == new_pass) [[likely]] {
         num_draws++;
         return;
@@ -58,8 +124,8 @@ void RenderpassCache::BeginRendering(const RenderPass& new_pass) {
             .renderPass = info.render_pass,
             .framebuffer = info.framebuffer,
             .renderArea = info.render_area,
-            .clearValueCount = info.do_clear ? 1u : 0u,
-            .pClearValues = &info.clear,
+            .clearValueCount = info.do_clear ? static_cast<u32>(info.clear.size()) : 0u,
+            .pClearValues = info.clear.data(),
         };
         cmdbuf.beginRenderPass(renderpass_begin_info, vk::SubpassContents::eInline);
     });
@@ -68,6 +134,7 @@ void RenderpassCache::BeginRendering(const RenderPass& new_pass) {
 }
 
 void RenderpassCache::EndRendering() {
+    FlushClears();
     if (!pass.render_pass) {
         return;
     }
@@ -123,8 +190,112 @@ void RenderpassCache::EndRendering() {
     }
 }
 
+bool RenderpassCache::ClearAttachment(vk::Image image, vk::Rect2D rect,
+                                      const vk::ClearValue& value) {
+    if (!pass.render_pass || !image) {
+        return false;
+    }
+    const auto it = std::find(attachment_images.begin(), attachment_images.end(), image);
+    if (it == attachment_images.end() || !Contains(pass.render_area, rect)) {
+        return false;
+    }
+
+    const vk::ClearAttachment attachment = {
+        .aspectMask = aspects[std::distance(attachment_images.begin(), it)],
+        .colorAttachment = 0,
+        .clearValue = value,
+    };
+    const vk::ClearRect clear_rect = {
+        .rect = rect,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+    scheduler.Record([attachment, clear_rect](vk::CommandBuffer cmdbuf) {
+        cmdbuf.clearAttachments(attachment, clear_rect);
+    });
+    return true;
+}
+
+void RenderpassCache::ClearImage(const ImageClear& clear) {
+    // Clears are only deferred while no renderpass is active, so they can always be flushed
+    ASSERT(!pass.render_pass);
+    DiscardClear(clear.image);
+    if (pending_clears.size() == pending_clears.capacity()) {
+        FlushClears();
+    }
+    pending_clears.push_back(clear);
+}
+
+void RenderpassCache::DiscardClear(vk::Image image) {
+    const auto it =
+        std::remove_if(pending_clears.begin(), pending_clears.end(),
+                       [image](const ImageClear& clear) { return clear.image == image; });
+    pending_clears.erase(it, pending_clears.end());
+}
+
+void RenderpassCache::FlushClears() {
+    if (pending_clears.empty()) {
+        return;
+    }
+
+    scheduler.Record([clears = pending_clears](vk::CommandBuffer cmdbuf) {
+        for (const ImageClear& clear : clears) {
+            const vk::ImageSubresourceRange range = {
+                .aspectMask = clear.aspect,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            };
+
+            const vk::ImageMemoryBarrier pre_barrier = {
+                .srcAccessMask = clear.access,
+                .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .oldLayout = vk::ImageLayout::eGeneral,
+                .newLayout = vk::ImageLayout::eTransferDstOptimal,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = clear.image,
+                .subresourceRange = range,
+            };
+
+            const vk::ImageMemoryBarrier post_barrier = {
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = clear.access,
+                .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = clear.image,
+                .subresourceRange = range,
+            };
+
+            cmdbuf.pipelineBarrier(clear.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
+                                   vk::DependencyFlagBits::eByRegion, {}, {}, pre_barrier);
+
+            if (clear.aspect & vk::ImageAspectFlagBits::eColor) {
+                cmdbuf.clearColorImage(clear.image, vk::ImageLayout::eTransferDstOptimal,
+                                       clear.value.color, range);
+            } else {
+                cmdbuf.clearDepthStencilImage(clear.image, vk::ImageLayout::eTransferDstOptimal,
+                                              clear.value.depthStencil, range);
+            }
+
+            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, clear.pipeline_flags,
+                                   vk::DependencyFlagBits::eByRegion, {}, {}, post_barrier);
+        }
+    });
+    pending_clears.clear();
+}
+
 vk::RenderPass RenderpassCache::GetRenderpass(VideoCore::PixelFormat color,
                                               VideoCore::PixelFormat depth, bool is_clear) {
+    return GetRenderpass(color, depth, is_clear, is_clear);
+}
+
+vk::RenderPass RenderpassCache::GetRenderpass(VideoCore::PixelFormat color,
+                                              VideoCore::PixelFormat depth, bool clear_color,
+                                              bool clear_depth) {
     std::scoped_lock lock{cache_mutex};
 
     const u32 color_index =
@@ -136,20 +307,24 @@ vk::RenderPass RenderpassCache::GetRenderpass(VideoCore::PixelFormat color,
     ASSERT_MSG(color_index <= MAX_COLOR_FORMATS && depth_index <= MAX_DEPTH_FORMATS,
                "Invalid color index {} and/or depth_index {}", color_index, depth_index);
 
-    vk::UniqueRenderPass& renderpass = cached_renderpasses[color_index][depth_index][is_clear];
+    vk::UniqueRenderPass& renderpass =
+        cached_renderpasses[color_index][depth_index][clear_color][clear_depth];
     if (!renderpass) {
         const vk::Format color_format = instance.GetTraits(color).native;
         const vk::Format depth_format = instance.GetTraits(depth).native;
-        const vk::AttachmentLoadOp load_op =
-            is_clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad;
-        renderpass = CreateRenderPass(color_format, depth_format, load_op);
+        const auto load_op = [](bool is_clear) {
+            return is_clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad;
+        };
+        renderpass = CreateRenderPass(color_format, depth_format, load_op(clear_color),
+                                      load_op(clear_depth));
     }
 
     return *renderpass;
 }
 
 vk::UniqueRenderPass RenderpassCache::CreateRenderPass(vk::Format color, vk::Format depth,
-                                                       vk::AttachmentLoadOp load_op) const {
+                                                       vk::AttachmentLoadOp color_load_op,
+                                                       vk::AttachmentLoadOp depth_load_op) const {
     u32 attachment_count = 0;
     std::array<vk::AttachmentDescription, 2> attachments;
 
@@ -161,7 +336,7 @@ vk::UniqueRenderPass RenderpassCache::CreateRenderPass(vk::Format color, vk::For
     if (color != vk::Format::eUndefined) {
         attachments[attachment_count] = vk::AttachmentDescription{
             .format = color,
-            .loadOp = load_op,
+            .loadOp = color_load_op,
             .storeOp = vk::AttachmentStoreOp::eStore,
             .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
             .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
@@ -180,9 +355,9 @@ vk::UniqueRenderPass RenderpassCache::CreateRenderPass(vk::Format color, vk::For
     if (depth != vk::Format::eUndefined) {
         attachments[attachment_count] = vk::AttachmentDescription{
             .format = depth,
-            .loadOp = load_op,
+            .loadOp = depth_load_op,
             .storeOp = vk::AttachmentStoreOp::eStore,
-            .stencilLoadOp = load_op,
+            .stencilLoadOp = depth_load_op,
             .stencilStoreOp = vk::AttachmentStoreOp::eStore,
             .initialLayout = vk::ImageLayout::eGeneral,
             .finalLayout = vk::ImageLayout::eGeneral,
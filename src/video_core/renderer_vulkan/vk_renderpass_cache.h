@@ -5,6 +5,7 @@
 #pragma once
 
 #include <mutex>
+#include <boost/container/static_vector.hpp>
 
 #include "common/math_util.h"
 #include "video_core/renderer_vulkan/vk_common.h"
@@ -23,17 +24,27 @@ struct RenderPass {
     vk::Framebuffer framebuffer;
     vk::RenderPass render_pass;
     vk::Rect2D render_area;
-    vk::ClearValue clear;
+    std::array<vk::ClearValue, 2> clear;
     bool do_clear;
 
     bool operator==(const RenderPass& other) const noexcept {
         return std::tie(framebuffer, render_pass, render_area, do_clear) ==
                    std::tie(other.framebuffer, other.render_pass, other.render_area,
                             other.do_clear) &&
-               std::memcmp(&clear, &other.clear, sizeof(vk::ClearValue)) == 0;
+               std::memcmp(clear.data(), other.clear.data(), sizeof(clear)) == 0;
     }
 };
 
+/// A clear of the first level of an image
+struct ImageClear {
+    vk::Image image;
+    vk::ImageAspectFlags aspect;
+    vk::PipelineStageFlags pipeline_flags;
+    vk::AccessFlags access;
+    vk::Extent2D extent;
+    vk::ClearValue value;
+};
+
 class RenderpassCache {
     static constexpr std::size_t MAX_COLOR_FORMATS = 13;
     static constexpr std::size_t MAX_DEPTH_FORMATS = 4;
@@ -51,22 +62,48 @@ public:
     /// Exits from any currently active renderpass instance
     void EndRendering();
 
+    /// Clears a rectangle of an attachment of the active renderpass without ending it.
+    /// Returns false when the image is not an attachment of the active renderpass.
+    bool ClearAttachment(vk::Image image, vk::Rect2D rect, const vk::ClearValue& value);
+
+    /// Clears the whole first level of an image outside of a renderpass. The clear is deferred
+    /// until the image is used again, so that a renderpass targeting it can clear it with its
+    /// load operation instead.
+    void ClearImage(const ImageClear& clear);
+
+    /// Drops the deferred clear of an image whose contents are no longer needed
+    void DiscardClear(vk::Image image);
+
     /// Returns the renderpass associated with the color-depth format pair
     vk::RenderPass GetRenderpass(VideoCore::PixelFormat color, VideoCore::PixelFormat depth,
                                  bool is_clear);
 
+    /// Returns the renderpass associated with the color-depth format pair, clearing
+    /// the attachments selected on load
+    vk::RenderPass GetRenderpass(VideoCore::PixelFormat color, VideoCore::PixelFormat depth,
+                                 bool clear_color, bool clear_depth);
+
 private:
+    /// Records the deferred image clears outside of a renderpass
+    void FlushClears();
+
+    /// Begins the renderpass, ending the active one unless it can be continued
+    void BeginPass(const RenderPass& new_pass);
+
     /// Creates a renderpass configured appropriately and stores it in cached_renderpasses
     vk::UniqueRenderPass CreateRenderPass(vk::Format color, vk::Format depth,
-                                          vk::AttachmentLoadOp load_op) const;
+                                          vk::AttachmentLoadOp color_load_op,
+                                          vk::AttachmentLoadOp depth_load_op) const;
 
 private:
     const Instance& instance;
     Scheduler& scheduler;
-    vk::UniqueRenderPass cached_renderpasses[MAX_COLOR_FORMATS + 1][MAX_DEPTH_FORMATS + 1][2];
+    vk::UniqueRenderPass cached_renderpasses[MAX_COLOR_FORMATS + 1][MAX_DEPTH_FORMATS + 1][2][2];
     std::mutex cache_mutex;
     std::array<vk::Image, 2> images;
     std::array<vk::ImageAspectFlags, 2> aspects;
+    std::array<vk::Image, 2> attachment_images;
+    boost::container::static_vector<ImageClear, 2> pending_clears;
     RenderPass pass{};
     u32 num_draws{};
 };
@@ -69,8 +69,10 @@ struct CommandPool::Pool {
     std::array<vk::CommandBuffer, COMMAND_BUFFER_POOL_SIZE> cmdbufs;
 };
 
-CommandPool::CommandPool(const Instance& instance, MasterSemaphore* master_semaphore)
-    : ResourcePool{master_semaphore, COMMAND_BUFFER_POOL_SIZE}, instance{instance} {}
+CommandPool::CommandPool(const Instance& instance, MasterSemaphore* master_semaphore,
+                         u32 queue_family_index_)
+    : ResourcePool{master_semaphore, COMMAND_BUFFER_POOL_SIZE}, instance{instance},
+      queue_family_index{queue_family_index_} {}
 
 CommandPool::~CommandPool() {
     vk::Device device = instance.GetDevice();
@@ -87,7 +89,7 @@ void CommandPool::Allocate(std::size_t begin, std::size_t end) {
     const vk::CommandPoolCreateInfo pool_create_info = {
         .flags = vk::CommandPoolCreateFlagBits::eTransient |
                  vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-        .queueFamilyIndex = instance.GetGraphicsQueueFamilyIndex(),
+        .queueFamilyIndex = queue_family_index,
     };
 
     vk::Device device = instance.GetDevice();
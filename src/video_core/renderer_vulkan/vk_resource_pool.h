@@ -51,7 +51,8 @@ protected:
 
 class CommandPool final : public ResourcePool {
 public:
-    explicit CommandPool(const Instance& instance, MasterSemaphore* master_semaphore);
+    explicit CommandPool(const Instance& instance, MasterSemaphore* master_semaphore,
+                         u32 queue_family_index);
     ~CommandPool() override;
 
     void Allocate(std::size_t begin, std::size_t end) override;
@@ -61,6 +62,7 @@ public:
 private:
     struct Pool;
     const Instance& instance;
+    u32 queue_family_index;
     std::vector<Pool> pools;
 };
 
@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <utility>
 #include "common/microprofile.h"
@@ -43,8 +46,31 @@ void Scheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf) {
 }
 
 Scheduler::Scheduler(const Instance& instance)
-    : master_semaphore{MakeMasterSemaphore(instance)},
-      command_pool{instance, master_semaphore.get()}, use_worker_thread{true} {
+    : instance{instance}, master_semaphore{MakeMasterSemaphore(instance)},
+      command_pool{instance, master_semaphore.get(), instance.GetGraphicsQueueFamilyIndex()},
+      use_worker_thread{true} {
+    if (instance.HasTransferQueue()) {
+        // Graphics submissions wait for the transfer batch they were recorded with, so transfer
+        // command buffers are free once the tick of that graphics submission is.
+        transfer_pool.emplace(instance, master_semaphore.get(),
+                              instance.GetTransferQueueFamilyIndex());
+        const vk::StructureChain semaphore_chain = {
+            vk::SemaphoreCreateInfo{},
+            vk::SemaphoreTypeCreateInfoKHR{
+                .semaphoreType = vk::SemaphoreType::eTimeline,
+                .initialValue = 0,
+            },
+        };
+        transfer_semaphore = instance.GetDevice().createSemaphoreUnique(semaphore_chain.get());
+    }
+    if (instance.IsTimestampSupported()) {
+        timestamp_pool = instance.GetDevice().createQueryPoolUnique({
+            .queryType = vk::QueryType::eTimestamp,
+            .queryCount = static_cast<u32>(TIMESTAMP_SLOTS * 2),
+        });
+    }
+    cmdbuf_tick = CurrentTick();
+    timed_tick = cmdbuf_tick;
     AllocateWorkerCommandBuffers();
     if (use_worker_thread) {
         AcquireNewChunk();
@@ -74,15 +100,13 @@ void Scheduler::WaitWorker() {
     MICROPROFILE_SCOPE(Vulkan_WaitForWorker);
     DispatchWork();
 
-    // Ensure the queue is drained.
-    {
-        std::unique_lock ql{queue_mutex};
-        event_cv.wait(ql, [this] { return work_queue.empty(); });
+    // Wait for the worker to execute every dispatched chunk.
+    const u64 dispatched = dispatched_chunks.load(std::memory_order::relaxed);
+    u64 executed = executed_chunks.load(std::memory_order::acquire);
+    while (executed < dispatched) {
+        executed_chunks.wait(executed, std::memory_order::acquire);
+        executed = executed_chunks.load(std::memory_order::acquire);
     }
-
-    // Now wait for execution to finish.
-    // This needs to be done in the same order as WorkerThread.
-    std::scoped_lock el{execution_mutex};
 }
 
 void Scheduler::Wait(u64 tick) {
@@ -98,65 +122,49 @@ void Scheduler::DispatchWork() {
         return;
     }
 
-    {
-        std::scoped_lock ql{queue_mutex};
-        work_queue.push(std::move(chunk));
-    }
+    // At most MAX_CHUNKS exist and the current one is not queued, so there is always room.
+    const std::size_t pushed = work_queue.Push(&chunk, 1);
+    ASSERT(pushed == 1);
 
-    event_cv.notify_all();
+    dispatched_chunks.fetch_add(1, std::memory_order::release);
+    dispatched_chunks.notify_one();
     AcquireNewChunk();
 }
 
 void Scheduler::WorkerThread(std::stop_token stop_token) {
     Common::SetCurrentThreadName("VulkanWorker");
 
-    const auto TryPopQueue{[this](auto& work) -> bool {
-        if (work_queue.empty()) {
-            return false;
-        }
-
-        work = std::move(work_queue.front());
-        work_queue.pop();
-        event_cv.notify_all();
-        return true;
-    }};
+    // Wake the worker up when asked to stop, the counter is not used after that.
+    const auto wake_up = [this] {
+        dispatched_chunks.fetch_add(1);
+        dispatched_chunks.notify_one();
+    };
+    const std::stop_callback stop_wake{stop_token, wake_up};
 
+    u64 executed = 0;
     while (!stop_token.stop_requested()) {
-        std::unique_ptr<CommandChunk> work;
-
-        {
-            std::unique_lock lk{queue_mutex};
-
+        CommandChunk* work{};
+        if (work_queue.Pop(&work, 1) == 0) {
             // Wait for work.
-            Common::CondvarWait(event_cv, lk, stop_token, [&] { return TryPopQueue(work); });
-
-            // If we've been asked to stop, we're done.
-            if (stop_token.stop_requested()) {
-                return;
-            }
-
-            // Exchange lock ownership so that we take the execution lock before
-            // the queue lock goes out of scope. This allows us to force execution
-            // to complete in the next step.
-            std::exchange(lk, std::unique_lock{execution_mutex});
-
-            // Perform the work, tracking whether the chunk was a submission
-            // before executing.
-            const bool has_submit = work->HasSubmit();
-            work->ExecuteAll(current_cmdbuf);
-
-            // If the chunk was a submission, reallocate the command buffer.
-            if (has_submit) {
-                AllocateWorkerCommandBuffers();
-            }
+            dispatched_chunks.wait(executed, std::memory_order::acquire);
+            continue;
         }
 
-        {
-            std::scoped_lock rl{reserve_mutex};
+        // Perform the work, tracking whether the chunk was a submission
+        // before executing.
+        const bool has_submit = work->HasSubmit();
+        work->ExecuteAll(current_cmdbuf);
 
-            // Recycle the chunk back to the reserve.
-            chunk_reserve.emplace_back(std::move(work));
+        // If the chunk was a submission, reallocate the command buffer.
+        if (has_submit) {
+            AllocateWorkerCommandBuffers();
         }
+
+        // Recycle the chunk back to the reserve before publishing its execution,
+        // so that waiting for the counter to change always finds it there.
+        chunk_reserve.Push(&work, 1);
+        executed_chunks.store(++executed, std::memory_order::release);
+        executed_chunks.notify_all();
     }
 }
 
@@ -167,16 +175,191 @@ void Scheduler::AllocateWorkerCommandBuffers() {
 
     current_cmdbuf = command_pool.Commit();
     current_cmdbuf.begin(begin_info);
+
+    if (timestamp_pool) {
+        const u32 query = static_cast<u32>(cmdbuf_tick % TIMESTAMP_SLOTS) * 2;
+        current_cmdbuf.resetQueryPool(*timestamp_pool, query, 2);
+        current_cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *timestamp_pool,
+                                      query);
+    }
+}
+
+vk::CommandBuffer Scheduler::TransferCommandBuffer() {
+    ASSERT(transfer_pool);
+    if (!transfer_cmdbuf) {
+        transfer_cmdbuf = transfer_pool->Commit();
+        transfer_cmdbuf.begin({
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+        });
+    }
+    return transfer_cmdbuf;
+}
+
+void Scheduler::InitTransferImage(vk::Image image, vk::ImageAspectFlags aspect) {
+    const vk::ImageSubresourceRange range = {
+        .aspectMask = aspect,
+        .baseMipLevel = 0,
+        .levelCount = VK_REMAINING_MIP_LEVELS,
+        .baseArrayLayer = 0,
+        .layerCount = VK_REMAINING_ARRAY_LAYERS,
+    };
+    const vk::ImageMemoryBarrier init_barrier = {
+        .srcAccessMask = vk::AccessFlagBits::eNone,
+        .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eGeneral,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = range,
+    };
+    TransferCommandBuffer().pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                            vk::PipelineStageFlagBits::eTransfer,
+                                            vk::DependencyFlagBits::eByRegion, {}, {},
+                                            init_barrier);
+
+    // The release is recorded at the end of the batch, the acquire executes after the graphics
+    // submission has waited for it, wherever it is recorded within that submission.
+    const vk::ImageMemoryBarrier release_barrier = {
+        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = vk::AccessFlagBits::eNone,
+        .oldLayout = vk::ImageLayout::eGeneral,
+        .newLayout = vk::ImageLayout::eGeneral,
+        .srcQueueFamilyIndex = instance.GetTransferQueueFamilyIndex(),
+        .dstQueueFamilyIndex = instance.GetGraphicsQueueFamilyIndex(),
+        .image = image,
+        .subresourceRange = range,
+    };
+    transfer_releases.push_back(release_barrier);
+
+    vk::ImageMemoryBarrier acquire_barrier = release_barrier;
+    acquire_barrier.srcAccessMask = vk::AccessFlagBits::eNone;
+    acquire_barrier.dstAccessMask =
+        vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
+    Record([acquire_barrier](vk::CommandBuffer cmdbuf) {
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                               vk::PipelineStageFlagBits::eAllCommands,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, acquire_barrier);
+    });
+}
+
+void Scheduler::UploadTransferImage(vk::Image image, vk::ImageAspectFlags aspect,
+                                    vk::Buffer buffer, const vk::BufferImageCopy& copy) {
+    // Copies to the same level may overlap, so the earlier ones are recorded first and the
+    // transitions between them order the writes.
+    const u32 level = copy.imageSubresource.mipLevel;
+    if (std::ranges::any_of(transfer_uploads, [&](const TransferUpload& upload) {
+            return upload.image == image && upload.copy.imageSubresource.mipLevel == level;
+        })) {
+        FlushTransferUploads();
+    }
+    transfer_uploads.push_back({image, aspect, buffer, copy});
+}
+
+void Scheduler::FlushTransferUploads() {
+    if (transfer_uploads.empty()) {
+        return;
+    }
+
+    transfer_barriers.clear();
+    for (const TransferUpload& upload : transfer_uploads) {
+        transfer_barriers.push_back({
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = upload.image,
+            .subresourceRange{
+                .aspectMask = upload.aspect,
+                .baseMipLevel = upload.copy.imageSubresource.mipLevel,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            },
+        });
+    }
+
+    const vk::CommandBuffer cmdbuf = TransferCommandBuffer();
+    cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                           vk::PipelineStageFlagBits::eTransfer,
+                           vk::DependencyFlagBits::eByRegion, {}, {}, transfer_barriers);
+    for (const TransferUpload& upload : transfer_uploads) {
+        cmdbuf.copyBufferToImage(upload.buffer, upload.image,
+                                 vk::ImageLayout::eTransferDstOptimal, upload.copy);
+    }
+    for (vk::ImageMemoryBarrier& barrier : transfer_barriers) {
+        std::swap(barrier.oldLayout, barrier.newLayout);
+    }
+    cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                           vk::PipelineStageFlagBits::eTransfer,
+                           vk::DependencyFlagBits::eByRegion, {}, {}, transfer_barriers);
+    transfer_uploads.clear();
+}
+
+u64 Scheduler::SubmitTransfer() {
+    FlushTransferUploads();
+    if (!transfer_cmdbuf) {
+        return 0;
+    }
+
+    MICROPROFILE_SCOPE(Vulkan_Submit);
+    if (!transfer_releases.empty()) {
+        transfer_cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                        vk::PipelineStageFlagBits::eBottomOfPipe,
+                                        vk::DependencyFlagBits::eByRegion, {}, {},
+                                        transfer_releases);
+        transfer_releases.clear();
+    }
+    transfer_cmdbuf.end();
+
+    const u64 signal_value = transfer_batch;
+    const vk::TimelineSemaphoreSubmitInfoKHR timeline_si = {
+        .signalSemaphoreValueCount = 1u,
+        .pSignalSemaphoreValues = &signal_value,
+    };
+    const vk::SubmitInfo submit_info = {
+        .pNext = &timeline_si,
+        .commandBufferCount = 1u,
+        .pCommandBuffers = &transfer_cmdbuf,
+        .signalSemaphoreCount = 1u,
+        .pSignalSemaphores = &transfer_semaphore.get(),
+    };
+
+    try {
+        instance.GetTransferQueue().submit(submit_info);
+    } catch (vk::DeviceLostError& err) {
+        LOG_CRITICAL(Render_Vulkan, "Device lost during transfer submit: {}", err.what());
+        UNREACHABLE();
+    }
+
+    transfer_cmdbuf = nullptr;
+    return signal_value;
 }
 
 void Scheduler::SubmitExecution(vk::Semaphore signal_semaphore, vk::Semaphore wait_semaphore) {
     state = StateFlags::AllDirty;
     const u64 signal_value = master_semaphore->NextTick();
 
-    Record([signal_semaphore, wait_semaphore, signal_value, this](vk::CommandBuffer cmdbuf) {
+    // The transfer batch is submitted right away, before the worker submits the graphics work
+    // that waits on it. Surfaces initialized on the transfer queue leave it with this batch.
+    const u64 transfer_value = SubmitTransfer();
+    const vk::Semaphore transfer_wait = transfer_value ? *transfer_semaphore : vk::Semaphore{};
+    transfer_batch++;
+
+    Record([signal_semaphore, wait_semaphore, signal_value, transfer_wait, transfer_value,
+            this](vk::CommandBuffer cmdbuf) {
         MICROPROFILE_SCOPE(Vulkan_Submit);
+        if (timestamp_pool) {
+            const u32 query = static_cast<u32>(signal_value % TIMESTAMP_SLOTS) * 2 + 1;
+            cmdbuf.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *timestamp_pool,
+                                  query);
+        }
+        cmdbuf_tick = signal_value + 1;
         std::scoped_lock lock{submit_mutex};
-        master_semaphore->SubmitWork(cmdbuf, wait_semaphore, signal_semaphore, signal_value);
+        master_semaphore->SubmitWork(cmdbuf, wait_semaphore, signal_semaphore, signal_value,
+                                     transfer_wait, transfer_value);
     });
 
     if (!use_worker_thread) {
@@ -187,15 +370,55 @@ void Scheduler::SubmitExecution(vk::Semaphore signal_semaphore, vk::Semaphore wa
     }
 }
 
+std::optional<std::chrono::nanoseconds> Scheduler::CollectGpuTime() {
+    if (!timestamp_pool) {
+        return std::nullopt;
+    }
+
+    // The queries of submissions that fell behind by a full ring of slots were reused
+    const u64 current_tick = CurrentTick();
+    if (current_tick > TIMESTAMP_SLOTS) {
+        timed_tick = std::max(timed_tick, current_tick - TIMESTAMP_SLOTS + 1);
+    }
+
+    const u32 valid_bits = instance.GetTimestampValidBits();
+    const u64 mask = valid_bits >= 64 ? ~u64{0} : (u64{1} << valid_bits) - 1;
+    const vk::Device device = instance.GetDevice();
+    u64 elapsed = 0;
+    master_semaphore->Refresh();
+    for (; timed_tick < current_tick && IsFree(timed_tick); timed_tick++) {
+        const u32 query = static_cast<u32>(timed_tick % TIMESTAMP_SLOTS) * 2;
+        std::array<u64, 2> timestamps{};
+        const vk::Result result = device.getQueryPoolResults(
+            *timestamp_pool, query, 2, sizeof(timestamps), timestamps.data(), sizeof(u64),
+            vk::QueryResultFlagBits::e64);
+        if (result == vk::Result::eSuccess) {
+            elapsed += (timestamps[1] - timestamps[0]) & mask;
+        }
+    }
+    return std::chrono::nanoseconds{
+        static_cast<s64>(static_cast<double>(elapsed) * instance.GetTimestampPeriod())};
+}
+
 void Scheduler::AcquireNewChunk() {
-    std::scoped_lock lock{reserve_mutex};
-    if (chunk_reserve.empty()) {
-        chunk = std::make_unique<CommandChunk>();
+    if (chunk_reserve.Pop(&chunk, 1) == 1) {
+        return;
+    }
+
+    if (chunks.size() < MAX_CHUNKS) {
+        chunk = chunks.emplace_back(std::make_unique<CommandChunk>()).get();
         return;
     }
 
-    chunk = std::move(chunk_reserve.back());
-    chunk_reserve.pop_back();
+    // Every chunk is waiting for the worker, take the first one it recycles.
+    MICROPROFILE_SCOPE(Vulkan_WaitForWorker);
+    while (true) {
+        const u64 executed = executed_chunks.load(std::memory_order::acquire);
+        if (chunk_reserve.Pop(&chunk, 1) == 1) {
+            return;
+        }
+        executed_chunks.wait(executed, std::memory_order::acquire);
+    }
 }
 
 } // namespace Vulkan
@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 #include "common/alignment.h"
 #include "common/common_funcs.h"
 #include "common/polyfill_thread.h"
+#include "common/ring_buffer.h"
 #include "video_core/renderer_vulkan/vk_master_semaphore.h"
 #include "video_core/renderer_vulkan/vk_resource_pool.h"
 
@@ -91,6 +95,36 @@ public:
         return master_semaphore.get();
     }
 
+    /// Returns true when uploads can be recorded to the dedicated transfer queue.
+    [[nodiscard]] bool HasTransferQueue() const noexcept {
+        return transfer_pool.has_value();
+    }
+
+    /// Returns the transfer batch that is submitted along with the next graphics submission.
+    [[nodiscard]] u64 TransferBatch() const noexcept {
+        return transfer_batch;
+    }
+
+    /// Returns the command buffer of the current transfer batch. It is recorded directly by
+    /// the calling thread and submitted before the graphics work of the batch, which waits on it.
+    [[nodiscard]] vk::CommandBuffer TransferCommandBuffer();
+
+    /// Initializes a freshly allocated image on the transfer queue. Ownership of the image is
+    /// released to the graphics queue when the transfer batch ends, so it may only be written
+    /// by the transfer queue until then.
+    void InitTransferImage(vk::Image image, vk::ImageAspectFlags aspect);
+
+    /// Queues a buffer to image copy on the transfer queue for an image initialized there.
+    /// Queued copies are recorded together, between one batch of layout transitions, when the
+    /// transfer batch is submitted.
+    void UploadTransferImage(vk::Image image, vk::ImageAspectFlags aspect, vk::Buffer buffer,
+                             const vk::BufferImageCopy& copy);
+
+    /// Returns the time the GPU spent executing the submissions that completed since the last
+    /// call, measured with timestamps at both ends of their command buffers. Returns nullopt if
+    /// the device cannot write timestamps.
+    [[nodiscard]] std::optional<std::chrono::nanoseconds> CollectGpuTime();
+
     std::mutex submit_mutex;
 
 private:
@@ -177,27 +211,57 @@ private:
         alignas(std::max_align_t) std::array<u8, 0x8000> data{};
     };
 
+    struct TransferUpload {
+        vk::Image image;
+        vk::ImageAspectFlags aspect;
+        vk::Buffer buffer;
+        vk::BufferImageCopy copy;
+    };
+
 private:
+    /// Maximum number of chunks, recorded or waiting for the worker, before recording waits
+    static constexpr std::size_t MAX_CHUNKS = 64;
+
+    /// Number of submissions whose timestamps are kept, the queries of a submission are reused by
+    /// the one this many ticks after it
+    static constexpr u64 TIMESTAMP_SLOTS = 256;
+
     void WorkerThread(std::stop_token stop_token);
 
     void AllocateWorkerCommandBuffers();
 
     void SubmitExecution(vk::Semaphore signal_semaphore, vk::Semaphore wait_semaphore);
 
+    /// Records the queued transfer uploads to the transfer command buffer.
+    void FlushTransferUploads();
+
+    /// Submits the recorded transfer batch, returning the value it signals or zero when empty.
+    u64 SubmitTransfer();
+
     void AcquireNewChunk();
 
 private:
+    const Instance& instance;
     std::unique_ptr<MasterSemaphore> master_semaphore;
     CommandPool command_pool;
-    std::unique_ptr<CommandChunk> chunk;
-    std::queue<std::unique_ptr<CommandChunk>> work_queue;
-    std::vector<std::unique_ptr<CommandChunk>> chunk_reserve;
+    std::optional<CommandPool> transfer_pool;
+    vk::UniqueSemaphore transfer_semaphore;
+    vk::CommandBuffer transfer_cmdbuf;
+    std::vector<vk::ImageMemoryBarrier> transfer_releases;
+    std::vector<TransferUpload> transfer_uploads;
+    std::vector<vk::ImageMemoryBarrier> transfer_barriers;
+    u64 transfer_batch{1};
+    vk::UniqueQueryPool timestamp_pool;
+    u64 cmdbuf_tick{}; ///< Tick of the command buffer being recorded, owned by the worker
+    u64 timed_tick{};  ///< First tick whose GPU time was not collected
+    std::vector<std::unique_ptr<CommandChunk>> chunks;
+    CommandChunk* chunk{};
+    Common::RingBuffer<CommandChunk*, MAX_CHUNKS> work_queue;
+    Common::RingBuffer<CommandChunk*, MAX_CHUNKS> chunk_reserve;
+    std::atomic<u64> dispatched_chunks{};
+    std::atomic<u64> executed_chunks{};
     vk::CommandBuffer current_cmdbuf;
     StateFlags state{};
-    std::mutex execution_mutex;
-    std::mutex reserve_mutex;
-    std::mutex queue_mutex;
-    std::condition_variable_any event_cv;
     std::jthread worker_thread;
     bool use_worker_thread;
 };
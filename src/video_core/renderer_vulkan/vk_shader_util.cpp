@@ -160,6 +160,15 @@ bool InitializeCompiler() {
 
 vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
                          std::string_view premable) {
+    const std::vector<u32> spv = CompileToSPV(code, stage, premable);
+    if (spv.empty()) {
+        return {};
+    }
+    return CompileSPV(spv, device);
+}
+
+std::vector<u32> CompileToSPV(std::string_view code, vk::ShaderStageFlagBits stage,
+                              std::string_view premable) {
     if (!InitializeCompiler()) {
         return {};
     }
@@ -214,7 +223,7 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
         LOG_INFO(Render_Vulkan, "SPIR-V conversion messages: {}", spv_messages);
     }
 
-    return CompileSPV(out_code, device);
+    return out_code;
 }
 
 vk::ShaderModule CompileSPV(std::span<const u32> code, vk::Device device) {
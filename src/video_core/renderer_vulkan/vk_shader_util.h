@@ -5,6 +5,7 @@
 #pragma once
 
 #include <span>
+#include <vector>
 
 #include "video_core/renderer_vulkan/vk_common.h"
 
@@ -19,6 +20,15 @@ namespace Vulkan {
 vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, vk::Device device,
                          std::string_view premable = "");
 
+/**
+ * @brief Converts GLSL to SPIR-V using glslang.
+ * @param code The string containing GLSL code.
+ * @param stage The pipeline stage the shader will be used in.
+ * @return The SPIR-V bytecode, empty if the shader failed to compile.
+ */
+std::vector<u32> CompileToSPV(std::string_view code, vk::ShaderStageFlagBits stage,
+                              std::string_view premable = "");
+
 /**
  * @brief Creates a vulkan shader module from SPIR-V bytecode.
  * @param code The SPIR-V bytecode data.
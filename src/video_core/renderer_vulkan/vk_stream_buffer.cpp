@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include "common/alignment.h"
 #include "common/assert.h"
@@ -62,56 +63,49 @@ u32 GetMemoryType(const vk::PhysicalDeviceMemoryProperties& properties, BufferTy
     return preferred_type.value();
 }
 
-constexpr u64 WATCHES_INITIAL_RESERVE = 0x4000;
-constexpr u64 WATCHES_RESERVE_CHUNK = 0x1000;
-
 } // Anonymous namespace
 
 StreamBuffer::StreamBuffer(const Instance& instance_, Scheduler& scheduler_,
-                           vk::BufferUsageFlags usage_, u64 size, BufferType type_)
+                           vk::BufferUsageFlags usage_, u64 size, BufferType type_, u64 max_size)
     : instance{instance_}, scheduler{scheduler_}, device{instance.GetDevice()},
-      stream_buffer_size{size}, usage{usage_}, type{type_} {
+      stream_buffer_size{size}, usage{usage_}, type{type_}, ring{size, max_size} {
     CreateBuffers(size);
-    ReserveWatches(current_watches, WATCHES_INITIAL_RESERVE);
-    ReserveWatches(previous_watches, WATCHES_INITIAL_RESERVE);
+    ring.Reset(stream_buffer_size);
 }
 
 StreamBuffer::~StreamBuffer() {
-    device.unmapMemory(memory);
-    device.destroyBuffer(buffer);
-    device.freeMemory(memory);
+    const auto& stats = ring.GetStats();
+    LOG_INFO(Render_Vulkan,
+             "{} buffer of {} KiB wrapped {} times, stalled {} times for {} ms and grew {} times",
+             BufferTypeName(type), stream_buffer_size / 1024, stats.wraps, stats.stalls,
+             std::chrono::duration_cast<std::chrono::milliseconds>(stats.stall_time).count(),
+             stats.grows);
+
+    for (const RetiredBuffer& old : retired) {
+        DestroyBuffers(old.buffer, old.memory);
+    }
+    DestroyBuffers(buffer, memory);
 }
 
 std::tuple<u8*, u64, bool> StreamBuffer::Map(u64 size, u64 alignment) {
     if (!is_coherent && type == BufferType::Stream) {
         size = Common::AlignUp(size, instance.NonCoherentAtomSize());
     }
-
-    ASSERT(size <= stream_buffer_size);
     mapped_size = size;
 
-    if (alignment > 0) {
-        offset = Common::AlignUp(offset, alignment);
-    }
+    ReleaseRetired();
 
-    bool invalidate{false};
-    if (offset + size > stream_buffer_size) {
-        // The buffer would overflow, save the amount of used watches and reset the state.
-        invalidate = true;
-        invalidation_mark = current_watch_cursor;
-        current_watch_cursor = 0;
-        offset = 0;
-
-        // Swap watches and reset waiting cursors.
-        std::swap(previous_watches, current_watches);
-        wait_cursor = 0;
-        wait_bound = 0;
+    const auto is_signaled = [this](u64 tick) { return scheduler.IsFree(tick); };
+    const auto wait = [this](u64 tick) { scheduler.Wait(tick); };
+    auto reservation = ring.Reserve(size, alignment, is_signaled, wait);
+    if (reservation.grow) {
+        Grow(ring.GrowSize());
+        reservation = ring.Reserve(size, alignment, is_signaled, wait);
+        reservation.invalidate = true;
     }
 
-    const u64 mapped_upper_bound = offset + size;
-    WaitPendingOperations(mapped_upper_bound);
-
-    return std::make_tuple(mapped + offset, offset, invalidate);
+    offset = reservation.offset;
+    return std::make_tuple(mapped + offset, offset, reservation.invalidate);
 }
 
 void StreamBuffer::Commit(u64 size) {
@@ -135,14 +129,7 @@ void StreamBuffer::Commit(u64 size) {
     }
 
     offset += size;
-
-    if (current_watch_cursor + 1 >= current_watches.size()) {
-        // Ensure that there are enough watches.
-        ReserveWatches(current_watches, WATCHES_RESERVE_CHUNK);
-    }
-    auto& watch = current_watches[current_watch_cursor++];
-    watch.upper_bound = offset;
-    watch.tick = scheduler.CurrentTick();
+    ring.Commit(size, scheduler.CurrentTick());
 }
 
 void StreamBuffer::CreateBuffers(u64 prefered_size) {
@@ -158,9 +145,17 @@ void StreamBuffer::CreateBuffers(u64 prefered_size) {
     const vk::DeviceSize heap_size = memory_properties.memoryHeaps[preferred_heap].size;
     // As per DXVK's example, using `heap_size / 2`
     const vk::DeviceSize allocable_size = heap_size / 2;
+
+    // Texture uploads may be read by the transfer queue as well as the graphics queue
+    const std::array queue_family_indices = {instance.GetGraphicsQueueFamilyIndex(),
+                                             instance.GetTransferQueueFamilyIndex()};
+    const bool is_shared = type == BufferType::Upload && instance.HasTransferQueue();
     buffer = device.createBuffer({
         .size = std::min(prefered_size, allocable_size),
         .usage = usage,
+        .sharingMode = is_shared ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+        .queueFamilyIndexCount = is_shared ? static_cast<u32>(queue_family_indices.size()) : 0U,
+        .pQueueFamilyIndices = queue_family_indices.data(),
     });
 
     const auto requirements_chain =
@@ -208,20 +203,27 @@ void StreamBuffer::CreateBuffers(u64 prefered_size) {
     }
 }
 
-void StreamBuffer::ReserveWatches(std::vector<Watch>& watches, std::size_t grow_size) {
-    watches.resize(watches.size() + grow_size);
+void StreamBuffer::DestroyBuffers(vk::Buffer old_buffer, vk::DeviceMemory old_memory) {
+    device.unmapMemory(old_memory);
+    device.destroyBuffer(old_buffer);
+    device.freeMemory(old_memory);
 }
 
-void StreamBuffer::WaitPendingOperations(u64 requested_upper_bound) {
-    if (!invalidation_mark) {
-        return;
-    }
-    while (requested_upper_bound > wait_bound && wait_cursor < *invalidation_mark) {
-        auto& watch = previous_watches[wait_cursor];
-        wait_bound = watch.upper_bound;
-        scheduler.Wait(watch.tick);
-        ++wait_cursor;
-    }
+void StreamBuffer::Grow(u64 new_size) {
+    // Commands referencing the old buffer may still be recorded in the current tick
+    retired.push_back({buffer, memory, scheduler.CurrentTick()});
+    CreateBuffers(new_size);
+    ring.Reset(stream_buffer_size);
+}
+
+void StreamBuffer::ReleaseRetired() {
+    std::erase_if(retired, [this](const RetiredBuffer& old) {
+        if (!scheduler.IsFree(old.tick)) {
+            return false;
+        }
+        DestroyBuffers(old.buffer, old.memory);
+        return true;
+    });
 }
 
 } // namespace Vulkan
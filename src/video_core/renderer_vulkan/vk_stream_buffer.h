@@ -4,11 +4,11 @@
 
 #pragma once
 
-#include <optional>
 #include <span>
 #include <tuple>
 #include <vector>
 #include "video_core/renderer_vulkan/vk_common.h"
+#include "video_core/stream_ring.h"
 
 namespace Vulkan {
 
@@ -25,9 +25,13 @@ class StreamBuffer final {
     static constexpr std::size_t MAX_BUFFER_VIEWS = 3;
 
 public:
+    /**
+     * @param max_size Size the buffer may grow to instead of waiting for the GPU. Growing replaces
+     *                 the buffer handle, so it is only allowed when Handle() is queried per use.
+     */
     explicit StreamBuffer(const Instance& instance, Scheduler& scheduler,
                           vk::BufferUsageFlags usage, u64 size,
-                          BufferType type = BufferType::Stream);
+                          BufferType type = BufferType::Stream, u64 max_size = 0);
     ~StreamBuffer();
 
     /**
@@ -44,19 +48,29 @@ public:
         return buffer;
     }
 
+    /// Returns the wait and growth statistics of the buffer
+    const VideoCore::StreamRing::Stats& GetStats() const noexcept {
+        return ring.GetStats();
+    }
+
 private:
-    struct Watch {
-        u64 tick{};
-        u64 upper_bound{};
+    struct RetiredBuffer {
+        vk::Buffer buffer;
+        vk::DeviceMemory memory;
+        u64 tick;
     };
 
     /// Creates Vulkan buffer handles committing the required the required memory.
     void CreateBuffers(u64 prefered_size);
 
-    /// Increases the amount of watches available.
-    void ReserveWatches(std::vector<Watch>& watches, std::size_t grow_size);
+    /// Unmaps and destroys the current buffer and its memory.
+    void DestroyBuffers(vk::Buffer buffer, vk::DeviceMemory memory);
+
+    /// Replaces the buffer with a larger one, keeping the old one alive until the GPU is done.
+    void Grow(u64 new_size);
 
-    void WaitPendingOperations(u64 requested_upper_bound);
+    /// Destroys the replaced buffers the GPU is done with.
+    void ReleaseRetired();
 
 private:
     const Instance& instance; ///< Vulkan instance.
@@ -74,13 +88,8 @@ private:
     u64 mapped_size{};  ///< Size reserved for the current copy.
     bool is_coherent{}; ///< True if the buffer is coherent
 
-    std::vector<Watch> current_watches;           ///< Watches recorded in the current iteration.
-    std::size_t current_watch_cursor{};           ///< Count of watches, reset on invalidation.
-    std::optional<std::size_t> invalidation_mark; ///< Number of watches used in the previous cycle.
-
-    std::vector<Watch> previous_watches; ///< Watches used in the previous iteration.
-    std::size_t wait_cursor{};           ///< Last watch being waited for completion.
-    u64 wait_bound{};                    ///< Highest offset being watched for completion.
+    VideoCore::StreamRing ring;         ///< Tracks the ranges the GPU may still read.
+    std::vector<RetiredBuffer> retired; ///< Buffers replaced by growing.
 };
 
 } // namespace Vulkan
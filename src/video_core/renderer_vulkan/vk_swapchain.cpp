@@ -8,6 +8,7 @@
 #include "common/microprofile.h"
 #include "common/settings.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_swapchain.h"
 
 MICROPROFILE_DEFINE(Vulkan_Acquire, "Vulkan", "Swapchain Acquire", MP_RGB(185, 66, 245));
@@ -15,8 +16,9 @@ MICROPROFILE_DEFINE(Vulkan_Present, "Vulkan", "Swapchain Present", MP_RGB(66, 18
 
 namespace Vulkan {
 
-Swapchain::Swapchain(const Instance& instance_, u32 width, u32 height, vk::SurfaceKHR surface_)
-    : instance{instance_}, surface{surface_} {
+Swapchain::Swapchain(const Instance& instance_, Scheduler& scheduler_, u32 width, u32 height,
+                     vk::SurfaceKHR surface_)
+    : instance{instance_}, scheduler{scheduler_}, surface{surface_} {
     FindPresentFormat();
     SetPresentMode();
     Create(width, height, surface);
@@ -24,17 +26,24 @@ Swapchain::Swapchain(const Instance& instance_, u32 width, u32 height, vk::Surfa
 
 Swapchain::~Swapchain() {
     Destroy();
+    for (const RetiredSwapchain& old : retired) {
+        instance.GetDevice().destroySwapchainKHR(old.swapchain);
+        for (const vk::Semaphore semaphore : old.semaphores) {
+            instance.GetDevice().destroySemaphore(semaphore);
+        }
+    }
     instance.GetInstance().destroySurfaceKHR(surface);
 }
 
 void Swapchain::Create(u32 width_, u32 height_, vk::SurfaceKHR surface_) {
+    // The old swapchain lets the driver reuse its resources, it must belong to the same surface
+    const vk::SwapchainKHR old_swapchain = surface == surface_ ? swapchain : vk::SwapchainKHR{};
     width = width_;
     height = height_;
     surface = surface_;
     needs_recreation = false;
 
-    Destroy();
-
+    ReleaseRetired();
     SetPresentMode();
     SetSurfaceProperties();
 
@@ -63,18 +72,26 @@ void Swapchain::Create(u32 width_, u32 height_, vk::SurfaceKHR surface_) {
         .compositeAlpha = composite_alpha,
         .presentMode = present_mode,
         .clipped = true,
-        .oldSwapchain = nullptr,
+        .oldSwapchain = old_swapchain,
     };
 
+    vk::SwapchainKHR new_swapchain{};
     try {
-        swapchain = instance.GetDevice().createSwapchainKHR(swapchain_info);
+        new_swapchain = instance.GetDevice().createSwapchainKHR(swapchain_info);
     } catch (vk::SystemError& err) {
         LOG_CRITICAL(Render_Vulkan, "{}", err.what());
         UNREACHABLE();
     }
 
+    Retire();
+    swapchain = new_swapchain;
+    frame_index = 0;
+
     SetupImages();
     RefreshSemaphores();
+
+    // Present ids keep increasing across swapchains, ids below this one belong to destroyed ones
+    first_present_id = present_id + 1;
 }
 
 bool Swapchain::AcquireNextImage() {
@@ -101,12 +118,20 @@ bool Swapchain::AcquireNextImage() {
     return !needs_recreation;
 }
 
-void Swapchain::Present() {
+u64 Swapchain::Present() {
     if (needs_recreation) {
-        return;
+        return 0;
     }
 
+    const bool use_present_id = instance.IsPresentWaitSupported();
+    const u64 current_present_id = use_present_id ? ++present_id : 0;
+    const vk::PresentIdKHR present_id_info = {
+        .swapchainCount = 1,
+        .pPresentIds = &current_present_id,
+    };
+
     const vk::PresentInfoKHR present_info = {
+        .pNext = use_present_id ? &present_id_info : nullptr,
         .waitSemaphoreCount = 1,
         .pWaitSemaphores = &present_ready[image_index],
         .swapchainCount = 1,
@@ -125,6 +150,26 @@ void Swapchain::Present() {
     }
 
     frame_index = (frame_index + 1) % image_count;
+    if (!retired.empty()) {
+        ReleaseRetired();
+    }
+    return needs_recreation ? 0 : current_present_id;
+}
+
+bool Swapchain::WaitForPresent(u64 wait_present_id, u64 timeout) {
+    if (wait_present_id < first_present_id || needs_recreation) {
+        return true;
+    }
+    try {
+        const vk::Result result =
+            instance.GetDevice().waitForPresentKHR(swapchain, wait_present_id, timeout);
+        return result != vk::Result::eTimeout;
+    } catch (vk::OutOfDateKHRError&) {
+        needs_recreation = true;
+    } catch (vk::SurfaceLostKHRError&) {
+        needs_recreation = true;
+    }
+    return true;
 }
 
 void Swapchain::FindPresentFormat() {
@@ -223,6 +268,36 @@ void Swapchain::SetSurfaceProperties() {
     }
 }
 
+void Swapchain::Retire() {
+    if (!swapchain) {
+        return;
+    }
+
+    // Frames submitted so far may still wait on the semaphores or copy to the images, they are
+    // all complete once the current tick is
+    RetiredSwapchain& old = retired.emplace_back();
+    old.swapchain = std::exchange(swapchain, vk::SwapchainKHR{});
+    old.semaphores = std::move(image_acquired);
+    old.semaphores.insert(old.semaphores.end(), present_ready.begin(), present_ready.end());
+    old.tick = scheduler.CurrentTick();
+    image_acquired.clear();
+    present_ready.clear();
+}
+
+void Swapchain::ReleaseRetired() {
+    const vk::Device device = instance.GetDevice();
+    std::erase_if(retired, [&](const RetiredSwapchain& old) {
+        if (!scheduler.IsFree(old.tick)) {
+            return false;
+        }
+        device.destroySwapchainKHR(old.swapchain);
+        for (const vk::Semaphore semaphore : old.semaphores) {
+            device.destroySemaphore(semaphore);
+        }
+        return true;
+    });
+}
+
 void Swapchain::Destroy() {
     vk::Device device = instance.GetDevice();
     if (swapchain) {
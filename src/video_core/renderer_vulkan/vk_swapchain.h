@@ -16,17 +16,32 @@ class Scheduler;
 
 class Swapchain {
 public:
-    explicit Swapchain(const Instance& instance, u32 width, u32 height, vk::SurfaceKHR surface);
+    explicit Swapchain(const Instance& instance, Scheduler& scheduler, u32 width, u32 height,
+                       vk::SurfaceKHR surface);
     ~Swapchain();
 
-    /// Creates (or recreates) the swapchain with a given size.
+    /**
+     * Creates (or recreates) the swapchain with a given size. The previous swapchain is handed
+     * to the driver as the old one and destroyed once the GPU is done with the submissions
+     * recorded so far.
+     */
     void Create(u32 width, u32 height, vk::SurfaceKHR surface);
 
+    /// Destroys the replaced swapchains the GPU is done with
+    void ReleaseRetired();
+
     /// Acquires the next image in the swapchain.
     bool AcquireNextImage();
 
-    /// Presents the current image and move to the next one
-    void Present();
+    /// Presents the current image and move to the next one.
+    /// Returns the present id of the image, zero when it cannot be waited on.
+    u64 Present();
+
+    /**
+     * Waits until the image presented with present_id is shown on the display.
+     * Returns false if it is still queued after timeout nanoseconds.
+     */
+    bool WaitForPresent(u64 present_id, u64 timeout);
 
     vk::SurfaceKHR GetSurface() const {
         return surface;
@@ -36,6 +51,10 @@ public:
         return images[image_index];
     }
 
+    u32 ImageIndex() const {
+        return image_index;
+    }
+
     vk::SurfaceFormatKHR GetSurfaceFormat() const {
         return surface_format;
     }
@@ -81,6 +100,9 @@ private:
     /// Destroys current swapchain resources
     void Destroy();
 
+    /// Queues the current swapchain resources for destruction
+    void Retire();
+
     /// Performs creation of image views and framebuffers from the swapchain images
     void SetupImages();
 
@@ -88,7 +110,14 @@ private:
     void RefreshSemaphores();
 
 private:
+    struct RetiredSwapchain {
+        vk::SwapchainKHR swapchain;
+        std::vector<vk::Semaphore> semaphores;
+        u64 tick;
+    };
+
     const Instance& instance;
+    Scheduler& scheduler;
     vk::SwapchainKHR swapchain{};
     vk::SurfaceKHR surface{};
     vk::SurfaceFormatKHR surface_format;
@@ -99,11 +128,14 @@ private:
     std::vector<vk::Image> images;
     std::vector<vk::Semaphore> image_acquired;
     std::vector<vk::Semaphore> present_ready;
+    std::vector<RetiredSwapchain> retired;
     u32 width = 0;
     u32 height = 0;
     u32 image_count = 0;
     u32 image_index = 0;
     u32 frame_index = 0;
+    u64 present_id = 0;
+    u64 first_present_id = 1;
     bool needs_recreation = true;
 };
 
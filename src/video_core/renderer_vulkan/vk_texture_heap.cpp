@@ -0,0 +1,133 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/microprofile.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_texture_heap.h"
+
+namespace Vulkan {
+
+MICROPROFILE_DEFINE(Vulkan_TextureHeapWait, "Vulkan", "Texture Heap Wait", MP_RGB(192, 128, 64));
+
+TextureHeap::TextureHeap(const Instance& instance, Scheduler& scheduler_, u32 size)
+    : scheduler{scheduler_}, device{instance.GetDevice()}, slots(size) {
+    const vk::DescriptorPoolSize pool_size = {
+        .type = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = size,
+    };
+    descriptor_pool = device.createDescriptorPoolUnique({
+        .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT,
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &pool_size,
+    });
+
+    // Slots that are never written or whose image got destroyed are not sampled by any draw,
+    // which allows updating them while command buffers using the heap are pending.
+    const vk::DescriptorBindingFlagsEXT binding_flags =
+        vk::DescriptorBindingFlagBitsEXT::ePartiallyBound |
+        vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind |
+        vk::DescriptorBindingFlagBitsEXT::eUpdateUnusedWhilePending;
+    const vk::DescriptorSetLayoutBinding binding = {
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = size,
+        .stageFlags = vk::ShaderStageFlagBits::eFragment,
+    };
+    const vk::StructureChain layout_chain = {
+        vk::DescriptorSetLayoutCreateInfo{
+            .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT,
+            .bindingCount = 1,
+            .pBindings = &binding,
+        },
+        vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT{
+            .bindingCount = 1,
+            .pBindingFlags = &binding_flags,
+        },
+    };
+    layout = device.createDescriptorSetLayoutUnique(layout_chain.get());
+
+    const auto sets = device.allocateDescriptorSets({
+        .descriptorPool = *descriptor_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout.get(),
+    });
+    set = sets[0];
+}
+
+TextureHeap::~TextureHeap() = default;
+
+u32 TextureHeap::Acquire(vk::ImageView image_view, vk::Sampler sampler) {
+    const Key key{image_view, sampler};
+    const u64 tick = scheduler.CurrentTick();
+    if (const auto it = slot_map.find(key); it != slot_map.end()) {
+        slots[it->second].tick = tick;
+        return it->second;
+    }
+
+    const u32 index = FindFreeSlot();
+    slots[index] = Slot{
+        .key = key,
+        .tick = tick,
+        .resident = true,
+    };
+    slot_map.emplace(key, index);
+
+    const vk::DescriptorImageInfo image_info = {
+        .sampler = sampler,
+        .imageView = image_view,
+        .imageLayout = vk::ImageLayout::eGeneral,
+    };
+    device.updateDescriptorSets(
+        vk::WriteDescriptorSet{
+            .dstSet = set,
+            .dstBinding = 0,
+            .dstArrayElement = index,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            .pImageInfo = &image_info,
+        },
+        {});
+    return index;
+}
+
+void TextureHeap::FreeWithImage(vk::ImageView image_view) {
+    for (auto it = slot_map.begin(); it != slot_map.end();) {
+        if (it->first.image_view == image_view) {
+            slots[it->second].resident = false;
+            it = slot_map.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+u32 TextureHeap::FindFreeSlot() {
+    const u32 size = Size();
+    for (u32 i = 0; i < size; i++) {
+        const u32 index = clock_hand;
+        clock_hand = (clock_hand + 1) % size;
+        if (scheduler.IsFree(slots[index].tick)) {
+            if (slots[index].resident) {
+                slot_map.erase(slots[index].key);
+            }
+            return index;
+        }
+    }
+
+    // Every slot is sampled by pending work, wait for the one that was used the longest ago.
+    MICROPROFILE_SCOPE(Vulkan_TextureHeapWait);
+    const auto oldest = std::min_element(
+        slots.begin(), slots.end(), [](const Slot& a, const Slot& b) { return a.tick < b.tick; });
+    const u32 index = static_cast<u32>(std::distance(slots.begin(), oldest));
+    scheduler.Wait(oldest->tick);
+    if (oldest->resident) {
+        slot_map.erase(oldest->key);
+    }
+    return index;
+}
+
+} // namespace Vulkan
@@ -0,0 +1,80 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+#include <tsl/robin_map.h>
+
+#include "common/hash.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * A single update after bind descriptor set holding an array of combined image samplers.
+ * Textures stay resident in their slot while they are sampled, so binding a texture only changes
+ * the index the shader reads from push constants instead of binding another descriptor set.
+ */
+class TextureHeap {
+public:
+    explicit TextureHeap(const Instance& instance, Scheduler& scheduler, u32 size);
+    ~TextureHeap();
+
+    /// Returns the slot of the texture, writing it to the heap when it is not resident
+    u32 Acquire(vk::ImageView image_view, vk::Sampler sampler);
+
+    /// Evicts the textures of image_view, their slots are reused once the GPU is done with them
+    void FreeWithImage(vk::ImageView image_view);
+
+    [[nodiscard]] vk::DescriptorSetLayout Layout() const noexcept {
+        return *layout;
+    }
+
+    [[nodiscard]] vk::DescriptorSet Set() const noexcept {
+        return set;
+    }
+
+    [[nodiscard]] u32 Size() const noexcept {
+        return static_cast<u32>(slots.size());
+    }
+
+private:
+    struct Key {
+        vk::ImageView image_view;
+        vk::Sampler sampler;
+
+        bool operator==(const Key& other) const noexcept = default;
+    };
+
+    struct KeyHasher {
+        u64 operator()(const Key& key) const noexcept {
+            return Common::ComputeHash64(&key, sizeof(key));
+        }
+    };
+
+    struct Slot {
+        Key key{};
+        u64 tick{};
+        bool resident{};
+    };
+
+    /// Returns a slot the GPU is done with, evicting its texture or waiting for it if needed
+    u32 FindFreeSlot();
+
+private:
+    Scheduler& scheduler;
+    vk::Device device;
+    vk::UniqueDescriptorPool descriptor_pool;
+    vk::UniqueDescriptorSetLayout layout;
+    vk::DescriptorSet set;
+    std::vector<Slot> slots;
+    u32 clock_hand{};
+    tsl::robin_map<Key, u32, KeyHasher> slot_map;
+};
+
+} // namespace Vulkan
@@ -2,20 +2,24 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <limits>
 #include <boost/container/small_vector.hpp>
 #include <boost/container/static_vector.hpp>
 
 #include "common/literals.h"
 #include "common/microprofile.h"
-#include "common/scope_exit.h"
+#include "common/settings.h"
 #include "video_core/custom_textures/material.h"
+#include "video_core/gpu_profiler.h"
 #include "video_core/rasterizer_cache/texture_codec.h"
 #include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_vulkan/pica_to_vk.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_memory_util.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_texture_heap.h"
 #include "video_core/renderer_vulkan/vk_texture_runtime.h"
 
 #include <vk_mem_alloc.h>
@@ -143,11 +147,36 @@ boost::container::small_vector<vk::ImageMemoryBarrier, 3> MakeInitBarriers(
     return barriers;
 }
 
-Handle MakeHandle(const Instance* instance, u32 width, u32 height, u32 levels, TextureType type,
-                  vk::Format format, vk::ImageUsageFlags usage, vk::ImageCreateFlags flags,
-                  vk::ImageAspectFlags aspect, bool need_format_list,
-                  std::string_view debug_name = {}) {
-    const u32 layers = type == TextureType::CubeMap ? 6 : 1;
+HandleInfo MakeHandleInfo(u32 width, u32 height, u32 levels, TextureType type, vk::Format format,
+                          vk::ImageUsageFlags usage, vk::ImageCreateFlags flags,
+                          vk::ImageAspectFlags aspect) {
+    return HandleInfo{
+        .format = format,
+        .view_type =
+            type == TextureType::CubeMap ? vk::ImageViewType::eCube : vk::ImageViewType::e2D,
+        .usage = usage,
+        .flags = flags,
+        .aspect = aspect,
+        .width = width,
+        .height = height,
+        .levels = levels,
+    };
+}
+
+void SetHandleName(const Instance* instance, const Handle& handle, std::string_view debug_name) {
+    if (debug_name.empty() || !instance->HasDebuggingToolAttached()) {
+        return;
+    }
+    Vulkan::SetObjectName(instance->GetDevice(), handle.image, debug_name);
+    Vulkan::SetObjectName(instance->GetDevice(), handle.image_view.get(), "{} View({})",
+                          debug_name, vk::to_string(handle.info.aspect));
+}
+
+Handle MakeHandle(const Instance* instance, ImagePools& image_pools, const HandleInfo& info) {
+    const bool is_cube = info.view_type == vk::ImageViewType::eCube;
+    const u32 layers = is_cube ? 6 : 1;
+    const bool need_format_list = (info.flags & vk::ImageCreateFlagBits::eMutableFormat) &&
+                                  instance->IsImageFormatListSupported();
 
     const std::array format_list = {
         vk::Format::eR8G8B8A8Unorm,
@@ -160,31 +189,38 @@ Handle MakeHandle(const Instance* instance, u32 width, u32 height, u32 levels, T
 
     const vk::ImageCreateInfo image_info = {
         .pNext = need_format_list ? &image_format_list : nullptr,
-        .flags = flags,
+        .flags = info.flags,
         .imageType = vk::ImageType::e2D,
-        .format = format,
-        .extent = {width, height, 1},
-        .mipLevels = levels,
+        .format = info.format,
+        .extent = {info.width, info.height, 1},
+        .mipLevels = info.levels,
         .arrayLayers = layers,
         .samples = vk::SampleCountFlagBits::e1,
-        .usage = usage,
+        .usage = info.usage,
     };
 
-    const VmaAllocationCreateInfo alloc_info = {
+    VkImage unsafe_image{};
+    VkImageCreateInfo unsafe_image_info = static_cast<VkImageCreateInfo>(image_info);
+    VmaAllocation allocation{};
+
+    VmaAllocationCreateInfo alloc_info = {
         .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT,
         .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
         .requiredFlags = 0,
         .preferredFlags = 0,
-        .pool = VK_NULL_HANDLE,
+        .pool = image_pools.Get(unsafe_image_info),
         .pUserData = nullptr,
     };
 
-    VkImage unsafe_image{};
-    VkImageCreateInfo unsafe_image_info = static_cast<VkImageCreateInfo>(image_info);
-    VmaAllocation allocation{};
-
     VkResult result = vmaCreateImage(instance->GetAllocator(), &unsafe_image_info, &alloc_info,
                                      &unsafe_image, &allocation, nullptr);
+    if (result != VK_SUCCESS && alloc_info.pool) {
+        // The pool is bound to a single memory type, the default pools may still fall back to
+        // another heap when it is out of budget.
+        alloc_info.pool = VK_NULL_HANDLE;
+        result = vmaCreateImage(instance->GetAllocator(), &unsafe_image_info, &alloc_info,
+                                &unsafe_image, &allocation, nullptr);
+    }
     if (result != VK_SUCCESS) [[unlikely]] {
         LOG_CRITICAL(Render_Vulkan, "Failed allocating image with error {}", result);
         UNREACHABLE();
@@ -193,29 +229,22 @@ Handle MakeHandle(const Instance* instance, u32 width, u32 height, u32 levels, T
     const vk::Image image{unsafe_image};
     const vk::ImageViewCreateInfo view_info = {
         .image = image,
-        .viewType =
-            type == TextureType::CubeMap ? vk::ImageViewType::eCube : vk::ImageViewType::e2D,
-        .format = format,
+        .viewType = info.view_type,
+        .format = info.format,
         .subresourceRange{
-            .aspectMask = aspect,
+            .aspectMask = info.aspect,
             .baseMipLevel = 0,
-            .levelCount = levels,
+            .levelCount = info.levels,
             .baseArrayLayer = 0,
             .layerCount = layers,
         },
     };
-    vk::UniqueImageView image_view = instance->GetDevice().createImageViewUnique(view_info);
-
-    if (!debug_name.empty() && instance->HasDebuggingToolAttached()) {
-        Vulkan::SetObjectName(instance->GetDevice(), image, debug_name);
-        Vulkan::SetObjectName(instance->GetDevice(), image_view.get(), "{} View({})", debug_name,
-                              vk::to_string(aspect));
-    }
 
     return Handle{
         .alloc = allocation,
         .image = image,
-        .image_view = std::move(image_view),
+        .image_view = instance->GetDevice().createImageViewUnique(view_info),
+        .info = info,
     };
 }
 
@@ -243,22 +272,39 @@ vk::ImageSubresourceRange MakeSubresourceRange(vk::ImageAspectFlags aspect, u32
     };
 }
 
-constexpr u64 UPLOAD_BUFFER_SIZE = 512_MiB;
+// Staging buffers start small and double whenever reusing them would wait for the GPU
+constexpr u64 UPLOAD_BUFFER_SIZE = 64_MiB;
+constexpr u64 MAX_UPLOAD_BUFFER_SIZE = 512_MiB;
 constexpr u64 DOWNLOAD_BUFFER_SIZE = 16_MiB;
+constexpr u64 READBACK_BUFFER_SIZE = 16_MiB;
+constexpr u64 MAX_DOWNLOAD_BUFFER_SIZE = 64_MiB;
 
 } // Anonymous namespace
 
 TextureRuntime::TextureRuntime(const Instance& instance, Scheduler& scheduler,
                                RenderpassCache& renderpass_cache, DescriptorPool& pool,
-                               DescriptorSetProvider& texture_provider_, u32 num_swapchain_images_)
+                               DescriptorSetProvider& texture_provider_,
+                               TextureHeap* texture_heap_, u32 num_swapchain_images_,
+                               VideoCore::GpuProfiler& gpu_profiler_)
     : instance{instance}, scheduler{scheduler}, renderpass_cache{renderpass_cache},
-      texture_provider{texture_provider_}, blit_helper{instance, scheduler, pool, renderpass_cache},
-      upload_buffer{instance, scheduler, vk::BufferUsageFlagBits::eTransferSrc, UPLOAD_BUFFER_SIZE,
-                    BufferType::Upload},
+      texture_provider{texture_provider_}, texture_heap{texture_heap_}, gpu_profiler{gpu_profiler_},
+      blit_helper{instance, scheduler, pool, renderpass_cache, gpu_profiler},
+      upload_buffer{instance, scheduler,
+                    vk::BufferUsageFlagBits::eTransferSrc |
+                        vk::BufferUsageFlagBits::eStorageBuffer,
+                    UPLOAD_BUFFER_SIZE, BufferType::Upload, MAX_UPLOAD_BUFFER_SIZE},
       download_buffer{instance, scheduler,
                       vk::BufferUsageFlagBits::eTransferDst |
                           vk::BufferUsageFlagBits::eStorageBuffer,
-                      DOWNLOAD_BUFFER_SIZE, BufferType::Download},
+                      DOWNLOAD_BUFFER_SIZE, BufferType::Download, MAX_DOWNLOAD_BUFFER_SIZE},
+      readback_buffer{instance, scheduler, vk::BufferUsageFlagBits::eTransferDst,
+                      READBACK_BUFFER_SIZE, BufferType::Download, MAX_DOWNLOAD_BUFFER_SIZE},
+      image_pools{instance.GetAllocator()},
+      handle_pool{static_cast<u64>(Settings::values.surface_pool_size.GetValue()) << 20,
+                  [allocator = instance.GetAllocator()](Handle&& handle) {
+                      handle.image_view.reset();
+                      vmaDestroyImage(allocator, handle.image, handle.alloc);
+                  }},
       num_swapchain_images{num_swapchain_images_} {}
 
 TextureRuntime::~TextureRuntime() = default;
@@ -277,15 +323,43 @@ u32 TextureRuntime::RemoveThreshold() {
     return num_swapchain_images;
 }
 
+u64 TextureRuntime::GetMemoryBudget() const {
+    return GetDeviceLocalBudget(instance.GetAllocator());
+}
+
 void TextureRuntime::Finish() {
+    blit_helper.FlushFilters();
     scheduler.Finish();
 }
 
+void TextureRuntime::Flush() {
+    blit_helper.FlushFilters();
+    scheduler.Flush();
+}
+
+void TextureRuntime::FlushFilters() {
+    blit_helper.FlushFilters();
+}
+
+VideoCore::StagingData TextureRuntime::FindReadbackStaging(u32 size) {
+    const auto [data, offset, invalidate] = readback_buffer.Map(size, 16);
+    return VideoCore::StagingData{
+        .size = size,
+        .offset = static_cast<u32>(offset),
+        .mapped = std::span{data, size},
+    };
+}
+
+void TextureRuntime::WaitDownload(u64 tick) {
+    scheduler.Wait(tick);
+}
+
 bool TextureRuntime::Reinterpret(Surface& source, Surface& dest,
                                  const VideoCore::TextureCopy& copy) {
     const PixelFormat src_format = source.pixel_format;
     const PixelFormat dst_format = dest.pixel_format;
     ASSERT_MSG(src_format != dst_format, "Reinterpretation with the same format is invalid");
+    blit_helper.FlushFilters();
 
     if (!source.traits.needs_conversion && !dest.traits.needs_conversion &&
         source.type == dest.type) {
@@ -305,7 +379,7 @@ bool TextureRuntime::Reinterpret(Surface& source, Surface& dest,
 }
 
 bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClear& clear) {
-    renderpass_cache.EndRendering();
+    blit_helper.FlushFilters();
 
     const RecordParams params = {
         .aspect = surface.Aspect(),
@@ -314,7 +388,38 @@ bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClea
         .src_image = surface.Image(),
     };
 
-    if (clear.texture_rect == surface.GetScaledRect()) {
+    // Clears of the attachments of the active renderpass are recorded within it
+    const vk::Rect2D clear_rect = {
+        .offset{
+            .x = static_cast<s32>(clear.texture_rect.left),
+            .y = static_cast<s32>(clear.texture_rect.bottom),
+        },
+        .extent{
+            .width = clear.texture_rect.GetWidth(),
+            .height = clear.texture_rect.GetHeight(),
+        },
+    };
+    const vk::ClearValue clear_value = MakeClearValue(clear.value);
+    if (clear.texture_level == 0 &&
+        renderpass_cache.ClearAttachment(params.src_image, clear_rect, clear_value)) {
+        return true;
+    }
+
+    renderpass_cache.EndRendering();
+    const bool is_full_clear = clear.texture_rect == surface.GetScaledRect();
+    if (is_full_clear && clear.texture_level == 0) {
+        renderpass_cache.ClearImage(ImageClear{
+            .image = params.src_image,
+            .aspect = params.aspect,
+            .pipeline_flags = params.pipeline_flags,
+            .access = params.src_access,
+            .extent = {surface.GetScaledWidth(), surface.GetScaledHeight()},
+            .value = clear_value,
+        });
+        return true;
+    }
+
+    if (is_full_clear) {
         scheduler.Record([params, clear](vk::CommandBuffer cmdbuf) {
             const vk::ImageSubresourceRange range = {
                 .aspectMask = params.aspect,
@@ -454,6 +559,14 @@ void TextureRuntime::ClearTextureWithRenderpass(Surface& surface,
 
 bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureCopy& copy) {
+    return CopyTextures(source, dest, std::span{&copy, 1});
+}
+
+bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
+                                  std::span<const VideoCore::TextureCopy> copies) {
+    ASSERT(!copies.empty() && copies.size() <= VideoCore::MAX_PICA_LEVELS);
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Blit};
+    blit_helper.FlushFilters();
     renderpass_cache.EndRendering();
 
     const RecordParams params = {
@@ -466,8 +579,13 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
         .dst_image = dest.Image(),
     };
 
-    scheduler.Record([params, copy](vk::CommandBuffer cmdbuf) {
-        const vk::ImageCopy image_copy = {
+    boost::container::static_vector<vk::ImageCopy, VideoCore::MAX_PICA_LEVELS> image_copies;
+    u32 src_levels_begin = std::numeric_limits<u32>::max();
+    u32 src_levels_end = 0;
+    u32 dst_levels_begin = std::numeric_limits<u32>::max();
+    u32 dst_levels_end = 0;
+    for (const VideoCore::TextureCopy& copy : copies) {
+        image_copies.push_back(vk::ImageCopy{
             .srcSubresource{
                 .aspectMask = params.aspect,
                 .mipLevel = copy.src_level,
@@ -485,8 +603,20 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
             .dstOffset = {static_cast<s32>(copy.dst_offset.x), static_cast<s32>(copy.dst_offset.y),
                           0},
             .extent = {copy.extent.width, copy.extent.height, 1},
-        };
+        });
+        src_levels_begin = std::min(src_levels_begin, copy.src_level);
+        src_levels_end = std::max(src_levels_end, copy.src_level + 1);
+        dst_levels_begin = std::min(dst_levels_begin, copy.dst_level);
+        dst_levels_end = std::max(dst_levels_end, copy.dst_level + 1);
+    }
+
+    // All the copies share one pair of barriers over the levels they touch
+    const vk::ImageSubresourceRange src_range =
+        MakeSubresourceRange(params.aspect, src_levels_begin, src_levels_end - src_levels_begin);
+    const vk::ImageSubresourceRange dst_range =
+        MakeSubresourceRange(params.aspect, dst_levels_begin, dst_levels_end - dst_levels_begin);
 
+    scheduler.Record([params, image_copies, src_range, dst_range](vk::CommandBuffer cmdbuf) {
         const bool self_copy = params.src_image == params.dst_image;
         const vk::ImageLayout new_src_layout =
             self_copy ? vk::ImageLayout::eGeneral : vk::ImageLayout::eTransferSrcOptimal;
@@ -502,7 +632,7 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .image = params.src_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, copy.src_level),
+                .subresourceRange = src_range,
             },
             vk::ImageMemoryBarrier{
                 .srcAccessMask = params.dst_access,
@@ -512,7 +642,7 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .image = params.dst_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, copy.dst_level),
+                .subresourceRange = dst_range,
             },
         };
         const std::array post_barriers = {
@@ -524,7 +654,7 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .image = params.src_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, copy.src_level),
+                .subresourceRange = src_range,
             },
             vk::ImageMemoryBarrier{
                 .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
@@ -534,7 +664,7 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .image = params.dst_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, copy.dst_level),
+                .subresourceRange = dst_range,
             },
         };
 
@@ -542,7 +672,7 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                vk::DependencyFlagBits::eByRegion, {}, {}, pre_barriers);
 
         cmdbuf.copyImage(params.src_image, new_src_layout, params.dst_image, new_dst_layout,
-                         image_copy);
+                         static_cast<u32>(image_copies.size()), image_copies.data());
 
         cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, params.pipeline_flags,
                                vk::DependencyFlagBits::eByRegion, {}, {}, post_barriers);
@@ -553,6 +683,8 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
 
 bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureBlit& blit) {
+    VideoCore::GpuProfiler::Scope gpu_scope{gpu_profiler, VideoCore::GpuPass::Blit};
+    blit_helper.FlushFilters();
     const bool is_depth_stencil = source.type == VideoCore::SurfaceType::DepthStencil;
     const auto& depth_traits = instance.GetTraits(source.pixel_format);
     if (is_depth_stencil && !depth_traits.blit_support) {
@@ -667,6 +799,7 @@ void TextureRuntime::GenerateMipmaps(Surface& surface) {
         return;
     }
 
+    blit_helper.FlushFilters();
     renderpass_cache.EndRendering();
 
     auto [width, height] = surface.RealExtent();
@@ -694,11 +827,50 @@ bool TextureRuntime::NeedsConversion(VideoCore::PixelFormat format) const {
            traits.aspect != (vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil);
 }
 
+bool TextureRuntime::SupportsTiledDecode(VideoCore::PixelFormat format) const {
+    const FormatTraits& traits = instance.GetTraits(format);
+    return VideoCore::IsGpuDecodable(format) && traits.native == vk::Format::eR8G8B8A8Unorm &&
+           (traits.usage & vk::ImageUsageFlagBits::eStorage);
+}
+
+bool TextureRuntime::SupportsCustomFormat(VideoCore::CustomPixelFormat format) const {
+    return instance.GetTraits(format).transfer_support;
+}
+
+Handle TextureRuntime::AllocateHandle(const HandleInfo& info, std::string_view debug_name,
+                                      bool* recycled) {
+    auto handle = handle_pool.Acquire(info);
+    if (recycled) {
+        *recycled = handle.has_value();
+    }
+    if (!handle) {
+        handle = MakeHandle(&instance, image_pools, info);
+    }
+    SetHandleName(&instance, *handle, debug_name);
+    return std::move(*handle);
+}
+
+void TextureRuntime::RecycleHandle(Handle&& handle) {
+    if (!handle.image_view) {
+        return;
+    }
+    // Descriptor sets are cached by view, drop them so the new owner does not inherit them
+    FreeDescriptorSetsWithImage(*handle.image_view);
+    VmaAllocationInfo alloc_info{};
+    vmaGetAllocationInfo(instance.GetAllocator(), handle.alloc, &alloc_info);
+    handle_pool.Release(handle.info, std::move(handle), alloc_info.size);
+}
+
 void TextureRuntime::FreeDescriptorSetsWithImage(vk::ImageView image_view) {
     texture_provider.FreeWithImage(image_view);
+    if (texture_heap) {
+        texture_heap->FreeWithImage(image_view);
+    }
     blit_helper.compute_provider.FreeWithImage(image_view);
     blit_helper.compute_buffer_provider.FreeWithImage(image_view);
     blit_helper.two_textures_provider.FreeWithImage(image_view);
+    blit_helper.decode_provider.FreeWithImage(image_view);
+    blit_helper.filter_provider.FreeWithImage(image_view);
 }
 
 Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceParams& params)
@@ -725,19 +897,33 @@ Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceParams& param
         flags |= vk::ImageCreateFlagBits::eMutableFormat;
     }
 
-    const bool need_format_list = is_mutable && instance->IsImageFormatListSupported();
-    handles[0] = MakeHandle(instance, width, height, levels, texture_type, format, traits.usage,
-                            flags, traits.aspect, need_format_list, DebugName(false));
-    raw_images.emplace_back(handles[0].image);
+    bool recycled{};
+    handles[0] = runtime->AllocateHandle(MakeHandleInfo(width, height, levels, texture_type,
+                                                        format, traits.usage, flags, traits.aspect),
+                                         DebugName(false), &recycled);
+
+    // Fresh images are not used by earlier graphics submissions, so color ones can be initialized
+    // and uploaded on the transfer queue. Recycled images must stay ordered with their old users.
+    runtime->renderpass_cache.EndRendering();
+    if (scheduler->HasTransferQueue() && !recycled &&
+        traits.aspect == vk::ImageAspectFlagBits::eColor) {
+        scheduler->InitTransferImage(handles[0].image, traits.aspect);
+        transfer_batch = scheduler->TransferBatch();
+    } else {
+        raw_images.emplace_back(handles[0].image);
+    }
 
     if (res_scale != 1) {
-        handles[1] =
-            MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type, format,
-                       traits.usage, flags, traits.aspect, need_format_list, DebugName(true));
+        handles[1] = runtime->AllocateHandle(
+            MakeHandleInfo(GetScaledWidth(), GetScaledHeight(), levels, texture_type, format,
+                           traits.usage, flags, traits.aspect),
+            DebugName(true));
         raw_images.emplace_back(handles[1].image);
     }
 
-    runtime->renderpass_cache.EndRendering();
+    if (raw_images.empty()) {
+        return;
+    }
     scheduler->Record([raw_images, aspect = traits.aspect](vk::CommandBuffer cmdbuf) {
         const auto barriers = MakeInitBarriers(aspect, raw_images);
         cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
@@ -765,19 +951,19 @@ Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceBase& surface
     }
 
     const std::string debug_name = DebugName(false, true);
-    handles[0] = MakeHandle(instance, mat->width, mat->height, levels, texture_type, format,
-                            traits.usage, flags, traits.aspect, false, debug_name);
+    const HandleInfo info = MakeHandleInfo(mat->width, mat->height, levels, texture_type, format,
+                                           traits.usage, flags, traits.aspect);
+    handles[0] = runtime->AllocateHandle(info, debug_name);
     raw_images.emplace_back(handles[0].image);
 
     if (res_scale != 1) {
-        handles[1] = MakeHandle(instance, mat->width, mat->height, levels, texture_type,
-                                vk::Format::eR8G8B8A8Unorm, traits.usage, flags, traits.aspect,
-                                false, debug_name);
+        HandleInfo scaled_info = info;
+        scaled_info.format = vk::Format::eR8G8B8A8Unorm;
+        handles[1] = runtime->AllocateHandle(scaled_info, debug_name);
         raw_images.emplace_back(handles[1].image);
     }
     if (has_normal) {
-        handles[2] = MakeHandle(instance, mat->width, mat->height, levels, texture_type, format,
-                                traits.usage, flags, traits.aspect, false, debug_name);
+        handles[2] = runtime->AllocateHandle(info, debug_name);
         raw_images.emplace_back(handles[2].image);
     }
 
@@ -797,21 +983,70 @@ Surface::~Surface() {
     if (!handles[0].image_view) {
         return;
     }
-    for (const auto& [alloc, image, image_view] : handles) {
-        if (image_view) {
-            runtime->FreeDescriptorSetsWithImage(*image_view);
-        }
-        if (image) {
-            vmaDestroyImage(instance->GetAllocator(), image, alloc);
+    // Queued filters may still reference the views of this surface
+    runtime->FlushFilters();
+    for (auto& views : level_views) {
+        for (const auto& view : views) {
+            if (view) {
+                runtime->FreeDescriptorSetsWithImage(*view);
+            }
         }
+        views.clear();
     }
-    if (copy_handle.image_view) {
-        vmaDestroyImage(instance->GetAllocator(), copy_handle.image, copy_handle.alloc);
+    for (Handle& handle : handles) {
+        runtime->renderpass_cache.DiscardClear(handle.image);
+        runtime->RecycleHandle(std::move(handle));
     }
+    runtime->RecycleHandle(std::move(copy_handle));
 }
 
 void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
-                     const VideoCore::StagingData& staging) {
+                     const VideoCore::StagingData& staging, bool filter) {
+    VideoCore::GpuProfiler::Scope gpu_scope{runtime->gpu_profiler, VideoCore::GpuPass::Upload};
+    // Transfer only queues require buffer offsets aligned to 4 bytes.
+    if (transfer_batch == scheduler->TransferBatch() && upload.buffer_offset % 4 == 0) {
+        RecordTransferUpload(upload);
+        runtime->upload_buffer.Commit(staging.size);
+    } else {
+        RecordUpload(upload, staging);
+    }
+
+    if (res_scale != 1) {
+        const VideoCore::TextureBlit blit = {
+            .src_level = upload.texture_level,
+            .dst_level = upload.texture_level,
+            .src_rect = upload.texture_rect,
+            .dst_rect = upload.texture_rect * res_scale,
+        };
+
+        if (!filter || !runtime->blit_helper.Filter(*this, blit)) {
+            BlitScale(blit, true);
+        }
+    }
+}
+
+void Surface::RecordTransferUpload(const VideoCore::BufferTextureCopy& upload) {
+    const vk::Image image = handles[0].image;
+    const auto rect = upload.texture_rect;
+    const vk::BufferImageCopy buffer_image_copy = {
+        .bufferOffset = upload.buffer_offset,
+        .bufferRowLength = rect.GetWidth(),
+        .bufferImageHeight = rect.GetHeight(),
+        .imageSubresource{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .mipLevel = upload.texture_level,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
+        .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1},
+    };
+    scheduler->UploadTransferImage(image, Aspect(), runtime->upload_buffer.Handle(),
+                                   buffer_image_copy);
+}
+
+void Surface::RecordUpload(const VideoCore::BufferTextureCopy& upload,
+                           const VideoCore::StagingData& staging) {
     runtime->renderpass_cache.EndRendering();
 
     const RecordParams params = {
@@ -882,6 +1117,14 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
     });
 
     runtime->upload_buffer.Commit(staging.size);
+}
+
+void Surface::UploadTiled(const VideoCore::BufferTextureCopy& upload,
+                          const VideoCore::StagingData& staging, bool filter) {
+    VideoCore::GpuProfiler::Scope gpu_scope{runtime->gpu_profiler, VideoCore::GpuPass::Upload};
+    runtime->renderpass_cache.EndRendering();
+    runtime->blit_helper.DecodeTiled(*this, runtime->upload_buffer.Handle(), upload);
+    runtime->upload_buffer.Commit(staging.size);
 
     if (res_scale != 1) {
         const VideoCore::TextureBlit blit = {
@@ -891,11 +1134,18 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
             .dst_rect = upload.texture_rect * res_scale,
         };
 
-        BlitScale(blit, true);
+        if (!filter || !runtime->blit_helper.Filter(*this, blit)) {
+            BlitScale(blit, true);
+        }
     }
 }
 
+void Surface::Filter(const VideoCore::TextureBlit& blit) {
+    runtime->blit_helper.Filter(*this, blit);
+}
+
 void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
+    VideoCore::GpuProfiler::Scope gpu_scope{runtime->gpu_profiler, VideoCore::GpuPass::Upload};
     const u32 width = material->width;
     const u32 height = material->height;
     const auto color = material->textures[0];
@@ -975,15 +1225,24 @@ void Surface::UploadCustom(const VideoCore::Material* material, u32 level) {
 
 void Surface::Download(const VideoCore::BufferTextureCopy& download,
                        const VideoCore::StagingData& staging) {
-    SCOPE_EXIT({
-        scheduler->Finish();
-        runtime->download_buffer.Commit(staging.size);
-    });
+    RecordDownload(download, runtime->download_buffer.Handle());
+    scheduler->Finish();
+    runtime->download_buffer.Commit(staging.size);
+}
+
+u64 Surface::DownloadAsync(const VideoCore::BufferTextureCopy& download,
+                           const VideoCore::StagingData& staging) {
+    RecordDownload(download, runtime->readback_buffer.Handle());
+    runtime->readback_buffer.Commit(staging.size);
+    return scheduler->CurrentTick();
+}
 
+void Surface::RecordDownload(const VideoCore::BufferTextureCopy& download, vk::Buffer buffer) {
+    runtime->FlushFilters();
     runtime->renderpass_cache.EndRendering();
 
     if (pixel_format == PixelFormat::D24S8) {
-        runtime->blit_helper.DepthToBuffer(*this, runtime->download_buffer.Handle(), download);
+        runtime->blit_helper.DepthToBuffer(*this, buffer, download);
         return;
     }
 
@@ -1005,58 +1264,57 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download,
         .src_image = Image(0),
     };
 
-    scheduler->Record(
-        [buffer = runtime->download_buffer.Handle(), params, download](vk::CommandBuffer cmdbuf) {
-            const auto rect = download.texture_rect;
-            const vk::BufferImageCopy buffer_image_copy = {
-                .bufferOffset = download.buffer_offset,
-                .bufferRowLength = rect.GetWidth(),
-                .bufferImageHeight = rect.GetHeight(),
-                .imageSubresource{
-                    .aspectMask = params.aspect,
-                    .mipLevel = download.texture_level,
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                },
-                .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
-                .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1},
-            };
+    scheduler->Record([buffer, params, download](vk::CommandBuffer cmdbuf) {
+        const auto rect = download.texture_rect;
+        const vk::BufferImageCopy buffer_image_copy = {
+            .bufferOffset = download.buffer_offset,
+            .bufferRowLength = rect.GetWidth(),
+            .bufferImageHeight = rect.GetHeight(),
+            .imageSubresource{
+                .aspectMask = params.aspect,
+                .mipLevel = download.texture_level,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
+            .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1},
+        };
 
-            const vk::ImageMemoryBarrier read_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .dstAccessMask = vk::AccessFlagBits::eTransferRead,
-                .oldLayout = vk::ImageLayout::eGeneral,
-                .newLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = params.src_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
-            };
-            const vk::ImageMemoryBarrier image_write_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eNone,
-                .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
-                .newLayout = vk::ImageLayout::eGeneral,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = params.src_image,
-                .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
-            };
-            const vk::MemoryBarrier memory_write_barrier = {
-                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
-            };
+        const vk::ImageMemoryBarrier read_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = params.src_image,
+            .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
+        };
+        const vk::ImageMemoryBarrier image_write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eNone,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = params.src_image,
+            .subresourceRange = MakeSubresourceRange(params.aspect, download.texture_level),
+        };
+        const vk::MemoryBarrier memory_write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+        };
 
-            cmdbuf.pipelineBarrier(params.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
-                                   vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
+        cmdbuf.pipelineBarrier(params.pipeline_flags, vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, {}, read_barrier);
 
-            cmdbuf.copyImageToBuffer(params.src_image, vk::ImageLayout::eTransferSrcOptimal, buffer,
-                                     buffer_image_copy);
+        cmdbuf.copyImageToBuffer(params.src_image, vk::ImageLayout::eTransferSrcOptimal, buffer,
+                                 buffer_image_copy);
 
-            cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, params.pipeline_flags,
-                                   vk::DependencyFlagBits::eByRegion, memory_write_barrier, {},
-                                   image_write_barrier);
-        });
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, params.pipeline_flags,
+                               vk::DependencyFlagBits::eByRegion, memory_write_barrier, {},
+                               image_write_barrier);
+    });
 }
 
 void Surface::ScaleUp(u32 new_scale) {
@@ -1064,6 +1322,13 @@ void Surface::ScaleUp(u32 new_scale) {
         return;
     }
 
+    runtime->FlushFilters();
+    for (const auto& view : level_views[1]) {
+        if (view) {
+            runtime->FreeDescriptorSetsWithImage(*view);
+        }
+    }
+    level_views[1].clear();
     res_scale = new_scale;
 
     const bool is_mutable = pixel_format == VideoCore::PixelFormat::RGBA8;
@@ -1076,9 +1341,10 @@ void Surface::ScaleUp(u32 new_scale) {
         flags |= vk::ImageCreateFlagBits::eMutableFormat;
     }
 
-    handles[1] =
-        MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type,
-                   traits.native, traits.usage, flags, traits.aspect, false, DebugName(true));
+    handles[1] = runtime->AllocateHandle(MakeHandleInfo(GetScaledWidth(), GetScaledHeight(), levels,
+                                                        texture_type, traits.native, traits.usage,
+                                                        flags, traits.aspect),
+                                         DebugName(true));
 
     runtime->renderpass_cache.EndRendering();
     scheduler->Record(
@@ -1138,6 +1404,8 @@ vk::PipelineStageFlags Surface::PipelineStageFlags() const noexcept {
 }
 
 vk::Image Surface::Image(u32 index) const noexcept {
+    // Every graphics access goes through the image or its views, which ends transfer uploads
+    transfer_batch = 0;
     const vk::Image image = handles[index].image;
     if (!image) {
         return handles[0].image;
@@ -1152,9 +1420,9 @@ vk::ImageView Surface::CopyImageView() noexcept {
         if (texture_type == VideoCore::TextureType::CubeMap) {
             flags |= vk::ImageCreateFlagBits::eCubeCompatible;
         }
-        copy_handle =
-            MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type,
-                       traits.native, traits.usage, flags, traits.aspect, false);
+        copy_handle = runtime->AllocateHandle(MakeHandleInfo(GetScaledWidth(), GetScaledHeight(),
+                                                             levels, texture_type, traits.native,
+                                                             traits.usage, flags, traits.aspect));
         copy_layout = vk::ImageLayout::eUndefined;
     }
 
@@ -1250,6 +1518,7 @@ vk::ImageView Surface::CopyImageView() noexcept {
 }
 
 vk::ImageView Surface::ImageView(u32 index) const noexcept {
+    transfer_batch = 0;
     const auto& image_view = handles[index].image_view.get();
     if (!image_view) {
         return handles[0].image_view.get();
@@ -1336,6 +1605,32 @@ vk::ImageView Surface::StorageView() noexcept {
     return storage_view.get();
 }
 
+vk::ImageView Surface::LevelView(u32 level, u32 index) noexcept {
+    auto& views = level_views[index];
+    if (views.size() <= level) {
+        views.resize(level + 1);
+    }
+    auto& view = views[level];
+    if (view) {
+        return view.get();
+    }
+
+    const vk::ImageViewCreateInfo view_info = {
+        .image = Image(index),
+        .viewType = vk::ImageViewType::e2D,
+        .format = vk::Format::eR8G8B8A8Unorm,
+        .subresourceRange{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .baseMipLevel = level,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+    };
+    view = instance->GetDevice().createImageViewUnique(view_info);
+    return view.get();
+}
+
 vk::Framebuffer Surface::Framebuffer() noexcept {
     const u32 index = res_scale == 1 ? 0u : 1u;
     if (framebuffers[index]) {
@@ -6,18 +6,22 @@
 
 #include <deque>
 #include <span>
+#include "common/hash.h"
 #include "video_core/rasterizer_cache/framebuffer_base.h"
 #include "video_core/rasterizer_cache/rasterizer_cache_base.h"
 #include "video_core/rasterizer_cache/surface_base.h"
+#include "video_core/rasterizer_cache/surface_pool.h"
 #include "video_core/renderer_vulkan/vk_blit_helper.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_memory_util.h"
 #include "video_core/renderer_vulkan/vk_stream_buffer.h"
 
 VK_DEFINE_HANDLE(VmaAllocation)
 
 namespace VideoCore {
+class GpuProfiler;
 struct Material;
-}
+} // namespace VideoCore
 
 namespace Vulkan {
 
@@ -25,12 +29,33 @@ class Instance;
 class RenderpassCache;
 class DescriptorPool;
 class DescriptorSetProvider;
+class TextureHeap;
 class Surface;
 
+struct HandleInfo {
+    vk::Format format;
+    vk::ImageViewType view_type;
+    vk::ImageUsageFlags usage;
+    vk::ImageCreateFlags flags;
+    vk::ImageAspectFlags aspect;
+    u32 width;
+    u32 height;
+    u32 levels;
+
+    bool operator==(const HandleInfo& other) const noexcept = default;
+
+    u64 Hash() const noexcept {
+        return Common::ComputeHash64(this, sizeof(HandleInfo));
+    }
+};
+static_assert(std::has_unique_object_representations_v<HandleInfo>,
+              "HandleInfo is not suitable for hashing");
+
 struct Handle {
     VmaAllocation alloc;
     vk::Image image;
     vk::UniqueImageView image_view;
+    HandleInfo info;
 };
 
 /**
@@ -43,7 +68,8 @@ class TextureRuntime {
 public:
     explicit TextureRuntime(const Instance& instance, Scheduler& scheduler,
                             RenderpassCache& renderpass_cache, DescriptorPool& pool,
-                            DescriptorSetProvider& texture_provider, u32 num_swapchain_images);
+                            DescriptorSetProvider& texture_provider, TextureHeap* texture_heap,
+                            u32 num_swapchain_images, VideoCore::GpuProfiler& gpu_profiler);
     ~TextureRuntime();
 
     const Instance& GetInstance() const {
@@ -61,12 +87,32 @@ public:
     /// Returns the removal threshold ticks for the garbage collector
     u32 RemoveThreshold();
 
+    /// Returns the amount of device local memory in bytes the application may use
+    u64 GetMemoryBudget() const;
+
     /// Submits and waits for current GPU work.
     void Finish();
 
+    /// Submits current GPU work without waiting for it.
+    void Flush();
+
+    /// Records the texture filters queued by surface uploads
+    void FlushFilters();
+
     /// Maps an internal staging buffer of the provided size for pixel uploads/downloads
     VideoCore::StagingData FindStaging(u32 size, bool upload);
 
+    /// Returns true if surfaces can be read back without waiting for the GPU.
+    bool SupportsAsyncDownload() const {
+        return true;
+    }
+
+    /// Maps readback memory of the provided size for asynchronous downloads
+    VideoCore::StagingData FindReadbackStaging(u32 size);
+
+    /// Waits for the asynchronous download that returned tick to complete
+    void WaitDownload(u64 tick);
+
     /// Attempts to reinterpret a rectangle of source to another rectangle of dest
     bool Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
@@ -76,6 +122,10 @@ public:
     /// Copies a rectangle of src_tex to another rectange of dst_rect
     bool CopyTextures(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
+    /// Copies up to MAX_PICA_LEVELS rectangles of source to dest, recorded as a single copy
+    bool CopyTextures(Surface& source, Surface& dest,
+                      std::span<const VideoCore::TextureCopy> copies);
+
     /// Blits a rectangle of src_tex to another rectange of dst_rect
     bool BlitTextures(Surface& surface, Surface& dest, const VideoCore::TextureBlit& blit);
 
@@ -85,6 +135,17 @@ public:
     /// Returns true if the provided pixel format needs convertion
     bool NeedsConversion(VideoCore::PixelFormat format) const;
 
+    /// Returns true if tiled data of the provided pixel format can be decoded on the GPU
+    bool SupportsTiledDecode(VideoCore::PixelFormat format) const;
+
+    /// Returns true if custom textures of the provided format can be sampled
+    bool SupportsCustomFormat(VideoCore::CustomPixelFormat format) const;
+
+    /// Returns true if the custom material can be uploaded now, materials are uploaded directly
+    bool PrepareCustomUpload(const VideoCore::Material*) {
+        return true;
+    }
+
     /// Removes any descriptor sets that contain the provided image view.
     void FreeDescriptorSetsWithImage(vk::ImageView image_view);
 
@@ -92,14 +153,27 @@ private:
     /// Clears a partial texture rect using a clear rectangle
     void ClearTextureWithRenderpass(Surface& surface, const VideoCore::TextureClear& clear);
 
+    /// Returns a released image matching info from the surface pool or allocates a new one.
+    /// When recycled is provided it is set to whether the image came from the pool.
+    Handle AllocateHandle(const HandleInfo& info, std::string_view debug_name = {},
+                          bool* recycled = nullptr);
+
+    /// Returns the image to the surface pool for reuse by later surfaces
+    void RecycleHandle(Handle&& handle);
+
 private:
     const Instance& instance;
     Scheduler& scheduler;
     RenderpassCache& renderpass_cache;
     DescriptorSetProvider& texture_provider;
+    TextureHeap* texture_heap;
+    VideoCore::GpuProfiler& gpu_profiler;
     BlitHelper blit_helper;
     StreamBuffer upload_buffer;
     StreamBuffer download_buffer;
+    StreamBuffer readback_buffer;
+    ImagePools image_pools;
+    VideoCore::SurfacePool<HandleInfo, Handle> handle_pool;
     u32 num_swapchain_images;
 };
 
@@ -143,11 +217,23 @@ public:
     /// Returns the R32 image view used for atomic load/store
     vk::ImageView StorageView() noexcept;
 
+    /// Returns a single level RGBA8 view of the image at index used as compute shader target
+    vk::ImageView LevelView(u32 level, u32 index = 0) noexcept;
+
     /// Returns a framebuffer handle for rendering to this surface
     vk::Framebuffer Framebuffer() noexcept;
 
-    /// Uploads pixel data in staging to a rectangle region of the surface texture
-    void Upload(const VideoCore::BufferTextureCopy& upload, const VideoCore::StagingData& staging);
+    /// Uploads pixel data in staging to a rectangle region of the surface texture.
+    /// When filter is false the upscaled image is only scaled linearly, see Filter.
+    void Upload(const VideoCore::BufferTextureCopy& upload, const VideoCore::StagingData& staging,
+                bool filter = true);
+
+    /// Uploads raw tiled pixel data in staging and decodes it to a rectangle region of the image
+    void UploadTiled(const VideoCore::BufferTextureCopy& upload,
+                     const VideoCore::StagingData& staging, bool filter = true);
+
+    /// Applies the texture filter to a rectangle region of the upscaled image
+    void Filter(const VideoCore::TextureBlit& blit);
 
     /// Uploads the custom material to the surface allocation.
     void UploadCustom(const VideoCore::Material* material, u32 level);
@@ -156,6 +242,10 @@ public:
     void Download(const VideoCore::BufferTextureCopy& download,
                   const VideoCore::StagingData& staging);
 
+    /// Records a download of a rectangle region to readback staging, returning its tick
+    u64 DownloadAsync(const VideoCore::BufferTextureCopy& download,
+                      const VideoCore::StagingData& staging);
+
     /// Scales up the surface to match the new resolution scale.
     void ScaleUp(u32 new_scale);
 
@@ -172,6 +262,16 @@ private:
     /// Performs blit between the scaled/unscaled images
     void BlitScale(const VideoCore::TextureBlit& blit, bool up_scale);
 
+    /// Queues the upload to the base image on the transfer queue
+    void RecordTransferUpload(const VideoCore::BufferTextureCopy& upload);
+
+    /// Records the upload to the base image on the graphics queue
+    void RecordUpload(const VideoCore::BufferTextureCopy& upload,
+                      const VideoCore::StagingData& staging);
+
+    /// Records a copy of the rectangle region of the surface to buffer
+    void RecordDownload(const VideoCore::BufferTextureCopy& download, vk::Buffer buffer);
+
     /// Downloads scaled depth stencil data
     void DepthStencilDownload(const VideoCore::BufferTextureCopy& download,
                               const VideoCore::StagingData& staging);
@@ -187,8 +287,12 @@ public:
     vk::UniqueImageView depth_view;
     vk::UniqueImageView stencil_view;
     vk::UniqueImageView storage_view;
+    std::array<std::vector<vk::UniqueImageView>, 2> level_views;
     bool is_framebuffer{};
     bool is_storage{};
+    /// Transfer batch the base image was initialized on the transfer queue with. Uploads may use
+    /// the transfer queue during that batch until the graphics queue accesses the image.
+    mutable u64 transfer_batch{};
 };
 
 class Framebuffer : public VideoCore::FramebufferParams {
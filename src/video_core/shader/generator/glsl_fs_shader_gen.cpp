@@ -98,7 +98,69 @@ layout (binding = 2, std140) uniform fs_data {
     vec3 tex_lod_bias;
     vec4 tex_border_color[3];
     vec4 blend_color;
-};
+)";
+
+/// The uber fragment shader reads the fragment configuration from the end of the fs_data block
+constexpr static std::string_view FSUberUniformMembers = R"(    uint uber_framebuffer;
+    uint uber_texture;
+    uint uber_texture_border;
+    uint uber_lighting;
+    uvec4 uber_tev_stages[NUM_TEV_STAGES];
+    uvec4 uber_lut_configs[2];
+    vec4 uber_lut_scales[2];
+    uvec4 uber_lights[2];
+)";
+
+/// Helpers shared by the generated fragment shaders and the uber fragment shader
+constexpr static std::string_view FSHelpersDef = R"(
+vec3 quaternion_rotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+float byteround(float x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec2 byteround(vec2 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec3 byteround(vec3 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec4 byteround(vec4 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+float getLod(vec2 coord) {
+    vec2 d = max(abs(dFdx(coord)), abs(dFdy(coord)));
+    return log2(max(d.x, d.y));
+}
+
+uvec2 DecodeShadow(uint pixel) {
+    return uvec2(pixel >> 8, pixel & 0xFFu);
+}
+)";
+
+constexpr static std::string_view LightingLUTHelpersDef = R"(
+float LookupLightingLUT(int lut_index, int index, float delta) {
+    vec2 entry = texelFetch(texture_buffer_lut_lf, lighting_lut_offset[lut_index >> 2][lut_index & 3] + index).rg;
+    return entry.r + entry.g * delta;
+}
+
+float LookupLightingLUTUnsigned(int lut_index, float pos) {
+    int index = int(clamp(floor(pos * 256.0), 0.f, 255.f));
+    float delta = pos * 256.0 - float(index);
+    return LookupLightingLUT(lut_index, index, delta);
+}
+
+float LookupLightingLUTSigned(int lut_index, float pos) {
+    int index = int(clamp(floor(pos * 128.0), -128.f, 127.f));
+    float delta = pos * 128.0 - float(index);
+    if (index < 0) index += 256;
+    return LookupLightingLUT(lut_index, index, delta);
+}
 )";
 
 FragmentModule::FragmentModule(const FSConfig& config_, const Profile& profile_)
@@ -460,10 +522,15 @@ void FragmentModule::WriteTevStage(u32 index) {
             out += ");\n";
         }
 
+        // Leave out multiplies by one, glslang does not fold them when targeting SPIR-V
+        const auto multiplier = [](u32 value) {
+            return value == 1 ? std::string{} : fmt::format(" * {}.0", value);
+        };
         out += fmt::format("combiner_output = vec4("
-                           "clamp(color_output_{} * {}.0, vec3(0.0), vec3(1.0)), "
-                           "clamp(alpha_output_{} * {}.0, 0.0, 1.0));\n",
-                           index, stage.GetColorMultiplier(), index, stage.GetAlphaMultiplier());
+                           "clamp(color_output_{}{}, vec3(0.0), vec3(1.0)), "
+                           "clamp(alpha_output_{}{}, 0.0, 1.0));\n",
+                           index, multiplier(stage.GetColorMultiplier()), index,
+                           multiplier(stage.GetAlphaMultiplier()));
     }
 
     out += "combiner_buffer = next_combiner_buffer;\n";
@@ -843,18 +910,25 @@ ivec2 image_coord = ivec2(gl_FragCoord.xy);
 beginInvocationInterlock();
 uint old_shadow = imageLoad(shadow_buffer, image_coord).x;
 uint new_shadow = UpdateShadow(old_shadow, d, s);
-imageStore(shadow_buffer, image_coord, uvec4(new_shadow));
+if (new_shadow != old_shadow) {
+    imageStore(shadow_buffer, image_coord, uvec4(new_shadow));
+}
 endInvocationInterlock();
 )";
     } else {
+        // Most fragments of a shadow caster fail the depth test and leave the pixel unchanged.
+        // Those only pay for the load, skipping the atomic orders them before any concurrent write.
         out += R"(
 uint old = imageLoad(shadow_buffer, image_coord).x;
-uint new1;
-uint old2;
-do {
-    old2 = old;
+uint new1 = UpdateShadow(old, d, s);
+while (new1 != old) {
+    uint prev = imageAtomicCompSwap(shadow_buffer, image_coord, old, new1);
+    if (prev == old) {
+        break;
+    }
+    old = prev;
     new1 = UpdateShadow(old, d, s);
-} while ((old = imageAtomicCompSwap(shadow_buffer, image_coord, old, new1)) != old2);
+}
 )";
     }
 }
@@ -1275,6 +1349,7 @@ void FragmentModule::DefineInterface() {
 void FragmentModule::DefineBindings() {
     // Uniform and texture buffers
     out += FSUniformBlockDef;
+    out += "};\n";
     out += "layout(binding = 3) uniform samplerBuffer texture_buffer_lut_lf;\n";
     out += "layout(binding = 4) uniform samplerBuffer texture_buffer_lut_rg;\n";
     out += "layout(binding = 5) uniform samplerBuffer texture_buffer_lut_rgba;\n\n";
@@ -1282,11 +1357,25 @@ void FragmentModule::DefineBindings() {
     // Texture samplers
     const auto texunit_set = profile.is_vulkan ? "set = 1, " : "";
     const auto texture_type = config.texture.texture0_type.Value();
-    for (u32 i = 0; i < 3; i++) {
-        const auto sampler =
-            i == 0 && texture_type == TextureType::TextureCube ? "samplerCube" : "sampler2D";
-        out +=
-            fmt::format("layout({0}binding = {1}) uniform {2} tex{1};\n", texunit_set, i, sampler);
+    if (profile.has_texture_heap) {
+        // 2D textures are sampled from the heap at the indices provided by push constants
+        out += fmt::format("layout(set = 3, binding = 0) uniform sampler2D tex_heap[{}];\n",
+                           profile.texture_heap_size);
+        out += "layout(push_constant) uniform texture_indices {\n    uint tex_index[3];\n};\n";
+        for (u32 i = 0; i < 3; i++) {
+            if (i == 0 && texture_type == TextureType::TextureCube) {
+                out += "layout(set = 1, binding = 0) uniform samplerCube tex0;\n";
+            } else {
+                out += fmt::format("#define tex{0} tex_heap[tex_index[{0}]]\n", i);
+            }
+        }
+    } else {
+        for (u32 i = 0; i < 3; i++) {
+            const auto sampler =
+                i == 0 && texture_type == TextureType::TextureCube ? "samplerCube" : "sampler2D";
+            out += fmt::format("layout({0}binding = {1}) uniform {2} tex{1};\n", texunit_set, i,
+                               sampler);
+        }
     }
 
     if (config.user.use_custom_normal && !profile.is_vulkan) {
@@ -1311,36 +1400,7 @@ void FragmentModule::DefineBindings() {
 }
 
 void FragmentModule::DefineHelpers() {
-    out += R"(
-vec3 quaternion_rotate(vec4 q, vec3 v) {
-    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
-}
-
-float byteround(float x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
-
-vec2 byteround(vec2 x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
-
-vec3 byteround(vec3 x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
-
-vec4 byteround(vec4 x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
-
-float getLod(vec2 coord) {
-    vec2 d = max(abs(dFdx(coord)), abs(dFdy(coord)));
-    return log2(max(d.x, d.y));
-}
-
-uvec2 DecodeShadow(uint pixel) {
-    return uvec2(pixel >> 8, pixel & 0xFFu);
-}
-)";
+    out += FSHelpersDef;
 }
 
 void FragmentModule::DefineLightingHelpers() {
@@ -1348,25 +1408,7 @@ void FragmentModule::DefineLightingHelpers() {
         return;
     }
 
-    out += R"(
-float LookupLightingLUT(int lut_index, int index, float delta) {
-    vec2 entry = texelFetch(texture_buffer_lut_lf, lighting_lut_offset[lut_index >> 2][lut_index & 3] + index).rg;
-    return entry.r + entry.g * delta;
-}
-
-float LookupLightingLUTUnsigned(int lut_index, float pos) {
-    int index = int(clamp(floor(pos * 256.0), 0.f, 255.f));
-    float delta = pos * 256.0 - float(index);
-    return LookupLightingLUT(lut_index, index, delta);
-}
-
-float LookupLightingLUTSigned(int lut_index, float pos) {
-    int index = int(clamp(floor(pos * 128.0), -128.f, 127.f));
-    float delta = pos * 128.0 - float(index);
-    if (index < 0) index += 256;
-    return LookupLightingLUT(lut_index, index, delta);
-}
-)";
+    out += LightingLUTHelpersDef;
 
     if (use_fragment_shader_barycentric) {
         out += R"(
@@ -1617,4 +1659,615 @@ std::string GenerateFragmentShader(const FSConfig& config, const Profile& profil
     return module.Generate();
 }
 
+/// Interprets the configuration of the uber fragment shader, see FSUberData for its layout
+constexpr static std::string_view FSUberShaderDef = R"(
+vec4 rounded_primary_color;
+vec4 primary_fragment_color;
+vec4 secondary_fragment_color;
+vec4 texture_color[4];
+vec4 combiner_buffer;
+vec4 combiner_output;
+
+vec3 normal;
+vec3 tangent;
+vec3 light_vector;
+vec3 half_vector;
+vec3 spot_dir;
+
+const int LUT_D0 = 0;
+const int LUT_D1 = 1;
+const int LUT_SP = 2;
+const int LUT_FR = 3;
+const int LUT_RR = 4;
+const int LUT_RG = 5;
+const int LUT_RB = 6;
+
+uint UberBits(uint value, int offset, int bits) {
+    return bitfieldExtract(value, offset, bits);
+}
+
+uint UberLutConfig(int lut) {
+    return uber_lut_configs[lut >> 2][lut & 3];
+}
+
+uint UberLight(int slot) {
+    return uber_lights[slot >> 2][slot & 3];
+}
+
+bool UsesBorderColor(int unit, vec2 coord) {
+    return (UberBits(uber_texture_border, unit * 2, 1) != 0u && (coord.x < 0 || coord.x > 1)) ||
+           (UberBits(uber_texture_border, unit * 2 + 1, 1) != 0u && (coord.y < 0 || coord.y > 1));
+}
+
+vec4 SampleUberTexture(int unit, vec2 coord, float lod_bias) {
+    if (UsesBorderColor(unit, coord)) {
+        return tex_border_color[unit];
+    }
+    switch (unit) {
+    case 0:
+        return textureLod(tex0, coord, getLod(coord * vec2(textureSize(tex0, 0))) + lod_bias);
+    case 1:
+        return textureLod(tex1, coord, getLod(coord * vec2(textureSize(tex1, 0))) + lod_bias);
+    default:
+        return textureLod(tex2, coord, getLod(coord * vec2(textureSize(tex2, 0))) + lod_bias);
+    }
+}
+
+void SampleUberTextures() {
+    uint texture0_type = UberBits(uber_texture, 0, 3);
+    if (texture0_type == 0u) {
+        texture_color[0] = SampleUberTexture(0, texcoord0, tex_lod_bias[0]);
+    } else if (texture0_type == 3u) {
+        texture_color[0] = UsesBorderColor(0, texcoord0)
+                               ? tex_border_color[0]
+                               : textureProj(tex0, vec3(texcoord0, texcoord0_w));
+    } else {
+        texture_color[0] = vec4(0.0);
+    }
+    texture_color[1] = SampleUberTexture(1, texcoord1, tex_lod_bias[1]);
+    vec2 texcoord2_value = UberBits(uber_texture, 3, 1) != 0u ? texcoord1 : texcoord2;
+    texture_color[2] = SampleUberTexture(2, texcoord2_value, tex_lod_bias[2]);
+    texture_color[3] = vec4(0.0);
+}
+
+float UberLightingLUT(int lut, int sampler, bool two_sided) {
+    uint config = UberLutConfig(lut);
+    float index;
+    switch (UberBits(config, 2, 3)) {
+    case 0u:
+        index = dot(normal, normalize(half_vector));
+        break;
+    case 1u:
+        index = dot(normalize(view), normalize(half_vector));
+        break;
+    case 2u:
+        index = dot(normal, normalize(view));
+        break;
+    case 3u:
+        index = dot(light_vector, normal);
+        break;
+    case 4u:
+        index = dot(light_vector, spot_dir);
+        break;
+    case 5u:
+        // CP input is only available with configuration 7
+        if (UberBits(uber_lighting, 11, 4) == 8u) {
+            vec3 half_angle = normalize(half_vector);
+            index = dot(half_angle - normal * dot(normal, half_angle), tangent);
+        } else {
+            index = 0.0;
+        }
+        break;
+    default:
+        index = 0.0;
+        break;
+    }
+
+    float value;
+    if (UberBits(config, 1, 1) != 0u) {
+        index = two_sided ? abs(index) : max(index, 0.0);
+        value = LookupLightingLUTUnsigned(sampler, index);
+    } else {
+        value = LookupLightingLUTSigned(sampler, index);
+    }
+    return uber_lut_scales[lut >> 2][lut & 3] * value;
+}
+
+bool UberLutEnabled(int lut) {
+    return UberBits(UberLutConfig(lut), 0, 1) != 0u;
+}
+
+void ComputeUberLighting() {
+    vec4 diffuse_sum = vec4(0.0, 0.0, 0.0, 1.0);
+    vec4 specular_sum = vec4(0.0, 0.0, 0.0, 1.0);
+
+    vec3 surface_normal = vec3(0.0, 0.0, 1.0);
+    vec3 surface_tangent = vec3(1.0, 0.0, 0.0);
+    uint bump_mode = UberBits(uber_lighting, 5, 2);
+    vec3 perturbation = 2.0 * texture_color[UberBits(uber_lighting, 7, 2)].rgb - 1.0;
+    if (bump_mode == 1u) {
+        surface_normal = perturbation;
+        if (UberBits(uber_lighting, 9, 1) != 0u) {
+            surface_normal.z = sqrt(max(1.0 - (surface_normal.x * surface_normal.x +
+                                               surface_normal.y * surface_normal.y), 0.0));
+        }
+    } else if (bump_mode == 2u) {
+        surface_tangent = perturbation;
+    }
+
+    vec4 normalized_normquat = normalize(normquat);
+    normal = quaternion_rotate(normalized_normquat, surface_normal);
+    tangent = quaternion_rotate(normalized_normquat, surface_tangent);
+
+    vec4 shadow = vec4(1.0);
+    bool enable_shadow = UberBits(uber_lighting, 17, 1) != 0u;
+    if (enable_shadow) {
+        shadow = texture_color[UberBits(uber_lighting, 22, 2)];
+        if (UberBits(uber_lighting, 20, 1) != 0u) {
+            shadow = vec4(1.0) - shadow;
+        }
+    }
+
+    bool enable_primary_alpha = UberBits(uber_lighting, 15, 1) != 0u;
+    bool enable_secondary_alpha = UberBits(uber_lighting, 16, 1) != 0u;
+    int src_num = int(UberBits(uber_lighting, 1, 4));
+    for (int light_index = 0; light_index < src_num; light_index++) {
+        uint light = UberLight(light_index);
+        int num = int(UberBits(light, 0, 3));
+        LightSrc src = light_src[num];
+
+        // LUT inputs take the absolute value by the two sided flag of the slot of the light number
+        bool lut_two_sided = UberBits(UberLight(num), 4, 1) != 0u;
+
+        light_vector = UberBits(light, 3, 1) != 0u ? src.position : src.position + view;
+        float light_distance = length(light_vector);
+        light_vector = normalize(light_vector);
+        spot_dir = src.spot_direction;
+        half_vector = normalize(view) + light_vector;
+
+        float dot_product = UberBits(light, 4, 1) != 0u ? abs(dot(light_vector, normal))
+                                                        : max(dot(light_vector, normal), 0.0);
+        float clamp_highlights = UberBits(uber_lighting, 10, 1) != 0u ? sign(dot_product) : 1.0;
+
+        float spot_atten = 1.0;
+        if (UberBits(light, 6, 1) != 0u && UberLutEnabled(LUT_SP)) {
+            spot_atten = UberLightingLUT(LUT_SP, 8 + num, lut_two_sided);
+        }
+
+        float dist_atten = 1.0;
+        if (UberBits(light, 5, 1) != 0u) {
+            float index = clamp(src.dist_atten_scale * light_distance + src.dist_atten_bias,
+                                0.0, 1.0);
+            dist_atten = LookupLightingLUTUnsigned(16 + num, index);
+        }
+
+        bool geometric_factor_0 = UberBits(light, 7, 1) != 0u;
+        bool geometric_factor_1 = UberBits(light, 8, 1) != 0u;
+        float geo_factor = 1.0;
+        if (geometric_factor_0 || geometric_factor_1) {
+            geo_factor = dot(half_vector, half_vector);
+            geo_factor = geo_factor == 0.0 ? 0.0 : min(dot_product / geo_factor, 1.0);
+        }
+
+        float d0_lut_value = UberLutEnabled(LUT_D0) ? UberLightingLUT(LUT_D0, 0, lut_two_sided)
+                                                     : 1.0;
+        vec3 specular_0 = d0_lut_value * src.specular_0;
+        if (geometric_factor_0) {
+            specular_0 *= geo_factor;
+        }
+
+        vec3 refl_value;
+        refl_value.r = UberLutEnabled(LUT_RR) ? UberLightingLUT(LUT_RR, 6, lut_two_sided) : 1.0;
+        refl_value.g = UberLutEnabled(LUT_RG) ? UberLightingLUT(LUT_RG, 5, lut_two_sided)
+                                              : refl_value.r;
+        refl_value.b = UberLutEnabled(LUT_RB) ? UberLightingLUT(LUT_RB, 4, lut_two_sided)
+                                              : refl_value.r;
+
+        float d1_lut_value = UberLutEnabled(LUT_D1) ? UberLightingLUT(LUT_D1, 1, lut_two_sided)
+                                                     : 1.0;
+        vec3 specular_1 = d1_lut_value * refl_value * src.specular_1;
+        if (geometric_factor_1) {
+            specular_1 *= geo_factor;
+        }
+
+        // Only the last entry in the light slots applies the Fresnel factor
+        if (light_index == src_num - 1 && UberLutEnabled(LUT_FR)) {
+            float fresnel = UberLightingLUT(LUT_FR, 3, lut_two_sided);
+            if (enable_primary_alpha) {
+                diffuse_sum.a = fresnel;
+            }
+            if (enable_secondary_alpha) {
+                specular_sum.a = fresnel;
+            }
+        }
+
+        bool light_shadow = UberBits(light, 9, 1) != 0u;
+        vec3 shadow_primary = vec3(1.0);
+        if (UberBits(uber_lighting, 18, 1) != 0u && light_shadow) {
+            shadow_primary = shadow.rgb;
+        }
+        vec3 shadow_secondary = vec3(1.0);
+        if (UberBits(uber_lighting, 19, 1) != 0u && light_shadow) {
+            shadow_secondary = shadow.rgb;
+        }
+
+        diffuse_sum.rgb += ((src.diffuse * dot_product * shadow_primary) + src.ambient) *
+                           dist_atten * spot_atten;
+        specular_sum.rgb += (specular_0 + specular_1) * clamp_highlights * dist_atten *
+                            spot_atten * shadow_secondary;
+    }
+
+    if (UberBits(uber_lighting, 21, 1) != 0u) {
+        if (enable_primary_alpha) {
+            diffuse_sum.a *= shadow.a;
+        }
+        if (enable_secondary_alpha) {
+            specular_sum.a *= shadow.a;
+        }
+    }
+
+    diffuse_sum.rgb += lighting_global_ambient;
+    primary_fragment_color = clamp(diffuse_sum, vec4(0.0), vec4(1.0));
+    secondary_fragment_color = clamp(specular_sum, vec4(0.0), vec4(1.0));
+}
+
+vec4 GetTevSource(uint source, int stage) {
+    switch (source) {
+    case 0u:
+        return rounded_primary_color;
+    case 1u:
+        return primary_fragment_color;
+    case 2u:
+        return secondary_fragment_color;
+    case 3u:
+        return texture_color[0];
+    case 4u:
+        return texture_color[1];
+    case 5u:
+        return texture_color[2];
+    case 6u:
+        return texture_color[3];
+    case 13u:
+        return combiner_buffer;
+    case 14u:
+        return const_color[stage];
+    case 15u:
+        return combiner_output;
+    default:
+        return vec4(0.0);
+    }
+}
+
+vec3 GetColorModifier(uint modifier, vec4 value) {
+    switch (modifier) {
+    case 0u:
+        return value.rgb;
+    case 1u:
+        return vec3(1.0) - value.rgb;
+    case 2u:
+        return value.aaa;
+    case 3u:
+        return vec3(1.0) - value.aaa;
+    case 4u:
+        return value.rrr;
+    case 5u:
+        return vec3(1.0) - value.rrr;
+    case 8u:
+        return value.ggg;
+    case 9u:
+        return vec3(1.0) - value.ggg;
+    case 12u:
+        return value.bbb;
+    case 13u:
+        return vec3(1.0) - value.bbb;
+    default:
+        return vec3(0.0);
+    }
+}
+
+float GetAlphaModifier(uint modifier, vec4 value) {
+    switch (modifier) {
+    case 0u:
+        return value.a;
+    case 1u:
+        return 1.0 - value.a;
+    case 2u:
+        return value.r;
+    case 3u:
+        return 1.0 - value.r;
+    case 4u:
+        return value.g;
+    case 5u:
+        return 1.0 - value.g;
+    case 6u:
+        return value.b;
+    default:
+        return 1.0 - value.b;
+    }
+}
+
+vec3 CombineColor(uint op, vec3 color_results_1, vec3 color_results_2, vec3 color_results_3) {
+    vec3 result;
+    switch (op) {
+    case 0u:
+        result = color_results_1;
+        break;
+    case 1u:
+        result = color_results_1 * color_results_2;
+        break;
+    case 2u:
+        result = color_results_1 + color_results_2;
+        break;
+    case 3u:
+        result = color_results_1 + color_results_2 - vec3(0.5);
+        break;
+    case 4u:
+        result = mix(color_results_2, color_results_1, color_results_3);
+        break;
+    case 5u:
+        result = color_results_1 - color_results_2;
+        break;
+    case 6u:
+    case 7u:
+        result = vec3(dot(color_results_1 - vec3(0.5), color_results_2 - vec3(0.5)) * 4.0);
+        break;
+    case 8u:
+        result = fma(color_results_1, color_results_2, color_results_3);
+        break;
+    case 9u:
+        result = min(color_results_1 + color_results_2, vec3(1.0)) * color_results_3;
+        break;
+    default:
+        result = vec3(0.0);
+        break;
+    }
+    return clamp(result, vec3(0.0), vec3(1.0));
+}
+
+float CombineAlpha(uint op, float alpha_results_1, float alpha_results_2, float alpha_results_3) {
+    float result;
+    switch (op) {
+    case 0u:
+        result = alpha_results_1;
+        break;
+    case 1u:
+        result = alpha_results_1 * alpha_results_2;
+        break;
+    case 2u:
+        result = alpha_results_1 + alpha_results_2;
+        break;
+    case 3u:
+        result = alpha_results_1 + alpha_results_2 - 0.5;
+        break;
+    case 4u:
+        result = mix(alpha_results_2, alpha_results_1, alpha_results_3);
+        break;
+    case 5u:
+        result = alpha_results_1 - alpha_results_2;
+        break;
+    case 8u:
+        result = fma(alpha_results_1, alpha_results_2, alpha_results_3);
+        break;
+    case 9u:
+        result = min(alpha_results_1 + alpha_results_2, 1.0) * alpha_results_3;
+        break;
+    default:
+        result = 0.0;
+        break;
+    }
+    return clamp(result, 0.0, 1.0);
+}
+
+bool IsPassThroughTevStage(uvec4 stage) {
+    return UberBits(stage.z, 0, 4) == 0u && UberBits(stage.z, 16, 4) == 0u &&
+           UberBits(stage.x, 0, 4) == 15u && UberBits(stage.x, 16, 4) == 15u &&
+           UberBits(stage.y, 0, 4) == 0u && UberBits(stage.y, 12, 3) == 0u &&
+           UberBits(stage.w, 0, 2) == 0u && UberBits(stage.w, 16, 2) == 0u;
+}
+
+vec4 GetTevStageSource(uvec4 stage, int index, int offset, int source3_offset) {
+    uint source = UberBits(stage.x, offset, 4);
+    // The first stage has no previous output, so it uses its third source instead
+    if (index == 0 && source == 15u) {
+        source = UberBits(stage.x, source3_offset, 4);
+    }
+    return GetTevSource(source, index);
+}
+
+float GetTevMultiplier(uint scale) {
+    return scale < 3u ? float(1u << scale) : 1.0;
+}
+
+void WriteTevStage(int index) {
+    uvec4 stage = uber_tev_stages[index];
+    if (IsPassThroughTevStage(stage)) {
+        return;
+    }
+
+    vec3 color_results_1 = GetColorModifier(UberBits(stage.y, 0, 4),
+                                            GetTevStageSource(stage, index, 0, 8));
+    vec3 color_results_2 = GetColorModifier(UberBits(stage.y, 4, 4),
+                                            GetTevStageSource(stage, index, 4, 8));
+    vec3 color_results_3 = GetColorModifier(UberBits(stage.y, 8, 4),
+                                            GetTevStageSource(stage, index, 8, 8));
+    uint color_op = UberBits(stage.z, 0, 4);
+    vec3 color_output =
+        byteround(CombineColor(color_op, color_results_1, color_results_2, color_results_3));
+
+    float alpha_output;
+    if (color_op == 7u) {
+        // Result of the Dot3_RGBA operation is also placed to the alpha component
+        alpha_output = color_output[0];
+    } else {
+        float alpha_results_1 = GetAlphaModifier(UberBits(stage.y, 12, 3),
+                                                 GetTevStageSource(stage, index, 16, 24));
+        float alpha_results_2 = GetAlphaModifier(UberBits(stage.y, 16, 3),
+                                                 GetTevStageSource(stage, index, 20, 24));
+        float alpha_results_3 = GetAlphaModifier(UberBits(stage.y, 20, 3),
+                                                 GetTevStageSource(stage, index, 24, 24));
+        alpha_output = byteround(CombineAlpha(UberBits(stage.z, 16, 4), alpha_results_1,
+                                              alpha_results_2, alpha_results_3));
+    }
+
+    combiner_output = vec4(
+        clamp(color_output * GetTevMultiplier(UberBits(stage.w, 0, 2)), vec3(0.0), vec3(1.0)),
+        clamp(alpha_output * GetTevMultiplier(UberBits(stage.w, 16, 2)), 0.0, 1.0));
+}
+
+bool FailsAlphaTest(uint func) {
+    int alpha = int(combiner_output.a * 255.0);
+    switch (func) {
+    case 0u:
+        return true;
+    case 2u:
+        return alpha != alphatest_ref;
+    case 3u:
+        return alpha == alphatest_ref;
+    case 4u:
+        return alpha >= alphatest_ref;
+    case 5u:
+        return alpha > alphatest_ref;
+    case 6u:
+        return alpha <= alphatest_ref;
+    case 7u:
+        return alpha < alphatest_ref;
+    default:
+        return false;
+    }
+}
+
+void main() {
+    uint alpha_test_func = UberBits(uber_framebuffer, 0, 3);
+    if (alpha_test_func == 0u) {
+        discard;
+    }
+
+    uint scissor_mode = UberBits(uber_framebuffer, 3, 2);
+    if (scissor_mode != 0u) {
+        bool inside = gl_FragCoord.x >= float(scissor_x1) && gl_FragCoord.y >= float(scissor_y1) &&
+                      gl_FragCoord.x < float(scissor_x2) && gl_FragCoord.y < float(scissor_y2);
+        // Include mode keeps the pixels inside the scissor box, exclude mode the ones outside
+        if (inside != (scissor_mode == 3u)) {
+            discard;
+        }
+    }
+
+    float depth = GetZOverW() * depth_scale + depth_offset;
+    if (UberBits(uber_framebuffer, 5, 1) == 0u) {
+        depth /= gl_FragCoord.w;
+    }
+
+    // We round the interpolated primary color to the nearest 1/255th
+    // This maintains the PICA's 8 bits of precision
+    rounded_primary_color = byteround(primary_color);
+    primary_fragment_color = vec4(0.0);
+    secondary_fragment_color = vec4(0.0);
+    SampleUberTextures();
+    if (UberBits(uber_lighting, 0, 1) != 0u) {
+        ComputeUberLighting();
+    }
+
+    combiner_buffer = vec4(0.0);
+    combiner_output = vec4(0.0);
+    vec4 next_combiner_buffer = tev_combiner_buffer_color;
+    uint combiner_buffer_input = UberBits(uber_texture, 4, 8);
+    for (int index = 0; index < NUM_TEV_STAGES; index++) {
+        WriteTevStage(index);
+        combiner_buffer = next_combiner_buffer;
+        if (index < 4) {
+            if (UberBits(combiner_buffer_input, index, 1) != 0u) {
+                next_combiner_buffer.rgb = combiner_output.rgb;
+            }
+            if (UberBits(combiner_buffer_input, index + 4, 1) != 0u) {
+                next_combiner_buffer.a = combiner_output.a;
+            }
+        }
+    }
+
+    if (FailsAlphaTest(alpha_test_func)) {
+        discard;
+    }
+
+    if (UberBits(uber_texture, 12, 3) == 5u) {
+        float fog_index = UberBits(uber_texture, 15, 1) != 0u ? (1.0 - depth) * 128.0
+                                                              : depth * 128.0;
+        float fog_i = clamp(floor(fog_index), 0.0, 127.0);
+        float fog_f = fog_index - fog_i;
+        vec2 fog_lut_entry = texelFetch(texture_buffer_lut_lf, int(fog_i) + fog_lut_offset).rg;
+        float fog_factor = clamp(fog_lut_entry.r + fog_lut_entry.g * fog_f, 0.0, 1.0);
+        combiner_output.rgb = mix(fog_color.rgb, combiner_output.rgb, fog_factor);
+    }
+
+    gl_FragDepth = depth;
+    // Round the final fragment color to maintain the PICA's 8 bits of precision
+    color = byteround(combiner_output);
+}
+)";
+
+bool CanUseUberFragmentShader(const FSConfig& config, const Profile& profile) {
+    using LogicOp = Pica::FramebufferRegs::LogicOp;
+    const auto logic_op = config.framebuffer.logic_op.Value();
+    const auto texture0_type = config.texture.texture0_type.Value();
+    return !config.UsesShadowPipeline() && texture0_type != TextureType::TextureCube &&
+           config.texture.fog_mode != TexturingRegs::FogMode::Gas && !config.proctex.enable &&
+           !config.user.use_custom_normal &&
+           (logic_op == LogicOp::Copy || logic_op == LogicOp::NoOp) &&
+           (!config.EmulateBlend() || profile.is_vulkan);
+}
+
+std::string GenerateUberFragmentShader(const Profile& profile) {
+    std::string out;
+    if (profile.has_separable_shaders) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+    if (!profile.is_vulkan) {
+        out += fragment_shader_precision_OES;
+    }
+
+    const auto define_input = [&](std::string_view var, Semantic location) {
+        if (profile.has_separable_shaders) {
+            out += fmt::format("layout (location = {}) ", location);
+        }
+        out += fmt::format("in {};\n", var);
+    };
+    define_input("vec4 primary_color", Semantic::Color);
+    define_input("vec2 texcoord0", Semantic::Texcoord0);
+    define_input("vec2 texcoord1", Semantic::Texcoord1);
+    define_input("vec2 texcoord2", Semantic::Texcoord2);
+    define_input("float texcoord0_w", Semantic::Texcoord0_W);
+    define_input("vec4 normquat", Semantic::Normquat);
+    define_input("vec3 view", Semantic::View);
+    out += "layout (location = 0) out vec4 color;\n\n";
+
+    out += FSUniformBlockDef;
+    out += FSUberUniformMembers;
+    out += "};\n";
+    out += "layout(binding = 3) uniform samplerBuffer texture_buffer_lut_lf;\n";
+    if (profile.has_texture_heap) {
+        out += fmt::format("layout(set = 3, binding = 0) uniform sampler2D tex_heap[{}];\n",
+                           profile.texture_heap_size);
+        out += "layout(push_constant) uniform texture_indices {\n    uint tex_index[3];\n};\n";
+        for (u32 i = 0; i < 3; i++) {
+            out += fmt::format("#define tex{0} tex_heap[tex_index[{0}]]\n", i);
+        }
+    } else {
+        const auto texunit_set = profile.is_vulkan ? "set = 1, " : "";
+        for (u32 i = 0; i < 3; i++) {
+            out += fmt::format("layout({}binding = {}) uniform sampler2D tex{};\n", texunit_set, i,
+                               i);
+        }
+    }
+
+    out += FSHelpersDef;
+    out += LightingLUTHelpersDef;
+    // See FragmentModule::WriteDepth for the conversion of the host depth range
+    if (profile.has_minus_one_to_one_range) {
+        out += "float GetZOverW() {\n    return -2.0 * gl_FragCoord.z + 1.0;\n}\n";
+    } else {
+        out += "float GetZOverW() {\n    return -gl_FragCoord.z;\n}\n";
+    }
+    out += FSUberShaderDef;
+    return out;
+}
+
 } // namespace Pica::Shader::Generator::GLSL
@@ -98,4 +98,14 @@ private:
  */
 std::string GenerateFragmentShader(const FSConfig& config, const Profile& profile);
 
+/// Returns true when the uber fragment shader can stand in for the shader of the configuration
+bool CanUseUberFragmentShader(const FSConfig& config, const Profile& profile);
+
+/**
+ * Generates the GLSL uber fragment shader, which interprets the TEV stages, lighting and fog of
+ * the configuration stored in FSUberData instead of specializing on it
+ * @returns String of the shader source code
+ */
+std::string GenerateUberFragmentShader(const Profile& profile);
+
 } // namespace Pica::Shader::Generator::GLSL
@@ -30,6 +30,24 @@ layout (binding = 0, std140) uniform vs_pica_data {
 };
 )";
 
+// The GS uniforms follow the VS uniforms in the same buffer, so both stages can share a binding.
+constexpr std::string_view GSPicaUniformBlockDef = R"(
+struct pica_uniforms {
+    bool b[16];
+    uvec4 i[4];
+    vec4 f[96];
+};
+
+#ifdef VULKAN
+layout (set = 0, binding = 0, std140) uniform gs_pica_data {
+#else
+layout (binding = 0, std140) uniform gs_pica_data {
+#endif
+    pica_uniforms vs_uniforms;
+    pica_uniforms uniforms;
+};
+)";
+
 constexpr std::string_view VSUniformBlockDef = R"(
 #ifdef VULKAN
 layout (set = 0, binding = 1, std140) uniform vs_data {
@@ -413,4 +431,102 @@ void main() {
 
     return out;
 }
+
+std::string GenerateGeometryShader(const ShaderSetup& setup, const PicaGSConfig& config,
+                                   bool separable_shader) {
+    const auto& state = config.state;
+    if (state.num_outputs == 0 || state.num_inputs % state.attributes_per_vertex != 0) {
+        return "";
+    }
+
+    std::string out;
+    if (separable_shader) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+
+    switch (config.GetVerticesPerPrimitive()) {
+    case 1:
+        out += "layout(points) in;\n";
+        break;
+    case 2:
+        out += "layout(lines) in;\n";
+        break;
+    case 3:
+        out += "layout(triangles) in;\n";
+        break;
+    default:
+        return "";
+    }
+    out += "layout(triangle_strip, max_vertices = 30) out;\n\n";
+
+    out += GSPicaUniformBlockDef;
+    out += GetGSCommonSource(state.gs_state, separable_shader);
+
+    const auto get_input_reg = [&state](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        const u32 attr = state.input_map[reg];
+        if (attr < state.num_inputs) {
+            const u32 vertex = attr / state.attributes_per_vertex;
+            const u32 attribute = attr % state.attributes_per_vertex;
+            if (attribute < state.gs_state.vs_output_attributes) {
+                return fmt::format("vs_out_attr{}[{}]", attribute, vertex);
+            }
+        }
+        return "vec4(0.0, 0.0, 0.0, 1.0)";
+    };
+
+    const auto get_output_reg = [&state](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        if (state.output_map[reg] < state.num_outputs) {
+            return fmt::format("output_buffer.attributes[{}]", state.output_map[reg]);
+        }
+        return "";
+    };
+
+    auto program_source = DecompileProgram(setup.program_code, setup.swizzle_data,
+                                           state.main_offset, get_input_reg, get_output_reg,
+                                           state.sanitize_mul, true);
+    if (program_source.empty()) {
+        return "";
+    }
+
+    out += R"(
+Vertex output_buffer;
+Vertex prim_buffer[3];
+uint vertex_id = 0u;
+bool prim_emit = false;
+bool winding = false;
+
+void setemit(uint vertex_id_, bool prim_emit_, bool winding_) {
+    vertex_id = vertex_id_;
+    prim_emit = prim_emit_;
+    winding = winding_;
+}
+
+void emit() {
+    prim_buffer[vertex_id] = output_buffer;
+
+    if (prim_emit) {
+        if (winding) {
+            EmitPrim(prim_buffer[1], prim_buffer[0], prim_buffer[2]);
+            winding = false;
+        } else {
+            EmitPrim(prim_buffer[0], prim_buffer[1], prim_buffer[2]);
+        }
+    }
+}
+
+bool exec_shader();
+
+void main() {
+)";
+    for (u32 i = 0; i < state.num_outputs; ++i) {
+        out += fmt::format("    output_buffer.attributes[{}] = vec4(0.0, 0.0, 0.0, 1.0);\n", i);
+    }
+    out += "    exec_shader();\n}\n\n";
+
+    out += program_source;
+
+    return out;
+}
 } // namespace Pica::Shader::Generator::GLSL
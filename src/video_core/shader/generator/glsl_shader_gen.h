@@ -28,6 +28,7 @@ struct ShaderSetup;
 namespace Pica::Shader::Generator {
 struct PicaVSConfig;
 struct PicaFixedGSConfig;
+struct PicaGSConfig;
 } // namespace Pica::Shader::Generator
 
 namespace Pica::Shader::Generator::GLSL {
@@ -52,4 +53,11 @@ std::string GenerateVertexShader(const Pica::ShaderSetup& setup, const PicaVSCon
  */
 std::string GenerateFixedGeometryShader(const PicaFixedGSConfig& config, bool separable_shader);
 
+/**
+ * Generates the GLSL geometry shader program source code for the given GS program
+ * @returns String of the shader source code; empty on failure
+ */
+std::string GenerateGeometryShader(const Pica::ShaderSetup& setup, const PicaGSConfig& config,
+                                   bool separable_shader);
+
 } // namespace Pica::Shader::Generator::GLSL
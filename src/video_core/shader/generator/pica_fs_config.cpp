@@ -2,10 +2,102 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <tuple>
+#include <utility>
 #include "video_core/shader/generator/pica_fs_config.h"
 
 namespace Pica::Shader {
 
+namespace {
+
+using TevStageConfig = Pica::TexturingRegs::TevStageConfig;
+
+/// Returns the number of operands a combiner operation reads
+u32 NumTevOperands(TevStageConfig::Operation op) {
+    switch (op) {
+    case TevStageConfig::Operation::Replace:
+        return 1;
+    case TevStageConfig::Operation::Modulate:
+    case TevStageConfig::Operation::Add:
+    case TevStageConfig::Operation::AddSigned:
+    case TevStageConfig::Operation::Subtract:
+    case TevStageConfig::Operation::Dot3_RGB:
+    case TevStageConfig::Operation::Dot3_RGBA:
+        return 2;
+    default:
+        // Lerp, MultiplyThenAdd and AddThenMultiply, unknown operations keep every operand.
+        return 3;
+    }
+}
+
+bool IsPassThroughTevStage(const TevStageConfig& stage) {
+    return stage.color_op == TevStageConfig::Operation::Replace &&
+           stage.alpha_op == TevStageConfig::Operation::Replace &&
+           stage.color_source1 == TevStageConfig::Source::Previous &&
+           stage.alpha_source1 == TevStageConfig::Source::Previous &&
+           stage.color_modifier1 == TevStageConfig::ColorModifier::SourceColor &&
+           stage.alpha_modifier1 == TevStageConfig::AlphaModifier::SourceAlpha &&
+           stage.GetColorMultiplier() == 1 && stage.GetAlphaMultiplier() == 1;
+}
+
+/**
+ * Clears the sources and modifiers of the operands the combiner of a stage does not read.
+ * Pass-through stages are not generated at all, so they are reduced to a single encoding.
+ */
+TevStageConfigRaw CanonicalizeTevStage(const TevStageConfigRaw& raw, u32 stage_index) {
+    constexpr u32 PreviousSource = static_cast<u32>(TevStageConfig::Source::Previous);
+    const TevStageConfig stage = raw;
+    if (IsPassThroughTevStage(stage)) {
+        return {
+            .sources_raw = PreviousSource | PreviousSource << 16,
+            .modifiers_raw = 0,
+            .ops_raw = 0,
+            .scales_raw = 0,
+        };
+    }
+
+    // Each source is 4 bits wide, color modifiers are 4 bits and alpha modifiers 3 bits wide.
+    const auto operand_masks = [&](u32 num_operands, u32 source_shift, u32 modifier_shift,
+                                   u32 modifier_mask) {
+        u32 sources = 0;
+        u32 modifiers = 0;
+        bool reads_previous = false;
+        for (u32 i = 0; i < num_operands; i++) {
+            const u32 shift = source_shift + i * 4;
+            sources |= 0xFu << shift;
+            modifiers |= modifier_mask << (modifier_shift + i * 4);
+            reads_previous |= ((raw.sources_raw >> shift) & 0xF) == PreviousSource;
+        }
+        // The first stage reads the third source in place of the previous combiner output.
+        if (stage_index == 0 && reads_previous) {
+            sources |= 0xFu << (source_shift + 8);
+        }
+        return std::pair{sources, modifiers};
+    };
+
+    u32 ops_mask = 0xF;
+    const auto [color_sources, color_modifiers] =
+        operand_masks(NumTevOperands(stage.color_op), 0, 0, 0xF);
+    u32 alpha_sources = 0;
+    u32 alpha_modifiers = 0;
+    if (stage.color_op != TevStageConfig::Operation::Dot3_RGBA) {
+        // The result of Dot3_RGBA is also placed in the alpha component, the alpha combiner is
+        // not evaluated.
+        std::tie(alpha_sources, alpha_modifiers) =
+            operand_masks(NumTevOperands(stage.alpha_op), 16, 12, 0x7);
+        ops_mask |= 0xF << 16;
+    }
+
+    return {
+        .sources_raw = raw.sources_raw & (color_sources | alpha_sources),
+        .modifiers_raw = raw.modifiers_raw & (color_modifiers | alpha_modifiers),
+        .ops_raw = raw.ops_raw & ops_mask,
+        .scales_raw = raw.scales_raw,
+    };
+}
+
+} // Anonymous namespace
+
 FramebufferConfig::FramebufferConfig(const Pica::RegsInternal& regs, const Profile& profile) {
     const auto& output_merger = regs.framebuffer.output_merger;
     scissor_test_mode.Assign(regs.rasterizer.scissor_test.mode);
@@ -67,11 +159,18 @@ TextureConfig::TextureConfig(const Pica::TexturingRegs& regs, const Profile& pro
         tev_stages[i].modifiers_raw = tev_stage.modifiers_raw;
         tev_stages[i].ops_raw = tev_stage.ops_raw;
         tev_stages[i].scales_raw = tev_stage.scales_raw;
-        if (tev_stage.color_op == Pica::TexturingRegs::TevStageConfig::Operation::Dot3_RGBA) {
-            tev_stages[i].sources_raw &= 0xFFF;
-            tev_stages[i].modifiers_raw &= 0xFFF;
-            tev_stages[i].ops_raw &= 0xF;
-        }
+    }
+}
+
+void TextureConfig::Canonicalize() {
+    if (fog_mode != Pica::TexturingRegs::FogMode::Fog) {
+        fog_flip.Assign(0);
+    }
+    if (texture0_type != Pica::TexturingRegs::TextureConfig::Shadow2D) {
+        shadow_texture_orthographic.Assign(0);
+    }
+    for (u32 i = 0; i < tev_stages.size(); i++) {
+        tev_stages[i] = CanonicalizeTevStage(tev_stages[i], i);
     }
 }
 
@@ -161,6 +260,53 @@ LightConfig::LightConfig(const Pica::LightingRegs& regs) {
     }
 }
 
+void LightConfig::Canonicalize() {
+    using Sampler = Pica::LightingRegs::LightingSampler;
+    if (!enable) {
+        return;
+    }
+
+    const auto canonicalize_lut = [this](LutConfig& lut, Sampler sampler) {
+        if (!lut.enable || !Pica::LightingRegs::IsLightingSamplerSupported(config, sampler)) {
+            lut = {};
+        }
+    };
+    canonicalize_lut(lut_d0, Sampler::Distribution0);
+    canonicalize_lut(lut_d1, Sampler::Distribution1);
+    canonicalize_lut(lut_sp, Sampler::SpotlightAttenuation);
+    canonicalize_lut(lut_fr, Sampler::Fresnel);
+    canonicalize_lut(lut_rr, Sampler::ReflectRed);
+    canonicalize_lut(lut_rg, Sampler::ReflectGreen);
+    canonicalize_lut(lut_rb, Sampler::ReflectBlue);
+
+    // The Fresnel factor is only written to the alpha components of the lighting result.
+    if (!enable_primary_alpha && !enable_secondary_alpha) {
+        lut_fr = {};
+    }
+
+    bool uses_spot = false;
+    for (u32 light_index = 0; light_index < src_num; ++light_index) {
+        auto& light = lights[light_index];
+        if (!lut_sp.enable) {
+            light.spot_atten_enable.Assign(0);
+        }
+        if (!shadow_primary && !shadow_secondary) {
+            light.shadow_enable.Assign(0);
+        }
+        uses_spot |= light.spot_atten_enable != 0;
+    }
+    if (!uses_spot) {
+        lut_sp = {};
+    }
+
+    if (bump_mode != Pica::LightingRegs::LightingBumpMode::NormalMap) {
+        bump_renorm.Assign(0);
+    }
+    if (bump_mode == Pica::LightingRegs::LightingBumpMode::None) {
+        bump_selector.Assign(0);
+    }
+}
+
 ProcTexConfig::ProcTexConfig(const Pica::TexturingRegs& regs) {
     if (!regs.main_config.texture3_enable) {
         return;
@@ -186,8 +332,24 @@ ProcTexConfig::ProcTexConfig(const Pica::TexturingRegs& regs) {
     lut_filter.Assign(regs.proctex_lut.filter);
 }
 
-FSConfig::FSConfig(const Pica::RegsInternal& regs, const UserConfig& user_, const Profile& profile)
+FSConfig::FSConfig(const Pica::RegsInternal& regs, const UserConfig& user_, const Profile& profile,
+                   u64* raw_hash)
     : framebuffer{regs, profile}, texture{regs.texturing, profile}, lighting{regs.lighting},
-      proctex{regs.texturing}, user{user_} {}
+      proctex{regs.texturing}, user{user_} {
+    if (raw_hash) {
+        *raw_hash = Hash();
+    }
+    texture.Canonicalize();
+    lighting.Canonicalize();
+}
+
+void FSConfigStats::Record(const FSConfig& config, u64 raw_hash) {
+    if (!raw_hashes.insert(raw_hash).second) {
+        return;
+    }
+    if (!canonical_hashes.insert(config.Hash()).second) {
+        num_collapsed++;
+    }
+}
 
 } // namespace Pica::Shader
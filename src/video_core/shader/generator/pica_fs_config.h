@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <unordered_set>
 #include "common/hash.h"
 #include "video_core/pica/regs_internal.h"
 #include "video_core/shader/generator/profile.h"
@@ -56,6 +57,9 @@ union TextureBorder {
 struct TextureConfig {
     explicit TextureConfig(const Pica::TexturingRegs& regs, const Profile& profile);
 
+    /// Clears the combiner operands and flags that are not read by the enabled state
+    void Canonicalize();
+
     union {
         u32 raw{};
         BitField<0, 3, Pica::TexturingRegs::TextureConfig::TextureType> texture0_type;
@@ -96,6 +100,9 @@ struct LutConfig {
 struct LightConfig {
     explicit LightConfig(const Pica::LightingRegs& regs);
 
+    /// Clears the LUTs and light flags that do not contribute to the lighting result
+    void Canonicalize();
+
     union {
         u32 raw{};
         BitField<0, 1, u32> enable;
@@ -158,8 +165,14 @@ union UserConfig {
 static_assert(std::has_unique_object_representations_v<UserConfig>);
 
 struct FSConfig {
+    /**
+     * Builds the configuration of the fragment shader emulating the current PICA state. State
+     * that does not affect the generated shader is cleared, so register combinations that only
+     * differ in dead state share a shader.
+     * @param raw_hash When not null receives the hash of the configuration before clearing
+     */
     explicit FSConfig(const Pica::RegsInternal& regs, const UserConfig& user,
-                      const Profile& profile);
+                      const Profile& profile, u64* raw_hash = nullptr);
 
     [[nodiscard]] bool TevStageUpdatesCombinerBufferColor(u32 stage_index) const {
         return (stage_index < 4) && (texture.combiner_buffer_input & (1 << stage_index));
@@ -196,6 +209,31 @@ struct FSConfig {
     UserConfig user;
 };
 
+/**
+ * Counts the configurations that canonicalization merged into an already seen configuration,
+ * each of which would otherwise have been compiled as a separate shader.
+ */
+class FSConfigStats {
+public:
+    /// Records a configuration along with the raw hash reported by its constructor
+    void Record(const FSConfig& config, u64 raw_hash);
+
+    /// Returns the number of distinct configurations that were recorded
+    [[nodiscard]] std::size_t NumConfigs() const noexcept {
+        return canonical_hashes.size();
+    }
+
+    /// Returns the number of raw configurations that collapsed into a recorded one
+    [[nodiscard]] u64 NumCollapsed() const noexcept {
+        return num_collapsed;
+    }
+
+private:
+    std::unordered_set<u64> raw_hashes;
+    std::unordered_set<u64> canonical_hashes;
+    u64 num_collapsed{};
+};
+
 } // namespace Pica::Shader
 
 namespace std {
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "common/common_types.h"
+
 namespace Pica::Shader {
 
 struct Profile {
@@ -21,7 +23,9 @@ struct Profile {
     bool has_gl_nv_fragment_shader_interlock{};
     bool has_gl_intel_fragment_shader_ordering{};
     bool has_gl_nv_fragment_shader_barycentric{};
+    bool has_texture_heap{};
     bool is_vulkan{};
+    u32 texture_heap_size{};
 };
 
 } // namespace Pica::Shader
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/bit_set.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
@@ -59,6 +60,34 @@ void PicaVSConfigState::Init(const Pica::RegsInternal& regs, Pica::ShaderSetup&
     }
 }
 
+void PicaProgrammableGSConfigState::Init(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup,
+                                         bool use_clip_planes_) {
+    gs_state.Init(regs, use_clip_planes_);
+
+    program_hash = setup.GetProgramCodeHash();
+    swizzle_hash = setup.GetSwizzleDataHash();
+    main_offset = regs.gs.main_offset;
+    sanitize_mul = Settings::values.shaders_accurate_mul.GetValue();
+
+    num_inputs = regs.gs.max_input_attribute_index + 1;
+    attributes_per_vertex = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+    input_map.fill(16);
+    for (u32 attr = 0; attr < num_inputs; ++attr) {
+        input_map[regs.gs.GetRegisterForAttribute(attr)] = attr;
+    }
+
+    num_outputs = 0;
+    output_map.fill(16);
+    for (u32 reg : Common::BitSet<u32>(regs.gs.output_mask)) {
+        output_map[reg] = num_outputs++;
+    }
+
+    // The vertex shader outputs are the inputs of each vertex, the primitives emitted by the
+    // geometry shader are made of its own outputs.
+    gs_state.vs_output_attributes = std::min(gs_state.vs_output_attributes, attributes_per_vertex);
+    gs_state.gs_output_attributes = num_outputs;
+}
+
 PicaVSConfig::PicaVSConfig(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup,
                            bool use_clip_planes_, bool use_geometry_shader_) {
     state.Init(regs, setup, use_clip_planes_, use_geometry_shader_);
@@ -68,4 +97,9 @@ PicaFixedGSConfig::PicaFixedGSConfig(const Pica::RegsInternal& regs, bool use_cl
     state.Init(regs, use_clip_planes_);
 }
 
+PicaGSConfig::PicaGSConfig(const Pica::RegsInternal& regs, Pica::ShaderSetup& setup,
+                           bool use_clip_planes_) {
+    state.Init(regs, setup, use_clip_planes_);
+}
+
 } // namespace Pica::Shader::Generator
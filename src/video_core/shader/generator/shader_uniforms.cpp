@@ -5,6 +5,7 @@
 #include <algorithm>
 #include "video_core/pica/regs_shader.h"
 #include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/pica_fs_config.h"
 #include "video_core/shader/generator/shader_uniforms.h"
 
 namespace Pica::Shader::Generator {
@@ -23,4 +24,47 @@ void PicaUniformsData::SetFromRegs(const Pica::ShaderRegs& regs, const Pica::Sha
                    });
 }
 
+void FSUberData::SetFromConfig(const FSConfig& config) {
+    using Sampler = LightingRegs::LightingSampler;
+    const auto& lighting = config.lighting;
+
+    framebuffer = config.framebuffer.raw;
+    texture = config.texture.raw;
+    texture_border = 0;
+    for (u32 i = 0; i < config.texture.texture_border_color.size(); i++) {
+        const auto& border = config.texture.texture_border_color[i];
+        texture_border |= (border.enable_s.Value() | border.enable_t.Value() << 1) << (i * 2);
+    }
+    this->lighting = lighting.raw;
+
+    for (u32 i = 0; i < tev_stages.size(); i++) {
+        const auto& stage = config.texture.tev_stages[i];
+        tev_stages[i] = {stage.sources_raw, stage.modifiers_raw, stage.ops_raw, stage.scales_raw};
+    }
+
+    // The shader only checks the enable bit, so fold the samplers of the configuration into it
+    const std::array<std::pair<const LutConfig&, Sampler>, 7> luts = {{
+        {lighting.lut_d0, Sampler::Distribution0},
+        {lighting.lut_d1, Sampler::Distribution1},
+        {lighting.lut_sp, Sampler::SpotlightAttenuation},
+        {lighting.lut_fr, Sampler::Fresnel},
+        {lighting.lut_rr, Sampler::ReflectRed},
+        {lighting.lut_rg, Sampler::ReflectGreen},
+        {lighting.lut_rb, Sampler::ReflectBlue},
+    }};
+    for (u32 i = 0; i < luts.size(); i++) {
+        const auto& [lut, sampler] = luts[i];
+        const bool enable =
+            lut.enable && LightingRegs::IsLightingSamplerSupported(lighting.config, sampler);
+        lut_configs[i / 4][i % 4] = enable ? lut.raw : 0;
+        lut_scales[i / 4][i % 4] = lut.scale;
+    }
+    lut_configs[1][3] = 0;
+    lut_scales[1][3] = 0.f;
+
+    for (u32 i = 0; i < lighting.lights.size(); i++) {
+        lights[i / 4][i % 4] = lighting.lights[i].raw;
+    }
+}
+
 } // namespace Pica::Shader::Generator
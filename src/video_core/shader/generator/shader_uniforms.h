@@ -12,6 +12,10 @@ struct ShaderRegs;
 struct ShaderSetup;
 } // namespace Pica
 
+namespace Pica::Shader {
+struct FSConfig;
+} // namespace Pica::Shader
+
 namespace Pica::Shader::Generator {
 
 struct LightSrc {
@@ -25,6 +29,26 @@ struct LightSrc {
     f32 dist_atten_scale;
 };
 
+/**
+ * Fragment configuration read by the uber fragment shader, which stands in for the shader generated
+ * from a configuration while that one is compiling. The words hold the raw FSConfig bitfields.
+ */
+struct FSUberData {
+    void SetFromConfig(const FSConfig& config);
+
+    u32 framebuffer;    ///< FramebufferConfig::raw
+    u32 texture;        ///< TextureConfig::raw
+    u32 texture_border; ///< Border color enables of the texture units, two bits per unit
+    u32 lighting;       ///< LightConfig::raw
+    alignas(16) std::array<Common::Vec4u, 6> tev_stages;
+    /// Raw words of the D0, D1, SP, FR, RR, RG and RB LUTs, only enabled when supported
+    alignas(16) std::array<Common::Vec4u, 2> lut_configs;
+    alignas(16) std::array<Common::Vec4f, 2> lut_scales;
+    alignas(16) std::array<Common::Vec4u, 2> lights; ///< Light::raw of each light slot
+};
+static_assert(sizeof(FSUberData) == 0xD0,
+              "The size of the FSUberData does not match the structure in the shader");
+
 /**
  * Uniform structure for the Uniform Buffer Object, all vectors must be 16-byte aligned
  * NOTE: Always keep a vec4 at the end. The GL spec is not clear wether the alignment at
@@ -62,9 +86,10 @@ struct FSUniformData {
     alignas(16) Common::Vec3f tex_lod_bias;
     alignas(16) Common::Vec4f tex_border_color[3];
     alignas(16) Common::Vec4f blend_color;
+    alignas(16) FSUberData uber;
 };
 
-static_assert(sizeof(FSUniformData) == 0x530,
+static_assert(sizeof(FSUniformData) == 0x600,
               "The size of the UniformData does not match the structure in the shader");
 static_assert(sizeof(FSUniformData) < 16384,
               "UniformData structure must be less than 16kb as per the OpenGL spec");
@@ -102,4 +127,15 @@ static_assert(sizeof(VSPicaUniformData) == 1856,
 static_assert(sizeof(VSPicaUniformData) < 16384,
               "VSPicaUniformData structure must be less than 16kb as per the OpenGL spec");
 
+/// Uniform data of draws using a PICA geometry shader. The VS uniforms come first, so that the
+/// vertex shader reads the same block from the shared binding.
+struct GSPicaUniformData {
+    alignas(16) PicaUniformsData vs_uniforms;
+    alignas(16) PicaUniformsData uniforms;
+};
+static_assert(sizeof(GSPicaUniformData) == 3712,
+              "The size of the GSPicaUniformData does not match the structure in the shader");
+static_assert(sizeof(GSPicaUniformData) < 16384,
+              "GSPicaUniformData structure must be less than 16kb as per the OpenGL spec");
+
 } // namespace Pica::Shader::Generator
@@ -408,6 +408,11 @@ void FragmentModule::WriteLighting() {
         }
     };
 
+    // Most LUTs are used unscaled, in which case the multiply is left out of the module
+    const auto scale_lut_value = [&](f32 scale, Id value) -> Id {
+        return scale == 1.f ? value : OpFMul(f32_id, ConstF32(scale), value);
+    };
+
     // Write the code to emulate each enabled light
     for (u32 light_index = 0; light_index < lighting.src_num; ++light_index) {
         const auto& light_config = lighting.lights[light_index];
@@ -454,7 +459,7 @@ void FragmentModule::WriteLighting() {
             const Id value{
                 get_lut_value(LightingRegs::SpotlightAttenuationSampler(light_config.num),
                               light_config.num, lighting.lut_sp.type, lighting.lut_sp.abs_input)};
-            spot_atten = OpFMul(f32_id, ConstF32(lighting.lut_sp.scale), value);
+            spot_atten = scale_lut_value(lighting.lut_sp.scale, value);
         }
 
         // If enabled, compute distance attenuation value
@@ -486,7 +491,7 @@ void FragmentModule::WriteLighting() {
             const Id value{get_lut_value(LightingRegs::LightingSampler::Distribution0,
                                          light_config.num, lighting.lut_d0.type,
                                          lighting.lut_d0.abs_input)};
-            d0_lut_value = OpFMul(f32_id, ConstF32(lighting.lut_d0.scale), value);
+            d0_lut_value = scale_lut_value(lighting.lut_d0.scale, value);
         }
 
         Id specular_0{OpVectorTimesScalar(vec_ids.Get(3), GetLightMember(0), d0_lut_value)};
@@ -503,7 +508,7 @@ void FragmentModule::WriteLighting() {
                                          light_config.num, lighting.lut_rr.type,
                                          lighting.lut_rr.abs_input)};
 
-            refl_value_r = OpFMul(f32_id, ConstF32(lighting.lut_rr.scale), value);
+            refl_value_r = scale_lut_value(lighting.lut_rr.scale, value);
         }
 
         // If enabled, lookup ReflectGreen value, otherwise, ReflectRed value is used
@@ -515,7 +520,7 @@ void FragmentModule::WriteLighting() {
                                          light_config.num, lighting.lut_rg.type,
                                          lighting.lut_rg.abs_input)};
 
-            refl_value_g = OpFMul(f32_id, ConstF32(lighting.lut_rg.scale), value);
+            refl_value_g = scale_lut_value(lighting.lut_rg.scale, value);
         }
 
         // If enabled, lookup ReflectBlue value, otherwise, ReflectRed value is used
@@ -526,7 +531,7 @@ void FragmentModule::WriteLighting() {
             const Id value{get_lut_value(LightingRegs::LightingSampler::ReflectBlue,
                                          light_config.num, lighting.lut_rb.type,
                                          lighting.lut_rb.abs_input)};
-            refl_value_b = OpFMul(f32_id, ConstF32(lighting.lut_rb.scale), value);
+            refl_value_b = scale_lut_value(lighting.lut_rb.scale, value);
         }
 
         // Specular 1 component
@@ -538,7 +543,7 @@ void FragmentModule::WriteLighting() {
             const Id value{get_lut_value(LightingRegs::LightingSampler::Distribution1,
                                          light_config.num, lighting.lut_d1.type,
                                          lighting.lut_d1.abs_input)};
-            d1_lut_value = OpFMul(f32_id, ConstF32(lighting.lut_d1.scale), value);
+            d1_lut_value = scale_lut_value(lighting.lut_d1.scale, value);
         }
 
         const Id refl_value{
@@ -559,7 +564,7 @@ void FragmentModule::WriteLighting() {
             // Lookup fresnel LUT value
             Id value{get_lut_value(LightingRegs::LightingSampler::Fresnel, light_config.num,
                                    lighting.lut_fr.type, lighting.lut_fr.abs_input)};
-            value = OpFMul(f32_id, ConstF32(lighting.lut_fr.scale), value);
+            value = scale_lut_value(lighting.lut_fr.scale, value);
 
             // Enabled for diffuse lighting alpha component
             if (lighting.enable_primary_alpha) {
@@ -666,12 +671,17 @@ void FragmentModule::WriteTevStage(s32 index) {
             alpha_output = Byteround(AppendAlphaCombiner(stage.alpha_op));
         }
 
-        color_output = OpVectorTimesScalar(
-            vec_ids.Get(3), color_output, ConstF32(static_cast<float>(stage.GetColorMultiplier())));
+        if (stage.GetColorMultiplier() != 1) {
+            color_output =
+                OpVectorTimesScalar(vec_ids.Get(3), color_output,
+                                    ConstF32(static_cast<float>(stage.GetColorMultiplier())));
+        }
         color_output = OpFClamp(vec_ids.Get(3), color_output, ConstF32(0.f, 0.f, 0.f),
                                 ConstF32(1.f, 1.f, 1.f));
-        alpha_output =
-            OpFMul(f32_id, alpha_output, ConstF32(static_cast<float>(stage.GetAlphaMultiplier())));
+        if (stage.GetAlphaMultiplier() != 1) {
+            alpha_output = OpFMul(f32_id, alpha_output,
+                                  ConstF32(static_cast<float>(stage.GetAlphaMultiplier())));
+        }
         alpha_output = OpFClamp(f32_id, alpha_output, ConstF32(0.f), ConstF32(1.f));
         combiner_output = OpCompositeConstruct(vec_ids.Get(4), color_output, alpha_output);
     }
@@ -894,6 +904,19 @@ Id FragmentModule::AppendProcTexCombineAndMap(ProcTexCombiner combiner, Id u, Id
     return ProcTexLookupLUT(offset, combined);
 }
 
+Id FragmentModule::TexturePointer(u32 texture_unit) {
+    if (!profile.has_texture_heap) {
+        const std::array tex_ids{tex0_id, tex1_id, tex2_id};
+        return tex_ids[texture_unit];
+    }
+    const Id index_pointer{TypePointer(spv::StorageClass::PushConstant, u32_id)};
+    const Id index{OpLoad(u32_id, OpAccessChain(index_pointer, texture_indices_id, ConstS32(0),
+                                                ConstU32(texture_unit)))};
+    const Id texture_pointer{
+        TypePointer(spv::StorageClass::UniformConstant, TypeSampledImage(image2d_id))};
+    return OpAccessChain(texture_pointer, texture_heap_id, index);
+}
+
 void FragmentModule::DefineTexSampler(u32 texture_unit) {
     const Id func_type{TypeFunction(vec_ids.Get(4))};
     sample_tex_unit_func[texture_unit] =
@@ -996,10 +1019,10 @@ void FragmentModule::DefineTexSampler(u32 texture_unit) {
         // Only unit 0 respects the texturing type
         switch (config.texture.texture0_type) {
         case Pica::TexturingRegs::TextureConfig::Texture2D:
-            ret_val = sample_lod(tex0_id);
+            ret_val = sample_lod(TexturePointer(0));
             break;
         case Pica::TexturingRegs::TextureConfig::Projection2D:
-            ret_val = sample_3d(tex0_id, true);
+            ret_val = sample_3d(TexturePointer(0), true);
             break;
         case Pica::TexturingRegs::TextureConfig::TextureCube:
             ret_val = sample_3d(tex0_id, false);
@@ -1018,10 +1041,10 @@ void FragmentModule::DefineTexSampler(u32 texture_unit) {
         }
         break;
     case 1:
-        ret_val = sample_lod(tex1_id);
+        ret_val = sample_lod(TexturePointer(1));
         break;
     case 2:
-        ret_val = sample_lod(tex2_id);
+        ret_val = sample_lod(TexturePointer(2));
         break;
     default:
         UNREACHABLE();
@@ -1586,9 +1609,25 @@ void FragmentModule::DefineInterface() {
     // Define texture unit samplers
     const auto texture_type = config.texture.texture0_type.Value();
     const auto tex0_type = texture_type == TextureType::TextureCube ? image_cube_id : image2d_id;
-    tex0_id = DefineUniformConst(TypeSampledImage(tex0_type), 1, 0);
-    tex1_id = DefineUniformConst(TypeSampledImage(image2d_id), 1, 1);
-    tex2_id = DefineUniformConst(TypeSampledImage(image2d_id), 1, 2);
+    if (profile.has_texture_heap) {
+        // 2D textures are sampled from the heap at the indices provided by push constants
+        const Id heap_type{
+            TypeArray(TypeSampledImage(image2d_id), ConstU32(profile.texture_heap_size))};
+        texture_heap_id = DefineUniformConst(heap_type, 3, 0);
+        const Id indices_type{TypeArray(u32_id, ConstU32(NUM_NON_PROC_TEX_UNITS))};
+        Decorate(indices_type, spv::Decoration::ArrayStride, 4u);
+        const Id indices_struct_id{TypeStruct(indices_type)};
+        MemberDecorate(indices_struct_id, 0, spv::Decoration::Offset, 0u);
+        Decorate(indices_struct_id, spv::Decoration::Block);
+        texture_indices_id = DefineVar(indices_struct_id, spv::StorageClass::PushConstant);
+        if (texture_type == TextureType::TextureCube) {
+            tex0_id = DefineUniformConst(TypeSampledImage(image_cube_id), 1, 0);
+        }
+    } else {
+        tex0_id = DefineUniformConst(TypeSampledImage(tex0_type), 1, 0);
+        tex1_id = DefineUniformConst(TypeSampledImage(image2d_id), 1, 1);
+        tex2_id = DefineUniformConst(TypeSampledImage(image2d_id), 1, 2);
+    }
 
     // Define shadow textures
     shadow_texture_px_id = DefineUniformConst(image_r32_id, 2, 0, true);
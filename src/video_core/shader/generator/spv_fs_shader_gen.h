@@ -64,6 +64,9 @@ private:
     /// Defines the basic texture sampling functions for a unit
     void DefineTexSampler(u32 texture_unit);
 
+    /// Returns the pointer to the 2D sampler of a texture unit
+    [[nodiscard]] Id TexturePointer(u32 texture_unit);
+
     /// Function for sampling the procedurally generated texture unit.
     Id ProcTexSampler();
 
@@ -258,6 +261,8 @@ private:
     Id tex0_id{};
     Id tex1_id{};
     Id tex2_id{};
+    Id texture_heap_id{};
+    Id texture_indices_id{};
     Id texture_buffer_lut_lf_id{};
     Id texture_buffer_lut_rg_id{};
     Id texture_buffer_lut_rgba_id{};
@@ -0,0 +1,1268 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+#include <fmt/format.h>
+#include <nihstro/shader_bytecode.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "video_core/pica/regs_rasterizer.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/pica_control_flow.h"
+#include "video_core/shader/generator/shader_gen.h"
+#include "video_core/shader/generator/spv_fs_shader_gen.h"
+#include "video_core/shader/generator/spv_vs_shader_gen.h"
+#include "video_core/shader/shader_dead_code.h"
+
+namespace Pica::Shader::Generator::SPIRV {
+
+using nihstro::DestRegister;
+using nihstro::Instruction;
+using nihstro::OpCode;
+using nihstro::RegisterType;
+using nihstro::SourceRegister;
+using nihstro::SwizzlePattern;
+using VSOutputAttributes = Pica::RasterizerRegs::VSOutputAttributes;
+
+constexpr u32 SPIRV_VERSION_1_3 = 0x00010300;
+
+namespace {
+
+/**
+ * Emits a SPIR-V vertex shader from a PICA vertex shader program. The program is split in the
+ * same subroutines as the GLSL decompiler, each one becoming a function that returns true when
+ * the program reached an END instruction.
+ */
+class VertexModule : public Sirit::Module {
+    static constexpr u32 NUM_REGS = 16;
+
+public:
+    explicit VertexModule(const ShaderSetup& setup_, const PicaVSConfig& config_)
+        : Sirit::Module{SPIRV_VERSION_1_3}, program_code{setup_.program_code},
+          swizzle_data{setup_.swizzle_data}, config{config_.state},
+          subroutines{AnalyzeControlFlow(program_code, config.main_offset)},
+          dead_instructions{FindDeadInstructions(program_code, swizzle_data, GetLiveOutputs())} {
+        DefineArithmeticTypes();
+        DefineUniformStructs();
+        DefineInterface();
+    }
+
+    ~VertexModule() = default;
+
+    /// Emits SPIR-V bytecode corresponding to the provided pica vertex program.
+    /// @throws DecompileFail if the program cannot be expressed with SPIR-V control flow.
+    void Generate() {
+        for (const Subroutine& subroutine : subroutines) {
+            AnalyzeSubroutine(subroutine);
+        }
+        const Subroutine& program_main = GetSubroutine(config.main_offset, PROGRAM_END);
+        DefineFunction(program_main);
+        DefineEntryPoint(functions.at(&program_main).id);
+    }
+
+private:
+    /// State of the SPIR-V function generated from a subroutine.
+    struct Function {
+        Id id{};
+        Id jmp_to{};                            ///< Next label to run, if it has labels
+        std::set<u32> labels;                   ///< Labels including the entry point
+        std::vector<const Subroutine*> callees; ///< Subroutines called by the function
+        bool visiting{};
+    };
+
+    /// Gets the Subroutine object corresponding to the specified address.
+    const Subroutine& GetSubroutine(u32 begin, u32 end) const {
+        const auto iter = subroutines.find(Subroutine{begin, end});
+        if (iter == subroutines.end()) {
+            throw DecompileFail("Subroutine was not found by the control flow analysis");
+        }
+        return *iter;
+    }
+
+    /**
+     * Follows the instructions that CompileRange visits, collecting the subroutines they call.
+     * @return the offset where compilation of the range stops, PROGRAM_END if it terminates.
+     */
+    u32 ScanRange(u32 begin, u32 end, std::vector<const Subroutine*>& callees) const {
+        u32 offset = begin;
+        while (offset < (begin > end ? PROGRAM_END : end)) {
+            const Instruction instr = {program_code[offset]};
+            const auto& flow_control = instr.flow_control;
+            switch (instr.opcode.Value()) {
+            case OpCode::Id::END:
+                return PROGRAM_END;
+            case OpCode::Id::CALL:
+            case OpCode::Id::CALLC:
+            case OpCode::Id::CALLU: {
+                const Subroutine& call_sub = GetSubroutine(
+                    flow_control.dest_offset,
+                    flow_control.dest_offset + flow_control.num_instructions);
+                callees.push_back(&call_sub);
+                if (instr.opcode.Value() == OpCode::Id::CALL &&
+                    call_sub.exit_method == ExitMethod::AlwaysEnd) {
+                    return PROGRAM_END;
+                }
+                ++offset;
+                break;
+            }
+            case OpCode::Id::IFC:
+            case OpCode::Id::IFU: {
+                const u32 else_offset = flow_control.dest_offset;
+                const u32 endif_offset = else_offset + flow_control.num_instructions;
+                const Subroutine& if_sub = GetSubroutine(offset + 1, else_offset);
+                callees.push_back(&if_sub);
+                offset = else_offset;
+                if (flow_control.num_instructions != 0) {
+                    const Subroutine& else_sub = GetSubroutine(else_offset, endif_offset);
+                    callees.push_back(&else_sub);
+                    if (if_sub.exit_method == ExitMethod::AlwaysEnd &&
+                        else_sub.exit_method == ExitMethod::AlwaysEnd) {
+                        return PROGRAM_END;
+                    }
+                    offset = endif_offset;
+                }
+                break;
+            }
+            case OpCode::Id::LOOP: {
+                const Subroutine& loop_sub =
+                    GetSubroutine(offset + 1, flow_control.dest_offset + 1);
+                callees.push_back(&loop_sub);
+                if (loop_sub.exit_method == ExitMethod::AlwaysEnd) {
+                    return PROGRAM_END;
+                }
+                offset = flow_control.dest_offset + 1;
+                break;
+            }
+            default:
+                ++offset;
+                break;
+            }
+        }
+        return offset;
+    }
+
+    /// Collects the labels and callees of a subroutine ahead of emitting its function.
+    void AnalyzeSubroutine(const Subroutine& subroutine) {
+        Function& function = functions[&subroutine];
+        if (subroutine.labels.empty()) {
+            ScanRange(subroutine.begin, subroutine.end, function.callees);
+            return;
+        }
+
+        // A label inside an IF/LOOP block makes the code after the block reachable by a jump
+        // too, so it also needs a label. Those are found here, as the switch needs all of them.
+        function.labels = subroutine.labels;
+        function.labels.insert(subroutine.begin);
+        for (auto it = function.labels.begin(); it != function.labels.end(); ++it) {
+            const auto next_it = std::next(it);
+            const u32 next_label = next_it == function.labels.end() ? subroutine.end : *next_it;
+            const u32 compile_end = ScanRange(*it, next_label, function.callees);
+            if (compile_end > next_label && compile_end != PROGRAM_END) {
+                function.labels.insert(compile_end);
+            }
+        }
+    }
+
+    /// Emits the function of a subroutine, after the functions of all the subroutines it calls.
+    void DefineFunction(const Subroutine& subroutine) {
+        Function& function = functions.at(&subroutine);
+        if (Sirit::ValidId(function.id)) {
+            return;
+        }
+        if (function.visiting) {
+            throw DecompileFail("Recursive function detected");
+        }
+        function.visiting = true;
+        for (const Subroutine* callee : function.callees) {
+            DefineFunction(*callee);
+        }
+        function.visiting = false;
+
+        function.id = OpFunction(bool_id, spv::FunctionControlMask::MaskNone,
+                                 TypeFunction(bool_id));
+        Name(function.id, subroutine.GetName());
+        AddLabel(OpLabel());
+
+        current_function = &function;
+        if (function.labels.empty()) {
+            if (CompileRange(subroutine.begin, subroutine.end) != PROGRAM_END) {
+                OpReturnValue(false_id);
+            }
+        } else {
+            CompileLabels(subroutine, function);
+        }
+        current_function = nullptr;
+
+        OpFunctionEnd();
+    }
+
+    /**
+     * Emits the body of a subroutine with labels. JMP instructions store the target label and
+     * break out of a switch, which dispatches to the label on the next iteration of a loop.
+     */
+    void CompileLabels(const Subroutine& subroutine, Function& function) {
+        function.jmp_to = DefineVar(u32_id, spv::StorageClass::Private);
+        Name(function.jmp_to, fmt::format("jmp_to_{}_{}", subroutine.begin, subroutine.end));
+        OpStore(function.jmp_to, ConstU32(subroutine.begin));
+
+        const Id loop_header{OpLabel()};
+        const Id loop_body{OpLabel()};
+        const Id continue_label{OpLabel()};
+        const Id loop_merge{OpLabel()};
+        const Id default_label{OpLabel()};
+        switch_merge = OpLabel();
+
+        OpBranch(loop_header);
+        AddLabel(loop_header);
+        OpLoopMerge(loop_merge, continue_label, spv::LoopControlMask::MaskNone);
+        OpBranch(loop_body);
+
+        AddLabel(loop_body);
+        std::vector<Sirit::Literal> literals;
+        std::vector<Id> case_labels;
+        for (const u32 label : function.labels) {
+            literals.emplace_back(label);
+            case_labels.push_back(OpLabel());
+        }
+        const Id jmp_to{OpLoad(u32_id, function.jmp_to)};
+        OpSelectionMerge(switch_merge, spv::SelectionControlMask::MaskNone);
+        OpSwitch(jmp_to, default_label, literals, case_labels);
+
+        auto case_label = case_labels.begin();
+        for (auto it = function.labels.begin(); it != function.labels.end(); ++it) {
+            AddLabel(*case_label++);
+            const auto next_it = std::next(it);
+            const u32 next_label = next_it == function.labels.end() ? subroutine.end : *next_it;
+            const u32 compile_end = CompileRange(*it, next_label);
+            if (compile_end != PROGRAM_END) {
+                OpStore(function.jmp_to, ConstU32(compile_end));
+                OpBranch(switch_merge);
+            }
+        }
+
+        AddLabel(default_label);
+        OpReturnValue(false_id);
+
+        AddLabel(switch_merge);
+        OpBranch(continue_label);
+
+        AddLabel(continue_label);
+        OpBranch(loop_header);
+
+        // Every path out of the loop returns from the function
+        AddLabel(loop_merge);
+        OpUnreachable();
+    }
+
+    /**
+     * Emits a selection construct that runs body when condition is true.
+     * @param body callable emitting the conditional code, returns true if it terminated the block
+     */
+    template <typename Func>
+    void EmitIf(Id condition, Func&& body) {
+        const Id then_label{OpLabel()};
+        const Id merge_label{OpLabel()};
+        OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+        OpBranchConditional(condition, then_label, merge_label);
+        AddLabel(then_label);
+        if (!body()) {
+            OpBranch(merge_label);
+        }
+        AddLabel(merge_label);
+    }
+
+    /**
+     * Adds code that calls a subroutine.
+     * @return true if the program always ends in the subroutine, terminating the current block.
+     */
+    bool CallSubroutine(const Subroutine& subroutine) {
+        const Id result{OpFunctionCall(bool_id, functions.at(&subroutine).id)};
+        switch (subroutine.exit_method) {
+        case ExitMethod::AlwaysEnd:
+            OpReturnValue(true_id);
+            return true;
+        case ExitMethod::Conditional:
+            EmitIf(result, [this] {
+                OpReturnValue(true_id);
+                return true;
+            });
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    /// Generates condition evaluation code for the flow control instruction.
+    Id EvaluateCondition(Instruction::FlowControlType flow_control) {
+        using Op = Instruction::FlowControlType::Op;
+
+        const Id condition{OpLoad(bvec_ids.Get(2), conditional_code)};
+        const Id cond_x{OpCompositeExtract(bool_id, condition, 0)};
+        const Id cond_y{OpCompositeExtract(bool_id, condition, 1)};
+        const Id result_x{flow_control.refx.Value() ? cond_x : OpLogicalNot(bool_id, cond_x)};
+        const Id result_y{flow_control.refy.Value() ? cond_y : OpLogicalNot(bool_id, cond_y)};
+
+        switch (flow_control.op) {
+        case Op::JustX:
+            return result_x;
+        case Op::JustY:
+            return result_y;
+        case Op::Or:
+            return OpLogicalOr(bool_id, result_x, result_y);
+        case Op::And:
+            return OpLogicalAnd(bool_id, result_x, result_y);
+        default:
+            UNREACHABLE();
+            return result_x;
+        }
+    }
+
+    /// Generates code representing a bool uniform
+    Id GetUniformBool(u32 index) {
+        const Id value{GetPicaUniform(u32_id, ConstS32(0), ConstU32(index))};
+        return OpINotEqual(bool_id, value, ConstU32(0u));
+    }
+
+    /// Returns the private variable holding an input register, defining it on first use.
+    Id GetInputRegister(u32 index) {
+        ASSERT(index < NUM_REGS);
+        if (!Sirit::ValidId(input_regs[index])) {
+            input_regs[index] = DefineVar(vec_ids.Get(4), spv::StorageClass::Private);
+            Name(input_regs[index], fmt::format("vs_in_reg{}", index));
+        }
+        return input_regs[index];
+    }
+
+    /// Returns the output registers mapped to an output attribute
+    OutputMask GetLiveOutputs() const {
+        OutputMask live_outputs;
+        for (u32 i = 0; i < NUM_REGS; i++) {
+            live_outputs[i] = config.output_map[i] < config.num_outputs;
+        }
+        return live_outputs;
+    }
+
+    /// Returns the variable of an output register, an invalid id if the register is unused.
+    Id GetOutputRegister(u32 index) const {
+        ASSERT(index < NUM_REGS);
+        const u32 attribute = config.output_map[index];
+        return attribute < config.num_outputs ? output_attrs[attribute] : Id{};
+    }
+
+    /// Loads a float uniform indexed by an address register, out of range reads return 1.0
+    Id GetOffsetRegister(u32 base_index, u32 address_register) {
+        const Id address{OpLoad(ivec_ids.Get(3), address_registers)};
+        const Id offset{OpCompositeExtract(i32_id, address, address_register)};
+        const Id in_range{OpLogicalAnd(bool_id,
+                                       OpSGreaterThanEqual(bool_id, offset, ConstS32(-128)),
+                                       OpSLessThanEqual(bool_id, offset, ConstS32(127)))};
+        const Id fixed_offset{OpSelect(i32_id, in_range, offset, ConstS32(0))};
+        const Id base{ConstS32(static_cast<s32>(base_index))};
+        const Id wrapped{OpBitwiseAnd(i32_id, OpIAdd(i32_id, base, fixed_offset), ConstS32(0x7F))};
+        const Id index{OpBitcast(u32_id, wrapped)};
+        const Id is_valid{OpULessThan(bool_id, index, ConstU32(96u))};
+        const Id safe_index{OpSelect(u32_id, is_valid, index, ConstU32(0u))};
+        const Id value{GetPicaUniform(vec_ids.Get(4), ConstS32(2), safe_index)};
+        const Id is_valid_vec{OpCompositeConstruct(bvec_ids.Get(4), is_valid, is_valid, is_valid,
+                                                   is_valid)};
+        return OpSelect(vec_ids.Get(4), is_valid_vec, value, ConstF32(1.f, 1.f, 1.f, 1.f));
+    }
+
+    /// Generates code representing a source register.
+    Id GetSourceRegister(const SourceRegister& source_reg, u32 address_register_index) {
+        const u32 index = static_cast<u32>(source_reg.GetIndex());
+
+        switch (source_reg.GetRegisterType()) {
+        case RegisterType::Input:
+            return OpLoad(vec_ids.Get(4), GetInputRegister(index));
+        case RegisterType::Temporary:
+            return OpLoad(vec_ids.Get(4), tmp_regs[index]);
+        case RegisterType::FloatUniform:
+            if (address_register_index != 0) {
+                return GetOffsetRegister(index, address_register_index - 1);
+            }
+            return GetPicaUniform(vec_ids.Get(4), ConstS32(2), ConstU32(index));
+        default:
+            UNREACHABLE();
+            return ConstF32(0.f, 0.f, 0.f, 0.f);
+        }
+    }
+
+    /// Reads a source register and applies the swizzle pattern and negation of the instruction.
+    template <SwizzlePattern::Selector (SwizzlePattern::*getter)(int) const>
+    Id GetSource(const SourceRegister& source_reg, u32 address_register_index,
+                 const SwizzlePattern& swizzle, bool negate) {
+        const Id value{GetSourceRegister(source_reg, address_register_index)};
+        const auto selector = [&](int i) { return static_cast<u32>((swizzle.*getter)(i)); };
+        const Id swizzled{OpVectorShuffle(vec_ids.Get(4), value, value, selector(0), selector(1),
+                                          selector(2), selector(3))};
+        return negate ? OpFNegate(vec_ids.Get(4), swizzled) : swizzled;
+    }
+
+    /// Generates code representing a destination register.
+    Id GetDestRegister(const DestRegister& dest_reg) const {
+        const u32 index = static_cast<u32>(dest_reg.GetIndex());
+
+        switch (dest_reg.GetRegisterType()) {
+        case RegisterType::Output:
+            return GetOutputRegister(index);
+        case RegisterType::Temporary:
+            return tmp_regs[index];
+        default:
+            UNREACHABLE();
+            return Id{};
+        }
+    }
+
+    /**
+     * Writes the enabled components of a value to a register.
+     * @param reg the variable of the destination register, an invalid id discards the value.
+     * @param value the vec4 value to write, or a float written to all enabled components.
+     */
+    void SetDest(const SwizzlePattern& swizzle, Id reg, Id value, u32 value_num_components) {
+        std::array<u32, 4> components;
+        u32 num_enabled = 0;
+        for (u32 i = 0; i < 4; ++i) {
+            const bool enabled = swizzle.DestComponentEnabled(static_cast<int>(i));
+            components[i] = enabled ? 4 + i : i;
+            num_enabled += enabled ? 1 : 0;
+        }
+        if (!Sirit::ValidId(reg) || num_enabled == 0) {
+            return;
+        }
+
+        const Id vec4_id{vec_ids.Get(4)};
+        if (value_num_components == 1) {
+            value = OpCompositeConstruct(vec4_id, value, value, value, value);
+        }
+        if (num_enabled != 4) {
+            const Id old_value{OpLoad(vec4_id, reg)};
+            value = OpVectorShuffle(vec4_id, old_value, value, components[0], components[1],
+                                    components[2], components[3]);
+        }
+        OpStore(reg, value);
+    }
+
+    /// Multiplies two vectors, with 0 * inf giving 0 as on the PICA.
+    Id SanitizeMul(Id lhs, Id rhs) {
+        const Id vec4_id{vec_ids.Get(4)};
+        const Id bvec4_id{bvec_ids.Get(4)};
+        const Id product{OpFMul(vec4_id, lhs, rhs)};
+        const Id rhs_nan{OpSelect(vec4_id, OpIsNan(bvec4_id, rhs), product,
+                                  ConstF32(0.f, 0.f, 0.f, 0.f))};
+        const Id lhs_nan{OpSelect(vec4_id, OpIsNan(bvec4_id, lhs), product, rhs_nan)};
+        return OpSelect(vec4_id, OpIsNan(bvec4_id, product), lhs_nan, product);
+    }
+
+    Id Multiply(Id lhs, Id rhs) {
+        return config.sanitize_mul ? SanitizeMul(lhs, rhs) : OpFMul(vec_ids.Get(4), lhs, rhs);
+    }
+
+    /// Writes the conditional code of a CMP instruction.
+    void WriteCompare(const Instruction& instr, Id src1, Id src2) {
+        using CompareOp = Instruction::Common::CompareOpType::Op;
+
+        const auto compare = [this](CompareOp op, Id lhs, Id rhs) -> Id {
+            switch (op) {
+            case CompareOp::Equal:
+                return OpFOrdEqual(bool_id, lhs, rhs);
+            case CompareOp::NotEqual:
+                return OpFUnordNotEqual(bool_id, lhs, rhs);
+            case CompareOp::LessThan:
+                return OpFOrdLessThan(bool_id, lhs, rhs);
+            case CompareOp::LessEqual:
+                return OpFOrdLessThanEqual(bool_id, lhs, rhs);
+            case CompareOp::GreaterThan:
+                return OpFOrdGreaterThan(bool_id, lhs, rhs);
+            case CompareOp::GreaterEqual:
+                return OpFOrdGreaterThanEqual(bool_id, lhs, rhs);
+            default:
+                return Id{};
+            }
+        };
+
+        const CompareOp op_x = instr.common.compare_op.x.Value();
+        const CompareOp op_y = instr.common.compare_op.y.Value();
+        const Id result_x{compare(op_x, OpCompositeExtract(f32_id, src1, 0),
+                                  OpCompositeExtract(f32_id, src2, 0))};
+        const Id result_y{compare(op_y, OpCompositeExtract(f32_id, src1, 1),
+                                  OpCompositeExtract(f32_id, src2, 1))};
+
+        if (!Sirit::ValidId(result_x)) {
+            LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", op_x);
+        } else if (!Sirit::ValidId(result_y)) {
+            LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", op_y);
+        } else {
+            OpStore(conditional_code,
+                    OpCompositeConstruct(bvec_ids.Get(2), result_x, result_y));
+        }
+    }
+
+    /**
+     * Compiles a single instruction from PICA to SPIR-V.
+     * @param offset the offset of the PICA shader instruction.
+     * @return the offset of the next instruction to execute. Usually it is the current offset + 1.
+     * If the current instruction is IF or LOOP, the next instruction is after the IF or LOOP block.
+     * If the current instruction always terminates the program, returns PROGRAM_END and the
+     * current block is terminated.
+     */
+    u32 CompileInstr(u32 offset) {
+        if (dead_instructions[offset]) {
+            if (offset + 1 == PROGRAM_END) {
+                OpReturnValue(true_id);
+            }
+            return offset + 1;
+        }
+
+        const Instruction instr = {program_code[offset]};
+
+        std::size_t swizzle_offset =
+            instr.opcode.Value().GetInfo().type == OpCode::Type::MultiplyAdd
+                ? instr.mad.operand_desc_id
+                : instr.common.operand_desc_id;
+        const SwizzlePattern swizzle = {swizzle_data[swizzle_offset]};
+        const Id vec4_id{vec_ids.Get(4)};
+        bool ended = false;
+
+        switch (instr.opcode.Value().GetInfo().type) {
+        case OpCode::Type::Arithmetic: {
+            const bool is_inverted =
+                (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+
+            const Id src1{GetSource<&SwizzlePattern::GetSelectorSrc1>(
+                instr.common.GetSrc1(is_inverted),
+                !is_inverted * instr.common.address_register_index, swizzle,
+                swizzle.negate_src1)};
+            const Id src2{GetSource<&SwizzlePattern::GetSelectorSrc2>(
+                instr.common.GetSrc2(is_inverted),
+                is_inverted * instr.common.address_register_index, swizzle,
+                swizzle.negate_src2)};
+            const Id dest_reg{GetDestRegister(instr.common.dest.Value())};
+
+            switch (instr.opcode.Value().EffectiveOpCode()) {
+            case OpCode::Id::ADD: {
+                SetDest(swizzle, dest_reg, OpFAdd(vec4_id, src1, src2), 4);
+                break;
+            }
+
+            case OpCode::Id::MUL: {
+                SetDest(swizzle, dest_reg, Multiply(src1, src2), 4);
+                break;
+            }
+
+            case OpCode::Id::FLR: {
+                SetDest(swizzle, dest_reg, OpFloor(vec4_id, src1), 4);
+                break;
+            }
+
+            case OpCode::Id::MAX: {
+                if (config.sanitize_mul) {
+                    const Id greater{OpFOrdGreaterThan(bvec_ids.Get(4), src1, src2)};
+                    SetDest(swizzle, dest_reg, OpSelect(vec4_id, greater, src1, src2), 4);
+                } else {
+                    SetDest(swizzle, dest_reg, OpFMax(vec4_id, src1, src2), 4);
+                }
+                break;
+            }
+
+            case OpCode::Id::MIN: {
+                if (config.sanitize_mul) {
+                    const Id less{OpFOrdLessThan(bvec_ids.Get(4), src1, src2)};
+                    SetDest(swizzle, dest_reg, OpSelect(vec4_id, less, src1, src2), 4);
+                } else {
+                    SetDest(swizzle, dest_reg, OpFMin(vec4_id, src1, src2), 4);
+                }
+                break;
+            }
+
+            case OpCode::Id::DP3:
+            case OpCode::Id::DP4:
+            case OpCode::Id::DPH:
+            case OpCode::Id::DPHI: {
+                const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+                Id dot{};
+                if (opcode == OpCode::Id::DP3) {
+                    const Id vec3_id{vec_ids.Get(3)};
+                    if (config.sanitize_mul) {
+                        const Id product{SanitizeMul(src1, src2)};
+                        dot = OpDot(f32_id, OpVectorShuffle(vec3_id, product, product, 0, 1, 2),
+                                    ConstF32(1.f, 1.f, 1.f));
+                    } else {
+                        dot = OpDot(f32_id, OpVectorShuffle(vec3_id, src1, src1, 0, 1, 2),
+                                    OpVectorShuffle(vec3_id, src2, src2, 0, 1, 2));
+                    }
+                } else {
+                    const Id src1_{opcode == OpCode::Id::DPH || opcode == OpCode::Id::DPHI
+                                       ? OpCompositeInsert(vec4_id, ConstF32(1.f), src1, 3)
+                                       : src1};
+                    if (config.sanitize_mul) {
+                        dot = OpDot(f32_id, SanitizeMul(src1_, src2),
+                                    ConstF32(1.f, 1.f, 1.f, 1.f));
+                    } else {
+                        dot = OpDot(f32_id, src1_, src2);
+                    }
+                }
+
+                SetDest(swizzle, dest_reg, dot, 1);
+                break;
+            }
+
+            case OpCode::Id::RCP:
+            case OpCode::Id::RSQ: {
+                const bool is_rcp = instr.opcode.Value().EffectiveOpCode() == OpCode::Id::RCP;
+                const Id src1_x{OpCompositeExtract(f32_id, src1, 0)};
+                const auto write_result = [&] {
+                    const Id result{is_rcp ? OpFDiv(f32_id, ConstF32(1.f), src1_x)
+                                           : OpInverseSqrt(f32_id, src1_x)};
+                    SetDest(swizzle, dest_reg, result, 1);
+                    return false;
+                };
+                if (config.sanitize_mul) {
+                    write_result();
+                } else {
+                    // When accurate multiplication is OFF, NaN are not really handled. This is a
+                    // workaround to cheaply avoid NaN. Fixes graphical issues in Ocarina of Time.
+                    const Id condition{is_rcp
+                                           ? OpFUnordNotEqual(bool_id, src1_x, ConstF32(0.f))
+                                           : OpFOrdGreaterThan(bool_id, src1_x, ConstF32(0.f))};
+                    EmitIf(condition, write_result);
+                }
+                break;
+            }
+
+            case OpCode::Id::MOVA: {
+                const Id value{OpConvertFToS(ivec_ids.Get(4), src1)};
+                Id address{OpLoad(ivec_ids.Get(3), address_registers)};
+                for (u32 i = 0; i < 2; ++i) {
+                    if (swizzle.DestComponentEnabled(static_cast<int>(i))) {
+                        address = OpCompositeInsert(ivec_ids.Get(3),
+                                                    OpCompositeExtract(i32_id, value, i), address,
+                                                    i);
+                    }
+                }
+                OpStore(address_registers, address);
+                break;
+            }
+
+            case OpCode::Id::MOV: {
+                SetDest(swizzle, dest_reg, src1, 4);
+                break;
+            }
+
+            case OpCode::Id::SGE:
+            case OpCode::Id::SGEI:
+            case OpCode::Id::SLT:
+            case OpCode::Id::SLTI: {
+                const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+                const Id condition{opcode == OpCode::Id::SGE || opcode == OpCode::Id::SGEI
+                                       ? OpFOrdGreaterThanEqual(bvec_ids.Get(4), src1, src2)
+                                       : OpFOrdLessThan(bvec_ids.Get(4), src1, src2)};
+                SetDest(swizzle, dest_reg,
+                        OpSelect(vec4_id, condition, ConstF32(1.f, 1.f, 1.f, 1.f),
+                                 ConstF32(0.f, 0.f, 0.f, 0.f)),
+                        4);
+                break;
+            }
+
+            case OpCode::Id::CMP: {
+                WriteCompare(instr, src1, src2);
+                break;
+            }
+
+            case OpCode::Id::EX2: {
+                SetDest(swizzle, dest_reg, OpExp2(f32_id, OpCompositeExtract(f32_id, src1, 0)),
+                        1);
+                break;
+            }
+
+            case OpCode::Id::LG2: {
+                SetDest(swizzle, dest_reg, OpLog2(f32_id, OpCompositeExtract(f32_id, src1, 0)),
+                        1);
+                break;
+            }
+
+            default: {
+                LOG_ERROR(HW_GPU, "Unhandled arithmetic instruction: 0x{:02x} ({}): 0x{:08x}",
+                          (int)instr.opcode.Value().EffectiveOpCode(),
+                          instr.opcode.Value().GetInfo().name, instr.hex);
+                throw DecompileFail("Unhandled instruction");
+                break;
+            }
+            }
+
+            break;
+        }
+
+        case OpCode::Type::MultiplyAdd: {
+            if ((instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MAD) ||
+                (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI)) {
+                bool is_inverted = (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI);
+
+                const Id src1{GetSource<&SwizzlePattern::GetSelectorSrc1>(
+                    instr.mad.GetSrc1(is_inverted), 0, swizzle, swizzle.negate_src1)};
+                const Id src2{GetSource<&SwizzlePattern::GetSelectorSrc2>(
+                    instr.mad.GetSrc2(is_inverted), !is_inverted * instr.mad.address_register_index,
+                    swizzle, swizzle.negate_src2)};
+                const Id src3{GetSource<&SwizzlePattern::GetSelectorSrc3>(
+                    instr.mad.GetSrc3(is_inverted), is_inverted * instr.mad.address_register_index,
+                    swizzle, swizzle.negate_src3)};
+
+                const Id dest_reg{
+                    (instr.mad.dest.Value() < 0x10)
+                        ? GetOutputRegister(static_cast<u32>(instr.mad.dest.Value().GetIndex()))
+                    : (instr.mad.dest.Value() < 0x20)
+                        ? tmp_regs[instr.mad.dest.Value().GetIndex()]
+                        : Id{}};
+
+                SetDest(swizzle, dest_reg, OpFAdd(vec4_id, Multiply(src1, src2), src3), 4);
+            } else {
+                LOG_ERROR(HW_GPU, "Unhandled multiply-add instruction: 0x{:02x} ({}): 0x{:08x}",
+                          (int)instr.opcode.Value().EffectiveOpCode(),
+                          instr.opcode.Value().GetInfo().name, instr.hex);
+                throw DecompileFail("Unhandled instruction");
+            }
+            break;
+        }
+
+        default: {
+            switch (instr.opcode.Value()) {
+            case OpCode::Id::END: {
+                OpReturnValue(true_id);
+                offset = PROGRAM_END - 1;
+                ended = true;
+                break;
+            }
+
+            case OpCode::Id::JMPC:
+            case OpCode::Id::JMPU: {
+                const u32 dest_offset = instr.flow_control.dest_offset.Value();
+                if (!current_function->labels.contains(dest_offset)) {
+                    throw DecompileFail("Jump target is not a label of the subroutine");
+                }
+
+                Id condition{};
+                if (instr.opcode.Value() == OpCode::Id::JMPC) {
+                    condition = EvaluateCondition(instr.flow_control);
+                } else {
+                    const bool invert_test = instr.flow_control.num_instructions & 1;
+                    condition = GetUniformBool(instr.flow_control.bool_uniform_id);
+                    if (invert_test) {
+                        condition = OpLogicalNot(bool_id, condition);
+                    }
+                }
+
+                EmitIf(condition, [&] {
+                    OpStore(current_function->jmp_to, ConstU32(dest_offset));
+                    OpBranch(switch_merge);
+                    return true;
+                });
+                break;
+            }
+
+            case OpCode::Id::CALL:
+            case OpCode::Id::CALLC:
+            case OpCode::Id::CALLU: {
+                auto& call_sub = GetSubroutine(instr.flow_control.dest_offset,
+                                               instr.flow_control.dest_offset +
+                                                   instr.flow_control.num_instructions);
+
+                if (instr.opcode.Value() == OpCode::Id::CALL) {
+                    if (CallSubroutine(call_sub)) {
+                        offset = PROGRAM_END - 1;
+                        ended = true;
+                    }
+                    break;
+                }
+
+                const Id condition{instr.opcode.Value() == OpCode::Id::CALLC
+                                       ? EvaluateCondition(instr.flow_control)
+                                       : GetUniformBool(instr.flow_control.bool_uniform_id)};
+                EmitIf(condition, [&] { return CallSubroutine(call_sub); });
+                break;
+            }
+
+            case OpCode::Id::NOP: {
+                break;
+            }
+
+            case OpCode::Id::IFC:
+            case OpCode::Id::IFU: {
+                const Id condition{instr.opcode.Value() == OpCode::Id::IFC
+                                       ? EvaluateCondition(instr.flow_control)
+                                       : GetUniformBool(instr.flow_control.bool_uniform_id)};
+
+                const u32 if_offset = offset + 1;
+                const u32 else_offset = instr.flow_control.dest_offset;
+                const u32 endif_offset =
+                    instr.flow_control.dest_offset + instr.flow_control.num_instructions;
+
+                auto& if_sub = GetSubroutine(if_offset, else_offset);
+                offset = else_offset - 1;
+
+                if (instr.flow_control.num_instructions == 0) {
+                    EmitIf(condition, [&] { return CallSubroutine(if_sub); });
+                    break;
+                }
+
+                auto& else_sub = GetSubroutine(else_offset, endif_offset);
+                offset = endif_offset - 1;
+
+                const Id then_label{OpLabel()};
+                const Id else_label{OpLabel()};
+                const Id merge_label{OpLabel()};
+                OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+                OpBranchConditional(condition, then_label, else_label);
+
+                AddLabel(then_label);
+                const bool if_ended = CallSubroutine(if_sub);
+                if (!if_ended) {
+                    OpBranch(merge_label);
+                }
+
+                AddLabel(else_label);
+                const bool else_ended = CallSubroutine(else_sub);
+                if (!else_ended) {
+                    OpBranch(merge_label);
+                }
+
+                AddLabel(merge_label);
+                if (if_ended && else_ended) {
+                    OpUnreachable();
+                    offset = PROGRAM_END - 1;
+                    ended = true;
+                }
+                break;
+            }
+
+            case OpCode::Id::LOOP: {
+                const Id int_uniform{GetPicaUniform(uvec_ids.Get(4), ConstS32(1),
+                                                    ConstU32(instr.flow_control.int_uniform_id))};
+                const Id loop_count{OpCompositeExtract(u32_id, int_uniform, 0)};
+                const Id loop_start{OpBitcast(i32_id, OpCompositeExtract(u32_id, int_uniform, 1))};
+                const Id loop_step{OpBitcast(i32_id, OpCompositeExtract(u32_id, int_uniform, 2))};
+
+                // Each compiled loop gets its own counter, as loops never run recursively
+                const Id loop_var{DefineVar(u32_id, spv::StorageClass::Private)};
+                Name(loop_var, fmt::format("loop{}", offset));
+                OpStore(address_registers,
+                        OpCompositeInsert(ivec_ids.Get(3), loop_start,
+                                          OpLoad(ivec_ids.Get(3), address_registers), 2));
+                OpStore(loop_var, ConstU32(0u));
+
+                const Id loop_header{OpLabel()};
+                const Id loop_body{OpLabel()};
+                const Id continue_label{OpLabel()};
+                const Id loop_merge{OpLabel()};
+
+                OpBranch(loop_header);
+                AddLabel(loop_header);
+                const Id condition{
+                    OpULessThanEqual(bool_id, OpLoad(u32_id, loop_var), loop_count)};
+                OpLoopMerge(loop_merge, continue_label, spv::LoopControlMask::MaskNone);
+                OpBranchConditional(condition, loop_body, loop_merge);
+
+                AddLabel(loop_body);
+                auto& loop_sub = GetSubroutine(offset + 1, instr.flow_control.dest_offset + 1);
+                if (!CallSubroutine(loop_sub)) {
+                    OpBranch(continue_label);
+                }
+
+                AddLabel(continue_label);
+                const Id address{OpLoad(ivec_ids.Get(3), address_registers)};
+                const Id loop_address{OpIAdd(i32_id, OpCompositeExtract(i32_id, address, 2),
+                                             loop_step)};
+                OpStore(address_registers,
+                        OpCompositeInsert(ivec_ids.Get(3), loop_address, address, 2));
+                OpStore(loop_var, OpIAdd(u32_id, OpLoad(u32_id, loop_var), ConstU32(1u)));
+                OpBranch(loop_header);
+
+                AddLabel(loop_merge);
+                offset = instr.flow_control.dest_offset;
+
+                if (loop_sub.exit_method == ExitMethod::AlwaysEnd) {
+                    OpReturnValue(true_id);
+                    offset = PROGRAM_END - 1;
+                    ended = true;
+                }
+                break;
+            }
+
+            case OpCode::Id::EMIT:
+            case OpCode::Id::SETEMIT: {
+                LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                break;
+            }
+
+            default: {
+                LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
+                          (int)instr.opcode.Value().EffectiveOpCode(),
+                          instr.opcode.Value().GetInfo().name, instr.hex);
+                throw DecompileFail("Unhandled instruction");
+                break;
+            }
+            }
+
+            break;
+        }
+        }
+
+        // Running past the end of the program memory also ends the program
+        if (offset + 1 == PROGRAM_END && !ended) {
+            OpReturnValue(true_id);
+        }
+        return offset + 1;
+    }
+
+    /**
+     * Compiles a range of instructions from PICA to SPIR-V.
+     * @param begin the offset of the starting instruction.
+     * @param end the offset where the compilation should stop (exclusive).
+     * @return the offset of the next instruction to compile. PROGRAM_END if the program terminates.
+     */
+    u32 CompileRange(u32 begin, u32 end) {
+        u32 program_counter;
+        for (program_counter = begin; program_counter < (begin > end ? PROGRAM_END : end);) {
+            program_counter = CompileInstr(program_counter);
+        }
+        return program_counter;
+    }
+
+    /// Writes the built-in and fixed function outputs from the PICA output attributes.
+    void WriteVertex() {
+        const auto semantic = [this](VSOutputAttributes::Semantic slot_semantic) -> Id {
+            const u32 slot = static_cast<u32>(slot_semantic);
+            const u32 attrib = config.gs_state.semantic_maps[slot].attribute_index;
+            const u32 comp = config.gs_state.semantic_maps[slot].component_index;
+            if (attrib < config.gs_state.gs_output_attributes) {
+                return OpCompositeExtract(f32_id, OpLoad(vec_ids.Get(4), output_attrs[attrib]),
+                                          comp);
+            }
+            return ConstF32(1.f);
+        };
+        const auto semantic_vec = [&](auto... slots) {
+            return OpCompositeConstruct(vec_ids.Get(sizeof...(slots)), semantic(slots)...);
+        };
+
+        Id vtx_pos{semantic_vec(VSOutputAttributes::POSITION_X, VSOutputAttributes::POSITION_Y,
+                                VSOutputAttributes::POSITION_Z, VSOutputAttributes::POSITION_W)};
+        vtx_pos = SanitizeVertex(vtx_pos);
+        const Id pos_z{OpCompositeExtract(f32_id, vtx_pos, 2)};
+        OpStore(gl_position_id, OpCompositeInsert(vec_ids.Get(4), OpFNegate(f32_id, pos_z),
+                                                  vtx_pos, 2));
+        if (config.use_clip_planes) {
+            // Fixed PICA clipping plane z <= 0
+            const Id output_f32{TypePointer(spv::StorageClass::Output, f32_id)};
+            OpStore(OpAccessChain(output_f32, gl_clip_distance_id, ConstS32(0)),
+                    OpFNegate(f32_id, pos_z));
+
+            const Id uniform_u32{TypePointer(spv::StorageClass::Uniform, u32_id)};
+            const Id uniform_vec4{TypePointer(spv::StorageClass::Uniform, vec_ids.Get(4))};
+            const Id enable_clip1{OpINotEqual(
+                bool_id, OpLoad(u32_id, OpAccessChain(uniform_u32, vs_data_id, ConstS32(0))),
+                ConstU32(0u))};
+            const Id clip_coef{
+                OpLoad(vec_ids.Get(4), OpAccessChain(uniform_vec4, vs_data_id, ConstS32(1)))};
+            OpStore(OpAccessChain(output_f32, gl_clip_distance_id, ConstS32(1)),
+                    OpSelect(f32_id, enable_clip1, OpDot(f32_id, clip_coef, vtx_pos),
+                             ConstF32(0.f)));
+        }
+
+        OpStore(normquat_id,
+                semantic_vec(VSOutputAttributes::QUATERNION_X, VSOutputAttributes::QUATERNION_Y,
+                             VSOutputAttributes::QUATERNION_Z, VSOutputAttributes::QUATERNION_W));
+        const Id vtx_color{semantic_vec(VSOutputAttributes::COLOR_R, VSOutputAttributes::COLOR_G,
+                                        VSOutputAttributes::COLOR_B, VSOutputAttributes::COLOR_A)};
+        OpStore(primary_color_id, OpFMin(vec_ids.Get(4), OpFAbs(vec_ids.Get(4), vtx_color),
+                                         ConstF32(1.f, 1.f, 1.f, 1.f)));
+
+        OpStore(texcoord_id[0],
+                semantic_vec(VSOutputAttributes::TEXCOORD0_U, VSOutputAttributes::TEXCOORD0_V));
+        OpStore(texcoord_id[1],
+                semantic_vec(VSOutputAttributes::TEXCOORD1_U, VSOutputAttributes::TEXCOORD1_V));
+        OpStore(texcoord0_w_id, semantic(VSOutputAttributes::TEXCOORD0_W));
+        OpStore(view_id, semantic_vec(VSOutputAttributes::VIEW_X, VSOutputAttributes::VIEW_Y,
+                                      VSOutputAttributes::VIEW_Z));
+        OpStore(texcoord_id[2],
+                semantic_vec(VSOutputAttributes::TEXCOORD2_U, VSOutputAttributes::TEXCOORD2_V));
+    }
+
+    /// Nudges depth values just outside of the clip volume back inside it.
+    Id SanitizeVertex(Id vtx_pos) {
+        const Id pos_z{OpCompositeExtract(f32_id, vtx_pos, 2)};
+        const Id pos_w{OpCompositeExtract(f32_id, vtx_pos, 3)};
+        const Id ndc_z{OpFDiv(f32_id, pos_z, pos_w)};
+        const Id near_zero{OpLogicalAnd(bool_id, OpFOrdGreaterThan(bool_id, ndc_z, ConstF32(0.f)),
+                                        OpFOrdLessThan(bool_id, ndc_z, ConstF32(0.000001f)))};
+        const Id near_minus_one{
+            OpLogicalAnd(bool_id, OpFOrdLessThan(bool_id, ndc_z, ConstF32(-1.f)),
+                         OpFOrdGreaterThan(bool_id, ndc_z, ConstF32(-1.00001f)))};
+        Id new_z{OpSelect(f32_id, near_zero, ConstF32(0.f), pos_z)};
+        new_z = OpSelect(f32_id, near_minus_one, OpFNegate(f32_id, pos_w), new_z);
+        return OpCompositeInsert(vec_ids.Get(4), new_z, vtx_pos, 2);
+    }
+
+    /// Loads the input attributes, runs the program and writes its outputs.
+    void DefineEntryPoint(Id program_main) {
+        AddCapability(spv::Capability::Shader);
+        SetMemoryModel(spv::AddressingModel::Logical, spv::MemoryModel::GLSL450);
+
+        const Id main_func{
+            OpFunction(void_id, spv::FunctionControlMask::MaskNone, TypeFunction(void_id))};
+        AddLabel(OpLabel());
+
+        for (u32 i = 0; i < NUM_REGS; ++i) {
+            if (!Sirit::ValidId(input_regs[i])) {
+                continue;
+            }
+            const auto flags = config.load_flags[i];
+            const Id type{True(flags & AttribLoadFlags::Sint)   ? ivec_ids.Get(4)
+                          : True(flags & AttribLoadFlags::Uint) ? uvec_ids.Get(4)
+                                                                : vec_ids.Get(4)};
+            const Id input_id{DefineInput(type, i)};
+            Name(input_id, fmt::format("vs_in_typed_reg{}", i));
+            interface_ids.push_back(input_id);
+
+            Id value{OpLoad(type, input_id)};
+            if (True(flags & AttribLoadFlags::Sint)) {
+                value = OpConvertSToF(vec_ids.Get(4), value);
+            } else if (True(flags & AttribLoadFlags::Uint)) {
+                value = OpConvertUToF(vec_ids.Get(4), value);
+            }
+            if (True(flags & AttribLoadFlags::ZeroW)) {
+                value = OpCompositeInsert(vec_ids.Get(4), ConstF32(0.f), value, 3);
+            }
+            OpStore(input_regs[i], value);
+        }
+        for (u32 i = 0; i < config.num_outputs; ++i) {
+            OpStore(output_attrs[i], ConstF32(0.f, 0.f, 0.f, 1.f));
+        }
+
+        OpFunctionCall(bool_id, program_main);
+        if (!config.use_geometry_shader) {
+            WriteVertex();
+        }
+        OpReturn();
+        OpFunctionEnd();
+
+        AddEntryPoint(spv::ExecutionModel::Vertex, main_func, "main", interface_ids);
+    }
+
+    void DefineArithmeticTypes() {
+        void_id = Name(TypeVoid(), "void_id");
+        bool_id = Name(TypeBool(), "bool_id");
+        f32_id = Name(TypeFloat(32), "f32_id");
+        i32_id = Name(TypeSInt(32), "i32_id");
+        u32_id = Name(TypeUInt(32), "u32_id");
+
+        for (u32 size = 2; size <= 4; size++) {
+            const u32 i = size - 2;
+            vec_ids.ids[i] = Name(TypeVector(f32_id, size), fmt::format("vec{}_id", size));
+            ivec_ids.ids[i] = Name(TypeVector(i32_id, size), fmt::format("ivec{}_id", size));
+            uvec_ids.ids[i] = Name(TypeVector(u32_id, size), fmt::format("uvec{}_id", size));
+            bvec_ids.ids[i] = Name(TypeVector(bool_id, size), fmt::format("bvec{}_id", size));
+        }
+
+        true_id = ConstantTrue(bool_id);
+        false_id = ConstantFalse(bool_id);
+    }
+
+    void DefineUniformStructs() {
+        // Booleans are stored as 16 byte aligned integers, as laid out by PicaUniformsData
+        const Id bools_array_id{TypeArray(u32_id, ConstU32(16u))};
+        const Id ints_array_id{TypeArray(uvec_ids.Get(4), ConstU32(4u))};
+        const Id floats_array_id{TypeArray(vec_ids.Get(4), ConstU32(96u))};
+        Decorate(bools_array_id, spv::Decoration::ArrayStride, 16u);
+        Decorate(ints_array_id, spv::Decoration::ArrayStride, 16u);
+        Decorate(floats_array_id, spv::Decoration::ArrayStride, 16u);
+
+        const Id pica_uniforms_struct_id{TypeStruct(bools_array_id, ints_array_id,
+                                                    floats_array_id)};
+        MemberDecorate(pica_uniforms_struct_id, 0, spv::Decoration::Offset, 0u);
+        MemberDecorate(pica_uniforms_struct_id, 1, spv::Decoration::Offset, 256u);
+        MemberDecorate(pica_uniforms_struct_id, 2, spv::Decoration::Offset, 320u);
+        Decorate(pica_uniforms_struct_id, spv::Decoration::Block);
+        pica_uniforms_id = DefineUniform(pica_uniforms_struct_id, 0);
+
+        const Id vs_data_struct_id{TypeStruct(u32_id, vec_ids.Get(4))};
+        MemberDecorate(vs_data_struct_id, 0, spv::Decoration::Offset, 0u);
+        MemberDecorate(vs_data_struct_id, 1, spv::Decoration::Offset, 16u);
+        Decorate(vs_data_struct_id, spv::Decoration::Block);
+        vs_data_id = DefineUniform(vs_data_struct_id, 1);
+    }
+
+    void DefineInterface() {
+        const Id vec4_id{vec_ids.Get(4)};
+        const Id vec4_one{ConstF32(0.f, 0.f, 0.f, 1.f)};
+        for (u32 i = 0; i < NUM_REGS; ++i) {
+            tmp_regs[i] = DefineVar(vec4_id, spv::StorageClass::Private, vec4_one);
+            Name(tmp_regs[i], fmt::format("reg_tmp{}", i));
+        }
+        conditional_code = DefineVar(bvec_ids.Get(2), spv::StorageClass::Private,
+                                     ConstantNull(bvec_ids.Get(2)));
+        address_registers = DefineVar(ivec_ids.Get(3), spv::StorageClass::Private,
+                                      ConstantNull(ivec_ids.Get(3)));
+        Name(conditional_code, "conditional_code");
+        Name(address_registers, "address_registers");
+
+        // A PICA geometry shader consumes the raw output attributes, otherwise they are
+        // converted to the fixed function attributes of the fragment shader.
+        for (u32 i = 0; i < config.num_outputs; ++i) {
+            if (config.use_geometry_shader) {
+                output_attrs[i] = DefineOutput(vec4_id, i);
+                interface_ids.push_back(output_attrs[i]);
+            } else {
+                output_attrs[i] = DefineVar(vec4_id, spv::StorageClass::Private);
+            }
+            Name(output_attrs[i], fmt::format("vs_out_attr{}", i));
+        }
+        if (config.use_geometry_shader) {
+            return;
+        }
+
+        primary_color_id = DefineOutput(vec4_id, ATTRIBUTE_COLOR);
+        texcoord_id[0] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD0);
+        texcoord_id[1] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD1);
+        texcoord_id[2] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD2);
+        texcoord0_w_id = DefineOutput(f32_id, ATTRIBUTE_TEXCOORD0_W);
+        normquat_id = DefineOutput(vec4_id, ATTRIBUTE_NORMQUAT);
+        view_id = DefineOutput(vec_ids.Get(3), ATTRIBUTE_VIEW);
+
+        gl_position_id = DefineVar(vec4_id, spv::StorageClass::Output);
+        Decorate(gl_position_id, spv::Decoration::BuiltIn, spv::BuiltIn::Position);
+        // Apple Silicon GPU drivers optimize more aggressively, which can create
+        // too much variance and cause visual artifacting in games like Pokemon.
+#ifdef __APPLE__
+        Decorate(gl_position_id, spv::Decoration::Invariant);
+#endif
+        interface_ids.insert(interface_ids.end(),
+                             {primary_color_id, texcoord_id[0], texcoord_id[1], texcoord_id[2],
+                              texcoord0_w_id, normquat_id, view_id, gl_position_id});
+
+        if (config.use_clip_planes) {
+            AddCapability(spv::Capability::ClipDistance);
+            gl_clip_distance_id =
+                DefineVar(TypeArray(f32_id, ConstU32(2u)), spv::StorageClass::Output);
+            Decorate(gl_clip_distance_id, spv::Decoration::BuiltIn, spv::BuiltIn::ClipDistance);
+            interface_ids.push_back(gl_clip_distance_id);
+        }
+    }
+
+    /// Loads a member of the pica uniforms block
+    template <typename... Ids>
+    [[nodiscard]] Id GetPicaUniform(Id type, Ids... ids) {
+        const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, type)};
+        return OpLoad(type, OpAccessChain(uniform_ptr, pica_uniforms_id, ids...));
+    }
+
+    /// Defines a input variable
+    [[nodiscard]] Id DefineInput(Id type, u32 location) {
+        const Id input_id{DefineVar(type, spv::StorageClass::Input)};
+        Decorate(input_id, spv::Decoration::Location, location);
+        return input_id;
+    }
+
+    /// Defines a output variable
+    [[nodiscard]] Id DefineOutput(Id type, u32 location) {
+        const Id output_id{DefineVar(type, spv::StorageClass::Output)};
+        Decorate(output_id, spv::Decoration::Location, location);
+        return output_id;
+    }
+
+    /// Defines a uniform buffer variable of the first descriptor set
+    [[nodiscard]] Id DefineUniform(Id type, u32 binding) {
+        const Id uniform_id{DefineVar(type, spv::StorageClass::Uniform)};
+        Decorate(uniform_id, spv::Decoration::DescriptorSet, 0u);
+        Decorate(uniform_id, spv::Decoration::Binding, binding);
+        return uniform_id;
+    }
+
+    [[nodiscard]] Id DefineVar(Id type, spv::StorageClass storage_class,
+                               std::optional<Id> initializer = std::nullopt) {
+        return AddGlobalVariable(TypePointer(storage_class, type), storage_class, initializer);
+    }
+
+    /// Returns the id of a signed integer constant of value
+    [[nodiscard]] Id ConstU32(u32 value) {
+        return Constant(u32_id, value);
+    }
+
+    /// Returns the id of a signed integer constant of value
+    [[nodiscard]] Id ConstS32(s32 value) {
+        return Constant(i32_id, value);
+    }
+
+    /// Returns the id of a float constant of value
+    [[nodiscard]] Id ConstF32(f32 value) {
+        return Constant(f32_id, value);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] Id ConstF32(Args... values) {
+        constexpr u32 size = static_cast<u32>(sizeof...(values));
+        static_assert(size >= 2 && size <= 4);
+        const std::array constituents{Constant(f32_id, values)...};
+        return ConstantComposite(vec_ids.Get(size), constituents);
+    }
+
+private:
+    const ProgramCode& program_code;
+    const SwizzleData& swizzle_data;
+    const PicaVSConfigState& config;
+    const std::set<Subroutine> subroutines;
+    const InstructionMask dead_instructions;
+
+    std::map<const Subroutine*, Function> functions;
+    Function* current_function{};
+    Id switch_merge{};
+
+    Id void_id{};
+    Id bool_id{};
+    Id f32_id{};
+    Id i32_id{};
+    Id u32_id{};
+    Id true_id{};
+    Id false_id{};
+
+    VectorIds vec_ids{};
+    VectorIds ivec_ids{};
+    VectorIds uvec_ids{};
+    VectorIds bvec_ids{};
+
+    Id pica_uniforms_id{};
+    Id vs_data_id{};
+
+    std::array<Id, NUM_REGS> input_regs{};
+    std::array<Id, NUM_REGS> tmp_regs{};
+    std::array<Id, NUM_REGS> output_attrs{};
+    Id conditional_code{};
+    Id address_registers{};
+
+    Id primary_color_id{};
+    std::array<Id, 3> texcoord_id{};
+    Id texcoord0_w_id{};
+    Id normquat_id{};
+    Id view_id{};
+    Id gl_position_id{};
+    Id gl_clip_distance_id{};
+    std::vector<Id> interface_ids;
+};
+
+} // Anonymous namespace
+
+std::vector<u32> GenerateVertexShader(const Pica::ShaderSetup& setup, const PicaVSConfig& config) {
+    try {
+        VertexModule module{setup, config};
+        module.Generate();
+        return module.Assemble();
+    } catch (const DecompileFail& exception) {
+        LOG_INFO(HW_GPU, "Shader decompilation failed: {}", exception.what());
+        return {};
+    }
+}
+
+} // namespace Pica::Shader::Generator::SPIRV
@@ -0,0 +1,29 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+#include "common/common_types.h"
+
+namespace Pica {
+struct ShaderSetup;
+}
+
+namespace Pica::Shader::Generator {
+struct PicaVSConfig;
+}
+
+namespace Pica::Shader::Generator::SPIRV {
+
+/**
+ * Generates the SPIR-V vertex shader program for the current PICA vertex shader program
+ * @param setup The PICA shader setup holding the program code and swizzle data
+ * @param config PicaVSConfig object generated for the current Pica state, used for the shader
+ *               configuration (NOTE: Use state in this struct only, not the Pica registers!)
+ * @returns The SPIR-V bytecode, empty if the program could not be decompiled
+ */
+std::vector<u32> GenerateVertexShader(const Pica::ShaderSetup& setup, const PicaVSConfig& config);
+
+} // namespace Pica::Shader::Generator::SPIRV
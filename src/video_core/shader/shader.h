@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include "common/common_types.h"
 
 namespace Pica {
@@ -14,6 +15,9 @@ struct ShaderUnit;
 
 class ShaderEngine {
 public:
+    /// Maximum number of shader units passed to a single RunBatch call.
+    static constexpr std::size_t MaxBatchSize = 8;
+
     virtual ~ShaderEngine() = default;
 
     /**
@@ -29,6 +33,15 @@ public:
      * @param state Shader unit state, must be setup with input data before each shader invocation.
      */
     virtual void Run(const ShaderSetup& setup, ShaderUnit& state) const = 0;
+
+    /**
+     * Runs the currently setup shader on independent shader units. The default implementation
+     * calls Run for each of them, engines can override it to amortize per invocation overhead.
+     *
+     * @param setup Shader engine state, must be setup with SetupBatch on each shader change.
+     * @param states Shader unit states, at most MaxBatchSize of them.
+     */
+    virtual void RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states) const;
 };
 
 std::unique_ptr<ShaderEngine> CreateEngine(bool use_jit);
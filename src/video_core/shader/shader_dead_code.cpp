@@ -0,0 +1,159 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <nihstro/shader_bytecode.h>
+#include "video_core/shader/shader_dead_code.h"
+
+using nihstro::DestRegister;
+using nihstro::Instruction;
+using nihstro::OpCode;
+using nihstro::RegisterType;
+using nihstro::SourceRegister;
+using nihstro::SwizzlePattern;
+
+namespace Pica::Shader {
+
+namespace {
+
+/// Bitmask of the components of the temporary registers, four bits per register
+using TemporaryMask = std::bitset<16 * 4>;
+
+/// Marks the temporary register components read through a source selector
+template <SwizzlePattern::Selector (SwizzlePattern::*getter)(int) const>
+void AddReads(TemporaryMask& reads, SourceRegister reg, const SwizzlePattern& swizzle) {
+    if (reg.GetRegisterType() != RegisterType::Temporary) {
+        return;
+    }
+    for (int i = 0; i < 4; i++) {
+        reads.set(reg.GetIndex() * 4 + static_cast<u32>((swizzle.*getter)(i)));
+    }
+}
+
+/// Returns true if the instruction reads a second source operand
+bool HasSecondSource(OpCode::Id opcode) {
+    switch (opcode) {
+    case OpCode::Id::EX2:
+    case OpCode::Id::LG2:
+    case OpCode::Id::FLR:
+    case OpCode::Id::RCP:
+    case OpCode::Id::RSQ:
+    case OpCode::Id::MOVA:
+    case OpCode::Id::MOV:
+        return false;
+    default:
+        return true;
+    }
+}
+
+/// Returns true if the instruction only writes its destination register
+bool OnlyWritesDest(OpCode::Id opcode) {
+    switch (opcode) {
+    case OpCode::Id::ADD:
+    case OpCode::Id::DP3:
+    case OpCode::Id::DP4:
+    case OpCode::Id::DPH:
+    case OpCode::Id::DPHI:
+    case OpCode::Id::EX2:
+    case OpCode::Id::LG2:
+    case OpCode::Id::MUL:
+    case OpCode::Id::SGE:
+    case OpCode::Id::SGEI:
+    case OpCode::Id::SLT:
+    case OpCode::Id::SLTI:
+    case OpCode::Id::FLR:
+    case OpCode::Id::MAX:
+    case OpCode::Id::MIN:
+    case OpCode::Id::RCP:
+    case OpCode::Id::RSQ:
+    case OpCode::Id::MOV:
+    case OpCode::Id::MAD:
+    case OpCode::Id::MADI:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Returns true if any component the instruction writes is consumed
+bool IsDestUsed(DestRegister dest, const SwizzlePattern& swizzle, OutputMask live_outputs,
+                const TemporaryMask& reads) {
+    const u32 index = static_cast<u32>(dest.GetIndex());
+    for (int i = 0; i < 4; i++) {
+        if (!swizzle.DestComponentEnabled(i)) {
+            continue;
+        }
+        switch (dest.GetRegisterType()) {
+        case RegisterType::Output:
+            if (live_outputs[index]) {
+                return true;
+            }
+            break;
+        case RegisterType::Temporary:
+            if (reads[index * 4 + i]) {
+                return true;
+            }
+            break;
+        default:
+            return true;
+        }
+    }
+    return false;
+}
+
+} // Anonymous namespace
+
+InstructionMask FindDeadInstructions(const ProgramCode& program_code,
+                                     const SwizzleData& swizzle_data, OutputMask live_outputs) {
+    // Instructions are marked used until no used instruction reads anything new. Every pass
+    // either marks a new temporary component read or ends the loop.
+    InstructionMask used;
+    TemporaryMask reads;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (u32 offset = 0; offset < program_code.size(); offset++) {
+            if (used[offset]) {
+                continue;
+            }
+            const Instruction instr = {program_code[offset]};
+            const OpCode::Info info = instr.opcode.Value().GetInfo();
+            const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+            const bool is_mad = info.type == OpCode::Type::MultiplyAdd;
+            if (info.type != OpCode::Type::Arithmetic && !is_mad) {
+                // Flow control does not read temporaries, but must stay
+                used.set(offset);
+                continue;
+            }
+
+            const SwizzlePattern swizzle = {
+                swizzle_data[is_mad ? instr.mad.operand_desc_id : instr.common.operand_desc_id]};
+            const DestRegister dest = is_mad ? instr.mad.dest.Value() : instr.common.dest.Value();
+            if (OnlyWritesDest(opcode) && !IsDestUsed(dest, swizzle, live_outputs, reads)) {
+                continue;
+            }
+
+            used.set(offset);
+            changed = true;
+            if (is_mad) {
+                const bool is_inverted = opcode == OpCode::Id::MADI;
+                AddReads<&SwizzlePattern::GetSelectorSrc1>(reads, instr.mad.GetSrc1(is_inverted),
+                                                           swizzle);
+                AddReads<&SwizzlePattern::GetSelectorSrc2>(reads, instr.mad.GetSrc2(is_inverted),
+                                                           swizzle);
+                AddReads<&SwizzlePattern::GetSelectorSrc3>(reads, instr.mad.GetSrc3(is_inverted),
+                                                           swizzle);
+                continue;
+            }
+            const bool is_inverted = (info.subtype & OpCode::Info::SrcInversed) != 0;
+            AddReads<&SwizzlePattern::GetSelectorSrc1>(reads, instr.common.GetSrc1(is_inverted),
+                                                       swizzle);
+            if (HasSecondSource(opcode)) {
+                AddReads<&SwizzlePattern::GetSelectorSrc2>(
+                    reads, instr.common.GetSrc2(is_inverted), swizzle);
+            }
+        }
+    }
+    return ~used;
+}
+
+} // namespace Pica::Shader
@@ -0,0 +1,30 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <bitset>
+#include "video_core/pica/shader_setup.h"
+
+namespace Pica::Shader {
+
+/// Bitmask of the instructions of a program, indexed by their offset
+using InstructionMask = std::bitset<MAX_PROGRAM_CODE_LENGTH>;
+
+/// Bitmask of the output registers of a program
+using OutputMask = std::bitset<16>;
+
+/**
+ * Finds the arithmetic instructions of a program whose results are never used: those that only
+ * write output registers missing from live_outputs, or temporary register components that no
+ * instruction with a used result reads. The analysis does not follow the control flow, so its
+ * result holds for any entry point and for temporaries carried over between invocations.
+ * @param live_outputs Output registers whose values are consumed after the program
+ * @returns Mask of the instructions that can be skipped without changing the program results
+ */
+[[nodiscard]] InstructionMask FindDeadInstructions(const ProgramCode& program_code,
+                                                   const SwizzleData& swizzle_data,
+                                                   OutputMask live_outputs);
+
+} // namespace Pica::Shader
@@ -52,6 +52,17 @@ void JitEngine::Run(const ShaderSetup& setup, ShaderUnit& state) const {
     shader->Run(setup, state, setup.entry_point);
 }
 
+void JitEngine::RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states) const {
+    ASSERT(setup.cached_shader != nullptr);
+
+    MICROPROFILE_SCOPE(GPU_Shader);
+
+    const JitShader* shader = static_cast<const JitShader*>(setup.cached_shader);
+    for (ShaderUnit& state : states) {
+        shader->Run(setup, state, setup.entry_point);
+    }
+}
+
 } // namespace Pica::Shader
 
 #endif // CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
@@ -23,8 +23,13 @@ public:
 
     void SetupBatch(ShaderSetup& setup, u32 entry_point) override;
     void Run(const ShaderSetup& setup, ShaderUnit& state) const override;
+    void RunBatch(const ShaderSetup& setup, std::span<ShaderUnit> states) const override;
 
 private:
+    // Compiled shaders are not persisted across boots. The emitted code calls host functions
+    // through their absolute or rip/pc-relative addresses and references the code buffer it was
+    // emitted into, so a blob is only valid in the process that produced it. Persisting it would
+    // need relocation support in both the Xbyak and oaknut backends.
     std::unordered_map<u64, std::unique_ptr<JitShader>> cache;
 };
 
@@ -879,6 +879,11 @@ void JitShader::Compile_NextInstr() {
 
     l(instruction_labels[program_counter]);
 
+    if (dead_instructions[program_counter]) {
+        program_counter++;
+        return;
+    }
+
     const Instruction instr = {(*program_code)[program_counter++]};
 
     const OpCode::Id opcode = instr.opcode.Value();
@@ -930,6 +935,9 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     // Find all `CALL` instructions and identify return locations
     FindReturnOffsets();
 
+    // Every output may be read by the geometry shader or the vertex loader
+    dead_instructions = FindDeadInstructions(*program_code, *swizzle_data, OutputMask{}.set());
+
     // The stack pointer is 8 modulo 16 at the entry of a procedure
     // We reserve 16 bytes and assign a dummy value to the first 8 bytes, to catch any potential
     // return checks (see Compile_Return) that happen in shader main routine.
@@ -18,6 +18,7 @@
 #include <oaknut/oaknut.hpp>
 #include "common/common_types.h"
 #include "video_core/pica/shader_setup.h"
+#include "video_core/shader/shader_dead_code.h"
 
 using nihstro::Instruction;
 using nihstro::OpCode;
@@ -137,6 +138,9 @@ private:
     /// Offsets in code where a return needs to be inserted
     std::vector<u32> return_offsets;
 
+    /// Instructions whose results are never used, which are not emitted
+    InstructionMask dead_instructions;
+
     u32 program_counter = 0; ///< Offset of the next instruction to decode
     u8 loop_depth = 0;       ///< Depth of the (nested) loops currently compiled
 
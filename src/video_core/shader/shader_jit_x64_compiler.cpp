@@ -228,6 +228,13 @@ void JitShader::Compile_SwizzleSrc(Instruction instr, u32 src_num, SourceRegiste
         address_register_index = instr.common.address_register_index;
     }
 
+    SwizzlePattern swiz = {(*swizzle_data)[operand_desc_id]};
+
+    // Selector component order needs to be reversed for the SHUFPS instruction
+    u8 sel = swiz.GetRawSelector(src_num);
+    const bool swizzle = sel != NO_SRC_REG_SWIZZLE;
+    sel = ((sel & 0xc0) >> 6) | ((sel & 3) << 6) | ((sel & 0xc) << 2) | ((sel & 0x30) >> 2);
+
     if (src_reg.GetRegisterType() == RegisterType::FloatUniform && src_num == offset_src &&
         address_register_index != 0) {
         Xbyak::Reg64 address_reg;
@@ -267,21 +274,21 @@ void JitShader::Compile_SwizzleSrc(Instruction instr, u32 src_num, SourceRegiste
         shl(rbx, 4);
         movaps(dest, xword[src_ptr + rbx]);
         L(load_end);
+
+        if (swizzle) {
+            shufps(dest, dest, sel);
+        }
+    } else if (swizzle && host_caps.has(Cpu::tAVX)) {
+        // Load and swizzle the source with a single instruction
+        vpermilps(dest, xword[src_ptr + src_offset_disp], sel);
     } else {
         // Load the source
         movaps(dest, xword[src_ptr + src_offset_disp]);
-    }
-
-    SwizzlePattern swiz = {(*swizzle_data)[operand_desc_id]};
-
-    // Generate instructions for source register swizzling as needed
-    u8 sel = swiz.GetRawSelector(src_num);
-    if (sel != NO_SRC_REG_SWIZZLE) {
-        // Selector component order needs to be reversed for the SHUFPS instruction
-        sel = ((sel & 0xc0) >> 6) | ((sel & 3) << 6) | ((sel & 0xc) << 2) | ((sel & 0x30) >> 2);
 
         // Shuffle inputs for swizzle
-        shufps(dest, dest, sel);
+        if (swizzle) {
+            shufps(dest, dest, sel);
+        }
     }
 
     // If the source register should be negated, flip the negative bit using XOR
@@ -327,13 +334,16 @@ void JitShader::Compile_DestEnable(Instruction instr, Xmm src) {
     } else {
         // Not all components are enabled, so mask the result when storing to the destination
         // register...
-        movaps(SCRATCH, xword[STATE + dest_offset_disp]);
-
-        if (host_caps.has(Cpu::tSSE41)) {
-            u8 mask = ((swiz.dest_mask & 1) << 3) | ((swiz.dest_mask & 8) >> 3) |
-                      ((swiz.dest_mask & 2) << 1) | ((swiz.dest_mask & 4) >> 1);
+        const u8 mask = ((swiz.dest_mask & 1) << 3) | ((swiz.dest_mask & 8) >> 3) |
+                        ((swiz.dest_mask & 2) << 1) | ((swiz.dest_mask & 4) >> 1);
+        if (host_caps.has(Cpu::tAVX)) {
+            // Blend the disabled components straight from memory
+            vblendps(SCRATCH, src, xword[STATE + dest_offset_disp], static_cast<u8>(~mask & 0xF));
+        } else if (host_caps.has(Cpu::tSSE41)) {
+            movaps(SCRATCH, xword[STATE + dest_offset_disp]);
             blendps(SCRATCH, src, mask);
         } else {
+            movaps(SCRATCH, xword[STATE + dest_offset_disp]);
             movaps(SCRATCH2, src);
             unpckhps(SCRATCH2, SCRATCH); // Unpack X/Y components of source and destination
             unpcklps(SCRATCH, src);      // Unpack Z/W components of source and destination
@@ -397,6 +407,21 @@ void JitShader::Compile_SanitizedMul(Xmm src1, Xmm src2, Xmm scratch) {
     andps(src1, scratch);
 }
 
+void JitShader::Compile_HorizontalSum(Xmm src, Xmm scratch) {
+    if (host_caps.has(Cpu::tAVX)) {
+        // Adds the components in the same order as two HADDPS, (x + y) + (z + w), with fewer
+        // and cheaper instructions.
+        vmovshdup(scratch, src);
+        vaddps(src, src, scratch);
+        vshufps(scratch, src, src, _MM_SHUFFLE(2, 2, 2, 2));
+        vshufps(src, src, src, _MM_SHUFFLE(0, 0, 0, 0));
+        vaddps(src, src, scratch);
+    } else {
+        haddps(src, src);
+        haddps(src, src);
+    }
+}
+
 void JitShader::Compile_EvaluateCondition(Instruction instr) {
     // Note: NXOR is used below to check for equality
     switch (instr.flow_control.op) {
@@ -475,9 +500,7 @@ void JitShader::Compile_DP4(Instruction instr) {
     Compile_SwizzleSrc(instr, 2, instr.common.src2, SRC2);
 
     Compile_SanitizedMul(SRC1, SRC2, SCRATCH);
-
-    haddps(SRC1, SRC1);
-    haddps(SRC1, SRC1);
+    Compile_HorizontalSum(SRC1, SCRATCH);
 
     Compile_DestEnable(instr, SRC1);
 }
@@ -502,9 +525,7 @@ void JitShader::Compile_DPH(Instruction instr) {
     }
 
     Compile_SanitizedMul(SRC1, SRC2, SCRATCH);
-
-    haddps(SRC1, SRC1);
-    haddps(SRC1, SRC1);
+    Compile_HorizontalSum(SRC1, SCRATCH);
 
     Compile_DestEnable(instr, SRC1);
 }
@@ -742,8 +763,12 @@ void JitShader::Compile_CMP(Instruction instr) {
         Xmm rhs_y = invert_op_y ? SRC1 : SRC2;
 
         // Compare X-component
-        movaps(SCRATCH, lhs_x);
-        cmpss(SCRATCH, rhs_x, cmp[op_x]);
+        if (host_caps.has(Cpu::tAVX)) {
+            vcmpss(SCRATCH, lhs_x, rhs_x, cmp[op_x]);
+        } else {
+            movaps(SCRATCH, lhs_x);
+            cmpss(SCRATCH, rhs_x, cmp[op_x]);
+        }
 
         // Compare Y-component
         cmpps(lhs_y, rhs_y, cmp[op_y]);
@@ -936,6 +961,11 @@ void JitShader::Compile_NextInstr() {
 
     L(instruction_labels[program_counter]);
 
+    if (dead_instructions[program_counter]) {
+        program_counter++;
+        return;
+    }
+
     Instruction instr = {(*program_code)[program_counter++]};
 
     OpCode::Id opcode = instr.opcode.Value();
@@ -987,6 +1017,9 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     // Find all `CALL` instructions and identify return locations
     FindReturnOffsets();
 
+    // Every output may be read by the geometry shader or the vertex loader
+    dead_instructions = FindDeadInstructions(*program_code, *swizzle_data, OutputMask{}.set());
+
     // The stack pointer is 8 modulo 16 at the entry of a procedure
     // We reserve 16 bytes and assign a dummy value to the first 8 bytes, to catch any potential
     // return checks (see Compile_Return) that happen in shader main routine.
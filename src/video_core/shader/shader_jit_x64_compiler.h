@@ -15,6 +15,7 @@
 #include <xbyak/xbyak.h>
 #include "common/common_types.h"
 #include "video_core/pica/shader_setup.h"
+#include "video_core/shader/shader_dead_code.h"
 
 using nihstro::Instruction;
 using nihstro::OpCode;
@@ -89,6 +90,9 @@ private:
      */
     void Compile_SanitizedMul(Xbyak::Xmm src1, Xbyak::Xmm src2, Xbyak::Xmm scratch);
 
+    /// Sums the components of `src` into all of its components. Clobbers `scratch`.
+    void Compile_HorizontalSum(Xbyak::Xmm src, Xbyak::Xmm scratch);
+
     void Compile_EvaluateCondition(Instruction instr);
     void Compile_UniformCondition(Instruction instr);
 
@@ -132,6 +136,9 @@ private:
     /// Offsets in code where a return needs to be inserted
     std::vector<u32> return_offsets;
 
+    /// Instructions whose results are never used, which are not emitted
+    InstructionMask dead_instructions;
+
     u32 program_counter = 0; ///< Offset of the next instruction to decode
     u8 loop_depth = 0;       ///< Depth of the (nested) loops currently compiled
 
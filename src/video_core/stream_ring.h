@@ -0,0 +1,179 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <vector>
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/common_types.h"
+
+namespace VideoCore {
+
+/**
+ * Backend independent bookkeeping of a persistently mapped buffer that is streamed to the GPU as
+ * a ring. Committed ranges are watched with the fence of the GPU work reading them and ranges
+ * are only reused once their fence has signaled. When reusing a range would block on a fence,
+ * the ring asks the backend to grow the buffer instead, up to a maximum size.
+ */
+class StreamRing {
+public:
+    struct Stats {
+        u64 wraps{};                           ///< Times the ring wrapped around
+        u64 stalls{};                          ///< Waits on fences that had not signaled yet
+        std::chrono::nanoseconds stall_time{}; ///< Time spent waiting in stalls
+        u32 grows{};                           ///< Times the backend was asked to grow the buffer
+    };
+
+    struct Reservation {
+        u64 offset;      ///< Offset of the reserved range in the buffer
+        bool invalidate; ///< True when the ring wrapped around and older ranges get reused
+        bool grow;       ///< True when the backend must reallocate the buffer with GrowSize() bytes
+    };
+
+    /**
+     * @param size_ Size of the buffer in bytes
+     * @param max_size_ Size the buffer may grow to, the buffer is never grown when not larger
+     */
+    explicit StreamRing(u64 size_, u64 max_size_ = 0) : size{size_}, max_size{max_size_} {}
+
+    /**
+     * Reserves a range of range_size bytes aligned to alignment, waiting for the GPU to finish
+     * reading it when necessary.
+     * @param is_signaled Callable returning whether a fence passed to Commit has signaled
+     * @param wait Callable blocking until a fence passed to Commit has signaled
+     * @returns The reserved range. When grow is set nothing was reserved, the backend must
+     *          allocate a new buffer of GrowSize() bytes, call Reset and reserve again.
+     */
+    template <typename IsSignaled, typename Wait>
+    [[nodiscard]] Reservation Reserve(u64 range_size, u64 alignment, IsSignaled&& is_signaled,
+                                      Wait&& wait) {
+        if (range_size > size) {
+            ASSERT_MSG(CanGrow(), "Requested size {} exceeds buffer size {}", range_size, size);
+            return Grow(range_size);
+        }
+        if (alignment > 0) {
+            offset = Common::AlignUp(offset, alignment);
+        }
+
+        bool invalidate = false;
+        if (offset + range_size > size) {
+            // The buffer would overflow, the ranges of this cycle must be waited on from now on.
+            invalidate = true;
+            std::swap(previous_watches, current_watches);
+            current_watches.clear();
+            wait_cursor = 0;
+            wait_bound = 0;
+            offset = 0;
+            stats.wraps++;
+        }
+
+        const u64 upper_bound = offset + range_size;
+        while (upper_bound > wait_bound && wait_cursor < previous_watches.size()) {
+            const Watch& watch = previous_watches[wait_cursor];
+            if (!is_signaled(watch.fence)) {
+                if (CanGrow()) {
+                    return Grow(range_size);
+                }
+                const auto stall_begin = std::chrono::steady_clock::now();
+                wait(watch.fence);
+                stats.stalls++;
+                stats.stall_time += std::chrono::steady_clock::now() - stall_begin;
+            }
+            wait_bound = watch.upper_bound;
+            ++wait_cursor;
+        }
+
+        return Reservation{
+            .offset = offset,
+            .invalidate = invalidate,
+            .grow = false,
+        };
+    }
+
+    /// Marks range_size bytes of the last reservation as used by the GPU work of fence
+    void Commit(u64 range_size, u64 fence) {
+        offset += range_size;
+        if (!current_watches.empty() && current_watches.back().fence == fence) {
+            current_watches.back().upper_bound = offset;
+            return;
+        }
+        current_watches.push_back(Watch{
+            .fence = fence,
+            .upper_bound = offset,
+        });
+    }
+
+    /**
+     * Forgets all ranges and restarts the ring on a new buffer of new_size bytes.
+     * Growing stops once the backend could not allocate the size requested by GrowSize().
+     */
+    void Reset(u64 new_size) {
+        if (grow_size && new_size < *grow_size) {
+            max_size = new_size;
+        }
+        size = new_size;
+        offset = 0;
+        current_watches.clear();
+        previous_watches.clear();
+        wait_cursor = 0;
+        wait_bound = 0;
+        grow_size.reset();
+    }
+
+    /// Returns the size the backend must allocate after Reserve requested to grow
+    [[nodiscard]] u64 GrowSize() const {
+        ASSERT(grow_size);
+        return *grow_size;
+    }
+
+    /// Returns the size of the buffer in bytes
+    [[nodiscard]] u64 Size() const noexcept {
+        return size;
+    }
+
+    [[nodiscard]] const Stats& GetStats() const noexcept {
+        return stats;
+    }
+
+private:
+    struct Watch {
+        u64 fence;
+        u64 upper_bound;
+    };
+
+    [[nodiscard]] bool CanGrow() const noexcept {
+        return size < max_size;
+    }
+
+    [[nodiscard]] Reservation Grow(u64 range_size) {
+        u64 new_size = size * 2;
+        while (new_size < range_size) {
+            new_size *= 2;
+        }
+        grow_size = std::min(new_size, max_size);
+        stats.grows++;
+        return Reservation{
+            .offset = 0,
+            .invalidate = true,
+            .grow = true,
+        };
+    }
+
+private:
+    u64 size;
+    u64 max_size;
+    u64 offset{};
+    std::vector<Watch> current_watches;  ///< Watches of the ranges committed in this cycle
+    std::vector<Watch> previous_watches; ///< Watches of the previous cycle, waited on for reuse
+    std::size_t wait_cursor{};           ///< First previous watch that was not waited on
+    u64 wait_bound{};                    ///< Highest offset known to be free in this cycle
+    std::optional<u64> grow_size;
+    Stats stats;
+};
+
+} // namespace VideoCore
@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <mutex>
 #include <system_error>
 #include <jwt/jwt.hpp>
+#include "common/detached_tasks.h"
 #include "common/logging/log.h"
 #include "common/web_result.h"
 #include "web_service/verify_user_jwt.h"
@@ -11,27 +14,75 @@
 
 namespace WebService {
 
-static std::string public_key;
+namespace {
+
+/// The key is refreshed in the background once it is this old, verifications keep using the old
+/// key until the new one has been fetched
+constexpr auto KeyRefreshInterval = std::chrono::hours{1};
+/// How often fetching the key is retried after it failed
+constexpr auto KeyRetryInterval = std::chrono::minutes{1};
+
+struct PublicKeyCache {
+    std::mutex mutex;
+    std::string key;
+    std::chrono::steady_clock::time_point fetch_time{};
+    bool fetched = false;
+    bool refreshing = false;
+};
+
+PublicKeyCache public_key_cache;
+
+std::string FetchPublicKey(const std::string& host) {
+    Client client(host, "", ""); // no need for credentials here
+    std::string key = client.GetPlain("/jwt/external/key.pem", true).returned_data;
+    if (key.empty()) {
+        LOG_ERROR(WebService, "Could not fetch external JWT public key, verification may fail");
+    } else {
+        LOG_INFO(WebService, "Fetched external JWT public key (size={})", key.size());
+    }
+    return key;
+}
+
+} // Anonymous namespace
+
 std::string GetPublicKey(const std::string& host) {
-    if (public_key.empty()) {
-        Client client(host, "", ""); // no need for credentials here
-        public_key = client.GetPlain("/jwt/external/key.pem", true).returned_data;
-        if (public_key.empty()) {
-            LOG_ERROR(WebService, "Could not fetch external JWT public key, verification may fail");
-        } else {
-            LOG_INFO(WebService, "Fetched external JWT public key (size={})", public_key.size());
-        }
-    }
-    return public_key;
+    std::scoped_lock lock{public_key_cache.mutex};
+    const auto now = std::chrono::steady_clock::now();
+    if (!public_key_cache.fetched) {
+        // The first fetch happens when the first room is created, before it serves any client
+        public_key_cache.key = FetchPublicKey(host);
+        public_key_cache.fetch_time = now;
+        public_key_cache.fetched = true;
+        return public_key_cache.key;
+    }
+
+    const auto interval = public_key_cache.key.empty() ? KeyRetryInterval : KeyRefreshInterval;
+    if (!public_key_cache.refreshing && now - public_key_cache.fetch_time >= interval) {
+        public_key_cache.refreshing = true;
+        Common::DetachedTasks::AddTask([host] {
+            std::string key = FetchPublicKey(host);
+            std::scoped_lock lock{public_key_cache.mutex};
+            // A failed refresh keeps using the previous key
+            if (!key.empty()) {
+                public_key_cache.key = std::move(key);
+            }
+            public_key_cache.fetch_time = std::chrono::steady_clock::now();
+            public_key_cache.refreshing = false;
+        });
+    }
+    return public_key_cache.key;
 }
 
-VerifyUserJWT::VerifyUserJWT(const std::string& host) : pub_key(GetPublicKey(host)) {}
+VerifyUserJWT::VerifyUserJWT(const std::string& host_) : host(host_) {
+    GetPublicKey(host);
+}
 
 Network::VerifyUser::UserData VerifyUserJWT::LoadUserData(const std::string& verify_UID,
                                                           const std::string& token) {
     const std::string audience = fmt::format("external-{}", verify_UID);
     using namespace jwt::params;
     std::error_code error;
+    const std::string pub_key = GetPublicKey(host);
     auto decoded =
         jwt::decode(token, algorithms({"rs256"}), error, secret(pub_key), issuer("citra-core"),
                     aud(audience), validate_iat(true), validate_jti(true));
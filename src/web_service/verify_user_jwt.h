@@ -12,14 +12,16 @@ namespace WebService {
 
 class VerifyUserJWT final : public Network::VerifyUser::Backend {
 public:
+    /// Fetches the public key of host, unless another room already has
     VerifyUserJWT(const std::string& host);
     ~VerifyUserJWT() = default;
 
+    /// Verifies the token with the cached public key, refreshing it in the background once stale
     Network::VerifyUser::UserData LoadUserData(const std::string& verify_UID,
                                                const std::string& token) override;
 
 private:
-    std::string pub_key;
+    std::string host;
 };
 
 } // namespace WebService